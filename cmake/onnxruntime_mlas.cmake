@@ -3,13 +3,17 @@
 
 set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/platform.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/tuning.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/threading.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/dgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/sgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/bf16gemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/pooling.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/reorder.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/transpose.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/activate.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/logistic.cpp
@@ -18,6 +22,10 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/quantize.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/qladd.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/qdwconv.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/layernorm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/gelu.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/cvtfp16.cpp
 )
 
 if(MSVC)
@@ -40,6 +48,7 @@ if(MSVC)
             armasm64.exe ${ARMASM_FLAGS} ${pre_filename} ${obj_filename}
     )
     set(mlas_platform_srcs ${obj_filename})
+    set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_UDOT_UNSUPPORTED -DMLAS_FP16_UNSUPPORTED")
   elseif(onnxruntime_target_platform STREQUAL "ARM")
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/arm/sgemmc.cpp
@@ -47,9 +56,14 @@ if(MSVC)
   elseif(onnxruntime_target_platform STREQUAL "x64")
     set(mlas_platform_srcs_avx2
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/qladd_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/layernorm_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/cvtfp16_avx2.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "/arch:AVX2")
 
+    # The AVX512_BF16 and AMX kernels are written with GCC/Clang vector casts.
+    set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512BF16_UNSUPPORTED -DMLAS_AMX_UNSUPPORTED")
+
     enable_language(ASM_MASM)
 
     set(mlas_platform_srcs
@@ -87,6 +101,7 @@ if(MSVC)
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/TanhKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/ErfKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx/min_max_elements.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx512f/layernorm_avx512f.cpp
     )
   else()
     enable_language(ASM_MASM)
@@ -151,6 +166,22 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/SgemmKernelNeon.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/SgemvKernelNeon.S
     )
+
+    set(mlas_platform_srcs_dotprod
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/dotprod/qgemm_udot.cpp
+    )
+    set_source_files_properties(${mlas_platform_srcs_dotprod} PROPERTIES COMPILE_FLAGS "-march=armv8.2-a+dotprod")
+
+    set(mlas_platform_srcs_fp16
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/fp16/halfgemm_neon_fp16.cpp
+    )
+    set_source_files_properties(${mlas_platform_srcs_fp16} PROPERTIES COMPILE_FLAGS "-march=armv8.2-a+fp16")
+
+    set(mlas_platform_srcs
+      ${mlas_platform_srcs}
+      ${mlas_platform_srcs_dotprod}
+      ${mlas_platform_srcs_fp16}
+    )
   elseif(POWER)
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/power/SgemmKernelPower.cpp
@@ -219,8 +250,10 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/TanhKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/ErfKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/qladd_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/layernorm_avx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx2/cvtfp16_avx2.cpp
     )
-    set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
+    set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma -mf16c")
 
     # Some toolchains do not support AVX512 compiler flags but are still able
     # to build the sources. Other toolchains require the AVX512 compiler flags
@@ -246,6 +279,7 @@ else()
         ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SconvKernelAvx512F.S
         ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SpoolKernelAvx512F.S
         ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/TransKernelAvx512F.S
+        ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx512f/layernorm_avx512f.cpp
       )
       if(HAS_AVX512F)
         set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
@@ -275,11 +309,61 @@ else()
         if(HAS_AVX512CORE)
           set_source_files_properties(${mlas_platform_srcs_avx512core} PROPERTIES COMPILE_FLAGS "-mavx512bw -mavx512dq -mavx512vl")
         endif()
+
+        check_cxx_compiler_flag("-mavx512bf16" HAS_AVX512BF16)
+        if(HAS_AVX512BF16)
+          set(CMAKE_REQUIRED_FLAGS "-mavx512f -mavx512bw -mavx512vl -mavx512bf16")
+          check_cxx_source_compiles("
+            #include <immintrin.h>
+            int main() {
+              __m512 zero = _mm512_setzero_ps();
+              __m512bh pair = _mm512_cvtne2ps_pbh(zero, zero);
+              __m512 sum = _mm512_dpbf16_ps(zero, pair, pair);
+              return _mm512_reduce_add_ps(sum) != 0.0f;
+            }"
+            COMPILES_AVX512BF16
+          )
+        endif()
+
+        if(COMPILES_AVX512BF16)
+          set(mlas_platform_srcs_avx512bf16
+            ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/avx512bf16/bf16gemm_avx512bf16.cpp
+          )
+          set_source_files_properties(${mlas_platform_srcs_avx512bf16} PROPERTIES COMPILE_FLAGS "-mavx512f -mavx512bw -mavx512vl -mavx512bf16")
+
+          check_cxx_compiler_flag("-mamx-tile -mamx-int8 -mamx-bf16" HAS_AMX)
+          if(HAS_AMX)
+            set(CMAKE_REQUIRED_FLAGS "-mavx512f -mavx512bw -mavx512vl -mavx512vnni -mavx512bf16 -mamx-tile -mamx-int8 -mamx-bf16")
+            check_cxx_source_compiles("
+              #include <immintrin.h>
+              int main() {
+                _tile_zero(0);
+                _tile_dpbusd(0, 1, 2);
+                _tile_dpbf16ps(0, 1, 2);
+                _tile_release();
+                return 0;
+              }"
+              COMPILES_AMX
+            )
+          endif()
+
+          if(COMPILES_AMX)
+            set(mlas_platform_srcs_amx
+              ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/amx/qgemm_amx.cpp
+              ${ONNXRUNTIME_ROOT}/core/mlas/lib/intrinsics/amx/bf16gemm_amx.cpp
+            )
+            set_source_files_properties(${mlas_platform_srcs_amx} PROPERTIES COMPILE_FLAGS "-mavx512f -mavx512bw -mavx512vl -mavx512vnni -mavx512bf16 -mamx-tile -mamx-int8 -mamx-bf16")
+          else()
+            set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AMX_UNSUPPORTED")
+          endif()
+        else()
+          set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512BF16_UNSUPPORTED -DMLAS_AMX_UNSUPPORTED")
+        endif()
       else()
-        set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512CORE_UNSUPPORTED")
+        set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512CORE_UNSUPPORTED -DMLAS_AMX_UNSUPPORTED")
       endif()
     else()
-      set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512F_UNSUPPORTED")
+      set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512F_UNSUPPORTED -DMLAS_AMX_UNSUPPORTED")
     endif()
 
     set(mlas_platform_srcs
@@ -288,6 +372,8 @@ else()
       ${mlas_platform_srcs_avx2}
       ${mlas_platform_srcs_avx512f}
       ${mlas_platform_srcs_avx512core}
+      ${mlas_platform_srcs_avx512bf16}
+      ${mlas_platform_srcs_amx}
     )
   endif()
 endif()
@@ -1,7 +1,10 @@
 using Microsoft.ML.OnnxRuntime.Tensors;
 using System;
 using System.Buffers;
+using System.Collections.Generic;
 using System.Diagnostics;
+using System.Runtime.InteropServices;
+using System.Text;
 
 namespace Microsoft.ML.OnnxRuntime
 {
@@ -38,6 +41,72 @@ namespace Microsoft.ML.OnnxRuntime
             return new FixedBufferOnnxValue(pinnedMemoryHandle, onnxValue, onnxValueType, elementType);
         }
 
+        /// <summary>
+        /// Creates a <see cref="FixedBufferOnnxValue"/> object over memory that is owned by the caller, such as a
+        /// buffer allocated on a CUDA device. The memory is not copied and must outlive the returned object.
+        /// </summary>
+        /// <typeparam name="T">Element type of the tensor. Strings are not supported.</typeparam>
+        /// <param name="deviceName">Where the memory lives: "Cpu", "Cuda" or "CudaPinned".</param>
+        /// <param name="deviceId">Id of the device the memory was allocated on.</param>
+        /// <param name="data">Address of the first element.</param>
+        /// <param name="bufferLengthInBytes">Size of the buffer, which must hold at least the elements of <paramref name="shape"/>.</param>
+        /// <param name="shape">Dimensions of the tensor.</param>
+        /// <returns></returns>
+        public static FixedBufferOnnxValue CreateFromMemory<T>(string deviceName, int deviceId, IntPtr data, long bufferLengthInBytes, long[] shape)
+        {
+            var elementType = TensorElementTypeConverter.GetTensorElementType(typeof(T));
+            if (elementType == TensorElementType.DataTypeMax || elementType == TensorElementType.String)
+            {
+                throw new NotSupportedException($"Tensors of type {typeof(T)} can't be created over native memory.");
+            }
+
+            IntPtr memoryInfo = IntPtr.Zero;
+            IntPtr onnxValue = IntPtr.Zero;
+            try
+            {
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtCreateMemoryInfo(GetNativeDeviceName(deviceName),
+                                                                                NativeMethods.AllocatorType.DeviceAllocator,
+                                                                                deviceId,
+                                                                                NativeMethods.MemoryType.Default,
+                                                                                out memoryInfo));
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtCreateTensorWithDataAsOrtValue(memoryInfo,
+                                                                                              data,
+                                                                                              (UIntPtr)bufferLengthInBytes,
+                                                                                              shape,
+                                                                                              (UIntPtr)shape.Length,
+                                                                                              elementType,
+                                                                                              out onnxValue));
+            }
+            finally
+            {
+                // the tensor keeps a copy of the memory info
+                if (memoryInfo != IntPtr.Zero)
+                {
+                    NativeMethods.OrtReleaseMemoryInfo(memoryInfo);
+                }
+            }
+
+            return new FixedBufferOnnxValue(default(MemoryHandle), onnxValue, OnnxValueType.ONNX_TYPE_TENSOR, elementType);
+        }
+
+        // OrtMemoryInfo keeps the name pointer it was created with, so the native names are never freed.
+        private static readonly Dictionary<string, IntPtr> _nativeDeviceNames = new Dictionary<string, IntPtr>();
+
+        private static IntPtr GetNativeDeviceName(string deviceName)
+        {
+            lock (_nativeDeviceNames)
+            {
+                if (!_nativeDeviceNames.TryGetValue(deviceName, out IntPtr nativeName))
+                {
+                    var utf8Name = Encoding.UTF8.GetBytes(deviceName + Char.MinValue);
+                    nativeName = Marshal.AllocHGlobal(utf8Name.Length);
+                    Marshal.Copy(utf8Name, 0, nativeName, utf8Name.Length);
+                    _nativeDeviceNames.Add(deviceName, nativeName);
+                }
+                return nativeName;
+            }
+        }
+
         #region IDisposable Support
 
         // standard dispose pattern to deal with both managed and native resources
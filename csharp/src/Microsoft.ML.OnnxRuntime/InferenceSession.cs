@@ -697,6 +697,57 @@ namespace Microsoft.ML.OnnxRuntime
             }
         }
 
+        /// <summary>
+        /// Creates an <see cref="OrtIoBinding"/> to bind pre-allocated inputs and outputs of this session,
+        /// which are then reused by <see cref="RunWithBinding(OrtIoBinding)"/>.
+        /// </summary>
+        /// <returns></returns>
+        public OrtIoBinding CreateIoBinding()
+        {
+            return new OrtIoBinding(this);
+        }
+
+        /// <summary>
+        /// Runs the loaded model with the inputs and outputs bound to <paramref name="ioBinding"/>.
+        /// The outputs are written to the bound values.
+        /// </summary>
+        /// <param name="ioBinding">Binding created by <see cref="CreateIoBinding"/> for this session.</param>
+        public void RunWithBinding(OrtIoBinding ioBinding)
+        {
+            RunWithBinding(ioBinding, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model with the inputs and outputs bound to <paramref name="ioBinding"/>.
+        /// Uses the given RunOptions for this run. The outputs are written to the bound values.
+        /// </summary>
+        /// <param name="ioBinding">Binding created by <see cref="CreateIoBinding"/> for this session.</param>
+        /// <param name="options"></param>
+        public void RunWithBinding(OrtIoBinding ioBinding, RunOptions options)
+        {
+            if (ioBinding.Session != this)
+            {
+                throw new ArgumentException("The binding was created by another session.", nameof(ioBinding));
+            }
+            if (ioBinding.OutputCount == 0)
+            {
+                throw new ArgumentException("At least one output must be bound.", nameof(ioBinding));
+            }
+
+            IntPtr status = NativeMethods.OrtRunWithNativeNames(
+                                                _nativeHandle,
+                                                options.Handle,
+                                                ioBinding.InputNames,
+                                                ioBinding.InputValues,
+                                                (UIntPtr)ioBinding.InputCount,
+                                                ioBinding.OutputNames,
+                                                (UIntPtr)ioBinding.OutputCount,
+                                                ioBinding.OutputValues /* pointers to Pre-allocated OrtValue instances */
+                                                );
+
+            NativeApiStatus.VerifySuccess(status);
+        }
+
         /// <summary>
         /// Ends profiling for the session. Returns the profile file name.
         /// 
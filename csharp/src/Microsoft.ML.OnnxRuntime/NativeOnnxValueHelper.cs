@@ -386,6 +386,19 @@ namespace Microsoft.ML.OnnxRuntime
 
     internal static class TensorElementTypeConverter
     {
+        public static TensorElementType GetTensorElementType(Type type)
+        {
+            foreach (TensorElementType elemType in Enum.GetValues(typeof(TensorElementType)))
+            {
+                GetTypeAndWidth(elemType, out Type elemClrType, out int width);
+                if (elemClrType == type)
+                {
+                    return elemType;
+                }
+            }
+            return TensorElementType.DataTypeMax;
+        }
+
         public static void GetTypeAndWidth(TensorElementType elemType, out Type type, out int width)
         {
             switch (elemType)
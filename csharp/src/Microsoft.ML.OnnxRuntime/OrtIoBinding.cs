@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace Microsoft.ML.OnnxRuntime
+{
+    /// <summary>
+    /// Binds <see cref="FixedBufferOnnxValue"/> inputs and outputs to the names of an <see cref="InferenceSession"/>,
+    /// so that the same buffers can be used by many runs. Names are marshalled once, when they are first bound,
+    /// and binding a name again only replaces its value, so a run with a binding allocates nothing on the managed heap.
+    ///
+    /// The binding doesn't own the bound values: they must stay alive, and must not be disposed, while they are bound.
+    /// A binding must not be used by concurrent runs.
+    /// </summary>
+    public class OrtIoBinding : IDisposable
+    {
+        private readonly InferenceSession _session;
+        private readonly BoundValues _inputs = new BoundValues();
+        private readonly BoundValues _outputs = new BoundValues();
+
+        internal OrtIoBinding(InferenceSession session)
+        {
+            _session = session;
+        }
+
+        /// <summary>
+        /// Binds a value to an input of the session. Replaces the value previously bound to the same name.
+        /// </summary>
+        /// <param name="name">Name of the input</param>
+        /// <param name="value">Value to feed, which can live in device memory</param>
+        public void BindInput(string name, FixedBufferOnnxValue value)
+        {
+            if (!_session.InputMetadata.ContainsKey(name) && !_session.OverridableInitializerMetadata.ContainsKey(name))
+            {
+                throw new ArgumentException($"'{name}' is not an input of the session.", nameof(name));
+            }
+            _inputs.Bind(name, value);
+        }
+
+        /// <summary>
+        /// Binds a pre-allocated value to an output of the session. Replaces the value previously bound to the same name.
+        /// The value must have the type and dimensions of the output.
+        /// </summary>
+        /// <param name="name">Name of the output</param>
+        /// <param name="value">Value to receive the output, which can live in device memory</param>
+        public void BindOutput(string name, FixedBufferOnnxValue value)
+        {
+            if (!_session.OutputMetadata.ContainsKey(name))
+            {
+                throw new ArgumentException($"'{name}' is not an output of the session.", nameof(name));
+            }
+            if (value.ElementType == TensorElementType.String)
+            {
+                throw new NotSupportedException("Using string type FixedBufferOnnxValue in outputs is not supported.");
+            }
+            _outputs.Bind(name, value);
+        }
+
+        /// <summary>
+        /// Removes all bound inputs and outputs.
+        /// </summary>
+        public void Clear()
+        {
+            _inputs.Clear();
+            _outputs.Clear();
+        }
+
+        internal InferenceSession Session
+        {
+            get
+            {
+                return _session;
+            }
+        }
+
+        internal int InputCount { get { return _inputs.Count; } }
+        internal IntPtr[] InputNames { get { return _inputs.NativeNames; } }
+        internal IntPtr[] InputValues { get { return _inputs.Values; } }
+        internal int OutputCount { get { return _outputs.Count; } }
+        internal IntPtr[] OutputNames { get { return _outputs.NativeNames; } }
+        internal IntPtr[] OutputValues { get { return _outputs.Values; } }
+
+        // The names and values passed to OrtRun. The arrays only grow, and only their first Count entries are used.
+        private class BoundValues
+        {
+            internal int Count { get; private set; }
+            internal IntPtr[] NativeNames { get; private set; } = new IntPtr[0];
+            internal IntPtr[] Values { get; private set; } = new IntPtr[0];
+            private string[] _names = new string[0];
+            // keeps the bound values from being finalized while they are bound
+            private FixedBufferOnnxValue[] _boundValues = new FixedBufferOnnxValue[0];
+
+            internal void Bind(string name, FixedBufferOnnxValue value)
+            {
+                int index = Array.IndexOf(_names, name, 0, Count);
+                if (index < 0)
+                {
+                    if (Count == _names.Length)
+                    {
+                        int capacity = Math.Max(4, 2 * Count);
+                        _names = Resize(_names, capacity);
+                        _boundValues = Resize(_boundValues, capacity);
+                        NativeNames = Resize(NativeNames, capacity);
+                        Values = Resize(Values, capacity);
+                    }
+                    index = Count++;
+                    _names[index] = name;
+                    var utf8Name = Encoding.UTF8.GetBytes(name + Char.MinValue);
+                    NativeNames[index] = Marshal.AllocHGlobal(utf8Name.Length);
+                    Marshal.Copy(utf8Name, 0, NativeNames[index], utf8Name.Length);
+                }
+                _boundValues[index] = value;
+                Values[index] = value.Value;
+            }
+
+            internal void Clear()
+            {
+                for (int i = 0; i < Count; ++i)
+                {
+                    Marshal.FreeHGlobal(NativeNames[i]);
+                    NativeNames[i] = IntPtr.Zero;
+                    Values[i] = IntPtr.Zero;
+                    _names[i] = null;
+                    _boundValues[i] = null;
+                }
+                Count = 0;
+            }
+
+            private static TElement[] Resize<TElement>(TElement[] array, int capacity)
+            {
+                var resized = new TElement[capacity];
+                Array.Copy(array, resized, array.Length);
+                return resized;
+            }
+        }
+
+        #region destructors disposers
+
+        ~OrtIoBinding()
+        {
+            Dispose(false);
+        }
+
+        public void Dispose()
+        {
+            GC.SuppressFinalize(this);
+            Dispose(true);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            // the native names are the only unmanaged resources
+            _inputs.Clear();
+            _outputs.Clear();
+        }
+
+        #endregion
+    }
+}
@@ -291,6 +291,48 @@ namespace Microsoft.ML.OnnxRuntime.Tests
                     session.Run(inputNames, pinnedInputs, expectedOutputNames, pinnedOutputs);
                     validateRunResultData(outputTensor);
                 }
+
+                // Run inference repeatedly with inputs and outputs bound once
+                using (DisposableList<FixedBufferOnnxValue> pinnedInputs = new DisposableList<FixedBufferOnnxValue>(),
+                                                            pinnedOutputs = new DisposableList<FixedBufferOnnxValue>())
+                using (var ioBinding = session.CreateIoBinding())
+                {
+                    foreach (var input in container)
+                    {
+                        pinnedInputs.Add(FixedBufferOnnxValue.CreateFromTensor(input.AsTensor<float>()));
+                        ioBinding.BindInput(input.Name, pinnedInputs.Last());
+                    }
+
+                    var outputTensor = new DenseTensor<float>(expectedOutputDimensions);
+                    pinnedOutputs.Add(FixedBufferOnnxValue.CreateFromTensor(outputTensor));
+                    ioBinding.BindOutput(expectedOutputNames[0], pinnedOutputs[0]);
+
+                    for (int i = 0; i < 2; ++i)
+                    {
+                        outputTensor.Fill(0);
+                        session.RunWithBinding(ioBinding);
+                        validateRunResultData(outputTensor);
+                    }
+
+                    // rebinding a name replaces its value
+                    var outputBuffer = new float[outputTensor.Length];
+                    var outputHandle = GCHandle.Alloc(outputBuffer, GCHandleType.Pinned);
+                    try
+                    {
+                        pinnedOutputs.Add(FixedBufferOnnxValue.CreateFromMemory<float>("Cpu", 0, outputHandle.AddrOfPinnedObject(),
+                                                                                       outputBuffer.Length * sizeof(float),
+                                                                                       new long[] { 1, 1000, 1, 1 }));
+                        ioBinding.BindOutput(expectedOutputNames[0], pinnedOutputs[1]);
+                        session.RunWithBinding(ioBinding);
+                        validateRunResultData(new DenseTensor<float>(outputBuffer, expectedOutputDimensions));
+                    }
+                    finally
+                    {
+                        outputHandle.Free();
+                    }
+
+                    Assert.Throws<ArgumentException>(() => ioBinding.BindOutput("not_an_output", pinnedOutputs[0]));
+                }
             }
         }
 
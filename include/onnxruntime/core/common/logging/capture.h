@@ -33,6 +33,17 @@ class Capture {
       : logger_{&logger}, severity_{severity}, category_{category}, data_type_{dataType}, location_{location} {
   }
 
+  /**
+     Initializes a copy of a captured message, which isn't logged when destroyed. For sinks that output messages
+     after they were logged.
+     @param message The captured message.
+  */
+  Capture(logging::Severity severity, const char* category, logging::DataType dataType, const CodeLocation& location,
+          const std::string& message)
+      : logger_{nullptr}, severity_{severity}, category_{category}, data_type_{dataType}, location_{location} {
+    stream_ << message;
+  }
+
   /**
      The stream that can capture the message via operator<<.
      @returns Output stream.
@@ -55,6 +55,8 @@ namespace profiling {
 enum EventCategory {
   SESSION_EVENT = 0,
   NODE_EVENT,
+  MEMORY_EVENT,       // lifetime of a tensor, with its "location" and "size" in bytes as arguments
+  THREAD_POOL_EVENT,  // work item run by a thread pool worker, on the lane of the worker thread
   EVENT_CATEGORY_MAX
 };
 
@@ -63,7 +65,9 @@ Event descriptions for the above session events.
 */
 static constexpr const char* event_categor_names_[EVENT_CATEGORY_MAX] = {
     "Session",
-    "Node"};
+    "Node",
+    "Memory",
+    "ThreadPool"};
 
 /*
 Timing record for all events.
@@ -43,24 +43,34 @@
 
 */
 
+// Messages less severe than ORT_MINIMUM_LOG_SEVERITY (the integer value of a Severity) are compiled out, so they
+// cost neither the check of the logger severity nor code size. FATAL messages are always kept.
+#ifndef ORT_MINIMUM_LOG_SEVERITY
+#define ORT_MINIMUM_LOG_SEVERITY 0
+#endif
+
+#define ORT_LOG_SEVERITY_COMPILED_IN(severity)                                                                  \
+  (static_cast<int>(::onnxruntime::logging::Severity::k##severity) >= ORT_MINIMUM_LOG_SEVERITY ||             \
+   ::onnxruntime::logging::Severity::k##severity == ::onnxruntime::logging::Severity::kFATAL)
+
 // Logging with explicit category
 
 // iostream style logging. Capture log info in Message, and push to the logger in ~Message.
 #define LOGS_CATEGORY(logger, severity, category)                       \
-  if ((logger).OutputIsEnabled(::onnxruntime::logging::Severity::k##severity, ::onnxruntime::logging::DataType::SYSTEM)) \
+  if (ORT_LOG_SEVERITY_COMPILED_IN(severity) && (logger).OutputIsEnabled(::onnxruntime::logging::Severity::k##severity, ::onnxruntime::logging::DataType::SYSTEM)) \
     CREATE_MESSAGE(logger, severity, category, ::onnxruntime::logging::DataType::SYSTEM).Stream()
 
 #define LOGS_USER_CATEGORY(logger, severity, category)                  \
-    if ((logger).OutputIsEnabled(::onnxruntime::logging::Severity::k##severity, ::onnxruntime::logging::DataType::USER)) \
+    if (ORT_LOG_SEVERITY_COMPILED_IN(severity) && (logger).OutputIsEnabled(::onnxruntime::logging::Severity::k##severity, ::onnxruntime::logging::DataType::USER)) \
       CREATE_MESSAGE(logger, severity, category, ::onnxruntime::logging::DataType::USER).Stream()
 
     // printf style logging. Capture log info in Message, and push to the logger in ~Message.
 #define LOGF_CATEGORY(logger, severity, category, format_str, ...)      \
-    if ((logger).OutputIsEnabled(::onnxruntime::logging::Severity::k##severity, ::onnxruntime::logging::DataType::SYSTEM)) \
+    if (ORT_LOG_SEVERITY_COMPILED_IN(severity) && (logger).OutputIsEnabled(::onnxruntime::logging::Severity::k##severity, ::onnxruntime::logging::DataType::SYSTEM)) \
       CREATE_MESSAGE(logger, severity, category, ::onnxruntime::logging::DataType::SYSTEM).CapturePrintf(format_str, ##__VA_ARGS__)
 
 #define LOGF_USER_CATEGORY(logger, severity, category, format_str, ...) \
-    if ((logger).OutputIsEnabled(::onnxruntime::logging::Severity::k##severity, ::onnxruntime::logging::DataType::USER)) \
+    if (ORT_LOG_SEVERITY_COMPILED_IN(severity) && (logger).OutputIsEnabled(::onnxruntime::logging::Severity::k##severity, ::onnxruntime::logging::DataType::USER)) \
       CREATE_MESSAGE(logger, severity, category, ::onnxruntime::logging::DataType::USER).CapturePrintf(format_str, ##__VA_ARGS__)
 
     // Logging with category of "onnxruntime"
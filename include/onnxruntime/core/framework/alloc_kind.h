@@ -16,10 +16,10 @@ namespace onnxruntime {
 //   - tensor values: The lifetimes of these tensor-values are statically
 //     determined, which is used for memory reuse/sharing optimizations. The
 //     runtime allocates/frees these values at the right time (as determined
-//     by the static allocation plan). Note that this is simplified since we
-//     do not try to optimize for "slice" like ops, where we may be able to
-//     conditionally reuse memory/data in some cases but not others.
-//     Generalizing this is future work.
+//     by the static allocation plan). "Slice" like ops that may conditionally
+//     reuse the memory of their input produce values of kind kAllocateOrView:
+//     the kernel either creates the value as a view of a contiguous range of
+//     the input, or allocates it. The input buffer lives as long as the value.
 
 enum class AllocKind {
   kAllocate = 0,
@@ -27,7 +27,8 @@ enum class AllocKind {
   kPreExisting = 2,
   kAllocateStatically = 3,
   kAllocateOutput = 4,
-  kShare = 5
+  kShare = 5,
+  kAllocateOrView = 6
 };
 
 std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind);
@@ -55,6 +55,15 @@ class IExecutionProvider {
    */
   virtual AllocatorPtr GetAllocator(int id, OrtMemType mem_type) const;
 
+  /**
+   * Get the allocator of the initializers planned in the memory of GetAllocator(id, mem_type), which is that
+   * allocator unless the provider keeps the initializers in another memory its kernels can read, such as host memory
+   * mapped into the address space of the device.
+   */
+  virtual AllocatorPtr GetInitializerAllocator(int id, OrtMemType mem_type) const {
+    return GetAllocator(id, mem_type);
+  }
+
   /**
    * Returns a data transfer object that implements methods to copy to and
    * from this device.
@@ -138,6 +147,27 @@ class IExecutionProvider {
   */
   virtual common::Status OnRunEnd();
 
+  /**
+     Indicates whether the provider can capture the device work of a run into a graph (e.g. a CUDA graph)
+     and replay it on later runs instead of executing the kernels again.
+  */
+  virtual bool IsGraphCaptureEnabled() const { return false; }
+
+  /**
+     Called by InferenceSession::Run before OnRunStart when graph capture is enabled and all the nodes
+     of the session are assigned to this provider. run_signature identifies the shapes and the device
+     buffers of the feeds and fetches of the run, and is 0 if the run can't be replayed. A graph captured
+     for another signature is discarded.
+     @return true if a graph was captured for run_signature, in which case ReplayGraph is called instead
+     of executing the session graph.
+  */
+  virtual bool PrepareGraphReplay(uint64_t /*run_signature*/) { return false; }
+
+  /**
+     Replays the graph captured for the current run signature and blocks until it has completed.
+  */
+  virtual common::Status ReplayGraph();
+
   /**
      Called when session creation is complete
      This provides an opportunity for execution providers to optionally synchronize and
@@ -64,6 +64,10 @@ class KernelDef {
     return alias_map_;
   }
 
+  const std::vector<std::pair<int, int>>& MayView() const {
+    return view_map_;
+  }
+
   OrtMemType InputMemoryType(size_t input_index) const {
     auto it = input_memory_type_args_.find(input_index);
     if (it == input_memory_type_args_.end())
@@ -118,6 +122,10 @@ class KernelDef {
   // An element <i, j> means that output j is an alias of input i.
   std::vector<std::pair<int, int>> alias_map_;
 
+  // An element <i, j> means that output j may be a view of a contiguous range of input i.
+  // j is -1 if all the outputs may be views of input i.
+  std::vector<std::pair<int, int>> view_map_;
+
   // The memory types of inputs/outputs of this kernel
   MemTypeMap input_memory_type_args_;
   MemTypeMap output_memory_type_args_;
@@ -201,6 +209,15 @@ class KernelDefBuilder {
   KernelDefBuilder& Alias(const std::vector<std::pair<int, int>>& aliases);
   KernelDefBuilder& Alias(int input_index, int output_index);
 
+  /**
+     View mapping from inputs to outputs. The kernel may produce the output as
+     a view of a contiguous range of the input (see OpKernelContext::OutputView),
+     e.g. for a Slice along the outermost axis, and allocates it otherwise.
+     The runtime then keeps the input buffer alive as long as the output.
+     An output_index of -1 applies to all the outputs, e.g. the variadic outputs of Split.
+  */
+  KernelDefBuilder& MayView(int input_index, int output_index);
+
   /**
      Specify that this kernel requires an input arg
      in certain memory type (instead of the default, device memory).
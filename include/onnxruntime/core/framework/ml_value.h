@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
@@ -32,6 +33,12 @@ struct OrtValue {
     type_ = type;
   }
 
+  // For data whose release needs state, e.g. a buffer borrowed from another framework.
+  void Init(void* pData, onnxruntime::MLDataType type, const std::function<void(void*)>& deleter) {
+    data_.reset(pData, deleter);
+    type_ = type;
+  }
+
   bool IsAllocated() const {
     return data_ && type_;
   }
@@ -104,6 +104,12 @@ class OpKernelContext {
   // Return nullptr if the output is an unused optional output.
   Tensor* Output(int index, const TensorShape& shape);
 
+  // Creates the output tensor as a view of a contiguous range of the input tensor at input_index, with the given
+  // shape and starting byte_offset bytes into the input data. The kernel def must declare the pair with MayView.
+  // Return nullptr if the output can't be a view (e.g. it is a graph output), in which case the kernel must call
+  // Output and copy the data.
+  Tensor* OutputView(int index, const TensorShape& shape, int input_index, size_t byte_offset);
+
   // Fetch a sparse-tensor output corresponding to the specified index.
   // num_values must specify the number of non-zero values (commonly known as NNZ/nnz),
   // and shape must specify the shape of the underlying dense-tensor.
@@ -117,17 +123,17 @@ class OpKernelContext {
 
   // always >= 0
   int InputCount() const {
-    return static_cast<int>(kernel_->Node().InputDefs().size());
+    return input_count_;
   }
 
   // always >= 0
   int ImplicitInputCount() const {
-    return static_cast<int>(kernel_->Node().ImplicitInputDefs().size());
+    return implicit_input_count_;
   }
 
   // always >= 0
   int OutputCount() const {
-    return static_cast<int>(kernel_->Node().OutputDefs().size());
+    return output_count_;
   }
 
   /**
@@ -180,9 +186,23 @@ class OpKernelContext {
  protected:
   onnxruntime::NodeIndex GetNodeIndex() const;
 
-  const OrtValue* GetInputMLValue(int index) const;
-  const OrtValue* GetImplicitInputMLValue(int index) const;
-  OrtValue* GetOutputMLValue(int index);
+  const OrtValue* GetInputMLValue(int index) const {
+    if (index < 0 || index >= input_count_)
+      return nullptr;
+    return GetArgMLValue(index);
+  }
+
+  const OrtValue* GetImplicitInputMLValue(int index) const {
+    if (index < 0 || index >= implicit_input_count_)
+      return nullptr;
+    return GetArgMLValue(input_count_ + index);
+  }
+
+  OrtValue* GetOutputMLValue(int index) {
+    if (index < 0 || index >= output_count_)
+      return nullptr;
+    return GetArgMLValue(input_count_ + implicit_input_count_ + index);
+  }
 
   // Creates the OrtValue* based on the shape, if it does not exist
   // The parameter nnz is used only for sparse-tensors and indicates the
@@ -198,15 +218,31 @@ class OpKernelContext {
   int GetImplicitInputArgIndex(int index) const;
   int GetOutputArgIndex(int index) const;
 
+  // Return nullptr if the argument is an unused optional input/output.
+  // arg_index counts the inputs, implicit inputs and outputs of the node, in that order.
+  OrtValue* GetArgMLValue(int arg_index) const {
+    int ort_value_idx = arg_ort_value_idxs_[arg_index];
+    return ort_value_idx >= 0 ? frame_values_ + ort_value_idx : nullptr;
+  }
+
   IExecutionFrame* const execution_frame_;
   const OpKernel* const kernel_;
   concurrency::ThreadPool* const threadpool_;
   const logging::Logger* const logger_;
 
+  int input_count_;
+  int implicit_input_count_;
+  int output_count_;
+
   // The argument starting index in ExecutionFrame.
   int node_input_start_index_{-1};
   int node_implicit_input_start_index_{-1};
   int node_output_start_index_{-1};
+
+  // The ort_value index of each argument of the node, and the frame values they index. Resolved once when the
+  // context is created, so that accessing an argument doesn't go through the frame and NodeIndexInfo every time.
+  const int* arg_ort_value_idxs_{nullptr};
+  OrtValue* frame_values_{nullptr};
 };
 
 // Fetching output tensor without shape is not allowed except when it already exists
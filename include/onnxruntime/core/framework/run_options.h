@@ -29,6 +29,14 @@ struct OrtRunOptions {
   // Set to 'true' to run in training mode.
   bool training_mode = false;
 
+  // Set to 'true' to release memory arena regions that are not in use back to the device once the Run completes.
+  // Use this after a Run with unusually large inputs so the memory it needed isn't held by the session.
+  bool shrink_memory_arenas = false;
+
+  // Set to 'true' to have the Python binding return outputs as writable copies.
+  // By default CPU outputs are returned as read-only numpy arrays sharing the buffers of the output OrtValues.
+  bool copy_outputs = false;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 
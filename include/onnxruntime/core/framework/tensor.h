@@ -212,6 +212,13 @@ class Tensor final {
   */
   size_t SizeInBytes() const;
 
+  /**
+  Whether the tensor releases its buffer when destroyed, rather than borrowing it.
+  */
+  bool OwnsBuffer() const noexcept {
+    return buffer_deleter_ != nullptr;
+  }
+
   // More API methods.
  private:
   void Init(MLDataType p_type,
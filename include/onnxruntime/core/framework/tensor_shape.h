@@ -5,8 +5,10 @@
 #include <iosfwd>
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <cstring>
+#include "gsl/gsl"
 #include "onnxruntime_config.h"
 
 namespace onnxruntime {
@@ -16,45 +18,50 @@ namespace onnxruntime {
 #pragma GCC diagnostic ignored "-Wnull-dereference"
 #endif
 #endif
-class TensorShape : private std::vector<int64_t> {
-  // TODO - Use a custom STL allocator to avoid heap allocations in the common case.
+class TensorShape {
   // We use negative numbers for unknown symbolic dimension. Each negative
   // number represents a unique symbolic dimension.
-  // Private inheritance is used to prevent ambiguity of element versus dimension size
+  // Shapes of up to kInlineDims dimensions are stored in the object itself, so creating, copying and destroying
+  // the shape of most tensors doesn't allocate. Larger shapes are stored in a heap allocated std::vector.
+  // GetDims() returns a std::vector, so its first call on an inline shape moves the dims to a vector,
+  // which the shape keeps using from then on. Prefer GetDimsAsSpan() in code that runs for every tensor.
  public:
-  TensorShape() = default;
+  static constexpr size_t kInlineDims = 6;
 
-  TensorShape(const TensorShape& /*other*/) = default;
-  TensorShape& operator=(const TensorShape& /*other*/) = default;
+  TensorShape() noexcept = default;
 
-  TensorShape(TensorShape&& /*other*/) = default;
-  TensorShape& operator=(TensorShape&& /*other*/) = default;
+  TensorShape(const TensorShape& other) : TensorShape(other.Data(), other.num_dims_) {}
+  TensorShape& operator=(const TensorShape& other);
 
-  TensorShape(const std::vector<int64_t>& dims) : std::vector<int64_t>(dims) {}
+  TensorShape(TensorShape&& other) noexcept;
+  TensorShape& operator=(TensorShape&& other) noexcept;
 
-  TensorShape(std::vector<int64_t>&& dims) : std::vector<int64_t>(std::move(dims)) {}
+  ~TensorShape() { delete spilled_dims_.load(std::memory_order_relaxed); }
 
-  TensorShape(const std::initializer_list<int64_t>& dims) : std::vector<int64_t>(dims) {}
+  TensorShape(const std::vector<int64_t>& dims) : TensorShape(dims.data(), dims.size()) {}
+
+  TensorShape(std::vector<int64_t>&& dims);
+
+  TensorShape(const std::initializer_list<int64_t>& dims) : TensorShape(dims.begin(), dims.size()) {}
 
   TensorShape(const int64_t* dimension_sizes, size_t dimension_count);
 
-  TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end);
+  TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end)
+      : TensorShape(dims.data() + start, end - start) {}
 
   /**
      Return the dimension specified by <idx>.
   */
   const int64_t& operator[](size_t idx) const {
-    return std::vector<int64_t>::operator[](static_cast<int>(idx));
+    return Data()[idx];
   }
 
   int64_t& operator[](size_t idx) {
-    return std::vector<int64_t>::operator[](static_cast<int>(idx));
+    return Data()[idx];
   }
 
   bool operator==(const TensorShape& other) const noexcept {
-    auto thisVector = static_cast<const std::vector<int64_t>*>(this);
-    auto otherVector = static_cast<const std::vector<int64_t>*>(&other);
-    return *thisVector == *otherVector;
+    return num_dims_ == other.num_dims_ && std::equal(Data(), Data() + num_dims_, other.Data());
   }
 
   bool operator!=(const TensorShape& other) const noexcept {
@@ -62,20 +69,31 @@ class TensorShape : private std::vector<int64_t> {
   }
 
   size_t NumDimensions() const noexcept {
-    return size();
+    return num_dims_;
   }
 
   /**
      Copy dims into an array with given size
   */
   void CopyDims(int64_t* dims, size_t num_dims) const {
-    memcpy(dims, data(), sizeof(value_type) * std::min(num_dims, NumDimensions()));
+    memcpy(dims, Data(), sizeof(int64_t) * std::min(num_dims, NumDimensions()));
   }
 
   /**
      Return underlying vector representation.
+     The first call on a shape stored inline allocates the vector.
+  */
+  const std::vector<int64_t>& GetDims() const {
+    const std::vector<int64_t>* dims = spilled_dims_.load(std::memory_order_acquire);
+    return dims != nullptr ? *dims : SpillDims();
+  }
+
+  /**
+     Return the dims without allocating.
   */
-  const std::vector<int64_t>& GetDims() const { return *this; }
+  gsl::span<const int64_t> GetDimsAsSpan() const {
+    return gsl::make_span(Data(), num_dims_);
+  }
 
   /**
    * Return the total number of elements. Returns 1 for an empty (rank 0) TensorShape.
@@ -125,14 +143,40 @@ class TensorShape : private std::vector<int64_t> {
      empty shape or 1D shape (1) is regarded as scalar tensor
   */
   bool IsScalar() const {
-    size_t len = size();
+    size_t len = num_dims_;
     return len == 0 || (len == 1 && operator[](0) == 1);
   }
 
-  static const TensorShape& ReinterpretBaseType(const std::vector<int64_t>& dimensions) {
-    static_assert(sizeof(TensorShape) == sizeof(std::vector<int64_t>), "Size of TensorShape prevents safe casting from vector");
-    return *static_cast<const TensorShape*>(&dimensions);
+  /**
+     Return a TensorShape with the given dimensions. It no longer aliases the vector,
+     but doesn't allocate for up to kInlineDims dimensions.
+  */
+  static TensorShape ReinterpretBaseType(const std::vector<int64_t>& dimensions) {
+    return TensorShape(dimensions);
+  }
+
+ private:
+  const int64_t* Data() const noexcept {
+    const std::vector<int64_t>* dims = spilled_dims_.load(std::memory_order_acquire);
+    return dims != nullptr ? dims->data() : inline_dims_;
+  }
+
+  int64_t* Data() noexcept {
+    std::vector<int64_t>* dims = spilled_dims_.load(std::memory_order_acquire);
+    return dims != nullptr ? dims->data() : inline_dims_;
   }
+
+  // Overwrites the dims, keeping the vector returned by GetDims() if there is one, as std::vector assignment does.
+  void Assign(const int64_t* dims, size_t num_dims);
+
+  // Moves inline dims to a vector for GetDims(). Concurrent readers of a const shape may race to do it,
+  // so the vector is published with a compare-exchange and the dims are never written back inline.
+  const std::vector<int64_t>& SpillDims() const;
+
+  int64_t inline_dims_[kInlineDims];
+  size_t num_dims_ = 0;
+  // Holds the dims once there are more than kInlineDims of them, or after GetDims() was called.
+  mutable std::atomic<std::vector<int64_t>*> spilled_dims_{nullptr};
 };
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
@@ -304,6 +304,9 @@ class Node {
   @remarks Creates a new vector so calling ContainsSubgraphs first is preferred. */
   std::vector<gsl::not_null<const Graph*>> GetSubgraphs() const;
 
+  /** Gets the Graph instance that contains this Node. */
+  const Graph& GetContainingGraph() const noexcept { return *graph_; }
+
   /** Gets a map of attribute name to the mutable Graph instances for all subgraphs of the Node.
   @returns Map of the attribute name that defines the subgraph to the subgraph's Graph instance.
            nullptr if the Node has no subgraphs.
@@ -479,6 +482,10 @@ class Node {
 
   // Graph instances for subgraphs that are owned by this Node
   std::vector<std::unique_ptr<Graph>> subgraphs_;
+
+  // Hash of the input and output types seen by the last type and shape inferencing of this Node in Resolve.
+  // 0 if the Node must be inferred by the next Resolve, e.g. because its attributes changed.
+  size_t inferred_types_hash_ = 0;
 };
 
 /**
@@ -1048,6 +1055,9 @@ class Graph {
   // information matches between node and op.
   common::Status VerifyNodeAndOpMatch(const ResolveOptions& options);
 
+  // Returns true if the Node consumes an initializer that was added, removed or replaced since the last Resolve.
+  bool ConsumesModifiedInitializer(const Node& node) const;
+
   // Set graph inputs/outputs when resolving a graph..
   common::Status SetGraphInputsOutputs();
 
@@ -1196,6 +1206,10 @@ class Graph {
   // these don't get recorded as graph inputs in the GraphProto.
   std::unordered_set<std::string> outer_scope_node_arg_names_;
 
+  // Initializers added, removed or replaced since the last Resolve. Type and shape inferencing may read initializer
+  // values, so nodes consuming them are inferred again even if their input types are unchanged.
+  std::unordered_set<std::string> modified_initializers_;
+
   // number of times Resolve has run.
   int num_resolves_ = 0;
 
@@ -12,6 +12,10 @@
 namespace onnxruntime {
 struct FreeDimensionOverride;
 
+namespace concurrency {
+class ThreadPool;
+}
+
 namespace optimizer_utils {
 
 /** Generates all predefined rules for this level.
@@ -22,10 +26,14 @@ std::vector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(TransformerLevel
 
 /** Generates all predefined (both rule-based and non-rule-based) transformers for this level.
     If transformers_and_rules_to_enable is not empty, it returns the intersection between the predefined transformers/rules 
-    and the transformers_and_rules_to_enable. */
+    and the transformers_and_rules_to_enable.
+    The transformers may run independent computations, such as constant folding, in parallel on thread_pool.
+    See ConstantFolding for constant_folding_max_size_ratio. */
 std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerLevel level,
                                                                     gsl::span<const FreeDimensionOverride> free_dimension_overrides,
-                                                                    const std::vector<std::string>& rules_and_transformers_to_enable = {});
+                                                                    const std::vector<std::string>& rules_and_transformers_to_enable = {},
+                                                                    concurrency::ThreadPool* thread_pool = nullptr,
+                                                                    float constant_folding_max_size_ratio = 16.f);
 
 /** Given a TransformerLevel, this method generates a name for the rule-based graph transformer of that level. */
 std::string GenerateRuleBasedTransformerName(TransformerLevel level);
@@ -9,6 +9,8 @@
 
 /* Modifications Copyright (c) Microsoft. */
 
+#include <chrono>
+#include <thread>
 #include <type_traits>
 
 #pragma once
@@ -33,8 +35,10 @@
 #pragma warning(pop)
 #endif
 #include "core/common/make_unique.h"
+#include "core/common/logging/logging.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/Barrier.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -53,6 +57,36 @@ class ExtendedThreadPoolInterface : public Eigen::ThreadPoolInterface {
   virtual void RunInParallel(std::function<void()> fn, unsigned n) = 0;
 };
 
+// A loop offered to the workers of a parallel section.  Up to workers_wanted
+// of them run a copy of fn alongside the thread that owns the section.
+struct ThreadPoolLoop {
+  ThreadPoolLoop(std::function<void()> f, uint64_t s, int n) : fn(std::move(f)), seq(s), workers_wanted(n) {
+  }
+  std::function<void()> fn;
+  const uint64_t seq;
+  std::atomic<int> workers_wanted;
+};
+
+// State of a parallel section (see ThreadPool::ParallelSection).  The team of
+// workers polls current_seq for new loops while the section is active, and a
+// worker joining a loop is counted in workers_in_loop until it has finished
+// with it.  The owning thread withdraws current_loop when its own copy of the
+// function is complete, and then waits for workers_in_loop to drop to zero
+// before the loop is deallocated.
+struct ThreadPoolParallelSection {
+  std::atomic<bool> active{false};
+  std::atomic<ThreadPoolLoop*> current_loop{nullptr};
+  std::atomic<uint64_t> current_seq{0};
+  std::atomic<unsigned> workers_in_loop{0};
+  std::atomic<unsigned> workers_running{0};  // Team work items that have been queued and not yet exited
+
+  // Accessed only by the owning thread
+  bool started{false};
+  bool in_loop{false};
+  uint64_t last_seq{0};
+  std::vector<std::pair<int, unsigned>> pending_items;
+};
+
 }  // namespace concurrency
 
 template <typename Work, typename Tag, unsigned kSize>
@@ -400,11 +434,14 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 #else
   using CHAR_TYPE = char;
 #endif
+  // If adaptive_spinning is set (and allow_spinning too), each worker tunes how
+  // long it spins before parking from the gaps it observes between work items.
   ThreadPoolTempl(const CHAR_TYPE* name, int num_threads, bool allow_spinning, Environment& env,
-                  const ThreadOptions& thread_options)
+                  const ThreadOptions& thread_options, bool adaptive_spinning = false)
       : env_(env),
         num_threads_(num_threads),
         allow_spinning_(allow_spinning),
+        adaptive_spinning_(allow_spinning && adaptive_spinning),
         worker_data_(num_threads),
         all_coprimes_(num_threads),
         blocked_(0),
@@ -431,6 +468,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
     worker_data_.resize(num_threads_);
     for (int i = 0; i < num_threads_; i++) {
+      worker_data_[i].spin_budget.store(allow_spinning_ ? kMaxSpinCount : 0, std::memory_order_relaxed);
       worker_data_[i].thread.reset(env_.CreateThread(name, i, WorkerLoop, this, thread_options));
     }
   }
@@ -460,8 +498,11 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     PerThread* pt = GetPerThread();
     if (pt->pool == this) {
       // Worker thread of this pool, push onto the thread's queue.
-      Queue& q = worker_data_[pt->thread_id].queue;
-      t = q.PushFront(std::move(t));
+      WorkerData& td = worker_data_[pt->thread_id];
+      t = td.queue.PushFront(std::move(t));
+      if (!t.f) {
+        RecordPush(td);
+      }
     } else {
       // A free-standing thread (or worker of another pool), push onto a random
       // queue.
@@ -474,6 +515,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         env_.ExecuteTask(t);
       } else {
         // The queue accepted the work; ensure that the thread will pick it up
+        RecordPush(td);
         td.EnsureAwake();
       }
     }
@@ -590,6 +632,7 @@ void RunInParallel(std::function<void()> fn, unsigned n) override {
       } else {
         // The queue accepted the work, ensure that the thread is servicing the queue
         pending_items.push_back({q_idx, w_idx});
+        RecordPush(td);
         td.EnsureAwake();
       }
     }
@@ -614,6 +657,88 @@ void RunInParallel(std::function<void()> fn, unsigned n) override {
   }
 }
 
+// Start a parallel section by queueing a work item for each of the other threads
+// in the pool.  Each work item runs the loops offered to the section until it
+// ends.  If the calling thread is already running in parallel then the section
+// gets no team, and its loops run directly in the caller.
+void StartParallelSection(concurrency::ThreadPoolParallelSection& ps) {
+  PerThread* my_pt = GetPerThread();
+  if (my_pt->in_parallel) {
+    return;
+  }
+  my_pt->in_parallel = true;
+  if (!my_pt->tag.Get()) {
+    my_pt->tag = Tag::GetNext();
+  }
+  ps.started = true;
+  ps.active = true;
+  for (int q_idx = 0; q_idx < num_threads_; q_idx++) {
+    if (my_pt->pool == this && my_pt->thread_id == q_idx) {
+      continue;
+    }
+    ps.workers_running++;
+    Task t = env_.CreateTask([this, &ps]() {
+      RunParallelSectionWorker(ps);
+    });
+    WorkerData& td = worker_data_[q_idx];
+    unsigned w_idx;
+    t = td.queue.PushBackWithTag(std::move(t), my_pt->tag, w_idx);
+    if (t.f) {
+      // The queue rejected the work, the section makes do with a smaller team
+      ps.workers_running--;
+    } else {
+      ps.pending_items.push_back({q_idx, w_idx});
+      RecordPush(td);
+      td.EnsureAwake();
+    }
+  }
+}
+
+// Run fn with up to n degree-of-parallelism using the team of the section.  As
+// with RunInParallel, the caller runs one copy of fn itself.
+void RunInParallelSection(concurrency::ThreadPoolParallelSection& ps, std::function<void()> fn, unsigned n) {
+  assert(n >= 1);
+  if (n == 1 || !ps.started || ps.in_loop || ps.pending_items.empty()) {
+    // Loops nested within a loop of the section run directly in the caller
+    fn();
+    return;
+  }
+  concurrency::ThreadPoolLoop loop(std::move(fn), ++ps.last_seq, static_cast<int>(n) - 1);
+  ps.in_loop = true;
+  ps.current_loop = &loop;
+  ps.current_seq = loop.seq;
+  try {
+    loop.fn();
+  } catch (...) {
+    EndParallelSectionLoop(ps);
+    throw;
+  }
+  EndParallelSectionLoop(ps);
+}
+
+// Wait for the team to exit, revoking the work items that have not started.
+void EndParallelSection(concurrency::ThreadPoolParallelSection& ps) {
+  if (!ps.started) {
+    return;
+  }
+  PerThread* my_pt = GetPerThread();
+  ps.active = false;
+  for (auto& item : ps.pending_items) {
+    Queue& q = worker_data_[item.first].queue;
+    if (q.RevokeWithTag(my_pt->tag, item.second)) {
+      ps.workers_running--;
+    }
+  }
+  for (int i = 0; ps.workers_running != 0; i++) {
+    if (i % 64 == 63) {
+      std::this_thread::yield();
+    }
+  }
+  ps.pending_items.clear();
+  ps.started = false;
+  my_pt->in_parallel = false;
+}
+
 void Cancel() override {
   cancelled_ = true;
   // If done_ is true, which means this object is being destructing.
@@ -643,6 +768,50 @@ int CurrentThreadId() const EIGEN_FINAL {
   return -1;
 }
 
+// Sum the spin-wait statistics of all the workers.  The counters are read
+// without synchronization, so the totals are only a snapshot.
+void GetSpinStats(uint64_t* num_spins, uint64_t* num_parks, uint64_t* num_wakeups, uint64_t* spin_budget) const {
+  *num_spins = *num_parks = *num_wakeups = *spin_budget = 0;
+  for (int i = 0; i < num_threads_; i++) {
+    const WorkerData& td = worker_data_[i];
+    *num_spins += td.num_spins.load(std::memory_order_relaxed);
+    *num_parks += td.num_parks.load(std::memory_order_relaxed);
+    *num_wakeups += td.num_wakeups.load(std::memory_order_relaxed);
+    *spin_budget += static_cast<uint64_t>(td.spin_budget.load(std::memory_order_relaxed));
+  }
+}
+
+// Turn the instrumentation of the workers on or off.  While it is on, the
+// workers time the work items they run and the waits between them, count the
+// work items they steal, and record a trace event per work item.  The depth
+// of the queues is sampled whenever work is pushed to them.
+void SetProfiling(bool enabled) {
+  profiling_.store(enabled, std::memory_order_relaxed);
+}
+
+void GetWorkerStats(std::vector<concurrency::ThreadPoolWorkerStats>& stats) const {
+  stats.resize(num_threads_);
+  for (int i = 0; i < num_threads_; i++) {
+    const WorkerData& td = worker_data_[i];
+    auto& worker_stats = stats[i];
+    worker_stats.num_tasks = td.num_tasks.load(std::memory_order_relaxed);
+    worker_stats.num_steals = td.num_steals.load(std::memory_order_relaxed);
+    worker_stats.busy_ns = td.busy_ns.load(std::memory_order_relaxed);
+    worker_stats.idle_ns = td.idle_ns.load(std::memory_order_relaxed);
+    worker_stats.num_pushes = td.num_pushes.load(std::memory_order_relaxed);
+    worker_stats.queue_depth_sum = td.queue_depth_sum.load(std::memory_order_relaxed);
+    worker_stats.max_queue_depth = td.max_queue_depth.load(std::memory_order_relaxed);
+  }
+}
+
+void TakeTraceEvents(std::vector<concurrency::ThreadPoolTraceEvent>& events) {
+  for (auto& td : worker_data_) {
+    std::lock_guard<OrtMutex> lock(td.trace_mutex);
+    events.insert(events.end(), td.trace_events.begin(), td.trace_events.end());
+    td.trace_events.clear();
+  }
+}
+
  private:
 
 #ifdef NDEBUG
@@ -753,6 +922,7 @@ int CurrentThreadId() const EIGEN_FINAL {
         assert(seen != ThreadStatus::Blocking);
         if (seen == ThreadStatus::Blocked) {
           status = ThreadStatus::Waking;
+          num_wakeups.fetch_add(1, std::memory_order_relaxed);
           cv.notify_one();
         }
       }
@@ -777,6 +947,7 @@ int CurrentThreadId() const EIGEN_FINAL {
       status = ThreadStatus::Blocking;
       if (should_block()) {
         status = ThreadStatus::Blocked;
+        num_parks.fetch_add(1, std::memory_order_relaxed);
         while (status == ThreadStatus::Blocked) {
           cv.wait(lk);
         }
@@ -785,20 +956,49 @@ int CurrentThreadId() const EIGEN_FINAL {
       status = ThreadStatus::Spinning;
     }
 
+    // Spin-wait statistics: the number of times the worker started spinning
+    // for work, parked on the condition variable, and was woken from it.
+    std::atomic<uint64_t> num_spins{0};
+    std::atomic<uint64_t> num_parks{0};
+    std::atomic<uint64_t> num_wakeups{0};
+    // The number of iterations the worker spins for before blocking
+    std::atomic<int> spin_budget{0};
+
+    // Instrumentation, updated while profiling_ is set.  The trace events are
+    // added by the thread itself and taken by TakeTraceEvents.
+    std::atomic<uint64_t> num_tasks{0};
+    std::atomic<uint64_t> num_steals{0};
+    std::atomic<uint64_t> busy_ns{0};
+    std::atomic<uint64_t> idle_ns{0};
+    std::atomic<uint64_t> num_pushes{0};
+    std::atomic<uint64_t> queue_depth_sum{0};
+    std::atomic<uint64_t> max_queue_depth{0};
+    unsigned int os_thread_id{0};
+    OrtMutex trace_mutex;
+    std::vector<concurrency::ThreadPoolTraceEvent> trace_events;
+
   private:
     std::atomic<ThreadStatus> status{ThreadStatus::Spinning};
     OrtMutex mutex;
     OrtCondVar cv;
   };
 
+  // The number of iterations an idle worker spins for before blocking, or the most with adaptive spinning
+  static constexpr int kMaxSpinCount = 1 << 20;
+
   Environment& env_;
   const int num_threads_;
   const bool allow_spinning_;
+  const bool adaptive_spinning_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
   std::atomic<unsigned> blocked_;  // Count of blocked workers, used as a termination condition
   std::atomic<bool> done_;
   std::atomic<bool> cancelled_;
+  std::atomic<bool> profiling_{false};
+
+  // Trace events kept per worker until they are taken.
+  static constexpr size_t kMaxTraceEventsPerWorker = 64 * 1024;
 
   // Allow control over how many bits to use in each entry in good_worker_hints_.
   // We reduce this below the full 64-bit word size for two reasons.  First, it
@@ -822,6 +1022,93 @@ int CurrentThreadId() const EIGEN_FINAL {
     }
   }
 
+  // Sample the depth of a queue that accepted a work item.
+  void RecordPush(WorkerData& td) {
+    if (!profiling_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    const uint64_t depth = td.queue.Size();
+    td.num_pushes.fetch_add(1, std::memory_order_relaxed);
+    td.queue_depth_sum.fetch_add(depth, std::memory_order_relaxed);
+    uint64_t max_depth = td.max_queue_depth.load(std::memory_order_relaxed);
+    while (depth > max_depth &&
+           !td.max_queue_depth.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed)) {
+    }
+  }
+
+  // Count a work item that the calling worker took from the queue of the victim.
+  void RecordSteal(unsigned victim) {
+    const PerThread* pt = GetPerThread();
+    if (profiling_.load(std::memory_order_relaxed) && pt->pool == this &&
+        victim != static_cast<unsigned>(pt->thread_id)) {
+      worker_data_[pt->thread_id].num_steals.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // Run a work item with the instrumentation on, from a worker that started
+  // waiting for it at wait_start (if set).
+  void ExecuteProfiledTask(WorkerData& td, int thread_id, Task& t, const TimePoint& wait_start) {
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+    const TimePoint start = std::chrono::high_resolution_clock::now();
+    env_.ExecuteTask(t);
+    const TimePoint end = std::chrono::high_resolution_clock::now();
+
+    td.num_tasks.fetch_add(1, std::memory_order_relaxed);
+    if (wait_start != TimePoint()) {
+      td.idle_ns.fetch_add(duration_cast<nanoseconds>(start - wait_start).count(), std::memory_order_relaxed);
+    }
+    td.busy_ns.fetch_add(duration_cast<nanoseconds>(end - start).count(), std::memory_order_relaxed);
+
+    std::lock_guard<OrtMutex> lock(td.trace_mutex);
+    if (td.trace_events.size() < kMaxTraceEventsPerWorker) {
+      td.trace_events.push_back({thread_id, td.os_thread_id, start, end});
+    }
+  }
+
+  // Withdraw the current loop of a parallel section, and wait for the workers
+  // that joined it to finish.  The increment of workers_in_loop by a joining
+  // worker is ordered before its load of current_loop, so either the worker sees
+  // the loop withdrawn, or we see the worker counted.
+  void EndParallelSectionLoop(concurrency::ThreadPoolParallelSection& ps) {
+    ps.current_loop = nullptr;
+    for (int i = 0; ps.workers_in_loop != 0; i++) {
+      if (i % 1024 == 1023) {
+        std::this_thread::yield();
+      }
+    }
+    ps.in_loop = false;
+  }
+
+  // Body of the work item run by each member of a parallel section's team.
+  void RunParallelSectionWorker(concurrency::ThreadPoolParallelSection& ps) {
+    uint64_t last_seq = 0;
+    for (int idle = 0; ps.active; idle++) {
+      const uint64_t seq = ps.current_seq;
+      if (seq == last_seq) {
+        // Spin waiting for the next loop, yielding occasionally in case we
+        // are keeping the owning thread from running
+        if (idle % 1024 == 1023) {
+          std::this_thread::yield();
+        }
+        continue;
+      }
+      ps.workers_in_loop++;
+      concurrency::ThreadPoolLoop* loop = ps.current_loop;
+      if (loop != nullptr) {
+        last_seq = loop->seq;
+        if (loop->workers_wanted.fetch_sub(1) > 0) {
+          loop->fn();
+        }
+      } else {
+        last_seq = seq;
+      }
+      ps.workers_in_loop--;
+      idle = 0;
+    }
+    ps.workers_running--;
+  }
+
   // Main worker thread loop.
   void WorkerLoop(int thread_id) {
     PerThread* pt = GetPerThread();
@@ -831,15 +1118,28 @@ int CurrentThreadId() const EIGEN_FINAL {
     pt->pool = this;
     pt->rand = GlobalThreadIdHash();
     pt->thread_id = thread_id;
+    td.os_thread_id = logging::GetThreadId();
 
     assert(td.GetStatus() == WorkerData::ThreadStatus::Spinning);
     SetGoodWorkerHint(thread_id, true /* Is good */);
 
-    const int log2_spin = 20;
-    const int spin_count = allow_spinning_ ? (1ull<<log2_spin) : 0;
-    const int steal_count = spin_count/100;
+    const int max_spin_count = allow_spinning_ ? kMaxSpinCount : 0;
+    // With adaptive spinning the spin budget moves between these bounds: it
+    // shrinks towards twice the observed wait when work arrives while spinning,
+    // doubles when work arrives shortly after giving up, and halves when the
+    // worker stays parked for longer. A park shorter than the spin, or than
+    // kShortPark, counts as short: a worker woken that soon has paid for a
+    // wake-up that spinning a little longer would have avoided.
+    const int min_spin_count = std::min(max_spin_count, 1 << 10);
+    int spin_count = max_spin_count;
+    using Clock = std::chrono::steady_clock;
+    constexpr Clock::duration kShortPark = std::chrono::milliseconds(1);
 
     while (!cancelled_ && !should_exit) {
+        // Profiling may be enabled while the thread waits, in which case the wait is not counted
+        const TimePoint wait_start = profiling_.load(std::memory_order_relaxed)
+                                         ? std::chrono::high_resolution_clock::now()
+                                         : TimePoint();
         Task t = q.PopFront();
         if (!t.f) {
           // Spin waiting for work.  We indicate, via SetGOodWorkerHint that we are
@@ -848,18 +1148,30 @@ int CurrentThreadId() const EIGEN_FINAL {
           // threads which are not themselves spinning.
 
           SetGoodWorkerHint(thread_id, true);
-          for (int i = 0; i < spin_count && !t.f && !cancelled_ && !done_; i++) {
+          td.num_spins.fetch_add(1, std::memory_order_relaxed);
+          const int steal_count = std::max(1, spin_count / 100);
+          const Clock::time_point spin_start = adaptive_spinning_ ? Clock::now() : Clock::time_point();
+          int i = 0;
+          for (; i < spin_count && !t.f && !cancelled_ && !done_; i++) {
             t = (i%steal_count == 0) ? TrySteal() : q.PopFront();
           }
           SetGoodWorkerHint(thread_id, false);
 
+          if (t.f && adaptive_spinning_) {
+            spin_count = std::max(min_spin_count, std::max(spin_count - spin_count / 8, std::min(2 * i, max_spin_count)));
+            td.spin_budget.store(spin_count, std::memory_order_relaxed);
+          }
+
           if (!t.f) {
+            const Clock::duration spin_time = adaptive_spinning_ ? Clock::now() - spin_start : Clock::duration();
             // No work passed to us while spinning; make a further full attempt to
             // steal work from other threads prior to blocking.
             if (num_threads_ != 1) {
               t = Steal(true /* true => check all queues */);
             }
             if (!t.f) {
+              bool parked = false;
+              Clock::time_point park_start;
               td.SetBlocked(
                   // Pre-block test
                   [&]() -> bool {
@@ -871,6 +1183,9 @@ int CurrentThreadId() const EIGEN_FINAL {
                       should_block = false;
                       if (!cancelled_) {
                         t = worker_data_[victim].queue.PopBack();
+                        if (t.f) {
+                          RecordSteal(victim);
+                        }
                       }
                     }
                     // Number of blocked threads is used as termination condition.
@@ -898,18 +1213,35 @@ int CurrentThreadId() const EIGEN_FINAL {
                         }
                       }
                     }
+                    if (should_block && adaptive_spinning_) {
+                      parked = true;
+                      park_start = Clock::now();
+                    }
                     return should_block;
                   },
                   // Post-block update (executed only if we blocked)
                   [&]() {
                     blocked_--;
                   });
+              if (adaptive_spinning_) {
+                if (!parked || Clock::now() - park_start < std::max(spin_time, kShortPark)) {
+                  // Work turned up soon after we stopped spinning
+                  spin_count = std::min(max_spin_count, spin_count * 2);
+                } else {
+                  spin_count = std::max(min_spin_count, spin_count / 2);
+                }
+                td.spin_budget.store(spin_count, std::memory_order_relaxed);
+              }
             }
           }
         }
         if (t.f) {
           td.SetActive();
-          env_.ExecuteTask(t);
+          if (profiling_.load(std::memory_order_relaxed)) {
+            ExecuteProfiledTask(td, thread_id, t, wait_start);
+          } else {
+            env_.ExecuteTask(t);
+          }
           td.SetSpinning();
         }
       }
@@ -948,6 +1280,7 @@ int CurrentThreadId() const EIGEN_FINAL {
             worker_data_[victim].GetStatus() == WorkerData::ThreadStatus::Active) {
           Task t = worker_data_[victim].queue.PopBack();
           if (t.f) {
+            RecordSteal(victim);
             return t;
           }
         }
@@ -49,6 +49,35 @@ namespace concurrency {
 
 class ExtendedThreadPoolInterface;
 class BatchHandle;
+class ParallelForCostTable;
+struct ThreadPoolParallelSection;
+
+// Counters describing how the worker threads waited for work.
+struct ThreadPoolSpinStats {
+  uint64_t num_spins = 0;    // times a worker started spinning for work
+  uint64_t num_parks = 0;    // times a worker gave up spinning and blocked
+  uint64_t num_wakeups = 0;  // times a blocked worker was woken for new work
+  uint64_t spin_budget = 0;  // sum of the iterations the workers currently spin for before blocking
+};
+
+// Counters of a worker thread, accumulated while profiling is enabled on the pool (see ThreadPool::SetProfiling).
+struct ThreadPoolWorkerStats {
+  uint64_t num_tasks = 0;        // work items run
+  uint64_t num_steals = 0;       // work items taken from the queue of another worker
+  uint64_t busy_ns = 0;          // time spent running work items
+  uint64_t idle_ns = 0;          // time spent spinning or blocked while waiting for work
+  uint64_t num_pushes = 0;       // work items pushed to the worker's queue
+  uint64_t queue_depth_sum = 0;  // sum of the depth of the queue after each push
+  uint64_t max_queue_depth = 0;  // deepest the queue was after a push
+};
+
+// A work item run by a worker thread while profiling is enabled on the pool.
+struct ThreadPoolTraceEvent {
+  int thread_id;              // index of the worker in the pool
+  unsigned int os_thread_id;  // id of the worker thread, as used by the profiler
+  TimePoint start;
+  TimePoint end;
+};
 
 class ThreadPool {
  public:
@@ -126,18 +155,46 @@ class ThreadPool {
   // wait. Conversely, if the threadpool is used to schedule high-latency
   // operations like I/O the hint should be set to false.
   //
+  // If "adaptive_spinning" is also true, each idle thread adjusts how long it
+  // spins before blocking based on how soon new work has been arriving.
+  //
   // REQUIRES: num_threads > 0
   // The allocator parameter is only used for creating a Eigen::ThreadPoolDevice to be used with Eigen Tensor classes.
   ThreadPool(Env* env,
              const ThreadOptions& thread_options,
              const NAME_CHAR_TYPE* name,
              int num_threads,
-             bool low_latency_hint);
+             bool low_latency_hint,
+             bool adaptive_spinning = false);
 
   // Waits until all scheduled work has finished and then destroy the
   // set of threads.
   ~ThreadPool();
 
+  // A parallel section keeps a team of the pool's threads engaged across the
+  // parallel loops (ParallelFor, SimpleParallelFor, TryBatchParallelFor, ...)
+  // that the current thread runs on the pool while the section exists.  Each
+  // loop is then just offered to the team, which is already running, instead
+  // of being pushed to the threads' queues with a wake-up and a join per loop.
+  // This helps operators that run a series of small loops, such as one per
+  // time step.  The team spins between loops, so a section should only cover
+  // a stretch of work that is mostly parallel loops.
+  //
+  // Constructing a section with a null pool, in an OpenMP build, or within
+  // another section on the same pool has no effect.
+  class ParallelSection {
+   public:
+    explicit ParallelSection(ThreadPool* tp);
+    ~ParallelSection();
+
+   private:
+    friend class ThreadPool;
+    ThreadPool* tp_ = nullptr;
+    std::unique_ptr<ThreadPoolParallelSection> ps_;
+    ParallelSection* prev_section_ = nullptr;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
+  };
+
   // Schedules fn() for execution in the pool of threads.
   void Schedule(std::function<void()> fn);
 
@@ -228,6 +285,31 @@ class ThreadPool {
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
 
+  // Returns the spin-wait counters accumulated over the lifetime of the pool.
+  ThreadPoolSpinStats GetSpinStats() const;
+
+  // Turns the instrumentation of the worker threads on or off. It is off by default, and may be toggled at any
+  // time. While it is on, the workers update their ThreadPoolWorkerStats and record a ThreadPoolTraceEvent per
+  // work item, at the cost of reading the clock around every work item.
+  void SetProfiling(bool enabled);
+
+  // Returns the counters of each worker thread, accumulated over the periods profiling was enabled.
+  std::vector<ThreadPoolWorkerStats> GetWorkerStats() const;
+
+  // Appends the work items recorded since the previous call to "events". Each worker keeps up to 64K of them, and
+  // drops the rest until they are taken.
+  void TakeTraceEvents(std::vector<ThreadPoolTraceEvent>& events);
+
+  // Returns the number of work items the calling thread has handed to thread pools so far. The difference taken
+  // around a kernel's Compute is the number of shards its parallel loops were split into.
+  static uint64_t NumWorkItemsScheduledByCurrentThread();
+
+  // Sizes the shards of ParallelFor loops run under a ParallelForCostTable::OpScope from the per-element
+  // costs learned in "cost_table", once it has enough samples, instead of the estimates passed by the callers.
+  // If "calibrate" is true the loops are also timed and the measurements added to the table.
+  // Pass nullptr to go back to the callers' estimates. Must not be called while loops are running.
+  void SetCostTable(std::shared_ptr<ParallelForCostTable> cost_table, bool calibrate);
+
   // Directly schedule the 'total' tasks to the underlying threadpool, without
   // cutting them by halves
   void SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn);
@@ -365,6 +447,8 @@ class ThreadPool {
   // eigen_threadpool_ is instantiated and owned by thread::ThreadPool if
   // user_threadpool is not in the constructor.
   std::unique_ptr<ThreadPoolTempl<Env> > extended_eigen_threadpool_;
+  std::shared_ptr<ParallelForCostTable> cost_table_;
+  bool calibrate_cost_ = false;
 };
 
 }  // namespace concurrency
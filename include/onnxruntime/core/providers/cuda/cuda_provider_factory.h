@@ -12,6 +12,28 @@ extern "C" {
  */
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessionOptions* options, int device_id);
 
+/**
+ * Device memory allocator supplied by the application, such as the caching allocator of another framework running in
+ * the same process, so that both allocate from one pool.
+ * Alloc returns size bytes on the current CUDA device, or NULL if the allocation failed. stream is the cudaStream_t
+ * the memory is used on, and NULL for the legacy default stream. Free releases a block returned by Alloc. Both are
+ * called concurrently from the threads running the session.
+ */
+typedef struct OrtCUDAExternalAllocator {
+  void*(ORT_API_CALL* Alloc)(void* user_data, size_t size, void* stream);
+  void(ORT_API_CALL* Free)(void* user_data, void* p);
+  void* user_data;
+} OrtCUDAExternalAllocator;
+
+/**
+ * Same as OrtSessionOptionsAppendExecutionProvider_CUDA, except that the device memory of the execution provider is
+ * allocated by the given allocator instead of an arena of its own. The allocator is copied, and the functions and
+ * user_data must remain valid while the sessions created with the options exist.
+ * \param device_id cuda device id, starts from zero.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA_WithExternalAllocator, _In_ OrtSessionOptions* options,
+               int device_id, _In_ const OrtCUDAExternalAllocator* allocator);
+
 #ifdef __cplusplus
 }
 #endif
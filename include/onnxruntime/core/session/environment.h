@@ -12,6 +12,8 @@
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
+class SharedInitializerRegistry;
+
 /** TODO: remove this class
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -34,6 +36,8 @@ class Environment {
                        const OrtThreadingOptions* tp_options = nullptr,
                        bool create_global_thread_pools = false);
 
+  ~Environment();
+
   logging::LoggingManager* GetLoggingManager() const {
     return logging_manager_.get();
   }
@@ -54,6 +58,12 @@ class Environment {
     return create_global_thread_pools_;
   }
 
+  // Registry of the constant initializers shared by the sessions of this environment that enable
+  // SessionOptions::share_initializers.
+  SharedInitializerRegistry* GetSharedInitializerRegistry() const {
+    return shared_initializer_registry_.get();
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
@@ -66,5 +76,6 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> intra_op_thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
+  std::unique_ptr<SharedInitializerRegistry> shared_initializer_registry_;
 };
 }  // namespace onnxruntime
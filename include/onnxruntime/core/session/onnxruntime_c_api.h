@@ -153,6 +153,11 @@ ORT_RUNTIME_CLASS(SequenceTypeInfo);
 ORT_RUNTIME_CLASS(ModelMetadata);
 ORT_RUNTIME_CLASS(ThreadPoolParams);
 ORT_RUNTIME_CLASS(ThreadingOptions);
+ORT_RUNTIME_CLASS(PreparedRun);
+ORT_RUNTIME_CLASS(RequestBatcher);
+ORT_RUNTIME_CLASS(SessionPool);
+ORT_RUNTIME_CLASS(SessionPoolWorker);
+ORT_RUNTIME_CLASS(SessionPipeline);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -189,6 +194,11 @@ typedef void(ORT_API_CALL* OrtLoggingFunction)(
     void* param, OrtLoggingLevel severity, const char* category, const char* logid, const char* code_location,
     const char* message);
 
+// Invoked on completion of a RunAsync call. The callback owns the outputs and the status (nullptr on success) and
+// must release them with ReleaseValue and ReleaseStatus.
+typedef void(ORT_API_CALL* RunAsyncCallbackFn)(
+    void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status);
+
 // Set Graph optimization level.
 // Refer https://github.com/microsoft/onnxruntime/blob/master/docs/ONNX_Runtime_Graph_Optimizations.md
 // for in-depth undersrtanding of Graph Optimizations in ORT
@@ -228,6 +238,22 @@ typedef enum OrtMemType {
   OrtMemTypeDefault = 0,                // the default allocator for execution provider
 } OrtMemType;
 
+/**
+ * How the CUDA execution provider chooses the cuDNN algorithm of a convolution
+ */
+typedef enum OrtCudnnConvAlgoSearch {
+  EXHAUSTIVE,  // benchmark the algorithms with cudnnFindConvolution*AlgorithmEx and use the fastest
+  HEURISTIC,   // use the algorithm ranked first by the cudnnGetConvolution*Algorithm_v7 heuristics
+} OrtCudnnConvAlgoSearch;
+
+/**
+ * The text format of the metrics returned by SessionGetMetrics
+ */
+typedef enum OrtMetricsFormat {
+  ORT_METRICS_FORMAT_JSON = 0,
+  ORT_METRICS_FORMAT_PROMETHEUS = 1,  // Prometheus text exposition format
+} OrtMetricsFormat;
+
 struct OrtApi;
 typedef struct OrtApi OrtApi;
 
@@ -836,6 +862,313 @@ struct OrtApi {
    */
   ORT_API2_STATUS(ReleaseAvailableProviders, _In_ char **ptr,
                   _In_ int providers_length);
+
+  /**
+   * Set to a non-zero value to release memory arena regions that are not in use back to the device
+   * once a Run call using these options completes.
+   */
+  ORT_API2_STATUS(RunOptionsSetMemoryArenaShrinkage, _Inout_ OrtRunOptions* options, int value);
+
+  /**
+   * Bind the intra-op threads of the session to the processors of a NUMA node and allocate the memory of the
+   * default CPU execution provider from that node. A negative value disables this, which is the default.
+   * If the number of intra-op threads is 0, the session uses one thread per processor of the node.
+   */
+  ORT_API2_STATUS(SetIntraOpNumaNode, _Inout_ OrtSessionOptions* options, int numa_node);
+
+  /**
+   * Queue a Run on threads owned by the session and return without waiting for it to complete.
+   * 'callback' is invoked on one of these threads with 'user_data' and the 'output_names_len' outputs, in the order
+   * of 'output_names', once the run completes. Errors of the run are reported to the callback; the returned status
+   * only reports whether the run was queued.
+   * The inputs are shared with the run, so the buffers of inputs created with CreateTensorWithDataAsOrtValue and
+   * 'run_options' (if not null) must remain valid until the callback is invoked. The session must outlive the runs
+   * too; releasing it waits for the queued runs to complete.
+   */
+  ORT_API2_STATUS(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data);
+
+  /**
+   * Set the number of threads running the RunAsync calls of the session. Calls beyond that wait in a queue.
+   * 0, the default, uses one thread per CPU core.
+   */
+  ORT_API2_STATUS(SetAsyncRunThreadPoolSize, _Inout_ OrtSessionOptions* options, int async_run_thread_pool_size);
+
+  /**
+   * Resolve the inputs and outputs of Run calls with the given names once, so RunWithPreparedRun can skip the name
+   * lookups done by each Run call. The prepared run can be shared by concurrent calls on the session that created it,
+   * and must be released before the session.
+   */
+  ORT_API2_STATUS(CreatePreparedRun, _In_ const OrtSession* sess,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Outptr_ OrtPreparedRun** out);
+
+  /**
+   * Same as Run with the input and output names of 'prepared_run'. 'input' and 'output' are in the order of the names
+   * given to CreatePreparedRun.
+   */
+  ORT_API2_STATUS(RunWithPreparedRun, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                  _In_ const OrtPreparedRun* prepared_run,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _Inout_updates_all_(output_len) OrtValue** output, size_t output_len);
+
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /**
+   * Set to a non-zero value to share the data of constant initializers with the other sessions created from the same
+   * OrtEnv that set it, so the sessions of the same model hold one copy of each weight in CPU memory.
+   */
+  ORT_API2_STATUS(SetShareInitializers, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Set to a non-zero value to memory map the model file when a session is created from a model path, and create
+   * the initializers of the main graph over the mapping instead of copying their data. The weights are then read
+   * on demand and shared with other processes through the page cache. Ignored for models loaded from memory.
+   */
+  ORT_API2_STATUS(SetUseMmapInitializers, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Set to a non-zero value to save the execution provider assigned to each node along with the optimized model
+   * written to the path given to SetOptimizedModelFilePath. Fails for models with nodes compiled by an
+   * execution provider.
+   */
+  ORT_API2_STATUS(SetSaveNodePlacements, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Set to a non-zero value when creating a session from an optimized model saved with SetSaveNodePlacements.
+   * The saved node placements are restored instead of optimizing and partitioning the graph again, which makes
+   * the creation of the session faster. The session must register the execution providers the model was
+   * optimized for.
+   */
+  ORT_API2_STATUS(SetUseSavedNodePlacements, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Create a batcher coalescing concurrent requests of the session for the given inputs and outputs into batched
+   * runs. Requests with inputs of the same types and shapes, except for the first dimension, are concatenated along
+   * that dimension until the batch has max_batch_size rows or the oldest request has waited max_delay_us
+   * microseconds. The rows of the outputs are then returned to each request, so the outputs must be batched along
+   * their first dimension too. The batches are run like RunAsync calls.
+   * The session must outlive the batcher; releasing the batcher waits for its requests to complete.
+   */
+  ORT_API2_STATUS(CreateRequestBatcher, _Inout_ OrtSession* sess,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  size_t max_batch_size, int64_t max_delay_us, _Outptr_ OrtRequestBatcher** out);
+
+  /**
+   * Queue a request with the inputs in the order of the input names given to CreateRequestBatcher.
+   * The callback is invoked as for RunAsync once the batch containing the request has run, with the outputs of
+   * the request in the order of the output names given to CreateRequestBatcher.
+   */
+  ORT_API2_STATUS(RequestBatcherRun, _Inout_ OrtRequestBatcher* batcher,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data);
+
+  /**
+   * Get the statistics of the batcher as a JSON object: the number of requests and batches, the number of
+   * batches per count of requests, and the number of requests per latency bucket, where bucket i > 0 counts the
+   * latencies in [2^(i-1), 2^i) microseconds.
+   * \param out is allocated with allocator and must be freed by the caller.
+   */
+  ORT_API2_STATUS(RequestBatcherGetStats, _In_ const OrtRequestBatcher* batcher, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  ORT_CLASS_RELEASE(RequestBatcher);
+
+  /**
+   * Run the session once per set of input shapes with zero filled inputs and discard the outputs, so the first
+   * Run with these shapes is as fast as the following ones: the memory patterns are planned, the arenas grow and
+   * the kernels create their state, such as the cuDNN algorithm search of Conv.
+   * \param input_names the inputs to create, which must include every required input. Only tensors are supported.
+   * \param input_shapes the shape of input j in set i is input_shapes[i * input_len + j], with
+   *        input_shape_lens[i * input_len + j] dimensions.
+   */
+  ORT_API2_STATUS(SessionWarmup, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(input_len* shape_set_count) const int64_t* const* input_shapes,
+                  _In_reads_(input_len* shape_set_count) const size_t* input_shape_lens, size_t shape_set_count);
+
+  /**
+   * Set to a non-zero value to collect aggregated statistics for each node of the main graph on every Run:
+   * the number of executions, the total, minimum and maximum kernel time, the total size of the outputs and the
+   * total number of thread pool work items. The counters are updated without locks, so unlike
+   * EnableProfiling this can stay on for a production session. Read them with SessionGetNodeStats.
+   */
+  ORT_API2_STATUS(SetEnableNodeStats, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Get the statistics collected for the nodes of a session created with SetEnableNodeStats, as a JSON array with
+   * an object per node that has run: name, op_type, count, total_us, min_us, max_us, output_bytes and num_shards.
+   * May be called at any time, including while the session runs.
+   * \param out is allocated with allocator and must be freed by the caller.
+   */
+  ORT_API2_STATUS(SessionGetNodeStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /**
+   * Get the metrics of a session since it was created: histograms of the Run latency and of the time RunAsync
+   * requests wait in the queue, with their count, sum, maximum and p50/p90/p99 in microseconds, the
+   * statistics of the arenas of the execution providers and the page faults of the process. Sessions created with SetEnableNodeStats also report
+   * the kernel time of each execution provider and the time spent in copies between devices.
+   * May be called at any time, including while the session runs.
+   * \param out is allocated with allocator and must be freed by the caller.
+   */
+  ORT_API2_STATUS(SessionGetMetrics, _In_ const OrtSession* sess, OrtMetricsFormat format,
+                  _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+
+  /**
+   * Set to a non-zero value to add the memory use to the profile of a session created with EnableProfiling:
+   * an event for the lifetime of every tensor allocated during a run with its size, device and producer node,
+   * counters of the memory in use on each device, and a "memory_peak" event per run and device listing the
+   * tensors that were live at the peak.
+   */
+  ORT_API2_STATUS(SetEnableMemoryProfiling, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Set to a non-zero value to add the hardware performance counters of the thread running each node (cycles,
+   * instructions, IPC, last level cache references and misses) to the node events of the profile of a session
+   * created with EnableProfiling. Only available on Linux, where perf_event_paranoid allows it; the events are
+   * left as they are otherwise.
+   */
+  ORT_API2_STATUS(SetEnableHardwareCounters, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Create a pool of 'num_workers' workers running the session for concurrent callers. The workers share the graph,
+   * the kernels and the initializers of the session, and each one runs on a dedicated thread so the per thread state
+   * of the execution providers, such as the CUDA stream, handles and arena, stays warm for it.
+   * The session must outlive the pool; releasing the pool waits for the checked out workers to be checked in.
+   */
+  ORT_API2_STATUS(CreateSessionPool, _Inout_ OrtSession* sess, size_t num_workers, _Outptr_ OrtSessionPool** out);
+
+  /**
+   * Take an idle worker of the pool, waiting up to 'timeout_us' microseconds for one to be checked in, or
+   * indefinitely if 'timeout_us' is negative. 'out' is set to null if no worker became idle in time.
+   * The worker is used by the caller alone until it is given back with SessionPoolCheckin.
+   */
+  ORT_API2_STATUS(SessionPoolCheckout, _Inout_ OrtSessionPool* pool, int64_t timeout_us,
+                  _Outptr_result_maybenull_ OrtSessionPoolWorker** out);
+
+  /**
+   * Same as Run on the session of the pool, executed on the thread of the worker.
+   */
+  ORT_API2_STATUS(SessionPoolWorkerRun, _Inout_ OrtSessionPoolWorker* worker, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Inout_updates_all_(output_names_len) OrtValue** output);
+
+  /**
+   * Give back a worker taken with SessionPoolCheckout.
+   */
+  ORT_API2_STATUS(SessionPoolCheckin, _Inout_ OrtSessionPool* pool, _In_ OrtSessionPoolWorker* worker);
+
+  ORT_CLASS_RELEASE(SessionPool);
+
+  /**
+   * Same as CreateEnv, except that the log messages are written by a background thread, so logging only copies the
+   * message into a queue holding 'queue_capacity' messages. Messages logged while the queue is full are dropped,
+   * and their number is reported by a warning once the queue has room again.
+   */
+  ORT_API2_STATUS(CreateEnvWithAsyncLogging, OrtLoggingLevel default_logging_level, _In_ const char* logid,
+                  size_t queue_capacity, _Outptr_ OrtEnv** out);
+
+  /**
+   * Set to a non-zero value to return the outputs produced by a ZipMap node, such as the probabilities of
+   * scikit-learn classifiers, as the 2D float tensor of the ZipMap input instead of a sequence of maps. Column j of
+   * the output holds the values of the key j returned by SessionGetOutputMapKeys, so no map is built per row.
+   */
+  ORT_API2_STATUS(SetColumnarZipMapOutputs, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Get the keys of the columns of the output at 'index' returned as a tensor by SetColumnarZipMapOutputs, as a 1D
+   * tensor of int64 or of strings allocated with 'allocator'. 'out' is set to null for the other outputs.
+   */
+  ORT_API2_STATUS(SessionGetOutputMapKeys, _In_ const OrtSession* sess, size_t index, _Inout_ OrtAllocator* allocator,
+                  _Outptr_result_maybenull_ OrtValue** out);
+
+  /**
+   * Create a pipeline running a model split into 'num_stages' consecutive sessions, such as a model too large for
+   * one GPU with each session using the CUDA execution provider of another device. Each stage runs on a dedicated
+   * thread, so the stages run different micro batches at the same time. The inputs of a stage are taken by name
+   * from the feeds or from the outputs of the earlier stages, and are copied to the device of the stage as needed.
+   * The sessions must outlive the pipeline.
+   */
+  ORT_API2_STATUS(CreateSessionPipeline, _In_reads_(num_stages) OrtSession* const* stages, size_t num_stages,
+                  _Outptr_ OrtSessionPipeline** out);
+
+  /**
+   * Run 'num_micro_batches' micro batches through the stages of the pipeline. 'input' holds the 'input_len' values
+   * of each micro batch one micro batch after the other, and 'output' is set to 'output_names_len' new values for
+   * each micro batch in the same layout.
+   */
+  ORT_API2_STATUS(SessionPipelineRun, _Inout_ OrtSessionPipeline* pipeline, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len* num_micro_batches) const OrtValue* const* input, size_t input_len,
+                  size_t num_micro_batches,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Out_writes_all_(output_names_len* num_micro_batches) OrtValue** output);
+
+  ORT_CLASS_RELEASE(SessionPipeline);
+
+  /**
+   * Set to a non-zero value to create each kernel when its node first runs, and set up each control flow subgraph
+   * when it's first run, instead of when the session is created. Models with branches that are rarely taken then
+   * start faster and use less memory, but the first run through each part of the model is slower.
+   */
+  ORT_API2_STATUS(SetLazyInitialization, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Get the data and the dims of the tensor input 'index' of a custom op kernel without creating an
+   * OrtTensorTypeAndShapeInfo. 'data' and 'dim_values' are set to nullptr for a missing optional input.
+   * The returned pointers are valid until KernelCompute returns.
+   */
+  ORT_API2_STATUS(KernelContext_GetInputData, _In_ const OrtKernelContext* context, _In_ size_t index,
+                  _Outptr_result_maybenull_ const void** data,
+                  _Outptr_result_maybenull_ const int64_t** dim_values, _Out_ size_t* dim_count);
+
+  /**
+   * Allocate the tensor output 'index' of a custom op kernel with the given dims and get its data directly.
+   */
+  ORT_API2_STATUS(KernelContext_GetOutputData, _Inout_ OrtKernelContext* context, _In_ size_t index,
+                  _In_ const int64_t* dim_values, size_t dim_count, _Outptr_ void** data);
+
+  /**
+   * Get the value of the input 'index' of the node of a custom op from its OrtKernelInfo if it's a constant
+   * initializer, so CreateKernel can pre-process it (e.g. repack weights) once instead of on every run.
+   * 'is_constant' is set to 0 and the other outputs to nullptr/0 if the input isn't constant. The data is owned by
+   * the session and stays valid for the lifetime of the kernel.
+   */
+  ORT_API2_STATUS(KernelInfoGetConstantInputData, _In_ const OrtKernelInfo* info, _In_ size_t index,
+                  _Out_ int* is_constant, _Outptr_result_maybenull_ const void** data,
+                  _Outptr_result_maybenull_ const int64_t** dim_values, _Out_ size_t* dim_count);
+
+  /**
+   * Split [0, total) into ranges and call 'fn' for each of them on the intra-op thread pool of the session running
+   * the custom op kernel. 'cost_per_unit' is an estimate of the cycles needed for one unit of work and decides how
+   * finely the range is split. Returns after all the ranges are done. Runs 'fn' inline without a thread pool.
+   */
+  ORT_API2_STATUS(KernelContext_ParallelFor, _In_ const OrtKernelContext* context,
+                  _In_ void(ORT_API_CALL* fn)(_In_opt_ void* user_data, size_t begin, size_t end),
+                  _In_opt_ void* user_data, size_t total, double cost_per_unit);
+
+  /**
+   * Set to a non-zero value to save the constant weights packed by the CPU kernels along with the optimized model
+   * written to the path given to SetOptimizedModelFilePath, in a file named after it with a ".prepacked" suffix.
+   * The file is tagged with the architecture and the packing formats of the processor.
+   */
+  ORT_API2_STATUS(SetSavePrepackedWeights, _Inout_ OrtSessionOptions* options, int value);
+
+  /**
+   * Set to a non-zero value when creating a session from an optimized model file saved with SetSavePrepackedWeights.
+   * The CPU kernels read their packed weights from the ".prepacked" file next to the model instead of packing them
+   * again, which makes the creation of the session faster. The weights are packed as usual if the file was saved on
+   * a processor with other packing formats.
+   */
+  ORT_API2_STATUS(SetUseSavedPrepackedWeights, _Inout_ OrtSessionOptions* options, int value);
 };
 
 /*
@@ -76,6 +76,10 @@ ORT_DEFINE_RELEASE(TypeInfo);
 ORT_DEFINE_RELEASE(Value);
 ORT_DEFINE_RELEASE(ModelMetadata);
 ORT_DEFINE_RELEASE(ThreadingOptions);
+ORT_DEFINE_RELEASE(PreparedRun);
+ORT_DEFINE_RELEASE(RequestBatcher);
+ORT_DEFINE_RELEASE(SessionPool);
+ORT_DEFINE_RELEASE(SessionPipeline);
 
 // This is used internally by the C++ API. This is the common base class used by the wrapper objects.
 template <typename T>
@@ -124,12 +128,14 @@ struct Env;
 struct TypeInfo;
 struct Value;
 struct ModelMetadata;
+struct PreparedRun;
 
 struct Env : Base<OrtEnv> {
   Env(std::nullptr_t) {}
   Env(OrtLoggingLevel default_logging_level = ORT_LOGGING_LEVEL_WARNING, _In_ const char* logid = "");
   Env(const OrtThreadingOptions* tp_options, OrtLoggingLevel default_logging_level = ORT_LOGGING_LEVEL_WARNING, _In_ const char* logid = "");
   Env(OrtLoggingLevel default_logging_level, const char* logid, OrtLoggingFunction logging_function, void* logger_param);
+  Env(OrtLoggingLevel default_logging_level, _In_ const char* logid, size_t async_log_queue_capacity);  // see CreateEnvWithAsyncLogging
   explicit Env(OrtEnv* p) : Base<OrtEnv>{p} {}
 
   Env& EnableTelemetryEvents();
@@ -162,6 +168,9 @@ struct RunOptions : Base<OrtRunOptions> {
   RunOptions& SetTerminate();
   // unset the terminate flag so this RunOptions instance can be used in a new Session::Run call
   RunOptions& UnsetTerminate();
+
+  // release memory arena regions that are not in use once the Session::Run call completes
+  RunOptions& SetMemoryArenaShrinkage(bool enable);
 };
 
 struct SessionOptions : Base<OrtSessionOptions> {
@@ -173,6 +182,19 @@ struct SessionOptions : Base<OrtSessionOptions> {
 
   SessionOptions& SetIntraOpNumThreads(int intra_op_num_threads);
   SessionOptions& SetInterOpNumThreads(int inter_op_num_threads);
+  SessionOptions& SetIntraOpNumaNode(int numa_node);
+  SessionOptions& SetAsyncRunThreadPoolSize(int async_run_thread_pool_size);
+  SessionOptions& SetShareInitializers(bool value);
+  SessionOptions& SetUseMmapInitializers(bool value);
+  SessionOptions& SetSaveNodePlacements(bool value);
+  SessionOptions& SetUseSavedNodePlacements(bool value);
+  SessionOptions& SetSavePrepackedWeights(bool value);
+  SessionOptions& SetUseSavedPrepackedWeights(bool value);
+  SessionOptions& SetEnableNodeStats(bool value);
+  SessionOptions& SetEnableMemoryProfiling(bool value);
+  SessionOptions& SetEnableHardwareCounters(bool value);
+  SessionOptions& SetColumnarZipMapOutputs(bool value);
+  SessionOptions& SetLazyInitialization(bool value);
   SessionOptions& SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level);
 
   SessionOptions& EnableCpuMemArena();
@@ -219,6 +241,19 @@ struct Session : Base<OrtSession> {
   // Run for when there is a list of prealloated outputs
   void Run(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
            const char* const* output_names, Value* output_values, size_t output_count);
+  // Run on the threads of the session, the outputs and status are passed to callback once it completes
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                const char* const* output_names, size_t output_count, RunAsyncCallbackFn callback, void* user_data);
+  // Run with the input and output names of prepared_run, allocating the output values
+  std::vector<Value> Run(const RunOptions& run_options, const PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+                         size_t output_count);
+  // Run with the input and output names of prepared_run, for when there is a list of preallocated outputs
+  void Run(const RunOptions& run_options, const PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
+  // Run once per set of input shapes, on zero filled inputs, to do the work of the first Run with these shapes up front.
+  // shape_sets[i][j] is the shape of input j in set i.
+  void Warmup(const RunOptions& run_options, const char* const* input_names, size_t input_count,
+              const std::vector<std::vector<std::vector<int64_t>>>& shape_sets);
 
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
@@ -228,6 +263,9 @@ struct Session : Base<OrtSession> {
   char* GetOutputName(size_t index, OrtAllocator* allocator) const;
   char* GetOverridableInitializerName(size_t index, OrtAllocator* allocator) const;
   char* EndProfiling(OrtAllocator* allocator) const;
+  char* GetNodeStats(OrtAllocator* allocator) const;  // JSON array, see SessionGetNodeStats
+  char* GetMetrics(OrtMetricsFormat format, OrtAllocator* allocator) const;  // see SessionGetMetrics
+  Value GetOutputMapKeys(size_t index, OrtAllocator* allocator) const;        // see SessionGetOutputMapKeys
   ModelMetadata GetModelMetadata() const;
 
   TypeInfo GetInputTypeInfo(size_t index) const;
@@ -235,6 +273,49 @@ struct Session : Base<OrtSession> {
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;
 };
 
+// The input and output names of Run calls resolved once, see CreatePreparedRun in the C API
+struct PreparedRun : Base<OrtPreparedRun> {
+  explicit PreparedRun(std::nullptr_t) {}
+  PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+              const char* const* output_names, size_t output_count);
+};
+
+// Coalesces concurrent requests of a session into batched runs, see CreateRequestBatcher in the C API
+struct RequestBatcher : Base<OrtRequestBatcher> {
+  explicit RequestBatcher(std::nullptr_t) {}
+  RequestBatcher(Session& session, const char* const* input_names, size_t input_count,
+                 const char* const* output_names, size_t output_count, size_t max_batch_size, int64_t max_delay_us);
+
+  void Run(const Value* input_values, size_t input_count, RunAsyncCallbackFn callback, void* user_data);
+
+  char* GetStats(OrtAllocator* allocator) const;
+};
+
+// Workers running a session for concurrent callers, see CreateSessionPool in the C API.
+// The workers are owned by the pool.
+struct SessionPool : Base<OrtSessionPool> {
+  explicit SessionPool(std::nullptr_t) {}
+  SessionPool(Session& session, size_t num_workers);
+
+  OrtSessionPoolWorker* Checkout(int64_t timeout_us = -1);  // nullptr if no worker became idle in time
+  void Checkin(OrtSessionPoolWorker* worker);
+
+  std::vector<Value> Run(OrtSessionPoolWorker* worker, const RunOptions& run_options, const char* const* input_names,
+                         const Value* input_values, size_t input_count, const char* const* output_names,
+                         size_t output_count);
+};
+
+// Sessions of the consecutive stages of a model run as a pipeline, see CreateSessionPipeline in the C API.
+struct SessionPipeline : Base<OrtSessionPipeline> {
+  explicit SessionPipeline(std::nullptr_t) {}
+  SessionPipeline(Session* stages, size_t num_stages);
+
+  // input_values holds input_count values per micro batch, and the result output_count values per micro batch
+  std::vector<Value> Run(const RunOptions& run_options, const char* const* input_names, const Value* input_values,
+                         size_t input_count, size_t num_micro_batches, const char* const* output_names,
+                         size_t output_count);
+};
+
 struct TensorTypeAndShapeInfo : Base<OrtTensorTypeAndShapeInfo> {
   explicit TensorTypeAndShapeInfo(std::nullptr_t) {}
   explicit TensorTypeAndShapeInfo(OrtTensorTypeAndShapeInfo* p) : Base<OrtTensorTypeAndShapeInfo>{p} {}
@@ -347,6 +428,19 @@ struct CustomOpApi {
   size_t KernelContext_GetOutputCount(const OrtKernelContext* context);
   OrtValue* KernelContext_GetOutput(OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count);
 
+  // Direct accessors that don't create an OrtValue wrapper or an OrtTensorTypeAndShapeInfo for each call.
+  // GetInputData returns nullptr for a missing optional input.
+  template <typename T>
+  const T* KernelContext_GetInputData(const OrtKernelContext* context, _In_ size_t index, _Out_ const int64_t** dim_values, _Out_ size_t* dim_count);
+  template <typename T>
+  T* KernelContext_GetOutputData(OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count);
+  // Returns nullptr if the input isn't a constant initializer.
+  template <typename T>
+  const T* KernelInfoGetConstantInputData(const OrtKernelInfo* info, _In_ size_t index, _Out_ std::vector<int64_t>* dims);
+  // Runs fn(begin, end) over ranges of [0, total) on the intra-op thread pool of the session.
+  template <typename TFn>
+  void KernelContext_ParallelFor(const OrtKernelContext* context, size_t total, double cost_per_unit, const TFn& fn);
+
   void ThrowOnError(OrtStatus* result);
 
  private:
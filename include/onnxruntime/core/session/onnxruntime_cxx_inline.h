@@ -90,6 +90,10 @@ inline Env::Env(const OrtThreadingOptions* tp_options, OrtLoggingLevel default_w
   ThrowOnError(Global<void>::api_.CreateEnvWithGlobalThreadPools(default_warning_level, logid, tp_options, &p_));
 }
 
+inline Env::Env(OrtLoggingLevel default_warning_level, _In_ const char* logid, size_t async_log_queue_capacity) {
+  ThrowOnError(Global<void>::api_.CreateEnvWithAsyncLogging(default_warning_level, logid, async_log_queue_capacity, &p_));
+}
+
 inline Env& Env::EnableTelemetryEvents() {
   ThrowOnError(Global<void>::api_.EnableTelemetryEvents(p_));
   return *this;
@@ -149,6 +153,11 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::SetMemoryArenaShrinkage(bool enable) {
+  ThrowOnError(Global<void>::api_.RunOptionsSetMemoryArenaShrinkage(p_, enable ? 1 : 0));
+  return *this;
+}
+
 inline SessionOptions::SessionOptions() {
   ThrowOnError(Global<void>::api_.CreateSessionOptions(&p_));
 }
@@ -169,6 +178,71 @@ inline SessionOptions& SessionOptions::SetInterOpNumThreads(int inter_op_num_thr
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetIntraOpNumaNode(int numa_node) {
+  ThrowOnError(Global<void>::api_.SetIntraOpNumaNode(p_, numa_node));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetAsyncRunThreadPoolSize(int async_run_thread_pool_size) {
+  ThrowOnError(Global<void>::api_.SetAsyncRunThreadPoolSize(p_, async_run_thread_pool_size));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetShareInitializers(bool value) {
+  ThrowOnError(Global<void>::api_.SetShareInitializers(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetUseMmapInitializers(bool value) {
+  ThrowOnError(Global<void>::api_.SetUseMmapInitializers(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetSaveNodePlacements(bool value) {
+  ThrowOnError(Global<void>::api_.SetSaveNodePlacements(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetUseSavedNodePlacements(bool value) {
+  ThrowOnError(Global<void>::api_.SetUseSavedNodePlacements(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetSavePrepackedWeights(bool value) {
+  ThrowOnError(Global<void>::api_.SetSavePrepackedWeights(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetUseSavedPrepackedWeights(bool value) {
+  ThrowOnError(Global<void>::api_.SetUseSavedPrepackedWeights(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetEnableNodeStats(bool value) {
+  ThrowOnError(Global<void>::api_.SetEnableNodeStats(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetEnableMemoryProfiling(bool value) {
+  ThrowOnError(Global<void>::api_.SetEnableMemoryProfiling(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetEnableHardwareCounters(bool value) {
+  ThrowOnError(Global<void>::api_.SetEnableHardwareCounters(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetColumnarZipMapOutputs(bool value) {
+  ThrowOnError(Global<void>::api_.SetColumnarZipMapOutputs(p_, value ? 1 : 0));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetLazyInitialization(bool value) {
+  ThrowOnError(Global<void>::api_.SetLazyInitialization(p_, value ? 1 : 0));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level) {
   ThrowOnError(Global<void>::api_.SetSessionGraphOptimizationLevel(p_, graph_optimization_level));
   return *this;
@@ -248,6 +322,44 @@ inline void Session::Run(const RunOptions& run_options, const char* const* input
   ThrowOnError(Global<void>::api_.Run(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values));
 }
 
+inline void Session::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                              const char* const* output_names, size_t output_count, RunAsyncCallbackFn callback, void* user_data) {
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  ThrowOnError(Global<void>::api_.RunAsync(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, callback, user_data));
+}
+
+inline std::vector<Value> Session::Run(const RunOptions& run_options, const PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+                                       size_t output_count) {
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < output_count; i++)
+    output_values.emplace_back(nullptr);
+  Run(run_options, prepared_run, input_values, input_count, output_values.data(), output_count);
+  return output_values;
+}
+
+inline void Session::Run(const RunOptions& run_options, const PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+                         Value* output_values, size_t output_count) {
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(Global<void>::api_.RunWithPreparedRun(p_, run_options, prepared_run, ort_input_values, input_count, ort_output_values, output_count));
+}
+
+inline void Session::Warmup(const RunOptions& run_options, const char* const* input_names, size_t input_count,
+                            const std::vector<std::vector<std::vector<int64_t>>>& shape_sets) {
+  std::vector<const int64_t*> input_shapes;
+  std::vector<size_t> input_shape_lens;
+  for (const auto& shapes : shape_sets) {
+    if (shapes.size() != input_count)
+      throw Ort::Exception("each set of input shapes must have input_count shapes", ORT_INVALID_ARGUMENT);
+    for (const auto& shape : shapes) {
+      input_shapes.push_back(shape.data());
+      input_shape_lens.push_back(shape.size());
+    }
+  }
+  ThrowOnError(Global<void>::api_.SessionWarmup(p_, run_options, input_names, input_count, input_shapes.data(),
+                                                input_shape_lens.data(), shape_sets.size()));
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ThrowOnError(Global<void>::api_.SessionGetInputCount(p_, &out));
@@ -290,6 +402,24 @@ inline char* Session::EndProfiling(OrtAllocator* allocator) const {
   return out;
 }
 
+inline char* Session::GetNodeStats(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(Global<void>::api_.SessionGetNodeStats(p_, allocator, &out));
+  return out;
+}
+
+inline char* Session::GetMetrics(OrtMetricsFormat format, OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(Global<void>::api_.SessionGetMetrics(p_, format, allocator, &out));
+  return out;
+}
+
+inline Value Session::GetOutputMapKeys(size_t index, OrtAllocator* allocator) const {
+  OrtValue* out;
+  ThrowOnError(Global<void>::api_.SessionGetOutputMapKeys(p_, index, allocator, &out));
+  return Value{out};
+}
+
 inline ModelMetadata Session::GetModelMetadata() const {
   OrtModelMetadata* out;
   ThrowOnError(Global<void>::api_.SessionGetModelMetadata(p_, &out));
@@ -356,6 +486,77 @@ inline TypeInfo Session::GetOverridableInitializerTypeInfo(size_t index) const {
   return TypeInfo{out};
 }
 
+inline PreparedRun::PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+                                const char* const* output_names, size_t output_count) {
+  ThrowOnError(Global<void>::api_.CreatePreparedRun(session, input_names, input_count, output_names, output_count, &p_));
+}
+
+inline RequestBatcher::RequestBatcher(Session& session, const char* const* input_names, size_t input_count,
+                                      const char* const* output_names, size_t output_count, size_t max_batch_size,
+                                      int64_t max_delay_us) {
+  ThrowOnError(Global<void>::api_.CreateRequestBatcher(session, input_names, input_count, output_names, output_count,
+                                                       max_batch_size, max_delay_us, &p_));
+}
+
+inline void RequestBatcher::Run(const Value* input_values, size_t input_count, RunAsyncCallbackFn callback,
+                                void* user_data) {
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  ThrowOnError(Global<void>::api_.RequestBatcherRun(p_, ort_input_values, input_count, callback, user_data));
+}
+
+inline char* RequestBatcher::GetStats(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(Global<void>::api_.RequestBatcherGetStats(p_, allocator, &out));
+  return out;
+}
+
+inline SessionPool::SessionPool(Session& session, size_t num_workers) {
+  ThrowOnError(Global<void>::api_.CreateSessionPool(session, num_workers, &p_));
+}
+
+inline OrtSessionPoolWorker* SessionPool::Checkout(int64_t timeout_us) {
+  OrtSessionPoolWorker* out;
+  ThrowOnError(Global<void>::api_.SessionPoolCheckout(p_, timeout_us, &out));
+  return out;
+}
+
+inline void SessionPool::Checkin(OrtSessionPoolWorker* worker) {
+  ThrowOnError(Global<void>::api_.SessionPoolCheckin(p_, worker));
+}
+
+inline std::vector<Value> SessionPool::Run(OrtSessionPoolWorker* worker, const RunOptions& run_options,
+                                           const char* const* input_names, const Value* input_values,
+                                           size_t input_count, const char* const* output_names, size_t output_count) {
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < output_count; i++)
+    output_values.emplace_back(nullptr);
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values.data());
+  ThrowOnError(Global<void>::api_.SessionPoolWorkerRun(worker, run_options, input_names, ort_input_values, input_count,
+                                                       output_names, output_count, ort_output_values));
+  return output_values;
+}
+
+inline SessionPipeline::SessionPipeline(Session* stages, size_t num_stages) {
+  std::vector<OrtSession*> ort_stages(stages, stages + num_stages);
+  ThrowOnError(Global<void>::api_.CreateSessionPipeline(ort_stages.data(), num_stages, &p_));
+}
+
+inline std::vector<Value> SessionPipeline::Run(const RunOptions& run_options, const char* const* input_names,
+                                               const Value* input_values, size_t input_count,
+                                               size_t num_micro_batches, const char* const* output_names,
+                                               size_t output_count) {
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < output_count * num_micro_batches; i++)
+    output_values.emplace_back(nullptr);
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values.data());
+  ThrowOnError(Global<void>::api_.SessionPipelineRun(p_, run_options, input_names, ort_input_values, input_count,
+                                                     num_micro_batches, output_names, output_count,
+                                                     ort_output_values));
+  return output_values;
+}
+
 inline ONNXTensorElementDataType TensorTypeAndShapeInfo::GetElementType() const {
   ONNXTensorElementDataType out;
   ThrowOnError(Global<void>::api_.GetTensorElementType(p_, &out));
@@ -613,6 +814,40 @@ inline OrtValue* CustomOpApi::KernelContext_GetOutput(OrtKernelContext* context,
   return out;
 }
 
+template <typename T>
+inline const T* CustomOpApi::KernelContext_GetInputData(const OrtKernelContext* context, _In_ size_t index, _Out_ const int64_t** dim_values, _Out_ size_t* dim_count) {
+  const void* out;
+  ThrowOnError(api_.KernelContext_GetInputData(context, index, &out, dim_values, dim_count));
+  return static_cast<const T*>(out);
+}
+
+template <typename T>
+inline T* CustomOpApi::KernelContext_GetOutputData(OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count) {
+  void* out;
+  ThrowOnError(api_.KernelContext_GetOutputData(context, index, dim_values, dim_count, &out));
+  return static_cast<T*>(out);
+}
+
+template <typename T>
+inline const T* CustomOpApi::KernelInfoGetConstantInputData(const OrtKernelInfo* info, _In_ size_t index, _Out_ std::vector<int64_t>* dims) {
+  int is_constant;
+  const void* out;
+  const int64_t* dim_values;
+  size_t dim_count;
+  ThrowOnError(api_.KernelInfoGetConstantInputData(info, index, &is_constant, &out, &dim_values, &dim_count));
+  if (!is_constant)
+    return nullptr;
+  dims->assign(dim_values, dim_values + dim_count);
+  return static_cast<const T*>(out);
+}
+
+template <typename TFn>
+inline void CustomOpApi::KernelContext_ParallelFor(const OrtKernelContext* context, size_t total, double cost_per_unit, const TFn& fn) {
+  ThrowOnError(api_.KernelContext_ParallelFor(
+      context, [](void* user_data, size_t begin, size_t end) { (*static_cast<const TFn*>(user_data))(begin, end); },
+      const_cast<TFn*>(&fn), total, cost_per_unit));
+}
+
 inline SessionOptions& SessionOptions::DisablePerSessionThreads() {
   ThrowOnError(Global<void>::api_.DisablePerSessionThreads(p_));
   return *this;
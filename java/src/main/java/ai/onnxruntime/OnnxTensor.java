@@ -121,6 +121,28 @@ public class OnnxTensor implements OnnxValue {
     close(OnnxRuntime.ortApiHandle, nativeHandle);
   }
 
+  /**
+   * Returns a direct ByteBuffer in native byte order which is a view of the memory of the
+   * OnnxTensor, without copying it.
+   *
+   * <p>Writes to the buffer change the tensor, so an input tensor can be refilled through it and
+   * passed to another run instead of creating a new tensor. An output tensor pinned with {@link
+   * OrtSession#run(java.util.Map, java.util.Map, OrtSession.RunOptions)} is overwritten by each run. The buffer must not
+   * be used after the OnnxTensor is closed.
+   *
+   * <p>This method returns null if the OnnxTensor contains Strings as they are stored externally to
+   * the OnnxTensor.
+   *
+   * @return A ByteBuffer view of the OnnxTensor.
+   */
+  public ByteBuffer getByteBufferView() {
+    if (info.type != OnnxJavaType.STRING) {
+      return getBuffer();
+    } else {
+      return null;
+    }
+  }
+
   /**
    * Returns a copy of the underlying OnnxTensor as a ByteBuffer.
    *
@@ -293,6 +293,7 @@ public class OrtSession implements AutoCloseable {
               inputHandles,
               inputNamesArray.length,
               outputNamesArray,
+              null,
               outputNamesArray.length,
               runOptionsHandle);
       return new Result(outputNamesArray, outputValues);
@@ -301,6 +302,94 @@ public class OrtSession implements AutoCloseable {
     }
   }
 
+  /**
+   * Scores an input feed dict, writing the requested outputs into the supplied tensors.
+   *
+   * @param inputs The inputs to score.
+   * @param pinnedOutputs The tensors to write the requested outputs into.
+   * @throws OrtException If there was an error in native code, the input or output names are
+   *     invalid, or if there are zero or too many inputs or outputs.
+   * @see #run(Map, Map, RunOptions)
+   */
+  public void run(Map<String, OnnxTensor> inputs, Map<String, OnnxTensor> pinnedOutputs)
+      throws OrtException {
+    run(inputs, pinnedOutputs, null);
+  }
+
+  /**
+   * Scores an input feed dict, writing the requested outputs into the supplied tensors.
+   *
+   * <p>Unlike the other run methods, no output tensors are allocated, so repeated runs with the
+   * same pinned outputs (and inputs refilled through {@link OnnxTensor#getByteBufferView}) don't
+   * create garbage. Each output tensor must have the type and shape the model produces for the
+   * inputs, and is overwritten by each run, so its contents should be read (e.g. through {@link
+   * OnnxTensor#getByteBufferView}) before the next run. The tensors remain owned by the caller.
+   *
+   * @param inputs The inputs to score.
+   * @param pinnedOutputs The tensors to write the requested outputs into.
+   * @param runOptions The RunOptions to control this run.
+   * @throws OrtException If there was an error in native code, the input or output names are
+   *     invalid, or if there are zero or too many inputs or outputs.
+   */
+  public void run(
+      Map<String, OnnxTensor> inputs, Map<String, OnnxTensor> pinnedOutputs, RunOptions runOptions)
+      throws OrtException {
+    if (!closed) {
+      if (inputs.isEmpty() || (inputs.size() > numInputs)) {
+        throw new OrtException(
+            "Unexpected number of inputs, expected [1," + numInputs + ") found " + inputs.size());
+      }
+      if (pinnedOutputs.isEmpty() || (pinnedOutputs.size() > numOutputs)) {
+        throw new OrtException(
+            "Unexpected number of pinnedOutputs, expected [1,"
+                + numOutputs
+                + ") found "
+                + pinnedOutputs.size());
+      }
+      String[] inputNamesArray = new String[inputs.size()];
+      long[] inputHandles = new long[inputs.size()];
+      int i = 0;
+      for (Map.Entry<String, OnnxTensor> t : inputs.entrySet()) {
+        if (inputNames.contains(t.getKey())) {
+          inputNamesArray[i] = t.getKey();
+          inputHandles[i] = t.getValue().getNativeHandle();
+          i++;
+        } else {
+          throw new OrtException(
+              "Unknown input name " + t.getKey() + ", expected one of " + inputNames.toString());
+        }
+      }
+      String[] outputNamesArray = new String[pinnedOutputs.size()];
+      long[] outputHandles = new long[pinnedOutputs.size()];
+      i = 0;
+      for (Map.Entry<String, OnnxTensor> t : pinnedOutputs.entrySet()) {
+        if (outputNames.contains(t.getKey())) {
+          outputNamesArray[i] = t.getKey();
+          outputHandles[i] = t.getValue().getNativeHandle();
+          i++;
+        } else {
+          throw new OrtException(
+              "Unknown output name " + t.getKey() + ", expected one of " + outputNames.toString());
+        }
+      }
+      long runOptionsHandle = runOptions == null ? 0 : runOptions.nativeHandle;
+
+      run(
+          OnnxRuntime.ortApiHandle,
+          nativeHandle,
+          allocator.handle,
+          inputNamesArray,
+          inputHandles,
+          inputNamesArray.length,
+          outputNamesArray,
+          outputHandles,
+          outputNamesArray.length,
+          runOptionsHandle);
+    } else {
+      throw new IllegalStateException("Trying to score a closed OrtSession.");
+    }
+  }
+
   /**
    * Gets the metadata for the currently loaded model.
    *
@@ -396,9 +485,12 @@ public class OrtSession implements AutoCloseable {
    * @param inputs The input tensors.
    * @param numInputs The number of inputs.
    * @param outputNamesArray The requested output names.
+   * @param outputs The (possibly null) pointers to the tensors to write the outputs into. The
+   *     outputs with a zero pointer are allocated by the run.
    * @param numOutputs The number of requested outputs.
    * @param runOptionsHandle The (possibly null) pointer to the run options.
-   * @return The OnnxValues produced by this run.
+   * @return The OnnxValues produced by this run, with null for the outputs written into the
+   *     supplied tensors.
    * @throws OrtException If the native call failed in some way.
    */
   private native OnnxValue[] run(
@@ -409,6 +501,7 @@ public class OrtSession implements AutoCloseable {
       long[] inputs,
       long numInputs,
       String[] outputNamesArray,
+      long[] outputs,
       long numOutputs,
       long runOptionsHandle)
       throws OrtException;
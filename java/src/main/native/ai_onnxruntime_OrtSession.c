@@ -235,11 +235,11 @@ JNIEXPORT jobjectArray JNICALL Java_ai_onnxruntime_OrtSession_getOutputInfo
 /*
  * Class:     ai_onnxruntime_OrtSession
  * Method:    run
- * Signature: (JJJ[Ljava/lang/String;[JJ[Ljava/lang/String;JJ)[Lai/onnxruntime/OnnxValue;
- * private native OnnxValue[] run(long apiHandle, long nativeHandle, long allocatorHandle, String[] inputNamesArray, long[] inputs, long numInputs, String[] outputNamesArray, long numOutputs)
+ * Signature: (JJJ[Ljava/lang/String;[JJ[Ljava/lang/String;[JJJ)[Lai/onnxruntime/OnnxValue;
+ * private native OnnxValue[] run(long apiHandle, long nativeHandle, long allocatorHandle, String[] inputNamesArray, long[] inputs, long numInputs, String[] outputNamesArray, long[] outputs, long numOutputs, long runOptionsHandle)
  */
 JNIEXPORT jobjectArray JNICALL Java_ai_onnxruntime_OrtSession_run
-  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong sessionHandle, jlong allocatorHandle, jobjectArray inputNamesArr, jlongArray tensorArr, jlong numInputs, jobjectArray outputNamesArr, jlong numOutputs, jlong runOptionsHandle) {
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong sessionHandle, jlong allocatorHandle, jobjectArray inputNamesArr, jlongArray tensorArr, jlong numInputs, jobjectArray outputNamesArr, jlongArray outputTensorArr, jlong numOutputs, jlong runOptionsHandle) {
     (void) jobj; // Required JNI parameter not needed by functions which don't need to access their host object.
     const OrtApi* api = (const OrtApi*) apiHandle;
     OrtAllocator* allocator = (OrtAllocator*) allocatorHandle;
@@ -266,12 +266,14 @@ JNIEXPORT jobjectArray JNICALL Java_ai_onnxruntime_OrtSession_run
     jlong* inputTensors = (*jniEnv)->GetLongArrayElements(jniEnv,tensorArr,NULL);
 
     // Extract the names of the output values, and allocate their output array.
+    // Outputs with a supplied tensor are written into it by the run, the others are allocated by the run.
+    jlong* outputTensors = outputTensorArr != NULL ? (*jniEnv)->GetLongArrayElements(jniEnv,outputTensorArr,NULL) : NULL;
     OrtValue** outputValues;
     checkOrtStatus(jniEnv,api,api->AllocatorAlloc(allocator,sizeof(OrtValue*)*numOutputs,(void**)&outputValues));
     for (int i = 0; i < numOutputs; i++) {
         javaOutputStrings[i] = (*jniEnv)->GetObjectArrayElement(jniEnv,outputNamesArr,i);
         outputNames[i] = (*jniEnv)->GetStringUTFChars(jniEnv,javaOutputStrings[i],NULL);
-        outputValues[i] = NULL;
+        outputValues[i] = outputTensors != NULL ? (OrtValue*) outputTensors[i] : NULL;
     }
 
     // Actually score the inputs.
@@ -288,13 +290,16 @@ JNIEXPORT jobjectArray JNICALL Java_ai_onnxruntime_OrtSession_run
 
     // Convert the output tensors into ONNXValues and release the output strings.
     for (int i = 0; i < numOutputs; i++) {
-        if (outputValues[i] != NULL) {
+        if (outputValues[i] != NULL && (outputTensors == NULL || outputTensors[i] == 0)) {
             jobject onnxValue = convertOrtValueToONNXValue(jniEnv,api,allocator,outputValues[i]);
             (*jniEnv)->SetObjectArrayElement(jniEnv,outputArray,i,onnxValue);
         }
         (*jniEnv)->ReleaseStringUTFChars(jniEnv,javaOutputStrings[i],outputNames[i]);
     }
     checkOrtStatus(jniEnv,api,api->AllocatorFree(allocator,outputValues));
+    if (outputTensors != NULL) {
+        (*jniEnv)->ReleaseLongArrayElements(jniEnv,outputTensorArr,outputTensors,JNI_ABORT);
+    }
 
     // Release the Java input strings
     for (int i = 0; i < numInputs; i++) {
@@ -31,6 +31,7 @@ import java.nio.file.Files;
 import java.nio.file.Path;
 import java.nio.file.Paths;
 import java.util.ArrayList;
+import java.util.Collections;
 import java.util.HashMap;
 import java.util.HashSet;
 import java.util.Iterator;
@@ -767,6 +768,40 @@ public class InferenceTest {
     }
   }
 
+  @Test
+  public void testPinnedOutputsAndReusedInputs() throws OrtException {
+    // model takes 1x5 input of fixed type, echoes back
+    String modelPath = getResourcePath("/test_types_FLOAT.pb").toString();
+
+    try (OrtEnvironment env = OrtEnvironment.getEnvironment("testPinnedOutputsAndReusedInputs");
+        SessionOptions options = new SessionOptions();
+        OrtSession session = env.createSession(modelPath, options)) {
+      String inputName = session.getInputNames().iterator().next();
+      String outputName = session.getOutputNames().iterator().next();
+      long[] shape = new long[] {1, 5};
+      float[] flatInput = new float[] {1.0f, 2.0f, -3.0f, Float.MIN_VALUE, Float.MAX_VALUE};
+      try (OnnxTensor input = OnnxTensor.createTensor(env, OrtUtil.reshape(flatInput, shape));
+          OnnxTensor output = OnnxTensor.createTensor(env, OrtUtil.reshape(new float[5], shape))) {
+        Map<String, OnnxTensor> inputs = Collections.singletonMap(inputName, input);
+        Map<String, OnnxTensor> outputs = Collections.singletonMap(outputName, output);
+        FloatBuffer inputView = input.getByteBufferView().asFloatBuffer();
+        FloatBuffer outputView = output.getByteBufferView().asFloatBuffer();
+        float[] resultArray = new float[flatInput.length];
+        for (int run = 0; run < 2; run++) {
+          for (int i = 0; i < flatInput.length; i++) {
+            inputView.put(i, flatInput[i] + run);
+          }
+          session.run(inputs, outputs);
+          outputView.get(resultArray, 0, resultArray.length);
+          outputView.rewind();
+          for (int i = 0; i < flatInput.length; i++) {
+            assertEquals(flatInput[i] + run, resultArray[i], 1e-6f);
+          }
+        }
+      }
+    }
+  }
+
   @Test
   public void testModelInputFLOAT() throws OrtException {
     // model takes 1x5 input of fixed type, echoes back
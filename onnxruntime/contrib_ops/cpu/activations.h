@@ -77,15 +77,18 @@ class Gelu : public OpKernel {
           T* p_output = output_data + start;
           int64_t count = std::min(length_per_task, elem_count - start);
 
+          // the output may share the input buffer, so compute erf into a separate buffer
+          // to keep the input values available for the final multiplication.
+          T erf_buffer[length_per_task];
           for (int64_t i = 0; i < count; i++) {
             T value = p_input[i];
-            p_output[i] = value * static_cast<T>(M_SQRT1_2);
+            erf_buffer[i] = value * static_cast<T>(M_SQRT1_2);
           }
 
-          MlasComputeErf(p_output, p_output, count);
+          MlasComputeErf(erf_buffer, erf_buffer, count);
 
           for (int64_t i = 0; i < count; i++) {
-            p_output[i] = 0.5f * p_input[i] * (p_output[i] + 1.0f);
+            p_output[i] = 0.5f * p_input[i] * (erf_buffer[i] + 1.0f);
           }
         },
         0);
@@ -17,7 +17,9 @@ namespace contrib {
 // These ops are internal-only, so register outside of onnx
 #define REGISTER_KERNEL_TYPED(T)                                                                          \
   ONNX_OPERATOR_TYPED_KERNEL_EX(Attention, kMSDomain, 1, T, kCpuExecutionProvider,                        \
-                                KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+                                KernelDefBuilder()                                                        \
+                                    .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())                \
+                                    .MayInplace(4, 1),                                                    \
                                 Attention<T>);
 
 REGISTER_KERNEL_TYPED(float)
@@ -28,31 +30,39 @@ AttentionBase::AttentionBase(const OpKernelInfo& info) {
   num_heads_ = static_cast<int>(num_heads);
 
   is_unidirectional_ = info.GetAttrOrDefault<int64_t>("unidirectional", 0) == 1;
+  past_present_share_buffer_ = info.GetAttrOrDefault<int64_t>("past_present_share_buffer", 0) == 1;
 }
 
 Status AttentionBase::CheckInputs(const Tensor* input,
                                   const Tensor* weights,
                                   const Tensor* bias,
                                   const Tensor* mask_index,
-                                  const Tensor* past) const {
+                                  const Tensor* past,
+                                  const Tensor* cumulative_sequence_length,
+                                  const Tensor* past_sequence_length_tensor) const {
   // Input shapes:
-  //   input       : (batch_size, sequence_length, hidden_size)
+  //   input       : (batch_size, sequence_length, hidden_size), or (token_count, hidden_size) if packed
   //   weights     : (hidden_size, 3 * hidden_size)
   //   bias        : (3 * hidden_size)
   //   mask_index  : (batch_size) if presented
-  //   past        : (2, batch_size, num_heads, past_sequence_length, head_size)
+  //   past        : (2, batch_size, num_heads, past_sequence_length, head_size), or
+  //                 (2, batch_size, num_heads, max_sequence_length, head_size) if past_present_share_buffer
+  //   cumulative_sequence_length : (batch_size + 1) if packed
+  //   past_sequence_length       : (1) if past_present_share_buffer
 
   const auto& dims = input->Shape().GetDims();
-  if (dims.size() != 3) {
+  if (cumulative_sequence_length != nullptr) {
+    ORT_RETURN_IF_ERROR(CheckPackedInputs(input, mask_index, past, cumulative_sequence_length));
+  } else if (dims.size() != 3) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'input' is expected to have 3 dimensions, got ",
                            dims.size());
   }
   int batch_size = static_cast<int>(dims[0]);
-  int sequence_length = static_cast<int>(dims[1]);
-  int hidden_size = static_cast<int>(dims[2]);
+  int sequence_length = dims.size() == 3 ? static_cast<int>(dims[1]) : 0;
+  int hidden_size = static_cast<int>(dims.back());
   if (hidden_size % num_heads_ != 0) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                           "Input 0 dimension 2 should be divisiable by value of the num_heads attribute.");
+                           "The last dimension of input 0 should be divisiable by value of the num_heads attribute.");
   }
 
   const auto& weights_dims = weights->Shape().GetDims();
@@ -60,9 +70,9 @@ Status AttentionBase::CheckInputs(const Tensor* input,
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'weights' is expected to have 2 dimensions, got ",
                            weights_dims.size());
   }
-  if (weights_dims[0] != dims[2]) {
+  if (weights_dims[0] != dims.back()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                           "Input 1 dimension 0 should have same length as dimension 2 of input 0");
+                           "Input 1 dimension 0 should have same length as the last dimension of input 0");
   }
   if (weights_dims[1] != 3 * weights_dims[0]) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'weights' dimension 1 should be 3 times of dimension 0");
@@ -102,6 +112,22 @@ Status AttentionBase::CheckInputs(const Tensor* input,
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Inputs 'past' dimension 2 shall have length of ", hidden_size / num_heads_);
     }
     past_sequence_length = static_cast<int>(past_dims[3]);
+
+    if (past_present_share_buffer_) {
+      if (past_sequence_length_tensor == nullptr || past_sequence_length_tensor->Shape().Size() != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_sequence_length' with shape (1) is required when past_present_share_buffer is 1");
+      }
+      const int max_sequence_length = past_sequence_length;
+      past_sequence_length = *past_sequence_length_tensor->Data<int32_t>();
+      if (past_sequence_length < 0 || past_sequence_length + sequence_length > max_sequence_length) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'past_sequence_length' is ", past_sequence_length,
+                               ", but the past buffer only holds ", max_sequence_length, " steps for the ",
+                               sequence_length, " new steps");
+      }
+    }
+  } else if (past_present_share_buffer_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'past' is required when past_present_share_buffer is 1");
   }
 
   if (mask_index != nullptr) {  // mask_index is optional
@@ -122,18 +148,60 @@ Status AttentionBase::CheckInputs(const Tensor* input,
   return Status::OK();
 }
 
+Status AttentionBase::CheckPackedInputs(const Tensor* input,
+                                        const Tensor* mask_index,
+                                        const Tensor* past,
+                                        const Tensor* cumulative_sequence_length) const {
+  const auto& dims = input->Shape().GetDims();
+  if (dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Packed input 'input' is expected to have 2 dimensions, got ", dims.size());
+  }
+  if (mask_index != nullptr || past != nullptr || is_unidirectional_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Packed input does not support 'mask_index', 'past' or unidirectional attention");
+  }
+
+  const auto& offsets_dims = cumulative_sequence_length->Shape().GetDims();
+  if (offsets_dims.size() != 1 || offsets_dims[0] < 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' is expected to have shape (batch_size + 1)");
+  }
+
+  // the offsets are read on CPU by every provider to keep the sequences of the packed input apart
+  const int32_t* offsets = cumulative_sequence_length->template Data<int32_t>();
+  if (offsets[0] != 0 || offsets[offsets_dims[0] - 1] != dims[0]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' shall start with 0 and end with the token count ",
+                           dims[0]);
+  }
+  for (int64_t i = 1; i < offsets_dims[0]; ++i) {
+    if (offsets[i] < offsets[i - 1]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'cumulative_sequence_length' shall not be decreasing");
+    }
+  }
+
+  return Status::OK();
+}
+
 Tensor* AttentionBase::GetPresent(OpKernelContext* context,
                                   const Tensor* past,
                                   int batch_size,
                                   int head_size,
                                   int sequence_length,
-                                  int& past_sequence_length) const {
+                                  int& past_sequence_length,
+                                  const Tensor* past_sequence_length_tensor) const {
   // Input and output shapes:
   //   past        : (2, batch_size, num_heads, past_sequence_length, head_size)
   //   present     : (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)
+  // or, if past_present_share_buffer, both have the shape (2, batch_size, num_heads, max_sequence_length, head_size).
 
   std::vector<int64_t> present_dims{2, batch_size, num_heads_, sequence_length, head_size};
-  if (nullptr != past) {
+  if (past_present_share_buffer_) {
+    past_sequence_length = *past_sequence_length_tensor->Data<int32_t>();
+    present_dims = past->Shape().GetDims();
+  } else if (nullptr != past) {
     const auto& past_dims = past->Shape().GetDims();
     past_sequence_length = static_cast<int>(past_dims[3]);
     present_dims[3] += past_dims[3];
@@ -159,8 +227,15 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   const Tensor* bias = context->Input<Tensor>(2);
   const Tensor* mask_index = context->Input<Tensor>(3);
   const Tensor* past = context->Input<Tensor>(4);
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(5);
+  const Tensor* past_sequence_length = context->Input<Tensor>(6);
 
-  ORT_RETURN_IF_ERROR(CheckInputs(input, weights, bias, mask_index, past));
+  ORT_RETURN_IF_ERROR(CheckInputs(input, weights, bias, mask_index, past, cumulative_sequence_length,
+                                  past_sequence_length));
+
+  if (cumulative_sequence_length != nullptr) {
+    return ComputePacked(context, input, weights, bias, cumulative_sequence_length);
+  }
 
   const auto& shape = input->Shape().GetDims();
   const int batch_size = static_cast<int>(shape[0]);
@@ -176,6 +251,7 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
 
   auto* tp = context->GetOperatorThreadPool();
+
   // Compute Q, K, V
   // gemm_data(BS, 3NH) = input(BS, NH) x weights(NH, 3NH) + bias(3NH)
   auto gemm_data = allocator->Alloc(SafeInt<size_t>(batch_size) * sequence_length * 3 * hidden_size * element_size);
@@ -240,7 +316,106 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q, K, V, mask_index, past, output,
                         batch_size, sequence_length,
-                        head_size, hidden_size, context);
+                        head_size, hidden_size, context, past_sequence_length);
+}
+
+template <typename T>
+Status Attention<T>::ComputePacked(OpKernelContext* context,
+                                   const Tensor* input,
+                                   const Tensor* weights,
+                                   const Tensor* bias,
+                                   const Tensor* cumulative_sequence_length) const {
+  // Input and output shapes:
+  //   input                      : (T, NH), the T tokens of the B sequences packed
+  //   cumulative_sequence_length : (B + 1), the tokens of sequence b are in rows [offsets[b], offsets[b + 1])
+  //   output                     : (T, NH)
+  const auto& shape = input->Shape().GetDims();
+  const int token_count = static_cast<int>(shape[0]);
+  const int hidden_size = static_cast<int>(shape[1]);
+  const int head_size = hidden_size / num_heads_;
+  const int batch_size = static_cast<int>(cumulative_sequence_length->Shape()[0]) - 1;
+  const int32_t* offsets = cumulative_sequence_length->template Data<int32_t>();
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (token_count == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto* tp = context->GetOperatorThreadPool();
+
+  // Q, K and V of sequence b and head n are S_b x H matrices at offset (offsets[b] x N + n x S_b) x H
+  auto gemm_data = allocator->Alloc(SafeInt<size_t>(token_count) * 3 * hidden_size * sizeof(T));
+  BufferUniquePtr gemm_buffer(gemm_data, BufferDeleter(allocator));
+  auto Q = reinterpret_cast<T*>(gemm_data);
+  auto K = Q + token_count * hidden_size;
+  auto V = K + token_count * hidden_size;
+
+  T* QKV[3] = {Q, K, V};
+
+  // the attention probs of sequence b and head n are a S_b x S_b matrix
+  std::vector<size_t> probs_offsets(static_cast<size_t>(batch_size) + 1, 0);
+  for (int b = 0; b < batch_size; ++b) {
+    const size_t length = static_cast<size_t>(offsets[b + 1] - offsets[b]);
+    probs_offsets[b + 1] = probs_offsets[b] + SafeInt<size_t>(num_heads_) * length * length;
+  }
+  auto probs_data = allocator->Alloc(SafeInt<size_t>(probs_offsets[batch_size]) * sizeof(T));
+  BufferUniquePtr probs_buffer(probs_data, BufferDeleter(allocator));
+  auto probs_base = reinterpret_cast<T*>(probs_data);
+
+  const auto input_data = input->template Data<T>();
+  const auto weights_data = weights->template Data<T>();
+  const auto bias_data = bias->template Data<T>();
+  T* output_data = output->template MutableData<T>();
+
+  const int loop_len = batch_size * num_heads_;
+  const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
+  const double average_length = static_cast<double>(token_count) / batch_size;
+  const double cost = average_length * static_cast<double>(head_size) * (3.0 * hidden_size + 2.0 * average_length);
+
+  ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const int batch_index = static_cast<int>(i / num_heads_);
+      const int head_index = static_cast<int>(i % num_heads_);
+      const int length = offsets[batch_index + 1] - offsets[batch_index];
+      if (length == 0) {
+        continue;
+      }
+
+      const int qkv_offset = (offsets[batch_index] * num_heads_ + head_index * length) * head_size;
+      for (int qkv_index = 0; qkv_index < 3; ++qkv_index) {
+        const int weights_offset = qkv_index * hidden_size + head_index * head_size;
+        T* qkv_dest = QKV[qkv_index] + qkv_offset;
+
+        // broadcast 3NH -> S_b x H
+        for (int seq_index = 0; seq_index < length; seq_index++) {
+          memcpy(qkv_dest + seq_index * head_size, bias_data + weights_offset, head_size * sizeof(T));
+        }
+
+        // qkv(S_b, H) = input(S_b, NH) x weights(NH, H) + bias(H)
+        math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, length, head_size, hidden_size, 1.0f,
+                                        input_data + offsets[batch_index] * hidden_size, hidden_size,
+                                        weights_data + weights_offset, 3 * hidden_size,
+                                        1.0f, qkv_dest, head_size, nullptr);
+      }
+
+      // attention_probs(S_b, S_b) = Softmax(1/sqrt(H) x Q(S_b, H) x K'(H, S_b))
+      T* probs = probs_base + probs_offsets[batch_index] + static_cast<size_t>(head_index) * length * length;
+      math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, length, length, head_size, alpha,
+                                Q + qkv_offset, K + qkv_offset, 0.0f, probs, nullptr);
+      ComputeAttentionSoftmaxInplace(probs, length, length, nullptr);
+
+      // the output columns of the head: output(S_b, H) = attention_probs(S_b, S_b) x V(S_b, H)
+      math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, length, head_size, length, 1.0f,
+                                      probs, length, V + qkv_offset, head_size, 0.0f,
+                                      output_data + offsets[batch_index] * hidden_size + head_index * head_size,
+                                      hidden_size, nullptr);
+    }
+  });
+
+  return Status::OK();
 }
 
 }  // namespace contrib
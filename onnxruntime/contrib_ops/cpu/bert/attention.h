@@ -15,6 +15,14 @@ class Attention : public OpKernel, public AttentionCPUBase {
  public:
   explicit Attention(const OpKernelInfo& info);
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // Computes the attention of each sequence of a packed input separately, so no work is done for padding.
+  Status ComputePacked(OpKernelContext* context,
+                       const Tensor* input,
+                       const Tensor* weights,
+                       const Tensor* bias,
+                       const Tensor* cumulative_sequence_length) const;
 };
 
 }  // namespace contrib
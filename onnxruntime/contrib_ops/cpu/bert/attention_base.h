@@ -16,17 +16,29 @@ class AttentionBase {
                      const Tensor* weights,
                      const Tensor* bias,
                      const Tensor* mask_index,
-                     const Tensor* past) const;
+                     const Tensor* past,
+                     const Tensor* cumulative_sequence_length = nullptr,
+                     const Tensor* past_sequence_length = nullptr) const;
+
+  Status CheckPackedInputs(const Tensor* input,
+                           const Tensor* mask_index,
+                           const Tensor* past,
+                           const Tensor* cumulative_sequence_length) const;
 
   Tensor* GetPresent(OpKernelContext* context,
                      const Tensor* past,
                      int batch_size,
                      int head_size,
                      int sequence_length,
-                     int& past_sequence_length) const;
+                     int& past_sequence_length,
+                     const Tensor* past_sequence_length_tensor = nullptr) const;
 
   int num_heads_;           // number of attention heads
   bool is_unidirectional_;  // whether every token can only attend to previous tokens.
+
+  // whether past and present are buffers of the same shape (2, batch_size, num_heads, max_sequence_length, head_size)
+  // holding past_sequence_length valid steps, where the new keys and values are appended in place.
+  bool past_present_share_buffer_;
 };
 
 }  // namespace contrib
@@ -17,6 +17,9 @@ class AttentionCPUBase : public AttentionBase {
  protected:
   AttentionCPUBase(const OpKernelInfo& info) : AttentionBase(info) {}
 
+  // Whether Q x K' and attention_probs x V run as uint8 GEMMs on dynamically quantized operands.
+  bool use_quantized_gemm_ = false;
+
   template <typename T>
   Status ApplyAttention(const T* Q,                // Q data. Its size is BxNxSxH
                         const T* K,                // K data. Its size is BxNxSxH
@@ -28,18 +31,24 @@ class AttentionCPUBase : public AttentionBase {
                         int sequence_length,       // sequence length
                         int head_size,             // head size
                         int hidden_size,           // hidden size
-                        OpKernelContext* context) const {
+                        OpKernelContext* context,
+                        const Tensor* past_sequence_length_tensor = nullptr) const {
     AllocatorPtr allocator;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
 
     auto* tp = context->GetOperatorThreadPool();
 
     int past_sequence_length = 0;
-    Tensor* present = GetPresent(context, past, batch_size, head_size, sequence_length, past_sequence_length);
+    Tensor* present = GetPresent(context, past, batch_size, head_size, sequence_length, past_sequence_length,
+                                 past_sequence_length_tensor);
 
     // Total sequence length including that of past state: S* = S' + S
     const int all_sequence_length = past_sequence_length + sequence_length;
 
+    // Length of the steps of each head in the present state: S* or, with a shared buffer, its maximum length
+    const int present_sequence_length =
+        past_present_share_buffer_ ? static_cast<int>(present->Shape()[3]) : all_sequence_length;
+
     // Compute the attention score. It does 2 things:
     //         I. attention_probs(B, N, S, S*) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S*, H -> B, N, H, S*) +
     //                                           1 x mask_data(B, N, S, S*)
@@ -61,24 +70,60 @@ class AttentionCPUBase : public AttentionBase {
     const T* past_data = past != nullptr ? past->template Data<T>() : nullptr;
     T* present_data = present != nullptr ? present->template MutableData<T>() : nullptr;
 
-    ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
-                             mask_index_data, mask_index_dims, static_cast<T*>(mask_data),
-                             batch_size, sequence_length, past_sequence_length, head_size,
-                             past_data, present_data, tp);
+    // With a shared buffer, only the new steps are written to the present state. The past steps are already in place
+    // when present is bound to the buffer of past, else the buffer is copied first.
+    if (past_present_share_buffer_) {
+      if (present_data != past_data) {
+        memcpy(present_data, past_data, past->SizeInBytes());
+      }
+      past_data = nullptr;
+    }
 
-    // Compute the attentionScore * Value. It does: out_tmp(B, N, S, H) = attention_probs(B, N, S, S*) x V(B, N, S*, H)
+    // Buffer for the attentionScore * Value: out_tmp(B, N, S, H)
     auto out_tmp_data =
         allocator->Alloc(SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * head_size * sizeof(T));
     BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(allocator));
 
-    ComputeVxAttentionScore(output->template MutableData<T>(), static_cast<T*>(out_tmp_data), static_cast<T*>(attention_probs), V,
-                            batch_size, sequence_length, past_sequence_length, head_size, hidden_size,
-                            past_data, present_data, tp);
+    if (mask_data != nullptr) {
+      PrepareMask(mask_index_data, mask_index_dims, static_cast<T*>(mask_data), is_unidirectional_,
+                  batch_size, sequence_length, past_sequence_length);
+    } else {  // no any mask
+      memset(attention_probs, 0, attention_probs_bytes);
+    }
+
+    {
+      // Run the consecutive parallel loops below with one team of threads
+      ThreadPool::ParallelSection parallel_section(tp);
+
+      ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
+                               static_cast<T*>(mask_data),
+                               batch_size, sequence_length, past_sequence_length, present_sequence_length, head_size,
+                               past_data, present_data, tp);
+
+      // Compute the attentionScore * Value. It does: out_tmp(B, N, S, H) = attention_probs(B, N, S, S*) x V(B, N, S*, H)
+      ComputeVxAttentionScore(output->template MutableData<T>(), static_cast<T*>(out_tmp_data),
+                              static_cast<T*>(attention_probs), V,
+                              batch_size, sequence_length, past_sequence_length, present_sequence_length, head_size,
+                              hidden_size, past_data, present_data, tp);
+    }
 
     return Status::OK();
   }
 
  private:
+  template <typename T>
+  void AttentionGemmBatch(CBLAS_TRANSPOSE trans_b, int M, int N, int K, float alpha,
+                          const T* A, size_t stride_a, const T* B, size_t stride_b, float beta,
+                          T* C, size_t stride_c, int batch_count, ThreadPool* tp) const {
+    if (use_quantized_gemm_) {
+      ComputeQuantizedAttentionGemmBatch(trans_b, M, N, K, alpha, A, stride_a, B, stride_b, beta,
+                                         C, stride_c, batch_count, tp);
+    } else {
+      ComputeAttentionGemmBatch(trans_b, M, N, K, alpha, A, stride_a, B, stride_b, beta,
+                                C, stride_c, batch_count, tp);
+    }
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  I. attention_probs(B, N, S, S*) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S*, H -> B, N, H, S*) +
   //                                    1 x mask_data(B, N, S, S*)
@@ -87,61 +132,60 @@ class AttentionCPUBase : public AttentionBase {
   void ComputeAttentionProbs(T* attention_probs,                           // output buffer for the attention probs. Its size is BxNxSxS
                              const T* Q,                                   // Q data. Its size is BxNxSxH
                              const T* K,                                   // k data. Its size is BxNxSxH
-                             const int32_t* mask_index,                    // mask index. nullptr if no mask or its size is B
-                             const std::vector<int64_t>* mask_index_dims,  // mask index shape
-                             T* mask_data,                                 // buffer for mask data. Its size is: SxS* if is_unidirectional_; BxSxS* if mask_index; null otherwise
+                             T* mask_data,                                 // prepared mask data. Its size is: SxS* if is_unidirectional_; BxSxS* if mask_index; null otherwise
                              int batch_size,                               // batch size of self-attention
                              int sequence_length,                          // sequence length of self-attention
                              int past_sequence_length,                     // sequence length of past state
+                             int present_sequence_length,                  // steps of each head in present state
                              int head_size,                                // head size of self-attention
-                             const T* past,                                // past state
+                             const T* past,                                // past state. nullptr if already in present
                              T* present,                                   // present state
                              ThreadPool* tp) const {
     const int all_sequence_length = past_sequence_length + sequence_length;                  // S* = S' + S
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length * head_size);  // S' x H
     const size_t input_chunk_length = static_cast<size_t>(sequence_length * head_size);      // S x H
-    const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // S* x H
+    const size_t present_chunk_length = static_cast<size_t>(present_sequence_length) * head_size;  // S* x H
 
     {
-      if (mask_data != nullptr) {
-        PrepareMask(mask_index, mask_index_dims, mask_data, is_unidirectional_, batch_size, sequence_length, past_sequence_length);
-      } else {  // no any mask
-        memset(attention_probs, 0, batch_size * num_heads_ * sequence_length * all_sequence_length * sizeof(T));
-      }
-
+      // attention_probs holds zeros when there is no mask
       const int loop_len = batch_size * num_heads_;
       const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
 
-      // The cost of Gemm
-      const double cost = static_cast<double>(head_size * sequence_length * all_sequence_length);
-
-      ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
-        for (std::ptrdiff_t i = begin; i != end; ++i) {
-          const std::ptrdiff_t batch_index = i / num_heads_;
-
-          // broadcast mask data: (Bx)SxS* -> (BxNx)SxS*
-          if (mask_data != nullptr) {
-            const T* broadcast_data_src = reinterpret_cast<T*>(mask_data) + batch_index * sequence_length * all_sequence_length;
-            T* broadcast_data_dest = reinterpret_cast<T*>(attention_probs) + sequence_length * all_sequence_length * i;
-            memcpy(broadcast_data_dest, broadcast_data_src, sequence_length * all_sequence_length * sizeof(T));
-          }
-
-          const T* k = K + input_chunk_length * i;
-          if (nullptr != present) {
-            // concatenate past_K and K : (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
-            k = ConcatStateChunk(past, k, present, past_chunk_length, present_chunk_length, i);
+      if (mask_data != nullptr || nullptr != present) {
+        // The cost of the copies
+        const double cost = static_cast<double>(sequence_length * all_sequence_length + present_chunk_length);
+
+        ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const std::ptrdiff_t batch_index = i / num_heads_;
+
+            // broadcast mask data: (Bx)SxS* -> (BxNx)SxS*
+            if (mask_data != nullptr) {
+              const T* broadcast_data_src = reinterpret_cast<T*>(mask_data) + batch_index * sequence_length * all_sequence_length;
+              T* broadcast_data_dest = reinterpret_cast<T*>(attention_probs) + sequence_length * all_sequence_length * i;
+              memcpy(broadcast_data_dest, broadcast_data_src, sequence_length * all_sequence_length * sizeof(T));
+            }
+
+            if (nullptr != present) {
+              // concatenate past_K and K : (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
+              ConcatStateChunk(past, K + input_chunk_length * i, present, past_chunk_length, input_chunk_length,
+                               present_chunk_length, i);
+            }
           }
+        });
+      }
 
-          // gemm
-          //                     original                 transposed             each iteration
-          // A: Q                (B x N x) S x H          (B x N x) S x H        S x H
-          // B: K'               (B x N x) S* x H         (B x N x) H x S*       H x S*
-          // C: attention_probs  (B x N x) S x S*         (B x N x) S x S*       S x S*
-          math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, all_sequence_length, head_size, alpha,
-                                    Q + input_chunk_length * i, k, 1.0,
-                                    reinterpret_cast<T*>(attention_probs) + sequence_length * all_sequence_length * i, nullptr);
-        }
-      });
+      // gemm
+      //                     original                 transposed             each iteration
+      // A: Q                (B x N x) S x H          (B x N x) S x H        S x H
+      // B: K'               (B x N x) S* x H         (B x N x) H x S*       H x S*
+      // C: attention_probs  (B x N x) S x S*         (B x N x) S x S*       S x S*
+      const T* k = nullptr != present ? present : K;
+      const size_t k_chunk_length = nullptr != present ? present_chunk_length : input_chunk_length;
+      AttentionGemmBatch(CblasTrans, sequence_length, all_sequence_length, head_size, alpha,
+                         Q, input_chunk_length, k, k_chunk_length, 1.0f,
+                         attention_probs, static_cast<size_t>(sequence_length) * all_sequence_length,
+                         loop_len, tp);
     }
 
     //  attention_probs(B, N, S, S*) = Softmax(attention_probs)
@@ -160,44 +204,54 @@ class AttentionCPUBase : public AttentionBase {
                                int batch_size,            // batch size
                                int sequence_length,       // sequence length
                                int past_sequence_length,  // sequence length in past state
+                               int present_sequence_length,  // steps of each head in present state
                                int head_size,             // head size
                                int hidden_size,           // hidden size
-                               const T* past,             // past state
+                               const T* past,             // past state. nullptr if already in present
                                T* present,                // present state
                                ThreadPool* tp) const {
     const int all_sequence_length = past_sequence_length + sequence_length;                  // S* = S' + S
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length * head_size);  // S' x H
     const size_t input_chunk_length = static_cast<size_t>(sequence_length * head_size);      // S x H
-    const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // S* x H
+    const size_t present_chunk_length = static_cast<size_t>(present_sequence_length) * head_size;  // S* x H
 
     // Move the pointer of past and present to start of v values.
     if (nullptr != past) {
       past += batch_size * num_heads_ * past_sequence_length * head_size;
     }
     if (nullptr != present) {
-      present += batch_size * num_heads_ * all_sequence_length * head_size;
+      present += batch_size * num_heads_ * present_chunk_length;
     }
 
-    const double cost =
-        static_cast<double>(sequence_length) * static_cast<double>(head_size) * static_cast<double>(sequence_length);
+    const int loop_len = batch_size * num_heads_;
 
-    ThreadPool::TryParallelFor(tp, batch_size * num_heads_, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
-      for (std::ptrdiff_t i = begin; i != end; ++i) {
-        const T* v = V + input_chunk_length * i;
-        if (nullptr != present) {
+    if (nullptr != present) {
+      const double cost = static_cast<double>(present_chunk_length);
+
+      ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
           // concatenate past_V and V: (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
-          v = ConcatStateChunk(past, v, present, past_chunk_length, present_chunk_length, i);
+          ConcatStateChunk(past, V + input_chunk_length * i, present, past_chunk_length, input_chunk_length,
+                           present_chunk_length, i);
         }
+      });
+    }
 
-        T* current_tmp_data = reinterpret_cast<T*>(tmp_buffer) + input_chunk_length * i;
-        math::MatMul<T>(sequence_length, head_size, all_sequence_length,
-                        attention_probs + sequence_length * all_sequence_length * i,
-                        v, current_tmp_data, nullptr);
+    // out_tmp(B, N, S, H) = attention_probs(B, N, S, S*) x V(B, N, S*, H)
+    const T* v = nullptr != present ? present : V;
+    const size_t v_chunk_length = nullptr != present ? present_chunk_length : input_chunk_length;
+    AttentionGemmBatch(CblasNoTrans, sequence_length, head_size, all_sequence_length, 1.0f,
+                       attention_probs, static_cast<size_t>(sequence_length) * all_sequence_length,
+                       v, v_chunk_length, 0.0f, tmp_buffer, input_chunk_length, loop_len, tp);
 
-        // transpose: out(B, S, N, H) = transpose out_tmp(B, N, S, H)
+    // transpose: out(B, S, N, H) = transpose out_tmp(B, N, S, H)
+    const double cost = static_cast<double>(input_chunk_length);
+
+    ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
         const int batch_index = static_cast<int>(i / num_heads_);
         const int head_index = static_cast<int>(i % num_heads_);
-        T* src = current_tmp_data;
+        const T* src = tmp_buffer + input_chunk_length * i;
         T* dest = output + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
         const auto bytes_to_copy = SafeInt<size_t>(head_size) * sizeof(T);
         for (int j = 0; j < sequence_length; j++) {
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <vector>
+
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 #include "core/common/safeint.h"
 #include "core/platform/threadpool.h"
 #include "core/mlas/inc/mlas.h"
@@ -59,6 +62,97 @@ inline void ComputeAttentionSoftmaxInplace(float* score, int N, int D, ThreadPoo
   MlasComputeSoftmax(score, score, N, D, false, tp);
 }
 
+// Computes C[i] = alpha x A[i] x op(B[i]) + beta x C[i] for a batch of packed row major matrices, where
+// A[i] is MxK, op(B[i]) is KxN and C[i] is MxN. The matrices of entry i start at i x stride of the first matrix.
+template <typename T>
+void ComputeAttentionGemmBatch(CBLAS_TRANSPOSE trans_b, int M, int N, int K, float alpha,
+                               const T* A, size_t stride_a, const T* B, size_t stride_b, float beta,
+                               T* C, size_t stride_c, int batch_count, ThreadPool* tp) {
+  const double cost = static_cast<double>(M) * static_cast<double>(N) * static_cast<double>(K);
+  ThreadPool::TryParallelFor(tp, batch_count, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      math::Gemm<T, ThreadPool>(CblasNoTrans, trans_b, M, N, K, alpha, A + stride_a * i, B + stride_b * i, beta,
+                                C + stride_c * i, nullptr);
+    }
+  });
+}
+
+template <>
+inline void ComputeAttentionGemmBatch(CBLAS_TRANSPOSE trans_b, int M, int N, int K, float alpha,
+                                      const float* A, size_t stride_a, const float* B, size_t stride_b, float beta,
+                                      float* C, size_t stride_c, int batch_count, ThreadPool* tp) {
+  MlasGemmBatch(CblasNoTrans, trans_b, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                alpha, A, static_cast<size_t>(K), stride_a,
+                B, static_cast<size_t>(trans_b == CblasNoTrans ? N : K), stride_b,
+                beta, C, static_cast<size_t>(N), stride_c, static_cast<size_t>(batch_count), tp);
+}
+
+// Computes the same batch as ComputeAttentionGemmBatch with uint8 GEMMs. A[i] and B[i] are dynamically quantized
+// per matrix, which trades some accuracy for integer matrix multiplications. Types other than float run in T.
+template <typename T>
+void ComputeQuantizedAttentionGemmBatch(CBLAS_TRANSPOSE trans_b, int M, int N, int K, float alpha,
+                                        const T* A, size_t stride_a, const T* B, size_t stride_b, float beta,
+                                        T* C, size_t stride_c, int batch_count, ThreadPool* tp) {
+  ComputeAttentionGemmBatch(trans_b, M, N, K, alpha, A, stride_a, B, stride_b, beta, C, stride_c, batch_count, tp);
+}
+
+template <>
+inline void ComputeQuantizedAttentionGemmBatch(CBLAS_TRANSPOSE trans_b, int M, int N, int K, float alpha,
+                                               const float* A, size_t stride_a, const float* B, size_t stride_b,
+                                               float beta, float* C, size_t stride_c, int batch_count,
+                                               ThreadPool* tp) {
+  const size_t a_size = static_cast<size_t>(M) * K;
+  const size_t b_size = static_cast<size_t>(K) * N;
+  const size_t c_size = static_cast<size_t>(M) * N;
+  const double cost = static_cast<double>(M) * static_cast<double>(N) * static_cast<double>(K);
+  ThreadPool::TryParallelFor(tp, batch_count, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    std::vector<uint8_t> a_quant(a_size);
+    std::vector<uint8_t> b_quant(b_size);
+    std::vector<uint8_t> b_transposed(trans_b == CblasNoTrans ? 0 : b_size);
+    std::vector<int32_t> c_int(c_size);
+
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const float* a = A + stride_a * i;
+      const float* b = B + stride_b * i;
+      float* c = C + stride_c * i;
+
+      float a_scale;
+      uint8_t a_zero_point;
+      GetQuantizationParameter(a, static_cast<int64_t>(a_size), a_scale, a_zero_point);
+      MlasQuantizeLinear(a, a_quant.data(), a_size, a_scale, a_zero_point);
+
+      float b_scale;
+      uint8_t b_zero_point;
+      GetQuantizationParameter(b, static_cast<int64_t>(b_size), b_scale, b_zero_point);
+      if (trans_b == CblasNoTrans) {
+        MlasQuantizeLinear(b, b_quant.data(), b_size, b_scale, b_zero_point);
+      } else {
+        // B[i] is N x K: quantize it as is, then transpose it to the K x N layout of the GEMM.
+        MlasQuantizeLinear(b, b_transposed.data(), b_size, b_scale, b_zero_point);
+        for (int n = 0; n < N; n++) {
+          for (int k = 0; k < K; k++) {
+            b_quant[static_cast<size_t>(k) * N + n] = b_transposed[static_cast<size_t>(n) * K + k];
+          }
+        }
+      }
+
+      QGemm(M, N, K, a_quant.data(), K, a_zero_point, b_quant.data(), N, b_zero_point, false,
+            c_int.data(), N, nullptr);
+
+      const float scale = alpha * a_scale * b_scale;
+      if (beta == 0.0f) {
+        for (size_t j = 0; j < c_size; j++) {
+          c[j] = scale * static_cast<float>(c_int[j]);
+        }
+      } else {
+        for (size_t j = 0; j < c_size; j++) {
+          c[j] = scale * static_cast<float>(c_int[j]) + beta * c[j];
+        }
+      }
+    }
+  });
+}
+
 template <typename T>
 void PrepareMask(const int32_t* mask_index,
                  const std::vector<int64_t>* mask_index_dims,
@@ -126,17 +220,17 @@ void PrepareMask(const int32_t* mask_index,
 // Concatenate a past state chunk S'xH with input state chunk SxH into present state chunk S*xH
 // Returns a pointer to the start of present state chunk.
 template <typename T>
-T* ConcatStateChunk(const T* past, const T* chunk, T* present, size_t past_chunk_length, size_t present_chunk_length, std::ptrdiff_t i) {
+T* ConcatStateChunk(const T* past, const T* chunk, T* present, size_t past_chunk_length, size_t input_chunk_length,
+                    size_t present_chunk_length, std::ptrdiff_t i) {
   T* start = present + i * present_chunk_length;
 
-  T* p = start;
+  // the past steps may already be in place in the present state
   if (nullptr != past) {
     const T* src_past = past + i * past_chunk_length;
-    memcpy(p, src_past, past_chunk_length * sizeof(T));
-    p += past_chunk_length;
+    memcpy(start, src_past, past_chunk_length * sizeof(T));
   }
 
-  memcpy(p, chunk, (present_chunk_length - past_chunk_length) * sizeof(T));
+  memcpy(start + past_chunk_length, chunk, input_chunk_length * sizeof(T));
   return start;
 }
 
@@ -41,18 +41,35 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
   const Tensor* gamma = context->Input<Tensor>(5);
   const Tensor* beta = context->Input<Tensor>(6);
   const Tensor* mask = context->Input<Tensor>(7);  // optional. nullptr if not provided
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(8);  // optional. nullptr if not packed
 
   const auto& input_dims = input_ids->Shape().GetDims();
   int64_t hidden_size = word_embedding->Shape()[1];
 
-  TensorShape output_shape({input_dims[0], input_dims[1], hidden_size});
-  Tensor* output = context->Output(0, output_shape);
+  // Packed input_ids (token_count) are handled as one sequence with the positions restarting at each offset.
+  const bool is_packed = nullptr != cumulative_sequence_length;
+  int batch_size = is_packed ? static_cast<int>(cumulative_sequence_length->Shape()[0]) - 1
+                             : static_cast<int>(input_dims[0]);
+  int sequence_length = is_packed ? static_cast<int>(input_dims[0]) : static_cast<int>(input_dims[1]);
 
-  TensorShape mask_index_shape({input_dims[0]});
+  std::vector<int64_t> output_dims(input_dims);
+  output_dims.push_back(hidden_size);
+  Tensor* output = context->Output(0, TensorShape(output_dims));
+
+  TensorShape mask_index_shape({batch_size});
   Tensor* mask_index = context->Output(1, mask_index_shape);
 
-  int batch_size = static_cast<int>(input_dims[0]);
-  int sequence_length = static_cast<int>(input_dims[1]);
+  std::vector<int32_t> packed_positions;
+  if (is_packed) {
+    const int32_t* offsets = cumulative_sequence_length->template Data<int32_t>();
+    packed_positions.resize(sequence_length);
+    for (int b = 0; b < batch_size; b++) {
+      for (int32_t t = offsets[b]; t < offsets[b + 1]; t++) {
+        packed_positions[t] = t - offsets[b];
+      }
+    }
+  }
+  const int32_t* positions = is_packed ? packed_positions.data() : nullptr;
 
   int word_embedding_length = static_cast<int>(word_embedding->Shape()[0]);
   int position_embedding_length = static_cast<int>(position_embedding->Shape()[0]);
@@ -71,14 +88,14 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
   {
     std::atomic_bool failed{false};
 
-    int n = batch_size * sequence_length;
+    int n = is_packed ? sequence_length : batch_size * sequence_length;
     concurrency::ThreadPool::TryBatchParallelFor(context->GetOperatorThreadPool(), n, [=, &failed](ptrdiff_t index) {
       int word_col_index = input_ids_data[index];
       if (word_col_index < 0 || word_col_index >= word_embedding_length) {
         failed.store(true, std::memory_order_release);
         return;
       }
-      int position_col_index = index % sequence_length;
+      int position_col_index = nullptr != positions ? positions[index] : index % sequence_length;
       if (position_col_index >= position_embedding_length) {
         failed.store(true, std::memory_order_release);
         return;
@@ -118,8 +135,13 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
     }
   }
 
-  // Calculate mask
-  if (nullptr != mask) {
+  // Calculate mask. The mask index of packed input is the length of each sequence.
+  if (is_packed) {
+    const int32_t* offsets = cumulative_sequence_length->template Data<int32_t>();
+    for (int b = 0; b < batch_size; b++) {
+      mask_index->template MutableData<int32_t>()[b] = offsets[b + 1] - offsets[b];
+    }
+  } else if (nullptr != mask) {
     const int32_t* mask_data = mask->template Data<int32_t>();
     for (int b = 0; b < batch_size; b++) {
       mask_index->template MutableData<int32_t>()[b] = static_cast<int32_t>(std::count_if(mask_data + (b * sequence_length),
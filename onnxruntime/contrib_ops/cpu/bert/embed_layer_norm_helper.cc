@@ -9,6 +9,43 @@ namespace onnxruntime {
 namespace contrib {
 namespace embed_layer_norm {
 
+Status CheckPackedInputs(const Tensor* input_ids, const Tensor* mask, const Tensor* cumulative_sequence_length) {
+  const auto& input_dims = input_ids->Shape().GetDims();
+  if (input_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Packed input_ids is expected to have 1 dimension, got ", input_dims.size());
+  }
+
+  if (nullptr != mask) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 7 (mask) is not allowed with packed input_ids");
+  }
+
+  const auto& offsets_dims = cumulative_sequence_length->Shape().GetDims();
+  if (offsets_dims.size() != 1 || offsets_dims[0] < 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "cumulative_sequence_length is expected to have shape (batch_size + 1)");
+  }
+
+  // the offsets stay on the device for the CUDA kernel, so they are only validated when they are in CPU memory
+  if (cumulative_sequence_length->Location().device.Type() == OrtDevice::CPU) {
+    const int32_t* offsets = cumulative_sequence_length->template Data<int32_t>();
+    if (offsets[0] != 0 || offsets[offsets_dims[0] - 1] != input_dims[0]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "cumulative_sequence_length shall start with 0 and end with the token count ",
+                             input_dims[0]);
+    }
+    for (int64_t i = 1; i < offsets_dims[0]; ++i) {
+      if (offsets[i] < offsets[i - 1]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "cumulative_sequence_length shall not be decreasing");
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 Status CheckInputs(const OpKernelContext* context) {
   const Tensor* input_ids = context->Input<Tensor>(0);
   const Tensor* segment_ids = context->Input<Tensor>(1);
@@ -18,6 +55,7 @@ Status CheckInputs(const OpKernelContext* context) {
   const Tensor* gamma = context->Input<Tensor>(5);
   const Tensor* beta = context->Input<Tensor>(6);
   const Tensor* mask = context->Input<Tensor>(7); // optional. nullptr if not provided
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(8);  // optional. nullptr if not packed
 
   if (input_ids->Shape() != segment_ids->Shape()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
@@ -31,7 +69,9 @@ Status CheckInputs(const OpKernelContext* context) {
 
 
   const auto& input_dims = input_ids->Shape().GetDims();
-  if (input_dims.size() != 2) {
+  if (nullptr != cumulative_sequence_length) {
+    ORT_RETURN_IF_ERROR(CheckPackedInputs(input_ids, mask, cumulative_sequence_length));
+  } else if (input_dims.size() != 2) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "input_ids is expected to have 2 dimensions, got ", input_dims.size());
   }
@@ -12,6 +12,9 @@ namespace embed_layer_norm {
 
 Status CheckInputs(const OpKernelContext* context);
 
+// Checks input_ids of shape (token_count) packing sequences at the offsets of cumulative_sequence_length.
+Status CheckPackedInputs(const Tensor* input_ids, const Tensor* mask, const Tensor* cumulative_sequence_length);
+
 }  // namespace embed_layer_norm
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/embedding_bag.h"
+
+#include <algorithm>
+
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag);
+
+namespace {
+
+template <typename Tind>
+Status ComputeEmbeddingBag(const Tensor& table, const Tensor& indices, const Tensor* offsets,
+                           int64_t batch_size, int64_t bag_size, bool mean, Tensor& Y,
+                           concurrency::ThreadPool* thread_pool) {
+  const int64_t num_embeddings = table.Shape()[0];
+  const int64_t embedding_dim = table.Shape()[1];
+  const int64_t num_indices = indices.Shape().Size();
+  const Tind* indices_data = indices.Data<Tind>();
+  const Tind* offsets_data = offsets != nullptr ? offsets->Data<Tind>() : nullptr;
+
+  // validate up front so that the bags can be reduced in parallel without failing
+  for (int64_t i = 0; i < num_indices; ++i) {
+    const int64_t index = static_cast<int64_t>(indices_data[i]);
+    if (index < -num_embeddings || index >= num_embeddings) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "EmbeddingBag index ", index,
+                             " is out of range for a table of ", num_embeddings, " rows");
+    }
+  }
+  for (int64_t b = 0; offsets_data != nullptr && b < batch_size; ++b) {
+    const int64_t begin = static_cast<int64_t>(offsets_data[b]);
+    const int64_t end = b + 1 < batch_size ? static_cast<int64_t>(offsets_data[b + 1]) : num_indices;
+    if (begin < 0 || begin > end || end > num_indices) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "EmbeddingBag offsets must be increasing and within the ",
+                             num_indices, " indices, got ", begin, " for bag ", b);
+    }
+  }
+
+  const float* table_data = table.Data<float>();
+  float* output_data = Y.MutableData<float>();
+
+  auto reduce_bags = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t b = first; b < last; ++b) {
+      const int64_t begin = offsets_data != nullptr ? static_cast<int64_t>(offsets_data[b]) : b * bag_size;
+      const int64_t end = offsets_data == nullptr ? begin + bag_size
+                                                  : (b + 1 < batch_size ? static_cast<int64_t>(offsets_data[b + 1])
+                                                                        : num_indices);
+
+      float* output = output_data + b * embedding_dim;
+      std::fill_n(output, embedding_dim, 0.0f);
+      for (int64_t i = begin; i < end; ++i) {
+        int64_t index = static_cast<int64_t>(indices_data[i]);
+        index = index < 0 ? index + num_embeddings : index;
+        const float* row = table_data + index * embedding_dim;
+        for (int64_t d = 0; d < embedding_dim; ++d) {
+          output[d] += row[d];
+        }
+      }
+
+      if (mean && end > begin) {
+        const float scale = 1.0f / static_cast<float>(end - begin);
+        for (int64_t d = 0; d < embedding_dim; ++d) {
+          output[d] *= scale;
+        }
+      }
+    }
+  };
+
+  const double bag_elements = batch_size > 0 ? static_cast<double>(num_indices) / batch_size * embedding_dim : 0.0;
+  concurrency::ThreadPool::TryParallelFor(thread_pool, static_cast<std::ptrdiff_t>(batch_size),
+                                          TensorOpCost{bag_elements * sizeof(float),
+                                                       static_cast<double>(embedding_dim * sizeof(float)),
+                                                       bag_elements},
+                                          reduce_bags);
+  return Status::OK();
+}
+
+}  // namespace
+
+Status EmbeddingBag::Compute(OpKernelContext* context) const {
+  const Tensor& table = *context->Input<Tensor>(0);
+  const Tensor& indices = *context->Input<Tensor>(1);
+  const Tensor* offsets = context->Input<Tensor>(2);
+
+  int64_t batch_size, bag_size;
+  ORT_RETURN_IF_ERROR(PrepareForCompute(table, indices, offsets, batch_size, bag_size));
+
+  Tensor& Y = *context->Output(0, {batch_size, table.Shape()[1]});
+  if (Y.Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+  if (indices.IsDataType<int32_t>()) {
+    return ComputeEmbeddingBag<int32_t>(table, indices, offsets, batch_size, bag_size, mean_, Y, thread_pool);
+  }
+  return ComputeEmbeddingBag<int64_t>(table, indices, offsets, batch_size, bag_size, mean_, Y, thread_pool);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// The attributes and input validation shared by the EmbeddingBag kernels.
+class EmbeddingBagBase {
+ protected:
+  EmbeddingBagBase(const OpKernelInfo& info) {
+    const std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+    ORT_ENFORCE(mode == "sum" || mode == "mean", "EmbeddingBag mode must be 'sum' or 'mean', got ", mode);
+    mean_ = mode == "mean";
+  }
+
+  // Checks the input shapes and returns the number of bags, which is the first dim of 2D indices or the size of the
+  // offsets, and the size of the bags of 2D indices, or 0 if the bags are given by offsets.
+  Status PrepareForCompute(const Tensor& table, const Tensor& indices, const Tensor* offsets,
+                           int64_t& batch_size, int64_t& bag_size) const {
+    if (table.Shape().NumDimensions() != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "EmbeddingBag table must be 2D, got ", table.Shape());
+    }
+    if (offsets != nullptr) {
+      if (indices.Shape().NumDimensions() != 1 || offsets->Shape().NumDimensions() != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "EmbeddingBag indices and offsets must be 1D, got ", indices.Shape(), " and ",
+                               offsets->Shape());
+      }
+      batch_size = offsets->Shape()[0];
+      bag_size = 0;
+    } else {
+      if (indices.Shape().NumDimensions() != 2) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "EmbeddingBag indices must be 2D without offsets, got ", indices.Shape());
+      }
+      batch_size = indices.Shape()[0];
+      bag_size = indices.Shape()[1];
+    }
+    return Status::OK();
+  }
+
+  bool mean_;
+};
+
+class EmbeddingBag final : public OpKernel, public EmbeddingBagBase {
+ public:
+  EmbeddingBag(const OpKernelInfo& info) : OpKernel(info), EmbeddingBagBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,299 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_elementwise.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace fused_elementwise {
+
+Status ParseProgram(const OpKernelInfo& info, std::vector<Step>& steps) {
+  static const std::unordered_map<std::string, OpType> op_types{
+      {"Add", OpType::Add}, {"Sub", OpType::Sub}, {"Mul", OpType::Mul}, {"Div", OpType::Div},
+      {"Sqrt", OpType::Sqrt}, {"Erf", OpType::Erf}, {"Tanh", OpType::Tanh}, {"Sigmoid", OpType::Sigmoid},
+      {"Relu", OpType::Relu}, {"Exp", OpType::Exp}, {"Neg", OpType::Neg}, {"Abs", OpType::Abs},
+      {"Reciprocal", OpType::Reciprocal}};
+
+  std::vector<std::string> ops;
+  std::vector<int64_t> operands;
+  ORT_RETURN_IF_ERROR(info.GetAttrs<std::string>("ops", ops));
+  ORT_RETURN_IF_ERROR(info.GetAttrs<int64_t>("operands", operands));
+
+  const int64_t input_count = static_cast<int64_t>(info.GetInputCount());
+  if (input_count < 1 || input_count > kMaxInputs) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise has ", input_count,
+                           " inputs, which must be between 1 and ", kMaxInputs);
+  }
+  if (ops.empty() || ops.size() > static_cast<size_t>(kMaxSteps)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise has ", ops.size(),
+                           " ops, which must be between 1 and ", kMaxSteps);
+  }
+  if (operands.size() != 2 * ops.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise has ", operands.size(),
+                           " operands for ", ops.size(), " ops. Each op has 2 operands.");
+  }
+
+  steps.clear();
+  for (size_t i = 0; i < ops.size(); ++i) {
+    auto op_type = op_types.find(ops[i]);
+    if (op_type == op_types.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise doesn't support ", ops[i]);
+    }
+
+    Step step{op_type->second, {-1, -1}};
+    // the operands can only be the inputs and the results of the previous steps
+    const int64_t operand_count = input_count + static_cast<int64_t>(i);
+    for (int j = 0; j < (IsBinary(step.op_type) ? 2 : 1); ++j) {
+      const int64_t operand = operands[2 * i + j];
+      if (operand < 0 || operand >= operand_count) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid operand ", operand, " of the op ", i,
+                               " of FusedElementwise");
+      }
+      step.operands[j] = static_cast<int32_t>(operand);
+    }
+    steps.push_back(step);
+  }
+
+  return Status::OK();
+}
+
+Status PrepareBroadcast(const std::vector<const TensorShape*>& input_shapes,
+                        std::vector<int64_t>& output_dims,
+                        std::vector<InputInfo>& input_infos) {
+  size_t rank = 0;
+  for (const auto* shape : input_shapes) {
+    rank = std::max(rank, shape->NumDimensions());
+  }
+
+  output_dims.assign(rank, 1);
+  for (const auto* shape : input_shapes) {
+    const size_t offset = rank - shape->NumDimensions();
+    for (size_t i = 0; i < shape->NumDimensions(); ++i) {
+      const int64_t dim = (*shape)[i];
+      int64_t& output_dim = output_dims[offset + i];
+      if (dim == output_dim || dim == 1) {
+        continue;
+      }
+      if (output_dim != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise: the input shapes ",
+                               *input_shapes[0], " and ", *shape, " can't be broadcast");
+      }
+      output_dim = dim;
+    }
+  }
+
+  const int64_t output_size = TensorShape(output_dims).Size();
+  input_infos.clear();
+  for (const auto* shape : input_shapes) {
+    InputInfo input_info{InputKind::Broadcast, shape->Size(), {}};
+    const size_t offset = rank - shape->NumDimensions();
+
+    if (input_info.size == output_size) {
+      input_info.kind = InputKind::Full;
+    } else if (input_info.size == 1) {
+      input_info.kind = InputKind::Scalar;
+    } else {
+      // the dims of the input after its leading 1s must be the trailing dims of the output
+      size_t first_dim = 0;
+      while (first_dim < shape->NumDimensions() && (*shape)[first_dim] == 1) {
+        ++first_dim;
+      }
+      bool is_suffix = true;
+      for (size_t i = first_dim; i < shape->NumDimensions(); ++i) {
+        is_suffix = is_suffix && (*shape)[i] == output_dims[offset + i];
+      }
+
+      if (is_suffix) {
+        input_info.kind = InputKind::Suffix;
+      } else {
+        input_info.strides.assign(rank, 0);
+        int64_t stride = 1;
+        for (size_t i = shape->NumDimensions(); i-- > 0;) {
+          if ((*shape)[i] != 1) {
+            input_info.strides[offset + i] = stride;
+          }
+          stride *= (*shape)[i];
+        }
+      }
+    }
+    input_infos.push_back(std::move(input_info));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace fused_elementwise
+
+using namespace fused_elementwise;
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+// Number of elements of the output computed at a time. The tiles of the inputs and of the results of the steps
+// are small enough to stay in the L1 or L2 cache.
+constexpr int64_t kTileSize = 512;
+
+// Returns the elements [begin, begin + count) of the input broadcast to the output, gathered in buffer if the input
+// isn't contiguous.
+const float* LoadInput(const float* input, const InputInfo& input_info, const std::vector<int64_t>& output_dims,
+                       int64_t begin, int64_t count, bool is_first_tile, float* buffer) {
+  switch (input_info.kind) {
+    case InputKind::Full:
+      return input + begin;
+    case InputKind::Scalar:
+      // the buffer is the same for all the tiles
+      if (is_first_tile) {
+        std::fill_n(buffer, kTileSize, *input);
+      }
+      return buffer;
+    case InputKind::Suffix: {
+      int64_t offset = begin % input_info.size;
+      for (int64_t i = 0; i < count;) {
+        const int64_t chunk = std::min(count - i, input_info.size - offset);
+        std::memcpy(buffer + i, input + offset, static_cast<size_t>(chunk) * sizeof(float));
+        i += chunk;
+        offset = 0;
+      }
+      return buffer;
+    }
+    default:
+      for (int64_t i = 0; i < count; ++i) {
+        int64_t index = begin + i;
+        int64_t offset = 0;
+        for (size_t dim = output_dims.size(); dim-- > 0;) {
+          offset += (index % output_dims[dim]) * input_info.strides[dim];
+          index /= output_dims[dim];
+        }
+        buffer[i] = input[offset];
+      }
+      return buffer;
+  }
+}
+
+void ComputeStep(OpType op_type, const float* a, const float* b, float* y, int64_t count) {
+  ConstEigenVectorArrayMap<float> xa(a, count);
+  EigenVectorArrayMap<float> ym(y, count);
+  switch (op_type) {
+    case OpType::Add:
+      ym = xa + ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case OpType::Sub:
+      ym = xa - ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case OpType::Mul:
+      ym = xa * ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case OpType::Div:
+      ym = xa / ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case OpType::Sqrt:
+      ym = xa.sqrt();
+      break;
+    case OpType::Erf:
+      MlasComputeErf(a, y, static_cast<size_t>(count));
+      break;
+    case OpType::Tanh:
+      MlasComputeTanh(a, y, static_cast<size_t>(count));
+      break;
+    case OpType::Sigmoid:
+      MlasComputeLogistic(a, y, static_cast<size_t>(count));
+      break;
+    case OpType::Relu:
+      ym = xa.cwiseMax(0.0f);
+      break;
+    case OpType::Exp:
+      MlasComputeExp(a, y, static_cast<size_t>(count));
+      break;
+    case OpType::Neg:
+      ym = -xa;
+      break;
+    case OpType::Abs:
+      ym = xa.abs();
+      break;
+    case OpType::Reciprocal:
+      ym = xa.inverse();
+      break;
+  }
+}
+
+}  // namespace
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  ORT_THROW_IF_ERROR(ParseProgram(info, steps_));
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const int input_count = context->InputCount();
+  std::vector<const float*> input_data;
+  std::vector<const TensorShape*> input_shapes;
+  for (int i = 0; i < input_count; ++i) {
+    const Tensor* input = context->Input<Tensor>(i);
+    input_data.push_back(input->Data<float>());
+    input_shapes.push_back(&input->Shape());
+  }
+
+  std::vector<int64_t> output_dims;
+  std::vector<InputInfo> input_infos;
+  ORT_RETURN_IF_ERROR(PrepareBroadcast(input_shapes, output_dims, input_infos));
+
+  Tensor* output = context->Output(0, TensorShape(output_dims));
+  const int64_t output_size = output->Shape().Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+  float* output_data = output->MutableData<float>();
+
+  const size_t value_count = input_count + steps_.size();
+  const std::ptrdiff_t tile_count = static_cast<std::ptrdiff_t>((output_size + kTileSize - 1) / kTileSize);
+  const TensorOpCost cost{static_cast<double>(input_count * kTileSize * sizeof(float)),
+                          static_cast<double>(kTileSize * sizeof(float)),
+                          static_cast<double>(steps_.size() * kTileSize)};
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), tile_count, cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // a tile for each input and each step, in the order of the operands
+        std::vector<float> buffers(value_count * kTileSize);
+        std::vector<const float*> values(value_count);
+
+        for (std::ptrdiff_t tile = first; tile < last; ++tile) {
+          const int64_t begin = tile * kTileSize;
+          const int64_t count = std::min(kTileSize, output_size - begin);
+
+          for (int i = 0; i < input_count; ++i) {
+            values[i] = LoadInput(input_data[i], input_infos[i], output_dims, begin, count, tile == first,
+                                  &buffers[i * kTileSize]);
+          }
+
+          for (size_t i = 0; i < steps_.size(); ++i) {
+            const Step& step = steps_[i];
+            // the last step writes the output
+            float* result = i + 1 == steps_.size() ? output_data + begin : &buffers[(input_count + i) * kTileSize];
+            ComputeStep(step.op_type, values[step.operands[0]],
+                        IsBinary(step.op_type) ? values[step.operands[1]] : nullptr, result, count);
+            values[input_count + i] = result;
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/fused_elementwise_program.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace fused_elementwise {
+
+// Parses the ops and operands attributes of a FusedElementwise node.
+Status ParseProgram(const OpKernelInfo& info, std::vector<Step>& steps);
+
+struct InputInfo {
+  InputKind kind;
+  int64_t size;
+  // strides of the input over the output dims, 0 on the broadcast dims. only set for Broadcast.
+  std::vector<int64_t> strides;
+};
+
+// Computes the broadcast shape of the inputs and how each input is read.
+Status PrepareBroadcast(const std::vector<const TensorShape*>& input_shapes,
+                        std::vector<int64_t>& output_dims,
+                        std::vector<InputInfo>& input_infos);
+
+}  // namespace fused_elementwise
+
+// Runs a chain of elementwise ops in a single pass over memory. The output is computed in tiles, each step of the
+// program reading the tiles of its operands and writing its own tile, so the intermediate results stay in cache.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  std::vector<fused_elementwise::Step> steps_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+// The program of a FusedElementwise node, shared by the CPU and CUDA kernels.
+
+namespace onnxruntime {
+namespace contrib {
+namespace fused_elementwise {
+
+// Maximum number of inputs and steps of a program, which bound the arguments of the CUDA kernel.
+constexpr int kMaxInputs = 16;
+constexpr int kMaxSteps = 32;
+
+// The binary ops are listed first.
+enum class OpType : int32_t {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Sqrt,
+  Erf,
+  Tanh,
+  Sigmoid,
+  Relu,
+  Exp,
+  Neg,
+  Abs,
+  Reciprocal,
+};
+
+inline bool IsBinary(OpType op_type) {
+  return op_type <= OpType::Div;
+}
+
+// A step of the program. The operands index the inputs of the node, followed by the results of the previous steps.
+struct Step {
+  OpType op_type;
+  int32_t operands[2];
+};
+
+// How an input is read at an index of the output.
+enum class InputKind : int32_t {
+  Full,       // input[i], the input has the shape of the output
+  Scalar,     // input[0]
+  Suffix,     // input[i % size], the input has the trailing dims of the output, e.g. a bias
+  Broadcast,  // other broadcasts, the offset is computed from the output dims and the strides
+};
+
+}  // namespace fused_elementwise
+}  // namespace contrib
+}  // namespace onnxruntime
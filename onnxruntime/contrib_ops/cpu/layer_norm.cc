@@ -5,6 +5,7 @@
 
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -20,12 +21,45 @@ namespace contrib {
       T,                                                          \
       kCpuExecutionProvider,                                      \
       KernelDefBuilder()                                          \
+          .MayInplace(0, 0)                                       \
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
       LayerNorm<T>);
 
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 
+namespace {
+
+template <typename T>
+void ComputeLayerNormRow(const T* p_input, const T* scale_data, const T* bias_data, T* p_output,
+                         T* p_mean, T* p_inv_std_var, int64_t norm_size, float epsilon) {
+  T mean = 0;
+  T mean_square = 0;
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    mean += p_input[h];
+    mean_square += p_input[h] * p_input[h];
+  }
+
+  mean = mean / norm_size;
+  mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+  }
+
+  *p_mean = mean;
+  *p_inv_std_var = 1 / mean_square;
+}
+
+void ComputeLayerNormRow(const float* p_input, const float* scale_data, const float* bias_data, float* p_output,
+                         float* p_mean, float* p_inv_std_var, int64_t norm_size, float epsilon) {
+  MlasComputeLayerNorm(p_input, nullptr, nullptr, scale_data, bias_data, p_output, p_mean, p_inv_std_var,
+                       1, static_cast<size_t>(norm_size), epsilon);
+}
+
+}  // namespace
+
 template <typename T>
 LayerNorm<T>::LayerNorm(const OpKernelInfo& op_kernel_info)
     : OpKernel(op_kernel_info) {
@@ -93,23 +127,9 @@ Status LayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
                                                  const T* p_input = X_data + task_idx * norm_size;
                                                  T* p_output = Y_data + task_idx * norm_size;
 
-                                                 T mean = 0;
-                                                 T mean_square = 0;
-
-                                                 for (int64_t h = 0; h < norm_size; h++) {
-                                                   mean += p_input[h];
-                                                   mean_square += p_input[h] * p_input[h];
-                                                 }
-
-                                                 mean = mean / norm_size;
-                                                 mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon_);
-
-                                                 for (int64_t h = 0; h < norm_size; h++) {
-                                                   p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
-                                                 }
-
-                                                 mean_data[task_idx] = mean;
-                                                 inv_std_var_data[task_idx] = 1 / mean_square;
+                                                 ComputeLayerNormRow(p_input, scale_data, bias_data, p_output,
+                                                                     mean_data + task_idx, inv_std_var_data + task_idx,
+                                                                     norm_size, epsilon_);
                                                }, 0);
 
   return Status::OK();
@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "nchwc_ops.h"
+
+#include <algorithm>
+
 #include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -40,6 +44,7 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
     1,
     float,
     KernelDefBuilder()
+        .MayInplace(1, 0)
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcMaxPool);
 
@@ -48,6 +53,7 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
     1,
     float,
     KernelDefBuilder()
+        .MayInplace(1, 0)
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcMaxPool);
 
@@ -56,6 +62,7 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
     1,
     float,
     KernelDefBuilder()
+        .MayInplace(1, 0)
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcAveragePool);
 
@@ -64,6 +71,7 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
     1,
     float,
     KernelDefBuilder()
+        .MayInplace(1, 0)
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcAveragePool);
 
@@ -72,6 +80,7 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
     1,
     float,
     KernelDefBuilder()
+        .MayInplace(1, 0)
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcUpsample);
 
@@ -185,6 +194,46 @@ Status NchwcConv::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+// Computes the output of a NCHWc op with the optional Sum input and fused activation in a single pass: each channel
+// block of each batch is computed into a buffer by compute_block, then added to the Sum and activated as it is stored
+// to the output. The output may be allocated inplace with the Sum, as each element of the Sum is read before the
+// same element of the output is written.
+template <typename ComputeBlock>
+static void ComputeWithSumAndActivation(const Tensor* Sum, Tensor& Y, const MLAS_ACTIVATION& activation,
+                                        concurrency::ThreadPool* thread_pool, ComputeBlock compute_block) {
+  const auto& Y_shape = Y.Shape();
+  const size_t nchwc_block_size = MlasNchwcGetBlockSize();
+  const std::ptrdiff_t block_count = static_cast<std::ptrdiff_t>(Y_shape[0] * (Y_shape[1] / nchwc_block_size));
+  const size_t output_block_size = static_cast<size_t>(Y_shape.SizeFromDimension(2)) * nchwc_block_size;
+
+  const float* sum_data = Sum != nullptr ? Sum->template Data<float>() : nullptr;
+  float* y_data = Y.template MutableData<float>();
+
+  const TensorOpCost cost{static_cast<double>(output_block_size * sizeof(float)),
+                          static_cast<double>(output_block_size * sizeof(float)),
+                          static_cast<double>(output_block_size) * 4};
+
+  auto compute_blocks = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<float> buffer(output_block_size);
+    for (std::ptrdiff_t block = first; block < last; block++) {
+      compute_block(static_cast<size_t>(block), buffer.data());
+
+      float* y = y_data + block * output_block_size;
+      if (sum_data != nullptr) {
+        const float* sum = sum_data + block * output_block_size;
+        for (size_t i = 0; i < output_block_size; i++) {
+          y[i] = buffer[i] + sum[i];
+        }
+      } else {
+        std::copy_n(buffer.data(), output_block_size, y);
+      }
+      MlasActivation(&activation, y, nullptr, 1, output_block_size, output_block_size);
+    }
+  };
+
+  concurrency::ThreadPool::TryParallelFor(thread_pool, block_count, cost, compute_blocks);
+}
+
 Status NchwcPoolBase::NchwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const {
   const auto* X = context->Input<Tensor>(0);
   const auto& X_shape = X->Shape();
@@ -195,6 +244,33 @@ Status NchwcPoolBase::NchwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind
   std::vector<int64_t> output_dims = pool_attrs_.SetOutputSize(X_shape, X_shape[1], &pads);
   auto* Y = context->Output(0, output_dims);
 
+  // Check for the optional Pool/Sum and Pool/activation fusions.
+  const auto* Sum = context->Input<Tensor>(1);
+  if (Sum != nullptr || activation_.ActivationKind != MlasIdentityActivation) {
+    ORT_RETURN_IF_NOT(Sum == nullptr || Y->Shape() == Sum->Shape(), "output and sum shape must match");
+
+    const int64_t nchwc_block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+    const int64_t block_input_shape[] = {1, nchwc_block_size, X_shape[2], X_shape[3]};
+    const int64_t block_output_shape[] = {1, nchwc_block_size, output_dims[2], output_dims[3]};
+    const size_t input_block_size = static_cast<size_t>(X_shape.SizeFromDimension(2) * nchwc_block_size);
+    const float* x_data = X->template Data<float>();
+
+    ComputeWithSumAndActivation(Sum, *Y, activation_, context->GetOperatorThreadPool(),
+                                [&](size_t block, float* buffer) {
+                                  MlasNchwcPool(kind,
+                                                block_input_shape,
+                                                pool_attrs_.global_pooling ? nullptr : pool_attrs_.kernel_shape.data(),
+                                                pool_attrs_.global_pooling ? nullptr : pool_attrs_.dilations.data(),
+                                                pool_attrs_.global_pooling ? nullptr : pads.data(),
+                                                pool_attrs_.global_pooling ? nullptr : pool_attrs_.strides.data(),
+                                                block_output_shape,
+                                                x_data + block * input_block_size,
+                                                buffer,
+                                                nullptr);
+                                });
+    return Status::OK();
+  }
+
   MlasNchwcPool(kind,
                 X_shape.GetDims().data(),
                 pool_attrs_.global_pooling ? nullptr : pool_attrs_.kernel_shape.data(),
@@ -227,6 +303,26 @@ Status NchwcUpsample::Compute(OpKernelContext* context) const {
   TensorShape Y_shape{X_shape[0], X_shape[1], X_shape[2] * scales_[2], X_shape[3] * scales_[3]};
   auto* Y = context->Output(0, Y_shape);
 
+  // Check for the optional Upsample/Sum and Upsample/activation fusions.
+  const auto* Sum = context->Input<Tensor>(1);
+  if (Sum != nullptr || activation_.ActivationKind != MlasIdentityActivation) {
+    ORT_RETURN_IF_NOT(Sum == nullptr || Y->Shape() == Sum->Shape(), "output and sum shape must match");
+
+    const int64_t nchwc_block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+    const int64_t block_input_shape[] = {1, nchwc_block_size, X_shape[2], X_shape[3]};
+    const size_t input_block_size = static_cast<size_t>(X_shape.SizeFromDimension(2) * nchwc_block_size);
+    const float* x_data = X->template Data<float>();
+
+    ComputeWithSumAndActivation(Sum, *Y, activation_, context->GetOperatorThreadPool(),
+                                [&](size_t block, float* buffer) {
+                                  MlasNchwcUpsample(block_input_shape,
+                                                    scales_.data() + 2,
+                                                    x_data + block * input_block_size,
+                                                    buffer);
+                                });
+    return Status::OK();
+  }
+
   MlasNchwcUpsample(X_shape.GetDims().data(),
                     scales_.data() + 2,
                     X->template Data<float>(),
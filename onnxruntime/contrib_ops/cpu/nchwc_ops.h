@@ -55,9 +55,13 @@ class NchwcPoolBase : public PoolBase {
     if (!pool_attrs_.global_pooling) {
       ORT_ENFORCE(pool_attrs_.kernel_shape.size() == 2, "kernel_shape num_dims is not compatible with X num_dims.");
     }
+    ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
   }
 
   Status NchwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const;
+
+ private:
+  MLAS_ACTIVATION activation_;
 };
 
 class NchwcMaxPool : public OpKernel, public NchwcPoolBase {
@@ -83,12 +87,15 @@ class NchwcUpsample : public OpKernel {
     ORT_ENFORCE(scales_.size() == 4);
     // Batch and channel dimensions cannot scale and spatial scaling must be positive.
     ORT_ENFORCE(scales_[0] == 1 && scales_[1] == 1 && scales_[2] >= 1 && scales_[3] >= 1);
+    ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
   std::vector<int64_t> scales_;
+
+  MLAS_ACTIVATION activation_;
 };
 
 }  // namespace contrib
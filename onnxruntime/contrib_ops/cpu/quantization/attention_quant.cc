@@ -48,6 +48,7 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
 
 template <typename T>
 QAttention<T>::QAttention(const OpKernelInfo& info) : OpKernel(info), AttentionCPUBase(info) {
+  use_quantized_gemm_ = info.GetAttrOrDefault<int64_t>("quantized_attention", 0) != 0;
   TryPackWeights(info);
 }
 
@@ -4,6 +4,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/common/safeint.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/math/gemm_packing_helper.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/qmath.h"
@@ -17,11 +18,10 @@ namespace contrib {
 class MatMulIntegerToFloatBase : public OpKernel {
  public:
   MatMulIntegerToFloatBase(const OpKernelInfo& info) : OpKernel(info) {
-    TryPackWeights(info);
+    TryPackQGemmWeights(info, 1, packed_b_);
   }
 
  protected:
-  void TryPackWeights(const OpKernelInfo& info);
   Status ComputeCommon(OpKernelContext* ctx,
                        const uint8_t* a_data,
                        const TensorShape& a_shape,
@@ -31,46 +31,10 @@ class MatMulIntegerToFloatBase : public OpKernel {
                        float multiplier,
                        const Tensor* bias_tensor) const;
 
-#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
-  BufferUniquePtr packed_b_;
-#endif
+  // constant B packed for the quantized GEMM, if supported by the platform
+  std::shared_ptr<void> packed_b_;
 };
 
-void MatMulIntegerToFloatBase::TryPackWeights(const OpKernelInfo& info) {
-#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
-  // Check if the weights tensor is constant.
-  const Tensor* b;
-  if (!info.TryGetConstantInput(1, &b)) {
-    return;
-  }
-
-  // Only handle the common case of a 2D weight matrix. Additional matrices
-  // could be handled by stacking the packed buffers.
-  const auto& b_shape = b->Shape();
-  if (b_shape.NumDimensions() != 2) {
-    return;
-  }
-
-  const size_t K = static_cast<size_t>(b_shape[0]);
-  const size_t N = static_cast<size_t>(b_shape[1]);
-
-  const auto* b_data = static_cast<const uint8_t*>(b->DataRaw());
-  const bool b_is_signed = b->IsDataType<int8_t>();
-
-  const size_t packed_b_size = MlasGemmPackBSize(N, K, b_is_signed);
-  if (packed_b_size == 0) {
-    return;
-  }
-
-  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
-  auto* packed_b_data = alloc->Alloc(packed_b_size);
-  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
-  MlasGemmPackB(N, K, b_data, N, b_is_signed, packed_b_data);
-#else
-  ORT_UNUSED_PARAMETER(info);
-#endif
-}
-
 Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
                                                const uint8_t* a_data,
                                                const TensorShape& a_shape,
@@ -144,24 +108,6 @@ class MatMulIntegerToFloat final : public MatMulIntegerToFloatBase {
   Status Compute(OpKernelContext* context) const override;
 };
 
-static void GetQuantizationParameter(const float* data, int64_t num_of_elements, float& scale, uint8_t& zp) {
-  // find input range min and max
-  float min, max;
-  MlasFindMinMaxElement(data, &min, &max, num_of_elements);
-
-  // ensure the input range includes zero
-  min = std::min(min, 0.0f);
-  max = std::max(max, 0.0f);
-
-  // find scale and zero point
-  uint8_t qmin = 0;
-  uint8_t qmax = 255;
-  scale = max == min ? 1.0f : (max - min) / (qmax - qmin);
-
-  float initial_zero_point = qmin - min / scale;
-  zp = static_cast<uint8_t>(RoundHalfToEven(std::max(float(qmin), std::min(float(qmax), initial_zero_point))));
-}
-
 Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
   const auto* a = ctx->Input<Tensor>(0);
   const auto* b = ctx->Input<Tensor>(1);
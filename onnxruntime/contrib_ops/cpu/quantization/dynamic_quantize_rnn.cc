@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/rnn/deep_cpu_gru.h"
+#include "core/providers/cpu/rnn/deep_cpu_lstm.h"
+#include "core/util/qmath.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using rnn::detail::GemmWeights;
+
+// Reads the scale and zero point of each direction of the quantized weights, which are either scalars or
+// 1D tensors with an element per direction.
+static Status GetWeightQuantizationParameters(const Tensor* scale_tensor, const Tensor* zero_point_tensor,
+                                              int num_directions, const char* weights_name,
+                                              float (&scale)[2], uint8_t (&zero_point)[2]) {
+  const int64_t scale_size = scale_tensor->Shape().Size();
+  ORT_RETURN_IF_NOT(scale_tensor->Shape().NumDimensions() <= 1 && (scale_size == 1 || scale_size == num_directions),
+                    "The scale of ", weights_name, " must be a scalar or a 1D tensor of size num_directions. ",
+                    "Per-channel quantization is not supported.");
+  const float* scale_data = scale_tensor->Data<float>();
+
+  const uint8_t* zero_point_data = nullptr;
+  int64_t zero_point_size = 0;
+  if (zero_point_tensor != nullptr) {
+    zero_point_size = zero_point_tensor->Shape().Size();
+    ORT_RETURN_IF_NOT(zero_point_tensor->Shape().NumDimensions() <= 1 &&
+                          (zero_point_size == 1 || zero_point_size == num_directions),
+                      "The zero point of ", weights_name, " must be a scalar or a 1D tensor of size num_directions.");
+    zero_point_data = static_cast<const uint8_t*>(zero_point_tensor->DataRaw());
+  }
+
+  for (int i = 0; i < num_directions; ++i) {
+    scale[i] = scale_data[scale_size == 1 ? 0 : i];
+    zero_point[i] = zero_point_data == nullptr ? 0 : zero_point_data[zero_point_size == 1 ? 0 : i];
+  }
+
+  return Status::OK();
+}
+
+// Validates that the quantized weights have the shape [num_directions, K, N].
+static Status ValidateQuantizedWeightsShape(const TensorShape& shape, int64_t num_directions, int64_t K, int64_t N,
+                                            const char* weights_name) {
+  ORT_RETURN_IF_NOT(shape.NumDimensions() == 3 && shape[0] == num_directions && shape[1] == K && shape[2] == N,
+                    "Input ", weights_name, " must have shape {", num_directions, ",", K, ",", N, "}. Actual:", shape);
+  return Status::OK();
+}
+
+/// The LSTM operator with 8-bit quantized weights. The inputs are quantized to uint8 with the range of their values
+/// before each GEMM, as done by DynamicQuantizeMatMul.
+class DynamicQuantizeLSTM final : public OpKernel, public LstmBase {
+ public:
+  DynamicQuantizeLSTM(const OpKernelInfo& info) : OpKernel(info), LstmBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+Status DynamicQuantizeLSTM::Compute(OpKernelContext* context) const {
+  const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
+  const Tensor& W = *context->Input<Tensor>(1);  // weights. [num_directions, input_size, 4*hidden_size]
+  const Tensor& R = *context->Input<Tensor>(2);  // recurrence weights. [num_directions, hidden_size, 4*hidden_size]
+
+  // optional
+  const Tensor* B = context->Input<Tensor>(3);              // bias. [num_directions, 8*hidden_size]
+  const Tensor* sequence_lens = context->Input<Tensor>(4);  // [batch_size]
+  const Tensor* initial_h = context->Input<Tensor>(5);      // initial hidden. [num_directions, batch_size, hidden_size]
+  const Tensor* initial_c = context->Input<Tensor>(6);      // initial cell. [num_directions, batch_size, hidden_size]
+  const Tensor* P = context->Input<Tensor>(7);              // peephole weights. [num_directions, 3*hidden_size]
+
+  ORT_RETURN_IF_NOT(X.Shape().NumDimensions() == 3,
+                    "Input X must have 3 dimensions only. Actual:", X.Shape());
+  const int64_t input_size = X.Shape()[2];
+  const int batch_size = gsl::narrow<int>(X.Shape()[1]);
+
+  ORT_RETURN_IF_ERROR(ValidateQuantizedWeightsShape(W.Shape(), num_directions_, input_size, 4 * hidden_size_, "W"));
+  ORT_RETURN_IF_ERROR(ValidateQuantizedWeightsShape(R.Shape(), num_directions_, hidden_size_, 4 * hidden_size_, "R"));
+
+  // validate the other inputs against the shapes of the equivalent float weights
+  ORT_RETURN_IF_ERROR(ValidateInputs(X,
+                                     TensorShape({num_directions_, 4 * hidden_size_, input_size}),
+                                     TensorShape({num_directions_, 4 * hidden_size_, hidden_size_}),
+                                     B, sequence_lens, initial_h, initial_c, P, batch_size));
+
+  float W_scale[2], R_scale[2];
+  uint8_t W_zero_point[2], R_zero_point[2];
+  ORT_RETURN_IF_ERROR(GetWeightQuantizationParameters(context->Input<Tensor>(8), context->Input<Tensor>(9),
+                                                      num_directions_, "W", W_scale, W_zero_point));
+  ORT_RETURN_IF_ERROR(GetWeightQuantizationParameters(context->Input<Tensor>(10), context->Input<Tensor>(11),
+                                                      num_directions_, "R", R_scale, R_zero_point));
+
+  const auto* W_data = static_cast<const uint8_t*>(W.DataRaw());
+  const auto* R_data = static_cast<const uint8_t*>(R.DataRaw());
+  const bool W_is_signed = W.IsDataType<int8_t>();
+  const bool R_is_signed = R.IsDataType<int8_t>();
+  const int hidden_size_x4 = 4 * hidden_size_;
+
+  GemmWeights<float> W_weights[2];
+  GemmWeights<float> R_weights[2];
+  for (int i = 0; i < num_directions_; ++i) {
+    W_weights[i] = GemmWeights<float>(W_data + i * input_size * hidden_size_x4, hidden_size_x4, W_is_signed,
+                                      W_scale[i], W_zero_point[i]);
+    R_weights[i] = GemmWeights<float>(R_data + i * static_cast<size_t>(hidden_size_) * hidden_size_x4, hidden_size_x4,
+                                      R_is_signed, R_scale[i], R_zero_point[i]);
+  }
+
+  return ComputeImpl<float>(*context, W_weights[0], W_weights[1], R_weights[0], R_weights[1]);
+}
+
+/// The GRU operator with 8-bit quantized weights. The inputs are quantized to uint8 with the range of their values
+/// before each GEMM, as done by DynamicQuantizeMatMul.
+class DynamicQuantizeGRU final : public OpKernel, public GruBase {
+ public:
+  DynamicQuantizeGRU(const OpKernelInfo& info) : OpKernel(info), GruBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+Status DynamicQuantizeGRU::Compute(OpKernelContext* context) const {
+#ifndef MLAS_SUPPORTS_GEMM_U8X8
+  // R[zr] and Rh are multiplied in place as column blocks of R, which the fallback GEMM doesn't support
+  ORT_UNUSED_PARAMETER(context);
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "DynamicQuantizeGRU requires the 8-bit GEMM of MLAS");
+#else
+  const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
+  const Tensor& W = *context->Input<Tensor>(1);  // weights. [num_directions, input_size, 3*hidden_size]
+  const Tensor& R = *context->Input<Tensor>(2);  // recurrence weights. [num_directions, hidden_size, 3*hidden_size]
+
+  // optional
+  const Tensor* B = context->Input<Tensor>(3);              // bias. [num_directions, 6*hidden_size]
+  const Tensor* sequence_lens = context->Input<Tensor>(4);  // [batch_size]
+  const Tensor* initial_h = context->Input<Tensor>(5);      // initial hidden. [num_directions, batch_size, hidden_size]
+
+  ORT_RETURN_IF_NOT(X.Shape().NumDimensions() == 3,
+                    "Input X must have 3 dimensions only. Actual:", X.Shape());
+  const int64_t input_size = X.Shape()[2];
+
+  ORT_RETURN_IF_ERROR(ValidateQuantizedWeightsShape(W.Shape(), num_directions_, input_size, 3 * hidden_size_, "W"));
+  ORT_RETURN_IF_ERROR(ValidateQuantizedWeightsShape(R.Shape(), num_directions_, hidden_size_, 3 * hidden_size_, "R"));
+
+  // validate the other inputs against the shapes of the equivalent float weights
+  ORT_RETURN_IF_ERROR(ValidateInputs(X,
+                                     TensorShape({num_directions_, 3 * hidden_size_, input_size}),
+                                     TensorShape({num_directions_, 3 * hidden_size_, hidden_size_}),
+                                     B, sequence_lens, initial_h));
+
+  float W_scale[2], R_scale[2];
+  uint8_t W_zero_point[2], R_zero_point[2];
+  ORT_RETURN_IF_ERROR(GetWeightQuantizationParameters(context->Input<Tensor>(6), context->Input<Tensor>(7),
+                                                      num_directions_, "W", W_scale, W_zero_point));
+  ORT_RETURN_IF_ERROR(GetWeightQuantizationParameters(context->Input<Tensor>(8), context->Input<Tensor>(9),
+                                                      num_directions_, "R", R_scale, R_zero_point));
+
+  const auto* W_data = static_cast<const uint8_t*>(W.DataRaw());
+  const auto* R_data = static_cast<const uint8_t*>(R.DataRaw());
+  const bool W_is_signed = W.IsDataType<int8_t>();
+  const bool R_is_signed = R.IsDataType<int8_t>();
+  const int hidden_size_x3 = 3 * hidden_size_;
+
+  // R[zr] and Rh are the first 2*hidden_size columns and the last hidden_size columns of R
+  GemmWeights<float> W_weights[2];
+  GemmWeights<float> R_ZR_weights[2];
+  GemmWeights<float> R_H_weights[2];
+  for (int i = 0; i < num_directions_; ++i) {
+    const uint8_t* R_data_i = R_data + i * static_cast<size_t>(hidden_size_) * hidden_size_x3;
+    W_weights[i] = GemmWeights<float>(W_data + i * input_size * hidden_size_x3, hidden_size_x3, W_is_signed,
+                                      W_scale[i], W_zero_point[i]);
+    R_ZR_weights[i] = GemmWeights<float>(R_data_i, hidden_size_x3, R_is_signed, R_scale[i], R_zero_point[i]);
+    R_H_weights[i] = GemmWeights<float>(R_data_i + 2 * hidden_size_, hidden_size_x3, R_is_signed,
+                                        R_scale[i], R_zero_point[i]);
+  }
+
+  return ComputeImpl<float>(*context, W_weights[0], W_weights[1], R_ZR_weights[0], R_ZR_weights[1],
+                            R_H_weights[0], R_H_weights[1]);
+#endif
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DynamicQuantizeLSTM,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()}),
+    DynamicQuantizeLSTM);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DynamicQuantizeGRU,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()}),
+    DynamicQuantizeGRU);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
@@ -24,6 +25,41 @@ namespace contrib {
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 
+namespace {
+
+template <typename T>
+void ComputeSkipLayerNormRow(const T* p_input, const T* p_skip, const T* bias_data, const T* gamma_data,
+                             const T* beta_data, T* p_output, int64_t hidden_size, float epsilon) {
+  T mean = 0;
+  T mean_square = 0;
+
+  for (int64_t h = 0; h < hidden_size; h++) {
+    T value = p_input[h] + p_skip[h];
+    if (nullptr != bias_data) {
+      value += bias_data[h];
+    }
+    p_output[h] = value;
+    mean += value;
+    mean_square += value * value;
+  }
+
+  mean = mean / hidden_size;
+  mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon);
+
+  for (int64_t h = 0; h < hidden_size; h++) {
+    p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+  }
+}
+
+void ComputeSkipLayerNormRow(const float* p_input, const float* p_skip, const float* bias_data,
+                             const float* gamma_data, const float* beta_data, float* p_output,
+                             int64_t hidden_size, float epsilon) {
+  MlasComputeLayerNorm(p_input, p_skip, bias_data, gamma_data, beta_data, p_output, nullptr, nullptr,
+                       1, static_cast<size_t>(hidden_size), epsilon);
+}
+
+}  // namespace
+
 template <typename T>
 SkipLayerNorm<T>::SkipLayerNorm(const OpKernelInfo& op_kernel_info)
     : OpKernel(op_kernel_info) {
@@ -41,10 +77,12 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
   Tensor* output = p_ctx->Output(0, input->Shape());
 
   const auto& input_dims = input->Shape().GetDims();
-  if (input_dims.size() != 3) {
+  // packed input of sequences with different lengths has shape (token_count, hidden_size)
+  if (input_dims.size() != 3 && input_dims.size() != 2) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                           "input is expected to have 3 dimensions, got ", input_dims.size());
+                           "input is expected to have 3 or 2 dimensions, got ", input_dims.size());
   }
+  const int64_t hidden_size = input_dims.back();
 
   if (input->Shape() != skip->Shape()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
@@ -56,7 +94,7 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "gamma is expected to have 1 dimension, got ", gamma_dims.size());
   }
-  if (gamma_dims[0] != input_dims[2]) {
+  if (gamma_dims[0] != hidden_size) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "Last dimension of gamma and input does not match");
   }
@@ -66,7 +104,7 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "beta is expected to have 1 dimension, got ", beta_dims.size());
   }
-  if (beta_dims[0] != input_dims[2]) {
+  if (beta_dims[0] != hidden_size) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "Last dimension of beta and input does not match");
   }
@@ -77,16 +115,13 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "bias is expected to have 1 dimension, got ", bias_dims.size());
     }
-    if (bias_dims[0] != input_dims[2]) {
+    if (bias_dims[0] != hidden_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Last dimension of bias and input does not match");
     }
   }
 
-  int64_t batch_size = input_dims[0];
-  int64_t sequence_length = input_dims[1];
-  int64_t hidden_size = input_dims[2];
-  int64_t task_count = batch_size * sequence_length;
+  int64_t task_count = input->Shape().SizeToDimension(input_dims.size() - 1);
 
   const T* input_data = input->Data<T>();
   const T* skip_data = skip->Data<T>();
@@ -102,25 +137,8 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
                                                  const T* p_skip = skip_data + task_idx * hidden_size;
                                                  T* p_output = output_data + task_idx * hidden_size;
 
-                                                 T mean = 0;
-                                                 T mean_square = 0;
-
-                                                 for (int64_t h = 0; h < hidden_size; h++) {
-                                                   T value = p_input[h] + p_skip[h];
-                                                   if (nullptr != bias_data) {
-                                                     value += bias_data[h];
-                                                   }
-                                                   p_output[h] = value;
-                                                   mean += value;
-                                                   mean_square += value * value;
-                                                 }
-
-                                                 mean = mean / hidden_size;
-                                                 mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
-
-                                                 for (int64_t h = 0; h < hidden_size; h++) {
-                                                   p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
-                                                 }
+                                                 ComputeSkipLayerNormRow(p_input, p_skip, bias_data, gamma_data, beta_data,
+                                                                         p_output, hidden_size, epsilon_);
                                                }, 0);
 
   return Status::OK();
@@ -171,7 +171,7 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
       assert(result);
       (void)result;
       assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
+      (output_data + output_index)->assign(s, token_idx, tlen);
       ++output_index;
       token_idx += tlen;
       ++tokens;
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "attention.h"
+
+#include <algorithm>
+
 #include "core/framework/tensorprotoutils.h"
 #include "core/providers/cuda/cuda_common.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
@@ -23,6 +26,7 @@ namespace cuda {
       T,                                                          \
       kCudaExecutionProvider,                                     \
       KernelDefBuilder()                                          \
+          .InputMemoryType<OrtMemTypeCPUInput>(5)                 \
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
       Attention<T>);
 
@@ -39,21 +43,32 @@ Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
   const Tensor* bias = context->Input<Tensor>(2);
   const Tensor* mask_index = context->Input<Tensor>(3);
   const Tensor* past = context->Input<Tensor>(4);
-  ORT_RETURN_IF_ERROR(CheckInputs(input, weights, bias, mask_index, past));
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(5);
+  if (past_present_share_buffer_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "past_present_share_buffer is only supported on CPU");
+  }
+  ORT_RETURN_IF_ERROR(CheckInputs(input, weights, bias, mask_index, past, cumulative_sequence_length));
 
   // Input and output shapes:
   //   Input 0 - input       : (batch_size, sequence_length, hidden_size)
   //   Output 0 - output     : (batch_size, sequence_length, hidden_size)
+  // The packed input and output have shape (token_count, hidden_size). As the gemm below handles all the tokens at
+  // once, packed input is processed like a batch of one sequence of token_count tokens up to the attention.
   const auto& shape = input->Shape();
-  int batch_size = static_cast<int>(shape[0]);
-  int sequence_length = static_cast<int>(shape[1]);
-  int hidden_size = static_cast<int>(shape[2]);
+  const bool is_packed = cumulative_sequence_length != nullptr;
+  int batch_size = is_packed ? 1 : static_cast<int>(shape[0]);
+  int sequence_length = is_packed ? static_cast<int>(shape[0]) : static_cast<int>(shape[1]);
+  int hidden_size = static_cast<int>(shape[shape.NumDimensions() - 1]);
   int head_size = hidden_size / num_heads_;
 
   Tensor* output = context->Output(0, shape);
+  if (is_packed && sequence_length == 0) {
+    return Status::OK();
+  }
 
   int past_sequence_length = 0;
-  Tensor* present = GetPresent(context, past, batch_size, head_size, sequence_length, past_sequence_length);
+  Tensor* present = is_packed ? nullptr
+                              : GetPresent(context, past, batch_size, head_size, sequence_length, past_sequence_length);
 
   cublasHandle_t cublas = CublasHandle();
   constexpr size_t element_size = sizeof(T);
@@ -84,6 +99,35 @@ Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
       reinterpret_cast<const CudaT*>(input->template Data<T>()), k,
       &one, reinterpret_cast<CudaT*>(gemm_buffer.get()), n, device_prop));
 
+  if (is_packed) {
+    const int packed_batch_size = static_cast<int>(cumulative_sequence_length->Shape()[0]) - 1;
+    const int* offsets = cumulative_sequence_length->template Data<int>();
+    // the workspace is reused by the sequences, as the kernels of the default stream run one after another
+    size_t workSpaceSize = 0;
+    for (int b = 0; b < packed_batch_size; ++b) {
+      workSpaceSize = std::max(workSpaceSize, GetAttentionWorkspaceSize(element_size, 1, num_heads_, head_size,
+                                                                        offsets[b + 1] - offsets[b], 0));
+    }
+
+    auto temp_buffer = GetScratchBuffer<void>(workSpaceSize);
+    if (!LaunchPackedAttentionKernel(
+            reinterpret_cast<const CudaT*>(gemm_buffer.get()),
+            offsets,
+            packed_batch_size,
+            output->template MutableData<T>(),
+            num_heads_,
+            head_size,
+            temp_buffer.get(),
+            cublas,
+            element_size)) {
+      // Get last error to reset it to cudaSuccess.
+      CUDA_CALL(cudaGetLastError());
+      return Status(common::ONNXRUNTIME, common::FAIL);
+    }
+
+    return Status::OK();
+  }
+
   size_t workSpaceSize = GetAttentionWorkspaceSize(element_size, batch_size, num_heads_, head_size, sequence_length, past_sequence_length);
   auto temp_buffer = GetScratchBuffer<void>(workSpaceSize);
   if (!LaunchAttentionKernel(
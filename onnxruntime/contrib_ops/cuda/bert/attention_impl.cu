@@ -49,6 +49,19 @@ size_t ScratchSize(size_t element_size, int batch_size, int num_heads, int seque
   return bytesAligned;
 }
 
+// Keys processed per iteration of the memory efficient attention kernel. Each lane of a warp scores one key.
+constexpr int kAttentionKeyTileSize = 32;
+
+// Query rows processed per thread block of the memory efficient attention kernel, one per warp.
+constexpr int kAttentionQueryRowsPerBlock = 4;
+
+// Longest total sequence length that materializes the BxNxSxS* attention probabilities.
+constexpr int kMemoryEfficientAttentionThreshold = 1024;
+
+bool UseMemoryEfficientAttention(int head_size, int all_sequence_length) {
+  return all_sequence_length > kMemoryEfficientAttentionThreshold && head_size <= 4 * GPU_WARP_SIZE;
+}
+
 size_t GetAttentionWorkspaceSize(
     size_t element_size,
     int batch_size,
@@ -57,6 +70,9 @@ size_t GetAttentionWorkspaceSize(
     int sequence_length,
     int past_sequence_length) {
   size_t qkv_size = 3 * batch_size * sequence_length * num_heads * head_size * element_size;
+  if (UseMemoryEfficientAttention(head_size, past_sequence_length + sequence_length)) {
+    return qkv_size;
+  }
   return qkv_size + 2 * ScratchSize(element_size, batch_size, num_heads, sequence_length, past_sequence_length + sequence_length);
 }
 
@@ -633,6 +649,214 @@ cublasStatus_t inline CublasGemmStridedBatched(
       handle, transa, transb, m, n, k, &alpha, A, lda, strideA, B, ldb, strideB, &beta, C, ldc, strideC, batchCount);
 }
 
+// Computes softmax(Q*K'/sqrt(H) + mask)*V without materializing the attention probabilities. The keys are visited in
+// tiles staged in shared memory, and each query row keeps a running max and sum of its scores (online softmax) to
+// rescale its partial output whenever a larger score is found.
+// Q: BxNxSxH, K and V: BxNxS*xH, output: BxSxNxH.
+template <typename T, int kElementsPerLane>
+__global__ void MemoryEfficientAttentionKernel(const int sequence_length,
+                                               const int all_sequence_length,
+                                               const int head_size,
+                                               const T* q,
+                                               const T* k,
+                                               const T* v,
+                                               const int* mask_end,        // 1D mask index: end position of each sequence
+                                               const int* mask_start,      // 1D mask index: start position of each sequence
+                                               const int* attention_mask,  // 2D attention mask
+                                               const bool is_unidirectional,
+                                               const float scale,
+                                               T* output) {
+  constexpr int kMaxHeadSize = kElementsPerLane * GPU_WARP_SIZE;
+
+  // k_tile is padded so that the lanes scoring different keys access different banks.
+  __shared__ float k_tile[kAttentionKeyTileSize][kMaxHeadSize + 1];
+  __shared__ float v_tile[kAttentionKeyTileSize][kMaxHeadSize];
+  __shared__ float q_rows[kAttentionQueryRowsPerBlock][kMaxHeadSize];
+  __shared__ int block_key_end;
+
+  const int lane = threadIdx.x;
+  const int row = threadIdx.y;
+  const int num_heads = gridDim.y;
+  const int head = blockIdx.y;
+  const int batch = blockIdx.z;
+  const int s = blockIdx.x * kAttentionQueryRowsPerBlock + row;
+  const bool is_valid_row = s < sequence_length;
+
+  const int batch_head = batch * num_heads + head;
+  const T* k_head = k + batch_head * all_sequence_length * head_size;
+  const T* v_head = v + batch_head * all_sequence_length * head_size;
+
+  // Find the range of keys attended by the query row, following the same rules as the masked softmax kernels.
+  const int from_index = all_sequence_length - sequence_length + s;
+  int key_start = 0;
+  int key_end = all_sequence_length;
+  if (attention_mask == nullptr) {
+    if (mask_end != nullptr) {
+      key_start = mask_start != nullptr ? max(0, mask_start[batch]) : 0;
+      key_end = min(all_sequence_length, mask_end[batch]);
+
+      // Attend to no word has same effect as attend to all words. This is added to get parity with CPU result.
+      if (key_start >= key_end) {
+        key_start = 0;
+        key_end = all_sequence_length;
+      }
+    }
+
+    if (is_unidirectional) {
+      const int end_unid = from_index + 1;
+      if (end_unid <= key_start) {
+        key_start = 0;
+        key_end = end_unid;
+      } else {
+        key_end = min(key_end, end_unid);
+      }
+    }
+  }
+
+  if (lane == 0 && row == 0) {
+    block_key_end = 0;
+  }
+  __syncthreads();
+
+  if (is_valid_row) {
+    if (lane == 0) {
+      atomicMax(&block_key_end, key_end);
+    }
+
+    const T* q_row = q + (batch_head * sequence_length + s) * head_size;
+    for (int d = lane; d < head_size; d += GPU_WARP_SIZE) {
+      q_rows[row][d] = float(q_row[d]);
+    }
+  }
+
+  float row_max = -CUDART_INF_F;
+  float row_sum = 0.f;
+  float accumulator[kElementsPerLane];
+#pragma unroll
+  for (int e = 0; e < kElementsPerLane; e++) {
+    accumulator[e] = 0.f;
+  }
+
+  const int thread_index = row * GPU_WARP_SIZE + lane;
+  const int thread_count = kAttentionQueryRowsPerBlock * GPU_WARP_SIZE;
+
+  for (int tile_start = 0; tile_start < all_sequence_length; tile_start += kAttentionKeyTileSize) {
+    __syncthreads();
+    if (tile_start >= block_key_end) {
+      break;
+    }
+
+    for (int i = thread_index; i < kAttentionKeyTileSize * head_size; i += thread_count) {
+      const int j = i / head_size;
+      const int d = i - j * head_size;
+      const int key = tile_start + j;
+      const bool is_valid_key = key < all_sequence_length;
+      k_tile[j][d] = is_valid_key ? float(k_head[key * head_size + d]) : 0.f;
+      v_tile[j][d] = is_valid_key ? float(v_head[key * head_size + d]) : 0.f;
+    }
+    __syncthreads();
+
+    if (is_valid_row) {
+      const int key = tile_start + lane;
+      float score = -CUDART_INF_F;
+      if (key >= key_start && key < key_end) {
+        float dot = 0.f;
+        for (int d = 0; d < head_size; d++) {
+          dot += q_rows[row][d] * k_tile[lane][d];
+        }
+        score = dot * scale;
+
+        if (attention_mask != nullptr) {
+          score += attention_mask[batch * all_sequence_length + key] > 0 ? 0.0f : -10000.0f;
+          if (is_unidirectional && key > from_index) {
+            score += -10000.0f;
+          }
+        }
+      }
+
+      float tile_max = score;
+#pragma unroll
+      for (int offset = GPU_WARP_SIZE / 2; offset > 0; offset /= 2) {
+        tile_max = fmaxf(tile_max, WARP_SHFL_XOR(tile_max, offset));
+      }
+
+      // Skip the tiles before the first attended key.
+      const float new_max = fmaxf(row_max, tile_max);
+      if (new_max != -CUDART_INF_F) {
+        const float probability = (score == -CUDART_INF_F) ? 0.f : expf(score - new_max);
+        const float correction = expf(row_max - new_max);
+
+        float tile_sum = probability;
+#pragma unroll
+        for (int offset = GPU_WARP_SIZE / 2; offset > 0; offset /= 2) {
+          tile_sum += WARP_SHFL_XOR(tile_sum, offset);
+        }
+        row_sum = row_sum * correction + tile_sum;
+
+#pragma unroll
+        for (int e = 0; e < kElementsPerLane; e++) {
+          accumulator[e] *= correction;
+        }
+
+        for (int j = 0; j < kAttentionKeyTileSize; j++) {
+          const float p = WARP_SHFL(probability, j);
+          if (p != 0.f) {
+#pragma unroll
+            for (int e = 0; e < kElementsPerLane; e++) {
+              const int d = lane + e * GPU_WARP_SIZE;
+              if (d < head_size) {
+                accumulator[e] += p * v_tile[j][d];
+              }
+            }
+          }
+        }
+
+        row_max = new_max;
+      }
+    }
+  }
+
+  if (is_valid_row) {
+    const float sum_reverse = 1.f / row_sum;
+    T* output_row = output + ((batch * sequence_length + s) * num_heads + head) * head_size;
+#pragma unroll
+    for (int e = 0; e < kElementsPerLane; e++) {
+      const int d = lane + e * GPU_WARP_SIZE;
+      if (d < head_size) {
+        output_row[d] = T(accumulator[e] * sum_reverse);
+      }
+    }
+  }
+}
+
+template <typename T>
+bool LaunchMemoryEfficientAttention(cudaStream_t stream,
+                                    const int batch_size, const int sequence_length, const int all_sequence_length,
+                                    const int num_heads, const int head_size,
+                                    const T* q, const T* k, const T* v,
+                                    const int* mask_end, const int* mask_start, const int* attention_mask,
+                                    const bool is_unidirectional, T* output) {
+  const dim3 grid(CeilDiv(sequence_length, kAttentionQueryRowsPerBlock), num_heads, batch_size);
+  const dim3 block(GPU_WARP_SIZE, kAttentionQueryRowsPerBlock, 1);
+  const float scale = 1.f / sqrt(static_cast<float>(head_size));
+
+  if (head_size <= GPU_WARP_SIZE) {
+    MemoryEfficientAttentionKernel<T, 1><<<grid, block, 0, stream>>>(
+        sequence_length, all_sequence_length, head_size, q, k, v, mask_end, mask_start, attention_mask,
+        is_unidirectional, scale, output);
+  } else if (head_size <= 2 * GPU_WARP_SIZE) {
+    MemoryEfficientAttentionKernel<T, 2><<<grid, block, 0, stream>>>(
+        sequence_length, all_sequence_length, head_size, q, k, v, mask_end, mask_start, attention_mask,
+        is_unidirectional, scale, output);
+  } else {
+    MemoryEfficientAttentionKernel<T, 4><<<grid, block, 0, stream>>>(
+        sequence_length, all_sequence_length, head_size, q, k, v, mask_end, mask_start, attention_mask,
+        is_unidirectional, scale, output);
+  }
+
+  return CUDA_CALL(cudaPeekAtLastError());
+}
+
 template <typename T>
 bool QkvToContext(
     cublasHandle_t& cublas, cudaStream_t stream,
@@ -641,7 +865,10 @@ bool QkvToContext(
     const int* mask_index, const std::vector<int64_t>* mask_index_dims,
     bool is_unidirectional, int past_sequence_length, const T* past, T* present) {
   const int all_sequence_length = past_sequence_length + sequence_length;
-  const size_t bytes = ScratchSize(element_size, batch_size, num_heads, sequence_length, all_sequence_length);
+  const bool use_memory_efficient_attention = UseMemoryEfficientAttention(head_size, all_sequence_length);
+  const size_t bytes = use_memory_efficient_attention
+                           ? 0
+                           : ScratchSize(element_size, batch_size, num_heads, sequence_length, all_sequence_length);
   T* scratch1 = workspace;
   T* scratch2 = scratch1 + (bytes / element_size);
   T* scratch3 = scratch2 + (bytes / element_size);
@@ -679,6 +906,20 @@ bool QkvToContext(
 
   bool use_2d_attention_mask = (nullptr != mask_index && nullptr != mask_index_dims && mask_index_dims->size() == 2);
 
+  // for long sequences, compute the attention without the BxNxSxS* scratch buffers and write output BxSxNxH directly
+  if (use_memory_efficient_attention) {
+    const int* mask_start = nullptr;
+    if (nullptr != mask_index && !use_2d_attention_mask) {
+      ORT_ENFORCE(nullptr != mask_index_dims && mask_index_dims->size() == 1);
+      mask_start = (mask_index_dims->at(0) > batch_size) ? mask_index + batch_size : nullptr;
+    }
+    return LaunchMemoryEfficientAttention<T>(stream, batch_size, sequence_length, all_sequence_length, num_heads, head_size,
+                                             q, k, v,
+                                             use_2d_attention_mask ? nullptr : mask_index, mask_start,
+                                             use_2d_attention_mask ? mask_index : nullptr,
+                                             is_unidirectional, output);
+  }
+
   // compute Q*K' (as K'*Q), scaled by 1/sqrt(H) and store in scratch1: BxNxSxS*
   // Q: BxNxSxH, K (present_k): BxNxS*xH, Q*K': BxNxSxS*
   const float rsqrt_head_size = 1.f / sqrt(static_cast<float>(head_size));
@@ -753,6 +994,56 @@ bool LaunchAttentionKernel(
   }
 }
 
+template <typename T>
+bool PackedQkvToContext(
+    cublasHandle_t& cublas, cudaStream_t stream,
+    const int* cumulative_sequence_length, const int batch_size, const int num_heads, const int head_size,
+    const size_t element_size, const T* input, T* output, T* workspace) {
+  // The packed input is Tx3xNxH with the tokens of sequence b in rows [offsets[b], offsets[b + 1]), so each
+  // sequence is a batch of one with its own sequence length and only the real tokens are computed.
+  const int hidden_size = num_heads * head_size;
+  for (int b = 0; b < batch_size; ++b) {
+    const int offset = cumulative_sequence_length[b];
+    const int sequence_length = cumulative_sequence_length[b + 1] - offset;
+    if (sequence_length == 0) {
+      continue;
+    }
+
+    if (!QkvToContext(cublas, stream, 1, sequence_length, num_heads, head_size, element_size,
+                      input + static_cast<size_t>(offset) * 3 * hidden_size,
+                      output + static_cast<size_t>(offset) * hidden_size, workspace,
+                      nullptr, nullptr, false, 0, static_cast<const T*>(nullptr), static_cast<T*>(nullptr))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool LaunchPackedAttentionKernel(
+    const void* input,
+    const int* cumulative_sequence_length,
+    int batch_size,
+    void* output,
+    int num_heads,
+    int head_size,
+    void* workspace,
+    cublasHandle_t& cublas,
+    const size_t element_size) {
+  // use default stream
+  const cudaStream_t stream = nullptr;
+
+  if (element_size == 2) {
+    return PackedQkvToContext(cublas, stream, cumulative_sequence_length, batch_size, num_heads, head_size, element_size,
+                              reinterpret_cast<const half*>(input), reinterpret_cast<half*>(output),
+                              reinterpret_cast<half*>(workspace));
+  } else {
+    return PackedQkvToContext(cublas, stream, cumulative_sequence_length, batch_size, num_heads, head_size, element_size,
+                              reinterpret_cast<const float*>(input), reinterpret_cast<float*>(output),
+                              reinterpret_cast<float*>(workspace));
+  }
+}
+
 }  // namespace cuda
 }  // namespace contrib
 }  // namespace onnxruntime
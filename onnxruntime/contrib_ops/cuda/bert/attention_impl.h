@@ -33,6 +33,18 @@ bool LaunchAttentionKernel(
     void* present                                 // Present state output
 );
 
+bool LaunchPackedAttentionKernel(
+    const void* input,                         // Input tensor with the projected Q, K and V of the packed tokens
+    const int* cumulative_sequence_length,     // Offsets of the sequences in the packed tokens, in CPU memory
+    int batch_size,                            // Number of packed sequences (B)
+    void* output,                              // Output tensor
+    int num_heads,                             // Number of attention heads (N)
+    int head_size,                             // Hidden layer size per head (H)
+    void* workspace,                           // Temporary buffer sized for any of the sequences
+    cublasHandle_t& cublas,                    // Cublas handle
+    const size_t element_size                  // Element size of input tensor
+);
+
 }  // namespace cuda
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -46,18 +46,29 @@ Status EmbedLayerNorm<T>::ComputeInternal(OpKernelContext* context) const {
   const Tensor* gamma = context->Input<Tensor>(5);
   const Tensor* beta = context->Input<Tensor>(6);
   const Tensor* mask = context->Input<Tensor>(7);  // optional. nullptr if not provided
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(8);  // optional. nullptr if not packed
 
   const auto& input_dims = input_ids->Shape().GetDims();
   int64_t hidden_size = word_embedding->Shape()[1];
 
-  TensorShape output_shape({input_dims[0], input_dims[1], hidden_size});
-  Tensor* output = context->Output(0, output_shape);
+  // Packed input_ids (token_count) are handled as one sequence with the positions restarting at each offset.
+  const bool is_packed = nullptr != cumulative_sequence_length;
+  int batch_size = is_packed ? static_cast<int>(cumulative_sequence_length->Shape()[0]) - 1
+                             : static_cast<int>(input_dims[0]);
+  int sequence_length = is_packed ? static_cast<int>(input_dims[0]) : static_cast<int>(input_dims[1]);
 
-  TensorShape mask_index_shape({input_dims[0]});
+  std::vector<int64_t> output_dims(input_dims);
+  output_dims.push_back(hidden_size);
+  Tensor* output = context->Output(0, TensorShape(output_dims));
+
+  TensorShape mask_index_shape({batch_size});
   Tensor* mask_index = context->Output(1, mask_index_shape);
 
-  int batch_size = static_cast<int>(input_dims[0]);
-  int sequence_length = static_cast<int>(input_dims[1]);
+  if (is_packed && sequence_length == 0) {
+    CUDA_RETURN_IF_ERROR(cudaMemsetAsync(mask_index->template MutableData<int32_t>(), 0, sizeof(int32_t) * batch_size));
+    return Status::OK();
+  }
+
   size_t element_size = sizeof(T);
 
   if (!LaunchEmbedLayerNormKernel(
@@ -66,6 +77,7 @@ Status EmbedLayerNorm<T>::ComputeInternal(OpKernelContext* context) const {
           input_ids->template Data<int32_t>(),
           segment_ids->template Data<int32_t>(),
           nullptr == mask ? nullptr : mask->template Data<int32_t>(),
+          is_packed ? cumulative_sequence_length->template Data<int32_t>() : nullptr,
           gamma->template Data<T>(),
           beta->template Data<T>(),
           word_embedding->template Data<T>(),
@@ -103,31 +103,63 @@ inline bool ComputeMaskIndex(cudaStream_t stream, const int sequence_length, con
   return CUDA_CALL(cudaPeekAtLastError());
 }
 
+__global__ void SequenceLengthKernel(int batch_size, const int* cumulative_sequence_length, int* mask_index) {
+  const int b = blockIdx.x * blockDim.x + threadIdx.x;
+  if (b < batch_size) {
+    mask_index[b] = cumulative_sequence_length[b + 1] - cumulative_sequence_length[b];
+  }
+}
+
+inline bool ComputeSequenceLength(cudaStream_t stream, const int batch_size, const int* cumulative_sequence_length, int* mask_index) {
+  // The mask index of packed input IDs is the length of each sequence
+  constexpr int tpb = 256;
+  SequenceLengthKernel<<<(batch_size + tpb - 1) / tpb, tpb, 0, stream>>>(batch_size, cumulative_sequence_length, mask_index);
+
+  return CUDA_CALL(cudaPeekAtLastError());
+}
+
 template <typename T, unsigned TPB>
 __global__ void EmbedLayerNormKernel(
     int hidden_size, const int* input_ids, const int* segment_ids, const T* beta, const T* gamma,
     const T* word_embedding, const T* position_embedding, const T* segment_embedding,
-    const T epsilon, T* output) {
+    const int* cumulative_sequence_length, int batch_size, const T epsilon, T* output) {
   KeyValuePairSum pair_sum;
   // 1. lookup word and segment of the block
   // blockIdx.x = position in the sequence
   // blockIdx.y = batch
   // gridDim.x = sequence_length
   // gridDim.y = batch_size
+  // For packed input IDs, gridDim.x = token_count and gridDim.y = 1, and the position restarts at each sequence.
   __shared__ int word_id;
   __shared__ int segment_id;
+  __shared__ int position_id;
 
   const T rld = T(1.f / hidden_size);
   const int sequence_position = blockIdx.y * gridDim.x + blockIdx.x;
   if (threadIdx.x == 0) {
     word_id = input_ids[sequence_position];
     segment_id = segment_ids[sequence_position];
+    position_id = blockIdx.x;
+    if (nullptr != cumulative_sequence_length) {
+      // find the last sequence starting at or before the token
+      int low = 0;
+      int high = batch_size;
+      while (high - low > 1) {
+        const int mid = (low + high) / 2;
+        if (cumulative_sequence_length[mid] <= sequence_position) {
+          low = mid;
+        } else {
+          high = mid;
+        }
+      }
+      position_id = sequence_position - cumulative_sequence_length[low];
+    }
   }
   __syncthreads();
 
   // 2. load pos/segment/word embeddings and add them toghether
   // offset into embeddings is given by word_id * hidden_size
-  const int position_offset = blockIdx.x * hidden_size;
+  const int position_offset = position_id * hidden_size;
   const int word_offset = word_id * hidden_size;
   const int segment_offset = segment_id * hidden_size;
   // the output offset is given by b * (sequence_length * hidden_size) + s * hidden_size
@@ -155,13 +187,14 @@ bool EmbedSkipLayerNorm(
     cudaStream_t stream, int hidden_size, int batch_size, int sequence_length,
     const int* input_ids, const int* segment_ids, const T* beta, const T* gamma,
     const T* word_embedding, const T* position_embedding, const T* segment_embedding,
-    const T epsilon, T* output) {
+    const int* cumulative_sequence_length, const T epsilon, T* output) {
   constexpr int tpb = 256;
-  const dim3 grid(sequence_length, batch_size, 1);
+  const dim3 grid(sequence_length, nullptr != cumulative_sequence_length ? 1 : batch_size, 1);
   const dim3 block(tpb, 1, 1);
 
   EmbedLayerNormKernel<T, tpb>
-      <<<grid, block, 0, stream>>>(hidden_size, input_ids, segment_ids, beta, gamma, word_embedding, position_embedding, segment_embedding, epsilon, output);
+      <<<grid, block, 0, stream>>>(hidden_size, input_ids, segment_ids, beta, gamma, word_embedding, position_embedding, segment_embedding,
+                                   cumulative_sequence_length, batch_size, epsilon, output);
 
   return CUDA_CALL(cudaPeekAtLastError());
 }
@@ -172,6 +205,7 @@ bool LaunchEmbedLayerNormKernel(
     const int* input_ids,
     const int* segment_ids,
     const int* input_mask,
+    const int* cumulative_sequence_length,
     const void* gamma,
     const void* beta,
     const void* word_embedding,
@@ -184,7 +218,10 @@ bool LaunchEmbedLayerNormKernel(
     const size_t element_size) {
   const cudaStream_t stream = nullptr;  // default stream
 
-  if (nullptr == input_mask) {
+  if (nullptr != cumulative_sequence_length) {
+    if (!ComputeSequenceLength(stream, batch_size, cumulative_sequence_length, static_cast<int*>(mask_index)))
+      return false;
+  } else if (nullptr == input_mask) {
     if (!CUDA_CALL(cudaMemsetAsync(mask_index, 0, sizeof(int) * batch_size)))
       return false;
   } else if (!ComputeMaskIndex(stream, sequence_length, batch_size, input_mask, static_cast<int*>(mask_index))) {
@@ -196,14 +233,14 @@ bool LaunchEmbedLayerNormKernel(
         stream, hidden_size, batch_size, sequence_length, input_ids, segment_ids,
         reinterpret_cast<const half*>(beta), reinterpret_cast<const half*>(gamma),
         reinterpret_cast<const half*>(word_embedding), reinterpret_cast<const half*>(position_embedding), 
-        reinterpret_cast<const half*>(segment_embedding), __float2half_rn(epsilon),
+        reinterpret_cast<const half*>(segment_embedding), cumulative_sequence_length, __float2half_rn(epsilon),
         reinterpret_cast<half*>(output));
   } else {
     return EmbedSkipLayerNorm<float>(
         stream, hidden_size, batch_size, sequence_length, input_ids, segment_ids,
         reinterpret_cast<const float*>(beta), reinterpret_cast<const float*>(gamma),
         reinterpret_cast<const float*>(word_embedding), reinterpret_cast<const float*>(position_embedding),
-        reinterpret_cast<const float*>(segment_embedding), epsilon,
+        reinterpret_cast<const float*>(segment_embedding), cumulative_sequence_length, epsilon,
         reinterpret_cast<float*>(output));
   }
 }
@@ -11,6 +11,7 @@ bool LaunchEmbedLayerNormKernel(void* output,                     // output tens
                                 const int* input_ids,             // input word IDs
                                 const int* segment_ids,           // input segment IDs
                                 const int* input_mask,            // input mask
+                                const int* cumulative_sequence_length,  // offsets of the sequences of packed input IDs. nullptr if not packed
                                 const void* gamma,                // weight for layer normalization
                                 const void* beta,                 // bias for layer normalization
                                 const void* word_embedding,       // weights for word embeddings
@@ -19,7 +20,7 @@ bool LaunchEmbedLayerNormKernel(void* output,                     // output tens
                                 float epsilon,                    // epsilon for layer normalization
                                 const int hidden_size,            // hidden size (that is head_size * num_heads)
                                 int batch_size,                   // batch size
-                                int sequence_length,              // sequence length
+                                int sequence_length,              // sequence length, or token count of packed input IDs
                                 const size_t element_size);       // size of element in output tensor. 2 for half, 4 for float.
 
 }  // namespace cuda
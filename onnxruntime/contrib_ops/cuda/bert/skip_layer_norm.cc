@@ -45,10 +45,12 @@ Status SkipLayerNorm<T>::ComputeInternal(OpKernelContext* ctx) const {
   Tensor* output = ctx->Output(0, input->Shape());
 
   const auto& input_dims = input->Shape().GetDims();
-  if (input_dims.size() != 3) {
+  // packed input of sequences with different lengths has shape (token_count, hidden_size)
+  if (input_dims.size() != 3 && input_dims.size() != 2) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                           "input is expected to have 3 dimensions, got ", input_dims.size());
+                           "input is expected to have 3 or 2 dimensions, got ", input_dims.size());
   }
+  const int64_t hidden_size = input_dims.back();
 
   if (input->Shape() != skip->Shape()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
@@ -60,7 +62,7 @@ Status SkipLayerNorm<T>::ComputeInternal(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "gamma is expected to have 1 dimension, got ", gamma_dims.size());
   }
-  if (gamma_dims[0] != input_dims[2]) {
+  if (gamma_dims[0] != hidden_size) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "Last dimension of gamma and input does not match");
   }
@@ -70,7 +72,7 @@ Status SkipLayerNorm<T>::ComputeInternal(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "beta is expected to have 1 dimension, got ", beta_dims.size());
   }
-  if (beta_dims[0] != input_dims[2]) {
+  if (beta_dims[0] != hidden_size) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "Last dimension of beta and input does not match");
   }
@@ -81,15 +83,13 @@ Status SkipLayerNorm<T>::ComputeInternal(OpKernelContext* ctx) const {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "bias is expected to have 1 dimension, got ", bias_dims.size());
     }
-    if (bias_dims[0] != input_dims[2]) {
+    if (bias_dims[0] != hidden_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Last dimension of bias and input does not match");
     }
   }
 
-  int sequence_length = static_cast<int>(input_dims[1]);
-  int hidden_size = static_cast<int>(input_dims[2]);
-  int64_t element_count = input_dims[0] * sequence_length * hidden_size;
+  int64_t element_count = input->Shape().Size();
   size_t element_size = sizeof(T);
 
   if (!LaunchSkipLayerNormKernel(
@@ -100,7 +100,7 @@ Status SkipLayerNorm<T>::ComputeInternal(OpKernelContext* ctx) const {
           beta->template Data<T>(),
           bias != nullptr ? bias->template Data<T>() : nullptr,
           epsilon_,
-          hidden_size,
+          static_cast<int>(hidden_size),
           static_cast<int>(element_count),  //TODO: check range
           element_size)) {
     // Get last error to reset it to cudaSuccess.
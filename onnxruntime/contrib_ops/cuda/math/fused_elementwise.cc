@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_elementwise.h"
+#include "fused_elementwise_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    float,
+    kCudaExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise<float>);
+
+template <typename T>
+Status FusedElementwise<T>::ComputeInternal(OpKernelContext* context) const {
+  const int input_count = context->InputCount();
+  std::vector<const TensorShape*> input_shapes;
+  for (int i = 0; i < input_count; ++i) {
+    input_shapes.push_back(&context->Input<Tensor>(i)->Shape());
+  }
+
+  std::vector<int64_t> output_dims;
+  std::vector<fused_elementwise::InputInfo> input_infos;
+  ORT_RETURN_IF_ERROR(fused_elementwise::PrepareBroadcast(input_shapes, output_dims, input_infos));
+
+  Tensor* output = context->Output(0, TensorShape(output_dims));
+  const int64_t output_size = output->Shape().Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  const int32_t rank = static_cast<int32_t>(output_dims.size());
+  FusedElementwiseArgs args;
+  args.input_count = input_count;
+  args.step_count = static_cast<int32_t>(steps_.size());
+  args.rank = rank;
+  args.inputs.size_ = input_count;
+  args.input_kinds.size_ = input_count;
+  args.fdm_input_sizes.size_ = input_count;
+  for (int i = 0; i < input_count; ++i) {
+    args.inputs[i] = context->Input<Tensor>(i)->template Data<T>();
+    args.input_kinds[i] = input_infos[i].kind;
+    if (input_infos[i].kind == fused_elementwise::InputKind::Suffix) {
+      args.fdm_input_sizes[i] = fast_divmod(gsl::narrow_cast<int>(input_infos[i].size));
+    } else if (input_infos[i].kind == fused_elementwise::InputKind::Broadcast) {
+      if (rank > kFusedElementwiseMaxRank) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise supports broadcasting up to rank ",
+                               kFusedElementwiseMaxRank, ", got an output of rank ", rank);
+      }
+      for (int32_t dim = 0; dim < rank; ++dim) {
+        args.input_strides[i * kFusedElementwiseMaxRank + dim] = gsl::narrow_cast<int32_t>(input_infos[i].strides[dim]);
+      }
+    }
+  }
+  if (rank <= kFusedElementwiseMaxRank) {
+    args.fdm_output_dims.size_ = rank;
+    for (int32_t dim = 0; dim < rank; ++dim) {
+      args.fdm_output_dims[dim] = fast_divmod(gsl::narrow_cast<int>(output_dims[dim]));
+    }
+  }
+  args.op_types.size_ = args.step_count;
+  args.operands.size_ = 2 * args.step_count;
+  for (int32_t i = 0; i < args.step_count; ++i) {
+    args.op_types[i] = steps_[i].op_type;
+    args.operands[2 * i] = steps_[i].operands[0];
+    args.operands[2 * i + 1] = steps_[i].operands[1];
+  }
+
+  FusedElementwiseImpl(args, output->template MutableData<T>(), static_cast<size_t>(output_size));
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+// Runs a chain of elementwise ops with one thread per element of the output, which keeps the intermediate results
+// in registers.
+template <typename T>
+class FusedElementwise final : public CudaKernel {
+ public:
+  FusedElementwise(const OpKernelInfo& info) : CudaKernel(info) {
+    ORT_THROW_IF_ERROR(fused_elementwise::ParseProgram(info, steps_));
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  std::vector<fused_elementwise::Step> steps_;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
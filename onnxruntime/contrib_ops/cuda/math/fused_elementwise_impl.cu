@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "fused_elementwise_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using fused_elementwise::InputKind;
+using fused_elementwise::OpType;
+
+__global__ void _FusedElementwiseKernel(const FusedElementwiseArgs args, float* output_data, const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+
+  // the inputs followed by the results of the steps
+  float values[fused_elementwise::kMaxInputs + fused_elementwise::kMaxSteps];
+  for (int i = 0; i < args.input_count; ++i) {
+    CUDA_LONG offset = 0;
+    switch (args.input_kinds[i]) {
+      case InputKind::Full:
+        offset = id;
+        break;
+      case InputKind::Scalar:
+        break;
+      case InputKind::Suffix:
+        offset = args.fdm_input_sizes[i].mod(id);
+        break;
+      default: {
+        int index = id;
+        for (int dim = args.rank - 1; dim >= 0; --dim) {
+          int q, r;
+          args.fdm_output_dims[dim].divmod(index, q, r);
+          offset += r * args.input_strides[i * kFusedElementwiseMaxRank + dim];
+          index = q;
+        }
+      } break;
+    }
+    values[i] = args.inputs[i][offset];
+  }
+
+  for (int i = 0; i < args.step_count; ++i) {
+    const float a = values[args.operands[2 * i]];
+    float y;
+    switch (args.op_types[i]) {
+      case OpType::Add:
+        y = a + values[args.operands[2 * i + 1]];
+        break;
+      case OpType::Sub:
+        y = a - values[args.operands[2 * i + 1]];
+        break;
+      case OpType::Mul:
+        y = a * values[args.operands[2 * i + 1]];
+        break;
+      case OpType::Div:
+        y = a / values[args.operands[2 * i + 1]];
+        break;
+      case OpType::Sqrt:
+        y = _Sqrt(a);
+        break;
+      case OpType::Erf:
+        y = _Erf(a);
+        break;
+      case OpType::Tanh:
+        y = _Tanh(a);
+        break;
+      case OpType::Sigmoid:
+        y = 1.0f / (1.0f + _Exp(-a));
+        break;
+      case OpType::Relu:
+        y = a > 0.0f ? a : 0.0f;
+        break;
+      case OpType::Exp:
+        y = _Exp(a);
+        break;
+      case OpType::Neg:
+        y = -a;
+        break;
+      case OpType::Abs:
+        y = fabsf(a);
+        break;
+      default:
+        y = 1.0f / a;
+        break;
+    }
+    values[args.input_count + i] = y;
+  }
+
+  output_data[id] = values[args.input_count + args.step_count - 1];
+}
+
+void FusedElementwiseImpl(const FusedElementwiseArgs& args, float* output_data, size_t count) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  _FusedElementwiseKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(args, output_data, (CUDA_LONG)count);
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+#include "contrib_ops/cpu/fused_elementwise_program.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+// Maximum rank of the inputs read with InputKind::Broadcast.
+constexpr int kFusedElementwiseMaxRank = 8;
+
+// The program and the inputs of a FusedElementwise node, passed by value to the kernel.
+struct FusedElementwiseArgs {
+  int32_t input_count;
+  int32_t step_count;
+  int32_t rank;
+  TArray<const float*, fused_elementwise::kMaxInputs> inputs;
+  TArray<fused_elementwise::InputKind, fused_elementwise::kMaxInputs> input_kinds;
+  // size of the Suffix inputs
+  TArray<fast_divmod, fused_elementwise::kMaxInputs> fdm_input_sizes;
+  // strides of the Broadcast inputs over the output dims, kFusedElementwiseMaxRank per input
+  TArray<int32_t, fused_elementwise::kMaxInputs * kFusedElementwiseMaxRank> input_strides;
+  TArray<fast_divmod, kFusedElementwiseMaxRank> fdm_output_dims;
+  TArray<fused_elementwise::OpType, fused_elementwise::kMaxSteps> op_types;
+  TArray<int32_t, 2 * fused_elementwise::kMaxSteps> operands;
+};
+
+void FusedElementwiseImpl(const FusedElementwiseArgs& args, float* output_data, size_t count);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,214 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_gemm.h"
+#include "core/providers/cpu/math/gemm_helper.h"
+#include "core/providers/cuda/activation/activations_impl.h"
+#include "contrib_ops/cuda/bert/fast_gelu_impl.h"
+
+#include <cublasLt.h>
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      FusedGemm,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedGemm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+
+// Upper bound of the workspace offered to the cuBLASLt heuristic.
+constexpr size_t kCublasLtWorkspaceSize = 4 * 1024 * 1024;
+
+#if CUDART_VERSION >= 11000
+// Owns the cuBLASLt descriptors of a single matmul.
+struct CublasLtMatmulDescriptors {
+  ~CublasLtMatmulDescriptors() {
+    if (preference != nullptr) cublasLtMatmulPreferenceDestroy(preference);
+    if (d_layout != nullptr) cublasLtMatrixLayoutDestroy(d_layout);
+    if (b_layout != nullptr) cublasLtMatrixLayoutDestroy(b_layout);
+    if (a_layout != nullptr) cublasLtMatrixLayoutDestroy(a_layout);
+    if (operation != nullptr) cublasLtMatmulDescDestroy(operation);
+  }
+
+  cublasLtMatmulDesc_t operation = nullptr;
+  cublasLtMatrixLayout_t a_layout = nullptr;
+  cublasLtMatrixLayout_t b_layout = nullptr;
+  cublasLtMatrixLayout_t d_layout = nullptr;
+  cublasLtMatmulPreference_t preference = nullptr;
+};
+#endif
+
+}  // namespace
+
+template <typename T>
+FusedGemm<T>::FusedGemm(const OpKernelInfo& info) : onnxruntime::cuda::Gemm<T>(info) {
+  std::string activation = info.GetAttrOrDefault<std::string>("activation", "");
+  if (activation == "Relu") {
+    activation_ = Activation::Relu;
+  } else if (activation == "FastGelu") {
+    activation_ = Activation::FastGelu;
+  } else {
+    ORT_THROW("Unsupported activation for CUDA FusedGemm: ", activation);
+  }
+}
+
+template <typename T>
+Status FusedGemm<T>::ComputeInternal(OpKernelContext* context) const {
+  bool computed = false;
+  ORT_RETURN_IF_ERROR(ComputeWithEpilogue(context, computed));
+  if (computed) {
+    return Status::OK();
+  }
+
+  // the bias or activation can't be expressed as a cuBLASLt epilogue, run Gemm then the activation
+  ORT_RETURN_IF_ERROR(onnxruntime::cuda::Gemm<T>::ComputeInternal(context));
+  return ComputeActivation(*context->Output<Tensor>(0));
+}
+
+template <typename T>
+Status FusedGemm<T>::ComputeWithEpilogue(OpKernelContext* context, bool& computed) const {
+  computed = false;
+#if CUDART_VERSION >= 11000
+  const auto* X = context->Input<Tensor>(0);
+  const auto* W = context->Input<Tensor>(1);
+  const auto* B = context->Input<Tensor>(2);
+  GemmHelper helper(X->Shape(), this->trans_A_, W->Shape(), this->trans_B_, B != nullptr ? B->Shape() : TensorShape({}));
+
+  if (!helper.State().IsOK())
+    return helper.State();
+
+  int64_t M = helper.M();
+  int64_t N = helper.N();
+  int64_t K = helper.K();
+  if (M == 0 || N == 0 || K == 0) {
+    return Status::OK();
+  }
+
+  // The epilogue adds an unscaled bias vector broadcast across the rows of Y, so only (N,) or (1, N) with beta == 1
+  // can be fused. Other shapes are broadcast into Y by Gemm before the matmul.
+  const bool has_bias = B != nullptr && this->beta_ != 0;
+  if (has_bias) {
+    const auto& b_shape = B->Shape();
+    if (this->beta_ != 1.0f || b_shape.Size() != N || (b_shape.NumDimensions() == 2 && b_shape[0] != 1)) {
+      return Status::OK();
+    }
+  }
+
+  cublasLtEpilogue_t epilogue;
+  switch (activation_) {
+    case Activation::Relu:
+      epilogue = has_bias ? CUBLASLT_EPILOGUE_RELU_BIAS : CUBLASLT_EPILOGUE_RELU;
+      break;
+    case Activation::FastGelu:
+#if CUDART_VERSION >= 11030
+      // the cuBLASLt GELU epilogue uses the same tanh approximation as FastGelu
+      epilogue = has_bias ? CUBLASLT_EPILOGUE_GELU_BIAS : CUBLASLT_EPILOGUE_GELU;
+      break;
+#else
+      return Status::OK();
+#endif
+    default:
+      return Status::OK();
+  }
+
+  const cudaDataType_t data_type = std::is_same<T, MLFloat16>::value ? CUDA_R_16F : CUDA_R_32F;
+  const cublasOperation_t trans_a = this->trans_B_ ? CUBLAS_OP_T : CUBLAS_OP_N;
+  const cublasOperation_t trans_b = this->trans_A_ ? CUBLAS_OP_T : CUBLAS_OP_N;
+
+  CublasLtMatmulDescriptors desc;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescCreate(&desc.operation, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(desc.operation, CUBLASLT_MATMUL_DESC_TRANSA,
+                                                        &trans_a, sizeof(trans_a)));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(desc.operation, CUBLASLT_MATMUL_DESC_TRANSB,
+                                                        &trans_b, sizeof(trans_b)));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(desc.operation, CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                                        &epilogue, sizeof(epilogue)));
+  if (has_bias) {
+    const void* bias_data = B->DataRaw();
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(desc.operation, CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+                                                          &bias_data, sizeof(bias_data)));
+  }
+
+  // CUDA assumes col-major, so Y(N,M) = alpha * op(W) x op(X) + bias, with the layouts describing W and X as stored.
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&desc.a_layout, data_type,
+                                                    this->trans_B_ ? K : N, this->trans_B_ ? N : K,
+                                                    this->trans_B_ ? K : N));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&desc.b_layout, data_type,
+                                                    this->trans_A_ ? M : K, this->trans_A_ ? K : M,
+                                                    this->trans_A_ ? M : K));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&desc.d_layout, data_type, N, M, N));
+
+  size_t max_workspace_size = kCublasLtWorkspaceSize;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceCreate(&desc.preference));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(desc.preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+                                                              &max_workspace_size, sizeof(max_workspace_size)));
+
+  // a cuBLAS handle can be used in place of a cuBLASLt handle
+  cublasLtHandle_t lt_handle = reinterpret_cast<cublasLtHandle_t>(this->CublasHandle());
+
+  cublasLtMatmulHeuristicResult_t heuristic = {};
+  int algo_count = 0;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulAlgoGetHeuristic(lt_handle, desc.operation, desc.a_layout, desc.b_layout,
+                                                        desc.d_layout, desc.d_layout, desc.preference,
+                                                        1, &heuristic, &algo_count));
+  if (algo_count == 0) {
+    return Status::OK();
+  }
+
+  auto* Y = context->Output(0, TensorShape(std::vector<int64_t>{M, N}));
+  auto workspace = this->GetWorkspace(heuristic.workspaceSize);
+
+  const float alpha = this->alpha_;
+  const float beta = 0.0f;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmul(lt_handle, desc.operation,
+                                        &alpha, W->DataRaw(), desc.a_layout, X->DataRaw(), desc.b_layout,
+                                        &beta, Y->MutableDataRaw(), desc.d_layout, Y->MutableDataRaw(), desc.d_layout,
+                                        &heuristic.algo, workspace.get(), heuristic.workspaceSize,
+                                        nullptr));
+  computed = true;
+#else
+  ORT_UNUSED_PARAMETER(context);
+#endif
+  return Status::OK();
+}
+
+template <typename T>
+Status FusedGemm<T>::ComputeActivation(Tensor& Y) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  CudaT* y_data = reinterpret_cast<CudaT*>(Y.template MutableData<T>());
+  const size_t count = gsl::narrow<size_t>(Y.Shape().Size());
+
+  switch (activation_) {
+    case Activation::Relu: {
+      onnxruntime::cuda::CtxRelu ctx;
+      onnxruntime::cuda::Impl_Relu<CudaT>(y_data, y_data, &ctx, count);
+      break;
+    }
+    case Activation::FastGelu:
+      if (!LaunchFastGeluKernel<CudaT>(this->GetDeviceProp(), nullptr, static_cast<int>(count), 0,
+                                       y_data, nullptr, y_data)) {
+        CUDA_CALL(cudaGetLastError());
+        return Status(common::ONNXRUNTIME, common::FAIL);
+      }
+      break;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
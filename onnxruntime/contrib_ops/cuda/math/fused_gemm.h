@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/math/gemm.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Gemm followed by an activation, as produced by GemmActivationFusion.
+// The bias and the activation are applied in the epilogue of a cuBLASLt matmul when the
+// bias is a row vector, otherwise the activation runs as a separate kernel on the Gemm output.
+template <typename T>
+class FusedGemm final : public onnxruntime::cuda::Gemm<T> {
+ public:
+  FusedGemm(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  enum class Activation {
+    Relu,
+    FastGelu,
+  };
+
+  Status ComputeWithEpilogue(OpKernelContext* context, bool& computed) const;
+  Status ComputeActivation(Tensor& Y) const;
+
+  Activation activation_;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/nn/batch_norm.h"
+#include "core/providers/cuda/nn/conv.h"
+#include "core/providers/cuda/nn/pool.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The channels-last variants of the cuDNN kernels, which the NhwcTransformer substitutes for the standard operators.
+template <typename T>
+using NhwcConv = ::onnxruntime::cuda::Conv<T, true>;
+template <typename T>
+using NhwcMaxPool = ::onnxruntime::cuda::Pool<T, MaxPool<1>, true>;
+template <typename T>
+using NhwcAveragePool = ::onnxruntime::cuda::Pool<T, AveragePool, true>;
+template <typename T>
+using NhwcBatchNorm = ::onnxruntime::cuda::BatchNorm<T, true>;
+
+#define REGISTER_NHWC_KERNEL_TYPED(op_name, T, kernel_class)                    \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                \
+      op_name,                                                                  \
+      kMSNhwcDomain,                                                            \
+      1,                                                                        \
+      T,                                                                        \
+      kCudaExecutionProvider,                                                   \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      kernel_class<T>);
+
+REGISTER_NHWC_KERNEL_TYPED(Conv, float, NhwcConv)
+REGISTER_NHWC_KERNEL_TYPED(Conv, MLFloat16, NhwcConv)
+REGISTER_NHWC_KERNEL_TYPED(MaxPool, float, NhwcMaxPool)
+REGISTER_NHWC_KERNEL_TYPED(MaxPool, MLFloat16, NhwcMaxPool)
+REGISTER_NHWC_KERNEL_TYPED(AveragePool, float, NhwcAveragePool)
+REGISTER_NHWC_KERNEL_TYPED(AveragePool, MLFloat16, NhwcAveragePool)
+REGISTER_NHWC_KERNEL_TYPED(BatchNormalization, float, NhwcBatchNorm)
+REGISTER_NHWC_KERNEL_TYPED(BatchNormalization, MLFloat16, NhwcBatchNorm)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "embedding_bag.h"
+#include "embedding_bag_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag);
+
+Status EmbeddingBag::ComputeInternal(OpKernelContext* context) const {
+  const Tensor& table = *context->Input<Tensor>(0);
+  const Tensor& indices = *context->Input<Tensor>(1);
+  const Tensor* offsets = context->Input<Tensor>(2);
+
+  int64_t batch_size, bag_size;
+  ORT_RETURN_IF_ERROR(PrepareForCompute(table, indices, offsets, batch_size, bag_size));
+
+  const int64_t num_embeddings = table.Shape()[0];
+  const int64_t embedding_dim = table.Shape()[1];
+  Tensor& Y = *context->Output(0, {batch_size, embedding_dim});
+  if (Y.Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const int64_t num_indices = indices.Shape().Size();
+  if (indices.IsDataType<int32_t>()) {
+    EmbeddingBagImpl<int32_t>(table.Data<float>(), num_embeddings, embedding_dim, indices.Data<int32_t>(),
+                              offsets != nullptr ? offsets->Data<int32_t>() : nullptr, num_indices, batch_size,
+                              bag_size, mean_, Y.MutableData<float>());
+  } else {
+    EmbeddingBagImpl<int64_t>(table.Data<float>(), num_embeddings, embedding_dim, indices.Data<int64_t>(),
+                              offsets != nullptr ? offsets->Data<int64_t>() : nullptr, num_indices, batch_size,
+                              bag_size, mean_, Y.MutableData<float>());
+  }
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
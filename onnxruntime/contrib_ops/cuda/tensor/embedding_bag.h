@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/embedding_bag.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+// Reduces each bag with a thread block, whose threads sum columns of the gathered rows.
+class EmbeddingBag final : public contrib::EmbeddingBagBase, public CudaKernel {
+ public:
+  EmbeddingBag(const OpKernelInfo& info) : contrib::EmbeddingBagBase(info), CudaKernel(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
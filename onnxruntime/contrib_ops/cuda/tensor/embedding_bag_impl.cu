@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "embedding_bag_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+template <typename Tind>
+__global__ void _EmbeddingBagKernel(
+    const float* table_data,
+    const int64_t num_embeddings,
+    const int64_t embedding_dim,
+    const Tind* indices_data,
+    const Tind* offsets_data,
+    const int64_t num_indices,
+    const int64_t batch_size,
+    const int64_t bag_size,
+    const bool mean,
+    float* output_data) {
+  const int64_t bag = blockIdx.x;
+  int64_t begin = bag * bag_size;
+  int64_t end = begin + bag_size;
+  if (offsets_data != nullptr) {
+    begin = max(min(static_cast<int64_t>(offsets_data[bag]), num_indices), int64_t{0});
+    end = bag + 1 < batch_size ? static_cast<int64_t>(offsets_data[bag + 1]) : num_indices;
+    end = max(min(end, num_indices), begin);
+  }
+
+  const float scale = mean && end > begin ? 1.0f / static_cast<float>(end - begin) : 1.0f;
+  for (int64_t d = threadIdx.x; d < embedding_dim; d += blockDim.x) {
+    float sum = 0.0f;
+    for (int64_t i = begin; i < end; ++i) {
+      int64_t index = static_cast<int64_t>(indices_data[i]);
+      index = index < 0 ? index + num_embeddings : index;
+      if (index >= 0 && index < num_embeddings) {
+        sum += table_data[index * embedding_dim + d];
+      }
+    }
+    output_data[bag * embedding_dim + d] = sum * scale;
+  }
+}
+
+template <typename Tind>
+void EmbeddingBagImpl(
+    const float* table_data,
+    const int64_t num_embeddings,
+    const int64_t embedding_dim,
+    const Tind* indices_data,
+    const Tind* offsets_data,
+    const int64_t num_indices,
+    const int64_t batch_size,
+    const int64_t bag_size,
+    const bool mean,
+    float* output_data) {
+  // a warp multiple of threads per bag, up to one thread per column
+  const int64_t warps = (embedding_dim + GPU_WARP_SIZE - 1) / GPU_WARP_SIZE;
+  const int threads_per_block = static_cast<int>(std::min<int64_t>(warps * GPU_WARP_SIZE,
+                                                                   GridDim::maxThreadsPerBlock));
+  _EmbeddingBagKernel<Tind><<<static_cast<unsigned int>(batch_size), threads_per_block, 0>>>(
+      table_data, num_embeddings, embedding_dim, indices_data, offsets_data, num_indices, batch_size, bag_size, mean,
+      output_data);
+}
+
+#define SPECIALIZED_IMPL(Tind)                                                                                   \
+  template void EmbeddingBagImpl<Tind>(const float* table_data, const int64_t num_embeddings,                  \
+                                       const int64_t embedding_dim, const Tind* indices_data,                  \
+                                       const Tind* offsets_data, const int64_t num_indices,                    \
+                                       const int64_t batch_size, const int64_t bag_size, const bool mean,      \
+                                       float* output_data);
+
+SPECIALIZED_IMPL(int32_t)
+SPECIALIZED_IMPL(int64_t)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
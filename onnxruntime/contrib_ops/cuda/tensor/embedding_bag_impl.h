@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+// offsets_data is nullptr if the bags are the rows of [batch_size, bag_size] indices. Indices out of the table are
+// skipped, as Gather produces zeros for them.
+template <typename Tind>
+void EmbeddingBagImpl(
+    const float* table_data,
+    const int64_t num_embeddings,
+    const int64_t embedding_dim,
+    const Tind* indices_data,
+    const Tind* offsets_data,
+    const int64_t num_indices,
+    const int64_t batch_size,
+    const int64_t bag_size,
+    const bool mean,
+    float* output_data);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -89,7 +89,20 @@ bool TryVectorization(
   }
   const int64_t* tail_dim = as_const_int(shape[rank - 1]);
 
-  if (nullptr != tail_dim) {
+  if (nullptr == tail_dim) {
+    // A symbolic tail dim, e.g. a sequence length only known at execution.
+    // Split it by the vector width anyway, so that one function serves every length:
+    // the split guards the last partial vector with likely(), and the loop partition in lowering
+    // peels it off into a scalar tail, leaving a vectorized main loop whose trip count is computed at runtime.
+    auto compute_op = tensor->op.as<tvm::ComputeOpNode>();
+    if (nullptr != compute_op && natural_vector_size > 1) {
+      tvm::IterVar x = compute_op->axis[rank - 1];
+      tvm::IterVar xi, xo;
+      ctx.schedule[tensor->op].split(x, static_cast<int32_t>(natural_vector_size), &xo, &xi);
+      ctx.schedule[tensor->op].vectorize(xi);
+      return true;
+    }
+  } else {
     auto extern_op = tensor->op.as<tvm::ExternOpNode>();
     if (nullptr != extern_op) {
       return false;
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace onnxruntime {
+
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+
+  int msb = kSubBucketBits;
+  while (msb < 63 && (value >> (msb + 1)) != 0) {
+    ++msb;
+  }
+  if (msb >= kMaxValueBits) {
+    return kNumBuckets - 1;
+  }
+
+  // the power of two range of the value, and its kSubBucketBits bits below the most significant bit
+  const size_t group = static_cast<size_t>(msb - kSubBucketBits + 1);
+  const size_t sub_bucket = static_cast<size_t>((value >> (msb - kSubBucketBits)) - kSubBuckets);
+  return group * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t bucket) {
+  const size_t group = bucket / kSubBuckets;
+  const uint64_t sub_bucket = bucket % kSubBuckets;
+  if (group == 0) {
+    return sub_bucket;
+  }
+  if (bucket == kNumBuckets - 1) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  const uint64_t lower_bound = (kSubBuckets + sub_bucket) << (group - 1);
+  return lower_bound + (uint64_t{1} << (group - 1)) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+  bucket_counts_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.bucket_counts.resize(kNumBuckets);
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    snapshot.bucket_counts[i] = bucket_counts_[i].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.bucket_counts[i];
+  }
+  snapshot.sum = sum_.load(std::memory_order_relaxed);
+  snapshot.max = max_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+uint64_t LatencyHistogram::Snapshot::ValueAtQuantile(double quantile) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  quantile = std::min(std::max(quantile, 0.0), 1.0);
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count))));
+
+  uint64_t cumulative_count = 0;
+  for (size_t i = 0; i < bucket_counts.size(); ++i) {
+    cumulative_count += bucket_counts[i];
+    if (cumulative_count >= rank) {
+      return std::min(BucketUpperBound(i), max);
+    }
+  }
+  return max;
+}
+
+}  // namespace onnxruntime
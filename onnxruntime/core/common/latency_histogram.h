@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+/**
+ * A histogram of latencies in microseconds, in the spirit of HdrHistogram.
+ *
+ * Each power of two range of values is split into kSubBuckets linear buckets, so the error of a
+ * reported value is bounded by 1/kSubBuckets of the value (6.25%) at any magnitude, with a fixed
+ * number of buckets. Values below kSubBuckets are counted exactly.
+ *
+ * Recording is lock free (relaxed atomic increments), so the histogram can be updated from
+ * concurrent runs and read at any time. A snapshot taken while values are being recorded may be
+ * off by the values being recorded.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+  // Values from 2^kMaxValueBits microseconds (about 12 days) on go to the last bucket.
+  static constexpr int kMaxValueBits = 40;
+  static constexpr size_t kNumBuckets = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+  struct Snapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    std::vector<uint64_t> bucket_counts;  // kNumBuckets entries
+
+    // Returns the smallest recorded value (up to the bucket resolution) that is greater than or equal to the
+    // given fraction (0 to 1) of the values, or 0 if nothing was recorded.
+    uint64_t ValueAtQuantile(double quantile) const;
+  };
+
+  LatencyHistogram() = default;
+
+  void Record(uint64_t value);
+
+  Snapshot GetSnapshot() const;
+
+  // Returns the bucket of a value.
+  static size_t BucketIndex(uint64_t value);
+
+  // Returns the largest value counted in a bucket.
+  static uint64_t BucketUpperBound(size_t bucket);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LatencyHistogram);
+
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+  std::atomic<uint64_t> bucket_counts_[kNumBuckets]{};
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/logging/sinks/async_sink.h"
+
+#include <stdexcept>
+
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+namespace logging {
+constexpr size_t AsyncSink::kDefaultCapacity;
+
+namespace {
+size_t RoundUpToPowerOf2(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+}  // namespace
+
+AsyncSink::AsyncSink(std::unique_ptr<ISink> sink, size_t capacity)
+    : sink_{std::move(sink)},
+      mask_{RoundUpToPowerOf2(capacity < 2 ? 2 : capacity) - 1},
+      slots_{new Slot[mask_ + 1]} {
+  if (sink_ == nullptr) {
+    throw std::logic_error("ISink must be provided.");
+  }
+
+  for (size_t i = 0; i <= mask_; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  thread_ = std::thread([this]() { OutputLoop(); });
+}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+// Bounded multi-producer ring buffer: each slot carries a sequence number telling whether it is free for the
+// entry at a given position, so producers only compete on enqueue_pos_.
+void AsyncSink::SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) {
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &slots_[pos & mask_];
+    const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // the slot still holds the entry of the previous lap, so the ring buffer is full
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+
+  const CodeLocation& location = message.Location();
+  Entry& entry = slot->entry;
+  entry.timestamp = timestamp;
+  entry.logger_id = logger_id;
+  entry.severity = message.Severity();
+  entry.category = message.Category();
+  entry.data_type = message.DataType();
+  entry.file = location.file_and_path;
+  entry.line = location.line_num;
+  entry.function = location.function;
+  entry.message = message.Message();
+  slot->sequence.store(pos + 1, std::memory_order_release);
+
+  // pairs with the fence in OutputLoop, so either this thread sees the background thread waiting or the
+  // background thread sees the entry
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiting_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_one();
+  }
+}
+
+bool AsyncSink::TryPop(Entry& entry) {
+  Slot& slot = slots_[dequeue_pos_ & mask_];
+  if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+    return false;
+  }
+
+  entry = std::move(slot.entry);
+  slot.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+  ++dequeue_pos_;
+  return true;
+}
+
+void AsyncSink::Output(const Entry& entry) {
+  // not logged again when destroyed as the Capture has no logger
+  Capture message{entry.severity, entry.category.c_str(), entry.data_type,
+                  CodeLocation{entry.file.c_str(), entry.line, entry.function.c_str()}, entry.message};
+  sink_->Send(entry.timestamp, entry.logger_id, message);
+  last_timestamp_ = entry.timestamp;
+}
+
+void AsyncSink::ReportDropped() {
+  const size_t dropped_count = dropped_count_.load(std::memory_order_relaxed);
+  if (dropped_count == reported_dropped_count_) {
+    return;
+  }
+
+  Entry entry;
+  entry.timestamp = last_timestamp_;
+  entry.logger_id = "AsyncSink";
+  entry.severity = Severity::kWARNING;
+  entry.category = Category::onnxruntime;
+  entry.data_type = DataType::SYSTEM;
+  entry.file = __FILE__;
+  entry.line = __LINE__;
+  entry.function = __FUNCTION__;
+  entry.message = std::to_string(dropped_count - reported_dropped_count_) +
+                  " log messages were dropped as the log output couldn't keep up";
+  reported_dropped_count_ = dropped_count;
+  Output(entry);
+}
+
+void AsyncSink::OutputLoop() {
+  Entry entry;
+  for (;;) {
+    while (TryPop(entry)) {
+      Output(entry);
+    }
+    ReportDropped();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      // output what was logged while shutting down
+      lock.unlock();
+      while (TryPop(entry)) {
+        Output(entry);
+      }
+      ReportDropped();
+      return;
+    }
+
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (slots_[dequeue_pos_ & mask_].sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+      // woken up by the next thread that logs, or by the destructor
+      cv_.wait(lock);
+    }
+    waiting_.store(false, std::memory_order_relaxed);
+  }
+}
+}  // namespace logging
+}  // namespace onnxruntime
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "core/common/logging/capture.h"
+#include "core/common/logging/isink.h"
+
+namespace onnxruntime {
+namespace logging {
+/// <summary>
+/// An ISink that hands the messages to another sink on a background thread, so the threads that log only copy the
+/// message into a bounded ring buffer. Writing to the ring buffer doesn't take a lock; when it is full the message
+/// is dropped and counted, and the number of dropped messages is reported by a warning once there is room again.
+/// The destructor outputs the buffered messages before returning.
+/// </summary>
+/// <seealso cref="ISink" />
+class AsyncSink : public ISink {
+ public:
+  static constexpr size_t kDefaultCapacity = 4096;
+
+  /// <summary>
+  /// Initializes a new instance of the <see cref="AsyncSink"/> class.
+  /// </summary>
+  /// <param name="sink">The sink the messages are sent to from the background thread.</param>
+  /// <param name="capacity">Number of messages the ring buffer holds, rounded up to a power of 2.</param>
+  explicit AsyncSink(std::unique_ptr<ISink> sink, size_t capacity = kDefaultCapacity);
+
+  ~AsyncSink() override;
+
+  void SendProfileEvent(profiling::EventRecord& event_record) const override {
+    sink_->SendProfileEvent(event_record);
+  }
+
+  /// <summary>
+  /// Number of messages dropped because the ring buffer was full.
+  /// </summary>
+  size_t DroppedCount() const noexcept { return dropped_count_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Entry {
+    Timestamp timestamp;
+    std::string logger_id;
+    Severity severity;
+    std::string category;
+    DataType data_type;
+    std::string file;
+    int line;
+    std::string function;
+    std::string message;
+  };
+
+  struct Slot {
+    // position of the entry that may be written next to the slot, plus one once the entry is written
+    std::atomic<size_t> sequence;
+    Entry entry;
+  };
+
+  void SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) override;
+
+  bool TryPop(Entry& entry);
+  void Output(const Entry& entry);
+  void ReportDropped();
+  void OutputLoop();
+
+  std::unique_ptr<ISink> sink_;
+
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<size_t> enqueue_pos_{0};
+  size_t dequeue_pos_ = 0;  // only used by the background thread
+
+  std::atomic<size_t> dropped_count_{0};
+  size_t reported_dropped_count_ = 0;
+  // timestamp of the last message output, used for the report of the dropped messages
+  Timestamp last_timestamp_;
+
+  // the background thread sleeps while the ring buffer is empty. the threads that log only take the mutex to
+  // wake it up.
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<bool> waiting_{false};
+  bool shutdown_ = false;
+
+  std::thread thread_;
+};
+}  // namespace logging
+}  // namespace onnxruntime
@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/parallel_for_cost_table.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace onnxruntime {
+namespace concurrency {
+
+namespace {
+thread_local const std::string* current_op_type = nullptr;
+
+// Weight of a new measurement once an entry has this many samples.
+// Before that, the entry is the plain average of its samples.
+constexpr uint64_t kAveragingWindow = 8;
+}  // namespace
+
+ParallelForCostTable::OpScope::OpScope(const std::string& op_type) : prev_op_type_(current_op_type) {
+  current_op_type = &op_type;
+}
+
+ParallelForCostTable::OpScope::~OpScope() {
+  current_op_type = prev_op_type_;
+}
+
+const std::string* ParallelForCostTable::CurrentOpType() {
+  return current_op_type;
+}
+
+int ParallelForCostTable::SizeClass(std::ptrdiff_t total) {
+  int size_class = 0;
+  for (auto n = static_cast<uint64_t>(total); n > 1; n >>= 1) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+bool ParallelForCostTable::Lookup(const std::string& op_type, std::ptrdiff_t total, double& ns_per_element) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(op_type);
+  if (it == entries_.end()) {
+    return false;
+  }
+  const Entry& entry = it->second[SizeClass(total)];
+  if (entry.num_samples < kMinSamples) {
+    return false;
+  }
+  ns_per_element = entry.ns_per_element;
+  return true;
+}
+
+void ParallelForCostTable::Record(const std::string& op_type, std::ptrdiff_t total, double ns) {
+  if (total <= 0 || ns < 0) {
+    return;
+  }
+  const double sample = ns / static_cast<double>(total);
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Entry& entry = entries_[op_type][SizeClass(total)];
+  ++entry.num_samples;
+  const auto weight = static_cast<double>(std::min(entry.num_samples, kAveragingWindow));
+  entry.ns_per_element += (sample - entry.ns_per_element) / weight;
+}
+
+size_t ParallelForCostTable::NumEntries() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  size_t num_entries = 0;
+  for (const auto& op_entries : entries_) {
+    for (const auto& entry : op_entries.second) {
+      if (entry.num_samples > 0) {
+        ++num_entries;
+      }
+    }
+  }
+  return num_entries;
+}
+
+Status ParallelForCostTable::Save(const PathString& file_path) const {
+  std::ofstream out(file_path, std::ios::out | std::ios::trunc);
+  if (!out) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open the ParallelFor cost table file for writing");
+  }
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& op_entries : entries_) {
+    for (int size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+      const Entry& entry = op_entries.second[size_class];
+      if (entry.num_samples > 0) {
+        out << op_entries.first << ' ' << size_class << ' ' << entry.ns_per_element << ' ' << entry.num_samples
+            << '\n';
+      }
+    }
+  }
+  out.flush();
+  if (!out) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the ParallelFor cost table file");
+  }
+  return Status::OK();
+}
+
+Status ParallelForCostTable::Load(const PathString& file_path) {
+  std::ifstream in(file_path);
+  if (!in) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Failed to open the ParallelFor cost table file");
+  }
+  std::unordered_map<std::string, Entries> entries;
+  std::string line;
+  for (int line_number = 1; std::getline(in, line); ++line_number) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string op_type;
+    int size_class = -1;
+    Entry entry;
+    if (!(fields >> op_type >> size_class >> entry.ns_per_element >> entry.num_samples) ||
+        size_class < 0 || size_class >= kNumSizeClasses || entry.ns_per_element < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Invalid entry in the ParallelFor cost table file at line ", line_number, ": ", line);
+    }
+    entries[op_type][size_class] = entry;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (auto& op_entries : entries) {
+    Entries& existing = entries_[op_entries.first];
+    for (int size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+      if (op_entries.second[size_class].num_samples > 0) {
+        existing[size_class] = op_entries.second[size_class];
+      }
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace concurrency
+}  // namespace onnxruntime
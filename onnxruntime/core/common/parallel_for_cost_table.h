@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace concurrency {
+
+/**
+ * Per-element costs of ThreadPool::ParallelFor loops measured at runtime.
+ *
+ * The costs are keyed by the operator running on the calling thread (see OpScope) and by the
+ * size class of the loop (floor(log2(total))), as the cost of an element usually depends on
+ * both. Once an entry has enough samples, ParallelFor uses it instead of the cost estimate
+ * passed by the kernel.
+ *
+ * The table can be written to and read from a text file with one entry per line:
+ *   <op type> <size class> <nanoseconds per element> <number of samples>
+ */
+class ParallelForCostTable {
+ public:
+  // Number of measurements an entry needs before it replaces the caller's estimate.
+  static constexpr uint64_t kMinSamples = 3;
+  static constexpr int kNumSizeClasses = 64;
+
+  ParallelForCostTable() = default;
+
+  // Sets the operator that ParallelFor calls made from the current thread are attributed to,
+  // for the lifetime of the scope.
+  class OpScope {
+   public:
+    explicit OpScope(const std::string& op_type);
+    ~OpScope();
+
+   private:
+    const std::string* prev_op_type_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OpScope);
+  };
+
+  // Returns the operator set by the innermost OpScope of the calling thread, or nullptr.
+  static const std::string* CurrentOpType();
+
+  static int SizeClass(std::ptrdiff_t total);
+
+  // Returns true and the learned cost in nanoseconds per element if the entry has enough samples.
+  bool Lookup(const std::string& op_type, std::ptrdiff_t total, double& ns_per_element) const;
+
+  // Adds a measurement of a loop of `total` elements that took `ns` nanoseconds of thread time.
+  void Record(const std::string& op_type, std::ptrdiff_t total, double ns);
+
+  size_t NumEntries() const;
+
+  Status Save(const PathString& file_path) const;
+  Status Load(const PathString& file_path);
+
+ private:
+  struct Entry {
+    double ns_per_element = 0;
+    uint64_t num_samples = 0;
+  };
+  using Entries = std::array<Entry, kNumSizeClasses>;
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<std::string, Entries> entries_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelForCostTable);
+};
+
+}  // namespace concurrency
+}  // namespace onnxruntime
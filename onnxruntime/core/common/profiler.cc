@@ -3,6 +3,10 @@
 
 #include "profiler.h"
 
+#include <algorithm>
+#include <map>
+#include <string>
+
 namespace onnxruntime {
 namespace profiling {
 using namespace std::chrono;
@@ -63,15 +67,25 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
                                      const TimePoint& start_time,
                                      const std::initializer_list<std::pair<std::string, std::string>>& event_args,
                                      bool /*sync_gpu*/) {
-  long long dur = TimeDiffMicroSeconds(start_time);
+  //TODO: sync_gpu if needed.
+  RecordEvent(category, event_name, start_time, high_resolution_clock::now(), logging::GetThreadId(),
+              {event_args.begin(), event_args.end()});
+}
+
+void Profiler::RecordEvent(EventCategory category,
+                           const std::string& event_name,
+                           const TimePoint& start_time,
+                           const TimePoint& end_time,
+                           int thread_id,
+                           std::unordered_map<std::string, std::string> event_args) {
+  long long dur = TimeDiffMicroSeconds(start_time, end_time);
   long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
 
   EventRecord event(category, logging::GetProcessId(),
-                    logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
+                    thread_id, event_name, ts, dur, std::move(event_args));
   if (profile_with_logger_) {
     custom_logger_->SendProfileEvent(event);
   } else {
-    //TODO: sync_gpu if needed.
     std::lock_guard<OrtMutex> lock(mutex_);
     if (events_.size() < max_num_events_) {
       events_.emplace_back(event);
@@ -85,6 +99,55 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
   }
 }
 
+void Profiler::EnableNodeStats(size_t num_nodes) {
+  node_stats_ = onnxruntime::make_unique<NodeStatsCounters[]>(num_nodes);
+  num_node_stats_ = num_nodes;
+}
+
+void Profiler::RecordNodeStats(size_t node_index, const TimePoint& start_time, size_t output_bytes,
+                               uint64_t num_shards) {
+  if (node_index >= num_node_stats_) {
+    return;
+  }
+
+  const int64_t duration_ns =
+      duration_cast<nanoseconds>(high_resolution_clock::now() - start_time).count();
+
+  // Runs on several threads update the same counters, so accumulate with relaxed atomics instead of a lock.
+  NodeStatsCounters& stats = node_stats_[node_index];
+  stats.count.fetch_add(1, std::memory_order_relaxed);
+  stats.total_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+  stats.output_bytes.fetch_add(output_bytes, std::memory_order_relaxed);
+  stats.num_shards.fetch_add(num_shards, std::memory_order_relaxed);
+
+  int64_t min_ns = stats.min_ns.load(std::memory_order_relaxed);
+  while (duration_ns < min_ns &&
+         !stats.min_ns.compare_exchange_weak(min_ns, duration_ns, std::memory_order_relaxed)) {
+  }
+  int64_t max_ns = stats.max_ns.load(std::memory_order_relaxed);
+  while (duration_ns > max_ns &&
+         !stats.max_ns.compare_exchange_weak(max_ns, duration_ns, std::memory_order_relaxed)) {
+  }
+}
+
+std::vector<Profiler::NodeStats> Profiler::GetNodeStats() const {
+  std::vector<NodeStats> node_stats(num_node_stats_);
+  for (size_t i = 0; i < num_node_stats_; ++i) {
+    const NodeStatsCounters& counters = node_stats_[i];
+    NodeStats& stats = node_stats[i];
+    stats.count = counters.count.load(std::memory_order_relaxed);
+    if (stats.count == 0) {
+      continue;
+    }
+    stats.total_ns = counters.total_ns.load(std::memory_order_relaxed);
+    stats.min_ns = counters.min_ns.load(std::memory_order_relaxed);
+    stats.max_ns = counters.max_ns.load(std::memory_order_relaxed);
+    stats.output_bytes = counters.output_bytes.load(std::memory_order_relaxed);
+    stats.num_shards = counters.num_shards.load(std::memory_order_relaxed);
+  }
+  return node_stats;
+}
+
 std::string Profiler::EndProfiling() {
   if (!enabled_) {
     return std::string();
@@ -101,8 +164,28 @@ std::string Profiler::EndProfiling() {
   std::lock_guard<OrtMutex> lock(mutex_);
   profile_stream_ << "[\n";
 
+  // the memory in use on each location over time, from the lifetimes of the tensors
+  std::map<std::string, std::vector<std::pair<long long, long long>>> memory_changes;
+  int memory_pid = 0;
+  for (const auto& rec : events_) {
+    if (rec.cat != MEMORY_EVENT) {
+      continue;
+    }
+    auto location = rec.args.find("location");
+    auto size = rec.args.find("size");
+    if (location == rec.args.end() || size == rec.args.end()) {
+      continue;
+    }
+    const long long bytes = std::stoll(size->second);
+    auto& changes = memory_changes[location->second];
+    changes.emplace_back(rec.ts, bytes);
+    changes.emplace_back(rec.ts + rec.dur, -bytes);
+    memory_pid = rec.pid;
+  }
+
   for (size_t i = 0; i < events_.size(); ++i) {
     auto& rec = events_[i];
+    if (i > 0) profile_stream_ << ",\n";
     profile_stream_ << R"({"cat" : ")" << event_categor_names_[rec.cat] << "\",";
     profile_stream_ << "\"pid\" :" << rec.pid << ",";
     profile_stream_ << "\"tid\" :" << rec.tid << ",";
@@ -117,13 +200,33 @@ std::string Profiler::EndProfiling() {
       profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
       is_first_arg = false;
     }
-    profile_stream_ << "}";
-    if (i == events_.size() - 1) {
-      profile_stream_ << "}\n";
-    } else {
-      profile_stream_ << "},\n";
+    profile_stream_ << "}}";
+  }
+
+  // write them as counter events, which chrome://tracing draws as a graph per location
+  bool is_first_event = events_.empty();
+  for (auto& location_changes : memory_changes) {
+    auto& changes = location_changes.second;
+    // at the same time stamp, apply the releases before the allocations
+    std::sort(changes.begin(), changes.end());
+    long long bytes_in_use = 0;
+    for (size_t i = 0; i < changes.size(); ++i) {
+      bytes_in_use += changes[i].second;
+      if (i + 1 < changes.size() && changes[i + 1].first == changes[i].first) {
+        continue;
+      }
+      if (!is_first_event) profile_stream_ << ",\n";
+      is_first_event = false;
+      profile_stream_ << R"({"cat" : "Memory",)";
+      profile_stream_ << "\"pid\" :" << memory_pid << ",";
+      profile_stream_ << "\"tid\" :0,";
+      profile_stream_ << "\"ts\" :" << changes[i].first << ",";
+      profile_stream_ << R"("ph" : "C",)";
+      profile_stream_ << R"("name" :")" << location_changes.first << " memory\",";
+      profile_stream_ << "\"args\" : {\"bytes_in_use\" : " << bytes_in_use << "}}";
     }
   }
+  if (!is_first_event) profile_stream_ << "\n";
   profile_stream_ << "]\n";
   profile_stream_.close();
   enabled_ = false;  // will not collect profile after writing.
@@ -7,7 +7,11 @@
 #include <fstream>
 #include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include "core/common/logging/logging.h"
 #include "core/platform/ort_mutex.h"
@@ -70,6 +74,51 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  /*
+  Record a single event that ran from start_time to end_time on the given thread, which need not be the
+  calling one.
+  */
+  void RecordEvent(EventCategory category,
+                   const std::string& event_name,
+                   const TimePoint& start_time,
+                   const TimePoint& end_time,
+                   int thread_id,
+                   std::unordered_map<std::string, std::string> event_args = {});
+
+  /*
+  Aggregated statistics of a node over all the runs it was executed in.
+  */
+  struct NodeStats {
+    uint64_t count = 0;         // number of times the node was executed
+    int64_t total_ns = 0;       // total time spent in the kernel
+    int64_t min_ns = 0;         // shortest time spent in the kernel
+    int64_t max_ns = 0;         // longest time spent in the kernel
+    uint64_t output_bytes = 0;  // total size of the output tensors produced by the kernel
+    uint64_t num_shards = 0;    // total number of work items the kernel handed to the thread pools
+  };
+
+  /*
+  Start collecting NodeStats for the nodes with an index below num_nodes. Unlike the events, these are
+  aggregated in place with atomic counters, so they are cheap enough to collect on every run of a
+  production session, and there is no limit on the number of runs.
+  Must be called before the session runs.
+  */
+  void EnableNodeStats(size_t num_nodes);
+
+  bool IsNodeStatsEnabled() const {
+    return node_stats_ != nullptr;
+  }
+
+  /*
+  Add one execution of the node, timed from start_time, to its NodeStats.
+  */
+  void RecordNodeStats(size_t node_index, const TimePoint& start_time, size_t output_bytes, uint64_t num_shards);
+
+  /*
+  Get the NodeStats of every node, indexed by node index. May be called while the session runs.
+  */
+  std::vector<NodeStats> GetNodeStats() const;
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -123,6 +172,18 @@ class Profiler {
   bool profile_with_logger_{false};
   const size_t max_num_events_{global_max_num_events_.load()};
 
+  struct NodeStatsCounters {
+    std::atomic<uint64_t> count{0};
+    std::atomic<int64_t> total_ns{0};
+    std::atomic<int64_t> min_ns{std::numeric_limits<int64_t>::max()};
+    std::atomic<int64_t> max_ns{0};
+    std::atomic<uint64_t> output_bytes{0};
+    std::atomic<uint64_t> num_shards{0};
+  };
+
+  std::unique_ptr<NodeStatsCounters[]> node_stats_;
+  size_t num_node_stats_{0};
+
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
   static Profiler* instance_;
 #endif
@@ -13,11 +13,14 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
 #include "core/common/eigen_common_wrapper.h"
+#include "core/common/parallel_for_cost_table.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
 
@@ -127,11 +130,12 @@ private:
 #endif
 
 ThreadPool::ThreadPool(Env* env, const ThreadOptions& thread_options, const NAME_CHAR_TYPE* name, int num_threads,
-                       bool low_latency_hint)
+                       bool low_latency_hint, bool adaptive_spinning)
     : thread_options_(thread_options) {
   ORT_ENFORCE(num_threads >= 1);
   extended_eigen_threadpool_ =
-      onnxruntime::make_unique<ThreadPoolTempl<Env>>(name, num_threads, low_latency_hint, *env, thread_options_);
+      onnxruntime::make_unique<ThreadPoolTempl<Env>>(name, num_threads, low_latency_hint, *env, thread_options_,
+                                                     adaptive_spinning);
   underlying_threadpool_ = extended_eigen_threadpool_.get();
 }
 
@@ -187,11 +191,57 @@ void ThreadPool::Schedule(std::function<void()> fn) {
   underlying_threadpool_->Schedule(std::move(fn));
 }
 
+namespace {
+// The innermost parallel section of the current thread; sections for other pools are linked through prev_section_.
+thread_local ThreadPool::ParallelSection* current_parallel_section = nullptr;
+
+// The number of work items the current thread has passed to RunInParallel.
+thread_local uint64_t num_work_items_scheduled = 0;
+}  // namespace
+
+ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
+#ifdef _OPENMP
+  ORT_UNUSED_PARAMETER(tp);
+#else
+  if (tp == nullptr) {
+    return;
+  }
+  for (auto* section = current_parallel_section; section != nullptr; section = section->prev_section_) {
+    if (section->tp_ == tp) {
+      return;
+    }
+  }
+  tp_ = tp;
+  ps_ = onnxruntime::make_unique<ThreadPoolParallelSection>();
+  tp_->extended_eigen_threadpool_->StartParallelSection(*ps_);
+  prev_section_ = current_parallel_section;
+  current_parallel_section = this;
+#endif
+}
+
+ThreadPool::ParallelSection::~ParallelSection() {
+  if (ps_ != nullptr) {
+    current_parallel_section = prev_section_;
+    tp_->extended_eigen_threadpool_->EndParallelSection(*ps_);
+  }
+}
+
 void ThreadPool::RunInParallel(std::function<void()> fn, int n) {
   ORT_ENFORCE(fn != nullptr);
+  num_work_items_scheduled += static_cast<uint64_t>(n);
+  for (auto* section = current_parallel_section; section != nullptr; section = section->prev_section_) {
+    if (section->tp_ == this) {
+      extended_eigen_threadpool_->RunInParallelSection(*section->ps_, std::move(fn), n);
+      return;
+    }
+  }
   underlying_threadpool_->RunInParallel(std::move(fn), n);
 }
 
+uint64_t ThreadPool::NumWorkItemsScheduledByCurrentThread() {
+  return num_work_items_scheduled;
+}
+
 bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
                                        const std::ptrdiff_t block_size) const {
   // Do not parallelize trivial loops, with only a single block of work
@@ -240,18 +290,32 @@ void ThreadPool::ParallelFor(std::ptrdiff_t total, const SchedulingParams& sched
 
 using CostModel = Eigen::TensorCostModel<Eigen::ThreadPoolDevice>;
 
+// Eigen's cost model counts cycles, while the calibrated costs are measured in nanoseconds. Loops with a calibrated
+// cost are sized with the same model, using its constants converted to nanoseconds at a nominal 3 GHz.
+static constexpr double kParallelForStartupNs = 100000 / 3.0;
+static constexpr double kParallelForPerThreadNs = 100000 / 3.0;
+static constexpr double kParallelForTaskNs = 40000 / 3.0;
+
+// Returns the number of threads worth using for a loop of n elements of ns_per_element nanoseconds each, like
+// CostModel::numThreads does for a cost in cycles.
+static int CalibratedNumThreads(const ptrdiff_t n, const double ns_per_element, int max_threads) {
+  const double total_ns = static_cast<double>(n) * ns_per_element;
+  const double threads = (total_ns - kParallelForStartupNs) / kParallelForPerThreadNs + 0.9;
+  return static_cast<int>(Eigen::numext::mini<double>(max_threads, Eigen::numext::maxi<double>(1, threads)));
+}
+
 // Calculates block size based on (1) the iteration cost and (2) parallel
 // efficiency. We want blocks to be not too small to mitigate parallelization
 // overheads; not too large to mitigate tail effect and potential load
 // imbalance and we also want number of blocks to be evenly dividable across
-// threads.
-static ptrdiff_t CalculateParallelForBlock(const ptrdiff_t n, const Eigen::TensorOpCost& cost,
+// threads. block_size_f is the number of iterations that make up a task worth scheduling.
+static ptrdiff_t CalculateParallelForBlock(const ptrdiff_t n, const double block_size_f,
                                            std::function<ptrdiff_t(ptrdiff_t)> block_align, int num_threads) {
-  const double block_size_f = 1.0 / CostModel::taskSize(1, cost);
   const ptrdiff_t max_oversharding_factor = 4;
   ptrdiff_t block_size = Eigen::numext::mini(
       n,
-      Eigen::numext::maxi<ptrdiff_t>(Eigen::divup<ptrdiff_t>(n, max_oversharding_factor * num_threads), static_cast<ptrdiff_t>(block_size_f)));
+      Eigen::numext::maxi<ptrdiff_t>(Eigen::divup<ptrdiff_t>(n, max_oversharding_factor * num_threads),
+                                     static_cast<ptrdiff_t>(Eigen::numext::mini<double>(static_cast<double>(n), block_size_f))));
   const ptrdiff_t max_block_size = Eigen::numext::mini(n, 2 * block_size);
 
   if (block_align) {
@@ -304,15 +368,45 @@ void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
   ORT_ENFORCE(n >= 0);
   Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
-  // Compute small problems directly in the caller thread.
-  if ((!ShouldParallelizeLoop(n)) ||
-      Eigen::TensorCostModel<Eigen::ThreadPoolDevice>::numThreads(static_cast<double>(n), cost, static_cast<int>(NumThreads())) == 1) {
-    f(0, n);
+  const std::string* op_type = cost_table_ ? ParallelForCostTable::CurrentOpType() : nullptr;
+  // The measured time covers the memory accesses too, so it replaces the whole estimate.
+  double ns_per_element = 0;
+  const bool calibrated = op_type != nullptr && cost_table_->Lookup(*op_type, n, ns_per_element);
+
+  auto run = [&](const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn) {
+    int num_threads;
+    double block_size_f;
+    if (calibrated) {
+      num_threads = CalibratedNumThreads(n, ns_per_element, NumThreads());
+      block_size_f = ns_per_element > 0 ? kParallelForTaskNs / ns_per_element : static_cast<double>(n);
+    } else {
+      num_threads = CostModel::numThreads(static_cast<double>(n), cost, static_cast<int>(NumThreads()));
+      block_size_f = 1.0 / CostModel::taskSize(1, cost);
+    }
+
+    // Compute small problems directly in the caller thread.
+    if ((!ShouldParallelizeLoop(n)) || num_threads == 1) {
+      fn(0, n);
+      return;
+    }
+
+    ptrdiff_t block = CalculateParallelForBlock(n, block_size_f, nullptr, NumThreads());
+    ParallelForFixedBlockSizeScheduling(n, block, fn);
+  };
+
+  if (op_type == nullptr || !calibrate_cost_) {
+    run(f);
     return;
   }
 
-  ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, NumThreads());
-  ParallelForFixedBlockSizeScheduling(n, block, f);
+  // Sum the time spent in the shards, so that the cost per element doesn't depend on how the loop was split.
+  std::atomic<int64_t> total_ns{0};
+  run([&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    const auto start = std::chrono::steady_clock::now();
+    f(first, last);
+    total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  });
+  cost_table_->Record(*op_type, n, static_cast<double>(total_ns.load()));
 }
 
 void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
@@ -339,5 +433,39 @@ int ThreadPool::CurrentThreadId() const {
   return underlying_threadpool_->CurrentThreadId();
 }
 
+void ThreadPool::SetCostTable(std::shared_ptr<ParallelForCostTable> cost_table, bool calibrate) {
+  cost_table_ = std::move(cost_table);
+  calibrate_cost_ = cost_table_ != nullptr && calibrate;
+}
+
+ThreadPoolSpinStats ThreadPool::GetSpinStats() const {
+  ThreadPoolSpinStats stats;
+  if (extended_eigen_threadpool_) {
+    extended_eigen_threadpool_->GetSpinStats(&stats.num_spins, &stats.num_parks, &stats.num_wakeups,
+                                             &stats.spin_budget);
+  }
+  return stats;
+}
+
+void ThreadPool::SetProfiling(bool enabled) {
+  if (extended_eigen_threadpool_) {
+    extended_eigen_threadpool_->SetProfiling(enabled);
+  }
+}
+
+std::vector<ThreadPoolWorkerStats> ThreadPool::GetWorkerStats() const {
+  std::vector<ThreadPoolWorkerStats> stats;
+  if (extended_eigen_threadpool_) {
+    extended_eigen_threadpool_->GetWorkerStats(stats);
+  }
+  return stats;
+}
+
+void ThreadPool::TakeTraceEvents(std::vector<ThreadPoolTraceEvent>& events) {
+  if (extended_eigen_threadpool_) {
+    extended_eigen_threadpool_->TakeTraceEvents(events);
+  }
+}
+
 }  // namespace concurrency
 }  // namespace onnxruntime
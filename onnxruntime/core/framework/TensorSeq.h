@@ -3,13 +3,18 @@
 
 #pragma once
 
+#include "core/framework/ml_value.h"
 #include "core/framework/tensor.h"
+#include <iterator>
 #include <vector>
 #include <utility>
 
 namespace onnxruntime {
 // Put this in a separate file to avoid circular dependency between tensor.h and data_types.h
 // Data type to represent a sequence of tensors of the same type
+// The tensors are held in OrtValues and are immutable once added, so sequences derived from one another (e.g. by
+// SequenceInsert or SequenceErase) share the tensors instead of copying them. A tensor that needs to change must be
+// copied into a new tensor.
 class TensorSeq {
  public:
   TensorSeq() = default;
@@ -17,19 +22,54 @@ class TensorSeq {
     SetType(elem_type);
   }
 
-  using const_iterator = std::vector<Tensor>::const_iterator;
+  // Iterates over the tensors of the sequence
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Tensor;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Tensor*;
+    using reference = const Tensor&;
+
+    explicit const_iterator(std::vector<OrtValue>::const_iterator it) noexcept : it_(it) {}
+
+    reference operator*() const { return it_->Get<Tensor>(); }
+    pointer operator->() const { return &it_->Get<Tensor>(); }
+
+    const_iterator& operator++() noexcept {
+      ++it_;
+      return *this;
+    }
+
+    bool operator==(const const_iterator& o) const noexcept { return it_ == o.it_; }
+    bool operator!=(const const_iterator& o) const noexcept { return it_ != o.it_; }
+
+   private:
+    std::vector<OrtValue>::const_iterator it_;
+  };
 
   // Sets the element type after construction.
   // Expects sequence to be empty at the time.
   void SetType(MLDataType elem_type) {
-    assert(tensors_.empty());
+    assert(values_.empty());
     elem_type_ = elem_type->AsPrimitiveDataType();
     ORT_ENFORCE(elem_type_ != nullptr, "Tensor sequence must contain only primitive types");
   }
 
   void SetElements(std::vector<Tensor>&& tensors) {
-    assert(tensors_.empty());
-    tensors_ = std::move(tensors);
+    assert(values_.empty());
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    values_.resize(tensors.size());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      values_[i].Init(new Tensor(std::move(tensors[i])), ml_tensor, ml_tensor->GetDeleteFunc());
+    }
+  }
+
+  // Sets the elements from OrtValues holding tensors, which may be shared with other sequences.
+  // The tensors must own their buffers, as the sequence may outlive the buffers borrowed by a tensor.
+  void SetElements(std::vector<OrtValue>&& values) {
+    assert(values_.empty());
+    values_ = std::move(values);
   }
 
   MLDataType DataType() const noexcept { return elem_type_; }
@@ -42,21 +82,27 @@ class TensorSeq {
     return elem_type_ == o.DataType()->AsPrimitiveDataType();
   }
 
-  size_t Size() const noexcept { return tensors_.size(); }
+  size_t Size() const noexcept { return values_.size(); }
 
   // Suitable for for range loop
   const_iterator begin() const noexcept {
-    return tensors_.cbegin();
+    return const_iterator(values_.cbegin());
   }
 
   const_iterator end() const noexcept {
-    return tensors_.cend();
+    return const_iterator(values_.cend());
   }
 
   // Get by index
   const Tensor& Get(size_t i) const {
-    ORT_ENFORCE(i < tensors_.size());
-    return tensors_[i];
+    ORT_ENFORCE(i < values_.size());
+    return values_[i].Get<Tensor>();
+  }
+
+  // Get the OrtValue holding the tensor at the index, to share the tensor with another sequence
+  const OrtValue& GetValue(size_t i) const {
+    ORT_ENFORCE(i < values_.size());
+    return values_[i];
   }
 
  private:
@@ -69,7 +115,7 @@ class TensorSeq {
 
   // TODO: optimization opportunity - if all tensors in the seq are scalars, we can potentially represent them
   // as vector<primitive type>
-  std::vector<Tensor> tensors_;
+  std::vector<OrtValue> values_;
 };
 
 }  // namespace onnxruntime
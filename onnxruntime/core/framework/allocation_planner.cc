@@ -3,6 +3,7 @@
 
 #include "core/framework/allocation_planner.h"
 #include <list>
+#include <set>
 #include <unordered_map>
 #include <algorithm>
 #include <sstream>
@@ -40,6 +41,9 @@ std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind) {
     case AllocKind::kShare:
       out << "Share";
       break;
+    case AllocKind::kAllocateOrView:
+      out << "AllocateOrView";
+      break;
   }
   return out;
 }
@@ -62,7 +66,12 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
     if (0 <= index && static_cast<size_t>(index) < plan_size) {
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
-      if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.alloc_kind == AllocKind::kReuse) {
+        out << " " << elt_plan.reused_buffer;
+        if (elt_plan.inplace_reuse) out << " (in-place)";
+      } else if (elt_plan.alloc_kind == AllocKind::kAllocateOrView) {
+        out << " " << elt_plan.reused_buffer;
+      }
 
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
@@ -97,6 +106,8 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
     }
   }
 
+  out << "\nEstimated peak memory: " << plan.estimated_peak_memory_bytes << " bytes" << std::endl;
+
   return out;
 }
 
@@ -153,6 +164,9 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // the OrtValues planned as possible views whose buffers are still in use
+  std::list<OrtValueIndex> views_;
+
   OrtValueIndex Index(const OrtValueName& name) {
     OrtValueIndex result;
     auto status = ort_value_name_idx_map_.GetIdx(name, result);
@@ -200,7 +214,47 @@ class PlannerImpl {
     // update allocation plan (for use at execution-time)
     auto& symplan = AllocPlan(reused_for);
     symplan.alloc_kind = alloc_kind;
-    symplan.reused_buffer = original;
+    symplan.reused_buffer = RuntimeBuffer(reused);
+  }
+
+  // The OrtValue whose tensor holds the memory of an OrtValue at execution-time. This is the original buffer, unless
+  // the OrtValue may be a view of it: a view starts at an offset into the buffer, so it is its own runtime buffer.
+  OrtValueIndex RuntimeBuffer(OrtValueIndex n) {
+    const auto& plan = AllocPlan(n);
+    if (plan.alloc_kind == AllocKind::kReuse) return plan.reused_buffer;
+    if (plan.alloc_kind == AllocKind::kAllocateOrView) return n;
+    return Buffer(n);
+  }
+
+  // Let viewer be a view of the buffer of the input viewed: the kernel decides at execution-time whether to create a
+  // view or allocate, so the buffer must live as long as either of them.
+  void View(OrtValueIndex viewed, OrtValueIndex viewer) {
+    auto& symplan = AllocPlan(viewer);
+    symplan.alloc_kind = AllocKind::kAllocateOrView;
+    symplan.reused_buffer = viewed;
+
+    // graph inputs and weights already outlive the views of them
+    OrtValueIndex original = Buffer(viewed);
+    const auto original_kind = AllocPlan(original).alloc_kind;
+    if (original_kind == AllocKind::kPreExisting || original_kind == AllocKind::kAllocateStatically) return;
+
+    Buffer(viewer) = original;
+    UseCount(original) += UseCount(viewer);
+    views_.push_back(viewer);
+  }
+
+  // Adds a buffer no longer used after the given step to the freelist, with the views of the buffer, which are freed
+  // at the same time since they might have allocated their own buffers.
+  void FreeBuffer(OrtValueIndex original, size_t program_counter) {
+    freelist_.push_front(FreeBufferInfo(original, program_counter));
+    for (auto it = views_.begin(); it != views_.end();) {
+      if (Buffer(*it) == original) {
+        freelist_.push_front(FreeBufferInfo(*it, program_counter));
+        it = views_.erase(it);
+      } else {
+        ++it;
+      }
+    }
   }
 
   // Find if there exists some input tensor that we can use in-place for output_arg_num-th input in the node.
@@ -235,7 +289,8 @@ class PlannerImpl {
           if (p_input_arg->Exists()) {
             auto input_arg_index = Index(p_input_arg->Name());
             auto original = Buffer(input_arg_index);
-            if (1 == UseCount(original)) {
+            // a view planned as its own buffer views a graph input or weight, which must not be updated
+            if (1 == UseCount(original) && AllocPlan(original).alloc_kind != AllocKind::kAllocateOrView) {
               if (SameSize(*p_input_arg, *p_output_arg)) {
                 // we can reuse this input since it is its last use and permitted for in-place update
                 *reusable_input = input_arg_index;  // or original; both should be okay
@@ -249,27 +304,59 @@ class PlannerImpl {
     return false;
   }
 
-  static bool SameShape(const TensorShapeProto& shape1, const TensorShapeProto& shape2) {
-    // TODO: This should probably be defined to be the equality operator on TensorShapeProto.
-    namespace on = ONNX_NAMESPACE;
-    int rank1 = shape1.dim_size();
-    if (shape2.dim_size() != rank1) return false;
-    for (int i = 0; i < rank1; i++) {
-      const auto& val1 = shape1.dim(i);
-      const auto& val2 = shape2.dim(i);
-      if (utils::HasDimValue(val1) && utils::HasDimValue(val2) &&
-          (val1.dim_value() == val2.dim_value()))
-        continue;  // same known dimension
-      if (utils::HasDimParam(val1) && utils::HasDimParam(val2)) {
-        const auto& val1_param = val1.dim_param();
-        if (val1_param == val2.dim_param() && !val1_param.empty())
-          continue;  // same unknown dimension
-      }
+  // Find if the output_arg_num-th output of the node may be a view of one of its inputs.
+  bool FindViewableInput(const onnxruntime::Node& node, int output_arg_num, OrtValueIndex* viewable_input) {
+    const KernelCreateInfo* ci;
+    Status st = kernel_registry_.SearchKernelRegistry(node, &ci);
+    if (!st.IsOK() || ci == nullptr || ci->kernel_def == nullptr) {
       return false;
     }
+
+    auto input_args = node.InputDefs();
+    for (auto pair : ci->kernel_def->MayView()) {
+      // an output index of -1 means all the outputs may be views
+      if ((pair.second == output_arg_num || pair.second == -1) &&
+          (0 <= pair.first) && (static_cast<size_t>(pair.first) < input_args.size())) {
+        auto p_input_arg = input_args[pair.first];
+        if (p_input_arg->Exists() && !IsNonTensor(*p_input_arg)) {
+          *viewable_input = Index(p_input_arg->Name());
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /*! \brief Split a shape into the product of its known dimensions and the sorted list of its symbolic dimensions.
+  Returns false if the shape has a dimension that is neither a known value nor a named symbol.
+  */
+  static bool GetSymbolicSize(const TensorShapeProto& shape, int64_t& known_size, std::vector<std::string>& symbols) {
+    known_size = 1;
+    symbols.clear();
+    for (const auto& dim : shape.dim()) {
+      if (utils::HasDimValue(dim) && dim.dim_value() >= 0) {
+        known_size *= dim.dim_value();
+      } else if (utils::HasDimParam(dim) && !dim.dim_param().empty()) {
+        symbols.push_back(dim.dim_param());
+      } else {
+        return false;
+      }
+    }
+    std::sort(symbols.begin(), symbols.end());
     return true;
   }
 
+  // Two shapes provably have the same number of elements if the products of their known dimensions are equal and
+  // the same symbols appear the same number of times in both, e.g. {"batch", "seq", 768} and {"seq", 768, "batch"}.
+  // The ranks and the order of dimensions are irrelevant since a reused buffer only needs to hold the elements.
+  static bool SameNumElements(const TensorShapeProto& shape1, const TensorShapeProto& shape2) {
+    int64_t known_size1, known_size2;
+    std::vector<std::string> symbols1, symbols2;
+    if (!GetSymbolicSize(shape1, known_size1, symbols1) || !GetSymbolicSize(shape2, known_size2, symbols2))
+      return false;
+    return known_size1 == known_size2 && symbols1 == symbols2;
+  }
+
   /*! \brief Given a tensor-type, return the size of an element of the tensor.
   */
   static size_t GetElementSize(const DataType& tensor_type) {
@@ -295,20 +382,9 @@ class PlannerImpl {
     // If either of the tensors is a string, don't treat them the same. Moreover, reusing a string tensor for a string
     // tensor without releasing the previous memory can cause memory leaks; hence we don't allow reuse across string
     // tensors as well.
-    return !(is_type1_string || is_type2_string) && (type1_size == type2_size) && SameShape(shape1, shape2);
-
-    /* TODO: we can improve this if the concrete shapes are known for both as below.
-       Unclear whether this is worthwhile though.
-    if (KnownSize(p_shape1) && KnownSize(p_shape2)) {
-      // Comparison of statically-known size
-      auto size1 = NumElements(p_shape1) * EltSize(ptype1);
-      auto size2 = NumElements(p_shape2) * EltSize(ptype2);
-      return size1 == size2;
-    } else {
-      // Comparison of statically-unknown size buffers
-      return SameElementSize(ptype1, ptype2) && SameShape(shape1, shape2);
-    }
-    */
+    //
+    // The element sizes must match as well: the execution frame validates a reused buffer by its element count.
+    return !(is_type1_string || is_type2_string) && (type1_size == type2_size) && SameNumElements(shape1, shape2);
   }
 
   bool SameSize(const onnxruntime::NodeArg& arg1, const onnxruntime::NodeArg& arg2) {
@@ -329,6 +405,8 @@ class PlannerImpl {
 
     for (auto it = freelist_.begin(); it != freelist_.end(); ++it) {
       size_t reusable = static_cast<size_t>(it->ml_value);
+      // a view doesn't own the memory it may use, which is freed with the buffer it views
+      if (AllocPlan(it->ml_value).alloc_kind == AllocKind::kAllocateOrView) continue;
       const onnxruntime::NodeArg* p_node_arg = ort_value_info_.at(reusable).p_def_site;
       if (!p_node_arg) {
         // TODO this should be an error case, needs more investigation
@@ -598,6 +676,10 @@ class PlannerImpl {
         } else if (FindReusableInput(*pnode, static_cast<int>(output_arg_def_index), &reused)) {
           // Reuse one of this node's input buffers as the output buffer (for in-place update)
           Reuse(reused, current, AllocKind::kReuse);
+          AllocPlan(current).inplace_reuse = true;
+        } else if (FindViewableInput(*pnode, static_cast<int>(output_arg_def_index), &reused)) {
+          // The output may be a view of one of this node's inputs (e.g., for a contiguous slice)
+          View(reused, current);
         } else if (!context_.IsParallelExecutionEnabled() &&
                    FindReusableTensor(*node_output, &reused)) {
           // Reuse an available (dead) buffer for this output, this is only for sequential execution.
@@ -614,7 +696,7 @@ class PlannerImpl {
           auto& sym = node_input->Name();
           auto original = Buffer(Index(sym));
           if (0 == --UseCount(original))
-            freelist_.push_front(FreeBufferInfo(original, program_counter));
+            FreeBuffer(original, program_counter);
         }
       }
 
@@ -623,7 +705,7 @@ class PlannerImpl {
           auto& sym = node_input->Name();
           auto original = Buffer(Index(sym));
           if (0 == --UseCount(original))
-            freelist_.push_front(FreeBufferInfo(original, program_counter));
+            FreeBuffer(original, program_counter);
         }
       }
 
@@ -633,7 +715,7 @@ class PlannerImpl {
           auto& sym = node_output->Name();
           auto original = Buffer(Index(sym));
           if (0 == --UseCount(original))
-            freelist_.push_front(FreeBufferInfo(original, program_counter));
+            FreeBuffer(original, program_counter);
         }
       }
     }
@@ -683,6 +765,219 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // Number of elements of a tensor counting the symbolic and unknown dimensions as 1, or 0 if the shape is unknown.
+  int64_t KnownNumElements(const onnxruntime::NodeArg* arg) {
+    const auto* shape = arg->Exists() ? context_.GetShape(*arg) : nullptr;
+    if (shape == nullptr) return 0;
+    int64_t size = 1;
+    for (const auto& dim : shape->dim()) {
+      if (utils::HasDimValue(dim) && dim.dim_value() > 0) size *= dim.dim_value();
+    }
+    return size;
+  }
+
+  // Estimate the cost of a node from the statically known parts of its shapes: the number of output elements,
+  // scaled by the length of the reduction for the matrix multiplication and convolution ops.
+  int64_t EstimateNodeCost(const onnxruntime::Node& node) {
+    int64_t output_elements = 0;
+    for (const auto* output_def : node.OutputDefs()) {
+      output_elements += KnownNumElements(output_def);
+    }
+
+    int64_t reduction_size = 1;
+    const auto& op_type = node.OpType();
+    const auto& input_defs = node.InputDefs();
+    const auto* weight_shape = input_defs.size() > 1 && input_defs[1]->Exists() ? context_.GetShape(*input_defs[1])
+                                                                                : nullptr;
+    if (weight_shape != nullptr && weight_shape->dim_size() > 0) {
+      auto known_dim = [weight_shape](int i) -> int64_t {
+        const auto& dim = weight_shape->dim(i);
+        return utils::HasDimValue(dim) && dim.dim_value() > 0 ? dim.dim_value() : 1;
+      };
+      const int rank = weight_shape->dim_size();
+      if (op_type == "Conv" || op_type == "FusedConv" || op_type == "ConvTranspose") {
+        // each output element sums over the weights of one output channel
+        reduction_size = KnownNumElements(input_defs[1]) / known_dim(0);
+      } else if (op_type == "MatMul" || op_type == "FusedMatMul" || op_type == "MatMulInteger") {
+        reduction_size = known_dim(rank > 1 ? rank - 2 : 0);
+      } else if ((op_type == "Gemm" || op_type == "FusedGemm") && rank == 2) {
+        const auto& attrs = node.GetAttributes();
+        auto trans_b = attrs.find("transB");
+        reduction_size = known_dim(trans_b != attrs.end() && trans_b->second.i() != 0 ? 1 : 0);
+      }
+    }
+
+    return 1 + output_elements * reduction_size;
+  }
+
+  // Compute the critical-path priority of each node: its estimated cost plus the largest priority of its consumers.
+  void ComputeNodePriorities() {
+    plan_.node_priority.assign(graph_viewer_.MaxNodeIndex(), 0);
+    const auto& nodes = graph_viewer_.GetNodesInTopologicalOrder();
+    for (auto it = nodes.rbegin(), end = nodes.rend(); it != end; ++it) {
+      const auto* pnode = graph_viewer_.GetNode(*it);
+      if (pnode == nullptr) continue;
+
+      int64_t consumers_priority = 0;
+      for (auto edge = pnode->OutputEdgesBegin(), edge_end = pnode->OutputEdgesEnd(); edge != edge_end; ++edge) {
+        consumers_priority = std::max(consumers_priority, plan_.node_priority[edge->GetNode().Index()]);
+      }
+
+      plan_.node_priority[*it] = EstimateNodeCost(*pnode) + consumers_priority;
+    }
+  }
+
+  // Estimated size in bytes of a tensor, counting unknown and symbolic dimensions as 1. 0 if the shape is unknown.
+  int64_t EstimateTensorBytes(const onnxruntime::NodeArg& arg) const {
+    if (!arg.Exists() || IsNonTensor(arg)) return 0;
+    auto p_shape = context_.GetShape(arg);
+    if (nullptr == p_shape) return 0;
+    int64_t num_elements = 1;
+    for (const auto& dim : p_shape->dim()) {
+      if (utils::HasDimValue(dim) && dim.dim_value() >= 0) num_elements *= dim.dim_value();
+    }
+    return num_elements * static_cast<int64_t>(GetElementSize(arg.Type()));
+  }
+
+  // Sequence the nodes. By default this is the topological order of the graph viewer. With
+  // ExecutionOrder::MemoryAware, of the nodes whose inputs are ready, the one with the highest score runs first:
+  // the bytes of the intermediate values it is the last consumer of, minus the bytes of its outputs. Ties keep the
+  // default order. This runs the nodes releasing large buffers (e.g. the gradient nodes consuming the activations
+  // of a training graph) before the nodes allocating new ones.
+  void ComputeExecutionOrder() {
+    const auto& topological_order = graph_viewer_.GetNodesInTopologicalOrder();
+    if (context_.GetExecutionOrder() != ExecutionOrder::MemoryAware) {
+      for (auto n : topological_order) {
+        plan_.execution_plan.emplace_back(n);
+      }
+      return;
+    }
+
+    // graph inputs, initializers, outer scope values and graph outputs are alive during the whole run
+    std::unordered_set<std::string> never_freed;
+    for (auto graph_input : graph_viewer_.GetInputsIncludingInitializers()) never_freed.insert(graph_input->Name());
+    for (const auto& pair : graph_viewer_.GetAllInitializedTensors()) never_freed.insert(pair.first);
+    for (auto node_arg : outer_scope_node_args_) never_freed.insert(node_arg->Name());
+    for (auto graph_output : graph_viewer_.GetOutputs()) never_freed.insert(graph_output->Name());
+
+    const size_t not_in_order = topological_order.size();
+    std::vector<size_t> position(graph_viewer_.MaxNodeIndex(), not_in_order);
+    for (size_t i = 0; i < topological_order.size(); ++i) {
+      position[topological_order[i]] = i;
+    }
+
+    // the distinct (explicit or implicit) inputs of each node and the nodes still to consume each value
+    std::vector<std::vector<const onnxruntime::NodeArg*>> node_inputs(topological_order.size());
+    std::unordered_map<std::string, std::vector<onnxruntime::NodeIndex>> consumers;
+    std::vector<size_t> pending_edges(topological_order.size(), 0);
+    for (size_t i = 0; i < topological_order.size(); ++i) {
+      const auto* pnode = graph_viewer_.GetNode(topological_order[i]);
+      ORT_ENFORCE(pnode != nullptr);
+      auto add_input = [&](const onnxruntime::NodeArg* input) {
+        if (!input->Exists()) return;
+        auto& inputs = node_inputs[i];
+        if (std::find(inputs.begin(), inputs.end(), input) != inputs.end()) return;
+        inputs.push_back(input);
+        consumers[input->Name()].push_back(pnode->Index());
+      };
+      for (auto input : pnode->InputDefs()) add_input(input);
+      for (auto input : pnode->ImplicitInputDefs()) add_input(input);
+
+      for (auto edge = pnode->InputEdgesBegin(), end = pnode->InputEdgesEnd(); edge != end; ++edge) {
+        if (position[edge->GetNode().Index()] != not_in_order) ++pending_edges[i];
+      }
+    }
+
+    auto score = [&](size_t i) {
+      const auto* pnode = graph_viewer_.GetNode(topological_order[i]);
+      int64_t freed_bytes = 0;
+      for (auto input : node_inputs[i]) {
+        if (never_freed.find(input->Name()) == never_freed.end() && consumers[input->Name()].size() == 1)
+          freed_bytes += EstimateTensorBytes(*input);
+      }
+      for (auto output : pnode->OutputDefs()) {
+        freed_bytes -= EstimateTensorBytes(*output);
+      }
+      return freed_bytes;
+    };
+
+    // ready nodes ordered by decreasing score, then by position in the default order
+    std::set<std::pair<int64_t, size_t>> ready;
+    std::vector<int64_t> ready_key(topological_order.size(), 0);
+    std::vector<bool> is_ready(topological_order.size(), false);
+    auto make_ready = [&](size_t i) {
+      ready_key[i] = -score(i);
+      is_ready[i] = true;
+      ready.emplace(ready_key[i], i);
+    };
+    for (size_t i = 0; i < topological_order.size(); ++i) {
+      if (pending_edges[i] == 0) make_ready(i);
+    }
+
+    while (!ready.empty()) {
+      const size_t i = ready.begin()->second;
+      ready.erase(ready.begin());
+      is_ready[i] = false;
+      const auto* pnode = graph_viewer_.GetNode(topological_order[i]);
+      plan_.execution_plan.emplace_back(pnode->Index());
+
+      // a value with one consumer left is freed by it, which changes the score of that consumer if it is ready
+      for (auto input : node_inputs[i]) {
+        auto& value_consumers = consumers[input->Name()];
+        value_consumers.erase(std::find(value_consumers.begin(), value_consumers.end(), pnode->Index()));
+        if (value_consumers.size() == 1) {
+          size_t last = position[value_consumers.front()];
+          if (is_ready[last]) {
+            ready.erase(std::make_pair(ready_key[last], last));
+            make_ready(last);
+          }
+        }
+      }
+
+      for (auto edge = pnode->OutputEdgesBegin(), end = pnode->OutputEdgesEnd(); edge != end; ++edge) {
+        size_t consumer = position[edge->GetNode().Index()];
+        if (consumer != not_in_order && --pending_edges[consumer] == 0) make_ready(consumer);
+      }
+    }
+
+    ORT_ENFORCE(plan_.execution_plan.size() == topological_order.size(),
+                "Failed to sequence all the nodes of the graph.");
+  }
+
+  // Estimate the peak memory of a run from the allocation and deallocation plans: the buffers allocated for the
+  // outputs of each step are in use until the step freeing them. Views and in-place updates don't add to it, the
+  // reuse of a buffer freed by an earlier step does.
+  void ComputeEstimatedPeakMemory() {
+    std::vector<int64_t> allocated_bytes(plan_.allocation_plan.size(), 0);
+    int64_t in_use = 0;
+    int64_t peak = 0;
+    for (const auto& step : plan_.execution_plan) {
+      const auto* pnode = graph_viewer_.GetNode(step.node_index);
+      for (auto output : pnode->OutputDefs()) {
+        if (!output->Exists()) continue;
+        auto index = Index(output->Name());
+        auto alloc_kind = AllocPlan(index).alloc_kind;
+        if (alloc_kind == AllocKind::kReuse) {
+          index = Buffer(index);
+          alloc_kind = AllocPlan(index).alloc_kind;
+          if (allocated_bytes[index] != 0) continue;
+        }
+        if (alloc_kind == AllocKind::kAllocate || alloc_kind == AllocKind::kAllocateOutput) {
+          allocated_bytes[index] = EstimateTensorBytes(*output);
+          in_use += allocated_bytes[index];
+        }
+      }
+      peak = std::max(peak, in_use);
+
+      for (int i = step.free_from_index; i <= step.free_to_index; ++i) {
+        auto freed = plan_.to_be_freed[i];
+        in_use -= allocated_bytes[freed];
+        allocated_bytes[freed] = 0;
+      }
+    }
+    plan_.estimated_peak_memory_bytes = peak;
+  }
+
   // Convert information in a freelist (about which ml-value becomes free when) into
   // a deallocation plan in the format required in an ExecutionPlan
   void GenerateDeallocationPlan() {
@@ -728,11 +1023,8 @@ Status PlannerImpl::CreatePlan() {
 
   Initialize(p_graph_nodes.size(), static_cast<size_t>(num_ml_values));
 
-  // Determine execution order: we use the default topological sort order for now. We can later
-  // explore more efficient orderings (from a memory usage perspective).
-  for (auto n : p_graph_nodes) {
-    plan_.execution_plan.emplace_back(n);
-  }
+  // Determine execution order: the default topological sort order, or a memory-aware one
+  ComputeExecutionOrder();
 
   // compute use counts for all ml-values
   ORT_RETURN_IF_ERROR(ComputeUseCounts());
@@ -746,6 +1038,12 @@ Status PlannerImpl::CreatePlan() {
   // convert information in the freelist_ into a deallocation plan in required format
   GenerateDeallocationPlan();
 
+  // report the peak memory of the execution order
+  ComputeEstimatedPeakMemory();
+
+  // determine the order in which the parallel executor starts nodes that are ready at the same time
+  ComputeNodePriorities();
+
   return Status::OK();
 }
 
@@ -27,12 +27,14 @@ class ISequentialPlannerContext {
   // If it returns true, planner won't reuse output tensors
   // see PlannerImpl::ComputeReusePlan
   virtual bool IsParallelExecutionEnabled() const { return false; }
+  // The order in which the planner sequences the nodes, see PlannerImpl::ComputeExecutionOrder
+  virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::Default; }
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode)
-      : m_execution_mode(execution_mode) {
+  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order = ExecutionOrder::Default)
+      : m_execution_mode(execution_mode), m_execution_order(execution_order) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -41,8 +43,11 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool IsParallelExecutionEnabled() const override { return m_execution_mode == ExecutionMode::ORT_PARALLEL; }
 
+  ExecutionOrder GetExecutionOrder() const override { return m_execution_order; }
+
  private:
   ExecutionMode m_execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  ExecutionOrder m_execution_order = ExecutionOrder::Default;
 };
 
 class SequentialPlanner {
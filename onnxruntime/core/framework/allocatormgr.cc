@@ -22,7 +22,8 @@ AllocatorPtr CreateAllocator(const DeviceAllocatorRegistrationInfo& info,
         onnxruntime::make_unique<MiMallocArena>(std::move(device_allocator), info.max_mem));
 #else
     return std::shared_ptr<IArenaAllocator>(
-        onnxruntime::make_unique<BFCArena>(std::move(device_allocator), info.max_mem, info.arena_extend_strategy));
+        onnxruntime::make_unique<BFCArena>(std::move(device_allocator), info.max_mem, info.arena_extend_strategy,
+                                              info.thread_cache_max_chunk_size));
 #endif
   }
 
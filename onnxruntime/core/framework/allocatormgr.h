@@ -15,17 +15,21 @@ struct DeviceAllocatorRegistrationInfo {
   DeviceAllocatorRegistrationInfo(OrtMemType ort_mem_type,
                                   DeviceAllocatorFactory alloc_factory,
                                   size_t mem,
-                                  ArenaExtendStrategy strategy = ArenaExtendStrategy::kNextPowerOfTwo)
+                                  ArenaExtendStrategy strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+                                  size_t thread_cache_chunk_size = 0)
       : mem_type(ort_mem_type),
         factory(alloc_factory),
         max_mem(mem),
-        arena_extend_strategy(strategy) {
+        arena_extend_strategy(strategy),
+        thread_cache_max_chunk_size(thread_cache_chunk_size) {
   }
 
   OrtMemType mem_type;
   DeviceAllocatorFactory factory;
   size_t max_mem;
   ArenaExtendStrategy arena_extend_strategy;
+  // chunks up to this size are cached per thread by the arena. 0 disables the thread caches.
+  size_t thread_cache_max_chunk_size;
 };
 
 AllocatorPtr CreateAllocator(const DeviceAllocatorRegistrationInfo& info, OrtDevice::DeviceId device_id = 0,
@@ -9,29 +9,6 @@
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
-// The interface for arena which manage memory allocations
-// Arena will hold a pool of pre-allocate memories and manage their lifecycle.
-// Need an underline IResourceAllocator to allocate memories.
-// The setting like max_chunk_size is init by IDeviceDescriptor from resource allocator
-class IArenaAllocator : public IAllocator {
- public:
-  IArenaAllocator(const OrtMemoryInfo& info) : IAllocator(info) {}
-  ~IArenaAllocator() override = default;
-  // Alloc call need to be thread safe.
-  void* Alloc(size_t size) override = 0;
-  // The chunck allocated by Reserve call won't be reused with other request.
-  // It will be return to the devices when it is freed.
-  // Reserve call need to be thread safe.
-  virtual void* Reserve(size_t size) = 0;
-  // Free call need to be thread safe.
-  void Free(void* p) override = 0;
-  virtual size_t Used() const = 0;
-  virtual size_t Max() const = 0;
-  // allocate host pinned memory?
-};
-
-using ArenaPtr = std::shared_ptr<IArenaAllocator>;
-
 // Runtime statistics collected by an allocator.
 struct AllocatorStats {
   int64_t num_allocs;             // Number of allocations.
@@ -43,6 +20,9 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_thread_cache_hits;    // Allocations served from a thread cache without taking the arena lock.
+  int64_t num_thread_cache_misses;  // Allocations eligible for a thread cache that had to go to the arena.
+  int64_t thread_cache_bytes;       // Bytes parked in thread caches. These are included in bytes_in_use.
 
   AllocatorStats() { Clear(); }
 
@@ -53,6 +33,9 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_thread_cache_hits = 0;
+    this->num_thread_cache_misses = 0;
+    this->thread_cache_bytes = 0;
   }
 
   std::string DebugString() const {
@@ -62,8 +45,39 @@ struct AllocatorStats {
        << "TotalAllocated: " << this->total_allocated_bytes << "\n"
        << "MaxInUse:       " << this->max_bytes_in_use << "\n"
        << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "CacheHits:      " << this->num_thread_cache_hits << "\n"
+       << "CacheMisses:    " << this->num_thread_cache_misses << "\n"
+       << "CachedBytes:    " << this->thread_cache_bytes << "\n";
     return ss.str();
   }
 };
+
+// The interface for arena which manage memory allocations
+// Arena will hold a pool of pre-allocate memories and manage their lifecycle.
+// Need an underline IResourceAllocator to allocate memories.
+// The setting like max_chunk_size is init by IDeviceDescriptor from resource allocator
+class IArenaAllocator : public IAllocator {
+ public:
+  IArenaAllocator(const OrtMemoryInfo& info) : IAllocator(info) {}
+  ~IArenaAllocator() override = default;
+  // Alloc call need to be thread safe.
+  void* Alloc(size_t size) override = 0;
+  // The chunck allocated by Reserve call won't be reused with other request.
+  // It will be return to the devices when it is freed.
+  // Reserve call need to be thread safe.
+  virtual void* Reserve(size_t size) = 0;
+  // Free call need to be thread safe.
+  void Free(void* p) override = 0;
+  virtual size_t Used() const = 0;
+  virtual size_t Max() const = 0;
+  // Release memory that is not currently in use back to the underlying device allocator.
+  // Arenas that can't do this ignore the request.
+  virtual Status Shrink() { return Status::OK(); }
+  // Runtime statistics of the arena. Arenas that don't collect them report zeros.
+  virtual void GetStats(AllocatorStats* stats) { stats->Clear(); }
+  // allocate host pinned memory?
+};
+
+using ArenaPtr = std::shared_ptr<IArenaAllocator>;
 }  // namespace onnxruntime
@@ -4,9 +4,12 @@
 #include "core/framework/bfc_arena.h"
 
 namespace onnxruntime {
+constexpr size_t BFCArena::kDefaultThreadCacheMaxChunkSize;
+
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
                    size_t total_memory,
-                   ArenaExtendStrategy arena_extend_strategy)
+                   ArenaExtendStrategy arena_extend_strategy,
+                   size_t thread_cache_max_chunk_size)
     : IArenaAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                     OrtAllocatorType::OrtArenaAllocator,
                                     resource_allocator->Info().device,
@@ -44,6 +47,14 @@ BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_max_chunk_size > 0) {
+    // cached chunks are a whole size class so the limit can't go beyond the largest bin
+    thread_cache_max_chunk_size_ = std::min(RoundedBytes(thread_cache_max_chunk_size), BinNumToSize(kNumBins - 1));
+    thread_cache_shards_.reset(new ThreadCacheShard[kNumThreadCacheShards]);
+    cached_ptr_shards_.reset(new CachedPtrShard[kNumThreadCacheShards]);
+    LOGS_DEFAULT(VERBOSE) << "Enabling thread caches for chunks up to " << thread_cache_max_chunk_size_ << " bytes";
+  }
 }
 
 BFCArena::~BFCArena() {
@@ -205,9 +216,142 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (ThreadCacheEnabled() && size > 0 && size <= thread_cache_max_chunk_size_) {
+    return AllocateFromThreadCache(size);
+  }
+
   return AllocateRawInternal(size, false);
 }
 
+// Returns the smallest bin whose size can hold 'bytes'.
+BFCArena::BinNum BFCArena::ThreadCacheSizeClass(size_t bytes) {
+  size_t rounded_bytes = RoundedBytes(bytes);
+  BinNum size_class = BinNumForSize(rounded_bytes);
+  if (BinNumToSize(size_class) < rounded_bytes) {
+    ++size_class;
+  }
+
+  return size_class;
+}
+
+BFCArena::ThreadCacheShard& BFCArena::CurrentThreadCacheShard() {
+  // hand out shards round-robin so that up to kNumThreadCacheShards threads never share one
+  static std::atomic<size_t> next_shard{0};
+  static thread_local const size_t shard = next_shard++ % kNumThreadCacheShards;
+  return thread_cache_shards_[shard];
+}
+
+BFCArena::CachedPtrShard& BFCArena::CachedPtrShardFor(const void* p) {
+  std::uintptr_t p_int = reinterpret_cast<std::uintptr_t>(p) >> kMinAllocationBits;
+  return cached_ptr_shards_[(p_int ^ (p_int >> 8)) % kNumThreadCacheShards];
+}
+
+void* BFCArena::AllocateFromThreadCache(size_t num_bytes) {
+  const BinNum size_class = ThreadCacheSizeClass(num_bytes);
+  const size_t class_bytes = BinNumToSize(size_class);
+
+  {
+    ThreadCacheShard& shard = CurrentThreadCacheShard();
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    auto& free_chunks = shard.free_chunks[size_class];
+    if (!free_chunks.empty()) {
+      void* ptr = free_chunks.back();
+      free_chunks.pop_back();
+      shard.cached_bytes -= class_bytes;
+      ++thread_cache_hits_;
+      return ptr;
+    }
+  }
+
+  ++thread_cache_misses_;
+
+  void* ptr = nullptr;
+  try {
+    ptr = AllocateRawInternal(class_bytes, false);
+  } catch (const OnnxRuntimeException&) {
+    // memory parked in other threads' caches may be what is needed to satisfy this request
+    FlushThreadCaches();
+    ptr = AllocateRawInternal(class_bytes, false);
+  }
+
+  CachedPtrShard& ptr_shard = CachedPtrShardFor(ptr);
+  std::lock_guard<OrtMutex> lock(ptr_shard.mutex);
+  ptr_shard.size_classes[ptr] = size_class;
+  return ptr;
+}
+
+bool BFCArena::ReturnToThreadCache(void* p) {
+  BinNum size_class = kInvalidBinNum;
+  {
+    CachedPtrShard& ptr_shard = CachedPtrShardFor(p);
+    std::lock_guard<OrtMutex> lock(ptr_shard.mutex);
+    auto entry = ptr_shard.size_classes.find(p);
+    if (entry == ptr_shard.size_classes.end()) {
+      return false;
+    }
+
+    size_class = entry->second;
+  }
+
+  std::vector<void*> to_flush;
+  {
+    ThreadCacheShard& shard = CurrentThreadCacheShard();
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    shard.free_chunks[size_class].push_back(p);
+    shard.cached_bytes += BinNumToSize(size_class);
+
+    if (shard.cached_bytes > kMaxThreadCacheShardBytes) {
+      for (auto& free_chunks : shard.free_chunks) {
+        to_flush.insert(to_flush.end(), free_chunks.begin(), free_chunks.end());
+        free_chunks.clear();
+      }
+      shard.cached_bytes = 0;
+    }
+  }
+
+  if (!to_flush.empty()) {
+    FlushChunksToBins(to_flush);
+  }
+
+  return true;
+}
+
+void BFCArena::FlushChunksToBins(std::vector<void*>& chunks) {
+  // forget the pointers before handing them back, otherwise a concurrent allocation could get the same
+  // address from the bins and have its size class entry removed by us
+  for (void* p : chunks) {
+    CachedPtrShard& ptr_shard = CachedPtrShardFor(p);
+    std::lock_guard<OrtMutex> lock(ptr_shard.mutex);
+    ptr_shard.size_classes.erase(p);
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* p : chunks) {
+    DeallocateRawInternal(p);
+  }
+}
+
+void BFCArena::FlushThreadCaches() {
+  if (!ThreadCacheEnabled()) {
+    return;
+  }
+
+  std::vector<void*> to_flush;
+  for (size_t i = 0; i < kNumThreadCacheShards; ++i) {
+    ThreadCacheShard& shard = thread_cache_shards_[i];
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    for (auto& free_chunks : shard.free_chunks) {
+      to_flush.insert(to_flush.end(), free_chunks.begin(), free_chunks.end());
+      free_chunks.clear();
+    }
+    shard.cached_bytes = 0;
+  }
+
+  if (!to_flush.empty()) {
+    FlushChunksToBins(to_flush);
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -288,9 +432,58 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   ORT_THROW(status.ErrorMessage());
 }
 
-void BFCArena::GetStats(AllocatorStats* stats) {
+Status BFCArena::Shrink() {
+  // chunks parked in the thread caches would otherwise keep their regions alive
+  FlushThreadCaches();
+
   std::lock_guard<OrtMutex> lock(lock_);
-  *stats = stats_;
+
+  // collect first as freeing modifies the region list
+  std::vector<std::pair<void*, size_t>> free_regions;
+  for (const auto& region : region_manager_.regions()) {
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    const Chunk* c = ChunkFromHandle(h);
+    // a region is entirely free if its first chunk is free and has been coalesced with everything after it
+    if (!c->in_use() && c->next == kInvalidChunkHandle) {
+      ORT_ENFORCE(c->size == region.memory_size());
+      free_regions.emplace_back(region.ptr(), region.memory_size());
+    }
+  }
+
+  size_t freed_bytes = 0;
+  for (const auto& region : free_regions) {
+    ChunkHandle h = region_manager_.get_handle(region.first);
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(region.first);
+    device_allocator_->Free(region.first);
+    stats_.total_allocated_bytes -= region.second;
+    freed_bytes += region.second;
+  }
+
+  if (freed_bytes > 0) {
+    LOGS_DEFAULT(INFO) << "Shrunk BFCArena for " << device_allocator_->Info().name << " by " << freed_bytes
+                       << " bytes. Total allocated bytes: " << stats_.total_allocated_bytes;
+  }
+
+  return Status::OK();
+}
+
+void BFCArena::GetStats(AllocatorStats* stats) {
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    *stats = stats_;
+  }
+
+  if (ThreadCacheEnabled()) {
+    stats->num_thread_cache_hits = thread_cache_hits_;
+    stats->num_thread_cache_misses = thread_cache_misses_;
+    for (size_t i = 0; i < kNumThreadCacheShards; ++i) {
+      ThreadCacheShard& shard = thread_cache_shards_[i];
+      std::lock_guard<OrtMutex> lock(shard.mutex);
+      stats->thread_cache_bytes += static_cast<int64_t>(shard.cached_bytes);
+    }
+  }
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -379,6 +572,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (ThreadCacheEnabled() && ReturnToThreadCache(p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -16,9 +16,12 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -52,11 +55,21 @@ enum class ArenaExtendStrategy : int32_t {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// Optionally, freed chunks up to 'thread_cache_max_chunk_size' bytes are kept in small per-thread
+// size-class caches instead of being returned to the bins. Allocations of the same size class from
+// the same thread are then served without taking the arena lock. Cached chunks are flushed back to
+// the bins when a thread cache grows too large, when the arena runs out of memory, or on request
+// via FlushThreadCaches().
 class BFCArena : public IArenaAllocator {
  public:
+  // A reasonable limit for thread cached chunks. Larger chunks are rare enough that the lock is not a concern.
+  static constexpr size_t kDefaultThreadCacheMaxChunkSize = 64 * 1024;
+
   BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
            size_t total_memory,
-           ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo);
+           ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+           size_t thread_cache_max_chunk_size = 0);
 
   ~BFCArena() override;
 
@@ -83,12 +96,18 @@ class BFCArena : public IArenaAllocator {
     return device_allocator_->CreateFence(session_state);
   }
 
-  void GetStats(AllocatorStats* stats);
+  void GetStats(AllocatorStats* stats) override;
 
   size_t RequestedSize(const void* ptr);
 
   size_t AllocatedSize(const void* ptr);
 
+  // Return all chunks held in the thread caches to the bins.
+  void FlushThreadCaches();
+
+  // Free all regions that have no chunks in use back to the device allocator.
+  Status Shrink() override;
+
  private:
   void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
   void DeallocateRawInternal(void* ptr);
@@ -275,6 +294,13 @@ class BFCArena : public IArenaAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr, "Could not find Region for ", ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -368,8 +394,37 @@ class BFCArena : public IArenaAllocator {
   // Computes and returns a BinDebugInfo for each Bin.
   std::array<BinDebugInfo, kNumBins> get_bin_debug_info();
 
+  // Thread cache support.
+  // Chunks in a thread cache are still 'in use' as far as the bins are concerned. Each cached size class
+  // holds chunks of exactly BinNumToSize(size_class) bytes so any of them can serve any request of that class.
+  static const size_t kNumThreadCacheShards = 64;
+  // Once a shard holds more than this many bytes, it is flushed back to the bins.
+  static const size_t kMaxThreadCacheShardBytes = 4 << 20;
+
+  struct ThreadCacheShard {
+    OrtMutex mutex;
+    std::array<std::vector<void*>, kNumBins> free_chunks;
+    size_t cached_bytes = 0;
+  };
+
+  // Maps a pointer handed out through the thread cache path to its size class. Sharded by address
+  // so that Free() from any thread can find it without taking lock_.
+  struct CachedPtrShard {
+    OrtMutex mutex;
+    std::unordered_map<const void*, BinNum> size_classes;
+  };
+
+  bool ThreadCacheEnabled() const { return thread_cache_max_chunk_size_ != 0; }
+  BinNum ThreadCacheSizeClass(size_t bytes);
+  ThreadCacheShard& CurrentThreadCacheShard();
+  CachedPtrShard& CachedPtrShardFor(const void* p);
+  void* AllocateFromThreadCache(size_t num_bytes);
+  bool ReturnToThreadCache(void* p);
+  void FlushChunksToBins(std::vector<void*>& chunks);
+
   // Structures immutable after construction
   size_t memory_limit_ = 0;
+  size_t thread_cache_max_chunk_size_ = 0;
   ArenaExtendStrategy arena_extend_strategy_ = ArenaExtendStrategy::kNextPowerOfTwo;
 
   int Log2FloorNonZeroSlow(uint64_t n) {
@@ -443,6 +498,11 @@ class BFCArena : public IArenaAllocator {
 
   std::unordered_map<void*, size_t> reserved_chunks_;
 
+  std::unique_ptr<ThreadCacheShard[]> thread_cache_shards_;
+  std::unique_ptr<CachedPtrShard[]> cached_ptr_shards_;
+  std::atomic<int64_t> thread_cache_hits_{0};
+  std::atomic<int64_t> thread_cache_misses_{0};
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef __GNUC__
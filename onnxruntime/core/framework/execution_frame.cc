@@ -3,6 +3,8 @@
 
 #include "core/framework/execution_frame.h"
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 #include "core/framework/mem_pattern_planner.h"
@@ -12,6 +14,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/run_scoped_arena.h"
 #include "core/framework/session_state.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/utils.h"
@@ -77,6 +80,35 @@ AllocatorPtr IExecutionFrame::GetAllocator(const OrtMemoryInfo& info) const {
   return GetAllocatorImpl(info);
 }
 
+Status IExecutionFrame::TryCreateNodeOutputView(int index, int input_index, const TensorShape& shape,
+                                                size_t byte_offset, OrtValue*& p_ort_value) {
+  p_ort_value = nullptr;
+  int ort_value_idx = GetNodeIdxToMLValueIdx(index);
+  int input_ort_value_idx = GetNodeIdxToMLValueIdx(input_index);
+  if (ort_value_idx == NodeIndexInfo::kInvalidEntry || input_ort_value_idx == NodeIndexInfo::kInvalidEntry ||
+      all_values_[ort_value_idx].IsAllocated() || !MayViewInput(ort_value_idx, input_ort_value_idx)) {
+    return Status::OK();
+  }
+
+  const OrtValue& input_value = GetMLValue(input_ort_value_idx);
+  const Tensor& input = input_value.Get<Tensor>();
+  MLDataType element_type = input.DataType();
+  ORT_RETURN_IF_NOT(byte_offset + static_cast<size_t>(shape.Size()) * element_type->Size() <= input.SizeInBytes(),
+                    "View of shape ", shape, " at byte offset ", byte_offset, " is out of the bounds of input of shape ",
+                    input.Shape());
+
+  // the view doesn't own the data: the allocation plan keeps the input buffer alive as long as the view
+  OrtValue& ort_value = all_values_[ort_value_idx];
+  auto p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, const_cast<void*>(input.DataRaw()),
+                                                   input.Location(), static_cast<ptrdiff_t>(byte_offset));
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  ort_value.ShareFenceWith(const_cast<OrtValue&>(input_value));
+
+  p_ort_value = &ort_value;
+  return Status::OK();
+}
+
 Status IExecutionFrame::ReleaseMLValue(int ort_value_idx) { return ReleaseMLValueImpl(ort_value_idx); }
 
 Status IExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
@@ -201,7 +233,8 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
     : IExecutionFrame(session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo(), fetch_mlvalue_idxs),
       session_state_(session_state),
       mem_patterns_(nullptr),
-      planner_(nullptr) {
+      planner_(nullptr),
+      profile_memory_(session_state.GetProfileMemory() && session_state.Profiler().IsEnabled()) {
   Init(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), fetches);
 
   // map the custom allocators to ort_value_idx entries
@@ -235,11 +268,16 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
 
     //if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes, feed_mlvalue_idxs);
-      // if no existing patterns, generate one in this executionframe
-      if (!mem_patterns_) {
+      bool needs_retrace = false;
+      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes, feed_mlvalue_idxs, &needs_retrace);
+      mem_patterns_key_ = session_state.GetMemoryPatternsKey(input_shapes);
+
+      // if no existing patterns, or the existing one needs to be re-planned, generate one in this executionframe
+      if (!mem_patterns_ || needs_retrace) {
         planner_ = onnxruntime::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
-      } else {
+      }
+
+      if (mem_patterns_) {
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
         for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
@@ -291,7 +329,11 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  if (profile_memory_) {
+    ReportMemoryProfile();
+  }
+}
 
 Status ExecutionFrame::CopyTensor(const Tensor& src, Tensor& dest) const {
   return session_state_.GetDataTransferMgr().CopyTensor(src, dest);
@@ -348,18 +390,27 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // if the block is not correct, log message then fall back to default behavior.
+          // with bucketing the pattern is shared by smaller shapes so any block that is large enough can be used.
+          const bool bucketing = session_state_.GetMemoryPatternBucketing() != MemoryPatternBucketing::None;
+          if (block->size_ == size || (bucketing && block->size_ > size)) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
                 shape);
+            // we're re-planning the pattern so need the actual size
+            if (status.IsOK()) {
+              TraceAllocate(ort_value_index, size);
+            }
             return status;
           } else {
+            if (bucketing && !mem_patterns_misfit_) {
+              mem_patterns_misfit_ = true;
+              session_state_.MarkMemoryPatternGroupForRetrace(mem_patterns_key_);
+            }
+
             // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
             // fed in, so use VERBOSE as the log level as it's expected.
-            // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
-            // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
             LOGS(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
                                                    << ", block in memory pattern size is: " << block->size_
                                                    << " but the actually size is: " << size
@@ -372,7 +423,14 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
   }
 
   //no memory pattern, or the pattern is not correct.
-  if (!alloc) alloc = GetAllocator(location);
+  // graph outputs are returned to the caller so must outlive the Run and can't come from the run scoped arena.
+  if (session_state_.GetUseRunScopedArena() && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput &&
+      !utils::IsDataTypeString(element_type)) {
+    alloc = GetRunScopedAllocator(location);
+  } else if (!alloc) {
+    alloc = GetAllocator(location);
+  }
+
   std::unique_ptr<Tensor> p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, alloc);
 
   {
@@ -480,6 +538,18 @@ static Status AllocateSparseTensor(MLValue& mlvalue, const DataTypeImpl& ml_type
   return Status::OK();
 }
 
+AllocatorPtr ExecutionFrame::GetRunScopedAllocator(const OrtMemoryInfo& location) {
+  std::lock_guard<OrtMutex> lock(run_scoped_arenas_mutex_);
+  auto& arena = run_scoped_arenas_[location];
+  if (!arena) {
+    auto parent = GetAllocator(location);
+    ORT_ENFORCE(parent, "Failed to get allocator for location: ", location.ToString());
+    arena = std::make_shared<RunScopedArena>(std::move(parent));
+  }
+
+  return arena;
+}
+
 // This method is not thread safe!
 Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_value_index, const TensorShape* shape,
                                                    size_t nnz) {
@@ -518,7 +588,8 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
       // Right now for kAllocate and kAllocateOutput we are using same approach.
       // In the future we may want to have different way to handle it.
       case AllocKind::kAllocateOutput:
-      case AllocKind::kAllocate: {
+      case AllocKind::kAllocate:
+      case AllocKind::kAllocateOrView: {
         ORT_RETURN_IF_ERROR(AllocateMLValueTensorSelfOwnBuffer(ort_value, ort_value_index, ml_data_type, alloc_info,
                                                                *shape, per_alloc_plan.create_fence_if_async));
         break;
@@ -535,6 +606,9 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
         }
         ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBuffer(
             ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, per_alloc_plan.create_fence_if_async));
+        if (per_alloc_plan.inplace_reuse) {
+          session_state_.RecordInPlaceReuse(static_cast<size_t>(shape->Size()) * ml_data_type->Size());
+        }
         break;
       }
       case AllocKind::kShare: {
@@ -578,6 +652,13 @@ Status ExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   return Status::OK();
 }
 
+bool ExecutionFrame::MayViewInput(int ort_value_idx, int input_ort_value_idx) const {
+  const auto& alloc_plan = session_state_.GetExecutionPlan()->allocation_plan;
+  ORT_ENFORCE(ort_value_idx >= 0 && static_cast<size_t>(ort_value_idx) < alloc_plan.size());
+  const auto& per_alloc_plan = alloc_plan[ort_value_idx];
+  return per_alloc_plan.alloc_kind == AllocKind::kAllocateOrView && per_alloc_plan.reused_buffer == input_ort_value_idx;
+}
+
 const AllocPlanPerValue& ExecutionFrame::GetAllocationPlan(int ort_value_idx) {
   const SequentialExecutionPlan* p_seq_exec_plan = session_state_.GetExecutionPlan();
   const auto& alloc_plan = p_seq_exec_plan->allocation_plan;
@@ -586,6 +667,10 @@ const AllocPlanPerValue& ExecutionFrame::GetAllocationPlan(int ort_value_idx) {
 }
 
 void ExecutionFrame::TraceAllocate(int ort_value_idx, size_t size) {
+  if (profile_memory_) {
+    ProfileAllocation(ort_value_idx, size);
+  }
+
   if (planner_) {
     // don't trace the output tensors.
     auto& allocation_plan = GetAllocationPlan(ort_value_idx);
@@ -598,6 +683,10 @@ void ExecutionFrame::TraceAllocate(int ort_value_idx, size_t size) {
 }
 
 void ExecutionFrame::TraceFree(int ort_value_idx) {
+  if (profile_memory_) {
+    ProfileFree(ort_value_idx);
+  }
+
   // don't trace free on output tensors.
   if (planner_ && !IsOutput(ort_value_idx)) {
     const SequentialExecutionPlan* p_seq_exec_plan = session_state_.GetExecutionPlan();
@@ -622,6 +711,126 @@ void ExecutionFrame::TraceFree(int ort_value_idx) {
   }
 }
 
+static std::string MemoryLocationName(const OrtMemoryInfo& location) {
+  return std::string(location.name) + ":" + std::to_string(location.id);
+}
+
+// returns the name of the value and of the node producing it
+static std::pair<std::string, std::string> GetValueAndProducerNames(const SessionState& session_state,
+                                                                    int ort_value_idx) {
+  std::pair<std::string, std::string> names;
+  if (!session_state.GetOrtValueNameIdxMap().GetName(ort_value_idx, names.first).IsOK()) {
+    return names;
+  }
+  const Node* producer = session_state.GetGraphViewer().GetGraph().GetProducerNode(names.first);
+  if (producer != nullptr) {
+    names.second = producer->Name();
+  }
+  return names;
+}
+
+static void RecordTensorLifetimeEvent(const SessionState& session_state, int ort_value_idx,
+                                      const OrtMemoryInfo& location, size_t size, const TimePoint& allocation_time) {
+  const auto names = GetValueAndProducerNames(session_state, ort_value_idx);
+  session_state.Profiler().EndTimeAndRecordEvent(profiling::MEMORY_EVENT, names.first, allocation_time,
+                                                 {{"location", MemoryLocationName(location)},
+                                                  {"size", std::to_string(size)},
+                                                  {"node", names.second}});
+}
+
+void ExecutionFrame::ProfileAllocation(int ort_value_idx, size_t size) {
+  const OrtMemoryInfo& location = GetAllocationPlan(ort_value_idx).location;
+  // the profiler may be stopped while the run is in progress, so this doesn't use Profiler::StartTime
+  const TimePoint now = std::chrono::high_resolution_clock::now();
+
+  std::lock_guard<OrtMutex> lock(memory_profile_mutex_);
+  const size_t seq = memory_event_seq_++;
+  live_tensors_[ort_value_idx] = tensor_lifetimes_.size();
+  tensor_lifetimes_.push_back({ort_value_idx, &location, size, now, seq, std::numeric_limits<size_t>::max()});
+
+  auto& usage = memory_usage_[location];
+  usage.bytes_in_use += size;
+  if (usage.bytes_in_use > usage.peak_bytes) {
+    usage.peak_bytes = usage.bytes_in_use;
+    usage.peak_seq = seq;
+    usage.peak_time = now;
+    usage.peak_ort_value_idx = ort_value_idx;
+  }
+}
+
+void ExecutionFrame::ProfileFree(int ort_value_idx) {
+  TensorLifetime lifetime;
+  {
+    std::lock_guard<OrtMutex> lock(memory_profile_mutex_);
+    auto it = live_tensors_.find(ort_value_idx);
+    // values reusing the buffer of another value aren't recorded
+    if (it == live_tensors_.end()) {
+      return;
+    }
+    auto& entry = tensor_lifetimes_[it->second];
+    entry.free_seq = memory_event_seq_++;
+    memory_usage_[*entry.location].bytes_in_use -= entry.size;
+    lifetime = entry;
+    live_tensors_.erase(it);
+  }
+
+  RecordTensorLifetimeEvent(session_state_, lifetime.ort_value_idx, *lifetime.location, lifetime.size,
+                            lifetime.allocation_time);
+}
+
+void ExecutionFrame::ReportMemoryProfile() {
+  std::lock_guard<OrtMutex> lock(memory_profile_mutex_);
+
+  // the graph outputs, and the values a failed run didn't release, live until the end of the run
+  for (const auto& live_tensor : live_tensors_) {
+    const auto& lifetime = tensor_lifetimes_[live_tensor.second];
+    RecordTensorLifetimeEvent(session_state_, lifetime.ort_value_idx, *lifetime.location, lifetime.size,
+                              lifetime.allocation_time);
+  }
+
+  for (const auto& location_usage : memory_usage_) {
+    const OrtMemoryInfo& location = location_usage.first;
+    const MemoryUsage& usage = location_usage.second;
+    if (usage.peak_bytes == 0) {
+      continue;
+    }
+
+    // the tensors that were live when the peak was reached, largest first
+    std::vector<const TensorLifetime*> peak_live_set;
+    for (const auto& lifetime : tensor_lifetimes_) {
+      if (*lifetime.location == location && lifetime.allocation_seq <= usage.peak_seq &&
+          lifetime.free_seq > usage.peak_seq) {
+        peak_live_set.push_back(&lifetime);
+      }
+    }
+    std::stable_sort(peak_live_set.begin(), peak_live_set.end(),
+                     [](const TensorLifetime* a, const TensorLifetime* b) { return a->size > b->size; });
+
+    // the lifetime events have all of them, so only the largest ones are listed
+    constexpr size_t kMaxListedTensors = 32;
+    std::ostringstream live_tensors;
+    for (size_t i = 0; i < peak_live_set.size() && i < kMaxListedTensors; ++i) {
+      const auto names = GetValueAndProducerNames(session_state_, peak_live_set[i]->ort_value_idx);
+      live_tensors << (i > 0 ? "; " : "") << names.first << " (" << names.second << "): " << peak_live_set[i]->size;
+    }
+    if (peak_live_set.size() > kMaxListedTensors) {
+      live_tensors << "; ...";
+    }
+
+    const std::string location_name = MemoryLocationName(location);
+    const auto peak_names = GetValueAndProducerNames(session_state_, usage.peak_ort_value_idx);
+    LOGS(session_state_.Logger(), INFO) << "[Memory] Peak of " << usage.peak_bytes << " bytes for " << location_name
+                                        << " with " << peak_live_set.size() << " live tensors: "
+                                        << live_tensors.str();
+    session_state_.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "memory_peak", usage.peak_time,
+                                                    {{"location", location_name},
+                                                     {"peak_bytes", std::to_string(usage.peak_bytes)},
+                                                     {"node", peak_names.second},
+                                                     {"num_live_tensors", std::to_string(peak_live_set.size())},
+                                                     {"live_tensors", live_tensors.str()}});
+  }
+}
+
 // generate memory pattern based on the tracing of memory allocation/free in current execution
 // return error if the planner is not setup.
 Status ExecutionFrame::GeneratePatterns(MemoryPatternGroup* out) const {
@@ -3,11 +3,13 @@
 
 #pragma once
 
+#include <map>
 #include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/status.h"
+#include "core/platform/ort_mutex.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/node_index_info.h"
@@ -43,6 +45,14 @@ class IExecutionFrame {
     return node_index_info_.GetNodeOffset(index);
   }
 
+  // Get the ort_value indexes of the count entries starting at index, see NodeIndexInfo::GetMLValueIndexes.
+  const int* GetNodeIdxToMLValueIdxs(int index, size_t count) const {
+    return node_index_info_.GetMLValueIndexes(index, count);
+  }
+
+  // Get the values indexed by ort_value_idx. They don't move once the frame is initialized.
+  OrtValue* GetMLValues() { return all_values_.data(); }
+
   // Return nullptr if index map to an value that is an unused optional input/output
   const OrtValue* GetNodeInputOrOutputMLValue(int index) const;
   OrtValue* GetMutableNodeInputOrOutputMLValue(int index);
@@ -53,6 +63,12 @@ class IExecutionFrame {
   // Shape is required for tensors but not traditional ML values.
   Status GetOrCreateNodeOutputMLValue(int index, const TensorShape* shape, OrtValue*& p_ort_value, size_t nnz = 0);
 
+  // Creates the output tensor at index as a view of the input tensor at input_index, with the given shape and starting
+  // byte_offset bytes into the input data, if the allocation plan allows the output to be a view of that input.
+  // Return S_OK and nullptr otherwise, in which case the output must be created by GetOrCreateNodeOutputMLValue.
+  Status TryCreateNodeOutputView(int index, int input_index, const TensorShape& shape, size_t byte_offset,
+                                 OrtValue*& p_ort_value);
+
   /**
    * write the output values to the 'fetches' vector
    * Don't access the values after SessionState is destroyed 
@@ -89,6 +105,9 @@ class IExecutionFrame {
 
   virtual Status CopyTensor(const Tensor& src, Tensor& dest) const = 0;
 
+  // returns true if the value at ort_value_idx may be created as a view of the value at input_ort_value_idx
+  virtual bool MayViewInput(int /*ort_value_idx*/, int /*input_ort_value_idx*/) const { return false; }
+
   const NodeIndexInfo& node_index_info_;
 
   // All the intermediate values for the entire graph.
@@ -148,6 +167,7 @@ class ExecutionFrame final : public IExecutionFrame {
   Status ReleaseMLValueImpl(int ort_value_idx) override;
   Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) override;
   Status CopyTensor(const Tensor& src, Tensor& dest) const override;
+  bool MayViewInput(int ort_value_idx, int input_ort_value_idx) const override;
 
   common::Status AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_value_index, const TensorShape* shape,
                                              size_t nnz);
@@ -159,9 +179,17 @@ class ExecutionFrame final : public IExecutionFrame {
   Status AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, void* pBuffer, MLDataType element_type,
                                                    const OrtMemoryInfo& location, const TensorShape& shape);
 
+  // Get the RunScopedArena for a location, creating it on first use.
+  AllocatorPtr GetRunScopedAllocator(const OrtMemoryInfo& location);
+
   void TraceAllocate(int ort_value_idx, size_t size);
   void TraceFree(int ort_value_idx);
 
+  // Memory profiling: record the allocation or release of a tensor, and report the memory use of the frame.
+  void ProfileAllocation(int ort_value_idx, size_t size);
+  void ProfileFree(int ort_value_idx);
+  void ReportMemoryProfile();
+
   const AllocPlanPerValue& GetAllocationPlan(int ort_value_idx);
 
   const SessionState& session_state_;
@@ -172,7 +200,14 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
+
+  // key of mem_patterns_ in the SessionState cache.
+  int64_t mem_patterns_key_ = 0;
+
+  // if mem_patterns_ was planned for smaller shapes in the same bucket, a block may be smaller than the tensor
+  // that needs it. if that happens we ask for the pattern to be re-planned.
+  bool mem_patterns_misfit_ = false;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -181,6 +216,12 @@ class ExecutionFrame final : public IExecutionFrame {
   // Big chunks on different locations that will be used by mem_pattern.
   std::map<OrtMemoryInfo, BufferUniquePtr> buffers_;
 
+  // Per-Run bump arenas for intermediate values if SessionState::GetUseRunScopedArena() is set.
+  // Each tensor allocated from one holds a reference to it, so the memory is returned to the session allocator
+  // once the frame and all those tensors are gone.
+  OrtMutex run_scoped_arenas_mutex_;
+  std::map<OrtMemoryInfo, AllocatorPtr> run_scoped_arenas_;
+
   // Size of virtual memory allocated before any kernel execution.
   // This field is not physical memory size.
   std::unordered_map<std::string, size_t> static_activation_memory_sizes_in_byte_;
@@ -188,5 +229,35 @@ class ExecutionFrame final : public IExecutionFrame {
   // we may allocate some memory for its outputs, if not planned.).
   // This field is not physical memory size.
   std::unordered_map<std::string, size_t> dynamic_activation_memory_sizes_in_byte_;
+
+  // Set if SessionState::GetProfileMemory is set and the profiler is enabled. Every tensor allocated by the frame
+  // is recorded as a MEMORY_EVENT spanning its lifetime, and the tensors live at the peak memory use of each
+  // location are reported when the frame is destroyed.
+  const bool profile_memory_;
+
+  struct TensorLifetime {
+    int ort_value_idx;
+    const OrtMemoryInfo* location;
+    size_t size;
+    TimePoint allocation_time;
+    // order of the allocation and the release among the memory events of the frame
+    size_t allocation_seq;
+    size_t free_seq;
+  };
+
+  struct MemoryUsage {
+    size_t bytes_in_use = 0;
+    size_t peak_bytes = 0;
+    size_t peak_seq = 0;
+    TimePoint peak_time;
+    int peak_ort_value_idx = -1;  // the allocation that reached the peak
+  };
+
+  // guards the memory profiling state, as the parallel executor allocates from several threads
+  OrtMutex memory_profile_mutex_;
+  std::vector<TensorLifetime> tensor_lifetimes_;
+  std::unordered_map<int, size_t> live_tensors_;  // ort_value_idx to its entry in tensor_lifetimes_
+  std::map<OrtMemoryInfo, MemoryUsage> memory_usage_;
+  size_t memory_event_seq_ = 0;
 };
 }  // namespace onnxruntime
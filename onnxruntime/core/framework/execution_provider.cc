@@ -51,6 +51,10 @@ common::Status IExecutionProvider::OnRunEnd() { return Status::OK(); }
 
 common::Status IExecutionProvider::OnSessionInitializationEnd() { return Status::OK(); }
 
+common::Status IExecutionProvider::ReplayGraph() {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, Type(), " does not support graph capture");
+}
+
 void IExecutionProvider::InsertAllocator(AllocatorPtr allocator) {
   const OrtMemoryInfo& info = allocator->Info();
   const int key = MakeKey(info.id, info.mem_type);
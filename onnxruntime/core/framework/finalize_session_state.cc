@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <limits>
+#include <unordered_set>
 #include <core/common/status.h>
 
 #include "core/common/common.h"
@@ -13,6 +14,7 @@
 
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
+#include "core/framework/endian.h"
 #include "core/graph/graph_utils.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/ml_value.h"
@@ -20,6 +22,7 @@
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializers.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
@@ -34,7 +37,10 @@ static common::Status SaveInitializedTensors(const Env& env, const std::basic_st
                                              const OrtValueNameIdxMap& ort_value_name_idx_map,
                                              ITensorAllocator& planner, const T& save_tensor_func,
                                              const logging::Logger& logger,
-                                             const DataTransferManager& data_transfer_mgr);
+                                             const DataTransferManager& data_transfer_mgr,
+                                             const SequentialExecutionPlan& exec_plan,
+                                             SharedInitializerRegistry* shared_initializers,
+                                             concurrency::ThreadPool* thread_pool);
 
 static common::Status SaveInputOutputNamesToNodeMapping(const onnxruntime::GraphViewer& graph,
                                                         const KernelRegistryManager& custom_registry_manager,
@@ -45,7 +51,8 @@ Status FinalizeSessionState(SessionState& session_state,
                             const std::basic_string<PATH_CHAR_TYPE>& graph_location,
                             KernelRegistryManager& kernel_registry_manager,
                             _In_opt_ const Node* parent_node,
-                            ExecutionMode execution_mode) {
+                            ExecutionMode execution_mode,
+                            ExecutionOrder execution_order) {
   session_state.CreateGraphInfo();
 
   const GraphViewer& graph_viewer = session_state.GetGraphViewer();
@@ -70,11 +77,14 @@ Status FinalizeSessionState(SessionState& session_state,
   }
 
   std::unique_ptr<SequentialExecutionPlan> exec_plan;
-  SequentialPlannerContext context(execution_mode);
+  SequentialPlannerContext context(execution_mode, execution_order);
   ORT_RETURN_IF_ERROR(SequentialPlanner::CreatePlan(parent_node, graph_viewer, valid_outer_scope_node_args,
                                                     session_state.GetExecutionProviders(), kernel_registry_manager,
                                                     ort_value_name_idx_map, context, exec_plan));
 
+  LOGS(logger, VERBOSE) << "Estimated peak memory of the intermediate values: "
+                        << exec_plan->estimated_peak_memory_bytes << " bytes";
+
   const auto* exec_plan_ptr = exec_plan.get();
   session_state.SetExecutionPlan(std::move(exec_plan));
 
@@ -91,7 +101,8 @@ Status FinalizeSessionState(SessionState& session_state,
       [&session_state](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
         return session_state.AddInitializedTensor(idx, value, &d, constant);
       },
-      logger, session_state.GetDataTransferMgr()));
+      logger, session_state.GetDataTransferMgr(), *exec_plan_ptr, session_state.GetSharedInitializerRegistry(),
+      session_state.GetThreadPool()));
 
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
@@ -164,26 +175,101 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   return common::Status::OK();
 }
 
+// Whether a constant initializer can be shared through the SharedInitializerRegistry. Only CPU tensors are shared
+// since the registry allocates from the CPU. Initializers with external data are memory mapped already.
+static bool CanShareInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtMemoryInfo& location) {
+  return strcmp(location.name, CPU) == 0 &&
+         tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+         tensor_proto.data_location() != ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL;
+}
+
+// Whether the tensor of an initializer is created directly over its memory mapped external data, in which case it
+// doesn't need a buffer from the planner. The data is copied into the planned buffer on other devices, and on
+// big-endian platforms as it is stored in little-endian order.
+static bool IsMappedInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtMemoryInfo& location) {
+  return endian::native == endian::little &&
+         strcmp(location.name, CPU) == 0 &&
+         tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+         tensor_proto.data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL;
+}
+
+static void ReleaseSharedInitializer(void* param) {
+  delete static_cast<std::shared_ptr<void>*>(param);
+}
+
+// Deserialize a constant initializer into a buffer of the registry and replace it by an identical buffer that
+// is already shared if there is one. The buffer is kept alive by `deleter` until the session state releases it.
+static common::Status DeserializeSharedInitializer(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
+                                                   const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                   SharedInitializerRegistry& shared_initializers,
+                                                   OrtValue& ort_value, OrtCallback& deleter) {
+  size_t size;
+  ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &size));
+
+  const AllocatorPtr& alloc = shared_initializers.Allocator();
+  BufferUniquePtr buffer(size > 0 ? alloc->Alloc(size) : nullptr, BufferDeleter(alloc));
+
+  OrtValue tmp_ort_value;
+  OrtCallback d;
+  ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto,
+                                                  MemBuffer(buffer.get(), size, alloc->Info()), tmp_ort_value, d));
+  // d is only set for string tensors and external data, which are not shared
+  ORT_ENFORCE(d.f == nullptr);
+
+  const Tensor& deserialized_tensor = tmp_ort_value.Get<Tensor>();
+  auto shared = onnxruntime::make_unique<std::shared_ptr<void>>();
+  if (size > 0) {
+    *shared = shared_initializers.Share(std::move(buffer), size);
+  }
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(deserialized_tensor.DataType(), deserialized_tensor.Shape(),
+                                                   shared->get(), alloc->Info());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+
+  deleter.f = ReleaseSharedInitializer;
+  deleter.param = shared.release();
+  return Status::OK();
+}
+
 template <typename T>
 common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                       const GraphViewer& graph, const OrtMemoryInfo& default_cpu_memory_info,
                                       const OrtValueNameIdxMap& ort_value_name_idx_map, ITensorAllocator& planner,
                                       const T& save_tensor_func, const logging::Logger& logger,
-                                      const DataTransferManager& data_transfer_mgr) {
+                                      const DataTransferManager& data_transfer_mgr,
+                                      const SequentialExecutionPlan& exec_plan,
+                                      SharedInitializerRegistry* shared_initializers,
+                                      concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
   //1. first plan the memory
+  // initializers shared with other sessions or created over memory mapped data are not allocated by the planner
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   std::unordered_map<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
+  std::unordered_map<int, const ONNX_NAMESPACE::TensorProto*> id_to_shared_initialized_tensor;
+  std::unordered_set<int> mapped_initialized_tensors;
   for (const auto& entry : initialized_tensor_set) {
     int ort_value_index;
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
-    id_to_initialized_tensor[ort_value_index] = entry.second;
+    const OrtMemoryInfo& location = exec_plan.GetLocation(ort_value_index);
+    if (shared_initializers != nullptr &&
+        graph.IsConstantInitializer(entry.first, /* check_outer_scope */ false) &&
+        CanShareInitializer(*entry.second, location)) {
+      id_to_shared_initialized_tensor[ort_value_index] = entry.second;
+    } else {
+      id_to_initialized_tensor[ort_value_index] = entry.second;
+      if (IsMappedInitializer(*entry.second, location)) {
+        mapped_initialized_tensors.insert(ort_value_index);
+      }
+    }
   }
 
   for (const auto& entry : id_to_initialized_tensor) {
-    ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
+    if (mapped_initialized_tensors.count(entry.first) == 0) {
+      ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
+    }
   }
 
   //2. allocate weight buffer on different locations
@@ -198,34 +284,107 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
                        << i.second << " bytes for " << i.first << std::endl;
   }
 
-  OrtCallback deleter;
-
   //3. create weight tensors based on weights buffer
+  // The tensors deserialized directly into CPU buffers are independent of each other and are created in parallel
+  // on the thread pool. The others are copied to their device by the data transfer manager one at a time.
+  struct DeserializedTensor {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    std::unique_ptr<MemBuffer> m;
+    OrtValue ort_value;
+    OrtCallback deleter{nullptr, nullptr};
+    Status status;
+  };
+
+  std::vector<DeserializedTensor> tensors;
+  tensors.reserve(id_to_initialized_tensor.size());
+  std::vector<size_t> cpu_tensors;
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
     const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
-    const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
 
     std::unique_ptr<MemBuffer> m;
-    // TODO: if the tensor need be copied, does it have enough room?
-    ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m));
+    if (mapped_initialized_tensors.count(ort_value_index) != 0) {
+      m = onnxruntime::make_unique<MemBuffer>(nullptr, 0, exec_plan.GetLocation(ort_value_index));
+    } else {
+      // TODO: if the tensor need be copied, does it have enough room?
+      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m));
 #ifndef NDEBUG
-    ORT_ENFORCE(m != nullptr);
-    ORT_ENFORCE(m->GetBuffer() != nullptr || m->GetLen() == 0);
+      ORT_ENFORCE(m != nullptr);
+      ORT_ENFORCE(m->GetBuffer() != nullptr || m->GetLen() == 0);
 #endif
+    }
+
+    const OrtMemoryInfo& alloc_info = m->GetAllocInfo();
+    if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
+      cpu_tensors.push_back(tensors.size());
+    }
+    tensors.push_back(DeserializedTensor{ort_value_index, entry.second, std::move(m), OrtValue(), {nullptr, nullptr},
+                                         Status::OK()});
+  }
+
+  const auto deserialize = [&](DeserializedTensor& tensor) {
+    tensor.status = DeserializeTensorProto(env, graph_loc, *tensor.tensor_proto, *tensor.m, default_cpu_memory_info,
+                                           tensor.ort_value, tensor.deleter, data_transfer_mgr);
+  };
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(cpu_tensors.size()),
+      [&](std::ptrdiff_t i) { deserialize(tensors[cpu_tensors[i]]); });
+
+  size_t next_cpu_tensor = 0;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (next_cpu_tensor < cpu_tensors.size() && cpu_tensors[next_cpu_tensor] == i) {
+      ++next_cpu_tensor;
+    } else {
+      deserialize(tensors[i]);
+    }
+  }
+
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    DeserializedTensor& tensor = tensors[i];
+    const char* name = (tensor.tensor_proto->name().empty()) ? "" : tensor.tensor_proto->name().c_str();
+    Status st = tensor.status;
+    if (st.IsOK()) {
+      bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
+      st = save_tensor_func(tensor.ort_value_index, tensor.ort_value, tensor.deleter, constant);
+    } else {
+      std::ostringstream oss;
+      oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
+      st = Status(st.Category(), st.Code(), oss.str());
+    }
+
+    if (!st.IsOK()) {
+      // release the tensors that were not handed over to the session state
+      for (size_t j = i + 1; j < tensors.size(); ++j) {
+        if (tensors[j].deleter.f != nullptr) {
+          tensors[j].deleter.f(tensors[j].deleter.param);
+        }
+      }
+      return st;
+    }
+
+    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << tensor.ort_value_index;
+  }
+
+  //4. create the weight tensors shared with other sessions
+  for (const auto& entry : id_to_shared_initialized_tensor) {
+    int ort_value_index = entry.first;
+    const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
+
     OrtValue ort_value;
-    Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, *m, default_cpu_memory_info, ort_value, deleter,
-                                       data_transfer_mgr);
+    OrtCallback shared_deleter;
+    Status st = DeserializeSharedInitializer(env, graph_loc, *entry.second, *shared_initializers, ort_value,
+                                             shared_deleter);
     if (!st.IsOK()) {
       std::ostringstream oss;
       oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
       return Status(st.Category(), st.Code(), oss.str());
     }
 
-    bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
-    ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
+    ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, shared_deleter, true));
 
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << ort_value_index;
+    VLOGS(logger, 1) << "Added shared weight with name : " << name << " with index: " << ort_value_index;
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
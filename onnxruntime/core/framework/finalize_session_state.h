@@ -20,6 +20,7 @@ Status FinalizeSessionState(SessionState& session_state,
                             const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                             KernelRegistryManager& kernel_registry_manager,
                             _In_opt_ const Node* parent_node,
-                            ExecutionMode execution_mode = ORT_SEQUENTIAL);
+                            ExecutionMode execution_mode = ORT_SEQUENTIAL,
+                            ExecutionOrder execution_order = ExecutionOrder::Default);
 
 }  // namespace onnxruntime
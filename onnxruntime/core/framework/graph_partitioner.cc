@@ -2,6 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/framework/graph_partitioner.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+
 #include "core/framework/kernel_registry_manager.h"
 #include "core/graph/function.h"
 #include "core/graph/graph_viewer.h"
@@ -10,6 +16,7 @@
 #include "core/framework/execution_providers.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/func_kernel.h"
+#include "core/framework/partitioning_cost_model.h"
 
 // uncomment this line to count non-CUDA ops in ONNX domain
 //#define COUNT_NON_CUDA_OPS
@@ -105,6 +112,380 @@ static Node* PlaceNode(Graph& graph, std::unique_ptr<IndexedSubGraph> capability
   return nullptr;
 }
 
+namespace {
+
+// Minimum s-t cut of a graph with the max flow algorithm of Dinic.
+class MinCut {
+ public:
+  explicit MinCut(size_t num_vertices) : adjacency_(num_vertices) {}
+
+  void AddEdge(size_t from, size_t to, double capacity) {
+    if (capacity <= 0.0) {
+      return;
+    }
+    adjacency_[from].push_back(edges_.size());
+    edges_.push_back({to, capacity});
+    adjacency_[to].push_back(edges_.size());
+    edges_.push_back({from, 0.0});
+  }
+
+  // Returns whether each vertex is on the source side of a minimum cut.
+  std::vector<bool> Solve(size_t source, size_t sink) {
+    while (BuildLevels(source, sink)) {
+      std::vector<size_t> next(adjacency_.size(), 0);
+      std::vector<size_t> path;
+      size_t v = source;
+      for (;;) {
+        if (v == sink) {
+          // augment the flow along the path, then restart from the source
+          double flow = edges_[path[0]].capacity;
+          for (size_t e : path) {
+            flow = std::min(flow, edges_[e].capacity);
+          }
+          for (size_t e : path) {
+            edges_[e].capacity -= flow;
+            edges_[e ^ 1].capacity += flow;
+          }
+          path.clear();
+          v = source;
+          continue;
+        }
+        auto& adjacent = adjacency_[v];
+        while (next[v] < adjacent.size()) {
+          const auto& edge = edges_[adjacent[next[v]]];
+          if (edge.capacity > kEpsilon && level_[edge.to] == level_[v] + 1) {
+            break;
+          }
+          ++next[v];
+        }
+        if (next[v] < adjacent.size()) {
+          path.push_back(adjacent[next[v]]);
+          v = edges_[path.back()].to;
+        } else if (v == source) {
+          break;
+        } else {
+          // dead end, retreat to the previous vertex of the path
+          level_[v] = -1;
+          v = edges_[path.back() ^ 1].to;
+          path.pop_back();
+          ++next[v];
+        }
+      }
+    }
+
+    std::vector<bool> source_side(adjacency_.size(), false);
+    BuildLevels(source, sink);
+    for (size_t i = 0; i < adjacency_.size(); ++i) {
+      source_side[i] = level_[i] >= 0;
+    }
+    return source_side;
+  }
+
+ private:
+  static constexpr double kEpsilon = 1e-9;
+
+  struct Edge {
+    size_t to;
+    double capacity;  // residual capacity. The reverse of edge i is edge i ^ 1.
+  };
+
+  // Computes the BFS level of the vertices reachable from the source in the residual graph.
+  bool BuildLevels(size_t source, size_t sink) {
+    level_.assign(adjacency_.size(), -1);
+    std::vector<size_t> queue{source};
+    level_[source] = 0;
+    for (size_t i = 0; i < queue.size(); ++i) {
+      size_t v = queue[i];
+      for (size_t e : adjacency_[v]) {
+        const auto& edge = edges_[e];
+        if (edge.capacity > kEpsilon && level_[edge.to] < 0) {
+          level_[edge.to] = level_[v] + 1;
+          queue.push_back(edge.to);
+        }
+      }
+    }
+    return level_[sink] >= 0;
+  }
+
+  std::vector<Edge> edges_;
+  std::vector<std::vector<size_t>> adjacency_;
+  std::vector<int> level_;
+};
+
+}  // namespace
+
+Status GraphPartitioner::LoadPlacementOverrides(const PathString& file_path,
+                                                NodePlacementOverrides& placement_overrides) {
+  std::ifstream in(file_path);
+  if (!in) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Failed to open the graph partitioning override file");
+  }
+  std::string line;
+  for (int line_number = 1; std::getline(in, line); ++line_number) {
+    std::istringstream fields(line);
+    std::string node_name;
+    std::string provider_type;
+    if (!(fields >> node_name) || node_name[0] == '#') {
+      continue;
+    }
+    if (!(fields >> provider_type)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Invalid entry in the graph partitioning override file at line ", line_number, ": ", line);
+    }
+    placement_overrides[node_name] = provider_type;
+  }
+  return Status::OK();
+}
+
+const std::string* GraphPartitioner::GetPlacementOverride(const Node& node) const {
+  if (placement_overrides_ == nullptr || node.Name().empty()) {
+    return nullptr;
+  }
+  auto entry = placement_overrides_->find(node.Name());
+  return entry != placement_overrides_->cend() ? &entry->second : nullptr;
+}
+
+void GraphPartitioner::AssignNodesByCost(Graph& graph, const NodeCandidates& node_candidates) const {
+  using namespace partitioning_cost_model;
+
+  // The nodes that both a host and a device provider can run are the vertices of a cut between the source (the
+  // host) and the sink (the device). The other candidate nodes go to their preferred provider.
+  static constexpr size_t kSource = 0;
+  static constexpr size_t kSink = 1;
+  struct Choice {
+    size_t vertex;
+    const std::string* host_provider;
+    const std::string* device_provider;
+  };
+  std::unordered_map<NodeIndex, Choice> choices;
+  for (const auto& entry : node_candidates) {
+    Node* node = graph.GetNode(entry.first);
+    if (node == nullptr || !node->GetExecutionProviderType().empty()) {
+      continue;
+    }
+    const std::string* host_provider = nullptr;
+    const std::string* device_provider = nullptr;
+    for (const auto& provider_type : entry.second) {
+      auto& provider = IsHostProvider(provider_type) ? host_provider : device_provider;
+      if (provider == nullptr) {
+        provider = &provider_type;
+      }
+    }
+    if (host_provider != nullptr && device_provider != nullptr) {
+      const size_t vertex = choices.size() + 2;
+      choices[entry.first] = {vertex, host_provider, device_provider};
+    } else {
+      node->SetExecutionProviderType(entry.second.front());
+    }
+  }
+  if (choices.empty()) {
+    return;
+  }
+
+  std::unordered_map<NodeIndex, const KernelDef*> kernel_defs;
+  auto get_kernel_def = [&](const Node& node, const std::string& provider_type) -> const KernelDef* {
+    auto entry = kernel_defs.find(node.Index());
+    if (entry != kernel_defs.cend()) {
+      return entry->second;
+    }
+    const KernelDef* kernel_def = nullptr;
+    for (const auto* registry : kernel_registry_mgr_.GetKernelRegistriesByProviderType(provider_type)) {
+      const KernelCreateInfo* kernel_create_info = nullptr;
+      if (registry->TryFindKernel(node, provider_type, &kernel_create_info).IsOK()) {
+        kernel_def = kernel_create_info->kernel_def.get();
+        break;
+      }
+    }
+    kernel_defs[node.Index()] = kernel_def;
+    return kernel_def;
+  };
+
+  // Where a node reads an input or writes an output: in host memory, in device memory, or in the memory of the
+  // vertex's side of the cut.
+  struct Endpoint {
+    bool is_vertex;
+    size_t vertex;
+    bool on_host;
+  };
+  auto get_endpoint = [&](const Node& node, bool is_input, size_t index) -> Endpoint {
+    auto choice = choices.find(node.Index());
+    const std::string& provider_type =
+        choice != choices.cend() ? *choice->second.device_provider : node.GetExecutionProviderType();
+    if (provider_type.empty() || IsHostProvider(provider_type)) {
+      return {false, 0, true};
+    }
+    // the kernel may read or write some tensors, such as shapes, in host memory
+    const KernelDef* kernel_def = get_kernel_def(node, provider_type);
+    if (kernel_def != nullptr && index < (is_input ? node.InputDefs().size() : node.OutputDefs().size()) &&
+        (is_input ? kernel_def->IsInputOnCpu(index) : kernel_def->IsOutputOnCpu(index))) {
+      return {false, 0, true};
+    }
+    if (choice != choices.cend()) {
+      return {true, choice->second.vertex, false};
+    }
+    return {false, 0, false};
+  };
+
+  MinCut min_cut(choices.size() + 2);
+  auto add_transfer = [&](const Endpoint& from, const Endpoint& to, const NodeArg& arg) {
+    if (!from.is_vertex && !to.is_vertex) {
+      return;
+    }
+    const double cost = TransferCost(arg);
+    if (from.is_vertex && to.is_vertex) {
+      min_cut.AddEdge(from.vertex, to.vertex, cost);
+      min_cut.AddEdge(to.vertex, from.vertex, cost);
+    } else {
+      const Endpoint& fixed = from.is_vertex ? to : from;
+      const size_t vertex = from.is_vertex ? from.vertex : to.vertex;
+      if (fixed.on_host) {
+        min_cut.AddEdge(kSource, vertex, cost);
+      } else {
+        min_cut.AddEdge(vertex, kSink, cost);
+      }
+    }
+  };
+
+  for (const auto& choice : choices) {
+    const Node& node = *graph.GetNode(choice.first);
+    min_cut.AddEdge(kSource, choice.second.vertex, NodeComputeCost(node, true));
+    min_cut.AddEdge(choice.second.vertex, kSink, NodeComputeCost(node, false));
+  }
+
+  // The graph inputs are fed from and the graph outputs fetched to host memory. The initializers are copied once by
+  // the session initialization. A tensor consumed by several nodes on the same device is only copied once, but is
+  // counted for each of them.
+  std::unordered_map<std::string, std::pair<const Node*, size_t>> producers;
+  for (const auto& node : graph.Nodes()) {
+    const auto& output_defs = node.OutputDefs();
+    for (size_t i = 0; i < output_defs.size(); ++i) {
+      if (output_defs[i]->Exists()) {
+        producers[output_defs[i]->Name()] = {&node, i};
+      }
+    }
+  }
+  const Endpoint host_endpoint{false, 0, true};
+  auto get_producer_endpoint = [&](const NodeArg& arg) -> Endpoint {
+    auto producer = producers.find(arg.Name());
+    return producer != producers.cend() ? get_endpoint(*producer->second.first, false, producer->second.second)
+                                        : host_endpoint;
+  };
+
+  for (const auto& node : graph.Nodes()) {
+    const auto& input_defs = node.InputDefs();
+    for (size_t i = 0; i < input_defs.size(); ++i) {
+      const auto& arg = *input_defs[i];
+      const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+      if (!arg.Exists() || graph.GetInitializedTensor(arg.Name(), initializer)) {
+        continue;
+      }
+      add_transfer(get_producer_endpoint(arg), get_endpoint(node, true, i), arg);
+    }
+    // the implicit inputs have no memory type in the kernel definition
+    for (const auto* implicit_input_def : node.ImplicitInputDefs()) {
+      const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+      if (implicit_input_def->Exists() && !graph.GetInitializedTensor(implicit_input_def->Name(), initializer)) {
+        add_transfer(get_producer_endpoint(*implicit_input_def), get_endpoint(node, true, SIZE_MAX),
+                     *implicit_input_def);
+      }
+    }
+  }
+  for (const auto* output : graph.GetOutputs()) {
+    add_transfer(get_producer_endpoint(*output), host_endpoint, *output);
+  }
+
+  const auto source_side = min_cut.Solve(kSource, kSink);
+  for (const auto& choice : choices) {
+    graph.GetNode(choice.first)
+        ->SetExecutionProviderType(source_side[choice.second.vertex] ? *choice.second.host_provider
+                                                                     : *choice.second.device_provider);
+  }
+}
+
+void GraphPartitioner::PlaceShapeComputationsOnHost(Graph& graph) const {
+  using namespace partitioning_cost_model;
+
+  if (providers_.Get(kCpuExecutionProvider) == nullptr) {
+    return;
+  }
+
+  // Whether a tensor is computed in host memory. The graph inputs are fed from host memory, and a device kernel
+  // may write some outputs, such as the output of Shape, in host memory.
+  std::unordered_map<std::string, std::pair<const Node*, size_t>> producers;
+  for (const auto& node : graph.Nodes()) {
+    const auto& output_defs = node.OutputDefs();
+    for (size_t i = 0; i < output_defs.size(); ++i) {
+      if (output_defs[i]->Exists()) {
+        producers[output_defs[i]->Name()] = {&node, i};
+      }
+    }
+  }
+  auto is_on_host = [&](const NodeArg& arg) {
+    auto producer = producers.find(arg.Name());
+    if (producer == producers.cend()) {
+      return true;
+    }
+    const Node& node = *producer->second.first;
+    if (node.GetExecutionProviderType().empty() || IsHostProvider(node.GetExecutionProviderType())) {
+      return true;
+    }
+    const KernelCreateInfo* kernel_create_info = nullptr;
+    return kernel_registry_mgr_.SearchKernelRegistry(node, &kernel_create_info).IsOK() &&
+           kernel_create_info->kernel_def->IsOutputOnCpu(producer->second.second);
+  };
+  auto is_small_integer_tensor = [](const NodeArg& arg) {
+    const auto* type = arg.TypeAsProto();
+    if (type == nullptr || !type->has_tensor_type()) {
+      return false;
+    }
+    const auto elem_type = type->tensor_type().elem_type();
+    return elem_type == ONNX_NAMESPACE::TensorProto_DataType_INT64 ||
+           elem_type == ONNX_NAMESPACE::TensorProto_DataType_INT32 ||
+           elem_type == ONNX_NAMESPACE::TensorProto_DataType_BOOL;
+  };
+
+  // A device node is moved if it reads some tensor computed in host memory, the rest of its inputs are in host
+  // memory or initializers, and its outputs are integer tensors. Its outputs are then in host memory too, so the
+  // nodes are visited until no more can move.
+  bool moved = true;
+  while (moved) {
+    moved = false;
+    for (auto& node : graph.Nodes()) {
+      const std::string provider_type = node.GetExecutionProviderType();
+      if (provider_type.empty() || IsHostProvider(provider_type) || !node.ImplicitInputDefs().empty() ||
+          GetPlacementOverride(node) != nullptr) {
+        continue;
+      }
+      bool reads_host_tensor = false;
+      bool all_inputs_on_host = true;
+      for (const auto* input_def : node.InputDefs()) {
+        const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+        if (!input_def->Exists() || graph.GetInitializedTensor(input_def->Name(), initializer)) {
+          continue;
+        }
+        if (!is_on_host(*input_def)) {
+          all_inputs_on_host = false;
+          break;
+        }
+        reads_host_tensor = reads_host_tensor || producers.count(input_def->Name()) != 0;
+      }
+      if (!reads_host_tensor || !all_inputs_on_host ||
+          !std::all_of(node.OutputDefs().cbegin(), node.OutputDefs().cend(), [&](const NodeArg* output_def) {
+            return !output_def->Exists() || is_small_integer_tensor(*output_def);
+          })) {
+        continue;
+      }
+      // the kernels are looked up for the provider the node is assigned to
+      node.SetExecutionProviderType(kCpuExecutionProvider);
+      if (KernelRegistryManager::HasImplementationOf(kernel_registry_mgr_, node, kCpuExecutionProvider)) {
+        moved = true;
+      } else {
+        node.SetExecutionProviderType(provider_type);
+      }
+    }
+  }
+}
+
 Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const {
   // It is a greedy partitioning algorithm per provider preferences user provided when calling ONNX RUNTIME right now.
   // 1. Execution providers' capabilities are checked one by one.
@@ -148,12 +529,40 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
   // TODO: when the graph contain a function node, and user pass in the dll which could
   // run the function by SessionOption, we should create a function kernel for it and
   // delegate the compute to the functions inside the dlls.
+  //
+  // With the cost-based partitioning, the single node capabilities are only collected in this loop. The nodes are
+  // assigned to one of the providers able to run them once all the capabilities are known.
+  NodeCandidates node_candidates;
   for (auto& provider : providers_) {
     int count = 0;
     std::vector<Node*> nodes_need_compile;
     std::vector<std::unique_ptr<ComputeCapability>> capabilities =
         provider->GetCapability(graph_viewer, kernel_registry_mgr_.GetKernelRegistriesByProviderType(provider->Type()));
     for (auto& capability : capabilities) {
+      if (capability->sub_graph == nullptr) {
+        continue;
+      }
+      // A node forced to another provider, or that a preferred provider can run, is not available.
+      bool available = true;
+      for (auto node_index : capability->sub_graph->nodes) {
+        const auto* node = graph.GetNode(node_index);
+        const std::string* placement_override = node != nullptr ? GetPlacementOverride(*node) : nullptr;
+        if ((placement_override != nullptr && *placement_override != provider->Type()) ||
+            (capability->sub_graph->GetMetaDef() != nullptr && node_candidates.count(node_index) != 0)) {
+          available = false;
+          break;
+        }
+      }
+      if (!available) {
+        continue;
+      }
+      if (mode_ == GraphPartitioningMode::CostBased && capability->sub_graph->GetMetaDef() == nullptr) {
+        const auto* node = graph.GetNode(capability->sub_graph->nodes[0]);
+        if (node != nullptr && node->GetExecutionProviderType().empty()) {
+          node_candidates[node->Index()].push_back(provider->Type());
+        }
+        continue;
+      }
       Node* n = PlaceNode(graph, std::move(capability->sub_graph), kernel_registry_mgr_, provider->Type(), count);
       if (n != nullptr) {
         nodes_need_compile.push_back(n);
@@ -186,6 +595,14 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
     }
   }
 
+  if (!node_candidates.empty()) {
+    AssignNodesByCost(graph, node_candidates);
+  }
+
+  if (mode_ == GraphPartitioningMode::Greedy) {
+    PlaceShapeComputationsOnHost(graph);
+  }
+
   ORT_RETURN_IF_ERROR(graph.Resolve());
 
   // To see if the node with no provider can be inlined. If one such nodes can be
@@ -228,6 +645,14 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
 
   if (!fused_kernel_registry->IsEmpty()) kernel_registry_mgr_.RegisterKernelRegistry(fused_kernel_registry);
 
+  for (const auto& node : graph.Nodes()) {
+    const std::string* placement_override = GetPlacementOverride(node);
+    if (placement_override != nullptr && node.GetExecutionProviderType() != *placement_override) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The node ", node.Name(), " (", node.OpType(),
+                             ") can't be placed on ", *placement_override, " as the override file requires");
+    }
+  }
+
   return Status::OK();
 }
 }  // namespace onnxruntime
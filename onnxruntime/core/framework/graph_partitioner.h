@@ -3,29 +3,62 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "core/common/common.h"
+#include "core/common/path_string.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/fuse_nodes_funcs.h"
+#include "core/framework/session_options.h"
 
 namespace onnxruntime {
 
 class ExecutionProviders;
 class KernelRegistryManager;
 
+// The execution provider type to place a node on, keyed by node name.
+using NodePlacementOverrides = std::unordered_map<std::string, std::string>;
+
 class GraphPartitioner {
  public:
   //The order of providers represents the user preference.
-  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers)
+  //The nodes named in placement_overrides are only placed on the given provider.
+  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers,
+                   GraphPartitioningMode mode = GraphPartitioningMode::Greedy,
+                   const NodePlacementOverrides* placement_overrides = nullptr)
       : kernel_registry_mgr_(kernel_registry_mgr),
-        providers_(providers) {}
+        providers_(providers),
+        mode_(mode),
+        placement_overrides_(placement_overrides) {}
 
   Status Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const;
 
+  // Loads the node placement overrides from a file with a "<node name> <execution provider type>" line per node.
+  // Empty lines and lines starting with '#' are ignored.
+  static Status LoadPlacementOverrides(const PathString& file_path, NodePlacementOverrides& placement_overrides);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphPartitioner);
 
+  // The providers that can run each node with a single node kernel, in preference order.
+  using NodeCandidates = std::unordered_map<NodeIndex, std::vector<std::string>>;
+
+  const std::string* GetPlacementOverride(const Node& node) const;
+
+  // Assigns the nodes with candidate providers so that the estimated time to run the graph, including the copies
+  // between the host and the device, is minimal.
+  void AssignNodesByCost(Graph& graph, const NodeCandidates& node_candidates) const;
+
+  // Moves the nodes computing small integer tensors, such as shapes, from host memory back to the CPU provider, so
+  // that the greedy partitioning doesn't copy them to the device and back.
+  void PlaceShapeComputationsOnHost(Graph& graph) const;
+
   KernelRegistryManager& kernel_registry_mgr_;
   const ExecutionProviders& providers_;
+  GraphPartitioningMode mode_;
+  const NodePlacementOverrides* placement_overrides_;
 };
 }  // namespace onnxruntime
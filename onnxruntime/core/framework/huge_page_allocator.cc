@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/huge_page_allocator.h"
+
+#include "core/framework/utils.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+HugePageCPUAllocator::~HugePageCPUAllocator() {
+  // the owner is expected to have freed everything, but don't leak the pages if it didn't
+  for (const auto& allocation : huge_page_allocations_) {
+    Env::Default().FreeHugePages(allocation.first, allocation.second);
+  }
+}
+
+void* HugePageCPUAllocator::Alloc(size_t size) {
+  void* p = Env::Default().AllocateHugePages(size, /*prefault*/ true);
+  if (p == nullptr) {
+    return utils::DefaultAlloc(size);
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  huge_page_allocations_[p] = size;
+  return p;
+}
+
+void HugePageCPUAllocator::Free(void* p) {
+  if (p == nullptr) return;
+
+  size_t size = 0;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = huge_page_allocations_.find(p);
+    if (it != huge_page_allocations_.end()) {
+      size = it->second;
+      huge_page_allocations_.erase(it);
+    }
+  }
+
+  if (size != 0) {
+    Env::Default().FreeHugePages(p, size);
+  } else {
+    utils::DefaultFree(p);
+  }
+}
+
+}  // namespace onnxruntime
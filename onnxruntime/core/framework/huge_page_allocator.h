@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// CPU allocator backed by huge pages that are faulted in when allocated, so the regions of an arena on top of it
+// take fewer TLB misses and the first use of a fresh region doesn't stall on page faults. The faults are taken
+// when the arena extends or reserves memory instead.
+// Falls back to the default CPU allocation if the platform can't allocate huge pages.
+class HugePageCPUAllocator : public IDeviceAllocator {
+ public:
+  HugePageCPUAllocator() : IDeviceAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
+
+  ~HugePageCPUAllocator() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(HugePageCPUAllocator);
+
+  // the platform needs the size to release huge page allocations
+  OrtMutex mutex_;
+  std::unordered_map<void*, size_t> huge_page_allocations_;
+};
+
+}  // namespace onnxruntime
@@ -46,5 +46,9 @@ namespace onnxruntime {
     size_t MiMallocArena::AllocatedSize(const void* ptr) {
         return mi_usable_size(ptr);
     }
+
+    void MiMallocArena::EnableLargeOsPages() {
+        mi_option_enable(mi_option_large_os_pages);
+    }
 }
 #endif
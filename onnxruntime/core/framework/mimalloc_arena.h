@@ -1,3 +1,5 @@
+#pragma once
+
 #if defined(USE_MIMALLOC_ARENA_ALLOCATOR)
 #include "core/common/common.h"
 #include "core/framework/arena.h"
@@ -13,7 +15,7 @@ class MiMallocArena : public IArenaAllocator {
     void Free(void* p) override;
 
     // mimalloc only maintains stats when compiled under debug, or when MI_STAT >= 2
-    void GetStats(AllocatorStats* stats);
+    void GetStats(AllocatorStats* stats) override;
 
     void* Reserve(size_t size) override;
 
@@ -29,6 +31,10 @@ class MiMallocArena : public IArenaAllocator {
 
     size_t AllocatedSize(const void* ptr);
 
+    // Makes mimalloc back its segments with huge pages. This is a process wide setting of mimalloc, and
+    // only applies to the segments it allocates afterwards.
+    static void EnableLargeOsPages();
+
     OrtMemoryInfo info_;
     AllocatorStats stats_;
 };
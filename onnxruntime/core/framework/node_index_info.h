@@ -42,6 +42,13 @@ class NodeIndexInfo final {
     return node_values_[offset];
   }
 
+  // Get the ort_value indexes of the count entries starting at offset, e.g. all the entries of a Node.
+  // Lets the caller resolve each entry without the bounds check of GetMLValueIndex.
+  const int* GetMLValueIndexes(int offset, size_t count) const {
+    ORT_ENFORCE(offset >= 0 && static_cast<size_t>(offset) + count <= node_values_size_);
+    return node_values_.data() + offset;
+  }
+
   int GetMaxMLValueIdx() const { return max_mlvalue_idx_; }
 
  private:
@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_placements.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "core/framework/execution_providers.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+// The placements are stored one node per line as "<op type>\t<node name>\t<provider>", in a pre-order traversal
+// visiting the nodes of a graph in the order they are serialized, and after each node its subgraphs ordered by the
+// name of their attribute. A graph loaded from the GraphProto has its nodes in the same order.
+static constexpr char kFieldSeparator = '\t';
+static constexpr char kLineSeparator = '\n';
+
+static std::vector<Graph*> GetSortedSubgraphs(Node& node) {
+  std::vector<std::pair<std::string, Graph*>> subgraphs;
+  for (const auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+    subgraphs.emplace_back(entry.first, entry.second);
+  }
+  std::sort(subgraphs.begin(), subgraphs.end());
+
+  std::vector<Graph*> sorted;
+  sorted.reserve(subgraphs.size());
+  for (const auto& entry : subgraphs) {
+    sorted.push_back(entry.second);
+  }
+  return sorted;
+}
+
+static Status SaveGraphNodePlacements(Graph& graph, std::ostringstream& out) {
+  GraphViewer graph_viewer(graph);
+  for (auto node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node& node = *graph.GetNode(node_index);
+    if (node.NodeType() == Node::Type::Fused) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Node placements can't be saved for the node ",
+                             node.Name(), " compiled by ", node.GetExecutionProviderType());
+    }
+
+    const std::string& provider = node.GetExecutionProviderType();
+    if (provider.empty() ||
+        node.OpType().find_first_of("\t\n") != std::string::npos ||
+        node.Name().find_first_of("\t\n") != std::string::npos) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Node placements can't be saved for the node ",
+                             node.Name());
+    }
+
+    out << node.OpType() << kFieldSeparator << node.Name() << kFieldSeparator << provider << kLineSeparator;
+
+    for (Graph* subgraph : GetSortedSubgraphs(node)) {
+      ORT_RETURN_IF_ERROR(SaveGraphNodePlacements(*subgraph, out));
+    }
+  }
+
+  return Status::OK();
+}
+
+Status SaveNodePlacements(Graph& graph, std::string& node_placements) {
+  std::ostringstream out;
+  ORT_RETURN_IF_ERROR(SaveGraphNodePlacements(graph, out));
+  node_placements = out.str();
+  return Status::OK();
+}
+
+static Status ApplyGraphNodePlacements(Graph& graph, const std::string& node_placements, size_t& pos,
+                                       const ExecutionProviders& providers) {
+  for (auto& node : graph.Nodes()) {
+    const size_t line_end = node_placements.find(kLineSeparator, pos);
+    const size_t op_type_end = node_placements.find(kFieldSeparator, pos);
+    const size_t name_end = op_type_end == std::string::npos
+                                ? std::string::npos
+                                : node_placements.find(kFieldSeparator, op_type_end + 1);
+    if (line_end == std::string::npos || name_end == std::string::npos || name_end > line_end) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The node placements saved with the model don't match "
+                             "its graph: no placement for the node ", node.Name());
+    }
+
+    if (node_placements.compare(pos, op_type_end - pos, node.OpType()) != 0 ||
+        node_placements.compare(op_type_end + 1, name_end - op_type_end - 1, node.Name()) != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The node placements saved with the model don't match "
+                             "its graph at the node ", node.Name(), " (", node.OpType(), ")");
+    }
+
+    std::string provider = node_placements.substr(name_end + 1, line_end - name_end - 1);
+    if (providers.Get(provider) == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The node ", node.Name(),
+                             " of the optimized model was assigned to ", provider,
+                             " which is not registered with the session.");
+    }
+
+    node.SetExecutionProviderType(provider);
+    pos = line_end + 1;
+
+    for (Graph* subgraph : GetSortedSubgraphs(node)) {
+      ORT_RETURN_IF_ERROR(ApplyGraphNodePlacements(*subgraph, node_placements, pos, providers));
+    }
+  }
+
+  return Status::OK();
+}
+
+Status ApplyNodePlacements(Graph& graph, const std::string& node_placements, const ExecutionProviders& providers) {
+  size_t pos = 0;
+  ORT_RETURN_IF_ERROR(ApplyGraphNodePlacements(graph, node_placements, pos, providers));
+  if (pos != node_placements.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The node placements saved with the model don't match its "
+                           "graph: the graph has fewer nodes.");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/common/common.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+class ExecutionProviders;
+
+// Key of the model metadata entry holding the node placements of an optimized model saved by a session.
+constexpr const char* kNodePlacementsMetadataKey = "onnxruntime.node_placements";
+
+// Serialize the execution provider assigned to each node of a partitioned graph and of its subgraphs, in the order
+// of the nodes in the serialized graph.
+// Fails if the graph contains nodes fused by an execution provider, as compiled nodes can't be serialized.
+Status SaveNodePlacements(Graph& graph, std::string& node_placements);
+
+// Assign the nodes of a graph loaded from an optimized model, and of its subgraphs, to the execution providers
+// recorded by SaveNodePlacements when the model was saved. The providers must be registered with the session.
+Status ApplyNodePlacements(Graph& graph, const std::string& node_placements, const ExecutionProviders& providers);
+
+}  // namespace onnxruntime
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/numa_allocator.h"
+
+#include "core/framework/utils.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+NumaCPUAllocator::~NumaCPUAllocator() {
+  // the owner is expected to have freed everything, but don't leak the pages if it didn't
+  for (const auto& allocation : numa_allocations_) {
+    Env::Default().FreeOnNumaNode(allocation.first, allocation.second);
+  }
+}
+
+void* NumaCPUAllocator::Alloc(size_t size) {
+  void* p = Env::Default().AllocateOnNumaNode(size, numa_node_);
+  if (p == nullptr) {
+    return utils::DefaultAlloc(size);
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  numa_allocations_[p] = size;
+  return p;
+}
+
+void NumaCPUAllocator::Free(void* p) {
+  if (p == nullptr) return;
+
+  size_t size = 0;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = numa_allocations_.find(p);
+    if (it != numa_allocations_.end()) {
+      size = it->second;
+      numa_allocations_.erase(it);
+    }
+  }
+
+  if (size != 0) {
+    Env::Default().FreeOnNumaNode(p, size);
+  } else {
+    utils::DefaultFree(p);
+  }
+}
+
+}  // namespace onnxruntime
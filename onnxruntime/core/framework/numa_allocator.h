@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// CPU allocator that places memory on a specific NUMA node, so an arena on top of it keeps its memory local to the
+// threads bound to that node regardless of which thread first touches it.
+// Falls back to the default CPU allocation if the platform can't allocate on the node.
+class NumaCPUAllocator : public IDeviceAllocator {
+ public:
+  explicit NumaCPUAllocator(int numa_node)
+      : IDeviceAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)), numa_node_(numa_node) {}
+
+  ~NumaCPUAllocator() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  int NumaNode() const noexcept { return numa_node_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NumaCPUAllocator);
+
+  const int numa_node_;
+
+  // the platform needs the size to release NUMA allocations
+  OrtMutex mutex_;
+  std::unordered_map<void*, size_t> numa_allocations_;
+};
+
+}  // namespace onnxruntime
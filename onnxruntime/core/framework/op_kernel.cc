@@ -15,9 +15,18 @@ OpKernelContext::OpKernelContext(_Inout_ IExecutionFrame* frame, _In_ const OpKe
   ORT_ENFORCE(frame != nullptr, "Execution frame was null");
   ORT_ENFORCE(kernel != nullptr, "OpKernel was null");
 
-  node_input_start_index_ = frame->GetNodeOffset(kernel->Node().Index());
-  node_implicit_input_start_index_ = node_input_start_index_ + InputCount();
-  node_output_start_index_ = node_implicit_input_start_index_ + ImplicitInputCount();
+  const auto& node = kernel->Node();
+  input_count_ = static_cast<int>(node.InputDefs().size());
+  implicit_input_count_ = static_cast<int>(node.ImplicitInputDefs().size());
+  output_count_ = static_cast<int>(node.OutputDefs().size());
+
+  node_input_start_index_ = frame->GetNodeOffset(node.Index());
+  node_implicit_input_start_index_ = node_input_start_index_ + input_count_;
+  node_output_start_index_ = node_implicit_input_start_index_ + implicit_input_count_;
+
+  arg_ort_value_idxs_ = frame->GetNodeIdxToMLValueIdxs(
+      node_input_start_index_, static_cast<size_t>(input_count_ + implicit_input_count_ + output_count_));
+  frame_values_ = frame->GetMLValues();
 }
 
 Tensor* OpKernelContext::Output(int index, const TensorShape& shape) {
@@ -25,6 +34,17 @@ Tensor* OpKernelContext::Output(int index, const TensorShape& shape) {
   return p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
 }
 
+Tensor* OpKernelContext::OutputView(int index, const TensorShape& shape, int input_index, size_t byte_offset) {
+  if (index < 0 || index >= OutputCount() || input_index < 0 || input_index >= InputCount())
+    return nullptr;
+
+  OrtValue* p_ml_value = nullptr;
+  Status status = execution_frame_->TryCreateNodeOutputView(GetOutputArgIndex(index), GetInputArgIndex(input_index),
+                                                            shape, byte_offset, p_ml_value);
+  ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+  return p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
+}
+
 SparseTensor* OpKernelContext::Output(int index, size_t nnz, const TensorShape& shape) {
   auto p_ml_value = OutputMLValue(index, shape, nnz);
   return p_ml_value ? p_ml_value->GetMutable<SparseTensor>() : nullptr;
@@ -34,6 +54,15 @@ OrtValue* OpKernelContext::OutputMLValue(int index, const TensorShape& shape, si
   if (index < 0 || index >= OutputCount())
     return nullptr;
 
+  // Fast path for outputs that already exist with the requested shape, e.g. graph outputs provided by the caller.
+  OrtValue* p_output = GetArgMLValue(input_count_ + implicit_input_count_ + index);
+  if (p_output == nullptr) {
+    return nullptr;
+  }
+  if (p_output->IsAllocated() && p_output->IsTensor() && p_output->Get<Tensor>().Shape() == shape) {
+    return p_output;
+  }
+
   //: Though we don't need to give 'ret' an initial value, GCC would generate a warning if we don't do that
   //"error: 'ret' may be used uninitialized in this function"
   //This warning only exists in Release build.
@@ -127,28 +156,4 @@ const std::string& OpKernelContext::GetOpDomain() const {
   return kernel_->KernelDef().Domain();
 }
 
-const OrtValue* OpKernelContext::GetInputMLValue(int index) const {
-  if (index < 0 || index >= InputCount())
-    return nullptr;
-
-  int input_arg_index = GetInputArgIndex(index);
-  return execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index);
-}
-
-const OrtValue* OpKernelContext::GetImplicitInputMLValue(int index) const {
-  if (index < 0 || index >= ImplicitInputCount())
-    return nullptr;
-
-  int input_arg_index = GetImplicitInputArgIndex(index);
-  return execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index);
-}
-
-OrtValue* OpKernelContext::GetOutputMLValue(int index) {
-  if (index < 0 || index >= OutputCount())
-    return nullptr;
-
-  auto output_arg_index = GetOutputArgIndex(index);
-  return execution_frame_->GetMutableNodeInputOrOutputMLValue(output_arg_index);
-}
-
 }  // namespace onnxruntime
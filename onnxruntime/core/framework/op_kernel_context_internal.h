@@ -41,8 +41,13 @@ class OpKernelContextInternal : public OpKernelContext {
     return session_state_.GetUseDeterministicCompute();
   }
   
+  // Get the SessionState of a subgraph of the node, finalizing it first if its initialization was deferred.
   const SessionState* SubgraphSessionState(const std::string& attribute_name) {
-    return session_state_.GetSubgraphSessionState(GetNodeIndex(), attribute_name);
+    const auto* subgraph_session_state = session_state_.GetSubgraphSessionState(GetNodeIndex(), attribute_name);
+    if (subgraph_session_state != nullptr) {
+      ORT_THROW_IF_ERROR(subgraph_session_state->RunDeferredInitialization());
+    }
+    return subgraph_session_state;
   }
 
   const OrtValue* GetInputMLValue(int index) const {
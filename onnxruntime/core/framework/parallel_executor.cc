@@ -3,27 +3,53 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parallel_for_cost_table.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
 #include "core/platform/threadpool.h"
+#include "core/profile/hardware_counters.h"
+
+#ifdef ENABLE_ITT_PROFILE
+// This header is for profile using Intel VTune.
+#include "core/profile/profile.h"
+#endif
 
 namespace onnxruntime {
 
-ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_(terminate_flag), executor_pool_(session_state.GetInterOpThreadPool()) {
+namespace {
+// A node is cheap if its kernel only creates a view of an input or reads the shape of one.
+// Checked from the kernel definition, so the kernels created on first use aren't created by the check.
+bool IsCheapNode(const Node& node, const KernelDef* kernel_def) {
+  if (kernel_def == nullptr) return false;
+  if (node.GetExecutionProviderType() != kCpuExecutionProvider) return false;
+  const auto& op_type = node.OpType();
+  return !kernel_def->Alias().empty() || op_type == "Shape" || op_type == "Size";
+}
+}  // namespace
+
+ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag,
+                                   bool only_execute_path_to_fetches)
+    : node_refs_(session_state.GetGraphViewer().MaxNodeIndex()),
+      cheap_nodes_(session_state.GetGraphViewer().MaxNodeIndex(), false),
+      out_standings_(0),
+      has_errors_(false),
+      terminate_flag_(terminate_flag),
+      only_execute_path_to_fetches_(only_execute_path_to_fetches),
+      executor_pool_(session_state.GetInterOpThreadPool()) {
   const auto& graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer.MaxNodeIndex());
   for (auto& node : graph_viewer.Nodes()) {
     node_refs_[node.Index()] = node.GetInputEdgesCount();
+    cheap_nodes_[node.Index()] = IsCheapNode(node, session_state.GetKernelDef(node.Index()));
   }
 }
 
@@ -40,13 +66,24 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
 
   root_frame_ = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
                                                          fetch_allocators, session_state);
-  //std::cout << "start nodes:" << std::endl;
+  if (only_execute_path_to_fetches_) {
+    to_be_executed_nodes_ = session_state.GetToBeExecutedNodes(fetch_mlvalue_idxs);
+  }
+
+  // start the nodes on the critical path first
+  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  std::vector<NodeIndex> root_nodes;
   for (auto node_index : session_state.GetGraphViewer().GetRootNodes()) {
-    auto p_op_kernel = session_state.GetKernel(node_index);
-    if (!p_op_kernel)
-      continue;
+    if (session_state.GetKernel(node_index) != nullptr && IsNodeToBeExecuted(node_index)) {
+      root_nodes.push_back(node_index);
+    }
+  }
+
+  std::stable_sort(root_nodes.begin(), root_nodes.end(), [&exec_plan](NodeIndex lhs, NodeIndex rhs) {
+    return exec_plan.NodePriority(lhs) > exec_plan.NodePriority(rhs);
+  });
 
-    //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
+  for (auto node_index : root_nodes) {
     EnqueueNode(node_index, session_state, logger);
   }
 
@@ -114,16 +151,36 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
 
   Status status = Status::OK();
 
-  size_t node_index = p_node_index;
-  bool keep_running = true;
+  // Nodes that became ready in this thread and are run here rather than scheduled on the thread pool:
+  // any number of cheap nodes, which are run first, and at most one other node to continue with.
+  std::vector<size_t> ready_cheap_nodes;
+  std::vector<size_t> ready_nodes;
+  size_t next_node_index = p_node_index;
+  bool has_next_node = true;
+
   const auto& graph_viewer = session_state.GetGraphViewer();
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
   const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  const bool collect_node_stats = session_state.GetCollectNodeStats();
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  // the nodes run by this call are all on the calling thread
+  profile::HardwareCounters* hardware_counters =
+      f_profiler_enabled && session_state.GetProfileHardwareCounters() ? profile::HardwareCounters::ForCurrentThread()
+                                                                      : nullptr;
+  profile::HardwareCounterValues kernel_begin_counters;
 
   // Avoid context switching if possible.
-  while (keep_running) {
+  while (!ready_cheap_nodes.empty() || has_next_node) {
+    size_t node_index;
+    if (!ready_cheap_nodes.empty()) {
+      node_index = ready_cheap_nodes.back();
+      ready_cheap_nodes.pop_back();
+    } else {
+      node_index = next_node_index;
+      has_next_node = false;
+    }
+
     // TODO: Convert RunNodeAsync return Status.
     // to also handle exception propagation
     if (terminate_flag_) {
@@ -184,17 +241,38 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                                      {{"op_name", p_op_kernel->KernelDef().OpName()}});
 
       kernel_begin_time = session_state.Profiler().StartTime();
+      if (hardware_counters != nullptr) {
+        kernel_begin_counters = hardware_counters->Read();
+      }
     }
 
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << node.Name();
 
+    TimePoint node_stats_begin_time;
+    uint64_t num_work_items_before = 0;
+    if (collect_node_stats) {
+      node_stats_begin_time = std::chrono::high_resolution_clock::now();
+      num_work_items_before = concurrency::ThreadPool::NumWorkItemsScheduledByCurrentThread();
+    }
+
+    // attribute the ParallelFor loops of the kernel to its operator for the cost table
+    concurrency::ParallelForCostTable::OpScope cost_table_scope(node.OpType());
+
     // Execute the kernel.
+#ifdef ENABLE_ITT_PROFILE
+    profile::IttRangeCreator node_compute_range(MakeString(node.OpType(), ".", node.Index(), "(", node.Name(), ")"),
+                                                profile::Color::Blue);
+    node_compute_range.Begin();
+#endif
     try {
       status = p_op_kernel->Compute(&op_kernel_context);
     } catch (const std::exception& ex) {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
     }
+#ifdef ENABLE_ITT_PROFILE
+    node_compute_range.End();
+#endif
 
     if (!status.IsOK()) {
       std::ostringstream ss;
@@ -206,11 +284,32 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       break;
     }
 
+    if (collect_node_stats) {
+      size_t output_bytes = 0;
+      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+        const OrtValue* p_output = op_kernel_context.GetOutputMLValue(output_index);
+        if (p_output != nullptr && p_output->IsTensor()) {
+          output_bytes += p_output->Get<Tensor>().SizeInBytes();
+        }
+      }
+      session_state.Profiler().RecordNodeStats(
+          node_index, node_stats_begin_time, output_bytes,
+          concurrency::ThreadPool::NumWorkItemsScheduledByCurrentThread() - num_work_items_before);
+    }
+
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+      const TimePoint kernel_end_time = std::chrono::high_resolution_clock::now();
+      std::unordered_map<std::string, std::string> event_args{{"op_name", p_op_kernel->KernelDef().OpName()},
+                                                              {"provider", p_op_kernel->KernelDef().Provider()}};
+      if (hardware_counters != nullptr) {
+        profile::HardwareCounters::AddEventArgs(kernel_begin_counters, hardware_counters->Read(), event_args);
+      }
+      session_state.Profiler().RecordEvent(profiling::NODE_EVENT,
+                                           node.Name() + "_kernel_time",
+                                           kernel_begin_time,
+                                           kernel_end_time,
+                                           logging::GetThreadId(),
+                                           std::move(event_args));
 
       sync_time_begin = session_state.Profiler().StartTime();
     }
@@ -244,30 +343,31 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                                      {{"op_name", p_op_kernel->KernelDef().OpName()}});
     }
 
-    //std::cout << "Run async node finish: " << p_node_index << std::endl;
-
-    keep_running = false;
-
     // Checking which output nodes ready for running.
-    {
-      auto begin = node.OutputEdgesBegin();
-      auto end = node.OutputEdgesEnd();
-
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
-      for (auto it = begin; it != end; it++) {
-        auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
-          }
+    ready_nodes.clear();
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      auto idx = (*it).GetNode().Index();
+      // the thread that consumes the last input edge owns the node
+      if (IsNodeToBeExecuted(idx) && --node_refs_[idx] == 0) {
+        if (cheap_nodes_[idx]) {
+          ready_cheap_nodes.push_back(idx);
+        } else {
+          ready_nodes.push_back(idx);
         }
+      }
+    }
 
-        // std::cout << "handle output, current name: " << node.Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
+    // continue with the ready node on the critical path and schedule the others in priority order
+    std::stable_sort(ready_nodes.begin(), ready_nodes.end(), [&exec_plan](size_t lhs, size_t rhs) {
+      return exec_plan.NodePriority(lhs) > exec_plan.NodePriority(rhs);
+    });
+
+    for (auto idx : ready_nodes) {
+      if (!has_next_node) {
+        next_node_index = idx;
+        has_next_node = true;
+      } else {
+        EnqueueNode(idx, session_state, logger);
       }
     }
   }
@@ -276,14 +376,11 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
 }
 
 void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
-  {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    // if there are errors there's no point queuing more work
-    if (!errors_.empty())
-      return;
+  // if there are errors there's no point queuing more work
+  if (has_errors_)
+    return;
 
-    out_standings_++;
-  }
+  ++out_standings_;
 
   executor_pool_->Schedule([this, p_node_index, &session_state, &logger]() {
     auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
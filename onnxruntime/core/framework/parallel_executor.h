@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <unordered_set>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
@@ -20,7 +22,8 @@ class ExecutionFrame;
 
 class ParallelExecutor : public IExecutor {
  public:
-  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false);
+  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false,
+                   bool only_execute_path_to_fetches = false);
 
   common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                          const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
@@ -35,31 +38,42 @@ class ParallelExecutor : public IExecutor {
 
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  bool IsNodeToBeExecuted(NodeIndex node_index) const {
+    return to_be_executed_nodes_ == nullptr || to_be_executed_nodes_->count(node_index) != 0;
+  }
+
   void FinishNodeRun(const Status& status) {
-    bool finished = false;
-    {
-      //Because we have a mutex here, it's not possible another thread is doing the test("while (out_standings_ > 0)"
+    if (!status.IsOK()) {
       std::lock_guard<OrtMutex> lock(complete_mutex_);
-      finished = --out_standings_ == 0;
-      if (!status.IsOK())
-        errors_.push_back(status);
+      errors_.push_back(status);
+      has_errors_ = true;
     }
 
-    if (finished) {
-      //std::cout << "all out standing nodes are completed." << std::endl;
+    if (--out_standings_ == 0) {
+      // take the lock so the notification can't be lost between the waiting thread testing
+      // "while (out_standings_ > 0)" and starting to wait.
+      { std::lock_guard<OrtMutex> lock(complete_mutex_); }
       complete_cv_.notify_all();
     }
   }
 
   std::unique_ptr<ExecutionFrame> root_frame_;
-  std::vector<size_t> node_refs_;
-  OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+  // number of input edges of each node that are yet to be produced. a node is ready when this reaches zero.
+  std::vector<std::atomic<size_t>> node_refs_;
+  // nodes that are cheap enough (view ops, shape queries) that scheduling them on the thread pool
+  // costs more than running them in the thread that made them ready.
+  std::vector<bool> cheap_nodes_;
+  std::atomic<int> out_standings_;
+  std::atomic<bool> has_errors_;
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
-  std::vector<Status> errors_;
+  std::vector<Status> errors_;  // protected by complete_mutex_
 
   const bool& terminate_flag_;
+  const bool only_execute_path_to_fetches_;
+  // the nodes the fetches depend on, if only those are executed. every input of such a node is produced by
+  // another one, so the others never become ready.
+  const std::unordered_set<NodeIndex>* to_be_executed_nodes_ = nullptr;
   // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
   onnxruntime::concurrency::ThreadPool* const executor_pool_{};
 };
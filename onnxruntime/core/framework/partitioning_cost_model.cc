@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/partitioning_cost_model.h"
+
+#include "core/graph/constants.h"
+#include "core/graph/graph.h"
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+namespace partitioning_cost_model {
+
+// Nominal throughputs and overheads of the host and of a device.
+static constexpr double kHostOpsPerMicrosecond = 1e4;
+static constexpr double kDeviceOpsPerMicrosecond = 1e6;
+static constexpr double kHostNodeOverhead = 1.0;
+static constexpr double kDeviceNodeOverhead = 5.0;
+static constexpr double kTransferBytesPerMicrosecond = 1e4;
+static constexpr double kTransferLatency = 10.0;
+
+// Assumed size of a symbolic dimension, and number of elements of a tensor of unknown rank.
+static constexpr double kSymbolicDimValue = 32.0;
+static constexpr double kUnknownShapeElements = 1024.0;
+
+bool IsHostProvider(const std::string& provider_type) {
+  return provider_type == kCpuExecutionProvider ||
+         provider_type == kDnnlExecutionProvider ||
+         provider_type == kNGraphExecutionProvider ||
+         provider_type == kNupharExecutionProvider ||
+         provider_type == kVitisAIExecutionProvider ||
+         provider_type == kOpenVINOExecutionProvider ||
+         provider_type == kNnapiExecutionProvider ||
+         provider_type == kAclExecutionProvider ||
+         provider_type == kArmNNExecutionProvider;
+}
+
+static double DimValue(const ONNX_NAMESPACE::TensorShapeProto_Dimension& dim) {
+  return dim.has_dim_value() ? static_cast<double>(dim.dim_value()) : kSymbolicDimValue;
+}
+
+static double NumElements(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return kUnknownShapeElements;
+  }
+  double num_elements = 1.0;
+  for (const auto& dim : shape->dim()) {
+    num_elements *= DimValue(dim);
+  }
+  return num_elements;
+}
+
+static double ElementSize(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return 4.0;
+  }
+  switch (type->tensor_type().elem_type()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+      return 1.0;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+      return 2.0;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+      return 8.0;
+    default:
+      return 4.0;
+  }
+}
+
+// Returns the number of multiply-adds per output element of the ops reducing over an input dimension.
+static double ReductionSize(const Node& node) {
+  const auto& input_defs = node.InputDefs();
+  const auto& op_type = node.OpType();
+  if (op_type == "Conv" || op_type == "FusedConv") {
+    // the weights are [M, C/group, kH, kW, ...]
+    const auto* w_shape = input_defs.size() > 1 ? input_defs[1]->Shape() : nullptr;
+    if (w_shape != nullptr && w_shape->dim_size() > 1) {
+      double size = 1.0;
+      for (int i = 1; i < w_shape->dim_size(); ++i) {
+        size *= DimValue(w_shape->dim(i));
+      }
+      return size;
+    }
+  } else if (op_type == "MatMul" || op_type == "FusedMatMul" || op_type == "Gemm" || op_type == "FusedGemm") {
+    const auto* a_shape = !input_defs.empty() ? input_defs[0]->Shape() : nullptr;
+    if (a_shape != nullptr && a_shape->dim_size() > 0) {
+      int k_axis = a_shape->dim_size() - 1;
+      const auto& attributes = node.GetAttributes();
+      auto trans_a = attributes.find("transA");
+      if (trans_a != attributes.cend() && trans_a->second.i() != 0 && a_shape->dim_size() == 2) {
+        k_axis = 0;
+      }
+      return DimValue(a_shape->dim(k_axis));
+    }
+  }
+  return 1.0;
+}
+
+double NodeComputeCost(const Node& node, bool on_device) {
+  double output_elements = 0.0;
+  for (const auto* output_def : node.OutputDefs()) {
+    if (output_def->Exists()) {
+      output_elements += NumElements(*output_def);
+    }
+  }
+  const double ops = output_elements * ReductionSize(node);
+  return on_device ? kDeviceNodeOverhead + ops / kDeviceOpsPerMicrosecond
+                   : kHostNodeOverhead + ops / kHostOpsPerMicrosecond;
+}
+
+double TransferCost(const NodeArg& arg) {
+  return kTransferLatency + NumElements(arg) * ElementSize(arg) / kTransferBytesPerMicrosecond;
+}
+
+}  // namespace partitioning_cost_model
+}  // namespace onnxruntime
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+namespace onnxruntime {
+
+class Node;
+class NodeArg;
+
+// Estimates, in microseconds, of the time to run a node on the host (CPU) or on a device such as a GPU, and of the
+// time to copy a tensor between the host and the device. They are used by the cost-based graph partitioning to
+// choose between the execution providers that can run a node, so they only need to rank the placements: the
+// compute cost of a node is proportional to its output size, times the reduction size for Conv, MatMul and Gemm.
+namespace partitioning_cost_model {
+
+// Whether the nodes assigned to the provider read and write their tensors in host memory, i.e. the MemcpyTransformer
+// doesn't insert copies between them and the CPU execution provider.
+bool IsHostProvider(const std::string& provider_type);
+
+double NodeComputeCost(const Node& node, bool on_device);
+
+double TransferCost(const NodeArg& arg);
+
+}  // namespace partitioning_cost_model
+}  // namespace onnxruntime
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Process wide cache that lets kernels share the packed copies of their constant weights, including kernels of
+// different sessions, so that the replicas of a model hold a single copy of each packed weight.
+// A kernel packs a weight into a buffer obtained from Allocator() and hands it to Share, which returns either that
+// buffer or an identical buffer that is already in use. Buffers are identical if they have the same format and the
+// same packed bytes, so the returned buffer can be used in place of the one that was packed.
+// The cache only holds weak references: a packed buffer is freed once the last kernel using it is destroyed.
+class PrepackedWeightsCache final {
+ public:
+  static PrepackedWeightsCache& Instance();
+
+  // Allocator for buffers passed to Share. It is independent of any session, so shared buffers don't keep the
+  // memory arena of the session that packed them alive.
+  const AllocatorPtr& Allocator() const { return allocator_; }
+
+  // Returns the shared buffer for the `size` bytes of packed data in `buffer`. `format` identifies the packing
+  // routine, e.g. "MlasSgemmPackB", so buffers produced by different routines are never shared.
+  std::shared_ptr<void> Share(const std::string& format, BufferUniquePtr buffer, size_t size);
+
+  // Number of packed buffers that are currently in use.
+  size_t NumSharedBuffers();
+
+ private:
+  PrepackedWeightsCache();
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsCache);
+
+  struct Entry {
+    std::string format;
+    size_t size;
+    std::weak_ptr<void> buffer;
+  };
+
+  void RemoveExpiredEntries();
+
+  AllocatorPtr allocator_;
+  OrtMutex mutex_;
+  // entries keyed by a hash of the packed bytes
+  std::unordered_multimap<uint64_t, Entry> entries_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,238 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_store.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <random>
+
+#include "core/framework/allocator.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
+#include "core/util/qmath.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// A file starts with the magic, then the platform tag, the model ID and the number of weights. Each weight is its
+// key and its size followed by its packed bytes, which start at a multiple of the buffer alignment so they can be
+// used in place once the file is mapped. Strings are stored as their 32-bit length followed by their characters,
+// counts and sizes as 64-bit values, all in the byte order of the platform, which is part of the tag.
+constexpr char kMagic[8] = {'O', 'R', 'T', 'P', 'A', 'C', 'K', '3'};
+
+template <typename T>
+void WriteValue(std::ofstream& out, T value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::ofstream& out, const std::string& value) {
+  WriteValue(out, static_cast<uint32_t>(value.size()));
+  out.write(value.data(), value.size());
+}
+
+size_t PaddingToAlignment(size_t offset) {
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+  return (alignment - offset % alignment) % alignment;
+}
+
+// Reads the values of a file loaded in memory, failing once it runs past the end.
+class Reader {
+ public:
+  Reader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  size_t Offset() const { return offset_; }
+
+  bool Skip(uint64_t size) {
+    if (size > size_ - offset_) {
+      return false;
+    }
+    offset_ += static_cast<size_t>(size);
+    return true;
+  }
+
+  template <typename T>
+  bool ReadValue(T& value) {
+    const size_t offset = offset_;
+    if (!Skip(sizeof(value))) {
+      return false;
+    }
+    memcpy(&value, data_ + offset, sizeof(value));
+    return true;
+  }
+
+  bool ReadString(std::string& value) {
+    uint32_t size;
+    const size_t offset = offset_ + sizeof(size);
+    if (!ReadValue(size) || !Skip(size)) {
+      return false;
+    }
+    value.assign(data_ + offset, size);
+    return true;
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+// Maps the file into memory, or reads it into an aligned buffer where it can't be mapped.
+Status LoadFile(const PathString& path, std::shared_ptr<char>& data, size_t& size) {
+  const Env& env = Env::Default();
+  ORT_RETURN_IF_ERROR(env.GetFileLength(path.c_str(), size));
+  if (size == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The prepacked weights file is invalid");
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  if (env.MapFileIntoMemory(path.c_str(), 0, size, mapped_file).IsOK()) {
+    auto deleter = mapped_file.get_deleter();
+    data = std::shared_ptr<char>(mapped_file.release(), deleter);
+    return Status::OK();
+  }
+
+  auto allocator = std::make_shared<CPUAllocator>();
+  data = std::shared_ptr<char>(static_cast<char*>(allocator->Alloc(size)),
+                               [allocator](char* buffer) { allocator->Free(buffer); });
+  return env.ReadFileIntoBuffer(path.c_str(), 0, size, gsl::make_span(data.get(), size));
+}
+
+// Returns 128 random bits as hexadecimal digits.
+std::string NewModelId() {
+  std::random_device random;
+  std::string id;
+  for (int i = 0; i < 4; ++i) {
+    char digits[9];
+    snprintf(digits, sizeof(digits), "%08x", static_cast<unsigned>(random()));
+    id += digits;
+  }
+  return id;
+}
+
+}  // namespace
+
+PrepackedWeightsStore::PrepackedWeightsStore() : model_id_(NewModelId()) {}
+
+std::string PrepackedWeightsStore::PlatformTag() {
+  std::string tag;
+#if defined(_M_AMD64) || defined(__x86_64__)
+  tag = "x64";
+#elif defined(_M_IX86) || defined(__i386__)
+  tag = "x86";
+#elif defined(_M_ARM64) || defined(__aarch64__)
+  tag = "arm64";
+#elif defined(_M_ARM) || defined(__arm__)
+  tag = "arm";
+#else
+  tag = "unknown";
+#endif
+  const uint16_t byte_order = 1;
+  tag += *reinterpret_cast<const uint8_t*>(&byte_order) == 1 ? "-le" : "-be";
+  tag += ";align=" + std::to_string(MlasGetPreferredBufferAlignment());
+
+  // the sizes of the packed buffers of a probe matrix change with the block sizes chosen for the processor
+  constexpr size_t kProbeN = 61;
+  constexpr size_t kProbeK = 67;
+  tag += ";nchwc=" + std::to_string(MlasNchwcGetBlockSize());
+  tag += ";sgemm=" + std::to_string(MlasGemmPackBSize(kProbeN, kProbeK));
+  tag += ";bf16=" + std::to_string(MlasGemmBf16PackBSize(kProbeN, kProbeK));
+#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
+  tag += ";u8=" + std::to_string(MlasGemmPackBSize(kProbeN, kProbeK, false));
+  tag += ";s8=" + std::to_string(MlasGemmPackBSize(kProbeN, kProbeK, true));
+#endif
+  return tag;
+}
+
+Status PrepackedWeightsStore::Load(const PathString& path, const std::string& model_id,
+                                   std::unique_ptr<PrepackedWeightsStore>& store) {
+  store.reset();
+
+  std::shared_ptr<char> data;
+  size_t data_size;
+  ORT_RETURN_IF_ERROR(LoadFile(path, data, data_size));
+
+  Reader reader(data.get(), data_size);
+  char magic[sizeof(kMagic)];
+  std::string tag;
+  std::string saved_model_id;
+  uint64_t num_weights;
+  if (!reader.ReadValue(magic) || memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      !reader.ReadString(tag) || !reader.ReadString(saved_model_id) || !reader.ReadValue(num_weights)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The prepacked weights file is invalid");
+  }
+  if (tag != PlatformTag()) {
+    return Status::OK();
+  }
+
+  if (saved_model_id != model_id) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH,
+                           "The prepacked weights file was saved with another model. Save the prepacked weights "
+                           "again along with the optimized model.");
+  }
+
+  auto loaded = onnxruntime::make_unique<PrepackedWeightsStore>();
+  for (uint64_t i = 0; i < num_weights; ++i) {
+    std::string key;
+    uint64_t size;
+    if (!reader.ReadString(key) || !reader.ReadValue(size) || !reader.Skip(PaddingToAlignment(reader.Offset()))) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The prepacked weights file is truncated");
+    }
+    const size_t offset = reader.Offset();
+    if (!reader.Skip(size)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The prepacked weights file is truncated");
+    }
+    loaded->saved_weights_[key] = SavedWeight{offset, static_cast<size_t>(size)};
+  }
+  if (reader.Offset() != data_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The prepacked weights file is invalid");
+  }
+
+  loaded->loaded_ = true;
+  loaded->model_id_ = model_id;
+  loaded->data_ = std::move(data);
+  store = std::move(loaded);
+  return Status::OK();
+}
+
+Status PrepackedWeightsStore::Save(const PathString& path) const {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create the prepacked weights file");
+  }
+
+  out.write(kMagic, sizeof(kMagic));
+  WriteString(out, PlatformTag());
+  WriteString(out, model_id_);
+  WriteValue(out, static_cast<uint64_t>(recorded_weights_.size()));
+  const std::string padding(MlasGetPreferredBufferAlignment(), '\0');
+  for (const auto& weight : recorded_weights_) {
+    WriteString(out, weight.first);
+    WriteValue(out, static_cast<uint64_t>(weight.second.size));
+    out.write(padding.data(), PaddingToAlignment(static_cast<size_t>(out.tellp())));
+    out.write(static_cast<const char*>(weight.second.buffer.get()), weight.second.size);
+  }
+
+  if (!out.flush()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the prepacked weights file");
+  }
+  return Status::OK();
+}
+
+std::shared_ptr<void> PrepackedWeightsStore::Get(const std::string& key, size_t size) const {
+  auto it = saved_weights_.find(key);
+  if (it == saved_weights_.end() || it->second.size != size) {
+    return nullptr;
+  }
+  return std::shared_ptr<void>(data_, data_.get() + it->second.offset);
+}
+
+void PrepackedWeightsStore::Record(const std::string& key, std::shared_ptr<void> buffer, size_t size) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  recorded_weights_.emplace(key, RecordedWeight{std::move(buffer), size});
+}
+
+}  // namespace onnxruntime
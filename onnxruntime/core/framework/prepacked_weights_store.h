@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Persists the packed copies of constant weights produced when the kernels of a session are created, so a session
+// created from the same optimized model uses them instead of packing the weights again.
+// A store either records the weights packed by the kernels of a session so they can be saved, or maps a file saved
+// on a platform with the same packing formats, whose weights the kernels use in place.
+// Kernels identify a weight by a key built from the packing format, the path to the subgraph holding the
+// initializer, its name and the part of it that was packed. The key doesn't identify the values of the weight, so a
+// saved file is bound to the optimized model it was saved with by a random ID written to both.
+class PrepackedWeightsStore final {
+ public:
+  // Creates a store that records packed weights, with a new model ID.
+  PrepackedWeightsStore();
+
+  // Loads the weights saved to `path` for the model with the ID `model_id`. `store` is left empty if the weights
+  // were saved on a platform with other packing formats, as they can't be used there. Fails if the file is invalid
+  // or was saved with another model.
+  static Status Load(const PathString& path, const std::string& model_id,
+                     std::unique_ptr<PrepackedWeightsStore>& store);
+
+  // Writes the recorded weights to `path`, tagged with the packing formats of the platform and the model ID.
+  Status Save(const PathString& path) const;
+
+  // Identifies the optimized model the weights are saved with. It must be written to the metadata of the model.
+  const std::string& ModelId() const { return model_id_; }
+
+  // True if the store was loaded from a file rather than recording weights.
+  bool IsLoaded() const { return loaded_; }
+
+  // Returns the saved weight `key` if it has `size` bytes, or nullptr if there is no such weight. The weight points
+  // into the loaded file, which it keeps alive.
+  std::shared_ptr<void> Get(const std::string& key, size_t size) const;
+
+  // Records the packed weight `key` of `size` bytes. The buffer is kept alive by the store until it is destroyed.
+  void Record(const std::string& key, std::shared_ptr<void> buffer, size_t size);
+
+  // Identifies the packing formats of the platform: the architecture, the alignment of the buffers, the NCHWc block
+  // size and the packed GEMM formats supported by the processor.
+  static std::string PlatformTag();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsStore);
+
+  struct SavedWeight {
+    size_t offset;
+    size_t size;
+  };
+
+  struct RecordedWeight {
+    std::shared_ptr<void> buffer;
+    size_t size;
+  };
+
+  bool loaded_ = false;
+  std::string model_id_;
+  // the contents of the loaded file, mapped into memory, which the saved weights point into
+  std::shared_ptr<char> data_;
+  std::unordered_map<std::string, SavedWeight> saved_weights_;
+
+  OrtMutex mutex_;
+  // weights used by several kernels are recorded once
+  std::unordered_map<std::string, RecordedWeight> recorded_weights_;
+};
+
+}  // namespace onnxruntime
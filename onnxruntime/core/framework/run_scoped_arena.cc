@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/run_scoped_arena.h"
+
+#include <mutex>
+
+namespace onnxruntime {
+constexpr size_t RunScopedArena::kDefaultBlockSize;
+constexpr size_t RunScopedArena::kAlignment;
+
+RunScopedArena::RunScopedArena(AllocatorPtr parent, size_t block_size)
+    : IAllocator(parent->Info()),
+      parent_(std::move(parent)),
+      block_size_(block_size) {
+  ORT_ENFORCE(block_size_ >= kAlignment, "Block size must be at least ", kAlignment, " bytes");
+}
+
+RunScopedArena::~RunScopedArena() {
+  for (void* block : blocks_) {
+    parent_->Free(block);
+  }
+
+  for (const auto& entry : large_allocations_) {
+    parent_->Free(entry.first);
+  }
+}
+
+void* RunScopedArena::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  size_t aligned_size = (size + kAlignment - 1) & ~(kAlignment - 1);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  if (aligned_size > block_size_ / 2) {
+    void* p = parent_->Alloc(size);
+    if (p != nullptr) {
+      large_allocations_[p] = size;
+      reserved_bytes_ += size;
+    }
+
+    return p;
+  }
+
+  if (cur_ == nullptr || static_cast<size_t>(end_ - cur_) < aligned_size) {
+    char* block = static_cast<char*>(parent_->Alloc(block_size_));
+    if (block == nullptr) {
+      return nullptr;
+    }
+
+    blocks_.push_back(block);
+    reserved_bytes_ += block_size_;
+    cur_ = block;
+    end_ = block + block_size_;
+  }
+
+  last_ = cur_;
+  cur_ += aligned_size;
+  return last_;
+}
+
+void RunScopedArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  auto entry = large_allocations_.find(p);
+  if (entry != large_allocations_.end()) {
+    reserved_bytes_ -= entry->second;
+    large_allocations_.erase(entry);
+    parent_->Free(p);
+    return;
+  }
+
+  // the memory of all other allocations is released with the arena, but if this was the most recent one
+  // from the current block we can hand it out again.
+  if (p == last_) {
+    cur_ = last_;
+    last_ = nullptr;
+  }
+}
+
+size_t RunScopedArena::ReservedBytes() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return reserved_bytes_;
+}
+
+}  // namespace onnxruntime
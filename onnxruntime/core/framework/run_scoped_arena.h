@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// A bump allocator for values that only live for the duration of a single Run.
+// Small requests are carved out of large blocks obtained from the session allocator, and individual
+// Free calls don't return memory (other than rolling back the most recent allocation). All blocks are
+// returned to the session allocator at once when the RunScopedArena is destroyed, which happens once the
+// execution frame and every tensor allocated from it have been released.
+// Requests larger than half a block are passed through to the session allocator so that the memory
+// needed by a Run is not dominated by large tensors that are never freed.
+class RunScopedArena final : public IAllocator {
+ public:
+  static constexpr size_t kDefaultBlockSize = 1 << 20;
+  static constexpr size_t kAlignment = 64;
+
+  explicit RunScopedArena(AllocatorPtr parent, size_t block_size = kDefaultBlockSize);
+  ~RunScopedArena() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  FencePtr CreateFence(const SessionState* session_state) override {
+    return parent_->CreateFence(session_state);
+  }
+
+  // Total bytes currently obtained from the session allocator.
+  size_t ReservedBytes() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunScopedArena);
+
+  AllocatorPtr parent_;
+  const size_t block_size_;
+
+  mutable OrtMutex mutex_;
+  std::vector<void*> blocks_;
+  // pass-through allocations and their sizes
+  std::unordered_map<void*, size_t> large_allocations_;
+  size_t reserved_bytes_ = 0;
+
+  // bump pointer within the current block
+  char* cur_ = nullptr;
+  char* end_ = nullptr;
+  // most recent allocation from the current block, which can be given back by Free
+  char* last_ = nullptr;
+};
+
+}  // namespace onnxruntime
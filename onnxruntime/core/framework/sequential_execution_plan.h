@@ -27,7 +27,10 @@ struct AllocPlanPerValue {
   OrtMemoryInfo location;
   // reused_buffer is valid only if alloc_kind == kReuse. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
+  // If alloc_kind == kAllocateOrView it is the input this OrtValue may be a view of.
   OrtValueIndex reused_buffer{0};
+  // set if the reused buffer belongs to an input of the node producing this OrtValue (in-place update)
+  bool inplace_reuse{false};
   // if the value is used in async kernel, a fence object would be created
   // note the fence object would be shared between MLValues reusing the same buffer
   bool create_fence_if_async{false};
@@ -72,6 +75,14 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   // to_be_freed: vector elements represent indices of ml-values to be freed (as described above)
   std::vector<OrtValueIndex> to_be_freed;
 
+  // Estimated cost of the longest path from a node to the end of the graph, key is node index.
+  // When several nodes are ready the parallel executor starts the one with the highest priority first.
+  std::vector<int64_t> node_priority;
+
+  // Estimated peak size in bytes of the buffers allocated for the intermediate values and outputs of a run in the
+  // order of execution_plan. Unknown and symbolic dimensions are counted as 1.
+  int64_t estimated_peak_memory_bytes{0};
+
   const OrtMemoryInfo& GetLocation(size_t ort_value_index) const override {
     return allocation_plan[ort_value_index].location;
   }
@@ -92,6 +103,10 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   bool NodeHasFence(onnxruntime::NodeIndex node_index) const {
     return node_has_fence[node_index];
   }
+
+  int64_t NodePriority(onnxruntime::NodeIndex node_index) const {
+    return node_index < node_priority.size() ? node_priority[node_index] : 0;
+  }
 };
 
 // Output details of an execution plan:
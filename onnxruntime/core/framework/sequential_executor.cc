@@ -9,10 +9,13 @@
 #include <sstream>
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parallel_for_cost_table.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+#include "core/profile/hardware_counters.h"
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
 #include "core/framework/utils.h"
@@ -24,6 +27,11 @@
 #include "core/profile/context.h"
 #endif
 
+#ifdef ENABLE_ITT_PROFILE
+// This header is for profile using Intel VTune.
+#include "core/profile/profile.h"
+#endif
+
 // #define TRACE_EXECUTION
 
 // Define this symbol to create Concurrency Visualizer markers.
@@ -127,6 +135,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
                                    const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                    const logging::Logger& logger) {
   const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  const bool collect_node_stats = session_state.GetCollectNodeStats();
   TimePoint tp;
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
@@ -138,6 +147,11 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     tp = session_state.Profiler().StartTime();
   }
 
+  profile::HardwareCounters* hardware_counters =
+      is_profiler_enabled && session_state.GetProfileHardwareCounters() ? profile::HardwareCounters::ForCurrentThread()
+                                                                       : nullptr;
+  profile::HardwareCounterValues kernel_begin_counters;
+
   ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
 
   const std::unordered_set<NodeIndex>* to_be_executed_nodes = session_state.GetToBeExecutedNodes(fetch_mlvalue_idxs);
@@ -287,6 +301,17 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       // Calculate total input sizes for this operation.
       CalculateTotalInputSizes(&op_kernel_context, p_op_kernel,
                                input_activation_sizes, input_parameter_sizes, node_name_for_profiling);
+
+      if (hardware_counters != nullptr) {
+        kernel_begin_counters = hardware_counters->Read();
+      }
+    }
+
+    TimePoint node_stats_begin_time;
+    uint64_t num_work_items_before = 0;
+    if (collect_node_stats) {
+      node_stats_begin_time = std::chrono::high_resolution_clock::now();
+      num_work_items_before = concurrency::ThreadPool::NumWorkItemsScheduledByCurrentThread();
     }
 
 #ifdef CONCURRENCY_VISUALIZER
@@ -295,11 +320,21 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 #endif
       Status compute_status;
 
+      // attribute the ParallelFor loops of the kernel to its operator for the cost table
+      concurrency::ParallelForCostTable::OpScope cost_table_scope(node.OpType());
+#ifdef ENABLE_ITT_PROFILE
+      profile::IttRangeCreator node_compute_range(MakeString(node.OpType(), ".", node.Index(), "(", node.Name(), ")"),
+                                                  profile::Color::Blue);
+      node_compute_range.Begin();
+#endif
       try {
         compute_status = p_op_kernel->Compute(&op_kernel_context);
       } catch (const std::exception& ex) {
         compute_status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
       }
+#ifdef ENABLE_ITT_PROFILE
+      node_compute_range.End();
+#endif
 
       if (!compute_status.IsOK()) {
         std::ostringstream ss;
@@ -314,6 +349,14 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     }
 #endif
 
+    if (collect_node_stats) {
+      size_t output_bytes = 0;
+      CalculateTotalOutputSizes(&op_kernel_context, output_bytes, node.Name());
+      session_state.Profiler().RecordNodeStats(
+          node.Index(), node_stats_begin_time, output_bytes,
+          concurrency::ThreadPool::NumWorkItemsScheduledByCurrentThread() - num_work_items_before);
+    }
+
     if (is_profiler_enabled) {
       // Calculate total output sizes for this operation.
       CalculateTotalOutputSizes(&op_kernel_context, total_output_sizes, node_name_for_profiling);
@@ -331,19 +374,26 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
                 << "\n";
 #endif
 
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node_name_for_profiling + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     // Log additional operation args / info.
-                                                     {
-                                                         {"op_name", p_op_kernel->KernelDef().OpName()},
-                                                         {"provider", p_op_kernel->KernelDef().Provider()},
-                                                         {"graph_index", std::to_string(p_op_kernel->Node().Index())},
-                                                         {"exec_plan_index", std::to_string(node_index)},
-                                                         {"activation_size", std::to_string(input_activation_sizes)},
-                                                         {"parameter_size", std::to_string(input_parameter_sizes)},
-                                                         {"output_size", std::to_string(total_output_sizes)},
-                                                     });
+      const TimePoint kernel_end_time = std::chrono::high_resolution_clock::now();
+      // Log additional operation args / info.
+      std::unordered_map<std::string, std::string> event_args{
+          {"op_name", p_op_kernel->KernelDef().OpName()},
+          {"provider", p_op_kernel->KernelDef().Provider()},
+          {"graph_index", std::to_string(p_op_kernel->Node().Index())},
+          {"exec_plan_index", std::to_string(node_index)},
+          {"activation_size", std::to_string(input_activation_sizes)},
+          {"parameter_size", std::to_string(input_parameter_sizes)},
+          {"output_size", std::to_string(total_output_sizes)},
+      };
+      if (hardware_counters != nullptr) {
+        profile::HardwareCounters::AddEventArgs(kernel_begin_counters, hardware_counters->Read(), event_args);
+      }
+      session_state.Profiler().RecordEvent(profiling::NODE_EVENT,
+                                           node_name_for_profiling + "_kernel_time",
+                                           kernel_begin_time,
+                                           kernel_end_time,
+                                           logging::GetThreadId(),
+                                           std::move(event_args));
 
       sync_time_begin = session_state.Profiler().StartTime();
     }
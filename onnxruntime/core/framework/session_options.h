@@ -17,6 +17,25 @@ enum class FreeDimensionOverrideType {
   Name = 2
 };
 
+// How input shapes are mapped to cached memory patterns.
+enum class MemoryPatternBucketing {
+  None = 0,        // a pattern is only used for the exact input shapes it was planned for
+  PowerOfTwo = 1,  // round each input dimension up to the next power of two
+  Multiple = 2     // round each input dimension up to a multiple of SessionOptions::mem_pattern_bucket_multiple
+};
+
+// How the nodes that several execution providers can run are assigned to them.
+enum class GraphPartitioningMode {
+  Greedy = 0,    // each node goes to the first provider in the preference order that can run it
+  CostBased = 1  // the host or device provider is chosen to minimize the estimated compute and copy time
+};
+
+// The order in which the sequential executor runs the nodes.
+enum class ExecutionOrder {
+  Default = 0,     // the topological order of the graph
+  MemoryAware = 1  // a topological order that greedily runs the nodes freeing the most memory first
+};
+
 struct FreeDimensionOverride {
   std::string dim_identifier;
   FreeDimensionOverrideType dim_identifer_type;
@@ -32,6 +51,20 @@ struct SessionOptions {
   // enable profiling for this session.
   bool enable_profiling = false;
 
+  // collect aggregated per node statistics (execution count, kernel time, output sizes, thread pool work items)
+  // for the nodes of the main graph on every run. Much cheaper than enable_profiling, so it can stay on in
+  // production. See InferenceSession::GetNodeStatsJson.
+  bool enable_node_stats = false;
+
+  // with enable_profiling, record the lifetime, size and producer node of every tensor allocated during a run,
+  // which the profile shows as a timeline of the memory in use on each device, and report the tensors that are
+  // live at the peak memory use of each run.
+  bool enable_memory_profiling = false;
+
+  // with enable_profiling, add the hardware performance counters of the thread that ran each node (cycles,
+  // instructions, last level cache misses) to its kernel event. Linux only, see profile::HardwareCounters.
+  bool enable_hardware_counters = false;
+
   // non empty filepath enables serialization of the transformed optimized model to the specified filepath.
   std::basic_string<ORTCHAR_T> optimized_model_filepath;
 
@@ -42,11 +75,117 @@ struct SessionOptions {
   // See class 'OrtValuePatternPlanner'.
   bool enable_mem_pattern = true;
 
+  // With bucketing, a memory pattern is shared by all input shapes in the same bucket. If a Run has a tensor
+  // that doesn't fit the block planned for it, the pattern is re-planned from the larger shapes.
+  // This makes the memory pattern effective for models with variable dimensions such as sequence length.
+  MemoryPatternBucketing mem_pattern_bucketing = MemoryPatternBucketing::None;
+  int64_t mem_pattern_bucket_multiple = 0;
+
+  // Maximum number of cached memory patterns. The least recently used pattern is evicted. 0 means unbounded.
+  size_t mem_pattern_cache_max_entries = 0;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // keep small freed chunks of the CPU arena in per-thread caches.
+  // This reduces contention on the arena lock when many threads call Run concurrently,
+  // at the cost of some memory being held by each thread. Has no effect if the CPU arena is disabled.
+  bool enable_cpu_mem_arena_thread_cache = false;
+
+  // back the regions of the CPU arena with huge pages, faulted in when the arena extends or reserves memory, so
+  // large buffers take fewer TLB misses and the first run after the arena grows doesn't stall on page faults.
+  // Falls back to regular pages if the platform can't provide huge pages. Has no effect if the CPU arena is
+  // disabled or the memory is allocated from a NUMA node.
+  bool enable_cpu_mem_arena_huge_pages = false;
+
+  // run float MatMul and Gemm nodes with constant weights on the bfloat16 GEMM of MLAS when the CPU supports it.
+  // The inputs are rounded to bfloat16 and the products are accumulated in single precision, so results differ
+  // from the single precision GEMM. Has no effect on CPUs without bfloat16 instructions.
+  bool enable_cpu_bf16_gemm = false;
+
+  // run float MatMul and Gemm nodes on CPU with a block sparse GEMM when at most a quarter of their constant weights
+  // are in blocks holding non-zero values, such as the weights of heavily pruned models. The weights are converted
+  // when the kernels are created. Takes precedence over enable_cpu_bf16_gemm for the weights it converts.
+  bool enable_cpu_sparse_gemm = false;
+
+  // run the float nodes assigned to the CUDA execution provider in float16 so that they can use Tensor Cores.
+  // Nodes are converted if their op type is in mixed_precision_op_allow_list and not in mixed_precision_op_deny_list,
+  // empty lists meaning the default lists of MixedPrecisionTransformer. Requires graph_optimization_level >= Level2.
+  bool enable_cuda_mixed_precision = false;
+  std::vector<std::string> mixed_precision_op_allow_list;
+  std::vector<std::string> mixed_precision_op_deny_list;
+
+  // share the packed copies of constant weights, such as the B input of MatMul and Gemm nodes, with other kernels
+  // holding identical packed weights, including the kernels of other sessions in the process that enable this
+  // option. Reduces the memory used by multiple sessions of the same model.
+  bool share_prepacked_weights = false;
+
+  // share the data of constant initializers with the sessions created from the same environment that enable this
+  // option and hold identical initializers, so replicas of a model hold a single copy of each weight in CPU memory.
+  // Initializers with external data are not shared as they are memory mapped already.
+  bool share_initializers = false;
+
+  // when loading the model from a file, memory map the file and create the tensors of the main graph's initializers
+  // over the mapping instead of copying their raw data, so the weights are loaded on demand and their pages are
+  // shared with the page cache and other processes. The mapping is private: the initializers must not be modified.
+  bool use_mmap_initializers = false;
+
+  // when saving the optimized model to optimized_model_filepath, also save the execution provider assigned to each
+  // node in the model's metadata.
+  bool save_node_placements = false;
+
+  // the model is an optimized model saved with save_node_placements. Its saved node placements are restored instead
+  // of running the graph optimizations and partitioning again, so the session initializes faster. The session must
+  // register the execution providers the model was optimized for.
+  bool use_saved_node_placements = false;
+
+  // when saving the optimized model to optimized_model_filepath, also save the constant weights packed by the CPU
+  // kernels, such as the packed B inputs of MatMul and Gemm nodes, to optimized_model_filepath + ".prepacked".
+  // The file is tagged with the architecture and the packing formats of the processor, and with a random ID that
+  // is also written to the metadata of the optimized model.
+  bool save_prepacked_weights = false;
+
+  // the model is an optimized model loaded from a file saved with save_prepacked_weights. The CPU kernels use their
+  // packed weights in place from the model path + ".prepacked", which is mapped into memory, instead of packing them
+  // again, unless the file was saved on a processor with other packing formats, in which case the weights are packed
+  // as usual. Initialize fails if the file is invalid or was saved with another model.
+  bool use_saved_prepacked_weights = false;
+
+  // return the outputs of the model produced by a ZipMap node as the tensor of the ZipMap input, with one row of
+  // values per map, instead of a sequence of maps. The keys shared by the rows are available from
+  // InferenceSession::GetColumnarMapOutputKeys. This avoids building a map per row for the outputs of classifiers.
+  bool columnar_zipmap_outputs = false;
+
+  // how the nodes are assigned to the execution providers. With CostBased, a node that both a host (CPU) provider
+  // and a device provider can run with a single node kernel is placed on the host if that avoids copies between
+  // the devices that cost more than the faster compute. Subgraphs compiled by a provider are still assigned greedily.
+  GraphPartitioningMode graph_partitioning_mode = GraphPartitioningMode::Greedy;
+
+  // File forcing the placement of nodes, with a "<node name> <execution provider type>" line per node. Used with
+  // either partitioning mode. Session initialization fails if a node can't run on the provider it is forced to.
+  std::basic_string<ORTCHAR_T> graph_partitioning_override_file;
+
+  // the order in which the sequential executor runs the nodes. MemoryAware picks, among the nodes whose inputs are
+  // ready, the one that frees the largest inputs net of the outputs it allocates, which lowers the peak memory of
+  // graphs with many independent branches such as training graphs. The estimated peak is logged at VERBOSE level.
+  ExecutionOrder execution_order = ExecutionOrder::Default;
+
+  // If non-zero, the memory arenas of this session are shrunk after this many Run calls since the last shrink,
+  // releasing regions that are not in use back to the device. See RunOptions::shrink_memory_arenas.
+  int arena_shrink_interval_runs = 0;
+
+  // allocate intermediate values (not graph outputs) that aren't covered by a memory pattern from a bump arena
+  // that lives for a single Run. This avoids per-tensor free list work and stops allocations from concurrent
+  // Run calls with varying shapes fragmenting the session arenas.
+  bool enable_run_scoped_arena = false;
+
+  // Create each kernel when its node first runs, and finalize the SessionState of each control flow subgraph when it
+  // first runs, instead of in Initialize. This cuts the startup time and memory of models with branches that are
+  // rarely or never taken, at the cost of the first Run through each part of the model being slower.
+  bool enable_lazy_initialization = false;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
@@ -70,10 +209,44 @@ struct SessionOptions {
   // configuring this makes sense only when you're using parallel executor
   OrtThreadPoolParams inter_op_param;
 
+  // With the parallel executor, run the nodes on the intra-op thread pool instead of a separate inter-op thread pool,
+  // so nodes running in parallel and the parallel loops within them share one set of threads.
+  // inter_op_param is ignored if this is set.
+  bool use_unified_thread_pool = false;
+
+  // Number of threads running the InferenceSession::RunAsync requests. Requests beyond that wait in a queue.
+  // 0 uses one thread per CPU core. The threads are created by the first RunAsync call.
+  int async_run_thread_pool_size = 0;
+
+  // Time the ParallelFor loops of each operator on the intra-op thread pool and size their shards from the measured
+  // per-element cost instead of the estimates hard-coded in the kernels.
+  bool calibrate_parallel_for_cost = false;
+
+  // File with the per-element ParallelFor costs learned by calibration. If set, it is loaded when the session is
+  // created, and the session uses the costs in it. With calibrate_parallel_for_cost, it is (re)written when the
+  // session is destroyed.
+  std::basic_string<ORTCHAR_T> parallel_for_cost_table_file;
+
   // For models with symbolic input dimensions (most commonly batch size), specifies a set of values to override those
   // symbolic dimensions with, keyed by dimension parameters.
   std::vector<FreeDimensionOverride> free_dimension_overrides;
 
+  // constant folding skips a node if its outputs are larger than this multiple of its inputs (and over 64KB), as
+  // with a Tile or Expand of a small initializer, since the folded initializer would take more memory than the
+  // computation saves time. 0 folds nodes regardless of their output size.
+  float constant_folding_max_size_ratio = 16.f;
+
+  // If non-zero, for models with free input dimensions, the first Run with a new set of input shapes optimizes a copy
+  // of the graph with these shapes, so the shape computations are constant folded and the Reshape targets resolved,
+  // and later Runs with the same shapes execute that graph. This is the number of specialized graphs kept, the least
+  // recently used one being released when it is exceeded. Each one holds its own copy of the initializers, unless
+  // they are shared through share_initializers.
+  size_t shape_specialization_cache_size = 0;
+
+  // When a Run requests only some of the graph outputs, execute only the nodes they depend on, as with
+  // RunOptions::only_execute_path_to_fetches. The set of nodes is computed once per set of requested outputs.
+  bool prune_to_requested_fetches = true;
+
   // By default the session uses its own set of threadpools, unless this is set to false.
   // Use this in conjunction with the CreateEnvWithGlobalThreadPools API.
   bool use_per_session_threads = true;
@@ -31,6 +31,9 @@ void SessionState::SetupAllocators() {
         allocators_[memory_info] = [&provider](int id, OrtMemType mem_type) {
           return provider->GetAllocator(id, mem_type);
         };
+        initializer_allocators_[memory_info] = [&provider](int id, OrtMemType mem_type) {
+          return provider->GetInitializerAllocator(id, mem_type);
+        };
       }
     }
   }
@@ -46,6 +49,16 @@ AllocatorPtr SessionState::GetAllocator(const OrtMemoryInfo& location) const noe
   return result;
 }
 
+AllocatorPtr SessionState::GetInitializerAllocator(const OrtMemoryInfo& location) const noexcept {
+  AllocatorPtr result;
+  auto entry = initializer_allocators_.find(location);
+  if (entry != initializer_allocators_.cend()) {
+    result = entry->second(location.id, location.mem_type);
+  }
+
+  return result;
+}
+
 AllocatorPtr SessionState::GetAllocator(OrtDevice device) const noexcept {
   AllocatorPtr result;
 
@@ -116,6 +129,25 @@ void SessionState::CreateGraphInfo() {
   LOGS(logger_, VERBOSE) << "Done saving OrtValue mappings.";
 }
 
+Status SessionState::CreateKernel(const Node& node, const KernelRegistryManager& custom_registry_manager,
+                                  std::unique_ptr<OpKernel>& op_kernel) const {
+  onnxruntime::ProviderType exec_provider_name = node.GetExecutionProviderType();
+
+  const IExecutionProvider* exec_provider = nullptr;
+  if (exec_provider_name.empty() || (exec_provider = execution_providers_.Get(exec_provider_name)) == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Could not create kernel for node: ", node.Name(),
+                           " as there's no execution provider allocated.");
+  }
+
+  common::Status status = custom_registry_manager.CreateKernel(node, *exec_provider, *this, op_kernel);
+  if (!status.IsOK()) {
+    return common::Status(
+        status.Category(), status.Code(),
+        MakeString("Kernel creation failed for node: ", node.Name(), " with error: ", status.ErrorMessage()));
+  }
+  return Status::OK();
+}
+
 Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_manager) {
   const GraphNodes& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
@@ -125,32 +157,62 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1, nullptr);
-    for (auto& node : graph_viewer_->Nodes()) {
-      // construct and save the kernels
-      std::unique_ptr<OpKernel> op_kernel;
-      onnxruntime::ProviderType exec_provider_name = node.GetExecutionProviderType();
-
-      const IExecutionProvider* exec_provider = nullptr;
-      if (exec_provider_name.empty() || (exec_provider = execution_providers_.Get(exec_provider_name)) == nullptr) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Could not create kernel for node: ", node.Name(),
-                               " as there's no execution provider allocated.");
-      }
 
-      common::Status status = custom_registry_manager.CreateKernel(node, *exec_provider, *this, op_kernel);
-      if (!status.IsOK()) {
-        return common::Status(
-            status.Category(), status.Code(),
-            MakeString("Kernel creation failed for node: ", node.Name(), " with error: ", status.ErrorMessage()));
+    if (create_kernels_on_first_use_) {
+      // fail now rather than in a Run if a node has no kernel
+      kernel_create_infos_.assign(max_nodeid + 1, nullptr);
+      for (auto& node : graph_viewer_->Nodes()) {
+        const KernelCreateInfo* kci = nullptr;
+        Status status = custom_registry_manager.SearchKernelRegistry(node, &kci);
+        if (!status.IsOK()) {
+          return common::Status(
+              status.Category(), status.Code(),
+              MakeString("Kernel creation failed for node: ", node.Name(), " with error: ", status.ErrorMessage()));
+        }
+        kernel_create_infos_[node.Index()] = kci;
+      }
+      kernel_registry_manager_ = &custom_registry_manager;
+      kernel_created_flags_.reset(new std::once_flag[max_nodeid + 1]);
+    } else {
+      for (auto& node : graph_viewer_->Nodes()) {
+        // construct and save the kernels
+        std::unique_ptr<OpKernel> op_kernel;
+        ORT_RETURN_IF_ERROR(CreateKernel(node, custom_registry_manager, op_kernel));
+        assert(session_kernels_[node.Index()] == nullptr);
+        // assumes vector is already resize()'ed to the number of nodes in the graph
+        session_kernels_[node.Index()] = op_kernel.release();
       }
-      assert(session_kernels_[node.Index()] == nullptr);
-      // assumes vector is already resize()'ed to the number of nodes in the graph
-      session_kernels_[node.Index()] = op_kernel.release();
     }
   }
   node_index_info_ = onnxruntime::make_unique<NodeIndexInfo>(*graph_viewer_, ort_value_name_idx_map_);
   return Status::OK();
 }
 
+OpKernel* SessionState::CreateKernelOnFirstUse(size_t node_id) const {
+  // call_once makes the concurrent callers wait for the kernel, and retries if its creation throws
+  std::call_once(kernel_created_flags_[node_id], [this, node_id]() {
+    if (kernel_create_infos_[node_id] == nullptr) {
+      return;
+    }
+    std::unique_ptr<OpKernel> op_kernel;
+    ORT_THROW_IF_ERROR(CreateKernel(*graph_viewer_->GetNode(node_id), *kernel_registry_manager_, op_kernel));
+    session_kernels_[node_id] = op_kernel.release();
+  });
+  return session_kernels_[node_id];
+}
+
+const KernelDef* SessionState::GetKernelDef(size_t node_id) const {
+  if (node_id >= session_kernels_.size()) {
+    return nullptr;
+  }
+  if (create_kernels_on_first_use_) {
+    const auto* kci = kernel_create_infos_[node_id];
+    return kci != nullptr ? kci->kernel_def.get() : nullptr;
+  }
+  const auto* kernel = session_kernels_[node_id];
+  return kernel != nullptr ? &kernel->KernelDef() : nullptr;
+}
+
 void SessionState::SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan) {
   p_seq_exec_plan_ = std::move(p_seq_exec_plan);
 }
@@ -214,12 +276,101 @@ void SessionState::CleanInitializedTensorsFromGraph() {
   graph_.CleanAllInitializedTensors();
 }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
+static int64_t BucketDimension(int64_t dim, MemoryPatternBucketing bucketing, int64_t multiple) {
+  if (dim <= 0) {
+    return dim;
+  }
+
+  switch (bucketing) {
+    case MemoryPatternBucketing::PowerOfTwo: {
+      int64_t bucket = 1;
+      while (bucket < dim) {
+        bucket <<= 1;
+      }
+      return bucket;
+    }
+    case MemoryPatternBucketing::Multiple:
+      return multiple > 1 ? ((dim + multiple - 1) / multiple) * multiple : dim;
+    default:
+      return dim;
+  }
+}
+
+static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes,
+                                          MemoryPatternBucketing bucketing = MemoryPatternBucketing::None,
+                                          int64_t bucket_multiple = 0) {
+  // combine in order so that e.g. {2, 3} and {3, 2} get different keys
+  uint64_t key = 0;
   for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
+    const auto& dims = shape.get().GetDims();
+    key = key * 31 + dims.size();
+    for (auto dim : dims) {
+      const auto bucket = static_cast<uint64_t>(BucketDimension(dim, bucketing, bucket_multiple));
+      key ^= bucket + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    }
   }
-  return key;
+
+  return static_cast<int64_t>(key);
+}
+
+int64_t SessionState::GetMemoryPatternsKey(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
+  return CalculateMemoryPatternsKey(input_shapes, mem_pattern_bucketing_, mem_pattern_bucket_multiple_);
+}
+
+void SessionState::SetMemoryPatternCacheOptions(MemoryPatternBucketing bucketing, int64_t bucket_multiple,
+                                                size_t max_entries) {
+  ORT_ENFORCE(bucketing != MemoryPatternBucketing::Multiple || bucket_multiple > 0,
+              "A positive bucket multiple is required for MemoryPatternBucketing::Multiple");
+  mem_pattern_bucketing_ = bucketing;
+  mem_pattern_bucket_multiple_ = bucket_multiple;
+  mem_pattern_cache_max_entries_ = max_entries;
+}
+
+const MemoryPatternGroup* SessionState::InsertMemoryPatternGroup(int64_t key,
+                                                                 std::unique_ptr<MemoryPatternGroup> group) const {
+  mem_patterns_lru_.push_front(key);
+  auto& entry = mem_patterns_[key];
+  entry.group = std::move(group);
+  entry.needs_retrace = false;
+  entry.lru_entry = mem_patterns_lru_.begin();
+
+  while (mem_pattern_cache_max_entries_ > 0 && mem_patterns_.size() > mem_pattern_cache_max_entries_) {
+    mem_patterns_.erase(mem_patterns_lru_.back());
+    mem_patterns_lru_.pop_back();
+    ++mem_patterns_stats_.evictions;
+  }
+
+  return entry.group.get();
+}
+
+void SessionState::MarkMemoryPatternGroupForRetrace(int64_t key) const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  auto it = mem_patterns_.find(key);
+  if (it != mem_patterns_.end()) {
+    it->second.needs_retrace = true;
+  }
+}
+
+SessionState::MemoryPatternCacheStats SessionState::GetMemoryPatternCacheStats() const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  MemoryPatternCacheStats stats = mem_patterns_stats_;
+  stats.entries = mem_patterns_.size();
+  return stats;
+}
+
+SessionState::InPlaceReuseStats SessionState::GetInPlaceReuseStats() const {
+  InPlaceReuseStats stats;
+  stats.num_reuses = in_place_reuse_count_.load(std::memory_order_relaxed);
+  stats.bytes_saved = in_place_reused_bytes_.load(std::memory_order_relaxed);
+  for (const auto& node_to_map_pair : subgraph_session_states_) {
+    for (const auto& attr_name_to_subgraph : node_to_map_pair.second) {
+      auto subgraph_stats = attr_name_to_subgraph.second->GetInPlaceReuseStats();
+      stats.num_reuses += subgraph_stats.num_reuses;
+      stats.bytes_saved += subgraph_stats.bytes_saved;
+    }
+  }
+  return stats;
 }
 
 #ifdef ENABLE_TRAINING
@@ -336,20 +487,25 @@ Status SessionState::GeneratePatternGroupCache(const std::vector<std::reference_
 }
 #endif
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
-                                                              const std::vector<int>& feed_mlvalue_idxs) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
+    const std::vector<int>& feed_mlvalue_idxs,
+    bool* needs_retrace) const {
+  int64_t key = GetMemoryPatternsKey(input_shapes);
+
+  if (needs_retrace) {
+    *needs_retrace = false;
+  }
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   auto it = mem_patterns_.find(key);
   if (it == mem_patterns_.end()) {
+    ++mem_patterns_stats_.misses;
 #ifdef ENABLE_TRAINING
     auto mem_patterns = onnxruntime::make_unique<MemoryPatternGroup>();
     if (GeneratePatternGroupCache(input_shapes, feed_mlvalue_idxs, mem_patterns.get()).IsOK()) {
-      key = CalculateMemoryPatternsKey(input_shapes);
-      auto ptr = mem_patterns.get();
-      mem_patterns_[key] = std::move(mem_patterns);
-      return ptr;
+      InsertMemoryPatternGroup(key, std::move(mem_patterns));
+      return mem_patterns_[key].group;
     }
     return nullptr;
 #else
@@ -358,7 +514,22 @@ const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<
 #endif
   }
 
-  return it->second.get();
+  ++mem_patterns_stats_.hits;
+  mem_patterns_lru_.splice(mem_patterns_lru_.begin(), mem_patterns_lru_, it->second.lru_entry);
+  if (needs_retrace) {
+    *needs_retrace = it->second.needs_retrace;
+  }
+
+  return it->second.group;
+}
+
+static size_t TotalPeakSize(const MemoryPatternGroup& group) {
+  size_t total = 0;
+  for (const auto& pattern : group.patterns) {
+    total += pattern.PeakSize();
+  }
+
+  return total;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -374,12 +545,17 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
                                                    std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+  int64_t key = GetMemoryPatternsKey(input_shapes);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   auto it = mem_patterns_.find(key);
   if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+    InsertMemoryPatternGroup(key, std::move(mem_patterns));
+  } else if (it->second.needs_retrace && TotalPeakSize(*mem_patterns) >= TotalPeakSize(*it->second.group)) {
+    // a Run with larger shapes in the bucket didn't fit the existing pattern. as only larger patterns replace
+    // the existing one, the pattern converges on the largest shapes seen in the bucket.
+    it->second.group = std::move(mem_patterns);
+    it->second.needs_retrace = false;
   }
 
   return Status::OK();
@@ -504,6 +680,20 @@ const SessionState* SessionState::GetSubgraphSessionState(onnxruntime::NodeIndex
   return const_cast<SessionState*>(this)->GetMutableSubgraphSessionState(index, attribute_name);
 }
 
+Status SessionState::RunDeferredInitialization() const {
+  if (!deferred_initialization_ || deferred_initialization_done_.load(std::memory_order_acquire)) {
+    return deferred_initialization_status_;
+  }
+
+  std::lock_guard<OrtMutex> lock(deferred_initialization_mutex_);
+  if (!deferred_initialization_done_.load(std::memory_order_relaxed)) {
+    // a partial initialization can't be run again, so a failure is returned to all the later calls
+    deferred_initialization_status_ = deferred_initialization_();
+    deferred_initialization_done_.store(true, std::memory_order_release);
+  }
+  return deferred_initialization_status_;
+}
+
 void SessionState::RemoveSubgraphSessionState(onnxruntime::NodeIndex index) {
   subgraph_session_states_.erase(index);
 }
@@ -516,8 +706,11 @@ const NodeIndexInfo& SessionState::GetNodeIndexInfo() const {
 void SessionState::UpdateToBeExecutedNodes(const std::vector<int>& fetch_mlvalue_idxs) {
   std::vector<int> sorted_idxs = fetch_mlvalue_idxs;
   std::sort(sorted_idxs.begin(), sorted_idxs.end());
-  if (to_be_executed_nodes_.find(sorted_idxs) != to_be_executed_nodes_.end())
-    return;
+  {
+    std::lock_guard<OrtMutex> lock(to_be_executed_nodes_lock_);
+    if (to_be_executed_nodes_.find(sorted_idxs) != to_be_executed_nodes_.end())
+      return;
+  }
 
   // Get the nodes generating the fetches.
   std::vector<const Node*> nodes;
@@ -528,20 +721,28 @@ void SessionState::UpdateToBeExecutedNodes(const std::vector<int>& fetch_mlvalue
     std::string node_arg_name;
     const auto status = this->GetOrtValueNameIdxMap().GetName(idx, node_arg_name);
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+    // a fetch that is a graph input or an initializer has no producer
     auto ending_node = graph_.GetProducerNode(node_arg_name);
-    nodes.push_back(ending_node);
+    if (ending_node != nullptr) {
+      nodes.push_back(ending_node);
+    }
   }
 
   // Reversely traverse to get reachable nodes.
   graph_.ReverseDFSFrom(
       nodes, {}, [&reachable_nodes](const Node* n) { reachable_nodes.insert(n->Index()); });
-  to_be_executed_nodes_.insert(std::make_pair(sorted_idxs, reachable_nodes));
+
+  // concurrent Runs with the same fetches may both get here, in which case the first insertion is kept
+  std::lock_guard<OrtMutex> lock(to_be_executed_nodes_lock_);
+  to_be_executed_nodes_.insert(std::make_pair(std::move(sorted_idxs), std::move(reachable_nodes)));
 }
 
 const std::unordered_set<NodeIndex>* SessionState::GetToBeExecutedNodes(
     const std::vector<int>& fetch_mlvalue_idxs) const {
   std::vector<int> sorted_idxs = fetch_mlvalue_idxs;
   std::sort(sorted_idxs.begin(), sorted_idxs.end());
+  // entries are never removed and std::map doesn't move them, so the set outlives the lock
+  std::lock_guard<OrtMutex> lock(to_be_executed_nodes_lock_);
   auto it = to_be_executed_nodes_.find(sorted_idxs);
   return (it != to_be_executed_nodes_.end()) ? &it->second : nullptr;
 }
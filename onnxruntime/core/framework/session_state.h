@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <list>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include "gsl/gsl"
@@ -23,6 +27,7 @@
 #include "core/framework/callback.h"
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/node_index_info.h"
+#include "core/framework/session_options.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/platform/threadpool.h"
@@ -36,6 +41,7 @@ class OpKernel;
 class NodeIndexInfo;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
+class SharedInitializerRegistry;
 
 /**
  * SessionState should be modified by the inference session class only.
@@ -81,9 +87,16 @@ class SessionState {
   // Call once all graph modifications like transforms are completed.
   void CreateGraphInfo();
 
-  // Call CreateKernels after CreateGraphInfo
+  // Call CreateKernels after CreateGraphInfo.
+  // If SetCreateKernelsOnFirstUse(true) was called, it only checks that there's a kernel for each node, and keeps a
+  // reference to custom_registry_manager to create them in GetKernel. It must then outlive the SessionState.
   Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
 
+  // Create each kernel the first time it's got instead of in CreateKernels, so the kernels of the nodes a model
+  // never runs don't cost their construction time and memory. Thread-safe.
+  bool GetCreateKernelsOnFirstUse() const noexcept { return create_kernels_on_first_use_; }
+  void SetCreateKernelsOnFirstUse(bool flag) noexcept { create_kernels_on_first_use_ = flag; }
+
   ~SessionState() {
     for (auto* p : session_kernels_) {
       delete p;
@@ -99,14 +112,20 @@ class SessionState {
   // kernels
   // Get kernel for specified node.
   // It should called right before graph execution only.
+  // Throws if the kernel is created on first use and its creation fails.
   const OpKernel* GetKernel(size_t node_id) const {
-    return (node_id < session_kernels_.size()) ? session_kernels_[node_id] : nullptr;
+    if (node_id >= session_kernels_.size()) return nullptr;
+    return create_kernels_on_first_use_ ? CreateKernelOnFirstUse(node_id) : session_kernels_[node_id];
   }
 
   OpKernel* GetMutableKernel(size_t node_id) {
-    return (node_id < session_kernels_.size()) ? session_kernels_[node_id] : nullptr;
+    if (node_id >= session_kernels_.size()) return nullptr;
+    return create_kernels_on_first_use_ ? CreateKernelOnFirstUse(node_id) : session_kernels_[node_id];
   }
 
+  // Get the definition of the kernel for specified node without creating it.
+  const KernelDef* GetKernelDef(size_t node_id) const;
+
   const ExecutionProviders& GetExecutionProviders() const noexcept { return execution_providers_; }
 
   /**
@@ -117,6 +136,12 @@ class SessionState {
   /** Get the allocator for a given OrtDevice. The first allocator that matches will be returned. */
   AllocatorPtr GetAllocator(OrtDevice device) const noexcept;
 
+  /**
+  Get the allocator of the initializers planned in the given OrtMemoryInfo location, see
+  IExecutionProvider::GetInitializerAllocator.
+  */
+  AllocatorPtr GetInitializerAllocator(const OrtMemoryInfo& location) const noexcept;
+
   const OrtValueNameIdxMap& GetOrtValueNameIdxMap() const noexcept { return ort_value_name_idx_map_; }
 
   /**
@@ -183,11 +208,14 @@ class SessionState {
   profiling::Profiler& Profiler() const noexcept { return profiler_; }
 
   /**
-  Get cached memory pattern based on input shapes
+  Get cached memory pattern based on input shapes.
+  @param needs_retrace Optional. Set to true if the pattern should be re-planned by tracing this Run as it was
+  planned for smaller shapes in the same bucket.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
-      const std::vector<int>& feed_mlvalue_idxs) const;
+      const std::vector<int>& feed_mlvalue_idxs,
+      bool* needs_retrace = nullptr) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -196,6 +224,51 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Configure how input shapes map to cached memory patterns and how many patterns are cached.
+  */
+  void SetMemoryPatternCacheOptions(MemoryPatternBucketing bucketing, int64_t bucket_multiple, size_t max_entries);
+  MemoryPatternBucketing GetMemoryPatternBucketing() const noexcept { return mem_pattern_bucketing_; }
+  int64_t GetMemoryPatternBucketMultiple() const noexcept { return mem_pattern_bucket_multiple_; }
+  size_t GetMemoryPatternCacheMaxEntries() const noexcept { return mem_pattern_cache_max_entries_; }
+
+  /**
+  Get the key of the memory pattern cache entry for the given input shapes.
+  */
+  int64_t GetMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
+
+  /**
+  Request that the cached pattern with the given key is re-planned because a Run didn't fit in it.
+  */
+  void MarkMemoryPatternGroupForRetrace(int64_t key) const;
+
+  struct MemoryPatternCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+  };
+
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
+  /**
+  Record that a node wrote an output of the given size into the buffer of one of its inputs.
+  */
+  void RecordInPlaceReuse(size_t bytes) const {
+    in_place_reuse_count_.fetch_add(1, std::memory_order_relaxed);
+    in_place_reused_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  struct InPlaceReuseStats {
+    size_t num_reuses = 0;
+    size_t bytes_saved = 0;
+  };
+
+  /**
+  Get the number and total size of in-place output allocations, including those of all subgraphs.
+  */
+  InPlaceReuseStats GetInPlaceReuseStats() const;
+
   bool GetUseDeterministicCompute() const {return use_deterministic_compute_;}
 
   /**
@@ -248,6 +321,15 @@ class SessionState {
 
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
+  // Defer the finalization of this subgraph SessionState to RunDeferredInitialization, which the control flow
+  // kernel calls when it first runs the subgraph. See SessionOptions::enable_lazy_initialization.
+  void SetDeferredInitialization(std::function<Status()> initialize) {
+    deferred_initialization_ = std::move(initialize);
+  }
+
+  // Run the deferred initialization if it hasn't run yet, and return its status. Thread-safe.
+  Status RunDeferredInitialization() const;
+
   // Remove the SessionState for a node containing a subgraph.
   // If the node isn't going to be executed by the CPU provider we don't need it.
   void RemoveSubgraphSessionState(onnxruntime::NodeIndex index);
@@ -258,6 +340,28 @@ class SessionState {
   bool ExportDll() const noexcept { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) noexcept { export_fused_dll_ = flag; }
 
+  // Allocate intermediate values from a per-Run bump arena instead of the session allocators.
+  bool GetUseRunScopedArena() const noexcept { return use_run_scoped_arena_; }
+  void SetUseRunScopedArena(bool flag) noexcept { use_run_scoped_arena_ = flag; }
+
+  // Record the per node statistics of the profiler for the nodes of this graph (see Profiler::EnableNodeStats).
+  bool GetCollectNodeStats() const noexcept { return collect_node_stats_; }
+  void SetCollectNodeStats(bool flag) noexcept { collect_node_stats_ = flag; }
+
+  // Record the tensors allocated by the execution frames in the profiler, if it is enabled.
+  bool GetProfileMemory() const noexcept { return profile_memory_; }
+  void SetProfileMemory(bool flag) noexcept { profile_memory_ = flag; }
+
+  // Add the hardware performance counters to the node events of the profiler, if it is enabled.
+  bool GetProfileHardwareCounters() const noexcept { return profile_hardware_counters_; }
+  void SetProfileHardwareCounters(bool flag) noexcept { profile_hardware_counters_ = flag; }
+
+  // Registry to share the constant initializers through, or nullptr if they are not shared.
+  SharedInitializerRegistry* GetSharedInitializerRegistry() const noexcept { return shared_initializer_registry_; }
+  void SetSharedInitializerRegistry(SharedInitializerRegistry* registry) noexcept {
+    shared_initializer_registry_ = registry;
+  }
+
   const FuncManager& GetFuncMgr() const noexcept { return fused_funcs_mgr_; }
   FuncManager& GetMutableFuncMgr() noexcept { return fused_funcs_mgr_; }
 
@@ -266,6 +370,8 @@ class SessionState {
   std::vector<BufferUniquePtr>& GetMutableWeightsBuffers() noexcept { return weights_buffers_; }
   const NodeIndexInfo& GetNodeIndexInfo() const;
 
+  // Computes and caches the nodes the fetches depend on, which are the only ones the executors run for them when
+  // only executing the path to the fetches. Thread-safe.
   void UpdateToBeExecutedNodes(const std::vector<int>& fetch_mlvalue_idxs);
   const std::unordered_set<NodeIndex>* GetToBeExecutedNodes(const std::vector<int>& fetch_mlvalue_idxs) const;
 
@@ -274,6 +380,10 @@ class SessionState {
 
   void SetupAllocators();
 
+  Status CreateKernel(const Node& node, const KernelRegistryManager& custom_registry_manager,
+                      std::unique_ptr<OpKernel>& op_kernel) const;
+  OpKernel* CreateKernelOnFirstUse(size_t node_id) const;
+
 #ifdef ENABLE_TRAINING
   Status GeneratePatternGroupCache(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
@@ -281,8 +391,14 @@ class SessionState {
       MemoryPatternGroup* output) const;
 #endif
 
-  // cache of the constructed kernels to avoid spending construction time per executor
-  std::vector<OpKernel*> session_kernels_;
+  // cache of the constructed kernels to avoid spending construction time per executor.
+  // mutable as GetKernel fills it when creating the kernels on first use.
+  mutable std::vector<OpKernel*> session_kernels_;
+  bool create_kernels_on_first_use_ = false;
+  // set when creating the kernels on first use
+  const KernelRegistryManager* kernel_registry_manager_ = nullptr;
+  std::vector<const KernelCreateInfo*> kernel_create_infos_;
+  mutable std::unique_ptr<std::once_flag[]> kernel_created_flags_;
   Graph& graph_;
   std::unique_ptr<GraphViewer> graph_viewer_;  // GraphViewer for const access to Graph
 
@@ -321,6 +437,10 @@ class SessionState {
   std::map<OrtMemoryInfo, std::function<AllocatorPtr(int id, OrtMemType mem_type)>,
            OrtMemoryInfoLessThanIgnoreAllocType>
       allocators_;
+  // same as allocators_ for IExecutionProvider::GetInitializerAllocator
+  std::map<OrtMemoryInfo, std::function<AllocatorPtr(int id, OrtMemType mem_type)>,
+           OrtMemoryInfoLessThanIgnoreAllocType>
+      initializer_allocators_;
 
   OrtValueNameIdxMap ort_value_name_idx_map_;
 
@@ -344,8 +464,30 @@ class SessionState {
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
 
+  struct CachedMemoryPatternGroup {
+    // shared so a Run using the pattern keeps it alive if it's evicted or replaced
+    std::shared_ptr<const MemoryPatternGroup> group;
+    bool needs_retrace = false;
+    std::list<int64_t>::iterator lru_entry;
+  };
+
+  // insert a new cache entry and evict the least recently used entries if the cache is full.
+  // mem_patterns_lock_ must be held.
+  const MemoryPatternGroup* InsertMemoryPatternGroup(int64_t key, std::unique_ptr<MemoryPatternGroup> group) const;
+
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  mutable std::map<int64_t, CachedMemoryPatternGroup> mem_patterns_;
+  // cache keys from most to least recently used
+  mutable std::list<int64_t> mem_patterns_lru_;
+  mutable MemoryPatternCacheStats mem_patterns_stats_;
+
+  // updated by concurrent Runs
+  mutable std::atomic<size_t> in_place_reuse_count_{0};
+  mutable std::atomic<size_t> in_place_reused_bytes_{0};
+
+  MemoryPatternBucketing mem_pattern_bucketing_ = MemoryPatternBucketing::None;
+  int64_t mem_pattern_bucket_multiple_ = 0;
+  size_t mem_pattern_cache_max_entries_ = 0;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -356,11 +498,21 @@ class SessionState {
       std::unordered_map<onnxruntime::NodeIndex, std::unordered_map<std::string, std::unique_ptr<SessionState>>>;
   SubgraphSessionStateMap subgraph_session_states_;
 
+  std::function<Status()> deferred_initialization_;
+  mutable OrtMutex deferred_initialization_mutex_;
+  mutable std::atomic<bool> deferred_initialization_done_{false};
+  mutable Status deferred_initialization_status_;
+
   // either threadpool could be nullptr
   concurrency::ThreadPool* const thread_pool_{};
   concurrency::ThreadPool* const inter_op_thread_pool_{};
 
   bool export_fused_dll_ = false;
+  bool use_run_scoped_arena_ = false;
+  bool collect_node_stats_ = false;
+  bool profile_memory_ = false;
+  bool profile_hardware_counters_ = false;
+  SharedInitializerRegistry* shared_initializer_registry_ = nullptr;
   FuncManager fused_funcs_mgr_;
   const DataTransferManager& data_transfer_mgr_;
 
@@ -368,7 +520,9 @@ class SessionState {
 
   std::unique_ptr<NodeIndexInfo> node_index_info_;
   std::multimap<int, std::unique_ptr<FeedsFetchesManager>> cached_feeds_fetches_managers_;
+  // nodes to execute for each set of fetches, keyed by their sorted OrtValue indices
   std::map<std::vector<int>, std::unordered_set<NodeIndex>> to_be_executed_nodes_;
+  mutable OrtMutex to_be_executed_nodes_lock_;
 
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
   SessionState* parent_ = nullptr;
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializers.h"
+
+#include <cstring>
+#include <mutex>
+
+#include "core/framework/buffer_hash.h"
+
+namespace onnxruntime {
+
+SharedInitializerRegistry::SharedInitializerRegistry() : allocator_(std::make_shared<CPUAllocator>()) {
+}
+
+std::shared_ptr<void> SharedInitializerRegistry::Share(BufferUniquePtr buffer, size_t size) {
+  ORT_ENFORCE(buffer != nullptr, "An initializer buffer is required");
+
+  const uint64_t hash = HashBuffer(buffer.get(), size);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  RemoveExpiredEntries();
+
+  auto range = entries_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Entry& entry = it->second;
+    if (entry.size != size) {
+      continue;
+    }
+    std::shared_ptr<void> existing = entry.buffer.lock();
+    if (existing != nullptr && memcmp(existing.get(), buffer.get(), size) == 0) {
+      // the copy in `buffer` is released on return
+      return existing;
+    }
+  }
+
+  BufferDeleter deleter = buffer.get_deleter();
+  std::shared_ptr<void> shared(buffer.release(), deleter);
+  entries_.emplace(hash, Entry{size, shared});
+  return shared;
+}
+
+size_t SharedInitializerRegistry::NumSharedBuffers() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  RemoveExpiredEntries();
+  return entries_.size();
+}
+
+void SharedInitializerRegistry::RemoveExpiredEntries() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.buffer.expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace onnxruntime
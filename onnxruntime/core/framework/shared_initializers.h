@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Registry owned by the Environment that lets its sessions share the data of identical constant initializers, so
+// that sessions of the same model hold a single copy of each weight.
+// A session deserializes a constant initializer into a buffer obtained from Allocator() and hands it to Share, which
+// returns either that buffer or an identical buffer already in use. Buffers are identical if they have the same
+// bytes; each session creates its own Tensor over the returned buffer, so the element type and shape don't need to
+// match. The shared buffers must not be written to.
+// The registry only holds weak references: a buffer is freed once the last session using it is destroyed.
+class SharedInitializerRegistry final {
+ public:
+  SharedInitializerRegistry();
+
+  // Allocator for buffers passed to Share. It is independent of any session, so shared buffers don't keep the
+  // memory arena of the session that created them alive.
+  const AllocatorPtr& Allocator() const { return allocator_; }
+
+  // Returns the shared buffer for the `size` bytes of initializer data in `buffer`.
+  std::shared_ptr<void> Share(BufferUniquePtr buffer, size_t size);
+
+  // Number of buffers that are currently in use.
+  size_t NumSharedBuffers();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerRegistry);
+
+  struct Entry {
+    size_t size;
+    std::weak_ptr<void> buffer;
+  };
+
+  void RemoveExpiredEntries();
+
+  AllocatorPtr allocator_;
+  OrtMutex mutex_;
+  // entries keyed by a hash of the bytes
+  std::unordered_multimap<uint64_t, Entry> entries_;
+};
+
+}  // namespace onnxruntime
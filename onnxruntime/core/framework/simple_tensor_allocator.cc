@@ -31,7 +31,7 @@ common::Status SimpleTensorAllocator::GetPreallocatedBuffer(int ort_value_index,
                            "', location: ", location.ToString());
   void* buffer = alloc->Alloc(len);
   weights_buffers_.push_back(BufferUniquePtr(buffer, alloc));
-  out = onnxruntime::make_unique<MemBuffer>(buffer, len, location);
+  out = onnxruntime::make_unique<MemBuffer>(buffer, len, GetBufferLocation(location, *alloc));
   return Status::OK();
 }
 }  // namespace onnxruntime
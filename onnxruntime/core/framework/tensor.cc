@@ -72,12 +72,12 @@ void Tensor::Init(MLDataType p_type, const TensorShape& shape, void* p_raw_data,
 Tensor::Tensor(Tensor&& other) noexcept
     : p_data_(other.p_data_),
       buffer_deleter_(other.buffer_deleter_),
-      shape_(other.shape_),
+      shape_(std::move(other.shape_)),
       dtype_(other.dtype_),
       alloc_info_(other.alloc_info_),
       byte_offset_(other.byte_offset_) {
   other.dtype_ = DataTypeImpl::GetType<float>()->AsPrimitiveDataType();
-  other.shape_ = TensorShape(std::vector<int64_t>(1, 0));
+  other.shape_ = TensorShape{0};
   other.p_data_ = nullptr;
   other.buffer_deleter_ = nullptr;
   other.byte_offset_ = 0;
@@ -88,14 +88,14 @@ Tensor& Tensor::operator=(Tensor&& other) noexcept {
     ReleaseBuffer();
 
     dtype_ = other.dtype_;
-    shape_ = other.shape_;
+    shape_ = std::move(other.shape_);
     alloc_info_ = other.alloc_info_;
     byte_offset_ = other.byte_offset_;
     p_data_ = other.p_data_;
     buffer_deleter_ = other.buffer_deleter_;
 
     other.dtype_ = DataTypeImpl::GetType<float>()->AsPrimitiveDataType();
-    other.shape_ = TensorShape(std::vector<int64_t>(1, 0));
+    other.shape_ = TensorShape{0};
     other.p_data_ = nullptr;
     other.byte_offset_ = 0;
     other.buffer_deleter_ = nullptr;
@@ -7,7 +7,7 @@
 namespace onnxruntime {
 
 AllocatorPtr ITensorAllocator::GetAllocator(const OrtMemoryInfo& memory_info) {
-  return session_state_.GetAllocator(memory_info);
+  return session_state_.GetInitializerAllocator(memory_info);
 }
 
 std::unique_ptr<ITensorAllocator> ITensorAllocator::Create(bool enable_mem_pattern,
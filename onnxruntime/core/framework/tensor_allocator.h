@@ -22,8 +22,15 @@ class ITensorAllocator {
                                                   const SessionState& session_state,
                                                   std::vector<BufferUniquePtr>& weights_buffers);
 
+  // allocator of the initializers planned in memory_info, see IExecutionProvider::GetInitializerAllocator
   AllocatorPtr GetAllocator(const OrtMemoryInfo& memory_info);
 
+  // location of the buffers allocated by alloc for the initializers planned in memory_info, which is the memory of
+  // alloc if the provider keeps the initializers out of the device memory
+  static const OrtMemoryInfo& GetBufferLocation(const OrtMemoryInfo& memory_info, const IAllocator& alloc) {
+    return alloc.Info().device == memory_info.device ? memory_info : alloc.Info();
+  }
+
   /**
    *
    * \param planned_memory_size_in_byte The size of memory allocated inside FinalizePlan
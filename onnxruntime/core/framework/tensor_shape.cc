@@ -9,29 +9,98 @@
 
 namespace onnxruntime {
 
+constexpr size_t TensorShape::kInlineDims;
+
 TensorShape::TensorShape(const int64_t* dimension_sizes, size_t dimension_count)
-    : std::vector<int64_t>(dimension_count) {
-  for (size_t i = 0; i < dimension_count; ++i) {
-    (*this)[i] = dimension_sizes[i];
+    : num_dims_(dimension_count) {
+  if (dimension_count <= kInlineDims) {
+    std::copy(dimension_sizes, dimension_sizes + dimension_count, inline_dims_);
+  } else {
+    spilled_dims_.store(new std::vector<int64_t>(dimension_sizes, dimension_sizes + dimension_count),
+                        std::memory_order_relaxed);
+  }
+}
+
+TensorShape::TensorShape(std::vector<int64_t>&& dims)
+    : num_dims_(dims.size()) {
+  if (num_dims_ <= kInlineDims) {
+    std::copy(dims.begin(), dims.end(), inline_dims_);
+  } else {
+    spilled_dims_.store(new std::vector<int64_t>(std::move(dims)), std::memory_order_relaxed);
+  }
+}
+
+TensorShape::TensorShape(TensorShape&& other) noexcept
+    : num_dims_(other.num_dims_) {
+  std::copy(other.inline_dims_, other.inline_dims_ + std::min(num_dims_, kInlineDims), inline_dims_);
+  spilled_dims_.store(other.spilled_dims_.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+  other.num_dims_ = 0;
+}
+
+TensorShape& TensorShape::operator=(const TensorShape& other) {
+  if (this != &other) {
+    Assign(other.Data(), other.num_dims_);
   }
+  return *this;
 }
 
-TensorShape::TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end) {
-  assign(dims.begin() + start, dims.begin() + end);
+TensorShape& TensorShape::operator=(TensorShape&& other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  std::vector<int64_t>* dims = spilled_dims_.load(std::memory_order_relaxed);
+  std::vector<int64_t>* other_dims = other.spilled_dims_.load(std::memory_order_relaxed);
+  if (dims != nullptr && other_dims != nullptr) {
+    *dims = std::move(*other_dims);
+    num_dims_ = other.num_dims_;
+  } else if (dims == nullptr) {
+    num_dims_ = other.num_dims_;
+    std::copy(other.inline_dims_, other.inline_dims_ + std::min(num_dims_, kInlineDims), inline_dims_);
+    spilled_dims_.store(other.spilled_dims_.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+  } else {
+    // other is inline, and fits in the vector this shape already has
+    dims->assign(other.inline_dims_, other.inline_dims_ + other.num_dims_);
+    num_dims_ = other.num_dims_;
+  }
+  other.num_dims_ = 0;
+  return *this;
+}
+
+void TensorShape::Assign(const int64_t* dims, size_t num_dims) {
+  std::vector<int64_t>* spilled_dims = spilled_dims_.load(std::memory_order_relaxed);
+  if (spilled_dims != nullptr) {
+    spilled_dims->assign(dims, dims + num_dims);
+  } else if (num_dims <= kInlineDims) {
+    std::copy(dims, dims + num_dims, inline_dims_);
+  } else {
+    spilled_dims_.store(new std::vector<int64_t>(dims, dims + num_dims), std::memory_order_relaxed);
+  }
+  num_dims_ = num_dims;
+}
+
+const std::vector<int64_t>& TensorShape::SpillDims() const {
+  auto* dims = new std::vector<int64_t>(inline_dims_, inline_dims_ + num_dims_);
+  std::vector<int64_t>* expected = nullptr;
+  if (!spilled_dims_.compare_exchange_strong(expected, dims, std::memory_order_acq_rel)) {
+    // another reader spilled the dims first
+    delete dims;
+    return *expected;
+  }
+  return *dims;
 }
 
 /**
  * Return the total number of elements. Returns 1 for an empty (rank 0) TensorShape.
  */
 int64_t TensorShape::Size() const {
-  size_t arraySize = size();
+  size_t arraySize = num_dims_;
   int64_t size = SizeHelper(0, arraySize);
   //should we cache the size? as multiple operation may be expensive.
   return size;
 }
 
 int64_t TensorShape::SizeToDimension(size_t dimension) const {
-  const size_t num_dims = size();
+  const size_t num_dims = num_dims_;
   ORT_ENFORCE(dimension <= num_dims,
               "Invalid dimension of ", dimension, " for SizeFromDimension. Tensor has ",
               num_dims, " dimensions.");
@@ -41,7 +110,7 @@ int64_t TensorShape::SizeToDimension(size_t dimension) const {
 }
 
 int64_t TensorShape::SizeFromDimension(size_t dimension) const {
-  const size_t num_dims = size();
+  const size_t num_dims = num_dims_;
   ORT_ENFORCE(dimension <= num_dims,
               "Invalid dimension of ", dimension, " for SizeFromDimension. Tensor has ",
               num_dims, " dimensions.");
@@ -51,13 +120,13 @@ int64_t TensorShape::SizeFromDimension(size_t dimension) const {
 }
 
 TensorShape TensorShape::Slice(size_t dimstart, size_t dimend) const {
-  ORT_ENFORCE(dimstart <= dimend && dimend <= size(),
+  ORT_ENFORCE(dimstart <= dimend && dimend <= num_dims_,
               "Invalid tensor shape slice argument.");
-  return TensorShape(*this, dimstart, dimend);
+  return TensorShape(Data() + dimstart, dimend - dimstart);
 }
 
 TensorShape TensorShape::Slice(size_t dimstart) const {
-  return Slice(dimstart, size());
+  return Slice(dimstart, num_dims_);
 }
 
 // output dimensions
@@ -66,7 +135,7 @@ std::string TensorShape::ToString() const {
 
   result.append("{");
   bool first = true;
-  for (auto dim : (*this)) {
+  for (auto dim : GetDimsAsSpan()) {
     if (!first) {
       result.append(",");
     }
@@ -82,9 +151,10 @@ std::string TensorShape::ToString() const {
 int64_t TensorShape::SizeHelper(size_t start, size_t end) const {
   // Must return 1 for an empty sequence
   SafeInt<int64_t> size = 1;  // this is used to calculate the size, which is used for memory allocations, so validate no overflow
+  const int64_t* dims = Data();
   for (size_t i = start; i < end; i++) {
-    if ((*this)[i] < 0) return -1;
-    size *= (*this)[i];
+    if (dims[i] < 0) return -1;
+    size *= dims[i];
   }
   return size;
 }
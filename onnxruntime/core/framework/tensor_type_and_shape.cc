@@ -151,7 +151,7 @@ OrtStatus* GetTensorShapeAndTypeHelper(ONNXTensorElementDataType type, const onn
     return status;
   }
 
-  auto* status = OrtApis::SetDimensions(ret, shape.GetDims().data(), shape.GetDims().size());
+  auto* status = OrtApis::SetDimensions(ret, shape.GetDimsAsSpan().data(), shape.NumDimensions());
   if (status != nullptr) {
     OrtApis::ReleaseTensorTypeAndShapeInfo(ret);
     return status;
@@ -623,6 +623,19 @@ common::Status ConstantNodeProtoToTensorProto(const ONNX_NAMESPACE::NodeProto& n
   return Status::OK();
 }
 
+common::Status ConstantNodeProtoToTensorProto(ONNX_NAMESPACE::NodeProto&& node,
+                                              ONNX_NAMESPACE::TensorProto& tensor) {
+  if (node.attribute(0).type() != AttributeProto_AttributeType_TENSOR) {
+    return ConstantNodeProtoToTensorProto(static_cast<const ONNX_NAMESPACE::NodeProto&>(node), tensor);
+  }
+
+  tensor.Clear();
+  tensor.Swap(node.mutable_attribute(0)->mutable_t());
+  *(tensor.mutable_name()) = node.output(0);
+
+  return Status::OK();
+}
+
 template <typename T>
 static Status CopySparseData(size_t n_sparse_elements,
                              const ONNX_NAMESPACE::TensorProto& indices,
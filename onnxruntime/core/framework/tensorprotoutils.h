@@ -64,6 +64,11 @@ Status UnpackTensor(const ONNX_NAMESPACE::TensorProto& tensor, const void* raw_d
 common::Status ConstantNodeProtoToTensorProto(const ONNX_NAMESPACE::NodeProto& node,
                                               ONNX_NAMESPACE::TensorProto& tensor);
 
+// As above, but moves the value of a 'value' tensor attribute instead of copying it, so a large constant
+// isn't held twice. The tensor attribute of `node` is left empty.
+common::Status ConstantNodeProtoToTensorProto(ONNX_NAMESPACE::NodeProto&& node,
+                                              ONNX_NAMESPACE::TensorProto& tensor);
+
 // Convert a SparseTensorProto to a dense TensorProto
 common::Status SparseTensorProtoToDenseTensorProto(const ONNX_NAMESPACE::SparseTensorProto& sparse,
                                                    ONNX_NAMESPACE::TensorProto& dense);
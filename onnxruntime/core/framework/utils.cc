@@ -441,7 +441,8 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
       LOGS(logger, WARNING) << "Only one thread was configured for parallel execution. Hence will use sequential execution.";
       p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag, only_execute_path_to_fetches));
     } else {
-      p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
+      p_exec = std::unique_ptr<IExecutor>(
+          new ParallelExecutor(session_state, terminate_flag, only_execute_path_to_fetches));
     }
   }
 
@@ -515,6 +516,28 @@ common::Status ExecuteGraph(const SessionState& session_state,
   return status;
 }
 
+common::Status ExecutePreparedGraph(const SessionState& session_state,
+                                    const FeedsFetchesManager& feeds_fetches_manager,
+                                    const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                    ExecutionMode execution_mode, const bool& terminate_flag,
+                                    const logging::Logger& logger, bool only_execute_path_to_fetches) {
+  if (feeds_fetches_manager.GetDeviceCopyChecks().status == DeviceCopyCheck::NoCopy) {
+    return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+                            execution_mode, terminate_flag, logger, only_execute_path_to_fetches);
+  }
+
+  // the copies needed depend on the location of the feeds and fetches of this call.
+  // start from the static copy info so nothing from a previous call is carried over.
+  FeedsFetchesManager per_call_feeds_fetches_manager{FeedsFetchesInfo(feeds_fetches_manager.GetFeedsFetchesInfo())};
+  per_call_feeds_fetches_manager.GetMutableFeedsDeviceCopyInfo() = feeds_fetches_manager.GetFeedsDeviceCopyInfo();
+  per_call_feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo() = feeds_fetches_manager.GetFetchesDeviceCopyInfo();
+
+  FinalizeFeedFetchCopyInfo(per_call_feeds_fetches_manager, feeds, fetches);
+
+  return ExecuteGraphImpl(session_state, per_call_feeds_fetches_manager, feeds, fetches, {},
+                          execution_mode, terminate_flag, logger, only_execute_path_to_fetches);
+}
+
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
                                const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
@@ -65,6 +65,14 @@ common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManag
                             ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
                             bool only_execute_path_to_fetches = false);
 
+// Execute the graph with a FeedsFetchesManager that InitializeFeedFetchCopyInfo was called on once, so it can be
+// reused by concurrent calls. It is not modified; the device copy info is finalized on a copy of it if needed.
+common::Status ExecutePreparedGraph(const SessionState& session_state,
+                                    const FeedsFetchesManager& feeds_fetches_manager,
+                                    const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                    ExecutionMode execution_mode, const bool& terminate_flag,
+                                    const logging::Logger& logger, bool only_execute_path_to_fetches = false);
+
 // Execute a subgraph. The feeds_fetches_manager should have been finalized prior to calling this function.
 // See IControlFlowNode::SetupSubgraphExecutionInfo usage in the control flow kernels.
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
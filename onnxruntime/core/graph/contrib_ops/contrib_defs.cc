@@ -6,6 +6,7 @@
 #include "core/graph/contrib_ops/attn_lstm_schema_defs.h"
 #include "core/graph/contrib_ops/contrib_defs.h"
 #include "core/graph/contrib_ops/nchwc_schema_defs.h"
+#include "core/graph/contrib_ops/nhwc_schema_defs.h"
 #include "core/graph/contrib_ops/range_schema_defs.h"
 #include "core/graph/op.h"
 #include "onnx/defs/schema.h"
@@ -289,6 +290,42 @@ const char* contrib_ops_auto_pad_doc =
     "In case of odd number add the extra padding at the end for SAME_UPPER and at the "
     "beginning for SAME_LOWER. VALID mean no padding.";
 
+// Infers the outputs of the recurrent operators with quantized weights [num_directions, input_size, N], which are
+// the same as those of the float operator: Y [seq_length, num_directions, batch_size, hidden_size] and the final
+// states [num_directions, batch_size, hidden_size].
+void QuantizedRnnShapeInference(ONNX_NAMESPACE::InferenceContext& ctx) {
+  ONNX_NAMESPACE::TensorShapeProto::Dimension num_directions, seq_length, batch_size, hidden_size;
+
+  const auto num_inputs = ctx.getNumInputs();
+  if (num_inputs > 0 && hasInputShape(ctx, 0)) {
+    auto& first_input_shape = getInputShape(ctx, 0);
+    if (first_input_shape.dim_size() != 3) {
+      fail_shape_inference("First input tensor must have rank 3");
+    }
+    seq_length = first_input_shape.dim(0);
+    batch_size = first_input_shape.dim(1);
+  }
+
+  num_directions.set_dim_value(getAttribute(ctx, "direction", "forward") == "bidirectional" ? 2 : 1);
+
+  const int64_t hidden_size_value = getAttribute(ctx, "hidden_size", 0);
+  if (hidden_size_value > 0) {
+    hidden_size.set_dim_value(hidden_size_value);
+  }
+
+  const auto num_outputs = ctx.getNumOutputs();
+  for (size_t i = 0; i < num_outputs; ++i) {
+    propagateElemTypeFromInputToOutput(ctx, 0, i);
+  }
+
+  if (num_outputs > 0) {
+    updateOutputShape(ctx, 0, {seq_length, num_directions, batch_size, hidden_size});
+  }
+  for (size_t i = 1; i < num_outputs; ++i) {
+    updateOutputShape(ctx, i, {num_directions, batch_size, hidden_size});
+  }
+}
+
 void RegisterBertSchemas() {
   static const char* Attention_ver1_doc = R"DOC(
 Multi-Head Self Attention that can be either unidirectional (like GPT-2) or bidirectional (like BERT).
@@ -298,6 +335,13 @@ where value of each element is the end position, or valid length of actual seque
 left-side padding, mask_index has shape (2 * batch_size), where the values are the exclusive end positions followed by 
 the inclusive start positions. When unidirectional is 1, and each token only attend to previous tokens. For GPT-2, both past
 and present state are optional. Present state could appear in output even when past state is not in input.
+Sequences of different lengths can be packed without padding: when cumulative_sequence_length is given, input has
+shape (token_count, hidden_size) with the tokens of sequence i in rows [cumulative_sequence_length[i],
+cumulative_sequence_length[i + 1]). Each sequence only attends to its own tokens, so mask_index and past are not
+allowed, and the op shall be bidirectional.
+When past_present_share_buffer is 1, past and present have the same shape (2, batch_size, num_heads, max_sequence_length,
+head_size) and only the first past_sequence_length steps of past are valid. The keys and values of the new tokens are
+written after them, so that binding the same buffer to past and present appends to the state in place during decoding.
 )DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(Attention)
@@ -310,12 +354,19 @@ and present state are optional. Present state could appear in output even when p
             "Whether every token can only attend to previous tokens. Default value is 0.",
             AttributeProto::INT,
             static_cast<int64_t>(0))
-      .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size), hidden_size = num_heads * head_size", "T")
+      .Attr("past_present_share_buffer",
+            "Whether past and present are buffers of max_sequence_length steps, which can be the same buffer. "
+            "Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size), or 2D packed input tensor with shape (token_count, hidden_size), hidden_size = num_heads * head_size", "T")
       .Input(1, "weight", "2D input tensor with shape (hidden_size, 3 * hidden_size)", "T")
       .Input(2, "bias", "1D input tensor with shape (3 * hidden_size)", "T")
       .Input(3, "mask_index", "Attention mask with shape (batch_size, past_sequence_length + sequence_length), or index with shape (batch_size) or (2 * batch_size).", "M", OpSchema::Optional)
       .Input(4, "past", "past state for key and value with shape (2, batch_size, num_heads, past_sequence_length, head_size).", "T", OpSchema::Optional)
-      .Output(0, "output", "3D output tensor with shape (batch_size, append_length, hidden_size)", "T")
+      .Input(5, "cumulative_sequence_length", "Offsets of the sequences in packed input with shape (batch_size + 1). The first value is 0 and the last one is token_count.", "M", OpSchema::Optional)
+      .Input(6, "past_sequence_length", "Number of valid steps in past with shape (1). Required when past_present_share_buffer is 1.", "M", OpSchema::Optional)
+      .Output(0, "output", "3D output tensor with shape (batch_size, append_length, hidden_size), or 2D packed output tensor with shape (token_count, hidden_size)", "T")
       .Output(1, "present", "present state for key and value with shape (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)", "T", OpSchema::Optional)
       .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors.")
       .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask index to integer types")
@@ -332,7 +383,7 @@ and present state are optional. Present state could appear in output even when p
             auto& input_shape = getInputShape(ctx, 0);
             auto& input_dims = input_shape.dim();
             if (input_dims.size() != 3) {
-              fail_shape_inference("Inputs 0 shall be 3 dimensions");
+              fail_shape_inference("Inputs 0 shall be 3 dimensions when present is in outputs");
             }
 
             if (hasInputShape(ctx, 4)) {
@@ -342,7 +393,9 @@ and present state are optional. Present state could appear in output even when p
                 fail_shape_inference("Inputs 4 shall be 5 dimensions");
               }
 
-              if (past_dims[3].has_dim_value() && input_dims[1].has_dim_value()) {
+              if (getAttribute(ctx, "past_present_share_buffer", 0) == 1) {
+                propagateShapeFromInputToOutput(ctx, 4, 1);
+              } else if (past_dims[3].has_dim_value() && input_dims[1].has_dim_value()) {
                 auto all_sequence_length = past_shape.dim(3).dim_value() + input_shape.dim(1).dim_value();
 
                 ONNX_NAMESPACE::TensorShapeProto present_shape;
@@ -368,6 +421,11 @@ and present state are optional. Present state could appear in output even when p
             "Whether every token can only attend to previous tokens. Default value is 0.",
             AttributeProto::INT,
             static_cast<int64_t>(0))
+      .Attr("quantized_attention",
+            "Whether the CPU kernel also runs Q x K' and attention probs x V as uint8 matrix multiplications, "
+            "dynamically quantizing their operands. Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
       .Input(
           0,
           "input",
@@ -451,8 +509,11 @@ and present state are optional. Present state could appear in output even when p
 EmbedLayerNormalization is the fusion of embedding layer in BERT model, with optional mask processing.
 The embedding layer takes input_ids (word IDs) and segment_ids (sentence IDs) to look up word_embedding, position_embedding,
 and segment_emedding; the embeddings are added then applied layer normalization using gamma and beta tensors.
-The last input mask is optional. If mask is provided, mask index (that is position of first 0 in mask, or number of words)
-will be calculated.)DOC";
+The input mask is optional. If mask is provided, mask index (that is position of first 0 in mask, or number of words)
+will be calculated. Sequences of different lengths can be packed without padding: when cumulative_sequence_length is
+given, input_ids and segment_ids have shape (token_count) with the tokens of sequence i at
+[cumulative_sequence_length[i], cumulative_sequence_length[i + 1]), the output has shape (token_count, hidden_size),
+and mask index is the length of each sequence.)DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(EmbedLayerNormalization)
       .SetDomain(kMSDomain)
@@ -460,15 +521,16 @@ will be calculated.)DOC";
       .SetSupportLevel(OpSchema::SupportType::EXPERIMENTAL)
       .SetDoc(EmbedLayerNormalization_ver1_doc)
       .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT, kDefaultEmbedLayerNormEpsilon)
-      .Input(0, "input_ids", "2D words IDs with shape (batch_size, sequence_length)", "T1")
-      .Input(1, "segment_ids", "2D segment IDs with shape (batch_size, sequence_length)", "T1")
+      .Input(0, "input_ids", "2D words IDs with shape (batch_size, sequence_length), or 1D packed words IDs with shape (token_count)", "T1")
+      .Input(1, "segment_ids", "2D segment IDs with shape (batch_size, sequence_length), or 1D packed segment IDs with shape (token_count)", "T1")
       .Input(2, "word_embedding", "2D with shape (,hidden_size)", "T")
       .Input(3, "position_embedding", "2D with shape (, hidden_size)", "T")
       .Input(4, "segment_embedding", "2D with shape (, hidden_size)", "T")
       .Input(5, "gamma", "1D gamma tensor for layer normalization with shape (hidden_size)", "T")
       .Input(6, "beta", "1D beta tensor for layer normalization  with shape (hidden_size)", "T")
       .Input(7, "mask", "2D attention mask with shape (batch_size, sequence_length)", "T1", OpSchema::Optional)
-      .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .Input(8, "cumulative_sequence_length", "Offsets of the sequences in packed input_ids with shape (batch_size + 1). The first value is 0 and the last one is token_count.", "T1", OpSchema::Optional)
+      .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size), or 2D packed output tensor with shape (token_count, hidden_size)", "T")
       .Output(1, "mask_index", "1D mask_index tensor with shape (batch_size)", "T1")
       .TypeConstraint("T1", {"tensor(int32)"}, "Constrain input and output integer tensors types")
       .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output float tensors types.")
@@ -483,8 +545,9 @@ will be calculated.)DOC";
 
         // Note that both batch size and sequence length could be symbolic.
         // So we only check dimension size here.
-        if (input_ids_dims.size() != 2) {
-          fail_shape_inference("Inputs 0 shall be 2 dimensions");
+        const bool is_packed = ctx.getNumInputs() > 8 && ctx.getInputType(8) != nullptr;
+        if (input_ids_dims.size() != (is_packed ? 1 : 2)) {
+          fail_shape_inference("Inputs 0 shall be ", is_packed ? 1 : 2, " dimensions");
         }
 
         // get hidden_size from the last dimension of embedding
@@ -498,19 +561,21 @@ will be calculated.)DOC";
         int64_t hidden_size = word_embedding_shape.dim(1).dim_value();
 
         // input shape is (batch_size, sequence_length), output shape is (batch_size, sequence_length, hidden_size)
+        // packed input shape is (token_count), output shape is (token_count, hidden_size)
         ONNX_NAMESPACE::TensorShapeProto output_shape;
         for (auto& dim : input_ids_dims) {
           *output_shape.add_dim() = dim;
         }
-        output_shape.add_dim();
-        output_shape.mutable_dim(2)->set_dim_value(hidden_size);
+        output_shape.add_dim()->set_dim_value(hidden_size);
 
         updateOutputShape(ctx, 0, output_shape);
 
-        // mask_index shape is (batch_size)
-        ONNX_NAMESPACE::TensorShapeProto mask_index_shape;
-        *mask_index_shape.add_dim() = input_ids_dims[0];
-        updateOutputShape(ctx, 1, mask_index_shape);
+        // mask_index shape is (batch_size). The batch size of packed input is unknown.
+        if (!is_packed) {
+          ONNX_NAMESPACE::TensorShapeProto mask_index_shape;
+          *mask_index_shape.add_dim() = input_ids_dims[0];
+          updateOutputShape(ctx, 1, mask_index_shape);
+        }
       });
 
   static const char* FastGelu_ver1_doc = R"DOC(
@@ -533,12 +598,12 @@ GELU (Gaussian Error Linear Unit) approximation: Y=0.5*X*(1+tanh(0.797885*X+0.03
       .SetSupportLevel(OpSchema::SupportType::EXPERIMENTAL)
       .SetDoc("Skip and Layer Normalization Fusion")
       .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT, kDefaultSkipLayerNormEpsilon)
-      .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size)", "T")
-      .Input(1, "skip", "3D skip tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size), or 2D packed input tensor with shape (token_count, hidden_size)", "T")
+      .Input(1, "skip", "skip tensor with the same shape as input", "T")
       .Input(2, "gamma", "1D input tensor with shape (hidden_size)", "T")
       .Input(3, "beta", "1D skip tensor with shape (hidden_size", "T")
       .Input(4, "bias", "1D bias tensor with shape (hidden_size", "T", OpSchema::Optional)
-      .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .Output(0, "output", "output tensor with the same shape as input", "T")
       .Output(1, "mean", "Saved mean used during training to speed up gradient computation", "U", OpSchema::Optional)
       .Output(2, "inv_std_var", "Saved inverse standard variance used during training to speed up gradient computation.", "U", OpSchema::Optional)
       .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float or half tensors.")
@@ -1715,6 +1780,123 @@ Matrix product that behaves like numpy.matmul: https://docs.scipy.org/doc/numpy-
         ONNX_NAMESPACE::matmulShapeInference(ctx, 0, 1);
       });
 
+  static const char* DynamicQuantizeLSTM_ver1_doc = R"DOC(
+Computes a one-layer LSTM as the ONNX LSTM operator does, with 8-bit quantized weights. W and R are transposed
+compared to the LSTM operator, so that each direction's weights are a K x N matrix. Before each matrix
+multiplication, the input X or hidden state is quantized to uint8 with the range of its values, as done
+by DynamicQuantizeMatMul. The weights are quantized per direction.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(DynamicQuantizeLSTM)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(DynamicQuantizeLSTM_ver1_doc)
+      .Attr("direction",
+            "Specify if the RNN is forward, reverse, or bidirectional. Must be one of forward (default), reverse, "
+            "or bidirectional.",
+            AttributeProto::STRING,
+            std::string("forward"))
+      .Attr("hidden_size", "Number of neurons in the hidden layer", AttributeProto::INT, OPTIONAL_VALUE)
+      .Attr("activations",
+            "A list of 3 (or 6 if bidirectional) activation functions for input, output, forget, cell, and hidden. "
+            "See the LSTM operator.",
+            AttributeProto::STRINGS,
+            OPTIONAL_VALUE)
+      .Attr("activation_alpha", "Optional scaling values used by some activation functions.",
+            AttributeProto::FLOATS, OPTIONAL_VALUE)
+      .Attr("activation_beta", "Optional scaling values used by some activation functions.",
+            AttributeProto::FLOATS, OPTIONAL_VALUE)
+      .Attr("clip", "Cell clip threshold. No clip if not specified.", AttributeProto::FLOAT, OPTIONAL_VALUE)
+      .Attr("input_forget", "Couple the input and forget gates if 1.", AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(0, "X", "The input sequences with shape `[seq_length, batch_size, input_size]`.", "T")
+      .Input(1, "W",
+             "The quantized weight tensor for the gates, the transposed W[iofc] of each direction. "
+             "It has shape `[num_directions, input_size, 4*hidden_size]`.",
+             "T2")
+      .Input(2, "R",
+             "The quantized recurrence weight tensor, the transposed R[iofc] of each direction. "
+             "It has shape `[num_directions, hidden_size, 4*hidden_size]`.",
+             "T2")
+      .Input(3, "B", "The bias tensor for the gates with shape `[num_directions, 8*hidden_size]`.", "T",
+             OpSchema::Optional)
+      .Input(4, "sequence_lens", "Optional lengths of the sequences in a batch, with shape `[batch_size]`.", "T1",
+             OpSchema::Optional)
+      .Input(5, "initial_h", "Optional initial value of the hidden with shape `[num_directions, batch_size, hidden_size]`.",
+             "T", OpSchema::Optional)
+      .Input(6, "initial_c", "Optional initial value of the cell with shape `[num_directions, batch_size, hidden_size]`.",
+             "T", OpSchema::Optional)
+      .Input(7, "P", "The weight tensor for peepholes with shape `[num_directions, 3*hidden_size]`.", "T",
+             OpSchema::Optional)
+      .Input(8, "W_scale", "Scale of W. A scalar, or a 1-D tensor with a scale per direction.", "T")
+      .Input(9, "W_zero_point", "Zero point of W. A scalar, or a 1-D tensor with a zero point per direction.", "T2")
+      .Input(10, "R_scale", "Scale of R. A scalar, or a 1-D tensor with a scale per direction.", "T")
+      .Input(11, "R_zero_point", "Zero point of R. A scalar, or a 1-D tensor with a zero point per direction.", "T2")
+      .Output(0, "Y", "A tensor that concats all the intermediate output values of the hidden.", "T",
+              OpSchema::Optional)
+      .Output(1, "Y_h", "The last output value of the hidden.", "T", OpSchema::Optional)
+      .Output(2, "Y_c", "The last output value of the cell.", "T", OpSchema::Optional)
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("T1", {"tensor(int32)"}, "Constrain seq_lens to integer tensor.")
+      .TypeConstraint("T2", {"tensor(int8)", "tensor(uint8)"}, "Constrain the weights to 8-bit integer tensors.")
+      .TypeAndShapeInferenceFunction(QuantizedRnnShapeInference);
+
+  static const char* DynamicQuantizeGRU_ver1_doc = R"DOC(
+Computes a one-layer GRU as the ONNX GRU operator does, with 8-bit quantized weights. W and R are transposed
+compared to the GRU operator, so that each direction's weights are a K x N matrix. Before each matrix
+multiplication, the input X or hidden state is quantized to uint8 with the range of its values, as done
+by DynamicQuantizeMatMul. The weights are quantized per direction.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(DynamicQuantizeGRU)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(DynamicQuantizeGRU_ver1_doc)
+      .Attr("direction",
+            "Specify if the RNN is forward, reverse, or bidirectional. Must be one of forward (default), reverse, "
+            "or bidirectional.",
+            AttributeProto::STRING,
+            std::string("forward"))
+      .Attr("hidden_size", "Number of neurons in the hidden layer", AttributeProto::INT, OPTIONAL_VALUE)
+      .Attr("activations",
+            "A list of 2 (or 4 if bidirectional) activation functions for update, reset, and hidden gates. "
+            "See the GRU operator.",
+            AttributeProto::STRINGS,
+            OPTIONAL_VALUE)
+      .Attr("activation_alpha", "Optional scaling values used by some activation functions.",
+            AttributeProto::FLOATS, OPTIONAL_VALUE)
+      .Attr("activation_beta", "Optional scaling values used by some activation functions.",
+            AttributeProto::FLOATS, OPTIONAL_VALUE)
+      .Attr("clip", "Cell clip threshold. No clip if not specified.", AttributeProto::FLOAT, OPTIONAL_VALUE)
+      .Attr("linear_before_reset",
+            "When computing the output of the hidden gate, apply the linear transformation before multiplying by "
+            "the output of the reset gate.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Input(0, "X", "The input sequences with shape `[seq_length, batch_size, input_size]`.", "T")
+      .Input(1, "W",
+             "The quantized weight tensor for the gates, the transposed W[zrh] of each direction. "
+             "It has shape `[num_directions, input_size, 3*hidden_size]`.",
+             "T2")
+      .Input(2, "R",
+             "The quantized recurrence weight tensor, the transposed R[zrh] of each direction. "
+             "It has shape `[num_directions, hidden_size, 3*hidden_size]`.",
+             "T2")
+      .Input(3, "B", "The bias tensor for the gates with shape `[num_directions, 6*hidden_size]`.", "T",
+             OpSchema::Optional)
+      .Input(4, "sequence_lens", "Optional lengths of the sequences in a batch, with shape `[batch_size]`.", "T1",
+             OpSchema::Optional)
+      .Input(5, "initial_h", "Optional initial value of the hidden with shape `[num_directions, batch_size, hidden_size]`.",
+             "T", OpSchema::Optional)
+      .Input(6, "W_scale", "Scale of W. A scalar, or a 1-D tensor with a scale per direction.", "T")
+      .Input(7, "W_zero_point", "Zero point of W. A scalar, or a 1-D tensor with a zero point per direction.", "T2")
+      .Input(8, "R_scale", "Scale of R. A scalar, or a 1-D tensor with a scale per direction.", "T")
+      .Input(9, "R_zero_point", "Zero point of R. A scalar, or a 1-D tensor with a zero point per direction.", "T2")
+      .Output(0, "Y", "A tensor that concats all the intermediate output values of the hidden.", "T",
+              OpSchema::Optional)
+      .Output(1, "Y_h", "The last output value of the hidden.", "T", OpSchema::Optional)
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("T1", {"tensor(int32)"}, "Constrain seq_lens to integer tensor.")
+      .TypeConstraint("T2", {"tensor(int8)", "tensor(uint8)"}, "Constrain the weights to 8-bit integer tensors.")
+      .TypeAndShapeInferenceFunction(QuantizedRnnShapeInference);
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(MatMulIntegerToFloat)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -2750,6 +2932,8 @@ Example 4:
     RegisterNchwcSchemas();
   }
 
+  RegisterNhwcSchemas();
+
   static const char* Gelu_ver1_doc =
       R"DOC(Gaussian Error Linear Unit.
 A high-performing neural network activation function.The GELU nonlinearity is
@@ -2787,6 +2971,91 @@ It's an extension of Gelu. It takes the sum of input A and bias input B as the i
           "Constrain input and output types to float tensors.")
       .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
 
+  static const char* FusedElementwise_ver1_doc = R"DOC(
+Fused chain of elementwise ops, computed in a single pass over memory.
+The attribute ops lists the op of each step, among Add, Sub, Mul, Div, Sqrt, Erf, Tanh, Sigmoid, Relu, Exp, Neg,
+Abs and Reciprocal. The attribute operands has 2 entries per step: the operands of the step, numbering the inputs
+followed by the results of the previous steps. The second operand of the unary ops is -1.
+The inputs are broadcast with Numpy-style broadcasting. The output is the result of the last step.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedElementwise)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetSupportLevel(OpSchema::SupportType::EXPERIMENTAL)
+      .SetDoc(FusedElementwise_ver1_doc)
+      .Attr("ops", "The op of each step.", AttributeProto::STRINGS)
+      .Attr("operands", "The 2 operands of each step.", AttributeProto::INTS)
+      .Input(0, "inputs", "The inputs of the chain.", "T", OpSchema::Variadic)
+      .Output(0, "Y", "The result of the last step.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        using namespace ONNX_NAMESPACE;
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+
+        for (size_t i = 0; i < ctx.getNumInputs(); ++i) {
+          if (!hasInputShape(ctx, i)) {
+            return;
+          }
+        }
+        ONNX_NAMESPACE::TensorShapeProto output_shape = ctx.getInputType(0)->tensor_type().shape();
+        for (size_t i = 1; i < ctx.getNumInputs(); ++i) {
+          ONNX_NAMESPACE::TensorShapeProto broadcast_shape;
+          bidirectionalBroadcastShapeInference(output_shape, ctx.getInputType(i)->tensor_type().shape(),
+                                               broadcast_shape);
+          output_shape = broadcast_shape;
+        }
+        *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape() = output_shape;
+      });
+
+  static const char* EmbeddingBag_ver1_doc = R"DOC(
+Sums or averages bags of rows of an embedding table, as Gather followed by ReduceSum or ReduceMean over the bag
+axis, without materializing the gathered rows.
+If indices is 2D, each of its rows is a bag. If indices is 1D, offsets holds the position of the first index of
+each bag in indices, in increasing order, and a bag ends where the next one starts or at the end of indices.
+Negative indices count from the end of the table. Empty bags produce zeros.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(EmbeddingBag)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetSupportLevel(OpSchema::SupportType::EXPERIMENTAL)
+      .SetDoc(EmbeddingBag_ver1_doc)
+      .Attr("mode", "How the rows of a bag are reduced: 'sum' or 'mean'.", AttributeProto::STRING, std::string("sum"))
+      .Input(0, "table", "The embedding table, with shape (num_embeddings, embedding_dim).", "T")
+      .Input(1, "indices", "The rows of each bag, with shape (batch_size, bag_size), or (num_indices) with offsets.",
+             "Tind")
+      .Input(2, "offsets", "The start of each bag in 1D indices, with shape (batch_size).", "Tind",
+             OpSchema::Optional)
+      .Output(0, "Y", "The reduced bags, with shape (batch_size, embedding_dim).", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain table and output types to float tensors.")
+      .TypeConstraint(
+          "Tind",
+          {"tensor(int32)", "tensor(int64)"},
+          "Constrain indices and offsets to integer tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        using namespace ONNX_NAMESPACE;
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+
+        const bool has_offsets = ctx.getNumInputs() > 2 && ctx.getInputType(2) != nullptr;
+        const int batch_input = has_offsets ? 2 : 1;
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, batch_input)) {
+          return;
+        }
+        const auto& table_shape = getInputShape(ctx, 0);
+        const auto& batch_shape = getInputShape(ctx, batch_input);
+        if (table_shape.dim_size() != 2 || batch_shape.dim_size() != (has_offsets ? 1 : 2)) {
+          fail_shape_inference("EmbeddingBag expects a 2D table, and 2D indices or 1D indices and offsets");
+        }
+        auto* output_shape = getOutputShape(ctx, 0);
+        *output_shape->add_dim() = batch_shape.dim(0);
+        *output_shape->add_dim() = table_shape.dim(1);
+      });
+
   // Used to be ONNX 1.7 Inverse(12)
   // Comment out docs not to increase the binary size
   //
@@ -33,7 +33,10 @@ void NchwcPoolOpSchemaGenerator(OpSchema& schema) {
   schema.Attr("strides", "", AttributeProto::INTS, OPTIONAL_VALUE);
   schema.Attr("pads", "", AttributeProto::INTS, OPTIONAL_VALUE);
   schema.Attr("ceil_mode", "", AttributeProto::INT, static_cast<int64_t>(0));
+  schema.Attr("activation", "", AttributeProto::STRING, OPTIONAL_VALUE);
+  schema.Attr("activation_params", "", AttributeProto::FLOATS, OPTIONAL_VALUE);
   schema.Input(0, "X", "", "T");
+  schema.Input(1, "Sum", "", "T", OpSchema::Optional);
   schema.Output(0, "Y", "", "T");
   schema.TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors");
   schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
@@ -46,7 +49,10 @@ void NchwcGlobalPoolOpSchemaGenerator(OpSchema& schema) {
   schema.SetDomain(kMSNchwcDomain);
   schema.SinceVersion(1);
   schema.SetDoc(R"DOC(For internal use.)DOC");
+  schema.Attr("activation", "", AttributeProto::STRING, OPTIONAL_VALUE);
+  schema.Attr("activation_params", "", AttributeProto::FLOATS, OPTIONAL_VALUE);
   schema.Input(0, "X", "", "T");
+  schema.Input(1, "Sum", "", "T", OpSchema::Optional);
   schema.Output(0, "Y", "", "T");
   schema.TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors");
   schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
@@ -153,7 +159,10 @@ void RegisterNchwcSchemas() {
       .SinceVersion(1)
       .SetDoc(R"DOC(For internal use.)DOC")
       .Attr("scales", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("activation", "", AttributeProto::STRING, OPTIONAL_VALUE)
+      .Attr("activation_params", "", AttributeProto::FLOATS, OPTIONAL_VALUE)
       .Input(0, "X", "", "T")
+      .Input(1, "Sum", "", "T", OpSchema::Optional)
       .Output(0, "Y", "", "T")
       .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/constants.h"
+#include "core/graph/contrib_ops/contrib_defs.h"
+#include "core/graph/contrib_ops/nhwc_schema_defs.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using ONNX_NAMESPACE::AttributeProto;
+using ONNX_NAMESPACE::InferenceContext;
+using ONNX_NAMESPACE::OpSchema;
+using ONNX_NAMESPACE::OPTIONAL_VALUE;
+
+// Computes the output shape of a convolution or pooling of an input of shape [N, D1, ..., Dn, C]. The weights of a
+// convolution have shape [M, k1, ..., kn, C/group].
+static void NhwcConvPoolShapeInference(InferenceContext& ctx, bool has_weights) {
+  ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+  if (!hasInputShape(ctx, 0) || (has_weights && !hasInputShape(ctx, 1))) {
+    return;
+  }
+
+  const auto& input_shape = getInputShape(ctx, 0);
+  const int rank = input_shape.dim_size();
+  if (rank < 3) {
+    fail_shape_inference("Input tensor must have at least 3 dimensions");
+  }
+  const size_t spatial_rank = static_cast<size_t>(rank) - 2;
+
+  std::vector<int64_t> kernel_shape;
+  if (!getRepeatedAttribute(ctx, "kernel_shape", kernel_shape)) {
+    if (!has_weights) {
+      fail_shape_inference("Attribute kernel_shape must be specified");
+    }
+    const auto& weights_shape = getInputShape(ctx, 1);
+    if (weights_shape.dim_size() != rank) {
+      fail_shape_inference("Weights tensor must have the same rank as the input");
+    }
+    for (size_t i = 0; i < spatial_rank; i++) {
+      const auto& dim = weights_shape.dim(static_cast<int>(1 + i));
+      if (!dim.has_dim_value()) {
+        return;
+      }
+      kernel_shape.push_back(dim.dim_value());
+    }
+  }
+  if (kernel_shape.size() != spatial_rank) {
+    fail_shape_inference("Attribute kernel_shape has incorrect size");
+  }
+
+  std::vector<int64_t> strides;
+  if (!getRepeatedAttribute(ctx, "strides", strides) || strides.empty()) {
+    strides.assign(spatial_rank, 1);
+  }
+  std::vector<int64_t> dilations;
+  if (!getRepeatedAttribute(ctx, "dilations", dilations) || dilations.empty()) {
+    dilations.assign(spatial_rank, 1);
+  }
+  std::vector<int64_t> pads;
+  if (!getRepeatedAttribute(ctx, "pads", pads) || pads.empty()) {
+    pads.assign(spatial_rank * 2, 0);
+  }
+  if (strides.size() != spatial_rank || dilations.size() != spatial_rank || pads.size() != spatial_rank * 2) {
+    fail_shape_inference("Attributes strides, dilations and pads must match the spatial rank");
+  }
+
+  const auto* auto_pad_attr = ctx.getAttribute("auto_pad");
+  const std::string auto_pad = (auto_pad_attr != nullptr) ? auto_pad_attr->s() : "NOTSET";
+  const bool ceil_mode = getAttribute(ctx, "ceil_mode", 0) != 0;
+
+  auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+  *output_shape->add_dim() = input_shape.dim(0);
+
+  for (size_t i = 0; i < spatial_rank; i++) {
+    auto* output_dim = output_shape->add_dim();
+    const auto& input_dim = input_shape.dim(static_cast<int>(1 + i));
+    if (!input_dim.has_dim_value()) {
+      continue;
+    }
+
+    int64_t input_size = input_dim.dim_value();
+    if (auto_pad == "SAME_UPPER" || auto_pad == "SAME_LOWER") {
+      output_dim->set_dim_value((input_size + strides[i] - 1) / strides[i]);
+      continue;
+    }
+    if (auto_pad != "VALID") {
+      input_size += pads[i] + pads[i + spatial_rank];
+    }
+    const int64_t effective_kernel = (kernel_shape[i] - 1) * dilations[i] + 1;
+    const int64_t span = input_size - effective_kernel;
+    if (span < 0) {
+      fail_shape_inference("Kernel is larger than the padded input");
+    }
+    output_dim->set_dim_value((ceil_mode ? span + strides[i] - 1 : span) / strides[i] + 1);
+  }
+
+  if (has_weights) {
+    *output_shape->add_dim() = getInputShape(ctx, 1).dim(0);
+  } else {
+    *output_shape->add_dim() = input_shape.dim(rank - 1);
+  }
+}
+
+void NhwcPoolOpSchemaGenerator(OpSchema& schema) {
+  schema.SetDomain(kMSNhwcDomain);
+  schema.SinceVersion(1);
+  schema.SetDoc(R"DOC(For internal use.)DOC");
+  schema.Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"));
+  schema.Attr("kernel_shape", "", AttributeProto::INTS);
+  schema.Attr("strides", "", AttributeProto::INTS, OPTIONAL_VALUE);
+  schema.Attr("pads", "", AttributeProto::INTS, OPTIONAL_VALUE);
+  schema.Attr("ceil_mode", "", AttributeProto::INT, static_cast<int64_t>(0));
+  schema.Input(0, "X", "", "T");
+  schema.Output(0, "Y", "", "T");
+  schema.TypeConstraint("T", {"tensor(float16)", "tensor(float)"}, "Constrain input and output types to float tensors");
+  schema.TypeAndShapeInferenceFunction([](InferenceContext& ctx) {
+    NhwcConvPoolShapeInference(ctx, false);
+  });
+}
+
+void RegisterNhwcSchemas() {
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Conv)
+      .SetDomain(kMSNhwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"))
+      .Attr("kernel_shape", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("dilations", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("strides", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("pads", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("group", "", AttributeProto::INT, static_cast<int64_t>(1))
+      .Input(0, "X", "", "T")
+      .Input(1, "W", "", "T")
+      .Input(2, "B", "", "T", OpSchema::Optional)
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float16)", "tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](InferenceContext& ctx) {
+        NhwcConvPoolShapeInference(ctx, true);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MaxPool)
+      .FillUsing(NhwcPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(AveragePool)
+      .FillUsing(NhwcPoolOpSchemaGenerator)
+      .Attr("count_include_pad", "", AttributeProto::INT, static_cast<int64_t>(0));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(BatchNormalization)
+      .SetDomain(kMSNhwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr("epsilon", "", AttributeProto::FLOAT, 1e-5f)
+      .Input(0, "X", "", "T")
+      .Input(1, "scale", "", "T")
+      .Input(2, "B", "", "T")
+      .Input(3, "mean", "", "T")
+      .Input(4, "var", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float16)", "tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,12 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace onnxruntime {
+namespace contrib {
+
+void RegisterNhwcSchemas();
+
+}  // namespace contrib
+}  // namespace onnxruntime
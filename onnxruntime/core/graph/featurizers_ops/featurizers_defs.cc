@@ -862,6 +862,12 @@ void RegisterLagLeadOperatorFeaturizerVer1() {
   MS_FEATURIZERS_OPERATOR_SCHEMA(LagLeadOperatorTransformer)
       .SinceVersion(1)
       .SetDomain(kMSFeaturizersDomain)
+      .Attr(
+          "streaming",
+          "When non-zero, the history of the grains is kept from one run to the next and each run only processes the new rows, "
+          "instead of each run starting from the trained state",
+          AttributeProto::INT,
+          static_cast<int64_t>(0))
       .Input(
           0,
           "State",
@@ -1639,6 +1645,12 @@ void RegisterRollingWindowFeaturizerVer1() {
   MS_FEATURIZERS_OPERATOR_SCHEMA(AnalyticalRollingWindowTransformer)
       .SinceVersion(1)
       .SetDomain(kMSFeaturizersDomain)
+      .Attr(
+          "streaming",
+          "When non-zero, the windows of the grains are kept from one run to the next and each run only processes the new rows, "
+          "instead of each run starting from the trained state",
+          AttributeProto::INT,
+          static_cast<int64_t>(0))
       .Input(
           0,
           "State",
@@ -1736,6 +1748,12 @@ void RegisterRollingWindowFeaturizerVer1() {
   MS_FEATURIZERS_OPERATOR_SCHEMA(SimpleRollingWindowTransformer)
       .SinceVersion(1)
       .SetDomain(kMSFeaturizersDomain)
+      .Attr(
+          "streaming",
+          "When non-zero, the windows of the grains are kept from one run to the next and each run only processes the new rows, "
+          "instead of each run starting from the trained state",
+          AttributeProto::INT,
+          static_cast<int64_t>(0))
       .Input(
           0,
           "State",
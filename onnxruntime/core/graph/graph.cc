@@ -558,6 +558,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 void Node::AddAttribute(const std::string& attr_name, const AttributeProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inferred_types_hash_ = 0;
   attributes_[attr_name] = value;
 }
 
@@ -565,6 +566,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inferred_types_hash_ = 0;                                                \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -576,6 +578,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inferred_types_hash_ = 0;                                                \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -588,6 +591,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
                           const std::vector<type>& values) { \
     graph_->SetGraphResolveNeeded();                         \
     graph_->SetGraphProtoSyncNeeded();                       \
+    inferred_types_hash_ = 0;                                \
     AttributeProto a;                                        \
     a.set_name(attr_name);                                   \
     a.set_type(enumType);                                    \
@@ -600,6 +604,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 void Node::AddAttribute(const std::string& attr_name, const GraphProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inferred_types_hash_ = 0;
   AttributeProto a;
   a.set_name(attr_name);
   a.set_type(AttributeProto_AttributeType::AttributeProto_AttributeType_GRAPH);
@@ -624,6 +629,7 @@ ADD_LIST_ATTR_IMPL(SparseTensorProto, AttributeProto_AttributeType::AttributePro
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inferred_types_hash_ = 0;
   return attributes_.erase(attr_name) > 0;
 }
 
@@ -688,6 +694,8 @@ const NodeAttributes& Node::GetAttributes() const noexcept {
 }
 
 NodeAttributes& Node::GetMutableAttributes() noexcept {
+  // someone fetching these may change an attribute that type and shape inferencing depends on
+  inferred_types_hash_ = 0;
   return attributes_;
 }
 
@@ -794,14 +802,15 @@ Graph::Graph(const Model& owning_model,
   ArgNameToTypeMap name_to_type_map;
 
   // Process 'Constant' nodes
-  // Put the 'TensorProto' stored in the 'Constant' nodes attribute into the graphs initializer list
-  for (auto& node : graph_proto_->node()) {
+  // Put the 'TensorProto' stored in the 'Constant' nodes attribute into the graphs initializer list.
+  // The nodes are removed below, so their tensors are moved rather than copied.
+  for (auto& node : *graph_proto_->mutable_node()) {
     if (node.op_type() != kConstant) {
       continue;
     }
 
     const gsl::not_null<TensorProto*> tensor{graph_proto_->add_initializer()};
-    auto status = utils::ConstantNodeProtoToTensorProto(node, *tensor);
+    auto status = utils::ConstantNodeProtoToTensorProto(std::move(node), *tensor);
     ORT_ENFORCE(status.IsOK(), status.ToString());
   }
 
@@ -1995,6 +2004,73 @@ common::Status Graph::TypeCheckInputsAndInitializers() {
   return Status::OK();
 }
 
+// Hash of what type and shape inferencing of a Node depends on, besides its attributes and initializer inputs:
+// the names and types of its inputs, and the types of its outputs, which inferencing merges the inferred types into.
+static size_t HashInferredTypes(const Node& node) {
+  size_t hash = 0;
+  auto hash_combine = [&hash](size_t value) {
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  };
+
+  auto hash_defs = [&hash_combine](const ConstPointerContainer<std::vector<NodeArg*>>& defs) {
+    hash_combine(defs.size());
+    for (const auto* def : defs) {
+      if (!def->Exists()) {
+        hash_combine(0);
+        continue;
+      }
+
+      hash_combine(std::hash<std::string>{}(def->Name()));
+      const TypeProto* type = def->TypeAsProto();
+      if (type == nullptr) {
+        hash_combine(1);
+      } else if (utils::HasTensorType(*type)) {
+        const auto& tensor_type = type->tensor_type();
+        hash_combine(static_cast<size_t>(tensor_type.elem_type()) + 2);
+        if (utils::HasShape(tensor_type)) {
+          hash_combine(static_cast<size_t>(tensor_type.shape().dim_size()));
+          for (const auto& dim : tensor_type.shape().dim()) {
+            if (utils::HasDimValue(dim)) {
+              hash_combine(std::hash<int64_t>{}(dim.dim_value()));
+            } else if (utils::HasDimParam(dim)) {
+              hash_combine(std::hash<std::string>{}(dim.dim_param()));
+            } else {
+              hash_combine(0);
+            }
+          }
+        } else {
+          hash_combine(1);
+        }
+      } else {
+        hash_combine(std::hash<std::string>{}(type->SerializeAsString()));
+      }
+    }
+  };
+
+  hash_defs(node.InputDefs());
+  for (int arg_count : node.InputArgCount()) {
+    hash_combine(static_cast<size_t>(arg_count));
+  }
+  hash_defs(node.OutputDefs());
+
+  // 0 is reserved for 'not inferred'
+  return hash == 0 ? 1 : hash;
+}
+
+bool Graph::ConsumesModifiedInitializer(const Node& node) const {
+  if (modified_initializers_.empty()) {
+    return false;
+  }
+
+  for (const auto* input_def : node.InputDefs()) {
+    if (modified_initializers_.find(input_def->Name()) != modified_initializers_.cend()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
   CheckerContext ctx;
   ctx.set_ir_version(gsl::narrow_cast<int>(IrVersion()));
@@ -2021,8 +2097,6 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
     // Node verification.
     auto& node = *GetNode(node_index);
 
-    NodeProto node_proto;
-    node.ToProto(node_proto);
     auto& node_name = node.Name();
     auto& domain = node.Domain();
 
@@ -2036,6 +2110,8 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
     }
 
     if (!node.Op()) {
+      NodeProto node_proto;
+      node.ToProto(node_proto);
       try {
         checker::check_node(node_proto, ctx, lsc);
       } catch (const std::exception& ex) {
@@ -2087,11 +2163,22 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+    // Type and shape inferencing is most of the cost of Resolve. Skip it if nothing it depends on changed since it
+    // last ran for this node, so that a Resolve after an optimizer modified a few nodes only infers those, and the
+    // nodes downstream of them whose input types changed as a result.
+    // Nodes with subgraphs, and nodes in subgraphs, which may depend on outer scope values, are always inferred.
+    const bool infer_types = options.override_types || node.inferred_types_hash_ == 0 ||
+                             parent_graph_ != nullptr || node.ContainsSubgraph() ||
+                             ConsumesModifiedInitializer(node) ||
+                             node.inferred_types_hash_ != HashInferredTypes(node);
+    if (infer_types) {
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+      node.inferred_types_hash_ = HashInferredTypes(node);
+    }
 
     // Accumulate output names of the iterated Node
-    for (auto& output_name : node_proto.output()) {
-      lsc.output_names.insert(output_name);
+    for (const auto* output_def : node.OutputDefs()) {
+      lsc.output_names.insert(output_def->Name());
     }
   }
 
@@ -2252,6 +2339,7 @@ Status Graph::Resolve(const ResolveOptions& options) {
   // perform the final steps for this graph and all subgraphs
   auto finalize_func = [&options](Graph& graph) {
             graph.CleanUnusedInitializers(options.initializer_names_to_preserve);
+            graph.modified_initializers_.clear();
             graph.GraphResolveNeeded(false);
 
             // if we are resolving immediately after loading from a GraphProto, we don't need to
@@ -2300,6 +2388,7 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   const gsl::not_null<TensorProto*> tensor_added{graph_proto_->add_initializer()};
   *(tensor_added) = tensor;
   name_to_initial_tensor_[tensor.name()] = tensor_added;
+  modified_initializers_.insert(tensor.name());
   SetGraphResolveNeeded();
   if (!is_loaded_from_model_file_ && GetNodeArg(tensor.name()) == nullptr) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs may add it to the graph inputs.
@@ -2333,6 +2422,7 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   found = iter != name_to_initial_tensor_.end();
   if (found) {
     name_to_initial_tensor_.erase(tensor_name);
+    modified_initializers_.insert(tensor_name);
     SetGraphResolveNeeded();
   }
 
@@ -2381,6 +2471,7 @@ Status Graph::ReplaceInitializedTensor(const ONNX_NAMESPACE::TensorProto& new_in
               "graph_proto_ is not in sync with name_to_initial_tensor_");
 
   **existing_entry = new_initializer;
+  modified_initializers_.insert(initializer_name);
 
   return Status::OK();
 }
@@ -12,6 +12,7 @@
 #pragma warning(disable : 4800)
 #endif
 #include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -20,6 +21,7 @@
 #include "gsl/gsl"
 
 #include "core/platform/env.h"
+#include "core/platform/path_lib.h"
 #include "core/graph/schema_registry.h"
 
 using namespace ONNX_NAMESPACE;
@@ -213,6 +215,20 @@ const ModelMetaData& Model::MetaData() const noexcept {
   return model_metadata_;
 }
 
+void Model::SetMetaDataEntry(const std::string& key, const std::string& value) {
+  model_metadata_[key] = value;
+  for (auto& prop : *model_proto_.mutable_metadata_props()) {
+    if (prop.key() == key) {
+      prop.set_value(value);
+      return;
+    }
+  }
+
+  const gsl::not_null<StringStringEntryProto*> prop{model_proto_.add_metadata_props()};
+  prop->set_key(key);
+  prop->set_value(value);
+}
+
 Graph& Model::MainGraph() noexcept {
   return *graph_;
 }
@@ -478,6 +494,130 @@ Status Model::Load(int fd, ONNX_NAMESPACE::ModelProto& model_proto) {
   return Status::OK();
 }
 
+namespace {
+using ::google::protobuf::internal::WireFormatLite;
+
+// Field numbers in onnx.proto of the fields handled by LoadWithMappedInitializers.
+constexpr int kModelProtoGraphField = 7;
+constexpr int kGraphProtoInitializerField = 5;
+constexpr int kTensorProtoRawDataField = 9;
+
+// Merge the serialized message in [data, data + size) into `message`, except for the length delimited fields
+// `field_number` which are passed to `on_field` with their serialized content instead.
+// A message is a sequence of fields, so the runs of other fields in between can be merged separately.
+template <typename OnField>
+Status MergeFieldsExcept(const uint8_t* data, int size, int field_number, google::protobuf::MessageLite& message,
+                         OnField on_field) {
+  CodedInputStream input(data, size);
+  int run_start = 0;
+  const auto merge_run = [&](int run_end) {
+    if (run_end == run_start) {
+      return true;
+    }
+    CodedInputStream run(data + run_start, run_end - run_start);
+    return message.MergeFromCodedStream(&run);
+  };
+
+  for (;;) {
+    const int field_start = input.CurrentPosition();
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      break;
+    }
+
+    if (WireFormatLite::GetTagFieldNumber(tag) == field_number &&
+        WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      uint32_t length;
+      if (!input.ReadVarint32(&length)) {
+        return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+      }
+      const int offset = input.CurrentPosition();
+      if (length > static_cast<uint32_t>(size - offset) || !merge_run(field_start)) {
+        return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+      }
+      ORT_RETURN_IF_ERROR(on_field(data + offset, static_cast<int>(length)));
+      input.Skip(static_cast<int>(length));
+      run_start = offset + static_cast<int>(length);
+    } else if (!WireFormatLite::SkipField(&input, tag)) {
+      return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+    }
+  }
+
+  if (input.CurrentPosition() != size || !merge_run(size)) {
+    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+  }
+  return Status::OK();
+}
+
+// Parse an initializer, replacing its raw data by a reference to the same bytes in the model file.
+Status ParseMappedInitializer(const uint8_t* data, int size, const uint8_t* file_data, const std::string& location,
+                              TensorProto& tensor_proto) {
+  const uint8_t* raw_data = nullptr;
+  int raw_data_length = 0;
+  ORT_RETURN_IF_ERROR(MergeFieldsExcept(data, size, kTensorProtoRawDataField, tensor_proto,
+                                        [&raw_data, &raw_data_length](const uint8_t* field_data, int field_size) {
+                                          // the last occurrence of a bytes field wins
+                                          raw_data = field_data;
+                                          raw_data_length = field_size;
+                                          return Status::OK();
+                                        }));
+  if (raw_data == nullptr) {
+    return Status::OK();
+  }
+
+  // keep the data that can't be mapped, including empty tensors as a zero length means the whole file
+  if (raw_data_length == 0 ||
+      tensor_proto.data_type() == TensorProto_DataType_STRING ||
+      tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL) {
+    tensor_proto.set_raw_data(raw_data, raw_data_length);
+    return Status::OK();
+  }
+
+  tensor_proto.set_data_location(TensorProto_DataLocation_EXTERNAL);
+  auto* entry = tensor_proto.add_external_data();
+  entry->set_key("location");
+  entry->set_value(location);
+  entry = tensor_proto.add_external_data();
+  entry->set_key("offset");
+  entry->set_value(std::to_string(raw_data - file_data));
+  entry = tensor_proto.add_external_data();
+  entry->set_key("length");
+  entry->set_value(std::to_string(raw_data_length));
+  return Status::OK();
+}
+}  // namespace
+
+Status Model::LoadWithMappedInitializers(const PathString& file_path, ModelProto& model_proto) {
+  const Env& env = Env::Default();
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(file_path.c_str(), file_length));
+  if (file_length > static_cast<size_t>(INT_MAX)) {
+    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed. The model file exceeds 2GB.");
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  if (file_length == 0 || !env.MapFileIntoMemory(file_path.c_str(), 0, file_length, mapped_file).IsOK()) {
+    return Load(file_path, model_proto);
+  }
+
+  // The mapping is only read for the fields other than the initializers' raw data, so the pages of the weights
+  // aren't touched until their tensors are created.
+  const auto* file_data = reinterpret_cast<const uint8_t*>(mapped_file.get());
+  const std::string location = ToMBString(GetLastComponent(file_path));
+  model_proto.Clear();
+  return MergeFieldsExcept(
+      file_data, static_cast<int>(file_length), kModelProtoGraphField, model_proto,
+      [&](const uint8_t* graph_data, int graph_size) {
+        GraphProto& graph_proto = *model_proto.mutable_graph();
+        return MergeFieldsExcept(
+            graph_data, graph_size, kGraphProtoInitializerField, graph_proto,
+            [&](const uint8_t* tensor_data, int tensor_size) {
+              return ParseMappedInitializer(tensor_data, tensor_size, file_data, location,
+                                            *graph_proto.add_initializer());
+            });
+      });
+}
+
 Status Model::Load(int fd, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries,
                    const logging::Logger& logger) {
   return Load(fd, PathString{}, p_model, local_registries, logger);
@@ -102,6 +102,8 @@ class Model {
   void SetDocString(const std::string& doc_string);
 
   const ModelMetaData& MetaData() const noexcept;
+  // Add or replace an entry of the model's metadata.
+  void SetMetaDataEntry(const std::string& key, const std::string& value);
 
   // Gets the path from which the model was loaded, if any.
   const Path& ModelPath() const noexcept { return model_path_; }
@@ -136,6 +138,13 @@ class Model {
 
   static common::Status Load(int fd, /*out*/ ONNX_NAMESPACE::ModelProto& model_proto);
 
+  // Load the model from a memory mapped file without copying the raw data of the main graph's initializers.
+  // Each such initializer is changed to refer to its raw data in the model file as external data, so its tensor is
+  // created over a read-only mapping of the file when the session state is finalized.
+  // Falls back to a regular load if the file can't be mapped.
+  static common::Status LoadWithMappedInitializers(const PathString& file_path,
+                                                   /*out*/ ONNX_NAMESPACE::ModelProto& model_proto);
+
   static common::Status Load(int fd, /*out*/ std::shared_ptr<Model>& p_model,
                              const IOnnxRuntimeOpSchemaRegistryList* local_registries,
                              const logging::Logger& logger);
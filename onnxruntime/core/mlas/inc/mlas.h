@@ -147,6 +147,46 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasGemm(
@@ -225,6 +265,24 @@ MlasGemm(
 // Buffer packing routines.
 //
 
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -244,6 +302,48 @@ MlasGemmPackB(
     void* PackedB
     );
 
+//
+// Bfloat16 matrix/matrix multiply routines.
+//
+// The single precision inputs are rounded to bfloat16 and the products are
+// accumulated in single precision. MlasGemmBf16PackBSize returns zero if the
+// platform does not support these routines.
+//
+
+size_t
+MLASCALL
+MlasGemmBf16PackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasGemmBf16PackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasGemmBf16(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Convolution routines.
 //
@@ -252,6 +352,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -280,6 +381,11 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileCountHeight;
+            size_t TileCountWidth;
+            const float* TransformedFilter;
+        } Winograd;
     } u;
 };
 
@@ -315,6 +421,47 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Winograd convolution filter transform routines. A filter transformed once
+// ahead of time can be supplied to MlasConv through the TransformedFilter
+// field of the parameters when MlasConvPrepare selects the Winograd algorithm.
+//
+
+size_t
+MLASCALL
+MlasConvWinogradFilterSize(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels
+    );
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* TransformedFilter
+    );
+
+//
+// Quantized convolution routines.
+//
+
+void
+MLASCALL
+MlasConvDepthwise(
+    const uint8_t* const* Input,
+    uint8_t InputZeroPoint,
+    const uint8_t* Filter,
+    uint8_t FilterZeroPoint,
+    int32_t* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
 //
 // Pooling routines.
 //
@@ -388,11 +535,60 @@ MlasComputeTanh(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeLayerNorm(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon
+    );
+
+void
+MLASCALL
+MlasComputeInstanceNorm(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    size_t D,
+    float Epsilon
+    );
+
+void
+MLASCALL
+MlasComputeScaleShift(
+    const float* Input,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t N,
+    size_t D
+    );
+
+void
+MLASCALL
+MlasComputeBiasGelu(
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool UseApproximation
+    );
+
 //
 // Half-precision floating-point routines.
 //
 
-extern "C"
 void
 MLASCALL
 MlasConvertHalfToFloatBuffer(
@@ -401,6 +597,43 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+//
+// Half-precision matrix/matrix multiply routines.
+//
+// MlasHalfGemmIsNative returns true if the platform computes the products in
+// half precision. Otherwise MlasHalfGemm converts blocks of the matrices to
+// single precision and the products are accumulated in single precision.
+//
+
+bool
+MLASCALL
+MlasHalfGemmIsNative(
+    void
+    );
+
+void
+MLASCALL
+MlasHalfGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const unsigned short* A,
+    size_t lda,
+    const unsigned short* B,
+    size_t ldb,
+    unsigned short* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -445,6 +678,66 @@ MlasReorderFilterOIHWBo(
     float* D
     );
 
+//
+// Transpose routines. The M x N input matrix is transposed to the N x M
+// output matrix.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    size_t ldInput,
+    uint8_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    size_t ldInput,
+    uint16_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    size_t ldInput,
+    uint32_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    size_t ldInput,
+    uint64_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const float* Input,
+    size_t ldInput,
+    float* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
 //
 // Single precision NCHWc routines.
 //
@@ -525,6 +818,19 @@ MlasRequantizeOutput(
     uint8_t ZeroPoint
     );
 
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    const float* Scale,
+    bool PerColumnScale,
+    uint8_t ZeroPoint
+    );
+
 void
 MLASCALL
 MlasFindMinMaxElement(
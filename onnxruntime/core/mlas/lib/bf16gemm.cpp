@@ -0,0 +1,583 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm.cpp
+
+Abstract:
+
+    This module implements the bfloat16 matrix/matrix multiply operation
+    (BF16GEMM).
+
+    The single precision inputs are rounded to bfloat16 and the products are
+    accumulated in single precision. Matrix B is packed ahead of time by
+    MlasGemmBf16PackB, so the conversion cost of constant weights is paid
+    once.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a BF16GEMM operation on worker
+// threads.
+//
+
+struct MLAS_GEMM_BF16_WORK_BLOCK {
+    int32_t ThreadCountM;
+    int32_t ThreadCountN;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const float* A;
+    size_t lda;
+    const uint16_t* PackedB;
+    float beta;
+    float* C;
+    size_t ldc;
+};
+
+//
+// Define the striding parameters used for the BF16GEMM operation. StrideK
+// must be even so that only the last slice of matrix B along the K dimension
+// is padded. StrideM must be a multiple of 16, because the AMX kernel loads
+// the tiles of matrix A as 16 rows.
+//
+
+struct MLAS_GEMM_BF16_STRIDES {
+    size_t M;
+    size_t N;
+    size_t K;
+};
+
+constexpr MLAS_GEMM_BF16_STRIDES MlasGemmBf16Strides = {32, 256, 256};
+
+MLAS_FORCEINLINE
+uint16_t
+MlasGemmBf16ConvertFloatToBf16(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision value to bfloat16 with round to
+    nearest even, matching the VCVTNE2PS2BF16 instruction.
+
+Arguments:
+
+    Value - Supplies the value to convert.
+
+Return Value:
+
+    Returns the bfloat16 value.
+
+--*/
+{
+    uint32_t Bits;
+
+    memcpy(&Bits, &Value, sizeof(uint32_t));
+
+    if ((Bits & 0x7FFFFFFF) > 0x7F800000) {
+        return uint16_t((Bits >> 16) | 0x40);
+    }
+
+    Bits += 0x7FFF + ((Bits >> 16) & 1);
+
+    return uint16_t(Bits >> 16);
+}
+
+MLAS_FORCEINLINE
+bool
+MlasGemmBf16Available(
+    void
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    return MlasPlatform.GemmBf16Kernel != nullptr;
+#else
+    return false;
+#endif
+}
+
+#if defined(MLAS_TARGET_AMD64)
+
+void
+MlasGemmBf16Operation(
+    const MLAS_GEMM_BF16_WORK_BLOCK* WorkBlock,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the bfloat16 matrix/matrix multiply operation for
+    a range of matrix C.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    RangeStartM - Supplies the first row of matrix C to compute.
+
+    RangeCountM - Supplies the number of rows of matrix C to compute.
+
+    RangeStartN - Supplies the first column of matrix C to compute. The value
+        is a multiple of MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN.
+
+    RangeCountN - Supplies the number of columns of matrix C to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr MLAS_GEMM_BF16_STRIDES Strides = MlasGemmBf16Strides;
+
+    MLAS_DECLSPEC_ALIGN(uint32_t PanelA[Strides.M * Strides.K / 2], 64);
+
+    const size_t K = WorkBlock->K;
+    const size_t lda = WorkBlock->lda;
+    const size_t ldc = WorkBlock->ldc;
+    const float alpha = WorkBlock->alpha;
+    const float beta = WorkBlock->beta;
+
+    const size_t AlignedN = (WorkBlock->N + MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN - 1) &
+        ~size_t(MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    const float* A = WorkBlock->A + RangeStartM * lda;
+    const uint16_t* PackedB = WorkBlock->PackedB;
+    float* C = WorkBlock->C + RangeStartM * ldc + RangeStartN;
+
+    //
+    // Apply beta to matrix C up front so that every slice along the K
+    // dimension can accumulate into the output.
+    //
+
+    if (beta != 0.0f && beta != 1.0f) {
+        for (size_t m = 0; m < RangeCountM; m++) {
+            float* c = C + m * ldc;
+            for (size_t n = 0; n < RangeCountN; n++) {
+                c[n] *= beta;
+            }
+        }
+    }
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = (std::min)(K - k, Strides.K);
+
+        const size_t PairCountK = (CountK + 1) / 2;
+        const bool ZeroMode = (k == 0) && (beta == 0.0f);
+
+        //
+        // Step through each slice of matrix B along the N dimension.
+        //
+
+        size_t CountN;
+
+        for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+            CountN = (std::min)(RangeCountN - n, Strides.N);
+
+            const uint32_t* b = reinterpret_cast<const uint32_t*>(PackedB) +
+                (RangeStartN + n) * PairCountK;
+
+            //
+            // Step through each slice of matrix A along the M dimension.
+            //
+
+            size_t CountM;
+
+            for (size_t m = 0; m < RangeCountM; m += CountM) {
+
+                CountM = (std::min)(RangeCountM - m, Strides.M);
+
+                //
+                // Convert a panel of matrix A to a local buffer.
+                //
+
+                MlasPlatform.GemmBf16CopyPackARoutine(PanelA, A + m * lda + k, lda,
+                    CountM, CountK);
+
+                const uint32_t* pa = PanelA;
+                float* c = C + m * ldc + n;
+                size_t RowsRemaining = CountM;
+
+                while (RowsRemaining > 0) {
+
+                    size_t RowsHandled = MlasPlatform.GemmBf16Kernel(pa, b, c,
+                        PairCountK, RowsRemaining, CountN, ldc, alpha, ZeroMode);
+
+                    c += ldc * RowsHandled;
+                    pa += PairCountK * RowsHandled;
+                    RowsRemaining -= RowsHandled;
+                }
+            }
+        }
+
+        PackedB += AlignedN * PairCountK * 2;
+    }
+}
+
+void
+MlasGemmBf16Threaded(
+    void* Context,
+    int32_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    BF16GEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_GEMM_BF16_WORK_BLOCK*)Context;
+
+    const int32_t ThreadIdM = ThreadId / WorkBlock->ThreadCountN;
+    const int32_t ThreadIdN = ThreadId % WorkBlock->ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t RangeStartM;
+    size_t RangeCountM;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, WorkBlock->M,
+        &RangeStartM, &RangeCountM);
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t RangeStartN;
+    size_t RangeCountN;
+
+    const size_t BlockedN = (WorkBlock->N + MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, BlockedN,
+        &RangeStartN, &RangeCountN);
+
+    RangeStartN *= MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN;
+    RangeCountN *= MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN;
+
+    RangeCountN = std::min(WorkBlock->N - RangeStartN, RangeCountN);
+
+    MlasGemmBf16Operation(WorkBlock, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+}
+
+#endif
+
+size_t
+MLASCALL
+MlasGemmBf16PackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack a matrix with
+    the supplied shape for the bfloat16 matrix/matrix multiply operation.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the the number of rows of matrix B.
+
+Return Value:
+
+    Returns the number of bytes required to pack the matrix, else zero if the
+    platform does not support the operation.
+
+--*/
+{
+    if (!MlasGemmBf16Available()) {
+        return 0;
+    }
+
+    //
+    // Compute the number of bytes required to hold the packed buffer. Only
+    // the last slice along the K dimension can have an odd number of rows.
+    //
+
+    const size_t AlignedN = (N + MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN - 1) &
+        ~size_t(MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN - 1);
+    const size_t AlignedK = (K + 1) & ~size_t(1);
+
+    const size_t BytesRequired = AlignedN * AlignedK * sizeof(uint16_t);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired = (BytesRequired + BufferAlignment - 1) &
+        ~(BufferAlignment - 1);
+
+    return AlignedBytesRequired;
+}
+
+void
+MLASCALL
+MlasGemmBf16PackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the supplied single precision matrix B to the supplied
+    packed matrix B buffer. The size of the packed buffer was obtained from
+    MlasGemmBf16PackBSize.
+
+    Each slice of matrix B along the K dimension is stored as panels of 16
+    columns. Each row of a panel holds the bfloat16 values of two consecutive
+    rows of matrix B interleaved by column. Columns beyond N and the row
+    beyond an odd K are padded with zero.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B after the transpose
+        operation.
+
+    K - Supplies the the number of rows of matrix B after the transpose
+        operation.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (!MlasGemmBf16Available()) {
+        throw std::runtime_error("packing unavailable");
+    }
+
+    const size_t AlignedN = (N + MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN - 1) &
+        ~size_t(MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    uint16_t* pb = (uint16_t*)PackedB;
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = (std::min)(K - k, MlasGemmBf16Strides.K);
+
+        const size_t PairCountK = (CountK + 1) / 2;
+
+        for (size_t n = 0; n < AlignedN; n += 16) {
+
+            for (size_t kk = 0; kk < PairCountK * 2; kk++) {
+
+                //
+                // Rows kk and kk+1 of this slice are interleaved in each
+                // 32-bit element of the panel row kk/2.
+                //
+
+                uint16_t* d = pb + (kk / 2) * 32 + (kk & 1);
+
+                for (size_t nn = 0; nn < 16; nn++) {
+
+                    float Value = 0.0f;
+
+                    if (kk < CountK && n + nn < N) {
+                        Value = (TransB == CblasNoTrans) ?
+                            B[(k + kk) * ldb + n + nn] : B[(n + nn) * ldb + k + kk];
+                    }
+
+                    d[nn * 2] = MlasGemmBf16ConvertFloatToBf16(Value);
+                }
+            }
+
+            pb += PairCountK * 32;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasGemmBf16(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the bfloat16 matrix/matrix multiply operation
+    C = alpha * A * B + beta * C, where matrix B was packed by
+    MlasGemmBf16PackB.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar multiplier (see GEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see GEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (!MlasGemmBf16Available()) {
+        throw std::runtime_error("bfloat16 GEMM unavailable");
+    }
+
+    //
+    // Handle the degenerate case of an empty inner dimension, which produces
+    // C = beta * C.
+    //
+
+    if (K == 0) {
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                C[m * ldc + n] = (beta == 0.0f) ? 0.0f : C[m * ldc + n] * beta;
+            }
+        }
+        return;
+    }
+
+    MLAS_GEMM_BF16_WORK_BLOCK WorkBlock;
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.PackedB = (const uint16_t*)PackedB;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_BF16GEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_BF16GEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads.
+    //
+    // N.B. Currently, the operation is segmented as a 1D partition, which
+    // works okay for operations involving skinny matrices.
+    //
+
+    if (N > M) {
+
+        const size_t BlockedN = (N + MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(TargetThreadCount) > BlockedN) {
+            TargetThreadCount = int32_t(BlockedN);
+        }
+
+        WorkBlock.ThreadCountM = 1;
+        WorkBlock.ThreadCountN = TargetThreadCount;
+
+    } else {
+
+        if (size_t(TargetThreadCount) > M) {
+            TargetThreadCount = int32_t(M);
+        }
+
+        WorkBlock.ThreadCountM = TargetThreadCount;
+        WorkBlock.ThreadCountN = 1;
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    MlasExecuteThreaded(MlasGemmBf16Threaded, &WorkBlock, TargetThreadCount, ThreadPool);
+#else
+    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+#endif
+}
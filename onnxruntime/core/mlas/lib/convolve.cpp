@@ -23,6 +23,21 @@ Abstract:
 #define MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD \
     (MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK)
 
+//
+// Define the number of elements of a Winograd F(2x2, 3x3) tile: each 4x4
+// input tile produces a 2x2 output tile.
+//
+
+#define MLAS_CONV_WINOGRAD_TILE_SIZE 16
+
+//
+// Define the minimum channel and tile counts for the Winograd algorithm. The
+// transforms cost more than the multiplies saved for smaller convolutions.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS 16
+#define MLAS_CONV_WINOGRAD_MINIMUM_TILES 16
+
 //
 // Define the parameters to execute segments of a convolution operation on
 // worker threads.
@@ -736,6 +751,471 @@ Return Value:
     }
 }
 
+//
+// Define the parameters to execute the transforms of a Winograd convolution
+// on worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    float* TransformedInput;
+    const float* TransformedOutput;
+    const float* Bias;
+    float* Output;
+    int32_t TargetThreadCount;
+};
+
+void
+MlasConvWinogradTransformFilterBlock(
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 3x3 filters of one group to the Winograd
+    F(2x2, 3x3) domain by computing G * g * G^T for each filter.
+
+Arguments:
+
+    FilterCount - Supplies the number of filters of the group.
+
+    InputChannels - Supplies the number of input channels of the group.
+
+    Filter - Supplies the filter tensor of the group.
+
+    TransformedFilter - Supplies the buffer to receive the transformed filter
+        tensor, stored as MLAS_CONV_WINOGRAD_TILE_SIZE matrices of shape
+        [FilterCount, InputChannels].
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterStride = FilterCount * InputChannels;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            const float* g = Filter + (f * InputChannels + c) * 9;
+
+            //
+            // Apply G to the columns of the filter and then to the rows of
+            // the intermediate result.
+            //
+
+            float t[4][3];
+
+            for (size_t j = 0; j < 3; j++) {
+                t[0][j] = g[j];
+                t[1][j] = 0.5f * (g[j] + g[3 + j] + g[6 + j]);
+                t[2][j] = 0.5f * (g[j] - g[3 + j] + g[6 + j]);
+                t[3][j] = g[6 + j];
+            }
+
+            float* u = TransformedFilter + f * InputChannels + c;
+
+            for (size_t i = 0; i < 4; i++) {
+                u[(i * 4 + 0) * FilterStride] = t[i][0];
+                u[(i * 4 + 1) * FilterStride] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+                u[(i * 4 + 2) * FilterStride] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+                u[(i * 4 + 3) * FilterStride] = t[i][2];
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradTransformInputThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to transform a range of input
+    channels to the Winograd F(2x2, 3x3) domain by computing B^T * d * B for
+    each 4x4 input tile.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TileCountHeight = Parameters->u.Winograd.TileCountHeight;
+    const size_t TileCountWidth = Parameters->u.Winograd.TileCountWidth;
+    const size_t TileCount = TileCountHeight * TileCountWidth;
+    const size_t TransformedStride = InputChannels * TileCount;
+
+    size_t ChannelStart;
+    size_t ChannelRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, InputChannels,
+        &ChannelStart, &ChannelRemaining);
+
+    for (size_t c = ChannelStart; c < ChannelStart + ChannelRemaining; c++) {
+
+        const float* input = WorkBlock->Input + c * Parameters->InputSize;
+        float* v = WorkBlock->TransformedInput + c * TileCount;
+
+        for (size_t th = 0; th < TileCountHeight; th++) {
+
+            for (size_t tw = 0; tw < TileCountWidth; tw++) {
+
+                //
+                // Gather the 4x4 input tile, substituting zero for the
+                // padding. The subtraction wraps around for the rows and
+                // columns before the start of the input.
+                //
+
+                float d[4][4];
+
+                for (size_t i = 0; i < 4; i++) {
+
+                    size_t ih = th * 2 + i - PaddingTop;
+
+                    for (size_t j = 0; j < 4; j++) {
+
+                        size_t iw = tw * 2 + j - PaddingLeft;
+
+                        d[i][j] = (ih < InputHeight && iw < InputWidth) ?
+                            input[ih * InputWidth + iw] : 0.0f;
+                    }
+                }
+
+                //
+                // Apply B^T to the columns of the tile and then to the rows
+                // of the intermediate result.
+                //
+
+                float t[4][4];
+
+                for (size_t j = 0; j < 4; j++) {
+                    t[0][j] = d[0][j] - d[2][j];
+                    t[1][j] = d[1][j] + d[2][j];
+                    t[2][j] = d[2][j] - d[1][j];
+                    t[3][j] = d[1][j] - d[3][j];
+                }
+
+                float* vt = v + th * TileCountWidth + tw;
+
+                for (size_t i = 0; i < 4; i++) {
+                    vt[(i * 4 + 0) * TransformedStride] = t[i][0] - t[i][2];
+                    vt[(i * 4 + 1) * TransformedStride] = t[i][1] + t[i][2];
+                    vt[(i * 4 + 2) * TransformedStride] = t[i][2] - t[i][1];
+                    vt[(i * 4 + 3) * TransformedStride] = t[i][1] - t[i][3];
+                }
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradTransformOutputThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to transform a range of
+    output channels from the Winograd F(2x2, 3x3) domain by computing
+    A^T * m * A for each tile and then to apply the activation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TileCountHeight = Parameters->u.Winograd.TileCountHeight;
+    const size_t TileCountWidth = Parameters->u.Winograd.TileCountWidth;
+    const size_t TileCount = TileCountHeight * TileCountWidth;
+    const size_t TransformedStride = FilterCount * TileCount;
+
+    size_t FilterStart;
+    size_t FilterRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, FilterCount,
+        &FilterStart, &FilterRemaining);
+
+    for (size_t f = FilterStart; f < FilterStart + FilterRemaining; f++) {
+
+        const float* m = WorkBlock->TransformedOutput + f * TileCount;
+        float* output = WorkBlock->Output + f * OutputSize;
+
+        for (size_t th = 0; th < TileCountHeight; th++) {
+
+            for (size_t tw = 0; tw < TileCountWidth; tw++) {
+
+                const float* mt = m + th * TileCountWidth + tw;
+
+                //
+                // Apply A^T to the columns of the tile and then to the rows
+                // of the intermediate result.
+                //
+
+                float t[2][4];
+
+                for (size_t j = 0; j < 4; j++) {
+
+                    float m0 = mt[(0 * 4 + j) * TransformedStride];
+                    float m1 = mt[(1 * 4 + j) * TransformedStride];
+                    float m2 = mt[(2 * 4 + j) * TransformedStride];
+                    float m3 = mt[(3 * 4 + j) * TransformedStride];
+
+                    t[0][j] = m0 + m1 + m2;
+                    t[1][j] = m1 - m2 - m3;
+                }
+
+                //
+                // Store the 2x2 output tile, clipping the tiles that extend
+                // past the bottom or right edge of the output.
+                //
+
+                const size_t oh = th * 2;
+                const size_t ow = tw * 2;
+
+                for (size_t i = 0; i < 2 && oh + i < OutputHeight; i++) {
+
+                    float* out = output + (oh + i) * OutputWidth + ow;
+
+                    out[0] = t[i][0] + t[i][1] + t[i][2];
+
+                    if (ow + 1 < OutputWidth) {
+                        out[1] = t[i][1] - t[i][2] - t[i][3];
+                    }
+                }
+            }
+        }
+    }
+
+    //
+    // Apply the activation with optional bias.
+    //
+
+    const float* bias = WorkBlock->Bias;
+
+    if (bias != nullptr) {
+        bias += FilterStart;
+    }
+
+    MlasActivation(Parameters->Activation, WorkBlock->Output + FilterStart * OutputSize,
+        bias, FilterRemaining, OutputSize, OutputSize);
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* TransformedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a 3x3 convolution of one batch and group with the
+    Winograd F(2x2, 3x3) algorithm. The input and filter tiles are transformed
+    so that the convolution reduces to one GEMM for each of the elements of a
+    transformed tile, which is then transformed back to the output.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the batch and group.
+
+    TransformedFilter - Supplies the filter tensor of the group transformed by
+        MlasConvWinogradTransformFilterBlock.
+
+    Bias - Optionally supplies the bias vector of the group.
+
+    WorkingBuffer - Supplies a working buffer large enough for the transformed
+        input and output tiles.
+
+    Output - Supplies the output tensor of the batch and group.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TileCount = Parameters->u.Winograd.TileCountHeight *
+        Parameters->u.Winograd.TileCountWidth;
+
+    float* TransformedInput = WorkingBuffer;
+    float* TransformedOutput = WorkingBuffer + MLAS_CONV_WINOGRAD_TILE_SIZE * InputChannels * TileCount;
+
+    const int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.TransformedInput = TransformedInput;
+    WorkBlock.TransformedOutput = TransformedOutput;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+
+    //
+    // Transform the input tiles.
+    //
+
+    WorkBlock.TargetThreadCount = int32_t(std::min(size_t(MaximumThreadCount), InputChannels));
+
+    MlasExecuteThreaded(MlasConvWinogradTransformInputThreaded, &WorkBlock,
+        WorkBlock.TargetThreadCount, ThreadPool);
+
+    //
+    // Multiply the transformed filter and input matrices for each element of
+    // a transformed tile.
+    //
+
+    for (size_t xi = 0; xi < MLAS_CONV_WINOGRAD_TILE_SIZE; xi++) {
+
+        MlasGemm(CblasNoTrans, CblasNoTrans, FilterCount, TileCount, InputChannels, 1.0f,
+            TransformedFilter + xi * FilterCount * InputChannels, InputChannels,
+            TransformedInput + xi * InputChannels * TileCount, TileCount, 0.0f,
+            TransformedOutput + xi * FilterCount * TileCount, TileCount, ThreadPool);
+    }
+
+    //
+    // Transform the output tiles and apply the activation.
+    //
+
+    WorkBlock.TargetThreadCount = int32_t(std::min(size_t(MaximumThreadCount), FilterCount));
+
+    MlasExecuteThreaded(MlasConvWinogradTransformOutputThreaded, &WorkBlock,
+        WorkBlock.TargetThreadCount, ThreadPool);
+}
+
+size_t
+MLASCALL
+MlasConvWinogradFilterSize(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of elements of a filter tensor
+    transformed by MlasConvWinogradTransformFilter.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    InputChannels - Supplies the number of input channels per group.
+
+Return Value:
+
+    Returns the number of elements of the transformed filter tensor.
+
+--*/
+{
+    return GroupCount * MLAS_CONV_WINOGRAD_TILE_SIZE * FilterCount * InputChannels;
+}
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a 3x3 filter tensor for the Winograd convolution
+    algorithm.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    Filter - Supplies the filter tensor.
+
+    TransformedFilter - Supplies the buffer to receive the transformed filter
+        tensor, sized to the number of elements returned by
+        MlasConvWinogradFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterGroupSize = FilterCount * InputChannels;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        MlasConvWinogradTransformFilterBlock(FilterCount, InputChannels,
+            Filter + group * FilterGroupSize * 9,
+            TransformedFilter + group * MLAS_CONV_WINOGRAD_TILE_SIZE * FilterGroupSize);
+    }
+}
+
 inline
 bool
 MlasConvTryMultithread(
@@ -910,6 +1390,28 @@ Return Value:
         return;
     }
 
+    //
+    // Transform the filter for the Winograd algorithm unless the caller has
+    // supplied a transformed filter.
+    //
+
+    const float* WinogradFilter = nullptr;
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+
+        WinogradFilter = Parameters->u.Winograd.TransformedFilter;
+
+        if (WinogradFilter == nullptr) {
+
+            MlasConvWinogradTransformFilter(GroupCount, FilterCount,
+                Parameters->InputChannels, Filter, WorkingBuffer);
+
+            WinogradFilter = WorkingBuffer;
+            WorkingBuffer += MlasConvWinogradFilterSize(GroupCount, FilterCount,
+                Parameters->InputChannels);
+        }
+    }
+
     //
     // Iterate over each batch and group.
     //
@@ -988,6 +1490,15 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                {
+                    MlasConvWinograd(Parameters, Input, WinogradFilter + group *
+                        MlasConvWinogradFilterSize(1, FilterCount, Parameters->InputChannels),
+                        bias, WorkingBuffer, Output, ThreadPool);
+
+                    break;
+                }
             }
 
             //
@@ -1191,6 +1702,34 @@ Return Value:
         }
     }
 
+    if (Dimensions == 2 && AllStridesAreOne && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3 &&
+        InputChannels >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        FilterCount >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+
+        //
+        // Use the Winograd F(2x2, 3x3) algorithm for 3x3 convolutions that
+        // produce enough output tiles to amortize the transforms.
+        //
+
+        const size_t TileCountHeight = (Parameters->OutputShape[0] + 1) / 2;
+        const size_t TileCountWidth = (Parameters->OutputShape[1] + 1) / 2;
+        const size_t TileCount = TileCountHeight * TileCountWidth;
+
+        if (TileCount >= MLAS_CONV_WINOGRAD_MINIMUM_TILES) {
+
+            Parameters->Algorithm = MlasConvAlgorithmWinograd;
+            Parameters->u.Winograd.TileCountHeight = TileCountHeight;
+            Parameters->u.Winograd.TileCountWidth = TileCountWidth;
+            Parameters->u.Winograd.TransformedFilter = nullptr;
+
+            *WorkingBufferSize = MlasConvWinogradFilterSize(GroupCount, FilterCount, InputChannels) +
+                MLAS_CONV_WINOGRAD_TILE_SIZE * (InputChannels + FilterCount) * TileCount;
+
+            return;
+        }
+    }
+
     if (FilterCount > OutputSize) {
 
         //
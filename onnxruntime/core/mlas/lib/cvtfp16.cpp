@@ -0,0 +1,247 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvtfp16.cpp
+
+Abstract:
+
+    This module implements routines to convert between FP16 and FP32 formats.
+
+    The implementation below targets the base instruction set and converts
+    one element at a time with integer operations. Kernels using the F16C
+    instructions are selected at runtime on processors supporting them.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+uint32_t
+MlasFloatToBits(
+    float Value
+    )
+{
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(uint32_t));
+    return Bits;
+}
+
+MLAS_FORCEINLINE
+float
+MlasBitsToFloat(
+    uint32_t Bits
+    )
+{
+    float Value;
+    memcpy(&Value, &Bits, sizeof(float));
+    return Value;
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernel(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to convert the source buffer
+    of half-precision floats to the destination buffer of single-precision
+    floats.
+
+Arguments:
+
+    Source - Supplies the source buffer of half-precision floats.
+
+    Destination - Supplies the destination buffer of single-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr uint32_t ShiftedExponent = 0x7C00 << 13;
+    const float MagicDenormal = MlasBitsToFloat(113 << 23);
+
+    for (size_t i = 0; i < Count; i++) {
+
+        const uint32_t Half = Source[i];
+
+        //
+        // Shift the exponent and mantissa into place and adjust the exponent
+        // bias. Infinity and NaNs keep the maximum exponent and denormals are
+        // renormalized with a floating point subtraction.
+        //
+
+        uint32_t Bits = (Half & 0x7FFF) << 13;
+        const uint32_t Exponent = Bits & ShiftedExponent;
+        Bits += (127 - 15) << 23;
+
+        if (Exponent == ShiftedExponent) {
+            Bits += (128 - 16) << 23;
+        } else if (Exponent == 0) {
+            Bits += 1 << 23;
+            Bits = MlasFloatToBits(MlasBitsToFloat(Bits) - MagicDenormal);
+        }
+
+        Destination[i] = MlasBitsToFloat(Bits | ((Half & 0x8000) << 16));
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernel(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to convert the source buffer
+    of single-precision floats to the destination buffer of half-precision
+    floats, rounding to the nearest even value.
+
+Arguments:
+
+    Source - Supplies the source buffer of single-precision floats.
+
+    Destination - Supplies the destination buffer of half-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr uint32_t HalfOverflow = (127 + 16) << 23;
+    constexpr uint32_t HalfSmallestNormal = (127 - 14) << 23;
+    constexpr uint32_t MagicDenormalBits = ((127 - 15) + (23 - 10) + 1) << 23;
+    const float MagicDenormal = MlasBitsToFloat(MagicDenormalBits);
+
+    for (size_t i = 0; i < Count; i++) {
+
+        uint32_t Bits = MlasFloatToBits(Source[i]);
+        const uint32_t Sign = Bits & 0x80000000;
+        Bits ^= Sign;
+
+        uint32_t Half;
+
+        if (Bits >= HalfOverflow) {
+
+            //
+            // Values too large for half precision become infinity and NaNs
+            // become a quiet NaN.
+            //
+
+            Half = (Bits > 0x7F800000) ? 0x7E00 : 0x7C00;
+
+        } else if (Bits < HalfSmallestNormal) {
+
+            //
+            // Align the mantissa of denormals with a floating point addition,
+            // which also rounds the value.
+            //
+
+            Half = MlasFloatToBits(MlasBitsToFloat(Bits) + MagicDenormal) - MagicDenormalBits;
+
+        } else {
+
+            //
+            // Adjust the exponent bias and round the mantissa to nearest even.
+            //
+
+            const uint32_t MantissaOdd = (Bits >> 13) & 1;
+            Bits -= (127 - 15) << 23;
+            Bits += 0xFFF + MantissaOdd;
+            Half = Bits >> 13;
+        }
+
+        Destination[i] = static_cast<unsigned short>(Half | (Sign >> 16));
+    }
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half-precision floats to the
+    destination buffer of single-precision floats.
+
+Arguments:
+
+    Source - Supplies the source buffer of half-precision floats.
+
+    Destination - Supplies the destination buffer of single-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertHalfToFloatKernel(Source, Destination, Count);
+#else
+    MlasConvertHalfToFloatKernel(Source, Destination, Count);
+#endif
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single-precision floats to the
+    destination buffer of half-precision floats, rounding to the nearest even
+    value.
+
+Arguments:
+
+    Source - Supplies the source buffer of single-precision floats.
+
+    Destination - Supplies the destination buffer of half-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertFloatToHalfKernel(Source, Destination, Count);
+#else
+    MlasConvertFloatToHalfKernel(Source, Destination, Count);
+#endif
+}
@@ -0,0 +1,212 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gelu.cpp
+
+Abstract:
+
+    This module implements routines to compute the Gaussian error linear unit
+    (GELU) of a set of rows after adding a bias to the rows.
+
+    The exact form uses the error function while the approximate form (as
+    used by FastGelu) uses the hyperbolic tangent function. Each row is
+    processed in small blocks so that the intermediate values remain in the
+    cache between the passes over the block.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Bundles the constants for use by the GELU routines.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float SquareRootOneHalf;
+    float SquareRootTwoOverPi;
+    float CubicTermCoefficient;
+} MlasGeluConstants = {
+    0.7071067811865476f,        // sqrt(1 / 2)
+    0.7978845608028654f,        // sqrt(2 / pi)
+    0.035677408136300125f,      // 0.044715 * sqrt(2 / pi)
+};
+
+//
+// Stores the number of elements processed per block.
+//
+
+constexpr size_t MlasGeluBlockSize = 256;
+
+template<bool UseApproximation>
+void
+MlasBiasGeluRow(
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t D
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_COMPUTE_UNARY_FLOAT_KERNEL KernelRoutine =
+        UseApproximation ? MlasPlatform.TanhKernelRoutine : MlasPlatform.ErfKernelRoutine;
+#else
+    PMLAS_COMPUTE_UNARY_FLOAT_KERNEL KernelRoutine =
+        UseApproximation ? MlasTanhKernel : MlasErfKernel;
+#endif
+
+    const MLAS_FLOAT32X4 HalfBroadcast = MlasBroadcastFloat32x4(0.5f);
+    const MLAS_FLOAT32X4 OneBroadcast = MlasBroadcastFloat32x4(1.0f);
+    const MLAS_FLOAT32X4 SquareRootOneHalfBroadcast =
+        MlasBroadcastFloat32x4(MlasGeluConstants.SquareRootOneHalf);
+    const MLAS_FLOAT32X4 SquareRootTwoOverPiBroadcast =
+        MlasBroadcastFloat32x4(MlasGeluConstants.SquareRootTwoOverPi);
+    const MLAS_FLOAT32X4 CubicTermCoefficientBroadcast =
+        MlasBroadcastFloat32x4(MlasGeluConstants.CubicTermCoefficient);
+
+    MLAS_DECLSPEC_ALIGN(float Value[MlasGeluBlockSize], 16);
+
+    while (D > 0) {
+
+        const size_t CountThisBlock = std::min(D, MlasGeluBlockSize);
+
+        //
+        // Add the bias to the input and compute the argument of the error or
+        // hyperbolic tangent function. The biased input is buffered as the
+        // output buffer may alias the input buffer.
+        //
+
+        size_t d = 0;
+
+        for (; d + 4 <= CountThisBlock; d += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + d);
+
+            if (Bias != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + d));
+            }
+
+            MlasStoreAlignedFloat32x4(Value + d, Vector);
+
+            if (UseApproximation) {
+                MLAS_FLOAT32X4 Term = MlasMultiplyFloat32x4(Vector, Vector);
+                Term = MlasMultiplyAddFloat32x4(Term, CubicTermCoefficientBroadcast, SquareRootTwoOverPiBroadcast);
+                Vector = MlasMultiplyFloat32x4(Vector, Term);
+            } else {
+                Vector = MlasMultiplyFloat32x4(Vector, SquareRootOneHalfBroadcast);
+            }
+
+            MlasStoreFloat32x4(Output + d, Vector);
+        }
+
+        for (; d < CountThisBlock; d++) {
+
+            float Scalar = Input[d];
+
+            if (Bias != nullptr) {
+                Scalar += Bias[d];
+            }
+
+            Value[d] = Scalar;
+
+            if (UseApproximation) {
+                Output[d] = Scalar * (MlasGeluConstants.CubicTermCoefficient * Scalar * Scalar +
+                    MlasGeluConstants.SquareRootTwoOverPi);
+            } else {
+                Output[d] = Scalar * MlasGeluConstants.SquareRootOneHalf;
+            }
+        }
+
+        KernelRoutine(Output, Output, CountThisBlock);
+
+        //
+        // Compute 0.5 * x * (1 + f(x)).
+        //
+
+        d = 0;
+
+        for (; d + 4 <= CountThisBlock; d += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(Output + d), OneBroadcast);
+            Vector = MlasMultiplyFloat32x4(Vector, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Value + d), HalfBroadcast));
+
+            MlasStoreFloat32x4(Output + d, Vector);
+        }
+
+        for (; d < CountThisBlock; d++) {
+            Output[d] = 0.5f * Value[d] * (Output[d] + 1.0f);
+        }
+
+        Input += CountThisBlock;
+        Output += CountThisBlock;
+
+        if (Bias != nullptr) {
+            Bias += CountThisBlock;
+        }
+
+        D -= CountThisBlock;
+    }
+}
+
+void
+MLASCALL
+MlasComputeBiasGelu(
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool UseApproximation
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the Gaussian error linear unit of a set of rows
+    after adding a bias to the rows:
+
+        Value = Input + Bias
+        Output = 0.5 * Value * (1 + erf(Value / sqrt(2)))
+
+    or, if the approximation is used:
+
+        Output = 0.5 * Value * (1 + tanh(sqrt(2 / pi) * (Value + 0.044715 * Value^3)))
+
+Arguments:
+
+    Input - Supplies the input buffer of N rows by D columns.
+
+    Bias - Optionally supplies the bias of D elements added to each row.
+
+    Output - Supplies the output buffer of N rows by D columns. The output
+        buffer may alias the input buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns of each row.
+
+    UseApproximation - Supplies true to use the hyperbolic tangent
+        approximation, else false to use the error function.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < N; n++) {
+
+        if (UseApproximation) {
+            MlasBiasGeluRow<true>(Input, Bias, Output, D);
+        } else {
+            MlasBiasGeluRow<false>(Input, Bias, Output, D);
+        }
+
+        Input += D;
+        Output += D;
+    }
+}
@@ -0,0 +1,413 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm.cpp
+
+Abstract:
+
+    This module implements the half-precision matrix/matrix multiply
+    operation (HALFGEMM).
+
+    Processors that support the ARMv8.2 half-precision vector arithmetic
+    instructions multiply and accumulate the values directly. Otherwise,
+    blocks of the matrices are converted to single precision and multiplied
+    with the single precision GEMM.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a HALFGEMM operation on worker
+// threads.
+//
+
+struct MLAS_HALFGEMM_WORK_BLOCK {
+    int32_t ThreadCountM;
+    int32_t ThreadCountN;
+    size_t M;
+    size_t N;
+    size_t K;
+    const unsigned short* A;
+    size_t lda;
+    const unsigned short* B;
+    size_t ldb;
+    unsigned short* C;
+    size_t ldc;
+};
+
+//
+// Define the striding parameters used for the single precision fallback of
+// the HALFGEMM operation.
+//
+
+struct MLAS_HALFGEMM_STRIDES {
+    size_t M;
+    size_t N;
+    size_t K;
+};
+
+constexpr MLAS_HALFGEMM_STRIDES MlasHalfGemmStrides = {32, 64, 128};
+
+bool
+MLASCALL
+MlasHalfGemmIsNative(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether the platform multiplies and accumulates the
+    half-precision values directly.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns true if the half-precision kernel is available, else false.
+
+--*/
+{
+#if defined(MLAS_TARGET_ARM64)
+    return MlasPlatform.HalfGemmKernel != nullptr;
+#else
+    return false;
+#endif
+}
+
+void
+MlasHalfGemmOperation(
+    const MLAS_HALFGEMM_WORK_BLOCK* WorkBlock,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the half-precision matrix/matrix multiply
+    operation for a range of matrix C.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    RangeStartM - Supplies the first row of matrix C to compute.
+
+    RangeCountM - Supplies the number of rows of matrix C to compute.
+
+    RangeStartN - Supplies the first column of matrix C to compute.
+
+    RangeCountN - Supplies the number of columns of matrix C to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t K = WorkBlock->K;
+    const size_t lda = WorkBlock->lda;
+    const size_t ldb = WorkBlock->ldb;
+    const size_t ldc = WorkBlock->ldc;
+
+    const unsigned short* A = WorkBlock->A + RangeStartM * lda;
+    const unsigned short* B = WorkBlock->B + RangeStartN;
+    unsigned short* C = WorkBlock->C + RangeStartM * ldc + RangeStartN;
+
+#if defined(MLAS_TARGET_ARM64)
+
+    if (MlasPlatform.HalfGemmKernel != nullptr) {
+
+        //
+        // The kernel reads the matrices in place, so step through slices of
+        // matrix B along the N dimension to keep the slice in the cache while
+        // the rows of matrix A are processed.
+        //
+
+        size_t CountN;
+
+        for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+            CountN = (std::min)(RangeCountN - n, size_t(256));
+
+            const unsigned short* a = A;
+            unsigned short* c = C + n;
+            size_t RowsRemaining = RangeCountM;
+
+            while (RowsRemaining > 0) {
+
+                size_t RowsHandled = MlasPlatform.HalfGemmKernel(a, B + n, c,
+                    K, RowsRemaining, CountN, lda, ldb, ldc);
+
+                a += lda * RowsHandled;
+                c += ldc * RowsHandled;
+                RowsRemaining -= RowsHandled;
+            }
+        }
+
+        return;
+    }
+
+#endif
+
+    constexpr MLAS_HALFGEMM_STRIDES Strides = MlasHalfGemmStrides;
+
+    MLAS_DECLSPEC_ALIGN(float PanelA[Strides.M * Strides.K], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelB[Strides.K * Strides.N], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelC[Strides.M * Strides.N], 64);
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        CountN = (std::min)(RangeCountN - n, Strides.N);
+
+        //
+        // Step through each slice of matrix A along the M dimension.
+        //
+
+        size_t CountM;
+
+        for (size_t m = 0; m < RangeCountM; m += CountM) {
+
+            CountM = (std::min)(RangeCountM - m, Strides.M);
+
+            //
+            // Accumulate the block of matrix C in single precision over the
+            // slices along the K dimension.
+            //
+
+            size_t CountK;
+
+            for (size_t k = 0; k < K; k += CountK) {
+
+                CountK = (std::min)(K - k, Strides.K);
+
+                for (size_t mm = 0; mm < CountM; mm++) {
+                    MlasConvertHalfToFloatBuffer(A + (m + mm) * lda + k,
+                        PanelA + mm * CountK, CountK);
+                }
+
+                for (size_t kk = 0; kk < CountK; kk++) {
+                    MlasConvertHalfToFloatBuffer(B + (k + kk) * ldb + n,
+                        PanelB + kk * CountN, CountN);
+                }
+
+                MlasSgemmOperation(CblasNoTrans, CblasNoTrans, CountM, CountN,
+                    CountK, 1.0f, PanelA, CountK, PanelB, CountN,
+                    (k == 0) ? 0.0f : 1.0f, PanelC, CountN);
+            }
+
+            for (size_t mm = 0; mm < CountM; mm++) {
+                MlasConvertFloatToHalfBuffer(PanelC + mm * CountN,
+                    C + (m + mm) * ldc + n, CountN);
+            }
+        }
+    }
+}
+
+void
+MlasHalfGemmThreaded(
+    void* Context,
+    int32_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    HALFGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_HALFGEMM_WORK_BLOCK*)Context;
+
+    const int32_t ThreadIdM = ThreadId / WorkBlock->ThreadCountN;
+    const int32_t ThreadIdN = ThreadId % WorkBlock->ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t RangeStartM;
+    size_t RangeCountM;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, WorkBlock->M,
+        &RangeStartM, &RangeCountM);
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t RangeStartN;
+    size_t RangeCountN;
+
+    const size_t BlockedN = (WorkBlock->N + MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, BlockedN,
+        &RangeStartN, &RangeCountN);
+
+    RangeStartN *= MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN;
+    RangeCountN *= MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN;
+
+    RangeCountN = std::min(WorkBlock->N - RangeStartN, RangeCountN);
+
+    MlasHalfGemmOperation(WorkBlock, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+}
+
+void
+MLASCALL
+MlasHalfGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const unsigned short* A,
+    size_t lda,
+    const unsigned short* B,
+    size_t ldb,
+    unsigned short* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the half-precision matrix/matrix multiply
+    operation C = A * B. The matrices hold IEEE half-precision values.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    //
+    // Handle the degenerate case of an empty inner dimension.
+    //
+
+    if (K == 0) {
+        for (size_t m = 0; m < M; m++) {
+            std::fill_n(C + m * ldc, N, (unsigned short)0);
+        }
+        return;
+    }
+
+    MLAS_HALFGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_HALFGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_HALFGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads.
+    //
+    // N.B. Currently, the operation is segmented as a 1D partition, which
+    // works okay for operations involving skinny matrices.
+    //
+
+    if (N > M) {
+
+        const size_t BlockedN = (N + MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(TargetThreadCount) > BlockedN) {
+            TargetThreadCount = int32_t(BlockedN);
+        }
+
+        WorkBlock.ThreadCountM = 1;
+        WorkBlock.ThreadCountN = TargetThreadCount;
+
+    } else {
+
+        if (size_t(TargetThreadCount) > M) {
+            TargetThreadCount = int32_t(M);
+        }
+
+        WorkBlock.ThreadCountM = TargetThreadCount;
+        WorkBlock.ThreadCountN = 1;
+    }
+
+    MlasExecuteThreaded(MlasHalfGemmThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
@@ -0,0 +1,89 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    amx_common.h
+
+Abstract:
+
+    This module contains common definitions for the kernels that use the
+    Advanced Matrix Extensions (AMX) tile instructions.
+
+--*/
+
+#pragma once
+
+#include "../../mlasi.h"
+
+//
+// Define the tile registers used by the GEMM kernels. Each kernel iteration
+// computes a block of up to 32 rows by 32 columns using four accumulator
+// tiles, two tiles of matrix A and two tiles of matrix B. Every tile is
+// configured as 16 rows of 64 bytes.
+//
+
+#define MLAS_AMX_TILE_C00               0
+#define MLAS_AMX_TILE_C01               1
+#define MLAS_AMX_TILE_C10               2
+#define MLAS_AMX_TILE_C11               3
+#define MLAS_AMX_TILE_A0                4
+#define MLAS_AMX_TILE_A1                5
+#define MLAS_AMX_TILE_B0                6
+#define MLAS_AMX_TILE_B1                7
+
+constexpr size_t MLAS_AMX_TILE_ROWS = 16;
+constexpr size_t MLAS_AMX_TILE_ROW_BYTES = 64;
+
+//
+// Define the memory layout consumed by the LDTILECFG instruction.
+//
+
+struct MLAS_AMX_TILE_CONFIG {
+    uint8_t PaletteId;
+    uint8_t StartRow;
+    uint8_t Reserved[14];
+    uint16_t ColumnBytes[16];
+    uint8_t Rows[16];
+};
+
+static_assert(sizeof(MLAS_AMX_TILE_CONFIG) == 64, "unexpected tile configuration size");
+
+MLAS_FORCEINLINE
+void
+MlasAmxLoadTileConfig(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine configures the tile registers used by the GEMM kernels.
+
+    N.B. The configuration is loaded on every kernel invocation because other
+    code running on this thread may reconfigure or release the tiles.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(MLAS_AMX_TILE_CONFIG TileConfig, 64) = {};
+
+    TileConfig.PaletteId = 1;
+
+    for (unsigned tile = MLAS_AMX_TILE_C00; tile <= MLAS_AMX_TILE_B1; tile++) {
+        TileConfig.ColumnBytes[tile] = uint16_t(MLAS_AMX_TILE_ROW_BYTES);
+        TileConfig.Rows[tile] = uint8_t(MLAS_AMX_TILE_ROWS);
+    }
+
+    _tile_loadconfig(&TileConfig);
+}
@@ -0,0 +1,293 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm_amx.cpp
+
+Abstract:
+
+    This module implements the kernel for the bfloat16 matrix/matrix multiply
+    operation (BF16GEMM) with the AMX-BF16 tile instructions.
+
+    The kernel consumes the same buffers as the AVX512_BF16 kernel: matrix A
+    is converted by MlasGemmBf16CopyPackAAvx512Bf16 and matrix B is packed by
+    MlasGemmBf16PackB to panels of 16 columns, where each 64-byte row holds the
+    bfloat16 values of rows k and k+1 for every column. A 64-byte row of a
+    panel is therefore also a row of an AMX tile in VNNI layout.
+
+    Pairs along the K dimension that do not fill a complete tile are
+    accumulated with AVX512_BF16 instructions while the tile results are moved
+    to matrix C.
+
+--*/
+
+#include "amx_common.h"
+
+//
+// Define the number of bytes of packed matrix B for one tile along the K
+// dimension.
+//
+
+constexpr size_t MLAS_GEMM_BF16_AMX_TILE_BYTES_B = MLAS_AMX_TILE_ROWS * MLAS_AMX_TILE_ROW_BYTES;
+
+template<bool ComputeHighRows, bool ComputeHighColumns>
+MLAS_FORCEINLINE
+void
+MlasGemmBf16ComputeTilesAmx(
+    const uint32_t* A,
+    size_t lda,
+    const uint32_t* B0,
+    const uint32_t* B1,
+    size_t TileCountK,
+    float* Accumulators
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of up to 32 rows by 32 columns with the tile
+    instructions and stores the accumulators to the supplied buffer.
+
+Arguments:
+
+    A - Supplies the address of the converted matrix A.
+
+    lda - Supplies the number of bytes per row of the converted matrix A.
+
+    B0 - Supplies the address of the first panel of the packed matrix B.
+
+    B1 - Supplies the address of the second panel of the packed matrix B. Only
+        read if ComputeHighColumns is true.
+
+    TileCountK - Supplies the number of tiles along the K dimension.
+
+    Accumulators - Supplies the address of a buffer of 32 rows by 32 columns
+        that receives the accumulators.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    _tile_zero(MLAS_AMX_TILE_C00);
+
+    if (ComputeHighColumns) {
+        _tile_zero(MLAS_AMX_TILE_C01);
+    }
+
+    if (ComputeHighRows) {
+        _tile_zero(MLAS_AMX_TILE_C10);
+
+        if (ComputeHighColumns) {
+            _tile_zero(MLAS_AMX_TILE_C11);
+        }
+    }
+
+    const uint8_t* a0 = reinterpret_cast<const uint8_t*>(A);
+    const uint8_t* a1 = a0 + MLAS_AMX_TILE_ROWS * lda;
+    const uint8_t* b0 = reinterpret_cast<const uint8_t*>(B0);
+    const uint8_t* b1 = reinterpret_cast<const uint8_t*>(B1);
+
+    for (size_t k = 0; k < TileCountK; k++) {
+
+        _tile_loadd(MLAS_AMX_TILE_B0, b0, MLAS_AMX_TILE_ROW_BYTES);
+        _tile_loadd(MLAS_AMX_TILE_A0, a0, lda);
+        _tile_dpbf16ps(MLAS_AMX_TILE_C00, MLAS_AMX_TILE_A0, MLAS_AMX_TILE_B0);
+
+        if (ComputeHighColumns) {
+            _tile_loadd(MLAS_AMX_TILE_B1, b1, MLAS_AMX_TILE_ROW_BYTES);
+            _tile_dpbf16ps(MLAS_AMX_TILE_C01, MLAS_AMX_TILE_A0, MLAS_AMX_TILE_B1);
+        }
+
+        if (ComputeHighRows) {
+
+            _tile_loadd(MLAS_AMX_TILE_A1, a1, lda);
+            _tile_dpbf16ps(MLAS_AMX_TILE_C10, MLAS_AMX_TILE_A1, MLAS_AMX_TILE_B0);
+
+            if (ComputeHighColumns) {
+                _tile_dpbf16ps(MLAS_AMX_TILE_C11, MLAS_AMX_TILE_A1, MLAS_AMX_TILE_B1);
+            }
+        }
+
+        a0 += MLAS_AMX_TILE_ROW_BYTES;
+        a1 += MLAS_AMX_TILE_ROW_BYTES;
+        b0 += MLAS_GEMM_BF16_AMX_TILE_BYTES_B;
+        b1 += MLAS_GEMM_BF16_AMX_TILE_BYTES_B;
+    }
+
+    constexpr size_t StrideBytes = 32 * sizeof(float);
+
+    _tile_stored(MLAS_AMX_TILE_C00, Accumulators, StrideBytes);
+
+    if (ComputeHighColumns) {
+        _tile_stored(MLAS_AMX_TILE_C01, Accumulators + 16, StrideBytes);
+    }
+
+    if (ComputeHighRows) {
+        _tile_stored(MLAS_AMX_TILE_C10, Accumulators + 16 * 32, StrideBytes);
+
+        if (ComputeHighColumns) {
+            _tile_stored(MLAS_AMX_TILE_C11, Accumulators + 16 * 32 + 16, StrideBytes);
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmBf16KernelAmx(
+    const uint32_t* A,
+    const uint32_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+    N.B. The tiles of matrix A are always loaded as 16 rows. The caller must
+    ensure that the converted buffer is readable up to the next multiple of 16
+    rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A converted by
+        MlasGemmBf16CopyPackAAvx512Bf16.
+
+    B - Supplies the address of matrix B packed by MlasGemmBf16PackB.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of bfloat16 values along the K
+        dimension.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see GEMM definition).
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Accumulators[32 * 32], 64);
+
+    const size_t RowCount = std::min(CountM, size_t(32));
+    const size_t lda = PairCountK * sizeof(uint32_t);
+    const size_t TileCountK = PairCountK / MLAS_AMX_TILE_ROWS;
+    const size_t PanelCountB = PairCountK * 16;
+    const bool ComputeHighRows = (RowCount > 16);
+    const __m512 AlphaBroadcast = _mm512_set1_ps(alpha);
+
+    if (TileCountK > 0) {
+        MlasAmxLoadTileConfig();
+    }
+
+    for (size_t n = 0; n < CountN; n += 32) {
+
+        const size_t CountBlockN = std::min(CountN - n, size_t(32));
+        const bool ComputeHighColumns = (CountBlockN > 16);
+
+        const uint32_t* b0 = B;
+        const uint32_t* b1 = B + PanelCountB;
+
+        //
+        // Compute the complete tiles along the K dimension.
+        //
+
+        if (TileCountK > 0) {
+
+            if (ComputeHighRows) {
+                if (ComputeHighColumns) {
+                    MlasGemmBf16ComputeTilesAmx<true, true>(A, lda, b0, b1, TileCountK, Accumulators);
+                } else {
+                    MlasGemmBf16ComputeTilesAmx<true, false>(A, lda, b0, b1, TileCountK, Accumulators);
+                }
+            } else {
+                if (ComputeHighColumns) {
+                    MlasGemmBf16ComputeTilesAmx<false, true>(A, lda, b0, b1, TileCountK, Accumulators);
+                } else {
+                    MlasGemmBf16ComputeTilesAmx<false, false>(A, lda, b0, b1, TileCountK, Accumulators);
+                }
+            }
+        }
+
+        //
+        // Accumulate the remaining pairs along the K dimension, scale by alpha
+        // and store or accumulate to matrix C.
+        //
+
+        const __mmask16 Mask0 = __mmask16(0xFFFF >> (16 - std::min(CountBlockN, size_t(16))));
+        const __mmask16 Mask1 = ComputeHighColumns ? __mmask16(0xFFFF >> (32 - CountBlockN)) : __mmask16(0);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            __m512 Accumulator0 = _mm512_setzero_ps();
+            __m512 Accumulator1 = _mm512_setzero_ps();
+
+            if (TileCountK > 0) {
+                Accumulator0 = _mm512_load_ps(Accumulators + r * 32);
+                Accumulator1 = _mm512_load_ps(Accumulators + r * 32 + 16);
+            }
+
+            const uint32_t* a = A + r * PairCountK;
+
+            for (size_t k = TileCountK * MLAS_AMX_TILE_ROWS; k < PairCountK; k++) {
+
+                const __m512bh ABroadcast = (__m512bh)_mm512_set1_epi32(int32_t(a[k]));
+
+                Accumulator0 = _mm512_dpbf16_ps(Accumulator0, ABroadcast,
+                    (__m512bh)_mm512_loadu_si512(b0 + k * 16));
+
+                if (ComputeHighColumns) {
+                    Accumulator1 = _mm512_dpbf16_ps(Accumulator1, ABroadcast,
+                        (__m512bh)_mm512_loadu_si512(b1 + k * 16));
+                }
+            }
+
+            float* c = C + r * ldc + n;
+
+            Accumulator0 = _mm512_mul_ps(Accumulator0, AlphaBroadcast);
+            Accumulator1 = _mm512_mul_ps(Accumulator1, AlphaBroadcast);
+
+            if (!ZeroMode) {
+                Accumulator0 = _mm512_add_ps(Accumulator0, _mm512_maskz_loadu_ps(Mask0, c));
+                Accumulator1 = _mm512_add_ps(Accumulator1, _mm512_maskz_loadu_ps(Mask1, c + 16));
+            }
+
+            _mm512_mask_storeu_ps(c, Mask0, Accumulator0);
+            _mm512_mask_storeu_ps(c + 16, Mask1, Accumulator1);
+        }
+
+        B += PanelCountB * 2;
+    }
+
+    if (TileCountK > 0) {
+        _tile_release();
+    }
+
+    return RowCount;
+}
@@ -0,0 +1,307 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_amx.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) with the AMX-INT8 tile instructions.
+
+    The kernel consumes the same packed buffers as the AVX2 and AVX512VNNI
+    kernels: matrix A is packed as rows of PackedCountK groups of 4 bytes and
+    matrix B is packed as panels of 16 columns, where each 64-byte row holds 4
+    consecutive values along the K dimension for every column. A 64-byte row of
+    a panel is therefore also a row of an AMX tile in VNNI layout.
+
+    Groups along the K dimension that do not fill a complete tile are
+    accumulated with AVX512VNNI instructions while the tile results are moved
+    to matrix C.
+
+--*/
+
+#include "amx_common.h"
+
+//
+// Define the number of bytes of packed matrix B for one tile along the K
+// dimension.
+//
+
+constexpr size_t MLAS_GEMM_U8S8_AMX_TILE_BYTES_B = MLAS_AMX_TILE_ROWS * MLAS_AMX_TILE_ROW_BYTES;
+
+template<bool ComputeHighRows, bool ComputeHighColumns>
+MLAS_FORCEINLINE
+void
+MlasGemmU8S8ComputeTilesAmx(
+    const uint8_t* A,
+    size_t lda,
+    const uint8_t* B0,
+    const uint8_t* B1,
+    size_t TileCountK,
+    int32_t* Accumulators
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of up to 32 rows by 32 columns with the tile
+    instructions and stores the accumulators to the supplied buffer.
+
+Arguments:
+
+    A - Supplies the address of the packed matrix A.
+
+    lda - Supplies the number of bytes per row of the packed matrix A.
+
+    B0 - Supplies the address of the first panel of the packed matrix B.
+
+    B1 - Supplies the address of the second panel of the packed matrix B. Only
+        read if ComputeHighColumns is true.
+
+    TileCountK - Supplies the number of tiles along the K dimension.
+
+    Accumulators - Supplies the address of a buffer of 32 rows by 32 columns
+        that receives the accumulators.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    _tile_zero(MLAS_AMX_TILE_C00);
+
+    if (ComputeHighColumns) {
+        _tile_zero(MLAS_AMX_TILE_C01);
+    }
+
+    if (ComputeHighRows) {
+        _tile_zero(MLAS_AMX_TILE_C10);
+
+        if (ComputeHighColumns) {
+            _tile_zero(MLAS_AMX_TILE_C11);
+        }
+    }
+
+    const uint8_t* A1 = A + MLAS_AMX_TILE_ROWS * lda;
+
+    for (size_t k = 0; k < TileCountK; k++) {
+
+        _tile_loadd(MLAS_AMX_TILE_B0, B0, MLAS_AMX_TILE_ROW_BYTES);
+        _tile_loadd(MLAS_AMX_TILE_A0, A, lda);
+        _tile_dpbusd(MLAS_AMX_TILE_C00, MLAS_AMX_TILE_A0, MLAS_AMX_TILE_B0);
+
+        if (ComputeHighColumns) {
+            _tile_loadd(MLAS_AMX_TILE_B1, B1, MLAS_AMX_TILE_ROW_BYTES);
+            _tile_dpbusd(MLAS_AMX_TILE_C01, MLAS_AMX_TILE_A0, MLAS_AMX_TILE_B1);
+        }
+
+        if (ComputeHighRows) {
+
+            _tile_loadd(MLAS_AMX_TILE_A1, A1, lda);
+            _tile_dpbusd(MLAS_AMX_TILE_C10, MLAS_AMX_TILE_A1, MLAS_AMX_TILE_B0);
+
+            if (ComputeHighColumns) {
+                _tile_dpbusd(MLAS_AMX_TILE_C11, MLAS_AMX_TILE_A1, MLAS_AMX_TILE_B1);
+            }
+        }
+
+        A += MLAS_AMX_TILE_ROW_BYTES;
+        A1 += MLAS_AMX_TILE_ROW_BYTES;
+        B0 += MLAS_GEMM_U8S8_AMX_TILE_BYTES_B;
+        B1 += MLAS_GEMM_U8S8_AMX_TILE_BYTES_B;
+    }
+
+    constexpr size_t StrideBytes = 32 * sizeof(int32_t);
+
+    _tile_stored(MLAS_AMX_TILE_C00, Accumulators, StrideBytes);
+
+    if (ComputeHighColumns) {
+        _tile_stored(MLAS_AMX_TILE_C01, Accumulators + 16, StrideBytes);
+    }
+
+    if (ComputeHighRows) {
+        _tile_stored(MLAS_AMX_TILE_C10, Accumulators + 16 * 32, StrideBytes);
+
+        if (ComputeHighColumns) {
+            _tile_stored(MLAS_AMX_TILE_C11, Accumulators + 16 * 32 + 16, StrideBytes);
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmU8S8KernelAmx(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+    N.B. The tiles of matrix A are always loaded as 16 rows. The caller must
+    ensure that the packed buffer is readable up to the next multiple of 16
+    rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been packed
+        using MlasGemmU8S8CopyPackAAvx2.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasGemmU8S8CopyPackBAvx2.
+
+    C - Supplies the address of matrix C.
+
+    PackedCountK - Supplies the number of packed columns from matrix A and
+        the number of packed rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumBuffer - Supplies the sum of each row from matrix A multiplied by the
+        zero point offset of matrix B. These values are accumulated into every
+        row of matrix C.
+
+    ColumnSumBuffer - Supplies the sum of each column from matrix B multiplied
+        by the zero point offset of matrix A. These values are accumulated into
+        every column of matrix C.
+
+    DepthValue - Supplies the value CountK multiplied by the zero point offset
+        of matrix A multplied by the zero point offset of matrix B. This value is
+        accumulated into every element of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(int32_t Accumulators[32 * 32], 64);
+
+    const size_t RowCount = std::min(CountM, size_t(32));
+    const size_t lda = PackedCountK * 4;
+    const size_t TileCountK = PackedCountK / MLAS_AMX_TILE_ROWS;
+    const size_t PanelBytesB = PackedCountK * MLAS_AMX_TILE_ROW_BYTES;
+    const bool ComputeHighRows = (RowCount > 16);
+
+    if (TileCountK > 0) {
+        MlasAmxLoadTileConfig();
+    }
+
+    for (size_t n = 0; n < CountN; n += 32) {
+
+        const size_t CountBlockN = std::min(CountN - n, size_t(32));
+        const bool ComputeHighColumns = (CountBlockN > 16);
+
+        const uint8_t* b0 = B;
+        const uint8_t* b1 = B + PanelBytesB;
+
+        //
+        // Compute the complete tiles along the K dimension.
+        //
+
+        if (TileCountK > 0) {
+
+            if (ComputeHighRows) {
+                if (ComputeHighColumns) {
+                    MlasGemmU8S8ComputeTilesAmx<true, true>(A, lda, b0, b1, TileCountK, Accumulators);
+                } else {
+                    MlasGemmU8S8ComputeTilesAmx<true, false>(A, lda, b0, b1, TileCountK, Accumulators);
+                }
+            } else {
+                if (ComputeHighColumns) {
+                    MlasGemmU8S8ComputeTilesAmx<false, true>(A, lda, b0, b1, TileCountK, Accumulators);
+                } else {
+                    MlasGemmU8S8ComputeTilesAmx<false, false>(A, lda, b0, b1, TileCountK, Accumulators);
+                }
+            }
+        }
+
+        //
+        // Accumulate the remaining groups along the K dimension, apply the
+        // zero point adjustments and store or accumulate to matrix C.
+        //
+
+        const __mmask16 Mask0 = __mmask16(0xFFFF >> (16 - std::min(CountBlockN, size_t(16))));
+        const __mmask16 Mask1 = ComputeHighColumns ? __mmask16(0xFFFF >> (32 - CountBlockN)) : __mmask16(0);
+
+        const __m512i ColumnSums0 = _mm512_maskz_loadu_epi32(Mask0, ColumnSumBuffer + n);
+        const __m512i ColumnSums1 = _mm512_maskz_loadu_epi32(Mask1, ColumnSumBuffer + n + 16);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            __m512i Accumulator0 = _mm512_setzero_si512();
+            __m512i Accumulator1 = _mm512_setzero_si512();
+
+            if (TileCountK > 0) {
+                Accumulator0 = _mm512_load_si512(Accumulators + r * 32);
+                Accumulator1 = _mm512_load_si512(Accumulators + r * 32 + 16);
+            }
+
+            const int32_t* a = reinterpret_cast<const int32_t*>(A + r * lda);
+
+            for (size_t k = TileCountK * MLAS_AMX_TILE_ROWS; k < PackedCountK; k++) {
+
+                const __m512i ABroadcast = _mm512_set1_epi32(a[k]);
+
+                Accumulator0 = _mm512_dpbusd_epi32(Accumulator0, ABroadcast,
+                    _mm512_loadu_si512(b0 + k * MLAS_AMX_TILE_ROW_BYTES));
+
+                if (ComputeHighColumns) {
+                    Accumulator1 = _mm512_dpbusd_epi32(Accumulator1, ABroadcast,
+                        _mm512_loadu_si512(b1 + k * MLAS_AMX_TILE_ROW_BYTES));
+                }
+            }
+
+            const __m512i RowSum = _mm512_set1_epi32(RowSumBuffer[r] + DepthValue);
+
+            Accumulator0 = _mm512_add_epi32(Accumulator0, _mm512_add_epi32(RowSum, ColumnSums0));
+            Accumulator1 = _mm512_add_epi32(Accumulator1, _mm512_add_epi32(RowSum, ColumnSums1));
+
+            int32_t* c = C + r * ldc + n;
+
+            if (!ZeroMode) {
+                Accumulator0 = _mm512_add_epi32(Accumulator0, _mm512_maskz_loadu_epi32(Mask0, c));
+                Accumulator1 = _mm512_add_epi32(Accumulator1, _mm512_maskz_loadu_epi32(Mask1, c + 16));
+            }
+
+            _mm512_mask_storeu_epi32(c, Mask0, Accumulator0);
+            _mm512_mask_storeu_epi32(c + 16, Mask1, Accumulator1);
+        }
+
+        B += PanelBytesB * 2;
+    }
+
+    if (TileCountK > 0) {
+        _tile_release();
+    }
+
+    return RowCount;
+}
@@ -0,0 +1,86 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvtfp16_avx2.cpp
+
+Abstract:
+
+    This module implements the kernels to convert between FP16 and FP32
+    formats with F16C instructions.
+
+--*/
+
+#include "../../mlasi.h"
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernelF16C(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 8) {
+
+        __m128i Half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source));
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(Half));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        //
+        // Convert the remaining elements through a temporary vector.
+        //
+
+        MLAS_DECLSPEC_ALIGN(unsigned short HalfBuffer[8], 16) = {};
+        MLAS_DECLSPEC_ALIGN(float FloatBuffer[8], 32);
+
+        std::copy_n(Source, Count, HalfBuffer);
+        __m128i Half = _mm_load_si128(reinterpret_cast<const __m128i*>(HalfBuffer));
+        _mm256_store_ps(FloatBuffer, _mm256_cvtph_ps(Half));
+        std::copy_n(FloatBuffer, Count, Destination);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernelF16C(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 8) {
+
+        __m128i Half = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Destination), Half);
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        //
+        // Convert the remaining elements through a temporary vector.
+        //
+
+        MLAS_DECLSPEC_ALIGN(float FloatBuffer[8], 32) = {};
+        MLAS_DECLSPEC_ALIGN(unsigned short HalfBuffer[8], 16);
+
+        std::copy_n(Source, Count, FloatBuffer);
+        __m128i Half = _mm256_cvtps_ph(_mm256_load_ps(FloatBuffer), _MM_FROUND_TO_NEAREST_INT);
+        _mm_store_si128(reinterpret_cast<__m128i*>(HalfBuffer), Half);
+        std::copy_n(HalfBuffer, Count, Destination);
+    }
+}
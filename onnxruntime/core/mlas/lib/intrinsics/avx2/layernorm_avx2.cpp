@@ -0,0 +1,225 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx2.cpp
+
+Abstract:
+
+    This module implements the kernel for the layer normalization of a row
+    with AVX2 and FMA3 instructions.
+
+--*/
+
+#include "../../mlasi.h"
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddFloat32x8(
+    __m256 Vector
+    )
+{
+    __m128 Sum = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Sum = _mm_add_ps(Sum, _mm_movehl_ps(Sum, Sum));
+    Sum = _mm_add_ss(Sum, _mm_shuffle_ps(Sum, Sum, 1));
+    return _mm_cvtss_f32(Sum);
+}
+
+template<bool HasSkip, bool HasBias>
+MLAS_FORCEINLINE
+void
+MlasLayerNormF32KernelAvx2Impl(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t D,
+    float Epsilon
+    )
+{
+    //
+    // Accumulate the sum and the sum of squares of the row using two sets of
+    // accumulators to hide the latency of the additions.
+    //
+
+    __m256 SumVector0 = _mm256_setzero_ps();
+    __m256 SumVector1 = _mm256_setzero_ps();
+    __m256 SumSquareVector0 = _mm256_setzero_ps();
+    __m256 SumSquareVector1 = _mm256_setzero_ps();
+
+    size_t d = 0;
+
+    for (; d + 16 <= D; d += 16) {
+
+        __m256 Value0 = _mm256_loadu_ps(Input + d);
+        __m256 Value1 = _mm256_loadu_ps(Input + d + 8);
+
+        if (HasSkip) {
+            Value0 = _mm256_add_ps(Value0, _mm256_loadu_ps(Skip + d));
+            Value1 = _mm256_add_ps(Value1, _mm256_loadu_ps(Skip + d + 8));
+        }
+
+        if (HasBias) {
+            Value0 = _mm256_add_ps(Value0, _mm256_loadu_ps(Bias + d));
+            Value1 = _mm256_add_ps(Value1, _mm256_loadu_ps(Bias + d + 8));
+        }
+
+        if (HasSkip || HasBias) {
+            _mm256_storeu_ps(Output + d, Value0);
+            _mm256_storeu_ps(Output + d + 8, Value1);
+        }
+
+        SumVector0 = _mm256_add_ps(SumVector0, Value0);
+        SumVector1 = _mm256_add_ps(SumVector1, Value1);
+        SumSquareVector0 = _mm256_fmadd_ps(Value0, Value0, SumSquareVector0);
+        SumSquareVector1 = _mm256_fmadd_ps(Value1, Value1, SumSquareVector1);
+    }
+
+    if (d + 8 <= D) {
+
+        __m256 Value0 = _mm256_loadu_ps(Input + d);
+
+        if (HasSkip) {
+            Value0 = _mm256_add_ps(Value0, _mm256_loadu_ps(Skip + d));
+        }
+
+        if (HasBias) {
+            Value0 = _mm256_add_ps(Value0, _mm256_loadu_ps(Bias + d));
+        }
+
+        if (HasSkip || HasBias) {
+            _mm256_storeu_ps(Output + d, Value0);
+        }
+
+        SumVector0 = _mm256_add_ps(SumVector0, Value0);
+        SumSquareVector0 = _mm256_fmadd_ps(Value0, Value0, SumSquareVector0);
+
+        d += 8;
+    }
+
+    float Sum = MlasReduceAddFloat32x8(_mm256_add_ps(SumVector0, SumVector1));
+    float SumSquare = MlasReduceAddFloat32x8(_mm256_add_ps(SumSquareVector0, SumSquareVector1));
+
+    for (; d < D; d++) {
+
+        float Value = Input[d];
+
+        if (HasSkip) {
+            Value += Skip[d];
+        }
+
+        if (HasBias) {
+            Value += Bias[d];
+        }
+
+        if (HasSkip || HasBias) {
+            Output[d] = Value;
+        }
+
+        Sum += Value;
+        SumSquare += Value * Value;
+    }
+
+    const float MeanValue = Sum / float(D);
+    const float Variance = std::max(SumSquare / float(D) - MeanValue * MeanValue, 0.0f);
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+
+    //
+    // Normalize the row and apply the scale and shift.
+    //
+
+    const float* Source = (HasSkip || HasBias) ? Output : Input;
+
+    const __m256 MeanBroadcast = _mm256_set1_ps(MeanValue);
+    const __m256 InvStdDevBroadcast = _mm256_set1_ps(InvStdDevValue);
+
+    d = 0;
+
+    for (; d + 8 <= D; d += 8) {
+
+        __m256 Value = _mm256_loadu_ps(Source + d);
+
+        Value = _mm256_mul_ps(_mm256_sub_ps(Value, MeanBroadcast), InvStdDevBroadcast);
+
+        if (Beta != nullptr) {
+            Value = _mm256_fmadd_ps(Value, _mm256_loadu_ps(Gamma + d), _mm256_loadu_ps(Beta + d));
+        } else {
+            Value = _mm256_mul_ps(Value, _mm256_loadu_ps(Gamma + d));
+        }
+
+        _mm256_storeu_ps(Output + d, Value);
+    }
+
+    for (; d < D; d++) {
+
+        float Value = (Source[d] - MeanValue) * InvStdDevValue * Gamma[d];
+
+        if (Beta != nullptr) {
+            Value += Beta[d];
+        }
+
+        Output[d] = Value;
+    }
+}
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx2(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t D,
+    float Epsilon
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel for the layer normalization of a
+    single row.
+
+Arguments:
+
+    See MlasLayerNormF32Kernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Skip != nullptr) {
+        if (Bias != nullptr) {
+            MlasLayerNormF32KernelAvx2Impl<true, true>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        } else {
+            MlasLayerNormF32KernelAvx2Impl<true, false>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        }
+    } else {
+        if (Bias != nullptr) {
+            MlasLayerNormF32KernelAvx2Impl<false, true>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        } else {
+            MlasLayerNormF32KernelAvx2Impl<false, false>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        }
+    }
+}
@@ -0,0 +1,331 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm_avx512bf16.cpp
+
+Abstract:
+
+    This module implements the kernels for the bfloat16 matrix/matrix multiply
+    operation (BF16GEMM) with AVX512_BF16 instructions.
+
+    Matrix A is converted to pairs of bfloat16 values along the K dimension.
+    Matrix B is packed by MlasGemmBf16PackB to panels of 16 columns, where
+    each 32-bit element holds the bfloat16 values of rows k and k+1 for one
+    column. Products are accumulated in single precision.
+
+--*/
+
+#include "../../mlasi.h"
+
+//
+// Define the number of rows of matrix A processed by an iteration of the
+// kernel. Each row uses two accumulators of 16 columns.
+//
+
+constexpr size_t MLAS_GEMM_BF16_KERNEL_MAXIMUM_ROWS = 6;
+
+MLAS_FORCEINLINE
+uint32_t
+MlasGemmBf16LowBitsMask(
+    size_t Count
+    )
+{
+    return (Count >= 32) ? 0xFFFFFFFF : ((uint32_t(1) << Count) - 1);
+}
+
+void
+MLASCALL
+MlasGemmBf16CopyPackAAvx512Bf16(
+    uint32_t* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the supplied block of matrix A to pairs of bfloat16
+    values. A trailing odd element of each row is paired with zero.
+
+Arguments:
+
+    D - Supplies the address of the destination buffer. Each row of the buffer
+        holds (CountK + 1) / 2 elements.
+
+    A - Supplies the address of the source matrix.
+
+    lda - Supplies the first dimension of matrix A.
+
+    CountM - Supplies the number of rows to convert.
+
+    CountK - Supplies the number of columns to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PairCountK = (CountK + 1) / 2;
+
+    while (CountM-- > 0) {
+
+        const float* a = A;
+        uint16_t* d = reinterpret_cast<uint16_t*>(D);
+        size_t k = CountK;
+
+        while (k >= 32) {
+
+            __m512 Low = _mm512_loadu_ps(a);
+            __m512 High = _mm512_loadu_ps(a + 16);
+
+            _mm512_storeu_si512(d, (__m512i)_mm512_cvtne2ps_pbh(High, Low));
+
+            a += 32;
+            d += 32;
+            k -= 32;
+        }
+
+        if (k > 0) {
+
+            //
+            // Pad the trailing element of an odd count with zero so that the
+            // last pair is fully initialized.
+            //
+
+            const size_t PaddedK = (k + 1) & ~size_t(1);
+
+            const __mmask16 LowMask = __mmask16(MlasGemmBf16LowBitsMask(std::min(k, size_t(16))));
+            const __mmask16 HighMask = __mmask16(MlasGemmBf16LowBitsMask(k > 16 ? k - 16 : 0));
+
+            __m512 Low = _mm512_maskz_loadu_ps(LowMask, a);
+            __m512 High = _mm512_maskz_loadu_ps(HighMask, a + 16);
+
+            _mm512_mask_storeu_epi16(d, __mmask32(MlasGemmBf16LowBitsMask(PaddedK)),
+                (__m512i)_mm512_cvtne2ps_pbh(High, Low));
+        }
+
+        A += lda;
+        D += PairCountK;
+    }
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasGemmBf16ComputeBlock(
+    const uint32_t* A,
+    const uint32_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t ldc,
+    __m512 AlphaBroadcast,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of RowCount rows by up to 32 columns of
+    matrix C.
+
+Arguments:
+
+    A - Supplies the address of the converted matrix A.
+
+    B - Supplies the address of the first packed panel of matrix B. A second
+        panel is read only if CountN is larger than 16.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of bfloat16 values along the K
+        dimension.
+
+    CountN - Supplies the number of columns to compute, up to 32.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    AlphaBroadcast - Supplies the scalar multiplier broadcast to all lanes.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool ComputeHighColumns = (CountN > 16);
+
+    __m512 Accumulators[RowCount][2];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        Accumulators[r][0] = _mm512_setzero_ps();
+        Accumulators[r][1] = _mm512_setzero_ps();
+    }
+
+    const uint32_t* b0 = B;
+    const uint32_t* b1 = B + PairCountK * 16;
+
+    if (ComputeHighColumns) {
+
+        for (size_t k = 0; k < PairCountK; k++) {
+
+            __m512bh BElements0 = (__m512bh)_mm512_loadu_si512(b0);
+            __m512bh BElements1 = (__m512bh)_mm512_loadu_si512(b1);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                __m512bh ABroadcast = (__m512bh)_mm512_set1_epi32(int32_t(A[r * PairCountK + k]));
+                Accumulators[r][0] = _mm512_dpbf16_ps(Accumulators[r][0], ABroadcast, BElements0);
+                Accumulators[r][1] = _mm512_dpbf16_ps(Accumulators[r][1], ABroadcast, BElements1);
+            }
+
+            b0 += 16;
+            b1 += 16;
+        }
+
+    } else {
+
+        for (size_t k = 0; k < PairCountK; k++) {
+
+            __m512bh BElements0 = (__m512bh)_mm512_loadu_si512(b0);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                __m512bh ABroadcast = (__m512bh)_mm512_set1_epi32(int32_t(A[r * PairCountK + k]));
+                Accumulators[r][0] = _mm512_dpbf16_ps(Accumulators[r][0], ABroadcast, BElements0);
+            }
+
+            b0 += 16;
+        }
+    }
+
+    //
+    // Scale the accumulators by alpha and store or accumulate to matrix C.
+    //
+
+    const __mmask16 Mask0 = __mmask16(MlasGemmBf16LowBitsMask(std::min(CountN, size_t(16))));
+    const __mmask16 Mask1 = __mmask16(MlasGemmBf16LowBitsMask(ComputeHighColumns ? CountN - 16 : 0));
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        float* c = C + r * ldc;
+
+        __m512 Result0 = _mm512_mul_ps(Accumulators[r][0], AlphaBroadcast);
+        __m512 Result1 = _mm512_mul_ps(Accumulators[r][1], AlphaBroadcast);
+
+        if (!ZeroMode) {
+            Result0 = _mm512_add_ps(Result0, _mm512_maskz_loadu_ps(Mask0, c));
+            Result1 = _mm512_add_ps(Result1, _mm512_maskz_loadu_ps(Mask1, c + 16));
+        }
+
+        _mm512_mask_storeu_ps(c, Mask0, Result0);
+        _mm512_mask_storeu_ps(c + 16, Mask1, Result1);
+    }
+}
+
+template<size_t RowCount>
+void
+MlasGemmBf16ComputeRows(
+    const uint32_t* A,
+    const uint32_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    )
+{
+    const __m512 AlphaBroadcast = _mm512_set1_ps(alpha);
+
+    for (size_t n = 0; n < CountN; n += 32) {
+
+        MlasGemmBf16ComputeBlock<RowCount>(A, B, C + n, PairCountK,
+            std::min(CountN - n, size_t(32)), ldc, AlphaBroadcast, ZeroMode);
+
+        B += PairCountK * 32;
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmBf16KernelAvx512Bf16(
+    const uint32_t* A,
+    const uint32_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A converted by
+        MlasGemmBf16CopyPackAAvx512Bf16.
+
+    B - Supplies the address of matrix B packed by MlasGemmBf16PackB.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of bfloat16 values along the K
+        dimension.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see GEMM definition).
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    switch (std::min(CountM, MLAS_GEMM_BF16_KERNEL_MAXIMUM_ROWS)) {
+        case 1:
+            MlasGemmBf16ComputeRows<1>(A, B, C, PairCountK, CountN, ldc, alpha, ZeroMode);
+            return 1;
+        case 2:
+            MlasGemmBf16ComputeRows<2>(A, B, C, PairCountK, CountN, ldc, alpha, ZeroMode);
+            return 2;
+        case 3:
+            MlasGemmBf16ComputeRows<3>(A, B, C, PairCountK, CountN, ldc, alpha, ZeroMode);
+            return 3;
+        case 4:
+            MlasGemmBf16ComputeRows<4>(A, B, C, PairCountK, CountN, ldc, alpha, ZeroMode);
+            return 4;
+        case 5:
+            MlasGemmBf16ComputeRows<5>(A, B, C, PairCountK, CountN, ldc, alpha, ZeroMode);
+            return 5;
+        default:
+            MlasGemmBf16ComputeRows<6>(A, B, C, PairCountK, CountN, ldc, alpha, ZeroMode);
+            return 6;
+    }
+}
@@ -0,0 +1,216 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernel for the layer normalization of a row
+    with AVX512F instructions.
+
+--*/
+
+#include "../../mlasi.h"
+
+//
+// N.B. The sum is reduced by hand: with GCC 12, _mm512_reduce_add_ps,
+// _mm512_castps512_ps256 and _mm512_extractf64x4_pd pass an undefined vector
+// to the builtin and trigger -Wmaybe-uninitialized. The halves are extracted
+// with an all ones zeroing mask instead, which compiles to the same
+// instruction, and as doubles because _mm512_extractf32x8_ps requires
+// AVX512DQ.
+//
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddFloat32x16(
+    __m512 Vector
+    )
+{
+    const __m512d VectorPd = _mm512_castps_pd(Vector);
+    __m256 Sum256 = _mm256_add_ps(_mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, VectorPd, 0)),
+        _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, VectorPd, 1)));
+    __m128 Sum = _mm_add_ps(_mm256_castps256_ps128(Sum256), _mm256_extractf128_ps(Sum256, 1));
+    Sum = _mm_add_ps(Sum, _mm_movehl_ps(Sum, Sum));
+    Sum = _mm_add_ss(Sum, _mm_shuffle_ps(Sum, Sum, 1));
+    return _mm_cvtss_f32(Sum);
+}
+
+template<bool HasSkip, bool HasBias>
+MLAS_FORCEINLINE
+__m512
+MlasLayerNormLoadValueAvx512F(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Output,
+    __mmask16 Mask
+    )
+{
+    __m512 Value = _mm512_maskz_loadu_ps(Mask, Input);
+
+    if (HasSkip) {
+        Value = _mm512_add_ps(Value, _mm512_maskz_loadu_ps(Mask, Skip));
+    }
+
+    if (HasBias) {
+        Value = _mm512_add_ps(Value, _mm512_maskz_loadu_ps(Mask, Bias));
+    }
+
+    if (HasSkip || HasBias) {
+        _mm512_mask_storeu_ps(Output, Mask, Value);
+    }
+
+    return Value;
+}
+
+template<bool HasSkip, bool HasBias>
+MLAS_FORCEINLINE
+void
+MlasLayerNormF32KernelAvx512FImpl(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t D,
+    float Epsilon
+    )
+{
+    //
+    // Accumulate the sum and the sum of squares of the row using two sets of
+    // accumulators to hide the latency of the additions. The remaining
+    // elements of the row are processed with a masked load.
+    //
+
+    __m512 SumVector0 = _mm512_setzero_ps();
+    __m512 SumVector1 = _mm512_setzero_ps();
+    __m512 SumSquareVector0 = _mm512_setzero_ps();
+    __m512 SumSquareVector1 = _mm512_setzero_ps();
+
+    size_t d = 0;
+
+    for (; d + 32 <= D; d += 32) {
+
+        __m512 Value0 = MlasLayerNormLoadValueAvx512F<HasSkip, HasBias>(
+            Input + d, Skip + d, Bias + d, Output + d, 0xFFFF);
+        __m512 Value1 = MlasLayerNormLoadValueAvx512F<HasSkip, HasBias>(
+            Input + d + 16, Skip + d + 16, Bias + d + 16, Output + d + 16, 0xFFFF);
+
+        SumVector0 = _mm512_add_ps(SumVector0, Value0);
+        SumVector1 = _mm512_add_ps(SumVector1, Value1);
+        SumSquareVector0 = _mm512_fmadd_ps(Value0, Value0, SumSquareVector0);
+        SumSquareVector1 = _mm512_fmadd_ps(Value1, Value1, SumSquareVector1);
+    }
+
+    while (d < D) {
+
+        const size_t Remaining = D - d;
+        const __mmask16 Mask = (Remaining >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << Remaining) - 1);
+
+        __m512 Value0 = MlasLayerNormLoadValueAvx512F<HasSkip, HasBias>(
+            Input + d, Skip + d, Bias + d, Output + d, Mask);
+
+        SumVector0 = _mm512_add_ps(SumVector0, Value0);
+        SumSquareVector0 = _mm512_fmadd_ps(Value0, Value0, SumSquareVector0);
+
+        d += (Remaining >= 16) ? 16 : Remaining;
+    }
+
+    const float Sum = MlasReduceAddFloat32x16(_mm512_add_ps(SumVector0, SumVector1));
+    const float SumSquare = MlasReduceAddFloat32x16(_mm512_add_ps(SumSquareVector0, SumSquareVector1));
+
+    const float MeanValue = Sum / float(D);
+    const float Variance = std::max(SumSquare / float(D) - MeanValue * MeanValue, 0.0f);
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+
+    //
+    // Normalize the row and apply the scale and shift.
+    //
+
+    const float* Source = (HasSkip || HasBias) ? Output : Input;
+
+    const __m512 MeanBroadcast = _mm512_set1_ps(MeanValue);
+    const __m512 InvStdDevBroadcast = _mm512_set1_ps(InvStdDevValue);
+
+    for (d = 0; d < D; d += 16) {
+
+        const size_t Remaining = D - d;
+        const __mmask16 Mask = (Remaining >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << Remaining) - 1);
+
+        __m512 Value = _mm512_maskz_loadu_ps(Mask, Source + d);
+
+        Value = _mm512_mul_ps(_mm512_sub_ps(Value, MeanBroadcast), InvStdDevBroadcast);
+
+        if (Beta != nullptr) {
+            Value = _mm512_fmadd_ps(Value, _mm512_maskz_loadu_ps(Mask, Gamma + d),
+                _mm512_maskz_loadu_ps(Mask, Beta + d));
+        } else {
+            Value = _mm512_mul_ps(Value, _mm512_maskz_loadu_ps(Mask, Gamma + d));
+        }
+
+        _mm512_mask_storeu_ps(Output + d, Mask, Value);
+    }
+}
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx512F(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t D,
+    float Epsilon
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel for the layer normalization of
+    a single row.
+
+Arguments:
+
+    See MlasLayerNormF32Kernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Skip != nullptr) {
+        if (Bias != nullptr) {
+            MlasLayerNormF32KernelAvx512FImpl<true, true>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        } else {
+            MlasLayerNormF32KernelAvx512FImpl<true, false>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        }
+    } else {
+        if (Bias != nullptr) {
+            MlasLayerNormF32KernelAvx512FImpl<false, true>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        } else {
+            MlasLayerNormF32KernelAvx512FImpl<false, false>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        }
+    }
+}
@@ -0,0 +1,299 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_udot.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) with the ARMv8.2 dot product instructions.
+
+    The kernel consumes the same packed buffers as the NEON kernel: matrix A is
+    packed as rows of PackedCountK groups of 4 bytes and matrix B is packed as
+    panels of 16 columns, where each 64-byte row holds 4 consecutive values
+    along the K dimension for every column. Each 32-bit lane of a vector of
+    matrix B is therefore a complete operand of the UDOT instruction.
+
+--*/
+
+#include "../../mlasi.h"
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8ComputeBlockUdot(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of RowCount rows by up to 16 columns of
+    matrix C.
+
+Arguments:
+
+    A - Supplies the address of the packed matrix A.
+
+    B - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    PackedCountK - Supplies the number of packed groups along the K dimension.
+
+    CountN - Supplies the number of columns to compute, up to 16.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumBuffer - Supplies the row sums of matrix A.
+
+    ColumnSumBuffer - Supplies the column sums of matrix B.
+
+    DepthValue - Supplies the depth value accumulated into every element.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    uint32x4_t Accumulators[RowCount][4];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t i = 0; i < 4; i++) {
+            Accumulators[r][i] = vmovq_n_u32(0);
+        }
+    }
+
+    const size_t lda = PackedCountK * 4;
+    size_t k = 0;
+
+    //
+    // Process 4 groups along the K dimension per iteration: a single load of
+    // each row of matrix A supplies the operands for 4 rows of the panel.
+    //
+
+    for (; k + 4 <= PackedCountK; k += 4) {
+
+        uint8x16_t AElements[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            AElements[r] = vld1q_u8(&A[r * lda + k * 4]);
+        }
+
+#define MLAS_GEMM_U8X8_UDOT_GROUP(Lane) \
+        { \
+            const uint8x16_t BElements0 = vld1q_u8(&B[0]); \
+            const uint8x16_t BElements1 = vld1q_u8(&B[16]); \
+            const uint8x16_t BElements2 = vld1q_u8(&B[32]); \
+            const uint8x16_t BElements3 = vld1q_u8(&B[48]); \
+            for (size_t r = 0; r < RowCount; r++) { \
+                Accumulators[r][0] = vdotq_laneq_u32(Accumulators[r][0], BElements0, AElements[r], Lane); \
+                Accumulators[r][1] = vdotq_laneq_u32(Accumulators[r][1], BElements1, AElements[r], Lane); \
+                Accumulators[r][2] = vdotq_laneq_u32(Accumulators[r][2], BElements2, AElements[r], Lane); \
+                Accumulators[r][3] = vdotq_laneq_u32(Accumulators[r][3], BElements3, AElements[r], Lane); \
+            } \
+            B += 64; \
+        }
+
+        MLAS_GEMM_U8X8_UDOT_GROUP(0);
+        MLAS_GEMM_U8X8_UDOT_GROUP(1);
+        MLAS_GEMM_U8X8_UDOT_GROUP(2);
+        MLAS_GEMM_U8X8_UDOT_GROUP(3);
+
+#undef MLAS_GEMM_U8X8_UDOT_GROUP
+    }
+
+    //
+    // Process the remaining groups along the K dimension.
+    //
+
+    for (; k < PackedCountK; k++) {
+
+        const uint8x16_t BElements0 = vld1q_u8(&B[0]);
+        const uint8x16_t BElements1 = vld1q_u8(&B[16]);
+        const uint8x16_t BElements2 = vld1q_u8(&B[32]);
+        const uint8x16_t BElements3 = vld1q_u8(&B[48]);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            const uint8x16_t ABroadcast = vreinterpretq_u8_u32(
+                vld1q_dup_u32(reinterpret_cast<const uint32_t*>(&A[r * lda + k * 4])));
+
+            Accumulators[r][0] = vdotq_u32(Accumulators[r][0], BElements0, ABroadcast);
+            Accumulators[r][1] = vdotq_u32(Accumulators[r][1], BElements1, ABroadcast);
+            Accumulators[r][2] = vdotq_u32(Accumulators[r][2], BElements2, ABroadcast);
+            Accumulators[r][3] = vdotq_u32(Accumulators[r][3], BElements3, ABroadcast);
+        }
+
+        B += 64;
+    }
+
+    //
+    // Apply the zero point adjustments and store or accumulate to matrix C.
+    //
+
+    int32x4_t ColumnSums[4];
+
+    ColumnSums[0] = vld1q_s32(&ColumnSumBuffer[0]);
+    ColumnSums[1] = vld1q_s32(&ColumnSumBuffer[4]);
+    ColumnSums[2] = vld1q_s32(&ColumnSumBuffer[8]);
+    ColumnSums[3] = vld1q_s32(&ColumnSumBuffer[12]);
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        const int32x4_t RowSumVector = vmovq_n_s32(RowSumBuffer[r] + DepthValue);
+
+        int32x4_t Results[4];
+
+        for (size_t i = 0; i < 4; i++) {
+            Results[i] = vaddq_s32(vreinterpretq_s32_u32(Accumulators[r][i]),
+                vaddq_s32(RowSumVector, ColumnSums[i]));
+        }
+
+        int32_t* c = C + r * ldc;
+
+        if (CountN == 16) {
+
+            for (size_t i = 0; i < 4; i++) {
+
+                if (!ZeroMode) {
+                    Results[i] = vaddq_s32(Results[i], vld1q_s32(&c[i * 4]));
+                }
+
+                vst1q_s32(&c[i * 4], Results[i]);
+            }
+
+        } else {
+
+            MLAS_DECLSPEC_ALIGN(int32_t Output[16], 16);
+
+            for (size_t i = 0; i < 4; i++) {
+                vst1q_s32(&Output[i * 4], Results[i]);
+            }
+
+            if (ZeroMode) {
+                for (size_t n = 0; n < CountN; n++) {
+                    c[n] = Output[n];
+                }
+            } else {
+                for (size_t n = 0; n < CountN; n++) {
+                    c[n] += Output[n];
+                }
+            }
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmU8X8KernelUdot(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been packed
+        using MlasGemmU8X8CopyPackANeon.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasGemmU8X8CopyPackBNeon.
+
+    C - Supplies the address of matrix C.
+
+    PackedCountK - Supplies the number of packed columns from matrix A and
+        the number of packed rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumBuffer - Supplies the sum of each row from matrix A multiplied by the
+        zero point offset of matrix B. These values are accumulated into every
+        row of matrix C.
+
+    ColumnSumBuffer - Supplies the sum of each column from matrix B multiplied
+        by the zero point offset of matrix A. These values are accumulated into
+        every column of matrix C.
+
+    DepthValue - Supplies the value CountK multiplied by the zero point offset
+        of matrix A multplied by the zero point offset of matrix B. This value is
+        accumulated into every element of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    size_t RowsHandled;
+
+    if (CountM >= 4) {
+        RowsHandled = 4;
+    } else if (CountM >= 2) {
+        RowsHandled = 2;
+    } else {
+        RowsHandled = 1;
+    }
+
+    for (size_t n = 0; n < CountN; n += 16) {
+
+        const size_t CountBlockN = std::min(CountN - n, size_t(16));
+
+        if (RowsHandled == 4) {
+            MlasGemmU8X8ComputeBlockUdot<4>(A, B, C + n, PackedCountK, CountBlockN,
+                ldc, RowSumBuffer, ColumnSumBuffer + n, DepthValue, ZeroMode);
+        } else if (RowsHandled == 2) {
+            MlasGemmU8X8ComputeBlockUdot<2>(A, B, C + n, PackedCountK, CountBlockN,
+                ldc, RowSumBuffer, ColumnSumBuffer + n, DepthValue, ZeroMode);
+        } else {
+            MlasGemmU8X8ComputeBlockUdot<1>(A, B, C + n, PackedCountK, CountBlockN,
+                ldc, RowSumBuffer, ColumnSumBuffer + n, DepthValue, ZeroMode);
+        }
+
+        B += PackedCountK * 64;
+    }
+
+    return RowsHandled;
+}
@@ -0,0 +1,169 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_neon_fp16.cpp
+
+Abstract:
+
+    This module implements the kernel for the half-precision matrix/matrix
+    multiply operation (HALFGEMM) with the ARMv8.2 half-precision vector
+    arithmetic instructions.
+
+    The kernel reads matrix A and matrix B in place. Each block of 16 columns
+    of matrix C is accumulated in half precision for up to 4 rows of matrix A.
+
+--*/
+
+#include "../../mlasi.h"
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmComputeBlockNeonFp16(
+    const __fp16* A,
+    const __fp16* B,
+    __fp16* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldb,
+    size_t ldc
+    )
+{
+    while (CountN > 0) {
+
+        float16x8_t Accumulators[RowCount][2];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r][0] = vdupq_n_f16(0);
+            Accumulators[r][1] = vdupq_n_f16(0);
+        }
+
+        //
+        // Load the partial block of columns through a zero padded buffer.
+        //
+
+        const size_t CountBlockN = (CountN < 16) ? CountN : 16;
+
+        MLAS_DECLSPEC_ALIGN(__fp16 PaddedB[16], 16);
+
+        for (size_t k = 0; k < CountK; k++) {
+
+            const __fp16* b = B + k * ldb;
+
+            if (CountBlockN < 16) {
+                for (size_t n = 0; n < 16; n++) {
+                    PaddedB[n] = (n < CountBlockN) ? b[n] : __fp16(0);
+                }
+                b = PaddedB;
+            }
+
+            float16x8_t BElements0 = vld1q_f16(b);
+            float16x8_t BElements1 = vld1q_f16(b + 8);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                float16x8_t ABroadcast = vdupq_n_f16(A[r * lda + k]);
+                Accumulators[r][0] = vfmaq_f16(Accumulators[r][0], BElements0, ABroadcast);
+                Accumulators[r][1] = vfmaq_f16(Accumulators[r][1], BElements1, ABroadcast);
+            }
+        }
+
+        //
+        // Store the block of matrix C.
+        //
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            __fp16* c = C + r * ldc;
+
+            if (CountBlockN == 16) {
+                vst1q_f16(c, Accumulators[r][0]);
+                vst1q_f16(c + 8, Accumulators[r][1]);
+            } else {
+                MLAS_DECLSPEC_ALIGN(__fp16 PaddedC[16], 16);
+                vst1q_f16(PaddedC, Accumulators[r][0]);
+                vst1q_f16(PaddedC + 8, Accumulators[r][1]);
+                for (size_t n = 0; n < CountBlockN; n++) {
+                    c[n] = PaddedC[n];
+                }
+            }
+        }
+
+        B += CountBlockN;
+        C += CountBlockN;
+        CountN -= CountBlockN;
+    }
+}
+
+size_t
+MLASCALL
+MlasHalfGemmKernelNeonFp16(
+    const unsigned short* A,
+    const unsigned short* B,
+    unsigned short* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldb,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns of matrix A and the number of rows
+        of matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns of matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    const __fp16* a = reinterpret_cast<const __fp16*>(A);
+    const __fp16* b = reinterpret_cast<const __fp16*>(B);
+    __fp16* c = reinterpret_cast<__fp16*>(C);
+
+    if (CountM >= 4) {
+        MlasHalfGemmComputeBlockNeonFp16<4>(a, b, c, CountK, CountN, lda, ldb, ldc);
+        return 4;
+    }
+
+    if (CountM >= 2) {
+        MlasHalfGemmComputeBlockNeonFp16<2>(a, b, c, CountK, CountN, lda, ldb, ldc);
+        return 2;
+    }
+
+    MlasHalfGemmComputeBlockNeonFp16<1>(a, b, c, CountK, CountN, lda, ldb, ldc);
+    return 1;
+}
@@ -0,0 +1,481 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute the layer normalization of a
+    set of rows, optionally after adding a residual input and a bias to the
+    rows (as done by SkipLayerNormalization), and the instance normalization
+    and per row scale and shift of a set of rows (as done by
+    InstanceNormalization and BatchNormalization).
+
+    The implementation below targets the base instruction set (typically SSE2
+    or NEON) while the AVX2 and AVX512F implementations are selected at
+    runtime on processors supporting these instruction sets.
+
+--*/
+
+#include "mlasi.h"
+
+template<bool HasSkip, bool HasBias>
+MLAS_FORCEINLINE
+void
+MlasLayerNormF32KernelImpl(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t D,
+    float Epsilon
+    )
+{
+    //
+    // Accumulate the sum and the sum of squares of the row. If the row needs
+    // the residual and bias inputs added, the sums are stored to the output
+    // buffer for the normalization pass.
+    //
+
+    MLAS_FLOAT32X4 SumVector = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquareVector = MlasZeroFloat32x4();
+
+    size_t d = 0;
+
+    for (; d + 4 <= D; d += 4) {
+
+        MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(Input + d);
+
+        if (HasSkip) {
+            Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Skip + d));
+        }
+
+        if (HasBias) {
+            Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Bias + d));
+        }
+
+        if (HasSkip || HasBias) {
+            MlasStoreFloat32x4(Output + d, Value);
+        }
+
+        SumVector = MlasAddFloat32x4(SumVector, Value);
+        SumSquareVector = MlasMultiplyAddFloat32x4(Value, Value, SumSquareVector);
+    }
+
+    float Sum = MlasReduceAddFloat32x4(SumVector);
+    float SumSquare = MlasReduceAddFloat32x4(SumSquareVector);
+
+    for (; d < D; d++) {
+
+        float Value = Input[d];
+
+        if (HasSkip) {
+            Value += Skip[d];
+        }
+
+        if (HasBias) {
+            Value += Bias[d];
+        }
+
+        if (HasSkip || HasBias) {
+            Output[d] = Value;
+        }
+
+        Sum += Value;
+        SumSquare += Value * Value;
+    }
+
+    const float MeanValue = Sum / float(D);
+    const float Variance = std::max(SumSquare / float(D) - MeanValue * MeanValue, 0.0f);
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+
+    //
+    // Normalize the row and apply the scale and shift.
+    //
+
+    const float* Source = (HasSkip || HasBias) ? Output : Input;
+
+    const MLAS_FLOAT32X4 MeanBroadcast = MlasBroadcastFloat32x4(MeanValue);
+    const MLAS_FLOAT32X4 InvStdDevBroadcast = MlasBroadcastFloat32x4(InvStdDevValue);
+
+    d = 0;
+
+    for (; d + 4 <= D; d += 4) {
+
+        MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(Source + d);
+
+        Value = MlasMultiplyFloat32x4(MlasSubtractFloat32x4(Value, MeanBroadcast), InvStdDevBroadcast);
+        Value = MlasMultiplyFloat32x4(Value, MlasLoadFloat32x4(Gamma + d));
+
+        if (Beta != nullptr) {
+            Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Beta + d));
+        }
+
+        MlasStoreFloat32x4(Output + d, Value);
+    }
+
+    for (; d < D; d++) {
+
+        float Value = (Source[d] - MeanValue) * InvStdDevValue * Gamma[d];
+
+        if (Beta != nullptr) {
+            Value += Beta[d];
+        }
+
+        Output[d] = Value;
+    }
+}
+
+void
+MLASCALL
+MlasLayerNormF32Kernel(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t D,
+    float Epsilon
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the layer normalization of
+    a single row.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Skip - Optionally supplies the residual row added to the input row.
+
+    Bias - Optionally supplies the bias added to the input row.
+
+    Gamma - Supplies the scale applied to the normalized row.
+
+    Beta - Optionally supplies the shift applied to the normalized row.
+
+    Output - Supplies the output row. The output row may alias the input row.
+
+    Mean - Optionally receives the mean of the row.
+
+    InvStdDev - Optionally receives the inverse standard deviation of the row.
+
+    D - Supplies the number of elements of the row.
+
+    Epsilon - Supplies the value added to the variance for numerical
+        stability.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Skip != nullptr) {
+        if (Bias != nullptr) {
+            MlasLayerNormF32KernelImpl<true, true>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        } else {
+            MlasLayerNormF32KernelImpl<true, false>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        }
+    } else {
+        if (Bias != nullptr) {
+            MlasLayerNormF32KernelImpl<false, true>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        } else {
+            MlasLayerNormF32KernelImpl<false, false>(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, D, Epsilon);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasComputeLayerNorm(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of a set of rows:
+
+        Value = Input + Skip + Bias
+        Output = (Value - Mean(Value)) * InvStdDev(Value) * Gamma + Beta
+
+    where InvStdDev(Value) is 1 / sqrt(Variance(Value) + Epsilon).
+
+Arguments:
+
+    Input - Supplies the input buffer of N rows by D columns.
+
+    Skip - Optionally supplies the residual buffer of N rows by D columns
+        added to the input buffer.
+
+    Bias - Optionally supplies the bias of D elements added to each row.
+
+    Gamma - Supplies the scale of D elements applied to each row.
+
+    Beta - Optionally supplies the shift of D elements applied to each row.
+
+    Output - Supplies the output buffer of N rows by D columns. The output
+        buffer may alias the input buffer.
+
+    Mean - Optionally receives the N means of the rows.
+
+    InvStdDev - Optionally receives the N inverse standard deviations of the
+        rows.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns of each row.
+
+    Epsilon - Supplies the value added to the variance for numerical
+        stability.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_LAYER_NORM_FLOAT_KERNEL LayerNormF32Kernel = MlasPlatform.LayerNormF32Kernel;
+#else
+    PMLAS_LAYER_NORM_FLOAT_KERNEL LayerNormF32Kernel = MlasLayerNormF32Kernel;
+#endif
+
+    for (size_t n = 0; n < N; n++) {
+
+        LayerNormF32Kernel(Input, Skip, Bias, Gamma, Beta, Output,
+            (Mean != nullptr) ? Mean + n : nullptr,
+            (InvStdDev != nullptr) ? InvStdDev + n : nullptr, D, Epsilon);
+
+        Input += D;
+        Output += D;
+
+        if (Skip != nullptr) {
+            Skip += D;
+        }
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasScaleShiftRow(
+    const float* Input,
+    float* Output,
+    size_t D,
+    float Offset,
+    float Scale,
+    float Shift
+    )
+{
+    //
+    // Output = (Input - Offset) * Scale + Shift. Subtracting the offset first
+    // avoids the cancellation of folding it into the shift when the scale is
+    // large (a nearly constant row).
+    //
+
+    const MLAS_FLOAT32X4 OffsetBroadcast = MlasBroadcastFloat32x4(Offset);
+    const MLAS_FLOAT32X4 ScaleBroadcast = MlasBroadcastFloat32x4(Scale);
+    const MLAS_FLOAT32X4 ShiftBroadcast = MlasBroadcastFloat32x4(Shift);
+
+    size_t d = 0;
+
+    for (; d + 8 <= D; d += 8) {
+
+        MLAS_FLOAT32X4 Value0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + d), OffsetBroadcast);
+        MLAS_FLOAT32X4 Value1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + d + 4), OffsetBroadcast);
+
+        MlasStoreFloat32x4(Output + d, MlasMultiplyAddFloat32x4(Value0, ScaleBroadcast, ShiftBroadcast));
+        MlasStoreFloat32x4(Output + d + 4, MlasMultiplyAddFloat32x4(Value1, ScaleBroadcast, ShiftBroadcast));
+    }
+
+    for (; d + 4 <= D; d += 4) {
+
+        MLAS_FLOAT32X4 Value = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + d), OffsetBroadcast);
+
+        MlasStoreFloat32x4(Output + d, MlasMultiplyAddFloat32x4(Value, ScaleBroadcast, ShiftBroadcast));
+    }
+
+    for (; d < D; d++) {
+        Output[d] = (Input[d] - Offset) * Scale + Shift;
+    }
+}
+
+void
+MLASCALL
+MlasComputeInstanceNorm(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    size_t D,
+    float Epsilon
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the instance normalization of a set of rows, where
+    each row is normalized with its own statistics and scale and bias:
+
+        Output = (Input - Mean(Input)) * InvStdDev(Input) * Scale + Bias
+
+    where InvStdDev(Input) is 1 / sqrt(Variance(Input) + Epsilon).
+
+    The statistics are computed in a single pass over the row. The sums are
+    accumulated relative to the first element of the row, which keeps the
+    variance accurate for rows with a large mean compared to their spread.
+
+Arguments:
+
+    Input - Supplies the input buffer of N rows by D columns.
+
+    Scale - Supplies the N scales, one for each row.
+
+    Bias - Supplies the N biases, one for each row.
+
+    Output - Supplies the output buffer of N rows by D columns. The output
+        buffer may alias the input buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns of each row.
+
+    Epsilon - Supplies the value added to the variance for numerical
+        stability.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (D == 0) {
+        return;
+    }
+
+    for (size_t n = 0; n < N; n++) {
+
+        const float Origin = Input[0];
+        const MLAS_FLOAT32X4 OriginBroadcast = MlasBroadcastFloat32x4(Origin);
+
+        MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 SumVector1 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 SumSquareVector0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 SumSquareVector1 = MlasZeroFloat32x4();
+
+        size_t d = 0;
+
+        for (; d + 8 <= D; d += 8) {
+
+            MLAS_FLOAT32X4 Value0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + d), OriginBroadcast);
+            MLAS_FLOAT32X4 Value1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + d + 4), OriginBroadcast);
+
+            SumVector0 = MlasAddFloat32x4(SumVector0, Value0);
+            SumVector1 = MlasAddFloat32x4(SumVector1, Value1);
+            SumSquareVector0 = MlasMultiplyAddFloat32x4(Value0, Value0, SumSquareVector0);
+            SumSquareVector1 = MlasMultiplyAddFloat32x4(Value1, Value1, SumSquareVector1);
+        }
+
+        float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+        float SumSquare = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumSquareVector0, SumSquareVector1));
+
+        for (; d < D; d++) {
+            float Value = Input[d] - Origin;
+            Sum += Value;
+            SumSquare += Value * Value;
+        }
+
+        const float ShiftedMean = Sum / float(D);
+        const float Variance = std::max(SumSquare / float(D) - ShiftedMean * ShiftedMean, 0.0f);
+        const float MeanValue = ShiftedMean + Origin;
+
+        const float RowScale = Scale[n] / std::sqrt(Variance + Epsilon);
+
+        MlasScaleShiftRow(Input, Output, D, MeanValue, RowScale, Bias[n]);
+
+        Input += D;
+        Output += D;
+    }
+}
+
+void
+MLASCALL
+MlasComputeScaleShift(
+    const float* Input,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t N,
+    size_t D
+    )
+/*++
+
+Routine Description:
+
+    This routine applies a scale and a shift to each row of a set of rows:
+
+        Output = Input * Scale + Shift
+
+Arguments:
+
+    Input - Supplies the input buffer of N rows by D columns.
+
+    Scale - Supplies the N scales, one for each row.
+
+    Shift - Supplies the N shifts, one for each row.
+
+    Output - Supplies the output buffer of N rows by D columns. The output
+        buffer may alias the input buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns of each row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < N; n++) {
+
+        MlasScaleShiftRow(Input, Output, D, 0.0f, Scale[n], Shift[n]);
+
+        Input += D;
+        Output += D;
+    }
+}
@@ -139,6 +139,8 @@ Abstract:
 
 #define MLAS_SGEMM_STRIDEN                          128
 #define MLAS_SGEMM_STRIDEK                          128
+#define MLAS_SGEMM_PACKED_STRIDEN                   128
+#define MLAS_SGEMM_PACKED_STRIDEK                   256
 #define MLAS_DGEMM_STRIDEN                          64
 #define MLAS_DGEMM_STRIDEK                          128
 
@@ -154,6 +156,8 @@ Abstract:
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
 #define MLAS_DGEMM_STRIDEN_THREAD_ALIGN             8
 #define MLAS_QGEMM_STRIDEN_THREAD_ALIGN             16
+#define MLAS_BF16GEMM_STRIDEN_THREAD_ALIGN          16
+#define MLAS_HALFGEMM_STRIDEN_THREAD_ALIGN          16
 
 //
 // Define the prototypes of the platform optimized routines.
@@ -322,6 +326,52 @@ size_t
 
 typedef MLAS_GEMM_U8U8_KERNEL* PMLAS_GEMM_U8U8_KERNEL;
 
+typedef
+size_t
+(MLASCALL MLAS_GEMM_U8X8_KERNEL)(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    );
+
+typedef MLAS_GEMM_U8X8_KERNEL* PMLAS_GEMM_U8X8_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_GEMM_BF16_COPY_PACKA_ROUTINE)(
+    uint32_t* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+    );
+
+typedef MLAS_GEMM_BF16_COPY_PACKA_ROUTINE* PMLAS_GEMM_BF16_COPY_PACKA_ROUTINE;
+
+typedef
+size_t
+(MLASCALL MLAS_GEMM_BF16_KERNEL)(
+    const uint32_t* A,
+    const uint32_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    );
+
+typedef MLAS_GEMM_BF16_KERNEL* PMLAS_GEMM_BF16_KERNEL;
+
 typedef
 void
 (MLASCALL MLAS_CONV_FLOAT_KERNEL)(
@@ -473,6 +523,59 @@ void
 
 typedef MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL* PMLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL;
 
+typedef
+void
+(MLASCALL MLAS_LAYER_NORM_FLOAT_KERNEL)(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t D,
+    float Epsilon
+    );
+
+typedef MLAS_LAYER_NORM_FLOAT_KERNEL* PMLAS_LAYER_NORM_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_HALF_TO_FLOAT_KERNEL)(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_HALF_TO_FLOAT_KERNEL* PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_FLOAT_TO_HALF_KERNEL)(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_FLOAT_TO_HALF_KERNEL* PMLAS_CONVERT_FLOAT_TO_HALF_KERNEL;
+
+typedef
+size_t
+(MLASCALL MLAS_HALF_GEMM_KERNEL)(
+    const unsigned short* A,
+    const unsigned short* B,
+    unsigned short* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldb,
+    size_t ldc
+    );
+
+typedef MLAS_HALF_GEMM_KERNEL* PMLAS_HALF_GEMM_KERNEL;
+
 typedef
 void
 (MLASCALL MLAS_QLINEAR_BINARY_OP_S8_KERNEL)(
@@ -552,6 +655,18 @@ extern "C" {
     MLAS_GEMV_U8S8_KERNEL MlasGemvU8S8KernelAvx512Vnni;
     MLAS_GEMM_U8U8_KERNEL MlasGemmU8U8KernelAvx2;
     MLAS_GEMM_U8U8_KERNEL MlasGemmU8U8KernelAvx512Core;
+    MLAS_GEMM_BF16_COPY_PACKA_ROUTINE MlasGemmBf16CopyPackAAvx512Bf16;
+    MLAS_GEMM_BF16_KERNEL MlasGemmBf16KernelAvx512Bf16;
+    MLAS_GEMM_U8S8_KERNEL MlasGemmU8S8KernelAmx;
+    MLAS_GEMM_BF16_KERNEL MlasGemmBf16KernelAmx;
+#endif
+
+#if defined(MLAS_TARGET_ARM64) && !defined(MLAS_UDOT_UNSUPPORTED)
+    MLAS_GEMM_U8X8_KERNEL MlasGemmU8X8KernelUdot;
+#endif
+
+#if defined(MLAS_TARGET_ARM64) && !defined(MLAS_FP16_UNSUPPORTED)
+    MLAS_HALF_GEMM_KERNEL MlasHalfGemmKernelNeonFp16;
 #endif
 
 #if defined(MLAS_TARGET_AMD64)
@@ -620,6 +735,22 @@ extern "C" {
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx;
 #endif
 
+    MLAS_LAYER_NORM_FLOAT_KERNEL MlasLayerNormF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_LAYER_NORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx2;
+    MLAS_LAYER_NORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx512F;
+#endif
+
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernel;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernel;
+#if defined(MLAS_TARGET_AMD64)
+#if defined(_WIN32)
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernelSse;
+#endif
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernelF16C;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernelF16C;
+#endif
+
 }
 
 //
@@ -647,6 +778,8 @@ extern "C" {
 #define MLAS_SGEMM_THREAD_COMPLEXITY                (64 * 1024)
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (64 * 1024)
 #define MLAS_QGEMM_THREAD_COMPLEXITY                (64 * 1024)
+#define MLAS_BF16GEMM_THREAD_COMPLEXITY             (64 * 1024)
+#define MLAS_HALFGEMM_THREAD_COMPLEXITY             (64 * 1024)
 
 //
 // Single-threaded single precision matrix/matrix multiply operation.
@@ -676,6 +809,9 @@ MlasSgemmOperation(
 struct MLAS_GEMM_U8X8_KERNEL_SSE;
 struct MLAS_GEMM_U8S8_KERNEL_AVX2;
 struct MLAS_GEMM_U8U8_KERNEL_AVX2;
+struct MLAS_GEMM_U8S8_KERNEL_AMX;
+struct MLAS_GEMM_U8X8_KERNEL_NEON;
+struct MLAS_GEMM_U8X8_KERNEL_UDOT;
 
 template<typename KernelType>
 void
@@ -691,6 +827,83 @@ MlasGemmU8X8PackedOperation(
     const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
     );
 
+#if defined(MLAS_TARGET_AMD64_IX86)
+
+//
+// Levels of the instruction set extensions the kernels may use, in increasing
+// order. MlasIsaAll also allows the AVX512_BF16 and AMX kernels.
+//
+
+enum MLAS_ISA_LEVEL {
+    MlasIsaSse2,
+    MlasIsaAvx,
+    MlasIsaAvx2,
+    MlasIsaAvx512F,
+    MlasIsaAvx512Core,
+    MlasIsaAvx512Vnni,
+    MlasIsaAll,
+};
+
+//
+// Families of kernels whose instruction set level is selected separately.
+//
+
+enum MLAS_KERNEL_FAMILY {
+    MlasSgemmFamily,        // float and double GEMM, BF16 GEMM
+    MlasQgemmFamily,        // quantized GEMM
+    MlasConvFamily,         // convolution, pooling and the NCHWc block size
+    MlasElementwiseFamily,  // activations, softmax, reductions, conversions
+    MlasKernelFamilyCount
+};
+
+//
+// Stores the processor features that the kernel selection depends on.
+//
+
+struct MLAS_CPU_FEATURES {
+    MLAS_ISA_LEVEL IsaLevel;
+    bool HasF16C;
+    bool HasAvx512Vnni;
+    bool HasAvx512Bf16;
+    bool HasAmxInt8;
+    bool HasAmxBf16;
+};
+
+//
+// Stores the instruction set level of each kernel family and whether the
+// specialized SGEMM kernels for a single row are used.
+//
+
+struct MLAS_KERNEL_SELECTION {
+    MLAS_ISA_LEVEL Levels[MlasKernelFamilyCount];
+    bool UseSgemmKernelM1;
+};
+
+bool
+MlasParseKernelSelection(
+    const char* Text,
+    MLAS_KERNEL_SELECTION* Selection
+    );
+
+size_t
+MlasFormatKernelSelection(
+    const MLAS_KERNEL_SELECTION* Selection,
+    char* Buffer,
+    size_t BufferSize
+    );
+
+#if defined(MLAS_TARGET_AMD64)
+
+void
+MlasTuneKernelSelection(
+    const MLAS_CPU_FEATURES* Features,
+    MLAS_KERNEL_SELECTION* Selection
+    );
+
+#endif
+
+#endif
+
 //
 // Environment information class.
 //
@@ -700,6 +913,10 @@ struct MLAS_PLATFORM {
     MLAS_PLATFORM(void);
 
 #if defined(MLAS_TARGET_AMD64_IX86)
+    void SelectKernels(const MLAS_CPU_FEATURES* Features, const MLAS_KERNEL_SELECTION* Selection);
+
+    MLAS_CPU_FEATURES CpuFeatures;
+    MLAS_KERNEL_SELECTION KernelSelection;
     PMLAS_GEMM_FLOAT_KERNEL GemmFloatKernel;
 #endif
 
@@ -715,6 +932,8 @@ struct MLAS_PLATFORM {
     PMLAS_GEMM_U8X8_OPERATION GemmU8U8Operation;
     PMLAS_GEMM_U8X8_OPERATION GemmU8U8PackedOperation;
     PMLAS_GEMM_U8U8_KERNEL GemmU8U8Kernel;
+    PMLAS_GEMM_BF16_COPY_PACKA_ROUTINE GemmBf16CopyPackARoutine;
+    PMLAS_GEMM_BF16_KERNEL GemmBf16Kernel;
     PMLAS_CONV_FLOAT_KERNEL ConvNchwFloatKernel;
     PMLAS_CONV_FLOAT_KERNEL ConvNchwcFloatKernel;
     PMLAS_CONV_DEPTHWISE_FLOAT_KERNEL ConvDepthwiseFloatKernel;
@@ -731,9 +950,18 @@ struct MLAS_PLATFORM {
     PMLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL ComputeLogSoftmaxOutputF32Kernel;
     PMLAS_REDUCE_MAXIMUM_FLOAT_KERNEL ReduceMaximumF32Kernel;
     PMLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL ReduceMinimumMaximumF32Kernel;
+    PMLAS_LAYER_NORM_FLOAT_KERNEL LayerNormF32Kernel;
+    PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL ConvertHalfToFloatKernel;
+    PMLAS_CONVERT_FLOAT_TO_HALF_KERNEL ConvertFloatToHalfKernel;
     uint32_t NchwcBlockSize;
     uint32_t PreferredBufferAlignment;
 #endif
+
+#if defined(MLAS_TARGET_ARM64)
+    PMLAS_GEMM_U8X8_OPERATION GemmU8X8Operation;
+    PMLAS_GEMM_U8X8_OPERATION GemmU8X8PackedOperation;
+    PMLAS_HALF_GEMM_KERNEL HalfGemmKernel;
+#endif
 };
 
 extern MLAS_PLATFORM MlasPlatform;
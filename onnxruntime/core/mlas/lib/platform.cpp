@@ -17,6 +17,27 @@ Abstract:
 
 #include "mlasi.h"
 
+#if defined(__linux__) && defined(MLAS_TARGET_AMD64)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#if defined(__linux__) && defined(MLAS_TARGET_ARM64)
+#include <sys/auxv.h>
+#if !defined(HWCAP_ASIMDDP)
+#define HWCAP_ASIMDDP (1 << 20)
+#endif
+#if !defined(HWCAP_ASIMDHP)
+#define HWCAP_ASIMDHP (1 << 10)
+#endif
+#endif
+
 //
 // Stores the platform information.
 //
@@ -86,66 +107,308 @@ MlasReadExtendedControlRegister(
 #endif
 }
 
-#endif
+//
+// Stores the names of the instruction set levels and of the kernel families,
+// as used by the MLAS_MAXIMUM_ISA and MLAS_DISPATCH environment variables and
+// by the tuning file.
+//
 
-MLAS_PLATFORM::MLAS_PLATFORM(
-    void
+static const struct {
+    const char* Name;
+    MLAS_ISA_LEVEL Level;
+} MlasIsaLevelNames[] = {
+    { "sse2", MlasIsaSse2 },
+    { "avx", MlasIsaAvx },
+    { "avx2", MlasIsaAvx2 },
+    { "avx512f", MlasIsaAvx512F },
+    { "avx512core", MlasIsaAvx512Core },
+    { "avx512vnni", MlasIsaAvx512Vnni },
+    { "all", MlasIsaAll },
+};
+
+static const char* const MlasKernelFamilyNames[MlasKernelFamilyCount] = {
+    "sgemm",
+    "qgemm",
+    "conv",
+    "elementwise",
+};
+
+bool
+MlasParseIsaLevel(
+    const char* Name,
+    size_t Length,
+    MLAS_ISA_LEVEL* Level
+    )
+{
+    for (const auto& IsaLevelName : MlasIsaLevelNames) {
+        if (strlen(IsaLevelName.Name) == Length && strncmp(Name, IsaLevelName.Name, Length) == 0) {
+            *Level = IsaLevelName.Level;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool
+MlasParseKernelSelection(
+    const char* Text,
+    MLAS_KERNEL_SELECTION* Selection
     )
 /*++
 
 Routine Description:
 
-    This routine initializes the platform support for this library.
+    This routine parses a list of "family=value" settings separated by
+    semicolons, commas or whitespace, for example "sgemm=avx2;conv=avx512f".
+    The families are sgemm, qgemm, conv and elementwise, whose value is an
+    instruction set level, and sgemm_m1, whose value is on or off.
 
 Arguments:
 
-    None.
+    Text - Supplies the settings.
+
+    Selection - Supplies the kernel selection to update.
 
 Return Value:
 
-    None.
+    Returns false if a setting is not recognized. The valid settings are
+    applied regardless.
 
 --*/
 {
+    bool Valid = true;
 
-#if defined(MLAS_TARGET_AMD64_IX86)
+    while (*Text != '\0') {
 
-    //
-    // Default to the baseline SSE2 support.
-    //
+        size_t Length = strcspn(Text, ";, \t\r\n");
+
+        if (Length > 0) {
+
+            const char* Equals = static_cast<const char*>(memchr(Text, '=', Length));
+            bool Applied = false;
+
+            if (Equals != nullptr) {
+
+                size_t NameLength = size_t(Equals - Text);
+                const char* Value = Equals + 1;
+                size_t ValueLength = Length - NameLength - 1;
+
+                if (NameLength == 8 && strncmp(Text, "sgemm_m1", 8) == 0) {
+                    if (ValueLength == 2 && strncmp(Value, "on", 2) == 0) {
+                        Selection->UseSgemmKernelM1 = true;
+                        Applied = true;
+                    } else if (ValueLength == 3 && strncmp(Value, "off", 3) == 0) {
+                        Selection->UseSgemmKernelM1 = false;
+                        Applied = true;
+                    }
+                } else {
+                    for (size_t Family = 0; Family < MlasKernelFamilyCount; Family++) {
+                        if (strlen(MlasKernelFamilyNames[Family]) == NameLength &&
+                            strncmp(Text, MlasKernelFamilyNames[Family], NameLength) == 0) {
+                            Applied = MlasParseIsaLevel(Value, ValueLength, &Selection->Levels[Family]);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            Valid = Valid && Applied;
+            Text += Length;
+
+        } else {
+            Text++;
+        }
+    }
+
+    return Valid;
+}
+
+size_t
+MlasFormatKernelSelection(
+    const MLAS_KERNEL_SELECTION* Selection,
+    char* Buffer,
+    size_t BufferSize
+    )
+/*++
 
-    this->GemmFloatKernel = MlasGemmFloatKernelSse;
+Routine Description:
+
+    This routine formats a kernel selection as one "family=value" setting per
+    line, in the format read by MlasParseKernelSelection.
+
+Arguments:
+
+    Selection - Supplies the kernel selection.
+
+    Buffer - Supplies the buffer to format the settings to.
+
+    BufferSize - Supplies the size of the buffer in bytes.
+
+Return Value:
+
+    Returns the length of the text, excluding the terminating null character,
+    or zero if the buffer is too small.
+
+--*/
+{
+    size_t Length = 0;
+
+    for (size_t Family = 0; Family <= MlasKernelFamilyCount; Family++) {
+
+        const char* Value;
+
+        if (Family < MlasKernelFamilyCount) {
+            Value = "all";
+            for (const auto& IsaLevelName : MlasIsaLevelNames) {
+                if (IsaLevelName.Level == Selection->Levels[Family]) {
+                    Value = IsaLevelName.Name;
+                }
+            }
+        } else {
+            Value = Selection->UseSgemmKernelM1 ? "on" : "off";
+        }
+
+        const char* Name = (Family < MlasKernelFamilyCount) ? MlasKernelFamilyNames[Family] : "sgemm_m1";
+        int Count = snprintf(Buffer + Length, BufferSize - Length, "%s=%s\n", Name, Value);
+
+        if (Count < 0 || size_t(Count) >= BufferSize - Length) {
+            return 0;
+        }
+
+        Length += size_t(Count);
+    }
+
+    return Length;
+}
+
+//
+// Reads an environment variable into the buffer. Returns false if the
+// variable is not set or does not fit in the buffer.
+//
+
+bool
+MlasGetEnvironmentVariable(
+    const char* Name,
+    char* Buffer,
+    size_t BufferSize
+    )
+{
+#if defined(_WIN32)
+    DWORD Length = GetEnvironmentVariableA(Name, Buffer, DWORD(BufferSize));
+    return Length > 0 && Length < BufferSize;
+#else
+    const char* Value = getenv(Name);
+    if (Value == nullptr || strlen(Value) >= BufferSize) {
+        return false;
+    }
+    strcpy(Buffer, Value);
+    return true;
+#endif
+}
+
+//
+// Returns the instruction set level that the kernels are capped at by the
+// MLAS_MAXIMUM_ISA environment variable, to benchmark or test the kernels of
+// a lower level on a newer processor.
+//
+
+MLAS_ISA_LEVEL
+MlasGetMaximumIsaLevel(
+    void
+    )
+{
+    char Value[32];
+    MLAS_ISA_LEVEL Level;
+
+    if (MlasGetEnvironmentVariable("MLAS_MAXIMUM_ISA", Value, sizeof(Value)) &&
+        MlasParseIsaLevel(Value, strlen(Value), &Level)) {
+        return Level;
+    }
+
+    return MlasIsaAll;
+}
+
+#if defined(MLAS_TARGET_AMD64) && !defined(MLAS_AMX_UNSUPPORTED)
+
+//
+// Requests permission from the operating system to use the AMX tile data
+// state. Linux requires each process to opt in before the tile registers can
+// be used, otherwise the first tile instruction raises a fault.
+//
+
+#if defined(__linux__)
+#if !defined(ARCH_REQ_XCOMP_PERM)
+#define ARCH_REQ_XCOMP_PERM 0x1023
+#endif
+
+#if !defined(XFEATURE_XTILEDATA)
+#define XFEATURE_XTILEDATA 18
+#endif
+#endif
+
+bool
+MlasRequestAmxPermission(
+    void
+    )
+{
+#if defined(__linux__)
+    return syscall(SYS_arch_prctl, ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA) == 0;
+#else
+    return true;
+#endif
+}
+
+#endif
 
 #if defined(MLAS_TARGET_AMD64)
 
-    this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
-    this->GemmDoubleKernel = MlasGemmDoubleKernelSse;
-    this->GemmU8S8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_SSE>;
-    this->GemmU8U8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_SSE>;
-    this->ConvNchwFloatKernel = MlasConvNchwFloatKernelSse;
-    this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelSse;
-    this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelSse;
-    this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelSse;
-    this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelSse;
-    this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelSse;
-    this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelSse;
-    this->ComputeExpF32Kernel = MlasComputeExpF32Kernel;
-    this->LogisticKernelRoutine = MlasLogisticKernel;
-    this->TanhKernelRoutine = MlasTanhKernel;
-    this->ErfKernelRoutine = MlasErfKernel;
-    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
-    this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32Kernel;
-    this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
-    this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
-    this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
-    this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
-    this->QLinearAddU8Kernel = MlasQLinearAddU8Kernel;
+//
+// Opens the tuning file.
+//
 
-    this->NchwcBlockSize = 8;
-    this->PreferredBufferAlignment = MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT;
+FILE*
+MlasOpenTuningFile(
+    const char* FileName,
+    const char* Mode
+    )
+{
+#if defined(_WIN32)
+    FILE* File;
+    return (fopen_s(&File, FileName, Mode) == 0) ? File : nullptr;
+#else
+    return fopen(FileName, Mode);
+#endif
+}
 
 #endif
 
+MLAS_CPU_FEATURES
+MlasGetCpuFeatures(
+    MLAS_ISA_LEVEL MaximumIsaLevel
+    )
+/*++
+
+Routine Description:
+
+    This routine queries the instruction set extensions that are supported by
+    the processor and by the operating system, and that the library was built
+    with.
+
+Arguments:
+
+    MaximumIsaLevel - Supplies the highest level that may be used. The AMX
+        tile state is only requested from the operating system if the AMX
+        kernels may be used.
+
+Return Value:
+
+    Returns the processor features.
+
+--*/
+{
+    MLAS_CPU_FEATURES Features = {};
+
     //
     // Check if the processor supports the AVX and OSXSAVE features.
     //
@@ -167,26 +430,10 @@ Return Value:
 
         if ((xcr0 & 0x6) == 0x6) {
 
-            this->GemmFloatKernel = MlasGemmFloatKernelAvx;
+            Features.IsaLevel = MlasIsaAvx;
 
 #if defined(MLAS_TARGET_AMD64)
 
-            this->KernelM1Routine = MlasSgemmKernelM1Avx;
-            this->KernelM1TransposeBRoutine = MlasSgemmKernelM1TransposeBAvx;
-            this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Avx;
-            this->GemmDoubleKernel = MlasGemmDoubleKernelAvx;
-            this->ConvNchwFloatKernel = MlasConvNchwFloatKernelAvx;
-            this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelAvx;
-            this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelAvx;
-            this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelAvx;
-            this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx;
-            this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx;
-            this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx;
-            this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32KernelAvx;
-            this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32KernelAvx;
-            this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelAvx;
-            this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32KernelAvx;
-
             //
             // Check if the processor supports AVX2/FMA3 features.
             //
@@ -200,27 +447,8 @@ Return Value:
 
             if (((Cpuid1[2] & 0x1000) != 0) && ((Cpuid7[1] & 0x20) != 0)) {
 
-                this->GemmU8S8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
-                this->GemmU8S8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
-                this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx2;
-                this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx2;
-                this->GemmU8U8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8U8_KERNEL_AVX2>;
-                this->GemmU8U8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8U8_KERNEL_AVX2>;
-                this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx2;
-
-                this->GemmFloatKernel = MlasGemmFloatKernelFma3;
-                this->GemmDoubleKernel = MlasGemmDoubleKernelFma3;
-                this->ConvNchwFloatKernel = MlasConvNchwFloatKernelFma3;
-                this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelFma3;
-                this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelFma3;
-                this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelFma3;
-                this->ComputeExpF32Kernel = MlasComputeExpF32KernelFma3;
-                this->LogisticKernelRoutine = MlasLogisticKernelFma3;
-                this->TanhKernelRoutine = MlasTanhKernelFma3;
-                this->ErfKernelRoutine = MlasErfKernelFma3;
-                this->QLinearAddS8Kernel = MlasQLinearAddS8KernelAvx2;
-                this->QLinearAddU8Kernel = MlasQLinearAddU8KernelAvx2;
-                this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                Features.IsaLevel = MlasIsaAvx2;
+                Features.HasF16C = (Cpuid1[2] & 0x20000000) != 0;
 
 #if !defined(MLAS_AVX512F_UNSUPPORTED)
 
@@ -231,44 +459,55 @@ Return Value:
 
                 if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
 
-                    this->GemmFloatKernel = MlasGemmFloatKernelAvx512F;
-                    this->GemmDoubleKernel = MlasGemmDoubleKernelAvx512F;
-                    this->ConvNchwFloatKernel = MlasConvNchwFloatKernelAvx512F;
-                    this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelAvx512F;
-                    this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelAvx512F;
-                    this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelAvx512F;
-                    this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx512F;
-                    this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx512F;
-                    this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
-                    this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
-                    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
-                    this->NchwcBlockSize = 16;
-                    this->PreferredBufferAlignment = 64;
+                    Features.IsaLevel = MlasIsaAvx512F;
 
                     //
                     // Check if the processor supports AVX512 core features
-                    // (AVX512BW/AVX512DQ/AVX512VL).
+                    // (AVX512BW/AVX512DQ/AVX512VL). The extensions beyond
+                    // these are reported separately.
                     //
 
 #if !defined(MLAS_AVX512CORE_UNSUPPORTED)
 
                     if ((Cpuid7[1] & 0xC0020000) == 0xC0020000) {
 
-                        this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Core;
-                        this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Core;
-                        this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx512Core;
+                        Features.IsaLevel = MlasIsaAll;
+                        Features.HasAvx512Vnni = (Cpuid7[2] & 0x800) != 0;
+
+#if !defined(MLAS_AVX512BF16_UNSUPPORTED)
+
+                        //
+                        // Check if the processor supports AVX512_BF16.
+                        //
+
+                        unsigned Cpuid7_1[4];
+#if defined(_WIN32)
+                        __cpuidex((int*)Cpuid7_1, 7, 1);
+#else
+                        __cpuid_count(7, 1, Cpuid7_1[0], Cpuid7_1[1], Cpuid7_1[2], Cpuid7_1[3]);
+#endif
+
+                        Features.HasAvx512Bf16 = (Cpuid7[0] >= 1) && ((Cpuid7_1[0] & 0x20) != 0);
+
+#if !defined(MLAS_AMX_UNSUPPORTED)
 
                         //
-                        // Check if the processor supports AVX512VNNI.
+                        // Check if the processor supports the AMX tile features
+                        // and the operating system supports saving the tile state.
+                        // The tile kernels use AVX512VNNI or AVX512_BF16 for the
+                        // remainder along the K dimension.
                         //
 
-                        if ((Cpuid7[2] & 0x800) != 0) {
+                        if (((Cpuid7[3] & 0x1000000) != 0) && ((xcr0 & 0x60000) == 0x60000) &&
+                            MaximumIsaLevel >= MlasIsaAll && MlasRequestAmxPermission()) {
 
-                            this->GemmU8U8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
-                            this->GemmU8U8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
-                            this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Vnni;
-                            this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Vnni;
+                            Features.HasAmxInt8 = ((Cpuid7[3] & 0x2000000) != 0) && Features.HasAvx512Vnni;
+                            Features.HasAmxBf16 = ((Cpuid7[3] & 0x400000) != 0) && Features.HasAvx512Bf16;
                         }
+
+#endif // MLAS_AMX_UNSUPPORTED
+
+#endif // MLAS_AVX512BF16_UNSUPPORTED
                     }
 
 #endif // MLAS_AVX512CORE_UNSUPPORTED
@@ -284,8 +523,424 @@ Return Value:
         }
     }
 
+    return Features;
+}
+
+void
+MLAS_PLATFORM::SelectKernels(
+    const MLAS_CPU_FEATURES* Features,
+    const MLAS_KERNEL_SELECTION* Selection
+    )
+/*++
+
+Routine Description:
+
+    This routine assigns the kernels of each family for the instruction set
+    level that is selected for the family. The levels must not exceed the
+    level supported by the processor.
+
+    The kernels can only be changed before any packed buffers are built,
+    because the packed formats depend on the kernels.
+
+Arguments:
+
+    Features - Supplies the processor features.
+
+    Selection - Supplies the kernel selection.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    this->CpuFeatures = *Features;
+    this->KernelSelection = *Selection;
+
+    //
+    // Select the float and double GEMM kernels.
+    //
+
+    const MLAS_ISA_LEVEL SgemmLevel = Selection->Levels[MlasSgemmFamily];
+
+    this->GemmFloatKernel = (SgemmLevel >= MlasIsaAvx) ? MlasGemmFloatKernelAvx : MlasGemmFloatKernelSse;
+
+#if defined(MLAS_TARGET_AMD64)
+
+    this->KernelM1Routine = nullptr;
+    this->KernelM1TransposeBRoutine = nullptr;
+    this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
+    this->GemmDoubleKernel = MlasGemmDoubleKernelSse;
+    this->GemmBf16CopyPackARoutine = nullptr;
+    this->GemmBf16Kernel = nullptr;
+
+    if (SgemmLevel >= MlasIsaAvx) {
+
+        if (Selection->UseSgemmKernelM1) {
+            this->KernelM1Routine = MlasSgemmKernelM1Avx;
+            this->KernelM1TransposeBRoutine = MlasSgemmKernelM1TransposeBAvx;
+        }
+
+        this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Avx;
+        this->GemmDoubleKernel = MlasGemmDoubleKernelAvx;
+    }
+
+    if (SgemmLevel >= MlasIsaAvx2) {
+        this->GemmFloatKernel = MlasGemmFloatKernelFma3;
+        this->GemmDoubleKernel = MlasGemmDoubleKernelFma3;
+    }
+
+#if !defined(MLAS_AVX512F_UNSUPPORTED)
+
+    if (SgemmLevel >= MlasIsaAvx512F) {
+        this->GemmFloatKernel = MlasGemmFloatKernelAvx512F;
+        this->GemmDoubleKernel = MlasGemmDoubleKernelAvx512F;
+    }
+
+#if !defined(MLAS_AVX512CORE_UNSUPPORTED) && !defined(MLAS_AVX512BF16_UNSUPPORTED)
+
+    if (SgemmLevel >= MlasIsaAll && Features->HasAvx512Bf16) {
+
+        this->GemmBf16CopyPackARoutine = MlasGemmBf16CopyPackAAvx512Bf16;
+        this->GemmBf16Kernel = MlasGemmBf16KernelAvx512Bf16;
+
+#if !defined(MLAS_AMX_UNSUPPORTED)
+        if (Features->HasAmxBf16) {
+            this->GemmBf16Kernel = MlasGemmBf16KernelAmx;
+        }
+#endif
+    }
+
+#endif
+
+#endif // MLAS_AVX512F_UNSUPPORTED
+
+    //
+    // Select the quantized GEMM kernels.
+    //
+
+    const MLAS_ISA_LEVEL QgemmLevel = Selection->Levels[MlasQgemmFamily];
+
+    this->GemmU8S8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_SSE>;
+    this->GemmU8S8PackedOperation = nullptr;
+    this->GemmU8S8Kernel = nullptr;
+    this->GemvU8S8Kernel = nullptr;
+    this->GemmU8U8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_SSE>;
+    this->GemmU8U8PackedOperation = nullptr;
+    this->GemmU8U8Kernel = nullptr;
+
+    if (QgemmLevel >= MlasIsaAvx2) {
+        this->GemmU8S8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
+        this->GemmU8S8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
+        this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx2;
+        this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx2;
+        this->GemmU8U8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8U8_KERNEL_AVX2>;
+        this->GemmU8U8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8U8_KERNEL_AVX2>;
+        this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx2;
+    }
+
+#if !defined(MLAS_AVX512F_UNSUPPORTED) && !defined(MLAS_AVX512CORE_UNSUPPORTED)
+
+    if (QgemmLevel >= MlasIsaAvx512Core) {
+        this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Core;
+        this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Core;
+        this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx512Core;
+    }
+
+    if (QgemmLevel >= MlasIsaAvx512Vnni && Features->HasAvx512Vnni) {
+        this->GemmU8U8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
+        this->GemmU8U8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AVX2>;
+        this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Vnni;
+        this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Vnni;
+    }
+
+#if !defined(MLAS_AVX512BF16_UNSUPPORTED) && !defined(MLAS_AMX_UNSUPPORTED)
+
+    if (QgemmLevel >= MlasIsaAll && Features->HasAmxInt8) {
+        this->GemmU8S8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8S8_KERNEL_AMX>;
+        this->GemmU8S8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AMX>;
+        this->GemmU8U8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8S8_KERNEL_AMX>;
+        this->GemmU8U8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AMX>;
+    }
+
+#endif
+
+#endif
+
+    //
+    // Select the convolution and pooling kernels.
+    //
+
+    const MLAS_ISA_LEVEL ConvLevel = Selection->Levels[MlasConvFamily];
+
+    this->ConvNchwFloatKernel = MlasConvNchwFloatKernelSse;
+    this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelSse;
+    this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelSse;
+    this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelSse;
+    this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelSse;
+    this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelSse;
+    this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelSse;
+    this->NchwcBlockSize = 8;
+
+    if (ConvLevel >= MlasIsaAvx) {
+        this->ConvNchwFloatKernel = MlasConvNchwFloatKernelAvx;
+        this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelAvx;
+        this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelAvx;
+        this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelAvx;
+        this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx;
+        this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx;
+        this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx;
+    }
+
+    if (ConvLevel >= MlasIsaAvx2) {
+        this->ConvNchwFloatKernel = MlasConvNchwFloatKernelFma3;
+        this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelFma3;
+        this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelFma3;
+        this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelFma3;
+    }
+
+#if !defined(MLAS_AVX512F_UNSUPPORTED)
+
+    if (ConvLevel >= MlasIsaAvx512F) {
+        this->ConvNchwFloatKernel = MlasConvNchwFloatKernelAvx512F;
+        this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelAvx512F;
+        this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelAvx512F;
+        this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelAvx512F;
+        this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx512F;
+        this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx512F;
+        this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
+        this->NchwcBlockSize = 16;
+    }
+
+#endif
+
+    //
+    // Select the elementwise kernels.
+    //
+
+    const MLAS_ISA_LEVEL ElementwiseLevel = Selection->Levels[MlasElementwiseFamily];
+
+    this->ComputeExpF32Kernel = MlasComputeExpF32Kernel;
+    this->LogisticKernelRoutine = MlasLogisticKernel;
+    this->TanhKernelRoutine = MlasTanhKernel;
+    this->ErfKernelRoutine = MlasErfKernel;
+    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
+    this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32Kernel;
+    this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
+    this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
+    this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
+    this->LayerNormF32Kernel = MlasLayerNormF32Kernel;
+#if defined(_WIN32)
+    this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernelSse;
+#else
+    this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernel;
+#endif
+    this->ConvertFloatToHalfKernel = MlasConvertFloatToHalfKernel;
+    this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
+    this->QLinearAddU8Kernel = MlasQLinearAddU8Kernel;
+
+    if (ElementwiseLevel >= MlasIsaAvx) {
+        this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32KernelAvx;
+        this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32KernelAvx;
+        this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelAvx;
+        this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32KernelAvx;
+    }
+
+    if (ElementwiseLevel >= MlasIsaAvx2) {
+
+        this->ComputeExpF32Kernel = MlasComputeExpF32KernelFma3;
+        this->LogisticKernelRoutine = MlasLogisticKernelFma3;
+        this->TanhKernelRoutine = MlasTanhKernelFma3;
+        this->ErfKernelRoutine = MlasErfKernelFma3;
+        this->QLinearAddS8Kernel = MlasQLinearAddS8KernelAvx2;
+        this->QLinearAddU8Kernel = MlasQLinearAddU8KernelAvx2;
+        this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+        this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx2;
+
+        if (Features->HasF16C) {
+            this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernelF16C;
+            this->ConvertFloatToHalfKernel = MlasConvertFloatToHalfKernelF16C;
+        }
+    }
+
+#if !defined(MLAS_AVX512F_UNSUPPORTED)
+
+    if (ElementwiseLevel >= MlasIsaAvx512F) {
+        this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
+        this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
+        this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx512F;
+    }
+
+#endif
+
+#endif // MLAS_TARGET_AMD64
+}
+
+#endif
+
+MLAS_PLATFORM::MLAS_PLATFORM(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine initializes the platform support for this library.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    None.
+
+--*/
+{
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+
+    //
+    // Query the processor features, capped by the MLAS_MAXIMUM_ISA environment
+    // variable. The 32-bit kernels go no further than AVX.
+    //
+
+    const MLAS_ISA_LEVEL MaximumIsaLevel = MlasGetMaximumIsaLevel();
+
+    MLAS_CPU_FEATURES Features = MlasGetCpuFeatures(MaximumIsaLevel);
+
+    if (Features.IsaLevel > MaximumIsaLevel) {
+        Features.IsaLevel = MaximumIsaLevel;
+    }
+
+    //
+    // Default to the best kernels of each family.
+    //
+
+    MLAS_KERNEL_SELECTION Selection;
+
+    for (size_t Family = 0; Family < MlasKernelFamilyCount; Family++) {
+        Selection.Levels[Family] = Features.IsaLevel;
+    }
+
+    Selection.UseSgemmKernelM1 = true;
+
+    this->SelectKernels(&Features, &Selection);
+
+    //
+    // Benchmark the candidate kernels if MLAS_TUNE is set, saving the result
+    // to the file named by MLAS_TUNING_FILE if that is set too. Otherwise load
+    // the selection from the tuning file, if there is one.
+    //
+
+#if defined(MLAS_TARGET_AMD64)
+
+    char TuningFile[260];
+    char Value[256];
+
+    const bool HasTuningFile = MlasGetEnvironmentVariable("MLAS_TUNING_FILE", TuningFile, sizeof(TuningFile));
+
+    if (MlasGetEnvironmentVariable("MLAS_TUNE", Value, sizeof(Value)) && strcmp(Value, "0") != 0) {
+
+        MlasTuneKernelSelection(&Features, &Selection);
+
+        if (HasTuningFile) {
+
+            FILE* File = MlasOpenTuningFile(TuningFile, "w");
+
+            if (File != nullptr) {
+                size_t Length = MlasFormatKernelSelection(&Selection, Value, sizeof(Value));
+                fwrite(Value, 1, Length, File);
+                fclose(File);
+            }
+        }
+
+    } else if (HasTuningFile) {
+
+        FILE* File = MlasOpenTuningFile(TuningFile, "r");
+
+        if (File != nullptr) {
+            size_t Length = fread(Value, 1, sizeof(Value) - 1, File);
+            Value[Length] = '\0';
+            fclose(File);
+            MlasParseKernelSelection(Value, &Selection);
+        }
+    }
+
+#else
+
+    char Value[256];
+
+#endif
+
+    //
+    // Apply the overrides of the MLAS_DISPATCH environment variable, for
+    // example "sgemm=avx2;qgemm=avx512core;sgemm_m1=off".
+    //
+
+    if (MlasGetEnvironmentVariable("MLAS_DISPATCH", Value, sizeof(Value))) {
+        MlasParseKernelSelection(Value, &Selection);
+    }
+
+    //
+    // Never select kernels that the processor does not support.
+    //
+
+    for (size_t Family = 0; Family < MlasKernelFamilyCount; Family++) {
+        if (Selection.Levels[Family] > Features.IsaLevel) {
+            Selection.Levels[Family] = Features.IsaLevel;
+        }
+    }
+
+    this->SelectKernels(&Features, &Selection);
+
+#if defined(MLAS_TARGET_AMD64)
+
+    this->PreferredBufferAlignment = (Features.IsaLevel >= MlasIsaAvx512F) ?
+        64 : MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT;
+
+#endif
+
 #endif // MLAS_TARGET_AMD64_IX86
 
+#if defined(MLAS_TARGET_ARM64)
+
+    //
+    // Default to the baseline NEON support.
+    //
+
+    this->GemmU8X8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_NEON>;
+    this->GemmU8X8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_NEON>;
+    this->HalfGemmKernel = nullptr;
+
+#if defined(__linux__) && !defined(MLAS_UDOT_UNSUPPORTED)
+
+    //
+    // Check if the processor supports the ARMv8.2 dot product instructions.
+    //
+
+    if ((getauxval(AT_HWCAP) & HWCAP_ASIMDDP) != 0) {
+        this->GemmU8X8Operation = MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_UDOT>;
+        this->GemmU8X8PackedOperation = MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_UDOT>;
+    }
+
+#endif
+
+#if defined(__linux__) && !defined(MLAS_FP16_UNSUPPORTED)
+
+    //
+    // Check if the processor supports the ARMv8.2 half-precision vector
+    // arithmetic instructions.
+    //
+
+    if ((getauxval(AT_HWCAP) & HWCAP_ASIMDHP) != 0) {
+        this->HalfGemmKernel = MlasHalfGemmKernelNeonFp16;
+    }
+
+#endif
+
+#endif // MLAS_TARGET_ARM64
+
 }
 
 size_t
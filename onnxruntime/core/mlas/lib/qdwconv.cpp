@@ -0,0 +1,165 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qdwconv.cpp
+
+Abstract:
+
+    This module implements the quantized integer depthwise convolution
+    routines.
+
+    The input and output images use the channels last (NHWC) layout so that
+    the channels of a pixel are contiguous in memory and can be processed as
+    a vector. The spatial structure of the convolution (kernel shape, padding,
+    dilation and striding) is described by an indirection buffer that stores
+    a pointer to the input pixel for each output pixel and kernel position.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvDepthwise(
+    const uint8_t* const* Input,
+    uint8_t InputZeroPoint,
+    const uint8_t* Filter,
+    uint8_t FilterZeroPoint,
+    int32_t* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer depthwise convolution
+    with a channel multiplier of one.
+
+Arguments:
+
+    Input - Supplies the indirection buffer of OutputCount by KernelSize
+        pointers. Each pointer addresses the Channels elements of an input
+        pixel. Pointers for positions inside the padding region should
+        address a buffer filled with the input zero point.
+
+    InputZeroPoint - Supplies the zero point offset of the input.
+
+    Filter - Supplies the filter buffer of KernelSize by Channels elements.
+
+    FilterZeroPoint - Supplies the zero point offset of the filter.
+
+    Output - Supplies the output buffer of OutputCount by Channels elements.
+
+    Channels - Supplies the number of channels.
+
+    OutputCount - Supplies the number of output pixels.
+
+    KernelSize - Supplies the number of positions of the kernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+    const __m128i ZeroVector = _mm_setzero_si128();
+    const __m128i InputZeroPointVector = _mm_set1_epi16(InputZeroPoint);
+    const __m128i FilterZeroPointVector = _mm_set1_epi16(FilterZeroPoint);
+#elif defined(MLAS_NEON_INTRINSICS)
+    const int16x8_t InputZeroPointVector = vdupq_n_s16(InputZeroPoint);
+    const int16x8_t FilterZeroPointVector = vdupq_n_s16(FilterZeroPoint);
+#endif
+
+    while (OutputCount > 0) {
+
+        size_t ChannelOffset = 0;
+        size_t c = Channels;
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+
+        //
+        // Process eight channels at a time. The inputs and filters are
+        // widened to 16 bits after subtracting the zero point, so the
+        // products are exact when accumulated as 32-bit values.
+        //
+
+        while (c >= 8) {
+
+#if defined(MLAS_SSE2_INTRINSICS)
+            __m128i Accumulator0 = _mm_setzero_si128();
+            __m128i Accumulator1 = _mm_setzero_si128();
+#else
+            int32x4_t Accumulator0 = vdupq_n_s32(0);
+            int32x4_t Accumulator1 = vdupq_n_s32(0);
+#endif
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+#if defined(MLAS_SSE2_INTRINSICS)
+                __m128i InputVector = _mm_loadl_epi64((const __m128i*)&Input[k][ChannelOffset]);
+                __m128i FilterVector = _mm_loadl_epi64((const __m128i*)&Filter[k * Channels + ChannelOffset]);
+
+                InputVector = _mm_sub_epi16(_mm_unpacklo_epi8(InputVector, ZeroVector), InputZeroPointVector);
+                FilterVector = _mm_sub_epi16(_mm_unpacklo_epi8(FilterVector, ZeroVector), FilterZeroPointVector);
+
+                __m128i ProductLow = _mm_mullo_epi16(InputVector, FilterVector);
+                __m128i ProductHigh = _mm_mulhi_epi16(InputVector, FilterVector);
+
+                Accumulator0 = _mm_add_epi32(Accumulator0, _mm_unpacklo_epi16(ProductLow, ProductHigh));
+                Accumulator1 = _mm_add_epi32(Accumulator1, _mm_unpackhi_epi16(ProductLow, ProductHigh));
+#else
+                int16x8_t InputVector = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(&Input[k][ChannelOffset])));
+                int16x8_t FilterVector = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(&Filter[k * Channels + ChannelOffset])));
+
+                InputVector = vsubq_s16(InputVector, InputZeroPointVector);
+                FilterVector = vsubq_s16(FilterVector, FilterZeroPointVector);
+
+                Accumulator0 = vmlal_s16(Accumulator0, vget_low_s16(InputVector), vget_low_s16(FilterVector));
+                Accumulator1 = vmlal_s16(Accumulator1, vget_high_s16(InputVector), vget_high_s16(FilterVector));
+#endif
+            }
+
+#if defined(MLAS_SSE2_INTRINSICS)
+            _mm_storeu_si128((__m128i*)&Output[0], Accumulator0);
+            _mm_storeu_si128((__m128i*)&Output[4], Accumulator1);
+#else
+            vst1q_s32(&Output[0], Accumulator0);
+            vst1q_s32(&Output[4], Accumulator1);
+#endif
+
+            Output += 8;
+            ChannelOffset += 8;
+            c -= 8;
+        }
+
+#endif
+
+        while (c > 0) {
+
+            int32_t Accumulator = 0;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                int32_t InputValue = int32_t(Input[k][ChannelOffset]) - InputZeroPoint;
+                int32_t FilterValue = int32_t(Filter[k * Channels + ChannelOffset]) - FilterZeroPoint;
+
+                Accumulator += InputValue * FilterValue;
+            }
+
+            *Output++ = Accumulator;
+            ChannelOffset += 1;
+            c -= 1;
+        }
+
+        Input += KernelSize;
+        OutputCount -= 1;
+    }
+}
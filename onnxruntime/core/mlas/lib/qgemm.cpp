@@ -140,13 +140,12 @@ Return Value:
 
     //
     // Flip the sign bit of the zero point offset of matrix B if the kernel uses
-    // signed types and the matrix B data is unsigned.
+    // signed types and the matrix B data is unsigned, or the kernel uses
+    // unsigned types and the matrix B data is signed.
     //
 
-    if (std::is_signed<typename KernelType::OffsetBType>::value) {
-        if (!WorkBlock->BIsSigned) {
-            offb = typename KernelType::OffsetBType(offb ^ 0x80);
-        }
+    if (std::is_signed<typename KernelType::OffsetBType>::value != WorkBlock->BIsSigned) {
+        offb = typename KernelType::OffsetBType(offb ^ 0x80);
     }
 
     //
@@ -284,13 +283,12 @@ Return Value:
 
     //
     // Flip the sign bit of the zero point offset of matrix B if the kernel uses
-    // signed types and the matrix B data is unsigned.
+    // signed types and the matrix B data is unsigned, or the kernel uses
+    // unsigned types and the matrix B data is signed.
     //
 
-    if (std::is_signed<typename KernelType::OffsetBType>::value) {
-        if (!WorkBlock->BIsSigned) {
-            offb = typename KernelType::OffsetBType(offb ^ 0x80);
-        }
+    if (std::is_signed<typename KernelType::OffsetBType>::value != WorkBlock->BIsSigned) {
+        offb = typename KernelType::OffsetBType(offb ^ 0x80);
     }
 
     //
@@ -1434,27 +1432,103 @@ MlasGemmU8X8PackedOperation<MLAS_GEMM_U8U8_KERNEL_AVX2>(
     const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
     );
 
+#if !defined(MLAS_AMX_UNSUPPORTED)
+
+//
+// The AMX kernel consumes the buffers packed for the AVX2 kernel. The row
+// stride is a multiple of 16, because the tiles of matrix A are always loaded
+// as 16 rows, and the K stride is larger to amortize moving the tiles to
+// matrix C. Blocks of a few rows leave most of a tile unused and run faster
+// with the AVX512VNNI kernel, which reads the same packed buffers.
+//
+
+struct MLAS_GEMM_U8S8_KERNEL_AMX : MLAS_GEMM_U8S8_KERNEL_AVX2
+{
+    static constexpr MLAS_GEMM_U8X8_STRIDES Strides{32, 128, 512};
+    static constexpr MLAS_GEMM_U8X8_STRIDES PackedStrides{64, 256, 1024};
+
+    MLAS_FORCEINLINE
+    static
+    size_t
+    GemmKernel(
+        const PackedAType* A,
+        const PackedBType* B,
+        int32_t* C,
+        size_t PackedCountK,
+        size_t CountM,
+        size_t CountN,
+        size_t ldc,
+        const int32_t* RowSumBuffer,
+        const int32_t* ColumnSumBuffer,
+        int32_t DepthValue,
+        bool ZeroMode
+        )
+    {
+        if (CountM < 8) {
+            return MlasPlatform.GemmU8S8Kernel(A, B, C, PackedCountK, CountM, CountN,
+                ldc, RowSumBuffer, ColumnSumBuffer, DepthValue, ZeroMode);
+        }
+
+        return MlasGemmU8S8KernelAmx(A, B, C, PackedCountK, CountM, CountN,
+            ldc, RowSumBuffer, ColumnSumBuffer, DepthValue, ZeroMode);
+    }
+};
+
+constexpr MLAS_GEMM_U8X8_STRIDES MLAS_GEMM_U8S8_KERNEL_AMX::Strides;
+constexpr MLAS_GEMM_U8X8_STRIDES MLAS_GEMM_U8S8_KERNEL_AMX::PackedStrides;
+
+template
+void
+MlasGemmU8X8Operation<MLAS_GEMM_U8S8_KERNEL_AMX>(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
+    );
+
+template
+void
+MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AMX>(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
+    );
+
 #endif
 
-#ifdef MLAS_TARGET_AMD64_IX86
+#endif
+
+#ifdef MLAS_TARGET_ARM64
 
 void
-MlasGemmU8X8Threaded(
-    void* Context,
-    int32_t ThreadId
+MlasGemmU8X8CopyPackANeon(
+    uint8_t* D,
+    const uint8_t* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK,
+    int32_t* RowSumBuffer
     )
 /*++
 
 Routine Description:
 
-    This routine is invoked from a worker thread to execute a segment of a
-    QGEMM operation.
+    This routine copies elements from the source matrix to the destination
+    packed buffer.
+
+    The packed buffer has the same data ordering as the source bytes, but
+    CountK is aligned up to a multiple of 4 to maintain 32-bit alignment. All
+    extra bytes are zero-padded.
 
 Arguments:
 
-    Context - Supplies the pointer to the context for the threaded operation.
+    D - Supplies the address of the destination packed buffer.
 
-    ThreadId - Supplies the current index of the threaded operation.
+    A - Supplies the address of the source matrix.
+
+    lda - Supplies the number of elements per row of the source matrix.
+
+    CountM - Supplies the number of rows of the source matrix to copy.
+
+    CountK - Supplies the number of columns of the source matrix to copy.
+
+    RowSumBuffer - Supplies the address of the buffer to receive the sums of
+        the elements along each of the rows.
 
 Return Value:
 
@@ -1462,75 +1536,136 @@ Return Value:
 
 --*/
 {
-    MLAS_GEMM_U8X8_WORK_BLOCK WorkBlock;
+    //
+    // Process a single row of matrix A in a loop.
+    //
 
-    memcpy(&WorkBlock, Context, sizeof(MLAS_GEMM_U8X8_WORK_BLOCK));
+    while (CountM > 0) {
 
-    const int32_t ThreadIdM = ThreadId / WorkBlock.ThreadCountN;
-    const int32_t ThreadIdN = ThreadId % WorkBlock.ThreadCountN;
+        const uint8_t* a = A;
+        size_t k = CountK;
+        uint32x4_t RowSums = vmovq_n_u32(0);
 
-    //
-    // Partition the operation along the M dimension.
-    //
+        while (k >= 16) {
 
-    MlasPartitionWork(ThreadIdM, WorkBlock.ThreadCountM, WorkBlock.M,
-        &WorkBlock.RangeStartM, &WorkBlock.RangeCountM);
+            uint8x16_t Bytes = vld1q_u8(a);
+            RowSums = vpadalq_u16(RowSums, vpaddlq_u8(Bytes));
+            vst1q_u8(D, Bytes);
 
-    //
-    // Partition the operation along the N dimension.
-    //
+            D += 16;
+            a += 16;
+            k -= 16;
+        }
 
-    const size_t BlockedN = (WorkBlock.N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
-        MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+        if (k > 0) {
 
-    MlasPartitionWork(ThreadIdN, WorkBlock.ThreadCountN, BlockedN,
-        &WorkBlock.RangeStartN, &WorkBlock.RangeCountN);
+            //
+            // Copy the remaining bytes to the zero padded stack buffer.
+            //
 
-    WorkBlock.RangeStartN *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
-    WorkBlock.RangeCountN *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+            uint8_t PaddedMatrixAData[16] = { 0 };
 
-    WorkBlock.RangeCountN = std::min(WorkBlock.N - WorkBlock.RangeStartN,
-        WorkBlock.RangeCountN);
+            for (size_t kk = 0; kk < k; kk++) {
+                PaddedMatrixAData[kk] = a[kk];
+            }
+
+            uint8x16_t Bytes = vld1q_u8(PaddedMatrixAData);
+            RowSums = vpadalq_u16(RowSums, vpaddlq_u8(Bytes));
+
+            const size_t AlignedCountK = (k + 3) & ~size_t(3);
+
+            for (size_t kk = 0; kk < AlignedCountK; kk++) {
+                D[kk] = PaddedMatrixAData[kk];
+            }
+
+            D += AlignedCountK;
+        }
+
+        *RowSumBuffer++ = int32_t(vaddvq_u32(RowSums));
+
+        A += lda;
+        CountM -= 1;
+    }
+}
 
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8CopyPackBProcessNeon(
+    uint8_t* D,
+    uint8x16_t BytesRow0,
+    uint8x16_t BytesRow1,
+    uint8x16_t BytesRow2,
+    uint8x16_t BytesRow3,
+    uint8x16_t BitFlipVector,
+    uint32x4_t ColumnSums[4]
+    )
+{
     //
-    // Dispatch the partitioned operation.
+    // Interleave the four rows so that each group of 4 bytes holds the values
+    // along the K dimension for one column.
     //
 
-#if defined(MLAS_TARGET_AMD64)
-    PMLAS_GEMM_U8X8_OPERATION GemmU8X8Operation;
+    uint16x8_t BytesRow01Low = vreinterpretq_u16_u8(vzip1q_u8(BytesRow0, BytesRow1));
+    uint16x8_t BytesRow01High = vreinterpretq_u16_u8(vzip2q_u8(BytesRow0, BytesRow1));
+    uint16x8_t BytesRow23Low = vreinterpretq_u16_u8(vzip1q_u8(BytesRow2, BytesRow3));
+    uint16x8_t BytesRow23High = vreinterpretq_u16_u8(vzip2q_u8(BytesRow2, BytesRow3));
 
-    if (WorkBlock.BIsSigned) {
-        GemmU8X8Operation = WorkBlock.BIsPacked ?
-            MlasPlatform.GemmU8S8PackedOperation : MlasPlatform.GemmU8S8Operation;
-    } else {
-        GemmU8X8Operation = WorkBlock.BIsPacked ?
-            MlasPlatform.GemmU8U8PackedOperation : MlasPlatform.GemmU8U8Operation;
-    }
+    uint8x16_t Columns[4];
 
-    GemmU8X8Operation(&WorkBlock);
-#else
-    MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_SSE>(&WorkBlock);
-#endif
+    Columns[0] = vreinterpretq_u8_u16(vzip1q_u16(BytesRow01Low, BytesRow23Low));
+    Columns[1] = vreinterpretq_u8_u16(vzip2q_u16(BytesRow01Low, BytesRow23Low));
+    Columns[2] = vreinterpretq_u8_u16(vzip1q_u16(BytesRow01High, BytesRow23High));
+    Columns[3] = vreinterpretq_u8_u16(vzip2q_u16(BytesRow01High, BytesRow23High));
+
+    for (size_t i = 0; i < 4; i++) {
+
+        Columns[i] = veorq_u8(Columns[i], BitFlipVector);
+
+        vst1q_u8(&D[i * 16], Columns[i]);
+
+        ColumnSums[i] = vpadalq_u16(ColumnSums[i], vpaddlq_u8(Columns[i]));
+    }
 }
 
 void
-MlasGemmU8X8Schedule(
-    MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock,
-    MLAS_THREADPOOL* ThreadPool
+MlasGemmU8X8CopyPackBNeon(
+    uint8_t* D,
+    const uint8_t* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    int32_t* ColumnSumBuffer,
+    bool BIsSigned
     )
 /*++
 
 Routine Description:
 
-    This routine schedules the quantized integer matrix/matrix multiply
-    operation (QGEMM) across one or more threads.
+    This routine copies elements from the source matrix to the destination
+    packed buffer.
+
+    The packed buffer is organized as panels of 16 columns. Each 64-byte row
+    of a panel holds 4 consecutive values along the K dimension for every
+    column of the panel. Signed matrix data is converted to unsigned data by
+    flipping the sign bit. All extra bytes are zero-padded.
 
 Arguments:
 
-    WorkBlock - Supplies the structure containing the GEMM parameters.
+    D - Supplies the address of the destination packed buffer.
 
-    ThreadPool - Supplies the thread pool object to use, else nullptr if the
-        base library threading support should be used.
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    CountN - Supplies the number of columns of the source matrix to copy.
+
+    CountK - Supplies the number of rows of the source matrix to copy.
+
+    ColumnSumBuffer - Supplies the address of the buffer to receive the sums of
+        the elements along each of the columns.
+
+    BIsSigned - Supplies true if the source matrix is signed data, else false
+        if the source matrix is unsigned data.
 
 Return Value:
 
@@ -1538,105 +1673,745 @@ Return Value:
 
 --*/
 {
-    const size_t M = WorkBlock->M;
-    const size_t N = WorkBlock->N;
-    const size_t K = WorkBlock->K;
+    const uint8_t BitFlipValue = (BIsSigned ? 0x80 : 0);
+    const uint8x16_t BitFlipVector = vmovq_n_u8(BitFlipValue);
 
     //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
+    // Process 16 columns of matrix B in a loop.
     //
 
-    const double Complexity = double(M) * double(N) * double(K);
+    while (CountN > 0) {
 
-    int32_t TargetThreadCount;
+        const uint8_t* b = B;
+        size_t k = CountK;
+        uint32x4_t ColumnSums[4];
 
-    if (Complexity < double(MLAS_QGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
-        TargetThreadCount = int32_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
-    } else {
-        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
-    }
+        ColumnSums[0] = vmovq_n_u32(0);
+        ColumnSums[1] = vmovq_n_u32(0);
+        ColumnSums[2] = vmovq_n_u32(0);
+        ColumnSums[3] = vmovq_n_u32(0);
 
-    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+        if (CountN >= 16) {
 
-    if (TargetThreadCount >= MaximumThreadCount) {
-        TargetThreadCount = MaximumThreadCount;
-    }
+            while (k >= 4) {
 
-    //
-    // Segment the operation across multiple threads.
-    //
-    // N.B. Currently, the operation is segmented as a 1D partition, which
-    // works okay for operations involving skinny matrices.
-    //
+                MlasGemmU8X8CopyPackBProcessNeon(D, vld1q_u8(&b[0]), vld1q_u8(&b[ldb]),
+                    vld1q_u8(&b[ldb * 2]), vld1q_u8(&b[ldb * 3]), BitFlipVector,
+                    ColumnSums);
 
-    if (N > M) {
+                D += 64;
+                b += ldb * 4;
+                k -= 4;
+            }
+        }
 
-        const size_t BlockedN = (N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
-            MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+        if (k > 0) {
 
-        if (size_t(TargetThreadCount) > BlockedN) {
-            TargetThreadCount = int32_t(BlockedN);
-        }
+            //
+            // Copy the remaining rows or columns to a stack buffer. The padding
+            // is initialized with the bit flip value so that the padding is
+            // zero after the bit flip.
+            //
 
-        WorkBlock->ThreadCountM = 1;
-        WorkBlock->ThreadCountN = TargetThreadCount;
+            const size_t CountColumns = std::min(CountN, size_t(16));
 
-    } else {
+            do {
 
-        if (size_t(TargetThreadCount) > M) {
-            TargetThreadCount = int32_t(M);
+                MLAS_DECLSPEC_ALIGN(uint8_t PaddedMatrixBData[4][16], 16);
+
+                const size_t CountRows = std::min(k, size_t(4));
+
+                memset(PaddedMatrixBData, BitFlipValue, sizeof(PaddedMatrixBData));
+
+                for (size_t kk = 0; kk < CountRows; kk++) {
+                    memcpy(PaddedMatrixBData[kk], &b[ldb * kk], CountColumns);
+                }
+
+                MlasGemmU8X8CopyPackBProcessNeon(D, vld1q_u8(PaddedMatrixBData[0]),
+                    vld1q_u8(PaddedMatrixBData[1]), vld1q_u8(PaddedMatrixBData[2]),
+                    vld1q_u8(PaddedMatrixBData[3]), BitFlipVector, ColumnSums);
+
+                D += 64;
+                b += ldb * CountRows;
+                k -= CountRows;
+
+            } while (k > 0);
         }
 
-        WorkBlock->ThreadCountM = TargetThreadCount;
-        WorkBlock->ThreadCountN = 1;
-    }
+        vst1q_s32(&ColumnSumBuffer[0], vreinterpretq_s32_u32(ColumnSums[0]));
+        vst1q_s32(&ColumnSumBuffer[4], vreinterpretq_s32_u32(ColumnSums[1]));
+        vst1q_s32(&ColumnSumBuffer[8], vreinterpretq_s32_u32(ColumnSums[2]));
+        vst1q_s32(&ColumnSumBuffer[12], vreinterpretq_s32_u32(ColumnSums[3]));
 
-    MlasExecuteThreaded(MlasGemmU8X8Threaded, WorkBlock, TargetThreadCount, ThreadPool);
+        ColumnSumBuffer += 16;
+        B += 16;
+        CountN -= std::min(CountN, size_t(16));
+    }
 }
 
+template<size_t RowCount>
+MLAS_FORCEINLINE
 void
-MLASCALL
-MlasGemm(
-    size_t M,
-    size_t N,
-    size_t K,
+MlasGemmU8X8ComputeBlockNeon(
     const uint8_t* A,
-    size_t lda,
-    uint8_t offa,
     const uint8_t* B,
-    size_t ldb,
-    uint8_t offb,
-    bool BIsSigned,
     int32_t* C,
+    size_t PackedCountK,
+    size_t CountN,
     size_t ldc,
-    MLAS_THREADPOOL* ThreadPool
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    int32_t DepthValue,
+    bool ZeroMode
     )
 /*++
 
 Routine Description:
 
-    This routine implements the quantized integer matrix/matrix multiply
-    operation (QGEMM).
+    This routine computes a block of RowCount rows by up to 16 columns of
+    matrix C.
+
+    Each accumulator holds the partial sums of two columns: the bytes of a
+    group along the K dimension are multiplied to 16-bit products with UMULL
+    and then pairwise added to 32-bit lanes with UADALP.
 
 Arguments:
 
-    M - Supplies the number of rows of matrix A and matrix C.
+    A - Supplies the address of the packed matrix A.
 
-    N - Supplies the number of columns of matrix B and matrix C.
+    B - Supplies the address of the packed panel of matrix B.
 
-    K - Supplies the number of columns of matrix A and the number of rows of
-        matrix B.
+    C - Supplies the address of matrix C.
 
-    A - Supplies the address of matrix A.
+    PackedCountK - Supplies the number of packed groups along the K dimension.
 
-    lda - Supplies the first dimension of matrix A.
+    CountN - Supplies the number of columns to compute, up to 16.
 
-    offa - Supplies the zero point offset of matrix A.
+    ldc - Supplies the first dimension of matrix C.
 
-    B - Supplies the address of matrix B.
+    RowSumBuffer - Supplies the row sums of matrix A.
 
-    ldb - Supplies the first dimension of matrix B.
+    ColumnSumBuffer - Supplies the column sums of matrix B.
+
+    DepthValue - Supplies the depth value accumulated into every element.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    uint32x4_t Accumulators[RowCount][8];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t i = 0; i < 8; i++) {
+            Accumulators[r][i] = vmovq_n_u32(0);
+        }
+    }
+
+    const size_t lda = PackedCountK * 4;
+
+    for (size_t k = 0; k < PackedCountK; k++) {
+
+        uint8x16_t BElements[4];
+
+        BElements[0] = vld1q_u8(&B[0]);
+        BElements[1] = vld1q_u8(&B[16]);
+        BElements[2] = vld1q_u8(&B[32]);
+        BElements[3] = vld1q_u8(&B[48]);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            const uint8x16_t ABroadcast = vreinterpretq_u8_u32(
+                vld1q_dup_u32(reinterpret_cast<const uint32_t*>(&A[r * lda + k * 4])));
+            const uint8x8_t ABroadcastLow = vget_low_u8(ABroadcast);
+
+            for (size_t i = 0; i < 4; i++) {
+                Accumulators[r][i * 2] = vpadalq_u16(Accumulators[r][i * 2],
+                    vmull_u8(vget_low_u8(BElements[i]), ABroadcastLow));
+                Accumulators[r][i * 2 + 1] = vpadalq_u16(Accumulators[r][i * 2 + 1],
+                    vmull_high_u8(BElements[i], ABroadcast));
+            }
+        }
+
+        B += 64;
+    }
+
+    //
+    // Reduce the accumulators, apply the zero point adjustments and store or
+    // accumulate to matrix C.
+    //
+
+    const int32x4_t DepthVector = vmovq_n_s32(DepthValue);
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        const int32x4_t RowSumVector = vaddq_s32(vld1q_dup_s32(&RowSumBuffer[r]), DepthVector);
+
+        MLAS_DECLSPEC_ALIGN(int32_t Output[16], 16);
+
+        for (size_t i = 0; i < 4; i++) {
+
+            int32x4_t Result = vreinterpretq_s32_u32(
+                vpaddq_u32(Accumulators[r][i * 2], Accumulators[r][i * 2 + 1]));
+
+            Result = vaddq_s32(Result, RowSumVector);
+            Result = vaddq_s32(Result, vld1q_s32(&ColumnSumBuffer[i * 4]));
+
+            vst1q_s32(&Output[i * 4], Result);
+        }
+
+        int32_t* c = C + r * ldc;
+
+        if (ZeroMode) {
+            for (size_t n = 0; n < CountN; n++) {
+                c[n] = Output[n];
+            }
+        } else {
+            for (size_t n = 0; n < CountN; n++) {
+                c[n] += Output[n];
+            }
+        }
+    }
+}
+
+size_t
+MlasGemmU8X8KernelNeon(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been packed
+        using MlasGemmU8X8CopyPackANeon.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasGemmU8X8CopyPackBNeon.
+
+    C - Supplies the address of matrix C.
+
+    PackedCountK - Supplies the number of packed columns from matrix A and
+        the number of packed rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumBuffer - Supplies the sum of each row from matrix A multiplied by the
+        zero point offset of matrix B. These values are accumulated into every
+        row of matrix C.
+
+    ColumnSumBuffer - Supplies the sum of each column from matrix B multiplied
+        by the zero point offset of matrix A. These values are accumulated into
+        every column of matrix C.
+
+    DepthValue - Supplies the value CountK multiplied by the zero point offset
+        of matrix A multplied by the zero point offset of matrix B. This value is
+        accumulated into every element of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    const size_t RowsHandled = (CountM >= 2) ? 2 : 1;
+
+    for (size_t n = 0; n < CountN; n += 16) {
+
+        const size_t CountBlockN = std::min(CountN - n, size_t(16));
+
+        if (RowsHandled == 2) {
+            MlasGemmU8X8ComputeBlockNeon<2>(A, B, C + n, PackedCountK, CountBlockN,
+                ldc, RowSumBuffer, ColumnSumBuffer + n, DepthValue, ZeroMode);
+        } else {
+            MlasGemmU8X8ComputeBlockNeon<1>(A, B, C + n, PackedCountK, CountBlockN,
+                ldc, RowSumBuffer, ColumnSumBuffer + n, DepthValue, ZeroMode);
+        }
+
+        B += PackedCountK * 64;
+    }
+
+    return RowsHandled;
+}
+
+void
+MlasGemmU8X8OutputFloatNeon(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock,
+    int32_t* C,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the output matrix to floating point by applying the
+    scale multiplier and the optional bias vector.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    C - Supplies the address of matrix C.
+
+    StartN - Supplies the starting column offset relative to the base of the
+        work block. This is used to offset into column vectors accessed via the
+        work block.
+
+    CountM - Supplies the number of rows of the output matrix to process.
+
+    CountN - Supplies the number of columns of the output matrix to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t ldc = WorkBlock->ldc;
+    const float Scale = *WorkBlock->Scale;
+    const float32x4_t ScaleVector = vmovq_n_f32(Scale);
+
+    const float* BiasFloat = WorkBlock->BiasFloat;
+
+    if (BiasFloat != nullptr) {
+        BiasFloat += WorkBlock->RangeStartN + StartN;
+    }
+
+    while (CountM-- > 0) {
+
+        int32_t* c = C;
+        float* cf = reinterpret_cast<float*>(C);
+        size_t n = 0;
+
+        for (; n + 4 <= CountN; n += 4) {
+
+            float32x4_t FloatVector = vmulq_f32(vcvtq_f32_s32(vld1q_s32(&c[n])), ScaleVector);
+
+            if (BiasFloat != nullptr) {
+                FloatVector = vaddq_f32(FloatVector, vld1q_f32(&BiasFloat[n]));
+            }
+
+            vst1q_f32(&cf[n], FloatVector);
+        }
+
+        for (; n < CountN; n++) {
+
+            float FloatValue = float(c[n]) * Scale;
+
+            if (BiasFloat != nullptr) {
+                FloatValue += BiasFloat[n];
+            }
+
+            cf[n] = FloatValue;
+        }
+
+        C += ldc;
+    }
+}
+
+struct MLAS_GEMM_U8X8_KERNEL_NEON
+{
+    typedef uint8_t PackedAType;
+    typedef uint8_t PackedBType;
+    typedef uint8_t OffsetBType;
+
+    static constexpr size_t PackedK = 4;
+    static constexpr MLAS_GEMM_U8X8_STRIDES Strides{24, 128, 256};
+    static constexpr MLAS_GEMM_U8X8_STRIDES PackedStrides{24, 128, 384};
+
+    MLAS_FORCEINLINE
+    static
+    bool
+    TryGemvKernel(
+        const uint8_t* A,
+        const uint8_t* B,
+        size_t ldb,
+        int32_t* C,
+        size_t CountK,
+        size_t CountN,
+        bool BIsSigned
+        )
+    {
+        MLAS_UNREFERENCED_PARAMETER(A);
+        MLAS_UNREFERENCED_PARAMETER(B);
+        MLAS_UNREFERENCED_PARAMETER(ldb);
+        MLAS_UNREFERENCED_PARAMETER(C);
+        MLAS_UNREFERENCED_PARAMETER(CountK);
+        MLAS_UNREFERENCED_PARAMETER(CountN);
+        MLAS_UNREFERENCED_PARAMETER(BIsSigned);
+
+        return false;
+    }
+
+    MLAS_FORCEINLINE
+    static
+    void
+    CopyPackA(
+        PackedAType* D,
+        const uint8_t* A,
+        size_t lda,
+        size_t CountM,
+        size_t CountK,
+        int32_t* RowSumBuffer
+        )
+    {
+        MlasGemmU8X8CopyPackANeon(D, A, lda, CountM, CountK, RowSumBuffer);
+    }
+
+    MLAS_FORCEINLINE
+    static
+    void
+    CopyPackB(
+        PackedBType* D,
+        const uint8_t* B,
+        size_t ldb,
+        size_t CountN,
+        size_t CountK,
+        int32_t* ColumnSumBuffer,
+        bool BIsSigned
+        )
+    {
+        MlasGemmU8X8CopyPackBNeon(D, B, ldb, CountN, CountK, ColumnSumBuffer,
+            BIsSigned);
+    }
+
+    MLAS_FORCEINLINE
+    static
+    size_t
+    GemmKernel(
+        const PackedAType* A,
+        const PackedBType* B,
+        int32_t* C,
+        size_t PackedCountK,
+        size_t CountM,
+        size_t CountN,
+        size_t ldc,
+        const int32_t* RowSumBuffer,
+        const int32_t* ColumnSumBuffer,
+        int32_t DepthValue,
+        bool ZeroMode
+        )
+    {
+        return MlasGemmU8X8KernelNeon(A, B, C, PackedCountK, CountM, CountN, ldc,
+            RowSumBuffer, ColumnSumBuffer, DepthValue, ZeroMode);
+    }
+
+    MLAS_FORCEINLINE
+    static
+    void
+    OutputFloat(
+        const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock,
+        int32_t* C,
+        size_t StartN,
+        size_t CountM,
+        size_t CountN
+        )
+    {
+        MlasGemmU8X8OutputFloatNeon(WorkBlock, C, StartN, CountM, CountN);
+    }
+};
+
+constexpr size_t MLAS_GEMM_U8X8_KERNEL_NEON::PackedK;
+constexpr MLAS_GEMM_U8X8_STRIDES MLAS_GEMM_U8X8_KERNEL_NEON::Strides;
+constexpr MLAS_GEMM_U8X8_STRIDES MLAS_GEMM_U8X8_KERNEL_NEON::PackedStrides;
+
+template
+void
+MLASCALL
+MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_NEON>(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
+    );
+
+template
+void
+MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_NEON>(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
+    );
+
+#if !defined(MLAS_UDOT_UNSUPPORTED)
+
+//
+// The UDOT kernel consumes the buffers packed for the NEON kernel and
+// processes up to four rows per iteration.
+//
+
+struct MLAS_GEMM_U8X8_KERNEL_UDOT : MLAS_GEMM_U8X8_KERNEL_NEON
+{
+    MLAS_FORCEINLINE
+    static
+    size_t
+    GemmKernel(
+        const PackedAType* A,
+        const PackedBType* B,
+        int32_t* C,
+        size_t PackedCountK,
+        size_t CountM,
+        size_t CountN,
+        size_t ldc,
+        const int32_t* RowSumBuffer,
+        const int32_t* ColumnSumBuffer,
+        int32_t DepthValue,
+        bool ZeroMode
+        )
+    {
+        return MlasGemmU8X8KernelUdot(A, B, C, PackedCountK, CountM, CountN, ldc,
+            RowSumBuffer, ColumnSumBuffer, DepthValue, ZeroMode);
+    }
+};
+
+template
+void
+MLASCALL
+MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_UDOT>(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
+    );
+
+template
+void
+MlasGemmU8X8PackedOperation<MLAS_GEMM_U8X8_KERNEL_UDOT>(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock
+    );
+
+#endif
+
+#endif
+
+#if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_ARM64)
+
+void
+MlasGemmU8X8Threaded(
+    void* Context,
+    int32_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    QGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_GEMM_U8X8_WORK_BLOCK WorkBlock;
+
+    memcpy(&WorkBlock, Context, sizeof(MLAS_GEMM_U8X8_WORK_BLOCK));
+
+    const int32_t ThreadIdM = ThreadId / WorkBlock.ThreadCountN;
+    const int32_t ThreadIdN = ThreadId % WorkBlock.ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    MlasPartitionWork(ThreadIdM, WorkBlock.ThreadCountM, WorkBlock.M,
+        &WorkBlock.RangeStartM, &WorkBlock.RangeCountM);
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    const size_t BlockedN = (WorkBlock.N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock.ThreadCountN, BlockedN,
+        &WorkBlock.RangeStartN, &WorkBlock.RangeCountN);
+
+    WorkBlock.RangeStartN *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+    WorkBlock.RangeCountN *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+
+    WorkBlock.RangeCountN = std::min(WorkBlock.N - WorkBlock.RangeStartN,
+        WorkBlock.RangeCountN);
+
+    //
+    // Dispatch the partitioned operation.
+    //
+
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_GEMM_U8X8_OPERATION GemmU8X8Operation;
+
+    if (WorkBlock.BIsSigned) {
+        GemmU8X8Operation = WorkBlock.BIsPacked ?
+            MlasPlatform.GemmU8S8PackedOperation : MlasPlatform.GemmU8S8Operation;
+    } else {
+        GemmU8X8Operation = WorkBlock.BIsPacked ?
+            MlasPlatform.GemmU8U8PackedOperation : MlasPlatform.GemmU8U8Operation;
+    }
+
+    GemmU8X8Operation(&WorkBlock);
+#elif defined(MLAS_TARGET_ARM64)
+    PMLAS_GEMM_U8X8_OPERATION GemmU8X8Operation = WorkBlock.BIsPacked ?
+        MlasPlatform.GemmU8X8PackedOperation : MlasPlatform.GemmU8X8Operation;
+
+    GemmU8X8Operation(&WorkBlock);
+#else
+    MlasGemmU8X8Operation<MLAS_GEMM_U8X8_KERNEL_SSE>(&WorkBlock);
+#endif
+}
+
+void
+MlasGemmU8X8Schedule(
+    MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine schedules the quantized integer matrix/matrix multiply
+    operation (QGEMM) across one or more threads.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+    const size_t K = WorkBlock->K;
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_QGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads.
+    //
+    // N.B. Currently, the operation is segmented as a 1D partition, which
+    // works okay for operations involving skinny matrices.
+    //
+
+    if (N > M) {
+
+        const size_t BlockedN = (N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(TargetThreadCount) > BlockedN) {
+            TargetThreadCount = int32_t(BlockedN);
+        }
+
+        WorkBlock->ThreadCountM = 1;
+        WorkBlock->ThreadCountN = TargetThreadCount;
+
+    } else {
+
+        if (size_t(TargetThreadCount) > M) {
+            TargetThreadCount = int32_t(M);
+        }
+
+        WorkBlock->ThreadCountM = TargetThreadCount;
+        WorkBlock->ThreadCountN = 1;
+    }
+
+    MlasExecuteThreaded(MlasGemmU8X8Threaded, WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    bool BIsSigned,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
 
     offb - Supplies the zero point offset of matrix B.
 
@@ -1787,7 +2562,7 @@ Return Value:
 
 #endif
 
-#ifdef MLAS_TARGET_AMD64
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
 
 void
 MLASCALL
@@ -2006,6 +2781,7 @@ Return Value:
     // Retrieve the address of the packed operation function for the platform.
     //
 
+#if defined(MLAS_TARGET_AMD64)
     PMLAS_GEMM_U8X8_OPERATION GemmU8X8Operation = BIsSigned ?
         MlasPlatform.GemmU8S8PackedOperation : MlasPlatform.GemmU8U8PackedOperation;
 
@@ -2019,9 +2795,22 @@ Return Value:
         PackedK = MLAS_GEMM_U8S8_KERNEL_AVX2::PackedK;
     } else if (GemmU8X8Operation == &MlasGemmU8X8PackedOperation<MLAS_GEMM_U8U8_KERNEL_AVX2>) {
         PackedK = MLAS_GEMM_U8U8_KERNEL_AVX2::PackedK;
+#if !defined(MLAS_AMX_UNSUPPORTED)
+    } else if (GemmU8X8Operation == &MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AMX>) {
+        PackedK = MLAS_GEMM_U8S8_KERNEL_AMX::PackedK;
+#endif
     } else {
         return 0;
     }
+#else
+    MLAS_UNREFERENCED_PARAMETER(BIsSigned);
+
+    //
+    // All ARM64 kernels share the packed format of the NEON kernel.
+    //
+
+    const size_t PackedK = MLAS_GEMM_U8X8_KERNEL_NEON::PackedK;
+#endif
 
     //
     // Compute the number of bytes required to hold the packed buffer.
@@ -2082,6 +2871,7 @@ Return Value:
     // Retrieve the address of the packed operation function for the platform.
     //
 
+#if defined(MLAS_TARGET_AMD64)
     PMLAS_GEMM_U8X8_OPERATION GemmU8X8Operation = BIsSigned ?
         MlasPlatform.GemmU8S8PackedOperation : MlasPlatform.GemmU8U8PackedOperation;
 
@@ -2098,9 +2888,18 @@ Return Value:
     } else if (GemmU8X8Operation == &MlasGemmU8X8PackedOperation<MLAS_GEMM_U8U8_KERNEL_AVX2>) {
         PackedK = MLAS_GEMM_U8U8_KERNEL_AVX2::PackedK;
         StrideK = MLAS_GEMM_U8U8_KERNEL_AVX2::PackedStrides.K;
+#if !defined(MLAS_AMX_UNSUPPORTED)
+    } else if (GemmU8X8Operation == &MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AMX>) {
+        PackedK = MLAS_GEMM_U8S8_KERNEL_AMX::PackedK;
+        StrideK = MLAS_GEMM_U8S8_KERNEL_AMX::PackedStrides.K;
+#endif
     } else {
         throw std::runtime_error("packing unavailable");
     }
+#else
+    const size_t PackedK = MLAS_GEMM_U8X8_KERNEL_NEON::PackedK;
+    const size_t StrideK = MLAS_GEMM_U8X8_KERNEL_NEON::PackedStrides.K;
+#endif
 
     //
     // Reserve and initialize storage for the column sum buffer to hold the sums
@@ -2139,11 +2938,15 @@ Return Value:
 
             CountN = (std::min)(N - n, BatchedN);
 
-            if (GemmU8X8Operation == &MlasGemmU8X8PackedOperation<MLAS_GEMM_U8S8_KERNEL_AVX2>) {
-                MLAS_GEMM_U8S8_KERNEL_AVX2::CopyPackB(pb, B + n, ldb, CountN, CountK, ColumnSumBuffer, BIsSigned);
-            } else {
+#if defined(MLAS_TARGET_AMD64)
+            if (GemmU8X8Operation == &MlasGemmU8X8PackedOperation<MLAS_GEMM_U8U8_KERNEL_AVX2>) {
                 MLAS_GEMM_U8U8_KERNEL_AVX2::CopyPackB(pb, B + n, ldb, CountN, CountK, ColumnSumBuffer, BIsSigned);
+            } else {
+                MLAS_GEMM_U8S8_KERNEL_AVX2::CopyPackB(pb, B + n, ldb, CountN, CountK, ColumnSumBuffer, BIsSigned);
             }
+#else
+            MLAS_GEMM_U8X8_KERNEL_NEON::CopyPackB(pb, B + n, ldb, CountN, CountK, ColumnSumBuffer, BIsSigned);
+#endif
 
             //
             // Accumulate this batch of the column sum buffer into the packed
@@ -328,15 +328,16 @@ MlasRequantizeOutputVector(
     return IntegerVector;
 }
 
+template<bool PerColumnScale>
 void
-MLASCALL
-MlasRequantizeOutput(
+MlasRequantizeOutputImpl(
     const int32_t* Input,
     uint8_t* Output,
     const int32_t* Bias,
     size_t M,
     size_t N,
-    float Scale,
+    const float* Scale,
+    size_t RowScaleStride,
     uint8_t ZeroPoint
     )
 /*++
@@ -355,14 +356,17 @@ Arguments:
     Bias - Supplies the optional bias vector to be added to the input buffer
         before requantization.
 
-    Buffer - Supplies the output matrix.
-
     M - Supplies the number of elements of the bias vector and the number of
         rows in the output matrix.
 
     N - Supplies the number of columns of the output matrix.
 
-    Scale - Supplies the quantization scale.
+    Scale - Supplies the quantization scales. If PerColumnScale is true, this
+        is a vector of N scales. Otherwise the scale of each row is read from
+        this pointer, which is advanced by RowScaleStride after each row.
+
+    RowScaleStride - Supplies the number of elements to advance the scale
+        pointer by after each row: 0 for a single scale, 1 for a scale per row.
 
     ZeroPoint - Supplies the quantization zero point value.
 
@@ -372,7 +376,6 @@ Return Value:
 
 --*/
 {
-    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
     MLAS_FLOAT32X4 MinimumValueVector = MlasBroadcastFloat32x4(float(0 - ZeroPoint));
     MLAS_FLOAT32X4 MaximumValueVector = MlasBroadcastFloat32x4(float(255 - ZeroPoint));
     MLAS_INT32X4 ZeroPointVector = MlasBroadcastInt32x4(ZeroPoint);
@@ -388,10 +391,18 @@ Return Value:
             BiasVector = MlasBroadcastInt32x4(*Bias++);
         }
 
+        MLAS_FLOAT32X4 ScaleVector = PerColumnScale ? MlasZeroFloat32x4() : MlasBroadcastFloat32x4(*Scale);
+        const float* ColumnScale = Scale;
+
         size_t n = N;
 
         while (n >= 4) {
 
+            if (PerColumnScale) {
+                ScaleVector = MlasLoadFloat32x4(ColumnScale);
+                ColumnScale += 4;
+            }
+
             MLAS_INT32X4 IntegerVector = _mm_loadu_si128((const __m128i *)Input);
             IntegerVector = MlasRequantizeOutputVector(IntegerVector, BiasVector,
                 ScaleVector, MinimumValueVector, MaximumValueVector, ZeroPointVector);
@@ -408,6 +419,10 @@ Return Value:
 
         while (n > 0) {
 
+            if (PerColumnScale) {
+                ScaleVector = MlasBroadcastFloat32x4(*ColumnScale++);
+            }
+
             MLAS_INT32X4 IntegerVector = _mm_cvtsi32_si128(*Input);
             IntegerVector = MlasRequantizeOutputVector(IntegerVector, BiasVector,
                 ScaleVector, MinimumValueVector, MaximumValueVector, ZeroPointVector);
@@ -418,6 +433,109 @@ Return Value:
             Output += 1;
             n -= 1;
         }
+
+        Scale += RowScaleStride;
+    }
+}
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes the intermediate buffer to the output buffer
+    optionally adding the supplied bias.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    Output - Supplies the output matrix.
+
+    Bias - Supplies the optional bias vector to be added to the input buffer
+        before requantization.
+
+    M - Supplies the number of elements of the bias vector and the number of
+        rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasRequantizeOutputImpl<false>(Input, Output, Bias, M, N, &Scale, 0, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    const float* Scale,
+    bool PerColumnScale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes the intermediate buffer to the output buffer
+    optionally adding the supplied bias, using a quantization scale per row
+    or per column of the output matrix, such as for weights quantized per
+    output channel.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    Output - Supplies the output matrix.
+
+    Bias - Supplies the optional bias vector to be added to the input buffer
+        before requantization.
+
+    M - Supplies the number of elements of the bias vector and the number of
+        rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    Scale - Supplies the quantization scales: N elements if PerColumnScale is
+        true, else M elements.
+
+    PerColumnScale - Supplies true if the scales apply to the columns of the
+        output matrix, else they apply to its rows.
+
+    ZeroPoint - Supplies the quantization zero point value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (PerColumnScale) {
+        MlasRequantizeOutputImpl<true>(Input, Output, Bias, M, N, Scale, 0, ZeroPoint);
+    } else {
+        MlasRequantizeOutputImpl<false>(Input, Output, Bias, M, N, Scale, 1, ZeroPoint);
     }
 }
 
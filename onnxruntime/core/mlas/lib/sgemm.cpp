@@ -40,15 +40,47 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    const void* PackedB;
+    size_t PackedAlignedN;
     struct SEGMENT {
         size_t M;
         size_t N;
+        size_t StartN;
         const float* A;
         const float* B;
         float* C;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
+//
+// Define the parameters to execute a batch of SGEMM operations on worker
+// threads.
+//
+
+struct MLAS_SGEMM_BATCH_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    const float* A;
+    size_t lda;
+    size_t StrideA;
+    const float* B;
+    size_t ldb;
+    size_t StrideB;
+    float* C;
+    size_t ldc;
+    size_t StrideC;
+    float alpha;
+    float beta;
+    size_t BatchCount;
+    size_t BatchPerThread;
+    size_t SegmentsPerGemm;
+    size_t SegmentM;
+    size_t SegmentN;
+};
+
 void
 MlasSgemmMultiplyBeta(
     float* C,
@@ -1073,6 +1105,162 @@ Return Value:
     }
 }
 
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with matrix B packed by MlasGemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column from packed matrix B. This value
+        must be a multiple of MLAS_SGEMM_STRIDEN_THREAD_ALIGN.
+
+    RangeCountN - Supplies the number of columns from packed matrix B and
+        matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    AlignedN - Supplies the total number of columns of packed matrix B aligned
+        to MLAS_SGEMM_STRIDEN_THREAD_ALIGN.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C, offset to column RangeStartN.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        const size_t SliceStartN = RangeStartN + n;
+
+        CountN = RangeCountN - n;
+
+        if (CountN > MLAS_SGEMM_PACKED_STRIDEN) {
+            CountN = MLAS_SGEMM_PACKED_STRIDEN;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        bool ZeroMode = (beta == 0.0f);
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = K - k;
+
+            if (CountK > MLAS_SGEMM_PACKED_STRIDEK) {
+                CountK = MLAS_SGEMM_PACKED_STRIDEK;
+            }
+
+            //
+            // Each slice of packed matrix B along the K dimension holds the
+            // panels for all of the columns, so locate the panel of this
+            // slice along the N dimension.
+            //
+
+            const float* pb = (const float*)PackedB + AlignedN * k + CountK * SliceStartN;
+
+            //
+            // Step through each slice of matrix A along the M dimension.
+            //
+
+            float* c = C + n;
+
+            if (TransA == CblasNoTrans) {
+
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+
+            } else {
+
+                const float* a = A + k * lda;
+                size_t RowsRemaining = M;
+
+                do {
+
+                    //
+                    // Transpose elements from matrix A into a local buffer.
+                    //
+
+                    size_t RowsTransposed = RowsRemaining;
+
+                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+                    }
+
+                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+                    RowsRemaining -= RowsTransposed;
+                    a += RowsTransposed;
+
+                    //
+                    // Step through the rows of the local buffer.
+                    //
+
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+
+                } while (RowsRemaining > 0);
+            }
+
+            ZeroMode = false;
+        }
+    }
+}
+
 void
 MlasSgemmOperationThreaded(
     void* Context,
@@ -1101,6 +1289,14 @@ Return Value:
 
     MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
 
+    if (WorkBlock->PackedB != nullptr) {
+        MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M, Segment->StartN,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            WorkBlock->PackedB, WorkBlock->PackedAlignedN, WorkBlock->beta,
+            Segment->C, WorkBlock->ldc);
+        return;
+    }
+
     MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
         Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
         Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
@@ -1120,6 +1316,7 @@ MlasSgemmTryMultithread(
     size_t lda,
     const float* B,
     size_t ldb,
+    const void* PackedB,
     float beta,
     float* C,
     size_t ldc,
@@ -1155,6 +1352,9 @@ Arguments:
 
     ldb - Supplies the first dimension of matrix B.
 
+    PackedB - Supplies the address of matrix B packed by MlasGemmPackB, else
+        nullptr if matrix B is supplied by B and ldb.
+
     beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
     C - Supplies the address of matrix C.
@@ -1209,6 +1409,9 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.PackedB = PackedB;
+    WorkBlock.PackedAlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
 
     //
     // Segment the operation across multiple threads.
@@ -1239,8 +1442,9 @@ Return Value:
 
             WorkBlock.Segments[Index].M = M;
             WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].StartN = n;
             WorkBlock.Segments[Index].A = A;
-            WorkBlock.Segments[Index].B = B + n * pldb;
+            WorkBlock.Segments[Index].B = (PackedB != nullptr) ? nullptr : B + n * pldb;
             WorkBlock.Segments[Index].C = C + n;
 
             Index++;
@@ -1266,6 +1470,7 @@ Return Value:
 
             WorkBlock.Segments[Index].M = CountM;
             WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].StartN = 0;
             WorkBlock.Segments[Index].A = A + m * plda;
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
@@ -1347,7 +1552,447 @@ Return Value:
     // single thread based on the GEMM parameters and system configuration.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool)) {
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, nullptr, beta, C, ldc, ThreadPool)) {
         MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
     }
 }
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with matrix B packed by MlasGemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
+    //
+
+    if (!MlasSgemmTryMultithread(TransA, CblasNoTrans, M, N, K, alpha, A, lda, nullptr, 0, PackedB, beta, C, ldc, ThreadPool)) {
+
+        const size_t AlignedN =
+            (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        MlasSgemmPackedOperation(TransA, M, 0, N, K, alpha, A, lda, PackedB, AlignedN, beta, C, ldc);
+    }
+}
+
+void
+MlasSgemmBatchOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    batched SGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SGEMM_BATCH_WORK_BLOCK* WorkBlock = (const MLAS_SGEMM_BATCH_WORK_BLOCK*)Context;
+
+    //
+    // Each thread computes a range of complete matrices from the batch when the
+    // batch supplies enough work for the threads. Otherwise, each matrix is
+    // partitioned into segments along the M or N dimension.
+    //
+
+    if (WorkBlock->SegmentsPerGemm == 1) {
+
+        size_t BatchStart = size_t(Index) * WorkBlock->BatchPerThread;
+        size_t BatchEnd = std::min(BatchStart + WorkBlock->BatchPerThread, WorkBlock->BatchCount);
+
+        for (size_t b = BatchStart; b < BatchEnd; b++) {
+            MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, WorkBlock->M,
+                WorkBlock->N, WorkBlock->K, WorkBlock->alpha,
+                WorkBlock->A + b * WorkBlock->StrideA, WorkBlock->lda,
+                WorkBlock->B + b * WorkBlock->StrideB, WorkBlock->ldb, WorkBlock->beta,
+                WorkBlock->C + b * WorkBlock->StrideC, WorkBlock->ldc);
+        }
+
+        return;
+    }
+
+    const size_t b = size_t(Index) / WorkBlock->SegmentsPerGemm;
+    const size_t Segment = size_t(Index) % WorkBlock->SegmentsPerGemm;
+
+    const float* A = WorkBlock->A + b * WorkBlock->StrideA;
+    const float* B = WorkBlock->B + b * WorkBlock->StrideB;
+    float* C = WorkBlock->C + b * WorkBlock->StrideC;
+
+    if (WorkBlock->SegmentN != 0) {
+
+        const size_t n = Segment * WorkBlock->SegmentN;
+        const size_t CountN = std::min(WorkBlock->SegmentN, WorkBlock->N - n);
+        const size_t pldb = (WorkBlock->TransB == CblasNoTrans) ? 1 : WorkBlock->ldb;
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, WorkBlock->M,
+            CountN, WorkBlock->K, WorkBlock->alpha, A, WorkBlock->lda,
+            B + n * pldb, WorkBlock->ldb, WorkBlock->beta, C + n, WorkBlock->ldc);
+
+    } else {
+
+        const size_t m = Segment * WorkBlock->SegmentM;
+        const size_t CountM = std::min(WorkBlock->SegmentM, WorkBlock->M - m);
+        const size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, CountM,
+            WorkBlock->N, WorkBlock->K, WorkBlock->alpha, A + m * plda,
+            WorkBlock->lda, B, WorkBlock->ldb, WorkBlock->beta,
+            C + m * WorkBlock->ldc, WorkBlock->ldc);
+    }
+}
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of single precision matrix/matrix multiply
+    operations (SGEMM) where the matrices of each batch entry are at a fixed
+    stride from the matrices of the previous entry.
+
+    Small matrices such as the per head products of an attention layer are
+    distributed to the threads as a single parallel operation, instead of
+    issuing a threaded operation per matrix.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    StrideA - Supplies the number of elements between consecutive matrices A.
+
+    B - Supplies the address of the first matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    StrideB - Supplies the number of elements between consecutive matrices B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of the first matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    StrideC - Supplies the number of elements between consecutive matrices C.
+
+    BatchCount - Supplies the number of matrix multiplications.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+    int32_t TargetThreadCount;
+
+    if (BatchCount == 0 || M == 0 || N == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the whole
+    // batch. Small requests should run using the single threaded path.
+    //
+
+    double Complexity = double(M) * double(N) * double(K) * double(BatchCount);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+
+        for (size_t b = 0; b < BatchCount; b++) {
+            MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A + b * StrideA,
+                lda, B + b * StrideB, ldb, beta, C + b * StrideC, ldc);
+        }
+
+        return;
+    }
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.StrideA = StrideA;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.StrideB = StrideB;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.StrideC = StrideC;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.BatchCount = BatchCount;
+    WorkBlock.SegmentM = 0;
+    WorkBlock.SegmentN = 0;
+
+    int32_t Iterations;
+
+    if (BatchCount >= size_t(TargetThreadCount)) {
+
+        //
+        // Distribute ranges of complete matrices to the threads.
+        //
+
+        WorkBlock.SegmentsPerGemm = 1;
+        WorkBlock.BatchPerThread = (BatchCount + TargetThreadCount - 1) / TargetThreadCount;
+
+        Iterations = int32_t((BatchCount + WorkBlock.BatchPerThread - 1) / WorkBlock.BatchPerThread);
+
+    } else {
+
+        //
+        // Partition each matrix into segments along the larger of the M and N
+        // dimensions, as done for a single SGEMM operation.
+        //
+
+        const size_t ThreadsPerGemm = size_t(TargetThreadCount) / BatchCount;
+
+        if (N > M) {
+
+            size_t SegmentN = (N + ThreadsPerGemm - 1) / ThreadsPerGemm;
+
+            SegmentN =
+                (SegmentN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+            WorkBlock.SegmentN = SegmentN;
+            WorkBlock.SegmentsPerGemm = (N + SegmentN - 1) / SegmentN;
+
+        } else {
+
+            size_t SegmentM = (M + ThreadsPerGemm - 1) / ThreadsPerGemm;
+
+            WorkBlock.SegmentM = SegmentM;
+            WorkBlock.SegmentsPerGemm = (M + SegmentM - 1) / SegmentM;
+        }
+
+        WorkBlock.BatchPerThread = 1;
+
+        Iterations = int32_t(BatchCount * WorkBlock.SegmentsPerGemm);
+    }
+
+    MlasExecuteThreaded(MlasSgemmBatchOperationThreaded, &WorkBlock, Iterations, ThreadPool);
+}
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed matrix B buffer.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the number of bytes required to pack the matrix.
+
+--*/
+{
+    //
+    // Compute the number of bytes required to hold the packed buffer.
+    //
+
+    const size_t AlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    const size_t BytesRequired = AlignedN * K * sizeof(float);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired = (BytesRequired + BufferAlignment - 1) &
+        ~(BufferAlignment - 1);
+
+    return AlignedBytesRequired;
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the supplied matrix B to the supplied packed matrix B
+    buffer. The size of the packed buffer was obtained from MlasGemmPackBSize.
+
+    The packed buffer is organized as slices of MLAS_SGEMM_PACKED_STRIDEK rows
+    along the K dimension. Each slice holds the panels of 16 columns produced
+    by MlasSgemmCopyPackB or MlasSgemmTransposePackB for all of the columns.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = K - k;
+
+        if (CountK > MLAS_SGEMM_PACKED_STRIDEK) {
+            CountK = MLAS_SGEMM_PACKED_STRIDEK;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB((float*)PackedB, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB((float*)PackedB, B + k, ldb, N, CountK);
+        }
+
+        PackedB = (float*)PackedB + AlignedN * CountK;
+    }
+}
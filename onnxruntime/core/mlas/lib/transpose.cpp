@@ -0,0 +1,403 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transpose.cpp
+
+Abstract:
+
+    This module implements the transpose operation.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows of the input matrix that are transposed together
+// so that the input cache lines are reused by the following column panels.
+//
+
+#define MLAS_TRANSPOSE_ROW_BLOCK 64
+
+template<typename ElementType, size_t TileSize>
+MLAS_FORCEINLINE
+void
+MlasTransposeTileGeneric(
+    const ElementType* Input,
+    size_t ldInput,
+    ElementType* Output,
+    size_t ldOutput
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a square tile of elements without using vector
+    instructions.
+
+Arguments:
+
+    Input - Supplies the input tile.
+
+    ldInput - Supplies the number of elements between rows of the input tile.
+
+    Output - Supplies the output tile.
+
+    ldOutput - Supplies the number of elements between rows of the output tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t i = 0; i < TileSize; i++) {
+        for (size_t j = 0; j < TileSize; j++) {
+            Output[j * ldOutput + i] = Input[i * ldInput + j];
+        }
+    }
+}
+
+template<typename ElementType>
+struct MLAS_TRANSPOSE_TILE;
+
+template<>
+struct MLAS_TRANSPOSE_TILE<uint8_t>
+{
+    static constexpr size_t TileSize = 8;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint8_t* Input,
+        size_t ldInput,
+        uint8_t* Output,
+        size_t ldOutput
+        )
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+
+        __m128i a0 = _mm_loadl_epi64((const __m128i*)&Input[ldInput * 0]);
+        __m128i a1 = _mm_loadl_epi64((const __m128i*)&Input[ldInput * 1]);
+        __m128i a2 = _mm_loadl_epi64((const __m128i*)&Input[ldInput * 2]);
+        __m128i a3 = _mm_loadl_epi64((const __m128i*)&Input[ldInput * 3]);
+        __m128i a4 = _mm_loadl_epi64((const __m128i*)&Input[ldInput * 4]);
+        __m128i a5 = _mm_loadl_epi64((const __m128i*)&Input[ldInput * 5]);
+        __m128i a6 = _mm_loadl_epi64((const __m128i*)&Input[ldInput * 6]);
+        __m128i a7 = _mm_loadl_epi64((const __m128i*)&Input[ldInput * 7]);
+
+        __m128i b0 = _mm_unpacklo_epi8(a0, a1);
+        __m128i b1 = _mm_unpacklo_epi8(a2, a3);
+        __m128i b2 = _mm_unpacklo_epi8(a4, a5);
+        __m128i b3 = _mm_unpacklo_epi8(a6, a7);
+
+        __m128i c0 = _mm_unpacklo_epi16(b0, b1);
+        __m128i c1 = _mm_unpackhi_epi16(b0, b1);
+        __m128i c2 = _mm_unpacklo_epi16(b2, b3);
+        __m128i c3 = _mm_unpackhi_epi16(b2, b3);
+
+        __m128i d0 = _mm_unpacklo_epi32(c0, c2);
+        __m128i d1 = _mm_unpackhi_epi32(c0, c2);
+        __m128i d2 = _mm_unpacklo_epi32(c1, c3);
+        __m128i d3 = _mm_unpackhi_epi32(c1, c3);
+
+        _mm_storel_epi64((__m128i*)&Output[ldOutput * 0], d0);
+        _mm_storel_epi64((__m128i*)&Output[ldOutput * 1], _mm_unpackhi_epi64(d0, d0));
+        _mm_storel_epi64((__m128i*)&Output[ldOutput * 2], d1);
+        _mm_storel_epi64((__m128i*)&Output[ldOutput * 3], _mm_unpackhi_epi64(d1, d1));
+        _mm_storel_epi64((__m128i*)&Output[ldOutput * 4], d2);
+        _mm_storel_epi64((__m128i*)&Output[ldOutput * 5], _mm_unpackhi_epi64(d2, d2));
+        _mm_storel_epi64((__m128i*)&Output[ldOutput * 6], d3);
+        _mm_storel_epi64((__m128i*)&Output[ldOutput * 7], _mm_unpackhi_epi64(d3, d3));
+
+#elif defined(MLAS_NEON_INTRINSICS)
+
+        uint8x8x2_t t0 = vtrn_u8(vld1_u8(&Input[ldInput * 0]), vld1_u8(&Input[ldInput * 1]));
+        uint8x8x2_t t1 = vtrn_u8(vld1_u8(&Input[ldInput * 2]), vld1_u8(&Input[ldInput * 3]));
+        uint8x8x2_t t2 = vtrn_u8(vld1_u8(&Input[ldInput * 4]), vld1_u8(&Input[ldInput * 5]));
+        uint8x8x2_t t3 = vtrn_u8(vld1_u8(&Input[ldInput * 6]), vld1_u8(&Input[ldInput * 7]));
+
+        uint16x4x2_t u0 = vtrn_u16(vreinterpret_u16_u8(t0.val[0]), vreinterpret_u16_u8(t1.val[0]));
+        uint16x4x2_t u1 = vtrn_u16(vreinterpret_u16_u8(t0.val[1]), vreinterpret_u16_u8(t1.val[1]));
+        uint16x4x2_t u2 = vtrn_u16(vreinterpret_u16_u8(t2.val[0]), vreinterpret_u16_u8(t3.val[0]));
+        uint16x4x2_t u3 = vtrn_u16(vreinterpret_u16_u8(t2.val[1]), vreinterpret_u16_u8(t3.val[1]));
+
+        uint32x2x2_t v0 = vtrn_u32(vreinterpret_u32_u16(u0.val[0]), vreinterpret_u32_u16(u2.val[0]));
+        uint32x2x2_t v1 = vtrn_u32(vreinterpret_u32_u16(u1.val[0]), vreinterpret_u32_u16(u3.val[0]));
+        uint32x2x2_t v2 = vtrn_u32(vreinterpret_u32_u16(u0.val[1]), vreinterpret_u32_u16(u2.val[1]));
+        uint32x2x2_t v3 = vtrn_u32(vreinterpret_u32_u16(u1.val[1]), vreinterpret_u32_u16(u3.val[1]));
+
+        vst1_u8(&Output[ldOutput * 0], vreinterpret_u8_u32(v0.val[0]));
+        vst1_u8(&Output[ldOutput * 1], vreinterpret_u8_u32(v1.val[0]));
+        vst1_u8(&Output[ldOutput * 2], vreinterpret_u8_u32(v2.val[0]));
+        vst1_u8(&Output[ldOutput * 3], vreinterpret_u8_u32(v3.val[0]));
+        vst1_u8(&Output[ldOutput * 4], vreinterpret_u8_u32(v0.val[1]));
+        vst1_u8(&Output[ldOutput * 5], vreinterpret_u8_u32(v1.val[1]));
+        vst1_u8(&Output[ldOutput * 6], vreinterpret_u8_u32(v2.val[1]));
+        vst1_u8(&Output[ldOutput * 7], vreinterpret_u8_u32(v3.val[1]));
+
+#else
+
+        MlasTransposeTileGeneric<uint8_t, TileSize>(Input, ldInput, Output, ldOutput);
+
+#endif
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_TILE<uint16_t>
+{
+    static constexpr size_t TileSize = 4;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint16_t* Input,
+        size_t ldInput,
+        uint16_t* Output,
+        size_t ldOutput
+        )
+    {
+        MlasTransposeTileGeneric<uint16_t, TileSize>(Input, ldInput, Output, ldOutput);
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_TILE<uint32_t>
+{
+    static constexpr size_t TileSize = 4;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint32_t* Input,
+        size_t ldInput,
+        uint32_t* Output,
+        size_t ldOutput
+        )
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+
+        __m128i a0 = _mm_loadu_si128((const __m128i*)&Input[ldInput * 0]);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)&Input[ldInput * 1]);
+        __m128i a2 = _mm_loadu_si128((const __m128i*)&Input[ldInput * 2]);
+        __m128i a3 = _mm_loadu_si128((const __m128i*)&Input[ldInput * 3]);
+
+        __m128i b0 = _mm_unpacklo_epi32(a0, a1);
+        __m128i b1 = _mm_unpackhi_epi32(a0, a1);
+        __m128i b2 = _mm_unpacklo_epi32(a2, a3);
+        __m128i b3 = _mm_unpackhi_epi32(a2, a3);
+
+        _mm_storeu_si128((__m128i*)&Output[ldOutput * 0], _mm_unpacklo_epi64(b0, b2));
+        _mm_storeu_si128((__m128i*)&Output[ldOutput * 1], _mm_unpackhi_epi64(b0, b2));
+        _mm_storeu_si128((__m128i*)&Output[ldOutput * 2], _mm_unpacklo_epi64(b1, b3));
+        _mm_storeu_si128((__m128i*)&Output[ldOutput * 3], _mm_unpackhi_epi64(b1, b3));
+
+#elif defined(MLAS_NEON_INTRINSICS)
+
+        uint32x4_t a0 = vld1q_u32(&Input[ldInput * 0]);
+        uint32x4_t a1 = vld1q_u32(&Input[ldInput * 1]);
+        uint32x4_t a2 = vld1q_u32(&Input[ldInput * 2]);
+        uint32x4_t a3 = vld1q_u32(&Input[ldInput * 3]);
+
+        uint32x4x2_t b0 = vzipq_u32(a0, a2);
+        uint32x4x2_t b1 = vzipq_u32(a1, a3);
+
+        uint32x4x2_t c0 = vzipq_u32(b0.val[0], b1.val[0]);
+        uint32x4x2_t c1 = vzipq_u32(b0.val[1], b1.val[1]);
+
+        vst1q_u32(&Output[ldOutput * 0], c0.val[0]);
+        vst1q_u32(&Output[ldOutput * 1], c0.val[1]);
+        vst1q_u32(&Output[ldOutput * 2], c1.val[0]);
+        vst1q_u32(&Output[ldOutput * 3], c1.val[1]);
+
+#else
+
+        MlasTransposeTileGeneric<uint32_t, TileSize>(Input, ldInput, Output, ldOutput);
+
+#endif
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_TILE<uint64_t>
+{
+    static constexpr size_t TileSize = 2;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint64_t* Input,
+        size_t ldInput,
+        uint64_t* Output,
+        size_t ldOutput
+        )
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+
+        __m128i a0 = _mm_loadu_si128((const __m128i*)&Input[ldInput * 0]);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)&Input[ldInput * 1]);
+
+        _mm_storeu_si128((__m128i*)&Output[ldOutput * 0], _mm_unpacklo_epi64(a0, a1));
+        _mm_storeu_si128((__m128i*)&Output[ldOutput * 1], _mm_unpackhi_epi64(a0, a1));
+
+#else
+
+        MlasTransposeTileGeneric<uint64_t, TileSize>(Input, ldInput, Output, ldOutput);
+
+#endif
+    }
+};
+
+template<typename ElementType>
+void
+MlasTransposeImpl(
+    const ElementType* Input,
+    size_t ldInput,
+    ElementType* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix by square tiles. The rows of the input
+    matrix are processed in blocks so that the input cache lines loaded for a
+    panel of columns are still cached for the following panels.
+
+Arguments:
+
+    Input - Supplies the input matrix of M rows by N columns.
+
+    ldInput - Supplies the number of elements between rows of the input
+        matrix.
+
+    Output - Supplies the output matrix of N rows by M columns.
+
+    ldOutput - Supplies the number of elements between rows of the output
+        matrix.
+
+    M - Supplies the number of rows of the input matrix.
+
+    N - Supplies the number of columns of the input matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t TileSize = MLAS_TRANSPOSE_TILE<ElementType>::TileSize;
+
+    for (size_t m0 = 0; m0 < M; m0 += MLAS_TRANSPOSE_ROW_BLOCK) {
+
+        const size_t RowCount = std::min(M - m0, size_t(MLAS_TRANSPOSE_ROW_BLOCK));
+        const ElementType* InputBlock = Input + m0 * ldInput;
+        ElementType* OutputBlock = Output + m0;
+
+        size_t n = 0;
+
+        for (; n + TileSize <= N; n += TileSize) {
+
+            size_t m = 0;
+
+            for (; m + TileSize <= RowCount; m += TileSize) {
+                MLAS_TRANSPOSE_TILE<ElementType>::Transpose(&InputBlock[m * ldInput + n],
+                    ldInput, &OutputBlock[n * ldOutput + m], ldOutput);
+            }
+
+            for (; m < RowCount; m++) {
+                for (size_t j = 0; j < TileSize; j++) {
+                    OutputBlock[(n + j) * ldOutput + m] = InputBlock[m * ldInput + n + j];
+                }
+            }
+        }
+
+        for (; n < N; n++) {
+            for (size_t m = 0; m < RowCount; m++) {
+                OutputBlock[n * ldOutput + m] = InputBlock[m * ldInput + n];
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    size_t ldInput,
+    uint8_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTransposeImpl(Input, ldInput, Output, ldOutput, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    size_t ldInput,
+    uint16_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTransposeImpl(Input, ldInput, Output, ldOutput, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    size_t ldInput,
+    uint32_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTransposeImpl(Input, ldInput, Output, ldOutput, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    size_t ldInput,
+    uint64_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTransposeImpl(Input, ldInput, Output, ldOutput, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const float* Input,
+    size_t ldInput,
+    float* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTransposeImpl(reinterpret_cast<const uint32_t*>(Input), ldInput,
+        reinterpret_cast<uint32_t*>(Output), ldOutput, M, N);
+}
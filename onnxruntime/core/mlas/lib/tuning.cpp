@@ -0,0 +1,291 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    tuning.cpp
+
+Abstract:
+
+    This module implements the benchmarks that select the kernels of each
+    kernel family when the library is initialized with MLAS_TUNE set.
+
+    The newest instruction set extensions are not always the fastest: the
+    AVX512 kernels can lower the clock frequency of some processors, so the
+    kernels of each family are timed on a representative problem and the
+    fastest level is kept.
+
+--*/
+
+#include "mlasi.h"
+
+#include <chrono>
+#include <vector>
+
+#if defined(MLAS_TARGET_AMD64)
+
+//
+// Stores the number of timed runs of each candidate, after one warmup run.
+// The fastest run is used, as it is the least disturbed by other work.
+//
+
+constexpr size_t MlasTuningRuns = 5;
+
+template<typename Routine>
+double
+MlasTimeRoutine(
+    Routine&& Run
+    )
+{
+    Run();
+
+    double BestTime = 0.0;
+
+    for (size_t i = 0; i < MlasTuningRuns; i++) {
+
+        auto Start = std::chrono::steady_clock::now();
+        Run();
+        std::chrono::duration<double> Elapsed = std::chrono::steady_clock::now() - Start;
+
+        if (i == 0 || Elapsed.count() < BestTime) {
+            BestTime = Elapsed.count();
+        }
+    }
+
+    return BestTime;
+}
+
+template<typename Routine>
+void
+MlasTuneKernelFamily(
+    const MLAS_CPU_FEATURES* Features,
+    MLAS_KERNEL_SELECTION* Selection,
+    MLAS_KERNEL_FAMILY Family,
+    const MLAS_ISA_LEVEL* Candidates,
+    size_t CandidateCount,
+    Routine&& Run
+    )
+/*++
+
+Routine Description:
+
+    This routine times the kernels of a family at each candidate level that
+    does not exceed the current level of the family, and selects the fastest.
+
+    When the fastest candidate is the highest one that was timed, the current
+    level of the family is kept, so the kernels of the family that the
+    benchmark does not exercise are not downgraded.
+
+Arguments:
+
+    Features - Supplies the processor features.
+
+    Selection - Supplies the kernel selection to update.
+
+    Family - Supplies the kernel family to tune.
+
+    Candidates - Supplies the levels to time, in increasing order. Each level
+        should change the kernels that the benchmark uses.
+
+    CandidateCount - Supplies the number of candidate levels.
+
+    Run - Supplies the benchmark.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_ISA_LEVEL MaximumLevel = Selection->Levels[Family];
+
+    MLAS_ISA_LEVEL BestLevel = MaximumLevel;
+    MLAS_ISA_LEVEL HighestLevel = MlasIsaSse2;
+    double BestTime = 0.0;
+    bool HasCandidate = false;
+
+    for (size_t i = 0; i < CandidateCount; i++) {
+
+        if (Candidates[i] > MaximumLevel) {
+            break;
+        }
+
+        Selection->Levels[Family] = Candidates[i];
+        MlasPlatform.SelectKernels(Features, Selection);
+
+        double Time = MlasTimeRoutine(Run);
+
+        if (!HasCandidate || Time < BestTime) {
+            BestLevel = Candidates[i];
+            BestTime = Time;
+            HasCandidate = true;
+        }
+
+        HighestLevel = Candidates[i];
+    }
+
+    Selection->Levels[Family] = (BestLevel == HighestLevel) ? MaximumLevel : BestLevel;
+    MlasPlatform.SelectKernels(Features, Selection);
+}
+
+void
+MlasTuneKernelSelection(
+    const MLAS_CPU_FEATURES* Features,
+    MLAS_KERNEL_SELECTION* Selection
+    )
+/*++
+
+Routine Description:
+
+    This routine benchmarks the candidate kernels of the SGEMM, QGEMM and
+    convolution families on a single thread and updates the selection with
+    the fastest ones. The elementwise kernels are memory bound and are only
+    selected by the MLAS_DISPATCH environment variable.
+
+    This routine is called while the platform is initialized, before any
+    packed buffers are built.
+
+Arguments:
+
+    Features - Supplies the processor features.
+
+    Selection - Supplies the kernel selection to update. The levels of the
+        families are the highest levels that may be selected.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Tune the single precision GEMM with a problem that is large enough for
+    // the packed path.
+    //
+
+    {
+        constexpr size_t M = 128;
+        constexpr size_t N = 512;
+        constexpr size_t K = 512;
+
+        std::vector<float> A(M * K, 0.5f);
+        std::vector<float> B(K * N, 0.25f);
+        std::vector<float> C(M * N);
+
+        static const MLAS_ISA_LEVEL Candidates[] = {
+            MlasIsaAvx, MlasIsaAvx2, MlasIsaAvx512F,
+        };
+
+        constexpr size_t CandidateCount = sizeof(Candidates) / sizeof(Candidates[0]);
+
+        MlasTuneKernelFamily(Features, Selection, MlasSgemmFamily, Candidates, CandidateCount, [&]() {
+            MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A.data(), K, B.data(), N, 0.0f, C.data(), N, nullptr);
+        });
+
+        //
+        // Check whether the single row kernels beat the packed path for the
+        // selected kernels.
+        //
+
+        if (Selection->Levels[MlasSgemmFamily] >= MlasIsaAvx) {
+
+            constexpr size_t N1 = 1024;
+            constexpr size_t K1 = 1024;
+
+            std::vector<float> A1(K1, 0.5f);
+            std::vector<float> B1(K1 * N1, 0.25f);
+            std::vector<float> C1(N1);
+
+            auto RunM1 = [&]() {
+                MlasGemm(CblasNoTrans, CblasNoTrans, 1, N1, K1, 1.0f, A1.data(), K1, B1.data(), N1,
+                    0.0f, C1.data(), N1, nullptr);
+            };
+
+            Selection->UseSgemmKernelM1 = true;
+            MlasPlatform.SelectKernels(Features, Selection);
+            double KernelM1Time = MlasTimeRoutine(RunM1);
+
+            Selection->UseSgemmKernelM1 = false;
+            MlasPlatform.SelectKernels(Features, Selection);
+            double PackedTime = MlasTimeRoutine(RunM1);
+
+            Selection->UseSgemmKernelM1 = (KernelM1Time <= PackedTime);
+            MlasPlatform.SelectKernels(Features, Selection);
+        }
+    }
+
+    //
+    // Tune the quantized GEMM. The AVX512VNNI and AMX levels are only
+    // candidates if the processor supports them, as they otherwise select the
+    // same kernels as the level below.
+    //
+
+    {
+        constexpr size_t M = 128;
+        constexpr size_t N = 512;
+        constexpr size_t K = 512;
+
+        std::vector<uint8_t> A(M * K, 3);
+        std::vector<uint8_t> B(K * N, 5);
+        std::vector<int32_t> C(M * N);
+
+        MLAS_ISA_LEVEL Candidates[4];
+        size_t CandidateCount = 0;
+
+        Candidates[CandidateCount++] = MlasIsaAvx2;
+        Candidates[CandidateCount++] = MlasIsaAvx512Core;
+
+        if (Features->HasAvx512Vnni) {
+            Candidates[CandidateCount++] = MlasIsaAvx512Vnni;
+        }
+
+        if (Features->HasAmxInt8) {
+            Candidates[CandidateCount++] = MlasIsaAll;
+        }
+
+        MlasTuneKernelFamily(Features, Selection, MlasQgemmFamily, Candidates, CandidateCount, [&]() {
+            MlasGemm(M, N, K, A.data(), K, 0, B.data(), N, 0, true, C.data(), N, nullptr);
+        });
+    }
+
+    //
+    // Tune the convolution with a 3x3 NCHWc convolution. The selected level
+    // also determines the NCHWc block size of the graph transformations.
+    //
+
+    {
+        constexpr int64_t Channels = 64;
+        constexpr int64_t Height = 28;
+        constexpr int64_t Width = 28;
+
+        static const int64_t InputShape[] = { 1, Channels, Height, Width };
+        static const int64_t KernelShape[] = { 3, 3 };
+        static const int64_t DilationShape[] = { 1, 1 };
+        static const int64_t Padding[] = { 1, 1, 1, 1 };
+        static const int64_t StrideShape[] = { 1, 1 };
+        static const int64_t OutputShape[] = { 1, Channels, Height, Width };
+
+        std::vector<float> Input(Channels * Height * Width, 0.5f);
+        std::vector<float> Filter(Channels * Channels * 3 * 3, 0.25f);
+        std::vector<float> Output(Channels * Height * Width);
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasIdentityActivation;
+
+        static const MLAS_ISA_LEVEL Candidates[] = {
+            MlasIsaAvx, MlasIsaAvx2, MlasIsaAvx512F,
+        };
+
+        constexpr size_t CandidateCount = sizeof(Candidates) / sizeof(Candidates[0]);
+
+        MlasTuneKernelFamily(Features, Selection, MlasConvFamily, Candidates, CandidateCount, [&]() {
+            MlasNchwcConv(InputShape, KernelShape, DilationShape, Padding, StrideShape, OutputShape, 1,
+                Input.data(), Filter.data(), nullptr, Output.data(), &Activation, true, nullptr);
+        });
+    }
+}
+
+#endif
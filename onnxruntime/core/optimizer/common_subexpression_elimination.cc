@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/common_subexpression_elimination.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsNonDeterministic(const Node& node) {
+  static const std::unordered_set<std::string> non_deterministic_ops{
+      "RandomNormal", "RandomNormalLike", "RandomUniform", "RandomUniformLike", "Multinomial", "Dropout"};
+  return non_deterministic_ops.count(node.OpType()) > 0;
+}
+
+// The key of the value computed by a node. The inputs are identified by their names, which are unique in the graph.
+std::string GetNodeKey(const Node& node) {
+  std::string key = node.Domain() + ":" + node.OpType() + ":" + node.GetExecutionProviderType();
+
+  for (const NodeArg* input : node.InputDefs()) {
+    key += "|" + input->Name();
+  }
+  key += "|" + std::to_string(node.OutputDefs().size());
+  for (const NodeArg* output : node.OutputDefs()) {
+    key += output->Exists() ? "1" : "0";
+  }
+
+  // the attributes are kept in an unordered map
+  std::vector<std::string> attribute_names;
+  for (const auto& attribute : node.GetAttributes()) {
+    attribute_names.push_back(attribute.first);
+  }
+  std::sort(attribute_names.begin(), attribute_names.end());
+  for (const auto& name : attribute_names) {
+    key += "|" + node.GetAttributes().at(name).SerializeAsString();
+  }
+  return key;
+}
+
+// The outputs of the node can be replaced by the outputs of an equivalent node.
+bool CanReplaceOutputs(const Graph& graph, const Node& node) {
+  if (!graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+    return false;
+  }
+
+  // the implicit inputs of a subgraph would have to be renamed in the subgraph
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (static_cast<size_t>(it->GetDstArgIndex()) >= it->GetNode().InputDefs().size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                                 const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the first node computing each value, in topological order
+  std::unordered_map<std::string, NodeIndex> first_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        node.OutputDefs().empty() || node.ContainsSubgraph() || IsNonDeterministic(node)) {
+      continue;
+    }
+
+    auto first_node = first_nodes.emplace(GetNodeKey(node), node_index);
+    if (first_node.second || !CanReplaceOutputs(graph, node)) {
+      continue;
+    }
+
+    Node& replacement = *graph.GetNode(first_node.first->second);
+    for (int i = 0; i < static_cast<int>(node.OutputDefs().size()); ++i) {
+      graph_utils::ReplaceDownstreamNodeInput(graph, node, i, replacement, i);
+    }
+    graph.RemoveNode(node_index);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
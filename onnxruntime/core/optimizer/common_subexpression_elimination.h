@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class CommonSubexpressionElimination
+
+Merges the nodes computing the same values: nodes with the same op type, domain, attributes and inputs, such as the
+Shape -> Gather -> Unsqueeze chains or the attention masks repeated by exporters for each layer. The consumers of a
+duplicate node are connected to the first equivalent node in topological order, and the duplicate is removed.
+As the inputs of the merged nodes are then the same, the chains following them are merged too.
+
+Nodes are kept if they are non-deterministic, such as the Random ops, contain subgraphs, produce graph outputs, or
+have outputs used by a subgraph. The subgraphs are processed on their own.
+*/
+class CommonSubexpressionElimination : public GraphTransformer {
+ public:
+  CommonSubexpressionElimination(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("CommonSubexpressionElimination", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
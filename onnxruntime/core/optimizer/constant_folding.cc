@@ -2,10 +2,16 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/constant_folding.h"
+
+#include <algorithm>
+
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/optimizer_execution_frame.h"
+#include "core/optimizer/qdq_fusion.h"
+#include "core/framework/mldata_type_utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/threadpool.h"
 
 using namespace onnxruntime::common;
 
@@ -46,17 +52,202 @@ static bool ConstantFoldShapeNode(Graph& graph, Node& node) {
   return is_concrete_shape;  // convert to constant if this is true
 }
 
+// Outputs of up to this size are folded regardless of the size of the inputs.
+static constexpr size_t kMinSizeLimit = 64 * 1024;
+
+// The nodes with constant inputs are computed in batches of up to this size, which bounds the memory used by the
+// inputs and outputs of the batch.
+static constexpr size_t kMaxBatchSize = 64;
+
+struct ConstantFolding::Candidate {
+  Node* node;
+  InitializedTensorSet constant_inputs;
+  std::vector<ONNX_NAMESPACE::TensorProto> outputs;  // empty if the node can't be folded
+  Status status;
+};
+
+bool ConstantFolding::ExceedsSizeLimit(size_t output_size, size_t input_size) const {
+  return max_output_size_ratio_ > 0.f && output_size > kMinSizeLimit &&
+         static_cast<double>(output_size) > static_cast<double>(max_output_size_ratio_) * input_size;
+}
+
+// Returns the size of the tensor if its shape was inferred, or 0 otherwise.
+static size_t GetInferredSizeInBytes(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  const auto* ml_type = utils::GetMLDataType(arg);
+  if (shape == nullptr || ml_type == nullptr || !ml_type->IsTensorType()) {
+    return 0;
+  }
+  size_t size = static_cast<const TensorTypeBase*>(ml_type)->GetElementType()->Size();
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+      return 0;
+    }
+    size *= static_cast<size_t>(dim.dim_value());
+  }
+  return size;
+}
+
+Status ConstantFolding::ComputeCandidate(Candidate& candidate, const logging::Logger& logger) const {
+  Node* node = candidate.node;
+
+  size_t input_size = 0;
+  for (const auto& constant_input : candidate.constant_inputs) {
+    size_t tensor_size = 0;
+    ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(*constant_input.second, &tensor_size));
+    input_size += tensor_size;
+  }
+
+  // skip the node before computing it if the inferred output shapes are too large already
+  size_t inferred_output_size = 0;
+  for (const auto* node_out : node->OutputDefs()) {
+    inferred_output_size += GetInferredSizeInBytes(*node_out);
+  }
+  if (ExceedsSizeLimit(inferred_output_size, input_size)) {
+    LOGS(logger, VERBOSE) << "Not constant folding " << node->OpType() << " node '" << node->Name()
+                          << "' as its outputs of " << inferred_output_size << " bytes are much larger than its inputs";
+    return Status::OK();
+  }
+
+  // we currently constant fold using the CPU EP only. The execution provider is only used for the node, so it
+  // allocates from the system allocator rather than an arena that would keep its memory.
+  auto ep_type = node->GetExecutionProviderType();
+  bool cpu_ep = ep_type == kCpuExecutionProvider;
+  std::unique_ptr<CPUExecutionProvider> cpu_execution_provider =
+      onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+
+  // Create execution frame for executing constant nodes.
+  OptimizerExecutionFrame::Info info({node}, candidate.constant_inputs, std::move(cpu_execution_provider));
+
+  std::vector<int> fetch_mlvalue_idxs;
+  for (const auto* node_out : node->OutputDefs()) {
+    fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
+  }
+
+  // override the EP assigned to the node so that it will use the CPU kernel for Compute.
+  if (!cpu_ep) {
+    node->SetExecutionProviderType(kCpuExecutionProvider);
+  }
+
+  auto kernel = info.CreateKernel(node);
+
+  // undo the EP change to the value that was assigned at graph partitioning time
+  if (!cpu_ep) {
+    node->SetExecutionProviderType(ep_type);
+  }
+
+  if (kernel == nullptr) {
+    LOGS(logger, WARNING) << "Could not find a CPU kernel and hence "
+                          << "can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
+    return Status::OK();
+  }
+
+  OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
+
+  OpKernelContext op_kernel_context(&frame, kernel.get(), nullptr, logger);
+  ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+
+  ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
+  size_t output_size = 0;
+  for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
+    OrtValue& ort_value = fetches[fetch_idx];
+
+    if (!ort_value.IsTensor()) {
+      LOGS(logger, WARNING) << "Unsupported output type of " << ort_value.Type()
+                            << ". Can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
+      return Status::OK();
+    }
+    output_size += ort_value.Get<Tensor>().SizeInBytes();
+  }
+
+  if (ExceedsSizeLimit(output_size, input_size)) {
+    LOGS(logger, VERBOSE) << "Not constant folding " << node->OpType() << " node '" << node->Name()
+                          << "' as its outputs of " << output_size << " bytes are much larger than its inputs";
+    return Status::OK();
+  }
+
+  // Build the TensorProtos that correspond to the computed OrtValues, to be added as initializers to the graph.
+  for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
+    const Tensor& out_tensor = fetches[fetch_idx].Get<Tensor>();
+    candidate.outputs.push_back(utils::TensorToTensorProto(out_tensor, node->OutputDefs()[fetch_idx]->Name()));
+  }
+
+  return Status::OK();
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
   bool have_updated_nodes = false;
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
 
+  auto remove_constant_node = [&](Node& node) {
+    // Remove the output edges of the constant node and then remove the node itself.
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.Index());
+    modified = true;
+    have_updated_nodes = true;
+  };
+
+  // The nodes with constant inputs are collected in a batch, then computed in parallel. The batch is folded before
+  // a node that consumes one of its outputs is visited.
+  std::vector<Candidate> batch;
+  std::unordered_set<const NodeArg*> batch_outputs;
+  auto fold_batch = [&]() -> Status {
+    auto compute_candidate = [&](std::ptrdiff_t i) {
+      try {
+        batch[i].status = ComputeCandidate(batch[i], logger);
+      } catch (const std::exception& ex) {
+        batch[i].status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      }
+    };
+    concurrency::ThreadPool::TrySimpleParallelFor(thread_pool_, static_cast<std::ptrdiff_t>(batch.size()),
+                                                  compute_candidate);
+
+    for (auto& candidate : batch) {
+      ORT_RETURN_IF_ERROR(candidate.status);
+      if (candidate.outputs.empty()) {
+        continue;
+      }
+
+      // Go over all output node args and substitute them with the newly computed tensors, which are added to the
+      // graph as initializers.
+      for (size_t output_idx = 0; output_idx < candidate.outputs.size(); ++output_idx) {
+        auto& out_tensorproto = candidate.outputs[output_idx];
+        auto* constant_arg_out = candidate.node->MutableOutputDefs()[output_idx];
+
+        ONNX_NAMESPACE::TensorShapeProto result_shape;
+        for (auto dim : out_tensorproto.dims()) {
+          result_shape.add_dim()->set_dim_value(dim);
+        }
+
+        constant_arg_out->SetShape(result_shape);
+        graph.AddInitializedTensor(out_tensorproto);
+      }
+      remove_constant_node(*candidate.node);
+    }
+
+    batch.clear();
+    batch_outputs.clear();
+    return Status::OK();
+  };
+
   for (NodeIndex i : order) {
     auto* node = graph.GetNode(i);
     if (!node) {
       continue;
     }
 
+    if (!batch_outputs.empty()) {
+      auto is_batch_output = [&batch_outputs](const NodeArg* arg) { return batch_outputs.count(arg) != 0; };
+      if (std::any_of(node->InputDefs().begin(), node->InputDefs().end(), is_batch_output) ||
+          std::any_of(node->ImplicitInputDefs().begin(), node->ImplicitInputDefs().end(), is_batch_output)) {
+        ORT_RETURN_IF_ERROR(fold_batch());
+      }
+    }
+
     ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
 
     // Updating a node may allow shape inferencing to infer output shapes of following nodes,
@@ -67,116 +258,49 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       ORT_RETURN_IF_ERROR(graph.UpdateShapeInference(*node));
     }
 
-    bool converted_to_constant = false;
     if (node->OpType().compare("Shape") == 0) {
-      converted_to_constant = ConstantFoldShapeNode(graph, *node);
-    } else {
-      InitializedTensorSet constant_inputs;
-
-      // we currently constant fold using the CPU EP only.
-      // if the node is assigned to a different EP we can run it if it's an ONNX op as we have CPU based
-      // implementations for all ONNX ops. If the node/op is from a different op domain or if the CPU implementation
-      // does not support the specific input type(s) required by the node (currently we only support a subset of
-      // types in some CPU kernels) then we can't proceed with constant folding for the node.
-      auto ep_type = node->GetExecutionProviderType();
-      bool cpu_ep = ep_type == kCpuExecutionProvider;
-      if (!cpu_ep && node->Domain() != kOnnxDomain) {
-        continue;
-      }
-
-      // Check if constant folding can be applied on this node.
-      if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
-          excluded_op_types_.find(node->OpType()) != excluded_op_types_.end() ||
-          // constant folding does not support executing a node that includes subgraphs (control flow operators,
-          // such as If/Loop/Scan, fall into this category). individual nodes in the subgraph will be processed
-          // by the Recurse call above
-          node->ContainsSubgraph() || !graph_utils::AllNodeInputsAreConstant(graph, *node, constant_inputs, excluded_initializers_)) {
-        continue;
-      }
-
-      // Create execution frame for executing constant nodes.
-      std::unique_ptr<CPUExecutionProvider> cpu_execution_provider =
-          onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
-
-      // Create execution frame for executing constant nodes.
-      OptimizerExecutionFrame::Info info({node}, constant_inputs, std::move(cpu_execution_provider));
-
-      std::vector<int> fetch_mlvalue_idxs;
-      for (const auto* node_out : node->OutputDefs()) {
-        fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
-      }
-
-      // override the EP assigned to the node so that it will use the CPU kernel for Compute.
-      if (!cpu_ep) {
-        node->SetExecutionProviderType(kCpuExecutionProvider);
+      if (ConstantFoldShapeNode(graph, *node)) {
+        remove_constant_node(*node);
       }
+      continue;
+    }
 
-      auto kernel = info.CreateKernel(node);
-
-      // undo the EP change to the value that was assigned at graph partitioning time
-      if (!cpu_ep) {
-        node->SetExecutionProviderType(ep_type);
-      }
-
-      if (kernel == nullptr) {
-        LOGS(logger, WARNING) << "Could not find a CPU kernel and hence "
-                              << "can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
-
-        // Move on to the next candidate node
-        continue;
-      }
-
-      OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
-
-      OpKernelContext op_kernel_context(&frame, kernel.get(), nullptr, logger);
-      ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
-
-      std::vector<OrtValue> fetches;
-      ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+    InitializedTensorSet constant_inputs;
 
-      // Go over all output node args and substitute them with the newly computed tensors, which will be
-      // added to the graph as initializers.
-      ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
-      converted_to_constant = true;
-      for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-        OrtValue& ort_value = fetches[fetch_idx];
+    // we currently constant fold using the CPU EP only.
+    // if the node is assigned to a different EP we can run it if it's an ONNX op as we have CPU based
+    // implementations for all ONNX ops. If the node/op is from a different op domain or if the CPU implementation
+    // does not support the specific input type(s) required by the node (currently we only support a subset of
+    // types in some CPU kernels) then we can't proceed with constant folding for the node.
+    bool cpu_ep = node->GetExecutionProviderType() == kCpuExecutionProvider;
+    if (!cpu_ep && node->Domain() != kOnnxDomain) {
+      continue;
+    }
 
-        if (!ort_value.IsTensor()) {
-          LOGS(logger, WARNING) << "Unsupported output type of " << ort_value.Type()
-                                << ". Can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
-          converted_to_constant = false;
-          break;
-        }
-      }
+    // Check if constant folding can be applied on this node.
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
+        excluded_op_types_.find(node->OpType()) != excluded_op_types_.end() ||
+        // constant folding does not support executing a node that includes subgraphs (control flow operators,
+        // such as If/Loop/Scan, fall into this category). individual nodes in the subgraph will be processed
+        // by the Recurse call above
+        node->ContainsSubgraph() || !graph_utils::AllNodeInputsAreConstant(graph, *node, constant_inputs, excluded_initializers_)) {
+      continue;
+    }
 
-      if (converted_to_constant) {
-        for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-          OrtValue& ort_value = fetches[fetch_idx];
-          // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
-          auto* constant_arg_out = node->MutableOutputDefs()[fetch_idx];
-          const Tensor& out_tensor = ort_value.Get<Tensor>();
-          ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
-
-          ONNX_NAMESPACE::TensorShapeProto result_shape;
-          for (auto& dim : out_tensor.Shape().GetDims()) {
-            result_shape.add_dim()->set_dim_value(dim);
-          }
-
-          constant_arg_out->SetShape(result_shape);
-          graph.AddInitializedTensor(out_tensorproto);
-        }
-      }
+    // keep the DequantizeLinear of the quantized weights that QDQFusion passes to the quantized kernels
+    if (QDQFusion::IsFusableDequantizeLinear(graph, *node)) {
+      continue;
     }
 
-    if (converted_to_constant) {
-      // Remove the output edges of the constant node and then remove the node itself.
-      graph_utils::RemoveNodeOutputEdges(graph, *node);
-      graph.RemoveNode(node->Index());
-      modified = true;
-      have_updated_nodes = true;
+    batch.push_back({node, std::move(constant_inputs), {}, Status::OK()});
+    for (const auto* node_out : node->OutputDefs()) {
+      batch_outputs.insert(node_out);
+    }
+    if (batch.size() >= kMaxBatchSize) {
+      ORT_RETURN_IF_ERROR(fold_batch());
     }
   }
 
-  return Status::OK();
+  return fold_batch();
 }
 }  // namespace onnxruntime
@@ -7,22 +7,43 @@
 #include "core/framework/ml_value.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 
 /**
 @class ConstantFolding
 
 Transformer that traverses the graph top-down and performs constant folding, i.e.,
 it statically computes parts of the graph that rely only on constant initializers.
+The nodes that don't depend on each other are computed in parallel on the given thread pool.
 */
 class ConstantFolding : public GraphTransformer {
  public:
   /** Constant folding will not be applied to nodes that have one of initializers from excluded_initializers as input.
-      For pre-training, the trainable weights are those initializers to be excluded. */
+      For pre-training, the trainable weights are those initializers to be excluded.
+      A node is not folded if its outputs are larger than max_output_size_ratio times its inputs, such as a Tile or
+      Expand of a small initializer, as the initializer would take more memory than computing it in each run.
+      0 disables this check. */
   ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {},
-                  const std::unordered_set<std::string>& excluded_initializers = {}) noexcept
-      : GraphTransformer("ConstantFolding", compatible_execution_providers), excluded_initializers_(excluded_initializers) {}
+                  const std::unordered_set<std::string>& excluded_initializers = {},
+                  float max_output_size_ratio = kDefaultMaxOutputSizeRatio,
+                  concurrency::ThreadPool* thread_pool = nullptr) noexcept
+      : GraphTransformer("ConstantFolding", compatible_execution_providers),
+        excluded_initializers_(excluded_initializers),
+        max_output_size_ratio_(max_output_size_ratio),
+        thread_pool_(thread_pool) {}
+
+  static constexpr float kDefaultMaxOutputSizeRatio = 16.f;
 
  private:
+  struct Candidate;
+
+  // Computes the outputs of a node with constant inputs.
+  Status ComputeCandidate(Candidate& candidate, const logging::Logger& logger) const;
+
+  bool ExceedsSizeLimit(size_t output_size, size_t input_size) const;
+
   /** Constant folding will not be applied to nodes whose op_type is included in this set.
       All non-deterministic operators should be included in this set. */
   const std::unordered_set<std::string> excluded_op_types_ =
@@ -31,6 +52,8 @@ class ConstantFolding : public GraphTransformer {
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
   const std::unordered_set<std::string> excluded_initializers_;
+  const float max_output_size_ratio_;
+  concurrency::ThreadPool* const thread_pool_;
 };
 
 }  // namespace onnxruntime
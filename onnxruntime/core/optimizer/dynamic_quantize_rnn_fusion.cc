@@ -0,0 +1,200 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/dynamic_quantize_rnn_fusion.h"
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The DequantizeLinear node of the W or R input of a recurrent node, with its constant 8-bit weights.
+struct DequantizedWeights {
+  const Node* dq_node = nullptr;
+  const TensorProto* weights = nullptr;
+};
+
+bool IsScalarConstant(const Graph& graph, const NodeArg& arg, int32_t data_type) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != data_type) {
+    return false;
+  }
+  for (auto dim : tensor_proto->dims()) {
+    if (dim != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Matches the DequantizeLinear of a constant [num_directions, N, K] weights tensor quantized per tensor, whose output
+// is only consumed by the recurrent node.
+bool MatchDequantizedWeights(const Graph& graph, const Node& rnn_node, int input_index, DequantizedWeights& weights) {
+  const Node* dq_node = graph_utils::GetInputNode(rnn_node, input_index);
+  if (dq_node == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*dq_node, "DequantizeLinear", {10}) ||
+      !optimizer_utils::CheckOutputEdges(graph, *dq_node, 1)) {
+    return false;
+  }
+
+  const auto& dq_inputs = dq_node->InputDefs();
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, dq_inputs[0]->Name());
+  if (tensor_proto == nullptr || tensor_proto->dims_size() != 3 ||
+      (tensor_proto->data_type() != TensorProto_DataType_UINT8 &&
+       tensor_proto->data_type() != TensorProto_DataType_INT8)) {
+    return false;
+  }
+
+  // Initializer only reads 8-bit data from raw or external data
+  if (!utils::HasRawData(*tensor_proto) && tensor_proto->data_location() != TensorProto_DataLocation_EXTERNAL) {
+    return false;
+  }
+
+  if (!IsScalarConstant(graph, *dq_inputs[1], TensorProto_DataType_FLOAT) ||
+      (dq_inputs.size() > 2 && dq_inputs[2]->Exists() &&
+       !IsScalarConstant(graph, *dq_inputs[2], tensor_proto->data_type()))) {
+    return false;
+  }
+
+  weights.dq_node = dq_node;
+  weights.weights = tensor_proto;
+  return true;
+}
+
+// Adds the weights transposed to [num_directions, K, N], as the quantized recurrent operators take them.
+NodeArg& AddTransposedWeights(Graph& graph, const TensorProto& weights) {
+  Initializer initializer(weights, graph.ModelPath());
+  const int64_t num_directions = weights.dims(0);
+  const int64_t N = weights.dims(1);
+  const int64_t K = weights.dims(2);
+
+  const uint8_t* data = initializer.data<uint8_t>();
+  std::vector<uint8_t> transposed(static_cast<size_t>(num_directions * N * K));
+  for (int64_t d = 0; d < num_directions; ++d) {
+    const uint8_t* src = data + d * N * K;
+    uint8_t* dst = transposed.data() + d * N * K;
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        dst[k * N + n] = src[n * K + k];
+      }
+    }
+  }
+
+  TensorProto transposed_proto;
+  transposed_proto.set_name(graph.GenerateNodeArgName(weights.name() + "_transposed"));
+  transposed_proto.set_data_type(weights.data_type());
+  transposed_proto.add_dims(num_directions);
+  transposed_proto.add_dims(K);
+  transposed_proto.add_dims(N);
+  transposed_proto.set_raw_data(transposed.data(), transposed.size());
+
+  return graph_utils::AddInitializer(graph, transposed_proto);
+}
+
+// Returns the zero point input of the DequantizeLinear node, or adds a zero point of 0 if it has none.
+NodeArg& GetZeroPoint(Graph& graph, const Node& dq_node, int32_t data_type) {
+  const auto& dq_inputs = dq_node.InputDefs();
+  if (dq_inputs.size() > 2 && dq_inputs[2]->Exists()) {
+    return *graph.GetNodeArg(dq_inputs[2]->Name());
+  }
+
+  TensorProto zero_point_proto;
+  zero_point_proto.set_name(graph.GenerateNodeArgName("zero_point"));
+  zero_point_proto.set_data_type(data_type);
+  const uint8_t zero_point = 0;
+  zero_point_proto.set_raw_data(&zero_point, sizeof(zero_point));
+
+  return graph_utils::AddInitializer(graph, zero_point_proto);
+}
+
+}  // namespace
+
+/**
+DynamicQuantizeRnnFusion fuses an LSTM or GRU whose weights are dequantized from constant 8-bit tensors:
+
+    (quantized W)   (quantized R)
+          |               |
+          v               v
+  DequantizeLinear  DequantizeLinear                               (X)
+          |               |                                         |
+          v               v                     ---->               v
+  (X) --> LSTM or GRU <---+              DynamicQuantizeLSTM or DynamicQuantizeGRU (transposed quantized W and R)
+               |                                                    |
+               v                                                    v
+
+The weights, scales and zero points must be constant, and quantized per tensor.
+*/
+Status DynamicQuantizeRnnFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                           const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    const bool is_lstm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "LSTM", {7});
+    const bool is_gru = graph_utils::IsSupportedOptypeVersionAndDomain(node, "GRU", {7});
+    if ((!is_lstm && !is_gru) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    DequantizedWeights W, R;
+    if (!MatchDequantizedWeights(graph, node, 1, W) || !MatchDequantizedWeights(graph, node, 2, R)) {
+      continue;
+    }
+
+    // the optional inputs of the float operator, followed by the scales and zero points of W and R
+    const size_t num_float_inputs = is_lstm ? 8 : 6;
+    NodeArg optional_node_arg("", nullptr);
+    std::vector<NodeArg*> input_defs(num_float_inputs, &optional_node_arg);
+    auto& node_inputs = node.MutableInputDefs();
+    for (size_t i = 0; i < node_inputs.size() && i < num_float_inputs; ++i) {
+      input_defs[i] = node_inputs[i];
+    }
+    input_defs[1] = &AddTransposedWeights(graph, *W.weights);
+    input_defs[2] = &AddTransposedWeights(graph, *R.weights);
+    input_defs.push_back(graph.GetNodeArg(W.dq_node->InputDefs()[1]->Name()));
+    input_defs.push_back(&GetZeroPoint(graph, *W.dq_node, W.weights->data_type()));
+    input_defs.push_back(graph.GetNodeArg(R.dq_node->InputDefs()[1]->Name()));
+    input_defs.push_back(&GetZeroPoint(graph, *R.dq_node, R.weights->data_type()));
+
+    const std::string op_type = is_lstm ? "DynamicQuantizeLSTM" : "DynamicQuantizeGRU";
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(op_type),
+                                     op_type,
+                                     "",
+                                     input_defs,
+                                     node.MutableOutputDefs(),
+                                     &node.GetAttributes(),
+                                     kMSDomain);
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    const NodeIndex W_dq_index = W.dq_node->Index();
+    const NodeIndex R_dq_index = R.dq_node->Index();
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.Index());
+    for (NodeIndex dq_index : {W_dq_index, R_dq_index}) {
+      Node& dq_node = *graph.GetNode(dq_index);
+      graph_utils::RemoveNodeOutputEdges(graph, dq_node);
+      graph.RemoveNode(dq_index);
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
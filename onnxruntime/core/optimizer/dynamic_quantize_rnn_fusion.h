@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class DynamicQuantizeRnnFusion
+Fuse LSTM or GRU whose W and R inputs are DequantizeLinear of constant 8-bit weights to DynamicQuantizeLSTM or
+DynamicQuantizeGRU
+*/
+class DynamicQuantizeRnnFusion : public GraphTransformer {
+ public:
+  DynamicQuantizeRnnFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DynamicQuantizeRnnFusion", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,163 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The limits of the programs of the FusedElementwise kernels, see contrib_ops/cpu/fused_elementwise_program.h.
+constexpr size_t kMaxInputs = 16;
+constexpr size_t kMaxSteps = 32;
+
+bool IsFusableNode(const Node& node, const std::unordered_set<std::string>& compatible_providers) {
+  static const std::unordered_map<std::string, std::vector<ONNX_NAMESPACE::OperatorSetVersion>> fusable_ops{
+      {"Add", {7}}, {"Sub", {7}}, {"Mul", {7}}, {"Div", {7}}, {"Sqrt", {6}}, {"Erf", {9}}, {"Tanh", {6}},
+      {"Sigmoid", {6}}, {"Relu", {6}}, {"Exp", {6}}, {"Neg", {6}}, {"Abs", {6}}, {"Reciprocal", {6}}};
+
+  auto op = fusable_ops.find(node.OpType());
+  if (op == fusable_ops.end() || !graph_utils::IsSupportedOptypeVersionAndDomain(node, op->first, op->second) ||
+      !graph_utils::IsSupportedProvider(node, compatible_providers)) {
+    return false;
+  }
+
+  for (const NodeArg* arg : node.InputDefs()) {
+    if (arg->Type() == nullptr || *arg->Type() != "tensor(float)") {
+      return false;
+    }
+  }
+
+  // the ops on the blocked outputs of the NCHWc kernels are left to the NCHWc transformer
+  for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+    if ((*it).Domain() == kMSNchwcDomain) {
+      return false;
+    }
+  }
+  return node.OutputDefs()[0]->Type() != nullptr && *node.OutputDefs()[0]->Type() == "tensor(float)";
+}
+
+// The inputs of a chain, in the order of their first use.
+std::vector<NodeArg*> GetChainInputs(Graph& graph, const std::vector<NodeIndex>& chain) {
+  std::unordered_set<const NodeArg*> outputs;
+  for (auto index : chain) {
+    outputs.insert(graph.GetNode(index)->OutputDefs()[0]);
+  }
+
+  std::vector<NodeArg*> inputs;
+  for (auto index : chain) {
+    for (NodeArg* input : graph.GetNode(index)->MutableInputDefs()) {
+      if (outputs.count(input) == 0 && std::find(inputs.begin(), inputs.end(), input) == inputs.end()) {
+        inputs.push_back(input);
+      }
+    }
+  }
+  return inputs;
+}
+
+void FuseChain(Graph& graph, const std::vector<NodeIndex>& chain) {
+  std::vector<NodeArg*> inputs = GetChainInputs(graph, chain);
+
+  // the operands number the inputs followed by the results of the steps
+  std::unordered_map<const NodeArg*, int64_t> operand_indices;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    operand_indices[inputs[i]] = static_cast<int64_t>(i);
+  }
+
+  std::vector<std::string> ops;
+  std::vector<int64_t> operands;
+  for (auto index : chain) {
+    const Node& node = *graph.GetNode(index);
+    ops.push_back(node.OpType());
+    operands.push_back(operand_indices.at(node.InputDefs()[0]));
+    operands.push_back(node.InputDefs().size() > 1 ? operand_indices.at(node.InputDefs()[1]) : -1);
+    operand_indices[node.OutputDefs()[0]] = static_cast<int64_t>(inputs.size() + ops.size() - 1);
+  }
+
+  Node& last_node = *graph.GetNode(chain.back());
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"),
+                                   "FusedElementwise",
+                                   "fused chain of elementwise ops",
+                                   inputs,
+                                   last_node.MutableOutputDefs(),
+                                   nullptr,
+                                   kMSDomain);
+  fused_node.AddAttribute("ops", ops);
+  fused_node.AddAttribute("operands", operands);
+  // Assign provider to this new node. Provider should be same as the provider for old node.
+  fused_node.SetExecutionProviderType(last_node.GetExecutionProviderType());
+
+  for (auto index : chain) {
+    Node& node = *graph.GetNode(index);
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+  }
+  for (auto index : chain) {
+    graph.RemoveNode(index);
+  }
+}
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the chain ending with each fusable node which isn't yet part of the chain of its consumer, in topological order
+  std::unordered_map<NodeIndex, std::vector<NodeIndex>> chains;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!IsFusableNode(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    std::vector<NodeIndex> chain;
+    for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+      const Node& input_node = *it;
+      auto input_chain = chains.find(input_node.Index());
+      if (input_chain == chains.end() || input_node.GetOutputEdgesCount() != 1 ||
+          !graph.GetNodeOutputsInGraphOutputs(input_node).empty() ||
+          input_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+        continue;
+      }
+
+      std::vector<NodeIndex> merged_chain(chain);
+      merged_chain.insert(merged_chain.end(), input_chain->second.begin(), input_chain->second.end());
+      merged_chain.push_back(node_index);
+      if (merged_chain.size() > kMaxSteps || GetChainInputs(graph, merged_chain).size() > kMaxInputs) {
+        continue;
+      }
+
+      chain.insert(chain.end(), input_chain->second.begin(), input_chain->second.end());
+      chains.erase(input_chain);
+    }
+    chain.push_back(node_index);
+    chains.emplace(node_index, std::move(chain));
+  }
+
+  for (auto node_index : node_topology_list) {
+    auto chain = chains.find(node_index);
+    if (chain != chains.end() && chain->second.size() > 1) {
+      FuseChain(graph, chain->second);
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Fuses the chains of float elementwise ops (Add, Sub, Mul, Div, Sqrt, Erf, Tanh, Sigmoid, Relu, Exp, Neg, Abs and
+Reciprocal) into a FusedElementwise node, which computes the chain in a single pass over memory instead of
+materializing each intermediate tensor.
+
+A node joins the chain of its consumer if its output is only used by that consumer, so a chain is a tree of nodes
+with a single output. The inputs of the chain may be used by several of its nodes, and are broadcast as by the
+fused ops. It runs after the fusions of specific patterns such as GeluFusion and the NCHWc transformer, which fuse
+the elementwise ops into faster kernels.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_bag_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool HasRank(const NodeArg& arg, int rank) {
+  const auto* shape = arg.Shape();
+  return shape != nullptr && shape->dim_size() == rank;
+}
+
+bool IsType(const NodeArg& arg, std::initializer_list<const char*> types) {
+  if (arg.Type() == nullptr) {
+    return false;
+  }
+  for (const char* type : types) {
+    if (*arg.Type() == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Matches a ReduceSum or ReduceMean over axis 1 of a 3D input, without keeping the reduced dim.
+bool IsBagReduction(const Node& node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSum", {1, 11}) &&
+      !graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", {1, 11})) {
+    return false;
+  }
+
+  const auto* keepdims = graph_utils::GetNodeAttribute(node, "keepdims");
+  if (keepdims == nullptr || keepdims->i() != 0) {
+    return false;
+  }
+
+  std::vector<int64_t> axes;
+  return graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes) && axes.size() == 1 &&
+         (axes[0] == 1 || axes[0] == -2);
+}
+
+// Matches a Gather of the rows of a 2D float table with 2D indices, whose output is only used by the reduction.
+bool IsTableGather(const Graph& graph, const Node& node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11}) ||
+      !optimizer_utils::CheckOutputEdges(graph, node, 1)) {
+    return false;
+  }
+
+  const auto* axis = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis != nullptr && axis->i() != 0) {
+    return false;
+  }
+
+  const NodeArg& table = *node.InputDefs()[0];
+  const NodeArg& indices = *node.InputDefs()[1];
+  return HasRank(table, 2) && IsType(table, {"tensor(float)"}) &&
+         HasRank(indices, 2) && IsType(indices, {"tensor(int32)", "tensor(int64)"});
+}
+
+}  // namespace
+
+/**
+EmbeddingBagFusion fuses the bags of an embedding table reduced after a Gather:
+
+       (table)  (indices)                          (table)  (indices)
+           \      /                                    \      /
+            Gather           [batch, bag, dim]  ---->  EmbeddingBag
+              |                                             |
+     ReduceSum or ReduceMean (axes = [1], keepdims = 0)     v
+              |
+              v
+*/
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& reduce_node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(reduce_node, modified, graph_level, logger));
+
+    if (!IsBagReduction(reduce_node) ||
+        !graph_utils::IsSupportedProvider(reduce_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Node* gather_node = graph_utils::GetInputNode(reduce_node, 0);
+    if (gather_node == nullptr || !IsTableGather(graph, *gather_node) ||
+        gather_node->GetExecutionProviderType() != reduce_node.GetExecutionProviderType()) {
+      continue;
+    }
+
+    const std::string mode = reduce_node.OpType() == "ReduceMean" ? "mean" : "sum";
+    const auto& gather_inputs = gather_node->InputDefs();
+    Node& embedding_bag_node = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                                             "EmbeddingBag",
+                                             "fused Gather and " + reduce_node.OpType(),
+                                             {graph.GetNodeArg(gather_inputs[0]->Name()),
+                                              graph.GetNodeArg(gather_inputs[1]->Name())},
+                                             reduce_node.MutableOutputDefs(),
+                                             nullptr,
+                                             kMSDomain);
+    embedding_bag_node.AddAttribute("mode", mode);
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    embedding_bag_node.SetExecutionProviderType(reduce_node.GetExecutionProviderType());
+
+    const NodeIndex gather_index = gather_node->Index();
+    graph_utils::RemoveNodeOutputEdges(graph, reduce_node);
+    graph.RemoveNode(reduce_node.Index());
+    Node& gather = *graph.GetNode(gather_index);
+    graph_utils::RemoveNodeOutputEdges(graph, gather);
+    graph.RemoveNode(gather_index);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -36,6 +36,18 @@ bool IsFusableActivation(const Node& node) {
 #endif
          IsSupportedOptypeVersionAndDomain(node, "ThresholdedRelu", {1, 10}, kOnnxDomain);
 }
+
+// The CUDA FusedGemm applies the activation in a cuBLASLt epilogue, which supports Relu and the tanh
+// approximation of Gelu (FastGelu without a bias input) on float and float16 data.
+bool IsFusableActivationForCuda(const Node& gemm_node, const Node& act_node) {
+  const auto* type = gemm_node.InputDefs()[0]->Type();
+  if (type == nullptr || (*type != "tensor(float)" && *type != "tensor(float16)")) {
+    return false;
+  }
+
+  return IsSupportedOptypeVersionAndDomain(act_node, "Relu", {6}, kOnnxDomain) ||
+         (IsSupportedOptypeVersionAndDomain(act_node, "FastGelu", {1}, kMSDomain) && act_node.InputDefs().size() == 1);
+}
 }  // namespace
 
 Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
@@ -57,7 +69,14 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
     }
 
     const Node& next_node = *(node.OutputNodesBegin());
-    if (!IsFusableActivation(next_node) || next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    if (next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+      continue;
+    }
+
+    const bool is_fusable = node.GetExecutionProviderType() == kCudaExecutionProvider
+                                ? IsFusableActivationForCuda(node, next_node)
+                                : IsFusableActivation(next_node);
+    if (!is_fusable) {
       continue;
     }
 
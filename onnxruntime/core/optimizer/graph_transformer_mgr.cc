@@ -3,6 +3,9 @@
 
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
+#include "core/common/logging/logging.h"
+
+#include <chrono>
 
 using namespace onnxruntime;
 using namespace ::onnxruntime::common;
@@ -29,7 +32,14 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     bool graph_changed = false;
     for (const auto& transformer : transformers->second) {
       bool modified = false;
+      const auto start = std::chrono::high_resolution_clock::now();
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified, logger));
+      // the time includes the Resolve that follows a modification
+      const auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::high_resolution_clock::now() - start);
+      LOGS(logger, INFO) << "GraphTransformer " << transformer->Name() << " step " << step
+                         << (modified ? " modified the graph" : " made no change") << " in "
+                         << duration_us.count() << " us";
       graph_changed = graph_changed || modified;
     }
     if (!graph_changed) {
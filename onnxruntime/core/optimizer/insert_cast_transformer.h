@@ -16,9 +16,11 @@ Transformer to insert cast node that casts float16 to float for cpu nodes
 */
 class InsertCastTransformer : public onnxruntime::GraphTransformer {
  public:
-  InsertCastTransformer(const std::string& name)
+  // force_cpu_fp32 places float16 nodes that are isolated on the CPU on their float32 kernels. It can be turned off
+  // when the CPU computes float16 natively, so that the float16 kernels don't pay for the casts around them.
+  InsertCastTransformer(const std::string& name, bool force_cpu_fp32 = true)
       : onnxruntime::GraphTransformer(name),
-        force_cpu_fp32_(true) {
+        force_cpu_fp32_(force_cpu_fp32) {
   }
 
  private:
@@ -10,21 +10,16 @@ using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::common;
 namespace onnxruntime {
 
-static Node* GetTransposeNodeFromOutput(Graph& graph, NodeArg& node_arg) {
-  Node* trans_node = graph.GetMutableProducerNode(node_arg.Name());
-  if (trans_node == nullptr || trans_node->OpType() != "Transpose") {
-    return nullptr;
-  }
-
-  // if the node has Graph output, skip it too
-  if (!graph.GetNodeOutputsInGraphOutputs(*trans_node).empty()) {
-    return nullptr;
+static bool IsTransposeOfLastTwoDims(const Node& trans_node) {
+  auto perm_attr = trans_node.GetAttributes().find("perm");
+  if (perm_attr == trans_node.GetAttributes().end()) {
+    return false;
   }
 
-  auto perms = RetrieveValues<int64_t>(trans_node->GetAttributes().at("perm"));
+  auto perms = RetrieveValues<int64_t>(perm_attr->second);
   int64_t rank = perms.size();
   if (rank < 2) {
-    return nullptr;
+    return false;
   }
 
   bool is_trans_on_last_two_dims = true;
@@ -39,13 +34,98 @@ static Node* GetTransposeNodeFromOutput(Graph& graph, NodeArg& node_arg) {
     is_trans_on_last_two_dims = perms[rank - 2] == rank - 1 && perms[rank - 1] == rank - 2;
   }
 
-  if (!is_trans_on_last_two_dims) {
+  return is_trans_on_last_two_dims;
+}
+
+static Node* GetTransposeNodeFromOutput(Graph& graph, NodeArg& node_arg) {
+  Node* trans_node = graph.GetMutableProducerNode(node_arg.Name());
+  if (trans_node == nullptr || trans_node->OpType() != "Transpose") {
+    return nullptr;
+  }
+
+  // if the node has Graph output, skip it too
+  if (!graph.GetNodeOutputsInGraphOutputs(*trans_node).empty()) {
+    return nullptr;
+  }
+
+  if (!IsTransposeOfLastTwoDims(*trans_node)) {
     return nullptr;
   }
 
   return trans_node;
 }
 
+// The CPU TransposeMatMul kernel only supports float.
+static bool IsSupportedType(const Node& node) {
+  const auto* type = node.InputDefs()[0]->Type();
+  if (type == nullptr) {
+    return false;
+  }
+  if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+    return *type == "tensor(float)";
+  }
+  return *type == "tensor(float)" || *type == "tensor(float16)" || *type == "tensor(double)";
+}
+
+static bool IsMatMul(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "TransposeMatMul", {1}, kMSDomain);
+}
+
+static bool GetTransposeAttribute(const Node& node, const char* name) {
+  return node.OpType() == "TransposeMatMul" && static_cast<bool>(node.GetAttributes().at(name).i());
+}
+
+// Transpose(MatMul(A, B)) of the last two dims -> TransposeMatMul(B, A, transA=1, transB=1), as (A * B)' = B' * A'.
+static bool FuseTransposeOfOutput(Graph& graph, Node& node, const std::unordered_set<std::string>& providers) {
+  if (!IsMatMul(node) || !graph_utils::IsSupportedProvider(node, providers) || !IsSupportedType(node) ||
+      node.GetOutputEdgesCount() != 1 || !graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+    return false;
+  }
+
+  Node& trans_node = *graph.GetNode(node.OutputNodesBegin()->Index());
+  if (trans_node.OpType() != "Transpose" || !IsTransposeOfLastTwoDims(trans_node) ||
+      trans_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return false;
+  }
+
+  // MatMul prepends or appends a dim to the 1-D inputs, which the swapped inputs would get wrong
+  for (const NodeArg* input : node.InputDefs()) {
+    if (input->Shape() == nullptr || input->Shape()->dim_size() < 2) {
+      return false;
+    }
+  }
+
+  NodeArg* left_input = node.MutableInputDefs()[0];
+  NodeArg* right_input = node.MutableInputDefs()[1];
+  Node& matmul_node = graph.AddNode(graph.GenerateNodeName("MatMul_With_Transpose"),
+                                    "TransposeMatMul",
+                                    "fused MatMul and Transpose ",
+                                    {right_input, left_input},
+                                    {trans_node.MutableOutputDefs()[0]}, {}, kMSDomain);
+  matmul_node.AddAttribute("transA", static_cast<int64_t>(!GetTransposeAttribute(node, "transB")));
+  matmul_node.AddAttribute("transB", static_cast<int64_t>(!GetTransposeAttribute(node, "transA")));
+  // Assign provider to this new node. Provider should be same as the provider for old node.
+  matmul_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  // the inputs are swapped, so move the input edges of the MatMul to the other input
+  std::vector<Node::EdgeEnd> input_edges(node.InputEdgesBegin(), node.InputEdgesEnd());
+  for (const auto& edge : input_edges) {
+    graph.AddEdge(edge.GetNode().Index(), matmul_node.Index(), edge.GetSrcArgIndex(), 1 - edge.GetDstArgIndex());
+  }
+  for (NodeArg* input : {left_input, right_input}) {
+    auto consumers = graph.GetMutableConsumerNodes(input->Name());
+    std::replace(consumers.begin(), consumers.end(), &node, &matmul_node);
+    graph.UpdateConsumerNodes(input->Name(), consumers);
+  }
+  graph.UpdateProducerNode(matmul_node.OutputDefs()[0]->Name(), matmul_node.Index());
+
+  graph_utils::RemoveNodeOutputEdges(graph, node);
+  graph.RemoveNode(node.Index());
+  graph_utils::FinalizeNodeFusion(graph, matmul_node, trans_node);
+  return true;
+}
+
 static size_t UpdateConsumerCount(Graph& graph, NodeArg* target, std::unordered_map<NodeArg*, size_t>& count_map) {
   const auto& node_consumers = graph.GetConsumerNodes(target->Name());
   ORT_ENFORCE(!node_consumers.empty());
@@ -60,6 +140,16 @@ static size_t UpdateConsumerCount(Graph& graph, NodeArg* target, std::unordered_
 }
 
 Status MatmulTransposeFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  {
+    GraphViewer graph_viewer(graph);
+    for (auto node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+      auto* node = graph.GetNode(node_index);
+      if (node != nullptr && FuseTransposeOfOutput(graph, *node, GetCompatibleExecutionProviders())) {
+        modified = true;
+      }
+    }
+  }
+
   GraphViewer graph_viewer(graph);
   const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
   std::deque<onnxruntime::NodeIndex> removed_nodes;
@@ -70,9 +160,8 @@ Status MatmulTransposeFusion::ApplyImpl(Graph& graph, bool& modified, int graph_
     auto& node = *graph.GetNode(node_index);
     ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
 
-    if ((!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {9}) &&
-         !graph_utils::IsSupportedOptypeVersionAndDomain(node, "TransposeMatMul", {1}, kMSDomain)) ||
-        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+    if (!IsMatMul(node) || !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !IsSupportedType(node)) {
       continue;
     }
 
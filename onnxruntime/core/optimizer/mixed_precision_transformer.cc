@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/mixed_precision_transformer.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+// Ops with float16 CUDA kernels that are compute bound, or cheap enough that keeping them in float16 avoids Casts
+// between the compute bound ops.
+static const std::vector<std::string> default_op_allow_list{
+    "Add", "Attention", "AveragePool", "BiasGelu", "Concat", "Conv", "ConvTranspose", "Div", "FastGelu",
+    "Flatten", "Gelu", "Gemm", "GlobalAveragePool", "Identity", "LeakyRelu", "MatMul", "MaxPool", "Mul", "Relu",
+    "Reshape", "Sigmoid", "Squeeze", "Sub", "Tanh", "Transpose", "Unsqueeze"};
+
+// Ops that accumulate or exponentiate, and therefore lose too much accuracy or overflow in float16.
+static const std::vector<std::string> default_op_deny_list{
+    "EmbedLayerNormalization", "Erf", "Exp", "LayerNormalization", "Log", "LogSoftmax", "Pow", "ReduceL2",
+    "ReduceLogSumExp", "ReduceMean", "ReduceSum", "ReduceSumSquare", "SkipLayerNormalization", "Softmax", "Sqrt"};
+
+static bool IsFloatTensor(const NodeArg* arg) {
+  return arg != nullptr && arg->Exists() && arg->Type() != nullptr && *arg->Type() == "tensor(float)";
+}
+
+static NodeArg& CreateFloat16NodeArg(Graph& graph, const NodeArg& arg) {
+  // keep the shape of the float value
+  TypeProto type_proto(*arg.TypeAsProto());
+  type_proto.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(arg.Name() + "_fp16"), &type_proto);
+}
+
+static void AddCastNode(Graph& graph, NodeArg& input, NodeArg& output, TensorProto_DataType to,
+                        const std::string& provider) {
+  Node& cast_node = graph.AddNode(graph.GenerateNodeName("MixedPrecisionCast"), "Cast",
+                                  "Cast node inserted by MixedPrecisionTransformer", {&input}, {&output});
+  cast_node.AddAttribute("to", static_cast<int64_t>(to));
+  cast_node.SetExecutionProviderType(provider);
+}
+
+MixedPrecisionTransformer::MixedPrecisionTransformer(const std::vector<std::string>& op_allow_list,
+                                                     const std::vector<std::string>& op_deny_list,
+                                                     const std::unordered_set<std::string>& compatible_execution_providers)
+    : GraphTransformer("MixedPrecisionTransformer", compatible_execution_providers) {
+  const auto& allow_list = op_allow_list.empty() ? default_op_allow_list : op_allow_list;
+  const auto& deny_list = op_deny_list.empty() ? default_op_deny_list : op_deny_list;
+  op_allow_list_.insert(allow_list.begin(), allow_list.end());
+  op_deny_list_.insert(deny_list.begin(), deny_list.end());
+}
+
+const std::vector<std::string>& MixedPrecisionTransformer::DefaultOpAllowList() {
+  return default_op_allow_list;
+}
+
+const std::vector<std::string>& MixedPrecisionTransformer::DefaultOpDenyList() {
+  return default_op_deny_list;
+}
+
+bool MixedPrecisionTransformer::IsConvertible(const Node& node) const {
+  if ((node.Domain() != kOnnxDomain && node.Domain() != kMSDomain) ||
+      op_allow_list_.find(node.OpType()) == op_allow_list_.end() ||
+      op_deny_list_.find(node.OpType()) != op_deny_list_.end() ||
+      !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+    return false;
+  }
+
+  // only convert nodes computing in float, i.e. with a float input
+  return std::any_of(node.InputDefs().begin(), node.InputDefs().end(), IsFloatTensor);
+}
+
+Status MixedPrecisionTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::unordered_set<NodeIndex> fp16_nodes;
+  std::unordered_set<std::string> implicit_inputs;
+  for (auto index : order) {
+    Node* node = graph.GetNode(index);
+    if (node == nullptr)
+      continue;
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+
+    if (IsConvertible(*node)) {
+      fp16_nodes.insert(index);
+    }
+    for (const NodeArg* implicit_input : node->ImplicitInputDefs()) {
+      implicit_inputs.insert(implicit_input->Name());
+    }
+  }
+
+  if (fp16_nodes.empty()) {
+    return Status::OK();
+  }
+
+  const auto& graph_outputs = graph.GetOutputs();
+
+  // The float16 values replacing the float values consumed by, or produced by, the converted nodes.
+  std::unordered_map<const NodeArg*, NodeArg*> fp16_args;
+
+  for (auto index : order) {
+    if (fp16_nodes.find(index) == fp16_nodes.end())
+      continue;
+
+    Node& node = *graph.GetNode(index);
+    const std::string& provider = node.GetExecutionProviderType();
+    std::map<const NodeArg*, NodeArg*> replacement_defs;
+
+    for (NodeArg* input : node.MutableInputDefs()) {
+      if (!IsFloatTensor(input) || replacement_defs.find(input) != replacement_defs.end())
+        continue;
+
+      auto fp16_arg = fp16_args.find(input);
+      if (fp16_arg == fp16_args.end()) {
+        // the input is a float value from a node that isn't converted, a graph input or an initializer
+        NodeArg& fp16_input = CreateFloat16NodeArg(graph, *input);
+        const TensorProto* initializer = graph_utils::GetConstantInitializer(graph, input->Name(), false);
+        if (initializer != nullptr) {
+          Initializer fp32_initializer{*initializer, graph.ModelPath()};
+          graph.AddInitializedTensor(fp32_initializer.ToFP16(fp16_input.Name()));
+        } else {
+          AddCastNode(graph, *input, fp16_input, TensorProto_DataType_FLOAT16, provider);
+        }
+        fp16_arg = fp16_args.emplace(input, &fp16_input).first;
+      }
+      replacement_defs[input] = fp16_arg->second;
+    }
+
+    for (NodeArg* output : node.MutableOutputDefs()) {
+      if (!IsFloatTensor(output))
+        continue;
+
+      NodeArg& fp16_output = CreateFloat16NodeArg(graph, *output);
+      fp16_args[output] = &fp16_output;
+      replacement_defs[output] = &fp16_output;
+
+      // cast the output back to float if it's a graph output or it has consumers that aren't converted
+      bool float_consumer = std::find(graph_outputs.begin(), graph_outputs.end(), output) != graph_outputs.end() ||
+                            implicit_inputs.find(output->Name()) != implicit_inputs.end();
+      for (const Node* consumer : graph.GetConsumerNodes(output->Name())) {
+        float_consumer = float_consumer || fp16_nodes.find(consumer->Index()) == fp16_nodes.end();
+      }
+      if (float_consumer) {
+        AddCastNode(graph, fp16_output, *output, TensorProto_DataType_FLOAT, provider);
+      }
+    }
+
+    node.ReplaceDefs(replacement_defs);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
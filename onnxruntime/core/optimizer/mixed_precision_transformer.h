@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MixedPrecisionTransformer
+
+Rewrite graph to run the float nodes assigned to the compatible execution providers (CUDA by default) in float16, so
+that they can use Tensor Cores. A node is converted if its op type is in the allow list and not in the deny list.
+By default the allow list has the compute bound ops and the cheap ops around them that have float16 kernels, and the
+deny list has the ops that are numerically sensitive in float16, such as Softmax, LayerNormalization and the
+reductions. Constant initializers consumed by converted nodes are converted to float16, and Cast nodes are only
+inserted where a float16 value is consumed by a float node or a float value by a float16 node.
+*/
+class MixedPrecisionTransformer : public GraphTransformer {
+ public:
+  MixedPrecisionTransformer(const std::vector<std::string>& op_allow_list = {},
+                            const std::vector<std::string>& op_deny_list = {},
+                            const std::unordered_set<std::string>& compatible_execution_providers = {kCudaExecutionProvider});
+
+  static const std::vector<std::string>& DefaultOpAllowList();
+  static const std::vector<std::string>& DefaultOpDenyList();
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  bool IsConvertible(const Node& node) const;
+
+  std::unordered_set<std::string> op_allow_list_;
+  std::unordered_set<std::string> op_deny_list_;
+};
+
+}  // namespace onnxruntime
@@ -103,6 +103,10 @@ class NchwcTransformerImpl {
     }
   };
 
+  // Returns the index of the optional Sum input of a NCHWc node that supports
+  // the Add/Sum and activation fusions, or -1 otherwise.
+  static int GetSumInputIndex(const Node& node);
+
   size_t RemoveOutputEdges(Node& node);
   void CreateNchwcArgument(Node& node, Node& nchwc_node, int64_t channels, const NchwcArgument::Shape& shape);
   void FuseNchwcArgument(Node& node, const NchwcArgument& nchwc_arg);
@@ -145,6 +149,20 @@ class NchwcTransformerImpl {
   std::unordered_map<NodeArg*, NodeArg*> aligned_biases_;
 };
 
+int NchwcTransformerImpl::GetSumInputIndex(const Node& node) {
+  if (node.Domain() == kMSNchwcDomain) {
+    const auto& op_type = node.OpType();
+    if (op_type == "Conv") {
+      return 3;
+    }
+    if (op_type == "MaxPool" || op_type == "AveragePool" || op_type == "GlobalMaxPool" ||
+        op_type == "GlobalAveragePool" || op_type == "Upsample") {
+      return 1;
+    }
+  }
+  return -1;
+}
+
 size_t NchwcTransformerImpl::RemoveOutputEdges(Node& node) {
   size_t output_edges_count = node.GetOutputEdgesCount();
   if (output_edges_count > 0) {
@@ -555,8 +573,10 @@ void NchwcTransformerImpl::TransformBinary(Node& node, bool add_node) {
     nchwc_inputs[n]->remaining_original_uses_--;
   }
 
-  // If one of the inputs to the Add/Sum node is a NCHWc convolution, then
-  // attempt to fuse the addition into the convolution itself.
+  // If one of the inputs to the Add/Sum node is a NCHWc convolution, pooling
+  // or upsample, then attempt to fuse the addition into that node itself. The
+  // node's output is then allocated inplace with the other input if possible,
+  // as for the skip connection of a residual block.
   if (add_node && input_defs_count == 2) {
     for (size_t n = 0; n < 2; n++) {
       auto* nchwc_input_n = nchwc_inputs[n];
@@ -564,24 +584,25 @@ void NchwcTransformerImpl::TransformBinary(Node& node, bool add_node) {
       auto& nchwc_input_defs = nchwc_node.MutableInputDefs();
       auto& nchwc_input_args_count = nchwc_node.MutableInputArgsCount();
       size_t nchwc_input_defs_count = nchwc_input_defs.size();
-      // Check if this is a single use NCHWc convolution that hasn't already
-      // been fused with another Add/Sum node. The Add/Sum can also only be
-      // fused if the convolution isn't itself fused with an activation.
-      if ((nchwc_node.OpType() == "Conv") && (nchwc_node.Domain() == kMSNchwcDomain) &&
-          (nchwc_input_defs_count < 4) && (nchwc_input_args_count.size() < 4) &&
+      int sum_input_index = GetSumInputIndex(nchwc_node);
+      // Check if this is a single use NCHWc node that hasn't already been
+      // fused with another Add/Sum node. The Add/Sum can also only be fused if
+      // the node isn't itself fused with an activation.
+      if ((sum_input_index > 0) &&
+          (nchwc_input_defs_count <= static_cast<size_t>(sum_input_index)) &&
+          (nchwc_input_args_count.size() <= static_cast<size_t>(sum_input_index)) &&
           (nchwc_input_n->starting_original_uses_ == 1) &&
           (graph_utils::GetNodeAttribute(nchwc_node, "activation") == nullptr)) {
-        // Feed the output of the other NCHWc node into the selected convolution
-        // node.
-        nchwc_input_defs.resize(4);
-        nchwc_input_args_count.resize(4);
-        if (nchwc_input_defs_count < 3) {
-          // The optional bias parameter is empty so set to an empty string.
-          nchwc_input_defs[2] = &graph_.GetOrCreateNodeArg("", nullptr);
-          nchwc_input_args_count[2] = 1;
+        // Feed the output of the other NCHWc node into the selected node.
+        nchwc_input_defs.resize(sum_input_index + 1);
+        nchwc_input_args_count.resize(sum_input_index + 1);
+        for (size_t i = nchwc_input_defs_count; i < static_cast<size_t>(sum_input_index); i++) {
+          // The optional parameters such as the bias are empty so set to an empty string.
+          nchwc_input_defs[i] = &graph_.GetOrCreateNodeArg("", nullptr);
+          nchwc_input_args_count[i] = 1;
         }
-        nchwc_input_defs[3] = nchwc_inputs[n ^ 1]->output_node_.MutableOutputDefs()[0];
-        nchwc_input_args_count[3] = 1;
+        nchwc_input_defs[sum_input_index] = nchwc_inputs[n ^ 1]->output_node_.MutableOutputDefs()[0];
+        nchwc_input_args_count[sum_input_index] = 1;
 
         FuseNchwcArgument(node, *nchwc_input_n);
         removed_nodes_.push_front(node.Index());
@@ -651,10 +672,10 @@ void NchwcTransformerImpl::TransformActivation(Node& node) {
     input_defs[0] = nchwc_input->nchwc_arg_;
     nchwc_input->remaining_original_uses_--;
 
-    // Check if this is a single use NCHWc convolution that hasn't already
-    // been fused with another activation.
+    // Check if this is a single use NCHWc convolution, pooling or upsample
+    // that hasn't already been fused with another activation.
     auto& nchwc_node = nchwc_input->output_node_;
-    if ((nchwc_node.OpType() == "Conv") && (nchwc_node.Domain() == kMSNchwcDomain) &&
+    if ((GetSumInputIndex(nchwc_node) > 0) &&
         (nchwc_input->starting_original_uses_ == 1) &&
         (graph_utils::GetNodeAttribute(nchwc_node, "activation") == nullptr)) {
       nchwc_node.AddAttribute("activation", node.OpType());
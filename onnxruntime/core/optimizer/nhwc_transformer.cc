@@ -0,0 +1,424 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/nhwc_transformer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+class NhwcTransformerImpl {
+ public:
+  NhwcTransformerImpl(Graph& graph) noexcept : graph_(graph) {}
+
+  void Transform(Node& node);
+  void Finalize(bool& modified);
+
+ private:
+  // Associate the following state with each created NHWC output keyed off the
+  // original NodeArg.
+  struct NhwcArgument {
+    // Stores the NodeArg that represents the NHWC output.
+    NodeArg* nhwc_arg_;
+
+    // Stores the remaining number of uses for the original NodeArg. The count
+    // is decremented as uses are converted to NHWC format. A Transpose node is
+    // inserted to restore the NCHW output if this count is non-zero.
+    size_t remaining_original_uses_;
+
+    NhwcArgument(NodeArg* output_nhwc_arg, size_t original_uses)
+        : nhwc_arg_(output_nhwc_arg),
+          remaining_original_uses_(original_uses) {
+    }
+  };
+
+  static bool IsFloat16Tensor(const NodeArg& arg);
+
+  size_t RemoveOutputEdges(Node& node);
+  void CreateNhwcArgument(Node& node, Node& nhwc_node);
+  Node& AddTranspose(NodeArg& input_arg, NodeArg& output_arg, const std::vector<int64_t>& perm);
+  void InsertTransposeInput(Node& node);
+  NhwcArgument* FindNhwcInput(Node& node);
+
+  void TransformConv(Node& node);
+  void TransformPool(Node& node);
+  void TransformBatchNormalization(Node& node);
+  void TransformElementwise(Node& node);
+
+  Graph& graph_;
+
+  // Stores a queue of nodes to be removed after walking through the graph.
+  std::deque<NodeIndex> removed_nodes_;
+
+  // Stores a mapping from the original NodeArg outputs to the NHWC variants
+  // created inside this graph transform.
+  std::unordered_map<NodeArg*, std::unique_ptr<NhwcArgument>> nhwc_args_;
+
+  // Stores a mapping of NodeArg inputs that have already been transposed, so
+  // multiple nodes can share the NHWC input.
+  std::unordered_map<NodeArg*, NodeArg*> transposed_inputs_;
+
+  // Stores a mapping of the weights that have already been transposed from
+  // OIHW to OHWI, so multiple nodes can share the transposed filter.
+  std::unordered_map<NodeArg*, NodeArg*> filters_OHWI_;
+};
+
+bool NhwcTransformerImpl::IsFloat16Tensor(const NodeArg& arg) {
+  const auto* type_proto = arg.TypeAsProto();
+  return type_proto != nullptr &&
+         type_proto->has_tensor_type() &&
+         type_proto->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16;
+}
+
+size_t NhwcTransformerImpl::RemoveOutputEdges(Node& node) {
+  size_t output_edges_count = node.GetOutputEdgesCount();
+  if (output_edges_count > 0) {
+    graph_utils::RemoveNodeOutputEdges(graph_, node);
+  }
+  // Bias the edge count to handle the case of a node that produces a graph
+  // output.
+  if (!graph_.GetNodeOutputsInGraphOutputs(node).empty()) {
+    output_edges_count++;
+  }
+  return output_edges_count;
+}
+
+void NhwcTransformerImpl::CreateNhwcArgument(Node& node, Node& nhwc_node) {
+  size_t original_uses = RemoveOutputEdges(node);
+
+  // Create a new NodeArg to track the output from the NHWC node.
+  auto& output_defs = nhwc_node.MutableOutputDefs();
+  auto* output_original_arg = output_defs[0];
+  std::string output_nhwc_def_name = graph_.GenerateNodeArgName("nhwc");
+  auto* output_nhwc_arg = &graph_.GetOrCreateNodeArg(output_nhwc_def_name, nullptr);
+  nhwc_args_[output_original_arg] = onnxruntime::make_unique<NhwcArgument>(output_nhwc_arg, original_uses);
+  output_defs[0] = output_nhwc_arg;
+}
+
+Node& NhwcTransformerImpl::AddTranspose(NodeArg& input_arg, NodeArg& output_arg, const std::vector<int64_t>& perm) {
+  Node& transpose_node = graph_.AddNode(graph_.GenerateNodeName("Transpose"),
+                                        "Transpose",
+                                        "Transpose",
+                                        {&input_arg},
+                                        {&output_arg});
+  transpose_node.SetExecutionProviderType(kCudaExecutionProvider);
+  transpose_node.AddAttribute("perm", perm);
+  return transpose_node;
+}
+
+void NhwcTransformerImpl::InsertTransposeInput(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto* input_original_arg = input_defs[0];
+
+  auto it = transposed_inputs_.find(input_original_arg);
+  if (it == transposed_inputs_.end()) {
+    std::string input_nhwc_def_name = graph_.GenerateNodeArgName("nhwc");
+    auto* input_nhwc_arg = &graph_.GetOrCreateNodeArg(input_nhwc_def_name, nullptr);
+    transposed_inputs_[input_original_arg] = input_nhwc_arg;
+    AddTranspose(*input_original_arg, *input_nhwc_arg, {0, 2, 3, 1});
+    input_defs[0] = input_nhwc_arg;
+  } else {
+    input_defs[0] = it->second;
+  }
+}
+
+NhwcTransformerImpl::NhwcArgument* NhwcTransformerImpl::FindNhwcInput(Node& node) {
+  auto it = nhwc_args_.find(node.MutableInputDefs()[0]);
+  return it != nhwc_args_.end() ? it->second.get() : nullptr;
+}
+
+void NhwcTransformerImpl::TransformConv(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  auto* input_shape = input_defs[0]->Shape();
+  if ((input_shape == nullptr) || (input_shape->dim_size() != 4)) {
+    return;
+  }
+
+  // Require that the weights tensor be static, as it is transposed here.
+  const ONNX_NAMESPACE::TensorProto* conv_W_tensor_proto = nullptr;
+  if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[1]) ||
+      !graph_.GetInitializedTensor(input_defs[1]->Name(), conv_W_tensor_proto) ||
+      (conv_W_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16) ||
+      (conv_W_tensor_proto->dims_size() != 4)) {
+    return;
+  }
+
+  NodeArg* nhwc_conv_W_arg;
+  auto filters_it = filters_OHWI_.find(input_defs[1]);
+  if (filters_it != filters_OHWI_.end()) {
+    // Reuse the existing NodeArg.
+    nhwc_conv_W_arg = filters_it->second;
+  } else {
+    Initializer conv_W{*conv_W_tensor_proto, graph_.ModelPath()};
+    const auto& dims = conv_W.dims();
+    const int64_t output_channels = dims[0];
+    const int64_t input_channels = dims[1];
+    const int64_t kernel_size = dims[2] * dims[3];
+
+    // Transpose the weights tensor statically from OIHW to OHWI.
+    const MLFloat16* source = conv_W.data<MLFloat16>();
+    std::vector<MLFloat16> transposed_filter(static_cast<size_t>(conv_W.size()));
+    for (int64_t o = 0; o < output_channels; o++) {
+      for (int64_t i = 0; i < input_channels; i++) {
+        for (int64_t k = 0; k < kernel_size; k++) {
+          transposed_filter[(o * kernel_size + k) * input_channels + i] =
+              source[(o * input_channels + i) * kernel_size + k];
+        }
+      }
+    }
+
+    ONNX_NAMESPACE::TensorProto nhwc_conv_W_tensor_proto;
+
+    nhwc_conv_W_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT16);
+    nhwc_conv_W_tensor_proto.set_name(graph_.GenerateNodeArgName("nhwc"));
+    nhwc_conv_W_tensor_proto.set_raw_data(transposed_filter.data(), transposed_filter.size() * sizeof(MLFloat16));
+
+    nhwc_conv_W_tensor_proto.add_dims(output_channels);
+    nhwc_conv_W_tensor_proto.add_dims(dims[2]);
+    nhwc_conv_W_tensor_proto.add_dims(dims[3]);
+    nhwc_conv_W_tensor_proto.add_dims(input_channels);
+
+    nhwc_conv_W_arg = &graph_utils::AddInitializer(graph_, nhwc_conv_W_tensor_proto);
+    filters_OHWI_.emplace(input_defs[1], nhwc_conv_W_arg);
+  }
+
+  // Create the replacement node.
+  std::string nhwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   "Conv",
+                                   nhwc_node_name,
+                                   input_defs,
+                                   output_defs,
+                                   &node.GetAttributes(),
+                                   kMSNhwcDomain);
+  nhwc_node.SetExecutionProviderType(kCudaExecutionProvider);
+
+  nhwc_node.MutableInputDefs()[1] = nhwc_conv_W_arg;
+
+  auto* nhwc_input = FindNhwcInput(node);
+  if (nhwc_input == nullptr) {
+    InsertTransposeInput(nhwc_node);
+  } else {
+    nhwc_node.MutableInputDefs()[0] = nhwc_input->nhwc_arg_;
+    nhwc_input->remaining_original_uses_--;
+  }
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+// Pooling is only converted when its input is already in NHWC format, as the
+// pooling alone doesn't gain enough to pay for transposing its input.
+void NhwcTransformerImpl::TransformPool(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if MaxPool has the optional index tensor specified.
+  if (output_defs.size() > 1) {
+    return;
+  }
+
+  // The NHWC pooling doesn't support dilations or the column major storage
+  // order of the MaxPool indices.
+  const auto* dilations_attr = graph_utils::GetNodeAttribute(node, "dilations");
+  if (dilations_attr != nullptr) {
+    for (auto dilation : dilations_attr->ints()) {
+      if (dilation != 1) {
+        return;
+      }
+    }
+  }
+
+  auto* nhwc_input = FindNhwcInput(node);
+  if (nhwc_input == nullptr) {
+    return;
+  }
+
+  // Create the replacement node without the attributes that the NHWC schema
+  // doesn't define.
+  NodeAttributes nhwc_attributes = node.GetAttributes();
+  nhwc_attributes.erase("dilations");
+  nhwc_attributes.erase("storage_order");
+
+  std::string nhwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   node.OpType(),
+                                   nhwc_node_name,
+                                   input_defs,
+                                   output_defs,
+                                   &nhwc_attributes,
+                                   kMSNhwcDomain);
+  nhwc_node.SetExecutionProviderType(kCudaExecutionProvider);
+
+  nhwc_node.MutableInputDefs()[0] = nhwc_input->nhwc_arg_;
+  nhwc_input->remaining_original_uses_--;
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+void NhwcTransformerImpl::TransformBatchNormalization(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if the node has the optional training outputs specified.
+  if (output_defs.size() > 1) {
+    return;
+  }
+
+  // Require spatial batch normalization, which normalizes each channel.
+  const auto* spatial_attr = graph_utils::GetNodeAttribute(node, "spatial");
+  if (spatial_attr != nullptr && utils::HasInt(*spatial_attr) && spatial_attr->i() != 1) {
+    return;
+  }
+
+  auto* nhwc_input = FindNhwcInput(node);
+  if (nhwc_input == nullptr) {
+    return;
+  }
+
+  NodeAttributes nhwc_attributes;
+  const auto* epsilon_attr = graph_utils::GetNodeAttribute(node, "epsilon");
+  if (epsilon_attr != nullptr) {
+    nhwc_attributes["epsilon"] = *epsilon_attr;
+  }
+
+  std::string nhwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   "BatchNormalization",
+                                   nhwc_node_name,
+                                   input_defs,
+                                   output_defs,
+                                   &nhwc_attributes,
+                                   kMSNhwcDomain);
+  nhwc_node.SetExecutionProviderType(kCudaExecutionProvider);
+
+  nhwc_node.MutableInputDefs()[0] = nhwc_input->nhwc_arg_;
+  nhwc_input->remaining_original_uses_--;
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+// The elementwise operators are layout agnostic, so an activation can directly
+// use a NHWC input, and so can an Add/Sum/Mul if all of its inputs are NHWC
+// tensors of the same shape (no broadcasting).
+void NhwcTransformerImpl::TransformElementwise(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  std::vector<NhwcArgument*> nhwc_inputs;
+  size_t input_defs_count = input_defs.size();
+  nhwc_inputs.reserve(input_defs_count);
+  for (size_t i = 0; i < input_defs_count; i++) {
+    auto it = nhwc_args_.find(input_defs[i]);
+    if (it == nhwc_args_.end()) {
+      return;
+    }
+    nhwc_inputs.push_back(it->second.get());
+  }
+
+  if (input_defs_count > 1) {
+    auto* input_0_shape = input_defs[0]->Shape();
+    if (input_0_shape == nullptr) {
+      return;
+    }
+    for (size_t n = 1; n < input_defs_count; n++) {
+      auto* input_n_shape = input_defs[n]->Shape();
+      if ((input_n_shape == nullptr) || (input_n_shape->dim_size() != input_0_shape->dim_size())) {
+        return;
+      }
+      for (int i = 0; i < input_0_shape->dim_size(); i++) {
+        auto& input_0_dim = input_0_shape->dim(i);
+        auto& input_n_dim = input_n_shape->dim(i);
+        if (!utils::HasDimValue(input_0_dim) ||
+            !utils::HasDimValue(input_n_dim) ||
+            (input_0_dim.dim_value() != input_n_dim.dim_value())) {
+          return;
+        }
+      }
+    }
+  }
+
+  // Update the node to use the NHWC inputs directly and decrement the original
+  // use counts of the NHWC inputs.
+  for (size_t n = 0; n < input_defs_count; n++) {
+    input_defs[n] = nhwc_inputs[n]->nhwc_arg_;
+    nhwc_inputs[n]->remaining_original_uses_--;
+  }
+
+  CreateNhwcArgument(node, node);
+}
+
+void NhwcTransformerImpl::Transform(Node& node) {
+  // Only float16 nodes are converted, as cuDNN only runs NHWC convolutions
+  // faster than NCHW ones on Tensor Cores.
+  if (node.InputDefs().empty() || !IsFloat16Tensor(*node.InputDefs()[0])) {
+    return;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11})) {
+    TransformConv(node);
+  } else if (node.GetInputEdgesCount() == 0) {
+    // The following transforms only run when the input edge count has already
+    // been decremented to zero by earlier transforms, which is a hint that the
+    // inputs of the node have been converted to NHWC format.
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10, 11, 12}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {7, 10, 11})) {
+      TransformPool(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9})) {
+      TransformBatchNormalization(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7})) {
+      TransformElementwise(node);
+    }
+  }
+
+  // Nodes that are not transformed may still use an input produced by a NHWC
+  // node. Finalize() inserts the Transpose nodes that restore these inputs to
+  // NCHW format.
+}
+
+void NhwcTransformerImpl::Finalize(bool& modified) {
+  // Create Transpose nodes for any NHWC outputs that still have uses with the
+  // original tensor format.
+  for (auto& nhwc_output : nhwc_args_) {
+    if (nhwc_output.second->remaining_original_uses_ > 0) {
+      AddTranspose(*nhwc_output.second->nhwc_arg_, *nhwc_output.first, {0, 3, 1, 2});
+    }
+  }
+
+  for (auto index : removed_nodes_) {
+    graph_.RemoveNode(index);
+  }
+
+  if (!nhwc_args_.empty()) {
+    modified = true;
+  }
+}
+
+Status NhwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  NhwcTransformerImpl impl(graph);
+  GraphViewer graph_viewer(graph);
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+    if (node.GetExecutionProviderType() == kCudaExecutionProvider) {
+      impl.Transform(node);
+    }
+  }
+  impl.Finalize(modified);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class NhwcTransformer
+
+Transformer that optimizes the graph by using NHWC nodes instead of NCHW nodes
+for the float16 convolutions, pooling and batch normalizations assigned to the
+CUDA execution provider, so that cuDNN can run them on Tensor Cores without
+transposing each tensor. Transpose nodes are inserted where a NHWC tensor meets
+a node that requires the NCHW layout.
+*/
+class NhwcTransformer : public GraphTransformer {
+ public:
+  NhwcTransformer() noexcept : GraphTransformer("NhwcTransformer") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
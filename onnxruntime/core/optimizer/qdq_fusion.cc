@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_fusion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// A DequantizeLinear -> op -> QuantizeLinear group.
+struct QDQGroup {
+  const char* fused_op_type = nullptr;
+  const char* fused_domain = kOnnxDomain;
+  // the DequantizeLinear nodes of the two quantized inputs of the op
+  const Node* dq_nodes[2] = {nullptr, nullptr};
+  // the DequantizeLinear of the int32 bias of Conv, if any
+  const Node* bias_dq_node = nullptr;
+  const Node* q_node = nullptr;
+  int32_t quantized_type = TensorProto_DataType_UNDEFINED;
+};
+
+bool IsDequantizeLinear(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "DequantizeLinear", {10});
+}
+
+bool IsQuantizeLinear(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "QuantizeLinear", {10});
+}
+
+int32_t GetElementType(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return TensorProto_DataType_UNDEFINED;
+  }
+  return type->tensor_type().elem_type();
+}
+
+const Node* GetDequantizeLinearInput(const Node& node, int input_idx) {
+  const Node* input_node = graph_utils::GetInputNode(node, input_idx);
+  return input_node != nullptr && IsDequantizeLinear(*input_node) ? input_node : nullptr;
+}
+
+const Node* GetQuantizeLinearOutput(const Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() != 1 || !graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+    return nullptr;
+  }
+  const Node& output_node = *node.OutputNodesBegin();
+  return IsQuantizeLinear(output_node) ? &output_node : nullptr;
+}
+
+bool IsScalarFloatConstant(const Graph& graph, const NodeArg& arg) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+  for (auto dim : tensor_proto->dims()) {
+    if (dim != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The bias of QLinearConv is int32 with the scale X_scale * W_scale and a zero point of 0. A float constant bias can
+// be quantized if the scales are constants.
+bool IsSupportedConvBias(const Graph& graph, const Node& conv_node, QDQGroup& group) {
+  const auto& conv_inputs = conv_node.InputDefs();
+  if (conv_inputs.size() < 3 || !conv_inputs[2]->Exists()) {
+    return true;
+  }
+
+  group.bias_dq_node = GetDequantizeLinearInput(conv_node, 2);
+  if (group.bias_dq_node != nullptr) {
+    return GetElementType(*group.bias_dq_node->InputDefs()[0]) == TensorProto_DataType_INT32;
+  }
+
+  const TensorProto* bias = graph_utils::GetConstantInitializer(graph, conv_inputs[2]->Name());
+  return bias != nullptr && bias->data_type() == TensorProto_DataType_FLOAT &&
+         IsScalarFloatConstant(graph, *group.dq_nodes[0]->InputDefs()[1]) &&
+         IsScalarFloatConstant(graph, *group.dq_nodes[1]->InputDefs()[1]);
+}
+
+bool MatchQDQGroup(const Graph& graph, const Node& node, QDQGroup& group) {
+  // the types supported by the CPU kernels
+  std::vector<int32_t> quantized_types{TensorProto_DataType_UINT8};
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11})) {
+    group.fused_op_type = "QLinearConv";
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) {
+    group.fused_op_type = "QLinearMatMul";
+#ifndef DISABLE_CONTRIB_OPS
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7})) {
+    group.fused_op_type = "QLinearAdd";
+    group.fused_domain = kMSDomain;
+    quantized_types.push_back(TensorProto_DataType_INT8);
+#endif
+  } else {
+    return false;
+  }
+
+  group.q_node = GetQuantizeLinearOutput(graph, node);
+  if (group.q_node == nullptr) {
+    return false;
+  }
+
+  // the inputs and the output are quantized to the same type
+  group.quantized_type = GetElementType(*group.q_node->OutputDefs()[0]);
+  if (std::find(quantized_types.begin(), quantized_types.end(), group.quantized_type) == quantized_types.end()) {
+    return false;
+  }
+  for (int i = 0; i < 2; ++i) {
+    group.dq_nodes[i] = GetDequantizeLinearInput(node, i);
+    if (group.dq_nodes[i] == nullptr || GetElementType(*group.dq_nodes[i]->InputDefs()[0]) != group.quantized_type) {
+      return false;
+    }
+  }
+
+  return node.OpType() != "Conv" || IsSupportedConvBias(graph, node, group);
+}
+
+// The zero point of a DequantizeLinear or QuantizeLinear node, which defaults to 0.
+NodeArg& GetZeroPoint(Graph& graph, const Node& node, int32_t quantized_type) {
+  const auto& inputs = node.InputDefs();
+  if (inputs.size() > 2 && inputs[2]->Exists()) {
+    return *graph.GetNodeArg(inputs[2]->Name());
+  }
+
+  TensorProto zero_point;
+  zero_point.set_name(graph.GenerateNodeArgName(node.Name() + "_zero_point"));
+  zero_point.set_data_type(quantized_type);
+  zero_point.set_raw_data(std::string(1, '\0'));
+  return graph_utils::AddInitializer(graph, zero_point);
+}
+
+NodeArg& QuantizeBias(Graph& graph, const NodeArg& bias, const NodeArg& x_scale, const NodeArg& w_scale) {
+  Initializer bias_data{*graph_utils::GetConstantInitializer(graph, bias.Name()), graph.ModelPath()};
+  Initializer x_scale_data{*graph_utils::GetConstantInitializer(graph, x_scale.Name()), graph.ModelPath()};
+  Initializer w_scale_data{*graph_utils::GetConstantInitializer(graph, w_scale.Name()), graph.ModelPath()};
+  const double scale = static_cast<double>(*x_scale_data.data<float>()) * *w_scale_data.data<float>();
+
+  std::vector<int32_t> quantized_data(static_cast<size_t>(bias_data.size()));
+  const float* data = bias_data.data<float>();
+  for (size_t i = 0; i < quantized_data.size(); ++i) {
+    double value = scale != 0 ? std::nearbyint(data[i] / scale) : 0;
+    value = std::max(value, static_cast<double>(std::numeric_limits<int32_t>::min()));
+    value = std::min(value, static_cast<double>(std::numeric_limits<int32_t>::max()));
+    quantized_data[i] = static_cast<int32_t>(value);
+  }
+
+  TensorProto quantized_bias;
+  quantized_bias.set_name(graph.GenerateNodeArgName(bias.Name() + "_quantized"));
+  quantized_bias.set_data_type(TensorProto_DataType_INT32);
+  for (auto dim : bias_data.dims()) {
+    quantized_bias.add_dims(dim);
+  }
+  quantized_bias.set_raw_data(quantized_data.data(), quantized_data.size() * sizeof(int32_t));
+  return graph_utils::AddInitializer(graph, quantized_bias);
+}
+
+// A DequantizeLinear is removed with the group unless its output has other consumers.
+bool CanRemoveDequantizeLinear(const Graph& graph, const Node& dq_node) {
+  return dq_node.GetOutputEdgesCount() == 1 && graph.GetNodeOutputsInGraphOutputs(dq_node).empty();
+}
+
+void FuseQDQGroup(Graph& graph, Node& node, const QDQGroup& group) {
+  std::vector<NodeArg*> input_defs;
+  for (const Node* dq_node : group.dq_nodes) {
+    input_defs.push_back(graph.GetNodeArg(dq_node->InputDefs()[0]->Name()));
+    input_defs.push_back(graph.GetNodeArg(dq_node->InputDefs()[1]->Name()));
+    input_defs.push_back(&GetZeroPoint(graph, *dq_node, group.quantized_type));
+  }
+  input_defs.push_back(graph.GetNodeArg(group.q_node->InputDefs()[1]->Name()));
+  input_defs.push_back(&GetZeroPoint(graph, *group.q_node, group.quantized_type));
+
+  if (node.OpType() == "Conv" && node.InputDefs().size() > 2 && node.InputDefs()[2]->Exists()) {
+    if (group.bias_dq_node != nullptr) {
+      input_defs.push_back(graph.GetNodeArg(group.bias_dq_node->InputDefs()[0]->Name()));
+    } else {
+      input_defs.push_back(&QuantizeBias(graph, *node.InputDefs()[2], *group.dq_nodes[0]->InputDefs()[1],
+                                         *group.dq_nodes[1]->InputDefs()[1]));
+    }
+  }
+
+  Node& q_node = *graph.GetNode(group.q_node->Index());
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_quant"),
+                                   group.fused_op_type,
+                                   "fused " + node.OpType() + " of quantized inputs",
+                                   input_defs,
+                                   q_node.MutableOutputDefs(),
+                                   &node.GetAttributes(),
+                                   group.fused_domain);
+  // Assign provider to this new node. Provider should be same as the provider for old node.
+  fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  std::vector<std::reference_wrapper<Node>> nodes_to_remove{q_node, node};
+  for (const Node* dq_node : {group.dq_nodes[0], group.dq_nodes[1], group.bias_dq_node}) {
+    if (dq_node != nullptr && CanRemoveDequantizeLinear(graph, *dq_node)) {
+      nodes_to_remove.push_back(*graph.GetNode(dq_node->Index()));
+    }
+  }
+
+  for (auto& node_to_remove : nodes_to_remove) {
+    graph_utils::RemoveNodeOutputEdges(graph, node_to_remove);
+  }
+  for (auto& node_to_remove : nodes_to_remove) {
+    graph.RemoveNode(node_to_remove.get().Index());
+  }
+}
+
+}  // namespace
+
+bool QDQFusion::IsFusableDequantizeLinear(const Graph& graph, const Node& node) {
+  if (!IsDequantizeLinear(node)) {
+    return false;
+  }
+
+  for (auto it = node.OutputNodesBegin(); it != node.OutputNodesEnd(); ++it) {
+    QDQGroup group;
+    if (MatchQDQGroup(graph, *it, group) &&
+        (group.dq_nodes[0] == &node || group.dq_nodes[1] == &node || group.bias_dq_node == &node)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Status QDQFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    QDQGroup group;
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !MatchQDQGroup(graph, node, group)) {
+      continue;
+    }
+
+    // the whole group must run on the provider of the op
+    bool same_provider = group.q_node->GetExecutionProviderType() == node.GetExecutionProviderType();
+    for (const Node* dq_node : {group.dq_nodes[0], group.dq_nodes[1], group.bias_dq_node}) {
+      same_provider = same_provider &&
+                      (dq_node == nullptr || dq_node->GetExecutionProviderType() == node.GetExecutionProviderType());
+    }
+    if (!same_provider) {
+      continue;
+    }
+
+    FuseQDQGroup(graph, node, group);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class QDQFusion
+
+Fuses the DequantizeLinear -> op -> QuantizeLinear groups of a model in the QDQ format, as exported by
+quantization-aware training, into the quantized kernel of the op:
+
+  DequantizeLinear(X) + DequantizeLinear(W) + Conv + QuantizeLinear            -> QLinearConv
+  DequantizeLinear(A) + DequantizeLinear(B) + MatMul + QuantizeLinear          -> QLinearMatMul
+  DequantizeLinear(A) + DequantizeLinear(B) + Add + QuantizeLinear             -> QLinearAdd
+
+The bias of Conv is either a float constant, which is quantized with the scale X_scale * W_scale, or the
+DequantizeLinear of an int32 tensor quantized with that scale.
+The DequantizeLinear nodes are kept if their outputs have other consumers.
+*/
+class QDQFusion : public GraphTransformer {
+ public:
+  QDQFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("QDQFusion", compatible_execution_providers) {}
+
+  /** Whether a DequantizeLinear node is an input of a group the transformer can fuse, regardless of the execution
+      providers. ConstantFolding keeps such nodes so that the quantized weights can be used by the fused node. */
+  static bool IsFusableDequantizeLinear(const Graph& graph, const Node& node);
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,506 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/transpose_optimizer.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+using Perm = std::vector<int64_t>;
+
+// Ops computing each output element from the input elements at the same position, after broadcasting.
+const std::unordered_set<std::string> elementwise_ops{
+    "Abs", "Acos", "Acosh", "Add", "And", "Asin", "Asinh", "Atan", "Atanh", "Cast", "Ceil", "Clip", "Cos", "Cosh",
+    "Div", "Elu", "Equal", "Erf", "Exp", "Floor", "Greater", "HardSigmoid", "Identity", "IsInf", "IsNaN",
+    "LeakyRelu", "Less", "Log", "Max", "Mean", "Min", "Mod", "Mul", "Neg", "Not", "Or", "Pow", "Reciprocal",
+    "Relu", "Round", "Selu", "Shrink", "Sigmoid", "Sign", "Sin", "Sinh", "Softplus", "Softsign", "Sqrt", "Sub",
+    "Sum", "Tan", "Tanh", "ThresholdedRelu", "Where", "Xor"};
+
+// Ops reducing the axes of their first input given by an attribute.
+const std::unordered_set<std::string> reduce_ops{
+    "ArgMax", "ArgMin", "ReduceL1", "ReduceL2", "ReduceLogSum", "ReduceLogSumExp", "ReduceMax", "ReduceMean",
+    "ReduceMin", "ReduceProd", "ReduceSum", "ReduceSumSquare"};
+
+bool IsOnnxOp(const Node& node, const std::unordered_set<std::string>& op_types) {
+  return graph_utils::MatchesOpSetDomain(node, kOnnxDomain) && op_types.find(node.OpType()) != op_types.end();
+}
+
+bool IsTranspose(const Node& node) {
+  return node.OpType() == "Transpose" && graph_utils::MatchesOpSetDomain(node, kOnnxDomain);
+}
+
+// Gets the perm of a Transpose, which defaults to reversing the dims of the input.
+bool GetPerm(const Node& transpose, Perm& perm) {
+  if (!graph_utils::GetRepeatedNodeAttributeValues(transpose, "perm", perm)) {
+    const auto* shape = transpose.InputDefs()[0]->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+    perm.resize(shape->dim_size());
+    for (size_t i = 0; i < perm.size(); ++i) {
+      perm[i] = static_cast<int64_t>(perm.size() - 1 - i);
+    }
+  }
+
+  std::vector<bool> seen(perm.size(), false);
+  for (auto axis : perm) {
+    if (axis < 0 || axis >= static_cast<int64_t>(perm.size()) || seen[axis]) {
+      return false;
+    }
+    seen[axis] = true;
+  }
+  return !perm.empty();
+}
+
+Perm InversePerm(const Perm& perm) {
+  Perm inverse(perm.size());
+  for (size_t i = 0; i < perm.size(); ++i) {
+    inverse[perm[i]] = static_cast<int64_t>(i);
+  }
+  return inverse;
+}
+
+// The perm of Transpose(Transpose(X, first), second).
+Perm ComposePerms(const Perm& first, const Perm& second) {
+  Perm composed(second.size());
+  for (size_t i = 0; i < second.size(); ++i) {
+    composed[i] = first[second[i]];
+  }
+  return composed;
+}
+
+bool IsIdentityPerm(const Perm& perm) {
+  for (size_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether the value has a single element, so it is the same in any layout.
+bool IsSingleElement(const TensorShapeProto& shape) {
+  for (const auto& dim : shape.dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Creates a NodeArg for Transpose(arg, perm).
+NodeArg& CreateTransposedArg(Graph& graph, const NodeArg& arg, const Perm& perm) {
+  const std::string name = graph.GenerateNodeArgName(arg.Name() + "_transposed");
+  if (arg.TypeAsProto() == nullptr) {
+    return graph.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  TypeProto type(*arg.TypeAsProto());
+  const auto* shape = arg.Shape();
+  if (shape != nullptr && shape->dim_size() == static_cast<int>(perm.size())) {
+    auto* transposed_shape = type.mutable_tensor_type()->mutable_shape();
+    for (size_t i = 0; i < perm.size(); ++i) {
+      *transposed_shape->mutable_dim(static_cast<int>(i)) = shape->dim(static_cast<int>(perm[i]));
+    }
+  } else {
+    type.mutable_tensor_type()->clear_shape();
+  }
+  return graph.GetOrCreateNodeArg(name, &type);
+}
+
+// The graph doesn't update its producer and consumer lookups when nodes are added or removed, and the rewrites
+// look up the nodes created by the previous ones, so the lookups are updated with the edges.
+void AddConsumer(Graph& graph, const NodeArg& arg, Node& node) {
+  auto consumers = graph.GetMutableConsumerNodes(arg.Name());
+  consumers.erase(std::remove(consumers.begin(), consumers.end(), nullptr), consumers.end());
+  consumers.push_back(&node);
+  graph.UpdateConsumerNodes(arg.Name(), consumers);
+}
+
+void RemoveConsumer(Graph& graph, const NodeArg& arg, const Node& node) {
+  auto consumers = graph.GetMutableConsumerNodes(arg.Name());
+  consumers.erase(std::remove_if(consumers.begin(), consumers.end(),
+                                 [&node](const Node* consumer) { return consumer == nullptr || consumer == &node; }),
+                  consumers.end());
+  graph.UpdateConsumerNodes(arg.Name(), consumers);
+}
+
+// Connects a new node to the producers of its inputs. The consumers of its outputs are connected by the caller.
+void ConnectNode(Graph& graph, Node& node) {
+  const auto& inputs = node.MutableInputDefs();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (!inputs[i]->Exists()) {
+      continue;
+    }
+    const Node* producer = graph.GetProducerNode(inputs[i]->Name());
+    if (producer != nullptr) {
+      const auto& producer_outputs = producer->OutputDefs();
+      const auto src_index = std::find(producer_outputs.begin(), producer_outputs.end(), inputs[i]) -
+                             producer_outputs.begin();
+      graph.AddEdge(producer->Index(), node.Index(), static_cast<int>(src_index), static_cast<int>(i));
+    }
+    AddConsumer(graph, *inputs[i], node);
+  }
+  for (const NodeArg* output : node.OutputDefs()) {
+    if (output->Exists()) {
+      graph.UpdateProducerNode(output->Name(), node.Index());
+    }
+  }
+}
+
+// Moves the output edges of src_node to dst_node, which produces the same outputs.
+void MoveOutputEdges(Graph& graph, Node& src_node, Node& dst_node) {
+  std::vector<Node::EdgeEnd> output_edges(src_node.OutputEdgesBegin(), src_node.OutputEdgesEnd());
+  graph_utils::RemoveNodeOutputEdges(graph, src_node);
+  for (const auto& edge : output_edges) {
+    graph.AddEdge(dst_node.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+  }
+}
+
+// Removes a node without output edges.
+void RemoveNode(Graph& graph, Node& node) {
+  for (const NodeArg* input : node.InputDefs()) {
+    if (input->Exists()) {
+      RemoveConsumer(graph, *input, node);
+    }
+  }
+  graph.RemoveNode(node.Index());
+}
+
+bool IsUnused(const Graph& graph, const Node& node) {
+  return node.GetOutputEdgesCount() == 0 && graph.GetNodeOutputsInGraphOutputs(node).empty();
+}
+
+Node& AddTranspose(Graph& graph, const std::string& base_name, NodeArg& input, NodeArg& output, const Perm& perm,
+                   const std::string& provider) {
+  Node& transpose = graph.AddNode(graph.GenerateNodeName(base_name), "Transpose", "Transpose moved by TransposeOptimizer",
+                                  {&input}, {&output});
+  transpose.AddAttribute("perm", perm);
+  transpose.SetExecutionProviderType(provider);
+  return transpose;
+}
+
+class TransposeSinker {
+ public:
+  TransposeSinker(Graph& graph, const std::unordered_set<std::string>& compatible_providers,
+                  const logging::Logger& logger)
+      : graph_(graph), compatible_providers_(compatible_providers), logger_(logger) {}
+
+  void Add(const Node& node) {
+    if (IsCandidate(node)) {
+      transposes_.push_back(node.Index());
+    }
+  }
+
+  // Rewrites the queued Transposes until none of them can be moved.
+  bool Run() {
+    bool modified = false;
+    while (!transposes_.empty()) {
+      Node* transpose = graph_.GetNode(transposes_.front());
+      transposes_.pop_front();
+      // skip the Transposes removed by a previous rewrite
+      Perm perm;
+      if (transpose == nullptr || !GetPerm(*transpose, perm)) {
+        continue;
+      }
+
+      modified = (IsIdentityPerm(perm) && RemoveIdentity(*transpose)) ||
+                 MergeWithProducer(*transpose, perm) ||
+                 MoveBelowConsumer(*transpose, perm) ||
+                 modified;
+    }
+    return modified;
+  }
+
+ private:
+  bool IsCandidate(const Node& node) const {
+    return IsTranspose(node) && graph_utils::IsSupportedProvider(node, compatible_providers_);
+  }
+
+  bool CanRewrite(const Node& node, const Node& transpose) const {
+    return graph_utils::IsSupportedProvider(node, compatible_providers_) &&
+           node.GetExecutionProviderType() == transpose.GetExecutionProviderType() &&
+           !node.ContainsSubgraph();
+  }
+
+  // Queue the Transposes consuming the outputs of node, which may now be merged with it.
+  void AddTransposeConsumers(const Node& node) {
+    for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+      Add(*it);
+    }
+  }
+
+  bool RemoveIdentity(Node& transpose) {
+    if (!graph_utils::CanRemoveNode(graph_, transpose, logger_)) {
+      return false;
+    }
+
+    std::vector<Node*> consumers;
+    for (auto it = transpose.OutputNodesBegin(), end = transpose.OutputNodesEnd(); it != end; ++it) {
+      consumers.push_back(graph_.GetNode(it->Index()));
+    }
+    NodeArg& input = *transpose.MutableInputDefs()[0];
+    RemoveConsumer(graph_, input, transpose);
+    graph_utils::RemoveNode(graph_, transpose);
+    for (Node* consumer : consumers) {
+      AddConsumer(graph_, input, *consumer);
+      Add(*consumer);
+    }
+    return true;
+  }
+
+  // Transpose(Transpose(X, first), second) -> Transpose(X, ComposePerms(first, second))
+  bool MergeWithProducer(Node& transpose, const Perm& perm) {
+    Node* producer = graph_.GetMutableProducerNode(transpose.InputDefs()[0]->Name());
+    Perm producer_perm;
+    if (producer == nullptr || !IsCandidate(*producer) || !CanRewrite(*producer, transpose) ||
+        !GetPerm(*producer, producer_perm) || producer_perm.size() != perm.size()) {
+      return false;
+    }
+
+    Node& merged = AddTranspose(graph_, transpose.Name(), *producer->MutableInputDefs()[0],
+                                *transpose.MutableOutputDefs()[0], ComposePerms(producer_perm, perm),
+                                transpose.GetExecutionProviderType());
+    MoveOutputEdges(graph_, transpose, merged);
+    RemoveNode(graph_, transpose);
+    if (IsUnused(graph_, *producer)) {
+      RemoveNode(graph_, *producer);
+    }
+    ConnectNode(graph_, merged);
+
+    // the merged Transpose is removed next if the perms cancel
+    transposes_.push_back(merged.Index());
+    return true;
+  }
+
+  // consumer(Transpose(X, perm), ...) -> Transpose(consumer(X, ...), output_perm)
+  bool MoveBelowConsumer(Node& transpose, const Perm& perm) {
+    if (transpose.GetOutputEdgesCount() != 1 || !graph_.GetNodeOutputsInGraphOutputs(transpose).empty()) {
+      return false;
+    }
+
+    Node& consumer = *graph_.GetNode(transpose.OutputNodesBegin()->Index());
+    const bool is_elementwise = IsOnnxOp(consumer, elementwise_ops);
+    const bool is_concat = consumer.OpType() == "Concat" && graph_utils::MatchesOpSetDomain(consumer, kOnnxDomain);
+    const bool is_reduce = IsOnnxOp(consumer, reduce_ops);
+    if ((!is_elementwise && !is_concat && !is_reduce) || !CanRewrite(consumer, transpose) ||
+        consumer.OutputDefs().size() != 1) {
+      return false;
+    }
+
+    const NodeArg* transposed = transpose.OutputDefs()[0];
+    const auto rank = static_cast<int64_t>(perm.size());
+    std::vector<NodeArg*> inputs = consumer.MutableInputDefs();
+    std::vector<Node*> removed_transposes{&transpose};
+    std::vector<size_t> constant_inputs;
+    Perm output_perm = perm;
+    bool output_is_transposed = true;
+
+    // the axes attribute of a reduction, or the axis attribute of a Concat or ArgMax/ArgMin, in the layout of X
+    const bool has_single_axis = is_concat || consumer.OpType() == "ArgMax" || consumer.OpType() == "ArgMin";
+    std::vector<int64_t> axes;
+
+    if (is_reduce) {
+      // the axes are an input since opset 13
+      if (inputs.size() != 1) {
+        return false;
+      }
+
+      const auto* keepdims_attr = graph_utils::GetNodeAttribute(consumer, "keepdims");
+      const bool keepdims = keepdims_attr == nullptr || keepdims_attr->i() != 0;
+
+      if (has_single_axis) {
+        const auto* axis_attr = graph_utils::GetNodeAttribute(consumer, "axis");
+        axes.push_back(axis_attr == nullptr ? 0 : axis_attr->i());
+      } else if (!graph_utils::GetRepeatedNodeAttributeValues(consumer, "axes", axes)) {
+        // all the axes are reduced by default
+        for (int64_t i = 0; i < rank; ++i) {
+          axes.push_back(i);
+        }
+      }
+
+      std::vector<bool> reduced_output_axes(rank, false);
+      std::vector<bool> reduced_input_axes(rank, false);
+      for (auto& axis : axes) {
+        axis = axis < 0 ? axis + rank : axis;
+        if (axis < 0 || axis >= rank) {
+          return false;
+        }
+        reduced_output_axes[axis] = true;
+        axis = perm[axis];
+        reduced_input_axes[axis] = true;
+      }
+
+      if (!keepdims) {
+        // the remaining dims of the reduced X, in the order of the remaining dims of the reduced Transpose(X)
+        std::vector<int64_t> remaining_index(rank, -1);
+        int64_t remaining = 0;
+        for (int64_t i = 0; i < rank; ++i) {
+          if (!reduced_input_axes[i]) {
+            remaining_index[i] = remaining++;
+          }
+        }
+        output_perm.clear();
+        for (int64_t i = 0; i < rank; ++i) {
+          if (!reduced_output_axes[i]) {
+            output_perm.push_back(remaining_index[perm[i]]);
+          }
+        }
+      }
+
+      // all the remaining dims have a size of 1, or keep their order
+      output_is_transposed = std::find(reduced_output_axes.begin(), reduced_output_axes.end(), false) !=
+                                 reduced_output_axes.end() &&
+                             !IsIdentityPerm(output_perm);
+      inputs[0] = transpose.MutableInputDefs()[0];
+    } else {
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        NodeArg* input = inputs[i];
+        if (!input->Exists()) {
+          continue;
+        }
+        if (input == transposed) {
+          inputs[i] = transpose.MutableInputDefs()[0];
+          continue;
+        }
+
+        // another input transposed with the same perm
+        Node* producer = graph_.GetMutableProducerNode(input->Name());
+        Perm producer_perm;
+        if (producer != nullptr && IsCandidate(*producer) && CanRewrite(*producer, transpose) &&
+            GetPerm(*producer, producer_perm) && producer_perm == perm &&
+            producer->GetOutputEdgesCount() == 1 && graph_.GetNodeOutputsInGraphOutputs(*producer).empty()) {
+          inputs[i] = producer->MutableInputDefs()[0];
+          removed_transposes.push_back(producer);
+          continue;
+        }
+
+        const auto* shape = input->Shape();
+        if (shape == nullptr || shape->dim_size() > rank) {
+          return false;
+        }
+        if (IsSingleElement(*shape)) {
+          continue;
+        }
+        if (graph_utils::IsConstantInitializer(graph_, input->Name())) {
+          constant_inputs.push_back(i);
+          continue;
+        }
+        return false;
+      }
+
+      if (is_concat) {
+        const auto* axis_attr = graph_utils::GetNodeAttribute(consumer, "axis");
+        if (axis_attr == nullptr) {
+          return false;
+        }
+        int64_t axis = axis_attr->i() < 0 ? axis_attr->i() + rank : axis_attr->i();
+        if (axis < 0 || axis >= rank) {
+          return false;
+        }
+        axes.push_back(perm[axis]);
+      }
+    }
+
+    const std::string& provider = consumer.GetExecutionProviderType();
+    const Perm inverse_perm = InversePerm(perm);
+    for (size_t i : constant_inputs) {
+      inputs[i] = &TransposeConstant(*inputs[i], inverse_perm, provider);
+    }
+
+    NodeArg& output = *consumer.MutableOutputDefs()[0];
+    NodeArg* consumer_output = output_is_transposed ? &CreateTransposedArg(graph_, output, InversePerm(output_perm))
+                                                    : &output;
+    Node& new_consumer = graph_.AddNode(graph_.GenerateNodeName(consumer.Name()), consumer.OpType(),
+                                        consumer.Description(), inputs, {consumer_output},
+                                        &consumer.GetAttributes(), consumer.Domain());
+    if (has_single_axis) {
+      new_consumer.AddAttribute("axis", axes[0]);
+    } else if (is_reduce) {
+      new_consumer.AddAttribute("axes", axes);
+    }
+    new_consumer.SetExecutionProviderType(provider);
+
+    Node* output_node = &new_consumer;
+    if (output_is_transposed) {
+      output_node = &AddTranspose(graph_, transpose.Name(), *consumer_output, output, output_perm, provider);
+    }
+
+    MoveOutputEdges(graph_, consumer, *output_node);
+    RemoveNode(graph_, consumer);
+    for (Node* removed : removed_transposes) {
+      RemoveNode(graph_, *removed);
+    }
+    ConnectNode(graph_, new_consumer);
+
+    if (output_is_transposed) {
+      ConnectNode(graph_, *output_node);
+      transposes_.push_back(output_node->Index());
+    } else {
+      AddTransposeConsumers(new_consumer);
+    }
+    return true;
+  }
+
+  // Adds Transpose(constant, perm), broadcasting the constant to the rank of perm first.
+  // Constant folding replaces the Transpose by a transposed initializer.
+  NodeArg& TransposeConstant(NodeArg& constant, const Perm& perm, const std::string& provider) {
+    NodeArg* input = &constant;
+    const TensorProto* initializer = graph_utils::GetConstantInitializer(graph_, constant.Name());
+    if (initializer->dims_size() < static_cast<int>(perm.size())) {
+      // broadcasting prepends dims of 1, which doesn't move the data
+      TensorProto broadcast(*initializer);
+      broadcast.set_name(graph_.GenerateNodeArgName(constant.Name() + "_broadcast"));
+      broadcast.clear_dims();
+      for (size_t i = initializer->dims_size(); i < perm.size(); ++i) {
+        broadcast.add_dims(1);
+      }
+      for (auto dim : initializer->dims()) {
+        broadcast.add_dims(dim);
+      }
+      input = &graph_utils::AddInitializer(graph_, broadcast);
+    }
+
+    NodeArg& output = CreateTransposedArg(graph_, *input, perm);
+    Node& transpose = AddTranspose(graph_, constant.Name() + "_Transpose", *input, output, perm, provider);
+    ConnectNode(graph_, transpose);
+    return output;
+  }
+
+  Graph& graph_;
+  const std::unordered_set<std::string>& compatible_providers_;
+  const logging::Logger& logger_;
+  std::deque<NodeIndex> transposes_;
+};
+
+}  // namespace
+
+Status TransposeOptimizer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  TransposeSinker sinker(graph, GetCompatibleExecutionProviders(), logger);
+  for (auto node_index : node_topology_list) {
+    auto* node = graph.GetNode(node_index);
+    if (node == nullptr)
+      continue;
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+    sinker.Add(*node);
+  }
+
+  if (sinker.Run()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TransposeOptimizer
+
+Moves Transpose nodes towards the outputs of the graph through the ops that don't depend on the layout of their
+inputs, so that Transpose pairs meet and cancel, e.g. the NHWC <-> NCHW Transposes around each layer of a model
+converted from TensorFlow.
+
+A Transpose is pushed below:
+ - elementwise ops, if their other inputs come from Transposes with the same perm, are broadcast scalars, or are
+   constant initializers. The constants are transposed by new Transpose nodes, which constant folding removes.
+ - Concat, with the same conditions on the other inputs.
+ - reductions with an axes attribute, and ArgMax/ArgMin.
+Consecutive Transposes are merged, and removed if their perms cancel.
+
+The Transposes left in front of a MatMul can be fused into it by MatmulTransposeFusion.
+*/
+class TransposeOptimizer : public GraphTransformer {
+ public:
+  TransposeOptimizer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TransposeOptimizer", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -116,6 +116,47 @@ class Env {
   // This function doesn't support systems with more than 64 logical processors
   virtual std::vector<size_t> GetThreadAffinityMasks() const = 0;
 
+  // Returns the thread affinity masks, in the same format as GetThreadAffinityMasks(), of the processors
+  // on the given NUMA node. Returns an empty vector if the node doesn't exist or NUMA isn't supported.
+  virtual std::vector<size_t> GetNumaNodeThreadAffinityMasks(int numa_node) const {
+    ORT_UNUSED_PARAMETER(numa_node);
+    return {};
+  }
+
+  // Allocates memory backed by pages of the given NUMA node.
+  // Returns nullptr if that isn't supported, in which case the caller should use a regular allocation.
+  // Memory returned by this function must be freed with FreeOnNumaNode using the same size.
+  virtual void* AllocateOnNumaNode(size_t size, int numa_node) const {
+    ORT_UNUSED_PARAMETER(size);
+    ORT_UNUSED_PARAMETER(numa_node);
+    return nullptr;
+  }
+
+  virtual void FreeOnNumaNode(void* p, size_t size) const {
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(size);
+  }
+
+  // Allocates memory backed by huge pages, which take fewer TLB entries than regular pages. If prefault is true the
+  // pages are faulted in before returning, so the first use of the memory doesn't take page faults.
+  // Returns nullptr if that isn't supported, in which case the caller should use a regular allocation.
+  // Memory returned by this function must be freed with FreeHugePages using the same size.
+  virtual void* AllocateHugePages(size_t size, bool prefault) const {
+    ORT_UNUSED_PARAMETER(size);
+    ORT_UNUSED_PARAMETER(prefault);
+    return nullptr;
+  }
+
+  virtual void FreeHugePages(void* p, size_t size) const {
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(size);
+  }
+
+  // Returns the number of page faults the process took so far, or 0 if the platform doesn't report it.
+  virtual uint64_t GetPageFaultCount() const {
+    return 0;
+  }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -23,10 +23,15 @@ limitations under the License.
 #include <fcntl.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
 #include <fcntl.h>
 #include <dlfcn.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 #include <ftw.h>
 #include <string.h>
+#include <fstream>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
@@ -205,6 +210,114 @@ class PosixEnv : public Env {
     return ret;
   }
 
+  std::vector<size_t> GetNumaNodeThreadAffinityMasks(int numa_node) const override {
+    std::vector<size_t> ret;
+#if defined(__linux__)
+    if (numa_node < 0) return ret;
+    // the list is a comma separated list of processor ids and ranges, e.g. "0-7,16-23"
+    std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist");
+    std::string range;
+    while (std::getline(cpulist, range, ',')) {
+      size_t first, last;
+      auto dash = range.find('-');
+      try {
+        first = std::stoul(range.substr(0, dash));
+        last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+      } catch (const std::exception&) {
+        return {};
+      }
+      for (size_t cpu = first; cpu <= last; ++cpu) {
+        ret.push_back(cpu);
+      }
+    }
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+#endif
+    return ret;
+  }
+
+  void* AllocateOnNumaNode(size_t size, int numa_node) const override {
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int kMaxNumaNodes = sizeof(unsigned long) * 8;
+    if (size == 0 || numa_node < 0 || numa_node >= kMaxNumaNodes) return nullptr;
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    // MPOL_PREFERRED from <numaif.h>, which is part of libnuma. prefer the node rather than binding to it so the
+    // allocation still succeeds if the node runs out of memory.
+    constexpr int kMpolPreferred = 1;
+    unsigned long node_mask = 1UL << numa_node;
+    // the kernel only reads maxnode - 1 bits of the mask
+    if (syscall(SYS_mbind, p, size, kMpolPreferred, &node_mask, kMaxNumaNodes + 1, 0) != 0) {
+      munmap(p, size);
+      return nullptr;
+    }
+    return p;
+#else
+    ORT_UNUSED_PARAMETER(size);
+    ORT_UNUSED_PARAMETER(numa_node);
+    return nullptr;
+#endif
+  }
+
+  void FreeOnNumaNode(void* p, size_t size) const override {
+    if (p != nullptr) {
+      munmap(p, size);
+    }
+  }
+
+#if defined(__linux__)
+  // size of the huge pages of x86-64 and of aarch64 with 4KB base pages
+  static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+  void* AllocateHugePages(size_t size, bool prefault) const override {
+    if (size == 0) return nullptr;
+    const size_t mapped_size = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+
+    // explicit huge pages are only available if the administrator reserved some, and are faulted in when mapped
+    void* p = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (prefault ? MAP_POPULATE : 0), -1, 0);
+    if (p != MAP_FAILED) {
+      return p;
+    }
+
+    // otherwise ask for transparent huge pages, which require the mapping to be aligned to the huge page size
+    p = mmap(nullptr, mapped_size + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    char* start = static_cast<char*>(p);
+    char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(start) + kHugePageSize - 1) &
+                                            ~static_cast<uintptr_t>(kHugePageSize - 1));
+    if (aligned != start) {
+      munmap(start, aligned - start);
+    }
+    munmap(aligned + mapped_size, start + kHugePageSize - aligned);
+
+    // fails if transparent huge pages are disabled, in which case the memory is still usable with regular pages
+    madvise(aligned, mapped_size, MADV_HUGEPAGE);
+    if (prefault) {
+      // a write to each regular page faults the whole mapping in, a huge page at a time when they are available
+      const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      for (size_t offset = 0; offset < mapped_size; offset += page_size) {
+        static_cast<volatile char*>(aligned)[offset] = 0;
+      }
+    }
+    return aligned;
+  }
+
+  void FreeHugePages(void* p, size_t size) const override {
+    if (p != nullptr) {
+      munmap(p, (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize);
+    }
+  }
+#endif
+
+  uint64_t GetPageFaultCount() const override {
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0;
+    }
+    return static_cast<uint64_t>(usage.ru_minflt) + static_cast<uint64_t>(usage.ru_majflt);
+  }
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <Shlwapi.h>
 #include <Windows.h>
+#include <psapi.h>
 
 #include <fstream>
 #include <string>
@@ -169,6 +170,61 @@ class WindowsEnv : public Env {
     return ret;
   }
 
+  std::vector<size_t> GetNumaNodeThreadAffinityMasks(int numa_node) const override {
+    std::vector<size_t> ret;
+    ULONGLONG node_mask = 0;
+    if (numa_node < 0 || numa_node > MAXUCHAR ||
+        GetNumaNodeProcessorMask(static_cast<UCHAR>(numa_node), &node_mask) == FALSE || node_mask == 0) {
+      return ret;
+    }
+    // restrict each physical core to the logical processors it has on the node
+    for (size_t core_mask : GetThreadAffinityMasks()) {
+      size_t mask = core_mask & static_cast<size_t>(node_mask);
+      if (mask != 0) {
+        ret.push_back(mask);
+      }
+    }
+    return ret;
+  }
+
+  void* AllocateOnNumaNode(size_t size, int numa_node) const override {
+    if (size == 0 || numa_node < 0) return nullptr;
+    return VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE,
+                              static_cast<DWORD>(numa_node));
+  }
+
+  void FreeOnNumaNode(void* p, size_t size) const override {
+    ORT_UNUSED_PARAMETER(size);
+    if (p != nullptr) {
+      VirtualFree(p, 0, MEM_RELEASE);
+    }
+  }
+
+  void* AllocateHugePages(size_t size, bool prefault) const override {
+    // large pages are always resident, so they are faulted in by the allocation whether or not prefault is set
+    ORT_UNUSED_PARAMETER(prefault);
+    const size_t page_size = GetLargePageMinimum();
+    if (size == 0 || page_size == 0) return nullptr;
+    // fails unless the user has the "Lock pages in memory" privilege
+    return VirtualAlloc(nullptr, (size + page_size - 1) / page_size * page_size,
+                        MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+  }
+
+  void FreeHugePages(void* p, size_t size) const override {
+    ORT_UNUSED_PARAMETER(size);
+    if (p != nullptr) {
+      VirtualFree(p, 0, MEM_RELEASE);
+    }
+  }
+
+  uint64_t GetPageFaultCount() const override {
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+      return 0;
+    }
+    return counters.PageFaultCount;
+  }
+
   static WindowsEnv& Instance() {
     static WindowsEnv default_env;
     return default_env;
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/profile/hardware_counters.h"
+
+#include <memory>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace onnxruntime {
+namespace profile {
+
+#ifdef __linux__
+namespace {
+int OpenCounter(uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  if (group_fd < 0) {
+    // the group is enabled once all of its counters are open
+    attr.disabled = 1;
+  }
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // the calling thread, on any cpu
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+}  // namespace
+
+HardwareCounters::HardwareCounters() {
+  group_fd_ = OpenCounter(PERF_COUNT_HW_CPU_CYCLES, -1);
+  if (group_fd_ < 0) {
+    return;
+  }
+
+  const uint64_t member_configs[] = {PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES,
+                                     PERF_COUNT_HW_CACHE_MISSES};
+  for (size_t i = 0; i < 3; ++i) {
+    member_fds_[i] = OpenCounter(member_configs[i], group_fd_);
+    if (member_fds_[i] < 0) {
+      // all of the counters or none
+      for (size_t j = 0; j < i; ++j) {
+        close(member_fds_[j]);
+        member_fds_[j] = -1;
+      }
+      close(group_fd_);
+      group_fd_ = -1;
+      return;
+    }
+  }
+
+  ioctl(group_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+HardwareCounters::~HardwareCounters() {
+  for (int fd : member_fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  if (group_fd_ >= 0) {
+    close(group_fd_);
+  }
+}
+
+HardwareCounterValues HardwareCounters::Read() const {
+  HardwareCounterValues values;
+  // the number of counters in the group, followed by their values in the order they were opened
+  uint64_t buffer[5];
+  if (read(group_fd_, buffer, sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer)) && buffer[0] == 4) {
+    values.cycles = buffer[1];
+    values.instructions = buffer[2];
+    values.cache_references = buffer[3];
+    values.cache_misses = buffer[4];
+  }
+  return values;
+}
+#else
+HardwareCounters::HardwareCounters() = default;
+
+HardwareCounters::~HardwareCounters() = default;
+
+HardwareCounterValues HardwareCounters::Read() const {
+  return {};
+}
+#endif
+
+HardwareCounters* HardwareCounters::ForCurrentThread() {
+  thread_local std::unique_ptr<HardwareCounters> counters{new HardwareCounters()};
+  return counters->IsOpen() ? counters.get() : nullptr;
+}
+
+void HardwareCounters::AddEventArgs(const HardwareCounterValues& begin, const HardwareCounterValues& end,
+                                    std::unordered_map<std::string, std::string>& event_args) {
+  const uint64_t cycles = end.cycles - begin.cycles;
+  const uint64_t instructions = end.instructions - begin.instructions;
+  const uint64_t cache_misses = end.cache_misses - begin.cache_misses;
+  event_args["cycles"] = std::to_string(cycles);
+  event_args["instructions"] = std::to_string(instructions);
+  const double ipc = cycles != 0 ? static_cast<double>(instructions) / static_cast<double>(cycles) : 0.0;
+  event_args["ipc"] = std::to_string(ipc);
+  event_args["cache_references"] = std::to_string(end.cache_references - begin.cache_references);
+  event_args["cache_misses"] = std::to_string(cache_misses);
+  // the memory traffic of the thread, as the cache lines it read from memory
+  event_args["memory_read_bytes"] = std::to_string(cache_misses * 64);
+}
+
+}  // namespace profile
+}  // namespace onnxruntime
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace profile {
+
+// Values of the hardware performance counters of a thread.
+struct HardwareCounterValues {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t cache_references = 0;  // accesses to the last level cache
+  uint64_t cache_misses = 0;      // misses of the last level cache, each one a cache line read from memory
+};
+
+/**
+ * Hardware performance counters of the calling thread, read with the perf_event interface of Linux.
+ *
+ * The counters only count the work of the thread that opened them, so the work a kernel hands to the
+ * intra-op thread pool is not included. They may be unavailable: on other platforms, in containers or
+ * virtual machines without access to the PMU, or when /proc/sys/kernel/perf_event_paranoid forbids it.
+ */
+class HardwareCounters {
+ public:
+  // Returns the counters of the calling thread, opening them on the first call from the thread,
+  // or nullptr if they are unavailable.
+  static HardwareCounters* ForCurrentThread();
+
+  ~HardwareCounters();
+
+  HardwareCounterValues Read() const;
+
+  // Adds the counts between two reads of the counters, and the metrics derived from them, to the arguments
+  // of a profiler event.
+  static void AddEventArgs(const HardwareCounterValues& begin, const HardwareCounterValues& end,
+                           std::unordered_map<std::string, std::string>& event_args);
+
+ private:
+  HardwareCounters();
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(HardwareCounters);
+
+  bool IsOpen() const {
+    return group_fd_ >= 0;
+  }
+
+  // file descriptor of the cycles counter, which leads the group of counters so they are scheduled together
+  int group_fd_ = -1;
+  int member_fds_[3] = {-1, -1, -1};
+};
+
+}  // namespace profile
+}  // namespace onnxruntime
@@ -62,4 +62,30 @@ void NvtxMarkerCreator::Mark() {
 }  // namespace contrib
 }  // namespace onnxruntime
 
-#endif
\ No newline at end of file
+#endif
+
+#ifdef ENABLE_ITT_PROFILE
+#include "core/profile/profile.h"
+#include <ittnotify.h>
+
+namespace onnxruntime {
+namespace profile {
+
+static __itt_domain* GetIttDomain() {
+  static __itt_domain* domain = __itt_domain_create("onnxruntime");
+  return domain;
+}
+
+void IttRangeCreator::BeginImpl() {
+  // string handles are interned by ITT, so the same message gets the same handle
+  __itt_task_begin(GetIttDomain(), __itt_null, __itt_null, __itt_string_handle_create(message_.c_str()));
+}
+
+void IttRangeCreator::EndImpl() {
+  __itt_task_end(GetIttDomain());
+}
+
+}  // namespace profile
+}  // namespace onnxruntime
+
+#endif
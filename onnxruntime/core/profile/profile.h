@@ -6,7 +6,8 @@
 // They can be used to plot the time intervals of forward and backward passes.
 // They can also be used to plot the time span of a specific operator.
 // When writing this file, Nvidia only supports this tool on Linux.
-#ifdef ENABLE_NVTX_PROFILE
+// IttRangeCreator does the same for Intel VTune, with the ITT API.
+#if defined(ENABLE_NVTX_PROFILE) || defined(ENABLE_ITT_PROFILE)
 
 #pragma once
 
@@ -97,6 +98,7 @@ class RangeCreatorBase {
   bool is_end_called_;
 };
 
+#ifdef ENABLE_NVTX_PROFILE
 class NvtxRangeCreator final : public RangeCreatorBase {
  public:
   NvtxRangeCreator(const std::string message, const Color color)
@@ -133,6 +135,20 @@ class NvtxMarkerCreator final {
   // See nvtxRangeCreator.color_.
   const Color color_;
 };
+#endif
+
+#ifdef ENABLE_ITT_PROFILE
+// A task of the "onnxruntime" ITT domain, shown by VTune on the timeline of the thread that ran it.
+// ITT has no colors, so color is ignored.
+class IttRangeCreator final : public RangeCreatorBase {
+ public:
+  IttRangeCreator(const std::string message, const Color color)
+      : RangeCreatorBase(message, color) {};
+
+  void BeginImpl() override;
+  void EndImpl() override;
+};
+#endif
 
 }  // namespace profile
 }  // namespace onnxruntime
@@ -110,12 +110,14 @@ Status BatchNorm<T>::Compute(OpKernelContext* context) const {
     arm_compute::Iterator aclInputIt(pBatchNorm->in.get(), aclInpuWindow);
     const unsigned int aclWidth = pBatchNorm->in->info()->dimension(0);
     const unsigned int aclHeight = pBatchNorm->in->info()->dimension(1);
+    const unsigned int aclChannels = pBatchNorm->in->info()->dimension(2);
 
     // copy input tensor into the larger buffer
     arm_compute::execute_window_loop(
       aclInpuWindow,
       [&](const arm_compute::Coordinates& co) {
-        *reinterpret_cast<float*>(aclInputIt.ptr()) = x_data[co.z() * (aclWidth * aclHeight) + co.y() * aclHeight + co.x()];
+        *reinterpret_cast<float*>(aclInputIt.ptr()) =
+            x_data[((co[3] * aclChannels + co.z()) * aclHeight + co.y()) * aclWidth + co.x()];
       },
       aclInputIt);
   }else{
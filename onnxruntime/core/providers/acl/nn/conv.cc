@@ -107,23 +107,33 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   Tensor* Y = context->Output(0, TensorShape(Y_dims));
   LOGS_DEFAULT(VERBOSE) << "Y " << Y->Shape().ToString().c_str() << std::endl;
 
-  arm_compute::ActivationLayerInfo::ActivationFunction acl_activ_func;
-  bool acl_activ_enabled = false;
-
-  if (activation_type == "Relu") {
-    acl_activ_func = arm_compute::ActivationLayerInfo::ActivationFunction::RELU;
-    acl_activ_enabled = true;
-  } else if (activation_type == "LeakyRelu") {
-    acl_activ_func = arm_compute::ActivationLayerInfo::ActivationFunction::LEAKY_RELU;
-    acl_activ_enabled = true;
-  } else if (activation_type == "Tanh") {
-    acl_activ_func = arm_compute::ActivationLayerInfo::ActivationFunction::TANH;
-    acl_activ_enabled = true;
-  } else if (activation_type == "Sigmoid") {
-    acl_activ_func = arm_compute::ActivationLayerInfo::ActivationFunction::LOGISTIC;
-    acl_activ_enabled = true;
-  } else if (!activation_type.empty()) {
-    ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation_type);
+  // the parameters of the fused activation are parsed by the CPU kernel into activation_
+  arm_compute::ActivationLayerInfo acl_activ_info;
+  switch (this->activation_.ActivationKind) {
+    case MlasIdentityActivation:
+      break;
+    case MlasReluActivation:
+      acl_activ_info = arm_compute::ActivationLayerInfo(arm_compute::ActivationLayerInfo::ActivationFunction::RELU);
+      break;
+    case MlasLeakyReluActivation:
+      acl_activ_info = arm_compute::ActivationLayerInfo(arm_compute::ActivationLayerInfo::ActivationFunction::LEAKY_RELU,
+                                                        this->activation_.Parameters.LeakyRelu.alpha);
+      break;
+    case MlasTanhActivation:
+      // ACL computes a * tanh(b * x)
+      acl_activ_info = arm_compute::ActivationLayerInfo(arm_compute::ActivationLayerInfo::ActivationFunction::TANH, 1.0f, 1.0f);
+      break;
+    case MlasLogisticActivation:
+      acl_activ_info = arm_compute::ActivationLayerInfo(arm_compute::ActivationLayerInfo::ActivationFunction::LOGISTIC);
+      break;
+    case MlasClipActivation:
+      // ACL computes min(a, max(b, x))
+      acl_activ_info = arm_compute::ActivationLayerInfo(arm_compute::ActivationLayerInfo::ActivationFunction::LU_BOUNDED_RELU,
+                                                        this->activation_.Parameters.Clip.maximum,
+                                                        this->activation_.Parameters.Clip.minimum);
+      break;
+    default:
+      ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation_type);
   }
 
   if (it == Conv::convLayers.end()) {
@@ -217,12 +227,12 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
 #ifdef ACL_1902
         layer->configure(tconv.in.get(), tconv.k.get(), (B != nullptr) ? tconv.b.get() : nullptr, tconv.out.get(),
                          aclPadStride, 1 /* depth multiplier */,
-                         acl_activ_enabled ? arm_compute::ActivationLayerInfo(acl_activ_func, conv_attrs_.alpha) : arm_compute::ActivationLayerInfo());
+                         acl_activ_info);
 #endif
 #if defined(ACL_1905) || defined(ACL_1908)
         layer->configure(tconv.in.get(), tconv.k.get(), (B != nullptr) ? tconv.b.get() : nullptr, tconv.out.get(),
                          aclPadStride, 1 /* depth multiplier */,
-                         acl_activ_enabled ? arm_compute::ActivationLayerInfo(acl_activ_func, conv_attrs_.alpha) : arm_compute::ActivationLayerInfo(),
+                         acl_activ_info,
                          arm_compute::Size2D(aclDilation0, dilations[0]));
 #endif
         tconv.layer = std::move(layer);
@@ -237,8 +247,10 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
 #endif //DEPTHWISE_CPU
     } else {
       if(tconv.k->info()->tensor_shape()[0] == 1 && tconv.k->info()->tensor_shape()[1] == 1) {
-        //pointwise convolution
+        //pointwise convolution, remembered so that later calls go straight to the cpu kernel
         Status s = onnxruntime::Conv<T>::Compute(context);
+        tconv.isDepthwiseCPU = true;
+        Conv::convLayers.insert(std::pair<OpKernel*, ACLNEConv>((OpKernel*)this, tconv));
         return s;
       } else {
         //convolution
@@ -246,7 +258,7 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
         layer->configure(tconv.in.get(), tconv.k.get(), (B != nullptr) ? tconv.b.get() : nullptr, tconv.out.get(),
                          aclPadStride,
                          arm_compute::WeightsInfo(), arm_compute::Size2D(aclDilation0, dilations[0]),
-                         acl_activ_enabled ? arm_compute::ActivationLayerInfo(acl_activ_func, conv_attrs_.alpha) : arm_compute::ActivationLayerInfo(),
+                         acl_activ_info,
                          false, conv_attrs_.group);
         tconv.layer = std::move(layer);
       }
@@ -258,6 +270,10 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
     ret = Conv::convLayers.insert(std::pair<OpKernel*, ACLNEConv>((OpKernel*)this, tconv));
     pConv = &ret.first->second;
 
+    // the workspace of the layer stays allocated across runs instead of being allocated for each run
+    arm_compute::Allocator alloc_mm{};
+    pConv->mm_layer->populate(alloc_mm, 1);
+
     ACLPrintTensorShape("X", *tconv.in.get());
     ACLPrintTensorShape("Y", *tconv.out.get());
 
@@ -280,10 +296,7 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   T* y_data = Y->template MutableData<T>();
   ACLImportMemory(pConv->out->allocator(), (void*)y_data, Y->Shape().Size() * 4);
 
-  arm_compute::Allocator alloc_mm{};
-  pConv->mm_layer->populate(alloc_mm, 1);
   pConv->layer->run();
-  pConv->mm_layer->clear();
 
   pConv->in->allocator()->free();
   pConv->k->allocator()->free();
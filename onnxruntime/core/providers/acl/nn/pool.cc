@@ -88,8 +88,11 @@ ACLNEPool PoolOperation(onnxruntime::OpKernelContext* context,
         aclPads[3] = pads[2];
       }
 
+      // the output shape is computed by SetOutputSize, so the rounding has to agree with it
+      arm_compute::DimensionRoundingType aclRounding = pool_attrs.ceil_mode ? arm_compute::DimensionRoundingType::CEIL
+                                                                            : arm_compute::DimensionRoundingType::FLOOR;
       arm_compute::PadStrideInfo aclPadStride = arm_compute::PadStrideInfo(aclStrides[0], aclStrides[1],
-                                                                           aclPads[0], aclPads[1], aclPads[2], aclPads[3], arm_compute::DimensionRoundingType::FLOOR);
+                                                                           aclPads[0], aclPads[1], aclPads[2], aclPads[3], aclRounding);
 
       std::vector<int64_t> aclKernelShape(2);
       aclKernelShape[0] = (kernel_shape.size() > 1) ? kernel_shape[1] : 1;
@@ -117,12 +120,14 @@ ACLNEPool PoolOperation(onnxruntime::OpKernelContext* context,
   arm_compute::Iterator aclInputIt(tpool.in.get(), aclInpuWindow);
   const unsigned int aclWidth = tpool.in->info()->dimension(0);
   const unsigned int aclHeight = tpool.in->info()->dimension(1);
+  const unsigned int aclChannels = tpool.in->info()->dimension(2);
 
   // copy input tensor into the larger buffer
   arm_compute::execute_window_loop(
       aclInpuWindow,
       [&](const arm_compute::Coordinates& co) {
-        *reinterpret_cast<float*>(aclInputIt.ptr()) = x_data[co.z() * (aclWidth * aclHeight) + co.y() * aclHeight + co.x()];
+        *reinterpret_cast<float*>(aclInputIt.ptr()) =
+            x_data[((co[3] * aclChannels + co.z()) * aclHeight + co.y()) * aclWidth + co.x()];
       },
       aclInputIt);
 
@@ -179,8 +184,10 @@ Status MaxPoolV8<T>::Compute(OpKernelContext* context) const {
   aclDilations[0] = (dilations.size() == 2) ? dilations[1] : 1;
   aclDilations[1] = (!dilations.empty()) ? dilations[0] : 1;
 
+  // ACL doesn't output the indices of the maximum values
   if ((X->Shape().NumDimensions() != PREF_DIM) ||
-      (aclDilations[0] * aclDilations[1] > 1)) {
+      (aclDilations[0] * aclDilations[1] > 1) ||
+      (OpKernel::Node().OutputDefs().size() > 1 && OpKernel::Node().OutputDefs()[1]->Exists())) {
     Status s = onnxruntime::MaxPoolV8::Compute(context);
     return s;
   }
@@ -210,6 +217,7 @@ Status MaxPoolV8<T>::Compute(OpKernelContext* context) const {
 POOLING_KERNEL(MaxPool, float, MaxPool<1>, 1, 7)
 POOLING_KERNEL(AveragePool, float, AveragePool, 7, 9)
 POOLING_KERNEL(AveragePool, float, AveragePool, 10, 10)
+POOLING_KERNEL(AveragePool, float, AveragePool, 11, 11)
 POOLING_KERNEL(GlobalAveragePool, float, AveragePool, 1, 8)
 POOLING_KERNEL(GlobalMaxPool, float, MaxPool<1>, 1, 8)
 
@@ -223,5 +231,15 @@ ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_EX(
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()), \
       MaxPoolV8<float>);
 
+ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_EX(                                            \
+      MaxPool,                                                                      \
+      kOnnxDomain,                                                                  \
+      12,                                                                           \
+      12,                                                                           \
+      float,                                                                        \
+      kAclExecutionProvider,                                                        \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()), \
+      MaxPoolV8<float>);
+
 }  // namespace acl
 }  // namespace onnxruntime
\ No newline at end of file
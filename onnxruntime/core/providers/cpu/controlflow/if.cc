@@ -200,16 +200,16 @@ common::Status If::SetupSubgraphExecutionInfo(const SessionState& session_state,
 }
 
 Status If::Compute(OpKernelContext* ctx) const {
-  ORT_ENFORCE(then_feeds_fetches_manager_ && else_feeds_fetches_manager_,
-              "CreateFeedsFetchesManager must be called prior to execution of graph.");
-
   auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
 
   auto condition = *ctx->Input<Tensor>(0)->Data<bool>();
 
+  // with lazy initialization only the branch taken is set up, when getting its SessionState
   auto attribute = condition ? "then_branch" : "else_branch";
   auto* session_state = ctx_internal->SubgraphSessionState(attribute);
   ORT_ENFORCE(session_state, "Subgraph SessionState was not found for '", attribute, "' attribute.");
+  ORT_ENFORCE(condition ? then_feeds_fetches_manager_ != nullptr : else_feeds_fetches_manager_ != nullptr,
+              "CreateFeedsFetchesManager must be called prior to execution of graph.");
 
   const auto& info = condition ? then_info_ : else_info_;
   IfImpl impl{*ctx_internal, *session_state, *info};
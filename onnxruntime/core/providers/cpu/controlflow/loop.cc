@@ -131,6 +131,21 @@ struct Loop::Info {
       auto& output = subgraph_outputs[i];
       subgraph_output_names.push_back(output->Name());
     }
+
+    // if the 'cond' output is the 'cond' input, directly or via an Identity node, the condition can't change
+    // so the number of iterations is known when the Loop starts.
+    const std::string& cond_input_name = subgraph_input_names[1];
+    const std::string& cond_output_name = subgraph_output_names[0];
+    condition_is_loop_invariant = cond_input_name == cond_output_name;
+    for (const auto& node : subgraph.Nodes()) {
+      if (condition_is_loop_invariant) {
+        break;
+      }
+
+      condition_is_loop_invariant = node.OpType() == "Identity" &&
+                                    node.OutputDefs()[0]->Name() == cond_output_name &&
+                                    node.InputDefs()[0]->Name() == cond_input_name;
+    }
   }
 
   const GraphViewer& subgraph;
@@ -142,6 +157,8 @@ struct Loop::Info {
   int num_subgraph_inputs;
   int num_subgraph_outputs;
 
+  bool condition_is_loop_invariant;
+
   std::vector<std::string> subgraph_input_names;
   std::vector<std::string> subgraph_output_names;
 };
@@ -167,6 +184,14 @@ class LoopImpl {
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
+  // when the number of iterations is known, the subgraph writes the per-iteration outputs directly into slices of
+  // the Loop outputs, and the loop carried vars of the last iteration directly into the Loop outputs.
+  void SetupInPlaceFetches(int64_t iteration, std::vector<OrtValue>& fetches,
+                           std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+  Status SaveInPlaceOutputs(int64_t iteration, const std::vector<OrtValue>& fetches);
+  Status AllocateInPlaceOutput(int output_index, const TensorShape& per_iteration_shape);
+  OrtValue GetInPlaceOutputSlice(int output_index, int64_t iteration) const;
+
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
   const Loop::Info& info_;
@@ -174,6 +199,12 @@ class LoopImpl {
   int64_t max_trip_count_;
   bool condition_;
 
+  // number of iterations if known when the Loop starts, or -1
+  int64_t trip_count_ = -1;
+
+  // Loop outputs for the per-iteration outputs that are written in place. nullptr until allocated.
+  std::vector<Tensor*> in_place_outputs_;
+
   const std::vector<const OrtValue*>& implicit_inputs_;
 
   OrtValue iter_num_mlvalue_;
@@ -283,12 +314,18 @@ common::Status Loop::SetupSubgraphExecutionInfo(const SessionState& session_stat
   std::vector<const OrtMemoryInfo*> fetch_locations;
   fetch_locations.reserve(info_->num_subgraph_outputs);
 
-  // 'cond' is first output and we need it to be on CPU so we can read the latest value
-  const auto& cpu_allocator_info = session_state.GetExecutionProviders()
-                                       .Get(onnxruntime::kCpuExecutionProvider)
-                                       ->GetAllocator(0, OrtMemTypeDefault)
-                                       ->Info();
-  fetch_locations.push_back(&cpu_allocator_info);
+  // 'cond' is first output and we need it to be on CPU so we can read the latest value. if it can't change it is
+  // never read, so leave it where the subgraph produces it to avoid a copy from the device (and a sync) per iteration.
+  if (info_->condition_is_loop_invariant && info_->subgraph_output_names[0] != info_->subgraph_input_names[1]) {
+    fetch_locations.push_back(&utils::FindMemoryInfoForValue(subgraph_session_state,
+                                                             info_->subgraph_output_names[0]));
+  } else {
+    const auto& cpu_allocator_info = session_state.GetExecutionProviders()
+                                         .Get(onnxruntime::kCpuExecutionProvider)
+                                         ->GetAllocator(0, OrtMemTypeDefault)
+                                         ->Info();
+    fetch_locations.push_back(&cpu_allocator_info);
+  }
 
   // Loop state variables need to be where we can feed them in to the next iteration, so set the fetch location
   // to match the feed location.
@@ -378,6 +415,11 @@ Status LoopImpl::Initialize() {
 
   loop_output_tensors_.resize(info_.num_outputs - info_.num_loop_carried_vars);
 
+  if (max_trip_count_tensor && info_.condition_is_loop_invariant) {
+    trip_count_ = condition_ ? max_trip_count_ : 0;
+    in_place_outputs_.resize(info_.num_outputs - info_.num_loop_carried_vars, nullptr);
+  }
+
   return status;
 }
 
@@ -404,12 +446,21 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
-  // simple copy for cond and loop carried vars. start at 1 to skip iter_num in input
-  for (int i = 1; i < info_.num_subgraph_inputs; ++i) {
+  // simple copy for cond and loop carried vars. start at 1 to skip iter_num in input.
+  // a loop invariant cond keeps feeding the CPU value, as its output may have been left on another device.
+  if (!info_.condition_is_loop_invariant) {
+    next_inputs[1] = last_outputs[0];
+  }
+
+  for (int i = 2; i < info_.num_subgraph_inputs; ++i) {
     next_inputs[i] = last_outputs[i - 1];
   }
 
-  // save loop outputs as we have to concatenate at the end
+  // save loop outputs as we have to concatenate at the end, unless they were written in place
+  if (trip_count_ > 0) {
+    return;
+  }
+
   for (int j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
     loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(last_outputs[j + 1]);  // skip 'cond' in output
   }
@@ -434,15 +485,117 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_outp
   return Status::OK();
 }
 
+Status LoopImpl::AllocateInPlaceOutput(int output_index, const TensorShape& per_iteration_shape) {
+  Tensor*& output = in_place_outputs_[output_index - info_.num_loop_carried_vars];
+  if (output == nullptr) {
+    std::vector<int64_t> dims;
+    dims.reserve(1 + per_iteration_shape.NumDimensions());
+    dims.push_back(trip_count_);
+    const auto& per_iteration_dims = per_iteration_shape.GetDims();
+    std::copy(per_iteration_dims.cbegin(), per_iteration_dims.cend(), std::back_inserter(dims));
+
+    output = context_.Output(output_index, TensorShape(dims));
+    ORT_RETURN_IF(output == nullptr, "Failed to allocate Loop output ", output_index);
+  }
+
+  return Status::OK();
+}
+
+OrtValue LoopImpl::GetInPlaceOutputSlice(int output_index, int64_t iteration) const {
+  Tensor& output = *in_place_outputs_[output_index - info_.num_loop_carried_vars];
+  const auto& dims = output.Shape().GetDims();
+  TensorShape per_iteration_shape(std::vector<int64_t>(dims.cbegin() + 1, dims.cend()));
+  const size_t bytes_per_iteration = output.SizeInBytes() / static_cast<size_t>(trip_count_);
+
+  auto slice = onnxruntime::make_unique<Tensor>(output.DataType(), per_iteration_shape,
+                                                static_cast<uint8_t*>(output.MutableDataRaw()) +
+                                                    iteration * bytes_per_iteration,
+                                                output.Location());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  return OrtValue{slice.release(), ml_tensor, ml_tensor->GetDeleteFunc()};
+}
+
+void LoopImpl::SetupInPlaceFetches(int64_t iteration, std::vector<OrtValue>& fetches,
+                                   std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  fetches.resize(info_.num_subgraph_outputs);
+  fetch_allocators.clear();
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    const size_t fetch_index = i + 1;  // skip cond
+    if (iteration != 0) {
+      fetches[fetch_index] = GetInPlaceOutputSlice(i, iteration);
+      continue;
+    }
+
+    // the Loop output can be allocated once the shape of the first per-iteration output is known.
+    // if it isn't on the required device the execution frame allocates a temporary value, which
+    // SaveInPlaceOutputs copies to the Loop output.
+    fetch_allocators[fetch_index] = [this, i](const TensorShape& shape, const OrtMemoryInfo& location,
+                                              OrtValue& ort_value, bool& allocated) {
+      ORT_RETURN_IF_ERROR(AllocateInPlaceOutput(i, shape));
+      OrtValue slice = GetInPlaceOutputSlice(i, 0);
+      if (slice.Get<Tensor>().Location().device == location.device) {
+        ort_value = slice;
+        allocated = true;
+      }
+
+      return Status::OK();
+    };
+  }
+
+  if (iteration + 1 == trip_count_) {
+    for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+      fetch_allocators[i + 1] = [this, i](const TensorShape& shape, const OrtMemoryInfo& location,
+                                          OrtValue& ort_value, bool& allocated) {
+        Tensor* output = context_.Output(i, shape);
+        ORT_RETURN_IF(output == nullptr, "Failed to allocate Loop output ", i);
+        if (output->Location().device == location.device) {
+          auto tensor = onnxruntime::make_unique<Tensor>(output->DataType(), shape, output->MutableDataRaw(),
+                                                         output->Location());
+          auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+          ort_value = OrtValue{tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc()};
+          allocated = true;
+        }
+
+        return Status::OK();
+      };
+    }
+  }
+}
+
+Status LoopImpl::SaveInPlaceOutputs(int64_t iteration, const std::vector<OrtValue>& fetches) {
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    const auto& value = fetches[i + 1].Get<Tensor>();  // skip cond
+    ORT_RETURN_IF_ERROR(AllocateInPlaceOutput(i, value.Shape()));
+
+    // the subgraph may not have produced the output in the slice, e.g. if the output is a subgraph input,
+    // or was produced on a different device
+    OrtValue slice_value = GetInPlaceOutputSlice(i, iteration);
+    Tensor& slice = *slice_value.GetMutable<Tensor>();
+    if (slice.DataRaw() != value.DataRaw()) {
+      if (slice.Shape() != value.Shape()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
+                               " Expected:", slice.Shape(), " Got:", value.Shape());
+      }
+
+      ORT_RETURN_IF_ERROR(session_state_.GetDataTransferMgr().CopyTensor(value, slice));
+    }
+  }
+
+  return Status::OK();
+}
+
 Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   auto status = Status::OK();
 
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
 
   CreateInitialFeeds(feeds);
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
+  const bool in_place_outputs = trip_count_ > 0;
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
     if (iter_num_value != 0) {
@@ -450,22 +603,34 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    if (in_place_outputs) {
+      SetupInPlaceFetches(iter_num_value, fetches, fetch_allocators);
+    }
+
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger());
 
     ORT_RETURN_IF_ERROR(status);
 
-    condition_mlvalue_ = fetches[0];
+    if (in_place_outputs) {
+      ORT_RETURN_IF_ERROR(SaveInPlaceOutputs(iter_num_value, fetches));
+    }
+
+    if (!info_.condition_is_loop_invariant) {
+      condition_mlvalue_ = fetches[0];
+    }
 
     ++iter_num_value;
   }
 
   // As the loop carried variables may change shape across iterations there's no way to avoid a copy
-  // as we need the final shape.
+  // as we need the final shape, unless the last iteration wrote them directly into the Loop output.
   auto copy_tensor_from_mlvalue_to_output = [this](const OrtValue& input, int output_idx) {
     auto& data = input.Get<Tensor>();
     Tensor* output = context_.Output(output_idx, data.Shape());
-    session_state_.GetDataTransferMgr().CopyTensor(input.Get<Tensor>(), *output);
+    if (output->DataRaw() != data.DataRaw()) {
+      session_state_.GetDataTransferMgr().CopyTensor(input.Get<Tensor>(), *output);
+    }
   };
 
   // copy to Loop output
@@ -475,7 +640,8 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       copy_tensor_from_mlvalue_to_output(fetches[i + 1], i);  // skip cond
     }
 
-    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    // the per-iteration outputs were already written to the Loop outputs if in place
+    for (int i = info_.num_loop_carried_vars; !in_place_outputs && i < info_.num_outputs; ++i) {
       // add last output
       auto& per_iteration_outputs = loop_output_tensors_[i - info_.num_loop_carried_vars];
       per_iteration_outputs.push_back(fetches[i + 1]);  // skip cond
@@ -181,12 +181,11 @@ Scan<8>::~Scan() = default;
 
 template <>
 Status Scan<8>::Compute(OpKernelContext* ctx) const {
-  ORT_ENFORCE(feeds_fetches_manager_ && info_,
-              "CreateFeedsFetchesManager must be called prior to execution of graph.");
-
   auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
   auto* session_state = ctx_internal->SubgraphSessionState("body");
   ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'body' attribute.");
+  ORT_ENFORCE(feeds_fetches_manager_ && info_,
+              "CreateFeedsFetchesManager must be called prior to execution of graph.");
 
   Scan8Impl scan_impl{*ctx_internal, *session_state, *info_, input_directions_, device_helpers_};
 
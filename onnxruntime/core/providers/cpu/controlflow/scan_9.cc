@@ -225,12 +225,11 @@ Status Scan<9>::SetupSubgraphExecutionInfo(const SessionState& session_state,
 
 template <>
 Status Scan<9>::Compute(OpKernelContext* ctx) const {
-  ORT_ENFORCE(feeds_fetches_manager_ && info_,
-              "CreateFeedsFetchesManager must be called prior to execution of graph.");
-
   auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
   auto* session_state = ctx_internal->SubgraphSessionState("body");
   ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'body' attribute.");
+  ORT_ENFORCE(feeds_fetches_manager_ && info_,
+              "CreateFeedsFetchesManager must be called prior to execution of graph.");
 
   ScanImpl scan_impl{*ctx_internal, *session_state, *info_, input_directions_, output_directions_,
                      input_axes_, output_axes_, device_helpers_};
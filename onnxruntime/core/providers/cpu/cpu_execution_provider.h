@@ -5,6 +5,10 @@
 
 #include "core/framework/allocatormgr.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/huge_page_allocator.h"
+#include "core/framework/mimalloc_arena.h"
+#include "core/framework/numa_allocator.h"
+#include "core/framework/prepacked_weights_store.h"
 #include "core/graph/constants.h"
 
 namespace onnxruntime {
@@ -12,9 +16,23 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  // cache freed arena chunks per thread to reduce lock contention when many threads call Run concurrently
+  bool use_arena_thread_cache{false};
+  // if not negative, allocate the memory from this NUMA node
+  int numa_node{-1};
+  // back the arena regions with pre-faulted huge pages. ignored if numa_node is set.
+  bool use_huge_pages{false};
+  // run float MatMul/Gemm kernels with constant weights on the bfloat16 GEMM if the platform supports it
+  bool enable_bf16_gemm{false};
+  // share the packed constant weights of the kernels through the PrepackedWeightsCache
+  bool share_prepacked_weights{false};
+  // run float MatMul/Gemm kernels whose constant weights are mostly zeros on a block sparse GEMM
+  bool enable_sparse_gemm{false};
+  // if set, the kernels read their packed constant weights from this store, or record them to it to be saved
+  std::shared_ptr<PrepackedWeightsStore> prepacked_weights_store;
 
-  explicit CPUExecutionProviderInfo(bool use_arena)
-      : create_arena(use_arena) {}
+  explicit CPUExecutionProviderInfo(bool use_arena, bool use_thread_cache = false)
+      : create_arena(use_arena), use_arena_thread_cache(use_thread_cache) {}
 
   CPUExecutionProviderInfo() = default;
 };
@@ -26,10 +44,26 @@ using FuseRuleFn = std::function<void(const onnxruntime::GraphViewer&,
 class CPUExecutionProvider : public IExecutionProvider {
  public:
   explicit CPUExecutionProvider(const CPUExecutionProviderInfo& info)
-      : IExecutionProvider{onnxruntime::kCpuExecutionProvider} {
+      : IExecutionProvider{onnxruntime::kCpuExecutionProvider},
+        enable_bf16_gemm_(info.enable_bf16_gemm),
+        share_prepacked_weights_(info.share_prepacked_weights),
+        enable_sparse_gemm_(info.enable_sparse_gemm),
+        prepacked_weights_store_(info.prepacked_weights_store) {
+    const int numa_node = info.numa_node;
+    const bool use_huge_pages = info.use_huge_pages;
     DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
-                                                [](int) { return onnxruntime::make_unique<TAllocator>(); },
-                                                std::numeric_limits<size_t>::max()};
+                                                [numa_node, use_huge_pages](int) -> std::unique_ptr<IDeviceAllocator> {
+                                                  if (numa_node >= 0) {
+                                                    return onnxruntime::make_unique<NumaCPUAllocator>(numa_node);
+                                                  }
+                                                  if (use_huge_pages) {
+                                                    return onnxruntime::make_unique<HugePageCPUAllocator>();
+                                                  }
+                                                  return onnxruntime::make_unique<TAllocator>();
+                                                },
+                                                std::numeric_limits<size_t>::max(),
+                                                ArenaExtendStrategy::kNextPowerOfTwo,
+                                                info.use_arena_thread_cache ? BFCArena::kDefaultThreadCacheMaxChunkSize : 0};
 
     bool create_arena = info.create_arena;
 
@@ -44,13 +78,29 @@ class CPUExecutionProvider : public IExecutionProvider {
     create_arena = false;
 #endif
 
+#if defined(USE_MIMALLOC_ARENA_ALLOCATOR)
+    // the mimalloc arena gets its memory from mimalloc rather than from the device allocator
+    if (create_arena && use_huge_pages && numa_node < 0) {
+      MiMallocArena::EnableLargeOsPages();
+    }
+#endif
+
     InsertAllocator(CreateAllocator(device_info, 0, create_arena));
   }
 
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
 
+  bool Bf16GemmEnabled() const { return enable_bf16_gemm_; }
+  bool SharePrepackedWeights() const { return share_prepacked_weights_; }
+  bool SparseGemmEnabled() const { return enable_sparse_gemm_; }
+  PrepackedWeightsStore* GetPrepackedWeightsStore() const { return prepacked_weights_store_.get(); }
+
  private:
   std::vector<FuseRuleFn> fuse_rules_;
+  bool enable_bf16_gemm_;
+  bool share_prepacked_weights_;
+  bool enable_sparse_gemm_;
+  std::shared_ptr<PrepackedWeightsStore> prepacked_weights_store_;
 };
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "einsum_auxiliary_ops.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -26,12 +27,11 @@ Status Transpose(const std::vector<size_t>& permutation, const Tensor& input,
   return TransposeBase::DoTranspose(permutation, input, output, input_shape_override);
 }
 
-// CPU specific MatMul helper
+// Multiplies the batches of matrices one batch at a time
 template <typename T>
-Status MatMul(const T* input_1_data, const T* input_2_data, T* output_data,
-              size_t left_stride, size_t right_stride, size_t output_stride,
-              size_t num_batches, size_t M, size_t K, size_t N, concurrency::ThreadPool* tp,
-              void* /*einsum_cuda_assets*/) {
+static void BatchedMatMul(const T* input_1_data, const T* input_2_data, T* output_data,
+                          size_t left_stride, size_t right_stride, size_t output_stride,
+                          size_t num_batches, size_t M, size_t K, size_t N, concurrency::ThreadPool* tp) {
   for (size_t i = 0; i < num_batches; ++i) {
     math::MatMul<T>(
         static_cast<int>(M),
@@ -41,6 +41,27 @@ Status MatMul(const T* input_1_data, const T* input_2_data, T* output_data,
         input_2_data + i * right_stride,
         output_data + i * output_stride, tp);
   }
+}
+
+// Multiplies all the batches of float matrices with a single strided batched SGEMM, which
+// partitions the work across the batches as well as within each matrix
+static void BatchedMatMul(const float* input_1_data, const float* input_2_data, float* output_data,
+                          size_t left_stride, size_t right_stride, size_t output_stride,
+                          size_t num_batches, size_t M, size_t K, size_t N, concurrency::ThreadPool* tp) {
+  MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, 1.f,
+                input_1_data, K, left_stride,
+                input_2_data, N, right_stride,
+                0.f, output_data, N, output_stride, num_batches, tp);
+}
+
+// CPU specific MatMul helper
+template <typename T>
+Status MatMul(const T* input_1_data, const T* input_2_data, T* output_data,
+              size_t left_stride, size_t right_stride, size_t output_stride,
+              size_t num_batches, size_t M, size_t K, size_t N, concurrency::ThreadPool* tp,
+              void* /*einsum_cuda_assets*/) {
+  BatchedMatMul(input_1_data, input_2_data, output_data, left_stride, right_stride, output_stride,
+                num_batches, M, K, N, tp);
 
   return Status::OK();
 }
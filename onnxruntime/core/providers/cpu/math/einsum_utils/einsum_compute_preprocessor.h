@@ -56,9 +56,8 @@ struct EinsumEquationPreprocessor {
   }
 
   // Holds the pre-processed equation string
-  // In theory, we could re-write the einsum equation to lower overall cost of intermediate arrays
-  // See numpy.einsum_path for details/examples
-  // These are very advanced optimizations that we don't require for the average use-case
+  // The order in which the inputs are contracted is chosen at compute time (once the input shapes are known)
+  // to lower the overall cost of intermediate arrays - see EinsumTypedComputeProcessor::Run()
   std::string einsum_preprocessed_equation_;
 
   // In explicit form, holds the left side of the einsum equation
@@ -3,8 +3,99 @@
 
 #include "einsum_typed_compute_processor.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace onnxruntime {
 
+// Returns the number of elements of the intermediate result obtained by contracting the inputs in `contracted`.
+// A subscript index survives in the result if it has a non-trivial dim value in any of the contracted inputs and
+// it is either part of the output or still present in an input that is yet to be contracted.
+static int64_t ContractedSize(const std::vector<TensorShape>& homogenized_input_dims,
+                              const std::vector<int64_t>& mapped_indices_to_last_input_index,
+                              const std::vector<bool>& contracted) {
+  int64_t size = 1;
+  for (size_t dim = 0, num_subscript_indices = mapped_indices_to_last_input_index.size();
+       dim < num_subscript_indices; ++dim) {
+    int64_t dim_value = 1;
+    bool is_live = mapped_indices_to_last_input_index[dim] == -1 ||
+                   !contracted[static_cast<size_t>(mapped_indices_to_last_input_index[dim])];
+    for (size_t input = 0; input < contracted.size(); ++input) {
+      int64_t input_dim_value = homogenized_input_dims[input][dim];
+      if (contracted[input]) {
+        dim_value = std::max(dim_value, input_dim_value);
+      } else if (input_dim_value > 1) {
+        is_live = true;
+      }
+    }
+    if (is_live) {
+      size *= dim_value;
+    }
+  }
+  return size;
+}
+
+// Chooses the order in which the inputs are contracted pair-wise.
+// The inputs are processed as a chain (the running result is contracted with one input at a time), so greedily
+// pick the pair of inputs with the smallest result to start the chain and then keep appending the input
+// that keeps the running result smallest. Ties are broken in favor of the order the inputs were given in.
+// (See numpy.einsum_path / opt_einsum's greedy strategy for the general idea)
+static std::vector<size_t> ComputeContractionOrder(const std::vector<TensorShape>& homogenized_input_dims,
+                                                   const std::vector<int64_t>& mapped_indices_to_last_input_index) {
+  const size_t num_inputs = homogenized_input_dims.size();
+  std::vector<size_t> order;
+  order.reserve(num_inputs);
+
+  if (num_inputs < 3) {
+    for (size_t input = 0; input < num_inputs; ++input) {
+      order.push_back(input);
+    }
+    return order;
+  }
+
+  std::vector<bool> contracted(num_inputs, false);
+
+  int64_t best_size = std::numeric_limits<int64_t>::max();
+  size_t best_left = 0;
+  size_t best_right = 1;
+  for (size_t left = 0; left < num_inputs; ++left) {
+    for (size_t right = left + 1; right < num_inputs; ++right) {
+      contracted[left] = contracted[right] = true;
+      int64_t size = ContractedSize(homogenized_input_dims, mapped_indices_to_last_input_index, contracted);
+      contracted[left] = contracted[right] = false;
+      if (size < best_size) {
+        best_size = size;
+        best_left = left;
+        best_right = right;
+      }
+    }
+  }
+  order.push_back(best_left);
+  order.push_back(best_right);
+  contracted[best_left] = contracted[best_right] = true;
+
+  while (order.size() < num_inputs) {
+    best_size = std::numeric_limits<int64_t>::max();
+    size_t best_input = 0;
+    for (size_t input = 0; input < num_inputs; ++input) {
+      if (contracted[input]) {
+        continue;
+      }
+      contracted[input] = true;
+      int64_t size = ContractedSize(homogenized_input_dims, mapped_indices_to_last_input_index, contracted);
+      contracted[input] = false;
+      if (size < best_size) {
+        best_size = size;
+        best_input = input;
+      }
+    }
+    order.push_back(best_input);
+    contracted[best_input] = true;
+  }
+
+  return order;
+}
+
 template <typename T>
 void EinsumTypedComputeProcessor<T>::FinalizeOutput(const Tensor& candidate_output,
                                                     const std::vector<int64_t>& ordered_subscript_indices_in_candidate) {
@@ -293,6 +384,37 @@ Status EinsumTypedComputeProcessor<T>::Run() {
 
   auto num_inputs = context_->InputCount();
 
+  // Choose the order in which the inputs are processed (only matters when there are 3 or more inputs)
+  std::vector<size_t> contraction_order = ComputeContractionOrder(homogenized_input_dims,
+                                                                  mapped_indices_to_last_input_index);
+
+  // For each subscript index, hold the position (in the contraction order) of the last input it is seen in.
+  // This is the position after which the dimension can be reduced.
+  // A subscript index seen in an input with a trivial dim value (1) can be reduced any time after the last input
+  // with a non-trivial dim value along it, as long as the input it was last seen in has been processed.
+  std::vector<int64_t> mapped_indices_to_last_position(num_subscript_labels, -1);
+  {
+    std::vector<int64_t> input_positions(num_inputs, 0);
+    for (size_t position = 0; position < contraction_order.size(); ++position) {
+      input_positions[contraction_order[position]] = static_cast<int64_t>(position);
+    }
+
+    for (int64_t dim = 0; dim < num_subscript_labels; ++dim) {
+      if (mapped_indices_to_last_input_index[dim] == -1) {
+        continue;
+      }
+      int64_t last_position = input_positions[mapped_indices_to_last_input_index[dim]];
+      for (int input = 0; input < num_inputs; ++input) {
+        if (homogenized_input_dims[input][static_cast<size_t>(dim)] > 1) {
+          last_position = std::max(last_position, input_positions[input]);
+        }
+      }
+      mapped_indices_to_last_position[dim] = last_position;
+    }
+  }
+
+  const size_t first_input = contraction_order[0];
+
   // Pre-process the first input so as to reduce any dims that only it has
   std::unique_ptr<const Tensor> result;
 
@@ -304,7 +426,7 @@ Status EinsumTypedComputeProcessor<T>::Run() {
     preserved_dims.reserve(num_subscript_labels);  // num_subscript_labels is the upper bound. No harm in over-reserving.
 
     for (int64_t i = 0; i < num_subscript_labels; ++i) {
-      if (mapped_indices_to_last_input_index[i] == 0) {
+      if (mapped_indices_to_last_position[i] == 0) {
         reduced_dims.push_back(i);
       } else {
         preserved_dims.push_back(i);
@@ -313,14 +435,15 @@ Status EinsumTypedComputeProcessor<T>::Run() {
 
     // Reduce the dims that are last seen in the first input alone
     if (reduced_dims.size() != 0) {
-      result = EinsumOp::ReduceSum<T>(preprocessed_inputs[0] ? *preprocessed_inputs[0] : *raw_inputs[0],
-                                      homogenized_input_dims[0].GetDims(), reduced_dims, allocator_, tp_,
+      result = EinsumOp::ReduceSum<T>(preprocessed_inputs[first_input] ? *preprocessed_inputs[first_input]
+                                                                       : *raw_inputs[first_input],
+                                      homogenized_input_dims[first_input].GetDims(), reduced_dims, allocator_, tp_,
                                       einsum_ep_assets_, device_reduce_sum_func_);
     } else {
       // Check if there is a pre-processed version of this input
       // If so assign it to result
-      if (preprocessed_inputs[0]) {
-        result = std::move(preprocessed_inputs[0]);
+      if (preprocessed_inputs[first_input]) {
+        result = std::move(preprocessed_inputs[first_input]);
       }
     }
 
@@ -338,21 +461,22 @@ Status EinsumTypedComputeProcessor<T>::Run() {
   {
     bool is_final_pair = false;
     // Keep processing each input pair-wise
-    for (int input = 1; input < num_inputs; ++input) {
+    for (int position = 1; position < num_inputs; ++position) {
+      const size_t input = contraction_order[position];
       std::vector<int64_t> reduced_dims;
       reduced_dims.reserve(num_subscript_labels);  // num_subscript_labels is the upper bound. No harm in over-reserving by a small margin.
       for (int64_t dim = 0; dim < num_subscript_labels; ++dim) {
-        if (mapped_indices_to_last_input_index[dim] == input) {
+        if (mapped_indices_to_last_position[dim] == position) {
           // This is the last input we are seeing this dimension (and it doesn't occur in the output), so reduce along the dimension
           reduced_dims.push_back(dim);
         }
       }
-      if (input == num_inputs - 1) {
+      if (position == num_inputs - 1) {
         is_final_pair = true;
       }
       // Use either the preprocessed inputs (if it is available) or the corresponding raw inputs
-      result = PairwiseOperandProcess(result ? *result : *raw_inputs[0],
-                                      result ? result->Shape() : homogenized_input_dims[0],
+      result = PairwiseOperandProcess(result ? *result : *raw_inputs[first_input],
+                                      result ? result->Shape() : homogenized_input_dims[first_input],
                                       preprocessed_inputs[input] ? *preprocessed_inputs[input] : *raw_inputs[input],
                                       homogenized_input_dims[input],
                                       reduced_dims, is_final_pair);
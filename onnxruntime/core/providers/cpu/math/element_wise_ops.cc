@@ -19,6 +19,16 @@ namespace onnxruntime {
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       KERNEL_CLASS<TYPE>);
 
+// for ops where each output element only depends on the input elements at the same position, so the output
+// may be written to the buffer of input 0 if the planner finds it has the same size
+#define REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)                  \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                                   \
+      OP_TYPE,                                                                                      \
+      VERSION,                                                                                      \
+      TYPE,                                                                                         \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      KERNEL_CLASS<TYPE>);
+
 #define REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
   ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                    \
       OP_TYPE,                                                                       \
@@ -68,61 +78,61 @@ namespace onnxruntime {
           .TypeConstraint("T1", BuildKernelDefConstraints<__VA_ARGS__>()),                          \
       KERNEL_CLASS);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, float, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, double, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int32_t, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int64_t, Add);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Add, 7, float, Add);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Add, 7, double, Add);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Add, 7, int32_t, Add);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Add, 7, int64_t, Add);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, float, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, double, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int32_t, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int64_t, Sub);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sub, 7, float, Sub);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sub, 7, double, Sub);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sub, 7, int32_t, Sub);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sub, 7, int64_t, Sub);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, float, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, double, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int32_t, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int64_t, Mul);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Mul, 7, float, Mul);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Mul, 7, double, Mul);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Mul, 7, int32_t, Mul);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Mul, 7, int64_t, Mul);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, float, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, double, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int32_t, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int64_t, Div);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Div, 7, float, Div);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Div, 7, double, Div);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Div, 7, int32_t, Div);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Div, 7, int64_t, Div);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, float, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, double, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int64_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint64_t, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, float, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, double, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, int8_t, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, int16_t, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, int32_t, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, int64_t, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, uint8_t, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, uint16_t, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, uint32_t, Abs);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Abs, 6, uint64_t, Abs);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, float, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, double, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, int8_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, int32_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, int64_t, Neg);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Neg, 6, float, Neg);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Neg, 6, double, Neg);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Neg, 6, int8_t, Neg);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Neg, 6, int32_t, Neg);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Neg, 6, int64_t, Neg);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Floor, 6, float, Floor);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Floor, 6, float, Floor);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Ceil, 6, float, Ceil);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Ceil, 6, float, Ceil);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Reciprocal, 6, float, Reciprocal);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Reciprocal, 6, float, Reciprocal);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, float, Sqrt);
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, double, Sqrt);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sqrt, 6, float, Sqrt);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sqrt, 6, double, Sqrt);
 
 REG_ELEMENTWISE_VERSIONED_KERNEL_NONT(Pow, 7, 11, Pow, float, double);
 // To reduce templetization we choose to support the below types for both
 // base and the exponent. This gives us 16 permutations
 REG_ELEMENTWISE_KERNEL_NONT(Pow, 12, Pow, int32_t, int64_t, float, double);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, float, Exp);
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, double, Exp);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Exp, 6, float, Exp);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Exp, 6, double, Exp);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Log, 6, float, Log);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Log, 6, float, Log);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sum, 6, 7, float, Sum_6);
 REG_ELEMENTWISE_TYPED_KERNEL(Sum, 8, float, Sum_8);
@@ -160,7 +170,7 @@ REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint8_t, BitShift);
 REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint32_t, BitShift);
 REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint64_t, BitShift);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Erf, 9, float, Erf);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Erf, 9, float, Erf);
 
 // REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(Not, 1, bool, Not);
 // REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(And, 7, bool, And);
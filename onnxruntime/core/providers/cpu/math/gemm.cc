@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/gemm.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_packing_helper.h"
 
 namespace onnxruntime {
 
@@ -26,4 +28,50 @@ ONNX_CPU_OPERATOR_KERNEL(
     11,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gemm<float>);
+
+template <>
+void Gemm<float>::TryPackWeights(const OpKernelInfo& info) {
+  const bool trans_b = trans_B_ != CblasNoTrans;
+
+  // BlockSparseGemm and MlasGemmBf16 read A without a transpose.
+  if (trans_A_ == CblasNoTrans) {
+    packed_b_is_sparse_ = TryPackBlockSparseGemmWeights(info, 1, trans_b, packed_b_);
+    if (!packed_b_is_sparse_) {
+      packed_b_is_bf16_ = TryPackBf16GemmWeights(info, 1, trans_b, packed_b_);
+    }
+  }
+  if (!packed_b_is_sparse_ && !packed_b_is_bf16_) {
+    TryPackSgemmWeights(info, 1, trans_b, packed_b_);
+  }
+}
+
+template <>
+bool Gemm<float>::TryComputePacked(int64_t M, int64_t N, int64_t K, const float* a_data,
+                                   const float* c_data, const TensorShape* c_shape, float* y_data,
+                                   concurrency::ThreadPool* thread_pool) const {
+  // The packed single precision GEMM is slower than the regular path for a single row, which does not amortize
+  // the reads of the larger packed panels.
+  if (!packed_b_ || (!packed_b_is_sparse_ && !packed_b_is_bf16_ && M == 1)) {
+    return false;
+  }
+
+  const float beta = c_data != nullptr ? beta_ : 0.0f;
+  BroadcastBias(M, N, beta, c_data, c_shape, y_data);
+
+  if (packed_b_is_sparse_) {
+    BlockSparseGemm(static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                    alpha_, a_data, static_cast<size_t>(K), packed_b_.get(), beta,
+                    y_data, static_cast<size_t>(N), thread_pool);
+  } else if (packed_b_is_bf16_) {
+    MlasGemmBf16(static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                 alpha_, a_data, static_cast<size_t>(K), packed_b_.get(), beta,
+                 y_data, static_cast<size_t>(N), thread_pool);
+  } else {
+    MlasGemm(trans_A_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+             alpha_, a_data, static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M), packed_b_.get(), beta,
+             y_data, static_cast<size_t>(N), thread_pool);
+  }
+  return true;
+}
+
 }  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math.h"
@@ -37,21 +39,14 @@ private:
 
     ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
-  }
 
-  static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
-                          int64_t M, int64_t N, int64_t K,
-                          float alpha,
-                          const T* a_data, const T* b_data,
-                          float beta,
-                          const T* c_data, const TensorShape* c_shape,
-                          T* y_data,
-                          concurrency::ThreadPool* thread_pool) {
-    // if input is empty tensor, return directly as nothing need to be calculated.
-    if (M == 0 || N == 0)
-      return;
+    TryPackWeights(info);
+  }
 
-    // Broadcast the bias as needed if bias is given
+  // Broadcasts the bias C to the output Y, as needed by a GEMM with a non-zero beta.
+  static void BroadcastBias(int64_t M, int64_t N, float beta,
+                            const T* c_data, const TensorShape* c_shape,
+                            T* y_data) {
     if (beta != 0 && c_data != nullptr) {
       ORT_ENFORCE(c_shape != nullptr, "c_shape is required if c_data is provided");
       auto output_mat = EigenMatrixMapRowMajor<T>(y_data, M, N);
@@ -69,6 +64,22 @@ private:
         output_mat = ConstEigenMatrixMapRowMajor<T>(c_data, M, N);
       }
     }
+  }
+
+  static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                          int64_t M, int64_t N, int64_t K,
+                          float alpha,
+                          const T* a_data, const T* b_data,
+                          float beta,
+                          const T* c_data, const TensorShape* c_shape,
+                          T* y_data,
+                          concurrency::ThreadPool* thread_pool) {
+    // if input is empty tensor, return directly as nothing need to be calculated.
+    if (M == 0 || N == 0)
+      return;
+
+    // Broadcast the bias as needed if bias is given
+    BroadcastBias(M, N, beta, c_data, c_shape, y_data);
 
     math::Gemm<T>(trans_a, trans_b,
                   M, N, K,
@@ -110,10 +121,12 @@ private:
 
     T* y_data = Y->MutableData<T>();
 
-    ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, X->Data<T>(), W->Data<T>(), beta_,
-                b_data, b_shape,
-                y_data,
-                thread_pool);
+    if (!TryComputePacked(M, N, K, X->Data<T>(), b_data, b_shape, y_data, thread_pool)) {
+      ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, X->Data<T>(), W->Data<T>(), beta_,
+                  b_data, b_shape,
+                  y_data,
+                  thread_pool);
+    }
 
     if(activation_){
       std::unique_ptr<functors::ElementWiseRangedTransform<T>> f(activation_->Copy());
@@ -128,14 +141,51 @@ private:
   }
 
  private:
+  // The prepacked GEMM paths are only implemented for float, see the specializations in gemm.cc.
+  void TryPackWeights(const OpKernelInfo& /*info*/) {}
+
+  bool TryComputePacked(int64_t /*M*/, int64_t /*N*/, int64_t /*K*/, const T* /*a_data*/,
+                      const T* /*c_data*/, const TensorShape* /*c_shape*/, T* /*y_data*/,
+                      concurrency::ThreadPool* /*thread_pool*/) const {
+    return false;
+  }
+
   CBLAS_TRANSPOSE trans_A_;
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
 
+  const bool use_packed_sgemm = packed_b_ && !packed_b_is_sparse_ && !packed_b_is_bf16_ && helper.M() > 1;
+
+  size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    if (packed_b_is_sparse_) {
+      BlockSparseGemm(static_cast<size_t>(helper.M()),
+                      static_cast<size_t>(helper.N()),
+                      static_cast<size_t>(helper.K()),
+                      1.0f,
+                      left_X->Data<float>() + helper.LeftOffsets()[i],
+                      static_cast<size_t>(helper.K()),
+                      packed_b_.get(),
+                      0.0f,
+                      Y->MutableData<float>() + helper.OutputOffsets()[i],
+                      static_cast<size_t>(helper.N()),
+                      thread_pool);
+      continue;
+    }
+
+
  protected:
   // For fused gemm + activation  
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 };
 
+template <>
+void Gemm<float>::TryPackWeights(const OpKernelInfo& info);
+
+template <>
+bool Gemm<float>::TryComputePacked(int64_t M, int64_t N, int64_t K, const float* a_data,
+                                   const float* c_data, const TensorShape* c_shape, float* y_data,
+                                   concurrency::ThreadPool* thread_pool) const;
+
 }  // namespace onnxruntime
@@ -0,0 +1,360 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/gemm_packing_helper.h"
+
+#include <algorithm>
+
+#include "core/framework/prepacked_weights_cache.h"
+#include "core/framework/prepacked_weights_store.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/util/qmath.h"
+
+namespace onnxruntime {
+
+namespace {
+
+const CPUExecutionProvider* GetCpuExecutionProvider(const OpKernelInfo& info) {
+  const IExecutionProvider* provider = info.GetExecutionProvider();
+  if (provider == nullptr || provider->Type() != kCpuExecutionProvider) {
+    return nullptr;
+  }
+  return static_cast<const CPUExecutionProvider*>(provider);
+}
+
+// Returns the constant 2D input at input_index, or nullptr if the input is not a constant 2D tensor.
+const Tensor* GetConstant2DInput(const OpKernelInfo& info, int input_index) {
+  const Tensor* b;
+  if (!info.TryGetConstantInput(input_index, &b) || b->Shape().NumDimensions() != 2) {
+    return nullptr;
+  }
+  return b;
+}
+
+// Returns the path to the subgraph containing the node, outermost first, which tells apart the initializers of
+// different subgraphs with the same name, such as the ones of the two branches of an If. Each control flow node is
+// named after its first output, which is unique in the model unlike the node names, followed by the attribute
+// holding the subgraph. The path of a node of the main graph is empty.
+std::string GetSubgraphPath(const Node& node) {
+  std::string path;
+  for (const Graph* graph = &node.GetContainingGraph(); graph->IsSubgraph(); graph = graph->ParentGraph()) {
+    const Node& parent_node = *graph->ParentNode();
+    for (const auto& attribute : parent_node.GetAttributes()) {
+      if (parent_node.GetGraphAttribute(attribute.first) == graph) {
+        path = parent_node.OutputDefs()[0]->Name() + "/" + attribute.first + "/" + path;
+        break;
+      }
+    }
+  }
+  return path;
+}
+
+// Allocates packed_b_size bytes, fills them with pack_b and stores the buffer to packed_b. The buffer is
+// exchanged for an identical buffer of another kernel if the execution provider shares prepacked weights.
+// If the execution provider has a store of saved prepacked weights, packed_b points into the store instead when it
+// holds the weight, or the buffer is recorded to the store to be saved. `part` tells apart the buffers packed from
+// different parts of the same input.
+template <typename PackFn>
+void PackWeights(const OpKernelInfo& info, int input_index, bool trans_b, size_t part, const char* format,
+                 size_t packed_b_size, PackFn pack_b, std::shared_ptr<void>& packed_b) {
+  const CPUExecutionProvider* provider = GetCpuExecutionProvider(info);
+  const bool share = provider != nullptr && provider->SharePrepackedWeights();
+  PrepackedWeightsStore* store = provider != nullptr ? provider->GetPrepackedWeightsStore() : nullptr;
+
+  std::string key;
+  if (store != nullptr) {
+    key = std::string(format) + "|" + GetSubgraphPath(info.node()) + info.node().InputDefs()[input_index]->Name() +
+          (trans_b ? "|T|" : "|N|") + std::to_string(part);
+  }
+
+  // the sessions mapping the same file share its pages, so the saved weights aren't exchanged through the cache
+  if (store != nullptr && store->IsLoaded()) {
+    packed_b = store->Get(key, packed_b_size);
+    if (packed_b != nullptr) {
+      return;
+    }
+  }
+
+  auto alloc = share ? PrepackedWeightsCache::Instance().Allocator() : info.GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  BufferUniquePtr buffer(packed_b_data, BufferDeleter(alloc));
+  pack_b(packed_b_data);
+
+  if (share) {
+    packed_b = PrepackedWeightsCache::Instance().Share(format, std::move(buffer), packed_b_size);
+  } else {
+    packed_b = std::shared_ptr<void>(buffer.release(), BufferDeleter(alloc));
+  }
+
+  if (store != nullptr && !store->IsLoaded()) {
+    store->Record(key, packed_b, packed_b_size);
+  }
+}
+
+// A B packed for BlockSparseGemm is this header followed by the K + 1 offsets of the first block of each row of B,
+// the starting column of each block, then the kSparseGemmBlockSize values of each block, padded with zeros past N.
+struct BlockSparseWeights {
+  size_t K;
+  size_t N;
+  size_t num_blocks;
+
+  const size_t* RowOffsets() const { return reinterpret_cast<const size_t*>(this + 1); }
+  const size_t* BlockColumns() const { return RowOffsets() + K + 1; }
+  const float* BlockValues() const { return reinterpret_cast<const float*>(BlockColumns() + num_blocks); }
+};
+
+constexpr size_t kSparseGemmBlockSize = 8;
+
+}  // namespace
+
+bool TryPackBf16GemmWeights(const OpKernelInfo& info, int input_index, bool trans_b,
+                            std::shared_ptr<void>& packed_b) {
+  const CPUExecutionProvider* provider = GetCpuExecutionProvider(info);
+  if (provider == nullptr || !provider->Bf16GemmEnabled()) {
+    return false;
+  }
+
+  const Tensor* b = GetConstant2DInput(info, input_index);
+  if (b == nullptr || !b->IsDataType<float>()) {
+    return false;
+  }
+
+  const auto& shape = b->Shape();
+  const size_t K = static_cast<size_t>(trans_b ? shape[1] : shape[0]);
+  const size_t N = static_cast<size_t>(trans_b ? shape[0] : shape[1]);
+
+  const size_t packed_b_size = MlasGemmBf16PackBSize(N, K);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  PackWeights(info, input_index, trans_b, 0, "MlasGemmBf16PackB", packed_b_size, [&](void* packed_b_data) {
+    MlasGemmBf16PackB(trans_b ? CblasTrans : CblasNoTrans, N, K, b->Data<float>(),
+                      static_cast<size_t>(shape[1]), packed_b_data);
+  }, packed_b);
+  return true;
+}
+
+bool TryPackSgemmWeights(const OpKernelInfo& info, int input_index, bool trans_b,
+                         std::shared_ptr<void>& packed_b) {
+  const Tensor* b = GetConstant2DInput(info, input_index);
+  if (b == nullptr || !b->IsDataType<float>()) {
+    return false;
+  }
+
+  const auto& shape = b->Shape();
+  const size_t K = static_cast<size_t>(trans_b ? shape[1] : shape[0]);
+  const size_t N = static_cast<size_t>(trans_b ? shape[0] : shape[1]);
+
+  const size_t packed_b_size = MlasGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  PackWeights(info, input_index, trans_b, 0, "MlasSgemmPackB", packed_b_size, [&](void* packed_b_data) {
+    MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans, N, K, b->Data<float>(),
+                  static_cast<size_t>(shape[1]), packed_b_data);
+  }, packed_b);
+  return true;
+}
+
+bool TryPackBatchedSgemmWeights(const OpKernelInfo& info, int input_index, bool trans_b,
+                                const std::vector<size_t>& n_blocks,
+                                std::vector<std::shared_ptr<void>>& packed_b) {
+  const Tensor* b;
+  if (!info.TryGetConstantInput(input_index, &b) || b->Shape().NumDimensions() != 3 || !b->IsDataType<float>()) {
+    return false;
+  }
+
+  const auto& shape = b->Shape();
+  const size_t batch = static_cast<size_t>(shape[0]);
+  const size_t K = static_cast<size_t>(trans_b ? shape[2] : shape[1]);
+  const size_t N = static_cast<size_t>(trans_b ? shape[1] : shape[2]);
+  const size_t ldb = static_cast<size_t>(shape[2]);
+
+  std::vector<size_t> blocks = n_blocks.empty() ? std::vector<size_t>{N} : n_blocks;
+  size_t total_n = 0;
+  for (size_t block_n : blocks) {
+    if (block_n == 0 || MlasGemmPackBSize(block_n, K) == 0) {
+      return false;
+    }
+    total_n += block_n;
+  }
+  if (batch == 0 || total_n != N) {
+    return false;
+  }
+
+  packed_b.resize(batch * blocks.size());
+  auto packed_b_iter = packed_b.begin();
+  for (size_t i = 0; i < batch; ++i) {
+    const float* matrix = b->Data<float>() + i * N * K;
+    size_t n = 0;
+    for (size_t block_n : blocks) {
+      // a block of N is a block of rows of B if it is transposed, else a block of its columns
+      const float* block = matrix + (trans_b ? n * ldb : n);
+      const size_t part = static_cast<size_t>(packed_b_iter - packed_b.begin());
+      const size_t packed_b_size = MlasGemmPackBSize(block_n, K);
+      PackWeights(info, input_index, trans_b, part, "MlasSgemmPackB", packed_b_size, [&](void* packed_b_data) {
+        MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans, block_n, K, block, ldb, packed_b_data);
+      }, *packed_b_iter++);
+      n += block_n;
+    }
+  }
+  return true;
+}
+
+bool TryPackQGemmWeights(const OpKernelInfo& info, int input_index, std::shared_ptr<void>& packed_b) {
+#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
+  const Tensor* b = GetConstant2DInput(info, input_index);
+  if (b == nullptr || !(b->IsDataType<uint8_t>() || b->IsDataType<int8_t>())) {
+    return false;
+  }
+
+  const auto& shape = b->Shape();
+  const size_t K = static_cast<size_t>(shape[0]);
+  const size_t N = static_cast<size_t>(shape[1]);
+  const bool b_is_signed = b->IsDataType<int8_t>();
+
+  const size_t packed_b_size = MlasGemmPackBSize(N, K, b_is_signed);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  const char* format = b_is_signed ? "MlasGemmPackB/s8" : "MlasGemmPackB/u8";
+  PackWeights(info, input_index, false, 0, format, packed_b_size, [&](void* packed_b_data) {
+    MlasGemmPackB(N, K, static_cast<const uint8_t*>(b->DataRaw()), N, b_is_signed, packed_b_data);
+  }, packed_b);
+  return true;
+#else
+  ORT_UNUSED_PARAMETER(info);
+  ORT_UNUSED_PARAMETER(input_index);
+  ORT_UNUSED_PARAMETER(packed_b);
+  return false;
+#endif
+}
+
+bool TryPackBlockSparseGemmWeights(const OpKernelInfo& info, int input_index, bool trans_b,
+                                   std::shared_ptr<void>& packed_b) {
+  const CPUExecutionProvider* provider = GetCpuExecutionProvider(info);
+  if (provider == nullptr || !provider->SparseGemmEnabled()) {
+    return false;
+  }
+
+  const Tensor* b = GetConstant2DInput(info, input_index);
+  if (b == nullptr || !b->IsDataType<float>()) {
+    return false;
+  }
+
+  const auto& shape = b->Shape();
+  const size_t K = static_cast<size_t>(trans_b ? shape[1] : shape[0]);
+  const size_t N = static_cast<size_t>(trans_b ? shape[0] : shape[1]);
+  const size_t ldb = static_cast<size_t>(shape[1]);
+  const float* b_data = b->Data<float>();
+  auto element = [&](size_t k, size_t n) { return trans_b ? b_data[n * ldb + k] : b_data[k * ldb + n]; };
+  auto block_is_zero = [&](size_t k, size_t n) {
+    for (size_t end = std::min(n + kSparseGemmBlockSize, N); n < end; ++n) {
+      if (element(k, n) != 0.0f) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  size_t num_blocks = 0;
+  for (size_t k = 0; k < K; ++k) {
+    for (size_t n = 0; n < N; n += kSparseGemmBlockSize) {
+      num_blocks += block_is_zero(k, n) ? 0 : 1;
+    }
+  }
+
+  // denser weights are faster with the dense GEMM
+  if (K * N == 0 || num_blocks * kSparseGemmBlockSize * 4 > K * N) {
+    return false;
+  }
+
+  const size_t packed_b_size = sizeof(BlockSparseWeights) + (K + 1 + num_blocks) * sizeof(size_t) +
+                               num_blocks * kSparseGemmBlockSize * sizeof(float);
+
+  PackWeights(info, input_index, trans_b, 0, "BlockSparseGemmPackB", packed_b_size, [&](void* packed_b_data) {
+    auto* weights = static_cast<BlockSparseWeights*>(packed_b_data);
+    weights->K = K;
+    weights->N = N;
+    weights->num_blocks = num_blocks;
+
+    auto* row_offsets = const_cast<size_t*>(weights->RowOffsets());
+    auto* block_columns = const_cast<size_t*>(weights->BlockColumns());
+    auto* block_values = const_cast<float*>(weights->BlockValues());
+    size_t block = 0;
+    for (size_t k = 0; k < K; ++k) {
+      row_offsets[k] = block;
+      for (size_t n = 0; n < N; n += kSparseGemmBlockSize) {
+        if (block_is_zero(k, n)) {
+          continue;
+        }
+        block_columns[block] = n;
+        float* values = block_values + block * kSparseGemmBlockSize;
+        for (size_t i = 0; i < kSparseGemmBlockSize; ++i) {
+          values[i] = n + i < N ? element(k, n + i) : 0.0f;
+        }
+        ++block;
+      }
+    }
+    row_offsets[K] = block;
+  }, packed_b);
+  return true;
+}
+
+void BlockSparseGemm(size_t M, size_t N, size_t K, float alpha, const float* A, size_t lda, const void* packed_b,
+                     float beta, float* C, size_t ldc, concurrency::ThreadPool* thread_pool) {
+  const auto& weights = *static_cast<const BlockSparseWeights*>(packed_b);
+  ORT_ENFORCE(weights.K == K && weights.N == N, "Packed sparse weights do not match the GEMM shape");
+
+  const size_t* row_offsets = weights.RowOffsets();
+  const size_t* block_columns = weights.BlockColumns();
+  const float* block_values = weights.BlockValues();
+
+  // each row of C accumulates alpha * A[m, k] times the blocks of row k of B
+  auto compute_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t m = first; m < last; ++m) {
+      const float* a = A + m * lda;
+      float* c = C + m * ldc;
+      if (beta == 0.0f) {
+        std::fill_n(c, N, 0.0f);
+      } else if (beta != 1.0f) {
+        std::transform(c, c + N, c, [beta](float value) { return beta * value; });
+      }
+
+      for (size_t k = 0; k < K; ++k) {
+        const float a_value = alpha * a[k];
+        if (a_value == 0.0f) {
+          continue;
+        }
+        for (size_t block = row_offsets[k], end = row_offsets[k + 1]; block < end; ++block) {
+          const size_t n = block_columns[block];
+          const float* values = block_values + block * kSparseGemmBlockSize;
+          float* c_block = c + n;
+          if (n + kSparseGemmBlockSize <= N) {
+            // fixed trip count so that the compiler vectorizes it
+            for (size_t i = 0; i < kSparseGemmBlockSize; ++i) {
+              c_block[i] += a_value * values[i];
+            }
+          } else {
+            for (size_t i = 0, count = N - n; i < count; ++i) {
+              c_block[i] += a_value * values[i];
+            }
+          }
+        }
+      }
+    }
+  };
+
+  const double row_compute = 2.0 * static_cast<double>(weights.num_blocks * kSparseGemmBlockSize);
+  concurrency::ThreadPool::TryParallelFor(thread_pool, static_cast<std::ptrdiff_t>(M),
+                                          TensorOpCost{static_cast<double>(K * sizeof(float)),
+                                                       static_cast<double>(N * sizeof(float)),
+                                                       row_compute},
+                                          compute_rows);
+}
+
+}  // namespace onnxruntime
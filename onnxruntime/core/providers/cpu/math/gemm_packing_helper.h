@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+
+// Helpers to pack the constant 2D B input of a GEMM based kernel for the MLAS prepacked GEMM routines.
+// B is [K, N], or [N, K] if trans_b is set. Each helper returns false and leaves packed_b empty if B is not packed.
+// If the CPU execution provider shares prepacked weights, packed_b may be a buffer shared with other kernels.
+
+// Packs a float B for MlasGemmBf16 if the CPU execution provider enabled the bfloat16 GEMM and the platform
+// supports it.
+bool TryPackBf16GemmWeights(const OpKernelInfo& info, int input_index, bool trans_b,
+                            std::shared_ptr<void>& packed_b);
+
+// Packs a float B for the single precision MlasGemm.
+bool TryPackSgemmWeights(const OpKernelInfo& info, int input_index, bool trans_b,
+                         std::shared_ptr<void>& packed_b);
+
+// Packs each matrix of a float constant 3D B input for the single precision MlasGemm, such as the per direction
+// weights of the RNN operators. B is [batch, K, N], or [batch, N, K] if trans_b is set. If n_blocks is not empty, the
+// N columns of each matrix are packed in separate buffers of n_blocks[i] columns, which must add up to N, so that a
+// GEMM can use a block of them. packed_b receives the buffers of each matrix in order.
+bool TryPackBatchedSgemmWeights(const OpKernelInfo& info, int input_index, bool trans_b,
+                                const std::vector<size_t>& n_blocks,
+                                std::vector<std::shared_ptr<void>>& packed_b);
+
+// Packs an 8-bit B for the quantized MlasGemm if the platform supports packed quantized GEMMs.
+bool TryPackQGemmWeights(const OpKernelInfo& info, int input_index, std::shared_ptr<void>& packed_b);
+
+// Packs a float B for BlockSparseGemm if the CPU execution provider enabled the sparse GEMM and at most a quarter
+// of B is in blocks holding non-zero values. The blocks are runs of consecutive columns of a row of [K, N] B.
+bool TryPackBlockSparseGemmWeights(const OpKernelInfo& info, int input_index, bool trans_b,
+                                   std::shared_ptr<void>& packed_b);
+
+// Computes C = alpha * A * B + beta * C with B packed by TryPackBlockSparseGemmWeights. A is [M, K] and C is [M, N],
+// which must match the K and N of the packed B. Only the non-zero blocks of B are read.
+void BlockSparseGemm(size_t M, size_t N, size_t K, float alpha, const float* A, size_t lda, const void* packed_b,
+                     float beta, float* C, size_t ldc, concurrency::ThreadPool* thread_pool);
+
+}  // namespace onnxruntime
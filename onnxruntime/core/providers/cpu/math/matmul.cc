@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/matmul.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_packing_helper.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "matmul_helper.h"
@@ -22,6 +24,13 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     MatMul<double>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1, 8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 // opset 9 supports more types
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     MatMul,
@@ -37,6 +46,13 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     MatMul<double>);
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    9,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     MatMul,
     9,
@@ -92,4 +108,169 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+namespace {
+
+// Returns whether the slices of the batch are evenly spaced in the inputs and the output, as the strided batched
+// GEMM requires, along with their strides.
+bool GetUniformBatchStrides(const MatMulComputeHelper& helper, size_t& stride_a, size_t& stride_b, size_t& stride_c) {
+  const auto& left_offsets = helper.LeftOffsets();
+  const auto& right_offsets = helper.RightOffsets();
+  const auto& output_offsets = helper.OutputOffsets();
+  stride_a = left_offsets[1] - left_offsets[0];
+  stride_b = right_offsets[1] - right_offsets[0];
+  stride_c = output_offsets[1] - output_offsets[0];
+  for (size_t i = 2; i < output_offsets.size(); i++) {
+    if (left_offsets[i] - left_offsets[i - 1] != stride_a ||
+        right_offsets[i] - right_offsets[i - 1] != stride_b ||
+        output_offsets[i] - output_offsets[i - 1] != stride_c) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+MatMul<float>::MatMul(const OpKernelInfo& info) : OpKernel(info) {
+  packed_b_is_sparse_ = TryPackBlockSparseGemmWeights(info, 1, false, packed_b_);
+  if (!packed_b_is_sparse_) {
+    packed_b_is_bf16_ = TryPackBf16GemmWeights(info, 1, false, packed_b_);
+  }
+  if (!packed_b_is_sparse_ && !packed_b_is_bf16_) {
+    TryPackSgemmWeights(info, 1, false, packed_b_);
+  }
+}
+
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  // The packed single precision GEMM is slower than the regular path for a single row, which does not amortize
+  // the reads of the larger packed panels.
+  const bool use_packed_sgemm = packed_b_ && !packed_b_is_sparse_ && !packed_b_is_bf16_ && helper.M() > 1;
+
+  size_t max_len = helper.OutputOffsets().size();
+
+  // A GEMM per slice can't use many threads when the slices are small. The batched GEMM instead spreads whole
+  // slices over the threads when there are enough of them, and splits each slice otherwise.
+  size_t stride_a, stride_b, stride_c;
+  if (max_len > 1 && !packed_b_is_sparse_ && !packed_b_is_bf16_ && !use_packed_sgemm &&
+      GetUniformBatchStrides(helper, stride_a, stride_b, stride_c)) {
+    MlasGemmBatch(CblasNoTrans,
+                  CblasNoTrans,
+                  static_cast<size_t>(helper.M()),
+                  static_cast<size_t>(helper.N()),
+                  static_cast<size_t>(helper.K()),
+                  1.0f,
+                  left_X->Data<float>(),
+                  static_cast<size_t>(helper.K()),
+                  stride_a,
+                  right_X->Data<float>(),
+                  static_cast<size_t>(helper.N()),
+                  stride_b,
+                  0.0f,
+                  Y->MutableData<float>(),
+                  static_cast<size_t>(helper.N()),
+                  stride_c,
+                  max_len,
+                  thread_pool);
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < max_len; i++) {
+    if (packed_b_is_sparse_) {
+      BlockSparseGemm(static_cast<size_t>(helper.M()),
+                      static_cast<size_t>(helper.N()),
+                      static_cast<size_t>(helper.K()),
+                      1.0f,
+                      left_X->Data<float>() + helper.LeftOffsets()[i],
+                      static_cast<size_t>(helper.K()),
+                      packed_b_.get(),
+                      0.0f,
+                      Y->MutableData<float>() + helper.OutputOffsets()[i],
+                      static_cast<size_t>(helper.N()),
+                      thread_pool);
+      continue;
+    }
+    if (packed_b_is_bf16_) {
+      MlasGemmBf16(static_cast<size_t>(helper.M()),
+                   static_cast<size_t>(helper.N()),
+                   static_cast<size_t>(helper.K()),
+                   1.0f,
+                   left_X->Data<float>() + helper.LeftOffsets()[i],
+                   static_cast<size_t>(helper.K()),
+                   packed_b_.get(),
+                   0.0f,
+                   Y->MutableData<float>() + helper.OutputOffsets()[i],
+                   static_cast<size_t>(helper.N()),
+                   thread_pool);
+      continue;
+    }
+    if (use_packed_sgemm) {
+      MlasGemm(CblasNoTrans,
+               static_cast<size_t>(helper.M()),
+               static_cast<size_t>(helper.N()),
+               static_cast<size_t>(helper.K()),
+               1.0f,
+               left_X->Data<float>() + helper.LeftOffsets()[i],
+               static_cast<size_t>(helper.K()),
+               packed_b_.get(),
+               0.0f,
+               Y->MutableData<float>() + helper.OutputOffsets()[i],
+               static_cast<size_t>(helper.N()),
+               thread_pool);
+      continue;
+    }
+    math::MatMul<float>(
+        static_cast<int>(helper.M()),
+        static_cast<int>(helper.N()),
+        static_cast<int>(helper.K()),
+        left_X->Data<float>() + helper.LeftOffsets()[i],
+        right_X->Data<float>() + helper.RightOffsets()[i],
+        Y->MutableData<float>() + helper.OutputOffsets()[i], thread_pool);
+  }
+
+  return Status::OK();
+}
+
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  // MLFloat16 is a wrapper of the IEEE half-precision bits
+  const auto* left_data = reinterpret_cast<const unsigned short*>(left_X->Data<MLFloat16>());
+  const auto* right_data = reinterpret_cast<const unsigned short*>(right_X->Data<MLFloat16>());
+  auto* output_data = reinterpret_cast<unsigned short*>(Y->MutableData<MLFloat16>());
+
+  size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    MlasHalfGemm(static_cast<size_t>(helper.M()),
+                 static_cast<size_t>(helper.N()),
+                 static_cast<size_t>(helper.K()),
+                 left_data + helper.LeftOffsets()[i],
+                 static_cast<size_t>(helper.K()),
+                 right_data + helper.RightOffsets()[i],
+                 static_cast<size_t>(helper.N()),
+                 output_data + helper.OutputOffsets()[i],
+                 static_cast<size_t>(helper.N()),
+                 thread_pool);
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
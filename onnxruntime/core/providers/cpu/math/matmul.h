@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 
@@ -18,4 +20,31 @@ class MatMul final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <>
+class MatMul<float> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // constant B packed for the block sparse GEMM or the bfloat16 GEMM if enabled by the execution provider, else for
+  // the single precision GEMM
+  std::shared_ptr<void> packed_b_;
+  bool packed_b_is_sparse_{false};
+  bool packed_b_is_bf16_{false};
+};
+
+// Computed by the half-precision GEMM, which accumulates in half precision on processors with native float16
+// arithmetic and in single precision otherwise.
+template <>
+class MatMul<MLFloat16> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info)
+      : OpKernel(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
 }  // namespace onnxruntime
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_packing_helper.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/qmath.h"
@@ -11,9 +13,15 @@ namespace onnxruntime {
 
 class MatMulInteger final : public OpKernel {
  public:
-  MatMulInteger(const OpKernelInfo& info) : OpKernel(info) {}
+  MatMulInteger(const OpKernelInfo& info) : OpKernel(info) {
+    TryPackQGemmWeights(info, 1, packed_b_);
+  }
 
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // constant B packed for the quantized GEMM, if supported by the platform
+  std::shared_ptr<void> packed_b_;
 };
 
 ONNX_OPERATOR_TYPED_KERNEL_EX(
@@ -60,6 +68,23 @@ Status MatMulInteger::Compute(OpKernelContext* ctx) const {
   auto* y_data = y->template MutableData<int32_t>();
 
   for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+#ifdef MLAS_SUPPORTS_PACKED_GEMM_U8X8
+    if (packed_b_) {
+      MlasGemm(static_cast<size_t>(helper.M()),
+               static_cast<size_t>(helper.N()),
+               static_cast<size_t>(helper.K()),
+               a_data + helper.LeftOffsets()[i],
+               static_cast<size_t>(helper.K()),
+               a_offset,
+               packed_b_.get(),
+               b_offset,
+               b_is_signed,
+               y_data + helper.OutputOffsets()[i],
+               static_cast<size_t>(helper.N()),
+               thread_pool);
+      continue;
+    }
+#endif
     QGemm(static_cast<int>(helper.M()),
           static_cast<int>(helper.N()),
           static_cast<int>(helper.K()),
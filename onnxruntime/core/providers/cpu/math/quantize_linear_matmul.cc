@@ -38,14 +38,20 @@ Status QLinearMatMul::Compute(OpKernelContext* ctx) const {
   ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
   Tensor* y = ctx->Output(0, helper.OutputShape());
 
+  // The weight can be quantized per column, with 1D scale and zero point tensors of size N.
+  const int64_t n = static_cast<int64_t>(helper.N());
+  auto is_per_column = [n](const Tensor* tensor) {
+    return tensor->Shape().NumDimensions() == 1 && tensor->Shape()[0] == n;
+  };
+
   // validate offsets
   const auto* a_offset = ctx->Input<Tensor>(2);
   const auto* b_offset = ctx->Input<Tensor>(5);
   const auto* y_offset = ctx->Input<Tensor>(7);
   ORT_ENFORCE(IsScalarOr1ElementVector(a_offset),
               "QLinearMatmul : input zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(b_offset),
-              "QLinearMatmul : weight zero point must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(b_offset) || is_per_column(b_offset),
+              "QLinearMatmul : weight zero point must be a scalar or 1D tensor of size 1 or N");
   ORT_ENFORCE(IsScalarOr1ElementVector(y_offset),
               "QLinearMatmul : result zero point must be a scalar or 1D tensor of size 1");
 
@@ -55,16 +61,28 @@ Status QLinearMatMul::Compute(OpKernelContext* ctx) const {
   const auto* y_scale = ctx->Input<Tensor>(6);
   ORT_ENFORCE(IsScalarOr1ElementVector(a_scale),
               "QLinearMatmul : input scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(b_scale),
-              "QLinearMatmul : weight scale must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(b_scale) || is_per_column(b_scale),
+              "QLinearMatmul : weight scale must be a scalar or 1D tensor of size 1 or N");
   ORT_ENFORCE(IsScalarOr1ElementVector(y_scale),
               "QLinearMatmul : result scale must be a scalar or 1D tensor of size 1");
 
+  // The GEMM subtracts a single weight zero point, so per column zero points must all be the same,
+  // as they are for symmetrically quantized weights.
+  const auto b_offset_data = b_offset->DataAsSpan<uint8_t>();
+  ORT_ENFORCE(std::all_of(b_offset_data.cbegin(), b_offset_data.cend(),
+                          [&b_offset_data](uint8_t offset) { return offset == b_offset_data[0]; }),
+              "QLinearMatmul : weight zero points must have the same value");
+
   auto a_scale_data = *(a_scale->template Data<float>());
-  auto b_scale_data = *(b_scale->template Data<float>());
   auto y_scale_data = *(y_scale->template Data<float>());
 
-  const float real_multiplier = (a_scale_data * b_scale_data) / y_scale_data;
+  // The scale used to requantize each column of the output.
+  const auto b_scale_data = b_scale->DataAsSpan<float>();
+  std::vector<float> output_scales(b_scale_data.size());
+  for (size_t i = 0; i < output_scales.size(); ++i) {
+    output_scales[i] = (a_scale_data * b_scale_data[i]) / y_scale_data;
+  }
+  const bool is_b_per_column = output_scales.size() != 1;
 
 #ifdef MLAS_SUPPORTS_GEMM_U8X8
   AllocatorPtr alloc;
@@ -74,10 +92,12 @@ Status QLinearMatMul::Compute(OpKernelContext* ctx) const {
   BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
   auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
 #else
+  ORT_RETURN_IF(is_b_per_column, "QLinearMatmul : per column weight quantization is not supported on this platform");
+
   // Compute the fixed point multiplier and shift for requantizing with GEMMLOWP.
   int32_t integer_multiplier;
   int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+  QuantizeMultiplier(output_scales[0], &integer_multiplier, &right_shift);
 #endif
 
   for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
@@ -96,13 +116,24 @@ Status QLinearMatMul::Compute(OpKernelContext* ctx) const {
           static_cast<int>(helper.N()),
           ctx->GetOperatorThreadPool());
 
-    MlasRequantizeOutput(gemm_output,
-                         y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
-                         nullptr,
-                         static_cast<size_t>(helper.M()),
-                         static_cast<size_t>(helper.N()),
-                         real_multiplier,
-                         *y_offset->template Data<uint8_t>());
+    if (is_b_per_column) {
+      MlasRequantizeOutput(gemm_output,
+                           y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
+                           nullptr,
+                           static_cast<size_t>(helper.M()),
+                           static_cast<size_t>(helper.N()),
+                           output_scales.data(),
+                           true,
+                           *y_offset->template Data<uint8_t>());
+    } else {
+      MlasRequantizeOutput(gemm_output,
+                           y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
+                           nullptr,
+                           static_cast<size_t>(helper.M()),
+                           static_cast<size_t>(helper.N()),
+                           output_scales[0],
+                           *y_offset->template Data<uint8_t>());
+    }
 #else
     GemmlowpMultiplyu8u8_u8(a->template Data<uint8_t>() + helper.LeftOffsets()[i],
                             b->template Data<uint8_t>() + helper.RightOffsets()[i],
@@ -20,11 +20,15 @@
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 #include <queue>
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
+#include <limits>
 
 using namespace std;
 namespace onnxruntime {
@@ -140,6 +144,311 @@ static void SelectTopK(const Comparator& comparer,
   // the data_holder now contains the indices of the top k elements in the first k elements
 }
 
+// The selection over contiguous rows (TopK on the innermost axis) of large size uses the algorithms below, which
+// are also used on chunks of a single row so that long rows are split across threads.
+
+// a value and its index in the row
+template <typename T>
+struct ValueIndex {
+  T value;
+  int64_t index;
+};
+
+// Orders values with the comparator, and equal values by lower index, the same as the comparators do for indices.
+template <class Comparator>
+struct ValueIndexCmp {
+  using T = typename Comparator::DataType;
+
+  explicit ValueIndexCmp(const Comparator& comparer) : comparer_(comparer) {
+  }
+
+  bool operator()(const ValueIndex<T>& lhs, const ValueIndex<T>& rhs) const {
+    return comparer_.CompareValueOnly(lhs.value, rhs.value) || (lhs.value == rhs.value && lhs.index < rhs.index);
+  }
+
+ private:
+  const Comparator& comparer_;
+};
+
+// Moves the best k of the candidates to the front, sorting them if requested, and drops the others.
+template <class Comparator>
+static void KeepTopK(const Comparator& comparer, unsigned k, bool sort_top_k,
+                     vector<ValueIndex<typename Comparator::DataType>>& candidates) {
+  ValueIndexCmp<Comparator> cmp(comparer);
+  if (candidates.size() > k) {
+    nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end(), cmp);
+    candidates.resize(k);
+  }
+
+  if (sort_top_k) {
+    std::sort(candidates.begin(), candidates.end(), cmp);
+  }
+}
+
+template <typename T>
+static void FindMinMax(const T* data, size_t n, T& min_value, T& max_value) {
+  // no branches so the compiler can vectorize the loop
+  min_value = max_value = data[0];
+  for (size_t i = 1; i < n; ++i) {
+    min_value = std::min(min_value, data[i]);
+    max_value = std::max(max_value, data[i]);
+  }
+}
+
+static void FindMinMax(const float* data, size_t n, float& min_value, float& max_value) {
+  MlasFindMinMaxElement(data, &min_value, &max_value, n);
+}
+
+// number of values that are checked against the threshold together in FilterTopK
+static constexpr size_t kFilterBlockSize = 256;
+
+// Selects the top k of the n values in data, for small k relative to n.
+// The k-th best value seen so far is a threshold that most values of a large row don't beat. Blocks of values are
+// reduced to their min and max with SIMD and skipped if neither beats the threshold. The values of the other blocks
+// that beat the threshold are appended to the candidates, which are cut back to the best k (raising the threshold)
+// when they reach 2k.
+// The candidates are left with the top k, unsorted, with their indices offset by index_base.
+template <class Comparator>
+static void FilterTopK(const Comparator& comparer, const typename Comparator::DataType* data, int64_t n,
+                       int64_t index_base, unsigned k, vector<ValueIndex<typename Comparator::DataType>>& candidates) {
+  candidates.clear();
+  candidates.reserve(2 * static_cast<size_t>(k));
+  for (int64_t l = 0; l < k; ++l) {
+    candidates.push_back({data[l], index_base + l});
+  }
+
+  ValueIndexCmp<Comparator> cmp(comparer);
+  nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end(), cmp);
+  auto threshold = candidates[k - 1].value;
+
+  // a value equal to the threshold can't enter the top k as the k candidates have lower indices, so only values
+  // that beat it are added
+  int64_t l = k;
+  while (l < n) {
+    const auto block_size = static_cast<size_t>(std::min<int64_t>(kFilterBlockSize, n - l));
+    const auto* block = data + l;
+
+    typename Comparator::DataType min_value, max_value;
+    FindMinMax(block, block_size, min_value, max_value);
+    if (comparer.CompareValueOnly(min_value, threshold) || comparer.CompareValueOnly(max_value, threshold)) {
+      for (size_t b = 0; b < block_size; ++b) {
+        if (comparer.CompareValueOnly(block[b], threshold)) {
+          candidates.push_back({block[b], index_base + l + static_cast<int64_t>(b)});
+
+          if (candidates.size() == 2 * static_cast<size_t>(k)) {
+            nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end(), cmp);
+            candidates.resize(k);
+            threshold = candidates[k - 1].value;
+          }
+        }
+      }
+    }
+
+    l += static_cast<int64_t>(block_size);
+  }
+
+  KeepTopK(comparer, k, false, candidates);
+}
+
+// Maps the values to unsigned keys with the same order. -0 and +0 compare equal so they get the same key.
+static inline uint32_t OrderedKey(float value) {
+  if (value == 0.f) {
+    value = 0.f;
+  }
+
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+static inline uint64_t OrderedKey(int64_t value) {
+  return static_cast<uint64_t>(value) ^ (uint64_t{1} << 63);
+}
+
+template <typename Key>
+struct KeyIndex {
+  Key key;
+  int64_t index;
+};
+
+// Selects the top k of the n values in data with a most significant digit first radix select, for larger k.
+// The values are mapped to keys on which the best values are the smallest. Each pass makes a histogram of one digit
+// of the keys that are still tied, and finds the digit of the k-th best key. Values with a smaller digit are
+// selected, values with a larger digit are dropped, and the values with the same digit go on to the next pass.
+// The ties left after the last digit are broken by index as the passes keep the values in index order.
+// The selected values are appended to selected, unsorted, with their indices offset by index_base.
+template <class Comparator>
+static void RadixSelectTopK(const Comparator& comparer, const typename Comparator::DataType* data, int64_t n,
+                            int64_t index_base, unsigned k,
+                            vector<ValueIndex<typename Comparator::DataType>>& selected,
+                            vector<KeyIndex<decltype(OrderedKey(typename Comparator::DataType{}))>>& ties) {
+  using T = typename Comparator::DataType;
+  using Key = decltype(OrderedKey(T{}));
+  constexpr int kDigitBits = 8;
+  constexpr size_t kNumDigits = size_t{1} << kDigitBits;
+
+  // the keys order values ascending, so flip them when selecting the largest values
+  const Key key_mask = comparer.CompareValueOnly(T{1}, T{0}) ? std::numeric_limits<Key>::max() : Key{0};
+
+  std::array<size_t, kNumDigits> histogram;
+  size_t needed = k;
+  int shift = static_cast<int>(sizeof(Key) * 8) - kDigitBits;
+
+  // returns the digit of the needed-th best key, and updates needed to be the number to take from that digit
+  auto find_digit = [&histogram, &needed]() {
+    size_t digit = 0;
+    while (histogram[digit] < needed) {
+      needed -= histogram[digit];
+      ++digit;
+    }
+    return digit;
+  };
+
+  // the first pass reads the input directly
+  histogram.fill(0);
+  for (int64_t l = 0; l < n; ++l) {
+    ++histogram[static_cast<size_t>((OrderedKey(data[l]) ^ key_mask) >> shift)];
+  }
+
+  size_t selected_digit = find_digit();
+  ties.clear();
+  for (int64_t l = 0; l < n; ++l) {
+    const Key key = OrderedKey(data[l]) ^ key_mask;
+    const size_t digit = static_cast<size_t>(key >> shift);
+    if (digit < selected_digit) {
+      selected.push_back({data[l], index_base + l});
+    } else if (digit == selected_digit) {
+      ties.push_back({key, l});
+    }
+  }
+
+  while (needed < ties.size() && shift > 0) {
+    shift -= kDigitBits;
+    histogram.fill(0);
+    for (const auto& tie : ties) {
+      ++histogram[static_cast<size_t>((tie.key >> shift) & (kNumDigits - 1))];
+    }
+
+    selected_digit = find_digit();
+    size_t num_ties = 0;
+    for (const auto& tie : ties) {
+      const size_t digit = static_cast<size_t>((tie.key >> shift) & (kNumDigits - 1));
+      if (digit < selected_digit) {
+        selected.push_back({data[tie.index], index_base + tie.index});
+      } else if (digit == selected_digit) {
+        ties[num_ties++] = tie;
+      }
+    }
+
+    ties.resize(num_ties);
+  }
+
+  for (size_t t = 0; t < needed; ++t) {
+    selected.push_back({data[ties[t].index], index_base + ties[t].index});
+  }
+}
+
+// the smallest rows that FindTopKElementsContiguous is used for
+static constexpr int64_t kMinContiguousSelectionSize = 4096;
+
+// the largest k that FilterTopK is used for. it also requires rows of at least kFilterRatio * k values.
+static constexpr unsigned kMaxFilterK = 512;
+static constexpr int64_t kFilterRatio = 16;
+
+// rough amount of values a thread should select from for the parallelism to pay off
+static constexpr int64_t kMinValuesPerThread = 64 * 1024;
+
+// Selects the top k of the n values in data, with indices offset by index_base, to candidates.
+template <class Comparator>
+static void SelectTopKContiguous(const Comparator& comparer, const typename Comparator::DataType* data, int64_t n,
+                                 int64_t index_base, unsigned k,
+                                 vector<ValueIndex<typename Comparator::DataType>>& candidates,
+                                 vector<KeyIndex<decltype(OrderedKey(typename Comparator::DataType{}))>>& ties) {
+  if (k <= kMaxFilterK && n >= kFilterRatio * k) {
+    FilterTopK(comparer, data, n, index_base, k, candidates);
+  } else {
+    candidates.clear();
+    RadixSelectTopK(comparer, data, n, index_base, k, candidates, ties);
+  }
+}
+
+// Finds the top k of each row of a [rows, cols] input for TopK on the innermost axis with large rows.
+// There are threads for each row if there are enough rows, otherwise each row is split in chunks whose top k are
+// found in parallel and merged.
+template <class Comparator>
+static void FindTopKElementsContiguous(const typename Comparator::DataType* input_data, int64_t rows, int64_t cols,
+                                       const unsigned k, bool sorted,
+                                       EigenMatrixMapRowMajor<typename Comparator::DataType>& values_map,
+                                       EigenMatrixMapRowMajor<int64_t>& indices_map,
+                                       concurrency::ThreadPool* threadpool) {
+  using T = typename Comparator::DataType;
+  using Key = decltype(OrderedKey(T{}));
+  const Comparator comparer(input_data);
+
+  auto write_row = [k, &values_map, &indices_map](int64_t i, const vector<ValueIndex<T>>& top_k) {
+    for (unsigned l = 0; l < k; ++l) {
+      values_map(i, l) = top_k[l].value;
+      indices_map(i, l) = top_k[l].index;
+    }
+  };
+
+  const int64_t tp_threads = concurrency::ThreadPool::NumThreads(threadpool);
+  const int64_t threads_needed = std::max<int64_t>(rows * cols / kMinValuesPerThread, 1);
+  const int64_t num_threads = std::min(tp_threads, threads_needed);
+
+  if (rows >= num_threads) {
+    auto find_top_k = [num_threads, rows, cols, k, sorted, input_data, &comparer, &write_row](std::ptrdiff_t batch) {
+      auto work = concurrency::ThreadPool::PartitionWork(batch, num_threads, rows);
+      vector<ValueIndex<T>> candidates;
+      vector<KeyIndex<Key>> ties;
+      for (auto i = work.start; i < work.end; ++i) {
+        SelectTopKContiguous(comparer, input_data + i * cols, cols, 0, k, candidates, ties);
+        KeepTopK(comparer, k, sorted, candidates);
+        write_row(i, candidates);
+      }
+    };
+
+    if (num_threads <= 1) {
+      find_top_k(0);
+    } else {
+      concurrency::ThreadPool::TrySimpleParallelFor(threadpool, num_threads, find_top_k);
+    }
+
+    return;
+  }
+
+  // each chunk must have at least k values, and enough values to be worth a thread
+  const int64_t num_chunks = std::max<int64_t>(
+      std::min<int64_t>(num_threads, cols / std::max<int64_t>(k, kMinValuesPerThread)), 1);
+  vector<vector<ValueIndex<T>>> chunk_candidates(num_chunks);
+  vector<vector<KeyIndex<Key>>> chunk_ties(num_chunks);
+  vector<ValueIndex<T>> merged;
+
+  for (int64_t i = 0; i < rows; ++i) {
+    const T* row_data = input_data + i * cols;
+    auto find_chunk_top_k = [num_chunks, cols, k, row_data, &comparer,
+                             &chunk_candidates, &chunk_ties](std::ptrdiff_t chunk) {
+      auto work = concurrency::ThreadPool::PartitionWork(chunk, num_chunks, cols);
+      SelectTopKContiguous(comparer, row_data + work.start, work.end - work.start, work.start, k,
+                           chunk_candidates[chunk], chunk_ties[chunk]);
+    };
+
+    if (num_chunks <= 1) {
+      find_chunk_top_k(0);
+    } else {
+      concurrency::ThreadPool::TrySimpleParallelFor(threadpool, num_chunks, find_chunk_top_k);
+    }
+
+    merged.clear();
+    for (const auto& candidates : chunk_candidates) {
+      merged.insert(merged.end(), candidates.begin(), candidates.end());
+    }
+
+    KeepTopK(comparer, k, sorted, merged);
+    write_row(i, merged);
+  }
+}
+
 // Given an input tensor 'input' and metadata values - 'k' and 'axis_parsed',
 // this method will extract the sorted top k largest/smallest elements and place them in the output tensor 'values'
 // along with the metadata output 'indices'
@@ -164,6 +473,11 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
   const int64_t num_blocks = input_shape[axis_parsed];
   const int64_t block_slice = reduced_cols / k;
 
+  if (block_slice == 1 && k != 1 && num_blocks >= kMinContiguousSelectionSize) {
+    FindTopKElementsContiguous<Comparator>(input_data, rows, cols, k, sorted, values_map, indices_map, threadpool);
+    return;
+  }
+
   int64_t tp_threads = concurrency::ThreadPool::NumThreads(threadpool);
   int64_t num_threads = std::min(tp_threads, rows);  // split on rows so can't have more threads than rows
 
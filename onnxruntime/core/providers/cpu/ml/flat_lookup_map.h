@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// An immutable hash map for the key/value attributes of the ML mapping operators, built once when
+// the kernel is created. Keys and values are stored in arrays and the table is open addressed with
+// linear probing, so a lookup touches a couple of contiguous slots instead of following the node
+// chain of std::unordered_map. Each slot caches the hash of its key so that mismatching string keys
+// are rarely compared.
+//
+// Lookup semantics match std::unordered_map<TKey, TValue> filled with operator[]: std::hash and
+// std::equal_to define the keys, and a duplicate key is mapped to the last value inserted.
+template <typename TKey, typename TValue>
+class FlatLookupMap {
+ public:
+  FlatLookupMap() = default;
+
+  void Reserve(size_t num_entries) {
+    pending_.reserve(num_entries);
+  }
+
+  // Adds an entry. Call Build() once all the entries are added.
+  void Insert(const TKey& key, const TValue& value) {
+    ORT_ENFORCE(!built_, "FlatLookupMap can't be modified once built");
+    pending_.emplace_back(key, value);
+  }
+
+  // Builds the table from the added entries.
+  void Build() {
+    ORT_ENFORCE(!built_, "FlatLookupMap is already built");
+    // Keep the load factor at most 1/2 so that probe sequences stay short
+    size_t capacity = 8;
+    while (capacity < pending_.size() * 2) {
+      capacity *= 2;
+    }
+    mask_ = capacity - 1;
+    slots_.assign(capacity, Slot{});
+
+    keys_.reserve(pending_.size());
+    values_.reserve(pending_.size());
+    // Insert in order so that a later duplicate overwrites an earlier one
+    for (auto& entry : pending_) {
+      const size_t hash = Hash(entry.first);
+      size_t pos = hash & mask_;
+      while (true) {
+        Slot& slot = slots_[pos];
+        if (slot.index == 0) {
+          keys_.push_back(std::move(entry.first));
+          values_.push_back(std::move(entry.second));
+          slot.hash = hash;
+          slot.index = keys_.size();
+          break;
+        }
+        if (slot.hash == hash && std::equal_to<TKey>()(keys_[slot.index - 1], entry.first)) {
+          values_[slot.index - 1] = std::move(entry.second);
+          break;
+        }
+        pos = (pos + 1) & mask_;
+      }
+    }
+
+    pending_.clear();
+    pending_.shrink_to_fit();
+    built_ = true;
+  }
+
+  size_t Size() const { return keys_.size(); }
+
+  // Returns the value mapped to key, or nullptr if there is none.
+  const TValue* Find(const TKey& key) const {
+    const size_t hash = Hash(key);
+    size_t pos = hash & mask_;
+    while (true) {
+      const Slot& slot = slots_[pos];
+      if (slot.index == 0) {
+        return nullptr;
+      }
+      if (slot.hash == hash && std::equal_to<TKey>()(keys_[slot.index - 1], key)) {
+        return &values_[slot.index - 1];
+      }
+      pos = (pos + 1) & mask_;
+    }
+  }
+
+  // Maps every element of input to output, writing default_value for missing keys.
+  // Large inputs are split across the thread pool.
+  void Map(const TKey* input, TValue* output, int64_t size, const TValue& default_value,
+           concurrency::ThreadPool* tp) const {
+    ORT_ENFORCE(built_, "FlatLookupMap must be built before it is used");
+    // A hash, a probe or two and a copy of the value
+    constexpr double cost_per_element = 16.0;
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(size), cost_per_element,
+        [this, input, output, &default_value](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i != last; ++i) {
+            const TValue* value = Find(input[i]);
+            output[i] = value != nullptr ? *value : default_value;
+          }
+        });
+  }
+
+ private:
+  struct Slot {
+    size_t hash = 0;
+    size_t index = 0;  // 1-based index of the entry, 0 for an empty slot
+  };
+
+  // Scrambles std::hash, which is the identity for integers, so that keys sharing their low bits
+  // don't all probe the same slots.
+  static size_t Hash(const TKey& key) {
+    const uint64_t hash = static_cast<uint64_t>(std::hash<TKey>()(key)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+  }
+
+  std::vector<std::pair<TKey, TValue>> pending_;
+  std::vector<TKey> keys_;
+  std::vector<TValue> values_;
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+  bool built_ = false;
+};
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -9,6 +9,9 @@
 #include "ml_common.h"
 #include "core/providers/cpu/math/gemm.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace onnxruntime {
 namespace ml {
 
@@ -39,28 +42,33 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
-
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
-
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
+      // ||a - b||^2 = ||a||^2 + ||b||^2 - 2 a.b, so the squared distances of all the batches to all the
+      // support vectors are a GEMM plus the squared norms, which is also how scikit-learn computes them.
+      std::vector<T> a_norms(static_cast<size_t>(m));
+      std::vector<T> b_norms(static_cast<size_t>(n));
+      EigenVectorMap<T>(a_norms.data(), m) = ConstEigenMatrixMapRowMajor<T>(a.data(), m, k).rowwise().squaredNorm();
+      EigenVectorMap<T>(b_norms.data(), n) = ConstEigenMatrixMapRowMajor<T>(b.data(), n, k).rowwise().squaredNorm();
 
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
-
-          *cur_out++ = std::exp(-gamma_ * sum);
-        }
+      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                        m, n, k,
+                                        -2.f, a.data(), b.data(), 0.f,
+                                        nullptr, nullptr,
+                                        out.data(),
+                                        threadpool);
 
-        cur_batch += k;  // move to start of next batch
-      }
+      concurrency::ThreadPool::TryParallelFor(
+          threadpool, static_cast<std::ptrdiff_t>(m), static_cast<double>(n) * 8.0,
+          [this, &a_norms, &b_norms, n, &out](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t batch = first; batch != last; ++batch) {
+              T* cur_out = out.data() + batch * n;
+              for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
+                // rounding can make the distance of nearly equal vectors slightly negative
+                T sum = std::max(cur_out[support_vector] + a_norms[batch] + b_norms[support_vector], T(0));
+                cur_out[support_vector] = -gamma_ * sum;
+              }
+              MlasComputeExp(cur_out, cur_out, static_cast<size_t>(n));
+            }
+          });
     } else {
       float alpha = 1.f;
       float beta = 1.f;
@@ -46,6 +46,8 @@ enum MissingTrack {
   kFalse
 };
 
+// A node as described by the attributes of the operator. TreeEnsembleCommon only uses them to build the flattened
+// layout of the trees that the traversal reads.
 template <typename T>
 struct TreeNodeElement {
   TreeNodeElementId id;
@@ -62,6 +64,13 @@ struct TreeNodeElement {
   bool is_missing_track_true;
 };
 
+// The weights of a leaf, stored contiguously with the weights of the other leaves by TreeEnsembleCommon.
+template <typename T>
+struct LeafWeights {
+  const SparseValue<T>* begin;
+  const SparseValue<T>* end;
+};
+
 template <typename ITYPE, typename OTYPE>
 class TreeAggregator {
  protected:
@@ -83,7 +92,7 @@ class TreeAggregator {
 
   // 1 output
 
-  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& /*prediction*/, const TreeNodeElement<OTYPE>& /*root*/) const {}
+  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& /*prediction*/, const LeafWeights<OTYPE>& /*leaf*/) const {}
 
   void MergePrediction1(ScoreValue<OTYPE>& /*prediction*/, ScoreValue<OTYPE>& /*prediction2*/) const {}
 
@@ -94,7 +103,7 @@ class TreeAggregator {
 
   // N outputs
 
-  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& /*predictions*/, const TreeNodeElement<OTYPE>& /*root*/) const {}
+  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& /*predictions*/, const LeafWeights<OTYPE>& /*leaf*/) const {}
 
   void MergePrediction(std::vector<ScoreValue<OTYPE>>& /*predictions*/, const std::vector<ScoreValue<OTYPE>>& /*predictions2*/) const {}
 
@@ -126,8 +135,8 @@ class TreeAggregatorSum : public TreeAggregator<ITYPE, OTYPE> {
 
   // 1 output
 
-  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const TreeNodeElement<OTYPE>& root) const {
-    prediction.score += root.weights[0].value;
+  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const LeafWeights<OTYPE>& leaf) const {
+    prediction.score += leaf.begin->value;
   }
 
   void MergePrediction1(ScoreValue<OTYPE>& prediction, const ScoreValue<OTYPE>& prediction2) const {
@@ -141,8 +150,8 @@ class TreeAggregatorSum : public TreeAggregator<ITYPE, OTYPE> {
 
   // N outputs
 
-  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const TreeNodeElement<OTYPE>& root) const {
-    for (auto it = root.weights.cbegin(); it != root.weights.cend(); ++it) {
+  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const LeafWeights<OTYPE>& leaf) const {
+    for (auto it = leaf.begin; it != leaf.end; ++it) {
       ORT_ENFORCE(it->i < (int64_t)predictions.size());
       predictions[it->i].score += it->value;
       predictions[it->i].has_score = 1;
@@ -212,9 +221,9 @@ class TreeAggregatorMin : public TreeAggregator<ITYPE, OTYPE> {
 
   // 1 output
 
-  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const TreeNodeElement<OTYPE>& root) const {
-    prediction.score = (!(prediction.has_score) || root.weights[0].value < prediction.score)
-                           ? root.weights[0].value
+  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const LeafWeights<OTYPE>& leaf) const {
+    prediction.score = (!(prediction.has_score) || leaf.begin->value < prediction.score)
+                           ? leaf.begin->value
                            : prediction.score;
     prediction.has_score = 1;
   }
@@ -230,8 +239,8 @@ class TreeAggregatorMin : public TreeAggregator<ITYPE, OTYPE> {
 
   // N outputs
 
-  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const TreeNodeElement<OTYPE>& root) const {
-    for (auto it = root.weights.begin(); it != root.weights.end(); ++it) {
+  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const LeafWeights<OTYPE>& leaf) const {
+    for (auto it = leaf.begin; it != leaf.end; ++it) {
       predictions[it->i].score = (!predictions[it->i].has_score || it->value < predictions[it->i].score)
                                      ? it->value
                                      : predictions[it->i].score;
@@ -263,9 +272,9 @@ class TreeAggregatorMax : public TreeAggregator<ITYPE, OTYPE> {
 
   // 1 output
 
-  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const TreeNodeElement<OTYPE>& root) const {
-    prediction.score = (!(prediction.has_score) || root.weights[0].value > prediction.score)
-                           ? root.weights[0].value
+  void ProcessTreeNodePrediction1(ScoreValue<OTYPE>& prediction, const LeafWeights<OTYPE>& leaf) const {
+    prediction.score = (!(prediction.has_score) || leaf.begin->value > prediction.score)
+                           ? leaf.begin->value
                            : prediction.score;
     prediction.has_score = 1;
   }
@@ -281,8 +290,8 @@ class TreeAggregatorMax : public TreeAggregator<ITYPE, OTYPE> {
 
   // N outputs
 
-  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const TreeNodeElement<OTYPE>& root) const {
-    for (auto it = root.weights.begin(); it != root.weights.end(); ++it) {
+  void ProcessTreeNodePrediction(std::vector<ScoreValue<OTYPE>>& predictions, const LeafWeights<OTYPE>& leaf) const {
+    for (auto it = leaf.begin; it != leaf.end; ++it) {
       predictions[it->i].score = (!predictions[it->i].has_score || it->value > predictions[it->i].score)
                                      ? it->value
                                      : predictions[it->i].score;
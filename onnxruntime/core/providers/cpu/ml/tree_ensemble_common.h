@@ -11,6 +11,32 @@ namespace onnxruntime {
 namespace ml {
 namespace detail {
 
+// Comparisons of the branch modes, which specialize the compiled trees.
+struct BranchLeq {
+  template <typename T1, typename T2>
+  bool operator()(T1 val, T2 threshold) const { return val <= threshold; }
+};
+struct BranchLt {
+  template <typename T1, typename T2>
+  bool operator()(T1 val, T2 threshold) const { return val < threshold; }
+};
+struct BranchGte {
+  template <typename T1, typename T2>
+  bool operator()(T1 val, T2 threshold) const { return val >= threshold; }
+};
+struct BranchGt {
+  template <typename T1, typename T2>
+  bool operator()(T1 val, T2 threshold) const { return val > threshold; }
+};
+struct BranchEq {
+  template <typename T1, typename T2>
+  bool operator()(T1 val, T2 threshold) const { return val == threshold; }
+};
+struct BranchNeq {
+  template <typename T1, typename T2>
+  bool operator()(T1 val, T2 threshold) const { return val != threshold; }
+};
+
 template <typename ITYPE, typename OTYPE>
 class TreeEnsembleCommon {
  public:
@@ -21,8 +47,30 @@ class TreeEnsembleCommon {
   POST_EVAL_TRANSFORM post_transform_;
   AGGREGATE_FUNCTION aggregate_function_;
   int64_t n_nodes_;
-  std::vector<TreeNodeElement<OTYPE>> nodes_;
-  std::vector<TreeNodeElement<OTYPE>*> roots_;
+
+  // Structure-of-arrays layout of the trees, which is all the traversal reads. The nodes of each tree are stored
+  // contiguously in breadth-first order, so the first levels of a tree, visited for every row, share cache lines.
+  // The true child of a leaf is the index of the leaf in leaf_weights_offsets_, the weights of leaf k being
+  // leaf_weights_[leaf_weights_offsets_[k]] to leaf_weights_[leaf_weights_offsets_[k + 1] - 1].
+  std::vector<uint32_t> roots_;
+  std::vector<int32_t> feature_ids_;
+  std::vector<OTYPE> thresholds_;
+  std::vector<NODE_MODE> modes_;
+  std::vector<uint8_t> missing_tracks_true_;
+  std::vector<uint32_t> true_children_;
+  std::vector<uint32_t> false_children_;
+  std::vector<SparseValue<OTYPE>> leaf_weights_;
+  std::vector<uint32_t> leaf_weights_offsets_;
+
+  // Depth of each tree, which selects between the row by row and the block traversals.
+  std::vector<uint32_t> tree_depths_;
+
+  // Returns the leaf node reached by a row in a tree, from the index of the root of the tree.
+  using CompiledTree = uint32_t (TreeEnsembleCommon::*)(uint32_t root, const ITYPE* x_data) const;
+
+  // Routine specialized for the depth and branch mode of each perfect tree (all leaves at the same depth) up to
+  // kMaxCompiledTreeDepth levels, or nullptr for the trees walked by ProcessTreeNodeLeave.
+  std::vector<CompiledTree> compiled_trees_;
 
   int64_t max_tree_depth_;
   int64_t n_trees_;
@@ -55,13 +103,72 @@ class TreeEnsembleCommon {
   void compute(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Z, Tensor* label) const;
 
  protected:
-  TreeNodeElement<OTYPE>* ProcessTreeNodeLeave(
-      TreeNodeElement<OTYPE>* root, const ITYPE* x_data) const;
+  // Rows of a batch walked together through each tree by ProcessTreeNodeLeaves.
+  static constexpr int64_t kBlockRows = 64;
+  // The block traversal runs every row of the block until the last one reaches a leaf and loses to the row by row
+  // traversal if the rows reach leaves at very different depths, as in the deep trees of random forests, or if
+  // there are too few rows to hide the latency of each level.
+  static constexpr int64_t kMinBlockRows = 8;
+  static constexpr uint32_t kMaxBlockTreeDepth = 16;
+
+  static constexpr uint32_t kMaxCompiledTreeDepth = 8;
+
+  LeafWeights<OTYPE> ProcessTreeNodeLeave(uint32_t root, const ITYPE* x_data) const;
+
+  LeafWeights<OTYPE> ProcessTree(size_t tree, const ITYPE* x_data) const {
+    CompiledTree compiled_tree = compiled_trees_[tree];
+    return compiled_tree != nullptr ? GetLeafWeights((this->*compiled_tree)(roots_[tree], x_data))
+                                    : ProcessTreeNodeLeave(roots_[tree], x_data);
+  }
+
+  // A perfect tree is stored in heap order by the breadth-first layout: the children of its k-th node are its
+  // (2k+1)-th and (2k+2)-th nodes, so it is walked with DEPTH unrolled steps without any branch.
+  template <uint32_t DEPTH, typename CMP>
+  uint32_t ProcessPerfectTree(uint32_t root, const ITYPE* x_data) const;
+
+  template <typename CMP>
+  static CompiledTree GetCompiledTree(uint32_t depth);
+
+  CompiledTree CompileTree(size_t tree) const;
+
+  // Walks n_rows rows of x_data, stride elements apart, through a tree and stores the index of the leaf node
+  // reached by each row in leaves. The rows advance one level at a time without branching on the comparisons,
+  // which removes the branch mispredictions of the row by row traversal.
+  void ProcessTreeNodeLeaves(size_t tree, const ITYPE* x_data, int64_t stride, int64_t n_rows,
+                             uint32_t* leaves) const;
+
+  template <typename CMP>
+  void ProcessTreeNodeLeaves(uint32_t root, const ITYPE* x_data, int64_t stride, int64_t n_rows,
+                             uint32_t* leaves, CMP cmp) const;
+
+  bool UseBlockTraversal(size_t tree, int64_t n_rows) const {
+    return same_mode_ && n_rows >= kMinBlockRows && tree_depths_[tree] <= kMaxBlockTreeDepth;
+  }
+
+  LeafWeights<OTYPE> GetLeafWeights(uint32_t leaf_node) const {
+    uint32_t leaf = true_children_[leaf_node];
+    const SparseValue<OTYPE>* weights = leaf_weights_.data();
+    return {weights + leaf_weights_offsets_[leaf], weights + leaf_weights_offsets_[leaf + 1]};
+  }
 
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Z, Tensor* label, const AGG& agg) const;
+
+  // Computes the rows [begin, end) of a batch by blocks of kBlockRows rows.
+  template <typename AGG>
+  void ComputeAggRows(const AGG& agg, const ITYPE* x_data, OTYPE* z_data, int64_t* label_data, int64_t stride,
+                      int64_t begin, int64_t end) const;
 };
 
+template <typename ITYPE, typename OTYPE>
+constexpr int64_t TreeEnsembleCommon<ITYPE, OTYPE>::kBlockRows;
+template <typename ITYPE, typename OTYPE>
+constexpr int64_t TreeEnsembleCommon<ITYPE, OTYPE>::kMinBlockRows;
+template <typename ITYPE, typename OTYPE>
+constexpr uint32_t TreeEnsembleCommon<ITYPE, OTYPE>::kMaxBlockTreeDepth;
+template <typename ITYPE, typename OTYPE>
+constexpr uint32_t TreeEnsembleCommon<ITYPE, OTYPE>::kMaxCompiledTreeDepth;
+
 template <typename ITYPE, typename OTYPE>
 TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int parallel_N,
                                                      const std::string& aggregate_function,
@@ -120,13 +227,13 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
   // filling nodes
 
   n_nodes_ = nodes_treeids.size();
-  nodes_.resize(n_nodes_);
-  roots_.clear();
+  std::vector<TreeNodeElement<OTYPE>> nodes(n_nodes_);
+  std::vector<TreeNodeElement<OTYPE>*> roots;
   std::map<TreeNodeElementId, TreeNodeElement<OTYPE>*> idi;
   size_t i;
 
   for (i = 0; i < nodes_treeids.size(); ++i) {
-    TreeNodeElement<OTYPE>& node = nodes_[i];
+    TreeNodeElement<OTYPE>& node = nodes[i];
     node.id.tree_id = static_cast<int>(nodes_treeids[i]);
     node.id.node_id = static_cast<int>(nodes_nodeids[i]);
     node.feature_id = static_cast<int>(nodes_featureids[i]);
@@ -149,10 +256,10 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
   }
 
   TreeNodeElementId coor;
-  for (auto it = nodes_.begin(); it != nodes_.end(); ++it, ++i) {
+  for (auto it = nodes.begin(); it != nodes.end(); ++it, ++i) {
     if (!it->is_not_leaf)
       continue;
-    i = std::distance(nodes_.begin(), it);
+    i = std::distance(nodes.begin(), it);
     coor.tree_id = it->id.tree_id;
     coor.node_id = static_cast<int>(nodes_truenodeids[i]);
 
@@ -186,9 +293,9 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
 
   int64_t previous = -1;
   for (i = 0; i < static_cast<size_t>(n_nodes_); ++i) {
-    if ((previous == -1) || (previous != nodes_[i].id.tree_id))
-      roots_.push_back(&(nodes_[i]));
-    previous = nodes_[i].id.tree_id;
+    if ((previous == -1) || (previous != nodes[i].id.tree_id))
+      roots.push_back(&(nodes[i]));
+    previous = nodes[i].id.tree_id;
   }
 
   TreeNodeElementId ind;
@@ -204,6 +311,64 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
     idi[ind]->weights.push_back(w);
   }
 
+  // flattening the trees
+
+  std::unordered_map<const TreeNodeElement<OTYPE>*, uint32_t> flat_ids;
+  std::vector<const TreeNodeElement<OTYPE>*> flat_nodes;
+  std::vector<uint32_t> flat_depths;
+  flat_nodes.reserve(n_nodes_);
+  flat_depths.reserve(n_nodes_);
+  roots_.reserve(roots.size());
+  tree_depths_.reserve(roots.size());
+  for (const auto* root : roots) {
+    size_t next = flat_nodes.size();
+    roots_.push_back(static_cast<uint32_t>(next));
+    flat_ids.emplace(root, static_cast<uint32_t>(next));
+    flat_nodes.push_back(root);
+    flat_depths.push_back(0);
+    uint32_t tree_depth = 0;
+    for (; next < flat_nodes.size(); ++next) {
+      const auto* node = flat_nodes[next];
+      tree_depth = std::max(tree_depth, flat_depths[next]);
+      if (!node->is_not_leaf)
+        continue;
+      for (const auto* child : {node->truenode, node->falsenode}) {
+        if (child == nullptr) {
+          ORT_THROW("Node ", node->id.node_id, " in tree ", node->id.tree_id, " is missing a child node.");
+        }
+        if (flat_ids.emplace(child, static_cast<uint32_t>(flat_nodes.size())).second) {
+          flat_nodes.push_back(child);
+          flat_depths.push_back(flat_depths[next] + 1);
+        }
+      }
+    }
+    tree_depths_.push_back(tree_depth);
+  }
+
+  size_t n_flat_nodes = flat_nodes.size();
+  feature_ids_.resize(n_flat_nodes, 0);
+  thresholds_.resize(n_flat_nodes, 0);
+  modes_.resize(n_flat_nodes);
+  missing_tracks_true_.resize(n_flat_nodes, 0);
+  true_children_.resize(n_flat_nodes);
+  false_children_.resize(n_flat_nodes, 0);
+  leaf_weights_offsets_.push_back(0);
+  for (i = 0; i < n_flat_nodes; ++i) {
+    const auto* node = flat_nodes[i];
+    modes_[i] = node->mode;
+    if (node->is_not_leaf) {
+      feature_ids_[i] = node->feature_id;
+      thresholds_[i] = node->value;
+      missing_tracks_true_[i] = node->is_missing_track_true ? 1 : 0;
+      true_children_[i] = flat_ids[node->truenode];
+      false_children_[i] = flat_ids[node->falsenode];
+    } else {
+      true_children_[i] = static_cast<uint32_t>(leaf_weights_offsets_.size() - 1);
+      leaf_weights_.insert(leaf_weights_.end(), node->weights.begin(), node->weights.end());
+      leaf_weights_offsets_.push_back(static_cast<uint32_t>(leaf_weights_.size()));
+    }
+  }
+
   n_trees_ = roots_.size();
   has_missing_tracks_ = false;
   for (auto itm = nodes_missing_value_tracks_true.begin();
@@ -213,6 +378,84 @@ TreeEnsembleCommon<ITYPE, OTYPE>::TreeEnsembleCommon(int parallel_tree, int para
       break;
     }
   }
+
+  compiled_trees_.resize(n_trees_);
+  for (i = 0; i < static_cast<size_t>(n_trees_); ++i) {
+    compiled_trees_[i] = CompileTree(i);
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+typename TreeEnsembleCommon<ITYPE, OTYPE>::CompiledTree
+TreeEnsembleCommon<ITYPE, OTYPE>::CompileTree(size_t tree) const {
+  uint32_t depth = tree_depths_[tree];
+  if (depth == 0 || depth > kMaxCompiledTreeDepth) {
+    return nullptr;
+  }
+
+  uint32_t root = roots_[tree];
+  size_t tree_end = tree + 1 < roots_.size() ? roots_[tree + 1] : modes_.size();
+  uint32_t n_branches = (1u << depth) - 1;
+  if (tree_end - root != 2 * static_cast<size_t>(n_branches) + 1) {
+    return nullptr;
+  }
+
+  NODE_MODE mode = modes_[root];
+  for (uint32_t k = 0; k < n_branches; ++k) {
+    if (modes_[root + k] != mode ||
+        true_children_[root + k] != root + 2 * k + 1 ||
+        false_children_[root + k] != root + 2 * k + 2) {
+      return nullptr;
+    }
+  }
+  for (uint32_t k = n_branches; k < 2 * n_branches + 1; ++k) {
+    if (modes_[root + k] != NODE_MODE::LEAF) {
+      return nullptr;
+    }
+  }
+
+  switch (mode) {
+    case NODE_MODE::BRANCH_LEQ:
+      return GetCompiledTree<BranchLeq>(depth);
+    case NODE_MODE::BRANCH_LT:
+      return GetCompiledTree<BranchLt>(depth);
+    case NODE_MODE::BRANCH_GTE:
+      return GetCompiledTree<BranchGte>(depth);
+    case NODE_MODE::BRANCH_GT:
+      return GetCompiledTree<BranchGt>(depth);
+    case NODE_MODE::BRANCH_EQ:
+      return GetCompiledTree<BranchEq>(depth);
+    case NODE_MODE::BRANCH_NEQ:
+      return GetCompiledTree<BranchNeq>(depth);
+    default:
+      return nullptr;
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+template <typename CMP>
+typename TreeEnsembleCommon<ITYPE, OTYPE>::CompiledTree
+TreeEnsembleCommon<ITYPE, OTYPE>::GetCompiledTree(uint32_t depth) {
+  switch (depth) {
+    case 1:
+      return &TreeEnsembleCommon::ProcessPerfectTree<1, CMP>;
+    case 2:
+      return &TreeEnsembleCommon::ProcessPerfectTree<2, CMP>;
+    case 3:
+      return &TreeEnsembleCommon::ProcessPerfectTree<3, CMP>;
+    case 4:
+      return &TreeEnsembleCommon::ProcessPerfectTree<4, CMP>;
+    case 5:
+      return &TreeEnsembleCommon::ProcessPerfectTree<5, CMP>;
+    case 6:
+      return &TreeEnsembleCommon::ProcessPerfectTree<6, CMP>;
+    case 7:
+      return &TreeEnsembleCommon::ProcessPerfectTree<7, CMP>;
+    case 8:
+      return &TreeEnsembleCommon::ProcessPerfectTree<8, CMP>;
+    default:
+      return nullptr;
+  }
 }
 
 template <typename ITYPE, typename OTYPE>
@@ -263,12 +506,12 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
   OTYPE* z_data = Z->template MutableData<OTYPE>();
   int64_t* label_data = label == nullptr ? nullptr : label->template MutableData<int64_t>();
 
-  if (n_targets_or_classes_ == 1) {
-    if (N == 1) {
+  if (N == 1) {
+    if (n_targets_or_classes_ == 1) {
       ScoreValue<OTYPE> score = {0, 0};
       if (n_trees_ <= parallel_tree_) {
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data));
+          agg.ProcessTreeNodePrediction1(score, ProcessTree(j, x_data));
         }
       } else {
         std::vector<ScoreValue<OTYPE>> scores_t(n_trees_, {0, 0});
@@ -276,7 +519,7 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
             ttp,
             SafeInt<int32_t>(n_trees_),
             [this, &scores_t, &agg, x_data](ptrdiff_t j) {
-              agg.ProcessTreeNodePrediction1(scores_t[j], *ProcessTreeNodeLeave(roots_[j], x_data));
+              agg.ProcessTreeNodePrediction1(scores_t[j], ProcessTree(j, x_data));
             },
             0);
 
@@ -287,41 +530,10 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
 
       agg.FinalizeScores1(z_data, score, label_data);
     } else {
-      if (N <= parallel_N_) {
-        ScoreValue<OTYPE> score;
-        size_t j;
-
-        for (int64_t i = 0; i < N; ++i) {
-          score = {0, 0};
-          for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-            agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-          }
-
-          agg.FinalizeScores1(z_data + i * n_targets_or_classes_, score,
-                              label_data == nullptr ? nullptr : (label_data + i));
-        }
-      } else {
-        concurrency::ThreadPool::TryBatchParallelFor(
-            ttp,
-            SafeInt<int32_t>(N),
-            [this, &agg, x_data, z_data, stride, label_data](ptrdiff_t i) {
-              ScoreValue<OTYPE> score = {0, 0};
-              for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-                agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-              }
-
-              agg.FinalizeScores1(z_data + i * n_targets_or_classes_, score,
-                                  label_data == nullptr ? nullptr : (label_data + i));
-            },
-            0);
-      }
-    }
-  } else {
-    if (N == 1) {
       std::vector<ScoreValue<OTYPE>> scores(n_targets_or_classes_, {0, 0});
       if (n_trees_ <= parallel_tree_) {
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data));
+          agg.ProcessTreeNodePrediction(scores, ProcessTree(j, x_data));
         }
       } else {
         // split the work into one block per thread so we can re-use the 'private_scores' vector as much as possible
@@ -335,7 +547,7 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
               std::vector<ScoreValue<OTYPE>> private_scores(n_targets_or_classes_, {0, 0});
               auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, n_trees_);
               for (auto j = work.start; j < work.end; ++j) {
-                agg.ProcessTreeNodePrediction(private_scores, *ProcessTreeNodeLeave(roots_[j], x_data));
+                agg.ProcessTreeNodePrediction(private_scores, ProcessTree(j, x_data));
               }
 
               std::lock_guard<OrtMutex> lock(merge_mutex);
@@ -344,62 +556,101 @@ void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAgg(concurrency::ThreadPool* ttp,
       }
 
       agg.FinalizeScores(scores, z_data, -1, label_data);
-    } else {
-      if (N <= parallel_N_) {
-        std::vector<ScoreValue<OTYPE>> scores(n_targets_or_classes_);
-        size_t j;
-
-        for (int64_t i = 0; i < N; ++i) {
-          std::fill(scores.begin(), scores.end(), ScoreValue<OTYPE>({0, 0}));
-          for (j = 0; j < roots_.size(); ++j) {
-            agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+    }
+  } else if (N <= parallel_N_) {
+    ComputeAggRows(agg, x_data, z_data, label_data, stride, 0, N);
+  } else {
+    // split the rows into one range per thread so each thread walks blocks of rows through the trees
+    // TODO: Refine the number of threads used.
+    auto num_threads = std::min<int32_t>(concurrency::ThreadPool::NumThreads(ttp), SafeInt<int32_t>(N));
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        ttp,
+        num_threads,
+        [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+          auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, N);
+          ComputeAggRows(agg, x_data, z_data, label_data, stride, work.start, work.end);
+        });
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+template <typename AGG>
+void TreeEnsembleCommon<ITYPE, OTYPE>::ComputeAggRows(const AGG& agg, const ITYPE* x_data, OTYPE* z_data,
+                                                      int64_t* label_data, int64_t stride,
+                                                      int64_t begin, int64_t end) const {
+  uint32_t leaves[kBlockRows];
+  std::vector<ScoreValue<OTYPE>> scores1;
+  std::vector<std::vector<ScoreValue<OTYPE>>> scores;
+  if (n_targets_or_classes_ == 1) {
+    scores1.resize(static_cast<size_t>(std::min(kBlockRows, end - begin)));
+  } else {
+    scores.resize(static_cast<size_t>(std::min(kBlockRows, end - begin)),
+                  std::vector<ScoreValue<OTYPE>>(n_targets_or_classes_));
+  }
+
+  for (int64_t block = begin; block < end; block += kBlockRows) {
+    const int64_t n_rows = std::min(kBlockRows, end - block);
+    const ITYPE* x_block = x_data + block * stride;
+
+    if (n_targets_or_classes_ == 1) {
+      std::fill(scores1.begin(), scores1.end(), ScoreValue<OTYPE>({0, 0}));
+      for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+        if (UseBlockTraversal(j, n_rows)) {
+          ProcessTreeNodeLeaves(j, x_block, stride, n_rows, leaves);
+          for (int64_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction1(scores1[r], GetLeafWeights(leaves[r]));
+          }
+        } else {
+          for (int64_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction1(scores1[r], ProcessTree(j, x_block + r * stride));
           }
+        }
+      }
 
-          agg.FinalizeScores(scores, z_data + i * n_targets_or_classes_, -1,
-                             label_data == nullptr ? nullptr : (label_data + i));
+      for (int64_t r = 0; r < n_rows; ++r) {
+        agg.FinalizeScores1(z_data + (block + r) * n_targets_or_classes_, scores1[r],
+                            label_data == nullptr ? nullptr : (label_data + block + r));
+      }
+    } else {
+      for (auto& row_scores : scores) {
+        std::fill(row_scores.begin(), row_scores.end(), ScoreValue<OTYPE>({0, 0}));
+      }
+      for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+        if (UseBlockTraversal(j, n_rows)) {
+          ProcessTreeNodeLeaves(j, x_block, stride, n_rows, leaves);
+          for (int64_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction(scores[r], GetLeafWeights(leaves[r]));
+          }
+        } else {
+          for (int64_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction(scores[r], ProcessTree(j, x_block + r * stride));
+          }
         }
-      } else {
-        // split the work into one block per thread so we can re-use the 'scores' vector as much as possible
-        // TODO: Refine the number of threads used.
-        auto num_threads = std::min<int32_t>(concurrency::ThreadPool::NumThreads(ttp), SafeInt<int32_t>(N));
-        concurrency::ThreadPool::TrySimpleParallelFor(
-            ttp,
-            num_threads,
-            [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
-              size_t j;
-              std::vector<ScoreValue<OTYPE>> scores(n_targets_or_classes_);
-              auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, N);
-
-              for (auto i = work.start; i < work.end; ++i) {
-                std::fill(scores.begin(), scores.end(), ScoreValue<OTYPE>({0, 0}));
-                for (j = 0; j < roots_.size(); ++j) {
-                  agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-                }
-
-                agg.FinalizeScores(scores,
-                                   z_data + i * n_targets_or_classes_, -1,
-                                   label_data == nullptr ? nullptr : (label_data + i));
-              }
-            });
+      }
+
+      for (int64_t r = 0; r < n_rows; ++r) {
+        agg.FinalizeScores(scores[r], z_data + (block + r) * n_targets_or_classes_, -1,
+                           label_data == nullptr ? nullptr : (label_data + block + r));
       }
     }
   }
 }  // namespace detail
 
-#define TREE_FIND_VALUE(CMP)                                         \
-  if (has_missing_tracks_) {                                         \
-    while (root->is_not_leaf) {                                      \
-      val = x_data[root->feature_id];                                \
-      root = (val CMP root->value ||                                 \
-              (root->is_missing_track_true && _isnan_(val)))         \
-                 ? root->truenode                                    \
-                 : root->falsenode;                                  \
-    }                                                                \
-  } else {                                                           \
-    while (root->is_not_leaf) {                                      \
-      val = x_data[root->feature_id];                                \
-      root = val CMP root->value ? root->truenode : root->falsenode; \
-    }                                                                \
+#define TREE_FIND_VALUE(CMP)                                     \
+  if (has_missing_tracks_) {                                     \
+    while (modes[index] != NODE_MODE::LEAF) {                    \
+      val = x_data[feature_ids[index]];                          \
+      index = (val CMP thresholds[index] ||                      \
+               (missing_tracks_true[index] && _isnan_(val)))     \
+                  ? true_children[index]                         \
+                  : false_children[index];                       \
+    }                                                            \
+  } else {                                                       \
+    while (modes[index] != NODE_MODE::LEAF) {                    \
+      val = x_data[feature_ids[index]];                          \
+      index = val CMP thresholds[index] ? true_children[index]   \
+                                        : false_children[index]; \
+    }                                                            \
   }
 
 inline bool _isnan_(float x) { return std::isnan(x); }
@@ -408,25 +659,32 @@ inline bool _isnan_(int64_t) { return false; }
 inline bool _isnan_(int32_t) { return false; }
 
 template <typename ITYPE, typename OTYPE>
-TreeNodeElement<OTYPE>*
-TreeEnsembleCommon<ITYPE, OTYPE>::ProcessTreeNodeLeave(
-    TreeNodeElement<OTYPE>* root, const ITYPE* x_data) const {
+LeafWeights<OTYPE>
+TreeEnsembleCommon<ITYPE, OTYPE>::ProcessTreeNodeLeave(uint32_t root, const ITYPE* x_data) const {
+  const int32_t* feature_ids = feature_ids_.data();
+  const OTYPE* thresholds = thresholds_.data();
+  const NODE_MODE* modes = modes_.data();
+  const uint8_t* missing_tracks_true = missing_tracks_true_.data();
+  const uint32_t* true_children = true_children_.data();
+  const uint32_t* false_children = false_children_.data();
+
+  uint32_t index = root;
   ITYPE val;
   if (same_mode_) {
-    switch (root->mode) {
+    switch (modes[index]) {
       case NODE_MODE::BRANCH_LEQ:
         if (has_missing_tracks_) {
-          while (root->is_not_leaf) {
-            val = x_data[root->feature_id];
-            root = (val <= root->value ||
-                    (root->is_missing_track_true && _isnan_(val)))
-                       ? root->truenode
-                       : root->falsenode;
+          while (modes[index] != NODE_MODE::LEAF) {
+            val = x_data[feature_ids[index]];
+            index = (val <= thresholds[index] ||
+                     (missing_tracks_true[index] && _isnan_(val)))
+                        ? true_children[index]
+                        : false_children[index];
           }
         } else {
-          while (root->is_not_leaf) {
-            val = x_data[root->feature_id];
-            root = val <= root->value ? root->truenode : root->falsenode;
+          while (modes[index] != NODE_MODE::LEAF) {
+            val = x_data[feature_ids[index]];
+            index = val <= thresholds[index] ? true_children[index] : false_children[index];
           }
         }
         break;
@@ -450,46 +708,123 @@ TreeEnsembleCommon<ITYPE, OTYPE>::ProcessTreeNodeLeave(
     }
   } else {  // Different rules to compare to node thresholds.
     OTYPE threshold;
-    while (root->is_not_leaf) {
-      val = x_data[root->feature_id];
-      threshold = root->value;
-      switch (root->mode) {
+    bool is_true;
+    while (modes[index] != NODE_MODE::LEAF) {
+      val = x_data[feature_ids[index]];
+      threshold = thresholds[index];
+      switch (modes[index]) {
         case NODE_MODE::BRANCH_LEQ:
-          root = val <= threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          is_true = val <= threshold;
           break;
         case NODE_MODE::BRANCH_LT:
-          root = val < threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          is_true = val < threshold;
           break;
         case NODE_MODE::BRANCH_GTE:
-          root = val >= threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          is_true = val >= threshold;
           break;
         case NODE_MODE::BRANCH_GT:
-          root = val > threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          is_true = val > threshold;
           break;
         case NODE_MODE::BRANCH_EQ:
-          root = val == threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          is_true = val == threshold;
           break;
         case NODE_MODE::BRANCH_NEQ:
-          root = val != threshold || (root->is_missing_track_true && _isnan_(val))
-                     ? root->truenode
-                     : root->falsenode;
+          is_true = val != threshold;
           break;
-        case NODE_MODE::LEAF:
+        default:
+          is_true = false;
           break;
       }
+      index = is_true || (missing_tracks_true[index] && _isnan_(val))
+                  ? true_children[index]
+                  : false_children[index];
+    }
+  }
+
+  return GetLeafWeights(index);
+}
+
+template <typename ITYPE, typename OTYPE>
+template <uint32_t DEPTH, typename CMP>
+uint32_t TreeEnsembleCommon<ITYPE, OTYPE>::ProcessPerfectTree(uint32_t root, const ITYPE* x_data) const {
+  const int32_t* feature_ids = feature_ids_.data() + root;
+  const OTYPE* thresholds = thresholds_.data() + root;
+  const uint8_t* missing_tracks_true = missing_tracks_true_.data() + root;
+  CMP cmp;
+
+  uint32_t k = 0;
+  for (uint32_t level = 0; level < DEPTH; ++level) {
+    ITYPE val = x_data[feature_ids[k]];
+    bool is_true = cmp(val, thresholds[k]) | ((missing_tracks_true[k] != 0) & _isnan_(val));
+    k = 2 * k + 2 - static_cast<uint32_t>(is_true);
+  }
+  return root + k;
+}
+
+template <typename ITYPE, typename OTYPE>
+void TreeEnsembleCommon<ITYPE, OTYPE>::ProcessTreeNodeLeaves(size_t tree, const ITYPE* x_data, int64_t stride,
+                                                             int64_t n_rows, uint32_t* leaves) const {
+  // All the branches have the same mode, see UseBlockTraversal.
+  uint32_t root = roots_[tree];
+  switch (modes_[root]) {
+    case NODE_MODE::BRANCH_LEQ:
+      ProcessTreeNodeLeaves(root, x_data, stride, n_rows, leaves,
+                            [](ITYPE val, OTYPE threshold) { return val <= threshold; });
+      break;
+    case NODE_MODE::BRANCH_LT:
+      ProcessTreeNodeLeaves(root, x_data, stride, n_rows, leaves,
+                            [](ITYPE val, OTYPE threshold) { return val < threshold; });
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      ProcessTreeNodeLeaves(root, x_data, stride, n_rows, leaves,
+                            [](ITYPE val, OTYPE threshold) { return val >= threshold; });
+      break;
+    case NODE_MODE::BRANCH_GT:
+      ProcessTreeNodeLeaves(root, x_data, stride, n_rows, leaves,
+                            [](ITYPE val, OTYPE threshold) { return val > threshold; });
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      ProcessTreeNodeLeaves(root, x_data, stride, n_rows, leaves,
+                            [](ITYPE val, OTYPE threshold) { return val == threshold; });
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      ProcessTreeNodeLeaves(root, x_data, stride, n_rows, leaves,
+                            [](ITYPE val, OTYPE threshold) { return val != threshold; });
+      break;
+    case NODE_MODE::LEAF:
+      std::fill_n(leaves, n_rows, root);
+      break;
+  }
+}
+
+template <typename ITYPE, typename OTYPE>
+template <typename CMP>
+void TreeEnsembleCommon<ITYPE, OTYPE>::ProcessTreeNodeLeaves(uint32_t root, const ITYPE* x_data, int64_t stride,
+                                                             int64_t n_rows, uint32_t* leaves, CMP cmp) const {
+  const int32_t* feature_ids = feature_ids_.data();
+  const OTYPE* thresholds = thresholds_.data();
+  const NODE_MODE* modes = modes_.data();
+  const uint8_t* missing_tracks_true = missing_tracks_true_.data();
+  const uint32_t* true_children = true_children_.data();
+  const uint32_t* false_children = false_children_.data();
+
+  std::fill_n(leaves, n_rows, root);
+
+  // Each pass moves every row down one level, the rows that reached a leaf staying there. The only branch depends
+  // on whether all the rows reached a leaf. The feature of a leaf is 0, so reading it is valid.
+  bool active = true;
+  while (active) {
+    active = false;
+    for (int64_t r = 0; r < n_rows; ++r) {
+      uint32_t index = leaves[r];
+      ITYPE val = x_data[r * stride + feature_ids[index]];
+      bool is_true = cmp(val, thresholds[index]) | ((missing_tracks_true[index] != 0) & _isnan_(val));
+      uint32_t next = is_true ? true_children[index] : false_children[index];
+      bool is_leaf = modes[index] == NODE_MODE::LEAF;
+      leaves[r] = is_leaf ? index : next;
+      active |= !is_leaf;
     }
   }
-  return root;
 }
 
 template <typename ITYPE, typename OTYPE>
@@ -22,6 +22,8 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/autopad_type.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/cpu/nn/batch_norm_helper.h"
 
@@ -83,17 +85,28 @@ class BatchNorm : public OpKernel {
     //   (x * inv_var * scale) + (bias - est_mean * inv_var * scale)
     Eigen::Array<T, Eigen::Dynamic, 1> new_scale = inv_std * scale_arr;
     Eigen::Array<T, Eigen::Dynamic, 1> new_bias = bias_arr - mean_arr * new_scale;
-    EigenArrayMap<T> Y_arr(Y->template MutableData<T>(),
-                           is_spatial_ ? sample_size : sample_size_incl_all_channels,
-                           is_spatial_ ? N * C : N);
-    ConstEigenArrayMap<T> X_arr(X->template Data<T>(),
-                                is_spatial_ ? sample_size : sample_size_incl_all_channels,
-                                is_spatial_ ? N * C : N);
     if (is_spatial_) {  // spatial == 1
-      for (size_t nc = 0; nc < N * C; ++nc) {
-        Y_arr.col(nc) = X_arr.col(nc) * new_scale(nc % C) + new_bias(nc % C);
-      }
+      const T* X_data = X->template Data<T>();
+      T* Y_data = Y->template MutableData<T>();
+
+      // A range of channel planes is split where it crosses into the next image, so each call reads a contiguous
+      // run of the per channel scales and biases.
+      const double plane_bytes = static_cast<double>(sample_size * sizeof(T));
+      concurrency::ThreadPool::TryParallelFor(
+          p_op_kernel_context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(N * C),
+          TensorOpCost{plane_bytes, plane_bytes, static_cast<double>(sample_size)},
+          [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            for (std::ptrdiff_t nc = begin; nc < end;) {
+              const size_t c = static_cast<size_t>(nc) % C;
+              const std::ptrdiff_t count = std::min<std::ptrdiff_t>(end - nc, static_cast<std::ptrdiff_t>(C - c));
+              ScaleShift(X_data + nc * sample_size, new_scale.data() + c, new_bias.data() + c,
+                         Y_data + nc * sample_size, static_cast<size_t>(count), sample_size);
+              nc += count;
+            }
+          });
     } else {  // spatial == 0
+      EigenArrayMap<T> Y_arr(Y->template MutableData<T>(), sample_size_incl_all_channels, N);
+      ConstEigenArrayMap<T> X_arr(X->template Data<T>(), sample_size_incl_all_channels, N);
       for (size_t n = 0; n < N; ++n) {
         Y_arr.col(n) = X_arr.col(n) * new_scale.col(0) + new_bias.col(0);
       }
@@ -103,6 +116,20 @@ class BatchNorm : public OpKernel {
   }
 
  protected:
+  // Y = X * scale + shift for 'rows' rows of 'row_size' elements, with one scale and shift per row.
+  template <typename U>
+  static void ScaleShift(const U* X, const U* scale, const U* shift, U* Y, size_t rows, size_t row_size) {
+    for (size_t r = 0; r < rows; ++r) {
+      EigenVectorArrayMap<U>(Y + r * row_size, row_size) =
+          ConstEigenVectorArrayMap<U>(X + r * row_size, row_size) * scale[r] + shift[r];
+    }
+  }
+
+  static void ScaleShift(const float* X, const float* scale, const float* shift, float* Y, size_t rows,
+                         size_t row_size) {
+    MlasComputeScaleShift(X, scale, shift, Y, rows, row_size);
+  }
+
   float epsilon_;
   const bool is_spatial_;
   //int64_t is_test_;   ignored in this implementation since we're doing inferencing only.
@@ -17,6 +17,8 @@
 
 #include "core/providers/cpu/nn/conv.h"
 
+#include <algorithm>
+
 #include "core/common/safeint.h"
 #include "core/util/math_cpuonly.h"
 
@@ -160,6 +162,32 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+void Conv<float>::TransformWinogradFilter(const OpKernelInfo& info) {
+  const Tensor* W;
+  if (!info.TryGetConstantInput(1, &W) || W->Shape().NumDimensions() != 4 ||
+      W->Shape()[2] != 3 || W->Shape()[3] != 3 || conv_attrs_.group <= 0 ||
+      W->Shape()[0] % conv_attrs_.group != 0) {
+    return;
+  }
+  // MlasConvPrepare only picks the Winograd algorithm for unit strides and dilations.
+  auto is_one = [](int64_t value) { return value == 1; };
+  if (!std::all_of(conv_attrs_.strides.begin(), conv_attrs_.strides.end(), is_one) ||
+      !std::all_of(conv_attrs_.dilations.begin(), conv_attrs_.dilations.end(), is_one)) {
+    return;
+  }
+
+  const auto group_count = static_cast<size_t>(conv_attrs_.group);
+  const auto filter_count = static_cast<size_t>(W->Shape()[0] / conv_attrs_.group);
+  const auto input_channels = static_cast<size_t>(W->Shape()[1]);
+  const size_t filter_size = MlasConvWinogradFilterSize(group_count, filter_count, input_channels);
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  auto* filter_data = alloc->Alloc(SafeInt<size_t>(sizeof(float)) * filter_size);
+  winograd_filter_ = BufferUniquePtr(filter_data, BufferDeleter(alloc));
+  MlasConvWinogradTransformFilter(group_count, filter_count, input_channels, W->Data<float>(),
+                                  static_cast<float*>(filter_data));
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const auto* X = context->Input<Tensor>(0);
@@ -226,6 +254,10 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     &WorkingBufferSize,
                     thread_pool);
 
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd && winograd_filter_ != nullptr) {
+      Parameters.u.Winograd.TransformedFilter = static_cast<const float*>(winograd_filter_.get());
+    }
+
     auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(SafeInt<size_t>(sizeof(float)) * WorkingBufferSize)
                                                : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
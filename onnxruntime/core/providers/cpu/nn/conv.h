@@ -26,6 +26,7 @@ class Conv<float> : public OpKernel {
  public:
   Conv<float>(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    TransformWinogradFilter(info);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -34,6 +35,13 @@ class Conv<float> : public OpKernel {
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // Transforms a constant 3x3 filter once so that MlasConv doesn't repeat it on every run
+  // when it picks the Winograd algorithm.
+  void TransformWinogradFilter(const OpKernelInfo& info);
+
+  BufferUniquePtr winograd_filter_;
 };
 
 }  // namespace onnxruntime
@@ -43,9 +43,17 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
     input_offset = *(X_Zero_Point->Data<uint8_t>());
   }
   if (num_inputs >= 4) {
+    // Per channel zero points are supported if they're all the same, as they are for symmetrically quantized
+    // filters, because the GEMM subtracts a single filter zero point.
     const auto* W_Zero_Point = context->Input<Tensor>(3);
-    ORT_ENFORCE(IsScalarOr1ElementVector(W_Zero_Point), "Non per-tensor quantization is not supported now.");
-    filter_offset = *(W_Zero_Point->Data<uint8_t>());
+    const auto W_Zero_Point_data = W_Zero_Point->DataAsSpan<uint8_t>();
+    ORT_ENFORCE(IsScalarOr1ElementVector(W_Zero_Point) ||
+                    (W_Zero_Point->Shape().NumDimensions() == 1 && W_Zero_Point->Shape()[0] == W->Shape()[0]),
+                "Filter zero point must be a scalar or 1D tensor of size 1 or M.");
+    filter_offset = W_Zero_Point_data[0];
+    ORT_ENFORCE(std::all_of(W_Zero_Point_data.cbegin(), W_Zero_Point_data.cend(),
+                            [filter_offset](uint8_t offset) { return offset == filter_offset; }),
+                "Non per-tensor quantization is only supported if the filter zero points have the same value.");
   }
 
   const int64_t N = X->Shape()[0];
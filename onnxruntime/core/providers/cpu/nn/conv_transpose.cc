@@ -17,6 +17,8 @@
 
 #include "core/providers/cpu/nn/conv_transpose.h"
 
+#include <algorithm>
+
 #include "core/common/safeint.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
@@ -40,6 +42,35 @@ Status ConvTranspose<T>::Compute(OpKernelContext* context) const {
   return ConvTranspose<T>::DoConvTranspose(context, false);
 }
 
+namespace {
+
+// Bounds the column buffer: the output channels are expanded in chunks that fit in this many elements
+// instead of expanding all of the channels of a group at once.
+constexpr int64_t kColBufferBudget = int64_t{1} << 22;
+
+// Scatters the columns of one output channel of a 2D transposed convolution whose kernel tiles the output
+// exactly, i.e. the stride equals the kernel, so that every output element is written once instead of being
+// zeroed and accumulated.
+template <typename T>
+void Col2imNonOverlapping(const T* data_col, int64_t input_h, int64_t input_w, int64_t kernel_h,
+                          int64_t kernel_w, T* data_im) {
+  const int64_t input_size = input_h * input_w;
+  const int64_t output_w = input_w * kernel_w;
+  for (int64_t y = 0; y < input_h; ++y) {
+    for (int64_t kh = 0; kh < kernel_h; ++kh) {
+      T* out = data_im + (y * kernel_h + kh) * output_w;
+      const T* col = data_col + kh * kernel_w * input_size + y * input_w;
+      for (int64_t x = 0; x < input_w; ++x) {
+        for (int64_t kw = 0; kw < kernel_w; ++kw) {
+          out[x * kernel_w + kw] = col[kw * input_size + x];
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
 template <typename T>
 Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_padding) const {
   concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
@@ -59,115 +90,107 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
   const int64_t Y_offset = p.Y->Shape().Size() / p.Y->Shape()[0] / conv_transpose_attrs_.group;
   const int64_t W_offset = p.F->Shape().Size() / conv_transpose_attrs_.group;
   const int64_t kernel_size = TensorShape(p.kernel_shape).Size();
-  const int64_t kernel_dim = p.num_output_channels / conv_transpose_attrs_.group * kernel_size;
+  const int64_t input_channels_per_group = p.num_input_channels / conv_transpose_attrs_.group;
+  const int64_t output_channels_per_group = p.num_output_channels / conv_transpose_attrs_.group;
+  const int64_t kernel_dim = output_channels_per_group * kernel_size;
   const int64_t output_size = (p.Y->Shape().Slice(2)).Size();
+  const size_t spatial_rank = p.kernel_shape.size();
+
+  // The rows of the column buffer of an output channel only scatter to that channel, so the channels are
+  // expanded a chunk at a time and each chunk is scattered across threads.
+  const int64_t col_channel_size = kernel_size * input_image_size;
+  const int64_t channels_per_chunk = std::max<int64_t>(
+      1, std::min(output_channels_per_group, kColBufferBudget / std::max<int64_t>(1, col_channel_size)));
 
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
 
-  const int64_t col_buffer_size = kernel_dim * p.input_shape.Size();
+  const int64_t col_buffer_size = channels_per_chunk * col_channel_size;
   auto col_data = alloc->Alloc(SafeInt<size_t>(sizeof(T)) * col_buffer_size);
   BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
   T* col_buffer_data = static_cast<T*>(col_buffer.get());
 
   const T* Xdata = p.X->template Data<T>();
   const T* filter_data = p.F->template Data<T>();
+  const T* Bdata = p.B != nullptr ? p.B->template Data<T>() : nullptr;
   T* Ydata = p.Y->template MutableData<T>();
 
-  std::vector<int64_t> col_buffer_shape{kernel_dim};
-  col_buffer_shape.insert(col_buffer_shape.end(), p.input_shape.GetDims().begin(), p.input_shape.GetDims().end());
-
-  if (p.X->Shape().NumDimensions() == 4) {
-    for (auto image_id = 0; image_id < p.N; ++image_id) {
-      for (int group_id = 0; group_id < conv_transpose_attrs_.group; ++group_id) {
-        // Weight term
-        math::Gemm<T>(
-            CblasTrans,
-            CblasNoTrans,
-            kernel_dim,
-            input_image_size,
-            p.num_input_channels / conv_transpose_attrs_.group,
-            1,
-            filter_data + group_id * W_offset,
-            Xdata + group_id * X_offset,
-            0,
-            col_buffer_data,
-            thread_pool);
-
-        // Col2im
-        math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
-            col_buffer_data,
-            p.num_output_channels / conv_transpose_attrs_.group,
-            p.Y->Shape()[2],
-            p.Y->Shape()[3],
-            p.kernel_shape[0],
-            p.kernel_shape[1],
-            p.dilations[0],
-            p.dilations[1],
-            p.pads[0],
-            p.pads[1],
-            p.pads[2],
-            p.pads[3],
-            p.strides[0],
-            p.strides[1],
-            Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
-      }
-
-      if (p.B != nullptr) {
-        auto Ymatrix = EigenMatrixMap<T>(Ydata, output_size, p.num_output_channels);
-        auto Bvec = ConstEigenVectorMap<T>(p.B->template Data<T>(), p.num_output_channels);
-        Ymatrix.rowwise() += Bvec.transpose();
-      }
+  // The shapes of a single output channel and its columns for Col2imNd.
+  std::vector<int64_t> channel_shape{1};
+  channel_shape.insert(channel_shape.end(), p.Y->Shape().GetDims().begin() + 2, p.Y->Shape().GetDims().end());
+  std::vector<int64_t> col_channel_shape{kernel_size};
+  col_channel_shape.insert(col_channel_shape.end(), p.input_shape.GetDims().begin(), p.input_shape.GetDims().end());
+
+  // A kernel that tiles the output exactly doesn't need the output to be zeroed and accumulated.
+  bool non_overlapping = spatial_rank == 2;
+  for (size_t i = 0; i < spatial_rank && non_overlapping; ++i) {
+    non_overlapping = p.strides[i] == p.kernel_shape[i] && p.dilations[i] == 1 && p.pads[i] == 0 &&
+                      p.pads[i + spatial_rank] == 0 && p.Y->Shape()[i + 2] == p.input_shape[i] * p.strides[i];
+  }
 
-      Xdata += X_offset * conv_transpose_attrs_.group;
-      Ydata += Y_offset * conv_transpose_attrs_.group;
+  auto col2im_channel = [&](const T* col, T* image) {
+    if (non_overlapping) {
+      Col2imNonOverlapping(col, p.input_shape[0], p.input_shape[1], p.kernel_shape[0], p.kernel_shape[1], image);
+    } else if (spatial_rank == 2) {
+      math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
+          col, 1, p.Y->Shape()[2], p.Y->Shape()[3],
+          p.kernel_shape[0], p.kernel_shape[1],
+          p.dilations[0], p.dilations[1],
+          p.pads[0], p.pads[1], p.pads[2], p.pads[3],
+          p.strides[0], p.strides[1],
+          image, &CPUMathUtil::Instance());
+    } else {
+      math::Col2imNd<T, CPUMathUtil, StorageOrder::NCHW>(
+          col, channel_shape.data(), col_channel_shape.data(), output_size, col_channel_size,
+          p.kernel_shape.data(), p.strides.data(), p.dilations.data(), p.pads.data(),
+          static_cast<int>(spatial_rank), image, &CPUMathUtil::Instance());
     }
-  } else {
-    TensorShape output_shape = p.Y->Shape().Slice(1);
-    output_shape[0] = output_shape[0] / conv_transpose_attrs_.group;
+  };
+
+  for (auto image_id = 0; image_id < p.N; ++image_id) {
+    for (int64_t group_id = 0; group_id < conv_transpose_attrs_.group; ++group_id) {
+      for (int64_t channel = 0; channel < output_channels_per_group; channel += channels_per_chunk) {
+        const int64_t chunk_channels = std::min(channels_per_chunk, output_channels_per_group - channel);
 
-    for (auto image_id = 0; image_id < p.N; ++image_id) {
-      for (int group_id = 0; group_id < conv_transpose_attrs_.group; ++group_id) {
         // Weight term
-        math::Gemm<T>(
+        math::GemmEx<T, concurrency::ThreadPool>(
             CblasTrans,
             CblasNoTrans,
-            kernel_dim,
-            input_image_size,
-            p.num_input_channels / conv_transpose_attrs_.group,
+            static_cast<int>(chunk_channels * kernel_size),
+            static_cast<int>(input_image_size),
+            static_cast<int>(input_channels_per_group),
             1,
-            filter_data + group_id * W_offset,
+            filter_data + group_id * W_offset + channel * kernel_size,
+            static_cast<int>(kernel_dim),
             Xdata + group_id * X_offset,
+            static_cast<int>(input_image_size),
             0,
             col_buffer_data,
+            static_cast<int>(input_image_size),
             thread_pool);
 
-        // Col2im
-        math::Col2imNd<T, CPUMathUtil, StorageOrder::NCHW>(
-            col_buffer_data,
-            output_shape.GetDims().data(),
-            col_buffer_shape.data(),
-            output_shape.Size(),
-            col_buffer_size,
-            p.kernel_shape.data(),
-            p.strides.data(),
-            p.dilations.data(),
-            p.pads.data(),
-            static_cast<int>(p.kernel_shape.size()),
-            Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
-      }
-
-      if (p.B != nullptr) {
-        auto Ymatrix = EigenMatrixMap<T>(Ydata, output_size, p.num_output_channels);
-        auto Bvec = ConstEigenVectorMap<T>(p.B->template Data<T>(), p.num_output_channels);
-        Ymatrix.rowwise() += Bvec.transpose();
+        // Col2im and bias
+        T* Ychunk = Ydata + group_id * Y_offset + channel * output_size;
+        const T* Bchunk = Bdata != nullptr ? Bdata + group_id * output_channels_per_group + channel : nullptr;
+        concurrency::ThreadPool::TryParallelFor(
+            thread_pool, static_cast<std::ptrdiff_t>(chunk_channels),
+            TensorOpCost{static_cast<double>(col_channel_size * sizeof(T)),
+                         static_cast<double>(output_size * sizeof(T)),
+                         static_cast<double>(col_channel_size + output_size)},
+            [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+              for (std::ptrdiff_t c = first; c < last; ++c) {
+                T* image = Ychunk + c * output_size;
+                col2im_channel(col_buffer_data + c * col_channel_size, image);
+                if (Bchunk != nullptr) {
+                  EigenVectorMap<T>(image, output_size).array() += Bchunk[c];
+                }
+              }
+            });
       }
-
-      Xdata += X_offset * conv_transpose_attrs_.group;
-      Ydata += Y_offset * conv_transpose_attrs_.group;
     }
+
+    Xdata += X_offset * conv_transpose_attrs_.group;
+    Ydata += Y_offset * conv_transpose_attrs_.group;
   }
 
   return Status::OK();
@@ -1,9 +1,12 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/providers/cpu/nn/instance_norm.h"
 #include "core/providers/cpu/nn/instance_norm_helper.h"
-#include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -28,16 +31,26 @@ Status InstanceNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const
   const TensorShape& x_shape = input->Shape();
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
 
-  for (auto i = 0; i < N * C; ++i) {
-    ConstEigenVectorArrayMap<float> Xi(input->template Data<float>() + W * i, W);
-    const float Xi_mean = Xi.mean();
-    const float squared_norm = (Xi - Xi_mean).matrix().squaredNorm();
-    const float inv_stdev = 1.0f / std::sqrt(squared_norm / W + epsilon_);
-    EigenVectorArrayMap<float> Yi(Y->template MutableData<float>() + W * i, W);
-    const float channel_scale = inv_stdev * scale->template Data<float>()[i % C];
-    const float channel_shift = B->template Data<float>()[i % C] - Xi_mean * channel_scale;
-    Yi = Xi * channel_scale + channel_shift;
-  }
+  const float* X_data = input->template Data<float>();
+  const float* scale_data = scale->template Data<float>();
+  const float* B_data = B->template Data<float>();
+  float* Y_data = Y->template MutableData<float>();
+
+  // Each channel plane of each image is normalized independently. A range of planes is split where it crosses
+  // into the next image, so each MLAS call reads a contiguous run of the per channel scales and biases.
+  const double plane_bytes = static_cast<double>(W * sizeof(float));
+  concurrency::ThreadPool::TryParallelFor(
+      p_op_kernel_context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(N * C),
+      TensorOpCost{plane_bytes, plane_bytes, static_cast<double>(W) * 4},
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i < end;) {
+          const int64_t c = i % C;
+          const std::ptrdiff_t count = std::min<std::ptrdiff_t>(end - i, static_cast<std::ptrdiff_t>(C - c));
+          MlasComputeInstanceNorm(X_data + W * i, scale_data + c, B_data + c, Y_data + W * i,
+                                  static_cast<size_t>(count), static_cast<size_t>(W), epsilon_);
+          i += count;
+        }
+      });
 
   return Status::OK();
 }
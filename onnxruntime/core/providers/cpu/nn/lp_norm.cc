@@ -1,9 +1,13 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "core/providers/cpu/nn/lp_norm.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 ONNX_CPU_OPERATOR_KERNEL(
@@ -12,59 +16,109 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     LpNorm<float>);
 
-using InnerStride = Eigen::InnerStride<Eigen::Dynamic>;
-using StridedVec = Eigen::Map<Eigen::Matrix<float, 1, Eigen::Dynamic>, 0, InnerStride>;
-using ConstStridedVec = Eigen::Map<const Eigen::Matrix<float, 1, Eigen::Dynamic>, 0, InnerStride>;
-
-void DoNormalizeP2(
-    const float* xData,
-    float* yData,
-    const int64_t m,
-    const int64_t n,
-    const int64_t sf) {
-  for (int i = 0; i < n; ++i) {
-    auto base = (i / sf) * sf * m + (i % sf);
-    ConstStridedVec xVec(xData + base, 1, m, InnerStride(sf));
-    auto norm = xVec.template lpNorm<2>();
-    if (norm != 0) {
-      StridedVec yVec(yData + base, 1, m, InnerStride(sf));
-      yVec = xVec / norm;
-    }
+namespace {
+
+// The norm of a row and the norms of a set of columns, for p = 1 or 2.
+template <int64_t P>
+float RowNorm(const ConstEigenVectorArrayMap<float>& x) {
+  return P == 1 ? x.abs().sum() : std::sqrt(x.square().sum());
+}
+
+template <int64_t P>
+void AccumulateColumnNorms(const ConstEigenVectorArrayMap<float>& x, EigenVectorArrayMap<float>& norms) {
+  if (P == 1) {
+    norms += x.abs();
+  } else {
+    norms += x.square();
   }
-};
-
-void DoNormalizeP1(
-    const float* xData,
-    float* yData,
-    const int64_t m,
-    const int64_t n,
-    const int64_t sf) {
-  for (int i = 0; i < n; ++i) {
-    auto base = (i / sf) * sf * m + (i % sf);
-    ConstStridedVec xVec(xData + base, 1, m, InnerStride(sf));
-    auto norm = xVec.template lpNorm<1>();
-    if (norm != 0) {
-      StridedVec yVec(yData + base, 1, m, InnerStride(sf));
-      yVec = xVec / norm;
-    }
+}
+
+// Columns of a block processed by one task when the normalized axis isn't the innermost one.
+constexpr int64_t kColumnsPerTask = 256;
+
+// Normalizes the n vectors of m elements, each of which starts at a multiple of sf * m plus an offset smaller
+// than sf and has a stride of sf. For sf == 1 the vectors are contiguous and each task normalizes whole vectors.
+// Otherwise a block of sf * m elements holds sf interleaved vectors: a task takes a run of up to kColumnsPerTask
+// of them and accumulates their norms one contiguous row of the block at a time, so the block is read in order
+// and the inner loops vectorize.
+template <int64_t P>
+void DoNormalize(const float* xData, float* yData, const int64_t m, const int64_t n, const int64_t sf,
+                 concurrency::ThreadPool* tp) {
+  if (sf == 1) {
+    const double vector_bytes = static_cast<double>(m * sizeof(float));
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(n), TensorOpCost{vector_bytes, vector_bytes, static_cast<double>(m) * 2},
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i < end; ++i) {
+            ConstEigenVectorArrayMap<float> xVec(xData + i * m, m);
+            EigenVectorArrayMap<float> yVec(yData + i * m, m);
+            const float norm = RowNorm<P>(xVec);
+            // A zero norm means a vector of zeros, which is its own normalization.
+            if (norm != 0) {
+              yVec = xVec / norm;
+            } else {
+              yVec = xVec;
+            }
+          }
+        });
+    return;
   }
-};
+
+  const int64_t num_blocks = n / sf;
+  const int64_t tasks_per_block = (sf + kColumnsPerTask - 1) / kColumnsPerTask;
+  const double task_bytes = static_cast<double>(std::min(sf, kColumnsPerTask) * m * sizeof(float));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks * tasks_per_block),
+      TensorOpCost{task_bytes, task_bytes, static_cast<double>(std::min(sf, kColumnsPerTask) * m) * 3},
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        float norms_buffer[kColumnsPerTask];
+        for (std::ptrdiff_t task = begin; task < end; ++task) {
+          const int64_t block = task / tasks_per_block;
+          const int64_t column = (task % tasks_per_block) * kColumnsPerTask;
+          const int64_t columns = std::min(kColumnsPerTask, sf - column);
+          const float* xBlock = xData + block * sf * m + column;
+          float* yBlock = yData + block * sf * m + column;
+
+          EigenVectorArrayMap<float> norms(norms_buffer, columns);
+          norms.setZero();
+          for (int64_t j = 0; j < m; ++j) {
+            AccumulateColumnNorms<P>(ConstEigenVectorArrayMap<float>(xBlock + j * sf, columns), norms);
+          }
+          // Zero norms are left as 1 so the zero vectors are copied as is.
+          if (P == 2) {
+            norms = norms.sqrt();
+          }
+          norms = (norms == 0.0f).select(1.0f, norms).inverse();
+
+          for (int64_t j = 0; j < m; ++j) {
+            EigenVectorArrayMap<float>(yBlock + j * sf, columns) =
+                ConstEigenVectorArrayMap<float>(xBlock + j * sf, columns) * norms;
+          }
+        }
+      });
+}
+
+}  // namespace
 
 template <>
 Status LpNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const {
   const auto* input = p_op_kernel_context->Input<Tensor>(0);
   const TensorShape& input_shape = input->Shape();
   Tensor* output = p_op_kernel_context->Output(0, input_shape);
+  if (input_shape.Size() == 0) {
+    return Status::OK();
+  }
 
   const auto canonical_axis = HandleNegativeAxis(axis_, static_cast<int64_t>(input_shape.NumDimensions()));
-  const int64_t m = input_shape.GetDims()[canonical_axis];
+  const int64_t m = input_shape[canonical_axis];
   const int64_t n = input_shape.Size() / m;
   const int64_t sf = input_shape.SizeFromDimension(canonical_axis + 1);
 
+  concurrency::ThreadPool* tp = p_op_kernel_context->GetOperatorThreadPool();
   if (p_ == 1) {
-    DoNormalizeP1(input->template Data<float>(), output->template MutableData<float>(), m, n, sf);
+    DoNormalize<1>(input->template Data<float>(), output->template MutableData<float>(), m, n, sf, tp);
   } else if (p_ == 2) {
-    DoNormalizeP2(input->template Data<float>(), output->template MutableData<float>(), m, n, sf);
+    DoNormalize<2>(input->template Data<float>(), output->template MutableData<float>(), m, n, sf, tp);
   }
 
   return Status::OK();
@@ -20,6 +20,23 @@ class QLinearConv : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
   ConvAttributes conv_attrs_;
+
+ private:
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+  Status ComputeDepthwise(OpKernelContext* context,
+                          const Tensor* X,
+                          uint8_t X_zero_point_value,
+                          const Tensor* W,
+                          uint8_t W_zero_point_value,
+                          const int32_t* Bdata,
+                          Tensor* Y,
+                          uint8_t Y_zero_point_value,
+                          const float* output_scales,
+                          const std::vector<int64_t>& kernel_shape,
+                          const std::vector<int64_t>& pads,
+                          const std::vector<int64_t>& dilations,
+                          const std::vector<int64_t>& strides) const;
+#endif
 };
 
 ONNX_OPERATOR_KERNEL_EX(
@@ -37,6 +54,12 @@ ONNX_OPERATOR_KERNEL_EX(
 Status QLinearConv::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const auto* W = context->Input<Tensor>(3);
+  const int64_t M = W->Shape()[0];
+
+  // The filter can be quantized per output channel, with 1D scale and zero point tensors of size M.
+  auto is_per_channel = [M](const Tensor* tensor) {
+    return tensor->Shape().NumDimensions() == 1 && tensor->Shape()[0] == M;
+  };
 
   // validate offsets
   auto X_zero_point = context->Input<Tensor>(2);
@@ -44,8 +67,8 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto Y_zero_point = context->Input<Tensor>(7);
   ORT_ENFORCE(IsScalarOr1ElementVector(X_zero_point),
               "QLinearConv : input zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(W_zero_point),
-              "QLinearConv : filter zero point must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(W_zero_point) || is_per_channel(W_zero_point),
+              "QLinearConv : filter zero point must be a scalar or 1D tensor of size 1 or M");
   ORT_ENFORCE(IsScalarOr1ElementVector(Y_zero_point),
               "QLinearConv : result zero point must be a scalar or 1D tensor of size 1");
 
@@ -53,21 +76,35 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto W_zero_point_value = *(W_zero_point->template Data<uint8_t>());
   auto Y_zero_point_value = *(Y_zero_point->template Data<uint8_t>());
 
+  // The GEMM subtracts a single filter zero point, so per channel zero points must all be the same,
+  // as they are for symmetrically quantized filters.
+  const auto W_zero_point_data = W_zero_point->DataAsSpan<uint8_t>();
+  ORT_ENFORCE(std::all_of(W_zero_point_data.cbegin(), W_zero_point_data.cend(),
+                          [W_zero_point_value](uint8_t zero_point) { return zero_point == W_zero_point_value; }),
+              "QLinearConv : filter zero points must have the same value");
+
   // validate scale
   auto X_scale = context->Input<Tensor>(1);
   auto W_scale = context->Input<Tensor>(4);
   auto Y_scale = context->Input<Tensor>(6);
   ORT_ENFORCE(IsScalarOr1ElementVector(X_scale),
               "QLinearConv : input scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(W_scale),
-              "QLinearConv : filter scale must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(W_scale) || is_per_channel(W_scale),
+              "QLinearConv : filter scale must be a scalar or 1D tensor of size 1 or M");
   ORT_ENFORCE(IsScalarOr1ElementVector(Y_scale),
               "QLinearConv : result scale must be a scalar or 1D tensor of size 1");
 
   auto X_scale_value = *(X_scale->template Data<float>());
-  auto W_scale_value = *(W_scale->template Data<float>());
   auto Y_scale_value = *(Y_scale->template Data<float>());
 
+  // The scale used to requantize each output channel.
+  const auto W_scale_data = W_scale->DataAsSpan<float>();
+  std::vector<float> output_scales(static_cast<size_t>(M));
+  for (size_t m = 0; m < output_scales.size(); ++m) {
+    const float W_scale_value = W_scale_data[W_scale_data.size() == 1 ? 0 : m];
+    output_scales[m] = (X_scale_value * W_scale_value) / Y_scale_value;
+  }
+
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* B = nullptr;
   if (num_inputs == 9) {
@@ -76,7 +113,6 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
   ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
 
   std::vector<int64_t> kernel_shape;
@@ -118,6 +154,17 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
   const size_t kernel_rank = kernel_shape.size();
 
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+  // Depthwise convolutions have a single input and output channel per group, so the GEMM for each
+  // group degenerates to a matrix-vector product. Use the MLAS depthwise kernel instead.
+  if (conv_attrs_.group > 1 && conv_attrs_.group == C && M == C && kernel_rank == 2) {
+    return ComputeDepthwise(context, X, X_zero_point_value, W, W_zero_point_value,
+                            B != nullptr ? B->template Data<int32_t>() : nullptr,
+                            Y, Y_zero_point_value, output_scales.data(),
+                            kernel_shape, pads, dilations, strides);
+  }
+#endif
+
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
 
@@ -140,8 +187,6 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
   auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
 
-  const float real_multiplier = (X_scale_value * W_scale_value) / Y_scale_value;
-
 #ifdef MLAS_SUPPORTS_GEMM_U8X8
   // Use an intermediate int32_t buffer for the GEMM computation before
   // requantizing to the output type.
@@ -149,10 +194,12 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
   auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
 #else
-  // Compute the fixed point multiplier and shift for requantizing with GEMMLOWP.
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+  // Compute the fixed point multiplier and shift of each output channel for requantizing with GEMMLOWP.
+  std::vector<int32_t> integer_multipliers(output_scales.size());
+  std::vector<int> right_shifts(output_scales.size());
+  for (size_t m = 0; m < output_scales.size(); ++m) {
+    QuantizeMultiplier(output_scales[m], &integer_multipliers[m], &right_shifts[m]);
+  }
 #endif
 
   const auto* Xdata = X->template Data<uint8_t>();
@@ -219,21 +266,27 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
                            Bdata != nullptr ? Bdata + group_id * B_offset : nullptr,
                            static_cast<size_t>(M / conv_attrs_.group),
                            static_cast<size_t>(output_image_size),
-                           real_multiplier,
+                           output_scales.data() + group_id * B_offset,
+                           false,
                            Y_zero_point_value);
 #else
-      GemmlowpMultiplyu8u8_u8(Wdata + group_id * W_offset,
-                              col_buffer_data == nullptr ? Xdata : col_buffer_data,
-                              Ydata,
-                              W_zero_point_value,
-                              X_zero_point_value,
-                              Y_zero_point_value,
-                              static_cast<int>(M / conv_attrs_.group),
-                              static_cast<int>(output_image_size),
-                              static_cast<int>(kernel_dim),
-                              integer_multiplier,
-                              right_shift,
-                              Bdata != nullptr ? Bdata + group_id * B_offset : nullptr);
+      // GEMMLOWP takes a single multiplier, so a per channel filter is multiplied one output channel at a time.
+      const int64_t rows_per_call = W_scale_data.size() != 1 ? 1 : M / conv_attrs_.group;
+      for (int64_t m = 0; m < M / conv_attrs_.group; m += rows_per_call) {
+        const int64_t channel = group_id * B_offset + m;
+        GemmlowpMultiplyu8u8_u8(Wdata + group_id * W_offset + m * kernel_dim,
+                                col_buffer_data == nullptr ? Xdata : col_buffer_data,
+                                Ydata + m * output_image_size,
+                                W_zero_point_value,
+                                X_zero_point_value,
+                                Y_zero_point_value,
+                                static_cast<int>(rows_per_call),
+                                static_cast<int>(output_image_size),
+                                static_cast<int>(kernel_dim),
+                                integer_multipliers[channel],
+                                right_shifts[channel],
+                                Bdata != nullptr ? Bdata + channel : nullptr);
+      }
 #endif
 
       Xdata += X_offset;
@@ -244,4 +297,125 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+
+namespace {
+
+// Transposes the rows x cols matrix in src to the cols x rows matrix in dst.
+template <typename T>
+void TransposeMatrix(const T* src, T* dst, size_t rows, size_t cols) {
+  for (size_t r = 0; r < rows; r++) {
+    for (size_t c = 0; c < cols; c++) {
+      dst[c * rows + r] = src[r * cols + c];
+    }
+  }
+}
+
+}  // namespace
+
+Status QLinearConv::ComputeDepthwise(OpKernelContext* context,
+                                     const Tensor* X,
+                                     uint8_t X_zero_point_value,
+                                     const Tensor* W,
+                                     uint8_t W_zero_point_value,
+                                     const int32_t* Bdata,
+                                     Tensor* Y,
+                                     uint8_t Y_zero_point_value,
+                                     const float* output_scales,
+                                     const std::vector<int64_t>& kernel_shape,
+                                     const std::vector<int64_t>& pads,
+                                     const std::vector<int64_t>& dilations,
+                                     const std::vector<int64_t>& strides) const {
+  const int64_t N = X->Shape()[0];
+  const size_t C = static_cast<size_t>(X->Shape()[1]);
+  const int64_t input_height = X->Shape()[2];
+  const int64_t input_width = X->Shape()[3];
+  const int64_t output_height = Y->Shape()[2];
+  const int64_t output_width = Y->Shape()[3];
+
+  const size_t input_image_size = static_cast<size_t>(input_height * input_width);
+  const size_t output_image_size = static_cast<size_t>(output_height * output_width);
+  const size_t kernel_size = static_cast<size_t>(kernel_shape[0] * kernel_shape[1]);
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // The depthwise kernel operates on the channels last (NHWC) layout, so each image is transposed into
+  // this buffer before the convolution.
+  auto* input_nhwc_data = alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * C * input_image_size);
+  BufferUniquePtr input_nhwc_buffer(input_nhwc_data, BufferDeleter(alloc));
+  auto* input_nhwc = static_cast<uint8_t*>(input_nhwc_buffer.get());
+
+  auto* output_data = alloc->Alloc(SafeInt<size_t>(sizeof(int32_t)) * C * output_image_size * 2);
+  BufferUniquePtr output_buffer(output_data, BufferDeleter(alloc));
+  auto* output_nhwc = static_cast<int32_t*>(output_buffer.get());
+  auto* output_nchw = output_nhwc + C * output_image_size;
+
+  // Reorder the filter from [C, 1, kernel_h, kernel_w] to [kernel_h, kernel_w, C].
+  std::vector<uint8_t> filter(kernel_size * C);
+  TransposeMatrix(W->template Data<uint8_t>(), filter.data(), C, kernel_size);
+
+  // Build the indirection buffer that addresses the input pixel for each output pixel and kernel
+  // position. Positions in the padding region address a pixel filled with the input zero point.
+  std::vector<uint8_t> padding(C, X_zero_point_value);
+  std::vector<const uint8_t*> indirection(output_image_size * kernel_size);
+  const uint8_t** indirection_data = indirection.data();
+
+  for (int64_t oh = 0; oh < output_height; oh++) {
+    for (int64_t ow = 0; ow < output_width; ow++) {
+      for (int64_t kh = 0; kh < kernel_shape[0]; kh++) {
+        const int64_t ih = oh * strides[0] - pads[0] + kh * dilations[0];
+        for (int64_t kw = 0; kw < kernel_shape[1]; kw++) {
+          const int64_t iw = ow * strides[1] - pads[1] + kw * dilations[1];
+          if (ih >= 0 && ih < input_height && iw >= 0 && iw < input_width) {
+            *indirection_data++ = input_nhwc + static_cast<size_t>(ih * input_width + iw) * C;
+          } else {
+            *indirection_data++ = padding.data();
+          }
+        }
+      }
+    }
+  }
+
+  const auto* Xdata = X->template Data<uint8_t>();
+  auto* Ydata = Y->template MutableData<uint8_t>();
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  for (int64_t image_id = 0; image_id < N; ++image_id) {
+    TransposeMatrix(Xdata, input_nhwc, C, input_image_size);
+
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(output_image_size), static_cast<double>(C * kernel_size),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          MlasConvDepthwise(indirection.data() + first * kernel_size,
+                            X_zero_point_value,
+                            filter.data(),
+                            W_zero_point_value,
+                            output_nhwc + first * C,
+                            C,
+                            static_cast<size_t>(last - first),
+                            kernel_size);
+        });
+
+    TransposeMatrix(output_nhwc, output_nchw, output_image_size, C);
+
+    MlasRequantizeOutput(output_nchw,
+                         Ydata,
+                         Bdata,
+                         C,
+                         output_image_size,
+                         output_scales,
+                         false,
+                         Y_zero_point_value);
+
+    Xdata += C * input_image_size;
+    Ydata += C * output_image_size;
+  }
+
+  return Status::OK();
+}
+
+#endif
+
 }  // namespace onnxruntime
@@ -16,6 +16,7 @@
 #include <iconv.h>
 #endif  // _MSC_VER
 
+#include <algorithm>
 #include <locale>
 #include <functional>
 #include <unordered_set>
@@ -81,7 +82,8 @@ const std::string default_locale("en-US");
 
 class Locale {
  public:
-  explicit Locale(const std::string& name) try : loc_(name.c_str()) {
+  explicit Locale(const std::string& name) try : loc_(name.c_str()),
+                                                 ctype_(std::use_facet<std::ctype<wchar_t>>(loc_)) {
   } catch (const std::runtime_error& e) {
     ORT_THROW("Failed to construct locale with name:",
               name, ":", e.what(), ":Please, install necessary language-pack-XX and configure locales");
@@ -92,17 +94,21 @@ class Locale {
   void ChangeCase(StringNormalizer::CaseAction caseaction,
                   std::wstring& wstr) const {
     assert(caseaction != StringNormalizer::NONE);
+    if (wstr.empty()) {
+      return;
+    }
+    // Convert the whole string with the facet rather than looking it up for every char
+    wchar_t* first = &wstr[0];
     if (caseaction == StringNormalizer::LOWER) {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return std::tolower(ch, loc_); });
+      ctype_.tolower(first, first + wstr.size());
     } else {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return std::toupper(ch, loc_); });
+      ctype_.toupper(first, first + wstr.size());
     }
   }
 
  private:
   std::locale loc_;
+  const std::ctype<wchar_t>& ctype_;
 };
 
 #if defined(__APPLE__) or defined(__ANDROID__)
@@ -110,20 +116,32 @@ using Utf8Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
 #else
 
 // All others (Linux)
+// iconv descriptors are opened on first use and reused by the following
+// conversions, so a converter must not be shared between threads.
 class Utf8Converter {
  public:
 
   Utf8Converter(const std::string&, const std::wstring&) {}
 
-  std::wstring from_bytes(const std::string& s) const {
+  ~Utf8Converter() {
+    if (IsOpen(to_wchar_)) {
+      iconv_close(to_wchar_);
+    }
+    if (IsOpen(to_utf8_)) {
+      iconv_close(to_utf8_);
+    }
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Utf8Converter);
+
+  std::wstring from_bytes(const std::string& s) {
     std::wstring result;
     if (s.empty()) {
       return result;
     }
     // Order of arguments is to, from
-    auto icvt = iconv_open("WCHAR_T", "UTF-8");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
+    auto icvt = Open(to_wchar_, "WCHAR_T", "UTF-8");
+    if (!IsOpen(icvt)) {
       return wconv_error;
     }
 
@@ -143,19 +161,17 @@ class Utf8Converter {
       assert((converted_bytes % sizeof(wchar_t)) == 0);
       result.assign(reinterpret_cast<const wchar_t*>(buffer.get()), converted_bytes / sizeof(wchar_t));
     }
-    iconv_close(icvt);
     return result;
   }
 
-  std::string to_bytes(const std::wstring& wstr) const {
+  std::string to_bytes(const std::wstring& wstr) {
     std::string result;
     if (wstr.empty()) {
       return result;
     }
     // Order of arguments is to, from
-    auto icvt = iconv_open("UTF-8", "WCHAR_T");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
+    auto icvt = Open(to_utf8_, "UTF-8", "WCHAR_T");
+    if (!IsOpen(icvt)) {
       return conv_error;
     }
 
@@ -177,9 +193,27 @@ class Utf8Converter {
       size_t converted_len = buffer_len - iconv_out_bytes;
       result.assign(buffer.get(), converted_len);
     }
-    iconv_close(icvt);
     return result;
   }
+
+ private:
+  static bool IsOpen(iconv_t icvt) {
+    // CentOS is not happy with -1
+    return std::numeric_limits<iconv_t>::max() != icvt;
+  }
+
+  // Opens the descriptor on first use, or resets the conversion state of an open one
+  static iconv_t Open(iconv_t& icvt, const char* to, const char* from) {
+    if (IsOpen(icvt)) {
+      iconv(icvt, nullptr, nullptr, nullptr, nullptr);
+    } else {
+      icvt = iconv_open(to, from);
+    }
+    return icvt;
+  }
+
+  iconv_t to_wchar_ = std::numeric_limits<iconv_t>::max();
+  iconv_t to_utf8_ = std::numeric_limits<iconv_t>::max();
 };
 
 #endif // __APPLE__
@@ -188,6 +222,30 @@ const std::string default_locale("en_US.UTF-8"); // All non-MS
 
 #endif // MS_VER
 
+// ASCII strings are widened and narrowed char by char, which is
+// much cheaper than going through the converter.
+inline bool IsAscii(const std::string& s) {
+  return std::all_of(s.cbegin(), s.cend(), [](char ch) { return (static_cast<unsigned char>(ch) & 0x80) == 0; });
+}
+
+inline bool IsAscii(const std::wstring& wstr) {
+  return std::all_of(wstr.cbegin(), wstr.cend(), [](wchar_t ch) { return static_cast<uint32_t>(ch) < 0x80; });
+}
+
+std::wstring FromUtf8(Utf8Converter& converter, const std::string& s) {
+  if (IsAscii(s)) {
+    return std::wstring(s.cbegin(), s.cend());
+  }
+  return converter.from_bytes(s);
+}
+
+std::string ToUtf8(Utf8Converter& converter, const std::wstring& wstr) {
+  if (IsAscii(wstr)) {
+    return std::string(wstr.cbegin(), wstr.cend());
+  }
+  return converter.to_bytes(wstr);
+}
+
 template <class ForwardIter>
 Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
                       const Locale& loc,
@@ -218,14 +276,14 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
   while (first != end) {
     auto& s = *first;
     if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
+      std::wstring wstr = FromUtf8(converter, s);
       if (wstr == wconv_error) {
         return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                       "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(s));
       }
       // In place transform
       loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
+      *(output_data + output_idx) = ToUtf8(converter, wstr);
     } else {
       assert(caseaction == StringNormalizer::NONE);
       // Simple copy or move if the iterator points to a non-const string
@@ -278,7 +336,7 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
       auto p = stopwords_.insert(sw);
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     } else {
-      std::wstring wstr = converter.from_bytes(sw);
+      std::wstring wstr = FromUtf8(converter, sw);
       ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
       locale.ChangeCase(compare_caseaction_, wstr);
       auto p = wstopwords_.insert(wstr);
@@ -351,7 +409,7 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
       auto const last = input_data + C;
       while (first != last) {
         const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
+        std::wstring wstr = FromUtf8(converter, s);
         if (wstr == wconv_error) {
           return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                         "Input contains invalid utf8 chars at: " + s);
@@ -361,7 +419,7 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
           if (case_change_action_ == NONE) {
             filtered_orignal_strings.push_back(std::cref(s));
           } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
+            filtered_cased_strings.push_back(ToUtf8(converter, wstr));
           }
         }
         ++first;
@@ -13,7 +13,9 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 #include "non_max_suppression_helper.h"
-#include <queue>
+#include <algorithm>
+#include <functional>
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -110,6 +112,96 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+// The corners and areas of the boxes of a batch, one array per coordinate so that the IOU of a box with a block of
+// boxes is computed with SIMD.
+struct BoxCorners {
+  std::vector<float> x_min, y_min, x_max, y_max, area;
+
+  void Resize(size_t size) {
+    x_min.resize(size);
+    y_min.resize(size);
+    x_max.resize(size);
+    y_max.resize(size);
+    area.resize(size);
+  }
+
+  void Set(size_t index, const float* box, int64_t center_point_box) {
+    // center_point_box_ only support 0 or 1
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2],
+      MaxMin(box[1], box[3], x_min[index], x_max[index]);
+      MaxMin(box[0], box[2], y_min[index], y_max[index]);
+    } else {
+      // 1 == center_point_box_ => boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      x_min[index] = box[0] - width_half;
+      x_max[index] = box[0] + width_half;
+      y_min[index] = box[1] - height_half;
+      y_max[index] = box[1] + height_half;
+    }
+    area[index] = (x_max[index] - x_min[index]) * (y_max[index] - y_min[index]);
+  }
+
+  void Append(const BoxCorners& boxes, size_t index) {
+    x_min.push_back(boxes.x_min[index]);
+    y_min.push_back(boxes.y_min[index]);
+    x_max.push_back(boxes.x_max[index]);
+    y_max.push_back(boxes.y_max[index]);
+    area.push_back(boxes.area[index]);
+  }
+};
+
+// Returns true if the IOU of the box at index in boxes with any of the selected boxes exceeds iou_threshold, with the
+// same conditions as SuppressByIOU.
+bool SuppressBySelected(const BoxCorners& boxes, size_t index, const BoxCorners& selected, float iou_threshold) {
+  const float x_min = boxes.x_min[index];
+  const float y_min = boxes.y_min[index];
+  const float x_max = boxes.x_max[index];
+  const float y_max = boxes.y_max[index];
+  const float area = boxes.area[index];
+  if (area <= .0f) {
+    return false;
+  }
+
+  // test blocks of selected boxes without branches so that the compiler vectorizes the loop, and stop at the first
+  // block suppressing the box
+  constexpr size_t kBlockSize = 16;
+  const size_t num_selected = selected.area.size();
+  for (size_t block = 0; block < num_selected; block += kBlockSize) {
+    const size_t block_end = std::min(block + kBlockSize, num_selected);
+    int suppressed = 0;
+    for (size_t i = block; i < block_end; ++i) {
+      const float width = std::max(std::min(x_max, selected.x_max[i]) - std::max(x_min, selected.x_min[i]), .0f);
+      const float height = std::max(std::min(y_max, selected.y_max[i]) - std::max(y_min, selected.y_min[i]), .0f);
+      const float intersection_area = width * height;
+      const float union_area = area + selected.area[i] - intersection_area;
+      suppressed |= static_cast<int>(intersection_area > .0f) & static_cast<int>(selected.area[i] > .0f) &
+                    static_cast<int>(union_area > .0f) & static_cast<int>(intersection_area / union_area > iou_threshold);
+    }
+    if (suppressed != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct ScoreIndexPair {
+  float score_{};
+  int64_t index_{};
+
+  ScoreIndexPair() = default;
+  explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
+
+  bool operator>(const ScoreIndexPair& rhs) const {
+    return score_ > rhs.score_;
+  }
+};
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   auto ret = PrepareCompute(ctx, pc);
@@ -129,69 +221,74 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
+  const auto center_point_box = GetCenterPointBox();
+  const size_t num_boxes = static_cast<size_t>(pc.num_boxes_);
 
-  struct ScoreIndexPair {
-    float score_{};
-    int64_t index_{};
-
-    ScoreIndexPair() = default;
-    explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
-
-    bool operator<(const ScoreIndexPair& rhs) const {
-      return score_ < rhs.score_;
+  // the corners of the boxes are shared by the classes of a batch
+  std::vector<BoxCorners> batch_boxes(static_cast<size_t>(pc.num_batches_));
+  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
+    auto& boxes = batch_boxes[batch_index];
+    boxes.Resize(num_boxes);
+    const float* batch_boxes_data = boxes_data + batch_index * pc.num_boxes_ * 4;
+    for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+      boxes.Set(box_index, batch_boxes_data + 4 * box_index, center_point_box);
     }
-  };
+  }
 
-  const auto center_point_box = GetCenterPointBox();
+  // the (batch, class) pairs are independent, so select their boxes in parallel and concatenate them in order
+  const int64_t num_pairs = pc.num_batches_ * pc.num_classes_;
+  std::vector<std::vector<int64_t>> selected_per_pair(static_cast<size_t>(num_pairs));
+
+  auto select_boxes = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<ScoreIndexPair> candidates;
+    BoxCorners selected;
+    for (std::ptrdiff_t pair = first; pair < last; ++pair) {
+      const auto& boxes = batch_boxes[pair / pc.num_classes_];
+      const float* class_scores = scores_data + pair * pc.num_boxes_;
 
-  std::vector<SelectedIndex> selected_indices;
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      int64_t box_offset = batch_index * pc.num_boxes_ * 4;
       // Filter by score_threshold_
-      std::priority_queue<ScoreIndexPair, std::deque<ScoreIndexPair>> sorted_scores_with_index;
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
-          }
-        }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
+      candidates.clear();
+      for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+        if (pc.score_threshold_ == nullptr || class_scores[box_index] > score_threshold) {
+          candidates.emplace_back(class_scores[box_index], static_cast<int64_t>(box_index));
         }
       }
 
-      ScoreIndexPair next_top_score;
-      std::vector<int64_t> selected_indices_inside_class;
+      // boxes often come sorted by score from the detector, so check before sorting. ties keep the order of the boxes.
+      if (!std::is_sorted(candidates.begin(), candidates.end(), std::greater<ScoreIndexPair>())) {
+        std::stable_sort(candidates.begin(), candidates.end(), std::greater<ScoreIndexPair>());
+      }
+
+      auto& selected_indices_inside_class = selected_per_pair[pair];
+      selected.Resize(0);
       // Get the next box with top score, filter by iou_threshold
-      while (!sorted_scores_with_index.empty()) {
-        next_top_score = sorted_scores_with_index.top();
-        sorted_scores_with_index.pop();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (int64_t selected_index : selected_indices_inside_class) {
-          if (SuppressByIOU(boxes_data + box_offset, selected_index, next_top_score.index_,
-                            center_point_box, iou_threshold)) {
-            selected = false;
+      for (const auto& candidate : candidates) {
+        const size_t box_index = static_cast<size_t>(candidate.index_);
+        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union)
+        // threshold
+        if (!SuppressBySelected(boxes, box_index, selected, iou_threshold)) {
+          selected_indices_inside_class.push_back(candidate.index_);
+          if (static_cast<int64_t>(selected_indices_inside_class.size()) >= max_output_boxes_per_class) {
             break;
           }
+          selected.Append(boxes, box_index);
         }
+      }
+    }
+  };
 
-        if (selected) {
-          if (max_output_boxes_per_class > 0 &&
-              static_cast<int64_t>(selected_indices_inside_class.size()) >= max_output_boxes_per_class) {
-            break;
-          }
-          selected_indices_inside_class.push_back(next_top_score.index_);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
-        }
-      }  //while
-    }    //for class_index
-  }      //for batch_index
+  concurrency::ThreadPool::TryParallelFor(ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_pairs),
+                                          TensorOpCost{static_cast<double>(num_boxes * sizeof(float)),
+                                                       static_cast<double>(num_boxes * sizeof(int64_t)),
+                                                       static_cast<double>(num_boxes * 16)},
+                                          select_boxes);
+
+  std::vector<SelectedIndex> selected_indices;
+  for (int64_t pair = 0; pair < num_pairs; ++pair) {
+    for (int64_t box_index : selected_per_pair[pair]) {
+      selected_indices.emplace_back(pair / pc.num_classes_, pair % pc.num_classes_, box_index);
+    }
+  }
 
   const auto last_dim = 3;
   const auto num_selected = selected_indices.size();
@@ -359,6 +359,162 @@ bool PrepareForReduce(const Tensor* input_tensor_ptr,
   return false;
 }
 
+// Computes the output dims of the reduction for the reduction kernels below, which reduce without transposing the
+// input when the reduced axes form a single group of adjacent dims once the dims with value 1 are ignored.
+// return value: true means the input can be viewed as [outer, reduced, inner] and reduced_dims are set.
+// false means the reduced axes are interleaved with kept axes and PrepareForReduce is needed.
+static bool PrepareForFastReduce(const TensorShape& input_shape,
+                                 const std::vector<int64_t>& axes_,
+                                 bool keepdims_,
+                                 /*out*/ std::vector<int64_t>& reduced_dims,
+                                 /*out*/ int64_t& outer,
+                                 /*out*/ int64_t& reduced,
+                                 /*out*/ int64_t& inner) {
+  const size_t ndim = input_shape.NumDimensions();
+  outer = reduced = inner = 1;
+
+  // Scalar tensor
+  if (ndim == 0) {
+    return true;
+  }
+
+  // the default case for non-arg kind reductions is to reduce on all dimensions
+  std::vector<bool> keep_axis(ndim, !axes_.empty());
+  for (int64_t axis : axes_) {
+    keep_axis[HandleNegativeAxis(axis, static_cast<int64_t>(ndim))] = false;
+  }
+
+  bool seen_reduced = false;
+  for (size_t i = 0; i < ndim; ++i) {
+    const int64_t dim = input_shape[i];
+    if (dim == 1) {
+      continue;
+    }
+
+    if (!keep_axis[i]) {
+      // a kept dim between two reduced dims
+      if (inner != 1) {
+        return false;
+      }
+      reduced *= dim;
+      seen_reduced = true;
+    } else if (seen_reduced) {
+      inner *= dim;
+    } else {
+      outer *= dim;
+    }
+  }
+
+  reduced_dims.reserve(ndim);
+  for (size_t i = 0; i < ndim; ++i) {
+    const int64_t dim = input_shape[i];
+    if (keep_axis[i]) {
+      reduced_dims.push_back(dim);
+    } else if (keepdims_) {
+      reduced_dims.push_back(dim == 0 ? 0 : 1);
+    } else {
+      // see PrepareForReduce for why a dim value of 0 can't be dropped
+      ORT_ENFORCE(dim != 0,
+                  "Can't reduce on dim with value of 0 if 'keepdims' is false. "
+                  "Invalid output shape would be produced. input_shape:",
+                  input_shape);
+    }
+  }
+
+  return true;
+}
+
+// The reductions supported by FastReduce. Reduce() reduces a contiguous vector, and Update() merges a vector into an
+// accumulator vector element-wise, both vectorized by Eigen.
+template <typename T>
+struct ReduceAggregatorSum {
+  static T Reduce(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).sum();
+  }
+  static void Update(T* accumulator, const T* data, int64_t size) {
+    EigenVectorMap<T>(accumulator, size) += ConstEigenVectorMap<T>(data, size);
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorMax {
+  static T Reduce(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).maxCoeff();
+  }
+  static void Update(T* accumulator, const T* data, int64_t size) {
+    EigenVectorMap<T> accumulator_vec(accumulator, size);
+    accumulator_vec = accumulator_vec.cwiseMax(ConstEigenVectorMap<T>(data, size));
+  }
+};
+
+// Reduces the `reduced` rows of `input`, `inner` elements apart, to the `size` elements of `output`.
+template <typename T, typename AGG>
+static void ReduceColumns(const T* input, T* output, int64_t reduced, int64_t inner, int64_t size) {
+  if (inner == 1) {
+    *output = AGG::Reduce(input, reduced);
+    return;
+  }
+
+  std::copy(input, input + size, output);
+  for (int64_t r = 1; r < reduced; ++r) {
+    AGG::Update(output, input + r * inner, size);
+  }
+}
+
+// Minimum number of input elements reduced by each part when the reduced dim is split across threads.
+static constexpr int64_t kFastReduceMinPartElements = 16 * 1024;
+
+// Reduces the input viewed as [outer, reduced, inner] to the output viewed as [outer, inner], which covers the
+// reduction of the innermost dims (inner == 1), of the outermost dims (outer == 1) and of the middle dims.
+// The threads split the output, unless it is too small to keep them busy, in which case the reduced dim is
+// split into parts whose partial results are combined by a second reduction.
+template <typename T, typename AGG>
+static void FastReduce(const T* input, T* output, int64_t outer, int64_t reduced, int64_t inner,
+                       concurrency::ThreadPool* tp) {
+  if (outer * inner == 0 || reduced == 0) {
+    return;
+  }
+
+  const int64_t num_threads = concurrency::ThreadPool::NumThreads(tp);
+  if (num_threads > 1 && outer * inner < num_threads * 16) {
+    const int64_t max_parts = std::min((num_threads + outer - 1) / outer,
+                                       reduced * inner / kFastReduceMinPartElements);
+    if (max_parts > 1) {
+      const int64_t part_size = (reduced + max_parts - 1) / max_parts;
+      const int64_t num_parts = (reduced + part_size - 1) / part_size;
+      std::vector<T> partials(static_cast<size_t>(outer * num_parts * inner));
+
+      concurrency::ThreadPool::TryParallelFor(
+          tp, outer * num_parts, static_cast<double>(part_size * inner),
+          [&](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t p = first; p < last; ++p) {
+              const int64_t o = p / num_parts;
+              const int64_t begin = (p % num_parts) * part_size;
+              const int64_t size = std::min(part_size, reduced - begin);
+              ReduceColumns<T, AGG>(input + (o * reduced + begin) * inner, partials.data() + p * inner,
+                                    size, inner, inner);
+            }
+          });
+
+      FastReduce<T, AGG>(partials.data(), output, outer, num_parts, inner, nullptr);
+      return;
+    }
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, outer * inner, static_cast<double>(reduced),
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        // split the range at the boundaries of the outer dim
+        while (first < last) {
+          const int64_t o = first / inner;
+          const int64_t i = first % inner;
+          const int64_t size = std::min<int64_t>(last - first, inner - i);
+          ReduceColumns<T, AGG>(input + o * reduced * inner + i, output + first, reduced, inner, size);
+          first += size;
+        }
+      });
+}
+
 template <typename T>
 Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
   FastAllocVector<T> transposed_input_data(GetAllocator<T>(*ctx));
@@ -487,6 +643,14 @@ Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
   std::vector<int64_t> reduced_dims;
   const Tensor* input = ctx->Input<Tensor>(0);
 
+  int64_t outer, reduced, inner;
+  if (PrepareForFastReduce(input->Shape(), axes_, keepdims_, reduced_dims, outer, reduced, inner)) {
+    Tensor* output = ctx->Output(0, reduced_dims);
+    FastReduce<T, ReduceAggregatorMax<T>>(input->template Data<T>(), output->template MutableData<T>(),
+                                          outer, reduced, inner, ctx->GetOperatorThreadPool());
+    return Status::OK();
+  }
+
   bool no_transpose = PrepareForReduce<T>(input, transposed_input_data, block_size, blocks, axes_, keepdims_, reduced_dims, true);
 
   Tensor* reduced = ctx->Output(0, reduced_dims);
@@ -515,6 +679,18 @@ Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
   std::vector<int64_t> reduced_dims;
   const Tensor* input = ctx->Input<Tensor>(0);
 
+  int64_t outer, reduced, inner;
+  if (PrepareForFastReduce(input->Shape(), axes_, keepdims_, reduced_dims, outer, reduced, inner)) {
+    Tensor* output = ctx->Output(0, reduced_dims);
+    T* output_data = output->template MutableData<T>();
+    FastReduce<T, ReduceAggregatorSum<T>>(input->template Data<T>(), output_data,
+                                          outer, reduced, inner, ctx->GetOperatorThreadPool());
+    if (reduced > 1) {
+      EigenVectorMap<T>(output_data, outer * inner) /= static_cast<T>(reduced);
+    }
+    return Status::OK();
+  }
+
   bool no_transpose = PrepareForReduce<T>(input, transposed_input_data, block_size, blocks, axes_, keepdims_, reduced_dims, true);
 
   Tensor* reduced = ctx->Output(0, reduced_dims);
@@ -617,6 +793,15 @@ Tensor ReduceSum<T>::Impl(const Tensor& input, const std::vector<int64_t>& reduc
   int64_t blocks;
   std::vector<int64_t> reduced_dims;
 
+  int64_t outer, reduced, inner;
+  if (PrepareForFastReduce(input_shape_override ? *input_shape_override : input.Shape(), reduce_axes, keep_dims,
+                           reduced_dims, outer, reduced, inner)) {
+    Tensor output(input.DataType(), reduced_dims, allocator);
+    FastReduce<T, ReduceAggregatorSum<T>>(input.template Data<T>(), output.template MutableData<T>(),
+                                          outer, reduced, inner, tp);
+    return output;
+  }
+
   bool no_transpose = PrepareForReduce<T>(&input, transposed_input_data, block_size, blocks,
                                           reduce_axes, keep_dims, reduced_dims, true, input_shape_override);
 
@@ -636,6 +821,14 @@ Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
   std::vector<int64_t> reduced_dims;
   const Tensor* input = ctx->Input<Tensor>(0);
 
+  int64_t outer, reduced, inner;
+  if (PrepareForFastReduce(input->Shape(), axes_, keepdims_, reduced_dims, outer, reduced, inner)) {
+    Tensor* output = ctx->Output(0, reduced_dims);
+    FastReduce<T, ReduceAggregatorSum<T>>(input->template Data<T>(), output->template MutableData<T>(),
+                                          outer, reduced, inner, ctx->GetOperatorThreadPool());
+    return Status::OK();
+  }
+
   bool no_transpose = PrepareForReduce<T>(input, transposed_input_data, block_size, blocks, axes_, keepdims_, reduced_dims, true);
 
   auto* output = ctx->Output(0, reduced_dims);
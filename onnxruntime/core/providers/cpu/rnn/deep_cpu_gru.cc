@@ -160,9 +160,10 @@ class UniDirectionalGru {
                     const ActivationFuncs::Entry& activation_func_g, float clip,
                     onnxruntime::concurrency::ThreadPool* ttp);
 
+  // recurrent_weightsZR and recurrent_weightsH are the R[zr] and Rh parts of the recurrence weights
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
-               gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weightsZR,
+               const GemmWeights<T>& recurrent_weightsH, gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   ~UniDirectionalGru() = default;
 
@@ -212,6 +213,12 @@ class UniDirectionalGru {
   gsl::span<T> inputs_reverse_;
   gsl::span<T> outputs_reverse_;
 
+  // scratch space of the GEMMs with quantized weights
+  IAllocatorUniquePtr<uint8_t> quantized_A_buffer_ptr_;
+  IAllocatorUniquePtr<T> quantized_C_buffer_ptr_;
+  gsl::span<uint8_t> quantized_A_buffer_;
+  gsl::span<T> quantized_C_buffer_;
+
   deepcpu::ClipWithBiasFuncPtr clip_with_bias_ptr_{};
 
   float zr_alpha_{};
@@ -238,12 +245,45 @@ class UniDirectionalGru {
 
 Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
+  const Tensor& W = *context->Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
+  const Tensor& R = *context->Input<Tensor>(2);  // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
+
+  // optional
+  const Tensor* B = context->Input<Tensor>(3);              // bias. [num_directions, 6*hidden_size]
+  const Tensor* sequence_lens = context->Input<Tensor>(4);  // [batch_size]
+  const Tensor* initial_h = context->Input<Tensor>(5);      // initial hidden. [num_directions, batch_size, hidden_size]
+
+  ORT_RETURN_IF_ERROR(ValidateInputs(X, W.Shape(), R.Shape(), B, sequence_lens, initial_h));
 
   Status status;
 
-  if (X.IsDataType<float>())
-    status = ComputeImpl<float>(*context);
-  else if (X.IsDataType<double>()) {
+  if (X.IsDataType<float>()) {
+    gsl::span<const float> input_weights = W.DataAsSpan<float>();
+    gsl::span<const float> recurrent_weights = R.DataAsSpan<float>();
+    const size_t input_weights_size_per_direction = input_weights.size() / num_directions_;
+    const size_t recurrent_weights_size_per_direction = recurrent_weights.size() / num_directions_;
+    const size_t recurrent_weightsZR_size = 2 * static_cast<size_t>(hidden_size_) * hidden_size_;
+    const size_t recurrent_weightsH_size = static_cast<size_t>(hidden_size_) * hidden_size_;
+
+    GemmWeights<float> W_weights[2];
+    GemmWeights<float> R_ZR_weights[2];
+    GemmWeights<float> R_H_weights[2];
+    for (int i = 0; i < num_directions_; ++i) {
+      gsl::span<const float> recurrent_weights_i = recurrent_weights.subspan(i * recurrent_weights_size_per_direction,
+                                                                             recurrent_weights_size_per_direction);
+      W_weights[i] = GemmWeights<float>(
+          input_weights.subspan(i * input_weights_size_per_direction, input_weights_size_per_direction),
+          packed_W_.empty() ? nullptr : packed_W_[i].get());
+      R_ZR_weights[i] = GemmWeights<float>(recurrent_weights_i.subspan(0, recurrent_weightsZR_size),
+                                           packed_R_.empty() ? nullptr : packed_R_[2 * i].get());
+      R_H_weights[i] = GemmWeights<float>(recurrent_weights_i.subspan(recurrent_weightsZR_size,
+                                                                      recurrent_weightsH_size),
+                                          packed_R_.empty() ? nullptr : packed_R_[2 * i + 1].get());
+    }
+
+    status = ComputeImpl<float>(*context, W_weights[0], W_weights[1], R_ZR_weights[0], R_ZR_weights[1],
+                                R_H_weights[0], R_H_weights[1]);
+  } else if (X.IsDataType<double>()) {
     /* Need to update all the helpers to support double...
     status = ComputeImpl<double>(*context); */
     ORT_NOT_IMPLEMENTED("GRU operator does not support double yet");
@@ -253,13 +293,23 @@ Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   return status;
 }
 
+Status GruBase::ValidateInputs(const Tensor& X,
+                               const TensorShape& W_shape,
+                               const TensorShape& R_shape,
+                               const Tensor* B,
+                               const Tensor* sequence_lens,
+                               const Tensor* initial_h) const {
+  return ValidateCommonRnnInputs(X, W_shape, R_shape, B, 3, sequence_lens, initial_h, num_directions_, hidden_size_);
+}
+
 template <typename T>
-Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
+Status GruBase::ComputeImpl(OpKernelContext& context,
+                            const GemmWeights<T>& W_1, const GemmWeights<T>& W_2,
+                            const GemmWeights<T>& R_ZR_1, const GemmWeights<T>& R_ZR_2,
+                            const GemmWeights<T>& R_H_1, const GemmWeights<T>& R_H_2) const {
   concurrency::ThreadPool* thread_pool = context.GetOperatorThreadPool();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
-  const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
-  const Tensor& R = *context.Input<Tensor>(2);  // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
 
   // optional
   const auto* B = context.Input<Tensor>(3);              // bias. [num_directions, 6*hidden_size]
@@ -272,9 +322,6 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   int batch_size = gsl::narrow<int>(X_shape[1]);
   int input_size = gsl::narrow<int>(X_shape[2]);
 
-  auto status = ValidateCommonRnnInputs(X, W, R, B, 3, sequence_lens, initial_h, num_directions_, hidden_size_);
-  ORT_RETURN_IF_ERROR(status);
-
   // GRU outputs are optional but must be in the same order
   TensorShape Y_dims{seq_length, num_directions_, batch_size, hidden_size_};
   Tensor* Y = context.Output(/*index*/ 0, Y_dims);
@@ -293,19 +340,12 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   }
 
   AllocatorPtr alloc;
-  status = context.GetTempSpaceAllocator(&alloc);
-  ORT_RETURN_IF_ERROR(status);
-  gsl::span<const T> input_weights = W.DataAsSpan<T>();
-  gsl::span<const T> recurrent_weights = R.DataAsSpan<T>();
+  ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
   gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
 
   // spans for first direction
-  const size_t input_weights_size_per_direction = 3 * hidden_size_ * input_size;
-  const size_t recurrent_weights_size_per_direction = 3 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 6 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, recurrent_weights_size_per_direction);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
   gsl::span<const T> input = X.DataAsSpan<T>();
@@ -340,10 +380,6 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> recurrent_weights_2 = recurrent_weights.subspan(recurrent_weights_size_per_direction,
-                                                                       recurrent_weights_size_per_direction);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
 
     gsl::span<const T> initial_hidden_2 = initial_hidden.empty()
@@ -362,24 +398,25 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1);
+    fw.Compute(input, sequence_lens_span, num_directions_, W_1, R_ZR_1, R_H_1, output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_, Direction::kReverse, bias_2, initial_hidden_2,
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
-               output_2, hidden_output_2);
+    bw.Compute(input, sequence_lens_span, num_directions_, W_2, R_ZR_2, R_H_2, output_2, hidden_output_2);
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_, direction_, bias_1, initial_hidden_1,
                                        activation_funcs_.Entries()[0],
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
-    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-                  output_1, hidden_output_1);
+    gru_p.Compute(input, sequence_lens_span, num_directions_, W_1, R_ZR_1, R_H_1, output_1, hidden_output_1);
+
+    ORT_UNUSED_PARAMETER(W_2);
+    ORT_UNUSED_PARAMETER(R_ZR_2);
+    ORT_UNUSED_PARAMETER(R_H_2);
   }
 
   if (!output.empty())
@@ -478,8 +515,9 @@ template <typename T>
 void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const gsl::span<const int>& sequence_lengths_arg,
                                    const int num_directions,
-                                   const gsl::span<const T>& input_weights,
-                                   const gsl::span<const T>& recurrent_weights,
+                                   const GemmWeights<T>& input_weights,
+                                   const GemmWeights<T>& recurrent_weightsZR,
+                                   const GemmWeights<T>& recurrent_weightsH,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -496,11 +534,6 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   }
 
   DumpMatrix("Inputs", inputs.data(), seq_length_ * batch_size_, input_size_);
-  DumpMatrix("input_weights", input_weights.data(), 3 * hidden_size_, input_size_);
-  DumpMatrix("recurrent_weights", recurrent_weights.data(), 3 * hidden_size_, hidden_size_);
-
-  gsl::span<const T> recurrent_weightsZR = recurrent_weights.subspan(0, 2 * hidden_size_ * hidden_size_);
-  gsl::span<const T> recurrent_weightsH = recurrent_weights.subspan(2 * hidden_size_ * hidden_size_, hidden_size_ * hidden_size_);
 
   gsl::span<T> original_outputs = outputs;
   const bool output_sequence = !outputs.empty();
@@ -527,14 +560,21 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
 
   float alpha = 1.0f;
 
+  // the GEMMs with quantized weights need space for their quantized A, which is either the inputs or a
+  // batch_size_ x hidden_size_ matrix of a step, and for the product of a step before it is added to outputZRH_
+  if (input_weights.quantized || recurrent_weightsZR.quantized || recurrent_weightsH.quantized) {
+    quantized_A_buffer_ = Allocate(allocator_, std::max(total_rows * input_size_, batch_size_ * hidden_size_),
+                                   quantized_A_buffer_ptr_);
+    quantized_C_buffer_ = Allocate(allocator_, batch_size_ * hidden_size_x2, quantized_C_buffer_ptr_);
+  }
+
   // apply weights to all the inputs
   ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
               input_size_,
-              input_weights.cbegin(), input_weights.cend(),
-              input_size_, 0.f,
+              input_weights, 0.f,
               outputZRH_.begin(), outputZRH_.end(),
-              hidden_size_x3, ttp_);
+              hidden_size_x3, quantized_A_buffer_, quantized_C_buffer_, ttp_);
 
   DumpMatrix("inputs with weights applied", outputZRH_.data(), seq_length_ * batch_size_ * 3, hidden_size_);
 
@@ -594,10 +634,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
     ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
                 prev_Ht, prev_Ht_end,
                 hidden_size_,
-                recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
-                hidden_size_, 1.f,  // beta == 1 so we add existing values in outputZRH_
+                recurrent_weightsZR, 1.f,  // beta == 1 so we add existing values in outputZRH_
                 outputZRH_.begin() + out_added_offset, outputZRH_.end(),
-                hidden_size_x3, ttp_);
+                hidden_size_x3, quantized_A_buffer_, quantized_C_buffer_, ttp_);
 
     DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
                outputZRH_.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
@@ -614,12 +653,11 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   prev_Ht, prev_Ht_end,  // Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_,
+                  recurrent_weightsH,     // Rh^T
                   use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
                   linear_output_.begin(),
                   linear_output_.end(),  // pre: Rbh if use_bias_, post:output
-                  hidden_size_, ttp_);
+                  hidden_size_, quantized_A_buffer_, quantized_C_buffer_, ttp_);
 
       DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
     }
@@ -687,10 +725,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   cur_h_local, cur_h_local_end,  // rt (.) Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, 1.f,                                       // beta == 1 to add Xt*(Wh^T) from out_H
+                  recurrent_weightsH, 1.f,  // Rh^T. beta == 1 to add Xt*(Wh^T) from out_H
                   out_H, outputZRH_.end(),
-                  hidden_size_x3, ttp_);
+                  hidden_size_x3, quantized_A_buffer_, quantized_C_buffer_, ttp_);
     }
 
     DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, outputZRH_.data() + out_added_offset,
@@ -842,4 +879,10 @@ void UniDirectionalGru<T>::AllocateBuffers() {
 }
 
 }  // namespace detail
+
+template Status GruBase::ComputeImpl<float>(OpKernelContext& context,
+                                            const GemmWeights<float>& W_1, const GemmWeights<float>& W_2,
+                                            const GemmWeights<float>& R_ZR_1, const GemmWeights<float>& R_ZR_2,
+                                            const GemmWeights<float>& R_H_1, const GemmWeights<float>& R_H_2) const;
+
 }  // namespace onnxruntime
@@ -6,15 +6,16 @@
 #include <limits>
 
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/gemm_packing_helper.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
 
 namespace onnxruntime {
 
-/// The class represents GRU operator using DeepCPU implementation for
-/// fast inference computation on CPU machines.
-class DeepCpuGruOp final : public OpKernel {
- public:
-  DeepCpuGruOp(const OpKernelInfo& info) : OpKernel(info) {
+/// The base of the DeepCPU implementations of a GRU operator with float or quantized weights. It reads the GRU
+/// attributes and runs the recurrence given the weights of each direction.
+class GruBase {
+ protected:
+  GruBase(const OpKernelInfo& info) {
     // required attributes
     std::string direction;
     ORT_ENFORCE(info.GetAttr("direction", &direction).IsOK());
@@ -51,11 +52,26 @@ class DeepCpuGruOp final : public OpKernel {
                                                      activation_func_betas);
   }
 
-  Status Compute(OpKernelContext* context) const override;
+  ~GruBase() = default;
 
-  ~DeepCpuGruOp() override = default;
+  // Computes the outputs with the input weights W, and the R[zr] and Rh parts of the recurrence weights R, of each
+  // direction. The weights of the second direction are unused unless the GRU is bidirectional.
+  // The shapes of W and R must have been validated.
+  template <typename T>
+  Status ComputeImpl(OpKernelContext& context,
+                     const rnn::detail::GemmWeights<T>& W_1, const rnn::detail::GemmWeights<T>& W_2,
+                     const rnn::detail::GemmWeights<T>& R_ZR_1, const rnn::detail::GemmWeights<T>& R_ZR_2,
+                     const rnn::detail::GemmWeights<T>& R_H_1, const rnn::detail::GemmWeights<T>& R_H_2) const;
+
+  // W_shape and R_shape are the shapes of float weights: [num_directions, 3*hidden_size, input_size] and
+  // [num_directions, 3*hidden_size, hidden_size]
+  Status ValidateInputs(const Tensor& X,
+                        const TensorShape& W_shape,
+                        const TensorShape& R_shape,
+                        const Tensor* B,
+                        const Tensor* sequence_lens,
+                        const Tensor* initial_h) const;
 
- private:
   rnn::detail::Direction direction_;
   int num_directions_;
 
@@ -64,9 +80,28 @@ class DeepCpuGruOp final : public OpKernel {
   int linear_before_reset_ {};
 
   rnn::detail::ActivationFuncs activation_funcs_;
+};
 
-  template <typename T>
-  Status ComputeImpl(OpKernelContext& context) const;
+/// The class represents GRU operator using DeepCPU implementation for
+/// fast inference computation on CPU machines.
+class DeepCpuGruOp final : public OpKernel, public GruBase {
+ public:
+  DeepCpuGruOp(const OpKernelInfo& info) : OpKernel(info), GruBase(info) {
+    // pack the constant W and R of each direction, which are applied as Xt*(W[zrh]^T), Ht-1*(R[zr]^T) and
+    // (rt (.) Ht-1)*(Rh^T) or Ht-1*(Rh^T), so R[zr] and Rh are packed separately
+    TryPackBatchedSgemmWeights(info, 1, true, {}, packed_W_);
+    TryPackBatchedSgemmWeights(info, 2, true, {2 * static_cast<size_t>(hidden_size_),
+                                               static_cast<size_t>(hidden_size_)}, packed_R_);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+  ~DeepCpuGruOp() override = default;
+
+ private:
+  // W of each direction, and R[zr] and Rh of each direction, packed for MlasGemm, or empty if they are not constant
+  std::vector<std::shared_ptr<void>> packed_W_;
+  std::vector<std::shared_ptr<void>> packed_R_;
 };
 
 }  // namespace onnxruntime
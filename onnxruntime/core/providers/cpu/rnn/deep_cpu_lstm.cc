@@ -211,7 +211,7 @@ class UniDirectionalLstm {
                      const ActivationFuncs::Entry& activation_func_h, float clip, concurrency::ThreadPool* thread_pool);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weights,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state);
 
   ~UniDirectionalLstm() = default;
@@ -279,6 +279,12 @@ class UniDirectionalLstm {
   IAllocatorUniquePtr<int> sequence_lengths_ptr_;
   gsl::span<int> sequence_lengths_;
 
+  // scratch space of the GEMMs with quantized weights
+  IAllocatorUniquePtr<uint8_t> quantized_A_buffer_ptr_;
+  IAllocatorUniquePtr<T> quantized_C_buffer_ptr_;
+  gsl::span<uint8_t> quantized_A_buffer_;
+  gsl::span<T> quantized_C_buffer_;
+
   deepcpu::ClipWithBiasFuncPtr clip_with_bias_ptr_;
 
   ActivationInfo<deepcpu::ActivationFuncPtr> activation_f_;
@@ -292,13 +298,36 @@ class UniDirectionalLstm {
 
 Status DeepCpuLstmOp::Compute(OpKernelContext* context) const {
   const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
+  const Tensor& W = *context->Input<Tensor>(1);  // weights. [num_directions, 4*hidden_size, input_size]
+  const Tensor& R = *context->Input<Tensor>(2);  // recurrence weights. [num_directions, 4*hidden_size, hidden_size]
 
   Status status;
   // auto& logger = context->Logger();
 
-  if (X.IsDataType<float>())
-    status = ComputeImpl<float>(*context);
-  else if (X.IsDataType<double>()) {
+  if (X.IsDataType<float>()) {
+    ORT_RETURN_IF_ERROR(ValidateInputs(X, W.Shape(), R.Shape(), context->Input<Tensor>(3), context->Input<Tensor>(4),
+                                       context->Input<Tensor>(5), context->Input<Tensor>(6),
+                                       context->Input<Tensor>(7), gsl::narrow<int>(X.Shape()[1])));
+
+    gsl::span<const float> input_weights = W.DataAsSpan<float>();
+    gsl::span<const float> recurrent_weights = R.DataAsSpan<float>();
+    const size_t input_weights_size_per_direction = input_weights.size() / num_directions_;
+    const size_t recurrent_weights_size_per_direction = recurrent_weights.size() / num_directions_;
+
+    // the weights of each direction
+    GemmWeights<float> W_weights[2];
+    GemmWeights<float> R_weights[2];
+    for (int i = 0; i < num_directions_; ++i) {
+      W_weights[i] = GemmWeights<float>(
+          input_weights.subspan(i * input_weights_size_per_direction, input_weights_size_per_direction),
+          packed_W_.empty() ? nullptr : packed_W_[i].get());
+      R_weights[i] = GemmWeights<float>(
+          recurrent_weights.subspan(i * recurrent_weights_size_per_direction, recurrent_weights_size_per_direction),
+          packed_R_.empty() ? nullptr : packed_R_[i].get());
+    }
+
+    status = ComputeImpl<float>(*context, W_weights[0], W_weights[1], R_weights[0], R_weights[1]);
+  } else if (X.IsDataType<double>()) {
     /* Need to update all the helpers to support double...
     status = ComputeImpl<double>(*context); */
     ORT_NOT_IMPLEMENTED("LSTM operator does not support double yet");
@@ -316,14 +345,14 @@ Status DeepCpuLstmOp::Compute(OpKernelContext* context) const {
 #endif
 
 template <typename T>
-Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
+Status LstmBase::ComputeImpl(OpKernelContext& context,
+                             const GemmWeights<T>& W_1, const GemmWeights<T>& W_2,
+                             const GemmWeights<T>& R_1, const GemmWeights<T>& R_2) const {
   concurrency::ThreadPool* thread_pool = context.GetOperatorThreadPool();
 
   auto& logger = context.Logger();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
-  const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 4*hidden_size, input_size]
-  const Tensor& R = *context.Input<Tensor>(2);  // recurrence weights. [num_directions, 4*hidden_size, hidden_size]
 
   // optional
   const Tensor* B = context.Input<Tensor>(3);              // bias. [num_directions, 8*hidden_size]
@@ -338,9 +367,6 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   int batch_size = gsl::narrow<int>(X_shape[1]);
   int input_size = gsl::narrow<int>(X_shape[2]);
 
-  Status status = ValidateInputs(X, W, R, B, sequence_lens, initial_h, initial_c, P, batch_size);
-  ORT_RETURN_IF_ERROR(status);
-
   // LSTM outputs are optional but must be in the same order
   TensorShape Y_dims{seq_length, num_directions_, batch_size, hidden_size_};
   Tensor* Y = context.Output(/*index*/ 0, Y_dims);
@@ -367,22 +393,15 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   }
 
   AllocatorPtr alloc;
-  status = context.GetTempSpaceAllocator(&alloc);
-  ORT_RETURN_IF_ERROR(status);
+  ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
 
-  gsl::span<const T> input_weights = W.DataAsSpan<T>();
-  gsl::span<const T> recurrent_weights = R.DataAsSpan<T>();
   gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
   gsl::span<const T> peephole_weights = P != nullptr ? P->DataAsSpan<T>() : gsl::span<const T>();
 
   // spans for first direction
-  const size_t input_weights_size_per_direction = 4 * hidden_size_ * input_size;
-  const size_t hidden_weights_size_per_direction = 4 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 8 * hidden_size_;
   const size_t peephole_weights_size_per_direction = 3 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, hidden_weights_size_per_direction);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
   gsl::span<const T> peephole_weights_1 =
       peephole_weights.empty() ? peephole_weights : peephole_weights.subspan(0, peephole_weights_size_per_direction);
@@ -428,10 +447,6 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 =
-        input_weights.subspan(input_weights_size_per_direction, input_weights_size_per_direction);
-    gsl::span<const T> hidden_weights_2 =
-        recurrent_weights.subspan(hidden_weights_size_per_direction, hidden_weights_size_per_direction);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
     gsl::span<const T> peephole_weights_2 =
         peephole_weights.empty() ? peephole_weights : peephole_weights.subspan(peephole_weights_size_per_direction, peephole_weights_size_per_direction);
@@ -457,18 +472,17 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      initial_cell_2, activation_funcs_.Entries()[3], activation_funcs_.Entries()[4],
                                      activation_funcs_.Entries()[5], clip_, thread_pool);
 
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1,
-               hidden_output_1, last_cell_1);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2, output_2, hidden_output_2,
-               last_cell_2);
+    fw.Compute(input, sequence_lens_span, num_directions_, W_1, R_1, output_1, hidden_output_1, last_cell_1);
+    bw.Compute(input, sequence_lens_span, num_directions_, W_2, R_2, output_2, hidden_output_2, last_cell_2);
   } else {
     detail::UniDirectionalLstm<T> fw(alloc, logger, seq_length, batch_size, input_size, hidden_size_, direction_,
                                      input_forget_, bias_1, peephole_weights_1, initial_hidden_1, initial_cell_1,
                                      activation_funcs_.Entries()[0], activation_funcs_.Entries()[1],
                                      activation_funcs_.Entries()[2], clip_, thread_pool);
 
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1,
-               hidden_output_1, last_cell_1);
+    ORT_UNUSED_PARAMETER(W_2);
+    ORT_UNUSED_PARAMETER(R_2);
+    fw.Compute(input, sequence_lens_span, num_directions_, W_1, R_1, output_1, hidden_output_1, last_cell_1);
   }
 
   if (!output.empty())
@@ -481,11 +495,11 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   return Status::OK();
 }
 
-Status DeepCpuLstmOp::ValidateInputs(const Tensor& X, const Tensor& W, const Tensor& R, const Tensor* B,
-                                     const Tensor* sequence_lens, const Tensor* initial_h, const Tensor* initial_c,
-                                     const Tensor* P, int batch_size) const {
-  auto status =
-      rnn::detail::ValidateCommonRnnInputs(X, W, R, B, 4, sequence_lens, initial_h, num_directions_, hidden_size_);
+Status LstmBase::ValidateInputs(const Tensor& X, const TensorShape& W_shape, const TensorShape& R_shape,
+                                const Tensor* B, const Tensor* sequence_lens, const Tensor* initial_h,
+                                const Tensor* initial_c, const Tensor* P, int batch_size) const {
+  auto status = rnn::detail::ValidateCommonRnnInputs(X, W_shape, R_shape, B, 4, sequence_lens, initial_h,
+                                                     num_directions_, hidden_size_);
   ORT_RETURN_IF_ERROR(status);
 
   if (initial_c != nullptr) {
@@ -680,9 +694,10 @@ void UniDirectionalLstm<T>::LoadBias(const gsl::span<const T>& WbRb_values) {
 template <typename T>
 void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                                     const gsl::span<const int>& sequence_lengths_arg, const int num_directions,
-                                    const gsl::span<const T>& input_weights,
-                                    const gsl::span<const T>& recurrent_weights, gsl::span<T>& outputs,
-                                    gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state) {
+                                    const GemmWeights<T>& input_weights,
+                                    const GemmWeights<T>& recurrent_weights,
+                                    gsl::span<T>& outputs, gsl::span<T>& final_hidden_state,
+                                    gsl::span<T>& final_cell_state) {
   // copy spans (just T* and size, not data in span) as we may change them
   gsl::span<const T> inputs = inputs_arg;
   gsl::span<const int> sequence_lengths = sequence_lengths_arg;
@@ -735,10 +750,19 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
   const int hidden_size_x4 = 4 * hidden_size_;
   const int total_rows = max_sequence_length * batch_size_;
 
+  // the GEMMs with quantized weights need space for their quantized A, which is either the inputs or the hidden
+  // state of a step, and for the product of a step before it is added to output_IOFC
+  if (input_weights.quantized || recurrent_weights.quantized) {
+    quantized_A_buffer_ = Allocate(allocator_, std::max(total_rows * input_size_, batch_size_ * hidden_size_),
+                                   quantized_A_buffer_ptr_);
+    quantized_C_buffer_ = Allocate(allocator_, batch_size_ * hidden_size_x4, quantized_C_buffer_ptr_);
+  }
+
   // apply the weights to all the inputs and save to output_IOFC
   ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha, inputs.cbegin(), inputs.cend(), input_size_,
-              input_weights.cbegin(), input_weights.cend(),  // W[iofc]
-              input_size_, beta, output_iofc_.begin(), output_iofc_.end(), hidden_size_x4, thread_pool_);
+              input_weights,  // W[iofc]
+              beta, output_iofc_.begin(), output_iofc_.end(), hidden_size_x4,
+              quantized_A_buffer_, quantized_C_buffer_, thread_pool_);
 
   DumpMatrix("Xt*(W[iofc]^T)", output_iofc_.data(), total_rows, hidden_size_x4);
 
@@ -765,6 +789,16 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       if ((row + fused_hidden_rows) > batch_size_)
         local_fused_hidden_rows = batch_size_ - row;
 
+      // the quantization buffers of the rows
+      gsl::span<uint8_t> quantized_A_buffer =
+          quantized_A_buffer_.empty() ? quantized_A_buffer_
+                                      : quantized_A_buffer_.subspan(row * hidden_size_,
+                                                                    local_fused_hidden_rows * hidden_size_);
+      gsl::span<T> quantized_C_buffer =
+          quantized_C_buffer_.empty() ? quantized_C_buffer_
+                                      : quantized_C_buffer_.subspan(row * hidden_size_x4,
+                                                                    local_fused_hidden_rows * hidden_size_x4);
+
       // these are all batch * hidden_size_ and get updated in-place when running GateComputations so non-const iters
       span_T_iter c_prev = batched_internal_state_prev_one_step.begin() + row * hidden_size_;
       span_T_iter c_prev_clipped = batched_internal_state_clipped_one_step.begin() + row * hidden_size_;
@@ -784,10 +818,10 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
         // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
         // Do it sequentially to avoid nested parallelism
         ComputeGemm(local_fused_hidden_rows, hidden_size_x4, hidden_size_, alpha, previous_state,
-                    previous_state_end,                                                  // Ht-1
-                    hidden_size_, recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                    hidden_size_, beta, step_out_IOFC, output_iofc_.end(),               // input contains Xt*(W[iofc]^T)
-                    hidden_size_x4, nullptr);
+                    previous_state_end,                       // Ht-1
+                    hidden_size_, recurrent_weights,          // R[iofc]
+                    beta, step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                    hidden_size_x4, quantized_A_buffer, quantized_C_buffer, nullptr);
 
         DumpMatrix("Xt*(W[iofc]^T) + Ht-t*R[iofc]" + row_str, &*step_out_IOFC, local_fused_hidden_rows, hidden_size_x4);
 
@@ -841,6 +875,9 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
     ExecuteLambdaInParallel(hidden_gemm_and_activations, batch_size_, fused_hidden_rows, cost, thread_pool_);
 
   } else {
+    // each step runs a small parallel gemm, so keep the threads engaged across the steps
+    concurrency::ThreadPool::ParallelSection parallel_section(thread_pool_);
+
     span_T_const_iter previous_state_end = batched_hidden_state_one_step.cend();
 
     span_T_iter c_prev = batched_internal_state_prev_one_step.begin();
@@ -862,9 +899,9 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
 
       // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
       ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, alpha, previous_state, previous_state_end,  // Ht-1
-                  hidden_size_, recurrent_weights.cbegin(), recurrent_weights.cend(),                    // R[iofc]
-                  hidden_size_, beta, step_out_IOFC, output_iofc_.end(),                                 // input contains Xt*(W[iofc]^T)
-                  hidden_size_x4, thread_pool_);
+                  hidden_size_, recurrent_weights,                                                       // R[iofc]
+                  beta, step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                  hidden_size_x4, quantized_A_buffer_, quantized_C_buffer_, thread_pool_);
 
       span_T_iter batched_output;
       span_T_iter batched_output_end;
@@ -1089,4 +1126,10 @@ void UniDirectionalLstm<T>::SetNumThreads() {
 }
 
 }  // namespace detail
+
+// used by the LSTM operators with quantized weights
+template Status LstmBase::ComputeImpl<float>(OpKernelContext& context,
+                                             const GemmWeights<float>& W_1, const GemmWeights<float>& W_2,
+                                             const GemmWeights<float>& R_1, const GemmWeights<float>& R_2) const;
+
 }  // namespace onnxruntime
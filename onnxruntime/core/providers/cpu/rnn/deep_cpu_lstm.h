@@ -6,16 +6,18 @@
 #include <limits>
 
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/gemm_packing_helper.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
 
 namespace onnxruntime {
 
-/// The class represents DeepCPU implementation of a long short term memory (LSTM) operator.
+/// The base of the DeepCPU implementations of a long short term memory (LSTM) operator with float or
+/// quantized weights. It reads the LSTM attributes and runs the recurrence given the weights of each direction.
 /// For details, refer to http://aka.ms/dl-optimization/.
-class DeepCpuLstmOp final : public OpKernel {
- public:
-  DeepCpuLstmOp(const OpKernelInfo& info)
-      : OpKernel(info), clip_(info.GetAttrOrDefault<float>("clip", std::numeric_limits<float>::max())) {
+class LstmBase {
+ protected:
+  LstmBase(const OpKernelInfo& info)
+      : clip_(info.GetAttrOrDefault<float>("clip", std::numeric_limits<float>::max())) {
     std::string direction;
     ORT_ENFORCE(info.GetAttr("direction", &direction).IsOK());
 
@@ -50,17 +52,20 @@ class DeepCpuLstmOp final : public OpKernel {
                                                      activation_func_betas);
   }
 
-  Status Compute(OpKernelContext* context) const override;
-
-  ~DeepCpuLstmOp() override = default;
+  ~LstmBase() = default;
 
- private:
+  // Computes the outputs with the input weights W and recurrence weights R of each direction. W_2 and R_2 are unused
+  // unless the LSTM is bidirectional. The shapes of W and R must have been validated.
   template <typename T>
-  Status ComputeImpl(OpKernelContext& context) const;
+  Status ComputeImpl(OpKernelContext& context,
+                     const rnn::detail::GemmWeights<T>& W_1, const rnn::detail::GemmWeights<T>& W_2,
+                     const rnn::detail::GemmWeights<T>& R_1, const rnn::detail::GemmWeights<T>& R_2) const;
 
+  // W_shape and R_shape are the shapes of float weights: [num_directions, 4*hidden_size, input_size] and
+  // [num_directions, 4*hidden_size, hidden_size]
   Status ValidateInputs(const Tensor& X,
-                        const Tensor& W,
-                        const Tensor& R,
+                        const TensorShape& W_shape,
+                        const TensorShape& R_shape,
                         const Tensor* B,
                         const Tensor* sequence_lens,
                         const Tensor* initial_h,
@@ -76,7 +81,25 @@ class DeepCpuLstmOp final : public OpKernel {
   bool input_forget_ = false;
 
   rnn::detail::ActivationFuncs activation_funcs_;
+};
+
+/// The class represents DeepCPU implementation of a long short term memory (LSTM) operator.
+class DeepCpuLstmOp final : public OpKernel, public LstmBase {
+ public:
+  DeepCpuLstmOp(const OpKernelInfo& info) : OpKernel(info), LstmBase(info) {
+    // pack the constant W and R of each direction, which are applied as Xt*(W[iofc]^T) and Ht-1*(R[iofc]^T)
+    TryPackBatchedSgemmWeights(info, 1, true, {}, packed_W_);
+    TryPackBatchedSgemmWeights(info, 2, true, {}, packed_R_);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+  ~DeepCpuLstmOp() override = default;
 
+ private:
+  // W and R of each direction packed for MlasGemm, or empty if they are not constant
+  std::vector<std::shared_ptr<void>> packed_W_;
+  std::vector<std::shared_ptr<void>> packed_R_;
 };
 
 }  // namespace onnxruntime
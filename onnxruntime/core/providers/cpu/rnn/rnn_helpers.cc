@@ -13,9 +13,11 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/rnn/rnn_activation_functors.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 
 namespace onnxruntime {
 namespace rnn {
@@ -24,8 +26,8 @@ namespace detail {
 using namespace ::onnxruntime::common;
 
 Status ValidateCommonRnnInputs(const Tensor& X,
-                               const Tensor& W,
-                               const Tensor& R,
+                               const TensorShape& W_shape,
+                               const TensorShape& R_shape,
                                const Tensor* B,
                                int WRB_dim_1_multipler,
                                const Tensor* sequence_lens,
@@ -33,8 +35,6 @@ Status ValidateCommonRnnInputs(const Tensor& X,
                                int64_t num_directions,
                                int64_t hidden_size) {
   auto& X_shape = X.Shape();
-  auto& W_shape = W.Shape();
-  auto& R_shape = R.Shape();
 
   int64_t seq_length = X_shape[0];
   int64_t batch_size = X_shape[1];
@@ -188,6 +188,38 @@ ActivationFuncs::ActivationFuncs(const std::vector<std::string>& funcs,
   }
 }
 
+void ComputeQuantizedGemm(int M, int N, int K, float alpha, const float* A, const GemmWeights<float>& B, float beta,
+                          float* C, int ldc, gsl::span<uint8_t> quantized_A, gsl::span<float> product,
+                          concurrency::ThreadPool* tp) {
+  const size_t A_size = static_cast<size_t>(M) * K;
+  ORT_ENFORCE(A_size <= static_cast<size_t>(quantized_A.size()));
+
+  float A_scale;
+  uint8_t A_zero_point;
+  GetQuantizationParameter(A, A_size, A_scale, A_zero_point);
+  MlasQuantizeLinear(A, quantized_A.data(), A_size, A_scale, A_zero_point);
+
+  const float multiplier = alpha * A_scale * B.scale;
+
+  if (beta == 0.f) {
+    QGemm(M, N, K, quantized_A.data(), K, A_zero_point, B.quantized_weights, B.quantized_ldb, B.zero_point,
+          B.quantized_is_signed, C, ldc, &multiplier, nullptr, tp);
+    return;
+  }
+
+  ORT_ENFORCE(static_cast<size_t>(M) * N <= static_cast<size_t>(product.size()));
+  QGemm(M, N, K, quantized_A.data(), K, A_zero_point, B.quantized_weights, B.quantized_ldb, B.zero_point,
+        B.quantized_is_signed, product.data(), N, &multiplier, nullptr, tp);
+
+  for (int m = 0; m < M; ++m) {
+    float* C_row = C + m * ldc;
+    const float* product_row = product.data() + m * N;
+    for (int n = 0; n < N; ++n) {
+      C_row[n] = beta * C_row[n] + product_row[n];
+    }
+  }
+}
+
 void DumpMatrixImpl(const std::string& name, const float* src, int row, int col, int offset, int col_width) {
   std::cout << "Dump matrix: " << name << std::endl;
 
@@ -205,62 +237,6 @@ void DumpMatrixImpl(const std::string& name, const float* src, int row, int col,
 
 namespace deepcpu {
 
-const float alpha_1 = 4.89352455891786e-03f;
-const float alpha_3 = 6.37261928875436e-04f;
-const float alpha_5 = 1.48572235717979e-05f;
-const float alpha_7 = 5.12229709037114e-08f;
-const float alpha_9 = -8.60467152213735e-11f;
-const float alpha_11 = 2.00018790482477e-13f;
-const float alpha_13 = -2.76076847742355e-16f;
-
-const float beta_0 = 4.89352518554385e-03f;
-const float beta_2 = 2.26843463243900e-03f;
-const float beta_4 = 1.18534705686654e-04f;
-const float beta_6 = 1.19825839466702e-06f;
-
-const float sigmoid_bound = 20.0f;
-const float tanh_bound = 10.0f;
-
-inline void clip_for_sigmoid_in_place(float* ps, int c) {
-  for (int i = 0; i < c; i++) {
-    if (ps[i] < -sigmoid_bound)
-      ps[i] = -sigmoid_bound;
-    else if (ps[i] > sigmoid_bound)
-      ps[i] = sigmoid_bound;
-  }
-}
-
-inline void clip_for_tanh_in_place(float* ps, int c) {
-  for (int i = 0; i < c; i++) {
-    if (ps[i] < -tanh_bound)
-      ps[i] = -tanh_bound;
-    else if (ps[i] > tanh_bound)
-      ps[i] = tanh_bound;
-  }
-}
-
-inline void clip_for_sigmoid(const float* ps, float* pd, int c) {
-  for (int i = 0; i < c; i++) {
-    if (ps[i] < -sigmoid_bound)
-      pd[i] = -sigmoid_bound;
-    else if (ps[i] > sigmoid_bound)
-      pd[i] = sigmoid_bound;
-    else
-      pd[i] = ps[i];
-  }
-}
-
-inline void clip_for_tanh(const float* ps, float* pd, int c) {
-  for (int i = 0; i < c; i++) {
-    if (ps[i] < -tanh_bound)
-      pd[i] = -tanh_bound;
-    else if (ps[i] > tanh_bound)
-      pd[i] = tanh_bound;
-    else
-      pd[i] = ps[i];
-  }
-}
-
 void add_bias_into_ignore(const float* ps, const float* pd, int c) {
   ORT_UNUSED_PARAMETER(ps);
   ORT_UNUSED_PARAMETER(pd);
@@ -314,22 +290,10 @@ void sigmoid_m(const float* ps1, float* ps1_c, const float* ps2, float* pd, int
   ORT_UNUSED_PARAMETER(alpha);
   ORT_UNUSED_PARAMETER(beta);
 
-  clip_for_sigmoid(ps1, ps1_c, c);
+  MlasComputeLogistic(ps1, ps1_c, c);
 
   for (int i = 0; i < c; i++) {
-    float x = 0.5f * ps1_c[i];
-    float x2 = x * x;
-    float p = x2 * alpha_13 + alpha_11;
-    p = x2 * p + alpha_9;
-    p = x2 * p + alpha_7;
-    p = x2 * p + alpha_5;
-    p = x2 * p + alpha_3;
-    p = x2 * p + alpha_1;
-    p = x * p;
-    float q = x2 * beta_6 + beta_4;
-    q = x2 * q + beta_2;
-    q = x2 * q + beta_0;
-    pd[i] = ps2[i] * 0.5f * (1 + (p / q));
+    pd[i] = ps2[i] * ps1_c[i];
   }
 }
 
@@ -338,22 +302,10 @@ void tanh_m(const float* ps1, float* ps1_c, const float* ps2, float* pd, int c,
   ORT_UNUSED_PARAMETER(alpha);
   ORT_UNUSED_PARAMETER(beta);
 
-  clip_for_tanh(ps1, ps1_c, c);
+  MlasComputeTanh(ps1, ps1_c, c);
 
   for (int i = 0; i < c; i++) {
-    float x = ps1_c[i];
-    float x2 = x * x;
-    float p = x2 * alpha_13 + alpha_11;
-    p = x2 * p + alpha_9;
-    p = x2 * p + alpha_7;
-    p = x2 * p + alpha_5;
-    p = x2 * p + alpha_3;
-    p = x2 * p + alpha_1;
-    p = x * p;
-    float q = x2 * beta_6 + beta_4;
-    q = x2 * q + beta_2;
-    q = x2 * q + beta_0;
-    pd[i] = ps2[i] * p / q;
+    pd[i] = ps2[i] * ps1_c[i];
   }
 }
 
@@ -402,46 +354,14 @@ void sigmoid(float* pd, int c, float alpha, float beta) {
   ORT_UNUSED_PARAMETER(alpha);
   ORT_UNUSED_PARAMETER(beta);
 
-  clip_for_sigmoid_in_place(pd, c);
-
-  for (int i = 0; i < c; i++) {
-    float x = 0.5f * pd[i];
-    float x2 = x * x;
-    float p = x2 * alpha_13 + alpha_11;
-    p = x2 * p + alpha_9;
-    p = x2 * p + alpha_7;
-    p = x2 * p + alpha_5;
-    p = x2 * p + alpha_3;
-    p = x2 * p + alpha_1;
-    p = x * p;
-    float q = x2 * beta_6 + beta_4;
-    q = x2 * q + beta_2;
-    q = x2 * q + beta_0;
-    pd[i] = 0.5f * (1 + (p / q));
-  }
+  MlasComputeLogistic(pd, pd, c);
 }
 
 void tanh(float* pd, int c, float alpha, float beta) {
   ORT_UNUSED_PARAMETER(alpha);
   ORT_UNUSED_PARAMETER(beta);
 
-  clip_for_tanh_in_place(pd, c);
-
-  for (int i = 0; i < c; i++) {
-    float x = pd[i];
-    float x2 = x * x;
-    float p = x2 * alpha_13 + alpha_11;
-    p = x2 * p + alpha_9;
-    p = x2 * p + alpha_7;
-    p = x2 * p + alpha_5;
-    p = x2 * p + alpha_3;
-    p = x2 * p + alpha_1;
-    p = x * p;
-    float q = x2 * beta_6 + beta_4;
-    q = x2 * q + beta_2;
-    q = x2 * q + beta_0;
-    pd[i] = p / q;
-  }
+  MlasComputeTanh(pd, pd, c);
 }
 
 void relu(float* pd, int c, float alpha, float beta) {
@@ -485,22 +405,10 @@ void gru_reset_gate_tanh(const float* ps1, float* ps2, float* pd, int c, float a
   ORT_UNUSED_PARAMETER(alpha);
   ORT_UNUSED_PARAMETER(beta);
 
-  clip_for_tanh_in_place(ps2, c);
+  MlasComputeTanh(ps2, ps2, c);
 
   for (int i = 0; i < c; i++) {
-    float x = ps2[i];
-    float x2 = x * x;
-    float p = x2 * alpha_13 + alpha_11;
-    p = x2 * p + alpha_9;
-    p = x2 * p + alpha_7;
-    p = x2 * p + alpha_5;
-    p = x2 * p + alpha_3;
-    p = x2 * p + alpha_1;
-    p = x * p;
-    float q = x2 * beta_6 + beta_4;
-    q = x2 * q + beta_2;
-    q = x2 * q + beta_0;
-    pd[i] = ps1[i] * p / q;
+    pd[i] = ps1[i] * ps2[i];
   }
 }
 
@@ -508,22 +416,10 @@ void gru_reset_gate_sigmoid(const float* ps1, float* ps2, float* pd, int c, floa
   ORT_UNUSED_PARAMETER(alpha);
   ORT_UNUSED_PARAMETER(beta);
 
-  clip_for_sigmoid_in_place(ps2, c);
+  MlasComputeLogistic(ps2, ps2, c);
 
   for (int i = 0; i < c; i++) {
-    float x = 0.5f * ps2[i];
-    float x2 = x * x;
-    float p = x2 * alpha_13 + alpha_11;
-    p = x2 * p + alpha_9;
-    p = x2 * p + alpha_7;
-    p = x2 * p + alpha_5;
-    p = x2 * p + alpha_3;
-    p = x2 * p + alpha_1;
-    p = x * p;
-    float q = x2 * beta_6 + beta_4;
-    q = x2 * q + beta_2;
-    q = x2 * q + beta_0;
-    pd[i] = ps1[i] * 0.5f * (1 + p / q);
+    pd[i] = ps1[i] * ps2[i];
   }
 }
 
@@ -548,22 +444,10 @@ void gru_output_gate_tanh(float* ph, const float* pz, const float* ps, float* po
   ORT_UNUSED_PARAMETER(alpha);
   ORT_UNUSED_PARAMETER(beta);
 
-  clip_for_tanh_in_place(ph, c);
+  MlasComputeTanh(ph, ph, c);
 
   for (int i = 0; i < c; i++) {
-    float x = ph[i];
-    float x2 = x * x;
-    float p = x2 * alpha_13 + alpha_11;
-    p = x2 * p + alpha_9;
-    p = x2 * p + alpha_7;
-    p = x2 * p + alpha_5;
-    p = x2 * p + alpha_3;
-    p = x2 * p + alpha_1;
-    p = x * p;
-    float q = x2 * beta_6 + beta_4;
-    q = x2 * q + beta_2;
-    q = x2 * q + beta_0;
-    po[i] = (1 - pz[i]) * (p / q) + pz[i] * ps[i];
+    po[i] = (1 - pz[i]) * ph[i] + pz[i] * ps[i];
   }
 }
 
@@ -588,22 +472,10 @@ void gru_output_gate_sigmoid(float* ph, const float* pz, const float* ps, float*
   ORT_UNUSED_PARAMETER(alpha);
   ORT_UNUSED_PARAMETER(beta);
 
-  clip_for_sigmoid_in_place(ph, c);
+  MlasComputeLogistic(ph, ph, c);
 
   for (int i = 0; i < c; i++) {
-    float x = 0.5f * (ph[i]);
-    float x2 = x * x;
-    float p = x2 * alpha_13 + alpha_11;
-    p = x2 * p + alpha_9;
-    p = x2 * p + alpha_7;
-    p = x2 * p + alpha_5;
-    p = x2 * p + alpha_3;
-    p = x2 * p + alpha_1;
-    p = x * p;
-    float q = x2 * beta_6 + beta_4;
-    q = x2 * q + beta_2;
-    q = x2 * q + beta_0;
-    po[i] = (1 - pz[i]) * 0.5f * (1 + (p / q)) + pz[i] * ps[i];
+    po[i] = (1 - pz[i]) * ph[i] + pz[i] * ps[i];
   }
 }
 
@@ -10,6 +10,8 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/framework/tensor_shape.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -70,8 +72,8 @@ gsl::span<TAlloc> Allocate(std::shared_ptr<IAllocator> allocator,
 
 // validate the common inputs to RNN, LSTM and GRU operators
 Status ValidateCommonRnnInputs(const Tensor& X,
-                               const Tensor& W,
-                               const Tensor& R,
+                               const TensorShape& W_shape,
+                               const TensorShape& R_shape,
                                const Tensor* B,
                                int WRB_dim_1_multipler,  // multiplier used with hidden_size for W, R and B inputs
                                const Tensor* sequence_lens,
@@ -161,6 +163,96 @@ void ComputeGemm(const int M,
       &*C, ldc, tp);
 }
 
+// A has size M x K, B has size N x K (transposed) and was packed by MlasGemmPackB, and C has size M x N
+template <typename TSpanAIter, typename TSpanCIter>
+void ComputeGemm(const int M,
+                 const int N,
+                 const int K,
+                 const float alpha,
+                 TSpanAIter A,
+                 TSpanAIter A_end,
+                 const int lda,
+                 const void* packed_B,
+                 const float beta,
+                 TSpanCIter C,
+                 TSpanCIter C_end,
+                 const int ldc, concurrency::ThreadPool* tp) {
+  // validate all the inputs
+  ORT_ENFORCE(lda >= K && ldc >= N);
+  ORT_ENFORCE(A + (M * lda - (lda - K)) <= A_end);
+  ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
+
+  MlasGemm(CblasNoTrans, M, N, K, alpha,
+           &*A, lda,
+           packed_B, beta,
+           &*C, ldc, tp);
+}
+
+// The B input of the GEMMs computing A*(B^T) in the recurrent operators. B is either a float N x K matrix, which may
+// also be packed by MlasGemmPackB, or an 8-bit K x N matrix quantized with scale and zero_point. A GEMM with a
+// quantized B quantizes A to uint8 with the range of its values, as DynamicQuantizeMatMul does.
+template <typename T>
+struct GemmWeights {
+  GemmWeights() = default;
+
+  GemmWeights(gsl::span<const T> weights_arg, const void* packed_weights_arg)
+      : weights(weights_arg), packed_weights(packed_weights_arg) {}
+
+  GemmWeights(const uint8_t* quantized_weights_arg, int ldb, bool is_signed, float scale_arg, uint8_t zero_point_arg)
+      : quantized(true),
+        quantized_weights(quantized_weights_arg),
+        quantized_ldb(ldb),
+        quantized_is_signed(is_signed),
+        scale(scale_arg),
+        zero_point(zero_point_arg) {}
+
+  gsl::span<const T> weights;
+  const void* packed_weights = nullptr;
+
+  bool quantized = false;
+  const uint8_t* quantized_weights = nullptr;
+  int quantized_ldb = 0;
+  bool quantized_is_signed = false;
+  float scale = 1.f;
+  uint8_t zero_point = 0;
+};
+
+// C = alpha * A*(B^T) + beta * C with a quantized B. quantized_A is scratch space for the M x K quantized A, and
+// product for the M x N product if beta is not 0.
+void ComputeQuantizedGemm(int M, int N, int K, float alpha, const float* A, const GemmWeights<float>& B, float beta,
+                          float* C, int ldc, gsl::span<uint8_t> quantized_A, gsl::span<float> product,
+                          concurrency::ThreadPool* tp);
+
+// A has size M x K, and C has size M x N. The quantization buffers are only used if B is quantized, see
+// ComputeQuantizedGemm, and A must then be contiguous.
+template <typename TSpanAIter, typename TSpanCIter>
+void ComputeGemm(const int M,
+                 const int N,
+                 const int K,
+                 const float alpha,
+                 TSpanAIter A,
+                 TSpanAIter A_end,
+                 const int lda,
+                 const GemmWeights<float>& B,
+                 const float beta,
+                 TSpanCIter C,
+                 TSpanCIter C_end,
+                 const int ldc,
+                 gsl::span<uint8_t> quantized_A_buffer,
+                 gsl::span<float> product_buffer,
+                 concurrency::ThreadPool* tp) {
+  if (B.quantized) {
+    ORT_ENFORCE(lda == K && ldc >= N);
+    ORT_ENFORCE(A + M * K <= A_end);
+    ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
+    ComputeQuantizedGemm(M, N, K, alpha, &*A, B, beta, &*C, ldc, quantized_A_buffer, product_buffer, tp);
+  } else if (B.packed_weights != nullptr) {
+    ComputeGemm(M, N, K, alpha, A, A_end, lda, B.packed_weights, beta, C, C_end, ldc, tp);
+  } else {
+    ComputeGemm(M, N, K, alpha, A, A_end, lda, B.weights.cbegin(), B.weights.cend(), K, beta, C, C_end, ldc, tp);
+  }
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
@@ -13,8 +13,8 @@ using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
-// TODO: The current implementation of sequence ops relies on tensor copies. Ideally we should try to avoid
-// these copies. This has been postponed due to lack of time.
+// The tensors of a sequence are immutable, so the sequence ops share them between their input and output sequences.
+// Input tensors are copied, as their buffers may be reused by the execution frame once the node has run.
 
 // SequenceLength
 ONNX_CPU_OPERATOR_KERNEL(
@@ -182,15 +182,28 @@ ONNX_CPU_OPERATOR_KERNEL(
                                  DataTypeImpl::GetTensorType<int64_t>()}),
     SequenceInsert);
 
-Status CreateCopyAndAppendCpuTensor(const Tensor& in_tensor, OpKernelContext* context, std::vector<Tensor>& tensors) {
+Status CreateCopyAndAppendCpuTensor(const Tensor& in_tensor, OpKernelContext* context, std::vector<OrtValue>& values) {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-  Tensor tmp(in_tensor.DataType(), onnxruntime::TensorShape(in_tensor.Shape()), alloc);
-  CopyCpuTensor(&in_tensor, &tmp);
-  tensors.push_back(std::move(tmp));
+  auto tmp = onnxruntime::make_unique<Tensor>(in_tensor.DataType(), onnxruntime::TensorShape(in_tensor.Shape()), alloc);
+  CopyCpuTensor(&in_tensor, tmp.get());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  values.emplace_back(tmp.release(), ml_tensor, ml_tensor->GetDeleteFunc());
   return Status::OK();
 }
 
+// Shares the tensor at index i of the sequence, unless it borrows its buffer (e.g. from a feed of the caller), which
+// could be released before the new sequence.
+static Status ShareOrCopyAndAppendCpuTensor(const TensorSeq& seq, size_t i, OpKernelContext* context,
+                                            std::vector<OrtValue>& values) {
+  const OrtValue& value = seq.GetValue(i);
+  if (value.Get<Tensor>().OwnsBuffer()) {
+    values.push_back(value);
+    return Status::OK();
+  }
+  return CreateCopyAndAppendCpuTensor(value.Get<Tensor>(), context, values);
+}
+
 Status SequenceInsert::Compute(OpKernelContext* context) const {
   const auto* S = context->Input<TensorSeq>(0);
   ORT_ENFORCE(S != nullptr, "Got nullptr for sequence input.");
@@ -222,22 +235,20 @@ Status SequenceInsert::Compute(OpKernelContext* context) const {
 
   auto* Y = context->Output<TensorSeq>(0);
   ORT_ENFORCE(Y != nullptr, "SequenceInsert: Got nullptr for output sequence");
-  std::vector<Tensor> tensors;
-  tensors.reserve(num_tensors_input_seq + 1);
+  std::vector<OrtValue> values;
+  values.reserve(num_tensors_input_seq + 1);
   for (int i = 0; i < num_tensors_input_seq; ++i) {
     if (i == input_seq_idx) {
-      CreateCopyAndAppendCpuTensor(*X, context, tensors);
-      CreateCopyAndAppendCpuTensor(S->Get(i), context, tensors);
-    } else {
-      CreateCopyAndAppendCpuTensor(S->Get(i), context, tensors);
+      ORT_RETURN_IF_ERROR(CreateCopyAndAppendCpuTensor(*X, context, values));
     }
+    ORT_RETURN_IF_ERROR(ShareOrCopyAndAppendCpuTensor(*S, i, context, values));
   }
   if (input_seq_idx == num_tensors_input_seq + 1) {
-    CreateCopyAndAppendCpuTensor(*X, context, tensors);
+    ORT_RETURN_IF_ERROR(CreateCopyAndAppendCpuTensor(*X, context, values));
   }
 
   Y->SetType(S->DataType());
-  Y->SetElements(std::move(tensors));
+  Y->SetElements(std::move(values));
 
   return Status::OK();
 }
@@ -275,15 +286,15 @@ Status SequenceErase::Compute(OpKernelContext* context) const {
   auto* Y = context->Output<TensorSeq>(0);
   ORT_ENFORCE(Y != nullptr, "SequenceErase: Got nullptr for output sequence");
   Y->SetType(S->DataType());
-  std::vector<Tensor> tensors;
-  tensors.reserve(num_tensors_input_seq - 1);
+  std::vector<OrtValue> values;
+  values.reserve(num_tensors_input_seq - 1);
   for (int i = 0; i < num_tensors_input_seq; ++i) {
     if (i == input_seq_idx) {
       continue;
     }
-    CreateCopyAndAppendCpuTensor(S->Get(i), context, tensors);
+    ORT_RETURN_IF_ERROR(ShareOrCopyAndAppendCpuTensor(*S, i, context, values));
   }
-  Y->SetElements(std::move(tensors));
+  Y->SetElements(std::move(values));
   return Status::OK();
 }
 
@@ -315,13 +326,13 @@ Status SequenceConstruct::Compute(OpKernelContext* context) const {
 
   // now copy the tensors to the output sequence
   Y->SetType(first_dtype);
-  std::vector<Tensor> tensors;
-  tensors.reserve(num_inputs);
+  std::vector<OrtValue> values;
+  values.reserve(num_inputs);
   for (int input_idx = 0; input_idx < num_inputs; ++input_idx) {
     const auto* X = context->Input<Tensor>(input_idx);
-    CreateCopyAndAppendCpuTensor(*X, context, tensors);
+    ORT_RETURN_IF_ERROR(CreateCopyAndAppendCpuTensor(*X, context, values));
   }
-  Y->SetElements(std::move(tensors));
+  Y->SetElements(std::move(values));
   return Status::OK();
 }
 
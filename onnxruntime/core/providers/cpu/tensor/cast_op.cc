@@ -1,71 +1,97 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
-#include "Eigen/src/Core/arch/Default/Half.h"
 #include "core/common/common.h"
-
-#if defined(_M_AMD64)
 #include "core/mlas/inc/mlas.h"
-#endif
+#include "core/platform/threadpool.h"
 
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 
+// Casts the elements in parallel over blocks for large tensors.
 template <typename SrcType,
           typename DstType>
-inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<SrcType>(in->template Data<SrcType>(), shape_size);
-  auto output_vector = EigenVectorMap<DstType>(out->template MutableData<DstType>(), shape_size);
-  output_vector = in_vector.template cast<DstType>();
+inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, concurrency::ThreadPool* tp) {
+  const SrcType* in_data = in->template Data<SrcType>();
+  DstType* out_data = out->template MutableData<DstType>();
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(shape.Size()),
+      TensorOpCost{static_cast<double>(sizeof(SrcType)), static_cast<double>(sizeof(DstType)), 1.0},
+      [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        const auto count = static_cast<Eigen::Index>(last - first);
+        auto in_vector = ConstEigenVectorMap<SrcType>(in_data + first, count);
+        auto output_vector = EigenVectorMap<DstType>(out_data + first, count);
+        output_vector = in_vector.template cast<DstType>();
+      });
 }
 
 template <>
-inline void CastData<float, MLFloat16>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<MLFloat16>();
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<float>(in->template Data<float>(), shape_size);
-  auto output_vector = EigenVectorMap<Eigen::half>(static_cast<Eigen::half*>(static_cast<void*>(out_data)), shape_size);
-  output_vector = in_vector.template cast<Eigen::half>();
+inline void CastData<float, MLFloat16>(const Tensor* in, Tensor* out, const TensorShape& shape,
+                                       concurrency::ThreadPool* tp) {
+  const float* in_data = in->template Data<float>();
+  MLFloat16* out_data = out->template MutableData<MLFloat16>();
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(shape.Size()),
+      TensorOpCost{static_cast<double>(sizeof(float)), static_cast<double>(sizeof(MLFloat16)), 1.0},
+      [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        MlasConvertFloatToHalfBuffer(in_data + first, &out_data[first].val, static_cast<size_t>(last - first));
+      });
 }
 
 template <>
-inline void CastData<MLFloat16, float>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<float>();
-  auto in_data = in->template Data<MLFloat16>();
-  auto shape_size = shape.Size();
-#if defined(_M_AMD64)
-  MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
-#else
-  auto in_vector = ConstEigenVectorMap<Eigen::half>(static_cast<const Eigen::half*>(static_cast<const void*>(in_data)), shape_size);
-  auto output_vector = EigenVectorMap<float>(out_data, shape_size);
-  output_vector = in_vector.template cast<float>();
-#endif
+inline void CastData<MLFloat16, float>(const Tensor* in, Tensor* out, const TensorShape& shape,
+                                       concurrency::ThreadPool* tp) {
+  const MLFloat16* in_data = in->template Data<MLFloat16>();
+  float* out_data = out->template MutableData<float>();
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(shape.Size()),
+      TensorOpCost{static_cast<double>(sizeof(MLFloat16)), static_cast<double>(sizeof(float)), 1.0},
+      [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        MlasConvertHalfToFloatBuffer(&in_data[first].val, out_data + first, static_cast<size_t>(last - first));
+      });
+}
+
+// Casts a block of MLFloat16 elements to a type other than float through a float buffer.
+template <typename DstType>
+inline void CastBlockThroughFloat(const MLFloat16* in_data, DstType* out_data, float* buffer, std::ptrdiff_t count) {
+  MlasConvertHalfToFloatBuffer(&in_data[0].val, buffer, static_cast<size_t>(count));
+  auto output_vector = EigenVectorMap<DstType>(out_data, static_cast<Eigen::Index>(count));
+  output_vector = ConstEigenVectorMap<float>(buffer, static_cast<Eigen::Index>(count)).template cast<DstType>();
 }
 
+// Casts a block of elements of a type other than float to MLFloat16 through a float buffer.
+template <typename SrcType>
+inline void CastBlockThroughFloat(const SrcType* in_data, MLFloat16* out_data, float* buffer, std::ptrdiff_t count) {
+  auto float_vector = EigenVectorMap<float>(buffer, static_cast<Eigen::Index>(count));
+  float_vector = ConstEigenVectorMap<SrcType>(in_data, static_cast<Eigen::Index>(count)).template cast<float>();
+  MlasConvertFloatToHalfBuffer(buffer, &out_data[0].val, static_cast<size_t>(count));
+}
+
+constexpr std::ptrdiff_t kCastFloat16BlockSize = 256;
+
+// Casts between MLFloat16 and a type other than float through float, in blocks that fit in a buffer on the stack.
 template <typename SrcType,
           typename DstType>
-inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, const AllocatorPtr& allocator) {
-  ORT_ENFORCE(allocator != nullptr);
-  const int64_t len = shape.Size();
-  ORT_ENFORCE(len > 0);
-  void* buffer = allocator->AllocArray(sizeof(float), len);
-  ORT_ENFORCE(buffer);
-  Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, buffer, allocator->Info());
-  if (std::is_same<SrcType, MLFloat16>::value) {
-    CastData<MLFloat16, float>(in, &tmp_tensor, shape);  // first cast to float
-    CastData<float, DstType>(&tmp_tensor, out, shape);   // then cast to the destination type.
-  } else if (std::is_same<DstType, MLFloat16>::value) {
-    CastData<SrcType, float>(in, &tmp_tensor, shape);
-    CastData<float, MLFloat16>(&tmp_tensor, out, shape);
-  }
-  allocator->Free(buffer);
+inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, concurrency::ThreadPool* tp) {
+  const SrcType* in_data = in->template Data<SrcType>();
+  DstType* out_data = out->template MutableData<DstType>();
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(shape.Size()),
+      TensorOpCost{static_cast<double>(sizeof(SrcType)), static_cast<double>(sizeof(DstType)), 2.0},
+      [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        float buffer[kCastFloat16BlockSize];
+        for (std::ptrdiff_t block = first; block < last; block += kCastFloat16BlockSize) {
+          CastBlockThroughFloat(in_data + block, out_data + block, buffer,
+                                std::min(kCastFloat16BlockSize, last - block));
+        }
+      });
 }
 
 template <typename SrcType>
@@ -176,16 +202,14 @@ class Cast final : public OpKernel {
  private:
   template <typename SrcType,
             typename DstType>
-  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) const {
-    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape);
+  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, OpKernelContext* context) const {
+    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape, context->GetOperatorThreadPool());
   }
 
   template <typename SrcType,
             typename DstType>
   Status CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, OpKernelContext* context) const {
-    AllocatorPtr allocator;
-    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
-    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, allocator);
+    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, context->GetOperatorThreadPool());
     return Status::OK();
   }
 
@@ -225,7 +249,10 @@ const std::vector<MLDataType> castOpTypeConstraints{
       6,                                                                                                                           \
       9,                                                                                                                           \
       in_type,                                                                                                                     \
-      KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>()).TypeConstraint("T2", castOpTypeConstraints), \
+      KernelDefBuilder()                                                                                                           \
+          .MayInplace(0, 0)                                                                                                        \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>())                                                            \
+          .TypeConstraint("T2", castOpTypeConstraints),                                                                            \
       Cast<in_type>);                                                                                                              \
                                                                                                                                    \
   template <>                                                                                                                      \
@@ -236,41 +263,41 @@ const std::vector<MLDataType> castOpTypeConstraints{
                                                                                                                                    \
     switch (to_) {                                                                                                                 \
       case TensorProto_DataType_BOOL:                                                                                              \
-        CastData<in_type, bool>(X, Y, shape);                                                                                      \
+        CastData<in_type, bool>(X, Y, shape, context);                                                                             \
         break;                                                                                                                     \
       case TensorProto_DataType_INT16:                                                                                             \
-        CastData<in_type, int16_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int16_t>(X, Y, shape, context);                                                                          \
         break;                                                                                                                     \
       case TensorProto_DataType_INT32:                                                                                             \
-        CastData<in_type, int32_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int32_t>(X, Y, shape, context);                                                                          \
         break;                                                                                                                     \
       case TensorProto_DataType_INT64:                                                                                             \
-        CastData<in_type, int64_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int64_t>(X, Y, shape, context);                                                                          \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT8:                                                                                             \
-        CastData<in_type, uint8_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, uint8_t>(X, Y, shape, context);                                                                          \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT16:                                                                                            \
-        CastData<in_type, uint16_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint16_t>(X, Y, shape, context);                                                                         \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT32:                                                                                            \
-        CastData<in_type, uint32_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint32_t>(X, Y, shape, context);                                                                         \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT64:                                                                                            \
-        CastData<in_type, uint64_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint64_t>(X, Y, shape, context);                                                                         \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT:                                                                                             \
-        CastData<in_type, float>(X, Y, shape);                                                                                     \
+        CastData<in_type, float>(X, Y, shape, context);                                                                            \
         break;                                                                                                                     \
       case TensorProto_DataType_DOUBLE:                                                                                            \
-        CastData<in_type, double>(X, Y, shape);                                                                                    \
+        CastData<in_type, double>(X, Y, shape, context);                                                                           \
         break;                                                                                                                     \
       case TensorProto_DataType_INT8:                                                                                              \
-        CastData<in_type, int8_t>(X, Y, shape);                                                                                    \
+        CastData<in_type, int8_t>(X, Y, shape, context);                                                                           \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT16:                                                                                           \
         if (std::is_same<in_type, float>::value) {                                                                                 \
-          CastData<float, MLFloat16>(X, Y, shape);                                                                                 \
+          CastData<float, MLFloat16>(X, Y, shape, context);                                                                        \
         } else {                                                                                                                   \
           auto st = CastFloat16Data<in_type, MLFloat16>(X, Y, shape, context);                                                     \
           if (!st.IsOK()) return st;                                                                                               \
@@ -304,7 +331,10 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     6,
     9,
     MLFloat16,
-    KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<MLFloat16>()).TypeConstraint("T2", castOpTypeConstraints),
+    KernelDefBuilder()
+        .MayInplace(0, 0)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<MLFloat16>())
+        .TypeConstraint("T2", castOpTypeConstraints),
     Cast<MLFloat16>);
 
 template <>
@@ -339,7 +369,7 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
       st = CastFloat16Data<MLFloat16, uint64_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_FLOAT:
-      CastData<MLFloat16, float>(X, Y, shape);
+      CastData<MLFloat16, float>(X, Y, shape, context);
       break;
     case TensorProto_DataType_FLOAT16: {
       auto X_type = X->DataType();
@@ -2,8 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/concat.h"
+
+#include <algorithm>
+
 #include "core/providers/common.h"
 #include "core/framework/TensorSeq.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -152,52 +156,56 @@ Status ConcatBase::PrepareForCompute(OpKernelContext* ctx,
 }
 
 // This method computes the output tensor for Concat/ConcatFromSequence ops
-Status ConcatBase::ComputeImpl(Prepare& p) const {
-  int input_count = static_cast<int>(p.inputs.size());
-  int64_t initial_output_offset = 0;  // initial offset for each input
-  auto element_bytes = p.output_tensor->DataType()->Size();
+Status ConcatBase::ComputeImpl(Prepare& p, concurrency::ThreadPool* tp) const {
+  const int input_count = static_cast<int>(p.inputs.size());
+  const auto element_bytes = p.output_tensor->DataType()->Size();
+
+  // Each row of 'output_axis_pitch' values in the output holds a block of 'axis_pitch' values of each input in turn.
+  // Find the offset of the block of each input in a row.
+  std::vector<int64_t> input_offsets(input_count);
+  int64_t initial_output_offset = 0;
   for (int input_index = 0; input_index < input_count; input_index++) {
-    const auto& prep = p.inputs[input_index];
-
-    // no data in this tensor - so skip it
-    if (prep.num_elements == 0)
-      continue;
-
-    auto input_axis_pitch = prep.axis_pitch;
-    const uint8_t* input = static_cast<const uint8_t*>(prep.tensor->DataRaw());
-
-    auto input_size = prep.num_elements;
-
-    // Copy the data across. For every 'input_axis_pitch' values copied, we move over by the 'output_axis_pitch'
-    // TODO: Optimization possibility: There are cases where we simply need to "merge" raw buffers and this 
-    // could be done without the pointer house-keeping as below. Some scenarios whether this is possible are:
-    // 1) Concatenating on input axis = 0
-    // 2) Stacking on output axis = 0
-    // 3) Stacking scalars
-    uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
-    int64_t cur_out_offset = 0;
-    int64_t cur_in_offset = 0;
-    for (size_t idx_copy = 0, end = input_size / input_axis_pitch; idx_copy < end; ++idx_copy) {
-      if (p.is_string_type) {
-        size_t out = initial_output_offset + cur_out_offset;
-        for (int idx_item = 0; idx_item < input_axis_pitch; ++idx_item) {
-          reinterpret_cast<std::string*>(output)[out + idx_item] =
-              reinterpret_cast<const std::string*>(input)[cur_in_offset + idx_item];
-        }
-      } else {
-        memcpy(
-            output + (initial_output_offset + cur_out_offset) * element_bytes,
-            input + cur_in_offset * element_bytes,
-            input_axis_pitch * element_bytes);
-      }
-
-      cur_out_offset += p.output_axis_pitch;
-      cur_in_offset += input_axis_pitch;
-    }
-
-    initial_output_offset += input_axis_pitch;
+    input_offsets[input_index] = initial_output_offset;
+    initial_output_offset += p.inputs[input_index].axis_pitch;
   }
 
+  // Split the output in ranges of values across the threads. Each range is copied as the contiguous runs of the
+  // input blocks that overlap it, so rows made of a few large blocks are still split between threads.
+  const bool is_string_type = p.is_string_type;
+  const int64_t output_axis_pitch = p.output_axis_pitch;
+  uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(p.output_num_elements),
+      TensorOpCost{static_cast<double>(element_bytes), static_cast<double>(element_bytes), 0.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        int64_t output_offset = first;
+        while (output_offset < last) {
+          const int64_t row = output_offset / output_axis_pitch;
+          const int64_t offset_in_row = output_offset % output_axis_pitch;
+
+          // the last input whose block starts at or before the offset, which skips the empty inputs
+          const auto input_index = static_cast<size_t>(
+              std::upper_bound(input_offsets.cbegin(), input_offsets.cend(), offset_in_row) -
+              input_offsets.cbegin() - 1);
+          const auto& prep = p.inputs[input_index];
+          const int64_t offset_in_block = offset_in_row - input_offsets[input_index];
+          const int64_t count = std::min(prep.axis_pitch - offset_in_block,
+                                         static_cast<int64_t>(last) - output_offset);
+          const int64_t input_offset = row * prep.axis_pitch + offset_in_block;
+
+          if (is_string_type) {
+            const std::string* input = prep.tensor->Data<std::string>() + input_offset;
+            std::copy(input, input + count, reinterpret_cast<std::string*>(output) + output_offset);
+          } else {
+            memcpy(output + output_offset * element_bytes,
+                   static_cast<const uint8_t*>(prep.tensor->DataRaw()) + input_offset * element_bytes,
+                   static_cast<size_t>(count) * element_bytes);
+          }
+
+          output_offset += count;
+        }
+      });
+
   return Status::OK();
 }
 
@@ -224,7 +232,7 @@ Status Concat::Compute(OpKernelContext* ctx) const {
     return Status::OK();
 
   // Compute values to be placed in the output tensor
-  return ComputeImpl(p);
+  return ComputeImpl(p, ctx->GetOperatorThreadPool());
 }
 
 }  // namespace onnxruntime
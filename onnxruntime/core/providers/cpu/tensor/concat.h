@@ -44,7 +44,8 @@ class ConcatBase {
   Status PrepareForCompute(OpKernelContext* ctx, const std::vector<const Tensor*>& input_tensors,
                            Prepare& p) const;
 
-  Status ComputeImpl(Prepare& p) const;
+  // Copies the inputs to the output, in parallel over ranges of the output if a thread pool is given
+  Status ComputeImpl(Prepare& p, concurrency::ThreadPool* tp = nullptr) const;
 
   int64_t axis_;
   bool is_stack_ = false;
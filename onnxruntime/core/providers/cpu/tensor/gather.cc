@@ -3,6 +3,9 @@
 
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
+
+#include <algorithm>
+
 #include "core/common/common.h"
 #include "core/platform/threadpool.h"
 
@@ -15,7 +18,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
         .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
-                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+                                                        DataTypeImpl::GetTensorType<int64_t>()})
+        .MayView(0, 0),
     Gather);
 
 ONNX_CPU_OPERATOR_KERNEL(
@@ -24,10 +28,30 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
         .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
-                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+                                                        DataTypeImpl::GetTensorType<int64_t>()})
+        .MayView(0, 0),
     Gather);
 
-Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const {
+// Returns the first index if the indices are a run of consecutive values within [0, axis_dim_limit), or -1.
+template <typename Tin>
+static int64_t FirstOfConsecutiveIndices(const Tensor& indices_tensor, int64_t axis_dim_limit) {
+  const Tin* indices_data = indices_tensor.template Data<Tin>();
+  const int64_t N = indices_tensor.Shape().Size();
+  if (N == 0)
+    return -1;
+
+  int64_t first = indices_data[0] < 0 ? indices_data[0] + axis_dim_limit : indices_data[0];
+  if (first < 0 || first + N > axis_dim_limit)
+    return -1;
+  for (int64_t i = 1; i < N; ++i) {
+    int64_t idx = indices_data[i] < 0 ? indices_data[i] + axis_dim_limit : indices_data[i];
+    if (idx != first + i)
+      return -1;
+  }
+  return first;
+}
+
+Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p, bool allow_view) const {
   p.input_tensor = context->Input<Tensor>(0);
   const TensorShape& input_data_shape = p.input_tensor->Shape();
   p.indices_tensor = context->Input<Tensor>(1);
@@ -49,15 +73,100 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   for (int64_t i = p.axis + 1; i < static_cast<int64_t>(input_rank); ++i)
     shape.push_back(input_data_shape[i]);
 
+  // with a single block before the axis, consecutive indices gather a contiguous range of the input
+  if (allow_view && !p.input_tensor->IsDataTypeString() && input_data_shape.SizeToDimension(p.axis) == 1) {
+    const int64_t axis_dim_limit = input_data_shape[p.axis];
+    const int64_t first = p.indices_tensor->IsDataType<int32_t>()
+                              ? FirstOfConsecutiveIndices<int32_t>(*p.indices_tensor, axis_dim_limit)
+                              : FirstOfConsecutiveIndices<int64_t>(*p.indices_tensor, axis_dim_limit);
+    if (first >= 0) {
+      const size_t byte_offset = static_cast<size_t>(first * input_data_shape.SizeFromDimension(p.axis + 1)) *
+                                 p.input_tensor->DataType()->Size();
+      p.output_tensor = context->OutputView(0, TensorShape(shape), 0, byte_offset);
+      if (p.output_tensor != nullptr) {
+        p.output_is_view = true;
+        return Status::OK();
+      }
+    }
+  }
+
   p.output_tensor = context->Output(0, TensorShape(std::move(shape)));
 
   return Status::OK();
 }
 
+// Gathered rows of a table larger than this are unlikely to be cached, so the row a few indices ahead is prefetched.
+static constexpr int64_t kGatherPrefetchTableBytes = 4 * 1024 * 1024;
+static constexpr int64_t kGatherPrefetchDistance = 8;
+
+static inline void PrefetchRow(const void* row) {
+#if defined(__GNUC__)
+  __builtin_prefetch(row);
+#else
+  ORT_UNUSED_PARAMETER(row);
+#endif
+}
+
+// Gathers M batches of N blocks, each of block elements of type T. T is either the element type for strings, or an
+// unsigned integer as wide as the alignment of the blocks allows so a single element block is copied with one store.
+template <typename Tin, typename T>
+static void GatherBlocks(const Tin* indices_data, const T* src_base, T* dst_base, const int64_t block,
+                         const int64_t M, const int64_t N, const int64_t axis_dim_limit, concurrency::ThreadPool* tp) {
+  const int64_t data_batch = axis_dim_limit * block;
+  const bool prefetch = data_batch * static_cast<int64_t>(sizeof(T)) > kGatherPrefetchTableBytes;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, M * N, static_cast<double>(block * sizeof(T)),
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        // walk the (batch, i) pairs incrementally rather than dividing each flattened index
+        int64_t i = first % N;
+        const T* src = src_base + (first / N) * data_batch;
+        T* dst = dst_base + first * block;
+
+        for (ptrdiff_t index = first; index < last; ++index) {
+          if (prefetch && i + kGatherPrefetchDistance < N) {
+            int64_t next = indices_data[i + kGatherPrefetchDistance];
+            next = next < 0 ? next + axis_dim_limit : next;
+            PrefetchRow(src + next * block);
+          }
+
+          int64_t idx = indices_data[i];
+          idx = idx < 0 ? idx + axis_dim_limit : idx;
+          if (block == 1) {
+            *dst = src[idx];
+          } else {
+            const T* row = src + idx * block;
+            std::copy(row, row + block, dst);
+          }
+
+          dst += block;
+          if (++i == N) {
+            i = 0;
+            src += data_batch;
+          }
+        }
+      });
+}
+
+// Copies with the widest unsigned integer type that divides the block size and the alignment of both buffers.
+template <typename Tin, typename T>
+static bool TryGatherWords(const Tin* indices_data, const uint8_t* src_base, uint8_t* dst_base,
+                           const int64_t block_size, const int64_t M, const int64_t N, const int64_t axis_dim_limit,
+                           concurrency::ThreadPool* tp) {
+  if (block_size % sizeof(T) != 0 ||
+      reinterpret_cast<uintptr_t>(src_base) % alignof(T) != 0 ||
+      reinterpret_cast<uintptr_t>(dst_base) % alignof(T) != 0) {
+    return false;
+  }
+
+  GatherBlocks<Tin, T>(indices_data, reinterpret_cast<const T*>(src_base), reinterpret_cast<T*>(dst_base),
+                       block_size / static_cast<int64_t>(sizeof(T)), M, N, axis_dim_limit, tp);
+  return true;
+}
+
 template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
-                      const size_t element_bytes, const int64_t block_size, const int64_t M,
-                      const int64_t N, const int64_t data_batch_bytes, const int64_t gathered_batch_bytes,
+                      const int64_t block, const int64_t block_size, const int64_t M, const int64_t N,
                       const TensorShape& input_data_shape, const int64_t axis, concurrency::ThreadPool* tp) {
   const Tin* indices_data = indices_tensor->template Data<Tin>();
 
@@ -73,37 +182,23 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-  auto lambda = [&](int64_t index) {
-    int64_t batch = index / N;
-    int64_t i = index % N;
-
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
-    idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
-
-    if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
-    } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
-    }
-  };
-  concurrency::ThreadPool::TryParallelFor(tp, M * N, static_cast<double>(block_size),
-                                          [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int index = static_cast<int>(first), end = static_cast<int>(last); index < end; ++index) {
-                                              lambda(index);
-                                            }
-                                          });
+  if (is_string_type) {
+    GatherBlocks<Tin, std::string>(indices_data, reinterpret_cast<const std::string*>(src_base),
+                                   reinterpret_cast<std::string*>(dst_base), block, M, N, axis_dim_limit, tp);
+  } else if (!TryGatherWords<Tin, uint64_t>(indices_data, src_base, dst_base, block_size, M, N, axis_dim_limit, tp) &&
+             !TryGatherWords<Tin, uint32_t>(indices_data, src_base, dst_base, block_size, M, N, axis_dim_limit, tp) &&
+             !TryGatherWords<Tin, uint16_t>(indices_data, src_base, dst_base, block_size, M, N, axis_dim_limit, tp)) {
+    GatherBlocks<Tin, uint8_t>(indices_data, src_base, dst_base, block_size, M, N, axis_dim_limit, tp);
+  }
 
   return Status::OK();
 }
 
 Status Gather::Compute(OpKernelContext* context) const {
   Prepare p;
-  ORT_RETURN_IF_ERROR(PrepareForCompute(context, p));
+  ORT_RETURN_IF_ERROR(PrepareForCompute(context, p, true));
+  if (p.output_is_view)
+    return Status::OK();
 
   const TensorShape& input_data_shape = p.input_tensor->Shape();
 
@@ -114,8 +209,6 @@ Status Gather::Compute(OpKernelContext* context) const {
   const int64_t block_size = block * element_bytes;
   const int64_t M = input_data_shape.SizeToDimension(p.axis);
   const int64_t N = p.indices_tensor->Shape().Size();
-  const int64_t data_batch_bytes = input_data_shape.SizeFromDimension(p.axis) * element_bytes;
-  const int64_t gathered_batch_bytes = N * block * element_bytes;
 
   const auto* src_base = static_cast<const uint8_t*>(p.input_tensor->DataRaw());
   auto* dst_base = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
@@ -123,12 +216,12 @@ Status Gather::Compute(OpKernelContext* context) const {
   concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
 
   if (p.indices_tensor->IsDataType<int32_t>()) {
-    return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis, tp);
+    return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, is_string_type, block, block_size, M, N,
+                                   input_data_shape, p.axis, tp);
   }
   if (p.indices_tensor->IsDataType<int64_t>()) {
-    return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis, tp);
+    return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, is_string_type, block, block_size, M, N,
+                                   input_data_shape, p.axis, tp);
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
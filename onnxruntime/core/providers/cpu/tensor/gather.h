@@ -20,9 +20,13 @@ class GatherBase {
     const Tensor* indices_tensor;
     Tensor* output_tensor;
     int64_t axis;
+    // set if the output was created as a view of the input and has no data to gather
+    bool output_is_view = false;
   };
 
-  Status PrepareForCompute(OpKernelContext* context, Prepare& p) const;
+  // If allow_view is set and the indices gather a run of consecutive blocks of the input along an outermost axis,
+  // the output is created as a view of the input if possible. The indices must be on CPU for that.
+  Status PrepareForCompute(OpKernelContext* context, Prepare& p, bool allow_view = false) const;
 
  private:
   int64_t axis_;
@@ -2,7 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gather_elements.h"
-#include "onnxruntime_config.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -114,32 +114,12 @@ static std::vector<int64_t> parse_and_validate_indices_tensor(const Tensor* indi
   return indices_data;
 }
 
-#ifdef __GNUC__
-#pragma GCC diagnostic push
-#ifdef HAS_CLASS_MEMACCESS
-#pragma GCC diagnostic ignored "-Wclass-memaccess"
-#endif
-#endif
-template <bool is_string, typename T>
+// T is std::string, or an unsigned integer as wide as the element type so each element is copied with one store
+template <typename T>
 static void core_impl(const Tensor* input_tensor, const Tensor* indices_tensor,
-                      Tensor* output_tensor, int64_t axis) {
-  // get pointer to input data
-  // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-  const T* input_data = nullptr;
-  if (is_string) {
-    input_data = input_tensor->Data<T>();
-  } else {
-    input_data = reinterpret_cast<const T*>(input_tensor->DataRaw());
-  }
-
-  // get pointer to output data
-  // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-  T* output_data = nullptr;
-  if (is_string) {
-    output_data = output_tensor->MutableData<T>();
-  } else {
-    output_data = reinterpret_cast<T*>(output_tensor->MutableDataRaw());
-  }
+                      Tensor* output_tensor, int64_t axis, concurrency::ThreadPool* tp) {
+  const T* input_data = static_cast<const T*>(input_tensor->DataRaw());
+  T* output_data = static_cast<T*>(output_tensor->MutableDataRaw());
 
   const int64_t input_rank = static_cast<int64_t>(input_tensor->Shape().NumDimensions());
   const TensorPitches input_shape_pitches(*input_tensor);
@@ -150,57 +130,42 @@ static void core_impl(const Tensor* input_tensor, const Tensor* indices_tensor,
   int64_t num_inner_dim = calculate_num_inner_dim(indices_shape);
   int64_t inner_dim_size = indices_shape[input_rank - 1];
   bool processing_inner_dim = (axis == input_rank - 1) ? true : false;
-
-  int64_t base_offset = 0;
-  int64_t indices_counter = -1;
-  int64_t output_counter = -1;
-  size_t element_size = input_tensor->DataType()->Size();
-
-  std::vector<int64_t> process_dims(input_rank, 0);
-
-  if (!processing_inner_dim) {
-    while (num_inner_dim-- != 0) {
-      base_offset = compute_base_offset(process_dims, input_shape_pitches, axis);
-
-      // process 1 chunk of 'inner dimension' length
-      for (int64_t i = 0; i < inner_dim_size; ++i) {
-        // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-        if (is_string) {
-          output_data[++output_counter] = input_data[base_offset + (indices_data[++indices_counter] * input_shape_pitches[axis]) + i];
-        } else {
-          memcpy(output_data,
-                 input_data + (base_offset + (indices_data[++indices_counter] * input_shape_pitches[axis]) + i) * element_size, element_size);
-          output_data += element_size;
+  const int64_t axis_pitch = input_shape_pitches[axis];
+
+  // each 'inner dimension' chunk of 'indices' maps to the same chunk of the output, so the chunks are independent
+  concurrency::ThreadPool::TryParallelFor(
+      tp, num_inner_dim, static_cast<double>(inner_dim_size * sizeof(T)),
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        // position of the first chunk in the outer dimensions of 'indices'
+        std::vector<int64_t> process_dims(input_rank, 0);
+        int64_t remainder = first;
+        for (int64_t dim = input_rank - 2; dim >= 0; --dim) {
+          process_dims[dim] = remainder % indices_shape[dim];
+          remainder /= indices_shape[dim];
         }
-      }
 
-      increment_over_inner_dim(process_dims, indices_shape);
-    }
-  }
-  // we special-case inner dim as we can weed-out some unnecessary computations in element offset calculations
-  else {
-    while (num_inner_dim-- != 0) {
-      base_offset = compute_base_offset(process_dims, input_shape_pitches, axis);
-
-      // process 1 chunk of 'inner dimension' length
-      for (int64_t i = 0; i < inner_dim_size; ++i) {
-        // for innermost axis, input_shape_pitches[axis] = 1 (so no need to multiply)
-        // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-        if (is_string) {
-          output_data[++output_counter] = input_data[base_offset + indices_data[++indices_counter]];
-        } else {
-          memcpy(output_data, input_data + (base_offset + indices_data[++indices_counter]) * element_size, element_size);
-          output_data += element_size;
+        for (ptrdiff_t chunk = first; chunk < last; ++chunk) {
+          const int64_t base_offset = compute_base_offset(process_dims, input_shape_pitches, axis);
+          const int64_t* chunk_indices = indices_data.data() + chunk * inner_dim_size;
+          T* chunk_output = output_data + chunk * inner_dim_size;
+
+          // process 1 chunk of 'inner dimension' length
+          // we special-case inner dim as we can weed-out some unnecessary computations in element offset calculations
+          if (processing_inner_dim) {
+            // for innermost axis, input_shape_pitches[axis] = 1 (so no need to multiply)
+            for (int64_t i = 0; i < inner_dim_size; ++i) {
+              chunk_output[i] = input_data[base_offset + chunk_indices[i]];
+            }
+          } else {
+            for (int64_t i = 0; i < inner_dim_size; ++i) {
+              chunk_output[i] = input_data[base_offset + chunk_indices[i] * axis_pitch + i];
+            }
+          }
+
+          increment_over_inner_dim(process_dims, indices_shape);
         }
-      }
-
-      increment_over_inner_dim(process_dims, indices_shape);
-    }
-  }
+      });
 }
-#ifdef __GNUC__
-#pragma GCC diagnostic pop
-#endif
 
 Status GatherElements::ValidateInputShapes(const TensorShape& input_data_shape,
                                            const TensorShape& indices_shape,
@@ -260,12 +225,30 @@ Status GatherElements::Compute(OpKernelContext* context) const {
   if (indices_shape.Size() == 0)
     return Status::OK();
 
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
 
-  if (input_tensor->IsDataTypeString())
-    core_impl<true, std::string>(input_tensor, indices_tensor, output_tensor, axis);
+  if (input_tensor->IsDataTypeString()) {
+    core_impl<std::string>(input_tensor, indices_tensor, output_tensor, axis, tp);
+    return Status::OK();
+  }
 
-  else
-    core_impl<false, int8_t>(input_tensor, indices_tensor, output_tensor, axis);
+  switch (input_data_type->Size()) {
+    case sizeof(uint8_t):
+      core_impl<uint8_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    case sizeof(uint16_t):
+      core_impl<uint16_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    case sizeof(uint32_t):
+      core_impl<uint32_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    case sizeof(uint64_t):
+      core_impl<uint64_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                             "GatherElements op: Unsupported element size of ", input_data_type->Size());
+  }
 
   return Status::OK();
 }
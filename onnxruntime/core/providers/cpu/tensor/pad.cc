@@ -10,6 +10,7 @@
 #include "core/util/math.h"
 #include "core/providers/cpu/tensor/pad.h"
 #include "core/providers/cpu/tensor/utils.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -182,6 +183,60 @@ static void ReshapePads(const std::vector<int64_t>& src_pad, size_t src_dim_coun
   reshaped_pad[inner_axis + new_dim_count] = src_pad[inner_axis + src_dim_count] * inner_no_pad_size;
 }
 
+// Writes the output of constant padding in parallel over the rows of its innermost axis. Each row is either only
+// padding, or a row of the input with the padding before and after it. The dims, pads, starts and extents are those
+// of the reshaped input and output.
+template <typename T>
+static void PadConstant(const T* input, T* output, const std::vector<int64_t>& input_dims,
+                        const std::vector<int64_t>& output_dims, const std::vector<int64_t>& pads,
+                        const std::vector<int64_t>& input_starts, const std::vector<int64_t>& input_extents,
+                        T value, concurrency::ThreadPool* tp) {
+  const size_t inner_axis = output_dims.size() - 1;
+  const int64_t row_size = output_dims[inner_axis];
+  int64_t num_rows = 1;
+  for (size_t axis = 0; axis < inner_axis; ++axis) {
+    num_rows *= output_dims[axis];
+  }
+
+  const TensorPitches input_pitches(input_dims);
+  const int64_t pre_pad = pads[inner_axis];
+  const int64_t inner_extent = input_extents[inner_axis];
+  const int64_t post_pad = row_size - pre_pad - inner_extent;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_rows),
+      TensorOpCost{static_cast<double>(inner_extent * sizeof(T)), static_cast<double>(row_size * sizeof(T)),
+                   static_cast<double>(inner_axis)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          T* output_row = output + row * row_size;
+
+          // find the input row, unless the row is in the padding of one of the outer axes
+          int64_t remaining = row;
+          int64_t input_offset = input_starts[inner_axis];
+          bool is_padding = false;
+          for (size_t axis = inner_axis; axis-- > 0;) {
+            const int64_t index = remaining % output_dims[axis] - pads[axis];
+            remaining /= output_dims[axis];
+            if (index < 0 || index >= input_extents[axis]) {
+              is_padding = true;
+              break;
+            }
+            input_offset += (input_starts[axis] + index) * input_pitches[axis];
+          }
+
+          if (is_padding) {
+            std::fill_n(output_row, row_size, value);
+            continue;
+          }
+
+          std::fill_n(output_row, pre_pad, value);
+          std::copy_n(input + input_offset, inner_extent, output_row + pre_pad);
+          std::fill_n(output_row + pre_pad + inner_extent, post_pad, value);
+        }
+      });
+}
+
 template <typename T>
 static Status PadImpl(OpKernelContext* ctx,
                   const std::vector<int64_t>& pads,
@@ -251,34 +306,9 @@ static Status PadImpl(OpKernelContext* ctx,
 
   switch (mode) {
     case Mode::Constant:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, value, prePad);
-          PadAxisConstant(output, value, postPad);
-          output += postPad;
-          alignSkip = prePad;
-        }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxisConstant(axisStart - prePad * inner_pitch, value, prePad * inner_pitch);
-          PadAxisConstant(output, value, postPad * inner_pitch);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
-        }
-      }
+      // the rows of the output are independent with constant padding, so they are written in parallel
+      PadConstant(reinterpret_cast<const T*>(input_tensor.DataRaw()), output, reshaped_input_dims,
+                  reshaped_output_dims, reshaped_pad, input_starts, input_extents, value, ctx->GetOperatorThreadPool());
       break;
 
     case Mode::Edge:
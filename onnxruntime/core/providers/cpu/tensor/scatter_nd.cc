@@ -124,15 +124,43 @@ Status ScatterND::Compute(OpKernelContext* context) const {
   return nullptr == p.input_str_base ? ScatterNumber(p, tp) : ScatterString(p, tp);
 }
 
+// Scatters slices of a single element with typed stores, as a memcpy call per element dominates the copy otherwise.
+template <typename T>
+static bool TryScatterElements(const uint8_t* input_base, uint8_t* output_base, uint64_t bytes_to_copy,
+                               const std::vector<uint64_t>& element_offsets, concurrency::ThreadPool* tp) {
+  if (bytes_to_copy != sizeof(T) ||
+      reinterpret_cast<uintptr_t>(input_base) % alignof(T) != 0 ||
+      reinterpret_cast<uintptr_t>(output_base) % alignof(T) != 0) {
+    return false;
+  }
+
+  const T* input = reinterpret_cast<const T*>(input_base);
+  T* output = reinterpret_cast<T*>(output_base);
+  concurrency::ThreadPool::TryParallelFor(tp, element_offsets.size(), static_cast<double>(sizeof(T)),
+                                          [&](ptrdiff_t first, ptrdiff_t last) {
+                                            for (ptrdiff_t i = first; i < last; ++i) {
+                                              output[element_offsets[i]] = input[i];
+                                            }
+                                          });
+  return true;
+}
+
 Status ScatterND::ScatterNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
-  auto lambda = [&](int64_t i) {
+  if (TryScatterElements<uint8_t>(p.input_base, p.output_base, p.bytes_to_copy, p.element_offsets, tp) ||
+      TryScatterElements<uint16_t>(p.input_base, p.output_base, p.bytes_to_copy, p.element_offsets, tp) ||
+      TryScatterElements<uint32_t>(p.input_base, p.output_base, p.bytes_to_copy, p.element_offsets, tp) ||
+      TryScatterElements<uint64_t>(p.input_base, p.output_base, p.bytes_to_copy, p.element_offsets, tp)) {
+    return Status::OK();
+  }
+
+  auto lambda = [&](ptrdiff_t i) {
     memcpy(p.output_base + p.element_offsets[i] * p.element_bytes,
            p.input_base + i * p.bytes_to_copy,
            p.bytes_to_copy);
   };
   concurrency::ThreadPool::TryParallelFor(tp, p.element_offsets.size(), static_cast<double>(p.bytes_to_copy),
                                           [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
+                                            for (ptrdiff_t i = first; i < last; ++i) {
                                               lambda(i);
                                             }
                                           });
@@ -140,14 +168,14 @@ Status ScatterND::ScatterNumber(const Prepare& p, concurrency::ThreadPool* tp) c
 }
 
 Status ScatterND::ScatterString(const Prepare& p, concurrency::ThreadPool* tp) const {
-  auto lambda = [&](int64_t i) {
+  auto lambda = [&](ptrdiff_t i) {
     for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
       p.output_str_base[p.element_offsets[i] + j] = p.input_str_base[i * p.element_to_copy + j];
     }
   };
   concurrency::ThreadPool::TryParallelFor(tp, p.element_offsets.size(), static_cast<double>(p.element_to_copy),
                                           [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
+                                            for (ptrdiff_t i = first; i < last; ++i) {
                                               lambda(i);
                                             }
                                           });
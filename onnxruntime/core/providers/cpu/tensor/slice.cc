@@ -14,7 +14,7 @@ namespace onnxruntime {
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     1, 9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).MayView(0, 0),
     Slice1);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
@@ -23,7 +23,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
         .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(),
-                                 DataTypeImpl::GetTensorType<int64_t>()}),
+                                 DataTypeImpl::GetTensorType<int64_t>()})
+        .MayView(0, 0),
     Slice10);
 
 ONNX_CPU_OPERATOR_KERNEL(
@@ -32,7 +33,8 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
         .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(),
-                                 DataTypeImpl::GetTensorType<int64_t>()}),
+                                 DataTypeImpl::GetTensorType<int64_t>()})
+        .MayView(0, 0),
     Slice10);
 
 namespace {
@@ -264,6 +266,47 @@ void SliceBase::FillVectorsFromInput(const Tensor& start_tensor,
   }
 }
 
+// Creates the output as a view of the input if the slice is a contiguous range of it: the axes keep all of the input
+// data from the innermost one out until one sliced with a step of 1, and all the axes before it have a single value.
+// starts and steps match flattened_output_dims if the innermost dims were combined.
+static bool TryCreateOutputView(OpKernelContext* ctx,
+                                const Tensor& input_tensor,
+                                const std::vector<int64_t>& output_dims,
+                                const std::vector<int64_t>* flattened_output_dims,
+                                const std::vector<int64_t>& starts,
+                                const std::vector<int64_t>& steps) {
+  if (input_tensor.IsDataTypeString() || TensorShape(output_dims).Size() == 0)
+    return false;
+
+  const auto& dims = flattened_output_dims ? *flattened_output_dims : output_dims;
+  const size_t num_dims = dims.size();
+  std::vector<int64_t> input_dims(input_tensor.Shape().GetDims());
+  input_dims.resize(num_dims);
+  if (flattened_output_dims)
+    input_dims.back() = dims.back();
+
+  size_t axis = num_dims;
+  while (axis > 0 && steps[axis - 1] == 1 && dims[axis - 1] == input_dims[axis - 1])
+    --axis;
+
+  if (axis > 0 && steps[axis - 1] != 1 && dims[axis - 1] != 1)
+    return false;
+  for (size_t i = 0; i + 1 < axis; ++i) {
+    if (dims[i] != 1)
+      return false;
+  }
+
+  int64_t offset = 0;
+  int64_t pitch = 1;
+  for (size_t i = num_dims; i > 0; --i) {
+    offset += starts[i - 1] * pitch;
+    pitch *= input_dims[i - 1];
+  }
+
+  const size_t byte_offset = static_cast<size_t>(offset) * input_tensor.DataType()->Size();
+  return ctx->OutputView(0, TensorShape(output_dims), 0, byte_offset) != nullptr;
+}
+
 template <typename T>
 static Status SliceImpl(OpKernelContext* ctx,
                         const Tensor& input_tensor,
@@ -348,6 +391,9 @@ Status SliceBase::Compute(OpKernelContext* ctx) const {
                                           p_flattened_output_dims));
   }
 
+  if (TryCreateOutputView(ctx, input_tensor, output_dims, p_flattened_output_dims, starts, steps))
+    return Status::OK();
+
   Status status = Status::OK();
 
   if (input_tensor.IsDataTypeString()) {
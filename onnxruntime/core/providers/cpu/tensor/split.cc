@@ -5,6 +5,7 @@
 #include "core/providers/common.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/platform/threadpool.h"
 
 #include "gsl/gsl"
 
@@ -19,7 +20,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
                                           DataTypeImpl::GetTensorType<float>(),
                                           DataTypeImpl::GetTensorType<int32_t>(),
                                           DataTypeImpl::GetTensorType<int64_t>(),
-                                          DataTypeImpl::GetTensorType<std::string>()}),
+                                          DataTypeImpl::GetTensorType<std::string>()})
+        .MayView(0, -1),
     Split);
 
 // Opset 11 starts to support Neg Axis.
@@ -31,7 +33,8 @@ ONNX_CPU_OPERATOR_KERNEL(
                                           DataTypeImpl::GetTensorType<float>(),
                                           DataTypeImpl::GetTensorType<int32_t>(),
                                           DataTypeImpl::GetTensorType<int64_t>(),
-                                          DataTypeImpl::GetTensorType<std::string>()}),
+                                          DataTypeImpl::GetTensorType<std::string>()})
+        .MayView(0, -1),
     Split);
 
 Status SplitBase::PrepareForCompute(const TensorShape& input_shape, int num_outputs, int64_t& axis, int& before_dims,
@@ -132,18 +135,33 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
     auto split_size = gsl::narrow<int>(split_sizes[i]);
     output_dimensions[axis] = split_size;
 
+    // with no dims before the axis each output is a contiguous range of the input, so it may be a view of it
+    const size_t byte_offset = static_cast<size_t>(input_offset) * sizeof(T);
+    if (before_dims == 1 && !input.IsDataTypeString() &&
+        context.OutputView(i, TensorShape{output_dimensions}, 0, byte_offset) != nullptr) {
+      input_offset += split_size * after_dims_excluding_split;
+      continue;
+    }
+
     Tensor* output = context.Output(i, TensorShape{output_dimensions});
     T* output_data = output->template MutableData<T>();
 
-    ::onnxruntime::math::CopyMatrix<T>(
-        before_dims,                                       // M
-        split_size * after_dims_excluding_split,           // N
-        static_cast<const T*>(input_data + input_offset),  // A
-        after_dims_including_split_axis,                   // lda
-        static_cast<T*>(output_data),                      // B
-        split_size * after_dims_excluding_split,           // ldb
-        [](const T* src, T* dst, size_t count) {
-          copy_data<T>(src, dst, count);
+    // copy the rows of the output from the input, split in ranges of values across the threads
+    const int64_t row_size = split_size * after_dims_excluding_split;
+    const T* rows_data = input_data + input_offset;
+    concurrency::ThreadPool::TryParallelFor(
+        context.GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(before_dims * row_size),
+        TensorOpCost{static_cast<double>(sizeof(T)), static_cast<double>(sizeof(T)), 0.0},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          int64_t output_offset = first;
+          while (output_offset < last) {
+            const int64_t row = output_offset / row_size;
+            const int64_t offset_in_row = output_offset % row_size;
+            const int64_t count = std::min(row_size - offset_in_row, static_cast<int64_t>(last) - output_offset);
+            copy_data<T>(rows_data + row * after_dims_including_split_axis + offset_in_row,
+                         output_data + output_offset, static_cast<size_t>(count));
+            output_offset += count;
+          }
         });
 
     input_offset += split_size * after_dims_excluding_split;  // offset by the N data we used in this iteration
@@ -3,6 +3,11 @@
 
 #include "core/providers/cpu/tensor/transpose.h"
 #include "core/framework/utils.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+#include <numeric>
+
 namespace onnxruntime {
 
 /* A permutation [a,b,c,...] indicates that 
@@ -531,9 +536,169 @@ static bool IsMovingSingleAxis(const std::vector<size_t>& permutations, size_t&
   return single_axis_moved;
 }
 
+/*
+Optimizations based on the permutation with the axes of size 1 removed, and the input axes that stay adjacent and in
+order in the output merged, which doesn't change the memory order of the input or the output.
+
+  e.g. transposing NCHW with shape {N, C, H, W} to NHWC is perm [0, 2, 3, 1], which reduces to [0, 2, 1] for the
+       input {N, C, H*W}. With N = 1 it reduces further to [1, 0] for the input {C, H*W}.
+
+If the reduced permutation has at most one axis the data is copied as is, e.g. when the permutation only moves axes
+of size 1.
+
+If it swaps two axes, optionally with a batch axis before them and a block of contiguous elements after them, each
+batch is a 2D transpose of blocks. If the block is 1, 2, 4 or 8 bytes, MlasTranspose transposes it with tiles of
+vector registers, and large transposes are split on the rows across threads.
+*/
+
+// Reduces the permutation as described above. `reduced_dims` are the dims of the reduced input.
+static void ReducePermutation(const std::vector<int64_t>& input_dims, const std::vector<size_t>& permutations,
+                              std::vector<int64_t>& reduced_dims, std::vector<size_t>& reduced_perm) {
+  const size_t rank = input_dims.size();
+
+  // the output order of the input axes that aren't of size 1
+  std::vector<size_t> perm;
+  for (size_t i = 0; i < rank; ++i) {
+    if (input_dims[permutations[i]] != 1) {
+      perm.push_back(permutations[i]);
+    }
+  }
+
+  // the first input axis of each group of axes that stay adjacent, in output order, and the size of the groups
+  std::vector<size_t> group_first_axis;
+  std::vector<int64_t> group_size;
+  for (size_t i = 0; i < perm.size(); ++i) {
+    bool extends_group = false;
+    if (i > 0 && perm[i] > perm[i - 1]) {
+      // the axes between the previous axis and this one must all be of size 1
+      extends_group = true;
+      for (size_t axis = perm[i - 1] + 1; axis < perm[i]; ++axis) {
+        if (input_dims[axis] != 1) {
+          extends_group = false;
+          break;
+        }
+      }
+    }
+
+    if (extends_group) {
+      group_size.back() *= input_dims[perm[i]];
+    } else {
+      group_first_axis.push_back(perm[i]);
+      group_size.push_back(input_dims[perm[i]]);
+    }
+  }
+
+  // the groups are the axes of the reduced input in the order of their first input axis
+  const size_t reduced_rank = group_first_axis.size();
+  std::vector<size_t> input_order(reduced_rank);
+  std::iota(input_order.begin(), input_order.end(), 0);
+  std::sort(input_order.begin(), input_order.end(),
+            [&group_first_axis](size_t lhs, size_t rhs) { return group_first_axis[lhs] < group_first_axis[rhs]; });
+
+  reduced_dims.resize(reduced_rank);
+  reduced_perm.resize(reduced_rank);
+  for (size_t reduced_axis = 0; reduced_axis < reduced_rank; ++reduced_axis) {
+    const size_t group = input_order[reduced_axis];
+    reduced_dims[reduced_axis] = group_size[group];
+    reduced_perm[group] = reduced_axis;
+  }
+}
+
+template <typename T>
+static void BatchedTransposeWithMlas(const T* input_data, T* output_data, int64_t num_batches, int64_t rows,
+                                     int64_t cols, concurrency::ThreadPool* tp) {
+  // split the rows of each batch in blocks for the threads
+  constexpr int64_t kRowsPerBlock = 64;
+  const int64_t blocks_per_batch = (rows + kRowsPerBlock - 1) / kRowsPerBlock;
+  const int64_t matrix_size = rows * cols;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_batches * blocks_per_batch),
+      TensorOpCost{static_cast<double>(kRowsPerBlock * cols * sizeof(T)),
+                   static_cast<double>(kRowsPerBlock * cols * sizeof(T)),
+                   static_cast<double>(kRowsPerBlock * cols)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const int64_t batch = block / blocks_per_batch;
+          const int64_t row = (block % blocks_per_batch) * kRowsPerBlock;
+          const int64_t num_rows = std::min(kRowsPerBlock, rows - row);
+          MlasTranspose(input_data + batch * matrix_size + row * cols, static_cast<size_t>(cols),
+                        output_data + batch * matrix_size + row, static_cast<size_t>(rows),
+                        static_cast<size_t>(num_rows), static_cast<size_t>(cols));
+        }
+      });
+}
+
+// Transposes with the reduced permutation if it is a copy, or a batched 2D transpose that MlasTranspose supports.
+// Returns false if the transpose needs the general implementation.
+static bool TryTransposeReduced(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                const TensorShape& input_shape, concurrency::ThreadPool* tp) {
+  std::vector<int64_t> dims;
+  std::vector<size_t> perm;
+  ReducePermutation(input_shape.GetDims(), permutations, dims, perm);
+
+  if (perm.size() <= 1) {
+    if (input.IsDataTypeString()) {
+      DoTransposeSingleBlock(static_cast<size_t>(input_shape.Size()), input.template Data<std::string>(),
+                             output.template MutableData<std::string>());
+    } else {
+      DoTransposeSingleBlock(static_cast<size_t>(input_shape.Size()), input.DataRaw(), output.MutableDataRaw(),
+                             input.DataType()->Size());
+    }
+    return true;
+  }
+
+  if (input.IsDataTypeString()) {
+    return false;
+  }
+
+  // match [batch], rows, cols, [block] transposed to [batch], cols, rows, [block]
+  size_t axis = 0;
+  int64_t num_batches = 1;
+  if (perm[0] == 0) {
+    num_batches = dims[axis++];
+  }
+
+  if (perm.size() < axis + 2 || perm[axis] != axis + 1 || perm[axis + 1] != axis) {
+    return false;
+  }
+
+  const int64_t rows = dims[axis];
+  const int64_t cols = dims[axis + 1];
+  int64_t block_size = 1;
+  if (perm.size() == axis + 3) {
+    block_size = dims[axis + 2];
+  } else if (perm.size() != axis + 2) {
+    return false;
+  }
+
+  const auto* input_data = input.DataRaw();
+  auto* output_data = output.MutableDataRaw();
+  switch (block_size * input.DataType()->Size()) {
+    case sizeof(uint8_t):
+      BatchedTransposeWithMlas(static_cast<const uint8_t*>(input_data), static_cast<uint8_t*>(output_data),
+                               num_batches, rows, cols, tp);
+      return true;
+    case sizeof(uint16_t):
+      BatchedTransposeWithMlas(static_cast<const uint16_t*>(input_data), static_cast<uint16_t*>(output_data),
+                               num_batches, rows, cols, tp);
+      return true;
+    case sizeof(uint32_t):
+      BatchedTransposeWithMlas(static_cast<const uint32_t*>(input_data), static_cast<uint32_t*>(output_data),
+                               num_batches, rows, cols, tp);
+      return true;
+    case sizeof(uint64_t):
+      BatchedTransposeWithMlas(static_cast<const uint64_t*>(input_data), static_cast<uint64_t*>(output_data),
+                               num_batches, rows, cols, tp);
+      return true;
+    default:
+      return false;
+  }
+}
+
 //`input_shape_override` overrides the shape of `input` for compute purposes.
 Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
-                                  const TensorShape* input_shape_override) {
+                                  const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
   Status status = Status::OK();
 
   auto input_type = input.DataType();
@@ -542,7 +707,8 @@ Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const
   if (input_type != output_type) {
     status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Mismatched data types between input and output Tensors. ",
                              input_type, " != ", output_type);
-  } else {
+  } else if (!TryTransposeReduced(permutations, input, output,
+                                  input_shape_override ? *input_shape_override : input.Shape(), tp)) {
     size_t from = 0, to = 0;
     bool moving_single_axis = IsMovingSingleAxis(permutations, from, to);
 
@@ -578,17 +744,7 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
   if (output_shape.Size() == 0)
     return Status::OK();
 
-  size_t from = 0, to = 0;
-  bool moving_single_axis = IsMovingSingleAxis(*p_perm, from, to);
-
-  if (moving_single_axis && !X.IsDataTypeString()) {
-    SingleAxisTranspose(*p_perm, X, Y, from, to);
-  } else {
-    // fall back to default implementation
-    status = DoUntypedTranspose(*p_perm, X, Y);
-  }
-
-  return status;
+  return DoTranspose(*p_perm, X, Y, nullptr, ctx->GetOperatorThreadPool());
 }
 
 ONNX_CPU_OPERATOR_KERNEL(
@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/upsample.h"
 #include "core/common/safeint.h"
+#include "core/platform/threadpool.h"
 #include <sstream>
 
 using namespace onnxruntime::common;
@@ -278,117 +279,156 @@ Status UpsampleLinear(const T* input,
   return Status::OK();
 }
 
+// Bilinear and bicubic resizing work on the two innermost spatial axes of 2-D [H, W], 4-D [N, C, H, W] or, with
+// channels_last, 4-D [N, H, W, C] inputs. The inputs are viewed as num_images images of
+// [height, width, pixel_size] where pixel_size is C for [N, H, W, C] and 1 otherwise.
+// The interpolation coefficients are computed once per output position of each axis, and the output rows are
+// computed in parallel.
+struct ResizeImageShape {
+  int64_t num_images;
+  int64_t pixel_size;
+  int64_t input_height;
+  int64_t input_width;
+  int64_t output_height;
+  int64_t output_width;
+};
+
+// Coefficients of linear interpolation along one axis: for each output position, the two input positions around
+// its original coordinate and their distances to it, and the original coordinate which decides extrapolation.
+struct LinearAxisCoeffs {
+  std::vector<float> original;
+  std::vector<int64_t> in1;
+  std::vector<int64_t> in2;
+  std::vector<float> d1;
+  std::vector<float> d2;
+};
+
+static LinearAxisCoeffs ComputeLinearAxisCoeffs(int64_t input_size, int64_t output_size, float scale,
+                                                float roi_start, float roi_end,
+                                                const GetOriginalCoordinateFunc& get_original_coordinate) {
+  LinearAxisCoeffs coeffs;
+  coeffs.original.resize(output_size);
+  coeffs.in1.resize(output_size);
+  coeffs.in2.resize(output_size);
+  coeffs.d1.resize(output_size);
+  coeffs.d2.resize(output_size);
+
+  for (int64_t i = 0; i < output_size; ++i) {
+    float in = get_original_coordinate(static_cast<float>(i), scale,
+                                       static_cast<float>(output_size), static_cast<float>(input_size),
+                                       roi_start, roi_end);
+    coeffs.original[i] = in;
+    in = std::max(0.0f, std::min(in, static_cast<float>(input_size - 1)));
+
+    coeffs.in1[i] = std::min(static_cast<int64_t>(in), input_size - 1);
+    coeffs.in2[i] = std::min(coeffs.in1[i] + 1, input_size - 1);
+    coeffs.d1[i] = std::fabs(in - coeffs.in1[i]);
+    coeffs.d2[i] = std::fabs(in - coeffs.in2[i]);
+
+    if (coeffs.in1[i] == coeffs.in2[i]) {
+      coeffs.d1[i] = 0.5f;
+      coeffs.d2[i] = 0.5f;
+    }
+  }
+
+  return coeffs;
+}
+
 // The following method supports a 4-D input in 'Linear mode'
 // that amounts to 'Bilinear' Upsampling/Resizing in the sense that it assumes
 // the scale values for the outermost 2 dimensions are 1.
 // This is the common use-case where the 4-D input (batched multi-channel images)
-// is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale]
+// is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale],
+// or of shape [N, H, W, C] with the scales [1.0, height_scale, width_scale, 1.0].
 template <typename T>
-void UpsampleBilinear(int64_t batch_size,
-                      int64_t num_channels,
-                      int64_t input_height,
-                      int64_t input_width,
-                      int64_t output_height,
-                      int64_t output_width,
+void UpsampleBilinear(const ResizeImageShape& shape,
                       float height_scale,
                       float width_scale,
-                      const std::vector<float>& roi,
+                      float roi_y_start, float roi_y_end,
+                      float roi_x_start, float roi_x_end,
                       bool use_extrapolation,
                       float extrapolation_value,
                       const T* Xdata,
                       T* Ydata,
-                      AllocatorPtr& alloc,
-                      GetOriginalCoordinateFunc get_original_coordinate) {
-  std::vector<float> y_original;
-  std::vector<float> x_original;
-
-  SafeInt<size_t> idx_buffer_size = SafeInt<size_t>(2) * sizeof(int64_t) * (output_height + output_width);
-  SafeInt<size_t> scale_buffer_size = SafeInt<size_t>(2) * sizeof(float_t) * (output_height + output_width);
-  auto inx_scale_data_buffer = alloc->Alloc(idx_buffer_size + scale_buffer_size);
-  BufferUniquePtr idx_scale_data_buffer_holder(inx_scale_data_buffer, BufferDeleter(alloc));
-  auto* idx_data = static_cast<int64_t*>(idx_scale_data_buffer_holder.get());
-  int64_t* input_width_mul_y1 = idx_data;
-  int64_t* input_width_mul_y2 = idx_data + output_height;
-  int64_t* in_x1 = idx_data + 2 * output_height;
-  int64_t* in_x2 = idx_data + 2 * output_height + output_width;
-
-  auto* scale_data = reinterpret_cast<float*>(in_x2 + output_width);
-  float* dy1 = scale_data;
-  float* dy2 = scale_data + output_height;
-  float* dx1 = scale_data + 2 * output_height;
-  float* dx2 = scale_data + 2 * output_height + output_width;
-
-  auto roi_y_start = roi.size() / 2 - 2;
-  auto roi_y_end = roi.size() - 2;
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = get_original_coordinate(static_cast<float>(y), height_scale,
-                                         static_cast<float>(output_height), static_cast<float>(input_height),
-                                         roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    in_y = std::max(0.0f, std::min(in_y, static_cast<float>(input_height - 1)));
-
-    const int64_t in_y1 = std::min(static_cast<int64_t>(in_y), input_height - 1);
-    const int64_t in_y2 = std::min(in_y1 + 1, input_height - 1);
-    dy1[y] = std::fabs(in_y - in_y1);
-    dy2[y] = std::fabs(in_y - in_y2);
-
-    if (in_y1 == in_y2) {
-      dy1[y] = 0.5f;
-      dy2[y] = 0.5f;
+                      concurrency::ThreadPool* tp,
+                      const GetOriginalCoordinateFunc& get_original_coordinate) {
+  const int64_t input_height = shape.input_height;
+  const int64_t input_width = shape.input_width;
+  const int64_t output_height = shape.output_height;
+  const int64_t output_width = shape.output_width;
+  const int64_t pixel_size = shape.pixel_size;
+
+  const LinearAxisCoeffs y_coeffs = ComputeLinearAxisCoeffs(input_height, output_height, height_scale,
+                                                            roi_y_start, roi_y_end, get_original_coordinate);
+  const LinearAxisCoeffs x_coeffs = ComputeLinearAxisCoeffs(input_width, output_width, width_scale,
+                                                            roi_x_start, roi_x_end, get_original_coordinate);
+
+  // when use_extrapolation is set and original index of x or y is out of the dim range
+  // then use extrapolation_value as the output value.
+  auto out_of_range = [](float original, int64_t input_size) {
+    return original < 0 || original > static_cast<float>(input_size - 1);
+  };
+
+  std::vector<uint8_t> x_extrapolated(output_width, 0);
+  if (use_extrapolation) {
+    for (int64_t x = 0; x < output_width; ++x) {
+      x_extrapolated[x] = out_of_range(x_coeffs.original[x], input_width);
     }
-
-    input_width_mul_y1[y] = input_width * in_y1;
-    input_width_mul_y2[y] = input_width * in_y2;
   }
 
-  auto roi_x_start = roi.size() / 2 - 1;
-  auto roi_x_end = roi.size() - 1;
+  // the input offsets of the columns, in elements
+  std::vector<int64_t> in_x1(output_width);
+  std::vector<int64_t> in_x2(output_width);
   for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = get_original_coordinate(static_cast<float>(x), width_scale,
-                                         static_cast<float>(output_width), static_cast<float>(input_width),
-                                         roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    in_x = std::max(0.0f, std::min(in_x, static_cast<float>(input_width - 1)));
-
-    in_x1[x] = std::min(static_cast<int64_t>(in_x), input_width - 1);
-    in_x2[x] = std::min(in_x1[x] + 1, input_width - 1);
-
-    dx1[x] = std::abs(in_x - in_x1[x]);
-    dx2[x] = std::abs(in_x - in_x2[x]);
-    if (in_x1[x] == in_x2[x]) {
-      dx1[x] = 0.5f;
-      dx2[x] = 0.5f;
-    }
+    in_x1[x] = x_coeffs.in1[x] * pixel_size;
+    in_x2[x] = x_coeffs.in2[x] * pixel_size;
   }
 
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        for (int64_t x = 0; x < output_width; ++x) {
-          // when use_extrapolation is set and original index of x or y is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation &&
-              ((y_original[y] < 0 || y_original[y] > static_cast<float>(input_height - 1)) ||
-               (x_original[x] < 0 || x_original[x] > static_cast<float>(input_width - 1)))) {
-            Ydata[output_width * y + x] = static_cast<T>(extrapolation_value);
-            continue;
-          }
+  const int64_t input_image_size = input_height * input_width * pixel_size;
+  const int64_t output_row_size = output_width * pixel_size;
+
+  auto compute_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const int64_t image = row / output_height;
+      const int64_t y = row % output_height;
+      T* Yrow = Ydata + row * output_row_size;
+
+      if (use_extrapolation && out_of_range(y_coeffs.original[y], input_height)) {
+        std::fill_n(Yrow, output_row_size, static_cast<T>(extrapolation_value));
+        continue;
+      }
 
-          T X11 = Xdata[input_width_mul_y1[y] + in_x1[x]];
-          T X21 = Xdata[input_width_mul_y1[y] + in_x2[x]];
-          T X12 = Xdata[input_width_mul_y2[y] + in_x1[x]];
-          T X22 = Xdata[input_width_mul_y2[y] + in_x2[x]];
+      const T* X1 = Xdata + image * input_image_size + y_coeffs.in1[y] * input_width * pixel_size;
+      const T* X2 = Xdata + image * input_image_size + y_coeffs.in2[y] * input_width * pixel_size;
+      const float dy1 = y_coeffs.d1[y];
+      const float dy2 = y_coeffs.d2[y];
 
-          Ydata[output_width * y + x] = static_cast<T>(dx2[x] * dy2[y] * X11 +
-                                                       dx1[x] * dy2[y] * X21 +
-                                                       dx2[x] * dy1[y] * X12 +
-                                                       dx1[x] * dy1[y] * X22);
+      for (int64_t x = 0; x < output_width; ++x) {
+        T* Y = Yrow + x * pixel_size;
+        if (x_extrapolated[x]) {
+          std::fill_n(Y, pixel_size, static_cast<T>(extrapolation_value));
+          continue;
+        }
+
+        const float w11 = x_coeffs.d2[x] * dy2;
+        const float w21 = x_coeffs.d1[x] * dy2;
+        const float w12 = x_coeffs.d2[x] * dy1;
+        const float w22 = x_coeffs.d1[x] * dy1;
+        const T* X11 = X1 + in_x1[x];
+        const T* X21 = X1 + in_x2[x];
+        const T* X12 = X2 + in_x1[x];
+        const T* X22 = X2 + in_x2[x];
+
+        // the channels of a pixel are contiguous with channels_last, so this loop is vectorized
+        for (int64_t c = 0; c < pixel_size; ++c) {
+          Y[c] = static_cast<T>(w11 * X11[c] + w21 * X21[c] + w12 * X12[c] + w22 * X22[c]);
         }
       }
-      Xdata += input_height * input_width;
-      Ydata += output_width * output_height;
     }
-  }
+  };
+
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(shape.num_images * output_height),
+                                          static_cast<double>(output_row_size * 8), compute_rows);
 }
 
 // Calculates cubic coeff based on Robert Keys approach
@@ -403,189 +443,159 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
-}
-
-// Computes cubic convolution interpolation in 1D
-template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
-  }
-
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[i] / coeff_sum * orig_data;
-  }
-  cache[grid_start_pos] = result;
-
-  return result;
-}
-#if defined(_MSC_VER)
-#pragma warning(push)
-#pragma warning(disable : 6001)
-#endif
-template <typename T>
-void ResizeBiCubic(
-    int64_t batch_size,
-    int64_t num_channels,
-    int64_t input_height,
-    int64_t input_width,
-    int64_t output_height,
-    int64_t output_width,
-    float height_scale,
-    float width_scale,
-    float cubic_coeff_a,
-    bool use_extrapolation,
-    float extrapolation_value,
-    bool exclude_outside,
-    const std::vector<float>& roi,
-    const T* Xdata,
-    T* Ydata,
-    GetOriginalCoordinateFunc get_original_coordinate) {
-  std::vector<float> y_original;
-  std::vector<float> x_original;
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
-  auto roi_y_start = roi.size() / 2 - 2;
-  auto roi_y_end = roi.size() - 2;
-  auto roi_x_start = roi.size() / 2 - 1;
-  auto roi_x_end = roi.size() - 1;
-
-  // generate coefficients in y direction
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = get_original_coordinate(static_cast<float>(y), height_scale,
-                                         static_cast<float>(output_height), static_cast<float>(input_height),
-                                         roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[y] - std::floor(y_original[y]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
+// Coefficients of cubic interpolation along one axis: for each output position, the CubicModeGridLength input
+// positions around its original coordinate, clamped to the input, and their weights, and the original coordinate
+// which decides extrapolation.
+struct CubicAxisCoeffs {
+  std::vector<float> original;
+  std::vector<int64_t> in;
+  std::vector<float> weights;
+};
+
+static CubicAxisCoeffs ComputeCubicAxisCoeffs(int64_t input_size, int64_t output_size, float scale,
+                                              float roi_start, float roi_end, float cubic_coeff_a,
+                                              bool exclude_outside,
+                                              const GetOriginalCoordinateFunc& get_original_coordinate) {
+  CubicAxisCoeffs coeffs;
+  coeffs.original.resize(output_size);
+  coeffs.in.resize(output_size * CubicModeGridLength);
+  coeffs.weights.resize(output_size * CubicModeGridLength);
+
+  for (int64_t i = 0; i < output_size; ++i) {
+    const float in = get_original_coordinate(static_cast<float>(i), scale,
+                                             static_cast<float>(output_size), static_cast<float>(input_size),
+                                             roi_start, roi_end);
+    coeffs.original[i] = in;
+
+    const auto in_int = static_cast<int64_t>(std::floor(in));
+    std::array<float, CubicModeGridLength> cubic_coeffs = GetCubicCoeffs(in - in_int, cubic_coeff_a);
+    float coeff_sum = 1;
+
+    if (exclude_outside) {
+      // When true, the weight of sampling locations outside the grid will be set to 0
+      // and the weight will be renormalized so that their sum is 1.0
+      coeff_sum = 0;
+      for (int64_t g = 0, in_val = in_int - 1; g < static_cast<int64_t>(CubicModeGridLength); ++g, ++in_val) {
+        if (in_val < 0 || in_val >= input_size) {
+          cubic_coeffs[g] = 0.0f;
+        }
+        coeff_sum += cubic_coeffs[g];
+      }
     }
-  }
 
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = get_original_coordinate(static_cast<float>(x), width_scale,
-                                         static_cast<float>(output_width), static_cast<float>(input_width),
-                                         roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[x] - std::floor(x_original[x]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
+    for (int64_t g = 0, in_val = in_int - 1; g < static_cast<int64_t>(CubicModeGridLength); ++g, ++in_val) {
+      coeffs.in[i * CubicModeGridLength + g] = std::max(static_cast<int64_t>(0), std::min(in_val, input_size - 1));
+      coeffs.weights[i * CubicModeGridLength + g] = cubic_coeffs[g] / coeff_sum;
     }
   }
 
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
-
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[y];
-
-        // when use_extrapolation is set and original index is out of the dim range
-        // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
-          }
-          continue;
-        }
+  return coeffs;
+}
 
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[i] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[i];
-            y_coeff_sum += y_coeff_holder[i];
+// Bicubic resizing as two separable passes: each input row is interpolated along the width into a temporary
+// buffer, and then the output rows are interpolated along the height from the rows of the temporary buffer, which
+// is a vectorized weighted sum of contiguous rows.
+template <typename T>
+void ResizeBiCubic(const ResizeImageShape& shape,
+                   float height_scale,
+                   float width_scale,
+                   float cubic_coeff_a,
+                   bool use_extrapolation,
+                   float extrapolation_value,
+                   bool exclude_outside,
+                   float roi_y_start, float roi_y_end,
+                   float roi_x_start, float roi_x_end,
+                   const T* Xdata,
+                   T* Ydata,
+                   AllocatorPtr& alloc,
+                   concurrency::ThreadPool* tp,
+                   const GetOriginalCoordinateFunc& get_original_coordinate) {
+  const int64_t input_height = shape.input_height;
+  const int64_t input_width = shape.input_width;
+  const int64_t output_height = shape.output_height;
+  const int64_t output_width = shape.output_width;
+  const int64_t pixel_size = shape.pixel_size;
+  const int64_t input_row_size = input_width * pixel_size;
+  const int64_t output_row_size = output_width * pixel_size;
+
+  const CubicAxisCoeffs y_coeffs = ComputeCubicAxisCoeffs(input_height, output_height, height_scale,
+                                                          roi_y_start, roi_y_end, cubic_coeff_a, exclude_outside,
+                                                          get_original_coordinate);
+  const CubicAxisCoeffs x_coeffs = ComputeCubicAxisCoeffs(input_width, output_width, width_scale,
+                                                          roi_x_start, roi_x_end, cubic_coeff_a, exclude_outside,
+                                                          get_original_coordinate);
+
+  // the input rows interpolated along the width
+  const SafeInt<size_t> num_input_rows = SafeInt<size_t>(shape.num_images) * input_height;
+  auto* width_interpolated_data = alloc->Alloc(num_input_rows * output_row_size * sizeof(float));
+  BufferUniquePtr width_interpolated_holder(width_interpolated_data, BufferDeleter(alloc));
+  auto* width_interpolated = static_cast<float*>(width_interpolated_holder.get());
+
+  auto interpolate_width = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const T* Xrow = Xdata + row * input_row_size;
+      float* temp_row = width_interpolated + row * output_row_size;
+      for (int64_t x = 0; x < output_width; ++x) {
+        const int64_t* in_x = x_coeffs.in.data() + x * CubicModeGridLength;
+        const float* weights = x_coeffs.weights.data() + x * CubicModeGridLength;
+        for (int64_t c = 0; c < pixel_size; ++c) {
+          float result = 0;
+          for (size_t g = 0; g < CubicModeGridLength; ++g) {
+            result += weights[g] * Xrow[in_x[g] * pixel_size + c];
           }
+          temp_row[x * pixel_size + c] = result;
         }
+      }
+    }
+  };
+
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(num_input_rows),
+                                          static_cast<double>(output_row_size * CubicModeGridLength * 2),
+                                          interpolate_width);
+
+  auto out_of_range = [](float original, int64_t input_size) {
+    return original < 0 || original > static_cast<float>(input_size - 1);
+  };
+
+  auto interpolate_height = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const int64_t image = row / output_height;
+      const int64_t y = row % output_height;
+      T* Yrow = Ydata + row * output_row_size;
+
+      // when use_extrapolation is set and original index is out of the dim range
+      // then use extrapolation_value as the output value.
+      if (use_extrapolation && out_of_range(y_coeffs.original[y], input_height)) {
+        std::fill_n(Yrow, output_row_size, static_cast<T>(extrapolation_value));
+        continue;
+      }
 
-        for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[x];
-
-          // when use_extrapolation is set and original index is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
-            continue;
-          }
+      const float* temp_image = width_interpolated + image * input_height * output_row_size;
+      const float* temp_rows[CubicModeGridLength];
+      const float* weights = y_coeffs.weights.data() + y * CubicModeGridLength;
+      for (size_t g = 0; g < CubicModeGridLength; ++g) {
+        temp_rows[g] = temp_image + y_coeffs.in[y * CubicModeGridLength + g] * output_row_size;
+      }
 
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[i] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[i];
-              x_coeff_sum += x_coeff_holder[i];
-            }
-          }
+      for (int64_t i = 0; i < output_row_size; ++i) {
+        Yrow[i] = static_cast<T>(weights[0] * temp_rows[0][i] + weights[1] * temp_rows[1][i] +
+                                 weights[2] * temp_rows[2][i] + weights[3] * temp_rows[3][i]);
+      }
 
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[i] / y_coeff_sum;
+      if (use_extrapolation) {
+        for (int64_t x = 0; x < output_width; ++x) {
+          if (out_of_range(x_coeffs.original[x], input_width)) {
+            std::fill_n(Yrow + x * pixel_size, pixel_size, static_cast<T>(extrapolation_value));
           }
-
-          Ydata[y * output_width + x] = static_cast<T>(result);
         }
       }
-
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
-
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
     }
-  }
+  };
+
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(shape.num_images * output_height),
+                                          static_cast<double>(output_row_size * CubicModeGridLength * 2),
+                                          interpolate_height);
 }
-#if defined(_MSC_VER)
-#pragma warning(pop)
-#endif
 
 template <typename T>
 Status Upsample<T>::BaseCompute(OpKernelContext* context,
@@ -628,9 +638,11 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
       return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(),
                                 scales, roi, is_resize_, use_extrapolation_, extrapolation_value_,
                                 use_nearest2x_optimization_, get_original_coordinate_, get_nearest_pixel_);
-    case UpsampleMode::LINEAR: {
+    case UpsampleMode::LINEAR:
+    case UpsampleMode::CUBIC: {
       //The correct behavior of 'linear' mode for an N-D input is not clear right now,
-      //so only support 'bilinear' with 2-D or 4-D input tensor with outermost 2 scales as 1 in the 4-D case
+      //so only support 'bilinear' with 2-D or 4-D input tensor with outermost 2 scales as 1 in the 4-D case,
+      //or with the outermost and innermost scales as 1 for a 4-D input with the channels last
       if (dims.size() != 2 && dims.size() != 4) {
         std::ostringstream oss;
         oss << "'Linear' mode only support 2-D inputs ('Bilinear') or 4-D inputs "
@@ -639,35 +651,39 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
         return Status(ONNXRUNTIME, FAIL, oss.str());
       }
 
-      bool is_2D = dims.size() == 2;
-      const int64_t batch_size = is_2D ? 1 : dims[0];
-      const int64_t num_channels = is_2D ? 1 : dims[1];
-      const int64_t input_height = is_2D ? dims[0] : dims[2];
-      const int64_t input_width = is_2D ? dims[1] : dims[3];
-      const int64_t output_height = is_2D ? output_dims[0] : output_dims[2];
-      const int64_t output_width = is_2D ? output_dims[1] : output_dims[3];
-
-      AllocatorPtr alloc;
-      ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-      UpsampleBilinear(batch_size, num_channels, input_height, input_width, output_height, output_width,
-                       is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], roi,
-                       use_extrapolation_, extrapolation_value_, X->template Data<T>(),
-                       Y->template MutableData<T>(), alloc, get_original_coordinate_);
-      return Status::OK();
-    }
-    case UpsampleMode::CUBIC: {
-      bool is_2D = dims.size() == 2;
-      const int64_t batch_size = is_2D ? 1 : dims[0];
-      const int64_t num_channels = is_2D ? 1 : dims[1];
-      const int64_t input_height = is_2D ? dims[0] : dims[2];
-      const int64_t input_width = is_2D ? dims[1] : dims[3];
-      const int64_t output_height = is_2D ? output_dims[0] : output_dims[2];
-      const int64_t output_width = is_2D ? output_dims[1] : output_dims[3];
-
-      ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
-                    is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], cubic_coeff_a_, use_extrapolation_,
-                    extrapolation_value_, exclude_outside_, roi, X->template Data<float>(), Y->template MutableData<float>(),
-                    get_original_coordinate_);
+      const bool is_2D = dims.size() == 2;
+      const bool channels_last = !is_2D && scales[1] != 1.0f;
+      const size_t height_axis = is_2D ? 0 : (channels_last ? 1 : 2);
+      const size_t width_axis = height_axis + 1;
+
+      ResizeImageShape shape;
+      shape.num_images = is_2D ? 1 : (channels_last ? dims[0] : dims[0] * dims[1]);
+      shape.pixel_size = channels_last ? dims[3] : 1;
+      shape.input_height = dims[height_axis];
+      shape.input_width = dims[width_axis];
+      shape.output_height = output_dims[height_axis];
+      shape.output_width = output_dims[width_axis];
+
+      // roi holds the starts of all the axes followed by their ends
+      const size_t rank = dims.size();
+      const float roi_y_start = roi[height_axis];
+      const float roi_y_end = roi[rank + height_axis];
+      const float roi_x_start = roi[width_axis];
+      const float roi_x_end = roi[rank + width_axis];
+
+      auto* tp = context->GetOperatorThreadPool();
+      if (mode_ == UpsampleMode::LINEAR) {
+        UpsampleBilinear(shape, scales[height_axis], scales[width_axis],
+                         roi_y_start, roi_y_end, roi_x_start, roi_x_end,
+                         use_extrapolation_, extrapolation_value_, X->template Data<T>(),
+                         Y->template MutableData<T>(), tp, get_original_coordinate_);
+      } else {
+        AllocatorPtr alloc;
+        ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+        ResizeBiCubic(shape, scales[height_axis], scales[width_axis], cubic_coeff_a_, use_extrapolation_,
+                      extrapolation_value_, exclude_outside_, roi_y_start, roi_y_end, roi_x_start, roi_x_end,
+                      X->template Data<T>(), Y->template MutableData<T>(), alloc, tp, get_original_coordinate_);
+      }
       return Status::OK();
     }
     default:
@@ -277,9 +277,11 @@ class UpsampleBase {
     }
 
     if (UpsampleMode::LINEAR == mode || UpsampleMode::CUBIC == mode) {
-      ORT_ENFORCE(scales.size() == 2 || (scales.size() == 4 && scales[0] == 1 && scales[1] == 1),
+      // 4-D inputs are [N, C, H, W], or [N, H, W, C] when only the outermost and innermost scales are 1
+      ORT_ENFORCE(scales.size() == 2 || (scales.size() == 4 && scales[0] == 1 && (scales[1] == 1 || scales[3] == 1)),
                   "'Linear' mode and 'Cubic' mode only support 2-D inputs ('Bilinear', 'Bicubic') or 4-D inputs "
-                  "with the corresponding outermost 2 scale values being 1 in the ",
+                  "with the corresponding outermost 2 scale values, or outermost and innermost scale values, "
+                  "being 1 in the ",
                   is_resize_ ? "Resize operator" : "Upsample operator");
     }
   }
@@ -52,8 +52,9 @@ static Status ConcatenateGpuOutput(std::vector<OrtValue>& per_iteration_output,
                              " Expected:", per_iteration_shape, " Got:", iteration_data.Shape());
     }
 
-    CUDA_RETURN_IF_ERROR(cudaMemcpy(cur_output, iteration_data.DataRaw(), bytes_per_iteration,
-                                    cudaMemcpyDeviceToDevice));
+    // ordered on the default stream with the kernels that produced and consume the data, so no sync is needed
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(cur_output, iteration_data.DataRaw(), bytes_per_iteration,
+                                         cudaMemcpyDeviceToDevice));
 
     cur_output = static_cast<void*>((static_cast<gsl::byte*>(cur_output) + bytes_per_iteration));
   }
@@ -3,6 +3,7 @@
 
 #pragma once
 #include <stdint.h>
+#include <algorithm>
 #include "core/providers/cuda/shared_inc/cuda_utils.h"
 #include "common.cuh"
 
@@ -101,6 +102,45 @@ __global__ void _BinaryElementWiseSimple(
   }
 }
 
+// for scalar broadcast or non-broadcast case, loading and storing VecSize elements at once in a grid-stride loop
+template <bool IncL, bool IncR, typename T, typename T1, typename FuncT, int VecSize>
+__global__ void _BinaryElementWiseSimpleVectorized(
+    const T* lhs_data,
+    const T1* rhs_data,
+    T* output_data,
+    FuncT func,
+    CUDA_LONG N) {
+  using LhsT = aligned_vector<T, VecSize>;
+  using RhsT = aligned_vector<T1, VecSize>;
+  const CUDA_LONG stride = blockDim.x * gridDim.x;
+  const CUDA_LONG num_vectors = N / VecSize;
+  const T lhs_scalar = IncL ? T() : lhs_data[0];
+  const T1 rhs_scalar = IncR ? T1() : rhs_data[0];
+
+  for (CUDA_LONG id = blockDim.x * blockIdx.x + threadIdx.x; id < num_vectors; id += stride) {
+    LhsT lvalue;
+    RhsT rvalue;
+    if (IncL) {
+      lvalue = reinterpret_cast<const LhsT*>(lhs_data)[id];
+    }
+    if (IncR) {
+      rvalue = reinterpret_cast<const RhsT*>(rhs_data)[id];
+    }
+
+    LhsT result;
+#pragma unroll
+    for (int i = 0; i < VecSize; i++) {
+      result.val[i] = func(IncL ? lvalue.val[i] : lhs_scalar, IncR ? rvalue.val[i] : rhs_scalar);
+    }
+    reinterpret_cast<LhsT*>(output_data)[id] = result;
+  }
+
+  // elements past the last whole vector
+  for (CUDA_LONG id = num_vectors * VecSize + blockDim.x * blockIdx.x + threadIdx.x; id < N; id += stride) {
+    output_data[id] = func(IncL ? lhs_data[id] : lhs_scalar, IncR ? rhs_data[id] : rhs_scalar);
+  }
+}
+
 // for rhs per-channel broadcast case
 template <typename T, typename T1, typename FuncT, int NumThreadsPerBlock, int NumElementsPerThread>
 __global__ void _BinaryElementWiseRhsPerChannelBatch1(
@@ -177,19 +217,50 @@ __global__ void _BinaryElementWiseRhsPerChannelBatchN(
   }
 }
 
-template <typename T, typename T1, typename FuncT>
-void BinaryElementWiseNoBroadcastImpl(
+// for rhs per-channel broadcast case with the output viewed as rows of cols elements, so that the rhs index is found
+// once per row instead of dividing the offset of each element. Rows and columns are covered by grid-stride loops.
+// per row (lhs(N,C,H) and rhs(C,1)):  out[row, col] = op(lhs[row, col], rhs[row % C]) with cols = H
+// per column (lhs(N,C) and rhs(C)):   out[row, col] = op(lhs[row, col], rhs[col]) with cols = C
+template <typename T, typename T1, typename FuncT, bool RhsPerRow>
+__global__ void _BinaryElementWiseRhsPerChannel2D(
+    const T* lhs_data,
+    const T1* rhs_data,
+    const fast_divmod fdm_C,
+    T* output_data,
+    FuncT func,
+    CUDA_LONG rows,
+    CUDA_LONG cols) {
+  for (CUDA_LONG row = blockDim.y * blockIdx.y + threadIdx.y; row < rows; row += blockDim.y * gridDim.y) {
+    const T1 rhs_row = RhsPerRow ? rhs_data[fdm_C.mod(row)] : T1();
+    const CUDA_LONG row_offset = row * cols;
+    for (CUDA_LONG col = blockDim.x * blockIdx.x + threadIdx.x; col < cols; col += blockDim.x * gridDim.x) {
+      output_data[row_offset + col] = func(lhs_data[row_offset + col], RhsPerRow ? rhs_row : rhs_data[col]);
+    }
+  }
+}
+
+template <bool IncL, bool IncR, typename T, typename T1, typename FuncT>
+void BinaryElementWiseSimpleImpl(
     const T* lhs_data,
     const T1* rhs_data,
     T* output_data,
     const FuncT& func,
-    size_t count) {
-  if (count == 0)  // special case where there's a dim value of 0 in the output shape
+    CUDA_LONG N) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(N, GridDim::maxThreadsPerBlock * GridDim::maxElementsPerThread));
+  constexpr int vec_size = GridDim::maxElementsPerThread;
+  if ((!IncL || CanVectorize<T, vec_size>(lhs_data)) && (!IncR || CanVectorize<T1, vec_size>(rhs_data)) &&
+      CanVectorize<T, vec_size>(output_data)) {
+    _BinaryElementWiseSimpleVectorized<IncL, IncR, T, T1, FuncT, vec_size>
+        <<<std::min<int>(blocksPerGrid, GridDim::maxGridStrideBlocks), GridDim::maxThreadsPerBlock, 0>>>(
+            lhs_data,
+            rhs_data,
+            output_data,
+            func,
+            N);
     return;
+  }
 
-  int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock * GridDim::maxElementsPerThread));
-  CUDA_LONG N = static_cast<CUDA_LONG>(count);
-  _BinaryElementWiseSimple<true, true, T, T1, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+  _BinaryElementWiseSimple<IncL, IncR, T, T1, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
       lhs_data,
       rhs_data,
       output_data,
@@ -197,6 +268,43 @@ void BinaryElementWiseNoBroadcastImpl(
       N);
 }
 
+template <bool RhsPerRow, typename T, typename T1, typename FuncT>
+void BinaryElementWiseRhsPerChannel2DImpl(
+    const T* lhs_data,
+    const T1* rhs_data,
+    const fast_divmod& fdm_C,
+    T* output_data,
+    const FuncT& func,
+    CUDA_LONG rows,
+    CUDA_LONG cols) {
+  // whole warps along a row, and the rest of the block over the next rows
+  const int block_x = std::min<int>(GridDim::maxThreadsPerBlock, CeilDiv(cols, GPU_WARP_SIZE) * GPU_WARP_SIZE);
+  const dim3 block(block_x, GridDim::maxThreadsPerBlock / block_x);
+  constexpr int max_grid_y = 65535;
+  const dim3 grid(CeilDiv(cols, block.x), std::min<int>(CeilDiv(rows, block.y), max_grid_y));
+  _BinaryElementWiseRhsPerChannel2D<T, T1, FuncT, RhsPerRow><<<grid, block, 0>>>(
+      lhs_data,
+      rhs_data,
+      fdm_C,
+      output_data,
+      func,
+      rows,
+      cols);
+}
+
+template <typename T, typename T1, typename FuncT>
+void BinaryElementWiseNoBroadcastImpl(
+    const T* lhs_data,
+    const T1* rhs_data,
+    T* output_data,
+    const FuncT& func,
+    size_t count) {
+  if (count == 0)  // special case where there's a dim value of 0 in the output shape
+    return;
+
+  BinaryElementWiseSimpleImpl<true, true>(lhs_data, rhs_data, output_data, func, static_cast<CUDA_LONG>(count));
+}
+
 template <typename T, typename T1, typename FuncT>
 void BinaryElementWiseImpl(
     int32_t output_rank_or_simple_broadcast,
@@ -215,28 +323,26 @@ void BinaryElementWiseImpl(
 
   int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock * GridDim::maxElementsPerThread));
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  const CUDA_LONG H = static_cast<CUDA_LONG>(fdm_H.d_);
+  const CUDA_LONG C = static_cast<CUDA_LONG>(fdm_C.d_);
   if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::NoBroadcast)) {
-    _BinaryElementWiseSimple<true, true, T, T1, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
-        lhs_data,
-        rhs_data,
-        output_data,
-        func,
-        N);
+    BinaryElementWiseSimpleImpl<true, true>(lhs_data, rhs_data, output_data, func, N);
   } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::LeftScalar)) {
-    _BinaryElementWiseSimple<false, true, T, T1, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
-        lhs_data,
-        rhs_data,
-        output_data,
-        func,
-        N);
+    BinaryElementWiseSimpleImpl<false, true>(lhs_data, rhs_data, output_data, func, N);
   } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::RightScalar)) {
-    _BinaryElementWiseSimple<true, false, T, T1, FuncT, GridDim::maxThreadsPerBlock,
-                             GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
-        lhs_data,
-        rhs_data,
-        output_data,
-        func,
-        N);
+    BinaryElementWiseSimpleImpl<true, false>(lhs_data, rhs_data, output_data, func, N);
+    // the per-channel cases with rows shorter than a warp, which would leave most of the threads of the 2D kernel
+    // idle, use the kernels dividing the offsets below
+  } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::RightPerChannelBatch1) &&
+             H >= GPU_WARP_SIZE) {
+    // rhs[row] for each of the C rows, fdm_C isn't set for this case
+    BinaryElementWiseRhsPerChannel2DImpl<true>(lhs_data, rhs_data, fast_divmod(N / H), output_data, func, N / H, H);
+  } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::RightPerChannelBatchN) &&
+             H >= GPU_WARP_SIZE) {
+    BinaryElementWiseRhsPerChannel2DImpl<true>(lhs_data, rhs_data, fdm_C, output_data, func, N / H, H);
+  } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::RightPerChannelBatchN) &&
+             H == 1 && C >= GPU_WARP_SIZE) {
+    BinaryElementWiseRhsPerChannel2DImpl<false>(lhs_data, rhs_data, fdm_C, output_data, func, N / C, C);
   } else if (output_rank_or_simple_broadcast == static_cast<int32_t>(SimpleBroadcast::RightPerChannelBatch1)) {
     _BinaryElementWiseRhsPerChannelBatch1<T, T1, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
         lhs_data,
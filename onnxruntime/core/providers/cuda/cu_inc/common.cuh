@@ -239,9 +239,22 @@ struct GridDim {
   enum : CUDA_LONG {
     maxThreadsPerBlock = 256,  // max threads per block
     maxElementsPerThread = 4,  // max element processed per thread
+    maxGridStrideBlocks = 2048,  // max blocks of the kernels looping over the elements with a grid-stride loop
   };
 };
 
+// VecSize elements loaded or stored with a single instruction, such as a float4 or two half2
+template <typename T, int VecSize>
+struct alignas(sizeof(T) * VecSize) aligned_vector {
+  T val[VecSize];
+};
+
+// whether p can be accessed as an array of aligned_vector<T, VecSize>
+template <typename T, int VecSize>
+bool CanVectorize(const T* p) {
+  return reinterpret_cast<uintptr_t>(p) % sizeof(aligned_vector<T, VecSize>) == 0;
+}
+
 
 #define CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N)          \
   CUDA_LONG id = blockDim.x * blockIdx.x + threadIdx.x;     \
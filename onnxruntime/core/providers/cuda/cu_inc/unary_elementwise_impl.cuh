@@ -3,6 +3,7 @@
 
 #pragma once
 #include <stdint.h>
+#include <algorithm>
 #include "core/providers/cuda/shared_inc/cuda_utils.h"
 #include "common.cuh"
 
@@ -37,6 +38,34 @@ __global__ void _UnaryElementWise(
   }
 }
 
+// same as _UnaryElementWise, loading and storing VecSize elements at once in a grid-stride loop
+template <typename InT, typename OutT, typename FuncT, int VecSize>
+__global__ void _UnaryElementWiseVectorized(
+    const InT* input_data,
+    OutT* output_data,
+    const FuncT functor,
+    CUDA_LONG N) {
+  using LoadT = aligned_vector<InT, VecSize>;
+  using StoreT = aligned_vector<OutT, VecSize>;
+  const CUDA_LONG stride = blockDim.x * gridDim.x;
+  const CUDA_LONG num_vectors = N / VecSize;
+
+  for (CUDA_LONG id = blockDim.x * blockIdx.x + threadIdx.x; id < num_vectors; id += stride) {
+    const LoadT value = reinterpret_cast<const LoadT*>(input_data)[id];
+    StoreT result;
+  #pragma unroll
+    for (int i = 0; i < VecSize; i++) {
+      result.val[i] = functor(value.val[i]);
+    }
+    reinterpret_cast<StoreT*>(output_data)[id] = result;
+  }
+
+  // elements past the last whole vector
+  for (CUDA_LONG id = num_vectors * VecSize + blockDim.x * blockIdx.x + threadIdx.x; id < N; id += stride) {
+    output_data[id] = functor(input_data[id]);
+  }
+}
+
 template <typename InT, typename OutT, typename FuncT>
 void UnaryElementWiseImpl(
     const InT* input_data,
@@ -48,6 +77,17 @@ void UnaryElementWiseImpl(
 
   int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock * GridDim::maxElementsPerThread));
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  constexpr int vec_size = GridDim::maxElementsPerThread;
+  if (CanVectorize<InT, vec_size>(input_data) && CanVectorize<OutT, vec_size>(output_data)) {
+    _UnaryElementWiseVectorized<InT, OutT, FuncT, vec_size>
+        <<<std::min<int>(blocksPerGrid, GridDim::maxGridStrideBlocks), GridDim::maxThreadsPerBlock, 0>>>(
+            input_data,
+            output_data,
+            func,
+            N);
+    return;
+  }
+
   _UnaryElementWise<InT, OutT, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
       <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
           input_data,
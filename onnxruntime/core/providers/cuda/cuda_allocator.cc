@@ -51,6 +51,24 @@ FencePtr CUDAAllocator::CreateFence(const SessionState* session_state) {
   return std::make_shared<CUDAFence>(GetGPUDataTransfer(session_state));
 }
 
+void* CUDAExternalAllocator::Alloc(size_t size) {
+  CheckDevice(true);
+  void* p = nullptr;
+  if (size > 0) {
+    p = info_.alloc(size, stream_);
+    if (p == nullptr) {
+      ORT_THROW("The external CUDA allocator failed to allocate ", size, " bytes");
+    }
+  }
+  return p;
+}
+
+void CUDAExternalAllocator::Free(void* p) {
+  if (p != nullptr) {
+    info_.free(p);
+  }
+}
+
 void* CUDAPinnedAllocator::Alloc(size_t size) {
   void* p = nullptr;
   if (size > 0) {
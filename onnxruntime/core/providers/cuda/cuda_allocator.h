@@ -3,10 +3,21 @@
 
 #pragma once
 
+#include <functional>
+
 #include "core/framework/allocator.h"
+#include "core/providers/cuda/cuda_pch.h"
 
 namespace onnxruntime {
 
+// Device memory allocator supplied by the application, such as the caching allocator of another framework in the
+// same process, that the execution provider uses instead of its arenas when alloc is set.
+struct CUDAExternalAllocatorInfo {
+  // returns size bytes used on stream, or nullptr if the allocation failed
+  std::function<void*(size_t size, cudaStream_t stream)> alloc;
+  std::function<void(void* p)> free;
+};
+
 class CUDAAllocator : public IDeviceAllocator {
  public:
   CUDAAllocator(OrtDevice::DeviceId device_id, const char* name)
@@ -18,10 +29,24 @@ class CUDAAllocator : public IDeviceAllocator {
   void Free(void* p) override;
   FencePtr CreateFence(const SessionState* session_state) override;
 
- private:
+ protected:
   void CheckDevice(bool throw_when_fail) const;
 };
 
+// Not wrapped in an arena, the external allocator does its own caching.
+class CUDAExternalAllocator : public CUDAAllocator {
+ public:
+  CUDAExternalAllocator(OrtDevice::DeviceId device_id, const char* name, const CUDAExternalAllocatorInfo& info,
+                        cudaStream_t stream)
+      : CUDAAllocator(device_id, name), info_(info), stream_(stream) {}
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+ private:
+  CUDAExternalAllocatorInfo info_;
+  cudaStream_t stream_;
+};
+
 //TODO: add a default constructor
 class CUDAPinnedAllocator : public IDeviceAllocator {
  public:
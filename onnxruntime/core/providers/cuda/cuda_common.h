@@ -93,6 +93,11 @@ class CudaKernel : public OpKernel {
     return provider_->GetScratchBuffer<T>(count_or_bytes);
   }
 
+  // See CUDAExecutionProvider::GetWorkspace.
+  inline IAllocatorUniquePtr<void> GetWorkspace(size_t bytes) const {
+    return provider_->GetWorkspace(bytes);
+  }
+
   inline void AddDeferredReleaseCPUPtr(void* p) const {
     provider_->AddDeferredReleaseCPUPtr(p);
   }
@@ -185,6 +190,10 @@ class CudaKernel : public OpKernel {
 
   inline int GetDeviceId() const { return provider_->GetDeviceId(); }
 
+  inline OrtCudnnConvAlgoSearch GetCudnnConvAlgoSearch() const { return provider_->GetCudnnConvAlgoSearch(); }
+
+  inline CudnnConvAlgoCache& GetCudnnConvAlgoCache() const { return provider_->GetCudnnConvAlgoCache(); }
+
  private:
   CUDAExecutionProvider* provider_;
 };
@@ -5,10 +5,12 @@
 #include "cuda_execution_provider.h"
 #include "cuda_fence.h"
 #include "cuda_allocator.h"
+#include "cuda_stream_ordered_arena.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/memcpy.h"
 #include "core/graph/graph_utils.h"
+#include "core/platform/env.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
 
 #ifndef DISABLE_CONTRIB_OPS
@@ -56,12 +58,26 @@ ONNX_OPERATOR_KERNEL_EX(
 
 }  // namespace cuda
 
-CUDAExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId device_id, size_t cuda_mem_limit, ArenaExtendStrategy arena_extend_strategy) {
+CUDAExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId device_id, size_t cuda_mem_limit, ArenaExtendStrategy arena_extend_strategy,
+                                                          const CUDAExternalAllocatorInfo& external_allocator_info) {
   CUDA_CALL_THROW(cudaSetDevice(device_id));
   CUBLAS_CALL_THROW(cublasCreate(&cublas_handle_));
   CUDNN_CALL_THROW(cudnnCreate(&cudnn_handle_));
   CURAND_CALL_THROW(curandCreateGenerator(&curand_generator_, CURAND_RNG_PSEUDO_DEFAULT));
 
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  stream_ = cudaStreamPerThread;
+#endif
+  // the libraries are not compiled with the per-thread default stream, so bind the stream explicitly
+  CUBLAS_CALL_THROW(cublasSetStream(cublas_handle_, stream_));
+  CUDNN_CALL_THROW(cudnnSetStream(cudnn_handle_, stream_));
+  CURAND_CALL_THROW(curandSetStream(curand_generator_, stream_));
+
+  if (external_allocator_info.alloc) {
+    allocator_ = std::make_shared<CUDAExternalAllocator>(device_id, CUDA, external_allocator_info, stream_);
+    return;
+  }
+
   DeviceAllocatorRegistrationInfo default_memory_info(
       {OrtMemTypeDefault,
        [](OrtDevice::DeviceId id) {
@@ -101,25 +117,83 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
     : IExecutionProvider{onnxruntime::kCudaExecutionProvider},
       device_id_(info.device_id),
       cuda_mem_limit_(info.cuda_mem_limit),
-      arena_extend_strategy_(info.arena_extend_strategy) {
+      arena_extend_strategy_(info.arena_extend_strategy),
+      external_allocator_info_(info.external_allocator_info),
+      workspace_max_bytes_(info.workspace_max_bytes),
+      cudnn_conv_algo_search_(info.cudnn_conv_algo_search) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
 
+  if (info.enable_cuda_graph) {
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+    cuda_graph_enabled_ = true;
+#else
+    LOGS_DEFAULT(WARNING) << "CUDA graph capture requires building with onnxruntime_CUDA_PER_THREAD_DEFAULT_STREAM "
+                             "as the legacy default stream can't be captured. Running without graph capture.";
+#endif
+  }
+
   // must wait GPU idle, otherwise cudaGetDeviceProperties might fail
   CUDA_CALL_THROW(cudaDeviceSynchronize());
   CUDA_CALL_THROW(cudaGetDeviceProperties(&device_prop_, device_id_));
 
+  if (info.initializers_in_host_memory) {
+    if (device_prop_.unifiedAddressing) {
+      initializers_in_host_memory_ = true;
+    } else {
+      LOGS_DEFAULT(WARNING) << "CUDA device " << device_id_ << " doesn't support unified addressing, so its kernels "
+                            << "can't read the initializers from host memory. Keeping them in device memory.";
+    }
+  }
+
+  std::string cudnn_conv_algo_cache_file;
+  if (!info.cudnn_conv_algo_cache_path.empty()) {
+    const auto& env = Env::Default();
+    if (!env.FolderExists(info.cudnn_conv_algo_cache_path)) {
+      ORT_THROW_IF_ERROR(env.CreateFolder(info.cudnn_conv_algo_cache_path));
+    }
+    // one file per device model, as the algorithms are chosen for the device
+    std::string device_name(device_prop_.name);
+    for (auto& c : device_name) {
+      if (!isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+    cudnn_conv_algo_cache_file = info.cudnn_conv_algo_cache_path + "/cudnn_conv_algos_" + device_name + "_sm" +
+                                 std::to_string(device_prop_.major) + std::to_string(device_prop_.minor) + ".txt";
+  }
+  cudnn_conv_algo_cache_ = onnxruntime::make_unique<cuda::CudnnConvAlgoCache>(cudnn_conv_algo_cache_file,
+                                                                              device_prop_);
+
   size_t free = 0;
   size_t total = 0;
   CUDA_CALL_THROW(cudaMemGetInfo(&free, &total));
 
-  DeviceAllocatorRegistrationInfo default_memory_info(
-      {OrtMemTypeDefault,
-       [](OrtDevice::DeviceId device_id) {
-         return onnxruntime::make_unique<CUDAAllocator>(device_id, CUDA);
-       },
-       cuda_mem_limit_});
+  if (info.use_stream_ordered_arena && !external_allocator_info_.alloc) {
+#ifdef ORT_CUDA_HAS_STREAM_ORDERED_ARENA
+    if (CUDAStreamOrderedArena::IsSupported(device_id_)) {
+      stream_ordered_allocator_ = std::make_shared<CUDAStreamOrderedArena>(device_id_, CUDA, cuda_mem_limit_);
+    } else {
+      LOGS_DEFAULT(WARNING) << "CUDA device " << device_id_
+                            << " doesn't support memory pools. Using a BFCArena instead of the stream-ordered arena.";
+    }
+#else
+    LOGS_DEFAULT(WARNING) << "The stream-ordered arena requires CUDA 11.2 or later. Using a BFCArena instead.";
+#endif
+  }
 
-  InsertAllocator(CreateAllocator(default_memory_info, device_id_));
+  if (external_allocator_info_.alloc) {
+    // used outside of the runs, such as for the initializers, so the memory isn't tied to a per thread stream
+    InsertAllocator(std::make_shared<CUDAExternalAllocator>(device_id_, CUDA, external_allocator_info_, nullptr));
+  } else if (stream_ordered_allocator_) {
+    InsertAllocator(stream_ordered_allocator_);
+  } else {
+    DeviceAllocatorRegistrationInfo default_memory_info(
+        {OrtMemTypeDefault,
+         [](OrtDevice::DeviceId device_id) {
+           return onnxruntime::make_unique<CUDAAllocator>(device_id, CUDA);
+         },
+         cuda_mem_limit_});
+
+    InsertAllocator(CreateAllocator(default_memory_info, device_id_));
+  }
 
   DeviceAllocatorRegistrationInfo pinned_memory_info(
       {OrtMemTypeCPUOutput,
@@ -145,7 +219,18 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
 }
 
 CUDAExecutionProvider::~CUDAExecutionProvider() {
+  const auto workspace_stats = GetWorkspaceStats();
+  if (workspace_stats.num_grows != 0 || workspace_stats.num_fallbacks != 0) {
+    LOGS_DEFAULT(VERBOSE) << "CUDA workspaces: peak " << workspace_stats.peak_bytes << " bytes, "
+                          << workspace_stats.reserved_bytes << " bytes reserved over " << workspace_stats.num_grows
+                          << " grows, " << workspace_stats.num_fallbacks << " allocated from the arena";
+  }
+
   auto cpu_alloc = GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPU);
+  cuda_graph_.Reset();
+  for (auto p : graph_cpu_ptrs_) {
+    cpu_alloc->Free(p);
+  }
   {
     std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
     auto it = deferred_release_cpu_ptr_.begin();
@@ -191,7 +276,8 @@ CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadCont
 
     // get or create a context
     if (context_state_.retired_context_pool.empty()) {
-      context = std::make_shared<PerThreadContext>(device_id_, cuda_mem_limit_, arena_extend_strategy_);
+      context = std::make_shared<PerThreadContext>(device_id_, cuda_mem_limit_, arena_extend_strategy_,
+                                                   external_allocator_info_);
     } else {
       context = context_state_.retired_context_pool.back();
       context_state_.retired_context_pool.pop_back();
@@ -231,19 +317,75 @@ AllocatorPtr CUDAExecutionProvider::GetAllocator(int id, OrtMemType mem_type) co
   // Pinned memory allocator is shared between threads, but CUDA memory allocator is per-thread or it may cause result changes
   // A hypothesis is that arena allocator is not aligned with CUDA output cache, and data from different kernel writes may
   // cause cacheline to contain dirty data.
-  if (mem_type == OrtMemTypeDefault) {
+  // The stream-ordered arena tracks the stream memory was freed on, so it can be shared instead.
+  if (mem_type == OrtMemTypeDefault && !stream_ordered_allocator_) {
     return GetPerThreadContext().GetAllocator();
   } else {
     return IExecutionProvider::GetAllocator(id, mem_type);
   }
 }
 
+IAllocatorUniquePtr<void> CUDAExecutionProvider::GetWorkspace(size_t bytes) const {
+  if (bytes == 0) {
+    return nullptr;
+  }
+
+  size_t peak_bytes = workspace_peak_bytes_.load(std::memory_order_relaxed);
+  while (bytes > peak_bytes &&
+         !workspace_peak_bytes_.compare_exchange_weak(peak_bytes, bytes, std::memory_order_relaxed)) {
+  }
+
+  if (workspace_max_bytes_ != 0 && bytes > workspace_max_bytes_) {
+    workspace_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    return GetScratchBuffer<void>(bytes);
+  }
+
+  size_t grown_bytes = 0;
+  void* workspace = GetPerThreadContext().GetWorkspace(bytes, workspace_max_bytes_,
+                                                       GetAllocator(device_id_, OrtMemTypeDefault), grown_bytes);
+  if (grown_bytes != 0) {
+    workspace_reserved_bytes_.fetch_add(grown_bytes, std::memory_order_relaxed);
+    workspace_grows_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // the buffer stays with the thread, so there's nothing to free
+  return IAllocatorUniquePtr<void>(workspace, [](void*) {});
+}
+
+CudaWorkspaceStats CUDAExecutionProvider::GetWorkspaceStats() const {
+  CudaWorkspaceStats stats;
+  stats.peak_bytes = workspace_peak_bytes_.load(std::memory_order_relaxed);
+  stats.reserved_bytes = workspace_reserved_bytes_.load(std::memory_order_relaxed);
+  stats.num_grows = workspace_grows_.load(std::memory_order_relaxed);
+  stats.num_fallbacks = workspace_fallbacks_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+AllocatorPtr CUDAExecutionProvider::GetInitializerAllocator(int id, OrtMemType mem_type) const {
+  // pinned host memory is mapped at the same address in the device with unified addressing
+  if (mem_type == OrtMemTypeDefault && initializers_in_host_memory_) {
+    return IExecutionProvider::GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPUOutput);
+  }
+  return GetAllocator(id, mem_type);
+}
+
 Status CUDAExecutionProvider::Sync() const {
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  // only wait for the work issued by the calling thread, other sessions sharing the device keep running
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(cudaStreamPerThread));
+#else
   CUDA_RETURN_IF_ERROR(cudaDeviceSynchronize());
+#endif
   return Status::OK();
 }
 
 void CUDAExecutionProvider::AddDeferredReleaseCPUPtr(void* p) {
+  if (cuda_graph_.IsCapturing()) {
+    // the captured graph copies from the buffer whenever it is replayed
+    graph_cpu_ptrs_.push_back(p);
+    return;
+  }
+
   // when not running in InferenceSession (e.g. Test)
   // it's OK to not remember the deferred release ptr
   // as the actual memory will be cleaned in arena allocator dtor
@@ -283,19 +425,77 @@ Status CUDAExecutionProvider::OnRunStart() {
   auto& current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
   CUDA_RETURN_IF_ERROR(cudaEventCreate(&current_deferred_release_event, cudaEventDisableTiming));
   deferred_release_cpu_ptr_.emplace(current_deferred_release_event, DeferredReleaseCPUPtrs());
+
+  if (cuda_graph_enabled_ && graph_run_signature_ != 0 && !graph_capture_failed_ && !cuda_graph_.IsCaptured() &&
+      graph_signature_runs_ >= kGraphCaptureWarmUpRuns) {
+    ORT_RETURN_IF_ERROR(cuda_graph_.CaptureBegin(GetPerThreadContext().Stream()));
+  }
   return Status::OK();
 }
 
 Status CUDAExecutionProvider::OnRunEnd() {
-  // record deferred release event on default stream, and release per_thread_context
-  auto current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
-  CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, nullptr));
+  // record deferred release event on the stream of this run, and release per_thread_context
+  auto& per_thread_context = GetPerThreadContext();
+
+  Status status = Status::OK();
+  if (cuda_graph_.IsCapturing()) {
+    // the captured kernels haven't executed, so launch the graph to produce the outputs of this run
+    status = cuda_graph_.CaptureEnd();
+    if (status.IsOK()) {
+      status = cuda_graph_.Replay(per_thread_context.Stream());
+    }
+    if (!status.IsOK()) {
+      // e.g. a kernel synchronized with the host while capturing, later runs with this signature execute eagerly
+      LOGS_DEFAULT(WARNING) << "Capturing the CUDA graph failed, running without graph capture: "
+                            << status.ErrorMessage();
+      cuda_graph_.Reset();
+      graph_capture_failed_ = true;
+    }
+  }
+  ++graph_signature_runs_;
+
+  auto current_deferred_release_event = per_thread_context.GetCurrentDeferredReleaseEvent();
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, per_thread_context.Stream()));
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  // the per-thread stream does not synchronize with the other threads, so the outputs of this run must be
+  // complete before another thread may consume them. Only this stream is waited on.
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(per_thread_context.Stream()));
+#endif
   ReleasePerThreadContext();
   std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
   deferred_release_cpu_ptr_[current_deferred_release_event].recorded = true;
+  return status;
+}
+
+bool CUDAExecutionProvider::PrepareGraphReplay(uint64_t run_signature) {
+  if (run_signature != graph_run_signature_) {
+    ResetGraph();
+    graph_run_signature_ = run_signature;
+  }
+
+  return cuda_graph_.IsCaptured();
+}
+
+Status CUDAExecutionProvider::ReplayGraph() {
+  CUDA_RETURN_IF_ERROR(cudaSetDevice(GetDeviceId()));
+  // the per-thread context isn't acquired as no kernel runs, so use the stream of the calling thread directly
+  ORT_RETURN_IF_ERROR(cuda_graph_.Replay(cudaStreamPerThread));
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(cudaStreamPerThread));
   return Status::OK();
 }
 
+void CUDAExecutionProvider::ResetGraph() {
+  // the previous replay has completed as ReplayGraph synchronizes, so the pinned buffers can be released
+  cuda_graph_.Reset();
+  auto cpu_alloc = GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPU);
+  for (auto p : graph_cpu_ptrs_) {
+    cpu_alloc->Free(p);
+  }
+  graph_cpu_ptrs_.clear();
+  graph_signature_runs_ = 0;
+  graph_capture_failed_ = false;
+}
+
 namespace cuda {
 // opset 1 to 9
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, MemcpyFromHost);
@@ -1466,7 +1666,8 @@ static bool CastNeedFallbackToCPU(const onnxruntime::Node& node) {
 }
 
 std::unique_ptr<onnxruntime::IDataTransfer> CUDAExecutionProvider::GetDataTransfer() const {
-  return onnxruntime::make_unique<onnxruntime::GPUDataTransfer>();
+  // stage the copies from pageable CPU memory through the pinned memory arena
+  return onnxruntime::make_unique<onnxruntime::GPUDataTransfer>(GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPUOutput));
 }
 
 std::vector<std::unique_ptr<ComputeCapability>>
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <set>
 #include <vector>
 
@@ -11,7 +13,10 @@
 #include "core/framework/bfc_arena.h"
 #include "core/framework/execution_provider.h"
 #include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_allocator.h"
+#include "core/providers/cuda/cuda_graph.h"
 #include "core/providers/cuda/cuda_pch.h"
+#include "core/providers/cuda/cudnn_conv_algo_cache.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "core/providers/cuda/shared_inc/cuda_utils.h"
 
@@ -24,6 +29,40 @@ struct CUDAExecutionProviderInfo {
   OrtDevice::DeviceId device_id{0};
   size_t cuda_mem_limit{std::numeric_limits<size_t>::max()};
   ArenaExtendStrategy arena_extend_strategy{ArenaExtendStrategy::kNextPowerOfTwo};
+  // Capture the kernels of a run into a CUDA graph and replay it on later runs with the same IOBinding-bound
+  // buffers and shapes. Requires building with onnxruntime_CUDA_PER_THREAD_DEFAULT_STREAM. Run() must not be
+  // called concurrently on a session using it.
+  bool enable_cuda_graph{false};
+  // Allocate the GPU memory of all the runs from a stream-ordered CUDA memory pool (cudaMallocAsync) instead of
+  // a BFCArena per thread. Requires CUDA 11.2 or later, and is ignored if the device doesn't support memory pools.
+  bool use_stream_ordered_arena{false};
+  // How the algorithm of a cuDNN convolution is chosen. The choices of an exhaustive search are cached by problem.
+  OrtCudnnConvAlgoSearch cudnn_conv_algo_search{EXHAUSTIVE};
+  // Directory of a file persisting the choices of the exhaustive cuDNN convolution algorithm search across
+  // processes, or empty to keep them in memory only. The directory is created if it doesn't exist.
+  std::string cudnn_conv_algo_cache_path;
+  // Keep the initializers in pinned host memory, which the kernels read through the unified address space, so a
+  // model whose weights don't fit in GPU memory can run at the cost of reading them over the bus on every run.
+  // Requires a device with unified addressing, and is ignored otherwise.
+  bool initializers_in_host_memory{false};
+  // Largest workspace the kernels borrow from the grow-only workspace buffer of each thread, see
+  // CUDAExecutionProvider::GetWorkspace. Larger workspaces are allocated from the arena. 0 means no limit.
+  size_t workspace_max_bytes{0};
+  // Allocate the GPU memory from the application's allocator instead of the arenas, so it shares one pool with
+  // other frameworks in the process. Overrides cuda_mem_limit, arena_extend_strategy and use_stream_ordered_arena.
+  CUDAExternalAllocatorInfo external_allocator_info;
+};
+
+// Statistics of the workspaces borrowed through CUDAExecutionProvider::GetWorkspace.
+struct CudaWorkspaceStats {
+  // largest workspace requested
+  size_t peak_bytes = 0;
+  // total size of the workspace buffers of all the threads
+  size_t reserved_bytes = 0;
+  // number of times a workspace buffer was grown
+  size_t num_grows = 0;
+  // number of workspaces over CUDAExecutionProviderInfo::workspace_max_bytes, allocated from the arena
+  size_t num_fallbacks = 0;
 };
 
 // Logical device representation.
@@ -34,12 +73,22 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   AllocatorPtr GetAllocator(int id, OrtMemType mem_type) const override;
 
+  AllocatorPtr GetInitializerAllocator(int id, OrtMemType mem_type) const override;
+
   Status Sync() const override;
 
   Status OnRunStart() override;
 
   Status OnRunEnd() override;
 
+  bool IsGraphCaptureEnabled() const override {
+    return cuda_graph_enabled_;
+  }
+
+  bool PrepareGraphReplay(uint64_t run_signature) override;
+
+  Status ReplayGraph() override;
+
   const void* GetExecutionHandle() const noexcept override {
     // The CUDA interface does not return anything interesting.
     return nullptr;
@@ -56,6 +105,12 @@ class CUDAExecutionProvider : public IExecutionProvider {
     return GetPerThreadContext().CurandGenerator();
   }
 
+  // The stream the cuBLAS/cuDNN/cuRAND handles of the calling thread are bound to. This is the legacy default
+  // stream unless built with onnxruntime_CUDA_PER_THREAD_DEFAULT_STREAM.
+  cudaStream_t PerThreadStream() {
+    return GetPerThreadContext().Stream();
+  }
+
   template <typename T>
   const T* GetConstOnes(size_t count) {
     return GetPerThreadContext().template GetConstOnes<T>(count);
@@ -71,6 +126,14 @@ class CUDAExecutionProvider : public IExecutionProvider {
     return IAllocator::MakeUniquePtr<T>(GetAllocator(device_id_, OrtMemTypeDefault), count_or_bytes);
   }
 
+  // Borrow a workspace of the given size from the grow-only workspace buffer of the calling thread, which avoids
+  // the arena for the cuDNN/cuBLAS workspaces of every Compute. The kernels run on the stream of the thread one after
+  // the other, so the buffer can be reused by the next kernel as soon as the work using it is enqueued. A kernel must
+  // hold a single workspace at a time, and release it before returning from Compute.
+  IAllocatorUniquePtr<void> GetWorkspace(size_t bytes) const;
+
+  CudaWorkspaceStats GetWorkspaceStats() const;
+
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<onnxruntime::IDataTransfer> GetDataTransfer() const override;
 
@@ -81,11 +144,26 @@ class CUDAExecutionProvider : public IExecutionProvider {
   int GetDeviceId() const { return device_id_; }
   const cudaDeviceProp& GetDeviceProp() const { return device_prop_; };
 
+  OrtCudnnConvAlgoSearch GetCudnnConvAlgoSearch() const { return cudnn_conv_algo_search_; }
+  cuda::CudnnConvAlgoCache& GetCudnnConvAlgoCache() const { return *cudnn_conv_algo_cache_; }
+
  private:
   OrtDevice::DeviceId device_id_;
   cudaDeviceProp device_prop_;
   size_t cuda_mem_limit_;
   ArenaExtendStrategy arena_extend_strategy_;
+  CUDAExternalAllocatorInfo external_allocator_info_;
+  bool initializers_in_host_memory_ = false;
+  size_t workspace_max_bytes_ = 0;
+  mutable std::atomic<size_t> workspace_peak_bytes_{0};
+  mutable std::atomic<size_t> workspace_reserved_bytes_{0};
+  mutable std::atomic<size_t> workspace_grows_{0};
+  mutable std::atomic<size_t> workspace_fallbacks_{0};
+  // shared by all the threads, see CUDAExecutionProviderInfo::use_stream_ordered_arena
+  AllocatorPtr stream_ordered_allocator_;
+
+  OrtCudnnConvAlgoSearch cudnn_conv_algo_search_;
+  std::unique_ptr<cuda::CudnnConvAlgoCache> cudnn_conv_algo_cache_;
 
   struct DeferredReleaseCPUPtrs {
     bool recorded = false;
@@ -95,9 +173,25 @@ class CUDAExecutionProvider : public IExecutionProvider {
   std::unordered_map<cudaEvent_t, DeferredReleaseCPUPtrs> deferred_release_cpu_ptr_;
   OrtMutex deferred_release_cpu_ptr_mutex_;
 
+  // Number of runs executed eagerly with a run signature before capturing the graph, so that the arena has grown
+  // and the lazily created buffers and cuDNN algorithm choices, which can't be set up while capturing, exist.
+  static constexpr int kGraphCaptureWarmUpRuns = 1;
+
+  bool cuda_graph_enabled_ = false;
+  CUDAGraph cuda_graph_;
+  // run signature the graph is captured for, and the number of runs with that signature
+  uint64_t graph_run_signature_ = 0;
+  int graph_signature_runs_ = 0;
+  bool graph_capture_failed_ = false;
+  // pinned CPU buffers the captured graph copies from, released with the graph instead of after the run
+  std::vector<void*> graph_cpu_ptrs_;
+
+  void ResetGraph();
+
   class PerThreadContext final {
    public:
-    PerThreadContext(OrtDevice::DeviceId device_id, size_t cuda_mem_limit, ArenaExtendStrategy arena_extend_strategy);
+    PerThreadContext(OrtDevice::DeviceId device_id, size_t cuda_mem_limit, ArenaExtendStrategy arena_extend_strategy,
+                     const CUDAExternalAllocatorInfo& external_allocator_info);
     ~PerThreadContext();
 
     cublasHandle_t CublasHandle() const {
@@ -112,6 +206,10 @@ class CUDAExecutionProvider : public IExecutionProvider {
       return curand_generator_;
     }
 
+    cudaStream_t Stream() const {
+      return stream_;
+    }
+
     cudaEvent_t& GetCurrentDeferredReleaseEvent() {
       return current_deferred_release_event_;
     }
@@ -142,7 +240,31 @@ class CUDAExecutionProvider : public IExecutionProvider {
       return allocator_;
     }
 
+    // Get the workspace buffer of this thread, grown from allocator to at least bytes if it's smaller.
+    // grown_bytes is set to the number of bytes it grew by.
+    void* GetWorkspace(size_t bytes, size_t max_bytes, const AllocatorPtr& allocator, size_t& grown_bytes) {
+      grown_bytes = 0;
+      if (bytes > workspace_bytes_) {
+        // grow by at least half to limit the reallocations while the sizes creep up
+        size_t new_bytes = std::max(bytes, workspace_bytes_ + workspace_bytes_ / 2);
+        if (max_bytes != 0) {
+          new_bytes = std::min(new_bytes, max_bytes);
+        }
+        // the work enqueued on the stream with the old buffer runs before any reuse of its memory
+        const size_t old_bytes = workspace_bytes_;
+        workspace_.reset();
+        workspace_bytes_ = 0;
+        workspace_ = IAllocator::MakeUniquePtr<void>(allocator, new_bytes);
+        workspace_bytes_ = new_bytes;
+        grown_bytes = new_bytes - old_bytes;
+      }
+      return workspace_.get();
+    }
+
    private:
+    // cudaStreamPerThread is resolved when used, so a pooled context picked up by another thread
+    // issues its work on the stream of that thread.
+    cudaStream_t stream_ = nullptr;
     cublasHandle_t cublas_handle_ = nullptr;
     cudnnHandle_t cudnn_handle_ = nullptr;
     curandGenerator_t curand_generator_ = nullptr;
@@ -157,6 +279,10 @@ class CUDAExecutionProvider : public IExecutionProvider {
     std::unique_ptr<cuda::IConstantBuffer<half>> constant_ones_half_;
 
     AllocatorPtr allocator_;
+
+    // grow-only buffer the kernels of this thread borrow their workspaces from
+    IAllocatorUniquePtr<void> workspace_;
+    size_t workspace_bytes_ = 0;
   };
 
   using PerThreadContextMap = std::unordered_map<const CUDAExecutionProvider*, std::weak_ptr<PerThreadContext>>;
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cuda_graph.h"
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+
+CUDAGraph::~CUDAGraph() {
+  Reset();
+}
+
+Status CUDAGraph::CaptureBegin(cudaStream_t stream) {
+  ORT_ENFORCE(!is_capturing_ && !IsCaptured(), "The CUDA graph must be reset before capturing it again");
+
+  // thread local mode so that only the capturing thread is restricted from calls that are unsafe while capturing
+  // (e.g. cudaMalloc), concurrent runs on other threads are unaffected.
+  CUDA_RETURN_IF_ERROR(cudaStreamBeginCapture(stream, cudaStreamCaptureModeThreadLocal));
+  capture_stream_ = stream;
+  is_capturing_ = true;
+  return Status::OK();
+}
+
+Status CUDAGraph::CaptureEnd() {
+  ORT_ENFORCE(is_capturing_, "The CUDA graph is not being captured");
+
+  is_capturing_ = false;
+  // the capture is invalidated if a captured call failed, in which case no graph is returned
+  CUDA_RETURN_IF_ERROR(cudaStreamEndCapture(capture_stream_, &graph_));
+  if (graph_ == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Capturing the CUDA graph returned no graph");
+  }
+
+  CUDA_RETURN_IF_ERROR(cudaGraphInstantiate(&graph_exec_, graph_, nullptr, nullptr, 0));
+  return Status::OK();
+}
+
+Status CUDAGraph::Replay(cudaStream_t stream) const {
+  ORT_ENFORCE(IsCaptured(), "The CUDA graph has not been captured");
+
+  CUDA_RETURN_IF_ERROR(cudaGraphLaunch(graph_exec_, stream));
+  return Status::OK();
+}
+
+void CUDAGraph::Reset() {
+  if (is_capturing_) {
+    // stop capturing, the partial graph isn't needed
+    cudaGraph_t graph = nullptr;
+    CUDA_CALL(cudaStreamEndCapture(capture_stream_, &graph));
+    if (graph != nullptr) {
+      CUDA_CALL(cudaGraphDestroy(graph));
+    }
+    is_capturing_ = false;
+  }
+
+  if (graph_exec_ != nullptr) {
+    CUDA_CALL(cudaGraphExecDestroy(graph_exec_));
+    graph_exec_ = nullptr;
+  }
+
+  if (graph_ != nullptr) {
+    CUDA_CALL(cudaGraphDestroy(graph_));
+    graph_ = nullptr;
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/providers/cuda/cuda_pch.h"
+
+namespace onnxruntime {
+
+// Captures the work issued to a stream into a CUDA graph, so that it can be replayed with a single launch.
+// The legacy default stream can't be captured.
+class CUDAGraph {
+ public:
+  CUDAGraph() = default;
+  ~CUDAGraph();
+
+  Status CaptureBegin(cudaStream_t stream);
+  Status CaptureEnd();
+  Status Replay(cudaStream_t stream) const;
+  void Reset();
+
+  bool IsCapturing() const { return is_capturing_; }
+  bool IsCaptured() const { return graph_exec_ != nullptr; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CUDAGraph);
+
+  cudaStream_t capture_stream_ = nullptr;
+  bool is_capturing_ = false;
+  cudaGraph_t graph_ = nullptr;
+  cudaGraphExec_t graph_exec_ = nullptr;
+};
+
+}  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "cuda_execution_provider.h"
 #include "core/session/abi_session_options_impl.h"
+#include "core/session/ort_apis.h"
 #include "core/framework/bfc_arena.h"
 
 using namespace onnxruntime;
@@ -13,34 +14,39 @@ using namespace onnxruntime;
 namespace onnxruntime {
 
 struct CUDAProviderFactory : IExecutionProviderFactory {
-  CUDAProviderFactory(OrtDevice::DeviceId device_id,
-                      size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
-                      ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo) 
-      : device_id_(device_id), 
-        cuda_mem_limit_(cuda_mem_limit), 
-        arena_extend_strategy_(arena_extend_strategy) {}
+  explicit CUDAProviderFactory(const CUDAExecutionProviderInfo& info) : info_(info) {}
   ~CUDAProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
-  OrtDevice::DeviceId device_id_;
-  size_t cuda_mem_limit_;
-  ArenaExtendStrategy arena_extend_strategy_;
+  CUDAExecutionProviderInfo info_;
 };
 
 std::unique_ptr<IExecutionProvider> CUDAProviderFactory::CreateProvider() {
-  CUDAExecutionProviderInfo info;
-  info.device_id = device_id_;
-  info.cuda_mem_limit = cuda_mem_limit_;
-  info.arena_extend_strategy = arena_extend_strategy_;
-  return onnxruntime::make_unique<CUDAExecutionProvider>(info);
+  return onnxruntime::make_unique<CUDAExecutionProvider>(info_);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(OrtDevice::DeviceId device_id,
                                                                                size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
-                                                                               ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo) {
-  return std::make_shared<onnxruntime::CUDAProviderFactory>(device_id, cuda_mem_limit, arena_extend_strategy);
+                                                                               ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+                                                                               bool enable_cuda_graph = false,
+                                                                               bool use_stream_ordered_arena = false,
+                                                                               OrtCudnnConvAlgoSearch cudnn_conv_algo_search = EXHAUSTIVE,
+                                                                               const std::string& cudnn_conv_algo_cache_path = "",
+                                                                               bool initializers_in_host_memory = false,
+                                                                               size_t workspace_max_bytes = 0) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.cuda_mem_limit = cuda_mem_limit;
+  info.arena_extend_strategy = arena_extend_strategy;
+  info.enable_cuda_graph = enable_cuda_graph;
+  info.use_stream_ordered_arena = use_stream_ordered_arena;
+  info.cudnn_conv_algo_search = cudnn_conv_algo_search;
+  info.cudnn_conv_algo_cache_path = cudnn_conv_algo_cache_path;
+  info.initializers_in_host_memory = initializers_in_host_memory;
+  info.workspace_max_bytes = workspace_max_bytes;
+  return std::make_shared<onnxruntime::CUDAProviderFactory>(info);
 }
 
 }  // namespace onnxruntime
@@ -49,3 +55,22 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessi
   options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(static_cast<OrtDevice::DeviceId>(device_id)));
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA_WithExternalAllocator, _In_ OrtSessionOptions* options,
+                    int device_id, _In_ const OrtCUDAExternalAllocator* allocator) {
+  if (allocator == nullptr || allocator->Alloc == nullptr || allocator->Free == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "The external allocator must provide Alloc and Free");
+  }
+
+  CUDAExecutionProviderInfo info;
+  info.device_id = static_cast<OrtDevice::DeviceId>(device_id);
+  const OrtCUDAExternalAllocator external_allocator = *allocator;
+  info.external_allocator_info.alloc = [external_allocator](size_t size, cudaStream_t stream) {
+    return external_allocator.Alloc(external_allocator.user_data, size, stream);
+  };
+  info.external_allocator_info.free = [external_allocator](void* p) {
+    external_allocator.Free(external_allocator.user_data, p);
+  };
+  options->provider_factories.push_back(std::make_shared<onnxruntime::CUDAProviderFactory>(info));
+  return nullptr;
+}
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cuda_stream_ordered_arena.h"
+#include "core/framework/session_state.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/cuda_fence.h"
+#include "core/providers/cuda/gpu_data_transfer.h"
+
+namespace onnxruntime {
+
+#ifdef ORT_CUDA_HAS_STREAM_ORDERED_ARENA
+
+CUDAStreamOrderedArena::CUDAStreamOrderedArena(OrtDevice::DeviceId device_id, const char* name, size_t total_memory)
+    : IArenaAllocator(OrtMemoryInfo(name, OrtAllocatorType::OrtArenaAllocator,
+                                    OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, device_id),
+                                    device_id, OrtMemTypeDefault)),
+      total_memory_(total_memory) {
+  cudaMemPoolProps pool_props = {};
+  pool_props.allocType = cudaMemAllocationTypePinned;
+  pool_props.handleTypes = cudaMemHandleTypeNone;
+  pool_props.location.type = cudaMemLocationTypeDevice;
+  pool_props.location.id = device_id;
+  CUDA_CALL_THROW(cudaMemPoolCreate(&pool_, &pool_props));
+
+  // keep the freed memory cached in the pool like an arena, instead of releasing it at each synchronization
+  uint64_t release_threshold = std::numeric_limits<uint64_t>::max();
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool_, cudaMemPoolAttrReleaseThreshold, &release_threshold));
+
+  // allow memory freed on one stream to be reused by another once the dependencies of the free are satisfied
+  int enable = 1;
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool_, cudaMemPoolReuseFollowEventDependencies, &enable));
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool_, cudaMemPoolReuseAllowOpportunistic, &enable));
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool_, cudaMemPoolReuseAllowInternalDependencies, &enable));
+
+  stats_.bytes_limit = static_cast<int64_t>(total_memory);
+}
+
+CUDAStreamOrderedArena::~CUDAStreamOrderedArena() {
+  // memory that is still allocated is released with the pool
+  CUDA_CALL(cudaDeviceSynchronize());
+  CUDA_CALL(cudaMemPoolDestroy(pool_));
+}
+
+bool CUDAStreamOrderedArena::IsSupported(OrtDevice::DeviceId device_id) {
+  int supported = 0;
+  return cudaDeviceGetAttribute(&supported, cudaDevAttrMemoryPoolsSupported, device_id) == cudaSuccess &&
+         supported != 0;
+}
+
+void* CUDAStreamOrderedArena::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    if (static_cast<size_t>(stats_.bytes_in_use) + size > total_memory_) {
+      ORT_THROW("Available memory of ", total_memory_ - static_cast<size_t>(stats_.bytes_in_use),
+                " is smaller than requested bytes of ", size);
+    }
+  }
+
+  // the default stream of the calling thread
+  void* p = nullptr;
+  CUDA_CALL_THROW(cudaMallocFromPoolAsync(&p, size, pool_, nullptr));
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  allocations_[p] = size;
+  stats_.num_allocs += 1;
+  stats_.bytes_in_use += static_cast<int64_t>(size);
+  stats_.max_bytes_in_use = std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
+  stats_.max_alloc_size = std::max(stats_.max_alloc_size, static_cast<int64_t>(size));
+  return p;
+}
+
+void* CUDAStreamOrderedArena::Reserve(size_t size) {
+  return Alloc(size);
+}
+
+void CUDAStreamOrderedArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = allocations_.find(p);
+    ORT_ENFORCE(it != allocations_.end(), "Freeing memory that was not allocated by the CUDA memory pool");
+    stats_.bytes_in_use -= static_cast<int64_t>(it->second);
+    allocations_.erase(it);
+  }
+
+  // the memory becomes available to the pool once the work issued before on the default stream has completed
+  CUDA_CALL(cudaFreeAsync(p, nullptr));
+}
+
+FencePtr CUDAStreamOrderedArena::CreateFence(const SessionState* session_state) {
+  OrtDevice gpu_device(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0);
+  OrtDevice cpu_device;
+  return std::make_shared<CUDAFence>(dynamic_cast<const GPUDataTransfer*>(
+      session_state->GetDataTransferMgr().GetDataTransfer(gpu_device, cpu_device)));
+}
+
+size_t CUDAStreamOrderedArena::Used() const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  return static_cast<size_t>(stats_.bytes_in_use);
+}
+
+size_t CUDAStreamOrderedArena::Max() const {
+  return total_memory_;
+}
+
+Status CUDAStreamOrderedArena::Shrink() {
+  CUDA_RETURN_IF_ERROR(cudaMemPoolTrimTo(pool_, 0));
+  return Status::OK();
+}
+
+void CUDAStreamOrderedArena::GetStats(AllocatorStats* stats) {
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    *stats = stats_;
+  }
+
+  uint64_t reserved_bytes = 0;
+  if (CUDA_CALL(cudaMemPoolGetAttribute(pool_, cudaMemPoolAttrReservedMemCurrent, &reserved_bytes))) {
+    stats->total_allocated_bytes = static_cast<int64_t>(reserved_bytes);
+  }
+}
+
+#endif
+
+}  // namespace onnxruntime
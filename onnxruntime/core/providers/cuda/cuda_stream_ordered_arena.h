@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "core/framework/arena.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_pch.h"
+
+// cudaMallocAsync and the memory pools were added in CUDA 11.2
+#if CUDART_VERSION >= 11020
+#define ORT_CUDA_HAS_STREAM_ORDERED_ARENA
+#endif
+
+namespace onnxruntime {
+
+#ifdef ORT_CUDA_HAS_STREAM_ORDERED_ARENA
+
+// Caches device memory in a CUDA memory pool and allocates it in stream order with cudaMallocAsync.
+//
+// Memory is allocated and freed on the default stream of the calling thread, which is the per-thread default stream
+// when building with onnxruntime_CUDA_PER_THREAD_DEFAULT_STREAM. The pool tracks the stream memory was last freed on:
+// a later allocation on the same stream reuses it without synchronizing, and an allocation on another stream reuses
+// it once the work of the freeing stream has completed, as observed through CUDA events, instead of requiring a
+// device-wide synchronization. Unlike the BFCArena the allocator can therefore be shared by concurrent runs.
+class CUDAStreamOrderedArena : public IArenaAllocator {
+ public:
+  CUDAStreamOrderedArena(OrtDevice::DeviceId device_id, const char* name, size_t total_memory);
+  ~CUDAStreamOrderedArena() override;
+
+  // Returns true if the device supports memory pools.
+  static bool IsSupported(OrtDevice::DeviceId device_id);
+
+  void* Alloc(size_t size) override;
+  // Memory freed to the pool is reused for other requests, so reserved allocations are ordinary allocations.
+  void* Reserve(size_t size) override;
+  void Free(void* p) override;
+  FencePtr CreateFence(const SessionState* session_state) override;
+  size_t Used() const override;
+  size_t Max() const override;
+  // Releases the cached memory that isn't in use back to the device.
+  Status Shrink() override;
+
+  // bytes_in_use is the memory handed out by the allocator and total_allocated_bytes is the memory reserved by the
+  // pool. The difference is the memory cached by the pool, which includes memory lost to fragmentation.
+  void GetStats(AllocatorStats* stats) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CUDAStreamOrderedArena);
+
+  const size_t total_memory_;
+  cudaMemPool_t pool_ = nullptr;
+
+  mutable OrtMutex lock_;
+  std::unordered_map<void*, size_t> allocations_;  // GUARDED_BY(lock_)
+  AllocatorStats stats_;                           // GUARDED_BY(lock_)
+};
+
+#endif
+
+}  // namespace onnxruntime
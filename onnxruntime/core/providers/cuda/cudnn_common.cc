@@ -41,6 +41,32 @@ Status CudnnTensor::Set(const std::vector<int64_t>& input_dims, cudnnDataType_t
   return Status::OK();
 }
 
+Status CudnnTensor::Set(const std::vector<int64_t>& input_dims, cudnnDataType_t dataType,
+                        cudnnTensorFormat_t format) {
+  if (format != CUDNN_TENSOR_NHWC) {
+    return Set(input_dims, dataType);
+  }
+
+  ORT_RETURN_IF_ERROR(CreateTensorIfNeeded());
+
+  // the strides of the dims in NCHW order, for a tensor laid out as NHWC
+  int rank = gsl::narrow_cast<int>(input_dims.size());
+  ORT_RETURN_IF_NOT(rank > 2, "A channels-last tensor must have spatial dimensions.");
+  TensorPitches pitches(ChannelsLastDims(input_dims));
+  std::vector<int> dims(rank);
+  std::vector<int> strides(rank);
+  for (int i = 0; i < rank; i++) {
+    dims[i] = gsl::narrow_cast<int>(input_dims[i]);
+  }
+  strides[0] = gsl::narrow_cast<int>(pitches[0]);
+  strides[1] = 1;
+  for (int i = 2; i < rank; i++) {
+    strides[i] = gsl::narrow_cast<int>(pitches[i - 1]);
+  }
+  CUDNN_RETURN_IF_ERROR(cudnnSetTensorNdDescriptor(tensor_, dataType, rank, dims.data(), strides.data()));
+  return Status::OK();
+}
+
 Status CudnnTensor::Set(const CudnnTensor& x_desc, cudnnBatchNormMode_t mode) {
   ORT_RETURN_IF_ERROR(CreateTensorIfNeeded());
   CUDNN_RETURN_IF_ERROR(cudnnDeriveBNTensorDescriptor(tensor_, x_desc, mode));
@@ -94,7 +120,8 @@ CudnnFilterDescriptor::~CudnnFilterDescriptor() {
   }
 }
 
-Status CudnnFilterDescriptor::Set(const std::vector<int64_t>& filter_dims, cudnnDataType_t data_type) {
+Status CudnnFilterDescriptor::Set(const std::vector<int64_t>& filter_dims, cudnnDataType_t data_type,
+                                  cudnnTensorFormat_t format) {
   if (!desc_)
     CUDNN_RETURN_IF_ERROR(cudnnCreateFilterDescriptor(&desc_));
 
@@ -106,7 +133,7 @@ Status CudnnFilterDescriptor::Set(const std::vector<int64_t>& filter_dims, cudnn
 
   CUDNN_RETURN_IF_ERROR(cudnnSetFilterNdDescriptor(desc_,
                                                    data_type,
-                                                   CUDNN_TENSOR_NCHW,
+                                                   format,
                                                    rank,
                                                    w_dims.data()));
   return Status::OK();
@@ -4,6 +4,7 @@
 #pragma once
 #include "cuda_common.h"
 #include "core/framework/tensor.h"
+#include <algorithm>
 #include <cfloat>
 
 namespace onnxruntime {
@@ -16,6 +17,8 @@ class CudnnTensor final {
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudnnTensor);
 
   Status Set(const std::vector<int64_t>& input_dims, cudnnDataType_t dataType);
+  // input_dims are in NCHW order whatever the layout of the tensor in memory.
+  Status Set(const std::vector<int64_t>& input_dims, cudnnDataType_t dataType, cudnnTensorFormat_t format);
   Status Set(const CudnnTensor& x_desc, cudnnBatchNormMode_t mode);
 
   operator cudnnTensorDescriptor_t() const { return tensor_; }
@@ -55,7 +58,9 @@ class CudnnFilterDescriptor final {
   ~CudnnFilterDescriptor();
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudnnFilterDescriptor);
 
-  Status Set(const std::vector<int64_t>& filter_dims, cudnnDataType_t data_typ);
+  // filter_dims are in KCRS order whatever the layout of the filter in memory.
+  Status Set(const std::vector<int64_t>& filter_dims, cudnnDataType_t data_typ,
+             cudnnTensorFormat_t format = CUDNN_TENSOR_NCHW);
 
   operator cudnnFilterDescriptor_t() const { return desc_; }
 
@@ -123,6 +128,24 @@ struct Consts<half> {
   static const float One;
 };
 
+// Converts the dims of a channels-last tensor [N, D1, ..., Dn, C] to channels-first order [N, C, D1, ..., Dn].
+inline std::vector<int64_t> ChannelsFirstDims(const std::vector<int64_t>& dims) {
+  std::vector<int64_t> result(dims);
+  if (dims.size() > 2) {
+    std::rotate(result.begin() + 1, result.end() - 1, result.end());
+  }
+  return result;
+}
+
+// Converts the dims of a channels-first tensor [N, C, D1, ..., Dn] to channels-last order [N, D1, ..., Dn, C].
+inline std::vector<int64_t> ChannelsLastDims(const std::vector<int64_t>& dims) {
+  std::vector<int64_t> result(dims);
+  if (dims.size() > 2) {
+    std::rotate(result.begin() + 1, result.begin() + 2, result.end());
+  }
+  return result;
+}
+
 inline double ClampCudnnBatchNormEpsilon(double epsilon) {
   if (epsilon < CUDNN_BN_MIN_EPSILON) {
     if (CUDNN_BN_MIN_EPSILON - epsilon > FLT_EPSILON)
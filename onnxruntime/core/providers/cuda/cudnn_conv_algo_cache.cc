@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cudnn_conv_algo_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "core/common/logging/logging.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+// Version of the file format, bumped whenever the key or the entry layout changes.
+constexpr int kFileVersion = 1;
+
+void AppendDims(std::ostringstream& key, const char* name, const std::vector<int64_t>& dims) {
+  key << '|' << name;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    key << (i == 0 ? "" : ",") << dims[i];
+  }
+}
+}  // namespace
+
+CudnnConvAlgoCache::CudnnConvAlgoCache(const std::string& file, const cudaDeviceProp& device_prop) : file_(file) {
+  std::ostringstream header;
+  header << "onnxruntime_cudnn_conv_algo_cache " << kFileVersion
+         << " cudnn " << cudnnGetVersion()
+         << " sm " << device_prop.major << device_prop.minor
+         << " device " << device_prop.name;
+  header_ = header.str();
+
+  if (!file_.empty()) {
+    ReadFile(file_, header_, entries_);
+  }
+}
+
+CudnnConvAlgoCache::~CudnnConvAlgoCache() {
+  auto status = Save();
+  if (!status.IsOK()) {
+    LOGS_DEFAULT(WARNING) << status.ErrorMessage();
+  }
+}
+
+std::string CudnnConvAlgoCache::MakeKey(const char* kind, cudnnDataType_t data_type,
+                                        const std::vector<int64_t>& x_dims, const std::vector<int64_t>& w_dims,
+                                        const std::vector<int64_t>& pads, const std::vector<int64_t>& strides,
+                                        const std::vector<int64_t>& dilations, int64_t group) {
+  std::ostringstream key;
+  key << kind << "|t" << static_cast<int>(data_type);
+  AppendDims(key, "x", x_dims);
+  AppendDims(key, "w", w_dims);
+  AppendDims(key, "p", pads);
+  AppendDims(key, "s", strides);
+  AppendDims(key, "d", dilations);
+  key << "|g" << group;
+  return key.str();
+}
+
+bool CudnnConvAlgoCache::Find(const std::string& key, Entry& entry) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  entry = it->second;
+  return true;
+}
+
+void CudnnConvAlgoCache::Insert(const std::string& key, const Entry& entry) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  entries_[key] = entry;
+  modified_ = true;
+}
+
+void CudnnConvAlgoCache::ReadFile(const std::string& file, const std::string& header,
+                                  std::unordered_map<std::string, Entry>& entries) {
+  std::ifstream stream(file);
+  if (!stream) {
+    return;
+  }
+
+  std::string line;
+  if (!std::getline(stream, line) || line != header) {
+    LOGS_DEFAULT(INFO) << "Ignoring the cuDNN convolution algorithm cache " << file
+                       << ", which was written for another cuDNN version or device.";
+    return;
+  }
+
+  while (std::getline(stream, line)) {
+    std::istringstream fields(line);
+    std::string key;
+    Entry entry;
+    if (!(fields >> key >> entry.algo >> entry.memory >> entry.math_type)) {
+      LOGS_DEFAULT(WARNING) << "Ignoring a malformed entry of the cuDNN convolution algorithm cache " << file;
+      continue;
+    }
+    entries.emplace(std::move(key), entry);
+  }
+}
+
+Status CudnnConvAlgoCache::Save() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (file_.empty() || !modified_) {
+    return Status::OK();
+  }
+
+  // keep the entries other processes saved since this cache was loaded
+  ReadFile(file_, header_, entries_);
+
+  // the file is written to a temporary file which is then renamed, so that concurrent processes never load a
+  // partially written cache
+  const std::string temp_file = file_ + "." + std::to_string(Env::Default().GetSelfPid()) + ".tmp";
+  {
+    std::ofstream stream(temp_file, std::ios::out | std::ios::trunc);
+    stream << header_ << '\n';
+    for (const auto& entry : entries_) {
+      stream << entry.first << ' ' << entry.second.algo << ' ' << entry.second.memory << ' '
+             << entry.second.math_type << '\n';
+    }
+    if (!stream) {
+      stream.close();
+      std::remove(temp_file.c_str());
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Could not write the cuDNN convolution algorithm cache ", temp_file);
+    }
+  }
+  if (std::rename(temp_file.c_str(), file_.c_str()) != 0) {
+    std::remove(temp_file.c_str());
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Could not replace the cuDNN convolution algorithm cache ", file_);
+  }
+
+  modified_ = false;
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
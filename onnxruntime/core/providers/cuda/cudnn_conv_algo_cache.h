@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_pch.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The cuDNN convolution algorithms chosen for each convolution problem, shared by the convolution kernels of a
+// CUDA execution provider so that identical problems are benchmarked once.
+//
+// If a file is given the cache is loaded from it on construction and the new entries are merged into it on
+// destruction, so later processes skip the benchmarks. The first line of the file identifies the cuDNN version
+// and the device the algorithms were chosen for; a file written for another version or device is ignored and
+// replaced.
+class CudnnConvAlgoCache {
+ public:
+  struct Entry {
+    int algo;
+    size_t memory;
+    int math_type;
+  };
+
+  CudnnConvAlgoCache(const std::string& file, const cudaDeviceProp& device_prop);
+  ~CudnnConvAlgoCache();
+
+  // Key of a convolution problem. kind distinguishes the forward and backward algorithms, which share the problem
+  // description.
+  static std::string MakeKey(const char* kind, cudnnDataType_t data_type,
+                             const std::vector<int64_t>& x_dims, const std::vector<int64_t>& w_dims,
+                             const std::vector<int64_t>& pads, const std::vector<int64_t>& strides,
+                             const std::vector<int64_t>& dilations, int64_t group);
+
+  bool Find(const std::string& key, Entry& entry) const;
+
+  void Insert(const std::string& key, const Entry& entry);
+
+  // Merge the entries into the file. A no-op if the cache has no file or no new entries.
+  Status Save();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudnnConvAlgoCache);
+
+  // Add the entries of the file that aren't in entries.
+  static void ReadFile(const std::string& file, const std::string& header,
+                       std::unordered_map<std::string, Entry>& entries);
+
+  const std::string file_;
+  std::string header_;
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // whether entries were inserted since the cache was loaded or saved
+  bool modified_ = false;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -5,14 +5,26 @@
 #include "cuda_common.h"
 
 namespace onnxruntime {
-GPUDataTransfer::GPUDataTransfer() {
-  // create streams, default is nullptr
+GPUDataTransfer::GPUDataTransfer(AllocatorPtr pinned_allocator) : pinned_allocator_(std::move(pinned_allocator)) {
+  // create streams, default is nullptr (or the per-thread default stream of the calling thread)
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  streams_[kCudaStreamDefault] = cudaStreamPerThread;
+#else
   streams_[kCudaStreamDefault] = nullptr;
+#endif
   CUDA_CALL_THROW(cudaStreamCreateWithFlags(&streams_[kCudaStreamCopyIn], cudaStreamNonBlocking));
   CUDA_CALL_THROW(cudaStreamCreateWithFlags(&streams_[kCudaStreamCopyOut], cudaStreamNonBlocking));
 }
 
 GPUDataTransfer::~GPUDataTransfer() {
+  for (auto& staging : pending_staging_buffers_) {
+    CUDA_CALL(cudaEventSynchronize(staging.event));
+    pinned_allocator_->Free(staging.buffer);
+    CUDA_CALL(cudaEventDestroy(staging.event));
+  }
+  for (auto event : free_staging_events_) {
+    CUDA_CALL(cudaEventDestroy(event));
+  }
   CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyIn]));
   CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyOut]));
 }
@@ -40,17 +52,22 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
       if (dst_data != src_data) {
         CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToDevice, streams_[kCudaStreamDefault]));
       }
+    } else if (pinned_allocator_ != nullptr) {
+      // copy from other CPU memory to GPU through a pinned buffer, this is non-blocking
+      ORT_RETURN_IF_ERROR(CopyToGpuStaged(dst_data, src_data, bytes));
     } else {
-      // copy from other CPU memory to GPU, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
+      // copy from other CPU memory to GPU, this is blocking for the default stream only
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, streams_[kCudaStreamDefault]));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(streams_[kCudaStreamDefault]));
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     if (dst_device.Type() == OrtDevice::CPU && dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
       // copying from GPU to pinned memory, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, streams_[exec_queue_id]));
     } else {
-      // copying from GPU to CPU memory, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyDeviceToHost));
+      // copying from GPU to CPU memory, this is blocking for the default stream only
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, streams_[kCudaStreamDefault]));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(streams_[kCudaStreamDefault]));
     }
   } else {
     // copying between cpu memory
@@ -59,4 +76,48 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
 
   return Status::OK();
 }
+
+common::Status GPUDataTransfer::CopyToGpuStaged(void* dst_data, const void* src_data, size_t bytes) const {
+  // The copy is issued on the default stream rather than the copy-in stream: the device memory comes from an
+  // arena that reuses it in the order of the default stream, so a copy on another stream would have to wait for
+  // the default stream anyway. Only the CPU is released early, the copy of a run still overlaps the kernels
+  // issued by other runs when each thread uses its own default stream.
+  std::lock_guard<OrtMutex> lock(staging_mutex_);
+
+  // release the buffers of the copies that have completed
+  auto it = pending_staging_buffers_.begin();
+  while (it != pending_staging_buffers_.end()) {
+    if (cudaEventQuery(it->event) == cudaSuccess) {
+      pinned_allocator_->Free(it->buffer);
+      free_staging_events_.push_back(it->event);
+      it = pending_staging_buffers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  void* staging_buffer = pinned_allocator_->Alloc(bytes);
+  if (staging_buffer == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to allocate a pinned staging buffer of ", bytes, " bytes");
+  }
+  memcpy(staging_buffer, src_data, bytes);
+
+  cudaEvent_t event;
+  if (free_staging_events_.empty()) {
+    if (!CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming))) {
+      pinned_allocator_->Free(staging_buffer);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "CUDA error executing cudaEventCreateWithFlags");
+    }
+  } else {
+    event = free_staging_events_.back();
+    free_staging_events_.pop_back();
+  }
+
+  // the buffer is tracked before issuing the copy so that it's released (after the event) on any failure below
+  pending_staging_buffers_.push_back({staging_buffer, event});
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, staging_buffer, bytes, cudaMemcpyHostToDevice, streams_[kCudaStreamDefault]));
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(event, streams_[kCudaStreamDefault]));
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <vector>
+
 #include "cuda_pch.h"
+#include "core/framework/allocator.h"
 #include "core/framework/data_transfer.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -17,7 +21,9 @@ enum CUDAStreamType : int {
 
 class GPUDataTransfer : public IDataTransfer {
  public:
-  GPUDataTransfer();
+  // If pinned_allocator is provided, copies from pageable CPU memory to the GPU are staged through pinned
+  // buffers allocated from it so that they don't block the CPU.
+  explicit GPUDataTransfer(AllocatorPtr pinned_allocator = nullptr);
   ~GPUDataTransfer();
 
   bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override;
@@ -32,7 +38,20 @@ class GPUDataTransfer : public IDataTransfer {
   }
 
  private:
+  common::Status CopyToGpuStaged(void* dst_data, const void* src_data, size_t bytes) const;
+
   cudaStream_t streams_[kTotalCudaStreams];
+
+  // pinned buffers of staged copies, released once the event recorded after the copy has completed
+  struct StagingBuffer {
+    void* buffer;
+    cudaEvent_t event;
+  };
+
+  AllocatorPtr pinned_allocator_;
+  mutable std::vector<StagingBuffer> pending_staging_buffers_;
+  mutable std::vector<cudaEvent_t> free_staging_events_;
+  mutable OrtMutex staging_mutex_;
 };
 
 }  // namespace onnxruntime
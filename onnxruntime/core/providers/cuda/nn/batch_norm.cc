@@ -31,8 +31,8 @@ namespace cuda {
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),    \
       BatchNorm<T>);
 
-template <typename T>
-Status BatchNorm<T>::ComputeInternal(OpKernelContext* p_op_kernel_context) const {
+template <typename T, bool NHWC>
+Status BatchNorm<T, NHWC>::ComputeInternal(OpKernelContext* p_op_kernel_context) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
 
   const Tensor* X = p_op_kernel_context->Input<Tensor>(0);
@@ -41,11 +41,24 @@ Status BatchNorm<T>::ComputeInternal(OpKernelContext* p_op_kernel_context) const
   const Tensor* mean = p_op_kernel_context->Input<Tensor>(3);
   const Tensor* var = p_op_kernel_context->Input<Tensor>(4);
 
-  ORT_RETURN_IF_ERROR(BatchNormHelper::ValidateInputs(X, scale, B, mean, var, spatial_ == 1));
-
   const TensorShape& x_shape = X->Shape();
   const TensorShape& channel_shape = mean->Shape();
 
+  // cuDNN takes the dims in NCHW order along with the layout
+  const cudnnTensorFormat_t format = NHWC ? CUDNN_TENSOR_NHWC : CUDNN_TENSOR_NCHW;
+  int64_t C;
+  if (NHWC) {
+    ORT_RETURN_IF_NOT(x_shape.NumDimensions() > 2, "NHWC BatchNormalization requires spatial dimensions.");
+    C = x_shape.GetDims().back();
+    for (const Tensor* input : {scale, B, mean, var}) {
+      ORT_RETURN_IF_NOT(input->Shape().NumDimensions() == 1 && input->Shape()[0] == C,
+                        "NHWC BatchNormalization requires inputs of shape [C].");
+    }
+  } else {
+    ORT_RETURN_IF_ERROR(BatchNormHelper::ValidateInputs(X, scale, B, mean, var, spatial_ == 1));
+    C = x_shape.GetDims()[1];
+  }
+
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
   Tensor* running_mean = p_op_kernel_context->Output(1, channel_shape);
   Tensor* running_var = p_op_kernel_context->Output(2, channel_shape);
@@ -65,8 +78,8 @@ Status BatchNorm<T>::ComputeInternal(OpKernelContext* p_op_kernel_context) const
 
   CudnnTensor data_desc;
   vector<int64_t> new_dims;
-  BatchNormHelper::NormalizeDims(x_shape, new_dims);
-  ORT_RETURN_IF_ERROR(data_desc.Set(new_dims, CudnnTensor::GetDataType<CudaT>()));
+  BatchNormHelper::NormalizeDims(NHWC ? TensorShape(ChannelsFirstDims(x_shape.GetDims())) : x_shape, new_dims);
+  ORT_RETURN_IF_ERROR(data_desc.Set(new_dims, CudnnTensor::GetDataType<CudaT>(), format));
 
   // For half data type, the alpha, beta, scale, B, mean, var need to be float type
   if (X->IsDataType<MLFloat16>()) {
@@ -76,7 +89,6 @@ Status BatchNorm<T>::ComputeInternal(OpKernelContext* p_op_kernel_context) const
     ORT_RETURN_IF_ERROR(bn_tensor_desc.Set(data_desc, cudnn_batch_norm_mode_));
 
     // Convert the scale, B, mean, var to float
-    const int64_t C = x_shape.GetDims()[1];
     auto f_scale = GetScratchBuffer<float>(C);
     auto f_B = GetScratchBuffer<float>(C);
     auto f_mean = GetScratchBuffer<float>(C);
@@ -162,5 +174,9 @@ SPECIALIZED_COMPUTE(float)
 SPECIALIZED_COMPUTE(double)
 SPECIALIZED_COMPUTE(MLFloat16)
 
+// the NHWC variants are registered with the contrib ops, in the kMSNhwcDomain
+template Status BatchNorm<float, true>::ComputeInternal(OpKernelContext* ctx) const;
+template Status BatchNorm<MLFloat16, true>::ComputeInternal(OpKernelContext* ctx) const;
+
 }  // namespace cuda
 }  // namespace onnxruntime
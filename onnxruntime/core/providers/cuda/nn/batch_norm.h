@@ -9,7 +9,9 @@
 namespace onnxruntime {
 namespace cuda {
 
-template <typename T>
+// With NHWC, X and Y are laid out as [N, D1, ..., Dn, C], as produced by the NhwcTransformer. Only the inference
+// mode is supported in this layout.
+template <typename T, bool NHWC = false>
 class BatchNorm final : public CudaKernel {
  public:
   BatchNorm(const OpKernelInfo& op_kernel_info)
@@ -33,8 +33,8 @@ REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 REGISTER_KERNEL_TYPED(MLFloat16)
 
-template <typename T>
-Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
+template <typename T, bool NHWC>
+Status Conv<T, NHWC>::ComputeInternal(OpKernelContext* context) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
 
   const Tensor* X = context->Input<Tensor>(0);
@@ -50,6 +50,9 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   bool has_bias = (num_inputs == 3);
 
+  // cuDNN takes the dims in NCHW order along with the layout
+  const cudnnTensorFormat_t format = NHWC ? CUDNN_TENSOR_NHWC : CUDNN_TENSOR_NCHW;
+
   CudaT* y_data = nullptr;
 
   {
@@ -69,10 +72,19 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
       const int64_t N = X->Shape()[0];
       const int64_t M = W->Shape()[0];
 
-      ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+      std::vector<int64_t> x_dims_cudnn = x_dims;
+      if (NHWC) {
+        ORT_RETURN_IF_NOT(x_dims.size() == 4 && w_dims.size() == 4, "NHWC Conv only supports 2D convolutions.");
+        x_dims_cudnn = ChannelsFirstDims(x_dims);
+        w_dims = ChannelsFirstDims(w_dims);
+        ORT_RETURN_IF_NOT(x_dims_cudnn[1] == w_dims[1] * conv_attrs_.group,
+                          "Input channels C is not equal to kernel channels * group.");
+      } else {
+        ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+      }
 
       std::vector<int64_t> kernel_shape;
-      ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+      ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(TensorShape(w_dims), kernel_shape));
       auto rank = kernel_shape.size();
       std::vector<int64_t> pads(conv_attrs_.pads);
       if (pads.empty()) {
@@ -89,13 +101,12 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
 
       std::vector<int64_t> y_dims;
       y_dims.insert(y_dims.begin(), {N, M});
-      ORT_RETURN_IF_ERROR(conv_attrs_.InferOutputShape<true>(x_shape.Slice(2), kernel_shape,
+      ORT_RETURN_IF_ERROR(conv_attrs_.InferOutputShape<true>(TensorShape(x_dims_cudnn).Slice(2), kernel_shape,
                                                              strides, dilations, &pads, &y_dims));
-      s_.y_dims = y_dims;
+      s_.y_dims = NHWC ? ChannelsLastDims(y_dims) : y_dims;
       Tensor* Y = context->Output(0, TensorShape(s_.y_dims));
       y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
 
-      std::vector<int64_t> x_dims_cudnn = x_dims;
       std::vector<int64_t> y_dims_cudnn = y_dims;
       if (rank < 2) {
         // cudnn only takes 4D or 5D input, so pad dimensions if needed
@@ -110,7 +121,7 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
       }
 
       if (w_dims_changed)
-        ORT_RETURN_IF_ERROR(s_.filter_desc.Set(w_dims, CudnnTensor::GetDataType<CudaT>()));
+        ORT_RETURN_IF_ERROR(s_.filter_desc.Set(w_dims, CudnnTensor::GetDataType<CudaT>(), format));
 
       // Special case when there is a dim value of 0 in the shape.
       // Return only after we have cached the following for subsequent runs :
@@ -120,8 +131,8 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
         return Status::OK();
       }
 
-      ORT_RETURN_IF_ERROR(s_.x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<CudaT>()));
-      ORT_RETURN_IF_ERROR(s_.y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<CudaT>()));
+      ORT_RETURN_IF_ERROR(s_.x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<CudaT>(), format));
+      ORT_RETURN_IF_ERROR(s_.y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<CudaT>(), format));
 
       cudnnConvolutionMode_t mode = CUDNN_CROSS_CORRELATION;
       ORT_RETURN_IF_ERROR(s_.conv_desc.Set(kernel_shape.size(), pads, strides, dilations,
@@ -141,29 +152,67 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
       }
 
       if (!s_.cached_benchmark_results.contains(x_dims_cudnn)) {
-        IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
-
-        // set math type to tensor core before algorithm search
-        if (std::is_same<T, MLFloat16>::value)
-          CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
-
-        cudnnConvolutionFwdAlgoPerf_t perf;
-        int algo_count = 1;
-        CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
-            CudnnHandle(),
-            s_.x_tensor,
-            x_data,
-            s_.filter_desc,
-            w_data,
-            s_.conv_desc,
-            s_.y_tensor,
-            y_data,
-            1,
-            &algo_count,
-            &perf,
-            algo_search_workspace.get(),
-            AlgoSearchWorkspaceSize));
-        s_.cached_benchmark_results.insert(x_dims_cudnn, {perf.algo, perf.memory, perf.mathType});
+        // identical problems of other Conv nodes, or of previous processes if the cache is persisted, are searched
+        // only once
+        auto& algo_cache = GetCudnnConvAlgoCache();
+        const std::string algo_key = CudnnConvAlgoCache::MakeKey(NHWC ? "fwd_nhwc" : "fwd",
+                                                                 CudnnTensor::GetDataType<CudaT>(),
+                                                                 x_dims_cudnn, w_dims, pads, strides, dilations,
+                                                                 conv_attrs_.group);
+        CudnnConvAlgoCache::Entry cached;
+        if (algo_cache.Find(algo_key, cached)) {
+          s_.cached_benchmark_results.insert(x_dims_cudnn,
+                                             {static_cast<cudnnConvolutionFwdAlgo_t>(cached.algo), cached.memory,
+                                              static_cast<cudnnMathType_t>(cached.math_type)});
+        } else {
+          // set math type to tensor core before algorithm search
+          if (std::is_same<T, MLFloat16>::value)
+            CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
+
+          cudnnConvolutionFwdAlgoPerf_t perf;
+          if (GetCudnnConvAlgoSearch() == HEURISTIC) {
+            // the heuristics don't run the convolution, so their choice is cheap and isn't cached across nodes
+            constexpr int max_algo_count = CUDNN_CONVOLUTION_FWD_ALGO_COUNT;
+            cudnnConvolutionFwdAlgoPerf_t perfs[max_algo_count];
+            int algo_count = 0;
+            CUDNN_RETURN_IF_ERROR(cudnnGetConvolutionForwardAlgorithm_v7(
+                CudnnHandle(),
+                s_.x_tensor,
+                s_.filter_desc,
+                s_.conv_desc,
+                s_.y_tensor,
+                max_algo_count,
+                &algo_count,
+                perfs));
+            // the results are ranked, use the first one that is supported for the problem
+            int chosen = 0;
+            while (chosen < algo_count && perfs[chosen].status != CUDNN_STATUS_SUCCESS) {
+              ++chosen;
+            }
+            ORT_RETURN_IF_NOT(chosen < algo_count, "No cuDNN convolution algorithm supports the problem.");
+            perf = perfs[chosen];
+          } else {
+            IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
+
+            int algo_count = 1;
+            CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
+                CudnnHandle(),
+                s_.x_tensor,
+                x_data,
+                s_.filter_desc,
+                w_data,
+                s_.conv_desc,
+                s_.y_tensor,
+                y_data,
+                1,
+                &algo_count,
+                &perf,
+                algo_search_workspace.get(),
+                AlgoSearchWorkspaceSize));
+            algo_cache.Insert(algo_key, {static_cast<int>(perf.algo), perf.memory, static_cast<int>(perf.mathType)});
+          }
+          s_.cached_benchmark_results.insert(x_dims_cudnn, {perf.algo, perf.memory, perf.mathType});
+        }
       }
 
       const auto& perf = s_.cached_benchmark_results.at(x_dims_cudnn);
@@ -184,7 +233,7 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
     const auto alpha = Consts<CudaT>::One;
     const auto beta = Consts<CudaT>::Zero;
 
-    IAllocatorUniquePtr<void> workspace = GetScratchBuffer<void>(s_.workspace_bytes);
+    IAllocatorUniquePtr<void> workspace = GetWorkspace(s_.workspace_bytes);
 
     CUDNN_RETURN_IF_ERROR(cudnnConvolutionForward(CudnnHandle(),
                                                   &alpha,
@@ -210,6 +259,10 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
   return Status::OK();
 }
 
+// the NHWC variants are registered with the contrib ops, in the kMSNhwcDomain
+template class Conv<float, true>;
+template class Conv<MLFloat16, true>;
+
 CudnnConvolutionDescriptor::CudnnConvolutionDescriptor() : desc_(nullptr) {
 }
 
@@ -141,7 +141,9 @@ enum : size_t {
   AlgoSearchWorkspaceSize = 32 * 1024 * 1024,
 };
 
-template <typename T>
+// With NHWC, X and Y are laid out as [N, H, W, C] and W as [M, kH, kW, C/group], as produced by the
+// NhwcTransformer. Only 2D convolutions are supported in this layout.
+template <typename T, bool NHWC = false>
 class Conv : public CudaKernel {
  public:
   Conv(const OpKernelInfo& info) : CudaKernel(info), conv_attrs_(info) {
@@ -26,7 +26,10 @@ namespace cuda {
 
 constexpr int UNROLL = 4;
 
-template <typename T>
+// Each group of UNROLL consecutive elements takes its random numbers from the Philox subsequence numbered after the
+// group, so the mask only depends on the seed and the offset, not on the device or the launch configuration.
+// Starting a Philox state at a subsequence only sets its counter, so a state per group is cheap.
+template <typename T, bool Vectorized>
 __global__ void DropoutKernel(
     const int64_t N,
     const float ratio,
@@ -34,35 +37,41 @@ __global__ void DropoutKernel(
     const T* X_data,
     T* Y_data,
     bool* mask_data) {
+  using LoadT = aligned_vector<T, UNROLL>;
+  using MaskT = aligned_vector<bool, UNROLL>;
+
   const float p = 1.0f - ratio;
   const float scale = 1.0f / p;
 
-  CUDA_LONG idx = blockDim.x * blockIdx.x + threadIdx.x;
-  CUDA_LONG step_size = gridDim.x * blockDim.x * UNROLL;
-  CUDA_LONG rounded_size = ((N - 1) / step_size + 1) * step_size;
-
-  curandStatePhilox4_32_10_t state;
-  curand_init(seeds.first, idx, seeds.second, &state);
+  const CUDA_LONG num_groups = static_cast<CUDA_LONG>((N + UNROLL - 1) / UNROLL);
+  const CUDA_LONG stride = gridDim.x * blockDim.x;
+  for (CUDA_LONG group = blockDim.x * blockIdx.x + threadIdx.x; group < num_groups; group += stride) {
+    curandStatePhilox4_32_10_t state;
+    curand_init(seeds.first, group, seeds.second, &state);
+    const float4 rand = curand_uniform4(&state);
 
-  // We ensure every thread generates the same number of random numbers (by rounding
-  // up the size) and at the same timestep (by syncing threads).
-  // From CUDA curand documentation:
-  //   The Philox_4x32_10 algorithm is closely tied to the thread and block count.
-  //   Each thread computes 4 random numbers in the same time thus the most efficient
-  //   use of Philox_4x32_10 is to generate a multiple of 4 times number of threads.
-  for (CUDA_LONG id = idx; id < rounded_size; id += step_size) {
-    float4 rand = curand_uniform4(&state);
-  
+    const CUDA_LONG start = group * UNROLL;
+    if (Vectorized && start + UNROLL <= N) {
+      const LoadT x = reinterpret_cast<const LoadT*>(X_data)[group];
+      LoadT y;
+      MaskT mask;
+  #pragma unroll
+      for (int i = 0; i < UNROLL; i++) {
+        mask.val[i] = (&rand.x)[i] < p;
+        y.val[i] = T(float(x.val[i]) * mask.val[i] * scale);
+      }
+      reinterpret_cast<LoadT*>(Y_data)[group] = y;
+      reinterpret_cast<MaskT*>(mask_data)[group] = mask;
+    } else {
   #pragma unroll
-    for (CUDA_LONG i = 0; i < UNROLL; i++) {
-      CUDA_LONG li = id + gridDim.x * blockDim.x * i;
-      if (li < N) {
-        mask_data[li] = (&rand.x)[i] < p;
-        Y_data[li] = T(float(X_data[li]) * mask_data[li] * scale);
+      for (int i = 0; i < UNROLL; i++) {
+        const CUDA_LONG li = start + i;
+        if (li < N) {
+          mask_data[li] = (&rand.x)[i] < p;
+          Y_data[li] = T(float(X_data[li]) * mask_data[li] * scale);
+        }
       }
     }
-
-    __syncthreads();
   }
 }
 
@@ -75,15 +84,22 @@ void DropoutKernelImpl(
     const T* X_data,
     T* Y_data,
     bool* mask_data) {
+  if (N == 0) {
+    return;
+  }
+
   const int block_size = 256;
   const int blocks_per_sm = prop.maxThreadsPerMultiProcessor / block_size;
   const int grid_size = std::min(prop.multiProcessorCount * blocks_per_sm, static_cast<int>(CeilDiv(N, block_size * UNROLL)));
 
-  // Compute the number of random numbers generated by each thread, and increment philox generator offset by that amount.
-  const uint64_t counter_offset = static_cast<uint64_t>(((N - 1) / (block_size * grid_size * UNROLL) + 1) * UNROLL);
-  auto seeds = generator.NextPhiloxSeeds(counter_offset);
+  // every subsequence is used for UNROLL random numbers
+  auto seeds = generator.NextPhiloxSeeds(UNROLL);
 
-  DropoutKernel<T><<<grid_size, block_size, 0>>>(N, ratio, seeds, X_data, Y_data, mask_data);
+  if (CanVectorize<T, UNROLL>(X_data) && CanVectorize<T, UNROLL>(Y_data) && CanVectorize<bool, UNROLL>(mask_data)) {
+    DropoutKernel<T, true><<<grid_size, block_size, 0>>>(N, ratio, seeds, X_data, Y_data, mask_data);
+  } else {
+    DropoutKernel<T, false><<<grid_size, block_size, 0>>>(N, ratio, seeds, X_data, Y_data, mask_data);
+  }
 }
 
 #define SPECIALIZED_DROPOUT_IMPL(T) \
@@ -122,17 +122,20 @@ class CudnnPoolingDescriptor final {
   cudnnPoolingDescriptor_t desc_;
 };
 
-template <typename T, typename PoolType>
-Status Pool<T, PoolType>::ComputeInternal(OpKernelContext* context) const {
+template <typename T, typename PoolType, bool NHWC>
+Status Pool<T, PoolType, NHWC>::ComputeInternal(OpKernelContext* context) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
   const Tensor* X = context->Input<Tensor>(0);
-  const TensorShape& x_shape = X->Shape();
-  const auto& x_dims = x_shape.GetDims();
 
-  if (x_shape.NumDimensions() < 3) {
+  if (X->Shape().NumDimensions() < 3) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input dimension cannot be less than 3.");
   }
 
+  // cuDNN takes the dims in NCHW order along with the layout
+  const cudnnTensorFormat_t format = NHWC ? CUDNN_TENSOR_NHWC : CUDNN_TENSOR_NCHW;
+  const TensorShape x_shape = NHWC ? TensorShape(ChannelsFirstDims(X->Shape().GetDims())) : X->Shape();
+  const auto& x_dims = x_shape.GetDims();
+
   std::vector<int64_t> kernel_shape = pool_attrs_.kernel_shape;
   std::vector<int64_t> pads = pool_attrs_.pads;
   std::vector<int64_t> strides = pool_attrs_.strides;
@@ -144,7 +147,7 @@ Status Pool<T, PoolType>::ComputeInternal(OpKernelContext* context) const {
   }
 
   std::vector<int64_t> y_dims = pool_attrs_.SetOutputSize(x_shape, x_shape[1], &pads);
-  TensorShape y_shape(y_dims);
+  TensorShape y_shape(NHWC ? ChannelsLastDims(y_dims) : y_dims);
   Tensor* Y = context->Output(0, y_shape);
   // special case when there is a dim value of 0 in the shape.
   if (y_shape.Size() == 0)
@@ -179,8 +182,8 @@ Status Pool<T, PoolType>::ComputeInternal(OpKernelContext* context) const {
     const auto beta = Consts<float>::Zero;
     CudnnTensor x_tensor;
     CudnnTensor y_tensor;
-    ORT_RETURN_IF_ERROR(x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<float>()));
-    ORT_RETURN_IF_ERROR(y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<float>()));
+    ORT_RETURN_IF_ERROR(x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<float>(), format));
+    ORT_RETURN_IF_ERROR(y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<float>(), format));
 
     const auto input_count = x_shape.Size();
     const auto output_count = y_shape.Size();
@@ -195,8 +198,8 @@ Status Pool<T, PoolType>::ComputeInternal(OpKernelContext* context) const {
     const auto beta = Consts<CudaT>::Zero;
     CudnnTensor x_tensor;
     CudnnTensor y_tensor;
-    ORT_RETURN_IF_ERROR(x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<CudaT>()));
-    ORT_RETURN_IF_ERROR(y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<CudaT>()));
+    ORT_RETURN_IF_ERROR(x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<CudaT>(), format));
+    ORT_RETURN_IF_ERROR(y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<CudaT>(), format));
 
     CUDNN_RETURN_IF_ERROR(cudnnPoolingForward(CudnnHandle(), pooling_desc, &alpha, x_tensor, x_data, &beta, y_tensor, y_data));
   }
@@ -255,5 +258,11 @@ Status Pool<T, MaxPool<8>>::ComputeInternal(OpKernelContext* context) const {
   return Status::OK();
 }
 
+// the NHWC variants are registered with the contrib ops, in the kMSNhwcDomain
+template class Pool<float, MaxPool<1>, true>;
+template class Pool<MLFloat16, MaxPool<1>, true>;
+template class Pool<float, AveragePool, true>;
+template class Pool<MLFloat16, AveragePool, true>;
+
 }  // namespace cuda
 }  // namespace onnxruntime
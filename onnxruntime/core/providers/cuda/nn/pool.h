@@ -11,7 +11,8 @@
 namespace onnxruntime {
 namespace cuda {
 
-template <typename T, typename PoolType>
+// With NHWC, X and Y are laid out as [N, D1, ..., Dn, C], as produced by the NhwcTransformer.
+template <typename T, typename PoolType, bool NHWC = false>
 class Pool : public CudaKernel, public PoolBase {
  public:
   Pool(OpKernelInfo info) : CudaKernel(info), PoolBase(info) {}
@@ -396,5 +396,413 @@ template void reduce_matrix_rows<float, float>(
 template void reduce_matrix_rows<double, double>(
   const double* data, double* output, int m, int n);
 
+bool is_supported_matrix_reduction_op(const cudnnReduceTensorOp_t cudnn_reduce_op) {
+  switch (cudnn_reduce_op) {
+    case CUDNN_REDUCE_TENSOR_ADD:
+    case CUDNN_REDUCE_TENSOR_AVG:
+    case CUDNN_REDUCE_TENSOR_MUL:
+    case CUDNN_REDUCE_TENSOR_MAX:
+    case CUDNN_REDUCE_TENSOR_MIN:
+    case CUDNN_REDUCE_TENSOR_NORM1:
+    case CUDNN_REDUCE_TENSOR_NORM2:
+      return true;
+    default:
+      return false;
+  }
+}
+
+ApplicableMatrixReduction get_applicable_matrix_reduction(
+    const cudnnReduceTensorOp_t cudnn_reduce_op,
+    const std::vector<int64_t>& dims,
+    const std::vector<int64_t>& axes,
+    int& m,
+    int& n) {
+  if (!is_supported_matrix_reduction_op(cudnn_reduce_op))
+    return ApplicableMatrixReduction::None;
+
+  const int64_t rank = static_cast<int64_t>(dims.size());
+  std::vector<bool> reduced(rank, axes.empty());
+  for (auto axis : axes) {
+    reduced[axis < 0 ? axis + rank : axis] = true;
+  }
+
+  // dims of 1 can be seen as reduced or kept, so only the other ones have to be either leading or trailing
+  int64_t reduced_size = 1;
+  int64_t kept_size = 1;
+  bool leading_reduced = true;
+  bool trailing_reduced = true;
+  for (int64_t i = 0; i < rank; ++i) {
+    if (dims[i] == 1)
+      continue;
+    if (reduced[i]) {
+      reduced_size *= dims[i];
+      leading_reduced = leading_reduced && kept_size == 1;
+    } else {
+      kept_size *= dims[i];
+      trailing_reduced = trailing_reduced && reduced_size == 1;
+    }
+  }
+
+  // all or none of the elements reduced together are handled by the callers
+  if (reduced_size == 1 || kept_size == 1)
+    return ApplicableMatrixReduction::None;
+  if (reduced_size > std::numeric_limits<int>::max() || kept_size > std::numeric_limits<int>::max())
+    return ApplicableMatrixReduction::None;
+
+  if (leading_reduced) {
+    m = static_cast<int>(reduced_size);
+    n = static_cast<int>(kept_size);
+    return ApplicableMatrixReduction::Rows;
+  }
+
+  // a block reduces each row, so a few long rows wouldn't keep the device busy
+  constexpr int64_t min_rows_for_long_rows = 128;
+  constexpr int64_t max_short_row_size = 16384;
+  if (trailing_reduced && (kept_size >= min_rows_for_long_rows || reduced_size <= max_short_row_size)) {
+    m = static_cast<int>(kept_size);
+    n = static_cast<int>(reduced_size);
+    return ApplicableMatrixReduction::Columns;
+  }
+
+  return ApplicableMatrixReduction::None;
+}
+
+template <typename TReduce, typename TBuf>
+__device__ __forceinline__ TBuf warp_reduce(TBuf value) {
+#pragma unroll
+  for (int stride = GPU_WARP_SIZE / 2; stride > 0; stride /= 2) {
+    value = TReduce()(value, WARP_SHFL_DOWN(value, stride));
+  }
+  return value;
+}
+
+// Reduces each row of a m-by-n matrix. Either a warp reduces each of the blockDim.y rows of a block, or all the
+// warps of a block (blockDim.y == 1) reduce a row together.
+template <typename TIn, typename TOut, typename TBuf, typename TOp, typename TReduce, typename TFinalOp,
+          bool DivideResultBySize>
+__global__ void reduce_matrix_columns_kernel(const TIn* input, TOut* output, int m, int n) {
+  // Shape is the number of warps in a row and element type is TBuf.
+  extern __shared__ unsigned char shared_memory_[];
+  TBuf* shared_memory = reinterpret_cast<TBuf*>(shared_memory_);
+  const int num_warps_in_row = blockDim.x / GPU_WARP_SIZE;
+  const int wid_in_row = threadIdx.x / GPU_WARP_SIZE;
+  const int lid_in_warp = threadIdx.x % GPU_WARP_SIZE;
+
+  // blockDim.y is 1 whenever several warps reduce a row, so all the threads of such a block run the same iterations
+  for (int row = blockIdx.x * blockDim.y + threadIdx.y; row < m; row += gridDim.x * blockDim.y) {
+    const TIn* row_data = input + static_cast<int64_t>(row) * n;
+    TBuf value = TReduce::Init();
+    for (int col = threadIdx.x; col < n; col += blockDim.x) {
+      value = TReduce()(value, TOp()(row_data[col]));
+    }
+    value = warp_reduce<TReduce>(value);
+
+    if (num_warps_in_row > 1) {
+      if (lid_in_warp == 0) {
+        shared_memory[wid_in_row] = value;
+      }
+      __syncthreads();
+      if (wid_in_row == 0) {
+        value = warp_reduce<TReduce>(lid_in_warp < num_warps_in_row ? shared_memory[lid_in_warp] : TReduce::Init());
+      }
+      // the shared memory is written again for the next row
+      __syncthreads();
+    }
+
+    if (threadIdx.x == 0) {
+      // Compilation time if-else branch controlled by template argument can be
+      // optimized out, so there will be no branch in real computation phase.
+      if (DivideResultBySize) {
+        output[row] = TOut(TFinalOp()(value / TBuf(n)));
+      } else {
+        output[row] = TOut(TFinalOp()(value));
+      }
+    }
+  }
+}
+
+template <typename TIn, typename TOut, typename TBuf, typename TOp, typename TReduce, typename TFinalOp,
+          bool DivideResultBySize>
+void call_reduce_matrix_columns(const TIn* input, TOut* output, int m, int n) {
+  constexpr int max_num_threads_in_row = 256;
+  constexpr int num_rows_per_warp_block = 8;
+  constexpr int max_num_blocks_in_grid = 65535;
+
+  // a warp for rows of up to NUM_ELEMENTS_PER_THREAD elements per lane, more warps for the longer rows
+  const int num_threads_in_row = std::min(
+      max_num_threads_in_row,
+      std::max(GPU_WARP_SIZE, least_pow2_bound(std::max(1, n / NUM_ELEMENTS_PER_THREAD))));
+  const dim3 block(num_threads_in_row, num_threads_in_row == GPU_WARP_SIZE ? num_rows_per_warp_block : 1, 1);
+  const dim3 grid(std::min(max_num_blocks_in_grid, static_cast<int>(CeilDiv(m, block.y))), 1, 1);
+  const int shared_mem_size = sizeof(TBuf) * num_threads_in_row / GPU_WARP_SIZE;
+
+  reduce_matrix_columns_kernel<TIn, TOut, TBuf, TOp, TReduce, TFinalOp, DivideResultBySize>
+      <<<grid, block, shared_mem_size>>>(input, output, m, n);
+}
+
+template <typename TIn, typename TOut>
+void reduce_matrix_columns(cudnnReduceTensorOp_t cudnn_reduce_op, const TIn* input, TOut* output, int m, int n) {
+  typedef typename ToBuffer<TOut>::Type TBuf;
+  switch (cudnn_reduce_op) {
+    case CUDNN_REDUCE_TENSOR_ADD:
+      call_reduce_matrix_columns<TIn, TOut, TBuf, Cast<TBuf, TIn>, Add<TBuf>, Identity<TBuf>, false>(input, output, m, n);
+      break;
+    case CUDNN_REDUCE_TENSOR_AVG:
+      call_reduce_matrix_columns<TIn, TOut, TBuf, Cast<TBuf, TIn>, Add<TBuf>, Identity<TBuf>, true>(input, output, m, n);
+      break;
+    case CUDNN_REDUCE_TENSOR_MUL:
+      call_reduce_matrix_columns<TIn, TOut, TBuf, Cast<TBuf, TIn>, Mul<TBuf>, Identity<TBuf>, false>(input, output, m, n);
+      break;
+    case CUDNN_REDUCE_TENSOR_MAX:
+      call_reduce_matrix_columns<TIn, TOut, TBuf, Cast<TBuf, TIn>, Max<TBuf>, Identity<TBuf>, false>(input, output, m, n);
+      break;
+    case CUDNN_REDUCE_TENSOR_MIN:
+      call_reduce_matrix_columns<TIn, TOut, TBuf, Cast<TBuf, TIn>, Min<TBuf>, Identity<TBuf>, false>(input, output, m, n);
+      break;
+    case CUDNN_REDUCE_TENSOR_NORM1:
+      call_reduce_matrix_columns<TIn, TOut, TBuf, Abs<TBuf, TIn>, Add<TBuf>, Identity<TBuf>, false>(input, output, m, n);
+      break;
+    case CUDNN_REDUCE_TENSOR_NORM2:
+      call_reduce_matrix_columns<TIn, TOut, TBuf, Square<TBuf, TIn>, Add<TBuf>, Sqrt<TBuf>, false>(input, output, m, n);
+      break;
+    default:
+      // rejected by get_applicable_matrix_reduction
+      break;
+  }
+}
+
+template void reduce_matrix_columns<half, half>(
+  cudnnReduceTensorOp_t cudnn_reduce_op, const half* input, half* output, int m, int n);
+template void reduce_matrix_columns<float, float>(
+  cudnnReduceTensorOp_t cudnn_reduce_op, const float* input, float* output, int m, int n);
+template void reduce_matrix_columns<double, double>(
+  cudnnReduceTensorOp_t cudnn_reduce_op, const double* input, double* output, int m, int n);
+
+// The rows of a m-by-n matrix are split into gridDim.y chunks. Each block reduces the rows of its chunk for
+// blockDim.x columns into partial[chunk, col], and reduce_matrix_rows_final_kernel reduces the chunks, so the
+// result doesn't depend on the order the blocks run in.
+template <typename TIn, typename TBuf, typename TOp, typename TReduce>
+__global__ void reduce_matrix_rows_partial_kernel(const TIn* input, TBuf* partial, int m, int n, int num_rows_in_chunk) {
+  // Shape is blockDim.y-by-blockDim.x and element type is TBuf.
+  extern __shared__ unsigned char shared_memory_[];
+  TBuf* shared_memory = reinterpret_cast<TBuf*>(shared_memory_);
+  const int tid_in_block = threadIdx.x + blockDim.x * threadIdx.y;
+  const int col = blockIdx.x * blockDim.x + threadIdx.x;
+  const int row_begin = blockIdx.y * num_rows_in_chunk;
+  const int row_end = min(m, row_begin + num_rows_in_chunk);
+
+  TBuf value = TReduce::Init();
+  if (col < n) {
+    for (int row = row_begin + threadIdx.y; row < row_end; row += blockDim.y) {
+      value = TReduce()(value, TOp()(input[static_cast<int64_t>(row) * n + col]));
+    }
+  }
+  shared_memory[tid_in_block] = value;
+  __syncthreads();
+
+  for (int stride = blockDim.y / 2; stride > 0; stride /= 2) {
+    if (threadIdx.y < stride) {
+      shared_memory[tid_in_block] = TReduce()(shared_memory[tid_in_block], shared_memory[tid_in_block + stride * blockDim.x]);
+    }
+    __syncthreads();
+  }
+
+  if (threadIdx.y == 0 && col < n) {
+    partial[static_cast<int64_t>(blockIdx.y) * n + col] = shared_memory[threadIdx.x];
+  }
+}
+
+template <typename TBuf, typename TOut, typename TReduce, typename TFinalOp, bool DivideResultBySize>
+__global__ void reduce_matrix_rows_final_kernel(const TBuf* partial, TOut* output, int num_chunks, int m, int n) {
+  for (int col = blockIdx.x * blockDim.x + threadIdx.x; col < n; col += blockDim.x * gridDim.x) {
+    TBuf value = TReduce::Init();
+    for (int chunk = 0; chunk < num_chunks; ++chunk) {
+      value = TReduce()(value, partial[static_cast<int64_t>(chunk) * n + col]);
+    }
+    if (DivideResultBySize) {
+      output[col] = TOut(TFinalOp()(value / TBuf(m)));
+    } else {
+      output[col] = TOut(TFinalOp()(value));
+    }
+  }
+}
+
+namespace {
+constexpr int kRowsReductionBlockX = GPU_WARP_SIZE;
+constexpr int kRowsReductionBlockY = NUM_WARPS_PER_BLOCK;
+constexpr int kRowsReductionMaxBlocks = 512;
+
+// chunks of rows so that the partial kernel runs about kRowsReductionMaxBlocks blocks
+int compute_num_row_chunks(int m, int n) {
+  const int num_column_blocks = static_cast<int>(CeilDiv(n, kRowsReductionBlockX));
+  const int max_num_chunks = std::max(1, kRowsReductionMaxBlocks / num_column_blocks);
+  // at least NUM_ELEMENTS_PER_THREAD rows per thread of a chunk
+  return std::max(1, std::min(max_num_chunks, m / (kRowsReductionBlockY * NUM_ELEMENTS_PER_THREAD)));
+}
+}  // namespace
+
+template <typename TOut>
+size_t compute_matrix_rows_reduction_buffer_size(int m, int n) {
+  typedef typename ToBuffer<TOut>::Type TBuf;
+  return static_cast<size_t>(compute_num_row_chunks(m, n)) * n * sizeof(TBuf);
+}
+
+template size_t compute_matrix_rows_reduction_buffer_size<half>(int m, int n);
+template size_t compute_matrix_rows_reduction_buffer_size<float>(int m, int n);
+template size_t compute_matrix_rows_reduction_buffer_size<double>(int m, int n);
+
+template <typename TIn, typename TOut, typename TBuf, typename TOp, typename TReduce, typename TFinalOp,
+          bool DivideResultBySize>
+void call_reduce_matrix_rows(const TIn* input, TOut* output, int m, int n, void* buffer) {
+  constexpr int max_num_blocks_in_grid = 65535;
+  const int num_chunks = compute_num_row_chunks(m, n);
+  TBuf* partial = reinterpret_cast<TBuf*>(buffer);
+
+  const dim3 block(kRowsReductionBlockX, kRowsReductionBlockY, 1);
+  const dim3 grid(static_cast<int>(CeilDiv(n, kRowsReductionBlockX)), num_chunks, 1);
+  reduce_matrix_rows_partial_kernel<TIn, TBuf, TOp, TReduce><<<grid, block, block.x * block.y * sizeof(TBuf)>>>(
+      input, partial, m, n, static_cast<int>(CeilDiv(m, num_chunks)));
+
+  const int final_grid = std::min(max_num_blocks_in_grid, static_cast<int>(CeilDiv(n, GridDim::maxThreadsPerBlock)));
+  reduce_matrix_rows_final_kernel<TBuf, TOut, TReduce, TFinalOp, DivideResultBySize>
+      <<<final_grid, GridDim::maxThreadsPerBlock, 0>>>(partial, output, num_chunks, m, n);
+}
+
+template <typename TIn, typename TOut>
+void reduce_matrix_rows(cudnnReduceTensorOp_t cudnn_reduce_op, const TIn* input, TOut* output, int m, int n,
+                        void* buffer) {
+  typedef typename ToBuffer<TOut>::Type TBuf;
+  switch (cudnn_reduce_op) {
+    case CUDNN_REDUCE_TENSOR_ADD:
+      call_reduce_matrix_rows<TIn, TOut, TBuf, Cast<TBuf, TIn>, Add<TBuf>, Identity<TBuf>, false>(input, output, m, n, buffer);
+      break;
+    case CUDNN_REDUCE_TENSOR_AVG:
+      call_reduce_matrix_rows<TIn, TOut, TBuf, Cast<TBuf, TIn>, Add<TBuf>, Identity<TBuf>, true>(input, output, m, n, buffer);
+      break;
+    case CUDNN_REDUCE_TENSOR_MUL:
+      call_reduce_matrix_rows<TIn, TOut, TBuf, Cast<TBuf, TIn>, Mul<TBuf>, Identity<TBuf>, false>(input, output, m, n, buffer);
+      break;
+    case CUDNN_REDUCE_TENSOR_MAX:
+      call_reduce_matrix_rows<TIn, TOut, TBuf, Cast<TBuf, TIn>, Max<TBuf>, Identity<TBuf>, false>(input, output, m, n, buffer);
+      break;
+    case CUDNN_REDUCE_TENSOR_MIN:
+      call_reduce_matrix_rows<TIn, TOut, TBuf, Cast<TBuf, TIn>, Min<TBuf>, Identity<TBuf>, false>(input, output, m, n, buffer);
+      break;
+    case CUDNN_REDUCE_TENSOR_NORM1:
+      call_reduce_matrix_rows<TIn, TOut, TBuf, Abs<TBuf, TIn>, Add<TBuf>, Identity<TBuf>, false>(input, output, m, n, buffer);
+      break;
+    case CUDNN_REDUCE_TENSOR_NORM2:
+      call_reduce_matrix_rows<TIn, TOut, TBuf, Square<TBuf, TIn>, Add<TBuf>, Sqrt<TBuf>, false>(input, output, m, n, buffer);
+      break;
+    default:
+      // rejected by get_applicable_matrix_reduction
+      break;
+  }
+}
+
+template void reduce_matrix_rows<half, half>(
+  cudnnReduceTensorOp_t cudnn_reduce_op, const half* input, half* output, int m, int n, void* buffer);
+template void reduce_matrix_rows<float, float>(
+  cudnnReduceTensorOp_t cudnn_reduce_op, const float* input, float* output, int m, int n, void* buffer);
+template void reduce_matrix_rows<double, double>(
+  cudnnReduceTensorOp_t cudnn_reduce_op, const double* input, double* output, int m, int n, void* buffer);
+
+// Running mean and sum of the squared differences from the mean of count values (Welford). Two states are merged
+// with the parallel formula of Chan et al.
+template <typename T>
+struct WelfordState {
+  T count;
+  T mean;
+  T m2;
+};
+
+template <typename T>
+__device__ __forceinline__ WelfordState<T> welford_merge(const WelfordState<T>& a, const WelfordState<T>& b) {
+  const T count = a.count + b.count;
+  if (count == T(0)) {
+    return a;
+  }
+  const T delta = b.mean - a.mean;
+  const T b_ratio = b.count / count;
+  return WelfordState<T>{count, a.mean + delta * b_ratio, a.m2 + b.m2 + delta * delta * a.count * b_ratio};
+}
+
+template <typename T>
+__device__ __forceinline__ WelfordState<T> welford_warp_reduce(WelfordState<T> state) {
+#pragma unroll
+  for (int stride = GPU_WARP_SIZE / 2; stride > 0; stride /= 2) {
+    WelfordState<T> other{WARP_SHFL_DOWN(state.count, stride), WARP_SHFL_DOWN(state.mean, stride),
+                          WARP_SHFL_DOWN(state.m2, stride)};
+    state = welford_merge(state, other);
+  }
+  return state;
+}
+
+// Same layout of the threads as reduce_matrix_columns_kernel, computing the mean and the variance of each row in
+// a single pass.
+template <typename TIn, typename TOut, typename TBuf>
+__global__ void reduce_matrix_columns_mean_variance_kernel(const TIn* input, TOut* mean, TOut* variance, int m, int n) {
+  extern __shared__ unsigned char shared_memory_[];
+  WelfordState<TBuf>* shared_memory = reinterpret_cast<WelfordState<TBuf>*>(shared_memory_);
+  const int num_warps_in_row = blockDim.x / GPU_WARP_SIZE;
+  const int wid_in_row = threadIdx.x / GPU_WARP_SIZE;
+  const int lid_in_warp = threadIdx.x % GPU_WARP_SIZE;
+
+  for (int row = blockIdx.x * blockDim.y + threadIdx.y; row < m; row += gridDim.x * blockDim.y) {
+    const TIn* row_data = input + static_cast<int64_t>(row) * n;
+    WelfordState<TBuf> state{TBuf(0), TBuf(0), TBuf(0)};
+    for (int col = threadIdx.x; col < n; col += blockDim.x) {
+      const TBuf value = TBuf(row_data[col]);
+      state.count += TBuf(1);
+      const TBuf delta = value - state.mean;
+      state.mean += delta / state.count;
+      state.m2 += delta * (value - state.mean);
+    }
+    state = welford_warp_reduce(state);
+
+    if (num_warps_in_row > 1) {
+      if (lid_in_warp == 0) {
+        shared_memory[wid_in_row] = state;
+      }
+      __syncthreads();
+      if (wid_in_row == 0) {
+        state = lid_in_warp < num_warps_in_row ? shared_memory[lid_in_warp] : WelfordState<TBuf>{TBuf(0), TBuf(0), TBuf(0)};
+        state = welford_warp_reduce(state);
+      }
+      __syncthreads();
+    }
+
+    if (threadIdx.x == 0) {
+      mean[row] = TOut(state.mean);
+      variance[row] = TOut(state.m2 / TBuf(n));
+    }
+  }
+}
+
+template <typename TIn, typename TOut>
+void reduce_matrix_columns_mean_variance(const TIn* input, TOut* mean, TOut* variance, int m, int n) {
+  typedef typename ToBuffer<TOut>::Type TBuf;
+  constexpr int max_num_threads_in_row = 256;
+  constexpr int num_rows_per_warp_block = 8;
+  constexpr int max_num_blocks_in_grid = 65535;
+
+  const int num_threads_in_row = std::min(
+      max_num_threads_in_row,
+      std::max(GPU_WARP_SIZE, least_pow2_bound(std::max(1, n / NUM_ELEMENTS_PER_THREAD))));
+  const dim3 block(num_threads_in_row, num_threads_in_row == GPU_WARP_SIZE ? num_rows_per_warp_block : 1, 1);
+  const dim3 grid(std::min(max_num_blocks_in_grid, static_cast<int>(CeilDiv(m, block.y))), 1, 1);
+  const int shared_mem_size = sizeof(WelfordState<TBuf>) * num_threads_in_row / GPU_WARP_SIZE;
+
+  reduce_matrix_columns_mean_variance_kernel<TIn, TOut, TBuf><<<grid, block, shared_mem_size>>>(
+      input, mean, variance, m, n);
+}
+
+template void reduce_matrix_columns_mean_variance<half, half>(
+  const half* input, half* mean, half* variance, int m, int n);
+template void reduce_matrix_columns_mean_variance<float, float>(
+  const float* input, float* mean, float* variance, int m, int n);
+template void reduce_matrix_columns_mean_variance<double, double>(
+  const double* input, double* mean, double* variance, int m, int n);
+
 }  // namespace cuda
 }  // namespace onnxruntime
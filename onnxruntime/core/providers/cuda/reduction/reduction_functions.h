@@ -32,5 +32,43 @@ bool is_matrix_row_reduction(
 template <typename TIn, typename TOut>
 void reduce_matrix_rows(const TIn* data, TOut* output, int m, int n);
 
+// How a reduction of a row-major tensor can be computed on a m-by-n matrix view of it by the kernels below
+// instead of cudnnReduceTensor.
+enum class ApplicableMatrixReduction {
+  // The leading axes are reduced: the m rows are reduced to n values by reduce_matrix_rows.
+  Rows,
+  // The trailing axes are reduced: each of the m rows is reduced to a value by reduce_matrix_columns.
+  Columns,
+  // Neither, or the reduction isn't one of ADD, AVG, MUL, MAX, MIN, NORM1 and NORM2.
+  None,
+};
+
+// Determine which of the matrix reductions below computes the reduction of the 'axes' of a tensor of shape 'dims',
+// and the shape of the matrix. Reducing all or none of the elements is left to the callers.
+ApplicableMatrixReduction get_applicable_matrix_reduction(
+    const cudnnReduceTensorOp_t cudnn_reduce_op,
+    const std::vector<int64_t>& dims,
+    const std::vector<int64_t>& axes,
+    int& m,
+    int& n);
+
+// Reduce each of the m rows of n elements to output[row], with warp shuffles for the short rows.
+template <typename TIn, typename TOut>
+void reduce_matrix_columns(cudnnReduceTensorOp_t cudnn_reduce_op, const TIn* input, TOut* output, int m, int n);
+
+// Size in bytes of the buffer of reduce_matrix_rows below.
+template <typename TOut>
+size_t compute_matrix_rows_reduction_buffer_size(int m, int n);
+
+// Reduce the m rows of n elements to the n values of output. Unlike the ADD-only overload above, the blocks
+// write partial results to 'buffer' instead of adding atomically, so the result is deterministic.
+template <typename TIn, typename TOut>
+void reduce_matrix_rows(cudnnReduceTensorOp_t cudnn_reduce_op, const TIn* input, TOut* output, int m, int n,
+                        void* buffer);
+
+// Compute the mean and the (biased) variance of each of the m rows of n elements in a single pass.
+template <typename TIn, typename TOut>
+void reduce_matrix_columns_mean_variance(const TIn* input, TOut* mean, TOut* variance, int m, int n);
+
 }  // namespace cuda
 }  // namespace onnxruntime
\ No newline at end of file
@@ -160,7 +160,7 @@ Status ReduceKernel<allow_multi_axes>::ReduceKernelShared(
   ORT_RETURN_IF_ERROR(output_tensor.Set(output_dims_cudnn, cudnn_type_X));
   size_t workspace_bytes = 0;
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionWorkspaceSize(CudnnHandle(), reduce_desc, input_tensor, output_tensor, &workspace_bytes));
-  auto workspace_cuda = GetScratchBuffer<CudaT>(workspace_bytes);
+  auto workspace_cuda = GetWorkspace(workspace_bytes);
 
   size_t indices_bytes = 0;
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionIndicesSize(CudnnHandle(), reduce_desc, input_tensor, output_tensor, &indices_bytes));
@@ -426,6 +426,36 @@ static Status ReduceComputeCore(CUDAExecutionProvider& cuda_ep, const Tensor& in
     }
   }
 
+  // Reductions of the leading or of the trailing axes run on the kernels of reduction_functions.cu, which need
+  // neither the workspace nor the transposes of cudnnReduceTensor. cuDNN remains for the other axes, ArgMax/ArgMin,
+  // ReduceSumSquare and ReduceLogSumExp.
+  if (ReduceTensorIndices == CUDNN_REDUCE_TENSOR_NO_INDICES && !calculate_sqt && !log_sum_exp) {
+    int m = 0;
+    int n = 0;
+    const auto matrix_reduction = get_applicable_matrix_reduction(cudnn_reduce_op, input_shape.GetDims(), axes, m, n);
+    if (matrix_reduction == ApplicableMatrixReduction::Columns) {
+      reduce_matrix_columns(cudnn_reduce_op,
+                            reinterpret_cast<const CudaT*>(input.template Data<T>()),
+                            reinterpret_cast<CudaT*>(output.template MutableData<T>()),
+                            m, n);
+    } else if (matrix_reduction == ApplicableMatrixReduction::Rows) {
+      auto buffer = cuda_ep.GetScratchBuffer<void>(compute_matrix_rows_reduction_buffer_size<CudaT>(m, n));
+      reduce_matrix_rows(cudnn_reduce_op,
+                         reinterpret_cast<const CudaT*>(input.template Data<T>()),
+                         reinterpret_cast<CudaT*>(output.template MutableData<T>()),
+                         m, n, buffer.get());
+    }
+
+    if (matrix_reduction != ApplicableMatrixReduction::None) {
+      if (calculate_log) {
+        Impl_Log<CudaT>(reinterpret_cast<CudaT*>(output.template MutableData<T>()),
+                        reinterpret_cast<CudaT*>(output.template MutableData<T>()),
+                        output_count);
+      }
+      return Status::OK();
+    }
+  }
+
   if (ReduceTensorIndices == CUDNN_REDUCE_TENSOR_FLATTENED_INDICES && std::is_same<T, MLFloat16>::value) {
     // ArgMax/ArgMin with FP16 are not supported by cudnn, so convert input to fp32 then call cudnn
     temp_X = cuda_ep.GetScratchBuffer<float>(input_count);
@@ -447,7 +477,7 @@ static Status ReduceComputeCore(CUDAExecutionProvider& cuda_ep, const Tensor& in
   size_t workspace_bytes = 0;
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionWorkspaceSize(cuda_ep.PerThreadCudnnHandle(), reduce_desc,
                                                        input_tensor, output_tensor, &workspace_bytes));
-  auto workspace_cuda = cuda_ep.GetScratchBuffer<CudaT>(workspace_bytes);
+  auto workspace_cuda = cuda_ep.GetWorkspace(workspace_bytes);
 
   size_t indices_bytes = 0;
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionIndicesSize(cuda_ep.PerThreadCudnnHandle(), reduce_desc,
@@ -670,7 +700,7 @@ Status ReduceKernel<true>::ComputeImpl<int32_t, CUDNN_REDUCE_TENSOR_NO_INDICES>(
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionIndicesSize(CudnnHandle(), reduce_desc, input_tensor, output_tensor, &indices_bytes));
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionWorkspaceSize(CudnnHandle(), reduce_desc, input_tensor, output_tensor, &workspace_bytes));
   IAllocatorUniquePtr<uint32_t> indices_cuda = GetScratchBuffer<uint32_t>(indices_bytes);
-  IAllocatorUniquePtr<CudaT> workspace_cuda = GetScratchBuffer<CudaT>(workspace_bytes);
+  IAllocatorUniquePtr<void> workspace_cuda = GetWorkspace(workspace_bytes);
 
   const auto one = Consts<float>::One;
   const auto zero = Consts<float>::Zero;
@@ -749,7 +779,7 @@ Status ReduceKernel<true>::ComputeImpl<int8_t, CUDNN_REDUCE_TENSOR_NO_INDICES>(O
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionIndicesSize(CudnnHandle(), reduce_desc, input_tensor, output_tensor, &indices_bytes));
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionWorkspaceSize(CudnnHandle(), reduce_desc, input_tensor, output_tensor, &workspace_bytes));
   IAllocatorUniquePtr<uint32_t> indices_cuda = GetScratchBuffer<uint32_t>(indices_bytes);
-  IAllocatorUniquePtr<CudaT> workspace_cuda = GetScratchBuffer<CudaT>(workspace_bytes);
+  IAllocatorUniquePtr<void> workspace_cuda = GetWorkspace(workspace_bytes);
 
   const auto one = Consts<float>::One;
   const auto zero = Consts<float>::Zero;
@@ -828,7 +858,7 @@ Status ReduceKernel<true>::ComputeImpl<uint8_t, CUDNN_REDUCE_TENSOR_NO_INDICES>(
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionIndicesSize(CudnnHandle(), reduce_desc, input_tensor, output_tensor, &indices_bytes));
   CUDNN_RETURN_IF_ERROR(cudnnGetReductionWorkspaceSize(CudnnHandle(), reduce_desc, input_tensor, output_tensor, &workspace_bytes));
   IAllocatorUniquePtr<uint32_t> indices_cuda = GetScratchBuffer<uint32_t>(indices_bytes);
-  IAllocatorUniquePtr<CudaT> workspace_cuda = GetScratchBuffer<CudaT>(workspace_bytes);
+  IAllocatorUniquePtr<void> workspace_cuda = GetWorkspace(workspace_bytes);
 
   const auto one = Consts<float>::One;
   const auto zero = Consts<float>::Zero;
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <limits>
 #include "core/providers/cuda/cu_inc/common.cuh"
 
 namespace onnxruntime {
@@ -54,6 +55,32 @@ struct Identity {
   }
 };
 
+// Binary operations combining the values of a reduction, with the value a reduction starts from.
+template <typename T>
+struct Add {
+  __forceinline__ __device__ static T Init() { return T(0); }
+  __forceinline__ __device__ T operator()(const T& a, const T& b) { return a + b; }
+};
+
+template <typename T>
+struct Mul {
+  __forceinline__ __device__ static T Init() { return T(1); }
+  __forceinline__ __device__ T operator()(const T& a, const T& b) { return a * b; }
+};
+
+// Max and Min propagate NaN like cuDNN reductions with CUDNN_PROPAGATE_NAN
+template <typename T>
+struct Max {
+  __forceinline__ __device__ static T Init() { return -std::numeric_limits<T>::infinity(); }
+  __forceinline__ __device__ T operator()(const T& a, const T& b) { return (b > a || b != b) ? b : a; }
+};
+
+template <typename T>
+struct Min {
+  __forceinline__ __device__ static T Init() { return std::numeric_limits<T>::infinity(); }
+  __forceinline__ __device__ T operator()(const T& a, const T& b) { return (b < a || b != b) ? b : a; }
+};
+
 template <typename T>
 struct ToBuffer {
   typedef T Type;
@@ -77,36 +77,31 @@ Status Transpose::DoTranspose(const cudaDeviceProp& prop,
   if (output.Shape().Size() == 0)
     return Status::OK();
 
-  auto element_type = input.GetElementType();
-  if (element_type == utils::GetONNXTensorElementDataType<float>() ||
-      element_type == utils::GetONNXTensorElementDataType<double>() ||
-      element_type == utils::GetONNXTensorElementDataType<MLFloat16>()) {
-    auto mn = TryTransposeWithCublas(permutations, input_shape_override ? *input_shape_override : input.Shape());
-    int M = std::get<0>(mn);
-    int N = std::get<1>(mn);
-    if (M != 0 && N != 0) {
-      if (element_type == utils::GetONNXTensorElementDataType<float>()) {
-        return TransposeWithCublas<float>(cublas_handle, input, output, M, N);
-      } else if (element_type == utils::GetONNXTensorElementDataType<double>()) {
-        return TransposeWithCublas<double>(cublas_handle, input, output, M, N);
-      } else {
-        return TransposeWithCublas<MLFloat16>(cublas_handle, input, output, M, N);
-      }
-    }
-  }
-
   const std::vector<int64_t>& input_dims = input_shape_override ? input_shape_override->GetDims() : input.Shape().GetDims();
-  const std::vector<int64_t>& output_dims = output.Shape().GetDims();
   auto rank = static_cast<int32_t>(input_dims.size());
 
+  // drop the dimensions of size 1, whose moves don't change the order of the elements
+  std::vector<size_t> new_permutations;
+  std::vector<int64_t> new_input_dims;
+  std::vector<int64_t> new_output_dims;
+  std::vector<size_t> squeezed_axes(rank);
+  for (auto i = 0; i < rank; i++) {
+    if (input_dims[i] != 1) {
+      squeezed_axes[i] = new_input_dims.size();
+      new_input_dims.push_back(input_dims[i]);
+    }
+  }
+  for (auto i = 0; i < rank; i++) {
+    if (input_dims[permutations[i]] != 1) {
+      new_permutations.push_back(squeezed_axes[permutations[i]]);
+      new_output_dims.push_back(input_dims[permutations[i]]);
+    }
+  }
+
   // flatten the adjacent dimensions which are contiguous
   // for example: permutations[0, 2, 3, 1] -> [0, 2, 1], permutations[0, 3, 1, 2] -> [0, 2, 1]
-  auto new_rank = rank;
-  std::vector<size_t> new_permutations(permutations);
-  std::vector<int64_t> new_input_dims(input_dims);
-  std::vector<int64_t> new_output_dims(output_dims);
-
-  for (auto i = rank - 1; i > 0; i--) {
+  auto new_rank = static_cast<int32_t>(new_input_dims.size());
+  for (auto i = new_rank - 1; i > 0; i--) {
     auto curr = new_permutations[i];
     auto prev = new_permutations[i - 1];
     if (prev + 1 == curr) {
@@ -143,6 +138,32 @@ Status Transpose::DoTranspose(const cudaDeviceProp& prop,
   new_input_dims.resize(new_rank);
   new_output_dims.resize(new_rank);
 
+  size_t element_size = input.DataType()->Size();
+  if (new_rank <= 1) {
+    // the order of the elements is unchanged
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output.MutableDataRaw(), input.DataRaw(),
+                                         output.Shape().Size() * element_size, cudaMemcpyDeviceToDevice));
+    return Status::OK();
+  }
+
+  auto element_type = input.GetElementType();
+  if (element_type == utils::GetONNXTensorElementDataType<float>() ||
+      element_type == utils::GetONNXTensorElementDataType<double>() ||
+      element_type == utils::GetONNXTensorElementDataType<MLFloat16>()) {
+    auto mn = TryTransposeWithCublas(permutations, input_shape_override ? *input_shape_override : input.Shape());
+    int M = std::get<0>(mn);
+    int N = std::get<1>(mn);
+    if (M != 0 && N != 0) {
+      if (element_type == utils::GetONNXTensorElementDataType<float>()) {
+        return TransposeWithCublas<float>(cublas_handle, input, output, M, N);
+      } else if (element_type == utils::GetONNXTensorElementDataType<double>()) {
+        return TransposeWithCublas<double>(cublas_handle, input, output, M, N);
+      } else {
+        return TransposeWithCublas<MLFloat16>(cublas_handle, input, output, M, N);
+      }
+    }
+  }
+
   TensorPitches new_input_strides(new_input_dims);
   TensorPitches new_output_strides(new_output_dims);
 
@@ -150,17 +171,31 @@ Status Transpose::DoTranspose(const cudaDeviceProp& prop,
   TArray<int64_t> input_shape(new_input_dims);
   TArray<int64_t> tmp_input_strides(new_input_strides);
 
-  size_t element_size = input.DataType()->Size();
   if (CanDoTranspose3D(new_rank, new_input_dims, new_permutations)) {
-    return Transpose3DImpl(element_size, input_shape, tmp_input_strides,
-                           input.DataRaw(), output.MutableDataRaw(), output.Shape().Size());
-  }  else if (CanDoTranspose4D(prop, element_size, new_rank, new_input_dims, new_permutations)) {
+    // a 2D transpose is a batch of one matrix
+    TArray<int64_t> matrices_shape(3);
+    matrices_shape[0] = new_rank == 3 ? new_input_dims[0] : 1;
+    matrices_shape[1] = new_input_dims[new_rank - 2];
+    matrices_shape[2] = new_input_dims[new_rank - 1];
+    return Transpose3DImpl(element_size, matrices_shape, input.DataRaw(), output.MutableDataRaw());
+  } else if (CanDoTranspose4D(prop, element_size, new_rank, new_input_dims, new_permutations)) {
     TArray<int64_t> tmp_output_strides(new_rank);
     for (auto i = 0; i < new_rank; i++) {
       tmp_output_strides[i] = new_output_strides[new_permutations[i]];
     }
     return Transpose4DImpl(element_size, input_shape, tmp_input_strides, input.DataRaw(),
                            tmp_output_strides, output.MutableDataRaw(), output.Shape().Size());
+  } else if (CanDoTransposeRows(new_rank, new_permutations)) {
+    // the strides of the outer dimensions, in rows of the innermost one
+    const int64_t row_size = new_input_dims[new_rank - 1];
+    TArray<int64_t> input_row_strides(new_rank - 1);
+    TArray<fast_divmod> output_row_strides(new_rank - 1);
+    for (auto i = 0; i < new_rank - 1; i++) {
+      input_row_strides[i] = new_input_strides[new_permutations[i]] / row_size;
+      output_row_strides[i] = fast_divmod(gsl::narrow_cast<int>(new_output_strides[i] / row_size));
+    }
+    return TransposeRowsImpl(element_size, new_rank - 1, input_row_strides, input.DataRaw(),
+                             output_row_strides, output.MutableDataRaw(), output.Shape().Size() / row_size, row_size);
   }
 
   // General cases
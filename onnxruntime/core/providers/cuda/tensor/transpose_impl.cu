@@ -4,76 +4,172 @@
 #include "core/providers/cuda/cu_inc/common.cuh"
 #include "transpose_impl.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace onnxruntime {
 namespace cuda {
 
-constexpr int TILE_DIM = 16;
+constexpr int TILE_DIM = 32;
+constexpr int TILE_BLOCK_ROWS = 8;
 
+// Transposes the [rows, cols] matrices of a [batch, rows, cols] input by tiles of TILE_DIM x TILE_DIM, so both the
+// reads and the writes are coalesced. The tile is padded by a column to avoid shared memory bank conflicts when it
+// is read by column. Each thread copies TILE_DIM / TILE_BLOCK_ROWS elements of the tile.
 template <typename T>
-__global__ void Transpose3DKernel(const TArray<int64_t> input_shape,
-                                  const TArray<int64_t> input_strides,
-                                  const T* input_data, T* output_data) {
-  __shared__ T tile[TILE_DIM * (TILE_DIM+1)];
+__global__ void Transpose3DKernel(int64_t batch, int rows, int cols, const T* input_data, T* output_data) {
+  __shared__ T tile[TILE_DIM][TILE_DIM + 1];
 
-  int x = blockIdx.x * TILE_DIM + threadIdx.x;
-  int y = blockIdx.y * TILE_DIM + threadIdx.y;
+  const int in_col = blockIdx.x * TILE_DIM + threadIdx.x;
+  const int in_row = blockIdx.y * TILE_DIM + threadIdx.y;
+  const int out_col = blockIdx.y * TILE_DIM + threadIdx.x;
+  const int out_row = blockIdx.x * TILE_DIM + threadIdx.y;
+  const int64_t matrix_size = static_cast<int64_t>(rows) * cols;
 
-  tile[threadIdx.y * TILE_DIM + threadIdx.x] = input_data[blockIdx.z * input_strides[0] + y * input_shape[2] + x];
-  __syncthreads();
+  for (int64_t b = blockIdx.z; b < batch; b += gridDim.z) {
+    const T* input = input_data + b * matrix_size;
+    T* output = output_data + b * matrix_size;
 
-  x = blockIdx.y * TILE_DIM + threadIdx.x;
-  y = blockIdx.x * TILE_DIM + threadIdx.y;
+#pragma unroll
+    for (int i = 0; i < TILE_DIM; i += TILE_BLOCK_ROWS) {
+      if (in_col < cols && in_row + i < rows) {
+        tile[threadIdx.y + i][threadIdx.x] = input[static_cast<int64_t>(in_row + i) * cols + in_col];
+      }
+    }
+    __syncthreads();
 
-  output_data[blockIdx.z * input_strides[0] + y * input_shape[1] + x] = tile[threadIdx.x * TILE_DIM + threadIdx.y];
+#pragma unroll
+    for (int i = 0; i < TILE_DIM; i += TILE_BLOCK_ROWS) {
+      if (out_col < rows && out_row + i < cols) {
+        output[static_cast<int64_t>(out_row + i) * rows + out_col] = tile[threadIdx.x][threadIdx.y + i];
+      }
+    }
+    // the tile is overwritten by the next matrix
+    __syncthreads();
+  }
 }
 
 bool CanDoTranspose3D(int32_t rank,
                       const std::vector<int64_t>& input_dims,
                       const std::vector<size_t>& permutations) {
-  if (rank == 3 &&
-      // permutation is done in the last two dimensions.
-      permutations[rank-2] == (rank-1) && permutations[rank-1] == (rank-2) &&
-      // the last two dimensions are aligned with TILE_DIM.
-      input_dims[rank-2] % TILE_DIM == 0 && input_dims[rank-1] % TILE_DIM == 0) {
-    return true;
+  // the last two dimensions are swapped, with the leading one, if any, staying in place.
+  if ((rank == 2 && permutations[0] == 1 && permutations[1] == 0) ||
+      (rank == 3 && permutations[0] == 0 && permutations[1] == 2 && permutations[2] == 1)) {
+    // the tiles of the rows are on the y dimension of the grid, which is limited to 65535
+    return CeilDiv(input_dims[rank - 2], TILE_DIM) <= 65535 &&
+           input_dims[rank - 2] * input_dims[rank - 1] <= std::numeric_limits<int>::max();
   }
   return false;
 }
 
-Status Transpose3DImpl(size_t element_size,
-                       const TArray<int64_t>& input_shape, const TArray<int64_t>& input_strides,
-                       const void* input_data, void* output_data, int64_t N) {
-  dim3 block_size(TILE_DIM, TILE_DIM);
-  dim3 grid_size(input_shape[2]/TILE_DIM, input_shape[1]/TILE_DIM, input_shape[0]);
+template <typename T>
+static void LaunchTranspose3DKernel(const TArray<int64_t>& input_shape, const void* input_data, void* output_data) {
+  const int rows = static_cast<int>(input_shape[1]);
+  const int cols = static_cast<int>(input_shape[2]);
+  dim3 block_size(TILE_DIM, TILE_BLOCK_ROWS);
+  dim3 grid_size(CeilDiv(cols, TILE_DIM), CeilDiv(rows, TILE_DIM),
+                 static_cast<unsigned int>(std::min<int64_t>(input_shape[0], 65535)));
+  Transpose3DKernel<T><<<grid_size, block_size, 0>>>(input_shape[0], rows, cols,
+                                                     reinterpret_cast<const T*>(input_data),
+                                                     reinterpret_cast<T*>(output_data));
+}
 
+Status Transpose3DImpl(size_t element_size, const TArray<int64_t>& input_shape,
+                       const void* input_data, void* output_data) {
   switch (element_size) {
     case sizeof(int8_t):
-      Transpose3DKernel<int8_t><<<grid_size, block_size, 0>>>(
-          input_shape, input_strides,
-          reinterpret_cast<const ToCudaType<int8_t>::MappedType*>(input_data),
-          reinterpret_cast<ToCudaType<int8_t>::MappedType*>(output_data));
+      LaunchTranspose3DKernel<int8_t>(input_shape, input_data, output_data);
       break;
     case sizeof(int16_t):
-      Transpose3DKernel<int16_t><<<grid_size, block_size, 0>>>(
-          input_shape, input_strides,
-          reinterpret_cast<const ToCudaType<int16_t>::MappedType*>(input_data),
-          reinterpret_cast<ToCudaType<int16_t>::MappedType*>(output_data));
+      LaunchTranspose3DKernel<int16_t>(input_shape, input_data, output_data);
       break;
     case sizeof(int32_t):
-      Transpose3DKernel<int32_t><<<grid_size, block_size, 0>>>(
-          input_shape, input_strides,
-          reinterpret_cast<const ToCudaType<int32_t>::MappedType*>(input_data),
-          reinterpret_cast<ToCudaType<int32_t>::MappedType*>(output_data));
+      LaunchTranspose3DKernel<int32_t>(input_shape, input_data, output_data);
       break;
     case sizeof(int64_t):
-      Transpose3DKernel<int64_t><<<grid_size, block_size, 0>>>(
-          input_shape, input_strides,
-          reinterpret_cast<const ToCudaType<int64_t>::MappedType*>(input_data),
-          reinterpret_cast<ToCudaType<int64_t>::MappedType*>(output_data));
+      LaunchTranspose3DKernel<int64_t>(input_shape, input_data, output_data);
       break;
     default:
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Type not supported for transpose on CUDA. Element size was ",
-                              element_size);
+                             element_size);
+  }
+
+  return Status::OK();
+}
+
+// Permutes the rows of row_size vectors of the input, for the permutations keeping the innermost dimension in
+// place, such as [B, S, H, D] -> [B, H, S, D] in attention. The input row is computed once per row, and the rows
+// are copied with coalesced vector accesses.
+template <typename VecT>
+__global__ void TransposeRowsKernel(int32_t shape_rank, const TArray<int64_t> input_row_strides,
+                                    const VecT* input_data, const TArray<fast_divmod> output_row_strides,
+                                    VecT* output_data, CUDA_LONG num_rows, CUDA_LONG row_size) {
+  for (CUDA_LONG row = blockIdx.x * blockDim.y + threadIdx.y; row < num_rows; row += gridDim.x * blockDim.y) {
+    CUDA_LONG input_row = 0;
+    CUDA_LONG output_index = row;
+#pragma unroll
+    for (auto dim = 0; dim < input_row_strides.GetCapacity(); ++dim) {
+      if (dim >= shape_rank) {
+        break;
+      }
+      int out_coord, r;
+      output_row_strides[dim].divmod(output_index, out_coord, r);
+      output_index = r;
+      input_row += static_cast<CUDA_LONG>(input_row_strides[dim]) * out_coord;
+    }
+
+    const VecT* input = input_data + static_cast<int64_t>(input_row) * row_size;
+    VecT* output = output_data + static_cast<int64_t>(row) * row_size;
+    for (CUDA_LONG i = threadIdx.x; i < row_size; i += blockDim.x) {
+      output[i] = input[i];
+    }
+  }
+}
+
+bool CanDoTransposeRows(int32_t rank, const std::vector<size_t>& permutations) {
+  return rank > 1 && permutations[rank - 1] == static_cast<size_t>(rank - 1);
+}
+
+template <typename VecT>
+static void LaunchTransposeRowsKernel(int32_t shape_rank, const TArray<int64_t>& input_row_strides,
+                                      const void* input_data, const TArray<fast_divmod>& fdm_output_row_strides,
+                                      void* output_data, int64_t num_rows, int64_t row_bytes) {
+  const CUDA_LONG row_size = static_cast<CUDA_LONG>(row_bytes / sizeof(VecT));
+  // a row per group of threads no larger than the row, so short rows don't leave threads idle
+  int threads_per_row = 1;
+  while (threads_per_row < row_size && threads_per_row < GridDim::maxThreadsPerBlock) {
+    threads_per_row *= 2;
+  }
+  dim3 block_size(threads_per_row, GridDim::maxThreadsPerBlock / threads_per_row);
+  const int blocks = static_cast<int>(std::min<int64_t>(CeilDiv(num_rows, block_size.y),
+                                                        GridDim::maxGridStrideBlocks));
+  TransposeRowsKernel<VecT><<<blocks, block_size, 0>>>(
+      shape_rank, input_row_strides, reinterpret_cast<const VecT*>(input_data), fdm_output_row_strides,
+      reinterpret_cast<VecT*>(output_data), static_cast<CUDA_LONG>(num_rows), row_size);
+}
+
+Status TransposeRowsImpl(size_t element_size, int32_t shape_rank, const TArray<int64_t>& input_row_strides,
+                         const void* input_data, const TArray<fast_divmod>& fdm_output_row_strides,
+                         void* output_data, int64_t num_rows, int64_t row_size) {
+  // the widest accesses the row size and the alignment of the data allow
+  const int64_t row_bytes = row_size * static_cast<int64_t>(element_size);
+  const uintptr_t alignment = reinterpret_cast<uintptr_t>(input_data) | reinterpret_cast<uintptr_t>(output_data) |
+                              static_cast<uintptr_t>(row_bytes);
+  if (alignment % sizeof(int4) == 0) {
+    LaunchTransposeRowsKernel<int4>(shape_rank, input_row_strides, input_data, fdm_output_row_strides,
+                                    output_data, num_rows, row_bytes);
+  } else if (alignment % sizeof(int2) == 0) {
+    LaunchTransposeRowsKernel<int2>(shape_rank, input_row_strides, input_data, fdm_output_row_strides,
+                                    output_data, num_rows, row_bytes);
+  } else if (alignment % sizeof(int32_t) == 0) {
+    LaunchTransposeRowsKernel<int32_t>(shape_rank, input_row_strides, input_data, fdm_output_row_strides,
+                                       output_data, num_rows, row_bytes);
+  } else if (alignment % sizeof(int16_t) == 0) {
+    LaunchTransposeRowsKernel<int16_t>(shape_rank, input_row_strides, input_data, fdm_output_row_strides,
+                                       output_data, num_rows, row_bytes);
+  } else {
+    LaunchTransposeRowsKernel<int8_t>(shape_rank, input_row_strides, input_data, fdm_output_row_strides,
+                                      output_data, num_rows, row_bytes);
   }
 
   return Status::OK();
@@ -8,9 +8,11 @@
 namespace onnxruntime {
 namespace cuda {
 
+// Whether the transpose swaps the last two dimensions of a 2D or 3D input, done by tiles in shared memory.
 bool CanDoTranspose3D(int32_t rank, const std::vector<int64_t>& input_dims, const std::vector<size_t>& permutations);
-Status Transpose3DImpl(size_t element_size, const TArray<int64_t>& input_shape, const TArray<int64_t>& input_strides, const void* input_data,
-                       void* output_data, int64_t N);
+// Transposes the matrices of a [batch, rows, cols] input_shape.
+Status Transpose3DImpl(size_t element_size, const TArray<int64_t>& input_shape, const void* input_data,
+                       void* output_data);
 bool CanDoTranspose4D(const cudaDeviceProp& prop,
                       size_t element_size,
                       int32_t rank,
@@ -18,6 +20,12 @@ bool CanDoTranspose4D(const cudaDeviceProp& prop,
                       const std::vector<size_t>& permutations);
 Status Transpose4DImpl(size_t element_size, const TArray<int64_t>& input_shape, const TArray<int64_t>& input_strides, const void* input_data,
                        const TArray<int64_t>& output_strides, void* output_data, int64_t N);
+// Whether the transpose keeps the innermost dimension in place, so it moves whole rows of it.
+bool CanDoTransposeRows(int32_t rank, const std::vector<size_t>& permutations);
+// Permutes the num_rows rows of row_size elements. The strides are the ones of the shape_rank outer dimensions.
+Status TransposeRowsImpl(size_t element_size, int32_t shape_rank, const TArray<int64_t>& input_row_strides,
+                         const void* input_data, const TArray<fast_divmod>& fdm_output_row_strides,
+                         void* output_data, int64_t num_rows, int64_t row_size);
 Status TransposeImpl(size_t element_size, int32_t shape_rank, const TArray<int64_t>& input_strides,
                      const void* input_data, const TArray<fast_divmod>& fdm_output_strides, void* output_data, int64_t N);
 }  // namespace cuda
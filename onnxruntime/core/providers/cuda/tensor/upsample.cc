@@ -49,6 +49,9 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
   if (roi.size() != 2 * X->Shape().GetDims().size())
     return Status(ONNXRUNTIME, INVALID_ARGUMENT,
                   "Resize: size of roi array should be 2 * N where N is the rank of input tensor X.");
+  if ((UpsampleMode::LINEAR == mode_ || UpsampleMode::CUBIC == mode_) && rank == 4 && scales[1] != 1)
+    return Status(ONNXRUNTIME, NOT_IMPLEMENTED,
+                  "'Linear' mode and 'Cubic' mode with the channels last are not supported by the CUDA provider.");
 
   Tensor* Y = context->Output(0, output_dims);
 
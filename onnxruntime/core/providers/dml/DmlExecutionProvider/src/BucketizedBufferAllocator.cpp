@@ -55,20 +55,38 @@ namespace Dml
     {
         assert(size != 0);
 
-        // Each bucket is twice as large as the previous one, in ascending order
-        gsl::index index = static_cast<gsl::index>(ceil(log2(size)));
-        assert((1ull << index) >= size); // This must be true unless there were some strange rounding issues
-
         // The smallest bucket is 2^n bytes large, where n = c_minResourceSizeExponent
-        index = std::max<gsl::index>(index, c_minResourceSizeExponent);
-        index -= c_minResourceSizeExponent;
+        if (size <= (1ull << c_minResourceSizeExponent))
+        {
+            return 0;
+        }
+
+        // Find the exponent such that 2^exponent < size <= 2^(exponent + 1). The buckets between these two powers
+        // of two are spaced evenly, so the size is rounded up to the next multiple of the spacing.
+        uint32_t exponent = c_minResourceSizeExponent;
+        while ((size - 1) >> (exponent + 1))
+        {
+            ++exponent;
+        }
+
+        const uint32_t spacingExponent = exponent - c_subBucketCountExponent;
+        const uint64_t subBucket = ((size - (1ull << exponent)) + (1ull << spacingExponent) - 1) >> spacingExponent;
+        assert(subBucket >= 1 && subBucket <= (1ull << c_subBucketCountExponent));
 
-        return index;
+        return 1 + (static_cast<gsl::index>(exponent - c_minResourceSizeExponent) << c_subBucketCountExponent) +
+               static_cast<gsl::index>(subBucket - 1);
     }
 
     /*static*/ uint64_t BucketizedBufferAllocator::GetBucketSizeFromIndex(gsl::index index)
     {
-        return (1ull << (index + c_minResourceSizeExponent));
+        if (index == 0)
+        {
+            return (1ull << c_minResourceSizeExponent);
+        }
+
+        const uint32_t exponent = c_minResourceSizeExponent + static_cast<uint32_t>((index - 1) >> c_subBucketCountExponent);
+        const uint64_t subBucket = static_cast<uint64_t>((index - 1) & ((1 << c_subBucketCountExponent) - 1)) + 1;
+        return (1ull << exponent) + (subBucket << (exponent - c_subBucketCountExponent));
     }
 
     void* BucketizedBufferAllocator::Alloc(size_t size)
@@ -83,6 +83,8 @@ namespace Dml
     // maintains a set of fixed-size buckets, with each bucket containing one or more D3D12 buffers of that fixed size.
     // All requested allocation sizes are rounded up to the nearest bucket size, which ensures minimal fragmentation
     // while providing an upper bound on the amount of memory "wasted" with each allocation.
+    // Between two powers of two there are 2^c_subBucketCountExponent evenly spaced bucket sizes, so the memory
+    // wasted by rounding up is at most a quarter of the allocation instead of half of it.
     class BucketizedBufferAllocator : public onnxruntime::IAllocator
     {
     public:
@@ -110,10 +112,11 @@ namespace Dml
 
     private:
         static const uint32_t c_minResourceSizeExponent = 16; // 2^16 = 64KB
+        static const uint32_t c_subBucketCountExponent = 2; // 2^2 = 4 buckets per power of two
 
         // The pool consists of a number of buckets, and each bucket contains a number of resources of the same size.
-        // The resources in each bucket are always sized as a power of two, and each bucket contains resources twice
-        // as large as the previous bucket.
+        // The smallest bucket is 2^c_minResourceSizeExponent bytes, and the buckets above it step from one power of
+        // two to the next in 2^c_subBucketCountExponent equal increments.
         struct Resource
         {
             ComPtr<ID3D12Resource> resource;
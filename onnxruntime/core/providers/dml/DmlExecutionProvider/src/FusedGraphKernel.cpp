@@ -314,16 +314,16 @@ namespace Dml
 
             if (graphDesc.reuseCommandList)
             {
-                BuildReusableCommandList();
+                m_reusableCommandLists.push_back(BuildReusableCommandList());
             }
         }
 
         onnxruntime::Status Compute(onnxruntime::OpKernelContext* kernelContext) const override
         {
-            // Only re-use the cached command list if its prior execution is complete on the GPU.
-            // This requirement can be avoided by mantaining ring buffers.
-            if (!m_graphicsCommandList || 
-                (m_fence != nullptr && m_fence->GetCompletedValue() < m_completionValue))
+            // A cached command list is only re-used once its prior execution is complete on the GPU, as its
+            // descriptors are updated in place.
+            ReusableCommandList* reusableCommandList = GetCompletedReusableCommandList();
+            if (!reusableCommandList)
             {
                 // Wrap tensors as required by Dml::IExecutionProvider::ExecuteOperator
                 OpKernelContextWrapper contextWrapper(
@@ -371,7 +371,7 @@ namespace Dml
             }
             else
             {
-                ExecuteReusableCommandList(kernelContext);
+                ExecuteReusableCommandList(kernelContext, *reusableCommandList);
             }
 
             return onnxruntime::Status::OK();
@@ -441,8 +441,59 @@ namespace Dml
             }
 
     private:
-        void BuildReusableCommandList()
+        // Command list recording the execution of the graph along with the descriptor heap it binds, so later
+        // executions only update the descriptors of the bindings that changed instead of recording the graph again.
+        struct ReusableCommandList
         {
+            ComPtr<ID3D12CommandAllocator> allocator;
+            ComPtr<ID3D12GraphicsCommandList> graphicsCommandList;
+            ComPtr<ID3D12DescriptorHeap> heap;
+            ComPtr<IDMLBindingTable> bindingTable;
+
+            // Bindings from previous executions of the command list
+            std::vector<uint64_t> inputBindingAllocIds;
+            std::vector<uint64_t> outputBindingAllocIds;
+            uint64_t tempBindingAllocId = 0;
+
+            // Fence tracking the status of the command list's last execution, and whether its descriptor heap
+            // can safely be updated.
+            ComPtr<ID3D12Fence> fence;
+            uint64_t completionValue = 0;
+        };
+
+        // Number of command lists cycled through when the graph runs again before its previous executions are
+        // complete on the GPU, which is the common case when runs are queued back to back.
+        static constexpr size_t c_maxReusableCommandLists = 3;
+
+        ReusableCommandList* GetCompletedReusableCommandList() const
+        {
+            if (m_reusableCommandLists.empty())
+            {
+                // The graph is too small for re-using command lists to be worthwhile
+                return nullptr;
+            }
+
+            for (auto& commandList : m_reusableCommandLists)
+            {
+                if (commandList->fence == nullptr || commandList->fence->GetCompletedValue() >= commandList->completionValue)
+                {
+                    return commandList.get();
+                }
+            }
+
+            if (m_reusableCommandLists.size() < c_maxReusableCommandLists)
+            {
+                m_reusableCommandLists.push_back(BuildReusableCommandList());
+                return m_reusableCommandLists.back().get();
+            }
+
+            return nullptr;
+        }
+
+        std::unique_ptr<ReusableCommandList> BuildReusableCommandList() const
+        {
+            auto commandList = std::make_unique<ReusableCommandList>();
+
             ComPtr<IDMLDevice> device;
             THROW_IF_FAILED(m_provider->GetDmlDevice(device.GetAddressOf()));
 
@@ -456,51 +507,52 @@ namespace Dml
             ComPtr<ID3D12Device> d3dDevice;
             THROW_IF_FAILED(m_provider->GetD3DDevice(d3dDevice.GetAddressOf()));
 
-            THROW_IF_FAILED(d3dDevice->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&m_heap)));
+            THROW_IF_FAILED(d3dDevice->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&commandList->heap)));
 
             // Create a binding table for execution.
             DML_BINDING_TABLE_DESC bindingTableDesc = {};
             bindingTableDesc.Dispatchable = m_compiledExecutionPlanOperator.Get();
-            bindingTableDesc.CPUDescriptorHandle = m_heap->GetCPUDescriptorHandleForHeapStart();
-            bindingTableDesc.GPUDescriptorHandle = m_heap->GetGPUDescriptorHandleForHeapStart();
+            bindingTableDesc.CPUDescriptorHandle = commandList->heap->GetCPUDescriptorHandleForHeapStart();
+            bindingTableDesc.GPUDescriptorHandle = commandList->heap->GetGPUDescriptorHandleForHeapStart();
             bindingTableDesc.SizeInDescriptors = execBindingProps.RequiredDescriptorCount;
 
-            THROW_IF_FAILED(device->CreateBindingTable(&bindingTableDesc, IID_PPV_ARGS(&m_bindingTable)));
+            THROW_IF_FAILED(device->CreateBindingTable(&bindingTableDesc, IID_PPV_ARGS(&commandList->bindingTable)));
 
-            ComPtr<ID3D12CommandAllocator> allocator;
             THROW_IF_FAILED(d3dDevice->CreateCommandAllocator(
                 m_provider->GetCommandListTypeForQueue(),
-                IID_PPV_ARGS(&allocator)));
+                IID_PPV_ARGS(&commandList->allocator)));
 
-            ComPtr<ID3D12CommandList> commandList;
             THROW_IF_FAILED(d3dDevice->CreateCommandList(
                 0,
                 m_provider->GetCommandListTypeForQueue(),
-                allocator.Get(),
+                commandList->allocator.Get(),
                 nullptr,
-                IID_PPV_ARGS(&commandList)));
-            
-            THROW_IF_FAILED(commandList.As(&m_graphicsCommandList));
+                IID_PPV_ARGS(&commandList->graphicsCommandList)));
 
             if (m_persistentResource)
             {
                 DML_BINDING_DESC persistentResourceBindingDesc =
                     { DML_BINDING_TYPE_BUFFER, m_persistentResourceBinding ? &*m_persistentResourceBinding : nullptr };
-                m_bindingTable->BindPersistentResource(&persistentResourceBindingDesc);
+                commandList->bindingTable->BindPersistentResource(&persistentResourceBindingDesc);
             }
 
-            ID3D12DescriptorHeap* descriptorHeaps[] = { m_heap.Get() };
-            m_graphicsCommandList->SetDescriptorHeaps(ARRAYSIZE(descriptorHeaps), descriptorHeaps);
+            ID3D12DescriptorHeap* descriptorHeaps[] = { commandList->heap.Get() };
+            commandList->graphicsCommandList->SetDescriptorHeaps(ARRAYSIZE(descriptorHeaps), descriptorHeaps);
 
             ComPtr<IDMLCommandRecorder> recorder;
             THROW_IF_FAILED(device->CreateCommandRecorder(IID_PPV_ARGS(recorder.GetAddressOf())));
 
-            recorder->RecordDispatch(commandList.Get(), m_compiledExecutionPlanOperator.Get(), m_bindingTable.Get());
+            recorder->RecordDispatch(
+                commandList->graphicsCommandList.Get(),
+                m_compiledExecutionPlanOperator.Get(),
+                commandList->bindingTable.Get());
+
+            THROW_IF_FAILED(commandList->graphicsCommandList->Close());
 
-            THROW_IF_FAILED(m_graphicsCommandList->Close());
+            return commandList;
         }
 
-        void ExecuteReusableCommandList(onnxruntime::OpKernelContext* kernelContext) const
+        void ExecuteReusableCommandList(onnxruntime::OpKernelContext* kernelContext, ReusableCommandList& commandList) const
         {
             DML_BINDING_PROPERTIES execBindingProps = m_compiledExecutionPlanOperator->GetBindingProperties();
                 
@@ -515,7 +567,7 @@ namespace Dml
 
             // Populate input bindings, excluding those which were specified as owned by DML and provided 
             // at initialization instead.
-            m_inputBindingAllocIds.resize(inputBindings.size());
+            commandList.inputBindingAllocIds.resize(inputBindings.size());
             bool inputBindingsChanged = false;
 
             for (uint32_t i = 0; i < inputBindings.size(); ++i)
@@ -534,25 +586,25 @@ namespace Dml
 
                         uint64_t allocId;
                         UnwrapTensor(tensor, &inputBindings[i].Buffer, &allocId);
-                        inputBindingsChanged = inputBindingsChanged || (!allocId || m_inputBindingAllocIds[i] != allocId);
+                        inputBindingsChanged = inputBindingsChanged || (!allocId || commandList.inputBindingAllocIds[i] != allocId);
                         inputBindings[i].Buffer->Release(); // Avoid holding an additional reference
                         inputBindings[i].SizeInBytes = AlignToPow2<size_t>(tensor->SizeInBytes(), 4);
                         inputBindingDescs[i] = {DML_BINDING_TYPE_BUFFER, &inputBindings[i]};
-                        m_inputBindingAllocIds[i] = allocId;
+                        commandList.inputBindingAllocIds[i] = allocId;
                     }
                 }
             }
                 
             if (inputBindingsChanged)
             {
-                m_bindingTable->BindInputs(gsl::narrow_cast<uint32_t>(inputBindingDescs.size()), inputBindingDescs.data());
+                commandList.bindingTable->BindInputs(gsl::narrow_cast<uint32_t>(inputBindingDescs.size()), inputBindingDescs.data());
             }
 
             // Populate Output bindings
             std::vector<DML_BUFFER_BINDING> outputBindings(kernelContext->OutputCount());
             std::vector<DML_BINDING_DESC> outputBindingDescs(kernelContext->OutputCount());
 
-            m_outputBindingAllocIds.resize(outputBindings.size());
+            commandList.outputBindingAllocIds.resize(outputBindings.size());
             bool outputBindingsChanged = false;
             
             for (uint32_t i = 0; i < outputBindings.size(); ++i)
@@ -571,16 +623,16 @@ namespace Dml
 
                 uint64_t allocId;
                 UnwrapTensor(tensor, &outputBindings[i].Buffer, &allocId);
-                outputBindingsChanged = outputBindingsChanged || (!allocId || m_outputBindingAllocIds[i] != allocId);
+                outputBindingsChanged = outputBindingsChanged || (!allocId || commandList.outputBindingAllocIds[i] != allocId);
                 outputBindings[i].Buffer->Release(); // Avoid holding an additional reference
                 outputBindings[i].SizeInBytes = AlignToPow2<size_t>(tensor->SizeInBytes(), 4);
                 outputBindingDescs[i] = {DML_BINDING_TYPE_BUFFER, &outputBindings[i]};
-                m_outputBindingAllocIds[i] = allocId;
+                commandList.outputBindingAllocIds[i] = allocId;
             }
 
             if (outputBindingsChanged)
             {
-                m_bindingTable->BindOutputs(gsl::narrow_cast<uint32_t>(outputBindingDescs.size()), outputBindingDescs.data());
+                commandList.bindingTable->BindOutputs(gsl::narrow_cast<uint32_t>(outputBindingDescs.size()), outputBindingDescs.data());
             }
 
             if (execBindingProps.TemporaryResourceSize > 0)
@@ -600,26 +652,27 @@ namespace Dml
                 DML_BUFFER_BINDING tempBufferBinding = {tempResource.Get(), 0, execBindingProps.TemporaryResourceSize};
                 DML_BINDING_DESC tempBindingDesc = { DML_BINDING_TYPE_BUFFER, &tempBufferBinding };
 
-                if (!tempAllocId || m_tempBindingAllocId != tempAllocId)
+                if (!tempAllocId || commandList.tempBindingAllocId != tempAllocId)
                 {
-                    m_bindingTable->BindTemporaryResource(&tempBindingDesc);
+                    commandList.bindingTable->BindTemporaryResource(&tempBindingDesc);
                 }
             
-                m_tempBindingAllocId = tempAllocId;
+                commandList.tempBindingAllocId = tempAllocId;
             }
 
             // Execute the command list and if it succeeds, update the fence value at which this command may be
             // re-used.
             ComPtr<ID3D12Fence> fence;
             uint64_t completionValue;
-            THROW_IF_FAILED(m_provider->ExecuteCommandList(m_graphicsCommandList.Get(), fence.GetAddressOf(), &completionValue));
-            m_fence = fence;
-            m_completionValue = completionValue;
+            THROW_IF_FAILED(m_provider->ExecuteCommandList(commandList.graphicsCommandList.Get(), fence.GetAddressOf(), &completionValue));
+            commandList.fence = fence;
+            commandList.completionValue = completionValue;
 
             // Queue references to objects which must be kept alive until resulting GPU work completes
-            m_winmlProvider->QueueReference(m_graphicsCommandList.Get());
-            m_winmlProvider->QueueReference(m_heap.Get());
-            m_winmlProvider->QueueReference(m_bindingTable.Get());
+            m_winmlProvider->QueueReference(commandList.graphicsCommandList.Get());
+            m_winmlProvider->QueueReference(commandList.allocator.Get());
+            m_winmlProvider->QueueReference(commandList.heap.Get());
+            m_winmlProvider->QueueReference(commandList.bindingTable.Get());
             m_winmlProvider->QueueReference(m_persistentResourceAllocatorUnk.Get());
         }
 
@@ -730,23 +783,12 @@ namespace Dml
         ComPtr<Dml::IExecutionProvider> m_provider;
         EdgeShapes m_outputShapes;
 
-        // Re-usable command list, supporting descriptor heap, and DML binding table to update that heap.
-        ComPtr<ID3D12GraphicsCommandList> m_graphicsCommandList;
-        ComPtr<ID3D12DescriptorHeap> m_heap;
-        ComPtr<IDMLBindingTable> m_bindingTable;
+        // Re-usable command lists, empty if the graph is always recorded into the command list of the provider.
+        mutable std::vector<std::unique_ptr<ReusableCommandList>> m_reusableCommandLists;
         std::optional<DML_BUFFER_BINDING> m_persistentResourceBinding;
         ComPtr<ID3D12Resource> m_persistentResource;
         ComPtr<IUnknown> m_persistentResourceAllocatorUnk; // Controls when the persistent resource is returned to the allocator
-        
-        // Bindings from previous executions of a re-used command list
-        mutable std::vector<uint64_t> m_inputBindingAllocIds;
-        mutable std::vector<uint64_t> m_outputBindingAllocIds;
-        mutable uint64_t m_tempBindingAllocId = 0;
-
-        // Fence tracking the status of the command list's last execution, and whether its descriptor heap 
-        // can safely be updated.
-        mutable ComPtr<ID3D12Fence> m_fence;
-        mutable uint64_t m_completionValue = 0;
+
 
         std::vector<uint8_t> m_inputsConstant;
         std::vector<ComPtr<ID3D12Resource>> m_nonOwnedGraphInputsFromInitializers;
@@ -39,36 +39,52 @@ class PrimitiveBase {
   virtual ~PrimitiveBase() = default;
 };
 
+// Primitives are cached per input shape. The number of primitives kept by a thread is bounded, and the least
+// recently used primitive is released first, so inputs with many distinct shapes don't grow the cache unbounded.
 template <typename T>
 class PrimitivePool {
  public:
+  static constexpr size_t kMaxPrimitives = 128;
+
   PrimitivePool() = default;
   ~PrimitivePool() = default;
 
   void SetPrimitive(const std::string& key, std::unique_ptr<PrimitiveBase> primitive) {
-    auto& map = PrimitivePool<T>::GetMap();
-    auto iter = map.find(key);
+    auto& cache = PrimitivePool<T>::GetCache();
+    auto iter = cache.map.find(key);
     // We should not find a primitive already using this key.
-    ORT_ENFORCE(iter == map.end(), "duplicate key: " + key);
-    map.insert(std::make_pair(key, std::move(primitive)));
+    ORT_ENFORCE(iter == cache.map.end(), "duplicate key: " + key);
+    if (cache.map.size() >= kMaxPrimitives) {
+      cache.map.erase(cache.lru.back().first);
+      cache.lru.pop_back();
+    }
+    cache.lru.emplace_front(key, std::move(primitive));
+    cache.map.insert(std::make_pair(key, cache.lru.begin()));
   }
 
   PrimitiveBase* GetPrimitive(const std::string& key) {
-    const auto& map = PrimitivePool<T>::GetMap();
-    auto iter = map.find(key);
-    if (iter != map.end()) {
-      return iter->second.get();
+    auto& cache = PrimitivePool<T>::GetCache();
+    auto iter = cache.map.find(key);
+    if (iter != cache.map.end()) {
+      // move to the front as the most recently used
+      cache.lru.splice(cache.lru.begin(), cache.lru, iter->second);
+      return iter->second->second.get();
     } else {
       return nullptr;
     }
   }
 
  private:
-  // For thread safety, the map needs to be kept in thread local storage.
-  static inline std::unordered_map<std::string, std::unique_ptr<PrimitiveBase>>& GetMap() {
-    using MapType = std::unordered_map<std::string, std::unique_ptr<PrimitiveBase>>;
-    static thread_local DeleteOnUnloadPtr<MapType> map(new MapType());
-    return *map;
+  struct Cache {
+    // most recently used first
+    std::list<std::pair<std::string, std::unique_ptr<PrimitiveBase>>> lru;
+    std::unordered_map<std::string, typename std::list<std::pair<std::string, std::unique_ptr<PrimitiveBase>>>::iterator> map;
+  };
+
+  // For thread safety, the cache needs to be kept in thread local storage.
+  static inline Cache& GetCache() {
+    static thread_local DeleteOnUnloadPtr<Cache> cache(new Cache());
+    return *cache;
   }
 };
 
@@ -35,16 +35,23 @@ class DNNLExecutionProvider : public Provider_IExecutionProvider {
 
   virtual std::shared_ptr<Provider_KernelRegistry> Provider_GetKernelRegistry() const override;
 
-  std::shared_ptr<dnnl::memory> GetWeightsMemoryBuffer(const std::string& weight_key) {
+  // the weights are reordered once per blocked layout picked by the primitives, as primitives created for
+  // different input shapes may not pick the same layout for the weights
+  std::shared_ptr<dnnl::memory> GetWeightsMemoryBuffer(const std::string& weight_key,
+                                                       const dnnl::memory::desc& weights_desc) {
     auto iter = weights_mem_map_.find(weight_key);
-    if (iter != weights_mem_map_.end())
-      return iter->second;
+    if (iter != weights_mem_map_.end()) {
+      for (const auto& filter_dst_mem : iter->second) {
+        if (filter_dst_mem->get_desc() == weights_desc)
+          return filter_dst_mem;
+      }
+    }
     return nullptr;
   }
 
   void SetWeightsMemoryBuffer(const std::string& weight_key,
                               const std::shared_ptr<dnnl::memory>& filter_dst_mem) {
-    weights_mem_map_.insert(std::make_pair(weight_key, filter_dst_mem));
+    weights_mem_map_[weight_key].push_back(filter_dst_mem);
   }
 
   OrtMutex& GetMutex() {
@@ -83,8 +90,8 @@ class DNNLExecutionProvider : public Provider_IExecutionProvider {
 
  private:
   // dnnl weights(filer data) memory blocks from first iteration
-  // saved by weights name
-  std::unordered_map<std::string, std::shared_ptr<dnnl::memory>> weights_mem_map_;
+  // saved by weights name, one per blocked layout
+  std::unordered_map<std::string, std::vector<std::shared_ptr<dnnl::memory>>> weights_mem_map_;
   // Save reordered memory buffers in list so that memory is not freed.
   std::vector<IAllocatorUniquePtr<void>> reordered_buffers_;
 
@@ -208,8 +208,11 @@ class DnnlConvBatchNorm : public DnnlKernel {
             strides_mkl, dilations_mkl, padding_left_mkl,
             padding_right_mkl));
 
+    // the scratchpad is taken from the allocator of the provider instead of being allocated by DNNL on every
+    // execution
+    dnnl::primitive_attr attr;
+    attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
     if (fuse_relu_) {
-      dnnl::primitive_attr attr;
       // attr.set_int_output_round_mode(dnnl::round_mode::round_nearest);
       // Execute RELU as Fuse PostOps
       const float ops_scale = 1.f;
@@ -223,8 +226,15 @@ class DnnlConvBatchNorm : public DnnlKernel {
           dnnl::convolution_forward::primitive_desc(*fwd_desc_, attr, cpu_engine));
     } else {
       conv_fwd_pd_ = onnxruntime::make_unique<dnnl::convolution_forward::primitive_desc>(
-          dnnl::convolution_forward::primitive_desc(*fwd_desc_, cpu_engine));
+          dnnl::convolution_forward::primitive_desc(*fwd_desc_, attr, cpu_engine));
+    }
+
+    auto scratchpad_size = conv_fwd_pd_->scratchpad_desc().get_size();
+    if (scratchpad_size > 0) {
+      scratchpad_buffer_ = Provider_IAllocator::MakeUniquePtr<void>(alloc_, scratchpad_size);
     }
+    scratchpad_mem_ = onnxruntime::make_unique<dnnl::memory>(
+        dnnl::memory(conv_fwd_pd_->scratchpad_desc(), cpu_engine, scratchpad_buffer_.get()));
 
     primitive_src_desc_ = static_cast<dnnl::memory::desc>(
         conv_fwd_pd_.get()->src_desc());
@@ -289,7 +299,8 @@ class DnnlConvBatchNorm : public DnnlKernel {
     net_args.push_back({{DNNL_ARG_SRC, *src_mem_},
                         {DNNL_ARG_WEIGHTS, *filter_mem_},
                         {DNNL_ARG_BIAS, *bias_mem_},
-                        {DNNL_ARG_DST, *primitive_dst_mem_}});
+                        {DNNL_ARG_DST, *primitive_dst_mem_},
+                        {DNNL_ARG_SCRATCHPAD, *scratchpad_mem_}});
 
     if (mklnode_ptr_->output_index >= 0) {
       // one of the end nodes. Allocate output buffer memory and
@@ -391,7 +402,7 @@ class DnnlConvBatchNorm : public DnnlKernel {
     {
       // lock to make sure reordering is done only once
       std::lock_guard<OrtMutex> lock(provider_->GetMutex());
-      std::shared_ptr<dnnl::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+      std::shared_ptr<dnnl::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name, filter_desc_);
 
       if (filter_dst_mem == nullptr) {
         dnnl::memory src = dnnl::memory({{filter_dims_mkl}, DnnnType<T>(), filter_format_}, cpu_engine, (void*)weights_scaled_by_axis.data());
@@ -458,16 +469,17 @@ class DnnlConvBatchNorm : public DnnlKernel {
     const OrtValue* winput_tensor = ort.KernelContext_GetInput(context, input_index + 1);
     const T* filter_data = const_cast<T*>(ort.GetTensorData<T>(winput_tensor));
 
-    std::shared_ptr<dnnl::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
-    if (filter_dst_mem == nullptr) {
+    if (filter_dst_mem_ == nullptr) {
+      // reordered at most once per layout and kept by the primitive for the following runs
       ReorderWeights(api, context, GetEngine());
-      filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+      std::lock_guard<OrtMutex> lock(provider_->GetMutex());
+      filter_dst_mem_ = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name, filter_desc_);
+      bias_dst_mem_ = provider_->GetBiasMemoryBuffer(mklnode_ptr_->weight_name);
     }
-    filter_data = static_cast<T*>(filter_dst_mem->get_data_handle());
+    filter_data = static_cast<T*>(filter_dst_mem_->get_data_handle());
     filter_mem_->set_data_handle(static_cast<void*>(const_cast<T*>(filter_data)));
 
-    std::shared_ptr<dnnl::memory> bias_mem = provider_->GetBiasMemoryBuffer(mklnode_ptr_->weight_name);
-    const T* bias_data = static_cast<T*>(bias_mem->get_data_handle());
+    const T* bias_data = static_cast<T*>(bias_dst_mem_->get_data_handle());
     bias_mem_->set_data_handle(static_cast<void*>(const_cast<T*>(bias_data)));
 
     if (primitive_src_desc_ != source_desc_) {
@@ -479,8 +491,11 @@ class DnnlConvBatchNorm : public DnnlKernel {
         src_mem_from_ = parents_[0].get()->primitive_dst_mem_;
       }
 
-      auto src_size = conv_fwd_pd_.get()->src_desc().get_size();
-      src_reorder_buffer_ = Provider_IAllocator::MakeUniquePtr<void>(alloc_, src_size);
+      // the primitive is cached per input shape, so the buffer is allocated once and reused by every run
+      if (src_reorder_buffer_ == nullptr) {
+        auto src_size = conv_fwd_pd_.get()->src_desc().get_size();
+        src_reorder_buffer_ = Provider_IAllocator::MakeUniquePtr<void>(alloc_, src_size);
+      }
       src_mem_->set_data_handle(src_reorder_buffer_.get());
     } else {
       if (mklnode_ptr_->parent_nodes.empty()) {
@@ -598,6 +613,10 @@ class DnnlConvBatchNorm : public DnnlKernel {
  private:
   IAllocatorUniquePtr<void> src_reorder_buffer_;
   IAllocatorUniquePtr<void> dst_reorder_buffer_;
+  IAllocatorUniquePtr<void> scratchpad_buffer_;
+  std::unique_ptr<dnnl::memory> scratchpad_mem_;
+  std::shared_ptr<dnnl::memory> filter_dst_mem_;
+  std::shared_ptr<dnnl::memory> bias_dst_mem_;
 
  private:
   Status ComputeKernelShape(const TensorShape& weight_shape, std::vector<int64_t>& kernel_shape) const {
@@ -197,8 +197,11 @@ class DnnlPool : public DnnlKernel {
         src_mem_from_ = parents_[0].get()->primitive_dst_mem_;
       }
 
-      auto src_size = fwd_primitive_desc_.get()->src_desc().get_size();
-      src_reorder_buffer_ = Provider_IAllocator::MakeUniquePtr<void>(alloc_, src_size);
+      // the primitive is cached per input shape, so the buffer is allocated once and reused by every run
+      if (src_reorder_buffer_ == nullptr) {
+        auto src_size = fwd_primitive_desc_.get()->src_desc().get_size();
+        src_reorder_buffer_ = Provider_IAllocator::MakeUniquePtr<void>(alloc_, src_size);
+      }
       src_mem_->set_data_handle(src_reorder_buffer_.get());
     } else {
       if (mklnode_ptr_->parent_nodes.empty()) {
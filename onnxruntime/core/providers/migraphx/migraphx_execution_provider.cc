@@ -118,6 +118,12 @@ MIGraphXExecutionProvider::MIGraphXExecutionProvider(const MIGraphXExecutionProv
   if (!fp16_enable_env.empty()) {
     fp16_enable_ = (std::stoi(fp16_enable_env) == 0 ? false : true);
   }
+
+  // number of programs kept per fused node for the input shapes it ran with, 0 disables the cache
+  const std::string prog_cache_size_env = env_instance.GetEnvironmentVar(migraphx_env_vars::kProgramCacheSize);
+  if (!prog_cache_size_env.empty()) {
+    prog_cache_size_ = std::stoul(prog_cache_size_env);
+  }
 }
 
 AllocatorPtr MIGraphXExecutionProvider::GetAllocator(int id, OrtMemType mem_type) const {
@@ -1094,6 +1100,28 @@ bool get_input_output_names(std::string& onnx_buffer,
   return no_input_shape;
 }
 
+// key of the program cache, made of the shapes of all the inputs of the fused node
+static std::string GetInputShapesKey(Ort::CustomOpApi& ort, OrtKernelContext* context)
+{
+  std::string key;
+  std::size_t input_count = ort.KernelContext_GetInputCount(context);
+  for (std::size_t i = 0; i < input_count; ++i)
+  {
+    const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
+    auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+    const auto& tensor_shape = ort.GetTensorShape(tensor_info);
+    ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+    for (auto dim : tensor_shape)
+    {
+      key += std::to_string(dim);
+      key += ',';
+    }
+    key += ';';
+  }
+
+  return key;
+}
+
 Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
                                         std::vector<NodeComputeInfo>& node_compute_funcs) {
   migraphx::onnx_options options;
@@ -1147,7 +1175,7 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>&
       std::unique_ptr<MIGraphXFuncState> p = onnxruntime::make_unique<MIGraphXFuncState>();
       *p = {context->allocate_func, context->release_func, context->allocator_handle, map_progs_[context->node_name], 
             map_onnx_string_[context->node_name], options, t_, map_input_index_[context->node_name], &mgx_mu_, 
-            map_no_input_shape_[context->node_name], fp16_enable_};
+            map_no_input_shape_[context->node_name], fp16_enable_, prog_cache_size_};
       *state = p.release();
       return 0;
     };
@@ -1223,18 +1251,49 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<onnxruntime::Node*>&
         }
       }
 
-      // input shapes are different, needs to re-parse onnx and 
-      // re-compile the program
+      // input shapes are different, take the program compiled for them
+      // earlier, or re-parse onnx and re-compile the program
       if (!input_shape_match)
       {
-        prog = migraphx::parse_onnx_buffer(onnx_string, cmp_options);
-        if (fp16_enable)
+        auto& prog_cache = mgx_state->prog_cache;
+        std::string key = GetInputShapesKey(ort, context);
+        auto cached_prog = prog_cache.find(key);
+        if (cached_prog != prog_cache.end())
         {
-          migraphx::quantize_fp16(prog);
+          prog = cached_prog->second;
         }
+        else
+        {
+          // the options may hold the shapes of another cached program, so
+          // set the shapes of all the inputs
+          for (auto& it : map_input_name_index)
+          {
+            const OrtValue* input_tensor = ort.KernelContext_GetInput(context, it.second);
+            auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+            const auto& tensor_shape = ort.GetTensorShape(tensor_info);
+            ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+            std::vector<std::size_t> ort_lens(tensor_shape.begin(), tensor_shape.end());
+            cmp_options.set_input_parameter_shape(it.first, ort_lens);
+          }
+
+          prog = migraphx::parse_onnx_buffer(onnx_string, cmp_options);
+          if (fp16_enable)
+          {
+            migraphx::quantize_fp16(prog);
+          }
 
-        prog.compile(t);
-        mgx_state->prog = prog;
+          prog.compile(t);
+
+          if (mgx_state->prog_cache_size > 0)
+          {
+            // the shapes seen so far are unlikely to come back when the cache fills up
+            if (prog_cache.size() >= mgx_state->prog_cache_size)
+            {
+              prog_cache.clear();
+            }
+            prog_cache.emplace(key, prog);
+          }
+        }
         param_shapes = prog.get_parameter_shapes();
         no_input_shape = false;
       }
@@ -12,6 +12,7 @@ namespace onnxruntime {
 
 namespace migraphx_env_vars {
 static const std::string kFP16Enable = "ORT_MIGRAPHX_FP16_ENABLE";
+static const std::string kProgramCacheSize = "ORT_MIGRAPHX_PROGRAM_CACHE_SIZE";
 };
 
 // Information needed to construct amdmigraphx execution providers.
@@ -33,6 +34,10 @@ struct MIGraphXFuncState {
   OrtMutex* mgx_mu_ptr = nullptr;
   bool no_input_shape = false;
   bool fp16_enable = false;
+  std::size_t prog_cache_size = 0;
+  // programs compiled for the input shapes the fused node ran with, so that
+  // switching back to a previous set of input shapes doesn't recompile
+  std::unordered_map<std::string, migraphx::program> prog_cache;
 };
 
 // Logical device representation.
@@ -54,6 +59,7 @@ class MIGraphXExecutionProvider : public IExecutionProvider {
 
 private:
   bool fp16_enable_ = false;
+  std::size_t prog_cache_size_ = 8;
   int device_id_;
   migraphx::target t_; 
   OrtMutex mgx_mu_;
@@ -33,24 +33,62 @@ bool ModelBuilder::IsNodeSupported(const Node& node) {
   }
 }
 
+// Operators only copying or reinterpreting the data, which are not worth a NNAPI partition
+bool IsDataMovementOp(const std::string& op) {
+  return op == "Reshape" ||
+         op == "Dropout" ||
+         op == "Identity" ||
+         op == "Squeeze" ||
+         op == "Transpose" ||
+         op == "Cast" ||
+         op == "Concat" ||
+         op == "QuantizeLinear" ||
+         op == "DequantizeLinear";
+}
+
+// Elementwise operators, cheap compared to copying their inputs and outputs between CPU and NNAPI
+bool IsElementwiseOp(const std::string& op) {
+  return op == "Add" ||
+         op == "Sub" ||
+         op == "Mul" ||
+         op == "Div" ||
+         op == "Relu" ||
+         op == "Abs" ||
+         op == "Exp" ||
+         op == "Floor" ||
+         op == "Log" ||
+         op == "Sigmoid" ||
+         op == "Neg" ||
+         op == "Sin" ||
+         op == "Sqrt" ||
+         op == "Tanh";
+}
+
+// Each NNAPI partition costs a transition from and back to the CPU, which a tiny partition doesn't make
+// up for. A partition is worth it if it has an operator doing real work, such as a convolution, or enough
+// elementwise operators; data movement operators alone never are. A partition covering the whole graph
+// adds no transition, so any operator doing work is enough
+constexpr size_t kMinElementwiseOpsInPartition = 2;
+
 bool IsValidSupportedNodesVec(const std::vector<int>& supported_node_vec, const GraphViewer& graph_view) {
-  if (!supported_node_vec.empty()) {
-    if (supported_node_vec.size() == 1) {
-      const auto& node_indices = graph_view.GetNodesInTopologicalOrder();
-      const auto* node(graph_view.GetNode(node_indices[supported_node_vec[0]]));
-      const auto& op = node->OpType();
-      // It is not worth it to perform a single Reshape/Dropout/Identity operator
-      // which is only copying the data in NNAPI
-      // If this is the case, let it fall back
-      if (op == "Reshape" ||
-          op == "Dropout" ||
-          op == "Identity") {
-        return false;
-      }
+  if (supported_node_vec.empty())
+    return false;
+
+  const auto& node_indices = graph_view.GetNodesInTopologicalOrder();
+  const size_t min_elementwise_ops =
+      supported_node_vec.size() == node_indices.size() ? 1 : kMinElementwiseOpsInPartition;
+  size_t num_elementwise_ops = 0;
+  for (const auto idx : supported_node_vec) {
+    const auto* node(graph_view.GetNode(node_indices[idx]));
+    const auto& op = node->OpType();
+    if (IsElementwiseOp(op)) {
+      num_elementwise_ops++;
+    } else if (!IsDataMovementOp(op)) {
+      return true;
     }
-    return true;
   }
-  return false;
+
+  return num_elementwise_ops >= min_elementwise_ops;
 }
 
 std::vector<std::vector<int>> ModelBuilder::GetSupportedNodes() {
@@ -78,10 +116,12 @@ std::vector<std::vector<int>> ModelBuilder::GetSupportedNodes() {
     if (supported) {
       supported_node_vec.push_back(i);
     } else {
-      if (IsValidSupportedNodesVec(supported_node_vec, graph_view_)) {
+      // a partition too small to be worth it falls back to CPU, its nodes must not be merged with the
+      // nodes after this unsupported one
+      if (IsValidSupportedNodesVec(supported_node_vec, graph_view_))
         supported_node_vecs.push_back(supported_node_vec);
-        supported_node_vec.clear();
-      }
+
+      supported_node_vec.clear();
     }
   }
 
@@ -277,6 +317,8 @@ void ModelBuilder::RegisterModelInputs() {
     }
 
     Type type = Type::TENSOR_FLOAT32;
+    float scale = 0.0f;
+    int32_t zero_point = 0;
     const auto* type_proto = node_arg->TypeAsProto();
     if (!type_proto || !type_proto->tensor_type().has_elem_type()) {
       ORT_THROW("The input of graph doesn't have elem_type: " + input_name);
@@ -285,6 +327,12 @@ void ModelBuilder::RegisterModelInputs() {
         case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
           type = Type::TENSOR_FLOAT32;
           break;
+        case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+          // a quantized input takes the scale and zero point of the quantized operator using it
+          type = Type::TENSOR_QUANT8_ASYMM;
+          ORT_ENFORCE(GetQuantizedInputScaleAndZeroPoint(*this, input_name, scale, zero_point),
+                      "The uint8 input of graph isn't used by a quantized operator, name: " + input_name);
+          break;
         default:
           // TODO: support other type
           ORT_THROW("The input of graph doesn't have valid type, name: " +
@@ -293,7 +341,7 @@ void ModelBuilder::RegisterModelInputs() {
       }
     }
 
-    OperandType operand_type(type, shape);
+    OperandType operand_type(type, shape, scale, zero_point);
     shaper_.AddShape(input_name, operand_type.dimensions);
 
     auto index = AddNewOperand(input_name, operand_type, false /* is_nhwc */);
@@ -96,6 +96,8 @@ class ModelBuilder {
 
   const Graph& GetOnnxGraph() const { return graph_view_.GetGraph(); }
 
+  const GraphViewer& GetGraphViewer() const { return graph_view_; }
+
   void RegisterNHWCOperand(const std::string& name);
   bool IsOperandNHWC(const std::string& name);
 
@@ -4,6 +4,8 @@
 #include <core/common/logging/logging.h>
 #include <core/common/safeint.h>
 #include <onnx/onnx_pb.h>
+#include <algorithm>
+#include <numeric>
 
 #include "helper.h"
 #include "model_builder.h"
@@ -30,6 +32,149 @@ const float* GetTensorFloatData(const ONNX_NAMESPACE::TensorProto& tensor) {
              : tensor.float_data().data();
 }
 
+// Get the data of an initializer of float, int32 or uint8 type, in the layout of the data in memory
+void GetInitializerBytes(const ONNX_NAMESPACE::TensorProto& tensor, std::vector<uint8_t>& bytes) {
+  if (!tensor.raw_data().empty()) {
+    bytes.assign(tensor.raw_data().begin(), tensor.raw_data().end());
+    return;
+  }
+
+  switch (tensor.data_type()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT: {
+      const auto* data = reinterpret_cast<const uint8_t*>(tensor.float_data().data());
+      bytes.assign(data, data + tensor.float_data_size() * sizeof(float));
+      break;
+    }
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32: {
+      const auto* data = reinterpret_cast<const uint8_t*>(tensor.int32_data().data());
+      bytes.assign(data, data + tensor.int32_data_size() * sizeof(int32_t));
+      break;
+    }
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+      // uint8 data is stored widened to int32 in int32_data
+      bytes.clear();
+      bytes.reserve(tensor.int32_data_size());
+      for (const auto value : tensor.int32_data())
+        bytes.push_back(static_cast<uint8_t>(value));
+      break;
+    default:
+      ORT_THROW("The initializer doesn't have valid type: " + tensor.name() +
+                " type: " + std::to_string(tensor.data_type()));
+  }
+}
+
+bool IsQuantizedOp(const Node& node) {
+  const auto& op = node.OpType();
+  return op == "QLinearConv" || op == "QLinearMatMul";
+}
+
+// NNAPI only supports quantization per tensor, so the scales and zero points need to be known scalars
+bool HasValidQuantizationScales(ModelBuilder& model_builder, const Node& node,
+                                const std::vector<size_t>& indices) {
+  const auto& initializers(model_builder.GetInitializerTensors());
+  const auto& input_defs(node.InputDefs());
+  for (const auto idx : indices) {
+    if (idx >= input_defs.size() || !input_defs[idx]->Exists()) {
+      LOGS_DEFAULT(VERBOSE) << "The scale of " << node.OpType() << " is missing";
+      return false;
+    }
+
+    const auto& scale_name = input_defs[idx]->Name();
+    if (!Contains(initializers, scale_name)) {
+      LOGS_DEFAULT(VERBOSE) << "The scale of " << node.OpType() << " must be known";
+      return false;
+    }
+
+    const auto& tensor = initializers.at(scale_name);
+    if (tensor.data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+        std::accumulate(tensor.dims().begin(), tensor.dims().end(), int64_t(1), std::multiplies<int64_t>()) != 1) {
+      LOGS_DEFAULT(VERBOSE) << "The scale of " << node.OpType() << " must be a float scalar";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// The zero points of QuantizeLinear and DequantizeLinear are optional, a missing zero point is 0
+bool HasValidQuantizationZeroPoints(ModelBuilder& model_builder, const Node& node,
+                                    const std::vector<size_t>& indices) {
+  const auto& initializers(model_builder.GetInitializerTensors());
+  const auto& input_defs(node.InputDefs());
+  for (const auto idx : indices) {
+    if (idx >= input_defs.size() || !input_defs[idx]->Exists())
+      continue;
+
+    const auto& zero_point_name = input_defs[idx]->Name();
+    if (!Contains(initializers, zero_point_name)) {
+      LOGS_DEFAULT(VERBOSE) << "The zero point of " << node.OpType() << " must be known";
+      return false;
+    }
+
+    const auto& tensor = initializers.at(zero_point_name);
+    if (tensor.data_type() != ONNX_NAMESPACE::TensorProto_DataType_UINT8 ||
+        std::accumulate(tensor.dims().begin(), tensor.dims().end(), int64_t(1), std::multiplies<int64_t>()) != 1) {
+      LOGS_DEFAULT(VERBOSE) << "The zero point of " << node.OpType() << " must be a uint8 scalar";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+float GetQuantizationScale(const ModelBuilder& model_builder, const Node& node, size_t idx) {
+  const auto& tensor = model_builder.GetInitializerTensors().at(node.InputDefs()[idx]->Name());
+  std::vector<uint8_t> bytes;
+  GetInitializerBytes(tensor, bytes);
+  float scale;
+  memcpy(&scale, bytes.data(), sizeof(float));
+  return scale;
+}
+
+int32_t GetQuantizationZeroPoint(const ModelBuilder& model_builder, const Node& node, size_t idx) {
+  const auto& input_defs(node.InputDefs());
+  if (idx >= input_defs.size() || !input_defs[idx]->Exists())
+    return 0;
+
+  const auto& tensor = model_builder.GetInitializerTensors().at(input_defs[idx]->Name());
+  std::vector<uint8_t> bytes;
+  GetInitializerBytes(tensor, bytes);
+  return static_cast<int32_t>(bytes[0]);
+}
+
+// NNAPI can't requantize an operand, so a quantized input must already use the scale and zero point
+// the operator expects for it
+void VerifyQuantizedInput(const ModelBuilder& model_builder, const std::string& input,
+                          float scale, int32_t zero_point) {
+  const auto& operand_type = model_builder.GetOperandTypes().at(input);
+  ORT_ENFORCE(operand_type.type == Type::TENSOR_QUANT8_ASYMM &&
+                  operand_type.operandType.scale == scale &&
+                  operand_type.operandType.zeroPoint == zero_point,
+              "The quantization parameters of input [" + input +
+                  "] don't match the ones of the operand producing it");
+}
+
+bool GetQuantizedInputScaleAndZeroPoint(const ModelBuilder& model_builder, const std::string& input_name,
+                                        float& scale, int32_t& zero_point) {
+  const auto& graph_view(model_builder.GetGraphViewer());
+  for (const auto node_idx : graph_view.GetNodesInTopologicalOrder()) {
+    const auto* node(graph_view.GetNode(node_idx));
+    const auto& op = node->OpType();
+    if (op != "QLinearConv" && op != "QLinearMatMul" && op != "DequantizeLinear")
+      continue;
+
+    // the quantized input of these operators is input 0, with its scale and zero point as inputs 1 and 2
+    if (node->InputDefs()[0]->Name() != input_name)
+      continue;
+
+    scale = GetQuantizationScale(model_builder, *node, 1);
+    zero_point = GetQuantizationZeroPoint(model_builder, *node, 2);
+    return true;
+  }
+
+  return false;
+}
+
 void AddTransposeOperator(ModelBuilder& model_builder,
                           const std::string& input,
                           const std::string& perm_name,
@@ -50,7 +195,11 @@ void AddTransposeOperator(ModelBuilder& model_builder,
 
   input_indices.push_back(perm_idx);  // permutation
   shaper.Transpose(input, perm, output);
-  const OperandType output_operand_type(operand_types.at(input).type, shaper[output]);
+  // a quantized output keeps the scale and zero point of the input
+  const auto& input_operand_type = operand_types.at(input);
+  const OperandType output_operand_type(input_operand_type.type, shaper[output],
+                                        input_operand_type.operandType.scale,
+                                        input_operand_type.operandType.zeroPoint);
   model_builder.AddOperation(ANEURALNETWORKS_TRANSPOSE, input_indices, {output},
                              {output_operand_type}, {output_is_nhwc});
 }
@@ -160,7 +309,9 @@ enum DataLayout {
 // TODO, replace this with more efficient code in optimizers
 uint32_t AddInitializerInNewLayout(ModelBuilder& model_builder,
                                    const std::string& name,
-                                   DataLayout new_layout) {
+                                   DataLayout new_layout,
+                                   float scale = 0.0f,
+                                   int32_t zero_point = 0) {
   const auto& tensor = model_builder.GetInitializerTensors().at(name);
   Shape shape;
   for (auto dim : tensor.dims())
@@ -174,6 +325,8 @@ uint32_t AddInitializerInNewLayout(ModelBuilder& model_builder,
   Type type;
   if (tensor.data_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
     type = Type::TENSOR_FLOAT32;
+  } else if (tensor.data_type() == ONNX_NAMESPACE::TensorProto_DataType_UINT8) {
+    type = Type::TENSOR_QUANT8_ASYMM;
   } else {
     ORT_THROW("The initializer of graph doesn't have valid type: " + name);
   }
@@ -186,9 +339,11 @@ uint32_t AddInitializerInNewLayout(ModelBuilder& model_builder,
   else
     dest_shape = {in_t, h_t, w_t, out_t};  // L_1230 for depthwise conv weight
 
-  const float* src = GetTensorFloatData(tensor);
-  float* buffer = new float[Product(shape)];
-  const OperandType operand_type(type, dest_shape);
+  std::vector<uint8_t> src;
+  GetInitializerBytes(tensor, src);
+  const OperandType operand_type(type, dest_shape, scale, zero_point);
+  const size_t element_size = operand_type.GetElementByteSize();
+  std::vector<uint8_t> buffer(src.size());
   for (uint32_t out = 0; out < out_t; out++) {
     for (uint32_t in = 0; in < in_t; in++) {
       for (uint32_t h = 0; h < h_t; h++) {
@@ -211,20 +366,20 @@ uint32_t AddInitializerInNewLayout(ModelBuilder& model_builder,
                         out;
           }
 
-          buffer[nnapi_idx] = src[onnx_idx];
+          memcpy(&buffer[nnapi_idx * element_size], &src[onnx_idx * element_size], element_size);
         }
       }
     }
   }
 
-  auto operand_idx = model_builder.AddOperandFromPersistMemoryBuffer(name, &buffer[0], operand_type);
-  delete[] buffer;
-  return operand_idx;
+  return model_builder.AddOperandFromPersistMemoryBuffer(name, buffer.data(), operand_type);
 }
 
 // TODO, replace this with more efficient code in optimizers
 uint32_t AddInitializerTransposed(ModelBuilder& model_builder,
-                                  const std::string& name) {
+                                  const std::string& name,
+                                  float scale = 0.0f,
+                                  int32_t zero_point = 0) {
   const auto& tensor = model_builder.GetInitializerTensors().at(name);
   Shape shape;
   for (auto dim : tensor.dims())
@@ -238,24 +393,26 @@ uint32_t AddInitializerTransposed(ModelBuilder& model_builder,
   Type type;
   if (tensor.data_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
     type = Type::TENSOR_FLOAT32;
+  } else if (tensor.data_type() == ONNX_NAMESPACE::TensorProto_DataType_UINT8) {
+    type = Type::TENSOR_QUANT8_ASYMM;
   } else {
     ORT_THROW("The initializer of graph doesn't have valid type: " + name);
   }
 
   auto x_t = shape[0], y_t = shape[1];
   Shape dest_shape = {y_t, x_t};
-  const OperandType operand_type(type, dest_shape);
-  const float* src = GetTensorFloatData(tensor);
-  float* buffer = new float[Product(shape)];
+  const OperandType operand_type(type, dest_shape, scale, zero_point);
+  const size_t element_size = operand_type.GetElementByteSize();
+  std::vector<uint8_t> src;
+  GetInitializerBytes(tensor, src);
+  std::vector<uint8_t> buffer(src.size());
   for (uint32_t x = 0; x < x_t; x++) {
     for (uint32_t y = 0; y < y_t; y++) {
-      buffer[y * x_t + x] = src[x * y_t + y];
+      memcpy(&buffer[(y * x_t + x) * element_size], &src[(x * y_t + y) * element_size], element_size);
     }
   }
-  auto operand_idx = model_builder.AddOperandFromPersistMemoryBuffer(name, &buffer[0], operand_type);
 
-  delete[] buffer;
-  return operand_idx;
+  return model_builder.AddOperandFromPersistMemoryBuffer(name, buffer.data(), operand_type);
 }
 
 #pragma endregion helpers
@@ -889,12 +1046,47 @@ class ConvOpBuilder : public BaseOpBuilder {
  private:
   bool IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) override;
 
+  int32_t GetMinSupportedSdkVer(ModelBuilder& /* model_builder */, const Node& node) const override {
+    return IsQuantizedOp(node) ? 29 : 27;
+  }
+
+  bool HasSupportedInputs(const Node& node) override;
+
   void AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node) override;
 };
 
+// Inputs of QLinearConv are x, x_scale, x_zero_point, w, w_scale, w_zero_point, y_scale, y_zero_point, B
+// while inputs of Conv are X, W, B
 void ConvOpBuilder::AddInitializersToSkip(ModelBuilder& model_builder, const Node& node) {
-  // skip the weight for conv as we need to transpose
-  model_builder.AddInitializerToSkip(node.InputDefs()[1]->Name());
+  const auto& input_defs(node.InputDefs());
+  if (IsQuantizedOp(node)) {
+    // skip the scales and zero points, the weight is transposed and the bias is added with its scale
+    for (size_t i = 1; i < input_defs.size(); i++)
+      model_builder.AddInitializerToSkip(input_defs[i]->Name());
+  } else {
+    // skip the weight for conv as we need to transpose
+    model_builder.AddInitializerToSkip(input_defs[1]->Name());
+  }
+}
+
+bool ConvOpBuilder::HasSupportedInputs(const Node& node) {
+  if (!IsQuantizedOp(node))
+    return BaseOpBuilder::HasSupportedInputs(node);
+
+  int32_t x_type, w_type;
+  if (!GetType(*node.InputDefs()[0], x_type) || !GetType(*node.InputDefs()[3], w_type))
+    return false;
+
+  if (x_type != ONNX_NAMESPACE::TensorProto_DataType_UINT8 ||
+      w_type != ONNX_NAMESPACE::TensorProto_DataType_UINT8) {
+    LOGS_DEFAULT(VERBOSE) << "[" << node.OpType()
+                          << "] Input type: [" << x_type
+                          << "] Weight type: [" << w_type
+                          << "] are not supported for now";
+    return false;
+  }
+
+  return true;
 }
 
 bool ConvOpBuilder::IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) {
@@ -904,10 +1096,12 @@ bool ConvOpBuilder::IsOpSupportedImpl(ModelBuilder& model_builder, const Node& n
     return false;
   }
 
+  const bool is_quant_conv = IsQuantizedOp(node);
+  const auto& initializers(model_builder.GetInitializerTensors());
   const auto group = helper.Get("group", 1);
-  const auto weight_name = node.InputDefs()[1]->Name();
-  if (Contains(model_builder.GetInitializerTensors(), weight_name)) {
-    const auto& tensor = model_builder.GetInitializerTensors().at(weight_name);
+  const auto weight_name = node.InputDefs()[is_quant_conv ? 3 : 1]->Name();
+  if (Contains(initializers, weight_name)) {
+    const auto& tensor = initializers.at(weight_name);
     if (tensor.dims().size() != 4) {
       LOGS_DEFAULT(VERBOSE) << "Only conv 2d is supported.";
       return false;
@@ -921,6 +1115,17 @@ bool ConvOpBuilder::IsOpSupportedImpl(ModelBuilder& model_builder, const Node& n
     return false;
   }
 
+  if (is_quant_conv) {
+    if (!HasValidQuantizationScales(model_builder, node, {1, 4, 6}) ||
+        !HasValidQuantizationZeroPoints(model_builder, node, {2, 5, 7}))
+      return false;
+
+    if (node.InputDefs().size() > 8 && !Contains(initializers, node.InputDefs()[8]->Name())) {
+      LOGS_DEFAULT(VERBOSE) << "The bias of QLinearConv must be known";
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -961,7 +1166,20 @@ void ConvOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Nod
     }
   }
 
-  const auto& weight = node.InputDefs()[1]->Name();
+  const bool is_quant_conv = IsQuantizedOp(node);
+  float x_scale = 0.0f, w_scale = 0.0f, y_scale = 0.0f;
+  int32_t x_zero_point = 0, w_zero_point = 0, y_zero_point = 0;
+  if (is_quant_conv) {
+    x_scale = GetQuantizationScale(model_builder, node, 1);
+    x_zero_point = GetQuantizationZeroPoint(model_builder, node, 2);
+    w_scale = GetQuantizationScale(model_builder, node, 4);
+    w_zero_point = GetQuantizationZeroPoint(model_builder, node, 5);
+    y_scale = GetQuantizationScale(model_builder, node, 6);
+    y_zero_point = GetQuantizationZeroPoint(model_builder, node, 7);
+    VerifyQuantizedInput(model_builder, input, x_scale, x_zero_point);
+  }
+
+  const auto& weight = node.InputDefs()[is_quant_conv ? 3 : 1]->Name();
   const auto& output = node.OutputDefs()[0]->Name();
 
   bool conv2d = (group == 1);
@@ -973,18 +1191,32 @@ void ConvOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Nod
 
   if (conv2d) {
     input_indices.push_back(AddInitializerInNewLayout(
-        model_builder, weight, L_0231));
+        model_builder, weight, L_0231, w_scale, w_zero_point));
   } else {  // depthwise_conv2d
     input_indices.push_back(AddInitializerInNewLayout(
-        model_builder, weight, L_1230));
+        model_builder, weight, L_1230, w_scale, w_zero_point));
   }
 
-  bool hasBias = (node.InputDefs().size() >= 3);
-  std::string bias = hasBias ? node.InputDefs()[2]->Name() : weight + "_bias";
+  const size_t bias_idx = is_quant_conv ? 8 : 2;
+  bool hasBias = (node.InputDefs().size() > bias_idx);
+  std::string bias = hasBias ? node.InputDefs()[bias_idx]->Name() : weight + "_bias";
 
   uint32_t bias_idx_val;
-  if (hasBias) {
+  if (hasBias && !is_quant_conv) {
     bias_idx_val = operand_indices.at(bias);
+  } else if (hasBias) {
+    // the bias of QLinearConv is quantized with the scale x_scale * w_scale and the zero point 0,
+    // which are the quantization parameters NNAPI requires for the bias
+    const auto& bias_tensor = initializers.at(bias);
+    Shape bias_dimen;
+    for (auto dim : bias_tensor.dims())
+      bias_dimen.push_back(SafeInt<uint32_t>(dim));
+
+    std::vector<uint8_t> buffer;
+    GetInitializerBytes(bias_tensor, buffer);
+    OperandType bias_operand_type(Type::TENSOR_INT32, bias_dimen, x_scale * w_scale);
+    bias_idx_val = model_builder.AddOperandFromPersistMemoryBuffer(
+        bias, buffer.data(), bias_operand_type);
   } else {
     const auto weight_dimen = shaper[weight];
     Shape bias_dimen;
@@ -1002,6 +1234,11 @@ void ConvOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Nod
       OperandType bias_operand_type(Type::TENSOR_FLOAT32, bias_dimen);
       bias_idx_val = model_builder.AddOperandFromPersistMemoryBuffer(
           bias, buffer.data(), bias_operand_type);
+    } else if (weight_type == Type::TENSOR_QUANT8_ASYMM) {
+      vector<int32_t> buffer(bias_dimen[0], 0);
+      OperandType bias_operand_type(Type::TENSOR_INT32, bias_dimen, x_scale * w_scale);
+      bias_idx_val = model_builder.AddOperandFromPersistMemoryBuffer(
+          bias, buffer.data(), bias_operand_type);
     } else {
       ORT_THROW("Unknown weight type " + TypeToStr(weight_type));
     }
@@ -1018,7 +1255,9 @@ void ConvOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Nod
     int32_t depthwiseMultiplier = shaper[weight][3] / group;
     input_indices.push_back(model_builder.AddOperandFromScalar(depthwiseMultiplier));
   }
-  int32_t fuse_code = model_builder.FindActivation(node, *node.OutputDefs()[0]);
+  // a quantized output can't be followed by a Relu on NNAPI, as Relu is only supported on float
+  int32_t fuse_code = is_quant_conv ? ANEURALNETWORKS_FUSED_NONE
+                                    : model_builder.FindActivation(node, *node.OutputDefs()[0]);
   input_indices.push_back(model_builder.AddOperandFromScalar(fuse_code));
   // TODO support API 28
   input_indices.push_back(model_builder.AddOperandFromScalar(use_nchw));
@@ -1040,7 +1279,7 @@ void ConvOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Nod
                          output);
   }
 
-  const OperandType output_operand_type(operand_types.at(input).type, shaper[output]);
+  const OperandType output_operand_type(operand_types.at(input).type, shaper[output], y_scale, y_zero_point);
   model_builder.AddOperation(operationCode, input_indices, {output}, {output_operand_type}, {output_is_nhwc});
 }
 
@@ -1122,12 +1361,33 @@ bool SoftMaxOpBuilder::IsOpSupportedImpl(ModelBuilder& /* model_builder */, cons
   if (!GetShape(*node.InputDefs()[0], input_shape))
     return false;
 
-  const auto input_size = input_shape.size();
-  if (input_size != 2 && input_size != 4) {
-    LOGS_DEFAULT(VERBOSE) << "SoftMax only support 2d/4d shape, input is "
+  const auto input_size = static_cast<int32_t>(input_shape.size());
+  if (input_size > 4 || input_size == 0) {
+    LOGS_DEFAULT(VERBOSE) << "SoftMax only supports 1-4d shape, input is "
                           << input_size << "d shape";
     return false;
   }
+
+  NodeAttrHelper helper(node);
+  int32_t axis = helper.Get("axis", 1);
+  if (axis < -input_size || axis >= input_size) {
+    LOGS_DEFAULT(VERBOSE) << "SoftMax axis " << axis << " is out of range for a "
+                          << input_size << "d shape";
+    return false;
+  }
+
+  if (axis < 0)
+    axis += input_size;
+
+  // ONNX SoftMax computes over the input flattened to 2d at axis, while NNAPI SOFTMAX computes over a
+  // single axis. Unless axis is the last one, the input is reshaped to 2d, which needs the shape to be known
+  if (axis != input_size - 1 &&
+      std::find(input_shape.begin(), input_shape.end(), 0u) != input_shape.end()) {
+    LOGS_DEFAULT(VERBOSE) << "SoftMax with axis " << axis << " requires a known input shape, input shape is "
+                          << Shape2String(input_shape);
+    return false;
+  }
+
   return true;
 }
 
@@ -1148,17 +1408,65 @@ void SoftMaxOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const
   }
 
   const auto& output = node.OutputDefs()[0]->Name();
-  float beta = 1.f;
+  const Shape input_shape = shaper[input];
+  const auto input_size = static_cast<int32_t>(input_shape.size());
   int32_t axis = helper.Get("axis", 1);
+  if (axis < 0)
+    axis += input_size;
+
+  // flatten the input to 2d at axis, so the softmax over the last axis covers all the axes from axis on
+  const bool flatten = axis != input_size - 1;
+  std::string softmax_input = input;
+  std::string softmax_output = output;
+  if (flatten) {
+    uint32_t outer = 1, inner = 1;
+    for (int32_t i = 0; i < input_size; i++) {
+      if (i < axis)
+        outer *= input_shape[i];
+      else
+        inner *= input_shape[i];
+    }
+
+    softmax_input = model_builder.GetUniqueName(node.Name() + input + "_2d");
+    softmax_output = model_builder.GetUniqueName(node.Name() + output + "_2d");
+
+    const std::vector<int32_t> shape_2d{static_cast<int32_t>(outer), static_cast<int32_t>(inner)};
+    const Shape shape_2d_dimen = {2};
+    const OperandType shape_operand_type(Type::TENSOR_INT32, shape_2d_dimen);
+    std::vector<uint32_t> input_indices;
+    input_indices.push_back(operand_indices.at(input));
+    input_indices.push_back(model_builder.AddOperandFromPersistMemoryBuffer(
+        model_builder.GetUniqueName(node.Name() + input + "_2d_shape"), shape_2d.data(), shape_operand_type));
+    shaper.Reshape(input, shape_2d, softmax_input);
+    const OperandType reshaped_operand_type(operand_types.at(input).type, shaper[softmax_input]);
+    model_builder.AddOperation(ANEURALNETWORKS_RESHAPE, input_indices, {softmax_input},
+                               {reshaped_operand_type}, {false});
+  }
+
+  float beta = 1.f;
   std::vector<uint32_t> input_indices;
-  input_indices.push_back(operand_indices.at(input));
+  input_indices.push_back(operand_indices.at(softmax_input));
   input_indices.push_back(model_builder.AddOperandFromScalar(beta));
-  input_indices.push_back(model_builder.AddOperandFromScalar(axis));
+  input_indices.push_back(model_builder.AddOperandFromScalar(static_cast<int32_t>(-1)));
 
-  shaper.Identity(input, output);
-  const OperandType output_operand_type(operand_types.at(input).type, shaper[output]);
-  model_builder.AddOperation(ANEURALNETWORKS_SOFTMAX, input_indices, {output},
+  shaper.Identity(softmax_input, softmax_output);
+  const OperandType output_operand_type(operand_types.at(softmax_input).type, shaper[softmax_output]);
+  model_builder.AddOperation(ANEURALNETWORKS_SOFTMAX, input_indices, {softmax_output},
                              {output_operand_type}, {false});
+
+  if (flatten) {
+    std::vector<int32_t> shape(input_shape.begin(), input_shape.end());
+    const Shape shape_dimen = {static_cast<uint32_t>(shape.size())};
+    const OperandType shape_operand_type(Type::TENSOR_INT32, shape_dimen);
+    std::vector<uint32_t> reshape_input_indices;
+    reshape_input_indices.push_back(operand_indices.at(softmax_output));
+    reshape_input_indices.push_back(model_builder.AddOperandFromPersistMemoryBuffer(
+        model_builder.GetUniqueName(node.Name() + output + "_shape"), shape.data(), shape_operand_type));
+    shaper.Reshape(softmax_output, shape, output);
+    const OperandType reshaped_operand_type(operand_types.at(softmax_output).type, shaper[output]);
+    model_builder.AddOperation(ANEURALNETWORKS_RESHAPE, reshape_input_indices, {output},
+                               {reshaped_operand_type}, {false});
+  }
 }
 
 #pragma endregion
@@ -1200,12 +1508,36 @@ class GemmOpBuilder : public BaseOpBuilder {
  private:
   bool IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) override;
 
+  bool HasSupportedInputs(const Node& node) override;
+
   void AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node) override;
 };
 
+bool GemmOpBuilder::HasSupportedInputs(const Node& node) {
+  if (node.OpType() != "QLinearMatMul")
+    return BaseOpBuilder::HasSupportedInputs(node);
+
+  int32_t a_type, b_type;
+  if (!GetType(*node.InputDefs()[0], a_type) || !GetType(*node.InputDefs()[3], b_type))
+    return false;
+
+  if (a_type != ONNX_NAMESPACE::TensorProto_DataType_UINT8 ||
+      b_type != ONNX_NAMESPACE::TensorProto_DataType_UINT8) {
+    LOGS_DEFAULT(VERBOSE) << "[" << node.OpType()
+                          << "] A Input type: [" << a_type
+                          << "] B Input type: [" << b_type
+                          << "] are not supported for now";
+    return false;
+  }
+
+  return true;
+}
+
+// Inputs of QLinearMatMul are a, a_scale, a_zero_point, b, b_scale, b_zero_point, y_scale, y_zero_point
 bool GemmOpBuilder::IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) {
   const auto& op = node.OpType();
   const auto& initializers(model_builder.GetInitializerTensors());
+  const size_t b_idx = op == "QLinearMatMul" ? 3 : 1;
 
   Shape a_shape;
   {
@@ -1220,7 +1552,7 @@ bool GemmOpBuilder::IsOpSupportedImpl(ModelBuilder& model_builder, const Node& n
 
   Shape b_shape;
   {
-    if (!GetShape(*node.InputDefs()[1], b_shape))
+    if (!GetShape(*node.InputDefs()[b_idx], b_shape))
       return false;
 
     if (b_shape.size() != 2) {
@@ -1229,11 +1561,17 @@ bool GemmOpBuilder::IsOpSupportedImpl(ModelBuilder& model_builder, const Node& n
     }
   }
 
-  if (op == "MatMul") {  // Only support A*B B is an initializer
-    if (!Contains(initializers, node.InputDefs()[1]->Name())) {
-      LOGS_DEFAULT(VERBOSE) << "B of MatMul must be known";
+  if (op == "MatMul" || op == "QLinearMatMul") {  // Only support A*B B is an initializer
+    if (!Contains(initializers, node.InputDefs()[b_idx]->Name())) {
+      LOGS_DEFAULT(VERBOSE) << "B of " << op << " must be known";
       return false;
     }
+
+    if (op == "QLinearMatMul") {
+      if (!HasValidQuantizationScales(model_builder, node, {1, 4, 6}) ||
+          !HasValidQuantizationZeroPoints(model_builder, node, {2, 5, 7}))
+        return false;
+    }
   } else if (op == "Gemm") {
     // Only support
     // 1. A*B'+C
@@ -1283,6 +1621,11 @@ void GemmOpBuilder::AddInitializersToSkip(ModelBuilder& model_builder, const Nod
     const auto transB = helper.Get("transB", 0);
     if (transB == 0)
       model_builder.AddInitializerToSkip(node.InputDefs()[1]->Name());
+  } else if (op == "QLinearMatMul") {
+    // skip the scales and zero points, and b which is transposed
+    const auto& input_defs(node.InputDefs());
+    for (size_t i = 1; i < input_defs.size(); i++)
+      model_builder.AddInitializerToSkip(input_defs[i]->Name());
   }
 }
 
@@ -1293,20 +1636,32 @@ void GemmOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Nod
   const auto& operand_types(model_builder.GetOperandTypes());
   NodeAttrHelper helper(node);
 
+  const bool is_quant_matmul = op == "QLinearMatMul";
   const auto& input1 = node.InputDefs()[0]->Name();
-  const auto& input2 = node.InputDefs()[1]->Name();
+  const auto& input2 = node.InputDefs()[is_quant_matmul ? 3 : 1]->Name();
   const auto& output = node.OutputDefs()[0]->Name();
   const auto transB = helper.Get("transB", 0);
 
+  float a_scale = 0.0f, b_scale = 0.0f, y_scale = 0.0f;
+  int32_t b_zero_point = 0, y_zero_point = 0;
+  if (is_quant_matmul) {
+    a_scale = GetQuantizationScale(model_builder, node, 1);
+    b_scale = GetQuantizationScale(model_builder, node, 4);
+    b_zero_point = GetQuantizationZeroPoint(model_builder, node, 5);
+    y_scale = GetQuantizationScale(model_builder, node, 6);
+    y_zero_point = GetQuantizationZeroPoint(model_builder, node, 7);
+    VerifyQuantizedInput(model_builder, input1, a_scale, GetQuantizationZeroPoint(model_builder, node, 2));
+  }
+
   uint32_t input_2_idx;
   if (transB == 0) {
-    input_2_idx = AddInitializerTransposed(model_builder, input2);
+    input_2_idx = AddInitializerTransposed(model_builder, input2, b_scale, b_zero_point);
   } else {
     input_2_idx = operand_indices.at(input2);
   }
 
   uint32_t bias_idx;
-  if (node.InputDefs().size() == 2) {
+  if (node.InputDefs().size() == 2 || is_quant_matmul) {
     std::string bias = node.Name() + op + "_bias";
     const auto& B_type = operand_types.at(input2).type;
     Shape bias_dimen = {shaper[input2][0]};
@@ -1318,6 +1673,12 @@ void GemmOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Nod
       OperandType bias_operand_type(Type::TENSOR_FLOAT32, bias_dimen);
       bias_idx = model_builder.AddOperandFromPersistMemoryBuffer(
           bias, &buffer[0], bias_operand_type);
+    } else if (B_type == Type::TENSOR_QUANT8_ASYMM) {
+      // NNAPI requires the bias of a quantized FULLY_CONNECTED to have the scale a_scale * b_scale
+      vector<int32_t> buffer(bias_dimen[0], 0);
+      OperandType bias_operand_type(Type::TENSOR_INT32, bias_dimen, a_scale * b_scale);
+      bias_idx = model_builder.AddOperandFromPersistMemoryBuffer(
+          bias, buffer.data(), bias_operand_type);
     } else {
       ORT_THROW("Unknown weight type " + TypeToStr(B_type));
     }
@@ -1329,11 +1690,12 @@ void GemmOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Nod
   input_indices.push_back(operand_indices.at(input1));  // A
   input_indices.push_back(input_2_idx);                 // B
   input_indices.push_back(bias_idx);                    // C
-  int32_t fuse_code = model_builder.FindActivation(node, *node.OutputDefs()[0]);
+  int32_t fuse_code = is_quant_matmul ? ANEURALNETWORKS_FUSED_NONE
+                                      : model_builder.FindActivation(node, *node.OutputDefs()[0]);
   input_indices.push_back(model_builder.AddOperandFromScalar(fuse_code));
 
   shaper.FC(input1, input2, output);
-  const OperandType output_operand_type(operand_types.at(input1).type, shaper[output]);
+  const OperandType output_operand_type(operand_types.at(input1).type, shaper[output], y_scale, y_zero_point);
   model_builder.AddOperation(ANEURALNETWORKS_FULLY_CONNECTED, input_indices, {output},
                              {output_operand_type}, {false});
 }
@@ -1426,6 +1788,27 @@ bool ConcatOpBuilder::IsOpSupportedImpl(ModelBuilder& /* model_builder */, const
     return false;
   }
 
+  // the axis may be negative, it is converted to the non negative axis NNAPI requires
+  const auto rank = static_cast<int32_t>(input_size);
+  NodeAttrHelper helper(node);
+  const auto axis = helper.Get("axis", 1);
+  if (axis < -rank || axis >= rank) {
+    LOGS_DEFAULT(VERBOSE) << "Concat axis " << axis << " is out of range for a "
+                          << rank << "d shape";
+    return false;
+  }
+
+  for (size_t i = 1; i < node.InputDefs().size(); i++) {
+    Shape shape;
+    if (!GetShape(*node.InputDefs()[i], shape))
+      return false;
+
+    if (shape.size() != input_size) {
+      LOGS_DEFAULT(VERBOSE) << "Concat inputs must have the same rank";
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -1573,6 +1956,302 @@ void SqueezeOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const
 
 #pragma endregion
 
+#pragma region op_quantizelinear
+
+class QuantizeLinearOpBuilder : public BaseOpBuilder {
+ public:
+  void AddInitializersToSkip(ModelBuilder& model_builder, const Node& node) override;
+
+ private:
+  bool IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) override;
+
+  int32_t GetMinSupportedSdkVer(ModelBuilder& /* model_builder */, const Node& /* node */) const override {
+    return 29;
+  }
+
+  void AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node) override;
+};
+
+void QuantizeLinearOpBuilder::AddInitializersToSkip(ModelBuilder& model_builder, const Node& node) {
+  const auto& input_defs(node.InputDefs());
+  for (size_t i = 1; i < input_defs.size(); i++)
+    model_builder.AddInitializerToSkip(input_defs[i]->Name());
+}
+
+bool QuantizeLinearOpBuilder::IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) {
+  return HasValidQuantizationScales(model_builder, node, {1}) &&
+         HasValidQuantizationZeroPoints(model_builder, node, {2});
+}
+
+void QuantizeLinearOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node) {
+  auto& shaper(model_builder.GetShaper());
+  const auto& operand_indices(model_builder.GetOperandIndices());
+
+  const auto& input = node.InputDefs()[0]->Name();
+  const auto& output = node.OutputDefs()[0]->Name();
+  bool output_is_nhwc = model_builder.IsOperandNHWC(input);
+
+  float scale = GetQuantizationScale(model_builder, node, 1);
+  int32_t zero_point = GetQuantizationZeroPoint(model_builder, node, 2);
+
+  std::vector<uint32_t> input_indices;
+  input_indices.push_back(operand_indices.at(input));
+  shaper.Identity(input, output);
+  const OperandType output_operand_type(Type::TENSOR_QUANT8_ASYMM, shaper[output], scale, zero_point);
+  model_builder.AddOperation(ANEURALNETWORKS_QUANTIZE, input_indices, {output},
+                             {output_operand_type}, {output_is_nhwc});
+}
+
+#pragma endregion
+
+#pragma region op_dequantizelinear
+
+class DequantizeLinearOpBuilder : public BaseOpBuilder {
+ public:
+  void AddInitializersToSkip(ModelBuilder& model_builder, const Node& node) override;
+
+ private:
+  bool IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) override;
+
+  bool HasSupportedInputs(const Node& node) override;
+
+  void AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node) override;
+};
+
+void DequantizeLinearOpBuilder::AddInitializersToSkip(ModelBuilder& model_builder, const Node& node) {
+  const auto& input_defs(node.InputDefs());
+  for (size_t i = 1; i < input_defs.size(); i++)
+    model_builder.AddInitializerToSkip(input_defs[i]->Name());
+}
+
+bool DequantizeLinearOpBuilder::HasSupportedInputs(const Node& node) {
+  int32_t input_type;
+  if (!GetType(*node.InputDefs()[0], input_type))
+    return false;
+
+  if (input_type != ONNX_NAMESPACE::TensorProto_DataType_UINT8) {
+    LOGS_DEFAULT(VERBOSE) << "[" << node.OpType()
+                          << "] Input type: [" << input_type
+                          << "] is not supported for now";
+    return false;
+  }
+
+  return true;
+}
+
+bool DequantizeLinearOpBuilder::IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) {
+  const auto& initializers(model_builder.GetInitializerTensors());
+  if (Contains(initializers, node.InputDefs()[0]->Name())) {
+    LOGS_DEFAULT(VERBOSE) << "Dequantizing an initializer is not supported";
+    return false;
+  }
+
+  return HasValidQuantizationScales(model_builder, node, {1}) &&
+         HasValidQuantizationZeroPoints(model_builder, node, {2});
+}
+
+void DequantizeLinearOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node) {
+  auto& shaper(model_builder.GetShaper());
+  const auto& operand_indices(model_builder.GetOperandIndices());
+
+  const auto& input = node.InputDefs()[0]->Name();
+  const auto& output = node.OutputDefs()[0]->Name();
+  bool output_is_nhwc = model_builder.IsOperandNHWC(input);
+
+  VerifyQuantizedInput(model_builder, input,
+                       GetQuantizationScale(model_builder, node, 1),
+                       GetQuantizationZeroPoint(model_builder, node, 2));
+
+  std::vector<uint32_t> input_indices;
+  input_indices.push_back(operand_indices.at(input));
+  shaper.Identity(input, output);
+  const OperandType output_operand_type(Type::TENSOR_FLOAT32, shaper[output]);
+  model_builder.AddOperation(ANEURALNETWORKS_DEQUANTIZE, input_indices, {output},
+                             {output_operand_type}, {output_is_nhwc});
+}
+
+#pragma endregion
+
+#pragma region op_resize
+
+class ResizeOpBuilder : public BaseOpBuilder {
+ public:
+  void AddInitializersToSkip(ModelBuilder& model_builder, const Node& node) override;
+
+ private:
+  bool IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) override;
+
+  int32_t GetMinSupportedSdkVer(ModelBuilder& model_builder, const Node& node) const override;
+
+  void AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node) override;
+};
+
+// Inputs of Resize are X, scales for opset 10, and X, roi, scales, sizes for opset 11
+bool IsResizeOpset10(const Node& node) {
+  return node.InputDefs().size() == 2;
+}
+
+// Get the output height and width of a 4d Resize from either its scales or its sizes
+bool GetResizeOutputSize(ModelBuilder& model_builder, const Node& node,
+                         const Shape& input_shape, uint32_t& output_h, uint32_t& output_w) {
+  const auto& initializers(model_builder.GetInitializerTensors());
+  const auto& input_defs(node.InputDefs());
+  const size_t scales_idx = IsResizeOpset10(node) ? 1 : 2;
+  const size_t sizes_idx = 3;
+
+  if (input_defs.size() > sizes_idx && input_defs[sizes_idx]->Exists() &&
+      Contains(initializers, input_defs[sizes_idx]->Name()) &&
+      initializers.at(input_defs[sizes_idx]->Name()).dims_size() == 1 &&
+      initializers.at(input_defs[sizes_idx]->Name()).dims()[0] == 4) {
+    const int64_t* sizes = GetTensorInt64Data(initializers.at(input_defs[sizes_idx]->Name()));
+    if (sizes[0] != input_shape[0] || sizes[1] != input_shape[1]) {
+      LOGS_DEFAULT(VERBOSE) << "Resize of the batch or channel dimension is not supported";
+      return false;
+    }
+
+    output_h = SafeInt<uint32_t>(sizes[2]);
+    output_w = SafeInt<uint32_t>(sizes[3]);
+    return true;
+  }
+
+  if (!Contains(initializers, input_defs[scales_idx]->Name())) {
+    LOGS_DEFAULT(VERBOSE) << "The scales or the sizes of Resize must be known";
+    return false;
+  }
+
+  const auto& scales_tensor = initializers.at(input_defs[scales_idx]->Name());
+  if (scales_tensor.dims_size() != 1 || scales_tensor.dims()[0] != 4) {
+    LOGS_DEFAULT(VERBOSE) << "Resize requires 4 scales";
+    return false;
+  }
+
+  const float* scales = GetTensorFloatData(scales_tensor);
+  if (scales[0] != 1.0f || scales[1] != 1.0f) {
+    LOGS_DEFAULT(VERBOSE) << "Resize of the batch or channel dimension is not supported";
+    return false;
+  }
+
+  if (input_shape[2] == 0 || input_shape[3] == 0) {
+    LOGS_DEFAULT(VERBOSE) << "Resize with scales requires a known input height and width";
+    return false;
+  }
+
+  // same as the output shape computed by the CPU Resize
+  output_h = static_cast<uint32_t>(input_shape[2] * scales[2]);
+  output_w = static_cast<uint32_t>(input_shape[3] * scales[3]);
+  return true;
+}
+
+void ResizeOpBuilder::AddInitializersToSkip(ModelBuilder& model_builder, const Node& node) {
+  const auto& input_defs(node.InputDefs());
+  for (size_t i = 1; i < input_defs.size(); i++)
+    model_builder.AddInitializerToSkip(input_defs[i]->Name());
+}
+
+int32_t ResizeOpBuilder::GetMinSupportedSdkVer(ModelBuilder& /* model_builder */, const Node& node) const {
+  NodeAttrHelper helper(node);
+  // RESIZE_NEAREST_NEIGHBOR is available from API 29
+  if (helper.Get("mode", "nearest") == "nearest")
+    return 29;
+
+  return 28;
+}
+
+bool ResizeOpBuilder::IsOpSupportedImpl(ModelBuilder& model_builder, const Node& node) {
+  Shape input_shape;
+  if (!GetShape(*node.InputDefs()[0], input_shape))
+    return false;
+
+  if (input_shape.size() != 4) {
+    LOGS_DEFAULT(VERBOSE) << "Resize only supports 4d shape, input is "
+                          << input_shape.size() << "d shape";
+    return false;
+  }
+
+  NodeAttrHelper helper(node);
+  const auto mode = helper.Get("mode", "nearest");
+  if (mode != "nearest" && mode != "linear") {
+    LOGS_DEFAULT(VERBOSE) << "Resize mode " << mode << " is not supported";
+    return false;
+  }
+
+  // NNAPI resizes without aligning the corners nor using the pixel centers, which is the asymmetric
+  // coordinate transformation, the only one before opset 11
+  if (!IsResizeOpset10(node)) {
+    if (helper.Get("coordinate_transformation_mode", "half_pixel") != "asymmetric") {
+      LOGS_DEFAULT(VERBOSE) << "Resize only supports the asymmetric coordinate transformation mode";
+      return false;
+    }
+
+    if (mode == "nearest" && helper.Get("nearest_mode", "round_prefer_floor") != "floor") {
+      LOGS_DEFAULT(VERBOSE) << "Resize only supports the floor nearest mode";
+      return false;
+    }
+  }
+
+  uint32_t output_h, output_w;
+  if (!GetResizeOutputSize(model_builder, node, input_shape, output_h, output_w))
+    return false;
+
+  // before opset 11 the nearest pixel is only the floor one when upsampling
+  if (IsResizeOpset10(node) && mode == "nearest" &&
+      (output_h < input_shape[2] || output_w < input_shape[3])) {
+    LOGS_DEFAULT(VERBOSE) << "Resize nearest before opset 11 only supports upsampling";
+    return false;
+  }
+
+  return true;
+}
+
+void ResizeOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node) {
+  auto& shaper(model_builder.GetShaper());
+  const auto& operand_indices(model_builder.GetOperandIndices());
+  const auto& operand_types(model_builder.GetOperandTypes());
+  NodeAttrHelper helper(node);
+
+  Shape onnx_input_shape;
+  GetShape(*node.InputDefs()[0], onnx_input_shape);
+
+  auto input = node.InputDefs()[0]->Name();
+  bool use_nchw = model_builder.UseNCHW();
+  bool input_is_nhwc = model_builder.IsOperandNHWC(input);
+  bool output_is_nhwc = false;
+  if (use_nchw) {
+    ORT_ENFORCE(!input_is_nhwc, "model_builder.UseNCHW() but input is NHWC");
+  } else {
+    output_is_nhwc = true;
+    if (!input_is_nhwc) {
+      const auto& nchw_input = node.InputDefs()[0]->Name();
+      if (!model_builder.GetNHWCOperand(nchw_input, input)) {
+        input = model_builder.GetUniqueName(nchw_input + "_nchw_to_nhwc");
+        TransposeNCHWToNHWC(model_builder, nchw_input, input);
+      }
+    }
+  }
+
+  uint32_t output_h, output_w;
+  ORT_ENFORCE(GetResizeOutputSize(model_builder, node, onnx_input_shape, output_h, output_w),
+              "Can't get the output size of Resize " + node.Name());
+
+  const auto& output = node.OutputDefs()[0]->Name();
+  const int32_t op_code = helper.Get("mode", "nearest") == "nearest" ? ANEURALNETWORKS_RESIZE_NEAREST_NEIGHBOR
+                                                                     : ANEURALNETWORKS_RESIZE_BILINEAR;
+
+  std::vector<uint32_t> input_indices;
+  input_indices.push_back(operand_indices.at(input));
+  input_indices.push_back(model_builder.AddOperandFromScalar(static_cast<int32_t>(output_w)));
+  input_indices.push_back(model_builder.AddOperandFromScalar(static_cast<int32_t>(output_h)));
+  // the layout is optional and defaults to nhwc, it is only available from API 29
+  if (use_nchw)
+    input_indices.push_back(model_builder.AddOperandFromScalar(use_nchw));
+
+  shaper.ResizeUsingOutputSizes(input, output_h, output_w, use_nchw, output);
+  const OperandType output_operand_type(operand_types.at(input).type, shaper[output]);
+  model_builder.AddOperation(op_code, input_indices, {output}, {output_operand_type}, {output_is_nhwc});
+}
+
+#pragma endregion
+
 #pragma region CreateOpBuilders
 
 std::unordered_map<std::string, std::shared_ptr<IOpBuilder>>
@@ -1600,7 +2279,12 @@ CreateOpBuilders() {
     op_map.emplace("MaxPool", pool_op_builder);
   }
 
-  op_map.emplace("Conv", std::make_shared<ConvOpBuilder>());
+  {
+    auto conv_op_builder = std::make_shared<ConvOpBuilder>();
+    op_map.emplace("Conv", conv_op_builder);
+    op_map.emplace("QLinearConv", conv_op_builder);
+  }
+
   op_map.emplace("Cast", std::make_shared<CastOpBuilder>());
   op_map.emplace("Softmax", std::make_shared<SoftMaxOpBuilder>());
   op_map.emplace("Identity", std::make_shared<IdentityOpBuilder>());
@@ -1609,6 +2293,7 @@ CreateOpBuilders() {
     auto gemm_op_builder = std::make_shared<GemmOpBuilder>();
     op_map.emplace("Gemm", gemm_op_builder);
     op_map.emplace("MatMul", gemm_op_builder);
+    op_map.emplace("QLinearMatMul", gemm_op_builder);
   }
 
   {
@@ -1626,6 +2311,9 @@ CreateOpBuilders() {
 
   op_map.emplace("Concat", std::make_shared<ConcatOpBuilder>());
   op_map.emplace("Squeeze", std::make_shared<SqueezeOpBuilder>());
+  op_map.emplace("QuantizeLinear", std::make_shared<QuantizeLinearOpBuilder>());
+  op_map.emplace("DequantizeLinear", std::make_shared<DequantizeLinearOpBuilder>());
+  op_map.emplace("Resize", std::make_shared<ResizeOpBuilder>());
 
   return op_map;
 }
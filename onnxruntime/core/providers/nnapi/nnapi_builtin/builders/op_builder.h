@@ -30,5 +30,9 @@ std::unordered_map<std::string, std::shared_ptr<IOpBuilder>> CreateOpBuilders();
 // Transpose the NHWCinput to NCHW output
 void TransposeNHWCToNCHW(ModelBuilder& model_builder, const std::string& input, const std::string& output);
 
+// Get the scale and zero point of a quantized (uint8) input of the model from the quantized operator using it
+bool GetQuantizedInputScaleAndZeroPoint(const ModelBuilder& model_builder, const std::string& input_name,
+                                        float& scale, int32_t& zero_point);
+
 }  // namespace nnapi
 }  // namespace onnxruntime
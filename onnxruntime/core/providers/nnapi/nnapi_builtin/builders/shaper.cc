@@ -414,6 +414,29 @@ void Shaper::Squeeze(const std::string& input_name,
   }
 }
 
+void Shaper::ResizeUsingOutputSizes(const std::string& input_name,
+                                    const uint32_t output_h, const uint32_t output_w,
+                                    bool nchw,
+                                    const std::string& output_name) {
+  Shape output_dimen = shape_map_.at(input_name);
+  if (nchw) {
+    output_dimen[2] = output_h;
+    output_dimen[3] = output_w;
+  } else {  // nhwc
+    output_dimen[1] = output_h;
+    output_dimen[2] = output_w;
+  }
+
+  shape_map_[output_name] = output_dimen;
+
+  if (!shaper_finalized_) {
+    shape_ops_.push_back(
+        [input_name, output_h, output_w, nchw, output_name](Shaper& shaper) {
+          shaper.ResizeUsingOutputSizes(input_name, output_h, output_w, nchw, output_name);
+        });
+  }
+}
+
 void Shaper::AddShape(const std::string& name, const Shape& shape) {
   shape_map_[name] = shape;
 }
@@ -50,6 +50,11 @@ class Shaper {
 
   void Squeeze(const std::string& input, const std::vector<int32_t>& axes, const std::string& output);
 
+  void ResizeUsingOutputSizes(const std::string& input_name,
+                              const uint32_t output_h, const uint32_t output_w,
+                              bool nchw,
+                              const std::string& output_name);
+
   // If the shape of certain input is dynamic
   // Use the following 2 functions to update the particular shape
   // and calculate the new output shape
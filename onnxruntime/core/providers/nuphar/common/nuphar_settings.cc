@@ -37,6 +37,7 @@ static const std::unordered_set<std::string> valid_keys = {
     kNupharCacheSoName,
     kNupharCacheModelChecksum,
     kNupharCacheForceNoJIT,
+    kNupharAutoCache,
     kNupharCodeGenTarget,
     kNupharParallelMinWorkloads};
 
@@ -17,6 +17,9 @@ constexpr static const char* kNupharCachePath = "nuphar_cache_path";
 constexpr static const char* kNupharCacheSoName = "nuphar_cache_so_name";
 constexpr static const char* kNupharCacheModelChecksum = "nuphar_cache_model_checksum";
 constexpr static const char* kNupharCacheForceNoJIT = "nuphar_cache_force_no_jit";
+// Option to save each JIT compiled subgraph to nuphar_cache_path, and to load it in later sessions,
+// keyed by the content of the lowered code
+constexpr static const char* kNupharAutoCache = "nuphar_auto_cache";
 // force to use IMatMulExternMKL/IMatMul16ExternMKL
 constexpr static const char* kNupharIMatMulForceMkl = "nuphar_imatmul_force_mkl";
 
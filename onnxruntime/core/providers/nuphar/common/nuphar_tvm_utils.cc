@@ -19,7 +19,10 @@
 #include <experimental/filesystem>
 #undef _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
 #include <atomic>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 namespace fs = std::experimental::filesystem;
 
 namespace onnxruntime {
@@ -204,6 +207,172 @@ void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& mod
   }
 }
 
+// subdirectory of the versioned cache directory holding the automatic cache
+static constexpr const char* kAutoCacheDirectory = "auto";
+
+#ifdef _WIN32
+static constexpr const char* kAutoCacheLibraryExtension = ".dll";
+#else
+static constexpr const char* kAutoCacheLibraryExtension = ".so";
+#endif
+
+bool IsAutoCacheEnabled() {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  return settings.HasOption(kNupharCachePath) && settings.OptionMatches(kNupharAutoCache, "on");
+}
+
+static void ReplaceAll(std::string& str, const std::string& from, const std::string& to) {
+  for (size_t pos = str.find(from); pos != std::string::npos; pos = str.find(from, pos + to.length())) {
+    str.replace(pos, from.length(), to);
+  }
+}
+
+// 64-bit FNV-1a, which unlike std::hash is the same in every build
+static std::string HashAutoCacheKey(const std::string& key) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream oss;
+  oss << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return oss.str();
+}
+
+AutoCacheEntry CreateAutoCacheEntry(const tvm::Array<tvm::LoweredFunc>& lowered,
+                                    const std::string& func_name,
+                                    const tvm::Target& tvm_target,
+                                    const tvm::Target& tvm_host_target,
+                                    const tvm::BuildConfig& config) {
+  std::ostringstream oss;
+  oss << "nuphar:" << __NUPHAR_CACHE_VERSION__ << "\n";
+#ifdef TVM_VERSION
+  oss << "tvm:" << TVM_VERSION << "\n";
+#endif
+  oss << "target:" << tvm_target->str() << "\n"
+      << "host:" << tvm_host_target->str() << "\n"
+      << "alignment:" << config->data_alignment << "\n";
+  for (const auto& func : lowered) {
+    oss << "func:" << func->name << " type:" << func->func_type
+        << " packed:" << func->is_packed_func << " restricted:" << func->is_restricted << "\n"
+        << "args:" << func->args << "\n"
+        << func->body << "\n";
+  }
+
+  // func_name embeds a subgraph id that depends on the order subgraphs are compiled in,
+  // so it's left out of the key
+  AutoCacheEntry entry;
+  entry.key = oss.str();
+  ReplaceAll(entry.key, func_name, "$func");
+  entry.file_stem = HashAutoCacheKey(entry.key);
+  entry.func_name = "_nuphar_" + entry.file_stem;
+  return entry;
+}
+
+static bool GetAutoCacheDirectory(fs::path& path, bool create) {
+  if (!GetOrCreateTVMModuleCacheDirectory(path, create))
+    return false;
+
+  path.append(kAutoCacheDirectory);
+  if (!fs::is_directory(path)) {
+    if (!create)
+      return false;
+    std::error_code ec;
+    // another process may have created it in the meantime
+    fs::create_directory(path, ec);
+    if (!fs::is_directory(path))
+      throw std::runtime_error("Failed to create directory " + path.string());
+  }
+  return true;
+}
+
+CacheStatus LoadTVMPackedFuncFromAutoCache(const AutoCacheEntry& entry, tvm::runtime::PackedFunc& func) {
+  fs::path dir;
+  if (!GetAutoCacheDirectory(dir, /*create*/ false))
+    return CacheStatus::Missing;
+
+  // the key file is written after the library, so the library is complete once the key file exists
+  fs::path key_path = dir / (entry.file_stem + ".key");
+  fs::path lib_path = dir / (entry.file_stem + kAutoCacheLibraryExtension);
+  std::ifstream key_file(key_path.string(), std::ios::binary);
+  if (!key_file)
+    return CacheStatus::Missing;
+  std::string cached_key((std::istreambuf_iterator<char>(key_file)), std::istreambuf_iterator<char>());
+  if (cached_key != entry.key) {
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Hash collision in auto cache entry " << key_path << ", using JIT...";
+    return CacheStatus::Mismatch;
+  }
+
+  tvm::runtime::Module module = tvm::runtime::Module::LoadFromFile(lib_path.string());
+  func = module.GetFunction(entry.func_name);
+  if (func == nullptr) {
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Cannot find " << entry.func_name << " in " << lib_path << ", using JIT...";
+    return CacheStatus::Missing;
+  }
+  return CacheStatus::Found;
+}
+
+static bool LinkSharedLibrary(const fs::path& obj_path, const fs::path& lib_path) {
+#ifdef _WIN32
+  std::string command = "link -nologo -dll -FORCE:MULTIPLE -EXPORT:__tvm_main__ -out:\"" + lib_path.string() + "\" \"" + obj_path.string() + "\" > NUL";
+#else
+  std::string command = "g++ -shared -fPIC -o \"" + lib_path.string() + "\" \"" + obj_path.string() + "\"";
+#endif
+  return std::system(command.c_str()) == 0;
+}
+
+static bool RenameIntoPlace(const fs::path& from, const fs::path& to) {
+  std::error_code ec;
+  fs::rename(from, to, ec);
+  if (ec) {
+    // renaming fails on Windows when another process has already saved the same entry
+    fs::remove(from, ec);
+    return false;
+  }
+  return true;
+}
+
+void SaveTVMModuleToAutoCache(const AutoCacheEntry& entry, tvm::runtime::Module& module) {
+  // Other sessions and processes may be saving the same entry, so each file is written under a unique name
+  // and renamed into place, which is atomic within a directory.
+  static std::atomic<uint64_t> save_count{0};
+  try {
+    fs::path dir;
+    if (!GetAutoCacheDirectory(dir, /*create*/ true))
+      return;
+
+    std::string tmp_stem = entry.file_stem + ".tmp" + std::to_string(Env::Default().GetSelfPid()) + "_" +
+                           std::to_string(save_count++);
+    fs::path obj_path = dir / (tmp_stem + ".o");
+    fs::path tmp_lib_path = dir / (tmp_stem + kAutoCacheLibraryExtension);
+    fs::path tmp_key_path = dir / (tmp_stem + ".key");
+
+    module->SaveToFile(obj_path.string(), "o");
+    bool linked = LinkSharedLibrary(obj_path, tmp_lib_path);
+    std::error_code ec;
+    fs::remove(obj_path, ec);
+    if (!linked) {
+      fs::remove(tmp_lib_path, ec);
+      LOGS_DEFAULT(WARNING) << "Failed to link " << tmp_lib_path << ", " << entry.func_name << " is not cached";
+      return;
+    }
+
+    {
+      std::ofstream key_file(tmp_key_path.string(), std::ios::binary);
+      key_file << entry.key;
+    }
+
+    if (RenameIntoPlace(tmp_lib_path, dir / (entry.file_stem + kAutoCacheLibraryExtension))) {
+      RenameIntoPlace(tmp_key_path, dir / (entry.file_stem + ".key"));
+    } else {
+      fs::remove(tmp_key_path, ec);
+    }
+  } catch (const std::exception& ex) {
+    // the cache is an optimization, so failing to save to it doesn't fail the session
+    LOGS_DEFAULT(WARNING) << "Failed to save " << entry.func_name << " to the auto cache: " << ex.what();
+  }
+}
+
 std::string GetPackedFuncName(const nuphar::NupharSubgraphUnit& subgraph, const CodeGenTarget& codegen_target, int64_t parallel_min_workloads) {
   // in C, a function does not allow its name starting with a digit.
   return NormalizeCppName("_" + subgraph.UniqueId() + "_" + codegen_target.GetTargetName() + "_p" + std::to_string(parallel_min_workloads));
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <tvm/build_module.h>
 #include <tvm/tvm.h>
 #include <string>
 
@@ -30,6 +31,28 @@ enum class CacheStatus {
 CacheStatus LoadTVMPackedFuncFromCache(const std::string& func_name, tvm::runtime::PackedFunc& func);
 void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module);
 
+// Helper functions for the automatic cache, which saves each JIT compiled subgraph to its own shared library
+// under nuphar_cache_path when nuphar_auto_cache is on, and loads it in later sessions and processes.
+// Entries are keyed by the lowered code, the TVM targets (i.e. the CPU features) and the cache and TVM versions,
+// so a changed model only misses the entries of the subgraphs that changed.
+struct AutoCacheEntry {
+  // everything the generated code depends on, saved next to the library to detect hash collisions
+  std::string key;
+  // hash of key, which names the files of the entry
+  std::string file_stem;
+  // name of the function in the library
+  std::string func_name;
+};
+
+bool IsAutoCacheEnabled();
+AutoCacheEntry CreateAutoCacheEntry(const tvm::Array<tvm::LoweredFunc>& lowered,
+                                    const std::string& func_name,
+                                    const tvm::Target& tvm_target,
+                                    const tvm::Target& tvm_host_target,
+                                    const tvm::BuildConfig& config);
+CacheStatus LoadTVMPackedFuncFromAutoCache(const AutoCacheEntry& entry, tvm::runtime::PackedFunc& func);
+void SaveTVMModuleToAutoCache(const AutoCacheEntry& entry, tvm::runtime::Module& module);
+
 std::string GetPackedFuncName(const nuphar::NupharSubgraphUnit& subgraph, const CodeGenTarget& codegen_target, int64_t parallel_min_workloads);
 
 bool TryCreateConstantScalar(tvm::Expr& scalar, const Tensor* tensor);
@@ -156,10 +156,12 @@ tvm::runtime::PackedFunc NupharCompiler::GetLoweredPackedFunc(
   if (cache_status != nuphar::CacheStatus::Found) {
     codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
 
-    if (settings.HasOption(kNupharCacheForceNoJIT)) {
-      if (settings.OptionMatches(kNupharCacheForceNoJIT, "on")) {
-        ORT_THROW("Force not using JIT code!");
-      }
+    bool force_no_jit = settings.HasOption(kNupharCacheForceNoJIT) &&
+                        settings.OptionMatches(kNupharCacheForceNoJIT, "on");
+    // the auto cache is looked up after lowering, since it is keyed by the lowered code
+    bool auto_cache = nuphar::IsAutoCacheEnabled();
+    if (force_no_jit && !auto_cache) {
+      ORT_THROW("Force not using JIT code!");
     }
 
     tvm::Schedule tvm_schedule = CreateSchedule(tvm_outputs_, context_);
@@ -179,6 +181,23 @@ tvm::runtime::PackedFunc NupharCompiler::GetLoweredPackedFunc(
       }
     }
 
+    if (auto_cache) {
+      nuphar::AutoCacheEntry entry = nuphar::CreateAutoCacheEntry(lowered, func_name, tvm_target, tvm_host_target, config);
+      if (nuphar::LoadTVMPackedFuncFromAutoCache(entry, cached_func) == nuphar::CacheStatus::Found) {
+        return cached_func;
+      }
+      if (force_no_jit) {
+        ORT_THROW("Force not using JIT code!");
+      }
+
+      // lower again under the name the entry is looked up with, which doesn't depend on the subgraph id
+      lowered = tvm::lower(tvm_schedule, tvm_args_, entry.func_name, binds, config);
+      tvm::runtime::Module module = tvm::build(lowered, tvm_target, tvm_host_target, config);
+      tvm_codegen::DumpTVMModuleToFile(func_name, module);
+      nuphar::SaveTVMModuleToAutoCache(entry, module);
+      return module.GetFunction(entry.func_name);
+    }
+
     tvm::runtime::Module module = tvm::build(lowered, tvm_target, tvm_host_target, config);
     tvm_codegen::DumpTVMModuleToFile(func_name, module);
     if (cache_status == nuphar::CacheStatus::Missing) {
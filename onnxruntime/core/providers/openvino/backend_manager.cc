@@ -253,26 +253,31 @@ void BackendManager::Compute(Ort::CustomOpApi api, OrtKernelContext* context) {
     std::vector<std::vector<int64_t>> tensor_shapes = GetInputTensorShapes(api, context);
     auto key = MakeMapKeyString(tensor_shapes, subgraph_context_.device_id);
 
-    if(subgraph_context_.device_id == "MYRIAD"){
-      for(size_t i = 0; i < subgraph_context_.input_indexes.size(); i++){
-        if(tensor_shapes[i].size() != 4)
-          subgraph_context_.set_vpu_config = true;
-      }
-    }
-
+    // Concurrent runs share the compiled backends; a shape seen for the first time is compiled
+    // once, while the runs needing it wait.
     std::shared_ptr<IBackend> dynamic_backend;
-    auto search = backend_map_.find(key);
-    if (search == backend_map_.end()) {
-      LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
-                         << "Creating concrete backend for key: " << key;
-      LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
-                         << "Backend created for graph " << subgraph_context_.subgraph_name;
-      auto modelproto_with_concrete_shapes = ReWriteInputShapeInfo(model_proto_, tensor_shapes);
-      dynamic_backend = BackendFactory::MakeBackend(*modelproto_with_concrete_shapes,
-                                                    GetGlobalContext(), subgraph_context_);
-      backend_map_.insert({key, dynamic_backend});
-    } else {
-      dynamic_backend = search->second;
+    {
+      std::lock_guard<std::mutex> lock(backend_map_lock_);
+      auto search = backend_map_.find(key);
+      if (search == backend_map_.end()) {
+        if(subgraph_context_.device_id == "MYRIAD"){
+          for(size_t i = 0; i < subgraph_context_.input_indexes.size(); i++){
+            if(tensor_shapes[i].size() != 4)
+              subgraph_context_.set_vpu_config = true;
+          }
+        }
+
+        LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
+                           << "Creating concrete backend for key: " << key;
+        LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
+                           << "Backend created for graph " << subgraph_context_.subgraph_name;
+        auto modelproto_with_concrete_shapes = ReWriteInputShapeInfo(model_proto_, tensor_shapes);
+        dynamic_backend = BackendFactory::MakeBackend(*modelproto_with_concrete_shapes,
+                                                      GetGlobalContext(), subgraph_context_);
+        backend_map_.insert({key, dynamic_backend});
+      } else {
+        dynamic_backend = search->second;
+      }
     }
 
     dynamic_backend->Infer(api, context);
@@ -9,6 +9,7 @@
 #include "core/framework/kernel_registry.h"
 #include "core/framework/allocatormgr.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include <mutex>
 #include <inference_engine.hpp>
 
 #include "contexts.h"
@@ -41,7 +42,9 @@ class BackendManager {
 
   ONNX_NAMESPACE::ModelProto model_proto_;
   std::shared_ptr<IBackend> concrete_backend_;
+  // Backends compiled for the concrete input shapes seen so far, when the subgraph has symbolic input dims
   std::map<std::string, std::shared_ptr<IBackend>> backend_map_;
+  std::mutex backend_map_lock_;
   SubGraphContext subgraph_context_;
 };
 
@@ -41,6 +41,22 @@ void DumpOnnxModelProto(const ONNX_NAMESPACE::ModelProto& model_proto, std::stri
 
 #endif
 
+std::string GetEnvironmentVar(const std::string& var_name) {
+#ifdef _WIN32
+  size_t value_len = 0;
+  char* value = nullptr;
+  std::string result;
+  if (_dupenv_s(&value, &value_len, var_name.c_str()) == 0 && value != nullptr) {
+    result = value;
+    free(value);
+  }
+  return result;
+#else
+  const char* value = std::getenv(var_name.c_str());
+  return value == nullptr ? std::string() : std::string(value);
+#endif
+}
+
 std::shared_ptr<InferenceEngine::CNNNetwork>
 CreateCNNNetwork(const ONNX_NAMESPACE::ModelProto& model_proto, std::string device_id,
                  InferenceEngine::Precision precision) {
@@ -17,6 +17,9 @@ const std::string log_tag = "[OpenVINO-EP] ";
 bool IsDebugEnabled();
 #endif
 
+// Returns the value of an environment variable, or an empty string if it isn't set.
+std::string GetEnvironmentVar(const std::string& var_name);
+
 void SetIODefs(const ONNX_NAMESPACE::ModelProto& model_proto,
                std::shared_ptr<InferenceEngine::CNNNetwork> network);
 
@@ -1,6 +1,7 @@
 // Copyright(C) 2019 Intel Corporation
 // Licensed under the MIT License
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <memory>
@@ -35,6 +36,15 @@ BasicBackend::BasicBackend(const ONNX_NAMESPACE::ModelProto& model_proto,
   if(subgraph_context_.device_id == "MYRIAD" && subgraph_context_.set_vpu_config){
     config["VPU_DETECT_NETWORK_BATCH"] = CONFIG_VALUE(NO);
   }
+  // Lets the CPU plugin run several Infer Requests at once, each on its own stream of threads.
+  // This trades the latency of a single run for the throughput of concurrent runs, so it is opt-in.
+  // The value is a number of streams, or CPU_THROUGHPUT_AUTO.
+  if (subgraph_context_.device_id == "CPU") {
+    std::string cpu_streams = GetEnvironmentVar("ORT_OPENVINO_CPU_THROUGHPUT_STREAMS");
+    if (!cpu_streams.empty()) {
+      config[CONFIG_KEY(CPU_THROUGHPUT_STREAMS)] = cpu_streams;
+    }
+  }
   try {
     exe_network = global_context_.ie_core.LoadNetwork(*ie_cnn_network_, subgraph_context_.device_id, config);
   } catch (InferenceEngine::details::InferenceEngineException e) {
@@ -44,15 +54,44 @@ BasicBackend::BasicBackend(const ONNX_NAMESPACE::ModelProto& model_proto,
   }
   LOGS_DEFAULT(INFO) << log_tag << "Loaded model to the plugin";
 
-  // Create infer request
+  // Concurrent ORT runs each take an Infer Request from the pool, so that they can be in flight
+  // at the same time on the streams (CPU) or the execution units (VPU) of the device.
+  // The plugin reports how many requests it takes to keep the device busy.
+  unsigned int num_inf_reqs = 1;
   try {
-    infer_request_ = exe_network.CreateInferRequestPtr();
-  } catch (InferenceEngine::details::InferenceEngineException e) {
-    ORT_THROW(log_tag + " Exception while creating InferRequest object: " + e.what());
+    num_inf_reqs = exe_network.GetMetric(METRIC_KEY(OPTIMAL_NUMBER_OF_INFER_REQUESTS)).as<unsigned int>();
   } catch (...) {
-    ORT_THROW(log_tag + "Exception while creating InferRequest object");
+    LOGS_DEFAULT(INFO) << log_tag << "Plugin doesn't report the optimal number of Infer Requests, creating one";
+  }
+  num_inf_reqs = std::max(num_inf_reqs, 1u);
+
+  // Create infer requests
+  for (unsigned int i = 0; i < num_inf_reqs; i++) {
+    try {
+      idle_infer_requests_.push_back(exe_network.CreateInferRequestPtr());
+    } catch (InferenceEngine::details::InferenceEngineException e) {
+      ORT_THROW(log_tag + " Exception while creating InferRequest object: " + e.what());
+    } catch (...) {
+      ORT_THROW(log_tag + "Exception while creating InferRequest object");
+    }
   }
-  LOGS_DEFAULT(INFO) << log_tag << "Infer request created";
+  LOGS_DEFAULT(INFO) << log_tag << "Infer Requests created: " << num_inf_reqs;
+}
+
+InferenceEngine::InferRequest::Ptr BasicBackend::AcquireInferRequest() {
+  std::unique_lock<std::mutex> lock(infer_requests_lock_);
+  infer_request_released_.wait(lock, [this] { return !idle_infer_requests_.empty(); });
+  auto infer_request = idle_infer_requests_.back();
+  idle_infer_requests_.pop_back();
+  return infer_request;
+}
+
+void BasicBackend::ReleaseInferRequest(InferenceEngine::InferRequest::Ptr infer_request) {
+  {
+    std::lock_guard<std::mutex> lock(infer_requests_lock_);
+    idle_infer_requests_.push_back(infer_request);
+  }
+  infer_request_released_.notify_one();
 }
 
 // Starts an asynchronous inference request for data in slice indexed by batch_slice_idx on
@@ -134,20 +173,26 @@ void BasicBackend::CompleteAsyncInference(Ort::CustomOpApi& ort,
 }
 
 void BasicBackend::Infer(Ort::CustomOpApi& ort, OrtKernelContext* context) {
-  // Preliminary Thread safety mechanism
-  // Currently allows only one Infer execution at a time
+  // Each Infer owns an Infer Request for its duration, so concurrent runs only wait
+  // when there are more of them than requests in the pool.
 
   LOGS_DEFAULT(INFO) << log_tag << "Running graph " << subgraph_context_.subgraph_name;
   LOGS_DEFAULT(INFO) << log_tag << "In Infer";
-  std::lock_guard<std::mutex> lock(compute_lock_);
 
-  size_t batch_size = 1;
-  // Get Input and Output tensors
-  auto input_tensors = GetInputTensors(ort, context, ie_cnn_network_, subgraph_context_.input_indexes);
-  auto output_tensors = GetOutputTensors(ort, context, batch_size, infer_request_, ie_cnn_network_, subgraph_context_.output_names);
+  auto infer_request = AcquireInferRequest();
+  try {
+    size_t batch_size = 1;
+    // Get Input and Output tensors
+    auto input_tensors = GetInputTensors(ort, context, ie_cnn_network_, subgraph_context_.input_indexes);
+    auto output_tensors = GetOutputTensors(ort, context, batch_size, infer_request, ie_cnn_network_, subgraph_context_.output_names);
 
-  StartAsyncInference(ort, input_tensors, infer_request_, ie_cnn_network_);
-  CompleteAsyncInference(ort, output_tensors, infer_request_, ie_cnn_network_);
+    StartAsyncInference(ort, input_tensors, infer_request, ie_cnn_network_);
+    CompleteAsyncInference(ort, output_tensors, infer_request, ie_cnn_network_);
+  } catch (...) {
+    ReleaseInferRequest(infer_request);
+    throw;
+  }
+  ReleaseInferRequest(infer_request);
 
   LOGS_DEFAULT(INFO) << log_tag << "Inference successful";
 }
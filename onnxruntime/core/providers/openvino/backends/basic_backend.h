@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include <inference_engine.hpp>
 
 #include "core/session/onnxruntime_cxx_api.h"
@@ -30,11 +33,16 @@ class BasicBackend : public IBackend {
                               InferenceEngine::InferRequest::Ptr infer_request,
                               std::shared_ptr<InferenceEngine::CNNNetwork> ie_cnn_network);
 
+  // Takes an idle Infer Request from the pool, waiting for a concurrent Infer to return one if none is idle
+  InferenceEngine::InferRequest::Ptr AcquireInferRequest();
+  void ReleaseInferRequest(InferenceEngine::InferRequest::Ptr infer_request);
+
   GlobalContext& global_context_;
   const SubGraphContext& subgraph_context_;
-  mutable std::mutex compute_lock_;
   std::shared_ptr<InferenceEngine::CNNNetwork> ie_cnn_network_;
-  InferenceEngine::InferRequest::Ptr infer_request_;
+  std::mutex infer_requests_lock_;
+  std::condition_variable infer_request_released_;
+  std::vector<InferenceEngine::InferRequest::Ptr> idle_infer_requests_;
 };
 }  // namespace openvino_ep
 }  // namespace onnxruntime
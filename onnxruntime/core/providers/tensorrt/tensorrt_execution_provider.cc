@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstdio>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 #include "core/graph/onnx_protobuf.h"
 
 #include "tensorrt_execution_provider.h"
@@ -91,6 +94,189 @@ TensorrtLogger& GetTensorrtLogger() {
   return trt_logger;
 }
 
+namespace {
+// FNV-1a is used for the engine cache keys so that the cache file names are stable across processes and builds.
+uint64_t HashEngineCacheKey(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string HashEngineCacheKey(const std::string& key, uint64_t hash = 14695981039346656037ull) {
+  std::ostringstream hex;
+  hex << std::hex << std::setw(16) << std::setfill('0') << HashEngineCacheKey(key.data(), key.size(), hash);
+  return hex.str();
+}
+
+// Append the min/opt/max shapes of an optimization profile input to the profile part of an engine cache key.
+void AppendProfileKey(std::string& profile_key, const char* name, const int32_t* shapes_min, const int32_t* shapes_opt,
+                      const int32_t* shapes_max, int nb_dims) {
+  profile_key += name;
+  for (const int32_t* shapes : {shapes_min, shapes_opt, shapes_max}) {
+    profile_key += ':';
+    for (int j = 0; j < nb_dims; ++j) {
+      profile_key += std::to_string(shapes[j]) + ',';
+    }
+  }
+  profile_key += ';';
+}
+
+// Parse the shapes of ORT_TENSORRT_PROFILE_*_SHAPES env variables. Profiles are separated by ';', the inputs of a
+// profile by ',' and each input is given as name:dim0xdim1x..., e.g. "input_ids:1x1,mask:1x1;input_ids:8x128,mask:8x128".
+std::vector<std::unordered_map<std::string, std::vector<int32_t>>> ParseProfileShapes(const std::string& env_name,
+                                                                                      const std::string& value) {
+  std::vector<std::unordered_map<std::string, std::vector<int32_t>>> profiles;
+  std::istringstream profiles_stream(value);
+  std::string profile;
+  while (std::getline(profiles_stream, profile, ';')) {
+    std::unordered_map<std::string, std::vector<int32_t>> shapes;
+    std::istringstream inputs_stream(profile);
+    std::string input;
+    while (std::getline(inputs_stream, input, ',')) {
+      const size_t separator = input.rfind(':');
+      ORT_ENFORCE(separator != std::string::npos && separator > 0 && separator + 1 < input.size(),
+                  "Invalid input shape '", input, "' in ", env_name, ", expected name:dim0xdim1x...");
+      std::vector<int32_t>& dims = shapes[input.substr(0, separator)];
+      std::istringstream dims_stream(input.substr(separator + 1));
+      std::string dim;
+      while (std::getline(dims_stream, dim, 'x')) {
+        dims.push_back(std::stoi(dim));
+      }
+    }
+    profiles.push_back(std::move(shapes));
+  }
+  return profiles;
+}
+
+// Returns true if every dynamic input of the network has shapes in all the declared profiles. Shape tensors can't
+// be described by the declared shapes, so the profiles aren't used for networks with shape tensor inputs.
+bool DeclaredProfilesCoverInputs(const std::vector<TensorrtProfileShapes>& profile_shapes,
+                                 const nvinfer1::INetworkDefinition& network) {
+  if (profile_shapes.empty()) {
+    return false;
+  }
+  for (int i = 0, end = network.getNbInputs(); i < end; ++i) {
+    auto input = network.getInput(i);
+    nvinfer1::Dims dims = input->getDimensions();
+    bool is_dynamic_shape = false;
+    for (int j = 0; j < dims.nbDims; ++j) {
+      is_dynamic_shape |= dims.d[j] == -1;
+    }
+    if (!is_dynamic_shape) {
+      continue;
+    }
+    if (input->isShapeTensor()) {
+      return false;
+    }
+    for (const auto& shapes : profile_shapes) {
+      auto iter = shapes.find(input->getName());
+      if (iter == shapes.end() || iter->second[0].size() != static_cast<size_t>(dims.nbDims)) {
+        LOGS_DEFAULT(WARNING) << "TensorRT EP declared optimization profiles don't cover input " << input->getName()
+                              << ", the engine will be rebuilt when the input shapes change.";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Read the INT8 calibration table given via ORT_TENSORRT_INT8_CALIBRATION_TABLE_NAME env variable. The table is
+// either a calibration cache written by TensorRT, which starts with a "TRT-" header line, or a table of dynamic
+// ranges computed by an ORT calibration run (see tools/quantization/calibrate.py) with a "tensor_name range" line
+// per tensor. Returns the contents of the file.
+std::string ReadCalibrationTable(const std::string& file, std::unique_ptr<TensorrtCalibrationCache>& calibration_cache,
+                                 std::unordered_map<std::string, float>& dynamic_ranges) {
+  std::ifstream table_file(file, std::ios::in | std::ios::binary);
+  ORT_ENFORCE(table_file, "TensorRT EP could not open INT8 calibration table ", file);
+  std::string table((std::istreambuf_iterator<char>(table_file)), std::istreambuf_iterator<char>());
+
+  if (table.compare(0, 4, "TRT-") == 0) {
+    calibration_cache = onnxruntime::make_unique<TensorrtCalibrationCache>(table);
+    return table;
+  }
+
+  std::istringstream lines(table);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    const size_t separator = line.rfind(' ');
+    ORT_ENFORCE(separator != std::string::npos && separator > 0,
+                "Invalid line '", line, "' in INT8 calibration table ", file, ", expected tensor_name range");
+    dynamic_ranges[line.substr(0, separator)] = std::stof(line.substr(separator + 1));
+  }
+  return table;
+}
+
+// Set the dynamic ranges of the network tensors found in the calibration table. Layers whose tensors have no
+// dynamic range are not run in INT8.
+void SetDynamicRanges(nvinfer1::INetworkDefinition& network, const std::unordered_map<std::string, float>& dynamic_ranges) {
+  auto set_dynamic_range = [&dynamic_ranges](nvinfer1::ITensor* tensor) {
+    auto iter = dynamic_ranges.find(tensor->getName());
+    if (iter != dynamic_ranges.end()) {
+      tensor->setDynamicRange(-iter->second, iter->second);
+    }
+  };
+
+  for (int i = 0, end = network.getNbInputs(); i < end; ++i) {
+    set_dynamic_range(network.getInput(i));
+  }
+  for (int i = 0, end = network.getNbLayers(); i < end; ++i) {
+    auto layer = network.getLayer(i);
+    for (int j = 0, end_j = layer->getNbOutputs(); j < end_j; ++j) {
+      set_dynamic_range(layer->getOutput(j));
+    }
+  }
+}
+
+std::string GetEngineCacheFile(const std::string& engine_cache_prefix, const std::string& profile_key, bool fp16) {
+  return engine_cache_prefix + "_" + HashEngineCacheKey(profile_key + (fp16 ? "fp16" : "fp32")) + ".engine";
+}
+
+// Returns nullptr if the file doesn't exist or doesn't hold an engine this TensorRT runtime can deserialize.
+tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine> LoadEngineCache(nvinfer1::IRuntime& runtime, const std::string& file) {
+  std::ifstream engine_file(file, std::ios::in | std::ios::binary);
+  if (!engine_file) {
+    return nullptr;
+  }
+  std::string engine_buf((std::istreambuf_iterator<char>(engine_file)), std::istreambuf_iterator<char>());
+  auto trt_engine = tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(
+      runtime.deserializeCudaEngine(engine_buf.data(), engine_buf.size(), nullptr));
+  if (trt_engine == nullptr) {
+    LOGS_DEFAULT(WARNING) << "TensorRT EP could not deserialize engine cache file " << file << ", rebuilding it.";
+  }
+  return trt_engine;
+}
+
+// The engine is written to a temporary file which is then renamed, so that concurrent sessions never load a
+// partially written engine.
+void SaveEngineCache(nvinfer1::ICudaEngine& trt_engine, const std::string& file) {
+  auto serialized_engine = tensorrt_ptr::unique_pointer<nvinfer1::IHostMemory>(trt_engine.serialize());
+  if (serialized_engine == nullptr) {
+    LOGS_DEFAULT(WARNING) << "TensorRT EP could not serialize engine for cache file " << file;
+    return;
+  }
+  const std::string temp_file = file + "." + std::to_string(Env::Default().GetSelfPid()) + ".tmp";
+  {
+    std::ofstream engine_file(temp_file, std::ios::out | std::ios::trunc | std::ios::binary);
+    engine_file.write(static_cast<const char*>(serialized_engine->data()), serialized_engine->size());
+    if (!engine_file) {
+      LOGS_DEFAULT(WARNING) << "TensorRT EP could not write engine cache file " << temp_file;
+      engine_file.close();
+      std::remove(temp_file.c_str());
+      return;
+    }
+  }
+  if (std::rename(temp_file.c_str(), file.c_str()) != 0) {
+    // Another session may have written the same engine in the meantime.
+    std::remove(temp_file.c_str());
+  }
+}
+}  // namespace
+
 TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProviderInfo& info)
     : IExecutionProvider{onnxruntime::kTensorrtExecutionProvider}, device_id_(info.device_id) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
@@ -136,10 +322,78 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     fp16_enable_ = (std::stoi(fp16_enable_env) == 0 ? false : true);
   }
 
+  const std::string int8_enable_env = env_instance.GetEnvironmentVar(tensorrt_env_vars::kINT8Enable);
+  if (!int8_enable_env.empty()) {
+    int8_enable_ = (std::stoi(int8_enable_env) == 0 ? false : true);
+  }
+
+  std::string int8_calibration_table;
+  if (int8_enable_) {
+    const std::string int8_calibration_table_name = env_instance.GetEnvironmentVar(tensorrt_env_vars::kINT8CalibrationTableName);
+    ORT_ENFORCE(!int8_calibration_table_name.empty(), "TensorRT EP INT8 mode requires a calibration table set via ",
+                tensorrt_env_vars::kINT8CalibrationTableName, " env variable.");
+    int8_calibration_table = ReadCalibrationTable(int8_calibration_table_name, int8_calibration_cache_, int8_dynamic_ranges_);
+  }
+
   const std::string dump_subgraphs_env = env_instance.GetEnvironmentVar(tensorrt_env_vars::kDumpSubgraphs);
   if (!dump_subgraphs_env.empty()) {
     dump_subgraphs_ = (std::stoi(dump_subgraphs_env) == 0 ? false : true);
   }
+
+  const std::string engine_cache_enable_env = env_instance.GetEnvironmentVar(tensorrt_env_vars::kEngineCacheEnable);
+  if (!engine_cache_enable_env.empty()) {
+    engine_cache_enable_ = (std::stoi(engine_cache_enable_env) == 0 ? false : true);
+  }
+
+  if (engine_cache_enable_) {
+    engine_cache_path_ = env_instance.GetEnvironmentVar(tensorrt_env_vars::kEngineCachePath);
+    if (engine_cache_path_.empty()) {
+      engine_cache_path_ = ".";
+    } else if (!env_instance.FolderExists(engine_cache_path_)) {
+      ORT_THROW_IF_ERROR(env_instance.CreateFolder(engine_cache_path_));
+    }
+
+    // Serialized engines are specific to the TensorRT version and the GPU architecture they were built for.
+    cudaDeviceProp prop;
+    CUDA_CALL_THROW(cudaGetDeviceProperties(&prop, device_id_));
+    engine_cache_target_ = "trt" + std::to_string(NV_TENSORRT_MAJOR) + "." + std::to_string(NV_TENSORRT_MINOR) + "." +
+                           std::to_string(NV_TENSORRT_PATCH) + "." + std::to_string(NV_TENSORRT_BUILD) + "_sm" +
+                           std::to_string(prop.major) + std::to_string(prop.minor);
+    if (int8_enable_) {
+      engine_cache_target_ += "_int8_" + HashEngineCacheKey(int8_calibration_table);
+    }
+    runtime_ = tensorrt_ptr::unique_pointer<nvinfer1::IRuntime>(nvinfer1::createInferRuntime(GetTensorrtLogger()));
+  }
+
+  const std::string profile_min_shapes_env = env_instance.GetEnvironmentVar(tensorrt_env_vars::kProfileMinShapes);
+  const std::string profile_opt_shapes_env = env_instance.GetEnvironmentVar(tensorrt_env_vars::kProfileOptShapes);
+  const std::string profile_max_shapes_env = env_instance.GetEnvironmentVar(tensorrt_env_vars::kProfileMaxShapes);
+  if (!profile_min_shapes_env.empty() || !profile_opt_shapes_env.empty() || !profile_max_shapes_env.empty()) {
+    const auto min_shapes = ParseProfileShapes(tensorrt_env_vars::kProfileMinShapes, profile_min_shapes_env);
+    const auto opt_shapes = ParseProfileShapes(tensorrt_env_vars::kProfileOptShapes, profile_opt_shapes_env);
+    const auto max_shapes = ParseProfileShapes(tensorrt_env_vars::kProfileMaxShapes, profile_max_shapes_env);
+    ORT_ENFORCE(min_shapes.size() == opt_shapes.size() && min_shapes.size() == max_shapes.size(),
+                "TensorRT EP optimization profile env variables must declare the same number of profiles.");
+    profile_shapes_.resize(min_shapes.size());
+    for (size_t p = 0; p < min_shapes.size(); ++p) {
+      for (const auto& input_shapes : min_shapes[p]) {
+        const std::string& name = input_shapes.first;
+        auto opt = opt_shapes[p].find(name);
+        auto max = max_shapes[p].find(name);
+        ORT_ENFORCE(opt != opt_shapes[p].end() && max != max_shapes[p].end() &&
+                        opt->second.size() == input_shapes.second.size() &&
+                        max->second.size() == input_shapes.second.size(),
+                    "TensorRT EP optimization profile ", p, " must declare min, opt and max shapes of the same rank for input ", name);
+        for (size_t j = 0; j < input_shapes.second.size(); ++j) {
+          ORT_ENFORCE(input_shapes.second[j] <= opt->second[j] && opt->second[j] <= max->second[j],
+                      "TensorRT EP optimization profile ", p, " must have min <= opt <= max shapes for input ", name);
+        }
+        profile_shapes_[p][name] = {input_shapes.second, opt->second, max->second};
+      }
+      ORT_ENFORCE(opt_shapes[p].size() == min_shapes[p].size() && max_shapes[p].size() == min_shapes[p].size(),
+                  "TensorRT EP optimization profile ", p, " must declare min, opt and max shapes for the same inputs.");
+    }
+  }
 }
 
 TensorrtExecutionProvider::~TensorrtExecutionProvider() {}
@@ -701,53 +955,115 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     trt_config->setMaxWorkspaceSize(max_workspace_size_);
 
     // Set optimization profile for dynamic shapes
-    auto trt_profile = trt_builder->createOptimizationProfile();
-    for (unsigned int i = 0, end = trt_network->getNbInputs(); i < end; ++i) {
-      auto input = trt_network->getInput(i);
-      nvinfer1::Dims dims = input->getDimensions();
-      nvinfer1::Dims dims_min(dims), dims_opt(dims), dims_max(dims);
-
-      int nb_dims = dims.nbDims;
-      if (input->isShapeTensor()) {  // Shape tensor
-        std::vector<int32_t> shapes_min(nb_dims), shapes_opt(nb_dims), shapes_max(nb_dims);
-        for (int j = 0, end = nb_dims; j < end; ++j) {
-          shapes_min[j] = 1;
-          shapes_opt[j] = 1;
-          shapes_max[j] = 1000;
-        }
-        trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMIN, &shapes_min[0], nb_dims);
-        trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kOPT, &shapes_opt[0], nb_dims);
-        trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMAX, &shapes_max[0], nb_dims);
-      } else {  // Execution tensor
-        bool is_dynamic_shape = false;
-        for (int j = 0, end = nb_dims; j < end; ++j) {
-          // For dynamic shape subgraph, a dummy engine is created at compile phase.
-          // Real engine will be created at compute phase based on input data
-          if (dims.d[j] == -1) {  // Dynamic shape
-            dims_min.d[j] = 1;
-            dims_opt.d[j] = 1;
-            dims_max.d[j] = 1;
-            is_dynamic_shape = true;
+    std::string profile_key;
+    const bool use_declared_profiles = DeclaredProfilesCoverInputs(profile_shapes_, *trt_network);
+    if (use_declared_profiles) {
+      // Build a single engine with all the profiles declared via ORT_TENSORRT_PROFILE_*_SHAPES env variables, so
+      // that the engine never has to be rebuilt when the input shapes change.
+      for (const auto& profile_shapes : profile_shapes_) {
+        auto trt_profile = trt_builder->createOptimizationProfile();
+        for (int i = 0, end = trt_network->getNbInputs(); i < end; ++i) {
+          auto input = trt_network->getInput(i);
+          nvinfer1::Dims dims = input->getDimensions();
+          auto shapes = profile_shapes.find(input->getName());
+          if (shapes == profile_shapes.end() || shapes->second[0].size() != static_cast<size_t>(dims.nbDims)) {
+            continue;
+          }
+          nvinfer1::Dims dims_min(dims), dims_opt(dims), dims_max(dims);
+          for (int j = 0, end = dims.nbDims; j < end; ++j) {
+            dims_min.d[j] = shapes->second[0][j];
+            dims_opt.d[j] = shapes->second[1][j];
+            dims_max.d[j] = shapes->second[2][j];
           }
-        }
-
-        if (is_dynamic_shape) {
           trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims_min);
           trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims_opt);
           trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims_max);
+          AppendProfileKey(profile_key, input->getName(), dims_min.d, dims_opt.d, dims_max.d, dims.nbDims);
         }
+        trt_config->addOptimizationProfile(trt_profile);
+        profile_key += '|';
       }
+    } else {
+      auto trt_profile = trt_builder->createOptimizationProfile();
+      for (unsigned int i = 0, end = trt_network->getNbInputs(); i < end; ++i) {
+        auto input = trt_network->getInput(i);
+        nvinfer1::Dims dims = input->getDimensions();
+        nvinfer1::Dims dims_min(dims), dims_opt(dims), dims_max(dims);
+
+        int nb_dims = dims.nbDims;
+        if (input->isShapeTensor()) {  // Shape tensor
+          std::vector<int32_t> shapes_min(nb_dims), shapes_opt(nb_dims), shapes_max(nb_dims);
+          for (int j = 0, end = nb_dims; j < end; ++j) {
+            shapes_min[j] = 1;
+            shapes_opt[j] = 1;
+            shapes_max[j] = 1000;
+          }
+          trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMIN, &shapes_min[0], nb_dims);
+          trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kOPT, &shapes_opt[0], nb_dims);
+          trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMAX, &shapes_max[0], nb_dims);
+          AppendProfileKey(profile_key, input->getName(), &shapes_min[0], &shapes_opt[0], &shapes_max[0], nb_dims);
+        } else {  // Execution tensor
+          bool is_dynamic_shape = false;
+          for (int j = 0, end = nb_dims; j < end; ++j) {
+            // For dynamic shape subgraph, a dummy engine is created at compile phase.
+            // Real engine will be created at compute phase based on input data
+            if (dims.d[j] == -1) {  // Dynamic shape
+              dims_min.d[j] = 1;
+              dims_opt.d[j] = 1;
+              dims_max.d[j] = 1;
+              is_dynamic_shape = true;
+            }
+          }
+
+          if (is_dynamic_shape) {
+            trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims_min);
+            trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims_opt);
+            trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims_max);
+            AppendProfileKey(profile_key, input->getName(), dims_min.d, dims_opt.d, dims_max.d, nb_dims);
+          }
+        }
+      }
+
+      trt_config->addOptimizationProfile(trt_profile);
     }
 
-    trt_config->addOptimizationProfile(trt_profile);
-    if (fp16_enable_ && trt_builder->platformHasFastFp16()) {
+    const bool use_fp16 = fp16_enable_ && trt_builder->platformHasFastFp16();
+    if (use_fp16) {
       trt_config->setFlag(nvinfer1::BuilderFlag::kFP16);
     }
 
-    auto trt_engine = tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(trt_builder->buildEngineWithConfig(*trt_network, *trt_config));
+    // Enable INT8 mode if enabled via ORT_TENSORRT_INT8_ENABLE env variable. The dynamic ranges are set on the network
+    // so that they also apply to the engines rebuilt for new input shapes.
+    if (int8_enable_ && trt_builder->platformHasFastInt8()) {
+      trt_config->setFlag(nvinfer1::BuilderFlag::kINT8);
+      if (int8_calibration_cache_ != nullptr) {
+        trt_config->setInt8Calibrator(int8_calibration_cache_.get());
+      } else {
+        SetDynamicRanges(*trt_network, int8_dynamic_ranges_);
+      }
+    }
+
+    // Load the engine from the engine cache if enabled via ORT_TENSORRT_ENGINE_CACHE_ENABLE env variable. The cache
+    // file is keyed by the subgraph, the TensorRT version and GPU architecture, the precision and the profile shapes.
+    std::string engine_cache_prefix;
+    std::string engine_cache_file;
+    tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine> trt_engine;
+    if (engine_cache_enable_) {
+      const uint64_t target_hash = HashEngineCacheKey(engine_cache_target_.data(), engine_cache_target_.size());
+      engine_cache_prefix = engine_cache_path_ + "/" + HashEngineCacheKey(string_buf, target_hash);
+      engine_cache_file = GetEngineCacheFile(engine_cache_prefix, profile_key, use_fp16);
+      trt_engine = LoadEngineCache(*runtime_, engine_cache_file);
+    }
+
     if (trt_engine == nullptr) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
-                             "TensorRT EP could not build Engine for fused node: " + fused_node->Name());
+      trt_engine = tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(trt_builder->buildEngineWithConfig(*trt_network, *trt_config));
+      if (trt_engine == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                               "TensorRT EP could not build Engine for fused node: " + fused_node->Name());
+      }
+      if (engine_cache_enable_) {
+        SaveEngineCache(*trt_engine, engine_cache_file);
+      }
     }
 
     // Build TensorRT context
@@ -769,6 +1085,10 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       if (iter != input_map.end()) {
         input_indexes[bindingIndex] = iter->second;
       }
+      if (use_declared_profiles) {
+        // The declared profiles are selected per run, so the shape ranges never need to be tracked
+        continue;
+      }
       if (input->isShapeTensor()) {  // Shape tensor
         for (int j = 0, end = dimensions.nbDims; j < end; ++j) {
           input_shape_ranges[bindingIndex][j] = std::make_pair(INT_MAX, INT_MIN);
@@ -805,7 +1125,7 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       output_types[bindingIndex] = tensor_type.elem_type();
     }
 
-    ORT_ENFORCE(trt_engine->getNbBindings() == (num_inputs + num_outputs));
+    ORT_ENFORCE(trt_engine->getNbBindings() == (num_inputs + num_outputs) * trt_engine->getNbOptimizationProfiles());
 
     // Save engine, context and input/output info to map
     parsers_.emplace(fused_node->Name(), std::move(trt_parser));
@@ -828,7 +1148,9 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
             &engines_[context->node_name], &contexts_[context->node_name], builders_[context->node_name].get(),
             networks_[context->node_name].get(), input_info_[context->node_name], output_info_[context->node_name],
             input_shape_ranges_[context->node_name], output_shapes_[context->node_name], &tensorrt_mu_, &fp16_enable_,
-            &max_workspace_size_};
+            &max_workspace_size_, runtime_.get(), engine_cache_prefix,
+            use_declared_profiles ? profile_shapes_ : std::vector<TensorrtProfileShapes>(), int8_enable_,
+            int8_calibration_cache_.get()};
       *state = p.release();
       return 0;
     };
@@ -858,6 +1180,7 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       auto trt_context = trt_state->context->get();
       auto trt_builder = trt_state->builder;
       nvinfer1::IOptimizationProfile* trt_profile = nullptr;
+      std::string profile_key;
       for (int i = 0, end = num_binding_inputs; i < end; ++i) {
         // Check and update shape ranges for dynamic shape inputs
         auto& shape_ranges = trt_state->input_shape_ranges;
@@ -911,10 +1234,12 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
               trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMIN, &shapes_min[0], nb_dims);
               trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kOPT, &shapes_opt[0], nb_dims);
               trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMAX, &shapes_max[0], nb_dims);
+              AppendProfileKey(profile_key, input->getName(), &shapes_min[0], &shapes_opt[0], &shapes_max[0], nb_dims);
             } else {
               trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims_min);
               trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims_opt);
               trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims_max);
+              AppendProfileKey(profile_key, input->getName(), dims_min.d, dims_opt.d, dims_max.d, nb_dims);
             }
           }
         }
@@ -926,16 +1251,34 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
         auto trt_config = tensorrt_ptr::unique_pointer<nvinfer1::IBuilderConfig>(trt_builder->createBuilderConfig());
         trt_config->setMaxWorkspaceSize(*(trt_state->max_workspace_size_ptr));
         trt_config->addOptimizationProfile(trt_profile);
-        if (*(trt_state->fp16_enable_ptr) && trt_builder->platformHasFastFp16()) {
+        const bool use_fp16 = *(trt_state->fp16_enable_ptr) && trt_builder->platformHasFastFp16();
+        if (use_fp16) {
           trt_config->setFlag(nvinfer1::BuilderFlag::kFP16);
         }
+        if (trt_state->int8_enable && trt_builder->platformHasFastInt8()) {
+          trt_config->setFlag(nvinfer1::BuilderFlag::kINT8);
+          if (trt_state->int8_calibrator != nullptr) {
+            trt_config->setInt8Calibrator(trt_state->int8_calibrator);
+          }
+        }
         trt_state->context->reset();
         trt_state->engine->reset();
-        *(trt_state->engine) =  tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(
-                                  trt_builder->buildEngineWithConfig(*trt_state->network, *trt_config));
+
+        std::string engine_cache_file;
+        if (!trt_state->engine_cache_prefix.empty()) {
+          engine_cache_file = GetEngineCacheFile(trt_state->engine_cache_prefix, profile_key, use_fp16);
+          *(trt_state->engine) = LoadEngineCache(*trt_state->runtime, engine_cache_file);
+        }
 
         if (trt_state->engine->get() == nullptr) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP Failed to Build Engine.");
+          *(trt_state->engine) = tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>(
+              trt_builder->buildEngineWithConfig(*trt_state->network, *trt_config));
+          if (trt_state->engine->get() == nullptr) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP Failed to Build Engine.");
+          }
+          if (!engine_cache_file.empty()) {
+            SaveEngineCache(*trt_state->engine->get(), engine_cache_file);
+          }
         }
         *(trt_state->context) = tensorrt_ptr::unique_pointer<nvinfer1::IExecutionContext>(
                                   trt_state->engine->get()->createExecutionContext());
@@ -945,6 +1288,47 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
         trt_context = trt_state->context->get();
       }
 
+      // Select the first declared optimization profile covering the input shapes. The bindings of profile p are
+      // numbered from p * total_bindings.
+      const bool use_declared_profiles = !trt_state->profile_shapes.empty();
+      int binding_offset = 0;
+      if (use_declared_profiles) {
+        const auto& engine = trt_context->getEngine();
+        int profile_index = -1;
+        for (int p = 0, end = static_cast<int>(trt_state->profile_shapes.size()); p < end && profile_index < 0; ++p) {
+          const auto& profile_shapes = trt_state->profile_shapes[p];
+          bool in_profile = true;
+          for (int i = 0; i < num_binding_inputs && in_profile; ++i) {
+            const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_indexes[i]);
+            auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+            const auto& tensor_shape = ort.GetTensorShape(tensor_info);
+            ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+            auto shapes = profile_shapes.find(engine.getBindingName(i));
+            if (shapes == profile_shapes.end() || shapes->second[0].size() != tensor_shape.size()) {
+              continue;
+            }
+            for (size_t j = 0, end = tensor_shape.size(); j < end; ++j) {
+              if (tensor_shape[j] < shapes->second[0][j] || tensor_shape[j] > shapes->second[2][j]) {
+                in_profile = false;
+                break;
+              }
+            }
+          }
+          if (in_profile) {
+            profile_index = p;
+          }
+        }
+
+        if (profile_index < 0) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                                 "TensorRT EP input shapes are outside of the declared optimization profiles.");
+        }
+        if (trt_context->getOptimizationProfile() != profile_index && !trt_context->setOptimizationProfile(profile_index)) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP Failed to Set Optimization Profile.");
+        }
+        binding_offset = profile_index * total_bindings;
+      }
+
       // Set input shapes and assign input buffers
       for (int i = 0, end = num_binding_inputs; i < end; ++i) {
         const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_indexes[i]);
@@ -952,12 +1336,12 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
         const auto& tensor_shape = ort.GetTensorShape(tensor_info);
 
         // Set dynamic shapes
-        nvinfer1::Dims dimensions = trt_context->getBindingDimensions(static_cast<int>(i));
+        nvinfer1::Dims dimensions = trt_context->getBindingDimensions(i + binding_offset);
         int nb_dims = dimensions.nbDims;
-        if (dimension_update) {
+        if (dimension_update || use_declared_profiles) {
           for (int j = 0, end = nb_dims; j < end; ++j)
             dimensions.d[j] = tensor_shape[j];
-          trt_context->setBindingDimensions(i, dimensions);
+          trt_context->setBindingDimensions(i + binding_offset, dimensions);
         }
 
         auto tensor_type = ort.GetTensorElementType(tensor_info);
@@ -991,7 +1375,7 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       std::vector<OrtValue*> output_tensor(num_binding_outputs, nullptr);
       for (int i = 0, end = num_binding_outputs; i < end; ++i) {
         // Set dynamic shapes
-        nvinfer1::Dims dimensions = trt_context->getBindingDimensions(static_cast<int>(i + num_binding_inputs));
+        nvinfer1::Dims dimensions = trt_context->getBindingDimensions(i + num_binding_inputs + binding_offset);
         int nb_dims = dimensions.nbDims;
         for (int j = 0, end = nb_dims; j < end; ++j) {
           trt_state->output_shapes[i][j] = dimensions.d[j];
@@ -1025,7 +1409,15 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       }
 
       // Run TRT inference
-      if (!trt_context->enqueueV2(&buffers[0], nullptr, nullptr)) {
+      void** bindings = &buffers[0];
+      std::vector<void*> profile_buffers;
+      if (binding_offset > 0) {
+        // The bindings of the profiles before the selected one are not used
+        profile_buffers.resize(binding_offset, nullptr);
+        profile_buffers.insert(profile_buffers.end(), buffers.begin(), buffers.end());
+        bindings = &profile_buffers[0];
+      }
+      if (!trt_context->enqueueV2(bindings, nullptr, nullptr)) {
         return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "TensorRT EP Execution Context Enqueue Failed.");
       }
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <array>
 #include <ctime>
 #include "core/common/logging/logging.h"
 #include "core/framework/op_kernel.h"
@@ -16,7 +17,14 @@ static const std::string kMaxPartitionIterations = "ORT_TENSORRT_MAX_PARTITION_I
 static const std::string kMinSubgraphSize = "ORT_TENSORRT_MIN_SUBGRAPH_SIZE";
 static const std::string kMaxWorkspaceSize = "ORT_TENSORRT_MAX_WORKSPACE_SIZE";
 static const std::string kFP16Enable = "ORT_TENSORRT_FP16_ENABLE";
+static const std::string kINT8Enable = "ORT_TENSORRT_INT8_ENABLE";
+static const std::string kINT8CalibrationTableName = "ORT_TENSORRT_INT8_CALIBRATION_TABLE_NAME";
 static const std::string kDumpSubgraphs = "ORT_TENSORRT_DUMP_SUBGRAPHS";
+static const std::string kEngineCacheEnable = "ORT_TENSORRT_ENGINE_CACHE_ENABLE";
+static const std::string kEngineCachePath = "ORT_TENSORRT_ENGINE_CACHE_PATH";
+static const std::string kProfileMinShapes = "ORT_TENSORRT_PROFILE_MIN_SHAPES";
+static const std::string kProfileOptShapes = "ORT_TENSORRT_PROFILE_OPT_SHAPES";
+static const std::string kProfileMaxShapes = "ORT_TENSORRT_PROFILE_MAX_SHAPES";
 }  // namespace tensorrt_env_vars
 
 class TensorrtLogger : public nvinfer1::ILogger {
@@ -38,6 +46,27 @@ class TensorrtLogger : public nvinfer1::ILogger {
   }
 };
 
+// Provides an existing TensorRT calibration cache to the builder, so that INT8 engines are built without running
+// the calibration.
+class TensorrtCalibrationCache : public nvinfer1::IInt8EntropyCalibrator2 {
+ public:
+  explicit TensorrtCalibrationCache(std::string cache) : cache_(std::move(cache)) {}
+
+  int getBatchSize() const override { return 1; }
+
+  bool getBatch(void* /*bindings*/[], const char* /*names*/[], int /*nb_bindings*/) override { return false; }
+
+  const void* readCalibrationCache(size_t& length) override {
+    length = cache_.size();
+    return cache_.data();
+  }
+
+  void writeCalibrationCache(const void* /*cache*/, size_t /*length*/) override {}
+
+ private:
+  std::string cache_;
+};
+
 namespace tensorrt_ptr {
 
   struct TensorrtInferDeleter {
@@ -58,6 +87,9 @@ struct TensorrtExecutionProviderInfo {
   int device_id{0};
 };
 
+// Min, opt and max shapes of the dynamic inputs of an optimization profile, by input name.
+using TensorrtProfileShapes = std::unordered_map<std::string, std::array<std::vector<int32_t>, 3>>;
+
 // Information to construct kernel function state.
 struct TensorrtFuncState {
 
@@ -76,6 +108,11 @@ struct TensorrtFuncState {
   OrtMutex* tensorrt_mu_ptr = nullptr;
   bool* fp16_enable_ptr = nullptr;
   size_t* max_workspace_size_ptr = nullptr;
+  nvinfer1::IRuntime* runtime = nullptr;
+  std::string engine_cache_prefix;
+  std::vector<TensorrtProfileShapes> profile_shapes;
+  bool int8_enable = false;
+  nvinfer1::IInt8Calibrator* int8_calibrator = nullptr;
 };
 
 // Logical device representation.
@@ -103,11 +140,18 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   int max_partition_iterations_ = 1000;
   int min_subgraph_size_ = 1;
   bool fp16_enable_ = false;
+  bool int8_enable_ = false;
+  std::unique_ptr<TensorrtCalibrationCache> int8_calibration_cache_;
+  std::unordered_map<std::string, float> int8_dynamic_ranges_;
   bool dump_subgraphs_ = false;
-
+  bool engine_cache_enable_ = false;
+  std::string engine_cache_path_;
+  std::string engine_cache_target_;
+  std::vector<TensorrtProfileShapes> profile_shapes_;
 
   OrtMutex tensorrt_mu_;
   int device_id_;
+  tensorrt_ptr::unique_pointer<nvinfer1::IRuntime> runtime_;
   std::unordered_map<std::string, tensorrt_ptr::unique_pointer<nvonnxparser::IParser>> parsers_;
   std::unordered_map<std::string, tensorrt_ptr::unique_pointer<nvinfer1::ICudaEngine>> engines_;
   std::unordered_map<std::string, tensorrt_ptr::unique_pointer<nvinfer1::IExecutionContext>> contexts_;
@@ -161,6 +161,72 @@ ORT_API_STATUS_IMPL(OrtApis::SetInterOpNumThreads, _Inout_ OrtSessionOptions* op
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SetIntraOpNumaNode, _Inout_ OrtSessionOptions* options, int numa_node) {
+  options->value.intra_op_param.numa_node = numa_node < 0 ? -1 : numa_node;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetAsyncRunThreadPoolSize, _Inout_ OrtSessionOptions* options,
+                    int async_run_thread_pool_size) {
+  options->value.async_run_thread_pool_size = async_run_thread_pool_size;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetShareInitializers, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.share_initializers = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetUseMmapInitializers, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.use_mmap_initializers = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSaveNodePlacements, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.save_node_placements = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetUseSavedNodePlacements, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.use_saved_node_placements = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetEnableNodeStats, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.enable_node_stats = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetEnableMemoryProfiling, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.enable_memory_profiling = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetEnableHardwareCounters, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.enable_hardware_counters = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetColumnarZipMapOutputs, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.columnar_zipmap_outputs = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetLazyInitialization, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.enable_lazy_initialization = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSavePrepackedWeights, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.save_prepacked_weights = value != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetUseSavedPrepackedWeights, _Inout_ OrtSessionOptions* options, int value) {
+  options->value.use_saved_prepacked_weights = value != 0;
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(OrtApis::AddFreeDimensionOverride, _Inout_ OrtSessionOptions* options,
                     _In_ const char* dim_denotation, _In_ int64_t dim_value) {
   options->value.free_dimension_overrides.push_back(
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/async_run_queue.h"
+
+namespace onnxruntime {
+
+AsyncRunQueue::AsyncRunQueue(int num_threads) {
+  ORT_ENFORCE(num_threads >= 1, "AsyncRunQueue requires at least one thread");
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this]() { WorkerLoop(); });
+  }
+}
+
+AsyncRunQueue::~AsyncRunQueue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void AsyncRunQueue::Enqueue(std::function<void()> fn) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ORT_ENFORCE(!shutdown_, "AsyncRunQueue is shutting down");
+    pending_.push_back(std::move(fn));
+  }
+  cv_.notify_one();
+}
+
+void AsyncRunQueue::WorkerLoop() {
+  for (;;) {
+    std::function<void()> fn;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return shutdown_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        // shutting down and nothing left to run
+        return;
+      }
+      fn = std::move(pending_.front());
+      pending_.pop_front();
+    }
+
+    fn();
+  }
+}
+
+}  // namespace onnxruntime
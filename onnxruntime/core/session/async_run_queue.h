@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+/**
+ * A fixed set of threads running the InferenceSession::RunAsync requests in submission order.
+ * The queue is unbounded, so enqueueing never blocks the caller or runs the request inline.
+ * The destructor runs the pending requests before joining the threads.
+ */
+class AsyncRunQueue {
+ public:
+  explicit AsyncRunQueue(int num_threads);
+  ~AsyncRunQueue();
+
+  void Enqueue(std::function<void()> fn);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(AsyncRunQueue);
+
+  void WorkerLoop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> pending_;
+  bool shutdown_ = false;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace onnxruntime
@@ -13,6 +13,7 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/tensor_type_and_shape.h"
+#include "core/platform/threadpool.h"
 
 ONNXTensorElementDataType MLDataTypeToOnnxRuntimeTensorElementDataType(const onnxruntime::DataTypeImpl* cpp_type);
 
@@ -51,6 +52,73 @@ ORT_API_STATUS_IMPL(OrtApis::KernelContext_GetOutput, _Inout_ OrtKernelContext*
   return nullptr;
 };
 
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_GetInputData, _In_ const OrtKernelContext* context, _In_ size_t index,
+                    _Outptr_result_maybenull_ const void** data,
+                    _Outptr_result_maybenull_ const int64_t** dim_values, _Out_ size_t* dim_count) {
+  const auto* value = reinterpret_cast<const onnxruntime::OpKernelContextInternal*>(context)->GetInputMLValue(static_cast<int>(index));
+  if (value == nullptr || !value->IsAllocated()) {
+    *data = nullptr;
+    *dim_values = nullptr;
+    *dim_count = 0;
+    return nullptr;
+  }
+  if (!value->IsTensor())
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Input is not a tensor");
+
+  const auto& tensor = value->Get<onnxruntime::Tensor>();
+  auto dims = tensor.Shape().GetDimsAsSpan();
+  *data = tensor.DataRaw();
+  *dim_values = dims.data();
+  *dim_count = static_cast<size_t>(dims.size());
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_GetOutputData, _Inout_ OrtKernelContext* context, _In_ size_t index,
+                    _In_ const int64_t* dim_values, size_t dim_count, _Outptr_ void** data) {
+  API_IMPL_BEGIN
+  onnxruntime::TensorShape shape(dim_values, dim_count);
+  auto* value = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->OutputMLValue(static_cast<int>(index), shape);
+  if (value == nullptr)
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Output index is out of range");
+  *data = value->GetMutable<onnxruntime::Tensor>()->MutableDataRaw();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::KernelInfoGetConstantInputData, _In_ const OrtKernelInfo* info, _In_ size_t index,
+                    _Out_ int* is_constant, _Outptr_result_maybenull_ const void** data,
+                    _Outptr_result_maybenull_ const int64_t** dim_values, _Out_ size_t* dim_count) {
+  const onnxruntime::Tensor* tensor = nullptr;
+  if (!reinterpret_cast<const onnxruntime::OpKernelInfo*>(info)->TryGetConstantInput(static_cast<int>(index), &tensor)) {
+    *is_constant = 0;
+    *data = nullptr;
+    *dim_values = nullptr;
+    *dim_count = 0;
+    return nullptr;
+  }
+
+  auto dims = tensor->Shape().GetDimsAsSpan();
+  *is_constant = 1;
+  *data = tensor->DataRaw();
+  *dim_values = dims.data();
+  *dim_count = static_cast<size_t>(dims.size());
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_ParallelFor, _In_ const OrtKernelContext* context,
+                    _In_ void(ORT_API_CALL* fn)(_In_opt_ void* user_data, size_t begin, size_t end),
+                    _In_opt_ void* user_data, size_t total, double cost_per_unit) {
+  API_IMPL_BEGIN
+  auto* thread_pool = reinterpret_cast<const onnxruntime::OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  onnxruntime::concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(total), cost_per_unit,
+      [fn, user_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        fn(user_data, static_cast<size_t>(begin), static_cast<size_t>(end));
+      });
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::KernelInfoGetAttribute_string, _In_ const OrtKernelInfo* info, _In_ const char* name, _Out_ char* out, _Inout_ size_t* size) {
   std::string value;
   auto status = reinterpret_cast<const onnxruntime::OpKernelInfo*>(info)->GetAttr<std::string>(name, &value);
@@ -4,6 +4,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <map>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -12,6 +13,7 @@
 #include <thread>
 
 #include "core/common/logging/logging.h"
+#include "core/common/parallel_for_cost_table.h"
 #include "core/platform/threadpool.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_utils.h"
@@ -27,21 +29,27 @@
 #include "core/framework/kernel_registry.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/mldata_type_utils.h"
+#include "core/framework/node_placements.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/prepacked_weights_store.h"
 #include "core/framework/finalize_session_state.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/utils.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/optimizer/mixed_precision_transformer.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #ifdef USE_DML  // TODO: This is necessary for the workaround in TransformGraph
 #include "core/providers/dml/DmlExecutionProvider/src/GraphTransformer.h"
 #endif
 #include "core/session/IOBinding.h"
+#include "core/session/async_run_queue.h"
+#include "core/session/prepared_run.h"
 #include "core/session/custom_ops.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
@@ -88,6 +96,114 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
+// Metadata key of the NCHWc block size an optimized model with NCHWc nodes was saved for. The filters of the NCHWc
+// convolutions are reordered for that block size, so the model can't run on processors using another one.
+constexpr const char* kNchwcBlockSizeMetadataKey = "onnxruntime.nchwc_block_size";
+
+// Metadata key of the ID binding an optimized model to the prepacked weights saved along with it.
+constexpr const char* kPrepackedWeightsModelIdMetadataKey = "onnxruntime.prepacked_weights_model_id";
+
+bool HasNchwcNodes(const Graph& graph) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.Domain() == kMSNchwcDomain) {
+      return true;
+    }
+    for (const auto& subgraph : node.GetSubgraphs()) {
+      if (HasNchwcNodes(*subgraph)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+inline void CombineGraphRunSignature(uint64_t& signature, uint64_t value) {
+  signature ^= value + 0x9e3779b97f4a7c15ull + (signature << 6) + (signature >> 2);
+}
+
+// A captured graph replays the kernels with the device buffers and shapes of the run it was captured for, so a run
+// can only be replayed if all its feeds and fetches are tensors already located on the device (e.g. bound with
+// IOBinding) and they match the captured run. Returns 0 if the run can't be replayed.
+uint64_t ComputeGraphRunSignature(const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                                  const std::vector<std::string>& output_names, const std::vector<OrtValue>& fetches,
+                                  uint64_t generation) {
+  if (fetches.size() != output_names.size()) {
+    return 0;
+  }
+
+  uint64_t signature = generation;
+
+  auto combine_values = [&signature](const std::vector<std::string>& names, const std::vector<OrtValue>& values) {
+    for (size_t i = 0, end = values.size(); i < end; ++i) {
+      const auto& value = values[i];
+      if (!value.IsAllocated() || !value.IsTensor()) {
+        return false;
+      }
+
+      const auto& tensor = value.Get<Tensor>();
+      if (tensor.Location().device.Type() == OrtDevice::CPU) {
+        return false;
+      }
+
+      CombineGraphRunSignature(signature, std::hash<std::string>{}(names[i]));
+      CombineGraphRunSignature(signature, reinterpret_cast<uintptr_t>(tensor.DataRaw()));
+      for (const auto dim : tensor.Shape().GetDimsAsSpan()) {
+        CombineGraphRunSignature(signature, static_cast<uint64_t>(dim));
+      }
+    }
+    return true;
+  };
+
+  if (!combine_values(feed_names, feeds) || !combine_values(output_names, fetches)) {
+    return 0;
+  }
+
+  // 0 is reserved for runs that can't be replayed
+  return signature != 0 ? signature : 1;
+}
+
+// Add the work items the workers of a thread pool ran since the previous call to the profile, on the lane of
+// each worker thread, and a summary of how busy the workers were since stats_at_start was taken to run_args.
+void RecordThreadPoolProfile(profiling::Profiler& profiler, concurrency::ThreadPool& thread_pool,
+                             const std::string& pool_name,
+                             const std::vector<concurrency::ThreadPoolWorkerStats>& stats_at_start,
+                             std::unordered_map<std::string, std::string>& run_args) {
+  std::vector<concurrency::ThreadPoolTraceEvent> trace_events;
+  thread_pool.TakeTraceEvents(trace_events);
+  const std::string work_item_name = pool_name + "_work_item";
+  for (const auto& trace_event : trace_events) {
+    profiler.RecordEvent(profiling::THREAD_POOL_EVENT, work_item_name, trace_event.start, trace_event.end,
+                         static_cast<int>(trace_event.os_thread_id),
+                         {{"worker", std::to_string(trace_event.thread_id)}});
+  }
+
+  const auto stats = thread_pool.GetWorkerStats();
+  concurrency::ThreadPoolWorkerStats total;
+  for (size_t i = 0; i < stats.size(); ++i) {
+    const auto& at_start = i < stats_at_start.size() ? stats_at_start[i] : concurrency::ThreadPoolWorkerStats();
+    total.num_tasks += stats[i].num_tasks - at_start.num_tasks;
+    total.num_steals += stats[i].num_steals - at_start.num_steals;
+    total.busy_ns += stats[i].busy_ns - at_start.busy_ns;
+    total.idle_ns += stats[i].idle_ns - at_start.idle_ns;
+    total.num_pushes += stats[i].num_pushes - at_start.num_pushes;
+    total.queue_depth_sum += stats[i].queue_depth_sum - at_start.queue_depth_sum;
+    total.max_queue_depth = std::max(total.max_queue_depth, stats[i].max_queue_depth);
+  }
+
+  // the share of the time the workers spent running work items rather than waiting for them
+  const uint64_t worker_ns = total.busy_ns + total.idle_ns;
+  const double utilization = worker_ns != 0 ? static_cast<double>(total.busy_ns) / worker_ns : 0.0;
+  const double average_queue_depth =
+      total.num_pushes != 0 ? static_cast<double>(total.queue_depth_sum) / total.num_pushes : 0.0;
+  run_args[pool_name + "_tasks"] = std::to_string(total.num_tasks);
+  run_args[pool_name + "_steals"] = std::to_string(total.num_steals);
+  run_args[pool_name + "_busy_us"] = std::to_string(total.busy_ns / 1000);
+  run_args[pool_name + "_idle_us"] = std::to_string(total.idle_ns / 1000);
+  run_args[pool_name + "_utilization"] = std::to_string(utilization);
+  run_args[pool_name + "_average_queue_depth"] = std::to_string(average_queue_depth);
+  run_args[pool_name + "_max_queue_depth"] = std::to_string(total.max_queue_depth);
+}
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -179,13 +295,42 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
       }
       // If the thread pool can use all the processors, then
       // we set affinity of each thread to each processor.
+      // A unified thread pool is the only pool, so it can use all the processors in parallel mode too.
       to.auto_set_affinity = to.thread_pool_size == 0 &&
-                             session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
+                             (session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL ||
+                              session_options_.use_unified_thread_pool) &&
                              to.affinity_vec_len == 0;
       thread_pool_ =
           concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
     }
-    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    if (session_options_.calibrate_parallel_for_cost || !session_options_.parallel_for_cost_table_file.empty()) {
+      if (thread_pool_ == nullptr) {
+        LOGS(*session_logger_, INFO) << "No intra-op thread pool, the ParallelFor cost table is not used";
+      } else {
+        parallel_for_cost_table_ = std::make_shared<concurrency::ParallelForCostTable>();
+        const auto& cost_table_file = session_options_.parallel_for_cost_table_file;
+        if (!cost_table_file.empty()) {
+          auto load_status = parallel_for_cost_table_->Load(cost_table_file);
+          if (load_status.IsOK()) {
+            LOGS(*session_logger_, INFO) << "Loaded " << parallel_for_cost_table_->NumEntries()
+                                         << " ParallelFor cost table entries";
+          } else if (session_options_.calibrate_parallel_for_cost && load_status.Code() == common::NO_SUCHFILE) {
+            LOGS(*session_logger_, INFO) << "No ParallelFor cost table file yet, calibrating from scratch";
+          } else {
+            LOGS(*session_logger_, WARNING) << "Failed to load the ParallelFor cost table: "
+                                            << load_status.ErrorMessage();
+          }
+        }
+        thread_pool_->SetCostTable(parallel_for_cost_table_, session_options_.calibrate_parallel_for_cost);
+      }
+    }
+    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL && session_options_.use_unified_thread_pool) {
+      LOGS(*session_logger_, INFO) << "Using the intra-op thread pool for the parallel executor";
+      if (thread_pool_ == nullptr) {
+        LOGS(*session_logger_, INFO) << "No intra-op thread pool for the parallel executor, setting ExecutionMode to SEQUENTIAL";
+        session_options_.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+      }
+    } else if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
       OrtThreadPoolParams to = session_options_.inter_op_param;
       // If the thread pool can use all the processors, then
       // we set thread affinity.
@@ -207,6 +352,18 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     ORT_ENFORCE(session_env.EnvCreatedWithGlobalThreadPools(),
                 "When the session is not configured to use per session"
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
+    if (session_options_.calibrate_parallel_for_cost || !session_options_.parallel_for_cost_table_file.empty()) {
+      LOGS(*session_logger_, WARNING) << "The ParallelFor cost table requires per session threadpools and is ignored";
+    }
+    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL &&
+        session_options_.use_unified_thread_pool && intra_op_thread_pool_from_env_ == nullptr) {
+      LOGS(*session_logger_, INFO) << "No intra-op thread pool for the parallel executor, setting ExecutionMode to SEQUENTIAL";
+      session_options_.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+    }
+  }
+
+  if (session_options_.share_initializers) {
+    shared_initializer_registry_ = session_env.GetSharedInitializerRegistry();
   }
 
   session_profiler_.Initialize(session_logger_);
@@ -222,7 +379,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 InferenceSession::InferenceSession(const SessionOptions& session_options, const Environment& session_env)
     : graph_transformation_mgr_(session_options.max_num_graph_transformation_steps),
       logging_manager_(session_env.GetLoggingManager()),
-      insert_cast_transformer_("CastFloat16Transformer") {
+      insert_cast_transformer_("CastFloat16Transformer", !MlasHalfGemmIsNative()) {
   // Initialize assets of this session instance
   ConstructorCommon(session_options, session_env);
 }
@@ -232,8 +389,10 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
     : model_location_(ToWideString(model_uri)),
       graph_transformation_mgr_(session_options.max_num_graph_transformation_steps),
       logging_manager_(session_env.GetLoggingManager()),
-      insert_cast_transformer_("CastFloat16Transformer") {
-  auto status = Model::Load(model_location_, model_proto_);
+      insert_cast_transformer_("CastFloat16Transformer", !MlasHalfGemmIsNative()) {
+  auto status = session_options.use_mmap_initializers
+                    ? Model::LoadWithMappedInitializers(model_location_, model_proto_)
+                    : Model::Load(model_location_, model_proto_);
   ORT_ENFORCE(status.IsOK(), "Given model could not be parsed while creating inference session. Error message: ",
               status.ErrorMessage());
   is_model_proto_parsed_ = true;
@@ -247,9 +406,11 @@ InferenceSession::InferenceSession(const SessionOptions& session_options,
                                    const std::wstring& model_uri)
     : graph_transformation_mgr_(session_options.max_num_graph_transformation_steps),
       logging_manager_(session_env.GetLoggingManager()),
-      insert_cast_transformer_("CastFloat16Transformer") {
+      insert_cast_transformer_("CastFloat16Transformer", !MlasHalfGemmIsNative()) {
   model_location_ = ToWideString(model_uri);
-  auto status = Model::Load(model_location_, model_proto_);
+  auto status = session_options.use_mmap_initializers
+                    ? Model::LoadWithMappedInitializers(model_location_, model_proto_)
+                    : Model::Load(model_location_, model_proto_);
   ORT_ENFORCE(status.IsOK(), "Given model could not be parsed while creating inference session. Error message: ",
               status.ErrorMessage());
   is_model_proto_parsed_ = true;
@@ -262,7 +423,7 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
                                    std::istream& model_istream)
     : graph_transformation_mgr_(session_options.max_num_graph_transformation_steps),
       logging_manager_(session_env.GetLoggingManager()),
-      insert_cast_transformer_("CastFloat16Transformer") {
+      insert_cast_transformer_("CastFloat16Transformer", !MlasHalfGemmIsNative()) {
   Status st = Model::Load(model_istream, &model_proto_);
   ORT_ENFORCE(st.IsOK(), "Could not parse model successfully while constructing the inference session");
   is_model_proto_parsed_ = true;
@@ -274,7 +435,7 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
                                    const void* model_data, int model_data_len)
     : graph_transformation_mgr_(session_options.max_num_graph_transformation_steps),
       logging_manager_(session_env.GetLoggingManager()),
-      insert_cast_transformer_("CastFloat16Transformer") {
+      insert_cast_transformer_("CastFloat16Transformer", !MlasHalfGemmIsNative()) {
   const bool result = model_proto_.ParseFromArray(model_data, model_data_len);
   ORT_ENFORCE(result, "Could not parse model successfully while constructing the inference session");
   is_model_proto_parsed_ = true;
@@ -283,6 +444,25 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 }
 
 InferenceSession::~InferenceSession() {
+  // finish the queued RunAsync requests while the session is still intact
+  async_run_queue_.reset();
+
+  if (parallel_for_cost_table_ != nullptr && session_options_.calibrate_parallel_for_cost &&
+      !session_options_.parallel_for_cost_table_file.empty()) {
+    auto save_status = parallel_for_cost_table_->Save(session_options_.parallel_for_cost_table_file);
+    if (!save_status.IsOK()) {
+      LOGS(*session_logger_, ERROR) << "Failed to save the ParallelFor cost table: " << save_status.ErrorMessage();
+    }
+  }
+
+  if (session_state_ != nullptr) {
+    auto in_place_stats = session_state_->GetInPlaceReuseStats();
+    if (in_place_stats.num_reuses > 0) {
+      LOGS(*session_logger_, INFO) << "In-place output allocations: " << in_place_stats.num_reuses
+                                   << ", bytes saved: " << in_place_stats.bytes_saved;
+    }
+  }
+
   if (session_options_.enable_profiling) {
     try {
       EndProfiling();
@@ -443,6 +623,12 @@ common::Status InferenceSession::Load(const std::basic_string<T>& model_uri) {
       ORT_RETURN_IF_ERROR(AddCustomOpDomains({domain.get()}));
     }
 #endif
+    if (session_options_.use_mmap_initializers) {
+      ModelProto model_proto;
+      ORT_RETURN_IF_ERROR(Model::LoadWithMappedInitializers(model_location_, model_proto));
+      return onnxruntime::Model::Load(std::move(model_proto), model_location_, model,
+                                      HasLocalSchema() ? &custom_schema_registries_ : nullptr, *session_logger_);
+    }
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
                                     *session_logger_);
   };
@@ -598,6 +784,18 @@ common::Status InferenceSession::Load() {
   return Load(loader, "model_loading_from_saved_proto");
 }
 
+// Lists the copies between devices in the graph and its subgraphs, as "<op type> (<copied value>)".
+static void CollectMemcpyNodes(const Graph& graph, std::vector<std::string>& memcpy_nodes) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "MemcpyFromHost" || node.OpType() == "MemcpyToHost") {
+      memcpy_nodes.push_back(node.OpType() + " (" + node.InputDefs()[0]->Name() + ")");
+    }
+    for (const auto* subgraph : node.GetSubgraphs()) {
+      CollectMemcpyNodes(*subgraph, memcpy_nodes);
+    }
+  }
+}
+
 common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
                                                 const onnxruntime::GraphTransformerManager& graph_transformer_mgr,
                                                 const ExecutionProviders& providers,
@@ -633,7 +831,8 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
 #endif
 
   // Do partitioning based on execution providers' capability.
-  GraphPartitioner partitioner(kernel_registry_manager, providers);
+  GraphPartitioner partitioner(kernel_registry_manager, providers, session_options_.graph_partitioning_mode,
+                               &node_placement_overrides_);
   ORT_RETURN_IF_ERROR_SESSIONID_(partitioner.Partition(graph, session_state.ExportDll(),
                                                        session_state.GetMutableFuncMgr()));
 
@@ -698,6 +897,16 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   MemcpyTransformer copy_transformer{provider_types, kernel_registry_manager};
   ORT_RETURN_IF_ERROR_SESSIONID_(copy_transformer.Apply(graph, modified, *session_logger_));
 
+  // report the copies between the devices, as each of them costs a synchronization and a transfer in every run
+  std::vector<std::string> memcpy_nodes;
+  CollectMemcpyNodes(graph, memcpy_nodes);
+  if (!memcpy_nodes.empty()) {
+    std::ostringstream all_nodes_str;
+    std::copy(memcpy_nodes.begin(), memcpy_nodes.end(), std::ostream_iterator<std::string>(all_nodes_str, ", "));
+    LOGS(*session_logger_, INFO) << "Inserted " << memcpy_nodes.size() << " Memcpy nodes: [" << all_nodes_str.str()
+                                 << "]";
+  }
+
   return common::Status::OK();
 }
 
@@ -722,6 +931,14 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
 
       // Pass fused function manager to subgraph
       subgraph_session_state->GetMutableFuncMgr().SetFusedFuncs(session_state.GetFuncMgr());
+      subgraph_session_state->SetUseRunScopedArena(session_state.GetUseRunScopedArena());
+      subgraph_session_state->SetCreateKernelsOnFirstUse(session_state.GetCreateKernelsOnFirstUse());
+      subgraph_session_state->SetProfileMemory(session_state.GetProfileMemory());
+      subgraph_session_state->SetProfileHardwareCounters(session_state.GetProfileHardwareCounters());
+      subgraph_session_state->SetSharedInitializerRegistry(session_state.GetSharedInitializerRegistry());
+      subgraph_session_state->SetMemoryPatternCacheOptions(session_state.GetMemoryPatternBucketing(),
+                                                           session_state.GetMemoryPatternBucketMultiple(),
+                                                           session_state.GetMemoryPatternCacheMaxEntries());
 
       // recurse
       ORT_RETURN_IF_ERROR_SESSIONID_(CreateSubgraphSessionState(*subgraph, *subgraph_session_state));
@@ -761,26 +978,157 @@ common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, Sessio
       SessionState* subgraph_session_state = session_state.GetMutableSubgraphSessionState(node.Index(), name);
       ORT_ENFORCE(subgraph_session_state, "CreateSubgraphSessionState should have created an entry earlier.");
 
-      ORT_RETURN_IF_ERROR_SESSIONID_(FinalizeSessionState(*subgraph_session_state, model_location_,
-                                                          kernel_registry_manager_, &node,
-                                                          session_options_.execution_mode));
-
-      // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
-      //                                                   &*subgraph_info.session_state);
+      if (session_options_.enable_lazy_initialization) {
+        // run by the control flow kernel when it first runs the subgraph, see OpKernelContextInternal
+        subgraph_session_state->SetDeferredInitialization(
+            [this, &node, name, &subgraph, &session_state, subgraph_session_state]() {
+              return InitializeSubgraphSession(node, name, subgraph, session_state, *subgraph_session_state);
+            });
+        continue;
+      }
 
-      // setup all the info for handling the feeds and fetches used in subgraph execution
-      auto* p_op_kernel = session_state.GetMutableKernel(node.Index());
-      ORT_ENFORCE(p_op_kernel);
-      // Downcast is safe, since only control flow nodes have subgraphs (node.GetAttributeNameToMutableSubgraphMap() is non-empty)
-      auto& control_flow_kernel = static_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
       ORT_RETURN_IF_ERROR_SESSIONID_(
-          control_flow_kernel.SetupSubgraphExecutionInfo(session_state, name, *subgraph_session_state));
+          InitializeSubgraphSession(node, name, subgraph, session_state, *subgraph_session_state));
+    }
+  }
 
-      // recurse
-      ORT_RETURN_IF_ERROR_SESSIONID_(InitializeSubgraphSessions(subgraph, *subgraph_session_state));
+  return Status::OK();
+}
+
+common::Status InferenceSession::InitializeSubgraphSession(const Node& node, const std::string& attribute_name,
+                                                           Graph& subgraph, SessionState& session_state,
+                                                           SessionState& subgraph_session_state) {
+  ORT_RETURN_IF_ERROR_SESSIONID_(FinalizeSessionState(subgraph_session_state, model_location_,
+                                                      kernel_registry_manager_, &node,
+                                                      session_options_.execution_mode,
+                                                      session_options_.execution_order));
+
+  // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
+  //                                                   &*subgraph_info.session_state);
+
+  // setup all the info for handling the feeds and fetches used in subgraph execution
+  auto* p_op_kernel = session_state.GetMutableKernel(node.Index());
+  ORT_ENFORCE(p_op_kernel);
+  // Downcast is safe, since only control flow nodes have subgraphs (node.GetAttributeNameToMutableSubgraphMap() is non-empty)
+  auto& control_flow_kernel = static_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
+  ORT_RETURN_IF_ERROR_SESSIONID_(
+      control_flow_kernel.SetupSubgraphExecutionInfo(session_state, attribute_name, subgraph_session_state));
+
+  // recurse
+  ORT_RETURN_IF_ERROR_SESSIONID_(InitializeSubgraphSessions(subgraph, subgraph_session_state));
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::CreateSpecializedGraph(const std::map<std::string, TensorShape>& input_shapes,
+                                                        SpecializedGraph& specialized_graph) {
+  ONNX_NAMESPACE::ModelProto model_proto(*specialization_model_proto_);
+  for (auto& input : *model_proto.mutable_graph()->mutable_input()) {
+    auto input_shape = input_shapes.find(input.name());
+    if (input_shape == input_shapes.end()) {
+      continue;
+    }
+
+    auto* shape = input.mutable_type()->mutable_tensor_type()->mutable_shape();
+    shape->clear_dim();
+    for (auto dim : input_shape->second.GetDims()) {
+      shape->add_dim()->set_dim_value(dim);
     }
   }
 
+  ORT_RETURN_IF_ERROR_SESSIONID_(Model::Load(std::move(model_proto), model_location_, specialized_graph.model,
+                                             HasLocalSchema() ? &custom_schema_registries_ : nullptr,
+                                             *session_logger_));
+  Graph& graph = specialized_graph.model->MainGraph();
+
+  specialized_graph.session_state = onnxruntime::make_unique<SessionState>(
+      graph,
+      execution_providers_,
+      session_options_.enable_mem_pattern && session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL,
+      GetIntraOpThreadPoolToUse(),
+      GetInterOpThreadPoolToUse(),
+      data_transfer_mgr_,
+      *session_logger_,
+      session_profiler_,
+      session_options_.use_deterministic_compute);
+  SessionState& session_state = *specialized_graph.session_state;
+  session_state.SetUseRunScopedArena(session_options_.enable_run_scoped_arena);
+  session_state.SetCreateKernelsOnFirstUse(session_options_.enable_lazy_initialization);
+  session_state.SetProfileMemory(session_options_.enable_memory_profiling);
+  session_state.SetProfileHardwareCounters(session_options_.enable_hardware_counters);
+  session_state.SetSharedInitializerRegistry(shared_initializer_registry_);
+  session_state.SetMemoryPatternCacheOptions(session_options_.mem_pattern_bucketing,
+                                             session_options_.mem_pattern_bucket_multiple,
+                                             session_options_.mem_pattern_cache_max_entries);
+
+  // the concrete input shapes let the shape inference of Resolve propagate static shapes through the graph, so the
+  // transformers can fold the shape computations
+  ORT_RETURN_IF_ERROR_SESSIONID_(CreateSubgraphSessionState(graph, session_state));
+  ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_, execution_providers_,
+                                                kernel_registry_manager_, insert_cast_transformer_, session_state));
+  ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
+
+  ORT_RETURN_IF_ERROR_SESSIONID_(FinalizeSessionState(session_state, model_location_, kernel_registry_manager_,
+                                                      nullptr, session_options_.execution_mode,
+                                                      session_options_.execution_order));
+  ORT_RETURN_IF_ERROR_SESSIONID_(InitializeSubgraphSessions(graph, session_state));
+  session_state.ResolveMemoryPatternFlag();
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetSpecializedGraph(const std::vector<std::string>& feed_names,
+                                                     const std::vector<OrtValue>& feeds,
+                                                     std::shared_ptr<SpecializedGraph>& specialized_graph) {
+  // the signature is the shapes of the inputs with free dimensions, ordered by name
+  std::map<std::string, TensorShape> input_shapes;
+  for (size_t i = 0; i < feed_names.size(); ++i) {
+    if (free_dim_inputs_.count(feed_names[i]) == 0) {
+      continue;
+    }
+    if (!feeds[i].IsTensor()) {
+      return Status::OK();
+    }
+    input_shapes.emplace(feed_names[i], feeds[i].Get<Tensor>().Shape());
+  }
+
+  std::ostringstream signature;
+  for (const auto& input_shape : input_shapes) {
+    signature << input_shape.first << input_shape.second << ";";
+  }
+  const std::string key = signature.str();
+
+  // the graph is created while holding the lock, so the runs with new shapes are specialized one at a time
+  std::lock_guard<onnxruntime::OrtMutex> l(specialization_mutex_);
+  auto entry = specialized_graph_index_.find(key);
+  if (entry != specialized_graph_index_.end()) {
+    specialized_graphs_.splice(specialized_graphs_.begin(), specialized_graphs_, entry->second);
+    specialized_graph = entry->second->second;
+    return Status::OK();
+  }
+
+  LOGS(*session_logger_, INFO) << "Specializing the graph to the input shapes " << key;
+  auto new_graph = std::make_shared<SpecializedGraph>();
+  Status status;
+  try {
+    status = CreateSpecializedGraph(input_shapes, *new_graph);
+  } catch (const std::exception& ex) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+  }
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to specialize the graph to the input shapes " << key
+                                    << ". Running the main graph for them. " << status.ErrorMessage();
+    new_graph = nullptr;
+  }
+
+  specialized_graphs_.emplace_front(key, new_graph);
+  specialized_graph_index_[key] = specialized_graphs_.begin();
+  if (specialized_graphs_.size() > session_options_.shape_specialization_cache_size) {
+    specialized_graph_index_.erase(specialized_graphs_.back().first);
+    specialized_graphs_.pop_back();
+  }
+
+  specialized_graph = std::move(new_graph);
   return Status::OK();
 }
 
@@ -829,6 +1177,53 @@ static bool ModelHasFP16Inputs(const Graph& graph) {
   return false;
 }
 
+common::Status InferenceSession::ConvertZipMapOutputsToColumnar(Graph& graph) {
+  std::vector<NodeIndex> zipmap_nodes;
+  for (const auto& node : graph.Nodes()) {
+    // a ZipMap output also consumed by other nodes keeps its type
+    if (node.OpType() == "ZipMap" && node.Domain() == kMLDomain && graph.IsOutput(node.OutputDefs()[0]) &&
+        node.GetOutputEdgesCount() == 0 && node.InputDefs()[0]->TypeAsProto() != nullptr) {
+      zipmap_nodes.push_back(node.Index());
+    }
+  }
+
+  for (NodeIndex index : zipmap_nodes) {
+    Node& node = *graph.GetNode(index);
+    NodeArg* input = node.MutableInputDefs()[0];
+    NodeArg* output = node.MutableOutputDefs()[0];
+
+    ColumnarMapKeys keys;
+    const auto& attributes = node.GetAttributes();
+    auto int64_keys = attributes.find("classlabels_int64s");
+    if (int64_keys != attributes.cend()) {
+      keys.int64_keys.assign(int64_keys->second.ints().cbegin(), int64_keys->second.ints().cend());
+    }
+    auto string_keys = attributes.find("classlabels_strings");
+    if (string_keys != attributes.cend()) {
+      keys.string_keys.assign(string_keys->second.strings().cbegin(), string_keys->second.strings().cend());
+    }
+
+    const std::string name = node.Name();
+    graph.RemoveNode(index);
+    // the output keeps its name, so the callers fetch it as before
+    graph.SetNodeArgType(*output, *input->TypeAsProto());
+    graph.AddNode(name, "Identity", "Output of ZipMap as a tensor", {input}, {output});
+    columnar_map_output_keys_[output->Name()] = std::move(keys);
+  }
+
+  if (!zipmap_nodes.empty()) {
+    graph.SetGraphProtoSyncNeeded();
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+  return Status::OK();
+}
+
+const InferenceSession::ColumnarMapKeys* InferenceSession::GetColumnarMapOutputKeys(
+    const std::string& output_name) const {
+  auto it = columnar_map_output_keys_.find(output_name);
+  return it != columnar_map_output_keys_.cend() ? &it->second : nullptr;
+}
+
 common::Status InferenceSession::Initialize() {
   Status status = Status::OK();
   TimePoint tp;
@@ -859,11 +1254,47 @@ common::Status InferenceSession::Initialize() {
       have_cpu_ep = execution_providers_.Get(onnxruntime::kCpuExecutionProvider) != nullptr;
     }
 
+    // the kernels of the default CPU execution provider read their packed weights from the store or record them
+    // to it, so the store is set up before the kernels are created and a recording store is saved once they all are
+    std::shared_ptr<PrepackedWeightsStore> prepacked_weights_store;
+    if (session_options_.use_saved_prepacked_weights) {
+      if (model_location_.empty()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "use_saved_prepacked_weights requires the model to be loaded from a file.");
+      }
+      const auto& metadata = model_->MetaData();
+      const auto model_id = metadata.find(kPrepackedWeightsModelIdMetadataKey);
+      std::unique_ptr<PrepackedWeightsStore> loaded_store;
+      ORT_RETURN_IF_ERROR_SESSIONID_(PrepackedWeightsStore::Load(
+          model_location_ + ORT_TSTR(".prepacked"), model_id != metadata.cend() ? model_id->second : std::string(),
+          loaded_store));
+      if (loaded_store == nullptr) {
+        LOGS(*session_logger_, WARNING) << "The prepacked weights of the model were saved on a processor with other "
+                                           "packing formats. The weights are packed again.";
+      }
+      prepacked_weights_store = std::move(loaded_store);
+    } else if (session_options_.save_prepacked_weights && !session_options_.optimized_model_filepath.empty()) {
+      if (session_options_.enable_lazy_initialization) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "save_prepacked_weights requires the kernels to be created by Initialize, so it can't "
+                               "be combined with enable_lazy_initialization.");
+      }
+      prepacked_weights_store = std::make_shared<PrepackedWeightsStore>();
+    }
+
     // Register default CPUExecutionProvider if user didn't provide it through the Register() calls.
     // RegisterExecutionProvider locks the session_mutex_ so we can't be holding it when we call that
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
-      CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena,
+                                   session_options_.enable_cpu_mem_arena_thread_cache};
+      // keep the memory local to the threads running the kernels
+      epi.numa_node = session_options_.intra_op_param.numa_node;
+      epi.use_huge_pages = session_options_.enable_cpu_mem_arena_huge_pages;
+      epi.enable_bf16_gemm = session_options_.enable_cpu_bf16_gemm;
+      epi.enable_sparse_gemm = session_options_.enable_cpu_sparse_gemm;
+      epi.share_prepacked_weights = session_options_.share_prepacked_weights;
+      epi.prepacked_weights_store = prepacked_weights_store;
       auto p_cpu_exec_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
@@ -887,6 +1318,14 @@ common::Status InferenceSession::Initialize() {
         *session_logger_,
         session_profiler_,
         session_options_.use_deterministic_compute);
+    session_state_->SetUseRunScopedArena(session_options_.enable_run_scoped_arena);
+    session_state_->SetCreateKernelsOnFirstUse(session_options_.enable_lazy_initialization);
+    session_state_->SetProfileMemory(session_options_.enable_memory_profiling);
+    session_state_->SetProfileHardwareCounters(session_options_.enable_hardware_counters);
+    session_state_->SetSharedInitializerRegistry(shared_initializer_registry_);
+    session_state_->SetMemoryPatternCacheOptions(session_options_.mem_pattern_bucketing,
+                                                 session_options_.mem_pattern_bucket_multiple,
+                                                 session_options_.mem_pattern_cache_max_entries);
 
     if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL &&
         execution_providers_.Get(onnxruntime::kCudaExecutionProvider)) {
@@ -913,19 +1352,90 @@ common::Status InferenceSession::Initialize() {
     // Register 2nd registries into KernelRegistryManager.
     ORT_RETURN_IF_ERROR_SESSIONID_(kernel_registry_manager_.RegisterKernels(execution_providers_));
 
+    // keep the graph before the transformations to specialize it to the input shapes of the runs
+    if (session_options_.shape_specialization_cache_size > 0 && !session_options_.use_saved_node_placements) {
+      for (const auto* input : graph.GetInputs()) {
+        const auto* type = input->TypeAsProto();
+        if (type == nullptr || !type->has_tensor_type()) {
+          continue;
+        }
+
+        const auto* shape = input->Shape();
+        bool has_free_dims = shape == nullptr;
+        for (int i = 0; !has_free_dims && i < shape->dim_size(); ++i) {
+          has_free_dims = !shape->dim(i).has_dim_value();
+        }
+        if (has_free_dims) {
+          free_dim_inputs_.insert(input->Name());
+        }
+      }
+
+      if (!free_dim_inputs_.empty()) {
+        specialization_model_proto_ = onnxruntime::make_unique<ONNX_NAMESPACE::ModelProto>(model_->ToProto());
+      }
+    }
+
     // create SessionState for subgraphs as it's needed by the transformers
     ORT_RETURN_IF_ERROR_SESSIONID_(CreateSubgraphSessionState(graph, *session_state_));
 
-    // apply any transformations to the main graph and any subgraphs
-    ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
-                                                  execution_providers_, kernel_registry_manager_,
-                                                  insert_cast_transformer_,
-                                                  *session_state_));
+    if (!session_options_.graph_partitioning_override_file.empty()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(GraphPartitioner::LoadPlacementOverrides(
+          session_options_.graph_partitioning_override_file, node_placement_overrides_));
+      for (const auto& placement_override : node_placement_overrides_) {
+        if (execution_providers_.Get(placement_override.second) == nullptr) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The graph partitioning override file places the node ",
+                                 placement_override.first, " on ", placement_override.second,
+                                 " which is not registered in the session");
+        }
+      }
+    }
+
+    if (session_options_.columnar_zipmap_outputs) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(ConvertZipMapOutputsToColumnar(graph));
+    }
+
+    const auto nchwc_block_size = model_->MetaData().find(kNchwcBlockSizeMetadataKey);
+    if (nchwc_block_size != model_->MetaData().cend() &&
+        nchwc_block_size->second != std::to_string(MlasNchwcGetBlockSize())) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The model was optimized for an NCHWc block size of ",
+                             nchwc_block_size->second, " but this processor uses ", MlasNchwcGetBlockSize(),
+                             ". Optimize the model again on this processor.");
+    }
+
+    if (session_options_.use_saved_node_placements) {
+      // the model was optimized and partitioned by the session that saved it, so only the node placements are
+      // restored
+      const auto& metadata = model_->MetaData();
+      const auto node_placements = metadata.find(kNodePlacementsMetadataKey);
+      if (node_placements == metadata.cend()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "The model has no saved node placements. It must be an optimized model saved by a "
+                               "session with save_node_placements set.");
+      }
+      ORT_RETURN_IF_ERROR_SESSIONID_(ApplyNodePlacements(graph, node_placements->second, execution_providers_));
+    } else {
+      // apply any transformations to the main graph and any subgraphs
+      ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
+                                                    execution_providers_, kernel_registry_manager_,
+                                                    insert_cast_transformer_,
+                                                    *session_state_));
+    }
 
     // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
     ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
 
     if (!session_options_.optimized_model_filepath.empty()) {
+      if (session_options_.save_node_placements) {
+        std::string node_placements;
+        ORT_RETURN_IF_ERROR_SESSIONID_(SaveNodePlacements(graph, node_placements));
+        model_->SetMetaDataEntry(kNodePlacementsMetadataKey, node_placements);
+      }
+      if (HasNchwcNodes(graph)) {
+        model_->SetMetaDataEntry(kNchwcBlockSizeMetadataKey, std::to_string(MlasNchwcGetBlockSize()));
+      }
+      if (prepacked_weights_store != nullptr && !prepacked_weights_store->IsLoaded()) {
+        model_->SetMetaDataEntry(kPrepackedWeightsModelIdMetadataKey, prepacked_weights_store->ModelId());
+      }
       // Serialize optimized ONNX model.
       ORT_RETURN_IF_ERROR_SESSIONID_(Model::Save(*model_, session_options_.optimized_model_filepath));
       if (session_options_.graph_optimization_level >= TransformerLevel::Level3) {
@@ -938,11 +1448,50 @@ common::Status InferenceSession::Initialize() {
     }
 
     ORT_RETURN_IF_ERROR_SESSIONID_(FinalizeSessionState(*session_state_, model_location_, kernel_registry_manager_,
-                                                        nullptr, session_options_.execution_mode));
+                                                        nullptr, session_options_.execution_mode,
+                                                      session_options_.execution_order));
 
     // handle any subgraphs
     ORT_RETURN_IF_ERROR_SESSIONID_(InitializeSubgraphSessions(graph, *session_state_));
     session_state_->ResolveMemoryPatternFlag();
+
+    // all the kernels, including those of the subgraphs, have packed their weights
+    if (prepacked_weights_store != nullptr && !prepacked_weights_store->IsLoaded()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(prepacked_weights_store->Save(session_options_.optimized_model_filepath +
+                                                                   ORT_TSTR(".prepacked")));
+    }
+
+    // Replaying the graph captured by a provider only performs the whole run if the provider executes all the
+    // nodes, and no control flow node decides on the host which kernels to run.
+    for (auto& xp : execution_providers_) {
+      if (!xp->IsGraphCaptureEnabled()) {
+        continue;
+      }
+
+      bool can_capture_graph = true;
+      for (const auto& node : graph.Nodes()) {
+        if (node.GetExecutionProviderType() != xp->Type() || node.ContainsSubgraph()) {
+          can_capture_graph = false;
+          break;
+        }
+      }
+
+      if (can_capture_graph) {
+        graph_capture_provider_ = xp.get();
+      } else {
+        LOGS(*session_logger_, WARNING) << "Graph capture is enabled for " << xp->Type()
+                                        << " but not all the nodes of the model are assigned to it or the model"
+                                           " contains control flow nodes. Running without graph capture.";
+      }
+      break;
+    }
+
+    // the graph is final, so the node indices of the statistics stay valid
+    if (session_options_.enable_node_stats) {
+      session_profiler_.EnableNodeStats(static_cast<size_t>(graph.MaxNodeIndex()));
+      session_state_->SetCollectNodeStats(true);
+    }
+
     is_inited_ = true;
 
     // and log telemetry
@@ -983,6 +1532,21 @@ int InferenceSession::GetCurrentNumRuns() const {
   return current_num_runs_.load();
 }
 
+common::Status InferenceSession::ShrinkMemoryArenas() {
+  // a captured graph refers to the memory that is released
+  ++graph_capture_generation_;
+
+  for (const auto& xp : execution_providers_) {
+    for (const auto& allocator : xp->GetAllocators()) {
+      if (allocator->Info().alloc_type == OrtArenaAllocator) {
+        ORT_RETURN_IF_ERROR(static_cast<IArenaAllocator*>(allocator.get())->Shrink());
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 const std::vector<std::string>& InferenceSession::GetRegisteredProviderTypes() const {
   return execution_providers_.GetIds();
 }
@@ -1055,45 +1619,51 @@ common::Status InferenceSession::ValidateInputs(const std::vector<std::string>&
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
     }
 
-    auto expected_type = iter->second.ml_data_type;
-    auto& input_ml_value = feeds.at(i);
-    if (input_ml_value.IsTensor()) {
-      // check for type
-      if (!expected_type->IsTensorType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type tensor.");
-      }
-      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
-      auto input_element_type = input_ml_value.Get<Tensor>().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
-
-      // check for shape
-      const auto& expected_shape = iter->second.tensor_shape;
-      if (expected_shape.NumDimensions() > 0) {
-        const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
-        ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
-      }
-    } else if (input_ml_value.IsSparseTensor()) {
-      if (!expected_type->IsSparseTensorType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type sparse tensor.");
-      }
-      auto expected_element_type = expected_type->AsSparseTensorType()->GetElementType();
-      auto input_element_type = input_ml_value.Get<SparseTensor>().Values().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
-      // TODO: In the future, when sparsetensors are in use, find out how to properly verify the shape
-    } else if (input_ml_value.IsTensorSequence()) {
-      if (!expected_type->IsTensorSequenceType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type tensor sequence.");
-      }
-      auto expected_element_type = expected_type->AsSequenceTensorBase()->GetElementType();
-      auto input_element_type = input_ml_value.Get<TensorSeq>().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
-    } else {
-      auto input_type = input_ml_value.Type();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_type, expected_type));
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInput(feed_name, iter->second, feeds[i]));
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidateInput(const std::string& feed_name, const InputDefMetaData& input_def,
+                                               const OrtValue& input_ml_value) const {
+  auto expected_type = input_def.ml_data_type;
+  if (input_ml_value.IsTensor()) {
+    // check for type
+    if (!expected_type->IsTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type tensor.");
     }
+    auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+    auto input_element_type = input_ml_value.Get<Tensor>().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
+
+    // check for shape
+    const auto& expected_shape = input_def.tensor_shape;
+    if (expected_shape.NumDimensions() > 0) {
+      const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
+      ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
+    }
+  } else if (input_ml_value.IsSparseTensor()) {
+    if (!expected_type->IsSparseTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type sparse tensor.");
+    }
+    auto expected_element_type = expected_type->AsSparseTensorType()->GetElementType();
+    auto input_element_type = input_ml_value.Get<SparseTensor>().Values().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
+    // TODO: In the future, when sparsetensors are in use, find out how to properly verify the shape
+  } else if (input_ml_value.IsTensorSequence()) {
+    if (!expected_type->IsTensorSequenceType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type tensor sequence.");
+    }
+    auto expected_element_type = expected_type->AsSequenceTensorBase()->GetElementType();
+    auto input_element_type = input_ml_value.Get<TensorSeq>().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
+  } else {
+    auto input_type = input_ml_value.Type();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_type, expected_type));
   }
 
   return Status::OK();
@@ -1127,13 +1697,108 @@ common::Status InferenceSession::ValidateOutputs(const std::vector<std::string>&
   return common::Status::OK();
 }
 
+common::Status InferenceSession::PrepareRun(const std::vector<std::string>& feed_names,
+                                            const std::vector<std::string>& output_names,
+                                            std::unique_ptr<PreparedRun>& prepared_run) const {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  std::vector<const InputDefMetaData*> input_defs;
+  input_defs.reserve(feed_names.size());
+  for (const auto& feed_name : feed_names) {
+    auto iter = input_def_map_.find(feed_name);
+    if (input_def_map_.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
+    }
+    input_defs.push_back(&iter->second);
+  }
+
+  const std::vector<OrtValue> no_fetches;
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, &no_fetches));
+
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+  ORT_RETURN_IF_ERROR_SESSIONID_(FeedsFetchesManager::Create(feed_names, output_names,
+                                                             session_state_->GetOrtValueNameIdxMap(),
+                                                             feeds_fetches_manager));
+  ORT_RETURN_IF_ERROR_SESSIONID_(utils::InitializeFeedFetchCopyInfo(*session_state_, *feeds_fetches_manager));
+
+  // private constructor, can't use make_unique
+  prepared_run = std::unique_ptr<PreparedRun>(new PreparedRun(*this, std::move(input_defs),
+                                                              std::move(feeds_fetches_manager)));
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidatePreparedRun(const PreparedRun& prepared_run,
+                                                     const std::vector<OrtValue>& feeds,
+                                                     const std::vector<OrtValue>* p_fetches) const {
+  if (&prepared_run.session_ != this) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The prepared run was created by another session.");
+  }
+
+  const auto& feed_names = prepared_run.GetFeedNames();
+  if (feed_names.size() != feeds.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Size mismatch: the prepared run has ", feed_names.size(),
+                           " inputs, but feeds has ", feeds.size(), " elements.");
+  }
+
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInput(feed_names[i], *prepared_run.input_defs_[i], feeds[i]));
+  }
+
+  // the output names were validated by PrepareRun
+  if (p_fetches == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
+  }
+
+  const auto num_outputs = prepared_run.GetOutputNames().size();
+  if (!p_fetches->empty() && (num_outputs != p_fetches->size())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output vector incorrectly sized: the prepared run has ",
+                           num_outputs, " outputs, p_fetches->size(): ", p_fetches->size());
+  }
+
+  return Status::OK();
+}
+
 Status InferenceSession::Run(const RunOptions& run_options,
                              const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
                              const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  return RunImpl(run_options, nullptr, feed_names, feeds, output_names, p_fetches, p_fetches_device_info);
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                                     const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches) {
+  return RunImpl(run_options, &prepared_run, prepared_run.GetFeedNames(), feeds, prepared_run.GetOutputNames(),
+                 p_fetches, nullptr);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options, const PreparedRun* prepared_run,
+                                 const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                                 const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info) {
+  const auto run_start = std::chrono::high_resolution_clock::now();
   TimePoint tp;
+  concurrency::ThreadPoolSpinStats spin_stats_at_start;
+  std::vector<concurrency::ThreadPoolWorkerStats> intra_op_stats_at_start;
+  std::vector<concurrency::ThreadPoolWorkerStats> inter_op_stats_at_start;
+  auto* intra_tp = GetIntraOpThreadPoolToUse();
+  auto* inter_tp = GetInterOpThreadPoolToUse();
+  if (inter_tp == intra_tp) {
+    inter_tp = nullptr;
+  }
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.StartTime();
+    if (intra_tp) {
+      spin_stats_at_start = intra_tp->GetSpinStats();
+      intra_tp->SetProfiling(true);
+      intra_op_stats_at_start = intra_tp->GetWorkerStats();
+    }
+    if (inter_tp) {
+      inter_tp->SetProfiling(true);
+      inter_op_stats_at_start = inter_tp->GetWorkerStats();
+    }
   }
 
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
@@ -1162,22 +1827,45 @@ Status InferenceSession::Run(const RunOptions& run_options,
       telemetry_.isEvaluationStart = true;
     }
 
-    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
-    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
-
-    FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
-
-    if (p_fetches_device_info) {
-      // populate the target device info. ignored if pre-allocated fetches are provided
-      const auto& fetch_device_info = *p_fetches_device_info;
-      auto& fetch_info = feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo();
+    if (prepared_run != nullptr) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(ValidatePreparedRun(*prepared_run, feeds, p_fetches));
+    } else {
+      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+    }
 
-      for (size_t i = 0, end = output_names.size(); i < end; ++i) {
-        fetch_info[i].target_device = fetch_device_info[i];
+    // the graph specialized to the input shapes if any, otherwise the main graph.
+    // a captured graph is replayed for the shapes it was captured with instead.
+    std::shared_ptr<SpecializedGraph> specialized_graph;
+    if (specialization_model_proto_ != nullptr && graph_capture_provider_ == nullptr) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(GetSpecializedGraph(feed_names, feeds, specialized_graph));
+    }
+    SessionState& session_state = specialized_graph != nullptr ? *specialized_graph->session_state : *session_state_;
+
+    // the feeds and fetches of a prepared run were resolved by PrepareRun against the main graph, otherwise resolve
+    // them for this call
+    const bool use_prepared_feeds_fetches = prepared_run != nullptr && specialized_graph == nullptr;
+    std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+    if (!use_prepared_feeds_fetches) {
+      FeedsFetchesInfo info(feed_names, output_names, session_state.GetOrtValueNameIdxMap());
+      feeds_fetches_manager = onnxruntime::make_unique<FeedsFetchesManager>(std::move(info));
+
+      if (p_fetches_device_info) {
+        // populate the target device info. ignored if pre-allocated fetches are provided
+        const auto& fetch_device_info = *p_fetches_device_info;
+        auto& fetch_info = feeds_fetches_manager->GetMutableFetchesDeviceCopyInfo();
+
+        for (size_t i = 0, end = output_names.size(); i < end; ++i) {
+          fetch_info[i].target_device = fetch_device_info[i];
+        }
       }
     }
 
+    const auto& fetches_mlvalue_idxs =
+        use_prepared_feeds_fetches
+            ? prepared_run->feeds_fetches_manager_->GetFeedsFetchesInfo().fetches_mlvalue_idxs
+            : feeds_fetches_manager->GetFeedsFetchesInfo().fetches_mlvalue_idxs;
+
     if (!run_options.run_tag.empty()) {
       LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
     }
@@ -1191,28 +1879,52 @@ Status InferenceSession::Run(const RunOptions& run_options,
     std::unique_ptr<logging::Logger> owned_run_logger;
     auto run_logger = CreateLoggerForRun(run_options, owned_run_logger);
 
-    // info all execution providers InferenceSession:Run started
-    // TODO: only call OnRunStart for all providers in-use
-    for (auto& xp : execution_providers_) {
-      // call OnRunStart and add to exec_providers_to_stop if successful
-      auto start_func = [&xp, &exec_providers_to_stop]() {
-        auto status = xp->OnRunStart();
-        if (status.IsOK())
-          exec_providers_to_stop.push_back(xp.get());
-
-        return status;
-      };
-
-      ORT_CHECK_AND_SET_RETVAL(start_func());
+    uint64_t graph_run_signature = 0;
+    if (graph_capture_provider_ != nullptr && !run_options.only_execute_path_to_fetches) {
+      graph_run_signature = ComputeGraphRunSignature(feed_names, feeds, output_names, *p_fetches,
+                                                     graph_capture_generation_);
     }
 
-    if (run_options.only_execute_path_to_fetches) {
-      session_state_->UpdateToBeExecutedNodes(feeds_fetches_manager.GetFeedsFetchesInfo().fetches_mlvalue_idxs);
+    if (graph_capture_provider_ != nullptr && graph_capture_provider_->PrepareGraphReplay(graph_run_signature)) {
+      // the provider captured the kernels of a run with the same feeds and fetches
+      ORT_CHECK_AND_SET_RETVAL(graph_capture_provider_->ReplayGraph());
+    } else {
+      // info all execution providers InferenceSession:Run started
+      // TODO: only call OnRunStart for all providers in-use
+      for (auto& xp : execution_providers_) {
+        // call OnRunStart and add to exec_providers_to_stop if successful
+        auto start_func = [&xp, &exec_providers_to_stop]() {
+          auto status = xp->OnRunStart();
+          if (status.IsOK())
+            exec_providers_to_stop.push_back(xp.get());
+
+          return status;
+        };
+
+        ORT_CHECK_AND_SET_RETVAL(start_func());
+      }
+
+      // a Run that requests only some of the graph outputs executes only the nodes they depend on. the fetches are
+      // validated to be graph outputs, so fewer fetches than outputs means some aren't needed.
+      const bool only_execute_path_to_fetches =
+          run_options.only_execute_path_to_fetches ||
+          (session_options_.prune_to_requested_fetches &&
+           fetches_mlvalue_idxs.size() < model_output_names_.size());
+      if (only_execute_path_to_fetches) {
+        session_state.UpdateToBeExecutedNodes(fetches_mlvalue_idxs);
+      }
+      // execute the graph
+      if (use_prepared_feeds_fetches) {
+        ORT_CHECK_AND_SET_RETVAL(utils::ExecutePreparedGraph(session_state, *prepared_run->feeds_fetches_manager_,
+                                                             feeds, *p_fetches, session_options_.execution_mode,
+                                                             run_options.terminate, run_logger,
+                                                             only_execute_path_to_fetches));
+      } else {
+        ORT_CHECK_AND_SET_RETVAL(utils::ExecuteGraph(session_state, *feeds_fetches_manager, feeds, *p_fetches,
+                                                     session_options_.execution_mode, run_options.terminate,
+                                                     run_logger, only_execute_path_to_fetches));
+      }
     }
-    // execute the graph
-    ORT_CHECK_AND_SET_RETVAL(utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
-                                                 session_options_.execution_mode, run_options.terminate, run_logger,
-                                                 run_options.only_execute_path_to_fetches));
   } catch (const std::exception& e) {
     retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
   } catch (...) {
@@ -1227,6 +1939,21 @@ Status InferenceSession::Run(const RunOptions& run_options,
 
   --current_num_runs_;
 
+  if (is_inited_) {
+    bool shrink_arenas = run_options.shrink_memory_arenas;
+    if (session_options_.arena_shrink_interval_runs > 0 &&
+        ++runs_since_arena_shrink_ >= session_options_.arena_shrink_interval_runs) {
+      shrink_arenas = true;
+    }
+
+    if (shrink_arenas) {
+      runs_since_arena_shrink_ = 0;
+      ORT_CHECK_AND_SET_RETVAL(ShrinkMemoryArenas());
+    }
+  }
+
+  run_latency_histogram_.Record(static_cast<uint64_t>(TimeDiffMicroSeconds(run_start)));
+
   // keep track of telemetry
   ++telemetry_.total_runs_since_last_;
   telemetry_.total_run_duration_since_last_ += TimeDiffMicroSeconds(tp);
@@ -1249,7 +1976,21 @@ Status InferenceSession::Run(const RunOptions& run_options,
   }
   // send out profiling events (optional)
   if (session_profiler_.IsEnabled()) {
-    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
+    // Report how the intra-op threads waited for work during this run, and what the workers of the pools ran.
+    // Concurrent runs share the pools, so the numbers then include their activity too.
+    std::unordered_map<std::string, std::string> run_args;
+    if (intra_tp != nullptr) {
+      const auto spin_stats = intra_tp->GetSpinStats();
+      run_args["intra_op_spins"] = std::to_string(spin_stats.num_spins - spin_stats_at_start.num_spins);
+      run_args["intra_op_parks"] = std::to_string(spin_stats.num_parks - spin_stats_at_start.num_parks);
+      run_args["intra_op_wakeups"] = std::to_string(spin_stats.num_wakeups - spin_stats_at_start.num_wakeups);
+      RecordThreadPoolProfile(session_profiler_, *intra_tp, "intra_op", intra_op_stats_at_start, run_args);
+    }
+    if (inter_tp != nullptr) {
+      RecordThreadPoolProfile(session_profiler_, *inter_tp, "inter_op", inter_op_stats_at_start, run_args);
+    }
+    session_profiler_.RecordEvent(profiling::SESSION_EVENT, "model_run", tp, std::chrono::high_resolution_clock::now(),
+                                  logging::GetThreadId(), std::move(run_args));
   }
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
   TraceLoggingWriteStop(ortrun_activity, "OrtRun");
@@ -1257,6 +1998,107 @@ Status InferenceSession::Run(const RunOptions& run_options,
   return retval;
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions* run_options, const std::vector<std::string>& feed_names,
+                                          const std::vector<OrtValue>& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          RunAsyncCallback callback) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  if (callback == nullptr) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "RunAsync requires a callback.");
+  }
+
+  std::call_once(async_run_queue_init_, [this]() {
+    int num_threads = session_options_.async_run_thread_pool_size;
+    if (num_threads <= 0) {
+      num_threads = std::max(1, Env::Default().GetNumCpuCores());
+    }
+    LOGS(*session_logger_, INFO) << "Creating " << num_threads << " threads for RunAsync";
+    async_run_queue_ = onnxruntime::make_unique<AsyncRunQueue>(num_threads);
+  });
+
+  const auto enqueue_time = std::chrono::high_resolution_clock::now();
+  async_run_queue_->Enqueue([this, run_options, feed_names, feeds, output_names, callback, enqueue_time]() {
+    async_queue_latency_histogram_.Record(static_cast<uint64_t>(TimeDiffMicroSeconds(enqueue_time)));
+
+    std::vector<OrtValue> fetches;
+    Status status;
+    if (run_options == nullptr) {
+      RunOptions default_run_options;
+      status = Run(default_run_options, feed_names, feeds, output_names, &fetches);
+    } else {
+      status = Run(*run_options, feed_names, feeds, output_names, &fetches);
+    }
+
+    try {
+      callback(status, fetches);
+    } catch (const std::exception& e) {
+      LOGS(*session_logger_, ERROR) << "Exception in the RunAsync callback: " << e.what();
+    } catch (...) {
+      LOGS(*session_logger_, ERROR) << "Unknown exception in the RunAsync callback";
+    }
+  });
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::Warmup(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                        const std::vector<std::vector<TensorShape>>& shape_sets) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  std::vector<MLDataType> element_types;
+  element_types.reserve(feed_names.size());
+  for (const auto& feed_name : feed_names) {
+    auto iter = input_def_map_.find(feed_name);
+    if (input_def_map_.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
+    }
+    if (!iter->second.ml_data_type->IsTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Warmup only supports tensor inputs, but ", feed_name,
+                             " is not a tensor.");
+    }
+    element_types.push_back(iter->second.ml_data_type->AsTensorType()->GetElementType());
+  }
+
+  std::vector<std::string> output_names;
+  output_names.reserve(output_def_list_.size());
+  for (const auto* output_def : output_def_list_) {
+    output_names.push_back(output_def->Name());
+  }
+
+  // the feeds are allocated like the inputs of a client, from the CPU allocator of the session
+  auto allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+
+  LOGS(*session_logger_, INFO) << "Warming up for " << shape_sets.size() << " sets of input shapes";
+  for (const auto& shapes : shape_sets) {
+    if (shapes.size() != feed_names.size()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Size mismatch: ", feed_names.size(),
+                             " inputs are warmed up, but a set has ", shapes.size(), " shapes.");
+    }
+
+    std::vector<OrtValue> feeds(feed_names.size());
+    for (size_t i = 0; i < feed_names.size(); ++i) {
+      auto tensor = onnxruntime::make_unique<Tensor>(element_types[i], shapes[i], allocator);
+      if (!tensor->IsDataTypeString() && tensor->SizeInBytes() > 0) {
+        memset(tensor->MutableDataRaw(), 0, tensor->SizeInBytes());
+      }
+      feeds[i].Init(tensor.release(), ml_tensor, ml_tensor->GetDeleter());
+    }
+
+    std::vector<OrtValue> fetches;
+    ORT_RETURN_IF_ERROR_SESSIONID_(Run(run_options, feed_names, feeds, output_names, &fetches));
+  }
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -1379,6 +2221,11 @@ void InferenceSession::StartProfiling(const logging::Logger* logger_ptr) {
 std::string InferenceSession::EndProfiling() {
   if (is_model_loaded_) {
     if (session_profiler_.IsEnabled()) {
+      for (auto* thread_pool : {GetIntraOpThreadPoolToUse(), GetInterOpThreadPoolToUse()}) {
+        if (thread_pool != nullptr) {
+          thread_pool->SetProfiling(false);
+        }
+      }
       return session_profiler_.EndProfiling();
     } else {
       LOGS(*session_logger_, VERBOSE) << "Profiler is disabled.";
@@ -1389,6 +2236,182 @@ std::string InferenceSession::EndProfiling() {
   return std::string();
 }
 
+common::Status InferenceSession::GetNodeStatsJson(std::string& node_stats_json) const {
+  if (!is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session was not initialized");
+  }
+  if (!session_profiler_.IsNodeStatsEnabled()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session was not created with node statistics enabled");
+  }
+
+  const auto node_stats = session_profiler_.GetNodeStats();
+  const Graph& graph = model_->MainGraph();
+
+  nlohmann::json stats_json = nlohmann::json::array();
+  for (size_t node_index = 0; node_index < node_stats.size(); ++node_index) {
+    const auto& stats = node_stats[node_index];
+    const Node* node = graph.GetNode(node_index);
+    if (stats.count == 0 || node == nullptr) {
+      continue;
+    }
+    stats_json.push_back({{"name", node->Name()},
+                          {"op_type", node->OpType()},
+                          {"count", stats.count},
+                          {"total_us", stats.total_ns / 1000},
+                          {"min_us", stats.min_ns / 1000},
+                          {"max_us", stats.max_ns / 1000},
+                          {"output_bytes", stats.output_bytes},
+                          {"num_shards", stats.num_shards}});
+  }
+
+  node_stats_json = stats_json.dump();
+  return Status::OK();
+}
+
+namespace {
+void AddLatencyMetrics(const std::string& name, const LatencyHistogram::Snapshot& latency,
+                       InferenceSession::MetricsFormat format, nlohmann::json& metrics_json,
+                       std::ostringstream& prometheus) {
+  const uint64_t p50 = latency.ValueAtQuantile(0.5);
+  const uint64_t p90 = latency.ValueAtQuantile(0.9);
+  const uint64_t p99 = latency.ValueAtQuantile(0.99);
+
+  if (format == InferenceSession::MetricsFormat::Json) {
+    metrics_json[name] = {{"count", latency.count},
+                          {"sum_us", latency.sum},
+                          {"max_us", latency.max},
+                          {"p50_us", p50},
+                          {"p90_us", p90},
+                          {"p99_us", p99}};
+    return;
+  }
+
+  // a summary with the quantiles; the values are in microseconds like the rest of the session metrics
+  const std::string metric = "onnxruntime_session_" + name + "_us";
+  prometheus << "# TYPE " << metric << " summary\n"
+             << metric << "{quantile=\"0.5\"} " << p50 << "\n"
+             << metric << "{quantile=\"0.9\"} " << p90 << "\n"
+             << metric << "{quantile=\"0.99\"} " << p99 << "\n"
+             << metric << "_sum " << latency.sum << "\n"
+             << metric << "_count " << latency.count << "\n"
+             << "# TYPE " << metric << "_max gauge\n"
+             << metric << "_max " << latency.max << "\n";
+}
+}  // namespace
+
+common::Status InferenceSession::GetMetrics(MetricsFormat format, std::string& metrics) const {
+  if (!is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session was not initialized");
+  }
+
+  nlohmann::json metrics_json = nlohmann::json::object();
+  std::ostringstream prometheus;
+
+  AddLatencyMetrics("run_latency", run_latency_histogram_.GetSnapshot(), format, metrics_json, prometheus);
+  AddLatencyMetrics("async_queue_latency", async_queue_latency_histogram_.GetSnapshot(), format, metrics_json,
+                    prometheus);
+
+  // kernel time of each execution provider and time of the copies between devices, from the node statistics
+  if (session_profiler_.IsNodeStatsEnabled()) {
+    std::map<std::string, uint64_t> provider_kernel_us;
+    uint64_t memcpy_count = 0;
+    uint64_t memcpy_us = 0;
+
+    const auto node_stats = session_profiler_.GetNodeStats();
+    const Graph& graph = model_->MainGraph();
+    for (size_t node_index = 0; node_index < node_stats.size(); ++node_index) {
+      const auto& stats = node_stats[node_index];
+      const Node* node = graph.GetNode(node_index);
+      if (stats.count == 0 || node == nullptr) {
+        continue;
+      }
+      provider_kernel_us[node->GetExecutionProviderType()] += stats.total_ns / 1000;
+      if (node->OpType() == "MemcpyFromHost" || node->OpType() == "MemcpyToHost") {
+        memcpy_count += stats.count;
+        memcpy_us += stats.total_ns / 1000;
+      }
+    }
+
+    if (format == MetricsFormat::Json) {
+      metrics_json["provider_kernel_us"] = provider_kernel_us;
+      metrics_json["memcpy"] = {{"count", memcpy_count}, {"sum_us", memcpy_us}};
+    } else {
+      prometheus << "# TYPE onnxruntime_session_provider_kernel_us counter\n";
+      for (const auto& provider : provider_kernel_us) {
+        prometheus << "onnxruntime_session_provider_kernel_us{provider=\"" << provider.first << "\"} "
+                   << provider.second << "\n";
+      }
+      prometheus << "# TYPE onnxruntime_session_memcpy_count counter\n"
+                 << "onnxruntime_session_memcpy_count " << memcpy_count << "\n"
+                 << "# TYPE onnxruntime_session_memcpy_us counter\n"
+                 << "onnxruntime_session_memcpy_us " << memcpy_us << "\n";
+    }
+  }
+
+  // page faults of the process, which grow with the first touches of fresh arena regions unless they are pre-faulted
+  const uint64_t page_faults = Env::Default().GetPageFaultCount();
+  if (format == MetricsFormat::Json) {
+    metrics_json["page_faults"] = page_faults;
+  } else {
+    prometheus << "# TYPE onnxruntime_process_page_faults counter\n"
+               << "onnxruntime_process_page_faults " << page_faults << "\n";
+  }
+
+  struct ArenaMetrics {
+    std::string provider;
+    std::string name;
+    AllocatorStats stats;
+  };
+  std::vector<ArenaMetrics> arenas;
+  for (const auto& xp : execution_providers_) {
+    for (const auto& allocator : xp->GetAllocators()) {
+      if (allocator->Info().alloc_type == OrtArenaAllocator) {
+        arenas.push_back({xp->Type(), allocator->Info().name, AllocatorStats()});
+        static_cast<IArenaAllocator*>(allocator.get())->GetStats(&arenas.back().stats);
+      }
+    }
+  }
+
+  if (format == MetricsFormat::Json) {
+    nlohmann::json arenas_json = nlohmann::json::array();
+    for (const auto& arena : arenas) {
+      arenas_json.push_back({{"provider", arena.provider},
+                             {"name", arena.name},
+                             {"num_allocs", arena.stats.num_allocs},
+                             {"bytes_in_use", arena.stats.bytes_in_use},
+                             {"max_bytes_in_use", arena.stats.max_bytes_in_use},
+                             {"total_allocated_bytes", arena.stats.total_allocated_bytes},
+                             {"max_alloc_size", arena.stats.max_alloc_size},
+                             {"bytes_limit", arena.stats.bytes_limit}});
+    }
+    metrics_json["arenas"] = arenas_json;
+    metrics = metrics_json.dump();
+    return Status::OK();
+  }
+
+  // the samples of a metric have to follow its TYPE line
+  const struct {
+    const char* name;
+    const char* type;
+    int64_t AllocatorStats::*value;
+  } arena_metrics[] = {{"onnxruntime_arena_num_allocs", "counter", &AllocatorStats::num_allocs},
+                       {"onnxruntime_arena_bytes_in_use", "gauge", &AllocatorStats::bytes_in_use},
+                       {"onnxruntime_arena_max_bytes_in_use", "gauge", &AllocatorStats::max_bytes_in_use},
+                       {"onnxruntime_arena_total_allocated_bytes", "gauge", &AllocatorStats::total_allocated_bytes}};
+  if (!arenas.empty()) {
+    for (const auto& arena_metric : arena_metrics) {
+      prometheus << "# TYPE " << arena_metric.name << " " << arena_metric.type << "\n";
+      for (const auto& arena : arenas) {
+        prometheus << arena_metric.name << "{provider=\"" << arena.provider << "\",arena=\"" << arena.name << "\"} "
+                   << arena.stats.*arena_metric.value << "\n";
+      }
+    }
+  }
+
+  metrics = prometheus.str();
+  return Status::OK();
+}
+
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
   // TODO add other post load processing here
@@ -1519,7 +2542,9 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
   auto add_transformers = [&](TransformerLevel level) {
     // Generate and register transformers for level
     auto transformers_to_register =
-        optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list);
+        optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list,
+                                              GetIntraOpThreadPoolToUse(),
+                                              session_options_.constant_folding_max_size_ratio);
     for (auto& entry : transformers_to_register) {
       transformer_manager.Register(std::move(entry), level);
     }
@@ -1535,6 +2560,14 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
       add_transformers(level);
     }
   }
+
+  // The conversion runs after the level 2 fusions so that the fused nodes are converted as a whole.
+  if (session_options_.enable_cuda_mixed_precision && graph_optimization_level >= TransformerLevel::Level2) {
+    transformer_manager.Register(onnxruntime::make_unique<MixedPrecisionTransformer>(
+                                     session_options_.mixed_precision_op_allow_list,
+                                     session_options_.mixed_precision_op_deny_list),
+                                 TransformerLevel::Level2);
+  }
 }
 
 common::Status InferenceSession::WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms) {
@@ -3,15 +3,21 @@
 
 #pragma once
 
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
 #include "core/common/common.h"
+#include "core/common/latency_histogram.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
 #include "core/common/status.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/framework_common.h"
+#include "core/framework/graph_partitioner.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/session_state.h"
@@ -29,6 +35,7 @@
 #endif
 
 namespace onnxruntime {  // forward declarations
+class AsyncRunQueue;
 class GraphTransformer;
 class Environment;
 }  // namespace onnxruntime
@@ -45,6 +52,8 @@ struct OrtCustomOpDomain {
 namespace onnxruntime {
 class IExecutionProvider;  // forward decl
 class IOBinding;
+class PreparedRun;
+class SharedInitializerRegistry;
 class CustomRegistry;
 struct Notification;
 
@@ -241,6 +250,64 @@ class InferenceSession {
                      std::vector<OrtValue>* p_fetches,
                      const std::vector<OrtDevice>* p_fetches_device_info = nullptr) ORT_MUST_USE_RESULT;
 
+  /**
+    * Resolve the feeds and fetches of Run calls with the given input and output names once, for reuse by
+    * Run(const RunOptions&, const PreparedRun&, ...). See PreparedRun class for more info.
+    * This API is thread-safe.
+    * @param feed_names names of the inputs, in the order the feeds will be provided.
+    * @param output_names names of the outputs, in the order the fetches will be returned.
+    * @return OK if the names are valid inputs and outputs of the model.
+    */
+  common::Status PrepareRun(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names,
+                            std::unique_ptr<PreparedRun>& prepared_run) const ORT_MUST_USE_RESULT;
+
+  /**
+    * Run a pre-loaded and pre-intialized model with the feeds and fetches resolved by PrepareRun.
+    * Multiple threads are allowed to run this function, with the same PreparedRun or not; hence its thread-safe.
+    * @param prepared_run created by PrepareRun on this session.
+    * @param feeds inputs in the order of the feed names of prepared_run.
+    * @param p_fetches output values in the order of the output names of prepared_run.
+    * @return OK if success.
+    */
+  common::Status Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                     const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches) ORT_MUST_USE_RESULT;
+
+  /**
+    * Called on completion of a RunAsync request with the status of the run and the fetches in the order of
+    * the output names.
+    */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+    * Queue a Run of a pre-loaded and pre-intialized model and return without waiting for it.
+    * The runs are executed by a fixed set of threads owned by the session (see
+    * SessionOptions::async_run_thread_pool_size), so many requests can be in flight with few threads.
+    * This API is thread-safe.
+    * @param run_options the options of the run, or nullptr to use the default ones. It must remain valid until the
+    *        callback is invoked.
+    * @param feeds the inputs are shared with the run, so the buffers they wrap must remain valid until the callback
+    *        is invoked.
+    * @param callback invoked on a thread of the session once the run completes. The errors of the run are reported
+    *        to it.
+    * @return OK if the run was queued.
+    */
+  common::Status RunAsync(const RunOptions* run_options, const std::vector<std::string>& feed_names,
+                          const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                          RunAsyncCallback callback) ORT_MUST_USE_RESULT;
+
+  /**
+    * Run a pre-loaded and pre-intialized model once per set of input shapes with zero filled inputs, so the work
+    * of the first Run with these shapes is done up front: the memory patterns, the growth of the arenas and the
+    * state created by kernels on their first Compute, such as the cuDNN algorithm search of Conv.
+    * The outputs are discarded.
+    * This API is thread-safe.
+    * @param feed_names names of the inputs, which shall include every required input. Only tensors are supported.
+    * @param shape_sets the shapes of the inputs of each warm-up run, in the order of feed_names.
+    * @return OK if every warm-up run succeeded.
+    */
+  common::Status Warmup(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                        const std::vector<std::vector<TensorShape>>& shape_sets) ORT_MUST_USE_RESULT;
+
   /**
     * Run a pre-loaded and pre-intialized model.
     * Multiple threads are allowed to run this function; hence its thread-safe.
@@ -308,6 +375,12 @@ class InferenceSession {
     */
   int GetCurrentNumRuns() const;
 
+  /**
+    * Release the memory held by the arenas of all execution providers that is not currently in use.
+    * Safe to call while other Run calls are in progress.
+    */
+  common::Status ShrinkMemoryArenas();
+
   /**
     * Get the names of registered Execution Providers. The returned vector is ordered by Execution Provider
     * priority. The first provider in the vector has the highest priority.
@@ -341,6 +414,41 @@ class InferenceSession {
     */
   std::string EndProfiling();
 
+  /**
+    * Get the statistics collected for each node of the main graph that has run, when the session was created
+    * with SessionOptions::enable_node_stats. May be called at any time, including while the session runs.
+    * @return a JSON array with an object per node: its name, op type, execution count, total/min/max kernel time
+    * in microseconds, total size of its outputs in bytes and total number of thread pool work items.
+    */
+  common::Status GetNodeStatsJson(std::string& node_stats_json) const;
+
+  enum class MetricsFormat {
+    Json,
+    Prometheus,
+  };
+
+  /**
+    * Get the metrics of the session since it was created: histograms of the Run latency and of the time RunAsync
+    * requests wait in the queue (count, sum, max, p50, p90 and p99 in microseconds), and the statistics of the
+    * arenas of the execution providers. When the session was created with SessionOptions::enable_node_stats, the
+    * kernel time of each execution provider and the time spent in copies between devices are reported too.
+    * May be called at any time, including while the session runs.
+    */
+  common::Status GetMetrics(MetricsFormat format, std::string& metrics) const;
+
+  // Keys of an output returned as a tensor instead of a sequence of maps, see SessionOptions::columnar_zipmap_outputs.
+  // Column j of the output holds the values of key j. Only one of the vectors is filled.
+  struct ColumnarMapKeys {
+    std::vector<int64_t> int64_keys;
+    std::vector<std::string> string_keys;
+  };
+
+  /**
+    * Get the keys of an output returned as a tensor instead of a sequence of maps.
+    * @return the keys, or nullptr if the output isn't such an output. Valid once the session is initialized.
+    */
+  const ColumnarMapKeys* GetColumnarMapOutputKeys(const std::string& output_name) const;
+
  protected:
   /**
     * Load an ONNX model.
@@ -407,6 +515,10 @@ class InferenceSession {
 
   common::Status InitializeSubgraphSessions(Graph& graph, SessionState& session_state) ORT_MUST_USE_RESULT;
 
+  common::Status InitializeSubgraphSession(const Node& node, const std::string& attribute_name, Graph& subgraph,
+                                           SessionState& session_state,
+                                           SessionState& subgraph_session_state) ORT_MUST_USE_RESULT;
+
   virtual void AddPredefinedTransformers(GraphTransformerManager& transformer_manager,
                                          TransformerLevel graph_optimization_level,
                                          const std::vector<std::string>& custom_list);
@@ -422,8 +534,28 @@ class InferenceSession {
   common::Status ValidateOutputs(const std::vector<std::string>& output_names,
                                  const std::vector<OrtValue>* p_fetches) const ORT_MUST_USE_RESULT;
 
+  // Run with the names resolved by prepared_run if not null, otherwise with feed_names and output_names.
+  common::Status RunImpl(const RunOptions& run_options, const PreparedRun* prepared_run,
+                         const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                         const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
+                         const std::vector<OrtDevice>* p_fetches_device_info) ORT_MUST_USE_RESULT;
+
   common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms) ORT_MUST_USE_RESULT;
 
+  // A copy of the main graph optimized for the shapes of the inputs of a run, and its session state.
+  struct SpecializedGraph {
+    std::shared_ptr<onnxruntime::Model> model;
+    std::unique_ptr<SessionState> session_state;
+  };
+
+  // Get the graph specialized to the shapes of the feeds, creating it on the first run with these shapes.
+  // specialized_graph is null if the main graph is to be used.
+  common::Status GetSpecializedGraph(const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                                     std::shared_ptr<SpecializedGraph>& specialized_graph) ORT_MUST_USE_RESULT;
+
+  common::Status CreateSpecializedGraph(const std::map<std::string, TensorShape>& input_shapes,
+                                        SpecializedGraph& specialized_graph) ORT_MUST_USE_RESULT;
+
   template <typename T>
   common::Status Load(const std::basic_string<T>& model_uri) ORT_MUST_USE_RESULT;
 
@@ -462,11 +594,21 @@ class InferenceSession {
   // Use these 2 threadpool methods to get access to the threadpools since they rely on
   // specific flags in session options
   // These methods assume that session options have been finalized before the call.
+  // Number of graphs specialized to the input shapes of runs currently cached.
+  // See SessionOptions::shape_specialization_cache_size.
+  size_t GetSpecializedGraphCount() const {
+    std::lock_guard<onnxruntime::OrtMutex> l(specialization_mutex_);
+    return specialized_graphs_.size();
+  }
+
   onnxruntime::concurrency::ThreadPool* GetIntraOpThreadPoolToUse() const {
     return session_options_.use_per_session_threads ? thread_pool_.get() : intra_op_thread_pool_from_env_;
   }
 
   onnxruntime::concurrency::ThreadPool* GetInterOpThreadPoolToUse() const {
+    if (session_options_.use_unified_thread_pool) {
+      return GetIntraOpThreadPoolToUse();
+    }
     return session_options_.use_per_session_threads ? inter_op_thread_pool_.get() : inter_op_thread_pool_from_env_;
   }
 
@@ -480,11 +622,27 @@ class InferenceSession {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Threads running the RunAsync requests, created by the first RunAsync call.
+  std::unique_ptr<AsyncRunQueue> async_run_queue_;
+  std::once_flag async_run_queue_init_;
+
+  // Latency of the completed runs, and time the RunAsync requests waited for a thread, in microseconds.
+  LatencyHistogram run_latency_histogram_;
+  LatencyHistogram async_queue_latency_histogram_;
+
+  // Per-element ParallelFor costs used by thread_pool_, when calibrate_parallel_for_cost or
+  // parallel_for_cost_table_file is set.
+  std::shared_ptr<onnxruntime::concurrency::ParallelForCostTable> parallel_for_cost_table_;
+
   // Global threadpools. These are intialized and used when use_per_session_threads is false *and*
   // the environment is created with create_global_thread_pools = true.
   onnxruntime::concurrency::ThreadPool* intra_op_thread_pool_from_env_{};
   onnxruntime::concurrency::ThreadPool* inter_op_thread_pool_from_env_{};
 
+  // Registry of the environment to share the constant initializers through if SessionOptions::share_initializers
+  // is set. Only used by Initialize; the shared data is kept alive by the sessions using it.
+  SharedInitializerRegistry* shared_initializer_registry_{};
+
   // initialized from session options
   // Determines which threadpools will be intialized and used for the duration of this session.
   // If true, use the per session ones, or else the global threadpools.
@@ -493,6 +651,15 @@ class InferenceSession {
   KernelRegistryManager kernel_registry_manager_;
   std::list<std::shared_ptr<onnxruntime::IOnnxRuntimeOpSchemaCollection>> custom_schema_registries_;
 
+  // Node placements loaded from SessionOptions::graph_partitioning_override_file.
+  NodePlacementOverrides node_placement_overrides_;
+
+  // Replaces the ZipMap nodes producing outputs of the main graph with an Identity of their input, and records
+  // their keys in columnar_map_output_keys_. See SessionOptions::columnar_zipmap_outputs.
+  common::Status ConvertZipMapOutputsToColumnar(Graph& graph) ORT_MUST_USE_RESULT;
+
+  std::unordered_map<std::string, ColumnarMapKeys> columnar_map_output_keys_;
+
   ModelMetadata model_metadata_;
   std::unordered_set<std::string> required_inputs_;
 
@@ -506,6 +673,15 @@ class InferenceSession {
   };
 
   std::unordered_map<std::string, InputDefMetaData> input_def_map_;
+
+  // PreparedRun holds the InputDefMetaData of its feeds
+  friend class PreparedRun;
+
+  common::Status ValidateInput(const std::string& feed_name, const InputDefMetaData& input_def,
+                               const OrtValue& input_ml_value) const ORT_MUST_USE_RESULT;
+
+  common::Status ValidatePreparedRun(const PreparedRun& prepared_run, const std::vector<OrtValue>& feeds,
+                                     const std::vector<OrtValue>* p_fetches) const ORT_MUST_USE_RESULT;
   OutputDefList output_def_list_;
 
   // Data transfer manager.
@@ -514,6 +690,30 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
+  // Number of completed Run calls since the arenas were last shrunk. See SessionOptions::arena_shrink_interval_runs.
+  std::atomic<int> runs_since_arena_shrink_{0};
+
+  // Provider that captures the device work of a run into a graph and replays it, if all the nodes are assigned to
+  // a provider with graph capture enabled. See IExecutionProvider::PrepareGraphReplay.
+  IExecutionProvider* graph_capture_provider_ = nullptr;
+
+  // Incremented when memory a captured graph may refer to is released, so the graph is captured again.
+  std::atomic<uint64_t> graph_capture_generation_{0};
+
+  // The main graph before the graph transformations, if SessionOptions::shape_specialization_cache_size is set
+  // and some inputs have free dimensions.
+  std::unique_ptr<ONNX_NAMESPACE::ModelProto> specialization_model_proto_;
+
+  // Names of the inputs of the main graph with free dimensions. The graphs are specialized to their shapes.
+  std::unordered_set<std::string> free_dim_inputs_;
+
+  // The specialized graphs by signature of the input shapes, the most recently used first. A failed specialization
+  // is cached as null so the main graph is used for these shapes. Runs hold a reference on the graph they execute,
+  // so a graph evicted by another thread is released at the end of the run.
+  std::list<std::pair<std::string, std::shared_ptr<SpecializedGraph>>> specialized_graphs_;
+  std::unordered_map<std::string, decltype(specialized_graphs_)::iterator> specialized_graph_index_;
+  mutable onnxruntime::OrtMutex specialization_mutex_;
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
@@ -24,6 +24,10 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/prepared_run.h"
+#include "core/session/request_batcher.h"
+#include "core/session/session_pipeline.h"
+#include "core/session/session_pool.h"
 #include "core/session/ort_apis.h"
 #include "core/session/ort_env.h"
 #include "core/framework/data_types.h"
@@ -100,6 +104,20 @@ ORT_API_STATUS_IMPL(OrtApis::CreateEnvWithGlobalThreadPools, OrtLoggingLevel def
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateEnvWithAsyncLogging, OrtLoggingLevel default_warning_level,
+                    _In_ const char* logid, size_t queue_capacity, _Outptr_ OrtEnv** out) {
+  API_IMPL_BEGIN
+  if (queue_capacity == 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "queue_capacity must be greater than 0");
+  }
+  OrtEnv::LoggingManagerConstructionInfo lm_info{nullptr, nullptr, default_warning_level, logid};
+  lm_info.async_log_queue_capacity = queue_capacity;
+  Status status;
+  *out = OrtEnv::GetInstance(lm_info, status);
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
 // enable platform telemetry
 ORT_API_STATUS_IMPL(OrtApis::EnableTelemetryEvents, _In_ const OrtEnv* ort_env) {
   API_IMPL_BEGIN
@@ -522,6 +540,196 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
   API_IMPL_END
 }
 
+// Adapts a RunAsyncCallbackFn to the completion callback of InferenceSession::RunAsync.
+static ::onnxruntime::InferenceSession::RunAsyncCallback MakeRunAsyncCallback(RunAsyncCallbackFn callback,
+                                                                              void* user_data) {
+  return [callback, user_data](const Status& status, std::vector<OrtValue>& fetches) {
+    if (!status.IsOK()) {
+      callback(user_data, nullptr, 0, ToOrtStatus(status));
+      return;
+    }
+
+    const int fetch_queue_id = 0;
+    std::vector<OrtValue*> outputs(fetches.size());
+    for (size_t i = 0; i != fetches.size(); ++i) {
+      ::OrtValue& value = fetches[i];
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, fetch_queue_id);
+      outputs[i] = new OrtValue(value);
+    }
+    callback(user_data, outputs.data(), outputs.size(), nullptr);
+  };
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const int queue_id = 0;
+
+  if (callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be null");
+  }
+
+  std::vector<std::string> feed_names(input_len);
+  std::vector<OrtValue> feeds(input_len);
+
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+
+    feed_names[i] = input_names[i];
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  auto status = session->RunAsync(run_options, feed_names, feeds, output_names,
+                                  MakeRunAsyncCallback(callback, user_data));
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionWarmup, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(input_len* shape_set_count) const int64_t* const* input_shapes,
+                    _In_reads_(input_len* shape_set_count) const size_t* input_shape_lens, size_t shape_set_count) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::vector<onnxruntime::TensorShape>> shape_sets(shape_set_count);
+  for (size_t i = 0; i != shape_set_count; ++i) {
+    shape_sets[i].reserve(input_len);
+    for (size_t j = 0; j != input_len; ++j) {
+      const size_t index = i * input_len + j;
+      if (input_shapes[index] == nullptr && input_shape_lens[index] != 0) {
+        return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input shape cannot be null");
+      }
+      shape_sets[i].emplace_back(input_shapes[index], input_shape_lens[index]);
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Warmup(op, feed_names, shape_sets);
+  } else {
+    status = session->Warmup(*run_options, feed_names, shape_sets);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  auto status = session->PrepareRun(feed_names, output_names, prepared_run);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  *out = reinterpret_cast<OrtPreparedRun*>(prepared_run.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunWithPreparedRun, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const OrtPreparedRun* prepared_run1,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _Inout_updates_all_(output_len) OrtValue** output, size_t output_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const auto& prepared_run = *reinterpret_cast<const ::onnxruntime::PreparedRun*>(prepared_run1);
+  const int queue_id = 0;
+
+  if (output_len != prepared_run.GetOutputNames().size()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output_len doesn't match the outputs of the prepared run");
+  }
+
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<OrtValue> fetches(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output[i] != nullptr) {
+      ::OrtValue& value = *(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, prepared_run, feeds, &fetches);
+  } else {
+    status = session->Run(*run_options, prepared_run, feeds, &fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t i = 0; i != output_len; ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::IsTensor, _In_ const OrtValue* value, _Out_ int* out) {
   auto v = reinterpret_cast<const ::OrtValue*>(value);
   *out = v->IsTensor() ? 1 : 0;
@@ -694,6 +902,277 @@ ORT_API_STATUS_IMPL(OrtApis::SessionEndProfiling, _In_ OrtSession* sess, _Inout_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateRequestBatcher, _Inout_ OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    size_t max_batch_size, int64_t max_delay_us, _Outptr_ OrtRequestBatcher** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  if (max_batch_size == 0 || max_delay_us < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 "max_batch_size must be positive and max_delay_us must not be negative");
+  }
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  auto batcher = onnxruntime::make_unique<::onnxruntime::RequestBatcher>(
+      *session, feed_names, output_names, max_batch_size, std::chrono::microseconds(max_delay_us));
+  *out = reinterpret_cast<OrtRequestBatcher*>(batcher.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RequestBatcherRun, _Inout_ OrtRequestBatcher* batcher1,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto batcher = reinterpret_cast<::onnxruntime::RequestBatcher*>(batcher1);
+  const int queue_id = 0;
+
+  if (callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be null");
+  }
+
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  auto status = batcher->Run(feeds, MakeRunAsyncCallback(callback, user_data));
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RequestBatcherGetStats, _In_ const OrtRequestBatcher* batcher1,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto batcher = reinterpret_cast<const ::onnxruntime::RequestBatcher*>(batcher1);
+  *out = StrDup(batcher->GetStatsJson(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateSessionPool, _Inout_ OrtSession* sess, size_t num_workers,
+                    _Outptr_ OrtSessionPool** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  if (num_workers == 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "num_workers must be positive");
+  }
+
+  auto pool = onnxruntime::make_unique<::onnxruntime::SessionPool>(*session, num_workers);
+  *out = reinterpret_cast<OrtSessionPool*>(pool.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionPoolCheckout, _Inout_ OrtSessionPool* pool1, int64_t timeout_us,
+                    _Outptr_result_maybenull_ OrtSessionPoolWorker** out) {
+  API_IMPL_BEGIN
+  auto pool = reinterpret_cast<::onnxruntime::SessionPool*>(pool1);
+  *out = reinterpret_cast<OrtSessionPoolWorker*>(pool->Checkout(std::chrono::microseconds(timeout_us)));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionPoolWorkerRun, _Inout_ OrtSessionPoolWorker* worker1,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output) {
+  API_IMPL_BEGIN
+  auto worker = reinterpret_cast<::onnxruntime::SessionPool::Worker*>(worker1);
+  const int queue_id = 0;
+
+  std::vector<std::string> feed_names(input_len);
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+
+    feed_names[i] = input_names[i];
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::vector<OrtValue> fetches(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output[i] != nullptr) {
+      ::OrtValue& value = *(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = worker->Run(op, feed_names, feeds, output_names, &fetches);
+  } else {
+    status = worker->Run(*run_options, feed_names, feeds, output_names, &fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionPoolCheckin, _Inout_ OrtSessionPool* pool1, _In_ OrtSessionPoolWorker* worker) {
+  API_IMPL_BEGIN
+  auto pool = reinterpret_cast<::onnxruntime::SessionPool*>(pool1);
+  pool->Checkin(reinterpret_cast<::onnxruntime::SessionPool::Worker*>(worker));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateSessionPipeline, _In_reads_(num_stages) OrtSession* const* stages,
+                    size_t num_stages, _Outptr_ OrtSessionPipeline** out) {
+  API_IMPL_BEGIN
+  if (num_stages == 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "num_stages must be positive");
+  }
+
+  std::vector<::onnxruntime::InferenceSession*> sessions(num_stages);
+  for (size_t i = 0; i != num_stages; ++i) {
+    if (stages[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "the session of a stage is null");
+    }
+    sessions[i] = reinterpret_cast<::onnxruntime::InferenceSession*>(stages[i]);
+  }
+
+  auto pipeline = onnxruntime::make_unique<::onnxruntime::SessionPipeline>(sessions);
+  *out = reinterpret_cast<OrtSessionPipeline*>(pipeline.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionPipelineRun, _Inout_ OrtSessionPipeline* pipeline1,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len* num_micro_batches) const OrtValue* const* input, size_t input_len,
+                    size_t num_micro_batches,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Out_writes_all_(output_names_len* num_micro_batches) OrtValue** output) {
+  API_IMPL_BEGIN
+  auto pipeline = reinterpret_cast<::onnxruntime::SessionPipeline*>(pipeline1);
+  const int queue_id = 0;
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::vector<OrtValue>> micro_batch_feeds(num_micro_batches, std::vector<OrtValue>(input_len));
+  for (size_t m = 0; m != num_micro_batches; ++m) {
+    for (size_t i = 0; i != input_len; ++i) {
+      auto& ort_value = micro_batch_feeds[m][i] = *reinterpret_cast<const ::OrtValue*>(input[m * input_len + i]);
+      if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    }
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::vector<std::vector<OrtValue>> micro_batch_fetches;
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = pipeline->Run(op, feed_names, micro_batch_feeds, output_names, micro_batch_fetches);
+  } else {
+    status = pipeline->Run(*run_options, feed_names, micro_batch_feeds, output_names, micro_batch_fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t m = 0; m != num_micro_batches; ++m) {
+    for (size_t i = 0; i != output_names_len; ++i) {
+      ::OrtValue& value = micro_batch_fetches[m][i];
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+      output[m * output_names_len + i] = new OrtValue(value);
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetNodeStats, _In_ const OrtSession* sess,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string node_stats_json;
+  auto status = session->GetNodeStatsJson(node_stats_json);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = StrDup(node_stats_json, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetMetrics, _In_ const OrtSession* sess, OrtMetricsFormat format,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string metrics;
+  auto status = session->GetMetrics(format == ORT_METRICS_FORMAT_PROMETHEUS
+                                        ? ::onnxruntime::InferenceSession::MetricsFormat::Prometheus
+                                        : ::onnxruntime::InferenceSession::MetricsFormat::Json,
+                                    metrics);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = StrDup(metrics, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetModelMetadata, _In_ const OrtSession* sess,
                     _Outptr_ OrtModelMetadata** out) {
   API_IMPL_BEGIN
@@ -952,7 +1431,7 @@ struct CallGetValueImpl {
                             _Outptr_ OrtValue** out) const {
     const auto& shape = tensor.Shape();
     const auto* tensor_data = tensor.Data<TensorElemType>();
-    OrtStatus* st = OrtApis::CreateTensorAsOrtValue(allocator, shape.GetDims().data(), shape.NumDimensions(),
+    OrtStatus* st = OrtApis::CreateTensorAsOrtValue(allocator, shape.GetDimsAsSpan().data(), shape.NumDimensions(),
                                                     onnxruntime::utils::GetONNXTensorElementDataType<TensorElemType>(), out);
     //TODO: check overflow before doing static_cast
     return st ? st : PopulateTensorWithData(*out, tensor_data, static_cast<size_t>(shape.Size()), sizeof(TensorElemType));
@@ -1127,7 +1606,7 @@ static OrtStatus* OrtCreateValueImplSeqHelperTensor(const Tensor& tensor,
   }
 
   auto elem_type = DataTypeImpl::GetType<TensorElemType>();
-  OrtStatus* st = CreateTensorImplForSeq(elem_type, tensor.Shape().GetDims().data(), tensor.Shape().NumDimensions(), out);
+  OrtStatus* st = CreateTensorImplForSeq(elem_type, tensor.Shape().GetDimsAsSpan().data(), tensor.Shape().NumDimensions(), out);
   if (st) {
     return st;
   }
@@ -1339,6 +1818,33 @@ static ORT_STATUS_PTR OrtCreateValueImpl(_In_reads_(num_values) const OrtValue*
   return OrtApis::CreateStatus(ORT_FAIL, "Input is not of type sequence or map.");
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetOutputMapKeys, _In_ const OrtSession* sess, size_t index,
+                    _Inout_ OrtAllocator* allocator, _Outptr_result_maybenull_ OrtValue** out) {
+  API_IMPL_BEGIN
+  char* name = nullptr;
+  OrtStatus* st = GetNodeDefNameImpl(sess, index, allocator, get_outputs_fn, &name);
+  if (st) {
+    return st;
+  }
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  const auto* keys = session->GetColumnarMapOutputKeys(name);
+  allocator->Free(allocator, name);
+  if (keys == nullptr) {
+    *out = nullptr;
+    return nullptr;
+  }
+
+  if (!keys->string_keys.empty()) {
+    std::vector<int64_t> dims{static_cast<int64_t>(keys->string_keys.size())};
+    st = OrtApis::CreateTensorAsOrtValue(allocator, dims.data(), dims.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING, out);
+    return st ? st : PopulateTensorWithData(*out, keys->string_keys.data(), keys->string_keys.size(), 0);
+  }
+  std::vector<int64_t> dims{static_cast<int64_t>(keys->int64_keys.size())};
+  st = OrtApis::CreateTensorAsOrtValue(allocator, dims.data(), dims.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64, out);
+  return st ? st : PopulateTensorWithData(*out, keys->int64_keys.data(), keys->int64_keys.size(), sizeof(int64_t));
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::CreateValue, _In_reads_(num_values) const OrtValue* const* in, size_t num_values,
                     enum ONNXType value_type, _Outptr_ OrtValue** out) {
   API_IMPL_BEGIN
@@ -1614,6 +2120,45 @@ static constexpr OrtApi ort_api_1_to_4 = {
     // Version 4 - In development, feel free to add/remove/rearrange here
     &OrtApis::GetAvailableProviders,
     &OrtApis::ReleaseAvailableProviders,
+    &OrtApis::RunOptionsSetMemoryArenaShrinkage,
+    &OrtApis::SetIntraOpNumaNode,
+    &OrtApis::RunAsync,
+    &OrtApis::SetAsyncRunThreadPoolSize,
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::RunWithPreparedRun,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::SetShareInitializers,
+    &OrtApis::SetUseMmapInitializers,
+    &OrtApis::SetSaveNodePlacements,
+    &OrtApis::SetUseSavedNodePlacements,
+    &OrtApis::CreateRequestBatcher,
+    &OrtApis::RequestBatcherRun,
+    &OrtApis::RequestBatcherGetStats,
+    &OrtApis::ReleaseRequestBatcher,
+    &OrtApis::SessionWarmup,
+    &OrtApis::SetEnableNodeStats,
+    &OrtApis::SessionGetNodeStats,
+    &OrtApis::SessionGetMetrics,
+    &OrtApis::SetEnableMemoryProfiling,
+    &OrtApis::SetEnableHardwareCounters,
+    &OrtApis::CreateSessionPool,
+    &OrtApis::SessionPoolCheckout,
+    &OrtApis::SessionPoolWorkerRun,
+    &OrtApis::SessionPoolCheckin,
+    &OrtApis::ReleaseSessionPool,
+    &OrtApis::CreateEnvWithAsyncLogging,
+    &OrtApis::SetColumnarZipMapOutputs,
+    &OrtApis::SessionGetOutputMapKeys,
+    &OrtApis::CreateSessionPipeline,
+    &OrtApis::SessionPipelineRun,
+    &OrtApis::ReleaseSessionPipeline,
+    &OrtApis::SetLazyInitialization,
+    &OrtApis::KernelContext_GetInputData,
+    &OrtApis::KernelContext_GetOutputData,
+    &OrtApis::KernelInfoGetConstantInputData,
+    &OrtApis::KernelContext_ParallelFor,
+    &OrtApis::SetSavePrepackedWeights,
+    &OrtApis::SetUseSavedPrepackedWeights,
 };
 
 // Assert to do a limited check to ensure Version 1 of OrtApi never changes (will detect an addition or deletion but not if they cancel out each other)
@@ -1643,3 +2188,7 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, OrtValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(ModelMetadata, ::onnxruntime::ModelMetadata)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, ::onnxruntime::PreparedRun)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RequestBatcher, ::onnxruntime::RequestBatcher)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(SessionPool, ::onnxruntime::SessionPool)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(SessionPipeline, ::onnxruntime::SessionPipeline)
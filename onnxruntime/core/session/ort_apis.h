@@ -202,4 +202,84 @@ ORT_API_STATUS_IMPL(GetAvailableProviders, _Outptr_ char ***out_ptr,
                     _In_ int *providers_length);
 ORT_API_STATUS_IMPL(ReleaseAvailableProviders, _In_ char **ptr,
                     _In_ int providers_length);
+ORT_API_STATUS_IMPL(RunOptionsSetMemoryArenaShrinkage, _Inout_ OrtRunOptions* options, int value);
+ORT_API_STATUS_IMPL(SetIntraOpNumaNode, _Inout_ OrtSessionOptions* options, int numa_node);
+ORT_API_STATUS_IMPL(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data);
+ORT_API_STATUS_IMPL(SetAsyncRunThreadPoolSize, _Inout_ OrtSessionOptions* options, int async_run_thread_pool_size);
+ORT_API_STATUS_IMPL(CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out);
+ORT_API_STATUS_IMPL(RunWithPreparedRun, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const OrtPreparedRun* prepared_run,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _Inout_updates_all_(output_len) OrtValue** output, size_t output_len);
+ORT_API(void, ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun*);
+ORT_API_STATUS_IMPL(SetShareInitializers, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(SetUseMmapInitializers, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(SetSaveNodePlacements, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(SetUseSavedNodePlacements, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(CreateRequestBatcher, _Inout_ OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    size_t max_batch_size, int64_t max_delay_us, _Outptr_ OrtRequestBatcher** out);
+ORT_API_STATUS_IMPL(RequestBatcherRun, _Inout_ OrtRequestBatcher* batcher,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data);
+ORT_API_STATUS_IMPL(RequestBatcherGetStats, _In_ const OrtRequestBatcher* batcher, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API(void, ReleaseRequestBatcher, _Frees_ptr_opt_ OrtRequestBatcher*);
+ORT_API_STATUS_IMPL(SessionWarmup, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(input_len* shape_set_count) const int64_t* const* input_shapes,
+                    _In_reads_(input_len* shape_set_count) const size_t* input_shape_lens, size_t shape_set_count);
+ORT_API_STATUS_IMPL(SetEnableNodeStats, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(SessionGetNodeStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(SessionGetMetrics, _In_ const OrtSession* sess, OrtMetricsFormat format,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+ORT_API_STATUS_IMPL(SetEnableMemoryProfiling, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(SetEnableHardwareCounters, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(CreateSessionPool, _Inout_ OrtSession* sess, size_t num_workers, _Outptr_ OrtSessionPool** out);
+ORT_API_STATUS_IMPL(SessionPoolCheckout, _Inout_ OrtSessionPool* pool, int64_t timeout_us,
+                    _Outptr_result_maybenull_ OrtSessionPoolWorker** out);
+ORT_API_STATUS_IMPL(SessionPoolWorkerRun, _Inout_ OrtSessionPoolWorker* worker, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output);
+ORT_API_STATUS_IMPL(SessionPoolCheckin, _Inout_ OrtSessionPool* pool, _In_ OrtSessionPoolWorker* worker);
+ORT_API(void, ReleaseSessionPool, _Frees_ptr_opt_ OrtSessionPool*);
+ORT_API_STATUS_IMPL(CreateEnvWithAsyncLogging, OrtLoggingLevel default_logging_level, _In_ const char* logid,
+                    size_t queue_capacity, _Outptr_ OrtEnv** out);
+ORT_API_STATUS_IMPL(SetColumnarZipMapOutputs, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(SessionGetOutputMapKeys, _In_ const OrtSession* sess, size_t index, _Inout_ OrtAllocator* allocator,
+                    _Outptr_result_maybenull_ OrtValue** out);
+ORT_API_STATUS_IMPL(CreateSessionPipeline, _In_reads_(num_stages) OrtSession* const* stages, size_t num_stages,
+                    _Outptr_ OrtSessionPipeline** out);
+ORT_API_STATUS_IMPL(SessionPipelineRun, _Inout_ OrtSessionPipeline* pipeline, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len* num_micro_batches) const OrtValue* const* input, size_t input_len,
+                    size_t num_micro_batches,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Out_writes_all_(output_names_len* num_micro_batches) OrtValue** output);
+ORT_API(void, ReleaseSessionPipeline, _Frees_ptr_opt_ OrtSessionPipeline*);
+ORT_API_STATUS_IMPL(SetLazyInitialization, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(KernelContext_GetInputData, _In_ const OrtKernelContext* context, _In_ size_t index,
+                    _Outptr_result_maybenull_ const void** data,
+                    _Outptr_result_maybenull_ const int64_t** dim_values, _Out_ size_t* dim_count);
+ORT_API_STATUS_IMPL(KernelContext_GetOutputData, _Inout_ OrtKernelContext* context, _In_ size_t index,
+                    _In_ const int64_t* dim_values, size_t dim_count, _Outptr_ void** data);
+ORT_API_STATUS_IMPL(KernelInfoGetConstantInputData, _In_ const OrtKernelInfo* info, _In_ size_t index,
+                    _Out_ int* is_constant, _Outptr_result_maybenull_ const void** data,
+                    _Outptr_result_maybenull_ const int64_t** dim_values, _Out_ size_t* dim_count);
+ORT_API_STATUS_IMPL(KernelContext_ParallelFor, _In_ const OrtKernelContext* context,
+                    _In_ void(ORT_API_CALL* fn)(_In_opt_ void* user_data, size_t begin, size_t end),
+                    _In_opt_ void* user_data, size_t total, double cost_per_unit);
+ORT_API_STATUS_IMPL(SetSavePrepackedWeights, _Inout_ OrtSessionOptions* options, int value);
+ORT_API_STATUS_IMPL(SetUseSavedPrepackedWeights, _Inout_ OrtSessionOptions* options, int value);
 }  // namespace OrtApis
@@ -8,6 +8,7 @@
 #include "ort_env.h"
 #include "core/session/ort_apis.h"
 #include "core/session/environment.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/logging.h"
 
@@ -39,21 +40,20 @@ OrtEnv* OrtEnv::GetInstance(const OrtEnv::LoggingManagerConstructionInfo& lm_inf
   std::lock_guard<onnxruntime::OrtMutex> lock(m_);
   std::unique_ptr<LoggingManager> lmgr;
   std::string name = lm_info.logid;
+  std::unique_ptr<ISink> sink;
   if (lm_info.logging_function) {
-    std::unique_ptr<ISink> logger = onnxruntime::make_unique<LoggingWrapper>(lm_info.logging_function,
-                                                                             lm_info.logger_param);
-    lmgr.reset(new LoggingManager(std::move(logger),
-                                  static_cast<Severity>(lm_info.default_warning_level),
-                                  false,
-                                  LoggingManager::InstanceType::Default,
-                                  &name));
+    sink = onnxruntime::make_unique<LoggingWrapper>(lm_info.logging_function, lm_info.logger_param);
   } else {
-    lmgr.reset(new LoggingManager(std::unique_ptr<ISink>{new CLogSink{}},
-                                  static_cast<Severity>(lm_info.default_warning_level),
-                                  false,
-                                  LoggingManager::InstanceType::Default,
-                                  &name));
+    sink.reset(new CLogSink{});
   }
+  if (lm_info.async_log_queue_capacity > 0) {
+    sink = onnxruntime::make_unique<AsyncSink>(std::move(sink), lm_info.async_log_queue_capacity);
+  }
+  lmgr.reset(new LoggingManager(std::move(sink),
+                                static_cast<Severity>(lm_info.default_warning_level),
+                                false,
+                                LoggingManager::InstanceType::Default,
+                                &name));
 
   if (!p_instance_) {
     std::unique_ptr<onnxruntime::Environment> env;
@@ -40,6 +40,8 @@ struct OrtEnv {
     void* logger_param{};
     OrtLoggingLevel default_warning_level;
     const char* logid{};
+    // messages are written by a background thread through a queue of this many messages when greater than 0
+    size_t async_log_queue_capacity{};
   };
 
   static OrtEnv* GetInstance(const LoggingManagerConstructionInfo& lm_info,
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+/**
+ * The feeds and fetches of a Run call, resolved once for repeated calls with the same input and output names.
+ * It caches the mapping of the names to OrtValue indexes and the static device copy info, so a Run with it skips
+ * the name lookups done by a Run with name vectors.
+ * Usage is as follows:
+ *
+ * InferenceSession session;
+ * session.Load();
+ * session.Initialize();
+ * ...
+ * std::unique_ptr<PreparedRun> prepared_run;
+ * session.PrepareRun({"X"}, {"Y"}, prepared_run);
+ *
+ * std::vector<OrtValue> fetches;
+ * session.Run(run_options, *prepared_run, feeds, &fetches);
+ *
+ * A PreparedRun is immutable once created, so it can be shared by concurrent Run calls of the session that
+ * created it. It must not outlive that session.
+ */
+class PreparedRun {
+ public:
+  const std::vector<std::string>& GetFeedNames() const {
+    return feeds_fetches_manager_->GetFeedsFetchesInfo().feed_names;
+  }
+
+  const std::vector<std::string>& GetOutputNames() const {
+    return feeds_fetches_manager_->GetFeedsFetchesInfo().output_names;
+  }
+
+ private:
+  friend InferenceSession;
+
+  PreparedRun(const InferenceSession& session,
+              std::vector<const InferenceSession::InputDefMetaData*>&& input_defs,
+              std::unique_ptr<FeedsFetchesManager>&& feeds_fetches_manager)
+      : session_(session),
+        input_defs_(std::move(input_defs)),
+        feeds_fetches_manager_(std::move(feeds_fetches_manager)) {}
+
+  const InferenceSession& session_;
+
+  // definition of each feed, in the order of the feed names. owned by the session.
+  std::vector<const InferenceSession::InputDefMetaData*> input_defs_;
+
+  // initialized with the static copy info of the session state. finalized per Run if device copies may be needed.
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+};
+}  // namespace onnxruntime
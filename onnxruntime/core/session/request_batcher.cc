@@ -0,0 +1,333 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+// Returns the number of rows of a request, or 0 if its feeds are not CPU tensors with the same first dimension.
+static int64_t GetBatchRows(const std::vector<OrtValue>& feeds) {
+  int64_t num_rows = 0;
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return 0;
+    }
+
+    const auto& tensor = feed.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (tensor.IsDataTypeString() || tensor.Location().device.Type() != OrtDevice::CPU ||
+        shape.NumDimensions() == 0 || shape[0] <= 0 || (num_rows != 0 && shape[0] != num_rows)) {
+      return 0;
+    }
+    num_rows = shape[0];
+  }
+
+  return num_rows;
+}
+
+static OrtValue MakeTensorValue(MLDataType element_type, const TensorShape& shape, const AllocatorPtr& allocator) {
+  auto p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, allocator);
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  OrtValue value;
+  value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return value;
+}
+
+static TensorShape WithRows(const TensorShape& shape, int64_t num_rows) {
+  std::vector<int64_t> dims = shape.GetDims();
+  dims[0] = num_rows;
+  return TensorShape(dims);
+}
+
+RequestBatcher::RequestBatcher(InferenceSession& session, const std::vector<std::string>& feed_names,
+                               const std::vector<std::string>& output_names, size_t max_batch_size,
+                               std::chrono::microseconds max_delay)
+    : session_(session),
+      feed_names_(feed_names),
+      output_names_(output_names),
+      max_batch_size_(max_batch_size),
+      max_delay_(max_delay),
+      allocator_(std::make_shared<CPUAllocator>()) {
+  ORT_ENFORCE(max_batch_size_ >= 1, "RequestBatcher requires a max_batch_size of at least 1");
+  ORT_ENFORCE(max_delay_.count() >= 0, "RequestBatcher requires a non-negative max_delay");
+  dispatcher_ = std::thread([this]() { DispatchLoop(); });
+}
+
+RequestBatcher::~RequestBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  pending_cv_.notify_all();
+  dispatcher_.join();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  in_flight_cv_.wait(lock, [this]() { return num_in_flight_ == 0; });
+}
+
+common::Status RequestBatcher::Run(const std::vector<OrtValue>& feeds, Callback callback) {
+  if (feeds.size() != feed_names_.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "RequestBatcher expects ", feed_names_.size(),
+                           " feeds, got ", feeds.size());
+  }
+
+  if (callback == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "RequestBatcher requires a callback.");
+  }
+
+  Request request{feeds, std::move(callback), std::chrono::steady_clock::now(), GetBatchRows(feeds)};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "RequestBatcher is shutting down");
+    }
+    pending_.push_back(std::move(request));
+  }
+  pending_cv_.notify_one();
+  return Status::OK();
+}
+
+bool RequestBatcher::CanBatch(const Request& a, const Request& b) {
+  if (a.num_rows == 0 || b.num_rows == 0) {
+    return false;
+  }
+
+  for (size_t i = 0; i < a.feeds.size(); ++i) {
+    const auto& a_tensor = a.feeds[i].Get<Tensor>();
+    const auto& b_tensor = b.feeds[i].Get<Tensor>();
+    const auto& a_dims = a_tensor.Shape().GetDims();
+    const auto& b_dims = b_tensor.Shape().GetDims();
+    if (a_tensor.DataType() != b_tensor.DataType() || a_dims.size() != b_dims.size() ||
+        !std::equal(a_dims.begin() + 1, a_dims.end(), b_dims.begin() + 1)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+size_t RequestBatcher::SelectBatch(std::vector<size_t>& indices) const {
+  indices.clear();
+  indices.push_back(0);
+
+  const Request& first = pending_.front();
+  size_t num_rows = static_cast<size_t>(first.num_rows);
+  if (first.num_rows == 0) {
+    return 0;
+  }
+
+  // requests that would overflow the batch or can't be batched with the first one wait for a later batch
+  for (size_t i = 1; i < pending_.size() && num_rows < max_batch_size_; ++i) {
+    const Request& request = pending_[i];
+    if (num_rows + static_cast<size_t>(request.num_rows) <= max_batch_size_ && CanBatch(first, request)) {
+      indices.push_back(i);
+      num_rows += static_cast<size_t>(request.num_rows);
+    }
+  }
+
+  return num_rows;
+}
+
+bool RequestBatcher::IsBatchFull(size_t num_rows) const {
+  return num_rows == 0 || num_rows >= max_batch_size_;
+}
+
+void RequestBatcher::DispatchLoop() {
+  std::vector<size_t> indices;
+  for (;;) {
+    std::vector<Request> batch;
+    size_t num_rows = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      pending_cv_.wait(lock, [this]() { return shutdown_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        // shutting down and nothing left to run
+        return;
+      }
+
+      const auto deadline = pending_.front().enqueue_time + max_delay_;
+      num_rows = SelectBatch(indices);
+      while (!shutdown_ && !IsBatchFull(num_rows) && std::chrono::steady_clock::now() < deadline) {
+        pending_cv_.wait_until(lock, deadline);
+        num_rows = SelectBatch(indices);
+      }
+
+      batch.reserve(indices.size());
+      for (size_t index : indices) {
+        batch.push_back(std::move(pending_[index]));
+      }
+      for (auto it = indices.rbegin(); it != indices.rend(); ++it) {
+        pending_.erase(pending_.begin() + *it);
+      }
+      ++num_in_flight_;
+    }
+
+    RunBatch(std::move(batch), num_rows);
+  }
+}
+
+void RequestBatcher::RunBatch(std::vector<Request>&& batch, size_t num_rows) {
+  auto requests = std::make_shared<std::vector<Request>>(std::move(batch));
+
+  std::vector<OrtValue> feeds;
+  Status status;
+  if (requests->size() == 1) {
+    feeds = requests->front().feeds;
+  } else {
+    status = ConcatFeeds(*requests, num_rows, feeds);
+  }
+
+  if (status.IsOK()) {
+    status = session_.RunAsync(nullptr, feed_names_, feeds, output_names_,
+                               [this, requests, num_rows](const Status& run_status, std::vector<OrtValue>& fetches) {
+                                 std::vector<std::vector<OrtValue>> request_fetches;
+                                 Status batch_status = run_status;
+                                 if (batch_status.IsOK()) {
+                                   if (requests->size() == 1) {
+                                     request_fetches.push_back(std::move(fetches));
+                                   } else {
+                                     batch_status = SplitFetches(*requests, num_rows, fetches, request_fetches);
+                                   }
+                                 }
+                                 Complete(*requests, batch_status, request_fetches);
+                               });
+  }
+
+  if (!status.IsOK()) {
+    std::vector<std::vector<OrtValue>> request_fetches;
+    Complete(*requests, status, request_fetches);
+  }
+}
+
+common::Status RequestBatcher::ConcatFeeds(const std::vector<Request>& batch, size_t num_rows,
+                                           std::vector<OrtValue>& feeds) const {
+  feeds.clear();
+  feeds.reserve(feed_names_.size());
+  for (size_t i = 0; i < feed_names_.size(); ++i) {
+    const auto& first = batch.front().feeds[i].Get<Tensor>();
+    OrtValue value = MakeTensorValue(first.DataType(), WithRows(first.Shape(), static_cast<int64_t>(num_rows)),
+                                     allocator_);
+    auto* dst = static_cast<uint8_t*>(value.GetMutable<Tensor>()->MutableDataRaw());
+    for (const auto& request : batch) {
+      const auto& tensor = request.feeds[i].Get<Tensor>();
+      const size_t size = tensor.SizeInBytes();
+      if (size > 0) {
+        memcpy(dst, tensor.DataRaw(), size);
+      }
+      dst += size;
+    }
+    feeds.push_back(std::move(value));
+  }
+
+  return Status::OK();
+}
+
+common::Status RequestBatcher::SplitFetches(const std::vector<Request>& batch, size_t num_rows,
+                                            const std::vector<OrtValue>& fetches,
+                                            std::vector<std::vector<OrtValue>>& request_fetches) const {
+  request_fetches.assign(batch.size(), std::vector<OrtValue>());
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    const auto& fetch = fetches[i];
+    const Tensor* tensor = fetch.IsTensor() ? &fetch.Get<Tensor>() : nullptr;
+    if (tensor == nullptr || tensor->IsDataTypeString() || tensor->Location().device.Type() != OrtDevice::CPU ||
+        tensor->Shape().NumDimensions() == 0 || tensor->Shape()[0] != static_cast<int64_t>(num_rows)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The output ", output_names_[i],
+                             " is not a CPU tensor batched along its first dimension, so the requests can't be "
+                             "batched.");
+    }
+
+    const size_t row_size = tensor->SizeInBytes() / num_rows;
+    const auto* src = static_cast<const uint8_t*>(tensor->DataRaw());
+    for (size_t r = 0; r < batch.size(); ++r) {
+      const int64_t request_rows = batch[r].num_rows;
+      OrtValue value = MakeTensorValue(tensor->DataType(), WithRows(tensor->Shape(), request_rows), allocator_);
+      const size_t size = row_size * static_cast<size_t>(request_rows);
+      if (size > 0) {
+        memcpy(value.GetMutable<Tensor>()->MutableDataRaw(), src, size);
+      }
+      src += size;
+      request_fetches[r].push_back(std::move(value));
+    }
+  }
+
+  return Status::OK();
+}
+
+void RequestBatcher::Complete(std::vector<Request>& batch, const common::Status& status,
+                              std::vector<std::vector<OrtValue>>& request_fetches) {
+  const auto now = std::chrono::steady_clock::now();
+  // the stats are updated first so they include the batch once its callbacks have run
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.num_requests += batch.size();
+    ++stats_.num_batches;
+    if (stats_.batch_size_counts.size() <= batch.size()) {
+      stats_.batch_size_counts.resize(batch.size() + 1);
+    }
+    ++stats_.batch_size_counts[batch.size()];
+
+    for (const auto& request : batch) {
+      auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(now - request.enqueue_time).count();
+      size_t bucket = 0;
+      while (latency_us > 0) {
+        latency_us >>= 1;
+        ++bucket;
+      }
+      if (stats_.latency_us_counts.size() <= bucket) {
+        stats_.latency_us_counts.resize(bucket + 1);
+      }
+      ++stats_.latency_us_counts[bucket];
+    }
+  }
+
+  std::vector<OrtValue> no_fetches;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    std::vector<OrtValue>& fetches = status.IsOK() ? request_fetches[i] : no_fetches;
+    try {
+      batch[i].callback(status, fetches);
+    } catch (const std::exception& e) {
+      LOGS_DEFAULT(ERROR) << "Exception in the RequestBatcher callback: " << e.what();
+    } catch (...) {
+      LOGS_DEFAULT(ERROR) << "Unknown exception in the RequestBatcher callback";
+    }
+  }
+
+  // the batcher may be destroyed as soon as num_in_flight_ is decremented, so it is notified under the lock
+  std::lock_guard<std::mutex> lock(mutex_);
+  --num_in_flight_;
+  in_flight_cv_.notify_all();
+}
+
+RequestBatcher::Stats RequestBatcher::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+std::string RequestBatcher::GetStatsJson() const {
+  const Stats stats = GetStats();
+  const auto write_counts = [](std::ostringstream& out, const std::vector<size_t>& counts) {
+    out << "[";
+    for (size_t i = 0; i < counts.size(); ++i) {
+      out << (i == 0 ? "" : ", ") << counts[i];
+    }
+    out << "]";
+  };
+
+  std::ostringstream out;
+  out << "{\"num_requests\": " << stats.num_requests << ", \"num_batches\": " << stats.num_batches
+      << ", \"batch_size_counts\": ";
+  write_counts(out, stats.batch_size_counts);
+  out << ", \"latency_us_counts\": ";
+  write_counts(out, stats.latency_us_counts);
+  out << "}";
+  return out.str();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+/**
+ * Coalesces concurrent requests for the same inputs and outputs of a session into batched runs.
+ * Requests whose inputs have the same element types and the same shapes except for the first, batch, dimension are
+ * concatenated along that dimension until the batch reaches max_batch_size rows or the oldest request has waited
+ * max_delay. The batch is run with InferenceSession::RunAsync and the rows of each output are scattered back to
+ * the requests, so all the outputs must be batched along their first dimension.
+ * Requests with inputs that aren't CPU tensors, or can't be batched, are run on their own.
+ * Usage is as follows:
+ *
+ * RequestBatcher batcher(session, {"X"}, {"Y"}, 32, std::chrono::microseconds(500));
+ * batcher.Run({x}, [](const Status& status, std::vector<OrtValue>& fetches) { ... });
+ *
+ * The batcher must not outlive the session. The destructor runs the pending requests and waits for them.
+ */
+class RequestBatcher {
+ public:
+  using Callback = InferenceSession::RunAsyncCallback;
+
+  struct Stats {
+    size_t num_requests = 0;
+    size_t num_batches = 0;
+    // number of batches of each size, indexed by the number of requests in the batch
+    std::vector<size_t> batch_size_counts;
+    // number of requests whose latency in microseconds, from Run to the invocation of its callback, was in
+    // [2^(i-1), 2^i) for i > 0, or below 1 for i == 0
+    std::vector<size_t> latency_us_counts;
+  };
+
+  RequestBatcher(InferenceSession& session, const std::vector<std::string>& feed_names,
+                 const std::vector<std::string>& output_names, size_t max_batch_size,
+                 std::chrono::microseconds max_delay);
+  ~RequestBatcher();
+
+  /**
+   * Queue a request with the feeds in the order of the feed names of the batcher. This API is thread-safe.
+   * @param callback invoked on a thread of the session with the fetches of the request in the order of the output
+   *        names. The errors of the batched run are reported to all the requests of the batch.
+   * @return OK if the request was queued.
+   */
+  common::Status Run(const std::vector<OrtValue>& feeds, Callback callback) ORT_MUST_USE_RESULT;
+
+  Stats GetStats() const;
+
+  // Serialize the stats as a JSON object.
+  std::string GetStatsJson() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RequestBatcher);
+
+  struct Request {
+    std::vector<OrtValue> feeds;
+    Callback callback;
+    std::chrono::steady_clock::time_point enqueue_time;
+    // number of rows along the batch dimension, or 0 if the request can't be batched
+    int64_t num_rows;
+  };
+
+  static bool CanBatch(const Request& a, const Request& b);
+
+  void DispatchLoop();
+  // Select the pending requests of the next batch, returning its number of rows. The batch is full if the returned
+  // value is at least max_batch_size_ or if the first request can't be batched.
+  size_t SelectBatch(std::vector<size_t>& indices) const;
+  bool IsBatchFull(size_t num_rows) const;
+  void RunBatch(std::vector<Request>&& batch, size_t num_rows);
+  common::Status ConcatFeeds(const std::vector<Request>& batch, size_t num_rows,
+                             std::vector<OrtValue>& feeds) const;
+  common::Status SplitFetches(const std::vector<Request>& batch, size_t num_rows, const std::vector<OrtValue>& fetches,
+                              std::vector<std::vector<OrtValue>>& request_fetches) const;
+  void Complete(std::vector<Request>& batch, const common::Status& status,
+                std::vector<std::vector<OrtValue>>& request_fetches);
+
+  InferenceSession& session_;
+  const std::vector<std::string> feed_names_;
+  const std::vector<std::string> output_names_;
+  const size_t max_batch_size_;
+  const std::chrono::microseconds max_delay_;
+  AllocatorPtr allocator_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable pending_cv_;
+  std::condition_variable in_flight_cv_;
+  std::deque<Request> pending_;
+  size_t num_in_flight_ = 0;
+  bool shutdown_ = false;
+  Stats stats_;
+
+  std::thread dispatcher_;
+};
+
+}  // namespace onnxruntime
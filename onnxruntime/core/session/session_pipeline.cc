@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/session_pipeline.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace onnxruntime {
+
+SessionPipeline::SessionPipeline(const std::vector<InferenceSession*>& stages) {
+  ORT_ENFORCE(!stages.empty(), "SessionPipeline requires at least one stage");
+  stages_.reserve(stages.size());
+  for (InferenceSession* session : stages) {
+    ORT_ENFORCE(session != nullptr, "The session of a stage is null");
+    auto stage = onnxruntime::make_unique<Stage>(*session);
+
+    auto inputs = session->GetModelInputs();
+    ORT_THROW_IF_ERROR(inputs.first);
+    for (const auto* input : *inputs.second) {
+      stage->input_names.push_back(input->Name());
+    }
+    auto outputs = session->GetModelOutputs();
+    ORT_THROW_IF_ERROR(outputs.first);
+    for (const auto* output : *outputs.second) {
+      stage->output_names.push_back(output->Name());
+    }
+    ORT_THROW_IF_ERROR(session->PrepareRun(stage->input_names, stage->output_names, stage->prepared_run));
+
+    stages_.push_back(std::move(stage));
+  }
+
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    stages_[i]->thread = std::thread([this, i]() { StageLoop(i); });
+  }
+}
+
+SessionPipeline::~SessionPipeline() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& stage : stages_) {
+    stage->thread.join();
+  }
+}
+
+common::Status SessionPipeline::RunStage(Stage& stage, std::unordered_map<std::string, OrtValue>& values) {
+  std::vector<OrtValue> feeds;
+  feeds.reserve(stage.input_names.size());
+  for (const auto& name : stage.input_names) {
+    feeds.push_back(values.at(name));
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(stage.session.Run(*run_options_, *stage.prepared_run, feeds, &fetches));
+
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    values[stage.output_names[i]] = std::move(fetches[i]);
+  }
+  for (const auto& name : stage.released_names) {
+    values.erase(name);
+  }
+  return Status::OK();
+}
+
+void SessionPipeline::StageLoop(size_t stage_index) {
+  Stage& stage = *stages_[stage_index];
+  uint64_t run_id = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this, run_id]() { return shutdown_ || run_id_ != run_id; });
+      if (shutdown_) {
+        return;
+      }
+      run_id = run_id_;
+    }
+
+    for (size_t i = 0; i < values_.size(); ++i) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // wait for the previous stage to run the micro batch, or for a stage to fail
+        cv_.wait(lock, [this, stage_index, i]() {
+          return !status_.IsOK() || stage_index == 0 || stages_[stage_index - 1]->completed > i;
+        });
+        if (!status_.IsOK()) {
+          break;
+        }
+      }
+
+      Status status = RunStage(stage, values_[i]);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!status.IsOK() && status_.IsOK()) {
+          status_ = status;
+        }
+        ++stage.completed;
+      }
+      cv_.notify_all();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stage.done = true;
+    }
+    cv_.notify_all();
+  }
+}
+
+common::Status SessionPipeline::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                    const std::vector<std::vector<OrtValue>>& micro_batch_feeds,
+                                    const std::vector<std::string>& output_names,
+                                    std::vector<std::vector<OrtValue>>& micro_batch_fetches) {
+  std::lock_guard<std::mutex> run_lock(run_mutex_);
+
+  for (const auto& feeds : micro_batch_feeds) {
+    ORT_RETURN_IF_NOT(feeds.size() == feed_names.size(),
+                      "Each micro batch must have a value for each of the ", feed_names.size(), " feed names");
+  }
+
+  // the stage after which each value is no longer used
+  std::unordered_map<std::string, size_t> last_stages;
+  for (const auto& name : feed_names) {
+    last_stages[name] = 0;
+  }
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    for (const auto& name : stages_[i]->input_names) {
+      auto it = last_stages.find(name);
+      ORT_RETURN_IF_NOT(it != last_stages.end(), "Input ", name, " of stage ", i,
+                        " is neither fed nor an output of an earlier stage");
+      it->second = std::max(it->second, i);
+    }
+    for (const auto& name : stages_[i]->output_names) {
+      last_stages[name] = i;
+    }
+  }
+
+  const std::unordered_set<std::string> output_name_set(output_names.begin(), output_names.end());
+  for (const auto& name : output_names) {
+    ORT_RETURN_IF_NOT(last_stages.find(name) != last_stages.end(), "Output ", name,
+                      " is neither fed nor an output of a stage");
+  }
+  for (auto& stage : stages_) {
+    stage->released_names.clear();
+  }
+  for (const auto& last_stage : last_stages) {
+    if (output_name_set.find(last_stage.first) == output_name_set.end()) {
+      stages_[last_stage.second]->released_names.push_back(last_stage.first);
+    }
+  }
+
+  Status status;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    run_options_ = &run_options;
+    values_.assign(micro_batch_feeds.size(), {});
+    for (size_t i = 0; i < micro_batch_feeds.size(); ++i) {
+      for (size_t j = 0; j < feed_names.size(); ++j) {
+        values_[i][feed_names[j]] = micro_batch_feeds[i][j];
+      }
+    }
+    status_ = Status::OK();
+    for (auto& stage : stages_) {
+      stage->completed = 0;
+      stage->done = false;
+    }
+    ++run_id_;
+    cv_.notify_all();
+
+    cv_.wait(lock, [this]() {
+      return std::all_of(stages_.begin(), stages_.end(), [](const std::unique_ptr<Stage>& stage) {
+        return stage->done;
+      });
+    });
+    status = status_;
+  }
+
+  if (status.IsOK()) {
+    micro_batch_fetches.assign(values_.size(), {});
+    for (size_t i = 0; i < values_.size(); ++i) {
+      micro_batch_fetches[i].reserve(output_names.size());
+      for (const auto& name : output_names) {
+        micro_batch_fetches[i].push_back(values_[i].at(name));
+      }
+    }
+  }
+  values_.clear();
+  run_options_ = nullptr;
+  return status;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/session/inference_session.h"
+#include "core/session/prepared_run.h"
+
+namespace onnxruntime {
+
+/**
+ * Runs a model split into consecutive stages, one session per stage, over a batch of inputs divided into micro
+ * batches, such as a model too large for one GPU with each stage using the CUDA execution provider of another device.
+ * Each stage runs on a dedicated thread, so while a stage runs micro batch i the next one runs micro batch i - 1 and
+ * all the devices are kept busy.
+ * The inputs of a stage are taken by name from the feeds or from the outputs of the earlier stages for the same micro
+ * batch, which are copied to the device of the stage by the session as with any feed. The values are released once
+ * no later stage uses them.
+ * Usage is as follows:
+ *
+ * SessionPipeline pipeline({&stage0, &stage1});
+ * pipeline.Run(run_options, {"input_ids"}, micro_batch_feeds, {"logits"}, micro_batch_fetches);
+ *
+ * The sessions must outlive the pipeline.
+ */
+class SessionPipeline {
+ public:
+  explicit SessionPipeline(const std::vector<InferenceSession*>& stages);
+  ~SessionPipeline();
+
+  /**
+   * Run the micro batches through the stages. micro_batch_feeds holds the values of feed_names for each micro
+   * batch, and micro_batch_fetches is set to the values of output_names for each micro batch.
+   * Concurrent calls run one after the other.
+   */
+  common::Status Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                     const std::vector<std::vector<OrtValue>>& micro_batch_feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<std::vector<OrtValue>>& micro_batch_fetches) ORT_MUST_USE_RESULT;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionPipeline);
+
+  struct Stage {
+    explicit Stage(InferenceSession& session) : session(session) {}
+
+    InferenceSession& session;
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+    std::unique_ptr<PreparedRun> prepared_run;
+    // names of the values of a micro batch that neither a later stage nor the caller uses once this stage ran it
+    std::vector<std::string> released_names;
+    // number of micro batches of the current Run this stage has run
+    size_t completed = 0;
+    // whether this stage is done with the current Run, having run all the micro batches or stopped after a failure
+    bool done = true;
+    std::thread thread;
+  };
+
+  void StageLoop(size_t stage_index);
+  common::Status RunStage(Stage& stage, std::unordered_map<std::string, OrtValue>& values);
+
+  std::vector<std::unique_ptr<Stage>> stages_;
+
+  // serializes the calls to Run
+  std::mutex run_mutex_;
+
+  // the state of the current Run shared with the stage threads
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t run_id_ = 0;
+  const RunOptions* run_options_ = nullptr;
+  // values by name for each micro batch. a stage only uses the values of a micro batch once the previous stage ran
+  // it, and the next stage only once this stage ran it, so they are accessed without the lock.
+  std::vector<std::unordered_map<std::string, OrtValue>> values_;
+  common::Status status_;
+  bool shutdown_ = false;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/session_pool.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+SessionPool::Worker::Worker(InferenceSession& session) : session_(session) {
+  thread_ = std::thread([this]() { ThreadLoop(); });
+}
+
+SessionPool::Worker::~Worker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void SessionPool::Worker::ThreadLoop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return shutdown_ || task_ != nullptr; });
+      if (task_ == nullptr) {
+        // shutting down and nothing left to run
+        return;
+      }
+      task = std::move(task_);
+      task_ = nullptr;
+    }
+
+    task();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_done_ = true;
+    }
+    cv_.notify_all();
+  }
+}
+
+common::Status SessionPool::Worker::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                        const std::vector<OrtValue>& feeds,
+                                        const std::vector<std::string>& output_names,
+                                        std::vector<OrtValue>* p_fetches) {
+  if (prepared_run_ == nullptr || prepared_run_->GetFeedNames() != feed_names ||
+      prepared_run_->GetOutputNames() != output_names) {
+    prepared_run_.reset();
+    ORT_RETURN_IF_ERROR(session_.PrepareRun(feed_names, output_names, prepared_run_));
+  }
+
+  // the run executes on the thread of the worker, so the per thread state of the execution providers is the one
+  // of the worker whichever thread checked it out
+  Status status;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_done_ = false;
+    // InferenceSession::Run reports the exceptions of the run in its status
+    task_ = [this, &run_options, &feeds, p_fetches, &status]() {
+      status = session_.Run(run_options, *prepared_run_, feeds, p_fetches);
+    };
+    cv_.notify_all();
+    cv_.wait(lock, [this]() { return task_done_; });
+  }
+
+  return status;
+}
+
+SessionPool::SessionPool(InferenceSession& session, size_t num_workers) {
+  ORT_ENFORCE(num_workers >= 1, "SessionPool requires at least one worker");
+  workers_.reserve(num_workers);
+  idle_workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(new Worker(session));
+    idle_workers_.push_back(workers_.back().get());
+  }
+}
+
+SessionPool::~SessionPool() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cv_.wait(lock, [this]() { return idle_workers_.size() == workers_.size(); });
+}
+
+SessionPool::Worker* SessionPool::Checkout(std::chrono::microseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto has_idle_worker = [this]() { return !idle_workers_.empty(); };
+  if (timeout.count() < 0) {
+    idle_cv_.wait(lock, has_idle_worker);
+  } else if (!idle_cv_.wait_for(lock, timeout, has_idle_worker)) {
+    return nullptr;
+  }
+
+  Worker* worker = idle_workers_.back();
+  idle_workers_.pop_back();
+  return worker;
+}
+
+void SessionPool::Checkin(Worker* worker) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ORT_ENFORCE(std::find_if(workers_.begin(), workers_.end(),
+                           [worker](const std::unique_ptr<Worker>& w) { return w.get() == worker; }) != workers_.end(),
+              "The worker doesn't belong to this pool");
+  ORT_ENFORCE(std::find(idle_workers_.begin(), idle_workers_.end(), worker) == idle_workers_.end(),
+              "The worker is already checked in");
+  idle_workers_.push_back(worker);
+  // the destructor may be waiting along with callers of Checkout. notify under the lock as the destructor may
+  // return, and destroy the condition variable, as soon as the lock is released.
+  idle_cv_.notify_all();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/session/inference_session.h"
+#include "core/session/prepared_run.h"
+
+namespace onnxruntime {
+
+/**
+ * A pool of workers running a session for concurrent callers. The workers share the graph, the kernels and the
+ * initializers of the session, while each worker runs on a dedicated thread that stays alive with the pool, so the
+ * state execution providers keep per thread (such as the stream, the library handles and the arena of a CUDA
+ * PerThreadContext) stays warm for the worker and isn't contended by the other workers. A worker also keeps the
+ * feeds and fetches of its most recent input and output names resolved.
+ * Usage is as follows:
+ *
+ * SessionPool pool(session, 4);
+ * SessionPool::Worker* worker = pool.Checkout(std::chrono::microseconds(-1));
+ * worker->Run(run_options, {"X"}, feeds, {"Y"}, &fetches);
+ * pool.Checkin(worker);
+ *
+ * A checked out worker is used by a single caller at a time. The pool must not outlive the session. The destructor
+ * waits for the checked out workers to be checked in.
+ */
+class SessionPool {
+ public:
+  class Worker {
+   public:
+    /**
+     * Same as InferenceSession::Run, executed on the thread of the worker. The caller waits for the run.
+     */
+    common::Status Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                       const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                       std::vector<OrtValue>* p_fetches) ORT_MUST_USE_RESULT;
+
+    ~Worker();
+
+   private:
+    friend SessionPool;
+
+    explicit Worker(InferenceSession& session);
+
+    void ThreadLoop();
+
+    InferenceSession& session_;
+
+    // feeds and fetches of the most recent Run, reused while the names don't change
+    std::unique_ptr<PreparedRun> prepared_run_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::function<void()> task_;
+    bool task_done_ = false;
+    bool shutdown_ = false;
+    std::thread thread_;
+
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Worker);
+  };
+
+  SessionPool(InferenceSession& session, size_t num_workers);
+  ~SessionPool();
+
+  /**
+   * Take an idle worker, waiting up to timeout for one to be checked in. A negative timeout waits indefinitely.
+   * This API is thread-safe.
+   * @return the worker, or nullptr if none became idle within the timeout.
+   */
+  Worker* Checkout(std::chrono::microseconds timeout);
+
+  /**
+   * Return a worker taken by Checkout to the pool. This API is thread-safe.
+   */
+  void Checkin(Worker* worker);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionPool);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable idle_cv_;
+  // most recently checked in last, so the warmest worker is handed out first
+  std::vector<Worker*> idle_workers_;
+};
+
+}  // namespace onnxruntime
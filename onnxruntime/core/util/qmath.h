@@ -8,11 +8,11 @@
 #include <cfenv>
 #include <cmath>
 
-#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__) || defined(_M_ARM64) || defined(__aarch64__)
 #define MLAS_SUPPORTS_GEMM_U8X8
 #endif
 
-#if defined(_M_AMD64) || defined(__x86_64__)
+#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_ARM64) || defined(__aarch64__)
 #define MLAS_SUPPORTS_PACKED_GEMM_U8X8
 #endif
 
@@ -50,6 +50,9 @@ void QGemm(
     const float* bias,
     concurrency::ThreadPool* thread_pool);
 
+// Computes the scale and zero point quantizing the range of data, extended to include zero, to uint8.
+void GetQuantizationParameter(const float* data, int64_t num_of_elements, float& scale, uint8_t& zp);
+
 inline float RoundHalfToEven(float input) {
   std::fesetround(FE_TONEAREST);
   auto result = std::nearbyintf(input);
@@ -2,6 +2,7 @@
 #include <algorithm>
 
 #include <core/common/make_unique.h>
+#include "core/common/logging/logging.h"
 #ifdef _WIN32
 #include <Windows.h>
 #endif
@@ -17,6 +18,22 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
   if (options.affinity_vec_len != 0) {
     to.affinity.assign(options.affinity_vec, options.affinity_vec + options.affinity_vec_len);
+  } else if (options.numa_node >= 0) {
+    cpu_list = Env::Default().GetNumaNodeThreadAffinityMasks(options.numa_node);
+    if (cpu_list.empty()) {
+      LOGS_DEFAULT(WARNING) << "Can't get the processors of NUMA node " << options.numa_node
+                            << ". The thread pool won't be bound to it.";
+    } else {
+      if (options.thread_pool_size <= 0) {
+        options.thread_pool_size = static_cast<int>(cpu_list.size());
+      }
+      if (options.thread_pool_size == 1)
+        return nullptr;
+      // the thread affinity is indexed by thread id, so share the node's processors if there are more threads
+      for (int i = 0; i < options.thread_pool_size; ++i) {
+        to.affinity.push_back(cpu_list[i % cpu_list.size()]);
+      }
+    }
   }
   if (options.thread_pool_size <= 0) {  // default
     cpu_list = Env::Default().GetThreadAffinityMasks();
@@ -28,7 +45,7 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   }
 
   return onnxruntime::make_unique<ThreadPool>(env, to, options.name, options.thread_pool_size,
-                                              options.allow_spinning);
+                                              options.allow_spinning, options.adaptive_spinning);
 }
 
 std::unique_ptr<ThreadPool>
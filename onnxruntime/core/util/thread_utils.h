@@ -18,6 +18,9 @@ struct OrtThreadPoolParams {
   bool auto_set_affinity = false;
   //If it is true, the thread pool will spin a while after the queue became empty.
   bool allow_spinning = true;
+  //If it is true and allow_spinning is true, each thread tunes how long it spins from the observed gaps
+  //between work items instead of always spinning for the maximum duration.
+  bool adaptive_spinning = false;
 
   unsigned int stack_size = 0;
   //Index is thread id, value is processor ID
@@ -25,6 +28,9 @@ struct OrtThreadPoolParams {
   size_t* affinity_vec = nullptr;
   size_t affinity_vec_len = 0;
   const ORTCHAR_T* name = nullptr;
+  //If it is not negative and no affinity_vec is given, bind the threads to the processors of this NUMA node.
+  //If thread_pool_size = 0, the pool gets one thread per processor of the node.
+  int numa_node = -1;
 };
 
 struct OrtThreadingOptions {
@@ -6,6 +6,8 @@
 #include "core/framework/data_types_internal.h"
 #include "core/framework/op_kernel.h"
 
+#include <mutex>
+
 #include "Featurizers/LagLeadOperatorFeaturizer.h"
 #include "Featurizers/../Archive.h"
 
@@ -14,9 +16,11 @@ namespace NS = Microsoft::Featurizer;
 namespace onnxruntime {
 namespace featurizers {
 
+// streaming_transformer is null unless the node streams, in which case it holds the transformer, along with the
+// history of the grains, from one call to the next and the call only processes the rows it is given.
 template <typename T>
 struct LagLeadOperatorTransformerImpl {
-  void operator()(OpKernelContext* ctx) const {
+  void operator()(OpKernelContext* ctx, std::shared_ptr<void>* streaming_transformer) const {
 
     using GrainT = std::vector<std::string>;
     using EstimatorT = Microsoft::Featurizer::Featurizers::GrainedLagLeadOperatorEstimator<T>;
@@ -24,12 +28,21 @@ struct LagLeadOperatorTransformerImpl {
     using OutputMatrixDataType = typename NS::Traits<T>::nullable_type;
     using OutputMatrixType = NS::RowMajMatrix<OutputMatrixDataType>;
     using OutputType = std::tuple<GrainT, OutputMatrixType>;
+    using TransformerT = typename EstimatorT::TransformerType;
 
     //Get the transformer
-    const auto* state_tensor(ctx->Input<Tensor>(0));
-    const uint8_t* const state_data(state_tensor->Data<uint8_t>());
-    Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().Size());
-    typename EstimatorT::TransformerType transformer(archive);
+    std::shared_ptr<TransformerT> transformer;
+    if (streaming_transformer != nullptr && *streaming_transformer != nullptr) {
+      transformer = std::static_pointer_cast<TransformerT>(*streaming_transformer);
+    } else {
+      const auto* state_tensor(ctx->Input<Tensor>(0));
+      const uint8_t* const state_data(state_tensor->Data<uint8_t>());
+      Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().Size());
+      transformer = std::make_shared<TransformerT>(archive);
+      if (streaming_transformer != nullptr) {
+        *streaming_transformer = transformer;
+      }
+    }
 
     // Get the Grains
     const auto* grains_tensor(ctx->Input<Tensor>(1));
@@ -50,8 +63,9 @@ struct LagLeadOperatorTransformerImpl {
 
     T* output_data = nullptr;
     bool has_allocate_output_data = false;
+    int64_t num_output_rows = 0;
     std::function<void(OutputType)> callback_fn;
-    callback_fn = [ctx, &output_grains_data, &output_data, &has_allocate_output_data, output_dim_0](OutputType value) -> void {
+    callback_fn = [ctx, &output_grains_data, &output_data, &has_allocate_output_data, &num_output_rows, output_dim_0](OutputType value) -> void {
       GrainT & output_grains(std::get<0>(value));
       const OutputMatrixType & output_matrix(std::get<1>(value));
       //Allocate tensor memory after first output is generated
@@ -67,6 +81,7 @@ struct LagLeadOperatorTransformerImpl {
       Eigen::Map<OutputMatrixType> output_matrix_mapping(output_data, output_matrix.rows(), output_matrix.cols());
       output_matrix_mapping = output_matrix;
       output_data += output_matrix.size();
+      ++num_output_rows;
     };
 
     // Transform
@@ -78,26 +93,44 @@ struct LagLeadOperatorTransformerImpl {
       std::copy(grains_data, grains_data + grains_num, std::back_inserter(grains));
       const GrainedInputType input_tuple(grains, *target_data);
       //Execute
-      transformer.execute(input_tuple, callback_fn);
+      transformer->execute(input_tuple, callback_fn);
       //Pointer Increment
       target_data++;
       grains_data += grains_num;
     }
-    transformer.flush(callback_fn);
+    // flushing outputs the rows waiting for their leads and resets the history
+    if (streaming_transformer == nullptr) {
+      transformer->flush(callback_fn);
+    } else {
+      ORT_ENFORCE(num_output_rows == output_dim_0,
+                  "Streaming LagLeadOperatorTransformer requires every row to be output when it is given, "
+                  "which isn't the case with lead offsets");
+    }
   }
 };
 
 class LagLeadOperatorTransformer final : public OpKernel {
  public:
-  explicit LagLeadOperatorTransformer(const OpKernelInfo& info) : OpKernel(info) {
+  explicit LagLeadOperatorTransformer(const OpKernelInfo& info) : OpKernel(info),
+      streaming_(info.GetAttrOrDefault<int64_t>("streaming", 0) != 0) {
   }
 
   Status Compute(OpKernelContext* ctx) const override {
     utils::MLTypeCallDispatcher<LagLeadOperatorTransformerImpl, float, double>
         t_disp(ctx->Input<Tensor>(2)->GetElementType());
-    t_disp.Invoke(ctx);
+    if (streaming_) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      t_disp.Invoke(ctx, &transformer_);
+    } else {
+      t_disp.Invoke(ctx, nullptr);
+    }
     return Status::OK();
   }
+
+ private:
+  const bool streaming_;
+  mutable std::mutex mutex_;
+  mutable std::shared_ptr<void> transformer_;
 };
 
 ONNX_OPERATOR_KERNEL_EX(
@@ -6,6 +6,8 @@
 #include "core/framework/data_types_internal.h"
 #include "core/framework/op_kernel.h"
 
+#include <mutex>
+
 #include "Featurizers/AnalyticalRollingWindowFeaturizer.h"
 #include "Featurizers/SimpleRollingWindowFeaturizer.h"
 #include "Featurizers/../Archive.h"
@@ -13,18 +15,29 @@
 namespace onnxruntime {
 namespace featurizers {
 
+// streaming_transformer is null unless the node streams, in which case it holds the transformer, along with the
+// windows of the grains, from one call to the next and the call only processes the rows it is given.
 template <typename T, typename EstimatorT, typename MatrixElementType>
-void RollingWindowTransformerImpl(OpKernelContext* ctx) {
+void RollingWindowTransformerImpl(OpKernelContext* ctx, std::shared_ptr<void>* streaming_transformer) {
   // Define the type
   using GrainT = std::vector<std::string>;
   using GrainedInputType = typename EstimatorT::InputType;
   using OutputType = typename EstimatorT::TransformedType;
+  using TransformerT = typename EstimatorT::TransformerType;
 
   //Get the transformer
-  const auto* state_tensor(ctx->Input<Tensor>(0));
-  const uint8_t* const state_data(state_tensor->Data<uint8_t>());
-  Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().Size());
-  typename EstimatorT::TransformerType transformer(archive);
+  std::shared_ptr<TransformerT> transformer;
+  if (streaming_transformer != nullptr && *streaming_transformer != nullptr) {
+    transformer = std::static_pointer_cast<TransformerT>(*streaming_transformer);
+  } else {
+    const auto* state_tensor(ctx->Input<Tensor>(0));
+    const uint8_t* const state_data(state_tensor->Data<uint8_t>());
+    Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().Size());
+    transformer = std::make_shared<TransformerT>(archive);
+    if (streaming_transformer != nullptr) {
+      *streaming_transformer = transformer;
+    }
+  }
 
   // Get the Grains
   const auto* grains_tensor(ctx->Input<Tensor>(1));
@@ -63,52 +76,77 @@ void RollingWindowTransformerImpl(OpKernelContext* ctx) {
     std::copy(grains_data, grains_data + grains_num, std::back_inserter(grains));
     const GrainedInputType input_tuple(grains, *target_data);
     //Execute
-    transformer.execute(input_tuple, callback_fn);
+    transformer->execute(input_tuple, callback_fn);
     //Increment Pointer
     target_data++;
     grains_data += grains_num;
   }
-  transformer.flush(callback_fn);
+  // flushing resets the windows
+  if (streaming_transformer == nullptr) {
+    transformer->flush(callback_fn);
+  }
 }
 
 template <typename T>
 struct AnalyticalRollingWindowTransformerImpl {
-  void operator()(OpKernelContext* ctx) const {
+  void operator()(OpKernelContext* ctx, std::shared_ptr<void>* streaming_transformer) const {
     RollingWindowTransformerImpl<T, Microsoft::Featurizer::Featurizers::GrainedAnalyticalRollingWindowEstimator<T>, double>(ctx);
   }
 };
 
 template <typename T>
 struct SimpleRollingWindowTransformerImpl {
-  void operator()(OpKernelContext* ctx) const {
+  void operator()(OpKernelContext* ctx, std::shared_ptr<void>* streaming_transformer) const {
     RollingWindowTransformerImpl<T, Microsoft::Featurizer::Featurizers::GrainedSimpleRollingWindowEstimator<T>, T>(ctx);
   }
 };
 
 class AnalyticalRollingWindowTransformer final : public OpKernel {
  public:
-  explicit AnalyticalRollingWindowTransformer(const OpKernelInfo& info) : OpKernel(info) {
+  explicit AnalyticalRollingWindowTransformer(const OpKernelInfo& info) : OpKernel(info),
+    streaming_(info.GetAttrOrDefault<int64_t>("streaming", 0) != 0) {
 }
 
   Status Compute(OpKernelContext* ctx) const override {
 
     utils::MLTypeCallDispatcher<AnalyticalRollingWindowTransformerImpl, float, double> t_disp(ctx->Input<Tensor>(2)->GetElementType());
-    t_disp.Invoke(ctx);
+    if (streaming_) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      t_disp.Invoke(ctx, &transformer_);
+    } else {
+      t_disp.Invoke(ctx, nullptr);
+    }
     return Status::OK();
   }
+
+ private:
+  const bool streaming_;
+  mutable std::mutex mutex_;
+  mutable std::shared_ptr<void> transformer_;
 };
 
 class SimpleRollingWindowTransformer final : public OpKernel {
  public:
-  explicit SimpleRollingWindowTransformer(const OpKernelInfo& info) : OpKernel(info) {
+  explicit SimpleRollingWindowTransformer(const OpKernelInfo& info) : OpKernel(info),
+    streaming_(info.GetAttrOrDefault<int64_t>("streaming", 0) != 0) {
 }
 
   Status Compute(OpKernelContext* ctx) const override {
 
     utils::MLTypeCallDispatcher<SimpleRollingWindowTransformerImpl, float, double> t_disp(ctx->Input<Tensor>(2)->GetElementType());
-    t_disp.Invoke(ctx);
+    if (streaming_) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      t_disp.Invoke(ctx, &transformer_);
+    } else {
+      t_disp.Invoke(ctx, nullptr);
+    }
     return Status::OK();
   }
+
+ private:
+  const bool streaming_;
+  mutable std::mutex mutex_;
+  mutable std::shared_ptr<void> transformer_;
 };
 
 ONNX_OPERATOR_KERNEL_EX(
@@ -0,0 +1,205 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "python/onnxruntime_pybind_dlpack.h"
+
+#include "core/framework/data_types.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace python {
+
+namespace {
+
+// The capsule names defined by the DLPack Python protocol. A consumer renames the capsule once it
+// owns the tensor, so that the capsule's destructor doesn't release it a second time.
+constexpr const char* kDlpackCapsuleName = "dltensor";
+constexpr const char* kUsedDlpackCapsuleName = "used_dltensor";
+
+// bool has no DLPack type code in v0.3 and is exchanged as uint8, like PyTorch does.
+DLDataType GetDlpackDataType(MLDataType type) {
+  DLDataType dtype{};
+  dtype.lanes = 1;
+  dtype.bits = static_cast<uint8_t>(type->Size() * 8);
+  if (type == DataTypeImpl::GetType<float>() || type == DataTypeImpl::GetType<double>() ||
+      type == DataTypeImpl::GetType<MLFloat16>()) {
+    dtype.code = kDLFloat;
+  } else if (type == DataTypeImpl::GetType<BFloat16>()) {
+    dtype.code = kDLBfloat;
+  } else if (type == DataTypeImpl::GetType<int8_t>() || type == DataTypeImpl::GetType<int16_t>() ||
+             type == DataTypeImpl::GetType<int32_t>() || type == DataTypeImpl::GetType<int64_t>()) {
+    dtype.code = kDLInt;
+  } else if (type == DataTypeImpl::GetType<uint8_t>() || type == DataTypeImpl::GetType<uint16_t>() ||
+             type == DataTypeImpl::GetType<uint32_t>() || type == DataTypeImpl::GetType<uint64_t>() ||
+             type == DataTypeImpl::GetType<bool>()) {
+    dtype.code = kDLUInt;
+  } else {
+    ORT_THROW("Tensor type ", DataTypeImpl::ToString(type), " can't be converted to DLPack.");
+  }
+  return dtype;
+}
+
+MLDataType GetOrtDataType(const DLDataType& dtype) {
+  ORT_ENFORCE(dtype.lanes == 1, "Vectorized DLPack types are not supported.");
+  switch (dtype.code) {
+    case kDLFloat:
+      switch (dtype.bits) {
+        case 16:
+          return DataTypeImpl::GetType<MLFloat16>();
+        case 32:
+          return DataTypeImpl::GetType<float>();
+        case 64:
+          return DataTypeImpl::GetType<double>();
+      }
+      break;
+    case kDLBfloat:
+      if (dtype.bits == 16) {
+        return DataTypeImpl::GetType<BFloat16>();
+      }
+      break;
+    case kDLInt:
+      switch (dtype.bits) {
+        case 8:
+          return DataTypeImpl::GetType<int8_t>();
+        case 16:
+          return DataTypeImpl::GetType<int16_t>();
+        case 32:
+          return DataTypeImpl::GetType<int32_t>();
+        case 64:
+          return DataTypeImpl::GetType<int64_t>();
+      }
+      break;
+    case kDLUInt:
+      switch (dtype.bits) {
+        case 8:
+          return DataTypeImpl::GetType<uint8_t>();
+        case 16:
+          return DataTypeImpl::GetType<uint16_t>();
+        case 32:
+          return DataTypeImpl::GetType<uint32_t>();
+        case 64:
+          return DataTypeImpl::GetType<uint64_t>();
+      }
+      break;
+  }
+  ORT_THROW("Unsupported DLPack type: code ", static_cast<int>(dtype.code), ", ", static_cast<int>(dtype.bits), " bits.");
+}
+
+OrtMemoryInfo GetOrtMemoryInfo(const DLContext& ctx) {
+  switch (ctx.device_type) {
+    case kDLCPU:
+    case kDLCPUPinned:
+      return OrtMemoryInfo(CPU, OrtDeviceAllocator);
+    case kDLGPU:
+      return OrtMemoryInfo(CUDA, OrtDeviceAllocator,
+                           OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, static_cast<OrtDevice::DeviceId>(ctx.device_id)),
+                           ctx.device_id);
+    default:
+      ORT_THROW("Unsupported DLPack device type: ", static_cast<int>(ctx.device_type));
+  }
+}
+
+// Owns what a DLManagedTensor exported by ToDlpack() points to.
+struct OrtDlpackContext {
+  OrtValue ort_value;
+  std::vector<int64_t> shape;
+  DLManagedTensor dlpack_tensor;
+};
+
+void DeleteOrtDlpackContext(DLManagedTensor* dlpack_tensor) {
+  delete static_cast<OrtDlpackContext*>(dlpack_tensor->manager_ctx);
+}
+
+// Releases a capsule that no consumer took ownership of.
+void DeleteUnusedDlpackCapsule(PyObject* capsule) {
+  if (PyCapsule_IsValid(capsule, kDlpackCapsuleName)) {
+    auto* dlpack_tensor = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule, kDlpackCapsuleName));
+    dlpack_tensor->deleter(dlpack_tensor);
+  }
+}
+
+}  // namespace
+
+OrtValue FromDlpack(py::object dlpack) {
+  if (py::hasattr(dlpack, "__dlpack__")) {
+    dlpack = dlpack.attr("__dlpack__")();
+  }
+  ORT_ENFORCE(PyCapsule_IsValid(dlpack.ptr(), kDlpackCapsuleName),
+              "Expected an unused DLPack capsule or an object implementing __dlpack__().");
+  auto* dlpack_tensor = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(dlpack.ptr(), kDlpackCapsuleName));
+  const DLTensor& dl_tensor = dlpack_tensor->dl_tensor;
+
+  std::vector<int64_t> shape(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  if (dl_tensor.strides != nullptr) {
+    int64_t expected_stride = 1;
+    for (int i = dl_tensor.ndim - 1; i >= 0; --i) {
+      ORT_ENFORCE(shape[i] == 1 || dl_tensor.strides[i] == expected_stride,
+                  "Only contiguous DLPack tensors can be converted to OrtValue.");
+      expected_stride *= shape[i];
+    }
+  }
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(
+      GetOrtDataType(dl_tensor.dtype), TensorShape(shape),
+      static_cast<char*>(dl_tensor.data) + dl_tensor.byte_offset, GetOrtMemoryInfo(dl_tensor.ctx));
+
+  OrtValue ort_value;
+  ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), [dlpack_tensor](void* p) {
+    DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()(p);
+    if (dlpack_tensor->deleter != nullptr) {
+      // The producer's deleter may release Python objects.
+      py::gil_scoped_acquire acquire;
+      dlpack_tensor->deleter(dlpack_tensor);
+    }
+  });
+  PyCapsule_SetName(dlpack.ptr(), kUsedDlpackCapsuleName);
+  return ort_value;
+}
+
+py::object ToDlpack(const OrtValue& ort_value) {
+  ORT_ENFORCE(ort_value.IsTensor(), "Only tensor OrtValues can be converted to DLPack.");
+  const Tensor& tensor = ort_value.Get<Tensor>();
+  const DLDataType dtype = GetDlpackDataType(tensor.DataType());
+  const auto device = GetDlpackDevice(ort_value);
+
+  auto context = onnxruntime::make_unique<OrtDlpackContext>();
+  context->ort_value = ort_value;
+  context->shape = tensor.Shape().GetDims();
+
+  DLManagedTensor& dlpack_tensor = context->dlpack_tensor;
+  dlpack_tensor.manager_ctx = context.get();
+  dlpack_tensor.deleter = DeleteOrtDlpackContext;
+  DLTensor& dl_tensor = dlpack_tensor.dl_tensor;
+  dl_tensor.data = const_cast<void*>(tensor.DataRaw());
+  dl_tensor.ctx.device_type = static_cast<DLDeviceType>(device.first);
+  dl_tensor.ctx.device_id = device.second;
+  dl_tensor.ndim = static_cast<int>(context->shape.size());
+  dl_tensor.dtype = dtype;
+  dl_tensor.shape = context->shape.data();
+  // Compact row-major.
+  dl_tensor.strides = nullptr;
+  dl_tensor.byte_offset = 0;
+
+  PyObject* capsule = PyCapsule_New(&dlpack_tensor, kDlpackCapsuleName, DeleteUnusedDlpackCapsule);
+  if (capsule == nullptr) {
+    throw py::error_already_set();
+  }
+  context.release();
+  return py::reinterpret_steal<py::object>(capsule);
+}
+
+std::pair<int, int> GetDlpackDevice(const OrtValue& ort_value) {
+  ORT_ENFORCE(ort_value.IsTensor(), "Only tensor OrtValues can be converted to DLPack.");
+  const OrtDevice& device = ort_value.Get<Tensor>().Location().device;
+  switch (device.Type()) {
+    case OrtDevice::CPU:
+      return {kDLCPU, 0};
+    case OrtDevice::GPU:
+      return {kDLGPU, device.Id()};
+    default:
+      ORT_THROW("Tensors on device type ", device.Type(), " can't be converted to DLPack.");
+  }
+}
+
+}  // namespace python
+}  // namespace onnxruntime
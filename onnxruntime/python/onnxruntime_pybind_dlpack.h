@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+#include <pybind11/pybind11.h>
+
+#include "core/framework/ml_value.h"
+
+// The structures of the DLPack ABI (https://github.com/dmlc/dlpack, v0.3), which is how
+// PyTorch, CuPy and other frameworks share tensors without copying them.
+extern "C" {
+
+typedef enum {
+  kDLCPU = 1,
+  kDLGPU = 2,
+  kDLCPUPinned = 3,
+} DLDeviceType;
+
+typedef struct {
+  DLDeviceType device_type;
+  int device_id;
+} DLContext;
+
+typedef enum {
+  kDLInt = 0U,
+  kDLUInt = 1U,
+  kDLFloat = 2U,
+  kDLBfloat = 4U,
+} DLDataTypeCode;
+
+typedef struct {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+  void* data;
+  DLContext ctx;
+  int ndim;
+  DLDataType dtype;
+  int64_t* shape;
+  int64_t* strides;
+  uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void* manager_ctx;
+  void (*deleter)(struct DLManagedTensor* self);
+} DLManagedTensor;
+}
+
+namespace onnxruntime {
+namespace python {
+
+namespace py = pybind11;
+
+/**
+ * Creates an OrtValue sharing the buffer of a DLPack tensor.
+ * @param dlpack A "dltensor" capsule, or an object implementing __dlpack__().
+ *               The capsule is consumed: the OrtValue calls the tensor's deleter once it is released.
+ */
+OrtValue FromDlpack(py::object dlpack);
+
+/**
+ * Creates a "dltensor" capsule sharing the buffer of a tensor OrtValue, which is kept alive until
+ * the consumer of the capsule calls its deleter.
+ */
+py::object ToDlpack(const OrtValue& ort_value);
+
+/**
+ * Returns the DLPack device type and id of a tensor OrtValue, as returned by __dlpack_device__().
+ */
+std::pair<int, int> GetDlpackDevice(const OrtValue& ort_value);
+
+}  // namespace python
+}  // namespace onnxruntime
@@ -251,11 +251,46 @@ void CopyDataToTensor(PyArrayObject* darray, int npy_type, std::unique_ptr<Tenso
     if (!IAllocator::CalcMemSizeForArray(p_tensor->DataType()->Size(), p_tensor->Shape().Size(), &len)) {
       throw std::runtime_error("length overflow");
     }
-    memcpy(buffer, PyArray_DATA(darray), len);
+    const void* src = PyArray_DATA(darray);
+    CopyWithoutGilIfLarge(len, [buffer, src, len]() { memcpy(buffer, src, len); });
+  }
+}
+
+// Copies the elements of an array along its strides to a contiguous buffer.
+static void CopyStridedData(const char* src, const npy_intp* dims, const npy_intp* strides, int ndim,
+                            size_t item_size, char*& dst) {
+  if (ndim == 0) {
+    memcpy(dst, src, item_size);
+    dst += item_size;
+  } else if (ndim == 1 && strides[0] == static_cast<npy_intp>(item_size)) {
+    memcpy(dst, src, dims[0] * item_size);
+    dst += dims[0] * item_size;
+  } else {
+    for (npy_intp i = 0; i < dims[0]; ++i) {
+      CopyStridedData(src + i * strides[0], dims + 1, strides + 1, ndim - 1, item_size, dst);
+    }
   }
 }
 
 std::unique_ptr<Tensor> CreateTensor(const AllocatorPtr& alloc, const std::string& name_input, PyArrayObject* pyObject) {
+  const int array_type = PyArray_TYPE(pyObject);
+  if (!PyArray_IS_C_CONTIGUOUS(pyObject) && array_type != NPY_UNICODE && array_type != NPY_STRING &&
+      array_type != NPY_VOID && array_type != NPY_OBJECT) {
+    // Gather the elements of a strided numeric array into the tensor directly, instead of into a contiguous
+    // copy made by numpy while holding the GIL.
+    auto p_tensor = onnxruntime::make_unique<Tensor>(NumpyToOnnxRuntimeTensorType(array_type), GetArrayShape(pyObject), alloc);
+    const char* src = static_cast<const char*>(PyArray_DATA(pyObject));
+    char* dst = static_cast<char*>(p_tensor->MutableDataRaw());
+    const npy_intp* dims = PyArray_DIMS(pyObject);
+    const npy_intp* strides = PyArray_STRIDES(pyObject);
+    const int ndim = PyArray_NDIM(pyObject);
+    const size_t item_size = PyArray_ITEMSIZE(pyObject);
+    CopyWithoutGilIfLarge(p_tensor->SizeInBytes(), [&]() {
+      CopyStridedData(src, dims, strides, ndim, item_size, dst);
+    });
+    return p_tensor;
+  }
+
   PyArrayObject* darray = PyArray_GETCONTIGUOUS(pyObject);
   ORT_ENFORCE(darray != nullptr, "The object must be a contiguous array for input '", name_input, "'.");
 
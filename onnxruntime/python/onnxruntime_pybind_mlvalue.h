@@ -30,6 +30,21 @@ void CreateGenericMLValue(const onnxruntime::InputDefList* input_def_list, const
 
 void GetPyObjFromTensor(const Tensor& rtensor, py::object& obj, const DataTransferManager* data_transfer_manager = nullptr);
 
+// Buffers of at least this size are copied without holding the GIL, so that the runs of other Python threads
+// aren't serialized by the conversion of their inputs and outputs. Smaller copies don't pay for the GIL hand-off.
+constexpr size_t kMinBytesToCopyWithoutGil = 64 * 1024;
+
+// Runs copy_fn, which must not use the Python API, without the GIL if it copies at least kMinBytesToCopyWithoutGil.
+template <typename CopyFn>
+void CopyWithoutGilIfLarge(size_t num_bytes, CopyFn&& copy_fn) {
+  if (num_bytes >= kMinBytesToCopyWithoutGil) {
+    py::gil_scoped_release release;
+    copy_fn();
+  } else {
+    copy_fn();
+  }
+}
+
 template <class T>
 struct DecRefFn {
   void operator()(T* pyobject) const {
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "python/onnxruntime_pybind_dlpack.h"
 #include "python/onnxruntime_pybind_exceptions.h"
 #include "python/onnxruntime_pybind_mlvalue.h"
 #include "python/onnxruntime_pybind_state_common.h"
@@ -11,6 +12,7 @@
 
 #include "core/framework/data_transfer_utils.h"
 #include "core/framework/data_types_internal.h"
+#include "core/framework/onnxruntime_typeinfo.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/common/logging/logging.h"
@@ -20,6 +22,7 @@
 #include "core/framework/session_options.h"
 #include "core/framework/bfc_arena.h"
 #include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 
 #if USE_CUDA
 #define BACKEND_PROC "GPU"
@@ -123,6 +126,12 @@
 OrtDevice::DeviceId cuda_device_id = 0;
 size_t cuda_mem_limit = std::numeric_limits<size_t>::max();
 onnxruntime::ArenaExtendStrategy arena_extend_strategy = onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo;
+bool enable_cuda_graph = false;
+bool use_stream_ordered_arena = false;
+OrtCudnnConvAlgoSearch cudnn_conv_algo_search = EXHAUSTIVE;
+std::string cudnn_conv_algo_cache_path;
+bool cuda_initializers_in_host_memory = false;
+size_t cuda_workspace_max_bytes = 0;
 #endif
 #ifdef USE_TENSORRT
 #include "core/providers/tensorrt/tensorrt_provider_factory.h"
@@ -155,7 +164,13 @@ namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(OrtDevice::DeviceId device_id,
                                                                                size_t cuda_mem_limit,
-                                                                               onnxruntime::ArenaExtendStrategy arena_extend_strategy);
+                                                                               onnxruntime::ArenaExtendStrategy arena_extend_strategy,
+                                                                               bool enable_cuda_graph,
+                                                                               bool use_stream_ordered_arena,
+                                                                               OrtCudnnConvAlgoSearch cudnn_conv_algo_search,
+                                                                               const std::string& cudnn_conv_algo_cache_path,
+                                                                               bool initializers_in_host_memory,
+                                                                               size_t workspace_max_bytes);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Tensorrt(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_MIGraphX(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Dnnl(int use_arena);
@@ -206,18 +221,24 @@ void GetPyObjFromTensor(const Tensor& rtensor, py::object& obj, const DataTransf
       PyArray_DATA(reinterpret_cast<PyArrayObject*>(obj.ptr())));
 
   if (numpy_type != NPY_OBJECT) {
+    const size_t num_bytes = dtype->Size() * shape.Size();
     //if it is not cpu tensor, need to copy to host
     if (rtensor.Location().device.Type() != OrtDevice::CPU) {
       if (!data_transfer_manager)
         throw std::runtime_error("GetPyObjFromTensor: data transfer manager is needed to convert non-CPU tensor to numpy array");
       static const OrtMemoryInfo cpu_alloc_info{onnxruntime::CPU, OrtDeviceAllocator};
-      std::vector<char> tensor_data_buffer{};
-      tensor_data_buffer.resize(rtensor.SizeInBytes());
-      ORT_THROW_IF_ERROR(CopyTensorDataToByteSpan(
-          *data_transfer_manager, rtensor, cpu_alloc_info, gsl::make_span(tensor_data_buffer)));
-      memcpy(outPtr, tensor_data_buffer.data(), dtype->Size() * shape.Size());
-    } else
-      memcpy(outPtr, rtensor.DataRaw(dtype), dtype->Size() * shape.Size());
+      // The device copy synchronizes with the device, so it never holds the GIL.
+      Status status;
+      {
+        py::gil_scoped_release release;
+        status = CopyTensorDataToByteSpan(
+            *data_transfer_manager, rtensor, cpu_alloc_info, gsl::make_span(static_cast<char*>(outPtr), num_bytes));
+      }
+      ORT_THROW_IF_ERROR(status);
+    } else {
+      const void* src = rtensor.DataRaw(dtype);
+      CopyWithoutGilIfLarge(num_bytes, [outPtr, src, num_bytes]() { memcpy(outPtr, src, num_bytes); });
+    }
   } else {
     // Handle string type.
     py::object* outObj = static_cast<py::object*>(outPtr);
@@ -290,10 +311,41 @@ void AddNonTensorAsPyObj(const OrtValue& val, std::vector<py::object>& pyobjs) {
   }
 }
 
-void AddTensorAsPyObj(const OrtValue& val, std::vector<py::object>& pyobjs) {
+// Wraps the buffer of a CPU tensor in a read-only numpy array without copying it.
+// The array's base object is a capsule holding a reference to the OrtValue, which keeps the buffer alive.
+// The buffer may be shared with other OrtValues (e.g. an initializer returned as a graph output), hence read-only.
+static void GetPyObjSharingTensorData(const OrtValue& val, py::object& obj) {
+  const Tensor& rtensor = val.Get<Tensor>();
+  std::vector<npy_intp> npy_dims;
+  const TensorShape& shape = rtensor.Shape();
+
+  for (size_t n = 0; n < shape.NumDimensions(); ++n) {
+    npy_dims.push_back(shape[n]);
+  }
+
+  const int numpy_type = OnnxRuntimeTensorToNumpyType(rtensor.DataType());
+  obj = py::reinterpret_steal<py::object>(PyArray_SimpleNewFromData(
+      shape.NumDimensions(), npy_dims.data(), numpy_type, const_cast<void*>(rtensor.DataRaw())));
+
+  py::capsule base(new OrtValue(val), [](void* owner) { delete static_cast<OrtValue*>(owner); });
+  PyArrayObject* array = reinterpret_cast<PyArrayObject*>(obj.ptr());
+  // PyArray_SetBaseObject steals the reference to the capsule.
+  if (PyArray_SetBaseObject(array, base.release().ptr()) != 0) {
+    throw py::error_already_set();
+  }
+  PyArray_CLEARFLAGS(array, NPY_ARRAY_WRITEABLE);
+}
+
+// Outputs are returned without a copy unless copy_outputs is set or the tensor isn't a CPU tensor of numeric type.
+void AddTensorAsPyObj(const OrtValue& val, std::vector<py::object>& pyobjs, bool copy_outputs = true) {
   const Tensor& rtensor = val.Get<Tensor>();
   py::object obj;
-  GetPyObjFromTensor(rtensor, obj);
+  if (!copy_outputs && rtensor.Location().device.Type() == OrtDevice::CPU &&
+      OnnxRuntimeTensorToNumpyType(rtensor.DataType()) != NPY_OBJECT) {
+    GetPyObjSharingTensorData(val, obj);
+  } else {
+    GetPyObjFromTensor(rtensor, obj);
+  }
   pyobjs.push_back(obj);
 }
 
@@ -320,10 +372,140 @@ const std::vector<std::string>& GetAvailableProviders() {
   return available_providers;
 }
 
+// Convert the python value of a model input to an OrtValue
+static void CreateFeedMLValue(const InferenceSession* sess, const std::string& name, py::object& value,
+                              OrtValue* p_mlvalue) {
+  auto px = sess->GetModelInputs();
+  if (!px.first.IsOK() || !px.second) {
+    throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+  }
+  CreateGenericMLValue(px.second, GetAllocator(), name, value, p_mlvalue);
+  if (PyErr_Occurred()) {
+    PyObject *ptype, *pvalue, *ptraceback;
+    PyErr_Fetch(&ptype, &pvalue, &ptraceback);
+
+    PyObject* pStr = PyObject_Str(ptype);
+    std::string sType = py::reinterpret_borrow<py::str>(pStr);
+    Py_XDECREF(pStr);
+    pStr = PyObject_Str(pvalue);
+    sType += ": ";
+    sType += py::reinterpret_borrow<py::str>(pStr);
+    Py_XDECREF(pStr);
+    throw std::runtime_error(sType);
+  }
+}
+
+// A prepared run bound to its session, for repeated calls with positional inputs.
+// The element type of each tensor input is resolved once, so a contiguous numpy array of that type is wrapped
+// directly instead of going through the per-input lookups of CreateFeedMLValue.
+// With reuse_outputs, a call writes its outputs to the buffers of the previous call if the input shapes are the
+// same, which overwrites the arrays returned by that call. Such a runner must not be used by concurrent calls.
+class PreparedRunner {
+ public:
+  PreparedRunner(InferenceSession* sess, std::unique_ptr<PreparedRun> prepared_run, bool reuse_outputs)
+      : sess_(sess), prepared_run_(std::move(prepared_run)), reuse_outputs_(reuse_outputs) {
+    auto px = sess->GetModelInputs();
+    if (!px.first.IsOK() || !px.second) {
+      throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+    }
+    for (const auto& name : prepared_run_->GetFeedNames()) {
+      MLDataType element_type = nullptr;
+      for (const NodeArg* def : *px.second) {
+        const auto* type_proto = def->TypeAsProto();
+        if (def->Name() == name && type_proto != nullptr && type_proto->has_tensor_type() &&
+            type_proto->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+          element_type = OrtTypeInfo::ElementTypeFromProto(
+              static_cast<ONNX_NAMESPACE::TensorProto_DataType>(type_proto->tensor_type().elem_type()));
+        }
+      }
+      input_element_types_.push_back(element_type);
+      input_numpy_types_.push_back(element_type != nullptr ? OnnxRuntimeTensorToNumpyType(element_type) : NPY_NOTYPE);
+    }
+  }
+
+  const PreparedRun& GetPreparedRun() const { return *prepared_run_; }
+
+  std::vector<py::object> Run(const py::list& inputs, const RunOptions* run_options) {
+    const auto& input_names = prepared_run_->GetFeedNames();
+    if (inputs.size() != input_names.size()) {
+      throw std::runtime_error("The prepared run has " + std::to_string(input_names.size()) +
+                               " inputs. " + std::to_string(inputs.size()) + " were provided.");
+    }
+
+    std::vector<OrtValue> feeds(input_names.size());
+    bool same_input_shapes = last_input_shapes_.size() == feeds.size();
+    last_input_shapes_.resize(feeds.size());
+    for (size_t i = 0; i < feeds.size(); ++i) {
+      py::object input = inputs[i];
+      PyArrayObject* arr = reinterpret_cast<PyArrayObject*>(input.ptr());
+      if (input_element_types_[i] != nullptr && PyArray_Check(input.ptr()) &&
+          PyArray_EquivTypenums(PyArray_TYPE(arr), input_numpy_types_[i]) && PyArray_IS_C_CONTIGUOUS(arr)) {
+        // The memory of the array is used directly, it is kept alive by the inputs list during the run.
+        TensorShape shape(std::vector<int64_t>(PyArray_DIMS(arr), PyArray_DIMS(arr) + PyArray_NDIM(arr)));
+        auto p_tensor = onnxruntime::make_unique<Tensor>(input_element_types_[i], shape, PyArray_DATA(arr),
+                                                         GetAllocator()->Info());
+        feeds[i].Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+      } else {
+        CreateFeedMLValue(sess_, input_names[i], input, &feeds[i]);
+      }
+
+      if (reuse_outputs_) {
+        TensorShape shape = feeds[i].IsTensor() ? feeds[i].Get<Tensor>().Shape() : TensorShape();
+        same_input_shapes = same_input_shapes && feeds[i].IsTensor() && shape == last_input_shapes_[i];
+        last_input_shapes_[i] = shape;
+      }
+    }
+
+    std::vector<OrtValue> fetches;
+    if (reuse_outputs_ && same_input_shapes) {
+      fetches = fetches_;
+    }
+    {
+      // release GIL to allow multiple python threads to invoke Run() in parallel.
+      py::gil_scoped_release release;
+      OrtPybindThrowIfError(sess_->Run(run_options != nullptr ? *run_options : RunOptions(), *prepared_run_, feeds, &fetches));
+    }
+    if (reuse_outputs_) {
+      fetches_ = fetches;
+    }
+
+    const bool copy_outputs = run_options != nullptr && run_options->copy_outputs;
+    std::vector<py::object> rfetch;
+    rfetch.reserve(fetches.size());
+    for (const auto& fetch : fetches) {
+      if (fetch.IsTensor()) {
+        AddTensorAsPyObj(fetch, rfetch, copy_outputs);
+      } else {
+        AddNonTensorAsPyObj(fetch, rfetch);
+      }
+    }
+    return rfetch;
+  }
+
+ private:
+  InferenceSession* sess_;
+  std::unique_ptr<PreparedRun> prepared_run_;
+  // element type of each tensor input, in the order of the feed names. nullptr for other inputs.
+  std::vector<MLDataType> input_element_types_;
+  std::vector<int> input_numpy_types_;
+  const bool reuse_outputs_;
+  std::vector<TensorShape> last_input_shapes_;
+  std::vector<OrtValue> fetches_;
+};
+
 void RegisterExecutionProviders(InferenceSession* sess, const std::vector<std::string>& provider_types) {
   for (const std::string& type : provider_types) {
     if (type == kCpuExecutionProvider) {
-      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CPU(sess->GetSessionOptions().enable_cpu_mem_arena));
+      // mirror the settings of the CPU execution provider that the session registers by default
+      const SessionOptions& session_options = sess->GetSessionOptions();
+      CPUExecutionProviderInfo info{session_options.enable_cpu_mem_arena,
+                                    session_options.enable_cpu_mem_arena_thread_cache};
+      info.numa_node = session_options.intra_op_param.numa_node;
+      info.use_huge_pages = session_options.enable_cpu_mem_arena_huge_pages;
+      info.enable_bf16_gemm = session_options.enable_cpu_bf16_gemm;
+      info.enable_sparse_gemm = session_options.enable_cpu_sparse_gemm;
+      info.share_prepacked_weights = session_options.share_prepacked_weights;
+      OrtPybindThrowIfError(sess->RegisterExecutionProvider(onnxruntime::make_unique<CPUExecutionProvider>(info)));
     } else if (type == kTensorrtExecutionProvider) {
 #ifdef USE_TENSORRT
       RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_Tensorrt(0));
@@ -334,7 +516,9 @@ void RegisterExecutionProviders(InferenceSession* sess, const std::vector<std::s
 #endif
     } else if (type == kCudaExecutionProvider) {
 #ifdef USE_CUDA
-      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CUDA(cuda_device_id, cuda_mem_limit, arena_extend_strategy));
+      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CUDA(cuda_device_id, cuda_mem_limit, arena_extend_strategy, enable_cuda_graph, use_stream_ordered_arena,
+                                                                                         cudnn_conv_algo_search, cudnn_conv_algo_cache_path,
+                                                                                         cuda_initializers_in_host_memory, cuda_workspace_max_bytes));
 #endif
     } else if (type == kDnnlExecutionProvider) {
 #ifdef USE_DNNL
@@ -442,7 +626,9 @@ void addGlobalMethods(py::module& m, const Environment& env) {
         std::vector<std::shared_ptr<onnxruntime::IExecutionProviderFactory>> factories = {
             onnxruntime::CreateExecutionProviderFactory_CPU(0),
 #ifdef USE_CUDA
-            onnxruntime::CreateExecutionProviderFactory_CUDA(cuda_device_id, cuda_mem_limit, arena_extend_strategy),
+            onnxruntime::CreateExecutionProviderFactory_CUDA(cuda_device_id, cuda_mem_limit, arena_extend_strategy, enable_cuda_graph, use_stream_ordered_arena,
+                                                             cudnn_conv_algo_search, cudnn_conv_algo_cache_path,
+                                                             cuda_initializers_in_host_memory, cuda_workspace_max_bytes),
 #endif
 #ifdef USE_DNNL
             onnxruntime::CreateExecutionProviderFactory_Dnnl(1),
@@ -489,6 +675,12 @@ void addGlobalMethods(py::module& m, const Environment& env) {
     cuda_mem_limit = static_cast<size_t>(limit);
   });
   m.def("set_arena_extend_strategy", [](const onnxruntime::ArenaExtendStrategy strategy) { arena_extend_strategy = strategy; });
+  m.def("set_enable_cuda_graph", [](const bool enable) { enable_cuda_graph = enable; });
+  m.def("set_use_stream_ordered_arena", [](const bool enable) { use_stream_ordered_arena = enable; });
+  m.def("set_cudnn_conv_algo_search", [](const OrtCudnnConvAlgoSearch search) { cudnn_conv_algo_search = search; });
+  m.def("set_cudnn_conv_algo_cache_path", [](const std::string& path) { cudnn_conv_algo_cache_path = path; });
+  m.def("set_cuda_initializers_in_host_memory", [](const bool enable) { cuda_initializers_in_host_memory = enable; });
+  m.def("set_cuda_workspace_max_bytes", [](const size_t max_bytes) { cuda_workspace_max_bytes = max_bytes; });
 #endif
 }
 
@@ -622,6 +814,10 @@ void addObjectMethods(py::module& m, Environment& env) {
       .value("ORT_SEQUENTIAL", ExecutionMode::ORT_SEQUENTIAL)
       .value("ORT_PARALLEL", ExecutionMode::ORT_PARALLEL);
 
+  py::enum_<GraphPartitioningMode>(m, "GraphPartitioningMode")
+      .value("Greedy", GraphPartitioningMode::Greedy)
+      .value("CostBased", GraphPartitioningMode::CostBased);
+
   py::class_<OrtDevice> device(m, "OrtDevice", R"pbdoc(ONNXRuntime device informaion.)pbdoc");
   device.def(py::init<OrtDevice::DeviceType, OrtDevice::MemoryType, OrtDevice::DeviceId>())
       .def("device_id", &OrtDevice::Id, R"pbdoc(Device Id.)pbdoc")
@@ -630,6 +826,41 @@ void addObjectMethods(py::module& m, Environment& env) {
       .def_static("cuda", []() { return OrtDevice::GPU; })
       .def_static("default_memory", []() { return OrtDevice::MemType::DEFAULT; });
 
+  py::class_<OrtValue> ort_value(m, "OrtValue", R"pbdoc(A tensor, which can be shared with other frameworks through DLPack.)pbdoc");
+  ort_value
+      .def_static("from_dlpack", &FromDlpack,
+                  R"pbdoc(Create an OrtValue sharing the buffer of a DLPack capsule or of an object implementing __dlpack__(),
+e.g. a PyTorch or CuPy tensor on CPU or CUDA. The tensor must be contiguous.)pbdoc")
+      .def("to_dlpack", &ToDlpack,
+           R"pbdoc(Return a DLPack capsule sharing the buffer of this OrtValue, e.g. for torch.utils.dlpack.from_dlpack.)pbdoc")
+      .def(
+          "__dlpack__", [](const OrtValue& value, py::object /*stream*/) { return ToDlpack(value); },
+          py::arg("stream") = py::none())
+      .def("__dlpack_device__", &GetDlpackDevice)
+      .def(
+          "shape", [](const OrtValue& value) { return value.Get<Tensor>().Shape().GetDims(); },
+          R"pbdoc(Shape of the tensor.)pbdoc")
+      .def(
+          "device_name", [](const OrtValue& value) { return std::string(GetDeviceName(value.Get<Tensor>().Location().device)); },
+          R"pbdoc(Name of the device the tensor is on.)pbdoc")
+      .def(
+          "numpy", [](const OrtValue& value) -> py::object {
+            py::object obj;
+            GetPyObjFromTensor(value.Get<Tensor>(), obj);
+            return obj;
+          },
+          R"pbdoc(Copy a CPU tensor to a numpy array.)pbdoc");
+
+  py::class_<PreparedRun>(m, "PreparedRun", R"pbdoc(Input and output names of run calls resolved by InferenceSession.prepare_run.)pbdoc")
+      .def_property_readonly("input_names", &PreparedRun::GetFeedNames)
+      .def_property_readonly("output_names", &PreparedRun::GetOutputNames);
+
+  py::class_<PreparedRunner>(m, "PreparedRunner", R"pbdoc(A prepared run bound to its session, created by InferenceSession.prepare_runner.)pbdoc")
+      .def_property_readonly("input_names", [](const PreparedRunner* runner) { return runner->GetPreparedRun().GetFeedNames(); })
+      .def_property_readonly("output_names", [](const PreparedRunner* runner) { return runner->GetPreparedRun().GetOutputNames(); })
+      .def("run", &PreparedRunner::Run, py::arg("inputs"), py::arg("run_options") = nullptr,
+           R"pbdoc(Compute the outputs for a list of inputs, in the order of the input names.)pbdoc");
+
   py::class_<SessionIOBinding> binding(m, "SessionIOBinding");
   binding
       .def(py::init<InferenceSession*>())
@@ -712,6 +943,17 @@ void addObjectMethods(py::module& m, Environment& env) {
         if (!status.IsOK())
           throw std::runtime_error("Error when bind output: " + status.ErrorMessage());
       })
+      .def("bind_output", [](SessionIOBinding* io_binding, const std::string& name, const OrtDevice& device) -> void {
+        // The output is allocated on the device by the run.
+        auto status = io_binding->Get()->BindOutput(name, OrtValue(), device);
+        if (!status.IsOK())
+          throw std::runtime_error("Error when bind output: " + status.ErrorMessage());
+      })
+      .def("bind_ortvalue_input", [](SessionIOBinding* io_binding, const std::string& name, const OrtValue& ml_value) -> void {
+        auto status = io_binding->Get()->BindInput(name, ml_value);
+        if (!status.IsOK())
+          throw std::runtime_error("Error when binding input: " + status.ErrorMessage());
+      })
       .def("clear_binding_inputs", [](SessionIOBinding* io_binding) -> void {
         io_binding->Get()->ClearInputs();
       })
@@ -730,6 +972,9 @@ void addObjectMethods(py::module& m, Environment& env) {
           }
         }
         return rfetch;
+      })
+      .def("get_outputs_as_ortvalues", [](SessionIOBinding* io_binding) -> std::vector<OrtValue> {
+        return io_binding->Get()->GetOutputs();
       });
 
   py::class_<SessionOptions>
@@ -739,8 +984,86 @@ void addObjectMethods(py::module& m, Environment& env) {
       .def_readwrite("enable_cpu_mem_arena", &SessionOptions::enable_cpu_mem_arena,
                      R"pbdoc(Enables the memory arena on CPU. Arena may pre-allocate memory for future usage.
 Set this option to false if you don't want it. Default is True.)pbdoc")
+      .def_readwrite("enable_cpu_mem_arena_huge_pages", &SessionOptions::enable_cpu_mem_arena_huge_pages,
+                     R"pbdoc(Backs the CPU memory arena with huge pages that are faulted in when the arena grows,
+reducing TLB misses and page faults on large buffers. Falls back to regular pages if the platform can't provide huge
+pages. Default is False.)pbdoc")
+      .def_readwrite("enable_cpu_bf16_gemm", &SessionOptions::enable_cpu_bf16_gemm,
+                     R"pbdoc(Runs float MatMul and Gemm nodes with constant weights on a bfloat16 GEMM when the CPU
+supports AVX512_BF16. Inputs are rounded to bfloat16, so results are less precise. Default is False.)pbdoc")
+      .def_readwrite("columnar_zipmap_outputs", &SessionOptions::columnar_zipmap_outputs,
+                     R"pbdoc(Returns the outputs produced by a ZipMap node, such as the probabilities of scikit-learn
+classifiers, as the 2D tensor of the ZipMap input instead of a list of dictionaries. The keys of the columns are
+returned by InferenceSession.get_output_map_keys. Default is False.)pbdoc")
+      .def_readwrite("enable_cpu_sparse_gemm", &SessionOptions::enable_cpu_sparse_gemm,
+                     R"pbdoc(Runs float MatMul and Gemm nodes on a block sparse GEMM when most of their constant
+weights are zeros, such as in pruned models. Default is False.)pbdoc")
+      .def_readwrite("enable_cuda_mixed_precision", &SessionOptions::enable_cuda_mixed_precision,
+                     R"pbdoc(Runs the float nodes assigned to the CUDA execution provider in float16 so that they
+can use Tensor Cores. Numerically sensitive ops such as Softmax and LayerNormalization stay in float. Requires
+graph_optimization_level >= ORT_ENABLE_EXTENDED. Default is False.)pbdoc")
+      .def_readwrite("mixed_precision_op_allow_list", &SessionOptions::mixed_precision_op_allow_list,
+                     R"pbdoc(Op types converted to float16 by enable_cuda_mixed_precision. Empty means the default
+list.)pbdoc")
+      .def_readwrite("mixed_precision_op_deny_list", &SessionOptions::mixed_precision_op_deny_list,
+                     R"pbdoc(Op types kept in float by enable_cuda_mixed_precision. Empty means the default
+list.)pbdoc")
+      .def_readwrite("share_prepacked_weights", &SessionOptions::share_prepacked_weights,
+                     R"pbdoc(Shares the packed copies of constant weights with other sessions in the process that
+set this option, so that multiple sessions of the same model hold one copy. Default is False.)pbdoc")
+      .def_readwrite("share_initializers", &SessionOptions::share_initializers,
+                     R"pbdoc(Shares the data of constant initializers in CPU memory with other sessions in the process
+that set this option, so that multiple sessions of the same model hold one copy. Default is False.)pbdoc")
+      .def_readwrite("use_mmap_initializers", &SessionOptions::use_mmap_initializers,
+                     R"pbdoc(Memory maps the model file when the session is created from a path, and creates the
+initializers over the mapping instead of copying their data. Default is False.)pbdoc")
+      .def_readwrite("save_node_placements", &SessionOptions::save_node_placements,
+                     R"pbdoc(Saves the execution provider assigned to each node along with the optimized model written
+to optimized_model_filepath. Default is False.)pbdoc")
+      .def_readwrite("use_saved_node_placements", &SessionOptions::use_saved_node_placements,
+                     R"pbdoc(The model is an optimized model saved with save_node_placements. Its node placements are
+restored instead of optimizing and partitioning the graph again. Default is False.)pbdoc")
+      .def_readwrite("save_prepacked_weights", &SessionOptions::save_prepacked_weights,
+                     R"pbdoc(Saves the weights packed by the CPU kernels to optimized_model_filepath + ".prepacked" along
+with the optimized model. Default is False.)pbdoc")
+      .def_readwrite("use_saved_prepacked_weights", &SessionOptions::use_saved_prepacked_weights,
+                     R"pbdoc(The model file is an optimized model saved with save_prepacked_weights. The CPU kernels read
+their packed weights from the ".prepacked" file next to it instead of packing them again. Default is False.)pbdoc")
+      .def_readwrite("arena_shrink_interval_runs", &SessionOptions::arena_shrink_interval_runs,
+                     R"pbdoc(If non-zero, memory arena regions that are not in use are released after
+this many runs. Default is 0 (never).)pbdoc")
+      .def_readwrite("enable_run_scoped_arena", &SessionOptions::enable_run_scoped_arena,
+                     R"pbdoc(Allocate intermediate values from an arena that only lives for a single run.
+Reduces fragmentation of the session memory arenas when input shapes vary. Default is False.)pbdoc")
+      .def_readwrite("enable_lazy_initialization", &SessionOptions::enable_lazy_initialization,
+                     R"pbdoc(Creates each kernel when its node first runs, and sets up each control flow subgraph when
+it's first run, instead of when the session is created. Default is False.)pbdoc")
+      .def_readwrite("constant_folding_max_size_ratio", &SessionOptions::constant_folding_max_size_ratio,
+                     R"pbdoc(Constant folding skips the nodes whose outputs are larger than this multiple of their
+inputs, such as a Tile of a small initializer. 0 disables the check. Default is 16.)pbdoc")
+      .def_readwrite("shape_specialization_cache_size", &SessionOptions::shape_specialization_cache_size,
+                     R"pbdoc(If non-zero, the graph of a model with free input dimensions is optimized again for
+each new set of input shapes, and up to this many specialized graphs are kept. Default is 0 (disabled).)pbdoc")
+      .def_readwrite("prune_to_requested_fetches", &SessionOptions::prune_to_requested_fetches,
+                     R"pbdoc(When a run requests only some of the outputs of the model, only execute the nodes
+they depend on. Default is True.)pbdoc")
+      .def_readwrite("graph_partitioning_mode", &SessionOptions::graph_partitioning_mode,
+                     R"pbdoc(How nodes are assigned to the execution providers. CostBased places a node that a CPU and
+a GPU provider can run where the estimated compute and copy time is lower. Default is Greedy.)pbdoc")
+      .def_readwrite("graph_partitioning_override_file", &SessionOptions::graph_partitioning_override_file,
+                     R"pbdoc(File with a "<node name> <execution provider type>" line per node to force on a
+provider.)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
+      .def_readwrite("enable_node_stats", &SessionOptions::enable_node_stats,
+                     R"pbdoc(Collect aggregated statistics for each node on every run, cheap enough to keep on in
+production. Read them with InferenceSession.get_node_stats. Default is false.)pbdoc")
+      .def_readwrite("enable_memory_profiling", &SessionOptions::enable_memory_profiling,
+                     R"pbdoc(With enable_profiling, add the lifetime of every tensor, the memory in use per device and
+the tensors live at the peak of each run to the profile. Default is false.)pbdoc")
+      .def_readwrite("enable_hardware_counters", &SessionOptions::enable_hardware_counters,
+                     R"pbdoc(With enable_profiling, add the hardware performance counters (cycles, instructions, IPC,
+last level cache misses) of the thread running each node to its event in the profile. Linux only. Default is false.)pbdoc")
       .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
                      R"pbdoc(File path to serialize optimized model. By default, optimized model is not serialized if optimized_model_filepath is not provided.)pbdoc")
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
@@ -757,8 +1080,19 @@ Applies to session load, initialization, etc. Default is 0.)pbdoc")
           "intra_op_num_threads", [](const SessionOptions* options) -> int { return options->intra_op_param.thread_pool_size; }, [](SessionOptions* options, int value) -> void { options->intra_op_param.thread_pool_size = value; }, R"pbdoc(Sets the number of threads used to parallelize the execution within nodes. Default is 0 to let onnxruntime choose.)pbdoc")
       .def_property(
           "inter_op_num_threads", [](const SessionOptions* options) -> int { return options->inter_op_param.thread_pool_size; }, [](SessionOptions* options, int value) -> void { options->inter_op_param.thread_pool_size = value; }, R"pbdoc(Sets the number of threads used to parallelize the execution of the graph (across nodes). Default is 0 to let onnxruntime choose.)pbdoc")
+      .def_property(
+          "intra_op_numa_node", [](const SessionOptions* options) -> int { return options->intra_op_param.numa_node; }, [](SessionOptions* options, int value) -> void { options->intra_op_param.numa_node = value; }, R"pbdoc(Binds the threads used to parallelize the execution within nodes to this NUMA node and allocates the CPU memory from it. Default is -1 (no binding).)pbdoc")
+      .def_property(
+          "intra_op_adaptive_spinning", [](const SessionOptions* options) -> bool { return options->intra_op_param.adaptive_spinning; }, [](SessionOptions* options, bool value) -> void { options->intra_op_param.adaptive_spinning = value; }, R"pbdoc(Lets the idle threads used to parallelize the execution within nodes tune how long they spin before blocking from the observed arrival of work. Default is False.)pbdoc")
+      .def_readwrite("calibrate_parallel_for_cost", &SessionOptions::calibrate_parallel_for_cost,
+                     R"pbdoc(Measures the per-element cost of the parallel loops of each operator and uses it to split them across the intra-op threads. Default is False.)pbdoc")
+      .def_readwrite("parallel_for_cost_table_file", &SessionOptions::parallel_for_cost_table_file,
+                     R"pbdoc(File with the parallel loop costs learned by calibrate_parallel_for_cost. It is loaded when the session is created and, when calibrating, written when the session is destroyed.)pbdoc")
       .def_readwrite("execution_mode", &SessionOptions::execution_mode,
                      R"pbdoc(Sets the execution mode. Default is sequential.)pbdoc")
+      .def_readwrite("use_unified_thread_pool", &SessionOptions::use_unified_thread_pool,
+                     R"pbdoc(In parallel execution mode, run the nodes on the intra-op thread pool so parallel nodes and
+parallel kernels share one set of threads instead of oversubscribing the cores. Default is False.)pbdoc")
       .def_property(
           "graph_optimization_level",
           [](const SessionOptions* options) -> GraphOptimizationLevel {
@@ -820,7 +1154,12 @@ RunOptions instance. The individual calls will exit gracefully and return an err
       .def_readwrite("only_execute_path_to_fetches", &RunOptions::only_execute_path_to_fetches,
                      R"pbdoc(Only execute the nodes needed by fetch list)pbdoc")
       .def_readwrite("training_mode", &RunOptions::training_mode,
-                     R"pbdoc(Choose to run in training or inferencing mode)pbdoc");
+                     R"pbdoc(Choose to run in training or inferencing mode)pbdoc")
+      .def_readwrite("shrink_memory_arenas", &RunOptions::shrink_memory_arenas,
+                     R"pbdoc(Release memory arena regions that are not in use once the run completes. Default is False.)pbdoc")
+      .def_readwrite("copy_outputs", &RunOptions::copy_outputs,
+                     R"pbdoc(Return the outputs as writable copies instead of read-only numpy arrays sharing the
+output buffers. Default is False.)pbdoc");
 
   py::class_<ModelMetadata>(m, "ModelMetadata", R"pbdoc(Pre-defined and custom metadata about the model.
 It is usually used to identify the model used to run the prediction and
@@ -917,24 +1256,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
         NameMLValMap feeds;
         for (auto _ : pyfeeds) {
           OrtValue ml_value;
-          auto px = sess->GetModelInputs();
-          if (!px.first.IsOK() || !px.second) {
-            throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
-          }
-          CreateGenericMLValue(px.second, GetAllocator(), _.first, _.second, &ml_value);
-          if (PyErr_Occurred()) {
-            PyObject *ptype, *pvalue, *ptraceback;
-            PyErr_Fetch(&ptype, &pvalue, &ptraceback);
-
-            PyObject* pStr = PyObject_Str(ptype);
-            std::string sType = py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            pStr = PyObject_Str(pvalue);
-            sType += ": ";
-            sType += py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            throw std::runtime_error(sType);
-          }
+          CreateFeedMLValue(sess, _.first, _.second, &ml_value);
           feeds.insert(std::make_pair(_.first, ml_value));
         }
 
@@ -951,11 +1273,90 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           }
         }
 
+        const bool copy_outputs = run_options != nullptr && run_options->copy_outputs;
         std::vector<py::object> rfetch;
         rfetch.reserve(fetches.size());
         for (auto _ : fetches) {
           if (_.IsTensor()) {
-            AddTensorAsPyObj(_, rfetch);
+            AddTensorAsPyObj(_, rfetch, copy_outputs);
+          } else {
+            AddNonTensorAsPyObj(_, rfetch);
+          }
+        }
+        return rfetch;
+      })
+      .def("warmup", [](InferenceSession* sess, const std::vector<std::map<std::string, std::vector<int64_t>>>& pyshape_sets, RunOptions* run_options = nullptr) -> void {
+        std::vector<std::string> input_names;
+        if (!pyshape_sets.empty()) {
+          for (const auto& input_shape : pyshape_sets.front()) {
+            input_names.push_back(input_shape.first);
+          }
+        }
+
+        std::vector<std::vector<TensorShape>> shape_sets;
+        shape_sets.reserve(pyshape_sets.size());
+        for (const auto& pyshapes : pyshape_sets) {
+          std::vector<TensorShape> shapes;
+          shapes.reserve(input_names.size());
+          for (const auto& input_name : input_names) {
+            auto iter = pyshapes.find(input_name);
+            if (iter == pyshapes.end() || pyshapes.size() != input_names.size()) {
+              throw std::runtime_error("Every set of input shapes must have the same inputs.");
+            }
+            shapes.emplace_back(iter->second);
+          }
+          shape_sets.push_back(std::move(shapes));
+        }
+
+        // release GIL to allow multiple python threads to invoke Run() in parallel.
+        py::gil_scoped_release release;
+        if (run_options != nullptr) {
+          OrtPybindThrowIfError(sess->Warmup(*run_options, input_names, shape_sets));
+        } else {
+          OrtPybindThrowIfError(sess->Warmup(RunOptions(), input_names, shape_sets));
+        }
+      })
+      .def("prepare_run", [](const InferenceSession* sess, const std::vector<std::string>& input_names, const std::vector<std::string>& output_names) -> std::unique_ptr<PreparedRun> {
+        std::unique_ptr<PreparedRun> prepared_run;
+        OrtPybindThrowIfError(sess->PrepareRun(input_names, output_names, prepared_run));
+        return prepared_run;
+      },
+           py::keep_alive<0, 1>())
+      .def("prepare_runner", [](InferenceSession* sess, const std::vector<std::string>& input_names, const std::vector<std::string>& output_names, bool reuse_outputs) -> std::unique_ptr<PreparedRunner> {
+        std::unique_ptr<PreparedRun> prepared_run;
+        OrtPybindThrowIfError(sess->PrepareRun(input_names, output_names, prepared_run));
+        return onnxruntime::make_unique<PreparedRunner>(sess, std::move(prepared_run), reuse_outputs);
+      },
+           py::keep_alive<0, 1>())
+      .def("run_prepared", [](InferenceSession* sess, const PreparedRun& prepared_run, std::vector<py::object> pyinputs, RunOptions* run_options = nullptr) -> std::vector<py::object> {
+        const auto& input_names = prepared_run.GetFeedNames();
+        if (pyinputs.size() != input_names.size()) {
+          throw std::runtime_error("The prepared run has " + std::to_string(input_names.size()) +
+                                   " inputs. " + std::to_string(pyinputs.size()) + " were provided.");
+        }
+
+        std::vector<OrtValue> feeds(pyinputs.size());
+        for (size_t i = 0; i < pyinputs.size(); ++i) {
+          CreateFeedMLValue(sess, input_names[i], pyinputs[i], &feeds[i]);
+        }
+
+        std::vector<OrtValue> fetches;
+        {
+          // release GIL to allow multiple python threads to invoke Run() in parallel.
+          py::gil_scoped_release release;
+          if (run_options != nullptr) {
+            OrtPybindThrowIfError(sess->Run(*run_options, prepared_run, feeds, &fetches));
+          } else {
+            OrtPybindThrowIfError(sess->Run(RunOptions(), prepared_run, feeds, &fetches));
+          }
+        }
+
+        const bool copy_outputs = run_options != nullptr && run_options->copy_outputs;
+        std::vector<py::object> rfetch;
+        rfetch.reserve(fetches.size());
+        for (auto _ : fetches) {
+          if (_.IsTensor()) {
+            AddTensorAsPyObj(_, rfetch, copy_outputs);
           } else {
             AddNonTensorAsPyObj(_, rfetch);
           }
@@ -965,6 +1366,28 @@ including arg name, arg type (contains both type and shape).)pbdoc")
       .def("end_profiling", [](InferenceSession* sess) -> std::string {
         return sess->EndProfiling();
       })
+      .def("get_node_stats", [](const InferenceSession* sess) -> std::string {
+        std::string node_stats_json;
+        OrtPybindThrowIfError(sess->GetNodeStatsJson(node_stats_json));
+        return node_stats_json;
+      })
+      .def("get_metrics", [](const InferenceSession* sess, bool prometheus) -> std::string {
+        std::string metrics;
+        OrtPybindThrowIfError(sess->GetMetrics(prometheus ? InferenceSession::MetricsFormat::Prometheus
+                                                          : InferenceSession::MetricsFormat::Json,
+                                               metrics));
+        return metrics;
+      })
+      .def("get_output_map_keys", [](const InferenceSession* sess, const std::string& output_name) -> py::object {
+        const auto* keys = sess->GetColumnarMapOutputKeys(output_name);
+        if (keys == nullptr) {
+          return py::none();
+        }
+        if (!keys->string_keys.empty()) {
+          return py::cast(keys->string_keys);
+        }
+        return py::cast(keys->int64_keys);
+      })
       .def("get_providers", [](InferenceSession* sess) -> const std::vector<std::string>& {
         return sess->GetRegisteredProviderTypes();
       })
@@ -1005,6 +1428,10 @@ including arg name, arg type (contains both type and shape).)pbdoc")
       .value("kNextPowerOfTwo", onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo)
       .value("kSameAsRequested", onnxruntime::ArenaExtendStrategy::kSameAsRequested)
       .export_values();
+
+  py::enum_<OrtCudnnConvAlgoSearch>(m, "OrtCudnnConvAlgoSearch")
+      .value("EXHAUSTIVE", OrtCudnnConvAlgoSearch::EXHAUSTIVE)
+      .value("HEURISTIC", OrtCudnnConvAlgoSearch::HEURISTIC);
 }
 
 #if defined(USE_MIMALLOC_ARENA_ALLOCATOR)
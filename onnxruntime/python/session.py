@@ -119,6 +119,69 @@ class Session:
             else:
                 raise
 
+    def warmup(self, shape_sets, run_options=None):
+        """
+        Run the model once per set of input shapes with zero filled inputs, so that the first :meth:`run`
+        with these shapes is as fast as the following ones. The outputs are discarded.
+
+        :param shape_sets: list of dictionaries ``{ input_name: shape }`` with the same inputs, including every
+            required input
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+
+        ::
+
+            sess.warmup([{input_name: [1, 3, 224, 224]}, {input_name: [8, 3, 224, 224]}])
+        """
+        self._sess.warmup(shape_sets, run_options)
+
+    def prepare_run(self, output_names, input_names):
+        """
+        Resolve the inputs and outputs of repeated runs with the same names once.
+
+        :param output_names: name of the outputs
+        :param input_names: name of the inputs, in the order of the values given to :meth:`run_prepared`
+        :return: a prepared run object to pass to :meth:`run_prepared`
+
+        ::
+
+            prepared = sess.prepare_run([output_name], [input_name])
+            sess.run_prepared(prepared, [x])
+        """
+        return self._sess.prepare_run(input_names, output_names)
+
+    def run_prepared(self, prepared_run, inputs, run_options=None):
+        """
+        Compute the predictions with the input and output names resolved by :meth:`prepare_run`.
+        It skips the name lookups done by :meth:`run`, which matters for small models.
+
+        :param prepared_run: the object returned by :meth:`prepare_run` on this session
+        :param inputs: list of input values, in the order of the input names of the prepared run
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: list of output values, in the order of the output names of the prepared run
+        """
+        return self._sess.run_prepared(prepared_run, inputs, run_options)
+
+    def prepare_runner(self, output_names, input_names, reuse_outputs=False):
+        """
+        Create a runner for repeated runs with the same input and output names. The type of each
+        input is resolved once, so numpy arrays of the input types are passed to the run without
+        the conversions done by :meth:`run` and :meth:`run_prepared`, which matters for small models.
+
+        :param output_names: name of the outputs
+        :param input_names: name of the inputs, in the order of the values given to the runner
+        :param reuse_outputs: write the outputs of a run to the buffers of the previous run when the input
+            shapes are the same. The arrays returned by the previous run are overwritten, unless
+            :attr:`onnxruntime.RunOptions.copy_outputs` is set. Such a runner must not be used by concurrent runs.
+        :return: a runner whose run method takes the list of input values and an optional
+            :class:`onnxruntime.RunOptions`, and returns the list of output values
+
+        ::
+
+            runner = sess.prepare_runner([output_name], [input_name])
+            runner.run([x])
+        """
+        return self._sess.prepare_runner(input_names, output_names, reuse_outputs)
+
     def end_profiling(self):
         """
         End profiling and return results in a file.
@@ -128,6 +191,32 @@ class Session:
         """
         return self._sess.end_profiling()
 
+    def get_node_stats(self):
+        """
+        Return the statistics collected for each node when the session was created with
+        :meth:`onnxruntime.SessionOptions.enable_node_stats`, as a JSON array with an object
+        per node that has run.
+        """
+        return self._sess.get_node_stats()
+
+    def get_output_map_keys(self, output_name):
+        """
+        Return the keys of the columns of an output that
+        :meth:`onnxruntime.SessionOptions.columnar_zipmap_outputs` returns as an array instead of
+        a list of dictionaries: a list of integers or of strings. Return None for the other
+        outputs.
+        """
+        return self._sess.get_output_map_keys(output_name)
+
+    def get_metrics(self, prometheus=False):
+        """
+        Return the metrics of the session: percentiles of the run latency and of the time
+        asynchronous runs wait in the queue, the statistics of the memory arenas and, with
+        :meth:`onnxruntime.SessionOptions.enable_node_stats`, the kernel time of each execution
+        provider. The metrics are a JSON object, or Prometheus text if prometheus is True.
+        """
+        return self._sess.get_metrics(prometheus)
+
     def io_binding(self):
         "Return an onnxruntime.IOBinding object`."
         return IOBinding(self)
@@ -219,6 +308,14 @@ class IOBinding:
                                                device_id),
                                    element_type, shape, buffer_ptr)
 
+    def bind_ortvalue_input(self, name, ortvalue):
+        '''
+        bind an input to a tensor without copying it
+        :param name: input name
+        :param ortvalue: input value as an OrtValue, e.g. created by OrtValue.from_dlpack from a PyTorch or CuPy tensor
+        '''
+        self._iobinding.bind_ortvalue_input(name, ortvalue)
+
     def bind_output(self, name, device_type='cpu', device_id=0, element_type=None, shape=None, buffer_ptr=None):
         '''
         :param name: output name
@@ -226,10 +323,14 @@ class IOBinding:
         :param device_id: device id, e.g. 0
         :param element_type: output element type
         :param shape: output shape
-        :param buffer_ptr: memory pointer to output data
+        :param buffer_ptr: memory pointer to output data, or None to have the run allocate the output on the device
         '''
         if device_type == 'cpu':
             self._iobinding.bind_output(name)
+        elif buffer_ptr is None:
+            self._iobinding.bind_output(name,
+                                        C.OrtDevice(get_ort_device_type(device_type), C.OrtDevice.default_memory(),
+                                                    device_id))
         else:
             self._iobinding.bind_output(name,
                                         C.OrtDevice(get_ort_device_type(device_type), C.OrtDevice.default_memory(),
@@ -240,6 +341,10 @@ class IOBinding:
         '''Obtain outputs.'''
         return self._iobinding.get_outputs()
 
+    def get_outputs_as_ortvalues(self):
+        '''Obtain outputs as OrtValues on the devices they were computed on, e.g. to pass them to OrtValue.to_dlpack.'''
+        return self._iobinding.get_outputs_as_ortvalues()
+
     def clear_binding_inputs(self):
         self._iobinding.clear_binding_inputs()
 
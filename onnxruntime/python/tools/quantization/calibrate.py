@@ -20,6 +20,7 @@ from data_preprocess import load_batch
 import re
 import subprocess
 import json
+from concurrent.futures import ThreadPoolExecutor
 
 
 def augment_graph(model, quantization_candidates=['Conv', 'MatMul'], black_nodes=[], white_nodes=[]):
@@ -69,7 +70,7 @@ def augment_graph(model, quantization_candidates=['Conv', 'MatMul'], black_nodes
 # Using augmented outputs to generate inputs to quantize.py
 
 
-def get_intermediate_outputs(model_path, session, inputs, calib_mode='naive'):
+def get_intermediate_outputs(model_path, session, inputs, calib_mode='naive', num_workers=1):
     '''
     Gather intermediate model outputs after running inference
         parameter model_path: path to augmented FP32 ONNX model
@@ -81,42 +82,59 @@ def get_intermediate_outputs(model_path, session, inputs, calib_mode='naive'):
                                 values; more techniques can be added based on further experimentation
                                 to improve the selection of the min max values. For example: some kind
                                 of noise reduction can be applied before taking the min and max values.
+        parameter num_workers: number of inputs run concurrently through the session
         return: dictionary mapping added node names to (ReduceMin, ReduceMax) pairs
     '''
+    if calib_mode != 'naive':
+        raise ValueError('Unknown value for calib_mode. Currently only naive mode is supported.')
+
     model = onnx.load(model_path)
     # number of outputs in original model
     num_model_outputs = len(model.graph.output)
-    num_inputs = len(inputs)
     input_name = session.get_inputs()[0].name
-    intermediate_outputs = [session.run([], {input_name: inputs[i]}) for i in range(num_inputs)]
-
-    # Creating dictionary with output results from multiple test inputs
-    node_output_names = [session.get_outputs()[i].name for i in range(len(intermediate_outputs[0]))]
-    output_dicts = [dict(zip(node_output_names, intermediate_outputs[i])) for i in range(num_inputs)]
-    merged_dict = {}
-    for d in output_dicts:
-        for k, v in d.items():
-            merged_dict.setdefault(k, []).append(v)
-    added_node_output_names = node_output_names[num_model_outputs:]
+    # only fetch the ReduceMin/ReduceMax outputs added by augment_graph, which are scalars,
+    # rather than the outputs of the original model
+    added_node_output_names = [output.name for output in session.get_outputs()[num_model_outputs:]]
     node_names = [added_node_output_names[i].rpartition('_')[0]
                   for i in range(0, len(added_node_output_names), 2)]  # output names
 
-    # Characterizing distribution of a node's values across test data sets
-    clean_merged_dict = dict((i, merged_dict[i]) for i in merged_dict if i != list(merged_dict.keys())[0])
-    if calib_mode == 'naive':
-        pairs = [
-            tuple([
-                float(min(clean_merged_dict[added_node_output_names[i]])),
-                float(max(clean_merged_dict[added_node_output_names[i + 1]]))
-            ]) for i in range(0, len(added_node_output_names), 2)
-        ]
+    # The ranges are folded in as each input completes, so the memory used doesn't grow with the data set.
+    # InferenceSession.run releases the GIL, so concurrent runs use the cores left idle by a single run.
+    rmins = np.full(len(node_names), np.inf)
+    rmaxs = np.full(len(node_names), -np.inf)
+
+    def run(data):
+        return session.run(added_node_output_names, {input_name: data})
+
+    def fold(outputs):
+        np.minimum(rmins, outputs[0::2], out=rmins)
+        np.maximum(rmaxs, outputs[1::2], out=rmaxs)
+
+    if num_workers > 1:
+        with ThreadPoolExecutor(max_workers=num_workers) as executor:
+            for outputs in executor.map(run, inputs):
+                fold(outputs)
     else:
-        raise ValueError('Unknown value for calib_mode. Currently only naive mode is supported.')
+        for data in inputs:
+            fold(run(data))
 
+    pairs = [(float(rmin), float(rmax)) for rmin, rmax in zip(rmins, rmaxs)]
     final_dict = dict(zip(node_names, pairs))
     return final_dict
 
 
+def write_calibration_table(calibration_cache, table_path):
+    '''
+    Write the dynamic ranges of the calibrated tensors as an INT8 calibration table for the TensorRT execution provider
+    (see ORT_TENSORRT_INT8_CALIBRATION_TABLE_NAME)
+        parameter calibration_cache: dictionary mapping tensor names to (ReduceMin, ReduceMax) pairs
+        parameter table_path: path of the calibration table to write
+    '''
+    with open(table_path, 'w') as fout:
+        for name, (rmin, rmax) in calibration_cache.items():
+            fout.write('{} {}\n'.format(name, max(abs(rmin), abs(rmax))))
+
+
 def calculate_scale_zeropoint(node, next_node, rmin, rmax):
     zp_and_scale = []
     # adjust rmin and rmax such that 0 is included in the range. This is required
@@ -240,10 +258,18 @@ def main():
                         default='augmented_model.onnx',
                         help='save augmented model to this file for verification purpose')
     parser.add_argument('--output_model_path', type=str, default='calibrated_quantized_model.onnx')
+    parser.add_argument('--calibration_table_path',
+                        type=str,
+                        default='',
+                        help='write an INT8 calibration table for the TensorRT execution provider to this file')
     parser.add_argument('--dataset_size',
                         type=int,
                         default=0,
                         help="Number of images or tensors to load. Default is 0 which means all samples")
+    parser.add_argument('--num_workers',
+                        type=int,
+                        default=1,
+                        help="Number of calibration inputs to run concurrently. Default is 1")
     parser.add_argument('--data_preprocess',
                         type=str,
                         required=True,
@@ -276,7 +302,9 @@ def main():
     else:
         inputs = load_batch(images_folder, height, width, args.data_preprocess, size_limit)
     print(inputs.shape)
-    dict_for_quantization = get_intermediate_outputs(model_path, session, inputs, calib_mode)
+    dict_for_quantization = get_intermediate_outputs(model_path, session, inputs, calib_mode, args.num_workers)
+    if args.calibration_table_path:
+        write_calibration_table(dict_for_quantization, args.calibration_table_path)
     quantization_params_dict = calculate_quantization_params(model, quantization_thresholds=dict_for_quantization)
     calibrated_quantized_model = quantize(onnx.load(model_path),
                                           quantization_mode=QuantizationMode.QLinearOps,
@@ -108,15 +108,17 @@ class QuantizedValue:
         self.qType = qType
 
 
-def quantize_data(data, quantize_range, qType):
+def quantize_data(data, quantize_range, qType, symmetric=False):
     '''
         :parameter data: data to quantize
         :parameter quantize_range: list of data to weight pack.
         :parameter qType: data type to quantize to. Supported types UINT8 and INT8
+        :parameter symmetric: quantize UINT8 data symmetrically around a zero point of 128
         :return: minimum, maximum, zero point, scale, and quantized weights
 
         To pack weights, we compute a linear transformation
             - when data type == uint8 mode, from [rmin, rmax] -> [0, 2^{b-1}] and
+            - when data type == uint8 and symmetric, from [-m, m] -> [1, 2^{b}-1] with a zero point of 2^{b-1}
             - when data type == int8, from [-m , m] -> [-(2^{b-1}-1), 2^{b-1}-1] where
                 m = max(abs(rmin), abs(rmax))
 
@@ -136,6 +138,11 @@ def quantize_data(data, quantize_range, qType):
         zero_point = 0
         # signed byte type
         quantized_data = (np.asarray(data) / scale).round().astype('b')
+    elif qType == onnx_proto.TensorProto.UINT8 and symmetric:
+        max_range = max(abs(rmin), abs(rmax))
+        scale = float(max_range) / 127 if max_range != 0 else 1
+        zero_point = 128
+        quantized_data = ((np.asarray(data) / scale).round() + zero_point).astype('B')  # unsigned byte type
     elif qType == onnx_proto.TensorProto.UINT8:
         scale = (float(rmax) - rmin) / quantize_range if rmin != rmax else 1
         zero_point = round((0 - rmin) / scale)  # round to nearest integer
@@ -317,6 +324,8 @@ class ONNXQuantizer:
                     new_list += self._handle_activation_ops(node, new_list)
                 elif node.op_type == 'Attention':
                     new_list += self._quantize_attention(node, new_list)
+                elif node.op_type == 'LSTM' or node.op_type == 'GRU':
+                    new_list += self._quantize_rnn(node, new_list)
                 else:
                     new_list += self._handle_other_ops(node, new_list)
 
@@ -455,9 +464,10 @@ class ONNXQuantizer:
         quantized_per_channel_data_list = []
         for i in range(channel_count):
             # for each channel, compute quantization data. Assuming (M x C/group x kH x kW)
+            # The channels are quantized symmetrically so they share a zero point, which QLinearConv requires.
             per_channel_data = np_data[i, :, :, :].flatten()
             rmin, rmax, zero_point, scale, quantized_per_channel_data = quantize_data(
-                per_channel_data.flatten().tolist(), _get_qrange_for_qType(qType), qType)
+                per_channel_data.flatten().tolist(), _get_qrange_for_qType(qType), qType, symmetric=True)
             rmin_list.append(rmin)
             rmax_list.append(rmax)
             zero_point_list.append(zero_point)
@@ -1374,6 +1384,93 @@ class ONNXQuantizer:
 
         return nodes
 
+    def _get_quantized_rnn_weight(self, initializer, qType):
+        '''
+            Quantizes the weights of each direction of a LSTM or GRU node, transposed to
+            [num_directions, input_size, num_gates * hidden_size] as DynamicQuantizeLSTM and DynamicQuantizeGRU take them.
+            parameter initializer: W or R initializer.
+            parameter qType: type to quantize to.
+            return: names of the quantized weight, scale and zero point initializers.
+        '''
+        weights_data = self.find_weight_data(initializer)
+        transposed_data = np.transpose(weights_data, (0, 2, 1))
+
+        quantized_data = []
+        scales = []
+        zero_points = []
+        for direction_data in transposed_data:
+            _, _, zero_point, scale, quantized_direction_data = quantize_data(direction_data.flatten().tolist(),
+                                                                              _get_qrange_for_qType(qType), qType)
+            quantized_data.append(np.asarray(quantized_direction_data).reshape(direction_data.shape))
+            scales.append(scale)
+            zero_points.append(zero_point)
+
+        quantized_name = initializer.name + "_quantized"
+        scale_name = initializer.name + "_scale"
+        zero_point_name = initializer.name + "_zero_point"
+        quantized_np_data = np.asarray(quantized_data, dtype=onnx.mapping.TENSOR_TYPE_TO_NP_TYPE[qType])
+        quantized_initializer = onnx.numpy_helper.from_array(quantized_np_data, quantized_name)
+        scale_initializer = onnx.helper.make_tensor(scale_name, onnx_proto.TensorProto.FLOAT, [len(scales)], scales)
+        zero_point_initializer = onnx.helper.make_tensor(zero_point_name, qType, [len(zero_points)], zero_points)
+        self.model.graph.initializer.extend([quantized_initializer, scale_initializer, zero_point_initializer])
+
+        return quantized_name, scale_name, zero_point_name
+
+    def _quantize_rnn(self, node, new_nodes_list):
+        '''
+            parameter node: LSTM or GRU node.
+            parameter new_nodes_list: List of new nodes created before processing this node.
+            return: a list of nodes in topological order that represents quantized LSTM or GRU node.
+        '''
+        assert (node.op_type == "LSTM" or node.op_type == "GRU")
+
+        # Only the weights are quantized. DynamicQuantizeLSTM and DynamicQuantizeGRU quantize their inputs before
+        # each matrix multiplication.
+        if self.static or self.mode != QuantizationMode.IntegerOps:
+            return self._handle_other_ops(node, new_nodes_list)
+
+        W = _find_by_name(node.input[1], self.model.graph.initializer)
+        R = _find_by_name(node.input[2], self.model.graph.initializer)
+        if W is None or R is None or W.data_type != onnx_proto.TensorProto.FLOAT or \
+                R.data_type != onnx_proto.TensorProto.FLOAT or len(W.dims) != 3 or len(R.dims) != 3:
+            return self._handle_other_ops(node, new_nodes_list)
+
+        nodes = []
+        for node_input in node.input:
+            dequantize_node = self._dequantize_value(node_input, new_nodes_list)
+            if dequantize_node is not None:
+                nodes.append(dequantize_node)
+
+        W_names = self._get_quantized_rnn_weight(W, self.weight_qType)
+        R_names = self._get_quantized_rnn_weight(R, self.weight_qType)
+
+        # the float weights are removed if no other node uses them
+        for weight in [W, R]:
+            if len(_find_nodes_using_initializer(self.model.graph, weight)) == 1:
+                self.model.graph.initializer.remove(weight)
+                weight_input = _find_by_name(weight.name, self.model.graph.input)
+                if weight_input is not None:
+                    self.model.graph.input.remove(weight_input)
+
+        num_float_inputs = 8 if node.op_type == "LSTM" else 6
+        inputs = [node.input[0], W_names[0], R_names[0]]
+        inputs.extend([node.input[i] if i < len(node.input) else "" for i in range(3, num_float_inputs)])
+        inputs.extend([W_names[1], W_names[2], R_names[1], R_names[2]])
+
+        quantized_node_name = ""
+        if node.name != "":
+            quantized_node_name = node.name + "_quant"
+
+        kwargs = {}
+        for attribute in node.attribute:
+            kwargs.update(_attribute_to_kwarg(attribute))
+        kwargs["domain"] = ms_domain
+        quantized_node = onnx.helper.make_node("DynamicQuantize" + node.op_type, inputs, node.output,
+                                               quantized_node_name, **kwargs)
+        nodes.append(quantized_node)
+
+        return nodes
+
 
 def check_opset_version(org_model, force_fusions):
     '''
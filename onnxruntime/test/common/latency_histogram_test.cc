@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/latency_histogram.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(LatencyHistogramTest, BucketBoundaries) {
+  // small values are counted exactly
+  for (uint64_t value = 0; value < LatencyHistogram::kSubBuckets; ++value) {
+    EXPECT_EQ(LatencyHistogram::BucketIndex(value), value);
+    EXPECT_EQ(LatencyHistogram::BucketUpperBound(value), value);
+  }
+
+  // every value is in a bucket whose range contains it, and the buckets are contiguous
+  for (uint64_t value = 1; value < (1 << 20); ++value) {
+    const size_t bucket = LatencyHistogram::BucketIndex(value);
+    ASSERT_LE(value, LatencyHistogram::BucketUpperBound(bucket)) << value;
+    ASSERT_GT(value, LatencyHistogram::BucketUpperBound(bucket - 1)) << value;
+  }
+
+  // the relative error of a bucket is bounded by 1/kSubBuckets
+  const size_t bucket = LatencyHistogram::BucketIndex(1000000);
+  const uint64_t bucket_width =
+      LatencyHistogram::BucketUpperBound(bucket) - LatencyHistogram::BucketUpperBound(bucket - 1);
+  EXPECT_LE(bucket_width, 1000000 / LatencyHistogram::kSubBuckets);
+
+  EXPECT_EQ(LatencyHistogram::BucketIndex(uint64_t{1} << LatencyHistogram::kMaxValueBits),
+            LatencyHistogram::kNumBuckets - 1);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(UINT64_MAX), LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, Quantiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.GetSnapshot().ValueAtQuantile(0.5), 0u);
+
+  for (uint64_t value = 1; value <= 1000; ++value) {
+    histogram.Record(value);
+  }
+
+  const auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.count, 1000u);
+  EXPECT_EQ(snapshot.sum, 500500u);
+  EXPECT_EQ(snapshot.max, 1000u);
+
+  for (double quantile : {0.5, 0.9, 0.99}) {
+    const double exact = quantile * 1000;
+    const double value = static_cast<double>(snapshot.ValueAtQuantile(quantile));
+    EXPECT_GE(value, exact) << quantile;
+    EXPECT_LE(value, exact * (1 + 1.0 / LatencyHistogram::kSubBuckets)) << quantile;
+  }
+
+  // the largest quantile is the maximum, not the end of its bucket
+  EXPECT_EQ(snapshot.ValueAtQuantile(1.0), 1000u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -3,11 +3,14 @@
 
 #include "core/common/logging/capture.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/common/logging/sinks/cerr_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/sinks/composite_sink.h"
 #include "core/common/logging/sinks/file_sink.h"
 
+#include <future>
+
 #include "test/common/logging/helpers.h"
 
 using namespace ::onnxruntime::logging;
@@ -144,3 +147,75 @@ TEST(LoggingTests, TestCompositeSink) {
 
   LOGS_CATEGORY(*logger, WARNING, "ArbitraryCategory") << "Warning";
 }
+
+/// <summary>
+/// Tests that an AsyncSink outputs all the messages to the wrapped sink by the time it is destroyed.
+/// </summary>
+TEST(LoggingTests, TestAsyncSink) {
+  const std::string logid{"TestAsyncSink"};
+  const Severity min_log_level = Severity::kWARNING;
+
+  MockSink* sink_ptr = new MockSink();
+  EXPECT_CALL(*sink_ptr, SendImpl(testing::_, logid, testing::Property(&Capture::Message, "Warning")))
+      .Times(3);
+
+  {
+    LoggingManager manager{std::unique_ptr<ISink>(new AsyncSink(std::unique_ptr<ISink>(sink_ptr))),
+                           min_log_level, false, InstanceType::Temporal};
+    auto logger = manager.CreateLogger(logid);
+
+    for (int i = 0; i < 3; ++i) {
+      LOGS_CATEGORY(*logger, WARNING, "ArbitraryCategory") << "Warning";
+    }
+    LOGS_CATEGORY(*logger, INFO, "ArbitraryCategory") << "Info isn't sent to the sink";
+  }
+}
+
+namespace {
+// Sink that blocks on the first message until released
+class BlockingSink : public ISink {
+ public:
+  BlockingSink(std::promise<void>& started, std::shared_future<void> release, std::vector<std::string>& messages)
+      : started_{started}, release_{std::move(release)}, messages_{messages} {}
+
+ private:
+  void SendImpl(const Timestamp&, const std::string&, const Capture& message) override {
+    messages_.push_back(message.Message());
+    if (messages_.size() == 1) {
+      started_.set_value();
+      release_.wait();
+    }
+  }
+
+  std::promise<void>& started_;
+  std::shared_future<void> release_;
+  std::vector<std::string>& messages_;
+};
+}  // namespace
+
+/// <summary>
+/// Tests that an AsyncSink drops the messages when its ring buffer is full and reports how many were dropped.
+/// </summary>
+TEST(LoggingTests, TestAsyncSinkDropsWhenFull) {
+  std::promise<void> started;
+  std::promise<void> release;
+  std::vector<std::string> messages;
+
+  {
+    AsyncSink sink{std::unique_ptr<ISink>(new BlockingSink(started, release.get_future().share(), messages)), 2};
+    const Capture message{Severity::kWARNING, Category::onnxruntime, DataType::SYSTEM, ORT_WHERE, "Warning"};
+
+    sink.Send(Timestamp{}, "logger", message);
+    // the background thread is now blocked in the wrapped sink, so 2 messages fill the ring buffer
+    started.get_future().wait();
+    for (int i = 0; i < 5; ++i) {
+      sink.Send(Timestamp{}, "logger", message);
+    }
+    EXPECT_EQ(sink.DroppedCount(), 3u);
+
+    release.set_value();
+  }
+
+  ASSERT_EQ(messages.size(), 4u);
+  EXPECT_EQ(messages[3], "3 log messages were dropped as the log output couldn't keep up");
+}
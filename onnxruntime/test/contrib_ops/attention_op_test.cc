@@ -222,6 +222,56 @@ TEST(AttentionTest, AttentionMaskPartialSequence) {
                    batch_size, sequence_length, hidden_size, number_of_heads);
 }
 
+TEST(AttentionTest, AttentionPackedSequences) {
+  int hidden_size = 4;
+  int number_of_heads = 2;
+
+  // The first sequence has the two tokens of AttentionBatch1 and the second one its first token only.
+  std::vector<float> input_data = {
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f,
+      0.8f, -0.5f, 0.0f, 1.f};
+
+  std::vector<float> weight_data = {
+      0.1f, -0.2f, 0.3f, 1.0f, 1.1f, 0.3f, 0.5f, 0.2f, 0.3f, -0.6f, 1.5f, 2.0f,
+      0.5f, 0.1f, 0.4f, 1.6f, 1.0f, 2.0f, 0.4f, 0.8f, 0.9f, 0.1f, -1.3f, 0.7f,
+      0.3f, 0.2f, 4.0f, 2.2f, 1.6f, 1.1f, 0.7f, 0.2f, 0.4f, 1.0f, 1.2f, 0.5f,
+      0.2f, 0.1f, 0.4f, 1.6f, 2.4f, 3.3f, 2.1f, 4.2f, 8.4f, 0.0f, 2.1f, 3.2f};
+
+  std::vector<float> bias_data = {
+      -0.5f, 0.6f, 1.2f, 2.1f, 0.5f, 0.7f, 0.2f, 1.2f, 0.5f, 0.4f, 0.3f, 1.2f};
+
+  std::vector<int32_t> cumulative_sequence_length = {0, 2, 3};
+
+  // A sequence of one token attends to itself only, like with mask_index 1 in AttentionMaskPartialSequence.
+  std::vector<float> output_data = {
+      3.1495983600616455f, 0.10843668878078461f, 4.25f, 5.6499996185302734f,
+      3.9696791172027588f, 0.073143675923347473f, 4.2499995231628418f, 5.6499991416931152f,
+      8.6899995803833008f, -0.13000002503395081f, 4.25f, 5.6499996185302734f};
+
+  int token_count = 3;
+  OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  tester.AddInput<float>("input", {token_count, hidden_size}, input_data);
+  tester.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weight_data);
+  tester.AddInput<float>("bias", {3 * hidden_size}, bias_data);
+  tester.AddMissingOptionalInput<int32_t>();
+  tester.AddMissingOptionalInput<float>();
+  tester.AddInput<int32_t>("cumulative_sequence_length", {3}, cumulative_sequence_length);
+  tester.AddOutput<float>("output", {token_count, hidden_size}, output_data);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  if (HasCudaEnvironment(0)) {
+    execution_providers.push_back(DefaultCudaExecutionProvider());
+  }
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  for (auto& execution_provider : execution_providers) {
+    std::vector<std::unique_ptr<IExecutionProvider>> run_providers;
+    run_providers.push_back(std::move(execution_provider));
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &run_providers);
+  }
+}
+
 TEST(AttentionTest, AttentionMaskExceedSequence) {
   int batch_size = 1;
   int sequence_length = 2;
@@ -566,6 +616,84 @@ TEST(AttentionTest, AttentionPastStateBatch1) {
                    use_past_state, past_sequence_length, &past_data, &present_data);
 }
 
+TEST(AttentionTest, AttentionPastStateSharedBuffer) {
+  // AttentionPastStateBatch1 with past and present in buffers of 5 steps, of which the first 3 are valid.
+  int hidden_size = 4;
+  int number_of_heads = 2;
+  int head_size = 2;
+  int past_sequence_length = 3;
+  int max_sequence_length = 5;
+
+  std::vector<float> input_data = {
+      -0.019333266f, -0.21813886f, 0.16212955f, -0.015626367f};
+
+  std::vector<float> weight_data = {
+      -0.4738484025001526f, -0.2613658607006073f, -0.0978037416934967f, -0.34988933801651f,
+      0.2243240624666214f, -0.0429205559194088f, 0.418695330619812f, 0.17441125214099884f,
+      -0.18825532495975494f, 0.18357256054878235f, -0.5806483626365662f, -0.02251487597823143f,
+      0.08742205798625946f, 0.14734269678592682f, 0.2387014478445053f, 0.2884027063846588f,
+      0.6490834355354309f, 0.16965825855731964f, -0.06346885114908218f, 0.4073973298072815f,
+      -0.03070945478975773f, 0.4110257923603058f, 0.07896808534860611f, 0.16783113777637482f,
+      0.0038893644232302904f, 0.06946629285812378f, 0.36680519580841064f, -0.07261059433221817f,
+      -0.14960581064224243f, 0.020944256335496902f, -0.09378612786531448f, -0.1336742341518402f,
+      0.06061394885182381f, 0.2205914407968521f, -0.03519909828901291f, -0.18405692279338837f,
+      0.22149960696697235f, -0.1884360909461975f, -0.014074507169425488f, 0.4252440333366394f,
+      0.24987126886844635f, -0.31396418809890747f, 0.14036843180656433f, 0.2854192554950714f,
+      0.09709841012954712f, 0.09935075044631958f, -0.012154420837759972f, 0.2575816512107849f};
+
+  std::vector<float> bias_data = {
+      0.4803391396999359f, -0.5254325866699219f, -0.42926454544067383f, -0.2059524953365326f,
+      -0.12773379683494568f, -0.09542735666036606f, -0.35286077857017517f, -0.07646317780017853f,
+      -0.04590314254164696f, -0.03752850368618965f, -0.013764488510787487f, -0.18478283286094666f};
+
+  std::vector<float> output_data = {
+      0.20141591f, 0.43005896f, 0.35745093f, 0.19957167f};
+
+  std::vector<float> past_data = {
+      0.55445826f, 0.10127074f, 0.71770734f, 0.15915526f, 0.13913247f, 0.77447522f, 0.66044068f, 0.27559045f, 0.35731629f, 0.62033528f, 0.24354559f, 0.22859341f,
+      0.45075402f, 0.85365993f, 0.097346395f, 0.28859729f, 0.26926181f, 0.65922296f, 0.8177433f, 0.4212271f, 0.34352475f, 0.059609573f, 0.46556228f, 0.7226882f};
+
+  std::vector<float> present_data = {
+      0.55445826f, 0.10127074f, 0.71770734f, 0.15915526f, 0.13913247f, 0.77447522f, -0.30182117f, -0.12330482f, 0.66044068f, 0.27559045f, 0.35731629f, 0.62033528f, 0.24354559f, 0.22859341f, -0.36450946f, -0.19483691f,
+      0.45075402f, 0.85365993f, 0.097346395f, 0.28859729f, 0.26926181f, 0.65922296f, -0.027254611f, -0.096526355f, 0.8177433f, 0.4212271f, 0.34352475f, 0.059609573f, 0.46556228f, 0.7226882f, -0.025281552f, -0.25482416f};
+
+  // Pad each (key or value, head) chunk to max_sequence_length steps. The padding shall be left untouched.
+  const float padding = 7.0f;
+  const size_t past_chunk_length = static_cast<size_t>(past_sequence_length) * head_size;
+  const size_t present_chunk_length = past_chunk_length + head_size;
+  const size_t buffer_chunk_length = static_cast<size_t>(max_sequence_length) * head_size;
+  std::vector<float> past_buffer;
+  std::vector<float> present_buffer;
+  for (size_t i = 0; i < 2 * static_cast<size_t>(number_of_heads); i++) {
+    past_buffer.insert(past_buffer.end(), past_data.begin() + i * past_chunk_length,
+                       past_data.begin() + (i + 1) * past_chunk_length);
+    past_buffer.resize((i + 1) * buffer_chunk_length, padding);
+    present_buffer.insert(present_buffer.end(), present_data.begin() + i * present_chunk_length,
+                          present_data.begin() + (i + 1) * present_chunk_length);
+    present_buffer.resize((i + 1) * buffer_chunk_length, padding);
+  }
+
+  std::vector<int64_t> buffer_dims = {2, 1, number_of_heads, max_sequence_length, head_size};
+
+  OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  tester.AddAttribute<int64_t>("unidirectional", static_cast<int64_t>(1));
+  tester.AddAttribute<int64_t>("past_present_share_buffer", static_cast<int64_t>(1));
+  tester.AddInput<float>("input", {1, 1, hidden_size}, input_data);
+  tester.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weight_data);
+  tester.AddInput<float>("bias", {3 * hidden_size}, bias_data);
+  tester.AddMissingOptionalInput<int32_t>();
+  tester.AddInput<float>("past", buffer_dims, past_buffer);
+  tester.AddMissingOptionalInput<int32_t>();
+  tester.AddInput<int32_t>("past_sequence_length", {1}, {past_sequence_length});
+  tester.AddOutput<float>("output", {1, 1, hidden_size}, output_data);
+  tester.AddOutput<float>("present", buffer_dims, present_buffer);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 TEST(AttentionTest, AttentionPastStateBatch2) {
   int batch_size = 2;
   int sequence_length = 1;
@@ -1204,5 +1332,51 @@ TEST(AttentionTest, AttentionPastState_dynamic) {
   test.Run();
 }
 
+
+TEST(AttentionTest, AttentionUnidirectionalLongSequence) {
+  // Total sequence length above 1024 uses the memory efficient attention kernel on CUDA.
+  int batch_size = 1;
+  int sequence_length = 1040;
+  int hidden_size = 4;
+  int number_of_heads = 2;
+  int mask_end = 1030;
+
+  std::vector<float> input_data(sequence_length * hidden_size);
+  for (int s = 0; s < sequence_length; s++) {
+    for (int h = 0; h < hidden_size; h++) {
+      input_data[s * hidden_size + h] = static_cast<float>(s % 7) * 0.1f + static_cast<float>(h) * 0.01f;
+    }
+  }
+
+  // Q and K are zero so every attended key has the same score, and V is the input.
+  std::vector<float> weight_data(hidden_size * 3 * hidden_size, 0.0f);
+  for (int h = 0; h < hidden_size; h++) {
+    weight_data[h * 3 * hidden_size + 2 * hidden_size + h] = 1.0f;
+  }
+
+  std::vector<float> bias_data(3 * hidden_size, 0.0f);
+
+  std::vector<int32_t> mask_index_data = {mask_end};
+
+  // Each output row is the mean of the inputs it attends to: [0, min(s + 1, mask_end)).
+  std::vector<float> output_data(sequence_length * hidden_size);
+  std::vector<double> sum(hidden_size, 0.0);
+  for (int s = 0; s < sequence_length; s++) {
+    if (s < mask_end) {
+      for (int h = 0; h < hidden_size; h++) {
+        sum[h] += input_data[s * hidden_size + h];
+      }
+    }
+    const int count = std::min(s + 1, mask_end);
+    for (int h = 0; h < hidden_size; h++) {
+      output_data[s * hidden_size + h] = static_cast<float>(sum[h] / count);
+    }
+  }
+
+  bool is_unidirectional = true;
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+#include "core/util/qmath.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Weights quantized per direction, with shape [num_directions, K, N], and the equivalent float weights with the
+// shape [num_directions, N, K] taken by the float operator.
+template <typename T>
+struct QuantizedRnnWeights {
+  QuantizedRnnWeights(RandomValueGenerator& random, int64_t num_directions, int64_t K, int64_t N)
+      : dims{num_directions, K, N}, float_dims{num_directions, N, K} {
+    std::vector<int32_t> values = random.Uniform<int32_t>(dims, std::numeric_limits<T>::min(),
+                                                          std::numeric_limits<T>::max());
+    quantized.assign(values.begin(), values.end());
+    scale = random.Uniform<float>({num_directions}, 0.0005f, 0.002f);
+    std::vector<int32_t> zero_point_values = random.Uniform<int32_t>({num_directions}, std::numeric_limits<T>::min(),
+                                                                     std::numeric_limits<T>::max());
+    zero_point.assign(zero_point_values.begin(), zero_point_values.end());
+
+    dequantized.resize(quantized.size());
+    for (int64_t d = 0; d < num_directions; ++d) {
+      for (int64_t k = 0; k < K; ++k) {
+        for (int64_t n = 0; n < N; ++n) {
+          const int32_t q = quantized[(d * K + k) * N + n];
+          dequantized[(d * N + n) * K + k] = scale[d] * (q - zero_point[d]);
+        }
+      }
+    }
+  }
+
+  std::vector<int64_t> dims;
+  std::vector<int64_t> float_dims;
+  std::vector<T> quantized;
+  std::vector<float> scale;
+  std::vector<T> zero_point;
+  std::vector<float> dequantized;
+};
+
+// Runs the float operator with the dequantized weights and checks that the quantized operator gets close outputs.
+template <typename T>
+static void RunDynamicQuantizeRnnTest(const std::string& op_type, const std::string& direction, int64_t seq_length,
+                                      int64_t batch_size, int64_t input_size, int64_t hidden_size,
+                                      bool linear_before_reset = false) {
+  const bool is_lstm = op_type == "LSTM";
+  const int64_t num_directions = direction == "bidirectional" ? 2 : 1;
+  const int64_t num_gates = is_lstm ? 4 : 3;
+
+  RandomValueGenerator random{};
+  const std::vector<int64_t> X_dims{seq_length, batch_size, input_size};
+  const std::vector<float> X = random.Uniform<float>(X_dims, -1.0f, 1.0f);
+  const std::vector<int64_t> B_dims{num_directions, 2 * num_gates * hidden_size};
+  const std::vector<float> B = random.Uniform<float>(B_dims, -0.1f, 0.1f);
+  QuantizedRnnWeights<T> W(random, num_directions, input_size, num_gates * hidden_size);
+  QuantizedRnnWeights<T> R(random, num_directions, hidden_size, num_gates * hidden_size);
+
+  const std::vector<int64_t> Y_dims{seq_length, num_directions, batch_size, hidden_size};
+  const std::vector<int64_t> Y_h_dims{num_directions, batch_size, hidden_size};
+  const std::vector<float> Y_zeros(seq_length * num_directions * batch_size * hidden_size);
+  const std::vector<float> Y_h_zeros(num_directions * batch_size * hidden_size);
+
+  auto add_attributes = [&](OpTester& test) {
+    test.AddAttribute<std::string>("direction", direction);
+    test.AddAttribute<int64_t>("hidden_size", hidden_size);
+    if (!is_lstm) {
+      test.AddAttribute<int64_t>("linear_before_reset", linear_before_reset ? 1 : 0);
+    }
+  };
+
+  // run the float operator on CPU to get the expected outputs
+  OpTester float_test(op_type.c_str(), 7, kOnnxDomain, false);
+  add_attributes(float_test);
+  float_test.AddInput<float>("X", X_dims, X);
+  float_test.AddInput<float>("W", W.float_dims, W.dequantized);
+  float_test.AddInput<float>("R", R.float_dims, R.dequantized);
+  float_test.AddInput<float>("B", B_dims, B);
+  float_test.AddOutput<float>("Y", Y_dims, Y_zeros);
+  float_test.AddOutput<float>("Y_h", Y_h_dims, Y_h_zeros);
+  if (is_lstm) {
+    float_test.AddOutput<float>("Y_c", Y_h_dims, Y_h_zeros);
+  }
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  float_test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  std::vector<MLValue> expected = float_test.GetFetches();
+
+  OpTester test(("DynamicQuantize" + op_type).c_str(), 1, kMSDomain);
+  add_attributes(test);
+  test.AddInput<float>("X", X_dims, X);
+  test.AddInput<T>("W", W.dims, W.quantized);
+  test.AddInput<T>("R", R.dims, R.quantized);
+  test.AddInput<float>("B", B_dims, B);
+  test.AddMissingOptionalInput<int32_t>();
+  test.AddMissingOptionalInput<float>();
+  if (is_lstm) {
+    test.AddMissingOptionalInput<float>();
+    test.AddMissingOptionalInput<float>();
+  }
+  test.AddInput<float>("W_scale", {num_directions}, W.scale);
+  test.AddInput<T>("W_zero_point", {num_directions}, W.zero_point);
+  test.AddInput<float>("R_scale", {num_directions}, R.scale);
+  test.AddInput<T>("R_zero_point", {num_directions}, R.zero_point);
+
+  const char* output_names[] = {"Y", "Y_h", "Y_c"};
+  for (size_t i = 0; i < expected.size(); ++i) {
+    const Tensor& expected_tensor = expected[i].Get<Tensor>();
+    test.AddOutput<float>(output_names[i], expected_tensor.Shape().GetDims(), expected_tensor.Data<float>(),
+                          static_cast<size_t>(expected_tensor.Shape().Size()));
+    // the inputs of the GEMMs are quantized to 8 bits
+    test.SetOutputAbsErr(output_names[i], 0.02f);
+  }
+
+  test.Run();
+}
+
+TEST(DynamicQuantizeLSTMTest, ForwardUInt8) {
+  RunDynamicQuantizeRnnTest<uint8_t>("LSTM", "forward", 3, 2, 8, 4);
+}
+
+TEST(DynamicQuantizeLSTMTest, BidirectionalInt8) {
+  RunDynamicQuantizeRnnTest<int8_t>("LSTM", "bidirectional", 3, 5, 8, 6);
+}
+
+TEST(DynamicQuantizeLSTMTest, ReverseBatchParallel) {
+  // a batch large enough for the batch-parallel path of the recurrence
+  RunDynamicQuantizeRnnTest<int8_t>("LSTM", "reverse", 2, 32, 16, 8);
+}
+
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+TEST(DynamicQuantizeGRUTest, ForwardUInt8) {
+  RunDynamicQuantizeRnnTest<uint8_t>("GRU", "forward", 3, 2, 8, 4);
+}
+
+TEST(DynamicQuantizeGRUTest, BidirectionalInt8LinearBeforeReset) {
+  RunDynamicQuantizeRnnTest<int8_t>("GRU", "bidirectional", 3, 5, 8, 6, true);
+}
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
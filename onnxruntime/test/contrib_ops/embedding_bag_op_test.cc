@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A table of 4 rows of 3 columns, row i holding i + 1, 10 * (i + 1) and -(i + 1).
+static const std::vector<float> kEmbeddingTable{1.f, 10.f, -1.f,
+                                                2.f, 20.f, -2.f,
+                                                3.f, 30.f, -3.f,
+                                                4.f, 40.f, -4.f};
+
+TEST(EmbeddingBagTest, SumFixedBags) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("table", {4, 3}, kEmbeddingTable);
+  test.AddInput<int64_t>("indices", {2, 3}, {0, 1, 3, 2, 2, -1});
+  test.AddOutput<float>("Y", {2, 3}, {7.f, 70.f, -7.f,
+                                      10.f, 100.f, -10.f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, MeanFixedBags) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<float>("table", {4, 3}, kEmbeddingTable);
+  test.AddInput<int32_t>("indices", {2, 2}, {0, 1, 3, 3});
+  test.AddOutput<float>("Y", {2, 3}, {1.5f, 15.f, -1.5f,
+                                      4.f, 40.f, -4.f});
+  test.Run();
+}
+
+// Bags of 3, 0 and 2 indices given by offsets. The empty bag produces zeros.
+TEST(EmbeddingBagTest, MeanOffsets) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<float>("table", {4, 3}, kEmbeddingTable);
+  test.AddInput<int64_t>("indices", {5}, {0, 1, 2, 3, 1});
+  test.AddInput<int64_t>("offsets", {3}, {0, 3, 3});
+  test.AddOutput<float>("Y", {3, 3}, {2.f, 20.f, -2.f,
+                                      0.f, 0.f, 0.f,
+                                      3.f, 30.f, -3.f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, InvalidIndex) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("table", {4, 3}, kEmbeddingTable);
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 4});
+  test.AddOutput<float>("Y", {1, 3}, {0.f, 0.f, 0.f});
+  // CUDA skips the indices out of the table, as its Gather does
+  test.Run(OpTester::ExpectResult::kExpectFailure, "index 4 is out of range", {kCudaExecutionProvider});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -353,6 +353,64 @@ TEST(EmbedLayerNormTest, EmbedLayerNormBatch2_NoMask) {
           false); // no mask
 }
 
+TEST(EmbedLayerNormTest, EmbedLayerNormPackedSequences) {
+  int hidden_size = 4;
+
+  // The sequences of EmbedLayerNormBatch2_NoMask packed without padding, with the second one cut to one token.
+  std::vector<int32_t> input_ids_data = {1, 3, 2, 1, 3};
+  std::vector<int32_t> segment_ids_data = {0, 1, 0, 0, 1};
+  std::vector<int32_t> cumulative_sequence_length = {0, 2, 3, 5};
+
+  std::vector<float> word_embedding_data = {
+      0.2f, 0.1f, 0.4f, -0.6f,
+      0.3f, 0.2f, 0.5f, 0.6f,
+      0.6f, 0.7f, 0.0f, -0.1f,
+      0.8f, 0.6f, 0.9f, 1.2f,
+      0.1f, 0.3f, 0.5f, 0.9f,
+      1.0f, -2.0f, 1.1f, 0.8f};
+
+  std::vector<float> position_embedding_data = {
+      0.1f, 0.1f, 0.4f, 0.6f,
+      0.6f, 0.0f, 0.8f, 0.6f,
+      0.3f, 0.9f, -2.0f, 0.8f};
+
+  std::vector<float> segment_embedding_data = {
+      0.3f, 0.4f, 0.9f, 0.1f,
+      0.7f, 0.3f, 0.5f, 0.2f};
+
+  std::vector<float> gamma_data = {
+      0.25f, 0.15f, 0.45f, -0.66f};
+
+  std::vector<float> beta_data = {
+      0.6f, 0.2f, 0.5f, -0.6f};
+
+  // the position of each token restarts at the beginning of its sequence
+  std::vector<float> output_data = {
+      0.36917170882225037, 0.061503000557422638, 1.1598974466323853, -0.85092413425445557,
+      0.74301940202713013, -0.057434864342212677, 0.84324657917022705, -0.85171419382095337,
+      0.57668739557266235, 0.2979130744934082, 0.96158987283706665, 0.44627034664154053,
+      0.36917170882225037, 0.061503000557422638, 1.1598974466323853, -0.85092413425445557,
+      0.74301940202713013, -0.057434864342212677, 0.84324657917022705, -0.85171419382095337};
+
+  std::vector<int32_t> mask_index_data = {2, 1, 2};
+
+  int token_count = 5;
+  OpTester tester("EmbedLayerNormalization", 1, onnxruntime::kMSDomain);
+  tester.AddInput<int32_t>("input_ids", {token_count}, input_ids_data);
+  tester.AddInput<int32_t>("segment_ids", {token_count}, segment_ids_data);
+  tester.AddInput<float>("word_embedding", {6, hidden_size}, word_embedding_data);
+  tester.AddInput<float>("position_embedding", {3, hidden_size}, position_embedding_data);
+  tester.AddInput<float>("segment_embedding", {2, hidden_size}, segment_embedding_data);
+  tester.AddInput<float>("gamma", {hidden_size}, gamma_data);
+  tester.AddInput<float>("beta", {hidden_size}, beta_data);
+  tester.AddAttribute("epsilon", epsilon_);
+  tester.AddMissingOptionalInput<int32_t>();
+  tester.AddInput<int32_t>("cumulative_sequence_length", {4}, cumulative_sequence_length);
+  tester.AddOutput<float>("output", {token_count, hidden_size}, output_data);
+  tester.AddOutput<int32_t>("mask_index", {3}, mask_index_data);
+  tester.Run();
+}
+
 // BatchSize > HiddenSize to reproduce mask processing bug
 TEST(EmbedLayerNormTest, EmbedLayerNormLargeBatchSmallHiddenSize) {
   int batch_size = 5;
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Add(X, B) -> Mul(S) -> Relu with a bias B of the last dim and a scalar S.
+TEST(FusedElementwiseTest, BiasScaleRelu) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Mul", "Relu"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, 2, 4, -1});
+
+  const std::vector<float> x{-3.f, -2.f, -1.f, 0.f, 1.f, 2.f};
+  const std::vector<float> b{1.f, 2.f, 3.f};
+  const float s = 0.5f;
+  std::vector<float> y;
+  for (size_t i = 0; i < x.size(); ++i) {
+    y.push_back(std::max((x[i] + b[i % b.size()]) * s, 0.f));
+  }
+
+  test.AddInput<float>("X", {2, 3}, x);
+  test.AddInput<float>("B", {3}, b);
+  test.AddInput<float>("S", {1}, {s});
+  test.AddOutput<float>("Y", {2, 3}, y);
+  test.Run();
+}
+
+// Sub(A, B) -> Abs, broadcasting A of shape [2, 1] and B of shape [1, 3] to [2, 3].
+TEST(FusedElementwiseTest, Broadcast) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Sub", "Abs"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1});
+
+  test.AddInput<float>("A", {2, 1}, {1.f, 2.f});
+  test.AddInput<float>("B", {1, 3}, {0.f, 1.f, 3.f});
+  test.AddOutput<float>("Y", {2, 3}, {1.f, 0.f, 2.f, 2.f, 1.f, 1.f});
+  test.Run();
+}
+
+// Gelu computed as X * 0.5 * (1 + Erf(X / sqrt(2))) on an input spanning several tiles.
+TEST(FusedElementwiseTest, Gelu) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Div", "Erf", "Add", "Mul", "Mul"});
+  // inputs: X, sqrt(2), 1, 0.5
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 4, -1, 5, 2, 0, 6, 7, 3});
+
+  const int64_t size = 1500;
+  std::vector<float> x;
+  std::vector<float> y;
+  for (int64_t i = 0; i < size; ++i) {
+    x.push_back(static_cast<float>(i - size / 2) / 100.f);
+    y.push_back(x.back() * 0.5f * (1.f + std::erf(x.back() / std::sqrt(2.f))));
+  }
+
+  test.AddInput<float>("X", {3, size / 3}, x);
+  test.AddInput<float>("sqrt2", {}, {std::sqrt(2.f)});
+  test.AddInput<float>("one", {}, {1.f});
+  test.AddInput<float>("half", {}, {0.5f});
+  test.AddOutput<float>("Y", {3, size / 3}, y);
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, InvalidOperand) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 2});
+
+  test.AddInput<float>("A", {2}, {1.f, 2.f});
+  test.AddInput<float>("B", {2}, {1.f, 2.f});
+  test.AddOutput<float>("Y", {2}, {2.f, 4.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Invalid operand 2 of the op 0 of FusedElementwise");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -179,6 +179,42 @@ TEST(SkipLayerNormTest, SkipLayerNormBatch2) {
           hidden_size);
 }
 
+TEST(SkipLayerNormTest, SkipLayerNormPackedSequences) {
+  int token_count = 3;
+  int hidden_size = 4;
+
+  // the first three tokens of SkipLayerNormBatch2 packed as (token_count, hidden_size)
+  std::vector<float> input_data = {
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f,
+      0.8f, -0.5f, 0.0f, 1.f};
+
+  std::vector<float> skip_data = {
+      0.1f, -0.2f, 0.3f, 1.0f,
+      0.5f, 0.1f, 0.4f, 1.6f,
+      1.8f, -0.3f, 0.0f, 1.f};
+
+  std::vector<float> gamma_data = {
+      0.3f, 0.2f, 4.0f, 2.2f};
+
+  std::vector<float> beta_data = {
+      0.2f, 0.1f, 0.4f, 1.6f};
+
+  std::vector<float> output_data = {
+      0.28433859348297119, -0.17090578377246857, -0.92897164821624756, 4.6924152374267578,
+      0.46111652255058289, -0.21333980560302734, -0.29631003737449646, 3.5148544311523438,
+      0.55470430850982666, -0.15080101788043976, -2.3229825496673584, 3.255286693572998};
+
+  OpTester test("SkipLayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("input", {token_count, hidden_size}, input_data);
+  test.AddInput<float>("skip", {token_count, hidden_size}, skip_data);
+  test.AddInput<float>("gamma", {hidden_size}, gamma_data);
+  test.AddInput<float>("beta", {hidden_size}, beta_data);
+  test.AddAttribute("epsilon", epsilon_);
+  test.AddOutput<float>("output", {token_count, hidden_size}, output_data);
+  test.Run();
+}
+
 TEST(SkipLayerNormTest, SkipLayerNormBatch2_Bias) {
   int batch_size = 2;
   int sequence_length = 2;
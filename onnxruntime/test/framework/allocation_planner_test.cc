@@ -126,15 +126,19 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, ExecutionOrder execution_order = ExecutionOrder::Default)
+      : shape_map_(shape_map), execution_order_(execution_order) {}
 
   TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  ExecutionOrder GetExecutionOrder() const override { return execution_order_; }
+
  private:
   ShapeMap* shape_map_;
+  ExecutionOrder execution_order_;
 };
 
 class PlannerTest : public ::testing::Test {
@@ -151,6 +155,7 @@ class PlannerTest : public ::testing::Test {
 
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;       // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;  // a unary kernel with in-place
+  std::unique_ptr<::onnxruntime::KernelDef> view_kernel_;      // a unary kernel whose output may be a view
 
   std::unordered_map<std::string, onnxruntime::NodeArg*> name_to_arg_;
   std::vector<std::unique_ptr<UnaryNode>> nodes_;
@@ -162,6 +167,7 @@ class PlannerTest : public ::testing::Test {
   profiling::Profiler profiler_;
   SessionState state_;
   ShapeMap shape_map_;
+  ExecutionOrder execution_order_ = ExecutionOrder::Default;
   std::unique_ptr<SequentialExecutionPlan> plan_;
 
  public:
@@ -175,6 +181,8 @@ class PlannerTest : public ::testing::Test {
     std_kernel_ = KernelDefBuilder().SetName("Transpose").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
     in_place_kernel_ =
         KernelDefBuilder().SetName("Relu").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayInplace(0, 0).Build();
+    view_kernel_ =
+        KernelDefBuilder().SetName("Squeeze").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayView(0, 0).Build();
     CPUExecutionProviderInfo epi;
     auto execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
     execution_providers_.Add("CPUExecutionProvider", std::move(execution_provider));
@@ -203,6 +211,10 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*in_place_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddViewNode(std::string& input, std::string& output) {
+    return AddNode(*view_kernel_, input, output);
+  }
+
   void BindKernel(onnxruntime::Node* p_node, ::onnxruntime::KernelDef& kernel_def, KernelRegistry* reg) {
     const IExecutionProvider* ep = execution_providers_.Get(*p_node);
     ASSERT_NE(ep, nullptr);
@@ -226,6 +238,8 @@ class PlannerTest : public ::testing::Test {
     }
   }
 
+  void SetExecutionOrder(ExecutionOrder execution_order) { execution_order_ = execution_order; }
+
   void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}) {
     EXPECT_EQ(graph_.Resolve(), Status::OK());
 
@@ -246,7 +260,7 @@ class PlannerTest : public ::testing::Test {
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
     status = state_.CreateKernels(kernel_registry_manager);
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, execution_order_);
     status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph_), outer_scope_node_args, execution_providers,
                                            kernel_registry_manager, state_.GetOrtValueNameIdxMap(), test_context, plan_);
 
@@ -260,6 +274,19 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+  void CheckInPlaceReuse(const std::string& name, bool expected) {
+    int id;
+    index(name, id);
+    EXPECT_EQ(plan_->allocation_plan[id].inplace_reuse, expected) << "Error in in-place reuse for " << name;
+  }
+
+  void CheckReusedBuffer(const std::string& name, const std::string& reused_name) {
+    int id, reused_id;
+    index(name, id);
+    index(reused_name, reused_id);
+    EXPECT_EQ(plan_->allocation_plan[id].reused_buffer, reused_id) << "Error in reused buffer for " << name;
+  }
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // create set and check equality
     std::unordered_set<int> expected;
@@ -381,6 +408,8 @@ TEST_F(PlannerTest, InPlaceTest) {
   CheckAllocKind(X3, AllocKind::kReuse);
   CheckAllocKind(X4, AllocKind::kAllocateOutput);
 
+  CheckInPlaceReuse(X3, true);
+
   // check each ml-value is freed at appropriate step
   CheckFreed(0, {});
   CheckFreed(1, {});
@@ -422,6 +451,165 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+// SymbolicSizeReuseTest: Check that buffers are reused when their sizes are provably equal even though the
+// symbolic shapes differ in rank or dimension order.
+TEST_F(PlannerTest, SymbolicSizeReuseTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // X1: input; X2: temporary
+  AddNormalNode(X2, X3);  // X3: temporary
+  AddNormalNode(X3, X4);  // X4: temporary
+  AddNormalNode(X4, X5);  // X5: output
+
+  // simulate shape-inference results:
+  Shape shape1w{"B", "S"};
+  auto shape1 = &shape1w.value;
+  Shape shape2w{"S", "B"};
+  auto shape2 = &shape2w.value;
+  Shape shape3w{"B", "S"};
+  shape3w.value.add_dim()->set_dim_value(1);
+  auto shape3 = &shape3w.value;
+  SetShape({{X1, shape1}, {X2, shape1}, {X3, shape1}, {X4, shape2}, {X5, shape3}});
+
+  CreatePlan();
+
+  // X4 ({S, B}) can reuse X2 ({B, S}) since both hold B*S elements.
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kReuse);
+  CheckAllocKind(X5, AllocKind::kAllocateOutput);
+}
+
+// ViewTest: Check that the buffer viewed by an output lives as long as the output, and that both are freed together.
+TEST_F(PlannerTest, ViewTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // X1: input; X2: temporary
+  AddViewNode(X2, X3);    // X3: view of X2
+  AddNormalNode(X3, X4);  // X4: temporary
+  AddNormalNode(X4, X5);  // X5: output
+
+  CreatePlan();
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocateOrView);
+  CheckReusedBuffer(X3, X2);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+
+  // X2 is freed with its view after the last use of X3 rather than after its own last use
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X2, X3});
+  CheckFreed(3, {X4});
+}
+
+// ViewOfInputTest: Check that a view of a graph input is freed after its own last use.
+TEST_F(PlannerTest, ViewOfInputTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3");
+
+  // graph structure:
+  AddViewNode(X1, X2);    // X1: input; X2: view of X1
+  AddNormalNode(X2, X3);  // X3: output
+
+  CreatePlan();
+
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kAllocateOrView);
+  CheckReusedBuffer(X2, X1);
+
+  CheckFreed(0, {});
+  CheckFreed(1, {X2});
+}
+
+// InPlaceOnViewTest: Check that an in-place update of a view reuses the view, and never updates a graph input.
+TEST_F(PlannerTest, InPlaceOnViewTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), X7("X7"), X8("X8");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // X1: input; X2: temporary
+  AddViewNode(X2, X3);     // X3: view of X2
+  AddInplaceNode(X3, X4);  // X4: may update X3 in place
+  AddNormalNode(X4, X5);   // X5: output
+  AddViewNode(X1, X6);     // X6: view of the graph input X1
+  AddInplaceNode(X6, X7);  // X7: must not update X6 in place
+  AddNormalNode(X7, X8);   // X8: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape}, {X7, shape}, {X8, shape}});
+
+  CreatePlan();
+
+  CheckAllocKind(X3, AllocKind::kAllocateOrView);
+  CheckAllocKind(X4, AllocKind::kReuse);
+  CheckInPlaceReuse(X4, true);
+  // the view may start at an offset into X2, so X4 must reuse the view rather than X2
+  CheckReusedBuffer(X4, X3);
+  CheckAllocKind(X6, AllocKind::kAllocateOrView);
+  CheckInPlaceReuse(X7, false);
+}
+
+// NodePriorityTest: Check that nodes on the longer path to the graph outputs get a higher priority.
+TEST_F(PlannerTest, NodePriorityTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
+
+  // graph structure:
+  auto* node0 = AddNormalNode(X1, X2);  // X1: input; X2: temporary
+  auto* node1 = AddNormalNode(X2, X3);  // X3: output
+  auto* node2 = AddNormalNode(X1, X4);  // X4: output
+
+  // simulate shape-inference results:
+  Shape shape1w{10};
+  auto shape1 = &shape1w.value;
+  SetShape({{X1, shape1}, {X2, shape1}, {X3, shape1}, {X4, shape1}});
+
+  CreatePlan();
+
+  // each node costs 1 + 10 output elements, so X1 -> X2 -> X3 is twice as long as X1 -> X4.
+  EXPECT_EQ(GetPlan().NodePriority(node0->Index()), 22);
+  EXPECT_EQ(GetPlan().NodePriority(node1->Index()), 11);
+  EXPECT_EQ(GetPlan().NodePriority(node2->Index()), 11);
+}
+
+TEST_F(PlannerTest, MemoryAwareExecutionOrderTest) {
+  // tensor variables:
+  std::string X("X"), A1("A1"), A2("A2"), B1("B1"), B2("B2");
+
+  // graph structure: two independent branches, each with a large temporary and a small output
+  auto* node0 = AddNormalNode(X, A1);   // X: input; A1: large temporary
+  auto* node1 = AddNormalNode(A1, A2);  // A2: small output
+  auto* node2 = AddNormalNode(X, B1);   // B1: large temporary
+  auto* node3 = AddNormalNode(B1, B2);  // B2: small output
+
+  // simulate shape-inference results:
+  Shape large_shape{100, 100};
+  Shape small_shape{10};
+  SetShape({{X, &large_shape.value}, {A1, &large_shape.value}, {B1, &large_shape.value},
+            {A2, &small_shape.value}, {B2, &small_shape.value}});
+
+  SetExecutionOrder(ExecutionOrder::MemoryAware);
+  CreatePlan();
+
+  // the consumer of the first large temporary runs before the other branch starts, so the second large temporary
+  // reuses the buffer of the first one.
+  const auto& steps = GetPlan().execution_plan;
+  ASSERT_EQ(steps.size(), 4u);
+  std::vector<NodeIndex> order{steps[0].node_index, steps[1].node_index, steps[2].node_index, steps[3].node_index};
+  std::vector<NodeIndex> branch_a_first{node0->Index(), node1->Index(), node2->Index(), node3->Index()};
+  std::vector<NodeIndex> branch_b_first{node2->Index(), node3->Index(), node0->Index(), node1->Index()};
+  EXPECT_TRUE(order == branch_a_first || order == branch_b_first);
+  EXPECT_EQ(GetPlan().estimated_peak_memory_bytes, static_cast<int64_t>((100 * 100 + 2 * 10) * sizeof(float)));
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
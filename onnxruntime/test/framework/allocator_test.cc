@@ -3,9 +3,20 @@
 
 #include "core/framework/allocatormgr.h"
 #include "core/framework/allocator.h"
+#include "core/framework/bfc_arena.h"
+#include "core/framework/huge_page_allocator.h"
+#include "core/framework/numa_allocator.h"
+#include "core/framework/run_scoped_arena.h"
 #include "test_utils.h"
 #include "gtest/gtest.h"
 
+#include <fstream>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace onnxruntime {
 namespace test {
 TEST(AllocatorTest, CPUAllocatorTest) {
@@ -100,5 +111,117 @@ TEST(AllocatorTest, TestOverflowChecks) {
   EXPECT_TRUE(IAllocator::CalcMemSizeForArrayWithAlignment<64>(num_elements, element_size - (64 / num_elements), &size));
   EXPECT_FALSE(IAllocator::CalcMemSizeForArrayWithAlignment<64>(num_elements, element_size, &size));
 }
+
+TEST(AllocatorTest, RunScopedArenaTest) {
+  auto session_arena = std::make_shared<BFCArena>(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  AllocatorStats stats;
+
+  {
+    auto run_arena = std::make_shared<RunScopedArena>(session_arena, 4096);
+    EXPECT_STREQ(run_arena->Info().name, session_arena->Info().name);
+
+    // small allocations are carved out of a single block
+    void* p1 = run_arena->Alloc(100);
+    void* p2 = run_arena->Alloc(100);
+    EXPECT_EQ(static_cast<char*>(p2) - static_cast<char*>(p1), 128);
+    EXPECT_EQ(run_arena->ReservedBytes(), 4096u);
+
+    // freeing the most recent allocation lets it be reused
+    run_arena->Free(p2);
+    EXPECT_EQ(run_arena->Alloc(64), p2);
+    run_arena->Free(p1);
+
+    // large allocations are passed through and released on Free
+    void* large = run_arena->Alloc(3000);
+    EXPECT_EQ(run_arena->ReservedBytes(), 4096u + 3000u);
+    run_arena->Free(large);
+    EXPECT_EQ(run_arena->ReservedBytes(), 4096u);
+
+    // a new block is started once the current one is exhausted
+    for (int i = 0; i < 4; ++i) {
+      run_arena->Alloc(1024);
+    }
+    EXPECT_EQ(run_arena->ReservedBytes(), 8192u);
+
+    session_arena->GetStats(&stats);
+    EXPECT_EQ(stats.bytes_in_use, 8192);
+  }
+
+  // everything goes back to the session arena when the run arena is destroyed
+  session_arena->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(AllocatorTest, NumaCPUAllocatorTest) {
+  // node 0 exists on every machine. if the platform can't allocate on it the default allocation is used.
+  NumaCPUAllocator numa_allocator(0);
+  BFCArena arena(std::unique_ptr<IDeviceAllocator>(new NumaCPUAllocator(0)), 1 << 20);
+
+  void* bytes = numa_allocator.Alloc(4096);
+  ASSERT_NE(bytes, nullptr);
+  memset(bytes, 1, 4096);
+  numa_allocator.Free(bytes);
+
+  void* chunk = arena.Alloc(1024);
+  ASSERT_NE(chunk, nullptr);
+  memset(chunk, 1, 1024);
+  arena.Free(chunk);
+  EXPECT_TRUE(arena.Shrink().IsOK());
+}
+
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+TEST(AllocatorTest, NumaCPUAllocatorPlacementTest) {
+  // use the last node, as memory only lands on a node other than the default one on machines with several nodes
+  int last_node = -1;
+  for (int node = 0; node < 64; node++) {
+    if (std::ifstream("/sys/devices/system/node/node" + std::to_string(node) + "/meminfo").good()) {
+      last_node = node;
+    }
+  }
+  if (last_node < 1) {
+    GTEST_SKIP() << "The machine has a single NUMA node.";
+  }
+
+  NumaCPUAllocator numa_allocator(last_node);
+  const size_t size = 1 << 20;
+  void* bytes = numa_allocator.Alloc(size);
+  ASSERT_NE(bytes, nullptr);
+  // the pages are placed when they are first touched
+  memset(bytes, 1, size);
+
+  // MPOL_F_NODE | MPOL_F_ADDR from <numaif.h>: get the node of the page at the address
+  constexpr unsigned long kMpolFNodeAddr = 1 | 2;
+  for (size_t offset = 0; offset < size; offset += 4096) {
+    int node = -1;
+    ASSERT_EQ(syscall(SYS_get_mempolicy, &node, nullptr, 0, static_cast<char*>(bytes) + offset, kMpolFNodeAddr), 0);
+    EXPECT_EQ(node, last_node);
+  }
+  numa_allocator.Free(bytes);
+}
+#endif
+
+TEST(AllocatorTest, HugePageCPUAllocatorTest) {
+  // if the platform can't allocate huge pages the default allocation is used
+  HugePageCPUAllocator huge_page_allocator;
+  BFCArena arena(std::unique_ptr<IDeviceAllocator>(new HugePageCPUAllocator()), 1 << 30);
+
+  // not a multiple of the huge page size
+  const size_t size = 3 * 1024 * 1024 + 100;
+  void* bytes = huge_page_allocator.Alloc(size);
+  ASSERT_NE(bytes, nullptr);
+  memset(bytes, 1, size);
+  huge_page_allocator.Free(bytes);
+
+  void* reserved = arena.Reserve(size);
+  ASSERT_NE(reserved, nullptr);
+  memset(reserved, 1, size);
+  arena.Free(reserved);
+
+  void* chunk = arena.Alloc(1024);
+  ASSERT_NE(chunk, nullptr);
+  memset(chunk, 1, 1024);
+  arena.Free(chunk);
+  EXPECT_TRUE(arena.Shrink().IsOK());
+}
 }  // namespace test
 }  // namespace onnxruntime
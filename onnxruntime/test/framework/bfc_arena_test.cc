@@ -5,6 +5,7 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -274,5 +275,106 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, Shrink) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+
+  void* first_ptr = a.Alloc(1 << 20);
+  void* second_ptr = a.Alloc(1 << 22);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (1 << 22));
+
+  // nothing can be released while all regions are in use
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (1 << 22));
+
+  a.Free(second_ptr);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+  EXPECT_EQ(stats.bytes_in_use, 1 << 20);
+
+  // the arena extends again as needed
+  second_ptr = a.Alloc(1 << 21);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (1 << 21));
+
+  a.Free(first_ptr);
+  a.Free(second_ptr);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheReuse) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kNextPowerOfTwo, BFCArena::kDefaultThreadCacheMaxChunkSize);
+
+  // 1000 bytes is served from the 1024 byte size class
+  void* first_ptr = a.Alloc(1000);
+  EXPECT_EQ(a.AllocatedSize(first_ptr), 1024u);
+  a.Free(first_ptr);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, 1);
+  EXPECT_EQ(stats.thread_cache_bytes, 1024);
+  // cached chunks are still in use as far as the arena is concerned
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+
+  // any request in the same size class gets the cached chunk back
+  void* second_ptr = a.Alloc(1024);
+  EXPECT_EQ(first_ptr, second_ptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_hits, 1);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  a.Free(second_ptr);
+
+  // larger allocations bypass the cache
+  void* large_ptr = a.Alloc(BFCArena::kDefaultThreadCacheMaxChunkSize + 1);
+  a.Free(large_ptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_hits + stats.num_thread_cache_misses, 2);
+  EXPECT_EQ(stats.thread_cache_bytes, 1024);
+
+  a.FlushThreadCaches();
+  // the large allocation is rounded up to a multiple of 256 bytes
+  CheckStats(&a, 2, 0, 1024 + 65792, 65792);
+}
+
+TEST(BFCArenaTest, ThreadCacheCrossThreadFree) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kNextPowerOfTwo, BFCArena::kDefaultThreadCacheMaxChunkSize);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 1024; ++i) {
+    ptrs.push_back(a.Alloc(static_cast<size_t>(256 + i * 32)));
+  }
+
+  // free from other threads, which places the chunks in those threads' caches
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&a, &ptrs, t]() {
+      for (size_t i = t; i < ptrs.size(); i += 4) {
+        a.Free(ptrs[i]);
+      }
+      for (int i = 0; i < 100; ++i) {
+        a.Free(a.Alloc(static_cast<size_t>(512 + t)));
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  a.FlushThreadCaches();
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -132,7 +132,7 @@ TEST(CUDAFenceTests, DISABLED_PartOnCPU) {
   ASSERT_TRUE(1 == outputs.size());
   const Tensor& output = outputs[0].Get<Tensor>();
   //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&output.Shape()), *reinterpret_cast<const std::vector<int64_t>*>(&shape));
+  EXPECT_EQ(output.Shape().GetDims(), shape.GetDims());
   EXPECT_EQ(output.DataType(), DataTypeImpl::GetType<float>());
 
   float expected_output[4] = {13.0f, -18.0f, -27.0f, 40.0f};
@@ -186,7 +186,7 @@ TEST(CUDAFenceTests, TileWithInitializer) {
   ASSERT_TRUE(1 == outputs.size());
   const Tensor& output = outputs[0].Get<Tensor>();
   //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&output.Shape()), (std::vector<int64_t>{2, 4}));
+  EXPECT_EQ(output.Shape().GetDims(), (std::vector<int64_t>{2, 4}));
   EXPECT_EQ(output.DataType(), DataTypeImpl::GetType<float>());
 
   float expected_output[8] = {-1, 2, -1, 2, 3, -4, 3, -4};
@@ -252,7 +252,7 @@ TEST(CUDAFenceTests, TileWithComputedInput) {
   ASSERT_TRUE(1 == outputs.size());
   const Tensor& output = outputs[0].Get<Tensor>();
   //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&output.Shape()), (std::vector<int64_t>{4, 4}));
+  EXPECT_EQ(output.Shape().GetDims(), (std::vector<int64_t>{4, 4}));
   EXPECT_EQ(output.DataType(), DataTypeImpl::GetType<float>());
 
   float expected_output[16] = {7, -10, 7, -10, -15, 22, -15, 22, 7, -10, 7, -10, -15, 22, -15, 22};
@@ -4,6 +4,7 @@
 #include "core/session/inference_session.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <functional>
 #include <iterator>
@@ -24,8 +25,10 @@
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/platform/env.h"
+#include "core/profile/hardware_counters.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #ifdef USE_CUDA
@@ -93,11 +96,11 @@ KernelRegistryAndStatus GetFusedKernelRegistry() {
 
 class FuseExecutionProvider : public IExecutionProvider {
  public:
-  explicit FuseExecutionProvider() : IExecutionProvider{kFuseExecutionProvider} {
+  explicit FuseExecutionProvider(OrtDevice device = OrtDevice()) : IExecutionProvider{kFuseExecutionProvider} {
     DeviceAllocatorRegistrationInfo device_info(
         {OrtMemTypeDefault,
-         [](int) {
-           return onnxruntime::make_unique<CPUAllocator>(OrtMemoryInfo("Fuse", OrtAllocatorType::OrtDeviceAllocator));
+         [device](int) {
+           return onnxruntime::make_unique<CPUAllocator>(OrtMemoryInfo("Fuse", OrtAllocatorType::OrtDeviceAllocator, device));
          },
          std::numeric_limits<size_t>::max()});
     InsertAllocator(device_info.factory(0));
@@ -132,6 +135,51 @@ class FuseExecutionProvider : public IExecutionProvider {
   }
 };
 
+// Copies between CPU memory and the CPU memory reported as device memory by GraphCaptureExecutionProvider.
+class FakeDeviceDataTransfer : public IDataTransfer {
+ public:
+  bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override {
+    return src_device.Type() == OrtDevice::GPU || dst_device.Type() == OrtDevice::GPU;
+  }
+
+  Status CopyTensor(const Tensor& src, Tensor& dst, int /*exec_queue_id*/) const override {
+    memcpy(dst.MutableDataRaw(), src.DataRaw(), src.SizeInBytes());
+    return Status::OK();
+  }
+};
+
+// FuseExecutionProvider that pretends to capture the run into a graph. Its allocator reports a non-CPU device so
+// that runs with feeds and fetches allocated by it can be replayed.
+class GraphCaptureExecutionProvider : public FuseExecutionProvider {
+ public:
+  GraphCaptureExecutionProvider() : FuseExecutionProvider(OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0)) {}
+
+  std::unique_ptr<IDataTransfer> GetDataTransfer() const override {
+    return onnxruntime::make_unique<FakeDeviceDataTransfer>();
+  }
+
+  bool IsGraphCaptureEnabled() const override { return true; }
+
+  bool PrepareGraphReplay(uint64_t run_signature) override {
+    run_signature_ = run_signature;
+    return run_signature != 0 && run_signature == captured_signature_;
+  }
+
+  Status ReplayGraph() override {
+    ++num_replays_;
+    return Status::OK();
+  }
+
+  Status OnRunEnd() override {
+    captured_signature_ = run_signature_;
+    return Status::OK();
+  }
+
+  uint64_t run_signature_ = 0;
+  uint64_t captured_signature_ = 0;
+  int num_replays_ = 0;
+};
+
 // InferenceSession wrapper to expose loaded graph.
 class InferenceSessionGetGraphWrapper : public InferenceSession {
  public:
@@ -193,7 +241,7 @@ void VerifyOutputs(const Tensor& tensor, const std::vector<int64_t>& expected_di
                    const std::vector<T>& expected_values) {
   TensorShape expected_shape(expected_dims);
   //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&expected_shape), *reinterpret_cast<const std::vector<int64_t>*>(&tensor.Shape()));
+  ASSERT_EQ(expected_shape.GetDims(), tensor.Shape().GetDims());
   const std::vector<T> found(tensor.template Data<T>(),
                              tensor.template Data<T>() + expected_values.size());
   ASSERT_EQ(expected_values, found);
@@ -386,6 +434,69 @@ TEST(InferenceSessionTests, OnlyExecutePathToFetches) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, PruneToRequestedFetches) {
+  // Two independent outputs: A = X + X, and R = Reshape(X, S), which fails if S doesn't match the size of X.
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  ONNX_NAMESPACE::TypeProto shape_tensor;
+  shape_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  shape_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto& input_arg_x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& input_arg_s = graph.GetOrCreateNodeArg("S", &shape_tensor);
+  auto& output_arg_a = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& output_arg_r = graph.GetOrCreateNodeArg("R", nullptr);
+  graph.AddNode("node_1", "Add", "node 1.", {&input_arg_x, &input_arg_x}, {&output_arg_a});
+  graph.AddNode("node_2", "Reshape", "node 2.", {&input_arg_x, &input_arg_s}, {&output_arg_r});
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_file_name = "prune_to_requested_fetches_test_graph.onnx";
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue ml_value_x;
+  CreateMLValue<float>(allocator, {3, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value_x);
+  OrtValue ml_value_s;
+  CreateMLValue<int64_t>(allocator, {1}, {7}, &ml_value_s);
+  NameMLValMap feeds{{"X", ml_value_x}, {"S", ml_value_s}};
+
+  auto test_case = [&](ExecutionMode execution_mode, bool prune_to_requested_fetches) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.PruneToRequestedFetches";
+    so.execution_mode = execution_mode;
+    so.inter_op_param.thread_pool_size = 2;
+    so.prune_to_requested_fetches = prune_to_requested_fetches;
+    InferenceSession session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(model_file_name));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    RunOptions run_options;
+    std::vector<OrtValue> fetches;
+    auto status = session_object.Run(run_options, feeds, {"A"}, &fetches);
+    ASSERT_EQ(status.IsOK(), prune_to_requested_fetches) << status.ErrorMessage();
+    if (prune_to_requested_fetches) {
+      VerifyOutputs(fetches, {3, 2}, {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f});
+
+      // the nodes to execute are cached for the set of fetches
+      fetches.clear();
+      ASSERT_STATUS_OK(session_object.Run(run_options, feeds, {"A"}, &fetches));
+      VerifyOutputs(fetches, {3, 2}, {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f});
+    }
+
+    // requesting all the outputs executes the Reshape
+    fetches.clear();
+    ASSERT_FALSE(session_object.Run(run_options, feeds, {"A", "R"}, &fetches).IsOK());
+  };
+
+  test_case(ExecutionMode::ORT_SEQUENTIAL, true);
+  test_case(ExecutionMode::ORT_PARALLEL, true);
+  test_case(ExecutionMode::ORT_SEQUENTIAL, false);
+}
+
 TEST(InferenceSessionTests, DisableCPUArena) {
   SessionOptions so;
 
@@ -401,6 +512,23 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, ParallelExecutionWithUnifiedThreadPool) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.ParallelExecutionWithUnifiedThreadPool";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.use_unified_thread_pool = true;
+  so.intra_op_param.thread_pool_size = 2;
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "unified thread pool";
+  RunModel(session_object, run_options);
+}
+
 TEST(InferenceSessionTests, TestModelSerialization) {
   // Load model with level 0 transform level
   // and assert that the model has Identity nodes.
@@ -463,6 +591,386 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+TEST(InferenceSessionTests, TestSavedNodePlacements) {
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestSavedNodePlacements";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  so.optimized_model_filepath = ToWideString(test_model + "-with-node-placements");
+  so.save_node_placements = true;
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(test_model));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // The optimized model is used as is: the Identity nodes are not restored by a lower optimization level.
+  SessionOptions so_saved;
+  so_saved.session_logid = "InferenceSessionTests.TestSavedNodePlacements";
+  so_saved.graph_optimization_level = TransformerLevel::Default;
+  so_saved.use_saved_node_placements = true;
+  InferenceSessionGetGraphWrapper session_object_saved{so_saved, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object_saved.Load(so.optimized_model_filepath));
+  ASSERT_STATUS_OK(session_object_saved.Initialize());
+
+  const auto& graph = session_object_saved.GetGraph();
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Identity"], 0);
+  for (const auto& node : graph.Nodes()) {
+    EXPECT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+  }
+
+  // A model that was not saved with its node placements can't be used.
+  InferenceSession session_object_unsaved{so_saved, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object_unsaved.Load(test_model));
+  ASSERT_FALSE(session_object_unsaved.Initialize().IsOK());
+}
+
+// Saves a model computing Y = MatMul(X, W) for a 2 x 64 X and a constant 64 x 48 W scaled by w_scale, which the
+// CPU MatMul kernel packs when it is created.
+static void SaveConstantMatMulModel(const std::string& model_file_name, float w_scale,
+                                    const std::string& nchwc_block_size = "") {
+  constexpr int64_t K = 64;
+  constexpr int64_t N = 48;
+  onnxruntime::Model model("constant_matmul", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(K);
+  TypeProto w_type;
+  w_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  w_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(K);
+  w_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(N);
+
+  auto& input_arg_x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& input_arg_w = graph.GetOrCreateNodeArg("W", &w_type);
+  auto& output_arg_y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("matmul", "MatMul", "MatMul with a constant B", {&input_arg_x, &input_arg_w}, {&output_arg_y});
+
+  TensorProto w;
+  w.set_name("W");
+  w.add_dims(K);
+  w.add_dims(N);
+  w.set_data_type(TensorProto_DataType_FLOAT);
+  for (int64_t i = 0; i < K * N; i++) {
+    w.add_float_data(w_scale * static_cast<float>(i % 13 - 6));
+  }
+  graph.AddInitializedTensor(w);
+
+  if (!nchwc_block_size.empty()) {
+    model.SetMetaDataEntry("onnxruntime.nchwc_block_size", nchwc_block_size);
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+}
+
+static void RunConstantMatMulModel(InferenceSession& session_object, std::vector<float>& y) {
+  std::vector<float> x(2 * 64);
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 64}, x, &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches));
+  const auto& tensor = fetches[0].Get<Tensor>();
+  y.assign(tensor.Data<float>(), tensor.Data<float>() + tensor.Shape().Size());
+}
+
+TEST(InferenceSessionTests, TestSavedPrepackedWeights) {
+  const std::string model_file_name = "saved_prepacked_weights_test.onnx";
+  const std::string optimized_model_file_name = model_file_name + "-optimized";
+  const std::string prepacked_file_name = optimized_model_file_name + ".prepacked";
+  SaveConstantMatMulModel(model_file_name, 0.5f);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestSavedPrepackedWeights";
+  so.optimized_model_filepath = ToWideString(optimized_model_file_name);
+  so.save_prepacked_weights = true;
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  std::vector<float> expected_y;
+  RunConstantMatMulModel(session_object, expected_y);
+  ASSERT_TRUE(std::ifstream(prepacked_file_name).good());
+
+  SessionOptions so_saved;
+  so_saved.session_logid = "InferenceSessionTests.TestSavedPrepackedWeights";
+  so_saved.use_saved_prepacked_weights = true;
+  {
+    InferenceSession session_object_saved{so_saved, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object_saved.Load(optimized_model_file_name));
+    ASSERT_STATUS_OK(session_object_saved.Initialize());
+    std::vector<float> y;
+    RunConstantMatMulModel(session_object_saved, y);
+    ASSERT_EQ(y, expected_y);
+  }
+
+  std::string prepacked;
+  {
+    std::ifstream in(prepacked_file_name, ios::binary);
+    prepacked.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+
+  // The saved weights are used rather than packed again: zeroing the packed W, which ends the file, zeroes Y.
+  const size_t packed_w_size = MlasGemmPackBSize(48, 64);
+  if (packed_w_size != 0) {
+    std::string zeroed = prepacked;
+    ASSERT_GE(zeroed.size(), packed_w_size);
+    std::fill(zeroed.end() - static_cast<std::ptrdiff_t>(packed_w_size), zeroed.end(), '\0');
+    std::ofstream(prepacked_file_name, ios::binary | ios::trunc).write(zeroed.data(), zeroed.size());
+
+    InferenceSession session_object_zeroed{so_saved, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object_zeroed.Load(optimized_model_file_name));
+    ASSERT_STATUS_OK(session_object_zeroed.Initialize());
+    std::vector<float> y;
+    RunConstantMatMulModel(session_object_zeroed, y);
+    ASSERT_EQ(y, std::vector<float>(expected_y.size(), 0.0f));
+  }
+
+  // A truncated file fails Initialize.
+  std::ofstream(prepacked_file_name, ios::binary | ios::trunc).write(prepacked.data(), prepacked.size() - 1);
+  {
+    InferenceSession session_object_truncated{so_saved, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object_truncated.Load(optimized_model_file_name));
+    ASSERT_FALSE(session_object_truncated.Initialize().IsOK());
+  }
+
+  // A model saved again with other values under the same names, without the ID of the saved weights, doesn't use
+  // the weights saved with the previous one.
+  std::ofstream(prepacked_file_name, ios::binary | ios::trunc).write(prepacked.data(), prepacked.size());
+  SaveConstantMatMulModel(optimized_model_file_name, 0.25f);
+  {
+    InferenceSession session_object_stale{so_saved, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object_stale.Load(optimized_model_file_name));
+    auto status = session_object_stale.Initialize();
+    ASSERT_FALSE(status.IsOK());
+    ASSERT_NE(status.ErrorMessage().find("another model"), std::string::npos) << status.ErrorMessage();
+  }
+
+  std::remove(prepacked_file_name.c_str());
+}
+
+TEST(InferenceSessionTests, TestSavedPrepackedWeightsInSubgraphs) {
+  // the main graph has an 'If' node whose branches multiply the outer scope input by constant weights with the same
+  // name and different values
+  constexpr int64_t K = 64;
+  constexpr int64_t N = 48;
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(K);
+  TypeProto w_type;
+  w_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  w_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(K);
+  w_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(N);
+  TypeProto bool_tensor;
+  bool_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto create_branch = [&](float w_scale, GraphProto& branch) {
+    onnxruntime::Model model("branch", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+    graph.AddOuterScopeNodeArg("X");
+    auto& w = graph.GetOrCreateNodeArg("W", &w_type);
+    auto& y = graph.GetOrCreateNodeArg("branch_y", nullptr);
+    graph.AddNode("matmul", "MatMul", "MatMul with a constant B", {&x, &w}, {&y});
+    TensorProto w_initializer;
+    w_initializer.set_name("W");
+    w_initializer.add_dims(K);
+    w_initializer.add_dims(N);
+    w_initializer.set_data_type(TensorProto_DataType_FLOAT);
+    for (int64_t i = 0; i < K * N; i++) {
+      w_initializer.add_float_data(w_scale * static_cast<float>(i % 13 - 6));
+    }
+    graph.AddInitializedTensor(w_initializer);
+    ASSERT_STATUS_OK(graph.Resolve());
+    branch = graph.ToGraphProto();
+  };
+  GraphProto then_branch;
+  GraphProto else_branch;
+  create_branch(0.5f, then_branch);
+  create_branch(-0.25f, else_branch);
+
+  onnxruntime::Model model("saved_prepacked_weights_in_subgraphs", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  auto& cond = graph.GetOrCreateNodeArg("cond", &bool_tensor);
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& if_node = graph.AddNode("if", "If", "if node", {&cond}, {&y});
+  if_node.AddAttribute("then_branch", then_branch);
+  if_node.AddAttribute("else_branch", else_branch);
+  graph.SetInputs({&cond, &x});
+  graph.SetOutputs({&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+  const std::string model_file_name = "saved_prepacked_weights_in_subgraphs_test.onnx";
+  const std::string optimized_model_file_name = model_file_name + "-optimized";
+  const std::string prepacked_file_name = optimized_model_file_name + ".prepacked";
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+
+  auto run = [](InferenceSession& session_object, bool condition, std::vector<float>& y) {
+    OrtValue ml_cond;
+    CreateMLValue<bool>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1}, {condition}, &ml_cond);
+    std::vector<float> x(2 * 64);
+    for (size_t i = 0; i < x.size(); i++) {
+      x[i] = static_cast<float>(i % 7) - 3.0f;
+    }
+    OrtValue ml_x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 64}, x, &ml_x);
+    NameMLValMap feeds{{"cond", ml_cond}, {"X", ml_x}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches));
+    const auto& tensor = fetches[0].Get<Tensor>();
+    y.assign(tensor.Data<float>(), tensor.Data<float>() + tensor.Shape().Size());
+  };
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestSavedPrepackedWeightsInSubgraphs";
+  so.optimized_model_filepath = ToWideString(optimized_model_file_name);
+  so.save_prepacked_weights = true;
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  std::vector<float> expected_then_y;
+  std::vector<float> expected_else_y;
+  run(session_object, true, expected_then_y);
+  run(session_object, false, expected_else_y);
+  ASSERT_NE(expected_then_y, expected_else_y);
+
+  // each branch reads its own weight
+  SessionOptions so_saved;
+  so_saved.session_logid = "InferenceSessionTests.TestSavedPrepackedWeightsInSubgraphs";
+  so_saved.use_saved_prepacked_weights = true;
+  InferenceSession session_object_saved{so_saved, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object_saved.Load(optimized_model_file_name));
+  ASSERT_STATUS_OK(session_object_saved.Initialize());
+  std::vector<float> y_saved;
+  run(session_object_saved, true, y_saved);
+  ASSERT_EQ(y_saved, expected_then_y);
+  run(session_object_saved, false, y_saved);
+  ASSERT_EQ(y_saved, expected_else_y);
+
+  std::remove(prepacked_file_name.c_str());
+}
+
+TEST(InferenceSessionTests, TestNchwcBlockSizeMetadata) {
+  const std::string model_file_name = "nchwc_block_size_metadata_test.onnx";
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestNchwcBlockSizeMetadata";
+
+  // A model optimized for the NCHWc block size of this processor can be used.
+  SaveConstantMatMulModel(model_file_name, 1.0f, std::to_string(MlasNchwcGetBlockSize()));
+  {
+    InferenceSession session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(model_file_name));
+    ASSERT_STATUS_OK(session_object.Initialize());
+  }
+
+  // A model optimized for another NCHWc block size can't.
+  SaveConstantMatMulModel(model_file_name, 1.0f, std::to_string(MlasNchwcGetBlockSize() + 1));
+  {
+    InferenceSession session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(model_file_name));
+    auto status = session_object.Initialize();
+    ASSERT_FALSE(status.IsOK());
+    ASSERT_NE(status.ErrorMessage().find("NCHWc block size"), std::string::npos) << status.ErrorMessage();
+  }
+}
+
+TEST(InferenceSessionTests, GraphPartitioningOverrides) {
+  const std::string override_file = "graph_partitioning_overrides.txt";
+  auto test_case = [&override_file](const std::string& overrides, bool expect_success) {
+    {
+      std::ofstream out(override_file);
+      out << "# node name, execution provider type\n"
+          << overrides << "\n";
+    }
+
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.GraphPartitioningOverrides";
+    so.graph_partitioning_mode = GraphPartitioningMode::CostBased;
+    so.graph_partitioning_override_file = ToWideString(override_file);
+    InferenceSessionGetGraphWrapper session_object{so, GetEnvironment()};
+#ifdef USE_CUDA
+    ASSERT_STATUS_OK(session_object.RegisterExecutionProvider(DefaultCudaExecutionProvider()));
+#endif
+    ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+    auto status = session_object.Initialize();
+    ASSERT_EQ(status.IsOK(), expect_success) << status.ErrorMessage();
+    if (expect_success) {
+      for (const auto& node : session_object.GetGraph().Nodes()) {
+        EXPECT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+      }
+      RunModel(session_object, RunOptions{});
+    }
+  };
+
+  test_case("mul_1 " + std::string(kCpuExecutionProvider), true);
+  // the placements of nodes that don't exist are ignored
+  test_case("no_such_node " + std::string(kCpuExecutionProvider), true);
+  // the provider must be registered
+  test_case("mul_1 NoSuchExecutionProvider", false);
+  // an entry must name the provider
+  test_case("mul_1", false);
+}
+
+#ifdef USE_CUDA
+TEST(InferenceSessionTests, ShapeComputationsPlacedOnHost) {
+  // R = Reshape(X, Identity(Shape(X))). The CUDA Shape kernel writes the shape in host memory, so the Identity runs on
+  // the CPU instead of copying the shape to the device and back for the Reshape.
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  ONNX_NAMESPACE::TypeProto shape_tensor;
+  shape_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  shape_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input_arg_x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& shape_arg = graph.GetOrCreateNodeArg("S", &shape_tensor);
+  auto& identity_arg = graph.GetOrCreateNodeArg("I", &shape_tensor);
+  auto& output_arg_r = graph.GetOrCreateNodeArg("R", &float_tensor);
+  graph.AddNode("shape_1", "Shape", "node 1.", {&input_arg_x}, {&shape_arg});
+  graph.AddNode("identity_1", "Identity", "node 2.", {&shape_arg}, {&identity_arg});
+  graph.AddNode("reshape_1", "Reshape", "node 3.", {&input_arg_x, &identity_arg}, {&output_arg_r});
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_file_name = "shape_computations_placed_on_host_test_graph.onnx";
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ShapeComputationsPlacedOnHost";
+  // keep the Shape and Identity nodes from being folded or eliminated
+  so.graph_optimization_level = TransformerLevel::Default;
+  InferenceSessionGetGraphWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.RegisterExecutionProvider(DefaultCudaExecutionProvider()));
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  for (const auto& node : session_object.GetGraph().Nodes()) {
+    if (node.Name() == "identity_1") {
+      EXPECT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+    } else if (node.Name() == "shape_1" || node.Name() == "reshape_1") {
+      EXPECT_EQ(node.GetExecutionProviderType(), kCudaExecutionProvider);
+    }
+  }
+  std::map<std::string, int> op_to_count = CountOpsInGraph(session_object.GetGraph());
+  EXPECT_EQ(op_to_count["MemcpyFromHost"], 0);
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue ml_value_x;
+  CreateMLValue<float>(allocator, {3, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, {"R"}, &fetches));
+  VerifyOutputs(fetches, {3, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+}
+#endif
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -629,6 +1137,128 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
   }
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerWithMemoryProfiling) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithMemoryProfiling";
+  so.enable_profiling = true;
+  so.enable_memory_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_memory_test");
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile_stream(profile_file);
+  ASSERT_TRUE(profile_stream);
+  const std::string profile{std::istreambuf_iterator<char>(profile_stream), std::istreambuf_iterator<char>()};
+
+  // the lifetime of the graph output, the memory in use over time and the live tensors at the peak
+  EXPECT_NE(profile.find(R"("cat" : "Memory")"), std::string::npos) << profile;
+  EXPECT_NE(profile.find(R"("ph" : "X","name" :"Y")"), std::string::npos) << profile;
+  EXPECT_NE(profile.find(R"("ph" : "C")"), std::string::npos) << profile;
+  EXPECT_NE(profile.find(R"("name" :"memory_peak")"), std::string::npos) << profile;
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerWithHardwareCounters) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithHardwareCounters";
+  so.enable_profiling = true;
+  so.enable_hardware_counters = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_hardware_counters_test");
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+  const bool has_counters = profile::HardwareCounters::ForCurrentThread() != nullptr;
+
+  std::ifstream profile_stream(profile_file);
+  ASSERT_TRUE(profile_stream);
+  const std::string profile{std::istreambuf_iterator<char>(profile_stream), std::istreambuf_iterator<char>()};
+
+  // the kernel events are written either way, with the counters where the machine lets us read them
+  EXPECT_NE(profile.find("_kernel_time"), std::string::npos) << profile;
+  EXPECT_EQ(profile.find(R"("ipc" : )") != std::string::npos, has_counters) << profile;
+}
+
+TEST(InferenceSessionTests, CheckNodeStats) {
+  SessionOptions so;
+
+  so.session_logid = "CheckNodeStats";
+  so.enable_node_stats = true;
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::string node_stats;
+  ASSERT_STATUS_OK(session_object.GetNodeStatsJson(node_stats));
+  EXPECT_EQ(node_stats, "[]");
+
+  RunOptions run_options;
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  // the statistics are aggregated, not recorded per run
+  ASSERT_STATUS_OK(session_object.GetNodeStatsJson(node_stats));
+  EXPECT_NE(node_stats.find("\"op_type\":\"Mul\""), std::string::npos) << node_stats;
+  EXPECT_NE(node_stats.find("\"count\":3"), std::string::npos) << node_stats;
+  // the output is a float tensor of shape {3, 2}
+  EXPECT_NE(node_stats.find("\"output_bytes\":72"), std::string::npos) << node_stats;
+}
+
+TEST(InferenceSessionTests, CheckNodeStatsDisabled) {
+  SessionOptions so;
+  so.session_logid = "CheckNodeStatsDisabled";
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::string node_stats;
+  EXPECT_FALSE(session_object.GetNodeStatsJson(node_stats).IsOK());
+}
+
+TEST(InferenceSessionTests, CheckMetrics) {
+  SessionOptions so;
+
+  so.session_logid = "CheckMetrics";
+  so.enable_node_stats = true;
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  std::string metrics;
+  ASSERT_STATUS_OK(session_object.GetMetrics(InferenceSession::MetricsFormat::Json, metrics));
+  EXPECT_NE(metrics.find("\"run_latency\":{\"count\":3"), std::string::npos) << metrics;
+  EXPECT_NE(metrics.find("\"p99_us\""), std::string::npos) << metrics;
+  EXPECT_NE(metrics.find("\"CPUExecutionProvider\""), std::string::npos) << metrics;
+  EXPECT_NE(metrics.find("\"page_faults\""), std::string::npos) << metrics;
+
+  ASSERT_STATUS_OK(session_object.GetMetrics(InferenceSession::MetricsFormat::Prometheus, metrics));
+  EXPECT_NE(metrics.find("# TYPE onnxruntime_session_run_latency_us summary\n"), std::string::npos) << metrics;
+  EXPECT_NE(metrics.find("onnxruntime_session_run_latency_us_count 3\n"), std::string::npos) << metrics;
+  EXPECT_NE(metrics.find("onnxruntime_session_provider_kernel_us{provider=\"CPUExecutionProvider\"}"),
+            std::string::npos)
+      << metrics;
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   SessionOptions so;
 
@@ -961,6 +1591,79 @@ TEST(InferenceSessionTests, TestBindCudaSpecifyOutputDeviceOnCuda) {
                  &device /* specify output device */);
 }
 
+TEST(InferenceSessionTests, TestCudaExternalAllocator) {
+  std::atomic<int> alloc_count{0};
+  std::atomic<int> free_count{0};
+  {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.TestCudaExternalAllocator";
+    InferenceSession session_object{so, GetEnvironment()};
+
+    CUDAExecutionProviderInfo epi;
+    epi.external_allocator_info.alloc = [&alloc_count](size_t size, cudaStream_t) {
+      void* p = nullptr;
+      if (cudaMalloc(&p, size) != cudaSuccess) {
+        return static_cast<void*>(nullptr);
+      }
+      ++alloc_count;
+      return p;
+    };
+    epi.external_allocator_info.free = [&free_count](void* p) {
+      cudaFree(p);
+      ++free_count;
+    };
+    ASSERT_STATUS_OK(session_object.RegisterExecutionProvider(onnxruntime::make_unique<CUDAExecutionProvider>(epi)));
+
+    std::unique_ptr<Model> p_model;
+    CreateMatMulModel(p_model, kCudaExecutionProvider);
+    std::string s1;
+    p_model->ToProto().SerializeToString(&s1);
+    std::stringstream sstr(s1);
+    ASSERT_STATUS_OK(session_object.Load(sstr));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    RunOptions run_options;
+    run_options.run_tag = so.session_logid;
+    RunModelWithBindingMatMul(session_object, run_options, kCudaExecutionProvider, false, kCpuExecutionProvider,
+                              nullptr);
+    EXPECT_GT(alloc_count, 0);
+  }
+  // no arena holds on to the memory
+  EXPECT_EQ(free_count, alloc_count);
+}
+
+TEST(InferenceSessionTests, TestCudaWorkspace) {
+  CUDAExecutionProviderInfo epi;
+  epi.workspace_max_bytes = 4096;
+  CUDAExecutionProvider provider(epi);
+
+  EXPECT_EQ(provider.GetWorkspace(0), nullptr);
+
+  // the buffer is reused while the requests fit
+  void* workspace = provider.GetWorkspace(1024).get();
+  ASSERT_NE(workspace, nullptr);
+  EXPECT_EQ(provider.GetWorkspace(512).get(), workspace);
+  auto stats = provider.GetWorkspaceStats();
+  EXPECT_EQ(stats.peak_bytes, 1024u);
+  EXPECT_EQ(stats.reserved_bytes, 1024u);
+  EXPECT_EQ(stats.num_grows, 1u);
+
+  // grows by at least half, up to the limit
+  ASSERT_NE(provider.GetWorkspace(1100), nullptr);
+  ASSERT_NE(provider.GetWorkspace(4000), nullptr);
+  stats = provider.GetWorkspaceStats();
+  EXPECT_EQ(stats.reserved_bytes, 4096u);
+  EXPECT_EQ(stats.num_grows, 3u);
+
+  // larger workspaces come from the arena
+  auto large_workspace = provider.GetWorkspace(8192);
+  ASSERT_NE(large_workspace, nullptr);
+  stats = provider.GetWorkspaceStats();
+  EXPECT_EQ(stats.peak_bytes, 8192u);
+  EXPECT_EQ(stats.reserved_bytes, 4096u);
+  EXPECT_EQ(stats.num_fallbacks, 1u);
+}
+
 #endif
 
 TEST(InferenceSessionTests, ModelWithoutOpset) {
@@ -1174,6 +1877,87 @@ TEST(ExecutionProviderTest, FunctionTest) {
   VerifyOutputs(fetches, expected_dims_mul_m, expected_values_mul_m);
 }
 
+TEST(ExecutionProviderTest, GraphCaptureTest) {
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input_arg_1 = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& input_arg_2 = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& input_arg_3 = graph.GetOrCreateNodeArg("Z", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("node_1_out_1", &float_tensor);
+  auto& output_arg_2 = graph.GetOrCreateNodeArg("M", &float_tensor);
+  graph.AddNode("node_1", "Add", "node 1.", {&input_arg_1, &input_arg_2}, {&output_arg});
+  graph.AddNode("node_2", "Add", "node 2.", {&output_arg, &input_arg_3}, {&output_arg_2});
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_file_name = "execution_provider_graph_capture_test_graph.onnx";
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+
+  SessionOptions so;
+  so.session_logid = "ExecutionProviderTest.GraphCaptureTest";
+  InferenceSession session_object{so, GetEnvironment()};
+  auto provider = onnxruntime::make_unique<GraphCaptureExecutionProvider>();
+  auto* graph_capture_provider = provider.get();
+  ASSERT_STATUS_OK(session_object.RegisterExecutionProvider(std::move(provider)));
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto allocator = graph_capture_provider->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value_x;
+  CreateMLValue<float>(allocator, dims_mul_x, values_mul_x, &ml_value_x);
+  OrtValue ml_value_y;
+  CreateMLValue<float>(allocator, dims_mul_x, values_mul_x, &ml_value_y);
+  OrtValue ml_value_z;
+  CreateMLValue<float>(allocator, dims_mul_x, values_mul_x, &ml_value_z);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value_x));
+  feeds.insert(std::make_pair("Y", ml_value_y));
+  feeds.insert(std::make_pair("Z", ml_value_z));
+
+  std::vector<std::string> output_names;
+  output_names.push_back("M");
+  std::vector<int64_t> expected_dims_mul_m = {3, 2};
+  std::vector<float> expected_values_mul_m = {3.0f, 6.0f, 9.0f, 12.0f, 15.0f, 18.0f};
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+
+  // outputs allocated by the session can't be replayed
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, expected_dims_mul_m, expected_values_mul_m);
+  ASSERT_EQ(graph_capture_provider->run_signature_, 0u);
+
+  // the first run with pre-allocated outputs executes the kernels, the next one replays them
+  OrtValue ml_value_m;
+  CreateMLValue<float>(allocator, dims_mul_x, std::vector<float>(6), &ml_value_m);
+  std::vector<OrtValue> preallocated_fetches{ml_value_m};
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &preallocated_fetches));
+  VerifyOutputs(preallocated_fetches, expected_dims_mul_m, expected_values_mul_m);
+  const uint64_t run_signature = graph_capture_provider->run_signature_;
+  ASSERT_NE(run_signature, 0u);
+  ASSERT_EQ(graph_capture_provider->num_replays_, 0);
+
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &preallocated_fetches));
+  ASSERT_EQ(graph_capture_provider->run_signature_, run_signature);
+  ASSERT_EQ(graph_capture_provider->num_replays_, 1);
+
+  // a different output buffer changes the signature, so the kernels are executed again
+  OrtValue ml_value_m_2;
+  CreateMLValue<float>(allocator, dims_mul_x, std::vector<float>(6), &ml_value_m_2);
+  std::vector<OrtValue> preallocated_fetches_2{ml_value_m_2};
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &preallocated_fetches_2));
+  VerifyOutputs(preallocated_fetches_2, expected_dims_mul_m, expected_values_mul_m);
+  ASSERT_NE(graph_capture_provider->run_signature_, run_signature);
+  ASSERT_EQ(graph_capture_provider->num_replays_, 1);
+}
+
 TEST(InferenceSessionTests, Test3LayerNestedSubgraph) {
   // The main graph contains a 'If' node: 'graph_0__if_0'
   // Inside the then-branch of 'graph_0__if_0', there is a nested 'If' node: 'graph_0__if_0__else__if_0'
@@ -1736,7 +2520,7 @@ TEST(InferenceSessionTests, TestTruncatedSequence) {
   auto& rtensor = fetches.front().Get<Tensor>();
   TensorShape expected_shape(Y_dims);
   //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&expected_shape), *reinterpret_cast<const std::vector<int64_t>*>(&rtensor.Shape()));
+  ASSERT_EQ(expected_shape.GetDims(), rtensor.Shape().GetDims());
   for (size_t i = 0; i < Y_data.size(); ++i)
     EXPECT_NEAR(Y_data[i], rtensor.template Data<float>()[i], FLT_EPSILON);
 
@@ -1779,7 +2563,7 @@ TEST(InferenceSessionTests, TestTruncatedSequence) {
     truncated_output_dims[0] = truncated_len;
     TensorShape truncated_shape(truncated_output_dims);
     //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-    ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&truncated_shape), *reinterpret_cast<const std::vector<int64_t>*>(&truncated_rtensor.Shape()));
+    ASSERT_EQ(truncated_shape.GetDims(), truncated_rtensor.Shape().GetDims());
     auto seq_output_stride = truncated_shape.SizeFromDimension(1);
     for (int i = 0; i < truncated_shape.Size(); ++i)
       EXPECT_NEAR(Y_data[i + seq_start * seq_output_stride], truncated_rtensor.template Data<float>()[i], FLT_EPSILON);
@@ -2218,6 +3002,108 @@ TEST(InferenceSessionTests, LoadModelWithEnvVarSetToUnsupportedVal) {
 #endif
 }
 
+// InferenceSession wrapper to expose the number of specialized graphs.
+class InferenceSessionSpecializationWrapper : public InferenceSession {
+ public:
+  InferenceSessionSpecializationWrapper(const SessionOptions& session_options, const Environment& env)
+      : InferenceSession(session_options, env) {
+  }
+
+  size_t GetSpecializedGraphCount() const { return InferenceSession::GetSpecializedGraphCount(); }
+};
+
+TEST(InferenceSessionTests, ShapeSpecialization) {
+  SessionOptions so;
+  so.session_logid = "ShapeSpecialization";
+  so.shape_specialization_cache_size = 2;
+
+  InferenceSessionSpecializationWrapper session_object{so, GetEnvironment()};
+  // x has the free dimensions Dim1 and Dim2
+  ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/abs_free_dimensions.onnx")));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto run = [&session_object](int64_t dim1) {
+    std::vector<int64_t> dims{dim1, 2, 5};
+    std::vector<float> values(static_cast<size_t>(dim1 * 10), -1.f);
+    OrtValue x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims, values, &x);
+
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, {"x"}, {x}, {"y"}, &fetches));
+    VerifyOutputs(fetches, dims, std::vector<float>(values.size(), 1.f));
+  };
+
+  run(1);
+  run(2);
+  run(1);
+  EXPECT_EQ(session_object.GetSpecializedGraphCount(), 2u);
+
+  // the least recently used graph, for dim1 = 2, is evicted
+  run(3);
+  EXPECT_EQ(session_object.GetSpecializedGraphCount(), 2u);
+  run(2);
+  EXPECT_EQ(session_object.GetSpecializedGraphCount(), 2u);
+}
+
+// The outputs of Split and of a Gather of consecutive rows are contiguous ranges of their input, so they are created
+// as views of it. The input must stay alive until the consumers of the views have run.
+TEST(InferenceSessionTests, ContiguousOutputsAsViews) {
+  std::unordered_map<std::string, int> domain_to_version{{onnxruntime::kOnnxDomain, 11}};
+  Model model("test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+              {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto tensor_int64;
+  tensor_int64.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+
+  ONNX_NAMESPACE::TensorProto indices;
+  indices.set_name("indices");
+  indices.set_data_type(TensorProto_DataType_INT64);
+  indices.add_dims(2);
+  indices.add_int64_data(1);
+  indices.add_int64_data(2);
+  graph.AddInitializedTensor(indices);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& a = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& s0 = graph.GetOrCreateNodeArg("S0", &tensor_float);
+  auto& s1 = graph.GetOrCreateNodeArg("S1", &tensor_float);
+  auto& g = graph.GetOrCreateNodeArg("G", &tensor_float);
+  graph.AddNode("relu", "Relu", "", {&x}, {&a});
+  graph.AddNode("split", "Split", "", {&a}, {&s0, &s1}).AddAttribute("axis", int64_t{0});
+  graph.AddNode("gather", "Gather", "", {&a, &graph.GetOrCreateNodeArg("indices", &tensor_int64)}, {&g});
+  graph.AddNode("neg0", "Neg", "", {&s0}, {&graph.GetOrCreateNodeArg("Y0", &tensor_float)});
+  graph.AddNode("neg1", "Neg", "", {&s1}, {&graph.GetOrCreateNodeArg("Y1", &tensor_float)});
+  graph.AddNode("neg2", "Neg", "", {&g}, {&graph.GetOrCreateNodeArg("Y2", &tensor_float)});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string serialized_model;
+  model.ToProto().SerializeToString(&serialized_model);
+  std::stringstream model_stream(serialized_model);
+
+  SessionOptions so;
+  so.session_logid = "ContiguousOutputsAsViews";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<float> values{-1.f, 2.f, 3.f, 4.f, -5.f, 6.f, 7.f, 8.f, -9.f, 10.f, 11.f, 12.f};
+  OrtValue input;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {4, 3}, values, &input);
+
+  // the second run uses the memory pattern traced by the first one
+  for (int run = 0; run < 2; ++run) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, {"X"}, {input}, {"Y0", "Y1", "Y2"}, &fetches));
+    ASSERT_EQ(fetches.size(), 3u);
+    VerifyOutputs(fetches[0].Get<Tensor>(), {2, 3}, {-0.f, -2.f, -3.f, -4.f, -0.f, -6.f});
+    VerifyOutputs(fetches[1].Get<Tensor>(), {2, 3}, {-7.f, -8.f, -0.f, -10.f, -11.f, -12.f});
+    VerifyOutputs(fetches[2].Get<Tensor>(), {2, 3}, {-4.f, -0.f, -6.f, -7.f, -8.f, -0.f});
+  }
+}
+
 // Global threadpool related tests
 // We test for 4 combinations
 class InferenceSessionTestGlobalThreadPools : public InferenceSession {
@@ -2387,5 +3273,80 @@ TEST(InferenceSessionTests, InvalidSessionEnvCombination) {
   }
 }
 
+TEST(InferenceSessionTests, LazyInitialization) {
+  // the main graph has an 'If' node whose branches add and subtract the outer scope input from itself
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  ONNX_NAMESPACE::TypeProto bool_tensor;
+  bool_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_BOOL);
+  bool_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto create_branch = [&float_tensor](const std::string& op_type, ONNX_NAMESPACE::GraphProto& branch) {
+    onnxruntime::Model model("branch_" + op_type, false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    auto& x = graph.GetOrCreateNodeArg("x", &float_tensor);
+    graph.AddOuterScopeNodeArg("x");
+    auto& y = graph.GetOrCreateNodeArg("branch_y", &float_tensor);
+    graph.AddNode("branch_" + op_type, op_type, "branch node", {&x, &x}, {&y});
+    ASSERT_STATUS_OK(graph.Resolve());
+    branch = graph.ToGraphProto();
+  };
+  ONNX_NAMESPACE::GraphProto then_branch;
+  ONNX_NAMESPACE::GraphProto else_branch;
+  create_branch("Add", then_branch);
+  create_branch("Sub", else_branch);
+
+  onnxruntime::Model model("lazy_initialization", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  auto& cond = graph.GetOrCreateNodeArg("cond", &bool_tensor);
+  auto& x = graph.GetOrCreateNodeArg("x", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("y", &float_tensor);
+  auto& if_node = graph.AddNode("if", "If", "if node", {&cond}, {&y});
+  if_node.AddAttribute("then_branch", then_branch);
+  if_node.AddAttribute("else_branch", else_branch);
+  const auto if_node_index = if_node.Index();
+  graph.SetInputs({&cond, &x});
+  graph.SetOutputs({&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_file_name = "lazy-initialization-test.onnx";
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.LazyInitialization";
+  so.enable_lazy_initialization = true;
+  InferenceSessionTestGlobalThreadPools session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // the branches are finalized when first run, which creates their execution plans
+  const auto& session_state = session_object.GetSessionState();
+  const auto* then_session_state = session_state.GetSubgraphSessionState(if_node_index, "then_branch");
+  const auto* else_session_state = session_state.GetSubgraphSessionState(if_node_index, "else_branch");
+  ASSERT_NE(then_session_state, nullptr);
+  ASSERT_NE(else_session_state, nullptr);
+  EXPECT_EQ(then_session_state->GetExecutionPlan(), nullptr);
+  EXPECT_EQ(else_session_state->GetExecutionPlan(), nullptr);
+
+  auto run = [&session_object](bool condition, float expected) {
+    OrtValue ml_cond;
+    CreateMLValue<bool>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1}, {condition}, &ml_cond);
+    OrtValue ml_x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1}, {3.f}, &ml_x);
+    NameMLValMap feeds{{"cond", ml_cond}, {"x", ml_x}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, {"y"}, &fetches));
+    VerifyOutputs(fetches, {1}, {expected});
+  };
+
+  run(true, 6.f);
+  EXPECT_NE(then_session_state->GetExecutionPlan(), nullptr);
+  EXPECT_EQ(else_session_state->GetExecutionPlan(), nullptr);
+
+  run(false, 0.f);
+  run(true, 6.f);
+  EXPECT_NE(else_session_state->GetExecutionPlan(), nullptr);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_cache.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static BufferUniquePtr MakePackedBuffer(const void* data, size_t size) {
+  const AllocatorPtr& alloc = PrepackedWeightsCache::Instance().Allocator();
+  void* buffer = alloc->Alloc(size);
+  memcpy(buffer, data, size);
+  return BufferUniquePtr(buffer, BufferDeleter(alloc));
+}
+
+TEST(PrepackedWeightsCacheTest, ShareIdenticalBuffers) {
+  PrepackedWeightsCache& cache = PrepackedWeightsCache::Instance();
+  const size_t initial_count = cache.NumSharedBuffers();
+
+  const float packed[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+  const float other_packed[] = {1.0f, 2.0f, 3.0f, 4.0f, 6.0f};
+
+  std::shared_ptr<void> first = cache.Share("test", MakePackedBuffer(packed, sizeof(packed)), sizeof(packed));
+  std::shared_ptr<void> second = cache.Share("test", MakePackedBuffer(packed, sizeof(packed)), sizeof(packed));
+  EXPECT_EQ(first.get(), second.get());
+
+  // Buffers that differ in their bytes or in their format are not shared.
+  std::shared_ptr<void> other_bytes =
+      cache.Share("test", MakePackedBuffer(other_packed, sizeof(other_packed)), sizeof(other_packed));
+  std::shared_ptr<void> other_format =
+      cache.Share("other", MakePackedBuffer(packed, sizeof(packed)), sizeof(packed));
+  EXPECT_NE(first.get(), other_bytes.get());
+  EXPECT_NE(first.get(), other_format.get());
+  EXPECT_EQ(memcmp(other_format.get(), packed, sizeof(packed)), 0);
+  EXPECT_EQ(cache.NumSharedBuffers(), initial_count + 3);
+
+  // The cache drops a buffer once it is no longer in use.
+  first.reset();
+  EXPECT_EQ(cache.NumSharedBuffers(), initial_count + 3);
+  second.reset();
+  EXPECT_EQ(cache.NumSharedBuffers(), initial_count + 2);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
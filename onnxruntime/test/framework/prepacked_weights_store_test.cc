@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_store.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "core/mlas/inc/mlas.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::shared_ptr<void> MakePackedBuffer(const void* data, size_t size) {
+  std::shared_ptr<void> buffer(new char[size], [](void* p) { delete[] static_cast<char*>(p); });
+  memcpy(buffer.get(), data, size);
+  return buffer;
+}
+
+static void WriteFile(const std::string& path, const std::string& contents) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(contents.data(), contents.size());
+}
+
+static std::string ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+TEST(PrepackedWeightsStoreTest, SaveAndLoad) {
+  const std::string store_path = "prepacked_weights_store_test.prepacked";
+
+  const float packed[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+  const float other_packed[] = {6.0f, 7.0f};
+
+  PrepackedWeightsStore recording_store;
+  EXPECT_FALSE(recording_store.IsLoaded());
+  recording_store.Record("format|W|N|0", MakePackedBuffer(packed, sizeof(packed)), sizeof(packed));
+  recording_store.Record("format|W|N|1", MakePackedBuffer(other_packed, sizeof(other_packed)), sizeof(other_packed));
+  // A weight used by several kernels is recorded once.
+  recording_store.Record("format|W|N|0", MakePackedBuffer(packed, sizeof(packed)), sizeof(packed));
+  ASSERT_TRUE(recording_store.Save(ToPathString(store_path)).IsOK());
+
+  // Each recording store gets its own model ID.
+  EXPECT_FALSE(recording_store.ModelId().empty());
+  EXPECT_NE(recording_store.ModelId(), PrepackedWeightsStore().ModelId());
+
+  std::unique_ptr<PrepackedWeightsStore> store;
+  ASSERT_TRUE(PrepackedWeightsStore::Load(ToPathString(store_path), recording_store.ModelId(), store).IsOK());
+  ASSERT_NE(store, nullptr);
+  EXPECT_TRUE(store->IsLoaded());
+  EXPECT_EQ(store->ModelId(), recording_store.ModelId());
+
+  // The weights are used in place, aligned as the buffers of the packing routines.
+  auto read = store->Get("format|W|N|0", sizeof(packed));
+  ASSERT_NE(read, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(read.get()) % MlasGetPreferredBufferAlignment(), 0u);
+  EXPECT_EQ(memcmp(read.get(), packed, sizeof(packed)), 0);
+  auto other_read = store->Get("format|W|N|1", sizeof(other_packed));
+  ASSERT_NE(other_read, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(other_read.get()) % MlasGetPreferredBufferAlignment(), 0u);
+  EXPECT_EQ(memcmp(other_read.get(), other_packed, sizeof(other_packed)), 0);
+
+  // Weights that weren't saved, or were saved with another size, are packed by the kernels.
+  EXPECT_EQ(store->Get("format|W|T|0", sizeof(packed)), nullptr);
+  EXPECT_EQ(store->Get("format|W|N|0", sizeof(float)), nullptr);
+
+  // The weights outlive the store.
+  store.reset();
+  EXPECT_EQ(memcmp(read.get(), packed, sizeof(packed)), 0);
+
+  read.reset();
+  other_read.reset();
+  std::remove(store_path.c_str());
+}
+
+TEST(PrepackedWeightsStoreTest, RejectInvalidFiles) {
+  const std::string store_path = "prepacked_weights_store_invalid_test.prepacked";
+  const std::string invalid_path = store_path + ".invalid";
+
+  const float packed[] = {1.0f, 2.0f, 3.0f, 4.0f};
+  PrepackedWeightsStore recording_store;
+  recording_store.Record("format|W|N|0", MakePackedBuffer(packed, sizeof(packed)), sizeof(packed));
+  ASSERT_TRUE(recording_store.Save(ToPathString(store_path)).IsOK());
+  const std::string contents = ReadFile(store_path);
+
+  auto load = [&](const std::string& path, const std::string& model_id) {
+    std::unique_ptr<PrepackedWeightsStore> store;
+    auto status = PrepackedWeightsStore::Load(ToPathString(path), model_id, store);
+    EXPECT_EQ(store, nullptr);
+    return status;
+  };
+  const std::string& model_id = recording_store.ModelId();
+
+  // missing and empty files
+  EXPECT_FALSE(load("prepacked_weights_store_missing_test.prepacked", model_id).IsOK());
+  WriteFile(invalid_path, "");
+  EXPECT_FALSE(load(invalid_path, model_id).IsOK());
+
+  // truncated in the middle of the weight, and right after the header
+  WriteFile(invalid_path, contents.substr(0, contents.size() - 1));
+  EXPECT_FALSE(load(invalid_path, model_id).IsOK());
+  WriteFile(invalid_path, contents.substr(0, 8));
+  EXPECT_FALSE(load(invalid_path, model_id).IsOK());
+
+  // trailing bytes
+  WriteFile(invalid_path, contents + "x");
+  EXPECT_FALSE(load(invalid_path, model_id).IsOK());
+
+  // corrupted magic
+  std::string corrupted = contents;
+  corrupted[0] = 'X';
+  WriteFile(invalid_path, corrupted);
+  EXPECT_FALSE(load(invalid_path, model_id).IsOK());
+
+  // saved with another model, or loaded for a model without an ID
+  for (const std::string& other_model_id : {PrepackedWeightsStore().ModelId(), std::string()}) {
+    auto status = load(store_path, other_model_id);
+    EXPECT_FALSE(status.IsOK());
+    EXPECT_NE(status.ErrorMessage().find("another model"), std::string::npos) << status.ErrorMessage();
+  }
+
+  std::remove(invalid_path.c_str());
+  std::remove(store_path.c_str());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
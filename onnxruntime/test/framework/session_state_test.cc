@@ -171,5 +171,52 @@ TEST_P(SessionStateTestP, TestInitializerProcessing) {
 }
 
 INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStateTestP, testing::ValuesIn(param_list));
+
+#ifndef ENABLE_TRAINING
+// training builds generate patterns on a cache miss, which needs a real graph
+TEST(SessionStateTest, MemoryPatternCacheBucketing) {
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  ExecutionProviders execution_providers;
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+  SessionState s(model.MainGraph(), execution_providers, true, nullptr, nullptr, dtm,
+                 DefaultLoggingManager().DefaultLogger(), profiler);
+  s.SetMemoryPatternCacheOptions(MemoryPatternBucketing::PowerOfTwo, 0, 2);
+
+  auto get = [&s](const TensorShape& shape) {
+    std::vector<std::reference_wrapper<const TensorShape>> shapes{std::cref(shape)};
+    return s.GetMemoryPatternGroup(shapes, {});
+  };
+
+  auto update = [&s](const TensorShape& shape) {
+    std::vector<std::reference_wrapper<const TensorShape>> shapes{std::cref(shape)};
+    ASSERT_STATUS_OK(s.UpdateMemoryPatternGroupCache(shapes, onnxruntime::make_unique<MemoryPatternGroup>()));
+  };
+
+  EXPECT_EQ(get(TensorShape({1, 5})), nullptr);
+  update(TensorShape({1, 5}));
+
+  // 5 and 7 are both in the bucket for 8
+  auto pattern = get(TensorShape({1, 7}));
+  EXPECT_NE(pattern, nullptr);
+  EXPECT_EQ(get(TensorShape({1, 9})), nullptr);
+  // order of dimensions matters
+  EXPECT_EQ(get(TensorShape({7, 1})), nullptr);
+
+  update(TensorShape({1, 9}));
+  update(TensorShape({1, 17}));
+
+  auto stats = s.GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 3u);
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.entries, 2u);
+
+  // least recently used entry was evicted, but remains valid for users that still hold it
+  EXPECT_EQ(get(TensorShape({1, 5})), nullptr);
+  EXPECT_TRUE(pattern->locations.empty());
+  EXPECT_NE(get(TensorShape({1, 16})), nullptr);
+}
+#endif
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializers.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static BufferUniquePtr MakeInitializerBuffer(SharedInitializerRegistry& registry, const void* data, size_t size) {
+  const AllocatorPtr& alloc = registry.Allocator();
+  void* buffer = alloc->Alloc(size);
+  memcpy(buffer, data, size);
+  return BufferUniquePtr(buffer, BufferDeleter(alloc));
+}
+
+TEST(SharedInitializerRegistryTest, ShareIdenticalBuffers) {
+  SharedInitializerRegistry registry;
+
+  const float data[] = {1.0f, 2.0f, 3.0f, 4.0f};
+  const float other_data[] = {1.0f, 2.0f, 3.0f, 5.0f};
+
+  std::shared_ptr<void> first = registry.Share(MakeInitializerBuffer(registry, data, sizeof(data)), sizeof(data));
+  std::shared_ptr<void> second = registry.Share(MakeInitializerBuffer(registry, data, sizeof(data)), sizeof(data));
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(memcmp(first.get(), data, sizeof(data)), 0);
+
+  // Buffers that differ in their bytes or in their size are not shared.
+  std::shared_ptr<void> other_bytes =
+      registry.Share(MakeInitializerBuffer(registry, other_data, sizeof(other_data)), sizeof(other_data));
+  std::shared_ptr<void> other_size =
+      registry.Share(MakeInitializerBuffer(registry, data, sizeof(float)), sizeof(float));
+  EXPECT_NE(first.get(), other_bytes.get());
+  EXPECT_NE(first.get(), other_size.get());
+  EXPECT_EQ(registry.NumSharedBuffers(), 3u);
+
+  // The registry drops a buffer once no session uses it.
+  first.reset();
+  EXPECT_EQ(registry.NumSharedBuffers(), 3u);
+  second.reset();
+  EXPECT_EQ(registry.NumSharedBuffers(), 2u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
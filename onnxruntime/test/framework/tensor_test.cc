@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensor.h"
+#include "core/framework/TensorSeq.h"
 #include "core/framework/allocatormgr.h"
 #include "test_utils.h"
 
@@ -22,7 +23,7 @@ void CPUTensorTest(std::vector<int64_t> dims, const int offset = 0) {
   Tensor t(DataTypeImpl::GetType<T>(), shape, data, alloc->Info(), offset);
   auto tensor_shape = t.Shape();
   //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&shape), *reinterpret_cast<const std::vector<int64_t>*>(&tensor_shape));
+  EXPECT_EQ(shape.GetDims(), tensor_shape.GetDims());
   EXPECT_EQ(t.DataType(), DataTypeImpl::GetType<T>());
   auto& location = t.Location();
   EXPECT_STREQ(location.name, CPU);
@@ -38,7 +39,7 @@ void CPUTensorTest(std::vector<int64_t> dims, const int offset = 0) {
 
   tensor_shape = new_t.Shape();
   //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&shape), *reinterpret_cast<const std::vector<int64_t>*>(&tensor_shape));
+  EXPECT_EQ(shape.GetDims(), tensor_shape.GetDims());
   EXPECT_EQ(new_t.DataType(), DataTypeImpl::GetType<T>());
   auto& new_location = new_t.Location();
   ASSERT_STREQ(new_location.name, CPU);
@@ -159,7 +160,7 @@ TEST(TensorTest, StringTensorTest) {
 
     auto& tensor_shape = t.Shape();
     //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-    EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&shape), *reinterpret_cast<const std::vector<int64_t>*>(&tensor_shape));
+    EXPECT_EQ(shape.GetDims(), tensor_shape.GetDims());
     EXPECT_EQ(t.DataType(), DataTypeImpl::GetType<std::string>());
     auto& location = t.Location();
     ASSERT_STREQ(location.name, CPU);
@@ -195,6 +196,29 @@ TEST(TensorTest, Int64PtrConstructor) {
   EXPECT_THAT(shape.GetDims(), testing::ElementsAre(2, 3));
 }
 
+TEST(TensorTest, TensorShapeInlineAndSpilledDims) {
+  TensorShape small{2, 3, 4};
+  TensorShape large(std::vector<int64_t>{1, 2, 3, 4, 5, 6, 7, 8});
+  EXPECT_EQ(large.Size(), 40320);
+  EXPECT_EQ(large.Slice(5).Size(), 336);
+  EXPECT_THAT(large.Slice(1, 4).GetDimsAsSpan(), testing::ElementsAre(2, 3, 4));
+
+  // the vector returned by GetDims() follows later changes to the shape, as it did when TensorShape was a vector
+  TensorShape shape = small;
+  const auto& dims = shape.GetDims();
+  shape[1] = 5;
+  EXPECT_THAT(dims, testing::ElementsAre(2, 5, 4));
+  shape = large;
+  EXPECT_EQ(dims.size(), 8u);
+  shape = std::move(small);
+  EXPECT_THAT(dims, testing::ElementsAre(2, 3, 4));
+
+  TensorShape moved(std::move(large));
+  EXPECT_EQ(moved.NumDimensions(), 8u);
+  EXPECT_EQ(moved, TensorShape(moved.GetDims()));
+  EXPECT_NE(moved, shape);
+}
+
 TEST(TensorTest, SizeOverflow) {
   // shape overflow
   EXPECT_THROW(TensorShape({std::numeric_limits<int64_t>::max() / 2, 3}).Size(), OnnxRuntimeException);
@@ -214,5 +238,40 @@ TEST(TensorTest, SizeOverflow) {
   ptrdiff_t offset = sizeof(float);  // one more element to push past max
   EXPECT_THROW(Tensor(type, shape2, alloc, offset), OnnxRuntimeException);
 }
+
+TEST(TensorTest, TensorSeqSharesElements) {
+  auto alloc = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  auto type = DataTypeImpl::GetType<float>();
+
+  std::vector<Tensor> tensors;
+  tensors.emplace_back(type, TensorShape({2}), alloc);
+  tensors.emplace_back(type, TensorShape({3}), alloc);
+  EXPECT_TRUE(tensors[0].OwnsBuffer());
+  const void* first_data = tensors[0].DataRaw();
+
+  std::vector<OrtValue> values;
+  {
+    TensorSeq seq(type);
+    seq.SetElements(std::move(tensors));
+    values.push_back(seq.GetValue(1));
+    values.push_back(seq.GetValue(0));
+  }
+
+  // the tensors outlive the sequence they were shared from
+  TensorSeq shared_seq(type);
+  shared_seq.SetElements(std::move(values));
+  ASSERT_EQ(shared_seq.Size(), 2u);
+  EXPECT_EQ(shared_seq.Get(1).DataRaw(), first_data);
+
+  std::vector<int64_t> sizes;
+  for (const auto& tensor : shared_seq) {
+    sizes.push_back(tensor.Shape().Size());
+  }
+  EXPECT_EQ(sizes, std::vector<int64_t>({3, 2}));
+
+  float data[2];
+  Tensor borrowed(type, TensorShape({2}), data, alloc->Info());
+  EXPECT_FALSE(borrowed.OwnsBuffer());
+}
 }  // namespace test
 }  // namespace onnxruntime
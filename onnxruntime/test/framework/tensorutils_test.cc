@@ -114,6 +114,12 @@ static void TestConstantNodeConversion(const std::string& attrib_name,
   EXPECT_STATUS_OK(utils::ConstantNodeProtoToTensorProto(c, tp));
 
   EXPECT_THAT(get_data(tp), ::testing::ContainerEq(input));
+
+  TensorProto moved_tp;
+  EXPECT_STATUS_OK(utils::ConstantNodeProtoToTensorProto(std::move(c), moved_tp));
+
+  EXPECT_THAT(get_data(moved_tp), ::testing::ContainerEq(input));
+  EXPECT_EQ(moved_tp.name(), tp.name());
 }
 
 TEST(TensorProtoUtilsTest, ConstantTensorProto) {
@@ -172,6 +178,19 @@ TEST(TensorProtoUtilsTest, ConstantTensorProto) {
       },
       -1);
 
+  TestConstantNodeConversion<float>(
+      "value", AttributeProto_AttributeType_TENSOR,
+      [](AttributeProto& attrib, const std::vector<float>& data) {
+        auto& t = *attrib.mutable_t();
+        t.set_data_type(TensorProto_DataType_FLOAT);
+        t.add_dims(static_cast<int64_t>(data.size()));
+        *t.mutable_float_data() = {data.cbegin(), data.cend()};
+      },
+      [](const TensorProto& tp) {
+        return std::vector<float>(tp.float_data().cbegin(), tp.float_data().cend());
+      },
+      -1);
+
   // sparse_tensor is covered by SparseTensorConversionTests.TestConstantNodeConversion
 }
 }  // namespace test
@@ -1361,5 +1361,43 @@ TEST_F(GraphTest, SetInputsAndSetOutputs_NewInputAndOutput) {
   ASSERT_TRUE(std::find(outputs.begin(), outputs.end(), sum_with_z) != outputs.end())
       << "expected new output sum_with_z";
 }
+
+// Resolve skips type and shape inferencing of nodes whose input and output types didn't change since the previous
+// Resolve. Check that the nodes affected by a modification are still inferred.
+TEST_F(GraphTest, ResolveAfterModificationInfersAffectedNodes) {
+  Model model("graph_1", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_type;
+  SetTypeAndShape(tensor_type.mutable_tensor_type(), TensorProto_DataType_FLOAT, {2, 3});
+
+  auto& X = graph.GetOrCreateNodeArg("X", &tensor_type);
+  auto& Y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& Z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("transpose", "Transpose", "transpose X", {&X}, {&Y});
+  graph.AddNode("identity", "Identity", "identity Y", {&Y}, {&Z});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  auto has_transposed_shape = [](const NodeArg* node_arg) {
+    const auto* shape = node_arg->Shape();
+    return shape != nullptr && shape->dim_size() == 2 &&
+           shape->dim(0).dim_value() == 3 && shape->dim(1).dim_value() == 2;
+  };
+
+  ASSERT_TRUE(has_transposed_shape(graph.GetNodeArg("Y")));
+  ASSERT_TRUE(has_transposed_shape(graph.GetNodeArg("Z")));
+
+  // an output type that changed since the previous inferencing requires inferencing the node again
+  graph.GetNodeArg("Y")->ClearShape();
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_TRUE(has_transposed_shape(graph.GetNodeArg("Y")));
+
+  // a new node consuming the output of an unchanged node is inferred
+  auto& W = graph.GetOrCreateNodeArg("W", nullptr);
+  graph.AddNode("identity_2", "Identity", "identity Z", {&Z}, {&W});
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_TRUE(has_transposed_shape(graph.GetNodeArg("W")));
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <memory>
+#include <unordered_map>
 #include "core/platform/env.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
@@ -188,5 +189,53 @@ TEST_F(ONNXModelsTest, TestModelsWithAnOpContainingAFunctionBody) {
   ASSERT_STATUS_OK(model->MainGraph().Resolve());
 }
 
+// test that loading with mapped initializers replaces the raw data of the initializers by references to the same
+// bytes in the model file, and leaves the rest of the model unchanged.
+TEST_F(ONNXModelsTest, LoadWithMappedInitializers) {
+  const ORTCHAR_T* model_path = ORT_TSTR("testdata/squeezenet/model.onnx");
+  ModelProto model_proto;
+  ASSERT_STATUS_OK(Model::Load(model_path, model_proto));
+  ModelProto mapped_model_proto;
+  ASSERT_STATUS_OK(Model::LoadWithMappedInitializers(model_path, mapped_model_proto));
+
+  const auto& graph = model_proto.graph();
+  const auto& mapped_graph = mapped_model_proto.graph();
+  ASSERT_EQ(mapped_model_proto.opset_import_size(), model_proto.opset_import_size());
+  ASSERT_EQ(mapped_graph.node_size(), graph.node_size());
+  ASSERT_EQ(mapped_graph.input_size(), graph.input_size());
+  ASSERT_EQ(mapped_graph.initializer_size(), graph.initializer_size());
+
+  int num_mapped = 0;
+  for (int i = 0; i < graph.initializer_size(); ++i) {
+    const TensorProto& initializer = graph.initializer(i);
+    const TensorProto& mapped_initializer = mapped_graph.initializer(i);
+    ASSERT_EQ(mapped_initializer.name(), initializer.name());
+    ASSERT_EQ(mapped_initializer.dims_size(), initializer.dims_size());
+    if (mapped_initializer.data_location() != TensorProto_DataLocation_EXTERNAL) {
+      EXPECT_EQ(mapped_initializer.raw_data(), initializer.raw_data());
+      continue;
+    }
+
+    ASSERT_FALSE(mapped_initializer.has_raw_data());
+    std::unordered_map<std::string, std::string> external_data;
+    for (const auto& entry : mapped_initializer.external_data()) {
+      external_data[entry.key()] = entry.value();
+    }
+    EXPECT_EQ(external_data["location"], "model.onnx");
+    const size_t length = std::stoull(external_data["length"]);
+    ASSERT_EQ(length, initializer.raw_data().size());
+    std::vector<char> data(length);
+    ASSERT_STATUS_OK(Env::Default().ReadFileIntoBuffer(model_path, std::stoll(external_data["offset"]), length,
+                                                       gsl::make_span(data)));
+    EXPECT_EQ(std::string(data.data(), length), initializer.raw_data());
+    ++num_mapped;
+  }
+
+#ifndef _WIN32
+  // the initializers are only mapped where Env::MapFileIntoMemory is implemented
+  EXPECT_GT(num_mapped, 0);
+#endif
+}
+
 }  // namespace test
 }  // namespace onnxruntime
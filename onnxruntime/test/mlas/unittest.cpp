@@ -20,6 +20,7 @@ Abstract:
 #include <limits>
 #include <memory>
 #include <random>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -41,11 +42,11 @@ Abstract:
 #define MLAS_HAS_DGEMM
 #endif
 
-#if defined(_M_IX86) || defined(__i386__) || defined(_M_AMD64) || defined(__x86_64__)
+#if defined(_M_IX86) || defined(__i386__) || defined(_M_AMD64) || defined(__x86_64__) || defined(_M_ARM64) || defined(__aarch64__)
 #define MLAS_HAS_QGEMM_U8X8
 #endif
 
-#if defined(_M_AMD64) || defined(__x86_64__)
+#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_ARM64) || defined(__aarch64__)
 #define MLAS_HAS_PACKED_QGEMM_U8X8
 #endif
 
@@ -206,8 +207,67 @@ public:
     }
 };
 
+template<typename T, bool Packed>
+class MlasFgemmTestBase;
+
 template<typename T>
-class MlasFgemmTest : public MlasTestBase
+class MlasFgemmTestBase<T, false> : public MlasTestBase
+{
+protected:
+    void
+    TestGemm(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const T* A,
+        size_t lda,
+        const T* B,
+        size_t ldb,
+        float beta,
+        T* C,
+        size_t ldc
+        )
+    {
+        MlasGemm(TransA, TransB, M, N, K, T(alpha), A, lda, B, ldb, T(beta), C, ldc, threadpool);
+    }
+};
+
+template<>
+class MlasFgemmTestBase<float, true> : public MlasTestBase
+{
+protected:
+    void
+    TestGemm(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        size_t lda,
+        const float* B,
+        size_t ldb,
+        float beta,
+        float* C,
+        size_t ldc
+        )
+    {
+        size_t PackedBSize = MlasGemmPackBSize(N, K);
+        void* PackedB = BufferBPacked.GetBuffer(PackedBSize);
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+        MlasGemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, threadpool);
+    }
+
+private:
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
+};
+
+template<typename T, bool Packed>
+class MlasFgemmTest : public MlasFgemmTestBase<T, Packed>
 {
 private:
     void
@@ -251,13 +311,13 @@ private:
         std::fill_n(C, M * N, -0.5f);
         std::fill_n(CReference, M * N, -0.5f);
 
-        MlasGemm(TransA, TransB, M, N, K, T(alpha), A, lda, B, ldb, T(beta), C, ldc, threadpool);
+        this->TestGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
         ReferenceGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, ldc);
 
         for (size_t f = 0; f < M * N; f++) {
             // Sensitive to comparing positive/negative zero.
             if (C[f] != CReference[f]) {
-                printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n", TransA, TransB, M, N, K, alpha, beta, float(C[f]), float(CReference[f]));
+                printf("mismatch Packed=%d, TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n", int(Packed), TransA, TransB, M, N, K, alpha, beta, float(C[f]), float(CReference[f]));
                 break;
             }
         }
@@ -470,6 +530,116 @@ public:
     }
 };
 
+class MlasSgemmBatchTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t BatchCount,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        Test(CblasNoTrans, CblasNoTrans, BatchCount, M, N, K, alpha, beta);
+        Test(CblasNoTrans, CblasTrans, BatchCount, M, N, K, alpha, beta);
+        Test(CblasTrans, CblasNoTrans, BatchCount, M, N, K, alpha, beta);
+        Test(CblasTrans, CblasTrans, BatchCount, M, N, K, alpha, beta);
+    }
+
+    void
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t BatchCount,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        //
+        // Pad the leading dimensions and the batch strides to check that the
+        // routine honors both.
+        //
+
+        const size_t lda = ((TransA == CblasNoTrans) ? K : M) + 1;
+        const size_t ldb = ((TransB == CblasNoTrans) ? N : K) + 2;
+        const size_t ldc = N + 3;
+        const size_t StrideA = lda * ((TransA == CblasNoTrans) ? M : K) + 5;
+        const size_t StrideB = ldb * ((TransB == CblasNoTrans) ? K : N) + 7;
+        const size_t StrideC = ldc * M + 9;
+
+        const float* A = BufferA.GetBuffer(StrideA * BatchCount);
+        const float* B = BufferB.GetBuffer(StrideB * BatchCount);
+        float* C = BufferC.GetBuffer(StrideC * BatchCount);
+        float* CReference = BufferCReference.GetBuffer(StrideC * BatchCount);
+
+        std::fill_n(C, StrideC * BatchCount, -0.5f);
+        std::fill_n(CReference, StrideC * BatchCount, -0.5f);
+
+        MlasGemmBatch(TransA, TransB, M, N, K, alpha, A, lda, StrideA, B, ldb, StrideB,
+            beta, C, ldc, StrideC, BatchCount, threadpool);
+
+        for (size_t b = 0; b < BatchCount; b++) {
+
+            const float* a = A + b * StrideA;
+            const float* bb = B + b * StrideB;
+
+            for (size_t m = 0; m < M; m++) {
+                for (size_t n = 0; n < N; n++) {
+
+                    float sum = 0.0f;
+
+                    for (size_t k = 0; k < K; k++) {
+                        const float av = (TransA == CblasNoTrans) ? a[m * lda + k] : a[k * lda + m];
+                        const float bv = (TransB == CblasNoTrans) ? bb[k * ldb + n] : bb[n * ldb + k];
+                        sum += av * bv;
+                    }
+
+                    float* c = CReference + b * StrideC + m * ldc + n;
+                    *c = (*c * beta) + (sum * alpha);
+                }
+            }
+        }
+
+        for (size_t f = 0; f < StrideC * BatchCount; f++) {
+            // Sensitive to comparing positive/negative zero.
+            if (C[f] != CReference[f]) {
+                printf("mismatch TransA=%d, TransB=%d, BatchCount=%zd, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n",
+                    TransA, TransB, BatchCount, M, N, K, alpha, beta, C[f], CReference[f]);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, b, 1.0f, 0.0f);
+        }
+        Test(1, 128, 128, 64, 0.125f, 1.0f);
+        Test(3, 128, 64, 128, 1.0f, 0.0f);
+        Test(24, 128, 128, 64, 0.125f, 1.0f);
+        Test(24, 128, 64, 128, 1.0f, 0.0f);
+        Test(1, 16, 300, 64, 1.0f, 0.0f);
+        Test(2, 7, 200, 33, 0.5f, -1.0f);
+        Test(5, 300, 9, 17, -0.25f, 0.5f);
+    }
+};
+
 #ifdef MLAS_HAS_QGEMM_U8X8
 
 template<bool Packed>
@@ -709,6 +879,7 @@ public:
             Test(1, b, b, 0, 0);
         }
         Test(43, 500, 401, 183, 223);
+        Test(71, 130, 1100, 17, 31);
         Test(1023, 1023, 1023, 5, 8);
     }
 
@@ -900,6 +1071,240 @@ public:
 
 #endif
 
+class MlasBf16GemmTest : public MlasTestBase
+{
+private:
+    static
+    float
+    RoundToBf16(
+        float Value
+        )
+    {
+        uint32_t Bits;
+        memcpy(&Bits, &Value, sizeof(uint32_t));
+        Bits += 0x7FFF + ((Bits >> 16) & 1);
+        Bits &= 0xFFFF0000;
+        memcpy(&Value, &Bits, sizeof(uint32_t));
+        return Value;
+    }
+
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta,
+        float InputScale
+        )
+    {
+        float* A = BufferA.GetBuffer(K * M);
+        float* B = BufferB.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        //
+        // Values that are not exactly representable as bfloat16 exercise the
+        // rounding of the inputs.
+        //
+
+        if (InputScale != 1.0f) {
+            for (size_t i = 0; i < K * M; i++) {
+                A[i] *= InputScale;
+            }
+            for (size_t i = 0; i < N * K; i++) {
+                B[i] *= InputScale;
+            }
+        }
+
+        Test(CblasNoTrans, M, N, K, alpha, A, K, B, N, beta, C, CReference, N);
+        Test(CblasTrans, M, N, K, alpha, A, K, B, K, beta, C, CReference, N);
+    }
+
+    void
+    Test(
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        size_t lda,
+        const float* B,
+        size_t ldb,
+        float beta,
+        float* C,
+        float* CReference,
+        size_t ldc
+        )
+    {
+        size_t PackedBSize = MlasGemmBf16PackBSize(N, K);
+        void* PackedB = BufferBPacked.GetBuffer(PackedBSize);
+        MlasGemmBf16PackB(TransB, N, K, B, ldb, PackedB);
+
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        MlasGemmBf16(M, N, K, alpha, A, lda, PackedB, beta, C, ldc, threadpool);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+
+                double sum = 0.0;
+                double magnitude = 0.0;
+
+                for (size_t k = 0; k < K; k++) {
+                    const float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+                    const double product = double(RoundToBf16(A[m * lda + k])) * double(RoundToBf16(b));
+                    sum += product;
+                    magnitude += std::abs(product);
+                }
+
+                float* c = CReference + (m * ldc) + n;
+                *c = float((double(*c) * beta) + (sum * alpha));
+
+                //
+                // The products are exact in single precision, so the only
+                // error comes from the order of the single precision sums.
+                //
+
+                const double tolerance = (magnitude * std::abs(alpha) + 1.0) * 1e-6;
+
+                if (std::abs(double(C[m * ldc + n]) - double(*c)) > tolerance) {
+                    printf("mismatch TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n",
+                        TransB, M, N, K, alpha, beta, C[m * ldc + n], *c);
+                    return;
+                }
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, 1.0f, 0.0f, 1.0f);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 1.0f, 0.0f, 1.0f);
+        }
+        for (size_t b = 256; b < 320; b += 32) {
+            Test(b, b, b, 1.0f, 0.0f, 0.1f);
+        }
+        for (size_t b = 1; b < 96; b++) {
+            Test(1, b, 33, 1.0f, 0.0f, 0.1f);
+        }
+        Test(7, 40, 511, 0.5f, 1.0f, 0.1f);
+        Test(43, 503, 401, -0.25f, -1.0f, 0.3f);
+        Test(64, 96, 600, 1.0f, 0.5f, 1.0f);
+    }
+};
+
+class MlasHalfGemmTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K
+        )
+    {
+        const size_t lda = K + 1;
+        const size_t ldb = N + 3;
+        const size_t ldc = N + 2;
+
+        unsigned short* A = BufferA.GetBuffer(M * lda);
+        unsigned short* B = BufferB.GetBuffer(K * ldb);
+        unsigned short* C = BufferC.GetBuffer(M * ldc);
+        float* AFloat = BufferAFloat.GetBuffer(M * lda);
+        float* BFloat = BufferBFloat.GetBuffer(K * ldb);
+        float* CFloat = BufferCFloat.GetBuffer(M * ldc);
+
+        //
+        // Every partial sum of the small integers stays below 2048, so the
+        // result is exact whether the products are accumulated in half or
+        // single precision.
+        //
+
+        for (size_t i = 0; i < M * lda; i++) {
+            AFloat[i] = float(int(i % 7) - 3);
+        }
+        for (size_t i = 0; i < K * ldb; i++) {
+            BFloat[i] = float(int(i % 5) - 2);
+        }
+
+        MlasConvertFloatToHalfBuffer(AFloat, A, M * lda);
+        MlasConvertFloatToHalfBuffer(BFloat, B, K * ldb);
+
+        std::fill_n(C, M * ldc, (unsigned short)0x7E00);
+
+        MlasHalfGemm(M, N, K, A, lda, B, ldb, C, ldc, threadpool);
+
+        MlasConvertHalfToFloatBuffer(C, CFloat, M * ldc);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+
+                float sum = 0.0f;
+
+                for (size_t k = 0; k < K; k++) {
+                    sum += AFloat[m * lda + k] * BFloat[k * ldb + n];
+                }
+
+                if (CFloat[m * ldc + n] != sum) {
+                    printf("mismatch HalfGemm: M=%zd, N=%zd, K=%zd  %f %f!\n",
+                        M, N, K, CFloat[m * ldc + n], sum);
+                    return;
+                }
+            }
+
+            for (size_t n = N; n < ldc; n++) {
+                if (C[m * ldc + n] != 0x7E00) {
+                    printf("mismatch HalfGemm: M=%zd, N=%zd, K=%zd  wrote past N!\n", M, N, K);
+                    return;
+                }
+            }
+        }
+    }
+
+    MatrixGuardBuffer<unsigned short> BufferA;
+    MatrixGuardBuffer<unsigned short> BufferB;
+    MatrixGuardBuffer<unsigned short> BufferC;
+    MatrixGuardBuffer<float> BufferAFloat;
+    MatrixGuardBuffer<float> BufferBFloat;
+    MatrixGuardBuffer<float> BufferCFloat;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 20; b++) {
+            Test(b, b, b);
+        }
+        for (size_t b = 32; b <= 256; b <<= 1) {
+            Test(b, b, b);
+        }
+        for (size_t b = 1; b < 40; b++) {
+            Test(1, b, 33);
+            Test(b, 1, 33);
+        }
+        Test(7, 300, 150);
+        Test(65, 17, 200);
+    }
+};
+
 class MlasConv2DTest : public MlasTestBase
 {
 protected:
@@ -983,7 +1388,7 @@ protected:
                         Bias,
                         OutputReference);
 
-        if (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0) {
+        if (!OutputMatches(Output, OutputReference, OutputElements)) {
             printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
                 BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
                 KernelHeight, KernelWidth);
@@ -991,9 +1396,20 @@ protected:
     }
 
     virtual
-    void
-    MlasConv2D(
-        size_t BatchCount,
+    bool
+    OutputMatches(
+        const float* Output,
+        const float* OutputReference,
+        size_t OutputElements
+        )
+    {
+        return memcmp(Output, OutputReference, OutputElements * sizeof(float)) == 0;
+    }
+
+    virtual
+    void
+    MlasConv2D(
+        size_t BatchCount,
         size_t GroupCount,
         size_t InputChannels,
         size_t InputHeight,
@@ -1223,6 +1639,60 @@ public:
     }
 };
 
+class MlasWinogradConv2DTest : public MlasConv2DTest
+{
+protected:
+    //
+    // The Winograd transforms sum the products in a different order than the
+    // GEMM reference, so the results are compared with a tolerance.
+    //
+
+    bool
+    OutputMatches(
+        const float* Output,
+        const float* OutputReference,
+        size_t OutputElements
+        ) override
+    {
+        constexpr float AbsoluteTolerance = 1e-4f;
+        constexpr float RelativeTolerance = 1e-5f;
+
+        for (size_t n = 0; n < OutputElements; n++) {
+            float diff = std::fabs(Output[n] - OutputReference[n]);
+            if (diff > AbsoluteTolerance && diff > std::fabs(OutputReference[n]) * RelativeTolerance) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        //
+        // These shapes select the Winograd algorithm: 3x3 kernels with unit
+        // strides and dilations, at least 16 input channels and filters, and
+        // at least 16 output tiles.
+        //
+
+        for (unsigned i = 9; i < 64; i <<= 1) {
+            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+        }
+
+        //
+        // Batches, groups, partial output tiles and asymmetric padding.
+        //
+
+        Test(2, 2, 16, 11, 13, 24, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+        Test(1, 1, 17, 13, 9, 19, 3, 3, 2, 1, 0, 0, 1, 1, 1, 1);
+    }
+};
+
 class MlasNchwcConv2DTest : public MlasConv2DTest
 {
 protected:
@@ -2495,6 +2965,461 @@ public:
     }
 };
 
+class MlasLayerNormTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferSkip;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferGamma;
+    MatrixGuardBuffer<float> BufferBeta;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+    MatrixGuardBuffer<float> BufferMean;
+    MatrixGuardBuffer<float> BufferInvStdDev;
+
+    void
+    Test(
+        size_t N,
+        size_t D,
+        bool HasSkip,
+        bool HasBias,
+        bool HasBeta
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Skip = HasSkip ? BufferSkip.GetBuffer(N * D) : nullptr;
+        float* Bias = HasBias ? BufferBias.GetBuffer(D) : nullptr;
+        float* Gamma = BufferGamma.GetBuffer(D);
+        float* Beta = HasBeta ? BufferBeta.GetBuffer(D) : nullptr;
+        float* Output = BufferOutput.GetBuffer(N * D);
+        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+        float* Mean = BufferMean.GetBuffer(N);
+        float* InvStdDev = BufferInvStdDev.GetBuffer(N);
+
+        std::default_random_engine generator(static_cast<unsigned>(N * D));
+        std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            Input[nd] = distribution(generator);
+            if (Skip != nullptr) {
+                Skip[nd] = distribution(generator);
+            }
+        }
+
+        for (size_t d = 0; d < D; d++) {
+            Gamma[d] = distribution(generator);
+            if (Bias != nullptr) {
+                Bias[d] = distribution(generator);
+            }
+            if (Beta != nullptr) {
+                Beta[d] = distribution(generator);
+            }
+        }
+
+        constexpr float Epsilon = 1e-5f;
+
+        MlasComputeLayerNorm(Input, Skip, Bias, Gamma, Beta, Output, Mean, InvStdDev, N, D, Epsilon);
+
+        constexpr float AbsoluteTolerance = 1e-5f;
+        constexpr float RelativeTolerance = 1e-5f;
+
+        for (size_t n = 0; n < N; n++) {
+
+            double MeanReference = 0.0;
+            double MeanSquareReference = 0.0;
+
+            for (size_t d = 0; d < D; d++) {
+                double Value = ReferenceValue(Input, Skip, Bias, n, d, D);
+                MeanReference += Value;
+                MeanSquareReference += Value * Value;
+            }
+
+            MeanReference /= double(D);
+            MeanSquareReference /= double(D);
+
+            double VarianceReference = MeanSquareReference - MeanReference * MeanReference;
+            double InvStdDevReference = 1.0 / std::sqrt(VarianceReference + double(Epsilon));
+
+            for (size_t d = 0; d < D; d++) {
+                double Value = ReferenceValue(Input, Skip, Bias, n, d, D);
+                double Normalized = (Value - MeanReference) * InvStdDevReference * double(Gamma[d]);
+                if (Beta != nullptr) {
+                    Normalized += double(Beta[d]);
+                }
+                OutputReference[n * D + d] = float(Normalized);
+            }
+
+            //
+            // The variance is computed from the sum of squares, so the inverse
+            // standard deviation is only accurate for rows that are not
+            // (nearly) constant.
+            //
+
+            if (!CloseEnough(Mean[n], float(MeanReference), AbsoluteTolerance, RelativeTolerance) ||
+                (VarianceReference > 1e-2 &&
+                 !CloseEnough(InvStdDev[n], float(InvStdDevReference), AbsoluteTolerance, RelativeTolerance))) {
+                printf("layernorm statistics mismatch: %u/%u %.8f %.8f %.8f %.8f\n", unsigned(N), unsigned(D),
+                    Mean[n], float(MeanReference), InvStdDev[n], float(InvStdDevReference));
+            }
+        }
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            if (!CloseEnough(Output[nd], OutputReference[nd], AbsoluteTolerance, RelativeTolerance)) {
+                printf("layernorm(%d,%d,%d) mismatch: %u/%u %.8f %.8f\n", int(HasSkip), int(HasBias), int(HasBeta),
+                    unsigned(N), unsigned(D), Output[nd], OutputReference[nd]);
+            }
+        }
+
+        //
+        // Verify the routine supports the output buffer aliasing the input
+        // buffer.
+        //
+
+        MlasComputeLayerNorm(Input, Skip, Bias, Gamma, Beta, Input, nullptr, nullptr, N, D, Epsilon);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            if (Input[nd] != Output[nd]) {
+                printf("layernorm(%d,%d,%d) inplace mismatch: %u/%u %.8f %.8f\n", int(HasSkip), int(HasBias), int(HasBeta),
+                    unsigned(N), unsigned(D), Input[nd], Output[nd]);
+            }
+        }
+    }
+
+    static
+    double
+    ReferenceValue(
+        const float* Input,
+        const float* Skip,
+        const float* Bias,
+        size_t n,
+        size_t d,
+        size_t D
+        )
+    {
+        double Value = double(Input[n * D + d]);
+        if (Skip != nullptr) {
+            Value += double(Skip[n * D + d]);
+        }
+        if (Bias != nullptr) {
+            Value += double(Bias[d]);
+        }
+        return Value;
+    }
+
+    static
+    bool
+    CloseEnough(
+        float Value,
+        float ValueReference,
+        float AbsoluteTolerance,
+        float RelativeTolerance
+        )
+    {
+        float diff = std::fabs(Value - ValueReference);
+        return diff <= AbsoluteTolerance || diff <= std::fabs(ValueReference) * RelativeTolerance;
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t d = 1; d < 80; d++) {
+            Test(1, d, false, false, true);
+            Test(2, d, true, true, true);
+        }
+
+        for (size_t d : {128, 256, 768, 1023, 1024}) {
+            Test(3, d, false, false, false);
+            Test(3, d, true, false, true);
+            Test(3, d, false, true, true);
+            Test(3, d, true, true, false);
+        }
+    }
+};
+
+class MlasInstanceNormTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferScale;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+
+    void
+    Test(
+        size_t N,
+        size_t D,
+        float Offset
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Scale = BufferScale.GetBuffer(N);
+        float* Bias = BufferBias.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N * D);
+
+        std::default_random_engine generator(static_cast<unsigned>(N * D));
+        std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            Input[nd] = Offset + distribution(generator);
+        }
+
+        for (size_t n = 0; n < N; n++) {
+            Scale[n] = distribution(generator);
+            Bias[n] = distribution(generator);
+        }
+
+        constexpr float Epsilon = 1e-5f;
+        constexpr float AbsoluteTolerance = 1e-4f;
+        constexpr float RelativeTolerance = 1e-4f;
+
+        MlasComputeInstanceNorm(Input, Scale, Bias, Output, N, D, Epsilon);
+
+        for (size_t n = 0; n < N; n++) {
+
+            double MeanReference = 0.0;
+            for (size_t d = 0; d < D; d++) {
+                MeanReference += double(Input[n * D + d]);
+            }
+            MeanReference /= double(D);
+
+            double VarianceReference = 0.0;
+            for (size_t d = 0; d < D; d++) {
+                double Centered = double(Input[n * D + d]) - MeanReference;
+                VarianceReference += Centered * Centered;
+            }
+            VarianceReference /= double(D);
+
+            double InvStdDevReference = 1.0 / std::sqrt(VarianceReference + double(Epsilon));
+
+            for (size_t d = 0; d < D; d++) {
+                float OutputReference = float((double(Input[n * D + d]) - MeanReference) * InvStdDevReference *
+                    double(Scale[n]) + double(Bias[n]));
+                if (!CloseEnough(Output[n * D + d], OutputReference, AbsoluteTolerance, RelativeTolerance)) {
+                    printf("instancenorm mismatch: %u/%u/%.1f %.8f %.8f\n", unsigned(N), unsigned(D), Offset,
+                        Output[n * D + d], OutputReference);
+                }
+            }
+        }
+
+        MlasComputeScaleShift(Input, Scale, Bias, Output, N, D);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            size_t n = nd / D;
+            float OutputReference = Input[nd] * Scale[n] + Bias[n];
+            if (!CloseEnough(Output[nd], OutputReference, AbsoluteTolerance, RelativeTolerance)) {
+                printf("scaleshift mismatch: %u/%u %.8f %.8f\n", unsigned(N), unsigned(D), Output[nd], OutputReference);
+            }
+        }
+    }
+
+    static
+    bool
+    CloseEnough(
+        float Value,
+        float ValueReference,
+        float AbsoluteTolerance,
+        float RelativeTolerance
+        )
+    {
+        float diff = std::fabs(Value - ValueReference);
+        return diff <= AbsoluteTolerance || diff <= std::fabs(ValueReference) * RelativeTolerance;
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t d = 1; d < 40; d++) {
+            Test(3, d, 0.0f);
+        }
+
+        for (size_t d : {256, 1023, 4096, 65536}) {
+            Test(2, d, 0.0f);
+            Test(2, d, 100.0f);
+        }
+    }
+};
+
+class MlasBiasGeluTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+
+    void
+    Test(
+        size_t N,
+        size_t D,
+        bool HasBias,
+        bool UseApproximation
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Bias = HasBias ? BufferBias.GetBuffer(D) : nullptr;
+        float* Output = BufferOutput.GetBuffer(N * D);
+
+        std::default_random_engine generator(static_cast<unsigned>(N * D));
+        std::uniform_real_distribution<float> distribution(-5.0f, 5.0f);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            Input[nd] = distribution(generator);
+        }
+
+        if (Bias != nullptr) {
+            for (size_t d = 0; d < D; d++) {
+                Bias[d] = distribution(generator);
+            }
+        }
+
+        MlasComputeBiasGelu(Input, Bias, Output, N, D, UseApproximation);
+
+        constexpr float AbsoluteTolerance = 5e-6f;
+        constexpr float RelativeTolerance = 5e-6f;
+
+        for (size_t n = 0; n < N; n++) {
+            for (size_t d = 0; d < D; d++) {
+
+                double Value = double(Input[n * D + d]);
+                if (Bias != nullptr) {
+                    Value += double(Bias[d]);
+                }
+
+                double OutputReference;
+
+                if (UseApproximation) {
+                    OutputReference = 0.5 * Value * (1.0 + std::tanh(0.7978845608028654 * (Value + 0.044715 * Value * Value * Value)));
+                } else {
+                    OutputReference = 0.5 * Value * (1.0 + std::erf(Value * 0.7071067811865476));
+                }
+
+                float diff = std::fabs(Output[n * D + d] - float(OutputReference));
+                if (diff > AbsoluteTolerance && diff > std::fabs(float(OutputReference)) * RelativeTolerance) {
+                    printf("biasgelu(%d,%d) mismatch: %u/%u %.8f %.8f\n", int(HasBias), int(UseApproximation),
+                        unsigned(N), unsigned(D), Output[n * D + d], float(OutputReference));
+                }
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t d = 1; d < 40; d++) {
+            Test(1, d, false, false);
+            Test(2, d, true, true);
+        }
+
+        for (size_t d : {255, 256, 257, 768, 3072}) {
+            Test(3, d, true, false);
+            Test(3, d, true, true);
+            Test(2, d, false, true);
+        }
+    }
+};
+
+class MlasConvDepthwiseTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<uint8_t> BufferInput;
+    MatrixGuardBuffer<uint8_t> BufferFilter;
+    MatrixGuardBuffer<int32_t> BufferOutput;
+    MatrixGuardBuffer<int32_t> BufferOutputReference;
+    std::vector<const uint8_t*> Indirection;
+    std::vector<uint8_t> Padding;
+
+    void
+    Test(
+        size_t Channels,
+        size_t OutputCount,
+        size_t KernelSize
+        )
+    {
+        //
+        // Generate an input image of OutputCount + KernelSize pixels and an
+        // indirection buffer that mixes input pixels and padding pixels.
+        //
+
+        const size_t InputPixels = OutputCount + KernelSize;
+
+        uint8_t* Input = BufferInput.GetBuffer(InputPixels * Channels);
+        uint8_t* Filter = BufferFilter.GetBuffer(KernelSize * Channels);
+        int32_t* Output = BufferOutput.GetBuffer(OutputCount * Channels);
+        int32_t* OutputReference = BufferOutputReference.GetBuffer(OutputCount * Channels);
+
+        std::default_random_engine generator(static_cast<unsigned>(Channels * OutputCount * KernelSize));
+        std::uniform_int_distribution<int> distribution(0, 255);
+
+        for (size_t i = 0; i < InputPixels * Channels; i++) {
+            Input[i] = uint8_t(distribution(generator));
+        }
+
+        for (size_t i = 0; i < KernelSize * Channels; i++) {
+            Filter[i] = uint8_t(distribution(generator));
+        }
+
+        const uint8_t InputZeroPoint = uint8_t(distribution(generator));
+        const uint8_t FilterZeroPoint = uint8_t(distribution(generator));
+
+        Padding.assign(Channels, InputZeroPoint);
+        Indirection.resize(OutputCount * KernelSize);
+
+        for (size_t i = 0; i < OutputCount * KernelSize; i++) {
+            size_t Pixel = size_t(distribution(generator)) % (InputPixels + 1);
+            Indirection[i] = (Pixel == InputPixels) ? Padding.data() : Input + Pixel * Channels;
+        }
+
+        MlasConvDepthwise(Indirection.data(), InputZeroPoint, Filter, FilterZeroPoint,
+            Output, Channels, OutputCount, KernelSize);
+
+        for (size_t i = 0; i < OutputCount; i++) {
+            for (size_t c = 0; c < Channels; c++) {
+                int32_t Accumulator = 0;
+                for (size_t k = 0; k < KernelSize; k++) {
+                    Accumulator += (int32_t(Indirection[i * KernelSize + k][c]) - InputZeroPoint) *
+                        (int32_t(Filter[k * Channels + c]) - FilterZeroPoint);
+                }
+                OutputReference[i * Channels + c] = Accumulator;
+            }
+        }
+
+        for (size_t i = 0; i < OutputCount * Channels; i++) {
+            if (Output[i] != OutputReference[i]) {
+                printf("mismatch ConvDepthwise: Channels=%zd, OutputCount=%zd, KernelSize=%zd, %zd: %d %d\n",
+                    Channels, OutputCount, KernelSize, i, Output[i], OutputReference[i]);
+                break;
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t c = 1; c < 40; c++) {
+            Test(c, 1, 9);
+            Test(c, 7, 25);
+        }
+
+        Test(32, 49, 9);
+        Test(96, 113, 9);
+        Test(144, 196, 25);
+        Test(256, 11, 4);
+        Test(15, 37, 1);
+    }
+};
+
 class MlasFindMinMaxElementsTest : public MlasTestBase
 {
 private:
@@ -2548,16 +3473,175 @@ public:
     }
 };
 
+template<typename ElementType>
+class MlasTransposeTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<ElementType> BufferInput;
+    MatrixGuardBuffer<ElementType> BufferOutput;
+    MatrixGuardBuffer<ElementType> BufferOutputReference;
+
+    void
+    Test(
+        size_t M,
+        size_t N
+        )
+    {
+        ElementType* Input = BufferInput.GetBuffer(M * N);
+        ElementType* Output = BufferOutput.GetBuffer(M * N);
+        ElementType* OutputReference = BufferOutputReference.GetBuffer(M * N);
+
+        for (size_t i = 0; i < M * N; i++) {
+            Input[i] = ElementType(i * 2654435761u);
+        }
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                OutputReference[n * M + m] = Input[m * N + n];
+            }
+        }
+
+        MlasTranspose(Input, N, Output, M, M, N);
+
+        if (memcmp(Output, OutputReference, M * N * sizeof(ElementType)) != 0) {
+            printf("mismatch Transpose: M=%zd, N=%zd, ElementSize=%zd\n", M, N, sizeof(ElementType));
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t m = 1; m <= 32; m++) {
+            for (size_t n = 1; n <= 32; n++) {
+                Test(m, n);
+            }
+        }
+
+        Test(67, 300);
+        Test(300, 67);
+    }
+};
+
+class MlasHalfConversionTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<unsigned short> BufferHalf;
+    MatrixGuardBuffer<float> BufferFloat;
+    MatrixGuardBuffer<unsigned short> BufferHalfOutput;
+
+    static
+    float
+    FloatFromBits(
+        uint32_t Bits
+        )
+    {
+        float Value;
+        memcpy(&Value, &Bits, sizeof(float));
+        return Value;
+    }
+
+    void
+    TestRoundTrip(
+        size_t Offset,
+        size_t N
+        )
+    {
+        unsigned short* Half = BufferHalf.GetBuffer(N);
+        float* Float = BufferFloat.GetBuffer(N);
+        unsigned short* HalfOutput = BufferHalfOutput.GetBuffer(N);
+
+        //
+        // Every half-precision value other than a NaN converts back to itself.
+        //
+
+        for (size_t n = 0; n < N; n++) {
+            unsigned short Value = static_cast<unsigned short>(Offset + n);
+            Half[n] = ((Value & 0x7C00) == 0x7C00 && (Value & 0x03FF) != 0) ? 0x7C00 : Value;
+        }
+
+        MlasConvertHalfToFloatBuffer(Half, Float, N);
+        MlasConvertFloatToHalfBuffer(Float, HalfOutput, N);
+
+        for (size_t n = 0; n < N; n++) {
+            if (HalfOutput[n] != Half[n]) {
+                printf("mismatch HalfConversion: half=%04x float=%g half output=%04x\n",
+                    Half[n], Float[n], HalfOutput[n]);
+                break;
+            }
+        }
+    }
+
+    void
+    TestRounding(
+        void
+        )
+    {
+        static const struct {
+            uint32_t FloatBits;
+            unsigned short Half;
+        } Cases[] = {
+            { 0x3F800000, 0x3C00 },     // 1.0
+            { 0xBF800000, 0xBC00 },     // -1.0
+            { 0x3F801000, 0x3C00 },     // 1 + 2^-11 rounds to even
+            { 0x3F803000, 0x3C02 },     // 1 + 3 * 2^-11 rounds to even
+            { 0x3F801001, 0x3C01 },     // above the halfway point
+            { 0x477FE000, 0x7BFF },     // 65504
+            { 0x477FF000, 0x7C00 },     // 65520 overflows
+            { 0x33800000, 0x0001 },     // 2^-24
+            { 0x33000000, 0x0000 },     // 2^-25 rounds to even
+            { 0x80000000, 0x8000 },     // -0.0
+            { 0x7F800000, 0x7C00 },     // infinity
+            { 0x7FC00000, 0x7E00 },     // NaN
+        };
+
+        for (const auto& Case : Cases) {
+
+            float Float = FloatFromBits(Case.FloatBits);
+            unsigned short Half;
+            MlasConvertFloatToHalfBuffer(&Float, &Half, 1);
+
+            if (Half != Case.Half) {
+                printf("mismatch HalfConversion: float=%08x half=%04x expected=%04x\n",
+                    Case.FloatBits, Half, Case.Half);
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        TestRounding();
+
+        for (size_t n = 1; n <= 32; n++) {
+            TestRoundTrip(0x3C00 - n, n);
+        }
+
+        for (size_t offset = 0; offset < 0x10000; offset += 0x1000) {
+            TestRoundTrip(offset, 0x1000);
+        }
+    }
+};
+
 void
 RunThreadedTests(
     void
     )
 {
     printf("SGEMM tests.\n");
-    onnxruntime::make_unique<MlasFgemmTest<float>>()->ExecuteShort();
+    onnxruntime::make_unique<MlasFgemmTest<float, false>>()->ExecuteShort();
+    printf("SGEMM packed tests.\n");
+    onnxruntime::make_unique<MlasFgemmTest<float, true>>()->ExecuteShort();
+    printf("SGEMM batch tests.\n");
+    onnxruntime::make_unique<MlasSgemmBatchTest>()->ExecuteShort();
 #ifdef MLAS_HAS_DGEMM
     printf("DGEMM tests.\n");
-    onnxruntime::make_unique<MlasFgemmTest<double>>()->ExecuteShort();
+    onnxruntime::make_unique<MlasFgemmTest<double, false>>()->ExecuteShort();
 #endif
 
 #ifdef MLAS_HAS_QGEMM_U8X8
@@ -2586,8 +3670,17 @@ RunThreadedTests(
     }
 #endif
 
+    if (MlasGemmBf16PackBSize(128, 128) > 0) {
+        printf("BF16GEMM tests.\n");
+        onnxruntime::make_unique<MlasBf16GemmTest>()->ExecuteShort();
+    }
+
+    printf("HALFGEMM tests.\n");
+    onnxruntime::make_unique<MlasHalfGemmTest>()->ExecuteShort();
+
     printf("Conv2D tests.\n");
     onnxruntime::make_unique<MlasConv2DTest>()->ExecuteShort();
+    onnxruntime::make_unique<MlasWinogradConv2DTest>()->ExecuteShort();
     if (MlasNchwcGetBlockSize() > 1) {
         onnxruntime::make_unique<MlasNchwcConv2DTest>()->ExecuteShort();
     }
@@ -2644,9 +3737,30 @@ main(
     printf("Transcendental tests.\n");
     onnxruntime::make_unique<MlasComputeExpTest>()->ExecuteShort();
 
+    printf("LayerNorm tests.\n");
+    onnxruntime::make_unique<MlasLayerNormTest>()->ExecuteShort();
+
+    printf("InstanceNorm tests.\n");
+    onnxruntime::make_unique<MlasInstanceNormTest>()->ExecuteShort();
+
+    printf("BiasGelu tests.\n");
+    onnxruntime::make_unique<MlasBiasGeluTest>()->ExecuteShort();
+
+    printf("ConvDepthwise tests.\n");
+    onnxruntime::make_unique<MlasConvDepthwiseTest>()->ExecuteShort();
+
     printf("MinMaxElements tests.\n");
     onnxruntime::make_unique<MlasFindMinMaxElementsTest>()->ExecuteShort();
 
+    printf("Transpose tests.\n");
+    onnxruntime::make_unique<MlasTransposeTest<uint8_t>>()->ExecuteShort();
+    onnxruntime::make_unique<MlasTransposeTest<uint16_t>>()->ExecuteShort();
+    onnxruntime::make_unique<MlasTransposeTest<uint32_t>>()->ExecuteShort();
+    onnxruntime::make_unique<MlasTransposeTest<uint64_t>>()->ExecuteShort();
+
+    printf("HalfConversion tests.\n");
+    onnxruntime::make_unique<MlasHalfConversionTest>()->ExecuteShort();
+
     printf("ReorderOutput tests.\n");
     if (MlasNchwcGetBlockSize() > 1) {
         onnxruntime::make_unique<MlasReorderOutputTest>()->ExecuteShort();
@@ -0,0 +1,460 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Benchmarks of the hot CPU kernels at the shapes of common models (BERT-base, ResNet-50). Each kernel runs as the
+// only node of a model through a session, with one thread so the results measure the kernel rather than the thread
+// pool. Set MLAS_MAXIMUM_ISA to sse2, avx, avx2, avx512f, avx512core or avx512vnni to run the MLAS kernels of a
+// lower instruction set level, e.g. to compare the dispatch levels on one machine.
+
+#include <benchmark/benchmark.h>
+#include <core/common/common.h>
+#include <core/graph/constants.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include <onnx/defs/attr_proto_util.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ONNX_NAMESPACE;
+
+namespace {
+
+Ort::Env& GetEnv() {
+  // shares the environment created by main
+  static Ort::Env env{ORT_LOGGING_LEVEL_ERROR, "benchmark"};
+  return env;
+}
+
+template <typename T>
+void FillRandom(std::vector<uint8_t>& bytes, size_t count, float low, float high) {
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> dist(low, high);
+  bytes.resize(count * sizeof(T));
+  T* data = reinterpret_cast<T*>(bytes.data());
+  for (size_t i = 0; i != count; ++i) {
+    data[i] = static_cast<T>(dist(gen));
+  }
+}
+
+std::vector<uint8_t> RandomTensorData(TensorProto_DataType type, const std::vector<int64_t>& dims, float low,
+                                      float high) {
+  size_t count = 1;
+  for (int64_t dim : dims) {
+    count *= static_cast<size_t>(dim);
+  }
+
+  std::vector<uint8_t> bytes;
+  switch (type) {
+    case TensorProto_DataType_FLOAT:
+      FillRandom<float>(bytes, count, low, high);
+      break;
+    case TensorProto_DataType_UINT8:
+      FillRandom<uint8_t>(bytes, count, low, high);
+      break;
+    case TensorProto_DataType_INT8:
+      FillRandom<int8_t>(bytes, count, low, high);
+      break;
+    case TensorProto_DataType_INT32:
+      FillRandom<int32_t>(bytes, count, low, high);
+      break;
+    case TensorProto_DataType_INT64:
+      FillRandom<int64_t>(bytes, count, low, high);
+      break;
+    default:
+      ORT_THROW("Unsupported tensor type ", type);
+  }
+  return bytes;
+}
+
+// A model with one node, whose inputs are either fed on each run or constant initializers.
+class SingleNodeModel {
+ public:
+  SingleNodeModel(const std::string& op_type, const std::string& domain = onnxruntime::kOnnxDomain) {
+    model_.set_ir_version(IR_VERSION);
+    auto add_opset = [this](const std::string& opset_domain, int64_t version) {
+      auto* opset = model_.add_opset_import();
+      opset->set_domain(opset_domain);
+      opset->set_version(version);
+    };
+    add_opset(onnxruntime::kOnnxDomain, 12);
+    add_opset(onnxruntime::kMSDomain, 1);
+    add_opset(onnxruntime::kMLDomain, 2);
+
+    model_.mutable_graph()->set_name("benchmark");
+    node_ = model_.mutable_graph()->add_node();
+    node_->set_op_type(op_type);
+    node_->set_domain(domain);
+  }
+
+  // An input fed on each run, with values drawn uniformly from [low, high).
+  SingleNodeModel& Input(const std::string& name, TensorProto_DataType type, const std::vector<int64_t>& dims,
+                         float low = -1.0f, float high = 1.0f) {
+    node_->add_input(name);
+    auto* tensor_type = AddValueInfo(*model_.mutable_graph()->add_input(), name, type);
+    for (int64_t dim : dims) {
+      tensor_type->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    input_names_.push_back(name);
+    input_dims_.push_back(dims);
+    input_types_.push_back(type);
+    input_data_.push_back(RandomTensorData(type, dims, low, high));
+    return *this;
+  }
+
+  // A constant input, such as the weights of the node.
+  SingleNodeModel& Initializer(const std::string& name, TensorProto_DataType type, const std::vector<int64_t>& dims,
+                               float low = -1.0f, float high = 1.0f) {
+    node_->add_input(name);
+    auto* initializer = model_.mutable_graph()->add_initializer();
+    initializer->set_name(name);
+    initializer->set_data_type(type);
+    for (int64_t dim : dims) {
+      initializer->add_dims(dim);
+    }
+    const std::vector<uint8_t> data = RandomTensorData(type, dims, low, high);
+    initializer->set_raw_data(data.data(), data.size());
+    return *this;
+  }
+
+  // A constant int64 input with the given values, such as a shape or the K of TopK.
+  SingleNodeModel& Initializer(const std::string& name, const std::vector<int64_t>& values) {
+    node_->add_input(name);
+    auto* initializer = model_.mutable_graph()->add_initializer();
+    initializer->set_name(name);
+    initializer->set_data_type(TensorProto_DataType_INT64);
+    initializer->add_dims(static_cast<int64_t>(values.size()));
+    for (int64_t value : values) {
+      initializer->add_int64_data(value);
+    }
+    return *this;
+  }
+
+  SingleNodeModel& Output(const std::string& name, TensorProto_DataType type = TensorProto_DataType_FLOAT) {
+    node_->add_output(name);
+    AddValueInfo(*model_.mutable_graph()->add_output(), name, type);
+    output_names_.push_back(name);
+    return *this;
+  }
+
+  SingleNodeModel& Attribute(const AttributeProto& attribute) {
+    *node_->add_attribute() = attribute;
+    return *this;
+  }
+
+  void Run(benchmark::State& state, GraphOptimizationLevel optimization_level = ORT_ENABLE_ALL) {
+    std::string model_data;
+    model_.SerializeToString(&model_data);
+
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(1);
+    session_options.SetGraphOptimizationLevel(optimization_level);
+    Ort::Session session(GetEnv(), model_data.data(), model_data.size(), session_options);
+
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+    std::vector<Ort::Value> inputs;
+    std::vector<const char*> input_names;
+    for (size_t i = 0; i != input_names_.size(); ++i) {
+      inputs.push_back(Ort::Value::CreateTensor(memory_info, input_data_[i].data(), input_data_[i].size(),
+                                                input_dims_[i].data(), input_dims_[i].size(),
+                                                static_cast<ONNXTensorElementDataType>(input_types_[i])));
+      input_names.push_back(input_names_[i].c_str());
+    }
+    std::vector<const char*> output_names;
+    for (const auto& name : output_names_) {
+      output_names.push_back(name.c_str());
+    }
+
+    for (auto _ : state) {
+      auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names.data(), inputs.data(), inputs.size(),
+                                 output_names.data(), output_names.size());
+      benchmark::DoNotOptimize(outputs);
+    }
+  }
+
+ private:
+  static TypeProto_Tensor* AddValueInfo(ValueInfoProto& value_info, const std::string& name,
+                                        TensorProto_DataType type) {
+    value_info.set_name(name);
+    auto* tensor_type = value_info.mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(type);
+    return tensor_type;
+  }
+
+  ModelProto model_;
+  NodeProto* node_;
+  std::vector<std::string> input_names_;
+  std::vector<std::vector<int64_t>> input_dims_;
+  std::vector<TensorProto_DataType> input_types_;
+  std::vector<std::vector<uint8_t>> input_data_;
+  std::vector<std::string> output_names_;
+};
+
+}  // namespace
+
+// M, K, N of BERT-base projections and feed forward layers, and of the ResNet-50 classifier
+static void GemmShapes(benchmark::internal::Benchmark* b) {
+  b->Args({128, 768, 768});
+  b->Args({128, 768, 3072});
+  b->Args({128, 3072, 768});
+  b->Args({1, 768, 768});
+  b->Args({1, 2048, 1000});
+}
+
+static void BM_MatMul(benchmark::State& state) {
+  const int64_t M = state.range(0), K = state.range(1), N = state.range(2);
+  SingleNodeModel("MatMul")
+      .Input("A", TensorProto_DataType_FLOAT, {M, K})
+      .Initializer("B", TensorProto_DataType_FLOAT, {K, N})
+      .Output("Y")
+      .Run(state);
+}
+
+BENCHMARK(BM_MatMul)->Apply(GemmShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_Gemm(benchmark::State& state) {
+  const int64_t M = state.range(0), K = state.range(1), N = state.range(2);
+  SingleNodeModel("Gemm")
+      .Input("A", TensorProto_DataType_FLOAT, {M, K})
+      .Initializer("B", TensorProto_DataType_FLOAT, {K, N})
+      .Initializer("C", TensorProto_DataType_FLOAT, {N})
+      .Output("Y")
+      .Run(state);
+}
+
+BENCHMARK(BM_Gemm)->Apply(GemmShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+// int8 GEMM with an unsigned or signed weight, which MLAS runs with different kernels
+template <bool BIsSigned>
+static void BM_MatMulInteger(benchmark::State& state) {
+  const int64_t M = state.range(0), K = state.range(1), N = state.range(2);
+  const TensorProto_DataType b_type = BIsSigned ? TensorProto_DataType_INT8 : TensorProto_DataType_UINT8;
+  const float b_low = BIsSigned ? -128.0f : 0.0f;
+  SingleNodeModel("MatMulInteger")
+      .Input("A", TensorProto_DataType_UINT8, {M, K}, 0.0f, 256.0f)
+      .Initializer("B", b_type, {K, N}, b_low, b_low + 256.0f)
+      .Initializer("a_zero_point", TensorProto_DataType_UINT8, {}, 128.0f, 129.0f)
+      .Output("Y", TensorProto_DataType_INT32)
+      .Run(state);
+}
+
+BENCHMARK_TEMPLATE(BM_MatMulInteger, true)->Apply(GemmShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MatMulInteger, false)->Apply(GemmShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+// input channels, output channels, input height and width, kernel size, stride of ResNet-50 convolutions
+static void ConvShapes(benchmark::internal::Benchmark* b) {
+  b->Args({3, 64, 224, 7, 2});
+  b->Args({64, 64, 56, 3, 1});
+  b->Args({64, 256, 56, 1, 1});
+  b->Args({256, 64, 56, 1, 1});
+  b->Args({128, 128, 28, 3, 1});
+  b->Args({256, 256, 14, 3, 1});
+  b->Args({512, 512, 7, 3, 1});
+}
+
+static void RunConv(benchmark::State& state, GraphOptimizationLevel optimization_level) {
+  const int64_t input_channels = state.range(0), output_channels = state.range(1), size = state.range(2);
+  const int64_t kernel = state.range(3), stride = state.range(4), pad = kernel / 2;
+  SingleNodeModel("Conv")
+      .Input("X", TensorProto_DataType_FLOAT, {1, input_channels, size, size})
+      .Initializer("W", TensorProto_DataType_FLOAT, {output_channels, input_channels, kernel, kernel})
+      .Initializer("B", TensorProto_DataType_FLOAT, {output_channels})
+      .Output("Y")
+      .Attribute(MakeAttribute("kernel_shape", std::vector<int64_t>{kernel, kernel}))
+      .Attribute(MakeAttribute("strides", std::vector<int64_t>{stride, stride}))
+      .Attribute(MakeAttribute("pads", std::vector<int64_t>{pad, pad, pad, pad}))
+      .Run(state, optimization_level);
+}
+
+// the NCHW convolution, as the NCHWc transformer only runs at the highest optimization level
+static void BM_Conv(benchmark::State& state) {
+  RunConv(state, ORT_ENABLE_EXTENDED);
+}
+
+BENCHMARK(BM_Conv)->Apply(ConvShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+// the NCHWc convolution, including the reorders of the input and output between the NCHW and NCHWc layouts
+static void BM_NchwcConv(benchmark::State& state) {
+  RunConv(state, ORT_ENABLE_ALL);
+}
+
+BENCHMARK(BM_NchwcConv)->Apply(ConvShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_Attention(benchmark::State& state) {
+  const int64_t batch = state.range(0), sequence = state.range(1), hidden = state.range(2);
+  SingleNodeModel("Attention", onnxruntime::kMSDomain)
+      .Input("input", TensorProto_DataType_FLOAT, {batch, sequence, hidden})
+      .Initializer("weight", TensorProto_DataType_FLOAT, {hidden, 3 * hidden})
+      .Initializer("bias", TensorProto_DataType_FLOAT, {3 * hidden})
+      .Output("output")
+      .Attribute(MakeAttribute("num_heads", state.range(3)))
+      .Run(state);
+}
+
+// batch, sequence length, hidden size, heads of BERT-base and BERT-large
+BENCHMARK(BM_Attention)
+    ->Args({1, 128, 768, 12})
+    ->Args({8, 128, 768, 12})
+    ->Args({1, 384, 1024, 16})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_LayerNormalization(benchmark::State& state) {
+  const int64_t rows = state.range(0), hidden = state.range(1);
+  SingleNodeModel("LayerNormalization")
+      .Input("X", TensorProto_DataType_FLOAT, {rows, hidden})
+      .Initializer("scale", TensorProto_DataType_FLOAT, {hidden})
+      .Initializer("B", TensorProto_DataType_FLOAT, {hidden})
+      .Output("Y")
+      .Attribute(MakeAttribute("axis", static_cast<int64_t>(-1)))
+      .Run(state);
+}
+
+BENCHMARK(BM_LayerNormalization)
+    ->Args({128, 768})
+    ->Args({384, 1024})
+    ->Args({4096, 768})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_Softmax(benchmark::State& state) {
+  const int64_t rows = state.range(0), columns = state.range(1);
+  SingleNodeModel("Softmax")
+      .Input("X", TensorProto_DataType_FLOAT, {rows, columns})
+      .Output("Y")
+      .Attribute(MakeAttribute("axis", static_cast<int64_t>(1)))
+      .Run(state);
+}
+
+// the attention probabilities of BERT-base and BERT-large, and a classifier
+BENCHMARK(BM_Softmax)
+    ->Args({12 * 128, 128})
+    ->Args({16 * 384, 384})
+    ->Args({1, 1000})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_Gather(benchmark::State& state) {
+  const int64_t vocabulary = state.range(0), hidden = state.range(1), indices = state.range(2);
+  SingleNodeModel("Gather")
+      .Initializer("data", TensorProto_DataType_FLOAT, {vocabulary, hidden})
+      .Input("indices", TensorProto_DataType_INT64, {indices}, 0.0f, static_cast<float>(vocabulary))
+      .Output("Y")
+      .Run(state);
+}
+
+// word embedding lookups of BERT-base
+BENCHMARK(BM_Gather)
+    ->Args({30522, 768, 128})
+    ->Args({30522, 768, 4096})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void RunTranspose(benchmark::State& state, const std::vector<int64_t>& perm) {
+  SingleNodeModel("Transpose")
+      .Input("X", TensorProto_DataType_FLOAT, {state.range(0), state.range(1), state.range(2), state.range(3)})
+      .Output("Y")
+      .Attribute(MakeAttribute("perm", perm))
+      .Run(state);
+}
+
+// batch, sequence, heads, head size to batch, heads, sequence, head size, as in attention
+static void BM_TransposeHeads(benchmark::State& state) {
+  RunTranspose(state, {0, 2, 1, 3});
+}
+
+BENCHMARK(BM_TransposeHeads)
+    ->Args({1, 128, 12, 64})
+    ->Args({8, 128, 12, 64})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_TransposeNchwToNhwc(benchmark::State& state) {
+  RunTranspose(state, {0, 2, 3, 1});
+}
+
+BENCHMARK(BM_TransposeNchwToNhwc)
+    ->Args({1, 64, 112, 112})
+    ->Args({1, 256, 56, 56})
+    ->Args({1, 2048, 7, 7})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_TopK(benchmark::State& state) {
+  const int64_t rows = state.range(0), columns = state.range(1), k = state.range(2);
+  SingleNodeModel("TopK")
+      .Input("X", TensorProto_DataType_FLOAT, {rows, columns})
+      .Initializer("K", std::vector<int64_t>{k})
+      .Output("Values")
+      .Output("Indices", TensorProto_DataType_INT64)
+      .Run(state);
+}
+
+// the top classes of a classifier, and the next token candidates of a language model
+BENCHMARK(BM_TopK)
+    ->Args({1, 1000, 5})
+    ->Args({64, 30522, 10})
+    ->Args({1, 100000, 100})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_TreeEnsembleRegressor(benchmark::State& state) {
+  const int64_t trees = state.range(0), depth = state.range(1), features = state.range(2), batch = state.range(3);
+
+  // complete binary trees with random splits, the children of node n being 2n+1 and 2n+2
+  const int64_t nodes_per_tree = (int64_t{1} << (depth + 1)) - 1;
+  const int64_t first_leaf = (int64_t{1} << depth) - 1;
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> value_dist(-1.0f, 1.0f);
+  std::uniform_int_distribution<int64_t> feature_dist(0, features - 1);
+
+  std::vector<int64_t> nodes_treeids, nodes_nodeids, nodes_featureids, nodes_truenodeids, nodes_falsenodeids;
+  std::vector<float> nodes_values;
+  std::vector<std::string> nodes_modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_ids;
+  std::vector<float> target_weights;
+  for (int64_t tree = 0; tree != trees; ++tree) {
+    for (int64_t node = 0; node != nodes_per_tree; ++node) {
+      const bool is_leaf = node >= first_leaf;
+      nodes_treeids.push_back(tree);
+      nodes_nodeids.push_back(node);
+      nodes_featureids.push_back(is_leaf ? 0 : feature_dist(gen));
+      nodes_values.push_back(is_leaf ? 0.0f : value_dist(gen));
+      nodes_modes.push_back(is_leaf ? "LEAF" : "BRANCH_LEQ");
+      nodes_truenodeids.push_back(is_leaf ? 0 : 2 * node + 1);
+      nodes_falsenodeids.push_back(is_leaf ? 0 : 2 * node + 2);
+      if (is_leaf) {
+        target_treeids.push_back(tree);
+        target_nodeids.push_back(node);
+        target_ids.push_back(0);
+        target_weights.push_back(value_dist(gen));
+      }
+    }
+  }
+
+  SingleNodeModel("TreeEnsembleRegressor", onnxruntime::kMLDomain)
+      .Input("X", TensorProto_DataType_FLOAT, {batch, features})
+      .Output("Y")
+      .Attribute(MakeAttribute("n_targets", static_cast<int64_t>(1)))
+      .Attribute(MakeAttribute("nodes_treeids", nodes_treeids))
+      .Attribute(MakeAttribute("nodes_nodeids", nodes_nodeids))
+      .Attribute(MakeAttribute("nodes_featureids", nodes_featureids))
+      .Attribute(MakeAttribute("nodes_values", nodes_values))
+      .Attribute(MakeAttribute("nodes_modes", nodes_modes))
+      .Attribute(MakeAttribute("nodes_truenodeids", nodes_truenodeids))
+      .Attribute(MakeAttribute("nodes_falsenodeids", nodes_falsenodeids))
+      .Attribute(MakeAttribute("target_treeids", target_treeids))
+      .Attribute(MakeAttribute("target_nodeids", target_nodeids))
+      .Attribute(MakeAttribute("target_ids", target_ids))
+      .Attribute(MakeAttribute("target_weights", target_weights))
+      .Run(state);
+}
+
+// trees, depth, features, batch
+BENCHMARK(BM_TreeEnsembleRegressor)
+    ->Args({100, 6, 32, 1})
+    ->Args({100, 6, 32, 1000})
+    ->Args({500, 8, 64, 100})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
@@ -18,6 +18,7 @@
 #include "core/optimizer/bias_gelu_fusion.h"
 #include "core/optimizer/computation_reduction.h"
 #include "core/optimizer/cast_elimination.h"
+#include "core/optimizer/common_subexpression_elimination.h"
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
@@ -25,7 +26,9 @@
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/gelu_approximation.h"
@@ -38,12 +41,16 @@
 #include "core/optimizer/layer_norm_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/mixed_precision_transformer.h"
+#include "core/optimizer/nhwc_transformer.h"
+#include "core/optimizer/qdq_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/utils.h"
 #include "core/platform/env.h"
@@ -782,6 +789,30 @@ TEST_F(GraphTransformationTests, Gemm_LeakyRelu_Fusion) {
   ASSERT_TRUE(op_to_count["Gemm"] == 0);
   ASSERT_TRUE(op_to_count["FusedGemm"] == 1);
 }
+
+TEST_F(GraphTransformationTests, Gemm_LeakyRelu_NoFusionOnCuda) {
+  auto model_uri = MODEL_FOLDER "gemm_activation_fusion/gemm_activation_fusion.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, p_model, nullptr, *logger_));
+  Graph& graph = p_model->MainGraph();
+
+  // the CUDA FusedGemm only supports the activations available as cuBLASLt epilogues
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(
+      onnxruntime::make_unique<GemmActivationFusion>(std::unordered_set<std::string>{kCpuExecutionProvider, kCudaExecutionProvider}),
+      TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["LeakyRelu"] == 1);
+  ASSERT_TRUE(op_to_count["Gemm"] == 1);
+  ASSERT_TRUE(op_to_count["FusedGemm"] == 0);
+}
 #endif
 
 TEST_F(GraphTransformationTests, FuseConvBnAddMulFloat16) {
@@ -835,7 +866,7 @@ TEST_F(GraphTransformationTests, FuseConvBnAddMulFloat16) {
   auto& rtensor = fetches.front().Get<Tensor>();
   TensorShape expected_shape(expected_dims_prod);
   //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&expected_shape), *reinterpret_cast<const std::vector<int64_t>*>(&rtensor.Shape()));
+  ASSERT_EQ(expected_shape.GetDims(), rtensor.Shape().GetDims());
   const std::vector<MLFloat16> found(rtensor.template Data<MLFloat16>(),
                                      rtensor.template Data<MLFloat16>() + expected_dims_prod.size());
   ASSERT_EQ(expected_values_prod, found);
@@ -1951,6 +1982,603 @@ TEST_F(GraphTransformationTests, GeluApproximation_Gelu_Add_MatMul) {
   EXPECT_EQ(op_to_count["FastGelu"], 1);
 }
 
+// Test the conversion of MatMul -> Add -> Softmax -> MatMul to float16 with Softmax kept in float.
+TEST_F(GraphTransformationTests, MixedPrecisionTransformer) {
+  Model model("MixedPrecisionTransformer", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  for (const char* name : {"W1", "B", "W2"}) {
+    TensorProto initializer;
+    initializer.set_name(name);
+    initializer.set_data_type(TensorProto_DataType_FLOAT);
+    initializer.add_dims(2);
+    initializer.add_dims(2);
+    for (int i = 0; i < 4; ++i) {
+      initializer.add_float_data(0.5f * i);
+    }
+    graph.AddInitializedTensor(initializer);
+  }
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor_type);
+  auto& w1 = graph.GetOrCreateNodeArg("W1", &float_tensor_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_tensor_type);
+  auto& w2 = graph.GetOrCreateNodeArg("W2", &float_tensor_type);
+  auto& matmul1_out = graph.GetOrCreateNodeArg("matmul1_out", &float_tensor_type);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &float_tensor_type);
+  auto& softmax_out = graph.GetOrCreateNodeArg("softmax_out", &float_tensor_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor_type);
+  graph.AddNode("matmul1", "MatMul", "", {&x, &w1}, {&matmul1_out});
+  graph.AddNode("add", "Add", "", {&matmul1_out, &b}, {&add_out});
+  graph.AddNode("softmax", "Softmax", "", {&add_out}, {&softmax_out});
+  graph.AddNode("matmul2", "MatMul", "", {&softmax_out, &w2}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<MixedPrecisionTransformer>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  // Casts are only needed for the graph input, around Softmax and for the graph output.
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Cast"], 4);
+  EXPECT_EQ(op_to_count["MatMul"], 2);
+  EXPECT_EQ(op_to_count["Add"], 1);
+  EXPECT_EQ(op_to_count["Softmax"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    EXPECT_STREQ(node.GetExecutionProviderType().c_str(), kCudaExecutionProvider);
+    if (node.OpType() == "Cast") {
+      continue;
+    }
+    const std::string expected_type = node.OpType() == "Softmax" ? "tensor(float)" : "tensor(float16)";
+    for (const auto* input : node.InputDefs()) {
+      EXPECT_EQ(*input->Type(), expected_type) << node.Name();
+      if (node.OpType() != "Softmax" && input != node.InputDefs()[0]) {
+        // the weights are converted to float16 initializers
+        EXPECT_NE(graph_utils::GetConstantInitializer(graph, input->Name()), nullptr);
+      }
+    }
+    EXPECT_EQ(*node.OutputDefs()[0]->Type(), expected_type) << node.Name();
+  }
+
+  ASSERT_EQ(graph.GetOutputs().size(), 1u);
+  EXPECT_EQ(graph.GetOutputs()[0]->Name(), "Y");
+  EXPECT_EQ(*graph.GetOutputs()[0]->Type(), "tensor(float)");
+}
+
+// Test that the NCHW -> NHWC Transposes around Relu -> Add cancel, the constant input of Add being transposed by
+// constant folding.
+TEST_F(GraphTransformationTests, TransposeOptimizerCancelsTransposes) {
+  Model model("TransposeOptimizer", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto nchw_type = make_type({1, 2, 3, 4});
+  TypeProto nhwc_type = make_type({1, 3, 4, 2});
+  TypeProto bias_type = make_type({2, 1, 1});
+
+  // per channel bias, broadcast to NCHW
+  TensorProto bias;
+  bias.set_name("B");
+  bias.set_data_type(TensorProto_DataType_FLOAT);
+  bias.add_dims(2);
+  bias.add_dims(1);
+  bias.add_dims(1);
+  bias.add_float_data(1.f);
+  bias.add_float_data(2.f);
+  graph.AddInitializedTensor(bias);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &nhwc_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &bias_type);
+  auto& transpose1_out = graph.GetOrCreateNodeArg("transpose1_out", &nchw_type);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &nchw_type);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &nchw_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &nhwc_type);
+
+  graph.AddNode("transpose1", "Transpose", "", {&x}, {&transpose1_out})
+      .AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  graph.AddNode("relu", "Relu", "", {&transpose1_out}, {&relu_out});
+  graph.AddNode("add", "Add", "", {&relu_out, &b}, {&add_out});
+  graph.AddNode("transpose2", "Transpose", "", {&add_out}, {&y})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<TransposeOptimizer>(), TransformerLevel::Level1);
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 0);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  EXPECT_EQ(op_to_count["Add"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Relu") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "X");
+    }
+  }
+  ASSERT_EQ(graph.GetOutputs().size(), 1u);
+  EXPECT_EQ(graph.GetOutputs()[0]->Name(), "Y");
+}
+
+// Test that Transposes with different perms aren't cancelled.
+TEST_F(GraphTransformationTests, TransposeOptimizerKeepsDifferentPerms) {
+  Model model("TransposeOptimizer", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : {2, 3, 4}) {
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& transpose1_out = graph.GetOrCreateNodeArg("transpose1_out", nullptr);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("transpose1", "Transpose", "", {&x}, {&transpose1_out})
+      .AddAttribute("perm", std::vector<int64_t>{1, 0, 2});
+  graph.AddNode("relu", "Relu", "", {&transpose1_out}, {&relu_out});
+  graph.AddNode("transpose2", "Transpose", "", {&relu_out}, {&y})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 1});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<TransposeOptimizer>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  // the Transposes are merged into one below Relu
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 1);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Transpose") {
+      EXPECT_EQ(RetrieveValues<int64_t>(node.GetAttributes().at("perm")), (std::vector<int64_t>{1, 2, 0}));
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y");
+    }
+  }
+}
+
+static void AddQDQInitializer(Graph& graph, const char* name, TensorProto_DataType data_type,
+                              const std::vector<int64_t>& dims, const std::string& raw_data) {
+  TensorProto initializer;
+  initializer.set_name(name);
+  initializer.set_data_type(data_type);
+  for (auto dim : dims) {
+    initializer.add_dims(dim);
+  }
+  initializer.set_raw_data(raw_data);
+  graph.AddInitializedTensor(initializer);
+}
+
+static std::string ToRawData(const std::vector<float>& values) {
+  return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+}
+
+// Test the fusion of DequantizeLinear -> MatMul -> QuantizeLinear into QLinearMatMul, with the DequantizeLinear of
+// the constant weight kept by constant folding.
+TEST_F(GraphTransformationTests, QDQFusionMatMul) {
+  Model model("QDQFusion", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto uint8_type;
+  uint8_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  uint8_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  uint8_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto scalar_float_type(float_type);
+  scalar_float_type.mutable_tensor_type()->mutable_shape();
+  TypeProto scalar_uint8_type;
+  scalar_uint8_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  scalar_uint8_type.mutable_tensor_type()->mutable_shape();
+
+  AddQDQInitializer(graph, "W", TensorProto_DataType_UINT8, {2, 2}, std::string("\x01\x02\x03\x04", 4));
+  AddQDQInitializer(graph, "scale", TensorProto_DataType_FLOAT, {}, ToRawData({0.5f}));
+  AddQDQInitializer(graph, "zero_point", TensorProto_DataType_UINT8, {}, std::string(1, '\x80'));
+
+  auto& x = graph.GetOrCreateNodeArg("X", &uint8_type);
+  auto& w = graph.GetOrCreateNodeArg("W", &uint8_type);
+  auto& scale = graph.GetOrCreateNodeArg("scale", &scalar_float_type);
+  auto& zero_point = graph.GetOrCreateNodeArg("zero_point", &scalar_uint8_type);
+  auto& x_dq = graph.GetOrCreateNodeArg("x_dq", &float_type);
+  auto& w_dq = graph.GetOrCreateNodeArg("w_dq", &float_type);
+  auto& matmul_out = graph.GetOrCreateNodeArg("matmul_out", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &uint8_type);
+  graph.AddNode("x_dq", "DequantizeLinear", "", {&x, &scale, &zero_point}, {&x_dq});
+  graph.AddNode("w_dq", "DequantizeLinear", "", {&w, &scale}, {&w_dq});
+  graph.AddNode("matmul", "MatMul", "", {&x_dq, &w_dq}, {&matmul_out});
+  graph.AddNode("q", "QuantizeLinear", "", {&matmul_out, &scale, &zero_point}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 2);
+
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["MatMul"], 0);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 0);
+  ASSERT_EQ(op_to_count["QLinearMatMul"], 1);
+
+  const Node& fused_node = *graph.Nodes().begin();
+  ASSERT_EQ(fused_node.InputDefs().size(), 8u);
+  EXPECT_EQ(fused_node.InputDefs()[0]->Name(), "X");
+  EXPECT_EQ(fused_node.InputDefs()[3]->Name(), "W");
+  // the missing zero point of W is added as an initializer of 0
+  const TensorProto* w_zero_point = graph_utils::GetConstantInitializer(graph, fused_node.InputDefs()[5]->Name());
+  ASSERT_NE(w_zero_point, nullptr);
+  EXPECT_EQ(w_zero_point->raw_data(), std::string(1, '\0'));
+  EXPECT_EQ(fused_node.OutputDefs()[0]->Name(), "Y");
+}
+
+// Test the fusion into QLinearConv, quantizing the float bias with the scale X_scale * W_scale.
+TEST_F(GraphTransformationTests, QDQFusionConvWithBias) {
+  Model model("QDQFusion", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto uint8_type;
+  uint8_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  AddQDQInitializer(graph, "W", TensorProto_DataType_UINT8, {2, 1, 1, 1}, std::string("\x01\x02", 2));
+  AddQDQInitializer(graph, "B", TensorProto_DataType_FLOAT, {2}, ToRawData({1.f, -2.f}));
+  AddQDQInitializer(graph, "x_scale", TensorProto_DataType_FLOAT, {}, ToRawData({0.5f}));
+  AddQDQInitializer(graph, "w_scale", TensorProto_DataType_FLOAT, {}, ToRawData({0.25f}));
+
+  auto& x = graph.GetOrCreateNodeArg("X", &uint8_type);
+  auto& w = graph.GetOrCreateNodeArg("W", &uint8_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_type);
+  auto& x_scale = graph.GetOrCreateNodeArg("x_scale", &float_type);
+  auto& w_scale = graph.GetOrCreateNodeArg("w_scale", &float_type);
+  auto& x_dq = graph.GetOrCreateNodeArg("x_dq", &float_type);
+  auto& w_dq = graph.GetOrCreateNodeArg("w_dq", &float_type);
+  auto& conv_out = graph.GetOrCreateNodeArg("conv_out", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &uint8_type);
+  graph.AddNode("x_dq", "DequantizeLinear", "", {&x, &x_scale}, {&x_dq});
+  graph.AddNode("w_dq", "DequantizeLinear", "", {&w, &w_scale}, {&w_dq});
+  graph.AddNode("conv", "Conv", "", {&x_dq, &w_dq, &b}, {&conv_out});
+  graph.AddNode("q", "QuantizeLinear", "", {&conv_out, &x_scale}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Conv"], 0);
+  ASSERT_EQ(op_to_count["QLinearConv"], 1);
+
+  const Node& fused_node = *graph.Nodes().begin();
+  ASSERT_EQ(fused_node.InputDefs().size(), 9u);
+  const TensorProto* bias = graph_utils::GetConstantInitializer(graph, fused_node.InputDefs()[8]->Name());
+  ASSERT_NE(bias, nullptr);
+  ASSERT_EQ(bias->data_type(), TensorProto_DataType_INT32);
+  std::vector<int32_t> expected_bias{8, -16};
+  EXPECT_EQ(bias->raw_data(), std::string(reinterpret_cast<const char*>(expected_bias.data()),
+                                          expected_bias.size() * sizeof(int32_t)));
+}
+
+// Test the fusion of Gather -> ReduceMean over the bags, and that a ReduceSum keeping the bag dim is not fused.
+TEST_F(GraphTransformationTests, EmbeddingBagFusion) {
+  Model model("EmbeddingBagFusion", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](TensorProto_DataType elem_type, std::vector<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(elem_type);
+    for (int64_t dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto table_type = make_type(TensorProto_DataType_FLOAT, {100, 16});
+  TypeProto indices_type = make_type(TensorProto_DataType_INT64, {8, 5});
+  TypeProto gathered_type = make_type(TensorProto_DataType_FLOAT, {8, 5, 16});
+  TypeProto output_type = make_type(TensorProto_DataType_FLOAT, {8, 16});
+  TypeProto kept_output_type = make_type(TensorProto_DataType_FLOAT, {8, 1, 16});
+
+  auto& table = graph.GetOrCreateNodeArg("table", &table_type);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &indices_type);
+  auto& gathered_0 = graph.GetOrCreateNodeArg("gathered_0", &gathered_type);
+  auto& gathered_1 = graph.GetOrCreateNodeArg("gathered_1", &gathered_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &output_type);
+  auto& y_kept = graph.GetOrCreateNodeArg("Y_kept", &kept_output_type);
+  graph.AddNode("gather_0", "Gather", "", {&table, &indices}, {&gathered_0});
+  auto& mean = graph.AddNode("mean", "ReduceMean", "", {&gathered_0}, {&y});
+  mean.AddAttribute("axes", std::vector<int64_t>{1});
+  mean.AddAttribute("keepdims", static_cast<int64_t>(0));
+  graph.AddNode("gather_1", "Gather", "", {&table, &indices}, {&gathered_1});
+  auto& sum = graph.AddNode("sum", "ReduceSum", "", {&gathered_1}, {&y_kept});
+  sum.AddAttribute("axes", std::vector<int64_t>{1});
+  sum.AddAttribute("keepdims", static_cast<int64_t>(1));
+  graph.SetOutputs({&y, &y_kept});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<EmbeddingBagFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Gather"], 1);
+  EXPECT_EQ(op_to_count["ReduceMean"], 0);
+  EXPECT_EQ(op_to_count["ReduceSum"], 1);
+  ASSERT_EQ(op_to_count["EmbeddingBag"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "EmbeddingBag") {
+      EXPECT_EQ(node.GetAttributes().at("mode").s(), "mean");
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "table");
+      EXPECT_EQ(node.InputDefs()[1]->Name(), "indices");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y");
+    }
+  }
+}
+
+// Test the fusion of the chains Add -> Mul and Sqrt -> Tanh, which share the input X.
+TEST_F(GraphTransformationTests, ElementwiseFusion) {
+  Model model("ElementwiseFusion", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_type);
+  auto& s = graph.GetOrCreateNodeArg("S", &float_type);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &float_type);
+  auto& mul_out = graph.GetOrCreateNodeArg("mul_out", &float_type);
+  auto& sqrt_out = graph.GetOrCreateNodeArg("sqrt_out", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+  graph.AddNode("add", "Add", "", {&x, &b}, {&add_out});
+  graph.AddNode("mul", "Mul", "", {&add_out, &s}, {&mul_out});
+  graph.AddNode("sqrt", "Sqrt", "", {&x}, {&sqrt_out});
+  graph.AddNode("tanh", "Tanh", "", {&sqrt_out}, {&y});
+  graph.SetOutputs({&mul_out, &y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ElementwiseFusion>(), TransformerLevel::Level3);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level3, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  EXPECT_EQ(op_to_count["Sqrt"], 0);
+  EXPECT_EQ(op_to_count["Tanh"], 0);
+  ASSERT_EQ(op_to_count["FusedElementwise"], 2);
+
+  for (const Node& node : graph.Nodes()) {
+    const auto& attrs = node.GetAttributes();
+    if (node.OutputDefs()[0]->Name() == "mul_out") {
+      ASSERT_EQ(node.InputDefs().size(), 3u);
+      EXPECT_EQ(attrs.at("ops").strings_size(), 2);
+      EXPECT_EQ(attrs.at("ops").strings(1), "Mul");
+      // Mul(step 0, S)
+      EXPECT_EQ(attrs.at("operands").ints(2), 3);
+      EXPECT_EQ(attrs.at("operands").ints(3), 2);
+    } else {
+      ASSERT_EQ(node.InputDefs().size(), 1u);
+      EXPECT_EQ(attrs.at("ops").strings(0), "Sqrt");
+      EXPECT_EQ(attrs.at("ops").strings(1), "Tanh");
+    }
+  }
+}
+
+// Test the conversion of Conv -> Relu -> MaxPool to NHWC, with Transposes only for the graph input and output.
+TEST_F(GraphTransformationTests, NhwcTransformer) {
+  Model model("NhwcTransformer", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  for (int64_t dim : {1, 8, 4, 4}) {
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+
+  TensorProto weights;
+  weights.set_name("W");
+  weights.set_data_type(TensorProto_DataType_FLOAT16);
+  for (int64_t dim : {8, 8, 3, 3}) {
+    weights.add_dims(dim);
+  }
+  std::vector<MLFloat16> weights_data(8 * 8 * 3 * 3);
+  for (size_t i = 0; i < weights_data.size(); ++i) {
+    weights_data[i] = MLFloat16(math::floatToHalf(0.01f * i));
+  }
+  weights.set_raw_data(weights_data.data(), weights_data.size() * sizeof(MLFloat16));
+  graph.AddInitializedTensor(weights);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &input_type);
+  auto& w = graph.GetOrCreateNodeArg("W", nullptr);
+  auto& conv_out = graph.GetOrCreateNodeArg("conv_out", nullptr);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& conv = graph.AddNode("conv", "Conv", "", {&x, &w}, {&conv_out});
+  conv.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  graph.AddNode("relu", "Relu", "", {&conv_out}, {&relu_out});
+  auto& pool = graph.AddNode("pool", "MaxPool", "", {&relu_out}, {&y});
+  pool.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  pool.AddAttribute("strides", std::vector<int64_t>{2, 2});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+  }
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<NhwcTransformer>(), TransformerLevel::Level3);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level3, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Conv"], 1);
+  EXPECT_EQ(op_to_count["MaxPool"], 1);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  EXPECT_EQ(op_to_count["Transpose"], 2);
+
+  for (auto& node : graph.Nodes()) {
+    EXPECT_STREQ(node.GetExecutionProviderType().c_str(), kCudaExecutionProvider);
+    if (node.OpType() == "Conv" || node.OpType() == "MaxPool") {
+      EXPECT_EQ(node.Domain(), kMSNhwcDomain);
+    }
+    if (node.OpType() == "Conv") {
+      // the weights are transposed to OHWI
+      const auto* nhwc_weights = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+      ASSERT_NE(nhwc_weights, nullptr);
+      EXPECT_EQ(std::vector<int64_t>(nhwc_weights->dims().begin(), nhwc_weights->dims().end()),
+                std::vector<int64_t>({8, 3, 3, 8}));
+    } else if (node.OpType() == "Transpose" && node.OutputDefs()[0]->Name() == "Y") {
+      EXPECT_EQ(node.InputDefs()[0]->Shape()->dim(3).dim_value(), 8);
+    }
+  }
+
+  ASSERT_EQ(graph.GetOutputs().size(), 1u);
+  EXPECT_EQ(graph.GetOutputs()[0]->Name(), "Y");
+}
+
+// Test the merge of two Shape -> Gather chains computing the same value, while the RandomUniformLike nodes with the
+// same input are kept.
+TEST_F(GraphTransformationTests, CommonSubexpressionElimination) {
+  Model model("CommonSubexpressionElimination", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto int64_type;
+  int64_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+
+  TensorProto index;
+  index.set_name("index");
+  index.set_data_type(TensorProto_DataType_INT64);
+  index.add_int64_data(0);
+  graph.AddInitializedTensor(index);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& index_arg = graph.GetOrCreateNodeArg("index", &int64_type);
+  std::vector<NodeArg*> gather_outputs;
+  for (int i = 0; i < 2; ++i) {
+    const std::string suffix = std::to_string(i);
+    auto& shape_out = graph.GetOrCreateNodeArg("shape_out" + suffix, &int64_type);
+    auto& gather_out = graph.GetOrCreateNodeArg("gather_out" + suffix, &int64_type);
+    auto& random_out = graph.GetOrCreateNodeArg("random_out" + suffix, &float_type);
+    graph.AddNode("shape" + suffix, "Shape", "", {&x}, {&shape_out});
+    graph.AddNode("gather" + suffix, "Gather", "", {&shape_out, &index_arg}, {&gather_out});
+    graph.AddNode("random" + suffix, "RandomUniformLike", "", {&x}, {&random_out});
+    gather_outputs.push_back(&gather_out);
+  }
+  auto& y = graph.GetOrCreateNodeArg("Y", &int64_type);
+  graph.AddNode("add", "Add", "", {gather_outputs[0], gather_outputs[1]}, {&y});
+  graph.SetOutputs({&y, graph.GetNodeArg("random_out0"), graph.GetNodeArg("random_out1")});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<CommonSubexpressionElimination>(),
+                                    TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Shape"], 1);
+  EXPECT_EQ(op_to_count["Gather"], 1);
+  EXPECT_EQ(op_to_count["RandomUniformLike"], 2);
+  ASSERT_EQ(op_to_count["Add"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Add") {
+      EXPECT_EQ(node.InputDefs()[0], node.InputDefs()[1]);
+    }
+  }
+}
+
+TEST_F(GraphTransformationTests, ConstantFoldingSizeLimit) {
+  auto test_case = [&](float max_output_size_ratio, int expected_expand_count) {
+    Model model("ConstantFoldingSizeLimit", false, *logger_);
+    auto& graph = model.MainGraph();
+
+    TypeProto float_type;
+    float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    TypeProto int64_type;
+    int64_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+
+    TensorProto value;
+    value.set_name("value");
+    value.set_data_type(TensorProto_DataType_FLOAT);
+    value.add_dims(1);
+    value.add_float_data(1.f);
+    graph.AddInitializedTensor(value);
+
+    TensorProto shape;
+    shape.set_name("shape");
+    shape.set_data_type(TensorProto_DataType_INT64);
+    shape.add_dims(2);
+    shape.add_int64_data(256);
+    shape.add_int64_data(256);
+    graph.AddInitializedTensor(shape);
+
+    // Expand turns the 4 byte value into a 256KB tensor, while the Neg of the value is computed independently.
+    auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+    auto& expand_out = graph.GetOrCreateNodeArg("expand_out", &float_type);
+    auto& neg_out = graph.GetOrCreateNodeArg("neg_out", &float_type);
+    auto& add_out = graph.GetOrCreateNodeArg("add_out", &float_type);
+    auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+    graph.AddNode("expand", "Expand", "",
+                  {graph.GetNodeArg("value"), graph.GetNodeArg("shape")}, {&expand_out});
+    graph.AddNode("neg", "Neg", "", {graph.GetNodeArg("value")}, {&neg_out});
+    graph.AddNode("add", "Add", "", {&x, &expand_out}, {&add_out});
+    graph.AddNode("mul", "Mul", "", {&add_out, &neg_out}, {&y});
+    graph.SetOutputs({&y});
+    ASSERT_STATUS_OK(graph.Resolve());
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(
+        onnxruntime::make_unique<ConstantFolding>(std::unordered_set<std::string>{}, std::unordered_set<std::string>{},
+                                                  max_output_size_ratio),
+        TransformerLevel::Level1);
+    ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_to_count["Expand"], expected_expand_count);
+    EXPECT_EQ(op_to_count["Neg"], 0);
+  };
+
+  // the Expand is only folded if the size check is disabled
+  test_case(ConstantFolding::kDefaultMaxOutputSizeRatio, 1);
+  test_case(0.f, 0);
+}
+
 TEST_F(GraphTransformationTests, FastGeluFusionTest) {
   auto model_uri = MODEL_FOLDER "fusion/fast_gelu.onnx";
   std::shared_ptr<Model> p_model;
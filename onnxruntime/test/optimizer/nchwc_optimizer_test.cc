@@ -656,6 +656,53 @@ TEST(NchwcOptimizerTests, FusedConvAddFusion) {
   test_case(true, true, 1);
 }
 
+TEST(NchwcOptimizerTests, PoolAddFusion) {
+  auto test_case = [&](const std::string& pool_op_type, bool do_relu) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 32, 28, 28});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* pool_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv1_output_arg, {32, 32, 3, 3});
+      helper.AddConvNode(input_arg, conv2_output_arg, {32, 32, 3, 3});
+
+      auto& pool_node = helper.AddNode(pool_op_type, {conv1_output_arg}, {pool_output_arg});
+      pool_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      pool_node.AddAttribute("kernel_shape", std::vector<int64_t>{3, 3});
+
+      if (do_relu) {
+        auto* add_output_arg = helper.MakeIntermediate();
+        helper.AddNode("Add", {pool_output_arg, conv2_output_arg}, {add_output_arg});
+        helper.AddNode("Relu", {add_output_arg}, {output_arg});
+      } else {
+        helper.AddNode("Add", {pool_output_arg, conv2_output_arg}, {output_arg});
+      }
+    };
+
+    auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["nchwc." + pool_op_type], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count["Add"], 0);
+      EXPECT_EQ(op_to_count["Relu"], 0);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Verify that the Add of a residual connection can be fused into a preceding
+  // NCHWc pooling node, with an optional Relu node following.
+  std::vector<std::string> pool_op_types{"MaxPool", "AveragePool"};
+  for (auto& pool_op_type : pool_op_types) {
+    test_case(pool_op_type, false);
+    test_case(pool_op_type, true);
+  }
+}
+
 TEST(NchwcOptimizerTests, ConvBinary) {
   auto test_case = [&](const std::string& op_type) {
     auto build_test_case = [&](NchwcTestHelper& helper) {
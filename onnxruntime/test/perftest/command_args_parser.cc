@@ -4,7 +4,9 @@
 #include "command_args_parser.h"
 
 #include <string.h>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 // Windows Specific
 #ifdef _WIN32
@@ -26,6 +28,7 @@ namespace perftest {
 /*static*/ void CommandLineParser::ShowUsage() {
   printf(
       "perf_test [options...] model_path [result_file]\n"
+      "perf_test [options...] -L load_config_file [result_file]\n"
       "Options:\n"
       "\t-m [test_mode]: Specifies the test mode. Value could be 'duration' or 'times'.\n"
       "\t\tProvide 'duration' to run the test for a fix duration, and 'times' to repeated for a certain times. \n"
@@ -33,6 +36,15 @@ namespace perftest {
       "\t-A: Disable memory arena\n"
       "\t-I: Generate tensor input binding (Free dimensions are treated as 1.)\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
+      "\t-W [warmup_times]: Specifies the number of runs before the measured ones, which are excluded from the results. "
+      "Default:1.\n"
+      "\t-q [requests_per_second]: Sends requests at a fixed rate instead of back to back, with up to [parallel runs] "
+      "of them running at a time. The latency of a request includes the time it waited to start.\n"
+      "\t-j [json_file]: Writes the summary of the results (throughput, latency percentiles) to a JSON file.\n"
+      "\t-L [load_config_file]: Runs the models listed in the file at the same time, and reports the throughput and\n"
+      "\t\tlatency of each model and of all of them. Each line of the file is 'model_path [parallel_runs]\n"
+      "\t\t[requests_per_second]'; the options given on the command line are the defaults of each model.\n"
+      "\t-G: Share the thread pools of the environment between the sessions instead of one set per session.\n"
       "\t-e [cpu|cuda|dnnl|tensorrt|ngraph|openvino|nuphar|dml|acl]: Specifies the provider 'cpu','cuda','dnnl','tensorrt', "
       "'ngraph', 'openvino', 'nuphar', 'dml' or 'acl'. "
       "Default:'cpu'.\n"
@@ -53,7 +65,7 @@ namespace perftest {
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:o:u:AMPIvhs"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:o:u:W:q:j:L:AMPIGvhs"))) != -1) {
     switch (ch) {
       case 'm':
         if (!CompareCString(optarg, ORT_TSTR("duration"))) {
@@ -113,7 +125,7 @@ namespace perftest {
         break;
       case 't':
         test_config.run_config.duration_in_seconds = static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
-        if (test_config.run_config.repeated_times <= 0) {
+        if (test_config.run_config.duration_in_seconds <= 0) {
           return false;
         }
         test_config.run_config.test_mode = TestMode::kFixDurationMode;
@@ -174,6 +186,29 @@ namespace perftest {
       case 'u':
         test_config.run_config.optimized_model_path = optarg;
         break;
+      case 'W': {
+        const long warmup_times = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (warmup_times < 0) {
+          return false;
+        }
+        test_config.run_config.warmup_times = static_cast<size_t>(warmup_times);
+        break;
+      }
+      case 'q':
+        test_config.run_config.target_qps = std::stod(ToMBString(optarg));
+        if (test_config.run_config.target_qps <= 0) {
+          return false;
+        }
+        break;
+      case 'j':
+        test_config.run_config.json_result_file = optarg;
+        break;
+      case 'L':
+        test_config.run_config.load_config_file = optarg;
+        break;
+      case 'G':
+        test_config.run_config.use_global_thread_pools = true;
+        break;
       case 'I':
         test_config.run_config.generate_model_input_binding = true;
         break;
@@ -188,6 +223,21 @@ namespace perftest {
   argc -= optind;
   argv += optind;
 
+  // the models of a load test come from its config file
+  if (!test_config.run_config.load_config_file.empty()) {
+    switch (argc) {
+      case 1:
+        test_config.model_info.result_file_path = argv[0];
+        break;
+      case 0:
+        test_config.run_config.f_dump_statistics = true;
+        break;
+      default:
+        return false;
+    }
+    return true;
+  }
+
   switch (argc) {
     case 2:
       test_config.model_info.result_file_path = argv[1];
@@ -204,5 +254,49 @@ namespace perftest {
   return true;
 }
 
+/*static*/ bool CommandLineParser::ParseLoadConfig(const PerformanceTestConfig& test_config,
+                                                   std::vector<PerformanceTestConfig>& model_configs) {
+  std::basic_ifstream<ORTCHAR_T> config_file(test_config.run_config.load_config_file);
+  if (!config_file.good()) {
+    std::cerr << "failed to open load config file '" << ToMBString(test_config.run_config.load_config_file)
+              << "'\n";
+    return false;
+  }
+
+  std::basic_string<ORTCHAR_T> line;
+  while (std::getline(config_file, line)) {
+    std::basic_istringstream<ORTCHAR_T> fields(line);
+    std::basic_string<ORTCHAR_T> model_path;
+    // skip empty lines and comments
+    if (!(fields >> model_path) || model_path[0] == ORT_TSTR('#')) {
+      continue;
+    }
+
+    auto has_field = [&fields]() { return !fields.eof() && !(fields >> std::ws).eof(); };
+
+    PerformanceTestConfig model_config = test_config;
+    model_config.model_info.model_file_path = model_path;
+    // the optional fields override the options from the command line
+    if (has_field()) {
+      fields >> model_config.run_config.concurrent_session_runs;
+    }
+    if (has_field()) {
+      fields >> model_config.run_config.target_qps;
+    }
+    if (fields.fail() || model_config.run_config.concurrent_session_runs == 0 ||
+        model_config.run_config.target_qps < 0) {
+      std::cerr << "invalid line in load config file: '" << ToMBString(line) << "'\n";
+      return false;
+    }
+    model_configs.push_back(std::move(model_config));
+  }
+
+  if (model_configs.empty()) {
+    std::cerr << "no models in load config file '" << ToMBString(test_config.run_config.load_config_file) << "'\n";
+    return false;
+  }
+  return true;
+}
+
 }  // namespace perftest
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <vector>
 #include <core/session/onnxruntime_c_api.h>
 
 namespace onnxruntime {
@@ -13,6 +14,9 @@ class CommandLineParser {
  public:
   static void ShowUsage();
   static bool ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]);
+  // Creates the configuration of each model of the load test in test_config.run_config.load_config_file.
+  static bool ParseLoadConfig(const PerformanceTestConfig& test_config,
+                              std::vector<PerformanceTestConfig>& model_configs);
 };
 
 }  // namespace perftest
@@ -6,6 +6,7 @@
 #include <random>
 #include "command_args_parser.h"
 #include "performance_runner.h"
+#include "core/util/thread_utils.h"
 #include <google/protobuf/stubs/common.h>
 
 using namespace onnxruntime;
@@ -27,7 +28,15 @@ int real_main(int argc, char* argv[]) {
     OrtLoggingLevel logging_level = test_config.run_config.f_verbose
                                         ? ORT_LOGGING_LEVEL_VERBOSE
                                         : ORT_LOGGING_LEVEL_WARNING;
-    env = Ort::Env(logging_level, "Default");
+    if (test_config.run_config.use_global_thread_pools) {
+      // the thread pools shared by the sessions, sized like those of a session
+      OrtThreadingOptions threading_options;
+      threading_options.intra_op_thread_pool_params.thread_pool_size = test_config.run_config.intra_op_num_threads;
+      threading_options.inter_op_thread_pool_params.thread_pool_size = test_config.run_config.inter_op_num_threads;
+      env = Ort::Env(&threading_options, logging_level, "Default");
+    } else {
+      env = Ort::Env(logging_level, "Default");
+    }
   } catch (const Ort::Exception& e) {
     fprintf(stderr, "Error creating environment: %s \n", e.what());
     return -1;
@@ -43,6 +52,19 @@ int real_main(int argc, char* argv[]) {
     }
   }
   std::random_device rd;
+  if (!test_config.run_config.load_config_file.empty()) {
+    std::vector<perftest::PerformanceTestConfig> model_configs;
+    if (!perftest::CommandLineParser::ParseLoadConfig(test_config, model_configs)) {
+      return -1;
+    }
+    auto status = perftest::RunLoadTest(env, model_configs, test_config, rd);
+    if (!status.IsOK()) {
+      printf("Run failed:%s\n", status.ErrorMessage().c_str());
+      return -1;
+    }
+    return 0;
+  }
+
   perftest::PerformanceRunner perf_runner(env, test_config, rd);
   auto status = perf_runner.Run();
   if (!status.IsOK()) {
@@ -50,6 +72,7 @@ int real_main(int argc, char* argv[]) {
     return -1;
   }
 
+  perf_runner.PrintSummary();
   perf_runner.SerializeResult();
 
   return 0;
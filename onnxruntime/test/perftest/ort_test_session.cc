@@ -127,6 +127,10 @@ OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device
     session_options.SetInterOpNumThreads(performance_test_config.run_config.inter_op_num_threads);
   }
 
+  if (performance_test_config.run_config.use_global_thread_pools) {
+    session_options.DisablePerSessionThreads();
+  }
+
   // Set optimization level.
   session_options.SetGraphOptimizationLevel(performance_test_config.run_config.optimization_level);
   if (!performance_test_config.run_config.profile_file.empty())
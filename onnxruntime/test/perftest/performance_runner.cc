@@ -8,6 +8,7 @@
 
 #include "performance_runner.h"
 #include <iostream>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
@@ -29,19 +30,29 @@ using onnxruntime::Status;
 #pragma GCC diagnostic pop
 #endif
 using DefaultThreadPoolType = Eigen::ThreadPool;
-static std::unique_ptr<DefaultThreadPoolType> default_pool;
-static std::once_flag default_pool_init;
-Eigen::ThreadPoolInterface* GetDefaultThreadPool(const onnxruntime::Env& env) {
-  std::call_once(default_pool_init, [&env] {
-    int core_num = env.GetNumCpuCores();
-    default_pool.reset(new DefaultThreadPoolType(core_num));
-  });
-  return default_pool.get();
-}
 
 namespace onnxruntime {
 namespace perftest {
 
+PerformanceResult::LatencyStats PerformanceResult::GetLatencyStats() const {
+  std::vector<double> sorted_time = time_costs;
+  std::sort(sorted_time.begin(), sorted_time.end());
+
+  const size_t total = sorted_time.size();
+  auto percentile = [&](double fraction) { return sorted_time[static_cast<size_t>(total * fraction)]; };
+
+  LatencyStats stats;
+  stats.min = sorted_time[0];
+  stats.max = sorted_time[total - 1];
+  stats.average = total_time_cost / total;
+  stats.p50 = percentile(0.5);
+  stats.p90 = percentile(0.9);
+  stats.p95 = percentile(0.95);
+  stats.p99 = percentile(0.99);
+  stats.p999 = percentile(0.999);
+  return stats;
+}
+
 void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics) const {
   bool have_file = !path.empty();
   std::ofstream outfile;
@@ -69,25 +80,16 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 
   if (!time_costs.empty() && f_include_statistics) {
-    std::vector<double> sorted_time = time_costs;
-
-    size_t total = sorted_time.size();
-    size_t n50 = static_cast<size_t>(total * 0.5);
-    size_t n90 = static_cast<size_t>(total * 0.9);
-    size_t n95 = static_cast<size_t>(total * 0.95);
-    size_t n99 = static_cast<size_t>(total * 0.99);
-    size_t n999 = static_cast<size_t>(total * 0.999);
-
-    std::sort(sorted_time.begin(), sorted_time.end());
+    const LatencyStats stats = GetLatencyStats();
 
     auto output_stats = [&](std::ostream& ostream) {
-      ostream << "Min Latency: " << sorted_time[0] << " s\n";
-      ostream << "Max Latency: " << sorted_time[total - 1] << " s\n";
-      ostream << "P50 Latency: " << sorted_time[n50] << " s\n";
-      ostream << "P90 Latency: " << sorted_time[n90] << " s\n";
-      ostream << "P95 Latency: " << sorted_time[n95] << " s\n";
-      ostream << "P99 Latency: " << sorted_time[n99] << " s\n";
-      ostream << "P999 Latency: " << sorted_time[n999] << " s" << std::endl;
+      ostream << "Min Latency: " << stats.min << " s\n";
+      ostream << "Max Latency: " << stats.max << " s\n";
+      ostream << "P50 Latency: " << stats.p50 << " s\n";
+      ostream << "P90 Latency: " << stats.p90 << " s\n";
+      ostream << "P95 Latency: " << stats.p95 << " s\n";
+      ostream << "P99 Latency: " << stats.p99 << " s\n";
+      ostream << "P999 Latency: " << stats.p999 << " s" << std::endl;
     };
 
     if (have_file) {
@@ -99,37 +101,99 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 }
 
+void PerformanceResult::DumpToJson(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const {
+  std::ofstream outfile(path, std::ofstream::out | std::ofstream::trunc);
+  if (!outfile.good()) {
+    std::cerr << "failed to open JSON result file '" << ToMBString(path) << "'.\n";
+    return;
+  }
+
+  WriteJson(outfile, run_config);
+  outfile << std::endl;
+}
+
+void PerformanceResult::WriteJson(std::ostream& ostream, const RunConfig& run_config, const std::string& indent) const {
+  std::string escaped_model_name;
+  for (char c : model_name) {
+    if (c == '"' || c == '\\') {
+      escaped_model_name += '\\';
+    }
+    escaped_model_name += c;
+  }
+
+  const std::chrono::duration<double> run_time = end - start;
+  const double throughput = run_time.count() > 0 ? time_costs.size() / run_time.count() : 0.0;
+  const char* test_mode = run_config.test_mode == TestMode::kFixDurationMode ? "duration" : "times";
+  const LatencyStats stats = time_costs.empty() ? LatencyStats() : GetLatencyStats();
+  // latencies in milliseconds
+  auto ms = [](double seconds) { return seconds * 1000; };
+
+  ostream << "{\n"
+          << indent << "  \"model_name\": \"" << escaped_model_name << "\",\n"
+          << indent << "  \"test_mode\": \"" << test_mode << "\",\n"
+          << indent << "  \"concurrent_session_runs\": " << run_config.concurrent_session_runs << ",\n"
+          << indent << "  \"target_qps\": " << run_config.target_qps << ",\n"
+          << indent << "  \"warmup_runs\": " << run_config.warmup_times << ",\n"
+          << indent << "  \"requests\": " << time_costs.size() << ",\n"
+          << indent << "  \"run_time_s\": " << run_time.count() << ",\n"
+          << indent << "  \"throughput_qps\": " << throughput << ",\n"
+          << indent << "  \"latency_ms\": {\n"
+          << indent << "    \"average\": " << ms(stats.average) << ",\n"
+          << indent << "    \"min\": " << ms(stats.min) << ",\n"
+          << indent << "    \"max\": " << ms(stats.max) << ",\n"
+          << indent << "    \"p50\": " << ms(stats.p50) << ",\n"
+          << indent << "    \"p90\": " << ms(stats.p90) << ",\n"
+          << indent << "    \"p95\": " << ms(stats.p95) << ",\n"
+          << indent << "    \"p99\": " << ms(stats.p99) << ",\n"
+          << indent << "    \"p999\": " << ms(stats.p999) << "\n"
+          << indent << "  },\n"
+          << indent << "  \"average_cpu_usage\": " << average_CPU_usage << ",\n"
+          << indent << "  \"peak_workingset_bytes\": " << peak_workingset_size << "\n"
+          << indent << "}";
+}
+
 Status PerformanceRunner::Run() {
   if (!Initialize()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
   }
 
   // warm up
-  RunOneIteration<true>();
+  for (size_t i = 0; i < performance_test_config_.run_config.warmup_times; ++i) {
+    ORT_RETURN_IF_ERROR(RunOneIteration<true>());
+  }
 
   // TODO: start profiling
   // if (!performance_test_config_.run_config.profile_file.empty())
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
   performance_result_.average_CPU_usage = p_ICPUUsage->GetUsage();
   performance_result_.peak_workingset_size = utils::GetPeakWorkingSetSize();
 
-  std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
   // TODO: end profiling
   // if (!performance_test_config_.run_config.profile_file.empty()) session_object->EndProfiling();
+
+  return Status::OK();
+}
+
+void PerformanceRunner::PrintSummary() const {
+  std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
   std::chrono::duration<double> inference_duration = performance_result_.end - performance_result_.start;
 
   std::cout << "Session creation time cost: " << session_create_duration.count() << " s\n"
@@ -138,11 +202,10 @@ Status PerformanceRunner::Run() {
             << "Average inference time cost: " << performance_result_.total_time_cost / performance_result_.time_costs.size() * 1000 << " ms\n"
             // Time between start and end of run. Less than Total time cost when running requests in parallel.
             << "Total inference run time: " << inference_duration.count() << " s\n"
+            << "Throughput: " << performance_result_.time_costs.size() / inference_duration.count() << " requests/s\n"
             << "Avg CPU usage: " << performance_result_.average_CPU_usage << " %\n"
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
-
-  return Status::OK();
 }
 
 Status PerformanceRunner::FixDurationTest() {
@@ -162,33 +225,34 @@ Status PerformanceRunner::RepeatedTimesTest() {
 }
 
 Status PerformanceRunner::RunParallelDuration() {
-  // Simple method to continually queue parallel work until the timer has run down.
-  // TODO: Make each thread enqueue a new worker.
-  auto tpool = GetDefaultThreadPool(Env::Default());
-  std::atomic<int> counter = {0};
+  const auto& run_config = performance_test_config_.run_config;
+
+  // create a threadpool with one thread per concurrent request, each one running requests back to back
+  // until the time has run down
+  auto tpool = onnxruntime::make_unique<DefaultThreadPoolType>(run_config.concurrent_session_runs);
+  std::atomic<int> counter{0};
   OrtMutex m;
   OrtCondVar cv;
 
-  auto start = std::chrono::high_resolution_clock::now();
-  auto end = start;
-  std::chrono::duration<double> duration_seconds;
-  do {
-    // We will queue work as deep as requested, ignoring the size of the threadpool itself
-    int count = counter.load(std::memory_order_seq_cst);
-    while (count < static_cast<int>(performance_test_config_.run_config.concurrent_session_runs)) {
-      count++;
-      counter++;
-      tpool->Schedule([this, &counter, &m, &cv]() {
-        session_->ThreadSafeRun();
-        // Simplified version of Eigen::Barrier
-        std::lock_guard<OrtMutex> lg(m);
-        counter--;
-        cv.notify_all();
-      });
-    }
-    end = std::chrono::high_resolution_clock::now();
-    duration_seconds = end - start;
-  } while (duration_seconds.count() < performance_test_config_.run_config.duration_in_seconds);
+  const auto deadline = std::chrono::high_resolution_clock::now() +
+                        std::chrono::seconds(run_config.duration_in_seconds);
+
+  // Fork
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    counter++;
+    tpool->Schedule([this, &counter, &m, &cv, deadline]() {
+      while (std::chrono::high_resolution_clock::now() < deadline) {
+        auto status = RunOneIteration<false>();
+        if (!status.IsOK())
+          std::cerr << status.ErrorMessage();
+      }
+
+      // Simplified version of Eigen::Barrier
+      std::lock_guard<OrtMutex> lg(m);
+      counter--;
+      cv.notify_all();
+    });
+  }
 
   //Join
   std::unique_lock<OrtMutex> lock(m);
@@ -230,6 +294,53 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop() {
+  const auto& run_config = performance_test_config_.run_config;
+
+  // Requests are sent at the target rate whether or not the previous ones have completed. A request that finds
+  // all the runners busy waits in the queue of the threadpool, and that wait is part of its latency.
+  auto tpool = onnxruntime::make_unique<DefaultThreadPoolType>(std::max<size_t>(run_config.concurrent_session_runs, 1));
+  std::atomic<int> counter{0};
+  OrtMutex m;
+  OrtCondVar cv;
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  const std::chrono::duration<double> interval(1.0 / run_config.target_qps);
+
+  for (size_t i = 0;; ++i) {
+    const std::chrono::duration<double> offset = interval * static_cast<double>(i);
+    if (run_config.test_mode == TestMode::kFixDurationMode ? offset.count() >= run_config.duration_in_seconds
+                                                           : i >= run_config.repeated_times) {
+      break;
+    }
+
+    const auto scheduled = start + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(offset);
+    std::this_thread::sleep_until(scheduled);
+
+    counter++;
+    tpool->Schedule([this, &counter, &m, &cv, scheduled]() {
+      try {
+        session_->Run();
+        const std::chrono::duration<double> latency = std::chrono::high_resolution_clock::now() - scheduled;
+        RecordTimeCost(latency.count());
+      } catch (const std::exception& ex) {
+        std::cerr << "PerformanceRunner::RunOpenLoop caught exception: " << ex.what() << std::endl;
+      }
+
+      // Simplified version of Eigen::Barrier
+      std::lock_guard<OrtMutex> lg(m);
+      counter--;
+      cv.notify_all();
+    });
+  }
+
+  //Join
+  std::unique_lock<OrtMutex> lock(m);
+  cv.wait(lock, [&counter]() { return counter == 0; });
+
+  return Status::OK();
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   if (CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) == 0) {
     return TestModelInfo::LoadOnnxModel(performance_test_config_.model_info.model_file_path.c_str());
@@ -267,6 +378,82 @@ PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig&
 
 PerformanceRunner::~PerformanceRunner() = default;
 
+Status RunLoadTest(Ort::Env& env, const std::vector<PerformanceTestConfig>& model_configs,
+                   const PerformanceTestConfig& test_config, std::random_device& rd) {
+  // create all the sessions before any of them runs, so the session creation doesn't interfere with the runs
+  std::vector<std::unique_ptr<PerformanceRunner>> runners;
+  for (const auto& model_config : model_configs) {
+    runners.push_back(onnxruntime::make_unique<PerformanceRunner>(env, model_config, rd));
+  }
+
+  std::vector<Status> statuses(runners.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != runners.size(); ++i) {
+    threads.emplace_back([&runners, &statuses, i]() { statuses[i] = runners[i]->Run(); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // the results of all the models together. CPU usage and working set are measured for the whole process.
+  PerformanceResult aggregate_result;
+  aggregate_result.model_name = "all_models";
+  for (size_t i = 0; i != runners.size(); ++i) {
+    ORT_RETURN_IF_ERROR(statuses[i]);
+    const PerformanceResult& result = runners[i]->GetResult();
+
+    std::cout << "\nModel: " << result.model_name << "\n";
+    runners[i]->PrintSummary();
+    result.DumpToFile(test_config.model_info.result_file_path, test_config.run_config.f_dump_statistics);
+
+    if (i == 0 || result.start < aggregate_result.start) {
+      aggregate_result.start = result.start;
+    }
+    if (i == 0 || result.end > aggregate_result.end) {
+      aggregate_result.end = result.end;
+    }
+    aggregate_result.time_costs.insert(aggregate_result.time_costs.end(), result.time_costs.begin(),
+                                       result.time_costs.end());
+    aggregate_result.total_time_cost += result.total_time_cost;
+    aggregate_result.average_CPU_usage = std::max(aggregate_result.average_CPU_usage, result.average_CPU_usage);
+    aggregate_result.peak_workingset_size = std::max(aggregate_result.peak_workingset_size,
+                                                     result.peak_workingset_size);
+  }
+
+  const std::chrono::duration<double> run_time = aggregate_result.end - aggregate_result.start;
+  std::cout << "\nAll models:\n"
+            << "Total inference requests: " << aggregate_result.time_costs.size() << "\n"
+            << "Total inference run time: " << run_time.count() << " s\n"
+            << "Throughput: " << aggregate_result.time_costs.size() / run_time.count() << " requests/s\n";
+  if (!aggregate_result.time_costs.empty()) {
+    const PerformanceResult::LatencyStats stats = aggregate_result.GetLatencyStats();
+    std::cout << "Average Latency: " << stats.average << " s\n"
+              << "P50 Latency: " << stats.p50 << " s\n"
+              << "P90 Latency: " << stats.p90 << " s\n"
+              << "P99 Latency: " << stats.p99 << " s" << std::endl;
+  }
+
+  const auto& json_result_file = test_config.run_config.json_result_file;
+  if (!json_result_file.empty()) {
+    std::ofstream outfile(json_result_file, std::ofstream::out | std::ofstream::trunc);
+    if (!outfile.good()) {
+      std::cerr << "failed to open JSON result file '" << ToMBString(json_result_file) << "'.\n";
+      return Status::OK();
+    }
+
+    outfile << "{\n  \"models\": [";
+    for (size_t i = 0; i != runners.size(); ++i) {
+      outfile << (i == 0 ? "\n    " : ",\n    ");
+      runners[i]->GetResult().WriteJson(outfile, model_configs[i].run_config, "    ");
+    }
+    outfile << "\n  ],\n  \"all_models\": ";
+    aggregate_result.WriteJson(outfile, test_config.run_config, "  ");
+    outfile << "\n}" << std::endl;
+  }
+
+  return Status::OK();
+}
+
 bool PerformanceRunner::Initialize() {
   std::basic_string<PATH_CHAR_TYPE> test_case_dir;
   auto st = GetDirNameFromFilePath(performance_test_config_.model_info.model_file_path, test_case_dir);
@@ -36,7 +36,26 @@ struct PerformanceResult {
   std::vector<double> time_costs;
   std::string model_name;
 
+  // Statistics of time_costs, in seconds.
+  struct LatencyStats {
+    double min{0};
+    double max{0};
+    double average{0};
+    double p50{0};
+    double p90{0};
+    double p95{0};
+    double p99{0};
+    double p999{0};
+  };
+
+  // time_costs must not be empty.
+  LatencyStats GetLatencyStats() const;
+
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
+
+  // Writes the configuration of the test, the throughput and the latency statistics as a JSON object.
+  void DumpToJson(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const;
+  void WriteJson(std::ostream& ostream, const RunConfig& run_config, const std::string& indent = "") const;
 };
 
 class PerformanceRunner {
@@ -46,11 +65,18 @@ class PerformanceRunner {
   ~PerformanceRunner();
   Status Run();
 
+  // Prints the session creation time, the inference time and the resource usage of the test.
+  void PrintSummary() const;
+
   inline const PerformanceResult& GetResult() const { return performance_result_; }
 
   inline void SerializeResult() const {
     performance_result_.DumpToFile(performance_test_config_.model_info.result_file_path,
                                    performance_test_config_.run_config.f_dump_statistics);
+    if (!performance_test_config_.run_config.json_result_file.empty()) {
+      performance_result_.DumpToJson(performance_test_config_.run_config.json_result_file,
+                                     performance_test_config_.run_config);
+    }
   }
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PerformanceRunner);
 
@@ -68,21 +94,26 @@ class PerformanceRunner {
     }
 
     if (!isWarmup) {
-      std::lock_guard<OrtMutex> guard(results_mutex_);
-      performance_result_.time_costs.emplace_back(duration_seconds.count());
-      performance_result_.total_time_cost += duration_seconds.count();
-      if (performance_test_config_.run_config.f_verbose) {
-        std::cout << "iteration:" << performance_result_.time_costs.size() << ","
-                  << "time_cost:" << performance_result_.time_costs.back() << std::endl;
-      }
+      RecordTimeCost(duration_seconds.count());
     }
     return Status::OK();
   }
 
+  void RecordTimeCost(double seconds) {
+    std::lock_guard<OrtMutex> guard(results_mutex_);
+    performance_result_.time_costs.emplace_back(seconds);
+    performance_result_.total_time_cost += seconds;
+    if (performance_test_config_.run_config.f_verbose) {
+      std::cout << "iteration:" << performance_result_.time_costs.size() << ","
+                << "time_cost:" << performance_result_.time_costs.back() << std::endl;
+    }
+  }
+
   Status FixDurationTest();
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunOpenLoop();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -110,5 +141,10 @@ class PerformanceRunner {
 
   OrtMutex results_mutex_;
 };
+
+// Runs the models of a load test at the same time in this process, each one with its own PerformanceRunner,
+// and reports the throughput and the latency of each model and of all of them together.
+Status RunLoadTest(Ort::Env& env, const std::vector<PerformanceTestConfig>& model_configs,
+                   const PerformanceTestConfig& test_config, std::random_device& rd);
 }  // namespace perftest
 }  // namespace onnxruntime
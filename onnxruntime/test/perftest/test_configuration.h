@@ -40,6 +40,16 @@ struct RunConfig {
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // runs before the measured ones, to exclude the cost of the first runs (lazy initialization, cold caches)
+  size_t warmup_times{1};
+  // if positive, send requests at this fixed rate instead of back to back (open loop). The latency of a request
+  // is measured from the time it was due, so the time it waited for a free runner counts.
+  double target_qps{0};
+  std::basic_string<ORTCHAR_T> json_result_file;
+  // file listing the models of a load test, which are run at the same time in one process
+  std::basic_string<ORTCHAR_T> load_config_file;
+  // share the thread pools of the environment between the sessions instead of giving each session its own
+  bool use_global_thread_pools{false};
   bool f_dump_statistics{false};
   bool f_verbose{false};
   bool enable_memory_pattern{true};
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/platform/threadpool.h"
+#include "core/common/parallel_for_cost_table.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
 
@@ -9,8 +10,11 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <cstdio>
+#include <chrono>
 #include <memory>
 #include <functional>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -202,6 +206,237 @@ TEST(ThreadPoolTest, TestMultipleParallelFor_4Thread_4Conc_8Tasks) {
 TEST(ThreadPoolTest, TestMultipleParallelFor_4Thread_4Conc_1MTasks) {
   TestMultipleParallelFor("TestMultipleParallelFor_4Thread_4Conc_1MTasks", 4, 4, 1000000);
 }
+
+TEST(ThreadPoolTest, TestAdaptiveSpinning) {
+  constexpr int num_threads = 4;
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                 num_threads, true, true);
+  auto run_loop = [&tp]() {
+    auto test_data = CreateTestData(1000);
+    tp->SimpleParallelFor(1000, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    ValidateTestData(*test_data);
+  };
+
+  // The workers start with the full spin budget
+  const uint64_t start_budget = tp->GetSpinStats().spin_budget;
+  ASSERT_GT(start_budget, 0u);
+
+  // Leave the workers idle for much longer than they spin, so each time they park for long and halve their budget,
+  // down to a small fraction of the full one
+  uint64_t idle_budget = start_budget;
+  for (int round = 0; round < 60 && idle_budget > start_budget / 512; round++) {
+    run_loop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    idle_budget = tp->GetSpinStats().spin_budget;
+  }
+  ASSERT_LE(idle_budget, start_budget / 512);
+  ThreadPoolSpinStats stats = tp->GetSpinStats();
+  ASSERT_GT(stats.num_parks, 0u);
+
+  // Give the workers new work shortly after they run out of it, which they then wait for by spinning longer
+  for (int round = 0; round < 500; round++) {
+    run_loop();
+    const auto resume = std::chrono::steady_clock::now() + std::chrono::microseconds(300);
+    while (std::chrono::steady_clock::now() < resume) {
+    }
+  }
+  const uint64_t busy_budget = tp->GetSpinStats().spin_budget;
+  ASSERT_GT(busy_budget, idle_budget);
+  ASSERT_LE(busy_budget, start_budget);
+}
+
+TEST(ThreadPoolTest, TestWorkerProfiling) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                 4, true);
+  constexpr int num_work_items = 100;
+  auto run_work_items = [&tp]() {
+    auto test_data = CreateTestData(num_work_items);
+    onnxruntime::Barrier b(num_work_items);
+    for (int i = 0; i < num_work_items; i++) {
+      tp->Schedule([&, i]() {
+        IncrementElement(*test_data, i);
+        b.Notify();
+      });
+    }
+    b.Wait();
+    ValidateTestData(*test_data);
+  };
+
+  auto count_tasks = [](const std::vector<ThreadPoolWorkerStats>& stats) {
+    uint64_t num_tasks = 0;
+    for (const auto& worker_stats : stats) {
+      num_tasks += worker_stats.num_tasks;
+    }
+    return num_tasks;
+  };
+
+  // Nothing is recorded until profiling is enabled
+  run_work_items();
+  std::vector<ThreadPoolTraceEvent> events;
+  tp->TakeTraceEvents(events);
+  ASSERT_TRUE(events.empty());
+  ASSERT_EQ(count_tasks(tp->GetWorkerStats()), 0u);
+
+  tp->SetProfiling(true);
+  run_work_items();
+  tp->SetProfiling(false);
+
+  // Schedule hands each work item to a worker, so every one of them is recorded. A worker records its work item
+  // after running it, so the last ones may still be on their way.
+  for (int attempt = 0; attempt < 1000 && events.size() < static_cast<size_t>(num_work_items); attempt++) {
+    tp->TakeTraceEvents(events);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(events.size(), static_cast<size_t>(num_work_items));
+  const auto stats = tp->GetWorkerStats();
+  ASSERT_EQ(stats.size(), 4u);
+  ASSERT_EQ(count_tasks(stats), static_cast<uint64_t>(num_work_items));
+  for (const auto& event : events) {
+    ASSERT_GE(event.thread_id, 0);
+    ASSERT_LT(event.thread_id, 4);
+    ASSERT_LE(event.start, event.end);
+  }
+
+  // The events are handed out once
+  events.clear();
+  tp->TakeTraceEvents(events);
+  ASSERT_TRUE(events.empty());
+}
+
+void TestParallelSection(int num_threads, int num_loops, int num_tasks) {
+  CreateThreadPoolAndTest("TestParallelSection", num_threads, [&](ThreadPool* tp) {
+    ThreadPool::ParallelSection section(tp);
+    for (int loop = 0; loop < num_loops; loop++) {
+      auto test_data = CreateTestData(num_tasks);
+      ThreadPool::TrySimpleParallelFor(tp, num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+      ValidateTestData(*test_data);
+    }
+  });
+}
+
+TEST(ThreadPoolTest, TestParallelSection_1Thread) {
+  TestParallelSection(1, 10, 8);
+}
+
+TEST(ThreadPoolTest, TestParallelSection_4Thread) {
+  TestParallelSection(4, 1000, 8);
+}
+
+TEST(ThreadPoolTest, TestParallelSection_4Thread_1MTasks) {
+  TestParallelSection(4, 4, 1000000);
+}
+
+TEST(ThreadPoolTest, TestParallelSection_NullPool) {
+  ThreadPool::ParallelSection section(nullptr);
+  auto test_data = CreateTestData(8);
+  ThreadPool::TrySimpleParallelFor(nullptr, 8, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestParallelSection_NestedLoops) {
+  CreateThreadPoolAndTest("TestParallelSection_NestedLoops", 4, [&](ThreadPool* tp) {
+    ThreadPool::ParallelSection section(tp);
+    ThreadPool::ParallelSection nested_section(tp);
+    for (int loop = 0; loop < 10; loop++) {
+      auto test_data = CreateTestData(64);
+      // Loops started from within a loop of the section, by the caller or by the team, run to completion too
+      ThreadPool::TrySimpleParallelFor(tp, 8, [&](std::ptrdiff_t i) {
+        ThreadPool::TrySimpleParallelFor(tp, 8, [&](std::ptrdiff_t j) { IncrementElement(*test_data, i * 8 + j); });
+      });
+      ValidateTestData(*test_data);
+    }
+  });
+}
+
+TEST(ThreadPoolTest, TestParallelForCostCalibration) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                 4, true);
+  auto cost_table = std::make_shared<ParallelForCostTable>();
+  tp->SetCostTable(cost_table, true);
+
+  // Loops outside an OpScope aren't measured.
+  auto test_data = CreateTestData(1000);
+  tp->ParallelFor(1000, 10.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; i++) IncrementElement(*test_data, i);
+  });
+  ValidateTestData(*test_data);
+  ASSERT_EQ(cost_table->NumEntries(), 0u);
+
+  const std::string op_type = "TestOp";
+  double ns_per_element = 0;
+  {
+    ParallelForCostTable::OpScope scope(op_type);
+    for (uint64_t round = 0; round < ParallelForCostTable::kMinSamples; round++) {
+      ASSERT_FALSE(cost_table->Lookup(op_type, 1000, ns_per_element));
+      test_data = CreateTestData(1000);
+      tp->ParallelFor(1000, 1000000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; i++) IncrementElement(*test_data, i);
+      });
+      ValidateTestData(*test_data);
+    }
+  }
+  ASSERT_TRUE(ParallelForCostTable::CurrentOpType() == nullptr);
+  ASSERT_EQ(cost_table->NumEntries(), 1u);
+  ASSERT_TRUE(cost_table->Lookup(op_type, 1000, ns_per_element));
+  ASSERT_GE(ns_per_element, 0.0);
+  // 1000 and 1023 have the same size class, 1024 doesn't
+  ASSERT_TRUE(cost_table->Lookup(op_type, 1023, ns_per_element));
+  ASSERT_FALSE(cost_table->Lookup(op_type, 1024, ns_per_element));
+
+  const ORTCHAR_T* file_name = ORT_TSTR("parallel_for_cost_table_test.txt");
+  ASSERT_TRUE(cost_table->Save(file_name).IsOK());
+  ParallelForCostTable loaded;
+  ASSERT_TRUE(loaded.Load(file_name).IsOK());
+  double loaded_ns_per_element = -1;
+  ASSERT_TRUE(loaded.Lookup(op_type, 1000, loaded_ns_per_element));
+  cost_table->Lookup(op_type, 1000, ns_per_element);
+  ASSERT_NEAR(loaded_ns_per_element, ns_per_element, 1e-3 * ns_per_element + 1e-6);
+  std::remove("parallel_for_cost_table_test.txt");
+}
+
+TEST(ThreadPoolTest, TestParallelForCalibratedShards) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                                 4, true);
+  auto cost_table = std::make_shared<ParallelForCostTable>();
+  tp->SetCostTable(cost_table, false);
+
+  // Runs a loop of `total` elements under `op_type` and returns the sizes of the shards it was split into.
+  auto run_loop = [&tp](const std::string& op_type, std::ptrdiff_t total) {
+    ParallelForCostTable::OpScope scope(op_type);
+    auto test_data = CreateTestData(static_cast<int>(total));
+    std::vector<std::ptrdiff_t> shards;
+    onnxruntime::OrtMutex mutex;
+    // The estimate passed by the caller is ignored once the cost is calibrated
+    tp->ParallelFor(total, 1000000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; i++) IncrementElement(*test_data, i);
+      std::lock_guard<onnxruntime::OrtMutex> lock(mutex);
+      shards.push_back(last - first);
+    });
+    ValidateTestData(*test_data);
+    return shards;
+  };
+
+  // At 10ns per element, a task is about 1333 elements, so 8 * 1333 elements are split in 8 even shards.
+  // Reading the cost as cycles would give 4000 element shards instead.
+  constexpr std::ptrdiff_t total = 8 * 1333;
+  for (uint64_t i = 0; i < ParallelForCostTable::kMinSamples; i++) {
+    cost_table->Record("SlowOp", total, 10.0 * total);
+  }
+  auto shards = run_loop("SlowOp", total);
+  ASSERT_EQ(shards.size(), 8u);
+  for (auto shard : shards) {
+    ASSERT_EQ(shard, 1333);
+  }
+
+  // At 1ns per element, the whole loop takes less than starting a thread, so it runs in the caller.
+  for (uint64_t i = 0; i < ParallelForCostTable::kMinSamples; i++) {
+    cost_table->Record("FastOp", total, 1.0 * total);
+  }
+  shards = run_loop("FastOp", total);
+  ASSERT_EQ(shards.size(), 1u);
+  ASSERT_EQ(shards[0], total);
+}
+
 #ifdef _WIN32
 TEST(ThreadPoolTest, TestStackSize) {
   ThreadOptions to;
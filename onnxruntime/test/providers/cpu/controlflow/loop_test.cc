@@ -470,6 +470,79 @@ TEST(Loop, ZeroIterations) {
           {});
 }
 
+// the condition is never changed so the number of iterations is known when the Loop starts, and the
+// per-iteration output and the final loop carried var are written directly into the Loop outputs.
+TEST(Loop, KnownTripCountOutputsInPlace) {
+  auto create_subgraph = [](const RunOptions&) {
+    Model model("Known trip count subgraph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    /*  Inputs: iter_num, cond_in, loop carried state variables.
+
+         iter_num_in    cond_in     loop_var_0_in
+           (unused)        |          |       |
+                       [Identity]   [Add]  [Identity]
+                           |          |       |
+                        cond_out  loop_var_0_out  loop_out_0
+    */
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& loop_var_0_in = graph.GetOrCreateNodeArg("loop_var_0_in", &float_tensor);
+
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
+    auto& loop_out_0 = graph.GetOrCreateNodeArg("loop_out_0", &float_tensor);
+
+    TensorProto one;
+    one.set_name("one");
+    one.add_dims(1);
+    one.add_float_data(1.f);
+    one.set_data_type(TensorProto_DataType_FLOAT);
+    graph.AddInitializedTensor(one);
+    auto& one_arg = graph.GetOrCreateNodeArg("one", nullptr);
+
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+    graph.AddNode("add", "Add", "Increment loop_var_0", {&loop_var_0_in, &one_arg}, {&loop_var_0_out});
+    graph.AddNode("loop_out_identity", "Identity", "Output loop_var_0_in", {&loop_var_0_in}, {&loop_out_0});
+
+    graph.SetInputs({&iter_num_in, &cond_in, &loop_var_0_in});
+    graph.SetOutputs({&cond_out, &loop_var_0_out, &loop_out_0});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  OpTester test("Loop", 11);
+  test.AddAttribute<GraphProto>("body", create_subgraph({}));
+  test.AddInput<int64_t>("M", {1}, {4});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("loop_var_0_orig", {2}, {1.f, 2.f});
+
+  test.AddOutput<float>("loop_var_0_final", {2}, {5.f, 6.f});
+  test.AddOutput<float>("loop_out_0_final", {4, 2}, {1.f, 2.f,
+                                                     2.f, 3.f,
+                                                     3.f, 4.f,
+                                                     4.f, 5.f});
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(Loop, InfiniteLoopTermination) {
   auto create_subgraph = [](const RunOptions&) {
     Model model("Infinite Loop subgraph", false, DefaultLoggingManager().DefaultLogger());
@@ -731,7 +804,7 @@ TEST(Loop, SubgraphInputShadowsOuterScopeValue) {
   auto& b_out = fetches[0].Get<Tensor>();
   TensorShape expected_shape(scalar);
   //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&expected_shape), *reinterpret_cast<const std::vector<int64_t>*>(&b_out.Shape()));
+  ASSERT_EQ(expected_shape.GetDims(), b_out.Shape().GetDims());
   ASSERT_EQ(b_out.DataAsSpan<float>()[0], expected_value_b);
 
   auto user_defined_vals_out = fetches[1].Get<Tensor>().DataAsSpan<float>();
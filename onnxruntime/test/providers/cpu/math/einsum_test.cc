@@ -187,6 +187,17 @@ TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input) {
   test.Run();
 }
 
+TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input_Reordered) {
+  // The contraction of the last two inputs gives the smallest intermediate result, so they are processed first
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ij,jk,k->i");
+  test.AddInput<float>("x", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("y", {3, 4}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f});
+  test.AddInput<float>("z", {4}, {1.f, 2.f, 3.f, 4.f});
+  test.AddOutput<float>("o", {2}, {500.f, 1130.f});
+  test.Run();
+}
+
 TEST(Einsum, ExplicitEinsumAsBatchedMatmul) {
   OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
   test.AddAttribute<std::string>("equation", "bij,bjk->bik");
@@ -6,6 +6,8 @@
 #include "test/util/include/default_providers.h"
 #include "core/util/math.h"
 #include <algorithm>
+#include <functional>
+#include <numeric>
 #include <cmath>
 
 namespace onnxruntime {
@@ -280,6 +282,37 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", excluded_providers);  //TensorRT: Input batch size is inconsistent
 }
 
+// rows and columns long enough for the CUDA kernels that broadcast per row or per column without dividing the
+// offset of each element, and an element count that isn't a multiple of the elements loaded at once
+TEST(MathOpTest, Add_Broadcast_LongRows) {
+  auto run = [](const std::vector<int64_t>& a_dims, const std::vector<int64_t>& b_dims) {
+    const int64_t size = std::accumulate(a_dims.begin(), a_dims.end(), int64_t{1}, std::multiplies<int64_t>());
+    const int64_t b_size = std::accumulate(b_dims.begin(), b_dims.end(), int64_t{1}, std::multiplies<int64_t>());
+    // the index of B broadcast to each element of A
+    const int64_t inner = b_dims.back() == 1 ? a_dims.back() : 1;
+
+    std::vector<float> a(size), b(b_size), c(size);
+    for (int64_t i = 0; i < b_size; ++i) {
+      b[i] = static_cast<float>(1000 * (i + 1));
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      a[i] = static_cast<float>(i);
+      c[i] = a[i] + b[(i / inner) % b_size];
+    }
+
+    OpTester test("Add");
+    test.AddInput<float>("A", a_dims, a);
+    test.AddInput<float>("B", b_dims, b);
+    test.AddOutput<float>("C", a_dims, c);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  };
+
+  run({3, 37}, {3, 1});     // per row, batch of 1
+  run({2, 3, 41}, {3, 1});  // per row
+  run({5, 45}, {45});       // per column
+  run({2, 3, 7}, {2, 3, 7});
+}
+
 // Validate runtime failure has useful error message when ORT_ENFORCE is used
 TEST(MathOpTest, Add_Invalid_Broadcast) {
   OpTester test("Add");
@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 namespace test {
@@ -269,5 +270,46 @@ TEST(GemmOpTest, GemmNoBiasOpset11) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider, kTensorrtExecutionProvider});
 }
 
+// B is transposed and mostly zero, so the CPU provider packs it for the block sparse GEMM if enabled.
+TEST(GemmOpTest, GemmTransBBlockSparseWeights) {
+  const int64_t M = 2, K = 8, N = 10;
+  const float alpha = 0.5f, beta = 2.0f;
+  std::vector<float> A(M * K);
+  for (size_t i = 0; i < A.size(); ++i) {
+    A[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+  }
+  std::vector<float> B(N * K, 0.0f);
+  B[0 * K + 1] = 1.0f;
+  B[9 * K + 7] = -2.0f;
+  std::vector<float> C{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f};
+  std::vector<float> Y(M * N);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; ++k) {
+        sum += A[m * K + k] * B[n * K + k];
+      }
+      Y[m * N + n] = alpha * sum + beta * C[n];
+    }
+  }
+
+  CPUExecutionProviderInfo info;
+  info.enable_sparse_gemm = true;
+
+  OpTester test("Gemm", 11);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(1));
+  test.AddAttribute("alpha", alpha);
+  test.AddAttribute("beta", beta);
+  test.AddInput<float>("A", {M, K}, A);
+  test.AddInput<float>("B", {N, K}, B, true);
+  test.AddInput<float>("C", {N}, C);
+  test.AddOutput<float>("Y", {M, N}, Y);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
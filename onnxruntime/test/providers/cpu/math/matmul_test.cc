@@ -3,6 +3,9 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/framework/session_options.h"
+#include "core/util/math.h"
 
 namespace onnxruntime {
 namespace test {
@@ -133,5 +136,205 @@ TEST(MathOpTest, MatMulUint64Type) {
   RunMatMulTest<uint64_t>(9);
 }
 
+// Every partial sum of the test cases is an integer below 2048, so the results are exact in float16 whether the
+// products are accumulated in half or single precision.
+TEST(MathOpTest, MatMulFloat16Type) {
+  auto to_float16 = [](const std::vector<float>& values) {
+    std::vector<MLFloat16> converted;
+    for (float value : values) {
+      converted.push_back(MLFloat16(math::floatToHalf(value)));
+    }
+    return converted;
+  };
+
+  std::vector<float> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  for (auto t : GenerateTestCases<float>()) {
+    OpTester test("MatMul", 9);
+
+    int64_t size0 = TensorShape::ReinterpretBaseType(t.input0_dims).SizeHelper(0, t.input0_dims.size());
+    std::vector<float> input0_vals(common_input_vals.cbegin(), common_input_vals.cbegin() + size0);
+    test.AddInput<MLFloat16>("A", t.input0_dims, to_float16(input0_vals));
+
+    int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
+    std::vector<float> input1_vals(common_input_vals.cbegin(), common_input_vals.cbegin() + size1);
+    test.AddInput<MLFloat16>("B", t.input1_dims, to_float16(input1_vals));
+
+    test.AddOutput<MLFloat16>("Y", t.expected_dims, to_float16(t.expected_vals));
+
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+  }
+}
+
+// The weights are constant, so the CPU provider packs them for the MLAS GEMM.
+// Small integers are exact in bfloat16, so the data also suits the bfloat16 GEMM.
+static void RunMatMulPackedWeightsTest(const CPUExecutionProviderInfo& info) {
+  OpTester test("MatMul", 9);
+  test.AddInput<float>("A", {2, 3, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f,
+                        0.0f, 1.0f, 0.0f, -1.0f,
+                        2.0f, 0.0f, -2.0f, 1.0f,
+                        3.0f, 1.0f, 1.0f, 3.0f,
+                        -2.0f, 4.0f, -4.0f, 2.0f});
+  test.AddInput<float>("B", {4, 3},
+                       {1.0f, 0.0f, -1.0f,
+                        2.0f, 1.0f, 0.0f,
+                        -1.0f, 3.0f, 1.0f,
+                        0.0f, -2.0f, 2.0f},
+                       true);
+  test.AddOutput<float>("Y", {2, 3, 3},
+                        {2.0f, 3.0f, 10.0f,
+                         -2.0f, -3.0f, -10.0f,
+                         2.0f, 3.0f, -2.0f,
+                         4.0f, -8.0f, -2.0f,
+                         4.0f, -2.0f, 4.0f,
+                         10.0f, -12.0f, 2.0f});
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MathOpTest, MatMulFloatPackedWeights) {
+  CPUExecutionProviderInfo info;
+  RunMatMulPackedWeightsTest(info);
+}
+
+TEST(MathOpTest, MatMulFloatBf16PackedWeights) {
+  CPUExecutionProviderInfo info;
+  info.enable_bf16_gemm = true;
+  RunMatMulPackedWeightsTest(info);
+}
+
+TEST(MathOpTest, MatMulFloatSharedPackedWeights) {
+  CPUExecutionProviderInfo info;
+  info.share_prepacked_weights = true;
+  RunMatMulPackedWeightsTest(info);
+  RunMatMulPackedWeightsTest(info);
+}
+
+// Most of B is zero, so the CPU provider packs it for the block sparse GEMM if enabled. N is not a multiple of the
+// block size so that the last block of each row is partial.
+TEST(MathOpTest, MatMulFloatBlockSparseWeights) {
+  const int64_t M = 3, K = 16, N = 20;
+  std::vector<float> A(2 * M * K);
+  for (size_t i = 0; i < A.size(); ++i) {
+    A[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+  std::vector<float> B(K * N, 0.0f);
+  for (int64_t k = 0; k < K; k += 3) {
+    B[k * N + (k * 5) % N] = static_cast<float>(k % 4) - 1.5f;
+    B[k * N + N - 1] = 0.5f;
+  }
+  std::vector<float> Y(2 * M * N, 0.0f);
+  for (int64_t m = 0; m < 2 * M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        Y[m * N + n] += A[m * K + k] * B[k * N + n];
+      }
+    }
+  }
+
+  CPUExecutionProviderInfo info;
+  info.enable_sparse_gemm = true;
+
+  OpTester test("MatMul", 9);
+  test.AddInput<float>("A", {2, M, K}, A);
+  test.AddInput<float>("B", {K, N}, B, true);
+  test.AddOutput<float>("Y", {2, M, N}, Y);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Multiplies stacks of M x K slices of A and K x N slices of B, broadcasting their batch dimensions, on a session
+// with an intra-op thread pool so that the batched GEMM splits the work. The inputs are small integers so that the
+// expected values computed here are exact.
+static void RunBatchedMatMulTest(const std::vector<int64_t>& a_batch_dims, const std::vector<int64_t>& b_dims,
+                                 int64_t M, int64_t K, int64_t N, bool b_is_initializer) {
+  // B may have fewer batch dimensions than A, such as none for a 2-D weight.
+  ASSERT_LE(b_dims.size(), a_batch_dims.size());
+  std::vector<int64_t> b_batch_dims(a_batch_dims.size() - b_dims.size(), 1);
+  b_batch_dims.insert(b_batch_dims.end(), b_dims.begin(), b_dims.end());
+  std::vector<int64_t> y_batch_dims(a_batch_dims.size());
+  int64_t a_batch = 1, b_batch = 1, y_batch = 1;
+  for (size_t i = 0; i < a_batch_dims.size(); ++i) {
+    y_batch_dims[i] = std::max(a_batch_dims[i], b_batch_dims[i]);
+    a_batch *= a_batch_dims[i];
+    b_batch *= b_batch_dims[i];
+    y_batch *= y_batch_dims[i];
+  }
+
+  std::vector<float> A(a_batch * M * K);
+  for (size_t i = 0; i < A.size(); ++i) {
+    A[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+  std::vector<float> B(b_batch * K * N);
+  for (size_t i = 0; i < B.size(); ++i) {
+    B[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+  }
+  std::vector<float> Y(y_batch * M * N, 0.0f);
+  for (int64_t y_index = 0; y_index < y_batch; ++y_index) {
+    // Map the output slice to the slices of A and B, treating their size 1 dimensions as broadcast.
+    int64_t a_index = 0, b_index = 0, remainder = y_index, y_stride = y_batch;
+    for (size_t i = 0; i < y_batch_dims.size(); ++i) {
+      y_stride /= y_batch_dims[i];
+      const int64_t index = remainder / y_stride;
+      remainder %= y_stride;
+      a_index = a_index * a_batch_dims[i] + (a_batch_dims[i] == 1 ? 0 : index);
+      b_index = b_index * b_batch_dims[i] + (b_batch_dims[i] == 1 ? 0 : index);
+    }
+    const float* a = A.data() + a_index * M * K;
+    const float* b = B.data() + b_index * K * N;
+    float* y = Y.data() + y_index * M * N;
+    for (int64_t m = 0; m < M; ++m) {
+      for (int64_t n = 0; n < N; ++n) {
+        for (int64_t k = 0; k < K; ++k) {
+          y[m * N + n] += a[m * K + k] * b[k * N + n];
+        }
+      }
+    }
+  }
+
+  auto dims = [](std::vector<int64_t> batch_dims, int64_t rows, int64_t columns) {
+    batch_dims.push_back(rows);
+    batch_dims.push_back(columns);
+    return batch_dims;
+  };
+
+  OpTester test("MatMul", 9);
+  test.AddInput<float>("A", dims(a_batch_dims, M, K), A);
+  test.AddInput<float>("B", dims(b_dims, K, N), B, b_is_initializer);
+  test.AddOutput<float>("Y", dims(y_batch_dims, M, N), Y);
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 4;
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo()));
+  test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// A batched A against a large constant 2-D B is flattened into a single GEMM with the packed B.
+TEST(MathOpTest, MatMulFloatBatchedPackedWeights) {
+  RunBatchedMatMulTest({6}, {}, 5, 96, 80, true);
+  RunBatchedMatMulTest({6}, {}, 5, 96, 80, false);
+}
+
+// Stacked slices of A and B, as in attention, run through the strided batched GEMM. More slices than threads
+// spreads whole slices over the threads, and fewer splits each slice.
+TEST(MathOpTest, MatMulFloatBatchedStackedInputs) {
+  RunBatchedMatMulTest({3, 4}, {3, 4}, 7, 64, 33, false);
+  RunBatchedMatMulTest({3, 4}, {3, 4}, 7, 64, 33, true);
+  RunBatchedMatMulTest({2}, {2}, 64, 96, 80, false);
+}
+
+// A single A broadcast over a stack of B is still evenly spaced, with a zero stride for A. Broadcasting both
+// inputs is not, so those slices keep the GEMM per slice.
+TEST(MathOpTest, MatMulFloatBatchedBroadcastInputs) {
+  RunBatchedMatMulTest({1}, {8}, 5, 64, 40, false);
+  RunBatchedMatMulTest({2, 1}, {1, 3}, 5, 64, 40, false);
+  RunBatchedMatMulTest({2, 1}, {1, 3}, 5, 64, 40, true);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -58,5 +58,20 @@ TEST(QuantizeLinearMatmulOpTest, QLinearMatMul) {
   test.AddOutput<uint8_t>("T3", {2, 3}, {168, 115, 255, 1, 66, 151});
   test.Run();
 }
+
+TEST(QuantizeLinearMatmulOpTest, QLinearMatMulPerColumn) {
+  // each column of the weight has its own scale
+  OpTester test("QLinearMatMul", 10);
+  test.AddInput<uint8_t>("T1", {2, 2}, {1, 2, 3, 4});
+  test.AddInput<float>("a_scale", {}, {1.f});
+  test.AddInput<uint8_t>("a_zero_point", {}, {0});
+  test.AddInput<uint8_t>("T2", {2, 5}, {1, 0, 2, 1, 3, 0, 1, 1, 2, 0});
+  test.AddInput<float>("b_scale", {5}, {1.f, 2.f, 0.5f, 1.f, 0.25f});
+  test.AddInput<uint8_t>("b_zero_point", {5}, {0, 0, 0, 0, 0});
+  test.AddInput<float>("y_scale", {}, {0.25f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {10});
+  test.AddOutput<uint8_t>("T3", {2, 5}, {14, 26, 18, 30, 13, 22, 42, 30, 54, 19});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider});
+}
 }  // namespace test
 }  // namespace onnxruntime
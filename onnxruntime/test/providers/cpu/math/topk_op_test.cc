@@ -556,5 +556,65 @@ TEST(TopKOperator, SelectTopKThreaded) {
   TestThreaded(k, n, batch_size);
 }
 
+// Runs TopK on the innermost axis of a [rows, cols] input, checking against the top k found with std::partial_sort,
+// with equal values ordered by index.
+template <typename T>
+static void TestLargeRows(int64_t rows, int64_t cols, int64_t k, int64_t largest, int64_t sorted,
+                          const std::function<T(int64_t)>& value_of) {
+  std::vector<T> input_vals(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    input_vals[i] = value_of(i);
+  }
+
+  std::vector<T> expected_vals;
+  std::vector<int64_t> expected_indices;
+  std::vector<int64_t> row_indices(cols);
+  for (int64_t i = 0; i < rows; ++i) {
+    const T* row = input_vals.data() + i * cols;
+    std::iota(row_indices.begin(), row_indices.end(), 0);
+    std::partial_sort(row_indices.begin(), row_indices.begin() + k, row_indices.end(),
+                      [row, largest](int64_t lhs, int64_t rhs) {
+                        return (largest ? row[lhs] > row[rhs] : row[lhs] < row[rhs]) ||
+                               (row[lhs] == row[rhs] && lhs < rhs);
+                      });
+    for (int64_t l = 0; l < k; ++l) {
+      expected_vals.push_back(row[row_indices[l]]);
+      expected_indices.push_back(row_indices[l]);
+    }
+  }
+
+  RunTest<T>(11, k, input_vals, {rows, cols}, expected_vals, expected_indices, {rows, k}, false, -1, largest, sorted);
+}
+
+// rows large enough for the threshold filtering used for small k
+TEST(TopKOperator, LargeRowsSmallK) {
+  auto value_of = [](int64_t i) { return static_cast<float>((i * 7919) % 100003); };
+  TestLargeRows<float>(4, 20000, 100, 1, 1, value_of);
+  TestLargeRows<float>(4, 20000, 100, 0, 1, value_of);
+  TestLargeRows<float>(4, 20000, 100, 1, 0, value_of);
+}
+
+// k too large for the threshold filtering, so radix select is used
+TEST(TopKOperator, LargeRowsLargeK) {
+  auto value_of = [](int64_t i) { return static_cast<float>((i * 7919) % 100003) - 50000.f; };
+  TestLargeRows<float>(3, 10000, 2000, 1, 1, value_of);
+  TestLargeRows<float>(3, 10000, 2000, 0, 1, value_of);
+  TestLargeRows<int64_t>(3, 10000, 2000, 1, 1, [](int64_t i) { return ((i * 7919) % 100003) - 50000; });
+}
+
+// many equal values, which must be selected by lowest index
+TEST(TopKOperator, LargeRowsTies) {
+  auto value_of = [](int64_t i) { return static_cast<float>((i * 7919) % 13); };
+  TestLargeRows<float>(2, 10000, 50, 1, 1, value_of);
+  TestLargeRows<float>(2, 10000, 3000, 0, 1, value_of);
+  TestLargeRows<int64_t>(2, 10000, 50, 0, 1, [](int64_t i) { return (i * 7919) % 13; });
+}
+
+// a single long row that is split in chunks across threads
+TEST(TopKOperator, SingleLongRowThreaded) {
+  TestLargeRows<float>(1, 1000000, 100, 1, 1, [](int64_t i) { return static_cast<float>((i * 7919) % 1000003); });
+  TestLargeRows<int64_t>(1, 300000, 10000, 0, 1, [](int64_t i) { return (i * 7919) % 1000; });
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -189,5 +189,38 @@ TEST(LabelEncoder, Int64ToInt64Opset2) {
   test.Run();
 }
 
+TEST(LabelEncoder, Int64ToInt64ManyKeysOpset2) {
+  // Enough keys and inputs to need several probes per lookup and to be split across threads.
+  constexpr int64_t num_keys = 1000;
+  constexpr int64_t num_inputs = 100000;
+
+  std::vector<std::int64_t> keys;
+  std::vector<std::int64_t> values;
+  for (int64_t i = 0; i < num_keys; ++i) {
+    // Keys sharing their low bits
+    keys.push_back(i * 4096);
+    values.push_back(i);
+  }
+
+  std::vector<std::int64_t> input;
+  std::vector<std::int64_t> output;
+  for (int64_t i = 0; i < num_inputs; ++i) {
+    const int64_t key = (i % (2 * num_keys)) * 2048;
+    input.push_back(key);
+    output.push_back(key % 4096 == 0 ? key / 4096 : -1);
+  }
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+  test.AddAttribute("keys_int64s", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)-1);
+
+  test.AddInput<std::int64_t>("X", {num_inputs}, input);
+  test.AddOutput<std::int64_t>("Y", {num_inputs}, output);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
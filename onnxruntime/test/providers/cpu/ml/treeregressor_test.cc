@@ -183,5 +183,125 @@ TEST(MLOpTest, TreeRegressorSingleTargetMax) {
   GenTreeAndRunTest1("MAX", true);
 }
 
+// The nodes are not listed in breadth-first order and their ids don't match their positions.
+TEST(MLOpTest, TreeRegressorNodesNotInBreadthFirstOrder) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> nodeids = {0, 3, 1, 4, 2};
+  std::vector<int64_t> lefts = {1, 0, 2, 0, 0};
+  std::vector<int64_t> rights = {4, 0, 3, 0, 0};
+  std::vector<int64_t> treeids = {0, 0, 0, 0, 0};
+  std::vector<int64_t> featureids = {0, 0, 1, 0, 0};
+  std::vector<float> thresholds = {0.5f, 0.f, 0.5f, 0.f, 0.f};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF"};
+
+  std::vector<int64_t> target_treeids = {0, 0, 0};
+  std::vector<int64_t> target_nodeids = {2, 3, 4};
+  std::vector<int64_t> target_classids = {0, 0, 0};
+  std::vector<float> target_weights = {1.f, 10.f, 100.f};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  test.AddInput<float>("X", {4, 2}, {0.f, 0.f, 0.f, 1.f, 1.f, 0.f, 1.f, 1.f});
+  test.AddOutput<float>("Y", {4, 1}, {1.f, 10.f, 100.f, 100.f});
+  test.Run();
+}
+
+// Perfect trees are walked by routines specialized for their depth and branch mode.
+TEST(MLOpTest, TreeRegressorPerfectTree) {
+  std::vector<int64_t> lefts = {1, 3, 5, 0, 0, 0, 0};
+  std::vector<int64_t> rights = {2, 4, 6, 0, 0, 0, 0};
+  std::vector<int64_t> treeids = {0, 0, 0, 0, 0, 0, 0};
+  std::vector<int64_t> nodeids = {0, 1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> featureids = {0, 1, 1, 0, 0, 0, 0};
+  std::vector<float> thresholds = {0.5f, 0.5f, 1.5f, 0.f, 0.f, 0.f, 0.f};
+  std::vector<std::string> modes = {"BRANCH_GT", "BRANCH_GT", "BRANCH_GT", "LEAF", "LEAF", "LEAF", "LEAF"};
+
+  std::vector<int64_t> target_treeids = {0, 0, 0, 0};
+  std::vector<int64_t> target_nodeids = {3, 4, 5, 6};
+  std::vector<int64_t> target_classids = {0, 0, 0, 0};
+  std::vector<float> target_weights = {1.f, 2.f, 3.f, 4.f};
+
+  std::vector<float> X = {1.f, 1.f, 1.f, 0.f, 0.f, 2.f, 0.f, 1.f};
+  std::vector<float> results = {1.f, 2.f, 3.f, 4.f};
+
+  for (int64_t N : {1, 4}) {
+    OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+    test.AddAttribute("nodes_truenodeids", lefts);
+    test.AddAttribute("nodes_falsenodeids", rights);
+    test.AddAttribute("nodes_treeids", treeids);
+    test.AddAttribute("nodes_nodeids", nodeids);
+    test.AddAttribute("nodes_featureids", featureids);
+    test.AddAttribute("nodes_values", thresholds);
+    test.AddAttribute("nodes_modes", modes);
+    test.AddAttribute("target_treeids", target_treeids);
+    test.AddAttribute("target_nodeids", target_nodeids);
+    test.AddAttribute("target_ids", target_classids);
+    test.AddAttribute("target_weights", target_weights);
+    test.AddAttribute("n_targets", (int64_t)1);
+
+    test.AddInput<float>("X", {N, 2}, std::vector<float>(X.begin(), X.begin() + N * 2));
+    test.AddOutput<float>("Y", {N, 1}, std::vector<float>(results.begin(), results.begin() + N));
+    test.Run();
+  }
+}
+
+// Enough rows for a full block of rows walked together through the trees, plus rows walked one by one.
+TEST(MLOpTest, TreeRegressorBlockOfRows) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> lefts = {1, 2, 0, 0, 0, 1, 0, 0};
+  std::vector<int64_t> rights = {4, 3, 0, 0, 0, 2, 0, 0};
+  std::vector<int64_t> treeids = {0, 0, 0, 0, 0, 1, 1, 1};
+  std::vector<int64_t> nodeids = {0, 1, 2, 3, 4, 0, 1, 2};
+  std::vector<int64_t> featureids = {0, 1, 0, 0, 0, 1, 0, 0};
+  std::vector<float> thresholds = {0.5f, 0.5f, 0.f, 0.f, 0.f, 0.5f, 0.f, 0.f};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "LEAF", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF"};
+
+  std::vector<int64_t> target_treeids = {0, 0, 0, 1, 1};
+  std::vector<int64_t> target_nodeids = {2, 3, 4, 1, 2};
+  std::vector<int64_t> target_classids = {0, 0, 0, 0, 0};
+  std::vector<float> target_weights = {1.f, 10.f, 100.f, 1000.f, 2000.f};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  const int64_t N = 75;
+  std::vector<float> X;
+  std::vector<float> results;
+  for (int64_t i = 0; i < N; ++i) {
+    float x0 = static_cast<float>(i % 2);
+    float x1 = static_cast<float>((i / 2) % 2);
+    X.push_back(x0);
+    X.push_back(x1);
+    results.push_back((x0 > 0.5f ? 100.f : (x1 > 0.5f ? 10.f : 1.f)) + (x1 > 0.5f ? 2000.f : 1000.f));
+  }
+
+  test.AddInput<float>("X", {N, 2}, X);
+  test.AddOutput<float>("Y", {N, 1}, results);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
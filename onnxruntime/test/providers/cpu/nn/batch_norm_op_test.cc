@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "core/framework/tensor.h"
+#include "core/framework/session_options.h"
 #include "core/session/inference_session.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -635,6 +638,49 @@ TEST(BatchNormTest, NonSpatial_Complicated) {
                 8);  // opset-8
 }
 
+// The channel planes are large enough to be split over the intra-op thread pool, and their size isn't a multiple
+// of the vector width. The expected values are computed here.
+TEST(BatchNormTest, SpatialThreaded) {
+  const int64_t N = 2, C = 64, H = 47, W = 47;
+  const int64_t sample_size = H * W;
+  vector<float> X(N * C * sample_size);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>(static_cast<int>(i * 37 % 101) - 50) / 25.0f;
+  }
+  vector<float> scale(C), B(C), mean(C), var(C);
+  for (int64_t c = 0; c < C; ++c) {
+    scale[c] = 0.5f + static_cast<float>(c % 5) * 0.25f;
+    B[c] = static_cast<float>(c % 7) * 0.1f - 0.3f;
+    mean[c] = static_cast<float>(c % 3) * 0.2f - 0.2f;
+    var[c] = 0.5f + static_cast<float>(c % 4) * 0.5f;
+  }
+  const float epsilon = 1e-05f;
+
+  vector<float> expected_output(X.size());
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t c = 0; c < C; ++c) {
+      const double inv_std = 1.0 / std::sqrt(static_cast<double>(var[c]) + epsilon);
+      for (int64_t i = 0; i < sample_size; ++i) {
+        const int64_t index = (n * C + c) * sample_size + i;
+        expected_output[index] = static_cast<float>((X[index] - mean[c]) * inv_std * scale[c] + B[c]);
+      }
+    }
+  }
+
+  OpTester test("BatchNormalization");
+  test.AddAttribute("epsilon", epsilon);
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("scale", {C}, scale);
+  test.AddInput<float>("B", {C}, B);
+  test.AddInput<float>("mean", {C}, mean);
+  test.AddInput<float>("var", {C}, var);
+  test.AddOutput<float>("output", {N, C, H, W}, expected_output);
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 4;
+  test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 // Only CUDA kernel has float 16 support
 #ifdef USE_CUDA
 TEST(BatchNormTest, BatchNorm2d_fp16) {
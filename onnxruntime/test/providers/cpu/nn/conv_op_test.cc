@@ -632,5 +632,47 @@ TEST(ConvTest, ConvDimWithZero) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, {}, out_shape, OpTester::ExpectResult::kExpectSuccess, "", 10);
 }
 
+// A 3x3 convolution with enough channels and output tiles for MLAS to use the Winograd algorithm,
+// with constant weights so that the CPU kernel transforms the filter when it is created.
+TEST(ConvTest, Conv2D_Winograd_ConstantWeights) {
+  const int64_t C = 16, M = 24, H = 9, W_ = 11;
+  vector<float> X(C * H * W_);
+  vector<float> W(M * C * 3 * 3);
+  vector<float> B(M);
+  for (size_t i = 0; i < X.size(); i++) X[i] = static_cast<float>(static_cast<int>(i % 13) - 6) / 8.0f;
+  for (size_t i = 0; i < W.size(); i++) W[i] = static_cast<float>(static_cast<int>(i % 7) - 3) / 4.0f;
+  for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(i) / 2.0f;
+
+  // pads of 1 keep the output the size of the input
+  vector<float> Y(M * H * W_);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t oh = 0; oh < H; oh++) {
+      for (int64_t ow = 0; ow < W_; ow++) {
+        float sum = B[m];
+        for (int64_t c = 0; c < C; c++) {
+          for (int64_t kh = 0; kh < 3; kh++) {
+            for (int64_t kw = 0; kw < 3; kw++) {
+              const int64_t ih = oh + kh - 1, iw = ow + kw - 1;
+              if (ih >= 0 && ih < H && iw >= 0 && iw < W_) {
+                sum += X[(c * H + ih) * W_ + iw] * W[((m * C + c) * 3 + kh) * 3 + kw];
+              }
+            }
+          }
+        }
+        Y[(m * H + oh) * W_ + ow] = sum;
+      }
+    }
+  }
+
+  OpTester test("Conv");
+  test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+  test.AddAttribute("pads", vector<int64_t>{1, 1, 1, 1});
+  test.AddInput<float>("X", {1, C, H, W_}, X);
+  test.AddInput<float>("W", {M, C, 3, 3}, W, true);
+  test.AddInput<float>("B", {M}, B, true);
+  test.AddOutput<float>("Y", {1, M, H, W_}, Y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -552,6 +552,37 @@ TEST(ConvTransposeTest, ConvTranspose_2D_NonDefaultStridesAndDilations) {
   TestConvTransposeOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
 }
 
+TEST(ConvTransposeTest, ConvTranspose_2D_StrideEqualsKernel_Bias) {
+  ConvTransposeOpAttributes attrs = {
+      vector<int64_t>{2, 2},        // kernel_shape
+      {},                           // output_padding
+      {},                           // output_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{2, 2},        // strides
+      vector<int64_t>{1, 1},        // dilations
+      1                             // group
+  };
+  vector<float> X = {1.f, 2.f, 3.f, 4.f,
+                     -1.f, 0.f, 2.f, 1.f};
+  vector<int64_t> X_shape = {1, 2, 2, 2};
+  vector<float> W = {1.f, 0.f, 2.f, -1.f, 0.5f, 1.f, 0.f, 2.f,
+                     -1.f, 1.f, 0.f, 1.f, 2.f, 0.f, 1.f, 1.f};
+  vector<int64_t> W_shape = {2, 2, 2, 2};
+  vector<float> B = {0.5f, -1.f};
+  vector<int64_t> B_shape = {2};
+  vector<int64_t> Y_shape = {1, 2, 4, 4};
+  auto expected_vals = {2.5f, -0.5f, 2.5f, 0.5f,
+                        2.5f, -1.5f, 4.5f, -1.5f,
+                        1.5f, 2.5f, 3.5f, 1.5f,
+                        6.5f, -0.5f, 8.5f, -2.5f,
+                        -2.5f, 0.f, 0.f, 1.f,
+                        -2.f, 0.f, -1.f, 3.f,
+                        4.5f, 2.f, 3.f, 3.f,
+                        1.f, 7.f, 0.f, 8.f};
+
+  TestConvTransposeOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
+
 TEST(ConvTransposeTest, DimWithZero) {
   ConvTransposeOpAttributes attrs = {
       vector<int64_t>{3, 3},        // kernel_shape
@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
+#include "core/framework/session_options.h"
 #include "test/providers/provider_test_utils.h"
 using namespace std;
 namespace onnxruntime {
@@ -114,5 +117,54 @@ TEST(InstanceNormalizationOpTest, InstanceNorm_2) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// The channel planes are large enough to be split over the intra-op thread pool, their size isn't a multiple of the
+// vector width, and their means are far from zero relative to their spread. The expected values are computed here.
+TEST(InstanceNormalizationOpTest, InstanceNormThreaded) {
+  const int64_t N = 2, C = 64, H = 47, W = 47;
+  const int64_t sample_size = H * W;
+  const float epsilon = 1e-05f;
+  vector<float> input(N * C * sample_size);
+  for (size_t i = 0; i < input.size(); ++i) {
+    const size_t c = i / sample_size % C;
+    input[i] = static_cast<float>(c) * 0.5f + static_cast<float>(static_cast<int>(i * 37 % 101) - 50) / 25.0f;
+  }
+  vector<float> scale(C), B(C);
+  for (int64_t c = 0; c < C; ++c) {
+    scale[c] = 0.5f + static_cast<float>(c % 5) * 0.25f;
+    B[c] = static_cast<float>(c % 7) * 0.1f - 0.3f;
+  }
+
+  vector<float> expected_output(input.size());
+  for (int64_t i = 0; i < N * C; ++i) {
+    const float* x = input.data() + i * sample_size;
+    double mean = 0.0;
+    for (int64_t j = 0; j < sample_size; ++j) {
+      mean += x[j];
+    }
+    mean /= sample_size;
+    double variance = 0.0;
+    for (int64_t j = 0; j < sample_size; ++j) {
+      variance += (x[j] - mean) * (x[j] - mean);
+    }
+    variance /= sample_size;
+    const double inv_std = 1.0 / std::sqrt(variance + epsilon);
+    for (int64_t j = 0; j < sample_size; ++j) {
+      expected_output[i * sample_size + j] = static_cast<float>((x[j] - mean) * inv_std * scale[i % C] + B[i % C]);
+    }
+  }
+
+  OpTester test("InstanceNormalization");
+  test.AddAttribute("epsilon", epsilon);
+  vector<int64_t> input_dims = {N, C, H, W};
+  test.AddInput<float>("input", input_dims, input);
+  test.AddInput<float>("scale", {C}, scale);
+  test.AddInput<float>("B", {C}, B);
+  test.AddOutput<float>("Y", input_dims, expected_output);
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 4;
+  test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
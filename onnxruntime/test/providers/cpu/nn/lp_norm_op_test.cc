@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
+#include "core/framework/session_options.h"
 #include "test/providers/provider_test_utils.h"
 using namespace std;
 namespace onnxruntime {
@@ -107,5 +110,67 @@ TEST(LpNormalizationTest, L1NormalizationWithValidNegativeAxis) {
   test.Run();
 }
 
+// Normalizes along 'axis' of a tensor large enough to be split over the intra-op thread pool, with one vector of
+// zeros. The expected values are computed here.
+static void RunLpNormalizationThreadedTest(const vector<int64_t>& input_dims, int64_t axis, int64_t p) {
+  int64_t size = 1;
+  for (auto dim : input_dims) {
+    size *= dim;
+  }
+  const int64_t m = input_dims[axis];
+  int64_t sf = 1;
+  for (size_t i = static_cast<size_t>(axis) + 1; i < input_dims.size(); ++i) {
+    sf *= input_dims[i];
+  }
+
+  vector<float> input(size);
+  for (int64_t i = 0; i < size; ++i) {
+    input[i] = static_cast<float>(static_cast<int>(i * 37 % 101) - 50) / 25.0f;
+  }
+  // vector i starts at element i % sf of block i / sf, and its elements are sf apart
+  auto vector_base = [&](int64_t i) { return (i / sf) * sf * m + (i % sf); };
+  for (int64_t j = 0; j < m; ++j) {
+    input[vector_base(sf + 5) + j * sf] = 0.0f;
+  }
+
+  vector<float> expected_output(size);
+  for (int64_t i = 0; i < size / m; ++i) {
+    const int64_t base = vector_base(i);
+    double norm = 0.0;
+    for (int64_t j = 0; j < m; ++j) {
+      const double x = input[base + j * sf];
+      norm += p == 1 ? std::abs(x) : x * x;
+    }
+    if (p == 2) {
+      norm = std::sqrt(norm);
+    }
+    for (int64_t j = 0; j < m; ++j) {
+      expected_output[base + j * sf] = norm != 0.0 ? static_cast<float>(input[base + j * sf] / norm) : 0.0f;
+    }
+  }
+
+  OpTester test("LpNormalization");
+  test.AddAttribute("axis", axis);
+  test.AddAttribute("p", p);
+  test.AddInput<float>("input", input_dims, input);
+  test.AddOutput<float>("Y", input_dims, expected_output);
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 4;
+  test.Run(so);
+}
+
+// The innermost axis, and an outer axis whose blocks of interleaved vectors are split into several runs of columns,
+// the last of them partial.
+TEST(LpNormalizationTest, L1NormalizationThreaded) {
+  RunLpNormalizationThreadedTest({256, 600}, 1, 1);
+  RunLpNormalizationThreadedTest({4, 64, 600}, 1, 1);
+}
+
+TEST(LpNormalizationTest, L2NormalizationThreaded) {
+  RunLpNormalizationThreadedTest({256, 600}, 1, 2);
+  RunLpNormalizationThreadedTest({4, 64, 600}, 1, 2);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <random>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -73,15 +75,23 @@ void TestQLinearConvOp(OpTester& test,
                        const QuantizedBiasTensor* B,
                        const QuantizedTensor& Y,
                        const std::vector<int64_t>& Y_shape,
-                       const std::unordered_set<std::string>& excluded_provider_types = {}) {
+                       const std::unordered_set<std::string>& excluded_provider_types = {},
+                       const std::vector<float>& W_channel_scales = {}) {
 
   test.AddInput<uint8_t>("x", X_shape, X.quantized_);
   test.AddInput<float>("x_scale", {}, {X.scale_});
   test.AddInput<uint8_t>("x_zero_point", {}, {X.zero_point_});
 
   test.AddInput<uint8_t>("w", W_shape, W.quantized_);
-  test.AddInput<float>("w_scale", {}, {W.scale_});
-  test.AddInput<uint8_t>("w_zero_point", {}, {W.zero_point_});
+  if (W_channel_scales.empty()) {
+    test.AddInput<float>("w_scale", {}, {W.scale_});
+    test.AddInput<uint8_t>("w_zero_point", {}, {W.zero_point_});
+  } else {
+    const std::vector<int64_t> channel_shape{static_cast<int64_t>(W_channel_scales.size())};
+    test.AddInput<float>("w_scale", channel_shape, W_channel_scales);
+    test.AddInput<uint8_t>("w_zero_point", channel_shape,
+                           std::vector<uint8_t>(W_channel_scales.size(), W.zero_point_));
+  }
 
   test.AddInput<float>("y_scale", {}, {Y.scale_});
   test.AddInput<uint8_t>("y_zero_point", {}, {Y.zero_point_});
@@ -96,6 +106,113 @@ void TestQLinearConvOp(OpTester& test,
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", excluded_provider_types);
 }
 
+// Computes the expected output of a 2D depthwise QLinearConv (group == C == M) with an NCHW layout.
+std::vector<uint8_t> ComputeDepthwiseReference(const QuantizedTensor& X,
+                                               const std::vector<int64_t>& X_shape,
+                                               const QuantizedTensor& W,
+                                               const std::vector<float>& W_channel_scales,
+                                               const std::vector<int64_t>& W_shape,
+                                               const std::vector<int32_t>& B,
+                                               float Y_scale,
+                                               uint8_t Y_zero_point,
+                                               const std::vector<int64_t>& Y_shape,
+                                               const std::vector<int64_t>& pads,
+                                               const std::vector<int64_t>& strides,
+                                               const std::vector<int64_t>& dilations) {
+  const int64_t N = X_shape[0], C = X_shape[1], H = X_shape[2], W_in = X_shape[3];
+  const int64_t KH = W_shape[2], KW = W_shape[3];
+  const int64_t OH = Y_shape[2], OW = Y_shape[3];
+
+  std::vector<uint8_t> Y(static_cast<size_t>(N * C * OH * OW));
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t c = 0; c < C; c++) {
+      const float W_scale = W_channel_scales.empty() ? W.scale_ : W_channel_scales[c];
+      const float multiplier = (X.scale_ * W_scale) / Y_scale;
+      for (int64_t oh = 0; oh < OH; oh++) {
+        for (int64_t ow = 0; ow < OW; ow++) {
+          int32_t sum = B.empty() ? 0 : B[c];
+          for (int64_t kh = 0; kh < KH; kh++) {
+            for (int64_t kw = 0; kw < KW; kw++) {
+              const int64_t ih = oh * strides[0] - pads[0] + kh * dilations[0];
+              const int64_t iw = ow * strides[1] - pads[1] + kw * dilations[1];
+              if (ih >= 0 && ih < H && iw >= 0 && iw < W_in) {
+                const int32_t x = X.quantized_[((n * C + c) * H + ih) * W_in + iw];
+                const int32_t w = W.quantized_[(c * KH + kh) * KW + kw];
+                sum += (x - X.zero_point_) * (w - W.zero_point_);
+              }
+            }
+          }
+          float value = static_cast<float>(sum) * multiplier;
+          value = std::min(std::max(value, static_cast<float>(0 - Y_zero_point)), static_cast<float>(255 - Y_zero_point));
+          Y[((n * C + c) * OH + oh) * OW + ow] = static_cast<uint8_t>(static_cast<int32_t>(std::nearbyint(value)) + Y_zero_point);
+        }
+      }
+    }
+  }
+  return Y;
+}
+
+void TestDepthwiseQLinearConvOp(const std::vector<int64_t>& X_shape,
+                                const std::vector<int64_t>& W_shape,
+                                const std::vector<int64_t>& Y_shape,
+                                const std::vector<int64_t>& pads,
+                                const std::vector<int64_t>& strides,
+                                const std::vector<int64_t>& dilations,
+                                bool with_bias,
+                                bool per_channel = false) {
+  std::default_random_engine generator(static_cast<unsigned>(X_shape[1] * W_shape[2]));
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::uniform_int_distribution<int32_t> bias_distribution(-2000, 2000);
+
+  std::vector<uint8_t> X_data(static_cast<size_t>(X_shape[0] * X_shape[1] * X_shape[2] * X_shape[3]));
+  for (auto& x : X_data) {
+    x = static_cast<uint8_t>(distribution(generator));
+  }
+  std::vector<uint8_t> W_data(static_cast<size_t>(W_shape[0] * W_shape[2] * W_shape[3]));
+  for (auto& w : W_data) {
+    w = static_cast<uint8_t>(distribution(generator));
+  }
+  std::vector<int32_t> B_data;
+  if (with_bias) {
+    B_data.resize(static_cast<size_t>(W_shape[0]));
+    for (auto& b : B_data) {
+      b = bias_distribution(generator);
+    }
+  }
+
+  QuantizedTensor X(X_data, 0.01f, 131);
+  QuantizedTensor W(W_data, 0.02f, 119);
+  QuantizedBiasTensor B(B_data, X.scale_ * W.scale_);
+
+  std::vector<float> W_channel_scales;
+  if (per_channel) {
+    for (int64_t c = 0; c < W_shape[0]; c++) {
+      W_channel_scales.push_back(0.005f + 0.003f * static_cast<float>(c));
+    }
+  }
+
+  const float Y_scale = 0.05f;
+  const uint8_t Y_zero_point = 127;
+  QuantizedTensor Y(ComputeDepthwiseReference(X, X_shape, W, W_channel_scales, W_shape, B_data, Y_scale, Y_zero_point, Y_shape,
+                                              pads, strides, dilations),
+                    Y_scale, Y_zero_point);
+
+  OpTester test("QLinearConv", 10);
+  test.AddAttribute("group", X_shape[1]);
+  test.AddAttribute("pads", pads);
+  test.AddAttribute("strides", strides);
+  test.AddAttribute("dilations", dilations);
+
+  // TODO: nGraph rejects grouped convolutions with bias.
+  TestQLinearConvOp(test,
+                    X, X_shape,
+                    W, W_shape,
+                    with_bias ? &B : nullptr,
+                    Y, Y_shape,
+                    {kNGraphExecutionProvider},
+                    W_channel_scales);
+}
+
 TEST(QLinearConvTest, Conv2DTest) {
   QuantizedTensor X({0.45246148109436035f, 0.15498268604278564f, 0.11199361085891724f, -0.39421093463897705f,
                      0.2626858949661255f, 0.13414543867111206f, -0.27184486389160156f, -0.43028733134269714f,
@@ -239,6 +356,46 @@ TEST(QLinearConvTest, WithGroup_2D) {
                     {kNGraphExecutionProvider});
 }
 
+TEST(QLinearConvTest, Depthwise_2D) {
+  TestDepthwiseQLinearConvOp({2, 11, 7, 6}, {11, 1, 3, 3}, {2, 11, 7, 6},
+                             {1, 1, 1, 1}, {1, 1}, {1, 1}, true);
+}
+
+TEST(QLinearConvTest, Depthwise_2D_NoBias) {
+  TestDepthwiseQLinearConvOp({1, 24, 6, 6}, {24, 1, 5, 5}, {1, 24, 6, 6},
+                             {2, 2, 2, 2}, {1, 1}, {1, 1}, false);
+}
+
+TEST(QLinearConvTest, Depthwise_2D_Strides) {
+  TestDepthwiseQLinearConvOp({1, 16, 7, 6}, {16, 1, 3, 3}, {1, 16, 3, 3},
+                             {1, 1, 0, 1}, {2, 2}, {1, 1}, true);
+}
+
+TEST(QLinearConvTest, Depthwise_2D_Dilations) {
+  TestDepthwiseQLinearConvOp({1, 9, 7, 6}, {9, 1, 3, 3}, {1, 9, 7, 6},
+                             {2, 2, 2, 2}, {1, 1}, {2, 2}, true);
+}
+
+TEST(QLinearConvTest, Depthwise_2D_PerChannel) {
+  TestDepthwiseQLinearConvOp({1, 13, 7, 6}, {13, 1, 3, 3}, {1, 13, 7, 6},
+                             {1, 1, 1, 1}, {1, 1}, {1, 1}, true, true);
+}
+
+TEST(QLinearConvTest, PerChannel_2D) {
+  // each output channel of the filter has its own scale
+  OpTester test("QLinearConv", 10);
+  test.AddInput<uint8_t>("x", {1, 1, 2, 2}, {1, 2, 3, 4});
+  test.AddInput<float>("x_scale", {}, {1.f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {0});
+  test.AddInput<uint8_t>("w", {2, 1, 1, 1}, {1, 2});
+  test.AddInput<float>("w_scale", {2}, {1.f, 2.f});
+  test.AddInput<uint8_t>("w_zero_point", {2}, {0, 0});
+  test.AddInput<float>("y_scale", {}, {1.f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {0});
+  test.AddOutput<uint8_t>("y", {1, 2, 2, 2}, {1, 2, 3, 4, 4, 8, 12, 16});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider});
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace onnxruntime
@@ -383,5 +383,35 @@ TEST(NonMaxSuppressionOpTest, WithIOUThresholdOpset11) {
   test.Run();
 }
 
+// Boxes 20 to 39 overlap boxes 0 to 19, which don't overlap each other, so each class selects 20 boxes. The scores of
+// class 0 are already sorted, and the scores of class 1 are in reverse order.
+TEST(NonMaxSuppressionOpTest, ManySelectedBoxesTwoClasses) {
+  const int64_t num_boxes = 40;
+  std::vector<float> boxes;
+  std::vector<float> scores(2 * num_boxes);
+  for (int64_t i = 0; i < num_boxes; ++i) {
+    const float x = 2.0f * (i % 20) + (i < 20 ? 0.0f : 0.05f);
+    boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    scores[i] = 1.0f - 0.01f * i;
+    scores[num_boxes + i] = 0.01f * (i + 1);
+  }
+
+  std::vector<int64_t> selected_indices;
+  for (int64_t i = 0; i < 20; ++i) {
+    selected_indices.insert(selected_indices.end(), {0L, 0L, i});
+  }
+  for (int64_t i = 0; i < 20; ++i) {
+    selected_indices.insert(selected_indices.end(), {0L, 1L, num_boxes - 1 - i});
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {1, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {1, 2, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {30L});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddOutput<int64_t>("selected_indices", {40, 3}, selected_indices);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
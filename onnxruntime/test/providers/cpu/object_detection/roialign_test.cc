@@ -343,5 +343,33 @@ TEST(RoiAlignTest, MismatchNumRois) {
 
   test.Run(OpTester::ExpectResult::kExpectFailure, "[ShapeInferenceError] Dimension mismatch in unification between 4 and 5");
 }
+
+// Each channel is constant, so the interpolated values of a ROI inside the image equal the channel value. There are
+// more channels than a block of the CPU kernel, which splits the channels of a ROI across threads.
+TEST(RoiAlignTest, AvgModeManyChannels) {
+  OpTester test("RoiAlign", 10);
+  test.AddAttribute<int64_t>("output_height", 2);
+  test.AddAttribute<int64_t>("output_width", 2);
+  test.AddAttribute<int64_t>("sampling_ratio", 2);
+  test.AddAttribute<float>("spatial_scale", 1.0f);
+
+  constexpr int64_t N = 1, C = 37, H = 5, W = 5;
+  std::vector<float> X;
+  for (int64_t c = 0; c < C; ++c) {
+    X.insert(X.end(), H * W, static_cast<float>(c));
+  }
+  std::vector<float> Y;
+  for (int64_t roi = 0; roi < 2; ++roi) {
+    for (int64_t c = 0; c < C; ++c) {
+      Y.insert(Y.end(), 2 * 2, static_cast<float>(c));
+    }
+  }
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("rois", {2, 4}, {0., 0., 4., 4., 1., 1., 3., 3.});
+  test.AddInput<int64_t>("batch_indices", {2}, {0, 0});
+  test.AddOutput<float>("Y", {2, C, 2, 2}, Y);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,8 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <random>
 #include <cmath>
+#include <limits>
+#include <tuple>
 #include <type_traits>
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
@@ -1202,6 +1205,122 @@ TEST(ReductionOpTest, ReduceSum_apex_more) {
   }
 }
 
+// Runs ReduceSum, ReduceMean and ReduceMax on a single group of adjacent axes, with small integer values so the
+// expected sums are exact whatever the order of the additions.
+static void TestReduceSumMeanMaxOnAxes(const std::vector<int64_t>& dims, int64_t first_axis, int64_t last_axis) {
+  int64_t outer = 1, reduced = 1, inner = 1;
+  std::vector<int64_t> axes, reduced_dims;
+  for (int64_t i = 0; i < static_cast<int64_t>(dims.size()); ++i) {
+    if (i < first_axis) {
+      outer *= dims[i];
+      reduced_dims.push_back(dims[i]);
+    } else if (i <= last_axis) {
+      reduced *= dims[i];
+      axes.push_back(i);
+    } else {
+      inner *= dims[i];
+      reduced_dims.push_back(dims[i]);
+    }
+  }
+
+  std::vector<float> X(outer * reduced * inner);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>((i * 7) % 11);
+  }
+
+  std::vector<float> sum(outer * inner, 0.0f), mean(outer * inner), max(outer * inner, -1.0f);
+  for (int64_t o = 0; o < outer; ++o) {
+    for (int64_t r = 0; r < reduced; ++r) {
+      for (int64_t i = 0; i < inner; ++i) {
+        const float value = X[(o * reduced + r) * inner + i];
+        sum[o * inner + i] += value;
+        max[o * inner + i] = std::max(max[o * inner + i], value);
+      }
+    }
+  }
+  for (size_t i = 0; i < sum.size(); ++i) {
+    mean[i] = sum[i] / static_cast<float>(reduced);
+  }
+
+  const std::pair<const char*, const std::vector<float>*> ops[] = {
+      {"ReduceSum", &sum}, {"ReduceMean", &mean}, {"ReduceMax", &max}};
+  for (const auto& op : ops) {
+    OpTester test(op.first);
+    test.AddAttribute("keepdims", (int64_t)0);
+    test.AddAttribute("axes", axes);
+    test.AddInput<float>("data", dims, X);
+    test.AddOutput<float>("reduced", reduced_dims, *op.second);
+    test.Run();
+  }
+}
+
+TEST(ReductionOpTest, ReduceSumMeanMax_adjacent_axes) {
+  // innermost, outermost and middle axes
+  TestReduceSumMeanMaxOnAxes({6, 5, 40}, 1, 2);
+  TestReduceSumMeanMaxOnAxes({40, 5, 6}, 0, 1);
+  TestReduceSumMeanMaxOnAxes({4, 30, 3, 20}, 1, 2);
+  TestReduceSumMeanMaxOnAxes({4, 1, 30, 1, 20}, 2, 2);
+}
+
+TEST(ReductionOpTest, ReduceSumMeanMax_large_reduced_dim) {
+  // few outputs with a large reduced dim, which is split across threads
+  TestReduceSumMeanMaxOnAxes({100000}, 0, 0);
+  TestReduceSumMeanMaxOnAxes({2, 50000}, 1, 1);
+  TestReduceSumMeanMaxOnAxes({30000, 3}, 0, 0);
+  TestReduceSumMeanMaxOnAxes({2, 20000, 3}, 1, 1);
+}
+
+// Runs ReduceMin, ReduceL1, ReduceL2 and ReduceLogSum on the leading or the trailing axes of a m-by-n matrix,
+// which the CUDA EP reduces without cuDNN.
+static void TestReduceMinNormsOnMatrix(int64_t m, int64_t n, bool reduce_rows) {
+  std::vector<float> X(m * n);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>((i * 7) % 11) - 3.0f;
+  }
+
+  const int64_t num_outputs = reduce_rows ? n : m;
+  std::vector<float> min(num_outputs, std::numeric_limits<float>::max()), l1(num_outputs, 0.0f),
+      l2(num_outputs, 0.0f), log_sum(num_outputs, 0.0f);
+  for (int64_t r = 0; r < m; ++r) {
+    for (int64_t c = 0; c < n; ++c) {
+      const float value = X[r * n + c];
+      const int64_t o = reduce_rows ? c : r;
+      min[o] = std::min(min[o], value);
+      l1[o] += std::abs(value);
+      l2[o] += value * value;
+      // shifted so the sums stay positive
+      log_sum[o] += value + 3.0f;
+    }
+  }
+  for (int64_t o = 0; o < num_outputs; ++o) {
+    l2[o] = std::sqrt(l2[o]);
+    log_sum[o] = std::log(log_sum[o]);
+  }
+  std::vector<float> shifted_X(X);
+  for (auto& value : shifted_X) {
+    value += 3.0f;
+  }
+
+  const std::tuple<const char*, const std::vector<float>*, const std::vector<float>*> ops[] = {
+      std::make_tuple("ReduceMin", &X, &min), std::make_tuple("ReduceL1", &X, &l1),
+      std::make_tuple("ReduceL2", &X, &l2), std::make_tuple("ReduceLogSum", &shifted_X, &log_sum)};
+  for (const auto& op : ops) {
+    OpTester test(std::get<0>(op));
+    test.AddAttribute("keepdims", (int64_t)0);
+    test.AddAttribute("axes", std::vector<int64_t>{reduce_rows ? 0 : 1});
+    test.AddInput<float>("data", {m, n}, *std::get<1>(op));
+    test.AddOutput<float>("reduced", {num_outputs}, *std::get<2>(op));
+    test.Run();
+  }
+}
+
+TEST(ReductionOpTest, ReduceMinNorms_leading_and_trailing_axes) {
+  // rows reduced by a warp, rows reduced by a block, and the rows reduced together
+  TestReduceMinNormsOnMatrix(6, 70, false);
+  TestReduceMinNormsOnMatrix(3, 3000, false);
+  TestReduceMinNormsOnMatrix(700, 6, true);
+}
+
 TEST(ReductionOpTest, ReduceSum_int64) {
   OpTester test("ReduceSum");
   test.AddAttribute("axes", std::vector<int64_t>{0, 2});
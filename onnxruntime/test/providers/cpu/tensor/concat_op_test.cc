@@ -233,5 +233,34 @@ TEST(ConcatOpTest, Concat3D_3) {
   test.Run();
 }
 
+TEST(ConcatOpTest, Concat2D_LargeBlocksWithEmptyInput) {
+  // rows made of a few large blocks, which are split between threads, and an empty input between them
+  OpTester test("Concat");
+  test.AddAttribute("axis", int64_t{1});
+
+  const int64_t rows = 3;
+  const int64_t cols_1 = 1000;
+  const int64_t cols_2 = 2500;
+  std::vector<float> input1(rows * cols_1);
+  std::vector<float> input2(rows * cols_2);
+  std::vector<float> output;
+  for (int64_t row = 0; row < rows; ++row) {
+    for (int64_t col = 0; col < cols_1; ++col) {
+      input1[row * cols_1 + col] = static_cast<float>(row * 10000 + col);
+      output.push_back(input1[row * cols_1 + col]);
+    }
+    for (int64_t col = 0; col < cols_2; ++col) {
+      input2[row * cols_2 + col] = static_cast<float>(-(row * 10000 + col));
+      output.push_back(input2[row * cols_2 + col]);
+    }
+  }
+
+  test.AddInput<float>("input1", {rows, cols_1}, input1);
+  test.AddInput<float>("input2", {rows, 0}, {});
+  test.AddInput<float>("input3", {rows, cols_2}, input2);
+  test.AddOutput<float>("concat_result", {rows, cols_1 + cols_2}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
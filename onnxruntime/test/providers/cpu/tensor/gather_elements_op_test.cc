@@ -315,5 +315,37 @@ TEST(GatherElementsOpTest, string) {
   RunTypedTest<std::string>();
 }
 
+TEST(GatherElementsOpTest, LargeInput) {
+  // enough 'inner dimension' chunks to be split across threads, gathering along an outer and the innermost axis
+  const int64_t dim0 = 4, dim1 = 64, dim2 = 48;
+  std::vector<float> input(dim0 * dim1 * dim2);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i);
+  }
+
+  for (int64_t axis : {1LL, 2LL}) {
+    const int64_t axis_dim = axis == 1 ? dim1 : dim2;
+    std::vector<int32_t> indices(input.size());
+    std::vector<float> output(input.size());
+    for (int64_t i = 0; i < dim0; ++i) {
+      for (int64_t j = 0; j < dim1; ++j) {
+        for (int64_t k = 0; k < dim2; ++k) {
+          const int64_t n = (i * dim1 + j) * dim2 + k;
+          const int64_t idx = (n * 31) % axis_dim;
+          indices[n] = static_cast<int32_t>(n % 2 == 0 ? idx : idx - axis_dim);
+          output[n] = axis == 1 ? input[(i * dim1 + idx) * dim2 + k] : input[(i * dim1 + j) * dim2 + idx];
+        }
+      }
+    }
+
+    OpTester test("GatherElements", 11);
+    test.AddAttribute<int64_t>("axis", axis);
+    test.AddInput<float>("data", {dim0, dim1, dim2}, input);
+    test.AddInput<int32_t>("indices", {dim0, dim1, dim2}, indices);
+    test.AddOutput<float>("output", {dim0, dim1, dim2}, output);
+    test.Run();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -328,5 +328,44 @@ TEST(GatherOpTest, Gather_axis1_neg_indices2d_int8) {
 
 }
 
+TEST(GatherOpTest, Gather_axis0_large_table) {
+  // a table large enough for the gathered rows to be prefetched, with more indices than the prefetch distance
+  const int64_t rows = 20000, cols = 64, num_indices = 300;
+  std::vector<float> input(rows * cols);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i % 1000);
+  }
+
+  std::vector<int64_t> indices(num_indices);
+  std::vector<float> output;
+  output.reserve(num_indices * cols);
+  for (int64_t i = 0; i < num_indices; ++i) {
+    const int64_t row = (i * 7919) % rows;
+    indices[i] = i % 3 == 0 ? row - rows : row;
+    output.insert(output.end(), input.begin() + row * cols, input.begin() + (row + 1) * cols);
+  }
+
+  OpTester test("Gather", 11);
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<float>("data", {rows, cols}, input);
+  test.AddInput<int64_t>("indices", {num_indices}, indices);
+  test.AddOutput<float>("output", {num_indices, cols}, output);
+  test.Run();
+}
+
+TEST(GatherOpTest, Gather_axis1_odd_block_uint8) {
+  // blocks of 3 bytes are copied bytewise
+  OpTester test("Gather", 11);
+  test.AddAttribute<int64_t>("axis", 1LL);
+  test.AddInput<uint8_t>("data", {2, 4, 3},
+                         {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+                          12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23});
+  test.AddInput<int32_t>("indices", {3}, {3, 0, -2});
+  test.AddOutput<uint8_t>("output", {2, 3, 3},
+                          {9, 10, 11, 0, 1, 2, 6, 7, 8,
+                           21, 22, 23, 12, 13, 14, 18, 19, 20});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "core/providers/cpu/tensor/resize.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 
 namespace onnxruntime {
 namespace test {
@@ -737,6 +738,90 @@ TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_MultiChannel) {
   test.AddOutput<float>("Y", {N, C, sizes[2], sizes[3]}, Y);
   test.Run();
 }
+// Transposes [N, C, H, W] data to [N, H, W, C]
+static std::vector<float> ToChannelsLast(const std::vector<float>& data, int64_t N, int64_t C, int64_t H, int64_t W) {
+  std::vector<float> result(data.size());
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t c = 0; c < C; ++c) {
+      for (int64_t i = 0; i < H * W; ++i) {
+        result[(n * H * W + i) * C + c] = data[(n * C + c) * H * W + i];
+      }
+    }
+  }
+  return result;
+}
+
+TEST(ResizeOpTest, ResizeOpLineartDownSampleTest_4DBilinear_ChannelsLast) {
+  OpTester test("Resize", 11);
+  std::vector<float> roi{};
+  std::vector<float> scales{1.0f, 0.6f, 0.6f, 1.0f};
+
+  test.AddAttribute("mode", "linear");
+
+  const int64_t N = 1, H = 2, W = 4, C = 2;
+  std::vector<float> X = {
+      1.0f, 2.0f, 3.0f, 4.0f,
+      5.0f, 6.0f, 7.0f, 8.0f,
+
+      11.0f, 12.0f, 13.0f, 14.0f,
+      15.0f, 16.0f, 17.0f, 18.0f};
+
+  test.AddInput<float>("X", {N, H, W, C}, ToChannelsLast(X, N, C, H, W));
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("scales", {4}, scales);
+
+  std::vector<float> Y = {2.66666651f, 12.6666665f, 4.3333331f, 14.3333331f};
+
+  test.AddOutput<float>("Y", {N, static_cast<int64_t>(H * scales[1]), static_cast<int64_t>(W * scales[2]), C}, Y);
+  // the channels last layout is only supported by the CPU provider
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+}
+
+// Checks the cubic resizing of [N, H, W, C] inputs against the resizing of the same inputs as [N, C, H, W]
+static void TestCubicChannelsLast(const std::vector<int64_t>& sizes, int64_t exclude_outside) {
+  const int64_t N = 2, H = 5, W = 7, C = 3;
+  std::vector<float> X(N * C * H * W);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>((i * 37) % 23) - 11.0f;
+  }
+
+  std::vector<float> roi{};
+  std::vector<float> scales{};
+  const std::vector<int64_t> channels_first_sizes{sizes[0], sizes[3], sizes[1], sizes[2]};
+
+  OpTester channels_first_test("Resize", 11);
+  channels_first_test.AddAttribute("mode", "cubic");
+  channels_first_test.AddAttribute("exclude_outside", exclude_outside);
+  channels_first_test.AddInput<float>("X", {N, C, H, W}, X);
+  channels_first_test.AddInput<float>("roi", {0}, roi);
+  channels_first_test.AddInput<float>("scales", {0}, scales);
+  channels_first_test.AddInput<int64_t>("sizes", {4}, channels_first_sizes);
+  channels_first_test.AddOutput<float>("Y", channels_first_sizes,
+                                       std::vector<float>(N * C * sizes[1] * sizes[2]));
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  channels_first_test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  std::vector<MLValue> fetches = channels_first_test.GetFetches();
+  const Tensor& channels_first_Y = fetches[0].Get<Tensor>();
+  std::vector<float> Y(channels_first_Y.Data<float>(), channels_first_Y.Data<float>() + channels_first_Y.Shape().Size());
+
+  OpTester test("Resize", 11);
+  test.AddAttribute("mode", "cubic");
+  test.AddAttribute("exclude_outside", exclude_outside);
+  test.AddInput<float>("X", {N, H, W, C}, ToChannelsLast(X, N, C, H, W));
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("scales", {0}, scales);
+  test.AddInput<int64_t>("sizes", {4}, sizes);
+  test.AddOutput<float>("Y", sizes, ToChannelsLast(Y, N, C, sizes[1], sizes[2]));
+  // the channels last layout is only supported by the CPU provider
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+}
+
+TEST(ResizeOpTest, ResizeOpCubicTest_ChannelsLast) {
+  TestCubicChannelsLast({2, 9, 12, 3}, 0);
+  TestCubicChannelsLast({2, 3, 4, 3}, 1);
+}
+
 TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_tf_half_pixel_for_nn) {
   OpTester test("Resize", 11);
   std::vector<float> scales{1.0f, 1.0f, 2.0f, 2.0f};
@@ -289,6 +289,38 @@ TEST(TensorOpTest, CastFromFloat16) {
   TestCastOp(input, int64_t_data, shape, TensorProto::INT64);
 }
 
+TEST(TensorOpTest, CastFloat16LargeTensor) {
+  // large enough to be split across threads and in several blocks of the conversions through float
+  const int64_t size = 10000;
+  std::vector<float> float_data;
+  std::vector<MLFloat16> float16_data;
+  std::vector<int32_t> int32_data;
+  std::vector<int64_t> int64_data;
+  for (int64_t i = 0; i < size; ++i) {
+    const int32_t value = static_cast<int32_t>(i % 2048) - 1024;
+    float_data.push_back(static_cast<float>(value));
+    float16_data.push_back(MLFloat16(math::floatToHalf(static_cast<float>(value))));
+    int32_data.push_back(value);
+    int64_data.push_back(value);
+  }
+
+  auto run_cast = [size](auto& input, auto& output, int64_t to) {
+    using SrcType = typename std::decay<decltype(input)>::type::value_type;
+    using DstType = typename std::decay<decltype(output)>::type::value_type;
+    OpTester test("Cast", 9);
+    test.AddAttribute("to", to);
+    test.AddInput<SrcType>("input", {size}, input);
+    test.AddOutput<DstType>("output", {size}, output);
+    test.Run(ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  };
+
+  run_cast(float_data, float16_data, TensorProto::FLOAT16);
+  run_cast(float16_data, float_data, TensorProto::FLOAT);
+  run_cast(float16_data, int32_data, TensorProto::INT32);
+  run_cast(int64_data, float16_data, TensorProto::FLOAT16);
+  run_cast(float_data, int32_data, TensorProto::INT32);
+}
+
 TEST(TensorOpTest, CastFromString) {
   const std::vector<int64_t> shape{2, 2, 2};
   std::initializer_list<std::string> string_data = {"-inf", "+INF", "0.9767611f", "0.28280696f",
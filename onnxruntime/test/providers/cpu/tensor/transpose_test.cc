@@ -411,6 +411,73 @@ TEST(TransposeOpTest, SingleAxisMovingInwardsBlockCopy) {
   TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals, false);
 }
 
+// Transposes an input of sequential values, checking against the output computed with index arithmetic
+template <typename T>
+static void TestTransposeSequential(const std::vector<int64_t>& perm, const std::vector<int64_t>& x_dims) {
+  const size_t rank = x_dims.size();
+  std::vector<int64_t> y_dims(rank);
+  std::vector<int64_t> x_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    x_strides[i - 1] = x_strides[i] * x_dims[i];
+  }
+  for (size_t i = 0; i < rank; ++i) {
+    y_dims[i] = x_dims[perm[i]];
+  }
+
+  const int64_t size = x_strides[0] * x_dims[0];
+  std::vector<T> X_data(size);
+  for (int64_t i = 0; i < size; ++i) {
+    X_data[i] = static_cast<T>(i);
+  }
+
+  std::vector<T> Y_data(size);
+  std::vector<int64_t> y_index(rank, 0);
+  for (int64_t i = 0; i < size; ++i) {
+    int64_t x_offset = 0;
+    for (size_t j = 0; j < rank; ++j) {
+      x_offset += y_index[j] * x_strides[perm[j]];
+    }
+    Y_data[i] = X_data[x_offset];
+
+    for (size_t j = rank; j > 0 && ++y_index[j - 1] == y_dims[j - 1]; --j) {
+      y_index[j - 1] = 0;
+    }
+  }
+
+  OpTester test("Transpose");
+  test.AddAttribute("perm", perm);
+  test.AddInput<T>("X", x_dims, X_data);
+  test.AddOutput<T>("Y", y_dims, Y_data);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+// transposes that reduce to batched 2D transposes, with sizes that aren't multiples of the tiles
+TEST(TransposeOpTest, BatchedTwoDimTransposes) {
+  TestTransposeSequential<float>({0, 2, 3, 1}, {2, 67, 9, 13});
+  TestTransposeSequential<float>({0, 3, 1, 2}, {1, 19, 23, 130});
+  TestTransposeSequential<uint8_t>({0, 2, 3, 1}, {3, 3, 37, 41});
+  TestTransposeSequential<uint8_t>({1, 0}, {300, 77});
+  TestTransposeSequential<int16_t>({1, 0}, {29, 300});
+  TestTransposeSequential<double>({2, 1, 0}, {5, 1, 70});
+  // the innermost axis is a block of 2 floats that moves with the elements
+  TestTransposeSequential<float>({0, 2, 1, 3}, {4, 33, 17, 2});
+}
+
+// transposes that keep the innermost axis in place, such as the [B, S, H, D] <-> [B, H, S, D] ones of attention
+TEST(TransposeOpTest, InnermostAxisInPlace) {
+  TestTransposeSequential<float>({0, 2, 1, 3}, {2, 7, 3, 40});
+  TestTransposeSequential<uint8_t>({0, 2, 1, 3}, {3, 5, 4, 6});
+  TestTransposeSequential<int16_t>({2, 0, 1, 3}, {4, 9, 3, 5});
+  TestTransposeSequential<int64_t>({1, 0, 2}, {33, 2, 3});
+}
+
+// transposes that only move axes of size 1, which copy the data as is
+TEST(TransposeOpTest, MovingAxesOfSizeOne) {
+  TestTransposeSequential<float>({1, 0, 2}, {1, 300, 7});
+  TestTransposeSequential<int64_t>({0, 3, 1, 2}, {5, 1, 1, 20});
+  TestTransposeSequential<uint8_t>({2, 0, 3, 1}, {1, 1, 8, 9});
+}
+
 #ifdef USE_CUDA
 static void TestTranspose(
     const std::vector<int64_t>& perm,
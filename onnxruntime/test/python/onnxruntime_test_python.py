@@ -73,6 +73,74 @@ class TestInferenceSession(unittest.TestCase):
         output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
         np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunModelOutputsSharingBuffers(self):
+        sess = onnxrt.InferenceSession(get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+
+        res = sess.run(["Y"], {"X": x})
+        self.assertFalse(res[0].flags.writeable)
+        self.assertFalse(res[0].flags.owndata)
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+        ro = onnxrt.RunOptions()
+        ro.copy_outputs = True
+        res = sess.run(["Y"], {"X": x}, ro)
+        self.assertTrue(res[0].flags.writeable)
+        res[0] += 1
+        np.testing.assert_allclose(output_expected + 1, res[0], rtol=1e-05, atol=1e-08)
+
+    def testRunModelNonContiguousInputsFromThreads(self):
+        sess = onnxrt.InferenceSession(get_name("mul_1.onnx"))
+        x = np.arange(12, dtype=np.float32).reshape((3, 4))[:, ::2]
+        self.assertFalse(x.flags.c_contiguous)
+        output_expected = np.ascontiguousarray(x) * np.ascontiguousarray(x)
+
+        results = [None] * 4
+
+        def run(i):
+            results[i] = sess.run(["Y"], {"X": x})[0]
+
+        threads = [threading.Thread(target=run, args=(i,)) for i in range(len(results))]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        for res in results:
+            np.testing.assert_allclose(output_expected, res, rtol=1e-05, atol=1e-08)
+
+    def testRunPreparedModel(self):
+        sess = onnxrt.InferenceSession(get_name("mul_1.onnx"))
+        prepared = sess.prepare_run(["Y"], ["X"])
+        self.assertEqual(prepared.input_names, ["X"])
+        self.assertEqual(prepared.output_names, ["Y"])
+        output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        for _ in range(2):
+            x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+            res = sess.run_prepared(prepared, [x])
+            np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+        with self.assertRaises(RuntimeError):
+            sess.prepare_run(["Z"], ["X"])
+
+    def testRunPreparedRunner(self):
+        sess = onnxrt.InferenceSession(get_name("mul_1.onnx"))
+        runner = sess.prepare_runner(["Y"], ["X"], reuse_outputs=True)
+        self.assertEqual(runner.input_names, ["X"])
+        self.assertEqual(runner.output_names, ["Y"])
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        first = runner.run([x])[0]
+        np.testing.assert_allclose(x * x, first, rtol=1e-05, atol=1e-08)
+
+        # the outputs of a run with the same input shapes are written to the buffers of the previous run
+        second = runner.run([x + 1])[0]
+        np.testing.assert_allclose((x + 1) * (x + 1), second, rtol=1e-05, atol=1e-08)
+        np.testing.assert_allclose(second, first, rtol=1e-05, atol=1e-08)
+
+        # inputs of another type than the model's go through the generic conversion
+        with self.assertRaises(Exception):
+            runner.run([x.astype(np.float64)])
+
     def testRunModelFromBytes(self):
         with open(get_name("mul_1.onnx"), "rb") as f:
             content = f.read()
@@ -3,6 +3,7 @@ import onnx
 import onnxruntime
 import torch
 import torch.nn as nn
+import torch.utils.dlpack
 import unittest
 
 from onnx import numpy_helper
@@ -67,6 +68,21 @@ class TestIOBinding(unittest.TestCase):
         ort_output = io_binding.get_outputs()[0]
     
         self.assertTrue(np.array_equal(torch_output, ort_output))
-    
+
+    def test_bind_ortvalue_with_dlpack(self):
+        torch_input, torch_output = self.create_model_and_input()
+
+        session = onnxruntime.InferenceSession('model.onnx')
+        io_binding = session.io_binding()
+        io_binding.bind_ortvalue_input('input', onnxruntime.OrtValue.from_dlpack(torch.utils.dlpack.to_dlpack(torch_input)))
+        io_binding.bind_output('output', 'cuda')
+        session.run_with_iobinding(io_binding)
+        ort_output = io_binding.get_outputs_as_ortvalues()[0]
+        self.assertEqual(ort_output.device_name(), 'Cuda')
+
+        output = torch.utils.dlpack.from_dlpack(ort_output.to_dlpack())
+        self.assertEqual(output.device, torch_input.device)
+        self.assertTrue(np.allclose(torch_output, output.cpu().numpy(), atol=1e-5))
+
 if __name__ == '__main__':
     unittest.main()
@@ -56,6 +56,23 @@ class TestInferenceSession(unittest.TestCase):
         res = sess.run([output_name], {x_name: x})
         self.assertEqual(output_expected, res[0])
 
+    def testZipMapColumnar(self):
+        so = onnxrt.SessionOptions()
+        so.columnar_zipmap_outputs = True
+        x = np.array([1.0, 0.0, 3.0, 44.0, 23.0, 11.0], dtype=np.float32).reshape((2, 3))
+
+        sess = onnxrt.InferenceSession(get_name("zipmap_stringfloat.onnx"), sess_options=so)
+        self.assertEqual(sess.get_outputs()[0].type, 'tensor(float)')
+        self.assertEqual(sess.get_output_map_keys("Z"), ['class1', 'class2', 'class3'])
+        self.assertIsNone(sess.get_output_map_keys("X"))
+        res = sess.run(["Z"], {"X": x})
+        np.testing.assert_array_equal(x, res[0])
+
+        sess = onnxrt.InferenceSession(get_name("zipmap_int64float.onnx"), sess_options=so)
+        self.assertEqual(sess.get_output_map_keys("Z"), [10, 20, 30])
+        res = sess.run(["Z"], {"X": x})
+        np.testing.assert_array_equal(x, res[0])
+
     def testDictVectorizer(self):
         sess = onnxrt.InferenceSession(get_name("pipeline_vectorize.onnx"))
         input_name = sess.get_inputs()[0].name
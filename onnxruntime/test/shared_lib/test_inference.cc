@@ -11,7 +11,11 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <gtest/gtest.h>
 #include "test_allocator.h"
 #include "test_fixture.h"
@@ -139,6 +143,7 @@ static constexpr PATH_TYPE MODEL_URI = TSTR("testdata/mul_1.onnx");
 static constexpr PATH_TYPE CUSTOM_OP_MODEL_URI = TSTR("testdata/foo_1.onnx");
 static constexpr PATH_TYPE CUSTOM_OP_LIBRARY_TEST_MODEL_URI = TSTR("testdata/custom_op_library/custom_op_test.onnx");
 static constexpr PATH_TYPE OVERRIDABLE_INITIALIZER_MODEL_URI = TSTR("testdata/overridable_initializer.onnx");
+static constexpr PATH_TYPE FREE_DIMENSIONS_MODEL_URI = TSTR("testdata/abs_free_dimensions.onnx");
 static constexpr PATH_TYPE NAMED_AND_ANON_DIM_PARAM_URI = TSTR("testdata/capi_symbolic_dims.onnx");
 static constexpr PATH_TYPE MODEL_WITH_CUSTOM_MODEL_METADATA = TSTR("testdata/model_with_valid_ort_config_json.onnx");
 
@@ -293,6 +298,66 @@ TEST(CApiTest, custom_op_handler) {
 #endif
 }
 
+// Same as MyCustomKernel, using the direct data accessors and reading the constant input W once at creation.
+struct MyPackedCustomKernel {
+  MyPackedCustomKernel(Ort::CustomOpApi ort, const OrtKernelInfo* info) : ort_(ort) {
+    std::vector<int64_t> dims;
+    const float* W = ort_.KernelInfoGetConstantInputData<float>(info, 1, &dims);
+    if (W == nullptr)
+      throw Ort::Exception("W is expected to be a constant initializer", ORT_INVALID_ARGUMENT);
+    int64_t size = 1;
+    for (int64_t dim : dims)
+      size *= dim;
+    packed_W_.assign(W, W + size);
+  }
+
+  void Compute(OrtKernelContext* context) {
+    const int64_t* dims;
+    size_t dim_count;
+    const float* X = ort_.KernelContext_GetInputData<float>(context, 0, &dims, &dim_count);
+    float* out = ort_.KernelContext_GetOutputData<float>(context, 0, dims, dim_count);
+    const float* W = packed_W_.data();
+
+    ort_.KernelContext_ParallelFor(context, packed_W_.size(), 1.0, [X, W, out](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        out[i] = X[i] + W[i];
+      }
+    });
+  }
+
+ private:
+  Ort::CustomOpApi ort_;
+  std::vector<float> packed_W_;
+};
+
+struct MyPackedCustomOp : Ort::CustomOpBase<MyPackedCustomOp, MyPackedCustomKernel> {
+  void* CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo* info) { return new MyPackedCustomKernel(api, info); };
+  const char* GetName() const { return "Foo"; };
+
+  size_t GetInputTypeCount() const { return 2; };
+  ONNXTensorElementDataType GetInputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+
+  size_t GetOutputTypeCount() const { return 1; };
+  ONNXTensorElementDataType GetOutputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+};
+
+TEST(CApiTest, custom_op_direct_data_access) {
+  std::vector<Input> inputs(1);
+  Input& input = inputs[0];
+  input.name = "X";
+  input.dims = {3, 2};
+  input.values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+
+  MyPackedCustomOp custom_op;
+  Ort::CustomOpDomain custom_op_domain("");
+  custom_op_domain.Add(&custom_op);
+
+  TestInference<PATH_TYPE, float>(*ort_env, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain, nullptr);
+}
+
 // Tests registration of a custom op of the same name for both CPU and CUDA EPs
 #ifdef USE_CUDA
 TEST(CApiTest, RegisterCustomOpForCPUAndCUDA) {
@@ -429,6 +494,262 @@ TEST(CApiTest, create_tensor_with_data) {
   ASSERT_EQ(1u, tensor_info.GetDimensionsCount());
 }
 
+TEST(CApiTest, run_with_prepared_run) {
+  Ort::Session session(*ort_env, MODEL_URI, Ort::SessionOptions{});
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::PreparedRun prepared_run(session, input_names, 1, output_names, 1);
+
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<float> expected_values = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  for (float scale : {1.0f, 2.0f}) {
+    std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    for (auto& value : x_values) value *= scale;
+    Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+
+    auto outputs = session.Run(Ort::RunOptions{nullptr}, prepared_run, &x, 1, 1);
+    ASSERT_EQ(outputs.size(), 1u);
+    const float* y = outputs[0].GetTensorMutableData<float>();
+    for (size_t i = 0; i != expected_values.size(); ++i) {
+      ASSERT_EQ(y[i], expected_values[i] * scale * scale);
+    }
+  }
+
+  const char* invalid_output_names[] = {"Z"};
+  ASSERT_THROW(Ort::PreparedRun(session, input_names, 1, invalid_output_names, 1), Ort::Exception);
+}
+
+struct RunAsyncResult {
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t completed = 0;
+  size_t failed = 0;
+  std::vector<float> values;
+};
+
+static void ORT_API_CALL RunAsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status) {
+  auto* result = reinterpret_cast<RunAsyncResult*>(user_data);
+  std::vector<float> values;
+  if (status == nullptr && num_outputs == 1) {
+    Ort::Value output{outputs[0]};
+    const float* data = output.GetTensorMutableData<float>();
+    values.assign(data, data + output.GetTensorTypeAndShapeInfo().GetElementCount());
+  } else if (status != nullptr) {
+    Ort::GetApi().ReleaseStatus(status);
+  }
+
+  std::lock_guard<std::mutex> lock(result->mutex);
+  if (values.empty()) {
+    ++result->failed;
+  } else {
+    result->values = std::move(values);
+  }
+  ++result->completed;
+  result->cv.notify_all();
+}
+
+TEST(CApiTest, run_async) {
+  Ort::SessionOptions session_options;
+  session_options.SetAsyncRunThreadPoolSize(2);
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  constexpr size_t num_runs = 4;
+  RunAsyncResult result;
+  for (size_t i = 0; i != num_runs; ++i) {
+    session.RunAsync(Ort::RunOptions{nullptr}, input_names, &x, 1, output_names, 1, RunAsyncCallback, &result);
+  }
+
+  std::unique_lock<std::mutex> lock(result.mutex);
+  result.cv.wait(lock, [&result]() { return result.completed == num_runs; });
+  ASSERT_EQ(result.failed, 0u);
+  std::vector<float> expected_values = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  ASSERT_EQ(result.values, expected_values);
+}
+
+TEST(CApiTest, request_batcher) {
+  Ort::SessionOptions session_options;
+  session_options.SetAsyncRunThreadPoolSize(2);
+  Ort::Session session(*ort_env, FREE_DIMENSIONS_MODEL_URI, session_options);
+
+  // the first dimension of x is free, so the requests can be concatenated into one batch
+  std::vector<float> x_values = {-1.0f, 2.0f, -3.0f, 4.0f, -5.0f};
+  std::vector<int64_t> x_dims = {1, 1, 5};
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+
+  const char* input_names[] = {"x"};
+  const char* output_names[] = {"y"};
+  constexpr size_t num_runs = 4;
+  RunAsyncResult result;
+  {
+    Ort::RequestBatcher batcher(session, input_names, 1, output_names, 1, 8, 100000);
+    for (size_t i = 0; i != num_runs; ++i) {
+      batcher.Run(&x, 1, RunAsyncCallback, &result);
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(result.mutex);
+      result.cv.wait(lock, [&result]() { return result.completed == num_runs; });
+    }
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    char* stats = batcher.GetStats(allocator);
+    std::string stats_json(stats);
+    allocator.Free(stats);
+    ASSERT_NE(stats_json.find("\"num_requests\": 4"), std::string::npos) << stats_json;
+  }
+
+  ASSERT_EQ(result.failed, 0u);
+  std::vector<float> expected_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+  ASSERT_EQ(result.values, expected_values);
+}
+
+TEST(CApiTest, session_pool) {
+  Ort::Session session(*ort_env, MODEL_URI, Ort::SessionOptions{});
+  Ort::SessionPool pool(session, 2);
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  std::vector<int64_t> x_dims = {3, 2};
+  std::vector<float> expected_values = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // more callers than workers, so some wait for a worker to be checked in
+  constexpr size_t num_callers = 4;
+  std::vector<size_t> mismatches(num_callers, 0);
+  std::vector<std::thread> callers;
+  for (size_t c = 0; c != num_callers; ++c) {
+    callers.emplace_back([&, c]() {
+      Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+      std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+      Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(),
+                                                     x_dims.size());
+      for (int i = 0; i != 8; ++i) {
+        OrtSessionPoolWorker* worker = pool.Checkout();
+        auto outputs = pool.Run(worker, Ort::RunOptions{nullptr}, input_names, &x, 1, output_names, 1);
+        pool.Checkin(worker);
+        const float* y = outputs[0].GetTensorMutableData<float>();
+        if (!std::equal(expected_values.begin(), expected_values.end(), y)) {
+          ++mismatches[c];
+        }
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  ASSERT_EQ(mismatches, std::vector<size_t>(num_callers, 0));
+
+  // no worker is idle once both are checked out
+  OrtSessionPoolWorker* worker0 = pool.Checkout(0);
+  OrtSessionPoolWorker* worker1 = pool.Checkout(0);
+  ASSERT_NE(worker0, nullptr);
+  ASSERT_NE(worker1, nullptr);
+  ASSERT_EQ(pool.Checkout(1000), nullptr);
+  pool.Checkin(worker1);
+  pool.Checkin(worker0);
+  ASSERT_THROW(pool.Checkin(worker0), Ort::Exception);
+}
+
+// model squaring its float input of shape {3, 2}, as mul_1.onnx does from X to Y
+static std::string CreateSquareModel(const std::string& input_name, const std::string& output_name) {
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(ONNX_NAMESPACE::IR_VERSION);
+  model.add_opset_import()->set_version(7);
+  auto* graph = model.mutable_graph();
+  graph->set_name("square");
+  auto* node = graph->add_node();
+  node->set_op_type("Mul");
+  node->add_input(input_name);
+  node->add_input(input_name);
+  node->add_output(output_name);
+  auto set_value_info = [](ONNX_NAMESPACE::ValueInfoProto* value_info, const std::string& name) {
+    value_info->set_name(name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    tensor_type->mutable_shape()->add_dim()->set_dim_value(3);
+    tensor_type->mutable_shape()->add_dim()->set_dim_value(2);
+  };
+  set_value_info(graph->add_input(), input_name);
+  set_value_info(graph->add_output(), output_name);
+  return model.SerializeAsString();
+}
+
+TEST(CApiTest, session_pipeline) {
+  const std::string stage1_model = CreateSquareModel("Y", "Z");
+  std::vector<Ort::Session> stages;
+  stages.emplace_back(*ort_env, MODEL_URI, Ort::SessionOptions{});
+  stages.emplace_back(*ort_env, stage1_model.data(), stage1_model.size(), Ort::SessionOptions{});
+  Ort::SessionPipeline pipeline(stages.data(), stages.size());
+
+  constexpr size_t num_micro_batches = 4;
+  std::vector<int64_t> x_dims = {3, 2};
+  std::vector<std::vector<float>> x_values(num_micro_batches);
+  std::vector<Ort::Value> inputs;
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  for (size_t m = 0; m != num_micro_batches; ++m) {
+    for (float value : {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}) {
+      x_values[m].push_back(value + m);
+    }
+    inputs.push_back(Ort::Value::CreateTensor<float>(info, x_values[m].data(), x_values[m].size(), x_dims.data(),
+                                                     x_dims.size()));
+  }
+
+  // Y is the output of the first stage and Z of the second one
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Z", "Y"};
+  auto outputs = pipeline.Run(Ort::RunOptions{nullptr}, input_names, inputs.data(), 1, num_micro_batches,
+                              output_names, 2);
+  ASSERT_EQ(outputs.size(), num_micro_batches * 2);
+  for (size_t m = 0; m != num_micro_batches; ++m) {
+    const float* z = outputs[m * 2].GetTensorMutableData<float>();
+    const float* y = outputs[m * 2 + 1].GetTensorMutableData<float>();
+    for (size_t i = 0; i != x_values[m].size(); ++i) {
+      const float x = x_values[m][i];
+      ASSERT_EQ(y[i], x * x);
+      ASSERT_EQ(z[i], x * x * x * x);
+    }
+  }
+
+  const char* invalid_input_names[] = {"W"};
+  ASSERT_THROW(pipeline.Run(Ort::RunOptions{nullptr}, invalid_input_names, inputs.data(), 1, num_micro_batches,
+                            output_names, 2),
+               Ort::Exception);
+}
+
+TEST(CApiTest, warmup) {
+  Ort::SessionOptions session_options;
+  Ort::Session session(*ort_env, FREE_DIMENSIONS_MODEL_URI, session_options);
+
+  const char* input_names[] = {"x"};
+  session.Warmup(Ort::RunOptions{nullptr}, input_names, 1, {{{1, 1, 5}}, {{2, 3, 5}}});
+
+  // every set must have a shape per input, and the inputs must exist in the model
+  ASSERT_THROW(session.Warmup(Ort::RunOptions{nullptr}, input_names, 1, {{{1, 1, 5}, {1, 1, 5}}}), Ort::Exception);
+  const char* invalid_names[] = {"z"};
+  ASSERT_THROW(session.Warmup(Ort::RunOptions{nullptr}, invalid_names, 1, {{{1, 1, 5}}}), Ort::Exception);
+
+  // a run after the warmup gives the usual results
+  std::vector<float> x_values = {-1.0f, 2.0f, -3.0f, 4.0f, -5.0f};
+  std::vector<int64_t> x_dims = {1, 1, 5};
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+  const char* output_names[] = {"y"};
+  auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &x, 1, output_names, 1);
+  ASSERT_EQ(outputs.size(), 1u);
+  const float* y = outputs[0].GetTensorMutableData<float>();
+  std::vector<float> expected_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+  ASSERT_EQ(std::vector<float>(y, y + 5), expected_values);
+}
+
 TEST(CApiTest, override_initializer) {
   Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
   auto allocator = onnxruntime::make_unique<MockedOrtAllocator>();
@@ -12,7 +12,13 @@ namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(OrtDevice::DeviceId device_id,
                                                                                size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
-                                                                               ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo);
+                                                                               ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+                                                                               bool enable_cuda_graph = false,
+                                                                               bool use_stream_ordered_arena = false,
+                                                                               OrtCudnnConvAlgoSearch cudnn_conv_algo_search = EXHAUSTIVE,
+                                                                               const std::string& cudnn_conv_algo_cache_path = "",
+                                                                               bool initializers_in_host_memory = false,
+                                                                               size_t workspace_max_bytes = 0);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Dnnl(int use_arena);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_NGraph(const char* ng_backend_type);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_OpenVINO(const char* device_id);
@@ -125,10 +125,11 @@ std::vector<std::string> GetOrderedOrtValueNames(const NameMLValMap& name_to_val
   return ordered_names;
 }
 
+// data_transfer_manager may be null if all tensors are in host memory
 Status SaveRuntimeTensors(
     const PathString& tensors_path,
     const PathString& tensors_data_path,
-    const DataTransferManager& data_transfer_manager,
+    const DataTransferManager* data_transfer_manager,
     const NameMLValMap& ort_values) {
   // just write data file basename to TensorProto - this will get overwritten
   //   with the actual path when loading the checkpoint
@@ -146,13 +147,22 @@ Status SaveRuntimeTensors(
     ORT_RETURN_IF_NOT(ort_value.IsTensor());
     const Tensor& tensor = ort_value.Get<Tensor>();
 
-    tensor_data_buffer.resize(tensor.SizeInBytes());
-    ORT_RETURN_IF_ERROR(CopyTensorDataToByteSpan(
-        data_transfer_manager, tensor, cpu_alloc_info, gsl::make_span(tensor_data_buffer)));
+    gsl::span<const char> tensor_data{};
+    if (tensor.Location().device.Type() == OrtDevice::CPU) {
+      tensor_data = gsl::make_span(static_cast<const char*>(tensor.DataRaw()), tensor.SizeInBytes());
+    } else {
+      ORT_RETURN_IF_NOT(
+          data_transfer_manager != nullptr,
+          "A DataTransferManager is required to save non-host tensor: ", tensor_name);
+      tensor_data_buffer.resize(tensor.SizeInBytes());
+      ORT_RETURN_IF_ERROR(CopyTensorDataToByteSpan(
+          *data_transfer_manager, tensor, cpu_alloc_info, gsl::make_span(tensor_data_buffer)));
+      tensor_data = tensor_data_buffer;
+    }
 
     saved_tensor_protos.emplace_back();
     ORT_RETURN_IF_ERROR(SaveRuntimeTensor(
-        tensor_name, tensor, tensor_data_buffer, tensors_data_relative_path,
+        tensor_name, tensor, tensor_data, tensors_data_relative_path,
         tensors_data_file, saved_tensor_protos.back()));
   }
 
@@ -200,11 +210,9 @@ Status SaveProperties(
   return Status::OK();
 }
 
-}  // namespace
-
-Status SaveModelCheckpoint(
+Status SaveModelCheckpointFiles(
     const PathString& checkpoint_path,
-    const DataTransferManager& data_transfer_manager,
+    const DataTransferManager* data_transfer_manager,
     const NameMLValMap& runtime_tensors,
     const std::unordered_map<std::string, std::string>& properties) {
   LOGS_DEFAULT(INFO) << "Saving model checkpoint files to " << ToMBString(checkpoint_path);
@@ -229,6 +237,64 @@ Status SaveModelCheckpoint(
   return Status::OK();
 }
 
+}  // namespace
+
+Status SaveModelCheckpoint(
+    const PathString& checkpoint_path,
+    const DataTransferManager& data_transfer_manager,
+    const NameMLValMap& runtime_tensors,
+    const std::unordered_map<std::string, std::string>& properties) {
+  return SaveModelCheckpointFiles(checkpoint_path, &data_transfer_manager, runtime_tensors, properties);
+}
+
+Status CreateCheckpointSnapshot(
+    const DataTransferManager& data_transfer_manager,
+    const NameMLValMap& runtime_tensors,
+    const std::unordered_map<std::string, std::string>& properties,
+    const AllocatorPtr& host_allocator,
+    CheckpointSnapshot& snapshot) {
+  ORT_RETURN_IF_NOT(
+      host_allocator->Info().device.Type() == OrtDevice::CPU,
+      "Checkpoint snapshots must be allocated in host memory.");
+
+  NameMLValMap snapshot_tensors{};
+  for (const auto& name_and_value : runtime_tensors) {
+    ORT_RETURN_IF_NOT(name_and_value.second.IsTensor());
+    const Tensor& tensor = name_and_value.second.Get<Tensor>();
+
+    // reuse the host buffer from the previous snapshot, if possible
+    auto previous_it = snapshot.tensors.find(name_and_value.first);
+    if (previous_it != snapshot.tensors.end() &&
+        previous_it->second.Get<Tensor>().DataType() == tensor.DataType() &&
+        previous_it->second.Get<Tensor>().Shape() == tensor.Shape()) {
+      ORT_RETURN_IF_ERROR(data_transfer_manager.CopyTensor(
+          tensor, *previous_it->second.GetMutable<Tensor>()));
+      snapshot_tensors.emplace(name_and_value.first, previous_it->second);
+      continue;
+    }
+
+    auto snapshot_tensor = onnxruntime::make_unique<Tensor>(tensor.DataType(), tensor.Shape(), host_allocator);
+    ORT_RETURN_IF_ERROR(data_transfer_manager.CopyTensor(tensor, *snapshot_tensor));
+
+    OrtValue snapshot_value{};
+    snapshot_value.Init(snapshot_tensor.release(),
+                        DataTypeImpl::GetType<Tensor>(),
+                        DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    snapshot_tensors.emplace(name_and_value.first, snapshot_value);
+  }
+
+  snapshot.tensors = std::move(snapshot_tensors);
+  snapshot.properties = properties;
+
+  return Status::OK();
+}
+
+Status SaveModelCheckpoint(
+    const PathString& checkpoint_path,
+    const CheckpointSnapshot& snapshot) {
+  return SaveModelCheckpointFiles(checkpoint_path, nullptr, snapshot.tensors, snapshot.properties);
+}
+
 namespace {
 Status UpdateTensorsExternalDataLocations(
     const PathString& external_data_path,
@@ -9,6 +9,7 @@
 
 #include "core/common/path_string.h"
 #include "core/common/status.h"
+#include "core/framework/allocator.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/data_types.h"
 #include "core/framework/framework_common.h"
@@ -39,6 +40,48 @@ common::Status SaveModelCheckpoint(
     const NameMLValMap& runtime_tensors,
     const std::unordered_map<std::string, std::string>& properties);
 
+/**
+ * A host memory copy of the state to checkpoint.
+ * Unlike the runtime tensors, it can be written while training continues.
+ */
+struct CheckpointSnapshot {
+  NameMLValMap tensors;
+  std::unordered_map<std::string, std::string> properties;
+};
+
+/**
+ * Copies the state to checkpoint into host memory.
+ *
+ * Host buffers of a previous snapshot are reused for tensors with the same
+ * name, type, and shape.
+ *
+ * @param data_transfer_manager The DataTransferManager instance.
+ * @param runtime_tensors The tensors to persist.
+ * @param properties The properties to persist.
+ * @param host_allocator The allocator for the host copies, e.g., a pinned
+ *        memory allocator for faster copies from the device.
+ * @param[in,out] snapshot The snapshot.
+ * @return The status of the operation.
+ */
+common::Status CreateCheckpointSnapshot(
+    const DataTransferManager& data_transfer_manager,
+    const NameMLValMap& runtime_tensors,
+    const std::unordered_map<std::string, std::string>& properties,
+    const AllocatorPtr& host_allocator,
+    CheckpointSnapshot& snapshot);
+
+/**
+ * Saves a model checkpoint from a snapshot in the specified location.
+ * This does not access device memory, so it may run on a background thread.
+ *
+ * @param checkpoint_path The checkpoint location.
+ * @param snapshot The snapshot to persist.
+ * @return The status of the operation.
+ */
+common::Status SaveModelCheckpoint(
+    const PathString& checkpoint_path,
+    const CheckpointSnapshot& snapshot);
+
 /**
  * Loads a model checkpoint from the specified location.
  *
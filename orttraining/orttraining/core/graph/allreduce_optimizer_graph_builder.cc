@@ -3,6 +3,10 @@
 
 #include "orttraining/core/graph/allreduce_optimizer_graph_builder.h"
 
+#include <numeric>
+
+#include "core/graph/graph_viewer.h"
+
 namespace onnxruntime {
 namespace training {
 
@@ -90,20 +94,12 @@ Status AllreduceOptimizerGraphBuilder::AddHorovodAllReduceForGradients(std::vect
   return Status::OK();
 }
 
-static Status AddNcclAllReduceForGradients(
+// Replaces the gradients with views of the all-reduced buffer they were fused into.
+static void AddAllReduceOutputView(
     std::vector<ArgDef>& gradient_argdefs,
-    ArgDef& fused_gradient_argdef,
+    const ArgDef& fused_allreduce_output,
     GraphAugmenter::GraphDefs& graph_defs,
-    ArgDef& fused_allreduce_output) {
-  fused_allreduce_output = ArgDef(fused_gradient_argdef.name + "AllReduce_Out", fused_gradient_argdef.type_proto);
-
-  // Add NCCL Allreduce node.
-  graph_defs.AddNodeDefs({NodeDef(OpDef{"NcclAllReduce", kMSDomain, 1},
-                                  {fused_gradient_argdef},
-                                  {fused_allreduce_output},
-                                  NodeAttributes(),
-                                  "NcclAllReduce")});
-
+    const std::string& view_name) {
   std::vector<ArgDef> view_inputs(gradient_argdefs.size() + 1);
   view_inputs[0] = fused_allreduce_output;
 
@@ -122,7 +118,7 @@ static Status AddNcclAllReduceForGradients(
   for (size_t i = 0; i < gradient_argdefs.size(); i++) {
     TypeProto* allreduced_gradient_type_proto = graph_defs.CopyTypeProto(gradient_argdefs[i]);
     allreduced_gradient_type_proto->mutable_tensor_type()->set_elem_type(
-        fused_gradient_argdef.type_proto->tensor_type().elem_type());
+        fused_allreduce_output.type_proto->tensor_type().elem_type());
 
     allreduce_outputs[i] = ArgDef(gradient_argdefs[i].name + "_AllReduce_Out", allreduced_gradient_type_proto);
   }
@@ -131,9 +127,185 @@ static Status AddNcclAllReduceForGradients(
                                   view_inputs,
                                   allreduce_outputs,
                                   NodeAttributes(),
-                                  "AllReduceOutputView")});
+                                  view_name)});
 
   gradient_argdefs = allreduce_outputs;
+}
+
+// Adds the zero initialized quantization error of the fused gradients, which have the shapes of the weights.
+static Status AddQuantizationErrorInitializer(
+    const NodeArgNameGeneratorFn& nodearg_name_generator,
+    const std::vector<ArgDef>& weight_argdefs,
+    GraphAugmenter::GraphDefs& graph_defs,
+    ArgDef& quantization_error_argdef) {
+  int64_t element_count = 0;
+  for (const auto& weight_argdef : weight_argdefs) {
+    const TypeProto* type_proto = weight_argdef.type_proto;
+    ORT_RETURN_IF_NOT(type_proto != nullptr && type_proto->tensor_type().has_shape(),
+                      "Quantized all-reduce requires the shape of weight ", weight_argdef.name);
+    int64_t weight_element_count = 1;
+    for (const auto& dim : type_proto->tensor_type().shape().dim()) {
+      ORT_RETURN_IF_NOT(dim.has_dim_value(),
+                        "Quantized all-reduce requires the shape of weight ", weight_argdef.name);
+      weight_element_count *= dim.dim_value();
+    }
+    element_count += weight_element_count;
+  }
+
+  quantization_error_argdef = ArgDef(
+      nodearg_name_generator("quantized_allreduce_error"),
+      graph_defs.CreateTypeProto({element_count}, ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+  graph_defs.AddInitializers({CreateTensorProto<float>(quantization_error_argdef.name, 0.0f, {element_count})});
+  return Status::OK();
+}
+
+// quantization_error_argdef is empty unless the gradients are quantized.
+static Status AddNcclAllReduceForGradients(
+    std::vector<ArgDef>& gradient_argdefs,
+    ArgDef& fused_gradient_argdef,
+    const ArgDef& quantization_error_argdef,
+    GraphAugmenter::GraphDefs& graph_defs,
+    ArgDef& fused_allreduce_output) {
+  fused_allreduce_output = ArgDef(fused_gradient_argdef.name + "AllReduce_Out", fused_gradient_argdef.type_proto);
+
+  if (quantization_error_argdef.name.empty()) {
+    // Add NCCL Allreduce node.
+    graph_defs.AddNodeDefs({NodeDef(OpDef{"NcclAllReduce", kMSDomain, 1},
+                                    {fused_gradient_argdef},
+                                    {fused_allreduce_output},
+                                    NodeAttributes(),
+                                    "NcclAllReduce")});
+  } else {
+    // Add NCCL quantized Allreduce node, which updates the quantization error in place.
+    const ArgDef quantization_error_output(quantization_error_argdef.name + "_Out", quantization_error_argdef.type_proto);
+    graph_defs.AddNodeDefs({NodeDef(OpDef{"NcclQuantizedAllReduce", kMSDomain, 1},
+                                    {fused_gradient_argdef, quantization_error_argdef},
+                                    {fused_allreduce_output, quantization_error_output},
+                                    NodeAttributes(),
+                                    "NcclQuantizedAllReduce")});
+  }
+
+  AddAllReduceOutputView(gradient_argdefs, fused_allreduce_output, graph_defs, "AllReduceOutputView");
+  return Status::OK();
+}
+
+// Groups the gradients into buckets of at least bucket_size bytes, except for the last one, in the order the graph
+// produces them. A gradient of unknown size closes its bucket.
+static std::vector<std::vector<size_t>> GetGradientBuckets(
+    const Graph& graph,
+    const std::vector<std::string>& gradient_names,
+    const std::vector<ArgDef>& gradient_argdefs,
+    const int64_t element_size,
+    const int64_t bucket_size) {
+  std::unordered_map<NodeIndex, size_t> topological_positions;
+  GraphViewer graph_viewer(graph);
+  const auto& node_indices = graph_viewer.GetNodesInTopologicalOrder();
+  for (size_t i = 0; i < node_indices.size(); ++i) {
+    topological_positions[node_indices[i]] = i + 1;
+  }
+
+  // the gradients without a producer, such as the initializers, are ready from the start
+  std::vector<size_t> ready_positions(gradient_names.size(), 0);
+  for (size_t i = 0; i < gradient_names.size(); ++i) {
+    const Node* producer = graph.GetProducerNode(gradient_names[i]);
+    if (producer != nullptr) {
+      ready_positions[i] = topological_positions[producer->Index()];
+    }
+  }
+
+  std::vector<size_t> ready_order(gradient_names.size());
+  std::iota(ready_order.begin(), ready_order.end(), 0);
+  std::stable_sort(ready_order.begin(), ready_order.end(), [&ready_positions](size_t a, size_t b) {
+    return ready_positions[a] < ready_positions[b];
+  });
+
+  std::vector<std::vector<size_t>> buckets;
+  std::vector<size_t> bucket;
+  int64_t bucket_bytes = 0;
+  for (size_t i : ready_order) {
+    int64_t gradient_bytes = bucket_size;
+    const TypeProto* type_proto = gradient_argdefs[i].type_proto;
+    if (type_proto != nullptr && type_proto->tensor_type().has_shape()) {
+      const auto& shape = type_proto->tensor_type().shape();
+      gradient_bytes = element_size;
+      for (int d = 0; d < shape.dim_size(); ++d) {
+        if (!shape.dim(d).has_dim_value()) {
+          gradient_bytes = bucket_size;
+          break;
+        }
+        gradient_bytes *= shape.dim(d).dim_value();
+      }
+    }
+
+    bucket.push_back(i);
+    bucket_bytes += gradient_bytes;
+    if (bucket_bytes >= bucket_size) {
+      buckets.push_back(std::move(bucket));
+      bucket.clear();
+      bucket_bytes = 0;
+    }
+  }
+
+  if (!bucket.empty()) {
+    buckets.push_back(std::move(bucket));
+  }
+
+  return buckets;
+}
+
+Status AllreduceOptimizerGraphBuilder::AddBucketedNcclAllReduceForGradients(
+    const Graph& graph,
+    const NodeArgNameGeneratorFn& nodearg_name_generator,
+    const float scale,
+    std::vector<ArgDef>& gradient_argdefs,  // update argdefs in place
+    GraphAugmenter::GraphDefs& graph_defs,
+    std::vector<ArgDef>& reduced_bucket_argdefs) {
+  const int64_t element_size = opt_graph_config_.allreduce_in_fp16 ? 2 : 4;
+  const auto buckets = GetGradientBuckets(graph, gradient_names_, gradient_argdefs, element_size,
+                                          opt_graph_config_.allreduce_bucket_size_bytes);
+
+  // Fuse and all-reduce each bucket on the communication stream, as soon as its gradients are ready.
+  std::vector<std::vector<ArgDef>> bucket_gradient_argdefs(buckets.size());
+  std::vector<ArgDef> bucket_allreduce_outputs(buckets.size());
+  for (size_t b = 0; b < buckets.size(); ++b) {
+    for (size_t i : buckets[b]) {
+      bucket_gradient_argdefs[b].push_back(gradient_argdefs[i]);
+    }
+
+    ArgDef fused_gradient_argdef;
+    ORT_RETURN_IF_ERROR(AddGradientScalingNodes(nodearg_name_generator, scale, bucket_gradient_argdefs[b],
+                                                fused_gradient_argdef, graph_defs,
+                                                opt_graph_config_.allreduce_in_fp16, true));
+
+    bucket_allreduce_outputs[b] = ArgDef(nodearg_name_generator(fused_gradient_argdef.name + "_AllReduce_Out"),
+                                         fused_gradient_argdef.type_proto);
+    graph_defs.AddNodeDefs({NodeDef(OpDef{"NcclAllReduce", kMSDomain, 1},
+                                    {fused_gradient_argdef},
+                                    {bucket_allreduce_outputs[b]},
+                                    {ONNX_NAMESPACE::MakeAttribute("use_comm_stream", static_cast<int64_t>(1))},
+                                    bucket_allreduce_outputs[b].name)});
+  }
+
+  // Wait for all the buckets before the gradients are used.
+  reduced_bucket_argdefs.clear();
+  for (const auto& bucket_allreduce_output : bucket_allreduce_outputs) {
+    reduced_bucket_argdefs.emplace_back(nodearg_name_generator(bucket_allreduce_output.name + "_Ready"),
+                                        bucket_allreduce_output.type_proto);
+  }
+  graph_defs.AddNodeDefs({NodeDef(OpDef{"NcclWait", kMSDomain, 1},
+                                  bucket_allreduce_outputs,
+                                  reduced_bucket_argdefs,
+                                  NodeAttributes(),
+                                  nodearg_name_generator("NcclWait"))});
+
+  for (size_t b = 0; b < buckets.size(); ++b) {
+    AddAllReduceOutputView(bucket_gradient_argdefs[b], reduced_bucket_argdefs[b], graph_defs,
+                           reduced_bucket_argdefs[b].name + "_View");
+    for (size_t j = 0; j < buckets[b].size(); ++j) {
+      gradient_argdefs[buckets[b][j]] = bucket_gradient_argdefs[b][j];
+    }
+  }
+
   return Status::OK();
 }
 
@@ -158,7 +330,10 @@ AllreduceOptimizerGraphBuilder::AllreduceOptimizerGraphBuilder(
               "Allreduce optimizer graph builder can only be used for distributed training.");
   if (opt_graph_config.use_nccl) {
     ORT_ENFORCE(IsNcclAvailable(), "Distributed training with NCCL is not supported, as NCCL is not enabled in this build.");
+    ORT_ENFORCE(!opt_graph_config.use_quantized_allreduce || opt_graph_config.allreduce_bucket_size_bytes == 0,
+                "Quantized all-reduce is not supported with all-reduce buckets.");
   } else {
+    ORT_ENFORCE(!opt_graph_config.use_quantized_allreduce, "Quantized all-reduce requires NCCL.");
     ORT_ENFORCE(IsHorovodAvailable(), "Distributed training with Horovod is not supported, as Horovod is not enabled in this build.");
   }
 }
@@ -175,32 +350,48 @@ Status AllreduceOptimizerGraphBuilder::BuildInternal(
   };
 
   const bool overlap_compute_allreduce = !opt_graph_config_.use_nccl;
+  const bool use_allreduce_buckets = opt_graph_config_.use_nccl && opt_graph_config_.allreduce_bucket_size_bytes > 0;
   const int64_t horovod_reduce_op = opt_graph_config_.horovod_reduce_op;
 
-  // add gradient scaling
-  ArgDef fused_gradient_argdef;
   const auto total_num_accumulations =
       opt_graph_config_.gradient_accumulation_steps * opt_graph_config_.data_parallel_group_size;
   ORT_RETURN_IF_NOT(total_num_accumulations > 0);
   const float scale = 1.0f / total_num_accumulations;
-  const bool fuse_scaling_outputs = !overlap_compute_allreduce;
-  ORT_RETURN_IF_ERROR(AddGradientScalingNodes(nodearg_name_generator, scale, gradient_argdefs, fused_gradient_argdef, graph_defs,
-                                              opt_graph_config_.allreduce_in_fp16, fuse_scaling_outputs));
 
-  // add Allreduce for gradients
-  ArgDef reduced_fused_gradient_argdef;
-
-  if (opt_graph_config_.use_nccl) {
-    ORT_RETURN_IF_ERROR(AddNcclAllReduceForGradients(gradient_argdefs, fused_gradient_argdef, graph_defs, reduced_fused_gradient_argdef));
+  std::vector<ArgDef> gradient_norm_inputs;
+  ArgDef quantization_error_argdef;
+  if (use_allreduce_buckets) {
+    // add gradient scaling and Allreduce for each bucket of gradients
+    ORT_RETURN_IF_ERROR(AddBucketedNcclAllReduceForGradients(graph, nodearg_name_generator, scale, gradient_argdefs,
+                                                             graph_defs, gradient_norm_inputs));
   } else {
-    ORT_RETURN_IF_ERROR(AddHorovodAllReduceForGradients(gradient_argdefs, graph_defs, horovod_reduce_op));
+    // add gradient scaling
+    ArgDef fused_gradient_argdef;
+    const bool fuse_scaling_outputs = !overlap_compute_allreduce;
+    ORT_RETURN_IF_ERROR(AddGradientScalingNodes(nodearg_name_generator, scale, gradient_argdefs, fused_gradient_argdef, graph_defs,
+                                                opt_graph_config_.allreduce_in_fp16, fuse_scaling_outputs));
+
+    // add Allreduce for gradients
+    ArgDef reduced_fused_gradient_argdef;
+
+    if (opt_graph_config_.use_nccl) {
+      if (opt_graph_config_.use_quantized_allreduce) {
+        ORT_RETURN_IF_ERROR(AddQuantizationErrorInitializer(nodearg_name_generator, weight_argdefs, graph_defs,
+                                                            quantization_error_argdef));
+      }
+      ORT_RETURN_IF_ERROR(AddNcclAllReduceForGradients(gradient_argdefs, fused_gradient_argdef, quantization_error_argdef,
+                                                       graph_defs, reduced_fused_gradient_argdef));
+    } else {
+      ORT_RETURN_IF_ERROR(AddHorovodAllReduceForGradients(gradient_argdefs, graph_defs, horovod_reduce_op));
+    }
+
+    gradient_norm_inputs = GetGradientNormInputs(gradient_argdefs, reduced_fused_gradient_argdef);
   }
 
   // check if all gradients are finite
   ArgDef global_grad_norm_argdef;
   ArgDef global_grad_norm_finite_argdef;
   if (opt_graph_config_.use_mixed_precision) {
-    auto gradient_norm_inputs = GetGradientNormInputs(gradient_argdefs, reduced_fused_gradient_argdef);
     ORT_RETURN_IF_ERROR(AddGradientNorm(
         nodearg_name_generator, gradient_norm_inputs, graph_defs, global_grad_norm_argdef));
     optimizer_graph_outputs[OptimizerOutputKey::GlobalGradientNorm] = global_grad_norm_argdef.name;
@@ -218,6 +409,10 @@ Status AllreduceOptimizerGraphBuilder::BuildInternal(
       opt_configs_, graph_defs,
       optimizer_state_initializer_names));
 
+  if (!quantization_error_argdef.name.empty()) {
+    optimizer_state_initializer_names.insert(quantization_error_argdef.name);
+  }
+
   return Status::OK();
 }
 
@@ -36,6 +36,17 @@ class AllreduceOptimizerGraphBuilder : public OptimizerGraphBuilder {
       std::vector<ArgDef>& gradient_argdefs,
       GraphAugmenter::GraphDefs& graph_defs,
       const int64_t horovod_reduce_op);
+
+  // Scales and all-reduces the gradients in buckets of about allreduce_bucket_size_bytes, filled in the order the
+  // backward pass produces the gradients. The all-reduces run on the NCCL communication stream, overlapped with the
+  // rest of the backward pass, and the reduced buckets are returned in reduced_bucket_argdefs.
+  Status AddBucketedNcclAllReduceForGradients(
+      const Graph& graph,
+      const NodeArgNameGeneratorFn& nodearg_name_generator,
+      const float scale,
+      std::vector<ArgDef>& gradient_argdefs,
+      GraphAugmenter::GraphDefs& graph_defs,
+      std::vector<ArgDef>& reduced_bucket_argdefs);
 };
 
 }  // namespace training
@@ -4,6 +4,7 @@
 #include "orttraining/core/graph/optimizer_builder.h"
 #include "orttraining/core/graph/optimizer/adam_optimizer_builder.h"
 #include "orttraining/core/graph/optimizer/lamb_optimizer_builder.h"
+#include "orttraining/core/graph/optimizer/multi_tensor_adam_optimizer_builder.h"
 #include "orttraining/core/graph/optimizer/sgd_optimizer_builder.h"
 
 namespace onnxruntime {
@@ -13,6 +14,7 @@ namespace training {
 void OptimizerBuilderRegistry::RegisterBuilders() {
   GetInstance().Register<AdamOptimizerBuilder>("AdamOptimizer");
   GetInstance().Register<LambOptimizerBuilder>("LambOptimizer");
+  GetInstance().Register<MultiTensorAdamOptimizerBuilder>("MultiTensorAdamOptimizer");
   GetInstance().Register<SGDOptimizerBuilder>("SGDOptimizer");
 }
 
@@ -20,8 +20,8 @@ enum AdasumReductionType {
 };
 
 // Configuration for the DeepSpeed ZeRO technique.  Currently only the stage
-// setting is supported, and only with stages 0 (disabled) and 1 (optimizer
-// state partitioning).
+// setting is supported, and only with stages 0 (disabled), 1 (optimizer
+// state partitioning) and 2 (gradient partitioning).
 
 struct ZeROConfig {
   // Default configuration
@@ -56,6 +56,11 @@ struct OptimizerGraphConfig {
   bool use_mixed_precision{false};
   bool allreduce_in_fp16{false};
   bool use_nccl{false};
+  // with NCCL, the gradients are all-reduced in buckets of about this many bytes, each as soon as the backward pass
+  // has produced its gradients, instead of all at once after the backward pass. 0 disables the buckets
+  int64_t allreduce_bucket_size_bytes{0};
+  // with NCCL, all-reduce the gradients quantized to 8 bits, keeping the quantization error for the next step
+  bool use_quantized_allreduce{false};
   ZeROConfig deepspeed_zero{0};
   int gradient_accumulation_steps{1};
   int64_t horovod_reduce_op{1};
@@ -97,7 +97,7 @@ Status OptimizerGraphBuilder::AddGradientScalingNodes(
   if (fuse_scaling_outputs) {
     TypeProto* fused_gradient_type_proto = graph_defs.CreateTypeProto();
     fused_gradient_type_proto->mutable_tensor_type()->set_elem_type(target_type);
-    fused_gradient_argdef = ArgDef("fused_gradient", fused_gradient_type_proto);
+    fused_gradient_argdef = ArgDef(nodearg_name_generator("fused_gradient"), fused_gradient_type_proto);
 
     std::vector<ArgDef> inputs;
     inputs.emplace_back(pre_allreduce_scale);
@@ -358,7 +358,8 @@ Status OptimizerGraphBuilder::Build(
   ORT_RETURN_IF_ERROR(GetArgDefsFromGraph(graph, weight_names_, weight_argdefs));
   ORT_RETURN_IF_ERROR(GetArgDefsFromGraph(graph, gradient_names_, gradient_argdefs));
 
-  const bool is_gradient_accumulation_enabled = opt_graph_config_.gradient_accumulation_steps > 1;
+  const bool is_gradient_accumulation_enabled =
+      opt_graph_config_.gradient_accumulation_steps > 1 && !AccumulatesGradientsInternally();
 
   // add gradient accumulation
   std::vector<ArgDef> gradient_accumulation_buffers;
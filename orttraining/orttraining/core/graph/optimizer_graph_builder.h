@@ -29,6 +29,15 @@ ArgDef BuildGradientAccumulationNode(const NodeArgNameGeneratorFn& nodearg_name_
                                      GraphAugmenter::GraphDefs& graph_defs,
                                      bool add_accumulate_buffer_as_initializers = true);
 
+ArgDef BuildGroupNode(const std::string& group_output_name,
+                      const std::vector<ArgDef>& input_argdefs,
+                      GraphAugmenter::GraphDefs& graph_defs);
+
+ArgDef BuildZeroGradientNode(const NodeArgNameGeneratorFn& nodearg_name_generator,
+                             const ArgDef& control_signal,
+                             const ArgDef& gradient,
+                             GraphAugmenter::GraphDefs& graph_defs);
+
 /**
  * Builds the optimizer components on top of an existing training graph.
  * The optimizers used are determined by the weight_names_to_opt_configs parameter
@@ -65,6 +74,10 @@ class OptimizerGraphBuilder {
       OptimizerOutputKeyMap<std::string>& optimizer_graph_outputs);
 
  protected:
+  // Whether BuildInternal() accumulates the gradients itself, e.g. after reducing them.
+  // Otherwise the gradients passed to BuildInternal() are already accumulated.
+  virtual bool AccumulatesGradientsInternally() const { return false; }
+
   virtual Status BuildInternal(
       Graph& graph,
       GraphAugmenter::GraphDefs& graph_defs,
@@ -0,0 +1,255 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/core/graph/recompute_transformer.h"
+#include <algorithm>
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+namespace training {
+
+namespace {
+
+bool IsBackwardNode(const Node& node) {
+  return node.Description() == "Backward pass";
+}
+
+// Recomputing a random op would not reproduce the values (e.g. the Dropout mask) used in the forward pass.
+bool IsDeterministic(const Node& node) {
+  const auto& op_type = node.OpType();
+  return op_type.find("Dropout") == std::string::npos && op_type.find("Random") == std::string::npos;
+}
+
+int64_t NumElements(const NodeArg& node_arg) {
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr) {
+    return 0;
+  }
+
+  int64_t num_elements = 1;
+  for (const auto& dim : shape->dim()) {
+    if (dim.has_dim_value()) {
+      num_elements *= dim.dim_value();
+    }
+  }
+  return num_elements;
+}
+
+int64_t ElementSize(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return 0;
+  }
+
+  switch (type->tensor_type().elem_type()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+      return 8;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+      return 4;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+      return 2;
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+// Element-wise ops are counted as one FLOP per output element, MatMul as 2 * K.
+int64_t EstimateFlops(const Node& node) {
+  int64_t num_elements = 0;
+  for (const auto* output : node.OutputDefs()) {
+    if (output->Exists()) {
+      num_elements += NumElements(*output);
+    }
+  }
+
+  if (node.OpType() == "MatMul") {
+    const auto* shape = node.InputDefs()[0]->Shape();
+    if (shape != nullptr && shape->dim_size() > 0 && shape->dim(shape->dim_size() - 1).has_dim_value()) {
+      return 2 * shape->dim(shape->dim_size() - 1).dim_value() * num_elements;
+    }
+  }
+  return num_elements;
+}
+
+// WaitEvent with event id -1 does not wait and only passes its inputs through.
+// Its additional inputs are dependencies that delay the recomputation until the backward pass needs it.
+NodeArg& GetNoWaitEventId(Graph& graph, NodeArg*& event_id_arg) {
+  if (event_id_arg == nullptr) {
+    ONNX_NAMESPACE::TensorProto event_id{};
+    event_id.set_name(graph.GenerateNodeArgName("recompute_event_id"));
+    event_id.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    event_id.add_int64_data(-1);
+    graph.AddInitializedTensor(event_id);
+
+    ONNX_NAMESPACE::TypeProto event_id_type{};
+    event_id_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    event_id_type.mutable_tensor_type()->mutable_shape();
+    event_id_arg = &graph.GetOrCreateNodeArg(event_id.name(), &event_id_type);
+  }
+  return *event_id_arg;
+}
+
+}  // namespace
+
+Status TransformGraphForRecompute(Graph& graph,
+                                  const std::unordered_set<std::string>& op_types,
+                                  const std::unordered_set<std::string>& activation_names,
+                                  RecomputeReport& report) {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  std::unordered_map<NodeIndex, size_t> topological_position{};
+  for (size_t i = 0; i < order.size(); ++i) {
+    topological_position[order[i]] = i;
+  }
+
+  std::unordered_set<std::string> graph_output_names{};
+  for (const auto* output : graph.GetOutputs()) {
+    graph_output_names.insert(output->Name());
+  }
+
+  // The backward consumers of the forward activations, i.e. the activations stashed for the backward pass.
+  std::unordered_map<std::string, std::vector<Node*>> backward_consumers{};
+  for (auto& node : graph.Nodes()) {
+    if (!IsBackwardNode(node)) {
+      continue;
+    }
+    for (const auto* input : node.InputDefs()) {
+      const Node* producer = graph.GetProducerNode(input->Name());
+      if (producer != nullptr && !IsBackwardNode(*producer)) {
+        auto& consumers = backward_consumers[input->Name()];
+        if (std::find(consumers.begin(), consumers.end(), &node) == consumers.end()) {
+          consumers.push_back(&node);
+        }
+      }
+    }
+  }
+
+  std::unordered_set<std::string> recomputed_activations{};
+  NodeArg* event_id_arg = nullptr;
+  for (auto index : order) {
+    Node* node = graph.GetNode(index);
+    if (node == nullptr || IsBackwardNode(*node) || !IsDeterministic(*node) || node->ContainsSubgraph()) {
+      continue;
+    }
+
+    const bool is_selected_op_type = op_types.find(node->OpType()) != op_types.end();
+    std::vector<size_t> dropped_output_indices{};
+    for (size_t i = 0; i < node->OutputDefs().size(); ++i) {
+      const auto& name = node->OutputDefs()[i]->Name();
+      if (!node->OutputDefs()[i]->Exists() ||
+          graph_output_names.find(name) != graph_output_names.end() ||
+          backward_consumers.find(name) == backward_consumers.end()) {
+        continue;
+      }
+      if (is_selected_op_type || activation_names.find(name) != activation_names.end()) {
+        dropped_output_indices.push_back(i);
+      }
+    }
+    if (dropped_output_indices.empty()) {
+      continue;
+    }
+
+    // Only recompute from tensors the backward pass holds anyway, otherwise no memory is saved.
+    // Recomputed inputs are not chained: the consumers of this node's outputs run earlier in the
+    // backward pass than the ones the input's recomputation is delayed for.
+    std::vector<NodeArg*> inputs{};
+    bool inputs_available = true;
+    for (auto* input : node->MutableInputDefs()) {
+      if (!input->Exists() || graph.GetProducerNode(input->Name()) == nullptr ||
+          (backward_consumers.find(input->Name()) != backward_consumers.end() &&
+           recomputed_activations.find(input->Name()) == recomputed_activations.end())) {
+        inputs.push_back(input);
+      } else {
+        inputs_available = false;
+        break;
+      }
+    }
+    if (!inputs_available) {
+      continue;
+    }
+
+    // Delay the recomputation until the other backward inputs of its first consumer are ready.
+    const Node* first_consumer = nullptr;
+    for (auto i : dropped_output_indices) {
+      for (const auto* consumer : backward_consumers[node->OutputDefs()[i]->Name()]) {
+        if (first_consumer == nullptr ||
+            topological_position[consumer->Index()] < topological_position[first_consumer->Index()]) {
+          first_consumer = consumer;
+        }
+      }
+    }
+    NodeArg* dependency = nullptr;
+    for (auto* input : first_consumer->InputDefs()) {
+      const Node* producer = graph.GetProducerNode(input->Name());
+      if (producer != nullptr && IsBackwardNode(*producer) &&
+          topological_position.find(producer->Index()) != topological_position.end()) {
+        dependency = const_cast<NodeArg*>(input);
+        break;
+      }
+    }
+
+    const bool has_inputs = std::any_of(inputs.begin(), inputs.end(), [](const NodeArg* input) {
+      return input->Exists();
+    });
+    if (dependency != nullptr && has_inputs) {
+      std::vector<NodeArg*> wait_inputs{&GetNoWaitEventId(graph, event_id_arg)};
+      std::vector<NodeArg*> wait_outputs{};
+      for (auto*& input : inputs) {
+        if (input->Exists()) {
+          wait_inputs.push_back(input);
+          input = &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(input->Name() + "_recompute_input"),
+                                            input->TypeAsProto());
+          wait_outputs.push_back(input);
+        }
+      }
+      wait_inputs.push_back(dependency);
+      graph.AddNode(graph.GenerateNodeName(node->Name() + "_recompute_wait"), "WaitEvent", "Backward pass",
+                    wait_inputs, wait_outputs, nullptr, kMSDomain);
+    }
+
+    std::vector<NodeArg*> outputs{};
+    for (auto* output : node->MutableOutputDefs()) {
+      outputs.push_back(output->Exists()
+                            ? &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output->Name() + "_recompute"),
+                                                        output->TypeAsProto())
+                            : output);
+    }
+    graph.AddNode(graph.GenerateNodeName(node->Name() + "_recompute"), node->OpType(), "Backward pass",
+                  inputs, outputs, &node->GetAttributes(), node->Domain());
+    report.extra_flops += EstimateFlops(*node);
+
+    for (auto i : dropped_output_indices) {
+      const NodeArg* output = node->OutputDefs()[i];
+      for (auto* consumer : backward_consumers[output->Name()]) {
+        for (size_t j = 0; j < consumer->InputDefs().size(); ++j) {
+          if (consumer->InputDefs()[j] == output) {
+            graph_utils::ReplaceNodeInput(*consumer, static_cast<int>(j), *outputs[i]);
+          }
+        }
+      }
+
+      recomputed_activations.insert(output->Name());
+      report.recomputed_activations.push_back(output->Name());
+      report.bytes_saved += NumElements(*output) * ElementSize(*output);
+    }
+  }
+
+  if (report.recomputed_activations.empty()) {
+    return Status::OK();
+  }
+
+  graph.SetGraphResolveNeeded();
+  return graph.Resolve();
+}
+
+}  // namespace training
+}  // namespace onnxruntime
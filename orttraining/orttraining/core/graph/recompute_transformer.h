@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+namespace training {
+
+/**
+ * Summary of the activations dropped by TransformGraphForRecompute().
+ *
+ * The byte and FLOP estimates count symbolic dimensions (e.g. batch size or
+ * sequence length) as 1, so they scale with the product of those dimensions.
+ */
+struct RecomputeReport {
+  // The forward activations no longer kept alive for the backward pass.
+  std::vector<std::string> recomputed_activations;
+  // The bytes of stashed activations freed after their last forward use.
+  int64_t bytes_saved{0};
+  // The FLOPs spent to recompute the activations in the backward pass.
+  int64_t extra_flops{0};
+};
+
+/**
+ * Applies activation recomputation (gradient checkpointing) to a graph
+ * containing forward and backward nodes.
+ *
+ * A forward activation consumed by the backward pass is dropped if its
+ * producer is deterministic and all of the producer's inputs are available
+ * in the backward pass anyway (initializers, graph inputs or activations that
+ * are stashed and not recomputed themselves). The producer is then cloned into the
+ * backward pass and the backward consumers are rewired to the clone, which
+ * is ordered after the consumer's other backward inputs so that the
+ * recomputed tensor is short-lived.
+ *
+ * @param graph The graph, which must already contain the backward pass.
+ * @param op_types The op types whose outputs are recomputed.
+ * @param activation_names The names of additional activations to recompute.
+ * @param report The summary of the recomputed activations.
+ *
+ * @return The status of the operation.
+ */
+Status TransformGraphForRecompute(Graph& graph,
+                                  const std::unordered_set<std::string>& op_types,
+                                  const std::unordered_set<std::string>& activation_names,
+                                  RecomputeReport& report);
+
+}  // namespace training
+}  // namespace onnxruntime
@@ -131,50 +131,10 @@ static void propagateRecvOutputTensorElemTypes(
   }
 }
 
-// TODO: This is copied from onnx schemas. When the change is in and we update this can be removed.
-// For Brevity documentation was not copied
-OpSchema& RegisterLambOpSchema(OpSchema&& op_schema) {
+// Inputs, outputs and type constraints shared by the optimizers updating a group of weights,
+// e.g. LambOptimizer and MultiTensorAdamOptimizer.
+void AddMultiTensorOptimizerInputsAndOutputs(OpSchema& op_schema) {
   op_schema
-      .SetDomain(kMSDomain)
-      .SinceVersion(1)
-      .Attr(
-          "alpha",
-          "Coefficient of previous gradient in running average.",
-          AttributeProto::FLOATS,
-          std::vector<float>(1024, 0.9f))
-      .Attr(
-          "beta",
-          "Coefficient of previous squared gradient in running average."
-          "The effective learning rate is computed by r = R / (1 + T * decay_factor). "
-          "Default to 0 so that increasing update counts doesn't reduce the learning rate.",
-          AttributeProto::FLOATS,
-          std::vector<float>(1024, 0.999f))
-      .Attr(
-          "lambda",
-          "Regularization coefficient of 0.5 * lambda * ||X||_2^2. Default to 0, "
-          "which means no regularization.",
-          AttributeProto::FLOATS,
-          std::vector<float>(1024, 0.0f))
-      .Attr(
-          "ratio_min",
-          "Lower bound on confidence ratio.",
-          AttributeProto::FLOAT,
-          -std::numeric_limits<float>::infinity())
-      .Attr(
-          "ratio_max",
-          "Upper bound on confidence ratio.",
-          AttributeProto::FLOAT,
-          std::numeric_limits<float>::infinity())
-      .Attr(
-          "epsilon",
-          "Small scalar to avoid dividing by zero.",
-          AttributeProto::FLOATS,
-          std::vector<float>(1024, 1e-6f))
-      .Attr(
-          "do_bias_correction",
-          "Compute unbiased 1st and 2nd momentums.",
-          AttributeProto::INT,
-          static_cast<int64_t>(1))
       .TypeConstraint(
           "T1",
           {"tensor(float16)", "tensor(float)", "tensor(double)"},
@@ -315,6 +275,97 @@ OpSchema& RegisterLambOpSchema(OpSchema&& op_schema) {
        "T4",
        "T_FP16"},
       OpSchema::Optional);
+}
+
+// TODO: This is copied from onnx schemas. When the change is in and we update this can be removed.
+// For Brevity documentation was not copied
+OpSchema& RegisterLambOpSchema(OpSchema&& op_schema) {
+  op_schema
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .Attr(
+          "alpha",
+          "Coefficient of previous gradient in running average.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 0.9f))
+      .Attr(
+          "beta",
+          "Coefficient of previous squared gradient in running average."
+          "The effective learning rate is computed by r = R / (1 + T * decay_factor). "
+          "Default to 0 so that increasing update counts doesn't reduce the learning rate.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 0.999f))
+      .Attr(
+          "lambda",
+          "Regularization coefficient of 0.5 * lambda * ||X||_2^2. Default to 0, "
+          "which means no regularization.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 0.0f))
+      .Attr(
+          "ratio_min",
+          "Lower bound on confidence ratio.",
+          AttributeProto::FLOAT,
+          -std::numeric_limits<float>::infinity())
+      .Attr(
+          "ratio_max",
+          "Upper bound on confidence ratio.",
+          AttributeProto::FLOAT,
+          std::numeric_limits<float>::infinity())
+      .Attr(
+          "epsilon",
+          "Small scalar to avoid dividing by zero.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 1e-6f))
+      .Attr(
+          "do_bias_correction",
+          "Compute unbiased 1st and 2nd momentums.",
+          AttributeProto::INT,
+          static_cast<int64_t>(1));
+
+  AddMultiTensorOptimizerInputsAndOutputs(op_schema);
+
+  return op_schema;
+}
+
+OpSchema& RegisterMultiTensorAdamOpSchema(OpSchema&& op_schema) {
+  op_schema
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .Attr(
+          "alpha",
+          "Coefficient of previous gradient in running average.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 0.9f))
+      .Attr(
+          "beta",
+          "Coefficient of previous squared gradient in running average.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 0.999f))
+      .Attr(
+          "lambda",
+          "Regularization coefficient of 0.5 * lambda * ||X||_2^2. Default to 0, "
+          "which means no regularization.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 0.0f))
+      .Attr(
+          "epsilon",
+          "Small scalar to avoid dividing by zero.",
+          AttributeProto::FLOATS,
+          std::vector<float>(1024, 1e-8f))
+      .Attr(
+          "do_bias_correction",
+          "Compute unbiased 1st and 2nd momentums.",
+          AttributeProto::INT,
+          static_cast<int64_t>(1))
+      .Attr(
+          "weight_decay_mode",
+          "Modes for applying weight decay, "
+          "0 means applying decay before weight update, "
+          "1 means applying decay after weight update.",
+          AttributeProto::INT,
+          static_cast<int64_t>(0));
+
+  AddMultiTensorOptimizerInputsAndOutputs(op_schema);
 
   return op_schema;
 }
@@ -655,6 +706,8 @@ void RegisterTrainingOpSchemas() {
 
   ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(LambOptimizer, RegisterLambOpSchema);
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(MultiTensorAdamOptimizer, RegisterMultiTensorAdamOpSchema);
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(InPlaceAccumulator)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -876,6 +929,11 @@ Example 4:
       .Attr("group_type", "0 - data parallel group, 1 - horizontal parallel group",
             AttributeProto::INT,
             static_cast<int64_t>(0))
+      .Attr("use_comm_stream",
+            "1 - all-reduce on the NCCL communication stream, overlapped with the following kernels. "
+            "The outputs must go through NcclWait before being used",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
       .Input(0, "input", "tensors to be reduced", "T", OpSchema::Variadic)
       .Output(0, "output", "reduced tensors", "T", OpSchema::Variadic)
       .TypeConstraint(
@@ -886,6 +944,54 @@ Example 4:
         propagateShapeAndTypeFromFirstInput(ctx);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NcclQuantizedAllReduce)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("All-reduces a tensor quantized to 8 bits per element, with a scale per block of elements "
+              "shared by all the ranks. The quantization error is added to the input of the next call.")
+      .Attr("group_type", "0 - data parallel group, 1 - horizontal parallel group",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Input(0, "input", "tensor to be reduced", "T")
+      .Input(1, "error", "quantization error of the previous call, with as many elements as the input", "T_ERROR")
+      .Output(0, "output", "reduced tensor", "T")
+      .Output(1, "error_out", "quantization error of this call", "T_ERROR")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)"},
+          "Constrain to float and float16 tensors.")
+      .TypeConstraint(
+          "T_ERROR",
+          {"tensor(float)"},
+          "Constrain the quantization error to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateShapeAndTypeFromFirstInput(ctx);
+        propagateElemTypeFromInputToOutput(ctx, 1, 1);
+        if (hasInputShape(ctx, 1)) {
+          propagateShapeFromInputToOutput(ctx, 1, 1);
+        }
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NcclWait)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Makes the following kernels wait for the NCCL operations launched on the communication stream, "
+              "and outputs its inputs.")
+      .Input(0, "input", "tensors produced on the communication stream", "T", OpSchema::Variadic)
+      .Output(0, "output", "the input tensors", "T", OpSchema::Variadic)
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain to float, float16 and double tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        for (size_t i = 0; i < ctx.getNumInputs(); ++i) {
+          propagateElemTypeFromInputToOutput(ctx, i, i);
+          if (hasInputShape(ctx, i)) {
+            propagateShapeFromInputToOutput(ctx, i, i);
+          }
+        }
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(NcclAllGather)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1058,6 +1164,86 @@ Example 4:
         }
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(BiasDropoutLayerNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetSupportLevel(OpSchema::SupportType::EXPERIMENTAL)
+      .SetDoc("BiasDropout followed by LayerNormalization over the last dimension: "
+              "output = LayerNormalization(Dropout(data + bias) + residual, scale, B)")
+      .Attr("seed", "(Optional) Seed to the random generator, if not specified we will auto generate one.", AttributeProto::INT, OPTIONAL_VALUE)
+      .Attr("epsilon",
+            "The epsilon value to use to avoid division by zero.",
+            AttributeProto::FLOAT, 1e-5f)
+      .AllowUncheckedAttributes()
+      .Input(0, "data", "The input data as Tensor.", "T")
+      .Input(1, "bias", "The bias input, a vector with the same shape as last dim of data", "T")
+      .Input(2, "scale", "Scale tensor of the normalization, with the same shape as last dim of data.", "T")
+      .Input(3, "B", "Bias tensor of the normalization, with the same shape as last dim of data.", "T")
+      .Input(4, "residual", "The residual input, must have the same shape as data", "T", OpSchema::Optional)
+      .Input(5, "ratio",
+             "The ratio of random dropout, with value in [0, 1). If this input was not set, "
+             "or if it was set to 0, nothing is dropped.",
+             "T1",
+             OpSchema::Optional)
+      .Input(6, "training_mode",
+             "If set to true then it indicates dropout is being used for "
+             "training. It is an optional value hence unless specified explicitly, it is false. "
+             "If it is false, ratio is ignored and nothing is dropped.",
+             "T2",
+             OpSchema::Optional)
+      .Output(0, "output", "The normalized output.", "T")
+      .Output(1, "mean", "Saved mean used during training to speed up gradient computation", "U", OpSchema::Optional)
+      .Output(2, "inv_std_var", "Saved inverse standard variance used during training to speed up gradient computation.", "U", OpSchema::Optional)
+      .Output(3, "mask", "The output mask of dropout.", "T2", OpSchema::Optional)
+      .Output(4, "dropout_output", "The input of the normalization, Dropout(data + bias) + residual.", "T", OpSchema::Optional)
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)"},
+          "Constrain input and output types (except mean and inv_std_var) to float tensors.")
+      .TypeConstraint(
+          "U",
+          {"tensor(float)"},
+          "Constrain mean and inv_std_var to be float tensors.")
+      .TypeConstraint(
+          "T1",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain input 'ratio' types to float tensors.")
+      .TypeConstraint(
+          "T2",
+          {"tensor(bool)"},
+          "Constrain output 'mask' types to boolean tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateShapeAndTypeFromFirstInput(ctx);
+        const auto num_outputs = ctx.getNumOutputs();
+        if (num_outputs > 1) {
+          updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::FLOAT);
+        }
+        if (num_outputs > 2) {
+          updateOutputElemType(ctx, 2, ONNX_NAMESPACE::TensorProto::FLOAT);
+        }
+        if (num_outputs > 3) {
+          updateOutputElemType(ctx, 3, ONNX_NAMESPACE::TensorProto::BOOL);
+        }
+        if (num_outputs > 4) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 4);
+        }
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+        auto& input_shape = ctx.getInputType(0)->tensor_type().shape();
+        if (input_shape.dim_size() < 1) {
+          fail_shape_inference("data is expected to have at least 1 dimension");
+        }
+        for (size_t i = 1; i < num_outputs && i < 3; ++i) {
+          auto saved_shape = ctx.getOutputType(i)->mutable_tensor_type()->mutable_shape();
+          saved_shape->CopyFrom(input_shape);
+          saved_shape->mutable_dim(input_shape.dim_size() - 1)->set_dim_value(1);
+        }
+        for (size_t i = 3; i < num_outputs; ++i) {
+          propagateShapeFromInputToOutput(ctx, 0, i);
+        }
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(TrainableDropout)
       .SetDomain(kOnnxDomain)
       .SinceVersion(9)
@@ -1185,7 +1371,7 @@ Example 4:
   ONNX_CONTRIB_OPERATOR_SCHEMA(GistBinarizeDecoder)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
-      .Input(0, "X1", "dummy input for late decoding", "T")
+      .Input(0, "X1", "dummy input for late decoding", "T2", OpSchema::Optional)
       .Input(1, "X", "compresssed input", "T1")
       .Output(0, "Y", "uncompressed output", "T")
       .TypeConstraint(
@@ -1195,7 +1381,83 @@ Example 4:
       .TypeConstraint(
           "T1",
           {"tensor(bool)"},
-          "Binarize tensors.");
+          "Binarize tensors.")
+      .TypeConstraint(
+          "T2",
+          OpSchema::all_tensor_types(),
+          "Allow any tensor as the dependency.");
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GistPack16Encoder)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Stores a float tensor stashed for the backward pass in float16.")
+      .Input(0, "X", "uncompressed input", "T")
+      .Output(0, "Y", "uncompressed output", "T")
+      .Output(1, "Y1", "compressed output", "T1")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain to float tensors.")
+      .TypeConstraint(
+          "T1",
+          {"tensor(float16)"},
+          "Packed tensors.");
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GistPack16Decoder)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .Input(0, "X1", "dummy input for late decoding", "T2", OpSchema::Optional)
+      .Input(1, "X", "compresssed input", "T1")
+      .Output(0, "Y", "uncompressed output", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain to float tensors.")
+      .TypeConstraint(
+          "T1",
+          {"tensor(float16)"},
+          "Packed tensors.")
+      .TypeConstraint(
+          "T2",
+          OpSchema::all_tensor_types(),
+          "Allow any tensor as the dependency.");
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GistPack8Encoder)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(
+          "Stores a tensor stashed for the backward pass as 8-bit floats with a sign bit, 5 exponent bits and "
+          "2 mantissa bits, i.e. the high byte of the float16 value rounded to nearest even.")
+      .Input(0, "X", "uncompressed input", "T")
+      .Output(0, "Y", "uncompressed output", "T")
+      .Output(1, "Y1", "compressed output", "T1")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)"},
+          "Constrain to float tensors.")
+      .TypeConstraint(
+          "T1",
+          {"tensor(uint8)"},
+          "Packed tensors.");
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GistPack8Decoder)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .Input(0, "X1", "dummy input for late decoding", "T2", OpSchema::Optional)
+      .Input(1, "X", "compresssed input", "T1")
+      .Output(0, "Y", "uncompressed output", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)"},
+          "Constrain to float tensors.")
+      .TypeConstraint(
+          "T1",
+          {"tensor(uint8)"},
+          "Packed tensors.")
+      .TypeConstraint(
+          "T2",
+          OpSchema::all_tensor_types(),
+          "Allow any tensor as the dependency.");
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(SinGrad)
       .SetDomain(kOnnxDomain)
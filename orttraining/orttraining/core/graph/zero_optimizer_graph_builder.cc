@@ -271,6 +271,33 @@ static Status ModifyParametersForOptimizerPartitioning(
   return Status::OK();
 }
 
+// Accumulates the partition of the reduced gradients handled by this rank, so that the
+// accumulation buffers only hold 1 / data_parallel_group_size of the gradients.
+static ArgDef AddGradientAccumulationNodesForPartition(
+    const NodeArgNameGeneratorFn& nodearg_name_generator,
+    const std::vector<OptimizerNodeConfig>& opt_configs,
+    std::vector<ArgDef>& gradient_argdefs,
+    std::vector<ArgDef>& gradient_accumulation_buffers,
+    GraphAugmenter::GraphDefs& graph_defs) {
+  std::vector<ArgDef> accumulated_gradient_argdefs;
+  gradient_accumulation_buffers.resize(gradient_argdefs.size());
+  for (size_t i = 0; i < gradient_argdefs.size(); i++) {
+    if (opt_configs[i].enabled) {
+      gradient_argdefs[i] = BuildGradientAccumulationNode(
+          nodearg_name_generator, gradient_argdefs[i], gradient_accumulation_buffers[i], graph_defs);
+      accumulated_gradient_argdefs.push_back(gradient_argdefs[i]);
+    }
+  }
+
+  // The ReduceScatter must run at every step on all ranks, including the ones handling no gradient.
+  ArgDef group_accumulate_gradient_output = BuildGroupNode(
+      nodearg_name_generator("Group_Accumulated_Gradients"),
+      accumulated_gradient_argdefs.empty() ? gradient_argdefs : accumulated_gradient_argdefs,
+      graph_defs);
+  graph_defs.AddGraphOutputs({group_accumulate_gradient_output.name});
+  return group_accumulate_gradient_output;
+}
+
 static std::vector<ArgDef> GetGradientNormInputs(
     const std::vector<ArgDef>& gradient_argdefs,
     const std::vector<OptimizerNodeConfig>& opt_configs) {
@@ -294,6 +321,13 @@ ZeROOptimizerGraphBuilder::ZeROOptimizerGraphBuilder(
   ORT_ENFORCE(opt_graph_config.data_parallel_group_size > 1, "ZeRO optimizer graph builder can only be used for distributed training.");
   ORT_ENFORCE(opt_graph_config.use_nccl, "Distributed training with ZeRO is only supported with NCCL.");
   ORT_ENFORCE(IsNcclAvailable(), "Distributed training with NCCL is not supported, as NCCL is not enabled in this build.");
+  ORT_ENFORCE(opt_graph_config.deepspeed_zero.stage <= 2,
+              "ZeRO stage ", opt_graph_config.deepspeed_zero.stage, " is not supported. "
+              "Stages 1 (optimizer state partitioning) and 2 (gradient partitioning) are supported.");
+}
+
+bool ZeROOptimizerGraphBuilder::AccumulatesGradientsInternally() const {
+  return opt_graph_config_.deepspeed_zero.stage >= 2;
 }
 
 Status ZeROOptimizerGraphBuilder::BuildInternal(
@@ -322,6 +356,16 @@ Status ZeROOptimizerGraphBuilder::BuildInternal(
   // add Reducescatter for gradients
   ORT_RETURN_IF_ERROR(AddNcclReduceScatterForGradients(gradient_argdefs, graph_defs));
 
+  // add gradient accumulation of the reduced gradients handled by this rank
+  const bool is_gradient_accumulation_enabled =
+      AccumulatesGradientsInternally() && opt_graph_config_.gradient_accumulation_steps > 1;
+  std::vector<ArgDef> gradient_accumulation_buffers;
+  if (is_gradient_accumulation_enabled) {
+    ArgDef group_accumulate_gradient_output = AddGradientAccumulationNodesForPartition(
+        nodearg_name_generator, opt_configs_, gradient_argdefs, gradient_accumulation_buffers, graph_defs);
+    optimizer_graph_outputs[OptimizerOutputKey::GradientAccumulation] = group_accumulate_gradient_output.name;
+  }
+
   // check if all gradients are finite
   ArgDef global_grad_norm_argdef;
   ArgDef global_grad_norm_finite_argdef;
@@ -346,6 +390,15 @@ Status ZeROOptimizerGraphBuilder::BuildInternal(
       opt_configs_, graph_defs,
       optimizer_state_initializer_names));
 
+  // add zero gradient, once the weights are updated
+  if (is_gradient_accumulation_enabled) {
+    for (size_t i = 0; i < gradient_accumulation_buffers.size(); i++) {
+      if (opt_configs_[i].enabled) {
+        BuildZeroGradientNode(nodearg_name_generator, weight_argdefs[i], gradient_accumulation_buffers[i], graph_defs);
+      }
+    }
+  }
+
   // add Allgather for weights
   ORT_RETURN_IF_ERROR(AddNcclAllGatherForWeights(weight_argdefs, graph_defs));
 
@@ -16,6 +16,9 @@ class ZeROOptimizerGraphBuilder : public OptimizerGraphBuilder {
       const std::unordered_map<std::string, OptimizerNodeConfig>& weight_names_to_opt_configs);
 
  protected:
+  // With gradient partitioning (stage 2), the gradients are reduced before they are accumulated.
+  bool AccumulatesGradientsInternally() const override;
+
   virtual Status BuildInternal(
       Graph& graph,
       GraphAugmenter::GraphDefs& graph_defs,
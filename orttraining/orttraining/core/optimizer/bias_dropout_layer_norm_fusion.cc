@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/core/optimizer/bias_dropout_layer_norm_fusion.h"
+#include "core/graph/graph_utils.h"
+
+#include <algorithm>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// The LayerNormalization consuming the output of the dropout node as its input, if it normalizes the last dimension
+const Node* GetLastDimLayerNorm(const Node& dropout_node) {
+  const NodeArg* dropout_output = dropout_node.OutputDefs()[0];
+  const TensorShapeProto* shape = dropout_output->Shape();
+  if (shape == nullptr || shape->dim_size() < 1) {
+    return nullptr;
+  }
+
+  for (auto it = dropout_node.OutputNodesBegin(); it != dropout_node.OutputNodesEnd(); ++it) {
+    const Node& node = *it;
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "LayerNormalization", {1}, kOnnxDomain) ||
+        node.GetExecutionProviderType() != dropout_node.GetExecutionProviderType() ||
+        node.InputDefs()[0] != dropout_output) {
+      continue;
+    }
+
+    const auto& attrs = node.GetAttributes();
+    const auto axis = attrs.find("axis");
+    if (axis != attrs.end() && axis->second.i() != -1 && axis->second.i() != shape->dim_size() - 1) {
+      return nullptr;
+    }
+
+    // scale and B are vectors over the normalized dimension
+    for (size_t i = 1; i < 3; ++i) {
+      const TensorShapeProto* vector_shape = node.InputDefs()[i]->Shape();
+      if (vector_shape == nullptr || vector_shape->dim_size() != 1) {
+        return nullptr;
+      }
+    }
+    return &node;
+  }
+  return nullptr;
+}
+}  // namespace
+
+Status BiasDropoutLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                             const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "BiasDropout", {1}, kMSDomain) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // the fused kernel normalizes float and float16 data
+    const auto* data_type = node.InputDefs()[0]->TypeAsProto();
+    if (data_type == nullptr ||
+        (data_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT &&
+         data_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT16)) {
+      continue;
+    }
+
+    const Node* layer_norm = GetLastDimLayerNorm(node);
+    if (layer_norm == nullptr) {
+      continue;
+    }
+    Node& layer_norm_node = *graph.GetNode(layer_norm->Index());
+
+    NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+    auto get_input = [&empty_arg](Node& n, size_t i) {
+      return i < n.MutableInputDefs().size() ? n.MutableInputDefs()[i] : &empty_arg;
+    };
+    auto get_output = [&empty_arg](Node& n, size_t i) {
+      return i < n.MutableOutputDefs().size() ? n.MutableOutputDefs()[i] : &empty_arg;
+    };
+
+    std::vector<NodeArg*> fused_inputs{
+        get_input(node, 0),             // data
+        get_input(node, 1),             // bias
+        get_input(layer_norm_node, 1),  // scale
+        get_input(layer_norm_node, 2),  // B
+        get_input(node, 2),             // residual
+        get_input(node, 3),             // ratio
+        get_input(node, 4)};            // training_mode
+
+    // the input of the normalization is only written out when something else consumes it
+    size_t dropout_output_consumers = 0;
+    for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+      if (it->GetSrcArgIndex() == 0) {
+        ++dropout_output_consumers;
+      }
+    }
+    const std::vector<int> graph_outputs = graph.GetNodeOutputsInGraphOutputs(node);
+    const bool keep_dropout_output = dropout_output_consumers > 1 ||
+                                     std::find(graph_outputs.begin(), graph_outputs.end(), 0) != graph_outputs.end();
+
+    std::vector<NodeArg*> fused_outputs{
+        get_output(layer_norm_node, 0),  // output
+        get_output(layer_norm_node, 1),  // mean
+        get_output(layer_norm_node, 2),  // inv_std_var
+        get_output(node, 1),             // mask
+        keep_dropout_output ? node.MutableOutputDefs()[0] : &empty_arg};
+
+    const std::string op_type = "BiasDropoutLayerNormalization";
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(op_type),
+                                     op_type,
+                                     "fused BiasDropout and LayerNormalization",
+                                     fused_inputs,
+                                     fused_outputs,
+                                     {},
+                                     kMSDomain);
+
+    const NodeAttributes& dropout_attrs = node.GetAttributes();
+    NodeAttributes::const_iterator seed = dropout_attrs.find("seed");
+    if (seed != dropout_attrs.end()) {
+      fused_node.AddAttribute("seed", seed->second);
+    }
+    const NodeAttributes& layer_norm_attrs = layer_norm_node.GetAttributes();
+    NodeAttributes::const_iterator epsilon = layer_norm_attrs.find("epsilon");
+    if (epsilon != layer_norm_attrs.end()) {
+      fused_node.AddAttribute("epsilon", epsilon->second);
+    }
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    for (Node* n : {&node, &layer_norm_node}) {
+      graph_utils::RemoveNodeOutputEdges(graph, *n);
+      graph.RemoveNode(n->Index());
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class BiasDropoutLayerNormFusion
+
+Fuse BiasDropout + LayerNormalization over the last dimension to BiasDropoutLayerNormalization. Runs after
+BiasDropoutFusion. The input of the normalization is kept as an output of the fused node when other nodes, such as
+LayerNormalizationGrad, consume it.
+
+*/
+class BiasDropoutLayerNormFusion : public GraphTransformer {
+ public:
+  BiasDropoutLayerNormFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("BiasDropoutLayerNormFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -8,103 +8,143 @@
 #include "core/graph/graph_utils.h"
 
 namespace onnxruntime {
-struct GraphEdgeHelper {
-  NodeIndex src_node;
-  NodeIndex dst_node;
-  int src_arg_index;
-  int dst_arg_index;
-  std::string arg_name;
-
-  GraphEdgeHelper(NodeIndex src_node, NodeIndex dst_node,
-                  int src_arg_index, int dst_arg_index, const std::string& arg_name) : src_node(src_node),
-                                                                                       dst_node(dst_node),
-                                                                                       src_arg_index(src_arg_index),
-                                                                                       dst_arg_index(dst_arg_index),
-                                                                                       arg_name(arg_name) {}
-
-  static GraphEdgeHelper CreateGraphEdge(const Node& node, const Node::EdgeEnd& edge_end, bool is_input_edge) {
-    return is_input_edge
-               ? GraphEdgeHelper(edge_end.GetNode().Index(),
-                                 node.Index(),
-                                 edge_end.GetSrcArgIndex(),
-                                 edge_end.GetDstArgIndex(),
-                                 node.InputDefs()[edge_end.GetDstArgIndex()]->Name())
-               : GraphEdgeHelper(node.Index(),
-                                 edge_end.GetNode().Index(),
-                                 edge_end.GetSrcArgIndex(),
-                                 edge_end.GetDstArgIndex(),
-                                 node.InputDefs()[edge_end.GetSrcArgIndex()]->Name());
-  }
-};
 
-static std::vector<GraphEdgeHelper> GetNodeOutputEdges(const Node& node) {
-  std::vector<GraphEdgeHelper> output_edges;
-  for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
-    output_edges.push_back(GraphEdgeHelper::CreateGraphEdge(node, *it, false));
-  }
+namespace {
 
-  return output_edges;
+bool IsBackwardNode(const Node& node) {
+  return node.Description() == "Backward pass";
 }
-static std::vector<GraphEdgeHelper> GetNodeInputEdges(const Node& node) {
-  std::vector<GraphEdgeHelper> input_edges;
-  for (auto it = node.InputEdgesBegin(), end = node.InputEdgesEnd(); it != end; ++it) {
-    input_edges.push_back(GraphEdgeHelper::CreateGraphEdge(node, *it, true));
+
+// The element type of the compressed tensor, or UNDEFINED if the compression doesn't support the input type.
+ONNX_NAMESPACE::TensorProto_DataType GetCompressedElementType(const std::string& compression_type, int32_t elem_type) {
+  const bool is_float = elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
+  const bool is_float16 = elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16;
+  const bool is_double = elem_type == ONNX_NAMESPACE::TensorProto_DataType_DOUBLE;
+  if (compression_type == GistEncodeDecode::GIST_BINARIZE && (is_float || is_float16 || is_double)) {
+    return ONNX_NAMESPACE::TensorProto_DataType_BOOL;
   }
-  return input_edges;
+  if (compression_type == GistEncodeDecode::GIST_PACK16 && is_float) {
+    return ONNX_NAMESPACE::TensorProto_DataType_FLOAT16;
+  }
+  if (compression_type == GistEncodeDecode::GIST_PACK8 && (is_float || is_float16)) {
+    return ONNX_NAMESPACE::TensorProto_DataType_UINT8;
+  }
+  return ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED;
+}
+
+bool CanCompress(const std::string& compression_type, const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         GetCompressedElementType(compression_type, type->tensor_type().elem_type()) !=
+             ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED;
 }
-bool GistEncodeDecode::AddEncodeDecode(Graph& graph, Node& curr_node, std::string compression_type) const {
-  ONNX_NAMESPACE::TypeProto bool_tensor;
-  bool_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_BOOL);
 
-  if (curr_node.GetOutputEdgesCount() < 1) {
+}  // namespace
+
+bool GistEncodeDecode::AddEncodeDecode(Graph& graph, Node& curr_node, const std::string& compression_type,
+                                       const std::vector<GraphEdge>& decoded_edges) const {
+  if (decoded_edges.empty()) {
     return false;
   }
 
-  std::vector<GraphEdgeHelper> output_edges = GetNodeOutputEdges(curr_node);
+  auto* curr_node_output_arg = curr_node.MutableOutputDefs()[0];
+  if (!CanCompress(compression_type, *curr_node_output_arg)) {
+    return false;
+  }
+  const auto* type = curr_node_output_arg->TypeAsProto();
 
-  auto curr_node_output_defs = curr_node.OutputDefs();
-  auto curr_node_output_def_name = curr_node_output_defs[0]->Name();
-  auto* curr_node_output_arg = graph.GetNodeArg(curr_node_output_def_name);
+  ONNX_NAMESPACE::TypeProto compressed_type;
+  compressed_type.mutable_tensor_type()->set_elem_type(
+      GetCompressedElementType(compression_type, type->tensor_type().elem_type()));
+  if (curr_node_output_arg->Shape() != nullptr) {
+    *compressed_type.mutable_tensor_type()->mutable_shape() = *curr_node_output_arg->Shape();
+  }
 
   std::string encode_node_name = graph.GenerateNodeName(GIST_ENCODER_NODE_NAME_BASE);
-  for (int i = 0; i < curr_node_output_arg->Shape()->dim_size(); i++) {
-    bool_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(curr_node_output_arg->Shape()->dim(i).dim_value());
+  auto& encode_output_def_compressed_arg = graph.GetOrCreateNodeArg(encode_node_name, &compressed_type);
+  auto& encode_output_def_uncompressed_arg = graph.GetOrCreateNodeArg(encode_node_name + "_identity", type);
+  auto& encode = graph.AddNode(encode_node_name, compression_type + "Encoder", "Encode", {curr_node_output_arg},
+                               {&encode_output_def_uncompressed_arg, &encode_output_def_compressed_arg}, {},
+                               kMSDomain);
+  graph.AddEdge(curr_node.Index(), encode.Index(), 0, 0);
+
+  // The forward consumers read the identity output of the encoder, so it runs before the last of them.
+  std::vector<GraphEdge> forward_edges;
+  for (auto it = curr_node.OutputEdgesBegin(), end = curr_node.OutputEdgesEnd(); it != end; ++it) {
+    const Node& dst = it->GetNode();
+    if (it->GetSrcArgIndex() == 0 && dst.Index() != encode.Index() && !IsBackwardNode(dst) &&
+        static_cast<size_t>(it->GetDstArgIndex()) < dst.InputDefs().size()) {
+      forward_edges.push_back({curr_node.Index(), dst.Index(), 0, it->GetDstArgIndex()});
+    }
   }
-  auto& encode_output_def_compressed_arg = graph.GetOrCreateNodeArg(encode_node_name, &bool_tensor);
-  auto& encode_output_def_uncompressed_arg = graph.GetOrCreateNodeArg(encode_node_name + "_identity", curr_node_output_arg->TypeAsProto());
-  auto& encode = graph.AddNode(encode_node_name, compression_type + "Encoder", "Encode", {curr_node_output_arg}, {&encode_output_def_uncompressed_arg, &encode_output_def_compressed_arg}, {}, kMSDomain);
-
-  std::string decode_arg_name = graph.GenerateNodeName(GIST_DECODER_NODE_NAME_BASE);
-  auto& decode_output_def_uncompressed_arg = graph.GetOrCreateNodeArg(decode_arg_name, curr_node_output_arg->TypeAsProto());
-  auto& decode_output_def_dummy_arg = graph.GetOrCreateNodeArg(decode_arg_name + "_late_dec", curr_node_output_arg->TypeAsProto());
-  auto& decode = graph.AddNode(decode_arg_name, compression_type + "Decoder", "Decode", {&decode_output_def_dummy_arg, &encode_output_def_compressed_arg}, {&decode_output_def_uncompressed_arg}, {}, kMSDomain);
-
-  bool early_encoding = false;
-  bool late_decoding = false;
-  for (auto& output_edge : output_edges) {
-    Node* node_dst = graph.GetNode(output_edge.dst_node);
-    if (node_dst->Description() == "Backward pass" && (node_dst->OpType() == "ReluGrad")) {
-      graph.AddEdge(output_edge.src_node, encode.Index(), output_edge.src_arg_index, 0);
-      graph.AddEdge(encode.Index(), decode.Index(), 1, 1);
-      graph.AddEdge(decode.Index(), output_edge.dst_node, 0, output_edge.dst_arg_index);
-      std::vector<GraphEdgeHelper> input_edges_dst = GetNodeInputEdges(*node_dst);
-      size_t i = 0;
-      while (!late_decoding && i < input_edges_dst.size()) {
-        if (graph.GetNode(input_edges_dst[i].src_node)->OpType() != curr_node.OpType()) {
-          graph.AddEdge(input_edges_dst[i].src_node, decode.Index(), input_edges_dst[i].src_arg_index, 0);
-          late_decoding = true;
-        }
-        i++;
+  for (const auto& edge : forward_edges) {
+    graph.RemoveEdge(edge.src_node, edge.dst_node, edge.src_arg_index, edge.dst_arg_index);
+    graph.AddEdge(encode.Index(), edge.dst_node, 0, edge.dst_arg_index);
+  }
+
+  // Each backward consumer gets its own decoder, delayed until another of its inputs is ready. A decoder shared by
+  // several consumers could not wait for their inputs without creating a cycle.
+  for (const auto& edge : decoded_edges) {
+    Node* node_dst = graph.GetNode(edge.dst_node);
+    const Node::EdgeEnd* late_decoding_edge = nullptr;
+    for (auto it = node_dst->InputEdgesBegin(), end = node_dst->InputEdgesEnd(); it != end; ++it) {
+      if (it->GetNode().Index() != curr_node.Index() &&
+          static_cast<size_t>(it->GetDstArgIndex()) < node_dst->InputDefs().size()) {
+        late_decoding_edge = &*it;
+        break;
       }
-    } else if (!early_encoding) {
-      graph.AddEdge(encode.Index(), output_edge.dst_node, 0, output_edge.dst_arg_index);
-      early_encoding = true;
     }
+    NodeArg* late_decoding_arg = late_decoding_edge != nullptr
+                                     ? node_dst->MutableInputDefs()[late_decoding_edge->GetDstArgIndex()]
+                                     : &graph.GetOrCreateNodeArg("", nullptr);
+    const NodeIndex late_decoding_node = late_decoding_edge != nullptr ? late_decoding_edge->GetNode().Index() : 0;
+    const int late_decoding_arg_index = late_decoding_edge != nullptr ? late_decoding_edge->GetSrcArgIndex() : 0;
+
+    std::string decode_arg_name = graph.GenerateNodeName(GIST_DECODER_NODE_NAME_BASE);
+    auto& decode_output_def_uncompressed_arg = graph.GetOrCreateNodeArg(decode_arg_name, type);
+    auto& decode = graph.AddNode(decode_arg_name, compression_type + "Decoder", "Decode",
+                                 {late_decoding_arg, &encode_output_def_compressed_arg},
+                                 {&decode_output_def_uncompressed_arg}, {}, kMSDomain);
+    if (late_decoding_edge != nullptr) {
+      graph.AddEdge(late_decoding_node, decode.Index(), late_decoding_arg_index, 0);
+    }
+    graph.AddEdge(encode.Index(), decode.Index(), 1, 1);
+
+    graph.RemoveEdge(edge.src_node, edge.dst_node, edge.src_arg_index, edge.dst_arg_index);
+    graph.AddEdge(decode.Index(), edge.dst_node, 0, edge.dst_arg_index);
   }
   return true;
 }
+
 Status GistEncodeDecode::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect, const logging::Logger& /*logger*/) const {
-  if (GistEncodeDecode::AddEncodeDecode(graph, node, "GistBinarize")) {
+  const bool is_relu = node.OpType() == "Relu";
+  const bool is_pack_op_type = !pack_type_.empty() && pack_op_types_.find(node.OpType()) != pack_op_types_.end();
+
+  std::vector<GraphEdge> binarize_edges;
+  std::vector<GraphEdge> pack_edges;
+  for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+    const Node& dst = it->GetNode();
+    if (it->GetSrcArgIndex() != 0 || !IsBackwardNode(dst) ||
+        static_cast<size_t>(it->GetDstArgIndex()) >= dst.InputDefs().size()) {
+      continue;
+    }
+    GraphEdge edge{node.Index(), dst.Index(), 0, it->GetDstArgIndex()};
+    if (is_relu && dst.OpType() == "ReluGrad") {
+      binarize_edges.push_back(edge);
+    } else if (is_pack_op_type) {
+      pack_edges.push_back(edge);
+    }
+  }
+
+  // ReluGrad works with the unpacked activation too, which avoids stashing a mask as well.
+  if (!pack_edges.empty() && CanCompress(pack_type_, *node.OutputDefs()[0])) {
+    pack_edges.insert(pack_edges.end(), binarize_edges.begin(), binarize_edges.end());
+    binarize_edges.clear();
+  }
+
+  bool modified = AddEncodeDecode(graph, node, GIST_BINARIZE, binarize_edges);
+  modified = AddEncodeDecode(graph, node, pack_type_, pack_edges) || modified;
+  if (modified) {
     rule_effect = RewriteRuleEffect::kModifiedRestOfGraph;
   }
 
@@ -8,28 +8,60 @@
 namespace onnxruntime {
 
 /**
-@Class GistEncode
+@Class GistEncodeDecode
 
-Rewrite rule that encode when Relu is found.
+Rewrite rule that compresses the activations stashed for the backward pass (GIST).
 
-It is attempted to be triggered only on nodes with op type "Relu".
+The output of a Relu consumed by ReluGrad is stored as a binary mask (GistBinarize), which is all ReluGrad needs.
+If a pack type is set, the outputs of the pack op types consumed in the backward pass are stored in reduced
+precision instead: float16 (GistPack16) or 8-bit floats with 5 exponent and 2 mantissa bits (GistPack8).
+
+The encoder runs before the forward consumers of the activation, so the full precision tensor is freed after its
+last forward use, and each decoder waits for another input of its backward consumer.
+
+It is attempted to be triggered only on nodes with op type "Relu" or one of the pack op types.
 */
 class GistEncodeDecode : public RewriteRule {
  public:
   static constexpr const char* GIST_ENCODER_NODE_NAME_BASE = "gist_encode";
   static constexpr const char* GIST_DECODER_NODE_NAME_BASE = "gist_decode";
 
+  static constexpr const char* GIST_BINARIZE = "GistBinarize";
+  static constexpr const char* GIST_PACK16 = "GistPack16";
+  static constexpr const char* GIST_PACK8 = "GistPack8";
+
   GistEncodeDecode() noexcept : RewriteRule("GistEncodeDecode") {}
 
+  GistEncodeDecode(const std::string& pack_type, const std::unordered_set<std::string>& pack_op_types)
+      : RewriteRule("GistEncodeDecode"), pack_type_(pack_type), pack_op_types_(pack_op_types) {}
+
   std::vector<std::string> TargetOpTypes() const noexcept override {
-    return {"Relu"};
+    std::vector<std::string> op_types{"Relu"};
+    if (!pack_type_.empty()) {
+      for (const auto& op_type : pack_op_types_) {
+        if (op_type != "Relu") op_types.push_back(op_type);
+      }
+    }
+    return op_types;
   }
 
  private:
+  struct GraphEdge {
+    NodeIndex src_node;
+    NodeIndex dst_node;
+    int src_arg_index;
+    int dst_arg_index;
+  };
+
   bool SatisfyCondition(const Graph& graph, const Node& node, const logging::Logger& logger) const override;
 
   Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect, const logging::Logger& logger) const override;
-  bool AddEncodeDecode(Graph& graph, Node& curr_node, std::string compression_type) const;
+  bool AddEncodeDecode(Graph& graph, Node& curr_node, const std::string& compression_type,
+                       const std::vector<GraphEdge>& decoded_edges) const;
+
+  // The compression of the activations other than the Relu masks. Empty to only binarize them.
+  std::string pack_type_;
+  std::unordered_set<std::string> pack_op_types_;
 };
 
-}
\ No newline at end of file
+}  // namespace onnxruntime
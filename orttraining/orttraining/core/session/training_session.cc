@@ -18,6 +18,7 @@
 #include "orttraining/core/graph/mixed_precision_transformer.h"
 #include "orttraining/core/graph/tensorboard_transformer.h"
 #include "orttraining/core/graph/pipeline_transformer.h"
+#include "orttraining/core/graph/recompute_transformer.h"
 #include "orttraining/core/graph/gradient_builder_base.h"
 
 //Gist Encoding
@@ -89,6 +90,8 @@ Status SetupOptimizerParams(
   opt_graph_config.gradient_accumulation_steps = config.gradient_accumulation_steps;
   opt_graph_config.allreduce_in_fp16 = optimizer_config.do_all_reduce_in_fp16;
   opt_graph_config.use_nccl = optimizer_config.use_nccl;
+  opt_graph_config.allreduce_bucket_size_bytes = optimizer_config.allreduce_bucket_size_bytes;
+  opt_graph_config.use_quantized_allreduce = optimizer_config.use_quantized_allreduce;
   opt_graph_config.adasum_reduction_type = optimizer_config.adasum_reduction_type;
   opt_graph_config.enable_grad_norm_clip = optimizer_config.enable_grad_norm_clip;
 #if USE_HOROVOD
@@ -236,6 +239,21 @@ Status TrainingSession::ConfigureForTraining(
   ORT_RETURN_IF_ERROR(BuildGradientGraph(
       weight_names_to_train, loss_name, config.gradient_graph_config, config.set_gradients_as_graph_outputs));
 
+  // drop selected activations and recompute them in the backward pass
+  if (config.recompute_config.has_value()) {
+    const auto& recompute_config = config.recompute_config.value();
+    TrainingConfigurationResult::RecomputeConfigurationResult recompute_result{};
+    ORT_RETURN_IF_ERROR(TransformGraphForRecompute(
+        model_->MainGraph(), recompute_config.op_types, recompute_config.activation_names, recompute_result.report));
+
+    const auto& report = recompute_result.report;
+    LOGS(*session_logger_, INFO) << "Recomputing " << report.recomputed_activations.size()
+                                 << " activations in the backward pass, saving " << report.bytes_saved
+                                 << " bytes for " << report.extra_flops
+                                 << " extra FLOPs per unit of the symbolic dimensions.";
+    config_result.recompute_config_result = recompute_result;
+  }
+
   // transform for mixed precision
   std::unordered_map<std::string, NodeArg*> fp32_weight_name_to_fp16_node_arg{};
   if (is_mixed_precision_enabled_) {
@@ -347,7 +365,7 @@ Status TrainingSession::ConfigureForTraining(
 
   // add GIST encoding
   if (config.gist_config.has_value()) {
-    ORT_RETURN_IF_ERROR(AddGistEncoding());
+    ORT_RETURN_IF_ERROR(AddGistEncoding(config.gist_config.value()));
   }
 
   // If the current node is in rank0 or if the current session is running pipeline (in which case different rank would
@@ -546,12 +564,12 @@ void TrainingSession::AddPredefinedTransformers(GraphTransformerManager& transfo
   }
 }
 
-Status TrainingSession::AddGistEncoding() {
+Status TrainingSession::AddGistEncoding(const TrainingConfiguration::GistConfiguration& config) {
   try {
     Graph& graph = model_->MainGraph();
 
     auto rule_transformer_L1 = onnxruntime::make_unique<RuleBasedGraphTransformer>("RuleGistTransformer1");
-    rule_transformer_L1->Register(onnxruntime::make_unique<GistEncodeDecode>());
+    rule_transformer_L1->Register(onnxruntime::make_unique<GistEncodeDecode>(config.pack_type, config.op_types));
     onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
     graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1);
 
@@ -11,6 +11,7 @@
 #include "orttraining/core/graph/optimizer_graph_output_key.h"
 #include "orttraining/core/graph/optimizer_config.h"
 #include "orttraining/core/graph/gradient_config.h"
+#include "orttraining/core/graph/recompute_transformer.h"
 
 namespace onnxruntime {
 namespace training {
@@ -91,11 +92,26 @@ class TrainingSession : public InferenceSession {
     // Exactly one of loss_function_config or loss_name should be given.
     optional<std::string> loss_name{};
 
-    struct GistConfiguration {};
+    struct GistConfiguration {
+      // The compression of the outputs of op_types stashed for the backward pass: "GistPack16" (float16) or
+      // "GistPack8" (8-bit float). If empty, only the Relu outputs consumed by ReluGrad are stored, as binary masks.
+      std::string pack_type{};
+      std::unordered_set<std::string> op_types{"Relu", "MaxPool", "AveragePool", "Conv", "BatchNormalization"};
+    };
     // The GIST configuration.
     // If not provided, GIST is disabled.
     optional<GistConfiguration> gist_config{};
 
+    struct RecomputeConfiguration {
+      // The op types whose outputs are recomputed in the backward pass instead of being kept alive.
+      std::unordered_set<std::string> op_types{"Gelu", "FastGelu", "BiasGelu"};
+      // The names of additional activations to recompute, e.g. user-marked checkpoints.
+      std::unordered_set<std::string> activation_names{};
+    };
+    // The activation recomputation configuration.
+    // If not provided, all activations needed by the backward pass are kept alive.
+    optional<RecomputeConfiguration> recompute_config{};
+
     struct TensorboardConfiguration {
       // The summary name.
       std::string summary_name{};
@@ -128,6 +144,11 @@ class TrainingSession : public InferenceSession {
       bool do_all_reduce_in_fp16{};
       // Whether to use NCCL.
       bool use_nccl{};
+      // The size in bytes of the buckets of gradients all-reduced with NCCL during the backward pass.
+      // 0 all-reduces the gradients at once after the backward pass.
+      int64_t allreduce_bucket_size_bytes{};
+      // Whether to all-reduce the gradients quantized to 8 bits with NCCL.
+      bool use_quantized_allreduce{};
       // Whether to partition the optimizer state.
       ZeROConfig deepspeed_zero{};
       // Selects the reduction algorithm for Adasum.
@@ -201,6 +222,14 @@ class TrainingSession : public InferenceSession {
     // This is only set if an optimizer is added.
     optional<OptimizerConfigurationResult> opt_config_result;
 
+    struct RecomputeConfigurationResult {
+      // The summary of the recomputed activations.
+      RecomputeReport report;
+    };
+    // The activation recomputation configuration output.
+    // This is only set if activation recomputation is enabled.
+    optional<RecomputeConfigurationResult> recompute_config_result;
+
     // The names of pipeline events in model's input list.
     // If an event is not used, its name should be empty.
     struct PipelineConfigurationResult {
@@ -342,7 +371,7 @@ class TrainingSession : public InferenceSession {
       std::string* loss_scale_input_name,
       std::string& actual_loss_name);
 
-  common::Status AddGistEncoding();
+  common::Status AddGistEncoding(const TrainingConfiguration::GistConfiguration& config);
 
   /** Add tensorboard summary nodes to the graph.
   @param summary_name name for the merged summary node.
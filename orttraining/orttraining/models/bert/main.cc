@@ -21,7 +21,13 @@
 namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(OrtDevice::DeviceId device_id,
                                                                                size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
-                                                                               onnxruntime::ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo);
+                                                                               onnxruntime::ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+                                                                               bool enable_cuda_graph = false,
+                                                                               bool use_stream_ordered_arena = false,
+                                                                               OrtCudnnConvAlgoSearch cudnn_conv_algo_search = EXHAUSTIVE,
+                                                                               const std::string& cudnn_conv_algo_cache_path = "",
+                                                                               bool initializers_in_host_memory = false,
+                                                                               size_t workspace_max_bytes = 0);
 }
 
 using namespace onnxruntime;
@@ -61,6 +67,10 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
         cxxopts::value<std::string>()->default_value("bert_data/128/books_wiki_en_corpus/train"))
       ("test_data_dir", "Input ONNX example files (can be a glob or comma separated).",
         cxxopts::value<std::string>()->default_value("bert_data/128/books_wiki_en_corpus/test"))
+      ("max_num_files_preload", "Number of data files prefetched by the data loaders.",
+        cxxopts::value<size_t>()->default_value("2"))
+      ("num_data_loader_threads", "Number of data files loaded concurrently by the data loaders.",
+        cxxopts::value<size_t>()->default_value("1"))
       ("train_data_dir_phase2", "Input ONNX example files (can be a glob or comma separated).",
         cxxopts::value<std::string>()->default_value(""))
       ("test_data_dir_phase2", "Input ONNX example files (can be a glob or comma separated).",
@@ -100,6 +110,8 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("checkpoint_period", "How many weight-update steps to run before saving a model checkpoint.", cxxopts::value<size_t>()->default_value("1000"))
       ("max_num_checkpoints", "Maximum number of checkpoint files to maintain.",
         cxxopts::value<size_t>()->default_value("10"))
+      ("use_sharded_async_checkpoints", "Whether each rank saves its own checkpoint under checkpoints_dir/rank_<rank> "
+       "from a host copy of its state in a background thread.", cxxopts::value<bool>()->default_value("false"))
       ("gradient_accumulation_steps_phase2", "The number of gradient accumulation steps before performing a backward/update pass in phase 2.",
         cxxopts::value<int>()->default_value("1"))
       ("iterations_per_loop", "How many steps to make in each estimator call.", cxxopts::value<int>()->default_value("1000"))
@@ -115,6 +127,12 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("use_fp16_initializer", "FP16 weights will be created. Otherwise, cast nodes will be inserted for converting weights from FP32 to FP16",
         cxxopts::value<bool>()->default_value("true"))
       ("use_nccl", "Whether to use NCCL for distributed training.", cxxopts::value<bool>()->default_value("false"))
+      ("allreduce_bucket_size_mb", "With NCCL, all-reduce the gradients in buckets of this size in MB during the backward pass. "
+        "0 all-reduces the gradients after the backward pass.", cxxopts::value<int>()->default_value("0"))
+      ("use_quantized_allreduce", "With NCCL, all-reduce the gradients quantized to 8 bits, "
+        "adding the quantization error to the next step's gradients.", cxxopts::value<bool>()->default_value("false"))
+      ("use_memory_aware_execution_order", "Whether to run the nodes in an order that frees large buffers early, "
+        "to lower the peak memory.", cxxopts::value<bool>()->default_value("false"))
       ("use_profiler", "Collect runtime profile data during this training run.", cxxopts::value<bool>()->default_value("false"))
       ("max_profile_records", "Maximum number of runtime profile data records to collect. 0 means use the default value.",
         cxxopts::value<size_t>()->default_value("0"))
@@ -132,9 +150,9 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("max_predictions_per_seq",
         "Maximum number of masked LM predictions per sequence. "
         "Must match data generation.", cxxopts::value<int>()->default_value("80"))
-      ("optimizer", "Adam or Lamb", cxxopts::value<std::string>()->default_value("Adam"))
+      ("optimizer", "Adam, MultiTensorAdam or Lamb", cxxopts::value<std::string>()->default_value("Adam"))
       ("deepspeed_zero_stage", "Controls whether to partition state using the DeepSpeed ZeRO technique. "
-       "Stages 0 (disabled) and 1 (optimizer state partitioning) are supported.",
+       "Stages 0 (disabled), 1 (optimizer state partitioning) and 2 (gradient partitioning) are supported.",
        cxxopts::value<int>()->default_value("0"))
       ("alpha", "Adam/Lamb alpha parameter", cxxopts::value<float>()->default_value("0.9"))
       ("beta", "Adam/Lamb beta parameter", cxxopts::value<float>()->default_value("0.999"))
@@ -157,6 +175,8 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("horizontal_parallel_size", "Horizontal model parallel group size.", cxxopts::value<int>()->default_value("1"))
       ("pipeline_parallel_size", "Number of pipeline stages.", cxxopts::value<int>()->default_value("1"))
       ("pipeline_stage_paths", "Specify the forward ONNX files for pipeline evaluation.", cxxopts::value<std::vector<std::string>>()->default_value(""))
+      ("use_1f1b_pipeline_schedule", "Whether to schedule pipeline batches one-forward-one-backward to bound activation memory.",
+        cxxopts::value<bool>()->default_value("false"))
       ("cut_group_info", "Specify the cutting info for graph partition (pipeline only). An example of a cut_group_info of "
       "size two is: 1393:407-1463/1585/1707,2369:407-2439/2561/2683. Here, the cut info is split by ',', with the first "
       "cut_info equal to 1393:407-1463/1585/1707, and second cut_info equal to 2369:407-2439/2561/2683. Each CutEdge is "
@@ -167,7 +187,13 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("enable_gelu_approximation", "Specify whether to enable GELU approximation.",
         cxxopts::value<bool>()->default_value("true"))
       ("use_invertible_layernorm_grad", "Specify whether to use invertible laynorm(dropping the input activation)",
-        cxxopts::value<bool>()->default_value("false"));
+        cxxopts::value<bool>()->default_value("false"))
+      ("use_recompute", "Specify whether to recompute activations in the backward pass instead of keeping them alive.",
+        cxxopts::value<bool>()->default_value("false"))
+      ("recompute_op_types", "Op types whose outputs are recomputed (e.g. 'Gelu,FastGelu,BiasGelu', the default).",
+        cxxopts::value<std::vector<std::string>>()->default_value({}))
+      ("recompute_activations", "Names of additional activations to recompute.",
+        cxxopts::value<std::vector<std::string>>()->default_value({}));
   options
     .add_options("ORT configuration")
       ("ort_log_severity", "ORT minimum logging severity (see onnxruntime::logging::Severity values)",
@@ -238,12 +264,21 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
     params.max_num_checkpoints = flags["max_num_checkpoints"].as<size_t>();
 
     params.use_nccl = flags["use_nccl"].as<bool>();
+    params.allreduce_bucket_size_bytes = static_cast<int64_t>(flags["allreduce_bucket_size_mb"].as<int>()) * 1024 * 1024;
+    params.use_quantized_allreduce = flags["use_quantized_allreduce"].as<bool>();
+    params.use_memory_aware_execution_order = flags["use_memory_aware_execution_order"].as<bool>();
     params.use_adasum = flags["use_adasum"].as<bool>();
     params.use_profiler = flags.count("use_profiler") > 0;
     ort_params.max_num_profiling_events = flags["max_profile_records"].as<size_t>();
 
     params.train_data_dir = ToPathString(flags["train_data_dir"].as<std::string>());
     params.test_data_dir = ToPathString(flags["test_data_dir"].as<std::string>());
+    params.max_num_files_preload = flags["max_num_files_preload"].as<size_t>();
+    params.num_data_loader_threads = flags["num_data_loader_threads"].as<size_t>();
+    if (params.max_num_files_preload == 0 || params.num_data_loader_threads == 0) {
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT,
+                    "max_num_files_preload and num_data_loader_threads must be positive.");
+    }
     params.log_dir = ToPathString(flags["log_dir"].as<std::string>());
     params.train_data_dir_phase2 = ToPathString(flags["train_data_dir_phase2"].as<std::string>());
     params.test_data_dir_phase2 = ToPathString(flags["test_data_dir_phase2"].as<std::string>());
@@ -261,6 +296,7 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       printf("No checkpoints directory specified. Checkpoint files will not be saved.\n");
     }
     params.checkpoint_to_load_path = ToPathString(flags["checkpoint_to_load_path"].as<std::string>());
+    params.use_sharded_async_checkpoints = flags["use_sharded_async_checkpoints"].as<bool>();
 
     params.histogram_names = flags["histogram"].as<std::vector<std::string>>();
     params.norm_names = flags["norm"].as<std::vector<std::string>>();
@@ -323,10 +359,12 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
     std::string optimizer_name = flags["optimizer"].as<std::string>();
     if (optimizer_name == "adam" || optimizer_name == "Adam") {
       params.training_optimizer_name = "AdamOptimizer";
+    } else if (optimizer_name == "multitensoradam" || optimizer_name == "MultiTensorAdam") {
+      params.training_optimizer_name = "MultiTensorAdamOptimizer";
     } else if (optimizer_name == "lamb" || optimizer_name == "Lamb") {
       params.training_optimizer_name = "LambOptimizer";
     } else {
-      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Incorrect optimizer type: it must be one of [Adam|Lamb]");
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Incorrect optimizer type: it must be one of [Adam|MultiTensorAdam|Lamb]");
     }
 
     params.deepspeed_zero = ZeROConfig(flags["deepspeed_zero_stage"].as<int>());
@@ -390,6 +428,7 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
     // All files only store forward pass with a Recv and a Send.
     // Backward pass and optimizer nodes are implicitly generated by ORT.
     params.pipeline_stage_paths = flags["pipeline_stage_paths"].as<std::vector<std::string>>();
+    params.use_1f1b_pipeline_schedule = flags["use_1f1b_pipeline_schedule"].as<bool>();
 
     // If user doesn't provide partitioned model files, a cut list should be provided for ORT to do partition
     // online. If the pipeline contains n stages, the cut list should be of length (n-1), in order to cut the
@@ -454,6 +493,10 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
 
     params.enable_gelu_approximation = flags["enable_gelu_approximation"].as<bool>();
 
+    params.use_recompute = flags["use_recompute"].as<bool>();
+    params.recompute_op_types = flags["recompute_op_types"].as<std::vector<std::string>>();
+    params.recompute_activation_names = flags["recompute_activations"].as<std::vector<std::string>>();
+
     ort_params.log_severity = static_cast<logging::Severity>(flags["ort_log_severity"].as<int>());
     ORT_RETURN_IF_NOT(
         logging::Severity::kVERBOSE <= ort_params.log_severity &&
@@ -724,8 +767,6 @@ static Status RunPerformanceTest(const BertParameters& params, const Environment
 }
 
 static Status RunTraining(const BertParameters& params, const Environment& env) {
-  const size_t max_num_files_preload = 2;
-
   auto runner = onnxruntime::make_unique<TrainingRunner>(params, env);
   ORT_RETURN_IF_ERROR(runner->Initialize());
 
@@ -735,16 +776,19 @@ static Status RunTraining(const BertParameters& params, const Environment& env)
     auto rank_in_data_parallel_group = params_for_phase.mpi_context.world_rank / params_for_phase.horizontal_parallel_size;
     auto training_data_loader = onnxruntime::make_unique<DataLoader>(params_for_phase.input_name_map,
                                                                      params_for_phase.train_data_dir,
-                                                                     max_num_files_preload,
+                                                                     params_for_phase.max_num_files_preload,
                                                                      rank_in_data_parallel_group,
-                                                                     params_for_phase.data_parallel_size);
+                                                                     params_for_phase.data_parallel_size,
+                                                                     params_for_phase.num_data_loader_threads);
 
     auto test_data_loader = std::unique_ptr<DataLoader>{};
     // Evaluation is only done in device #0
     if (params_for_phase.mpi_context.world_rank == 0) {
       test_data_loader = onnxruntime::make_unique<DataLoader>(params_for_phase.input_name_map,
                                                               params_for_phase.test_data_dir,
-                                                              max_num_files_preload);
+                                                              params_for_phase.max_num_files_preload,
+                                                              0 /* world_rank */, 1 /* world_size */,
+                                                              params_for_phase.num_data_loader_threads);
     }
 
     if (!params.perf_output_dir.empty()) {
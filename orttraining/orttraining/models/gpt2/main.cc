@@ -20,7 +20,13 @@
 namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(OrtDevice::DeviceId device_id,
                                                                                size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
-                                                                               onnxruntime::ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo);
+                                                                               onnxruntime::ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+                                                                               bool enable_cuda_graph = false,
+                                                                               bool use_stream_ordered_arena = false,
+                                                                               OrtCudnnConvAlgoSearch cudnn_conv_algo_search = EXHAUSTIVE,
+                                                                               const std::string& cudnn_conv_algo_cache_path = "",
+                                                                               bool initializers_in_host_memory = false,
+                                                                               size_t workspace_max_bytes = 0);
 }
 
 using namespace onnxruntime;
@@ -47,6 +53,10 @@ Status ParseArguments(int argc, char* argv[], GPT2Parameters& params, OrtParamet
         cxxopts::value<std::string>()->default_value("data/1024/books_wiki_en_corpus/train"))
       ("test_data_dir", "Input ONNX example files (can be a glob or comma separated).",
         cxxopts::value<std::string>()->default_value("data/1024/books_wiki_en_corpus/test"))
+      ("max_num_files_preload", "Number of data files prefetched by the data loaders.",
+        cxxopts::value<size_t>()->default_value("2"))
+      ("num_data_loader_threads", "Number of data files loaded concurrently by the data loaders.",
+        cxxopts::value<size_t>()->default_value("1"))
       ("output_dir", "The output directory where the trained model files will be written.",
         cxxopts::value<std::string>()->default_value(""))
       ("perf_output_dir", "The output directory where the trained perf metrics files will be written.",
@@ -77,9 +87,9 @@ Status ParseArguments(int argc, char* argv[], GPT2Parameters& params, OrtParamet
         "The maximum total input sequence length after WordPiece tokenization. "
         "Sequences longer than this will be truncated, and sequences shorter "
         "than this will be padded. Must match data generation.", cxxopts::value<int>()->default_value("1024"))
-      ("optimizer", "Adam or Lamb", cxxopts::value<std::string>()->default_value("Adam"))
+      ("optimizer", "Adam, MultiTensorAdam or Lamb", cxxopts::value<std::string>()->default_value("Adam"))
       ("deepspeed_zero_stage", "Controls whether to partition state using the DeepSpeed ZeRO technique. "
-       "Stages 0 (disabled) and 1 (optimizer state partitioning) are supported.",
+       "Stages 0 (disabled), 1 (optimizer state partitioning) and 2 (gradient partitioning) are supported.",
        cxxopts::value<int>()->default_value("0"))
       ("alpha", "Adam/Lamb alpha parameter", cxxopts::value<float>()->default_value("0.9"))
       ("beta", "Adam/Lamb beta parameter", cxxopts::value<float>()->default_value("0.999"))
@@ -140,6 +150,12 @@ Status ParseArguments(int argc, char* argv[], GPT2Parameters& params, OrtParamet
 
     params.train_data_dir = ToPathString(flags["train_data_dir"].as<std::string>());
     params.test_data_dir = ToPathString(flags["test_data_dir"].as<std::string>());
+    params.max_num_files_preload = flags["max_num_files_preload"].as<size_t>();
+    params.num_data_loader_threads = flags["num_data_loader_threads"].as<size_t>();
+    if (params.max_num_files_preload == 0 || params.num_data_loader_threads == 0) {
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT,
+                    "max_num_files_preload and num_data_loader_threads must be positive.");
+    }
     params.log_dir = ToPathString(flags["log_dir"].as<std::string>());
     params.output_dir = ToPathString(flags["output_dir"].as<std::string>());
     if (params.output_dir.empty()) {
@@ -199,10 +215,12 @@ Status ParseArguments(int argc, char* argv[], GPT2Parameters& params, OrtParamet
     std::string optimizer_name = flags["optimizer"].as<std::string>();
     if (optimizer_name == "adam" || optimizer_name == "Adam") {
       params.training_optimizer_name = "AdamOptimizer";
+    } else if (optimizer_name == "multitensoradam" || optimizer_name == "MultiTensorAdam") {
+      params.training_optimizer_name = "MultiTensorAdamOptimizer";
     } else if (optimizer_name == "lamb" || optimizer_name == "Lamb") {
       params.training_optimizer_name = "LambOptimizer";
     } else {
-      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Incorrect optimizer type: it must be one of [Adam|Lamb]");
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Incorrect optimizer type: it must be one of [Adam|MultiTensorAdam|Lamb]");
     }
 
     params.deepspeed_zero = ZeROConfig(flags["deepspeed_zero_stage"].as<int>());
@@ -412,24 +430,25 @@ static Status RunPerformanceTest(const GPT2Parameters& params, const Environment
 }
 
 static Status RunTraining(const GPT2Parameters& params, const Environment& env) {
-  const size_t max_num_files_preload = 2;
-
   auto runner = onnxruntime::make_unique<TrainingRunner>(params, env);
   ORT_RETURN_IF_ERROR(runner->Initialize());
 
   auto rank_in_data_parallel_group = params.mpi_context.world_rank / params.horizontal_parallel_size;
   auto training_data_loader = onnxruntime::make_unique<DataLoader>(params.input_name_map,
                                                                    params.train_data_dir,
-                                                                   max_num_files_preload,
+                                                                   params.max_num_files_preload,
                                                                    rank_in_data_parallel_group,
-                                                                   params.data_parallel_size);
+                                                                   params.data_parallel_size,
+                                                                   params.num_data_loader_threads);
 
   std::unique_ptr<DataLoader> test_data_loader;
   // Evaluation is only done in device #0
   if (params.mpi_context.world_rank == 0) {
     test_data_loader = onnxruntime::make_unique<DataLoader>(params.input_name_map,
                                                             params.test_data_dir,
-                                                            max_num_files_preload);
+                                                            params.max_num_files_preload,
+                                                            0 /* world_rank */, 1 /* world_size */,
+                                                            params.num_data_loader_threads);
   }
 
   if (!params.perf_output_dir.empty()) {
@@ -444,7 +463,9 @@ static Status RunTraining(const GPT2Parameters& params, const Environment& env)
   if (params.mpi_context.world_rank == 0) {
     test_data_loader = onnxruntime::make_unique<DataLoader>(params.input_name_map,
                                                             params.test_data_dir,
-                                                            max_num_files_preload);
+                                                            params.max_num_files_preload,
+                                                            0 /* world_rank */, 1 /* world_size */,
+                                                            params.num_data_loader_threads);
 
     ORT_RETURN_IF_ERROR(runner->EndTraining(test_data_loader.get()));
   }
@@ -20,7 +20,13 @@
 namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(OrtDevice::DeviceId device_id,
                                                                                size_t cuda_mem_limit = std::numeric_limits<size_t>::max(),
-                                                                               onnxruntime::ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo);
+                                                                               onnxruntime::ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+                                                                               bool enable_cuda_graph = false,
+                                                                               bool use_stream_ordered_arena = false,
+                                                                               OrtCudnnConvAlgoSearch cudnn_conv_algo_search = EXHAUSTIVE,
+                                                                               const std::string& cudnn_conv_algo_cache_path = "",
+                                                                               bool initializers_in_host_memory = false,
+                                                                               size_t workspace_max_bytes = 0);
 }
 
 using namespace onnxruntime;
@@ -44,6 +50,8 @@ Status ParseArguments(int argc, char* argv[], TrainingRunner::Parameters& params
         cxxopts::value<std::string>()->default_value(""))
       ("use_profiler", "Collect runtime profile data during this training run.", cxxopts::value<bool>()->default_value("false"))
       ("use_gist", "Use GIST encoding/decoding.")
+      ("gist_pack_type", "With use_gist, also store the other activations of the backward pass in reduced precision: "
+        "GistPack16 or GistPack8.", cxxopts::value<std::string>()->default_value(""))
       ("use_cuda", "Use CUDA execution provider for training.", cxxopts::value<bool>()->default_value("false"))
       ("num_train_steps", "Number of training steps.", cxxopts::value<int>()->default_value("2000"))
       ("train_batch_size", "Total batch size for training.", cxxopts::value<int>()->default_value("100"))
@@ -58,6 +66,7 @@ Status ParseArguments(int argc, char* argv[], TrainingRunner::Parameters& params
 
     params.model_name = flags["model_name"].as<std::string>();
     params.use_gist = flags.count("use_gist") > 0;
+    params.gist_pack_type = flags["gist_pack_type"].as<std::string>();
     params.lr_params.initial_lr = flags["learning_rate"].as<float>();
     params.num_train_steps = flags["num_train_steps"].as<int>();
     params.batch_size = flags["train_batch_size"].as<int>();
@@ -2,9 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/common/logging/logging.h"
+#include "core/framework/data_types.h"
 #include "core/platform/env.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "orttraining/models/runner/data_loader.h"
+#include <cstring>
 #include <fstream>
 
 namespace onnxruntime {
@@ -20,7 +22,8 @@ static std::vector<PathString> GetAllDataFiles(const PathString& dir_path) {
             PathString filename_str = filename;
             if (filename_str[0] == '.' ||
                 f_type != OrtFileType::TYPE_REG ||
-                !HasExtensionOf(filename_str, ORT_TSTR("pb"))) {
+                (!HasExtensionOf(filename_str, ORT_TSTR("pb")) &&
+                 !HasExtensionOf(filename_str, ORT_TSTR("ortdata")))) {
               return true;
             }
             data_files.push_back(ConcatPathComponent<PathChar>(dir_path, filename_str));
@@ -37,10 +40,13 @@ DataLoader::DataLoader(const MapStringToString& input_name_map,
                        const PathString& dir_path,
                        size_t max_num_files_preload,
                        size_t world_rank,
-                       size_t world_size)
+                       size_t world_size,
+                       size_t num_loader_threads)
     : input_name_map_(input_name_map),
-      max_num_files_preload_(max_num_files_preload) {
+      max_num_files_preload_(max_num_files_preload),
+      thread_pool_size_(static_cast<int32_t>(num_loader_threads)) {
   ORT_ENFORCE(max_num_files_preload > 0);
+  ORT_ENFORCE(num_loader_threads > 0);
 
   input_tensor_names_.reserve(input_name_map.size());
 
@@ -89,9 +95,11 @@ std::shared_ptr<DataSet> DataLoader::MoveToNextDataSet() {
   active_file_index_ = (active_file_index_ + 1) % NumShards();
 
   if (max_num_files_preload_ < NumShards()) {
-    const size_t index_to_remove = old_active_file_index;
+    // The old data set leaves the buffer before the load is scheduled, so that a load of the same index
+    // (when the loads wrap around) can never be removed by a concurrently running removal.
+    std::shared_ptr<DataSet> data_set_to_remove = buffer_.Take(old_active_file_index);
     const size_t index_to_load = (active_file_index_ + max_num_files_preload_ - 1) % NumShards();
-    LoadAndRemoveInternalAsync(index_to_load, true, index_to_remove);
+    LoadAndRemoveInternalAsync(index_to_load, std::move(data_set_to_remove));
   }
 
   return CurrentDataSet();
@@ -102,7 +110,7 @@ Status DataLoader::InitialPreLoadAsync() {
 
   for (size_t i = 0; i < std::min(max_num_files_preload_, NumShards()); ++i) {
     const auto data_set_index = (active_file_index_ + i) % NumShards();
-    LoadAndRemoveInternalAsync(data_set_index, false, 0);
+    LoadAndRemoveInternalAsync(data_set_index, nullptr);
   }
 
   is_preloaded_ = true;
@@ -116,8 +124,13 @@ void DataLoader::EnsurePreloadedOrThrow() {
   ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
 }
 
-void DataLoader::LoadAndRemoveInternalAsync(size_t index_to_load, bool need_remove, size_t index_to_remove) {
-  data_loader_thread_pool_->Schedule([this, index_to_load, need_remove, index_to_remove]() {
+void DataLoader::LoadAndRemoveInternalAsync(size_t index_to_load, std::shared_ptr<DataSet> data_set_to_remove) {
+  data_loader_thread_pool_->Schedule([this, index_to_load,
+                                      data_set_to_remove = std::move(data_set_to_remove)]() mutable {
+    // Release data in forked thread since it is observed releasing it in main thread will
+    // block the main thread execution (possibly because the removal triggering some heap re-org).
+    data_set_to_remove.reset();
+
     std::shared_ptr<DataSet> data_set = std::make_shared<DataSet>(input_tensor_names_);
     if (index_to_load >= NumShards()) {
       LOGS_DEFAULT(WARNING)
@@ -131,16 +144,14 @@ void DataLoader::LoadAndRemoveInternalAsync(size_t index_to_load, bool need_remo
     } else {
       buffer_.Set(index_to_load, data_set);
     }
-
-    // Put data removal in forked thread since it is observed calling Remove in main thread will
-    // block the main thread execution (possibly because the removal triggering some heap re-org).
-    if (need_remove) {
-      buffer_.Remove(index_to_remove);
-    }
   });
 }
 
 Status DataLoader::LoadFile(const PathString& file_path, std::shared_ptr<DataSet>& data_set) {
+  if (HasExtensionOf(file_path, ORT_TSTR("ortdata"))) {
+    return LoadMappedFile(file_path, data_set);
+  }
+
   int tensor_fd;
   ORT_RETURN_IF_ERROR(Env::Default().FileOpenRd(file_path, tensor_fd));
   FileInputStream f(tensor_fd);
@@ -190,5 +201,108 @@ Status DataLoader::LoadOneSample(CodedInputStream& coded_in,
   return Status::OK();
 }
 
+namespace {
+constexpr size_t kMappedAlignment = 8;
+
+size_t AlignMapped(size_t size) {
+  return (size + kMappedAlignment - 1) / kMappedAlignment * kMappedAlignment;
+}
+
+// Reads a T at offset and advances offset past it.
+template <typename T>
+Status ReadMapped(const char* data, size_t data_size, size_t& offset, T& value) {
+  ORT_RETURN_IF_NOT(offset + sizeof(T) <= data_size, "Unexpected end of data at offset ", offset);
+  memcpy(&value, data + offset, sizeof(T));
+  offset += sizeof(T);
+  return Status::OK();
+}
+}  // namespace
+
+Status DataLoader::LoadMappedFile(const PathString& file_path, std::shared_ptr<DataSet>& data_set) {
+  size_t file_length;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(file_path.c_str(), file_length));
+  if (file_length == 0) {
+    return Status::OK();
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(file_path.c_str(), 0, file_length, mapped_file));
+
+  size_t offset = 0;
+  while (offset < file_length) {
+    Status s = LoadOneMappedSample(mapped_file.get(), file_length, offset, data_set);
+    if (!s.IsOK()) {
+      return ORT_MAKE_STATUS(
+          ONNXRUNTIME, FAIL, "Failed to parse file '", ToMBString(file_path), "': ", s.ErrorMessage());
+    }
+  }
+
+  data_set->AddMappedBuffer(std::move(mapped_file));
+  return Status::OK();
+}
+
+Status DataLoader::LoadOneMappedSample(char* data, size_t data_size, size_t& offset,
+                                       std::shared_ptr<DataSet>& data_set) {
+  uint64_t num_features;
+  ORT_RETURN_IF_ERROR(ReadMapped(data, data_size, offset, num_features));
+
+  DataSet::SampleType sample = onnxruntime::make_unique<std::vector<OrtValue>>(NumInputs());
+  std::vector<bool> has_feature(NumInputs(), false);
+  for (uint64_t i = 0; i < num_features; ++i) {
+    uint32_t name_size, rank, reserved;
+    int32_t data_type;
+    ORT_RETURN_IF_ERROR(ReadMapped(data, data_size, offset, name_size));
+    ORT_RETURN_IF_ERROR(ReadMapped(data, data_size, offset, data_type));
+    ORT_RETURN_IF_ERROR(ReadMapped(data, data_size, offset, rank));
+    ORT_RETURN_IF_ERROR(ReadMapped(data, data_size, offset, reserved));
+
+    std::vector<int64_t> dims(rank);
+    for (auto& dim : dims) {
+      ORT_RETURN_IF_ERROR(ReadMapped(data, data_size, offset, dim));
+    }
+    uint64_t tensor_data_size;
+    ORT_RETURN_IF_ERROR(ReadMapped(data, data_size, offset, tensor_data_size));
+
+    ORT_RETURN_IF_NOT(offset + AlignMapped(name_size) + AlignMapped(tensor_data_size) <= data_size,
+                      "Unexpected end of data at offset ", offset);
+    const std::string name(data + offset, name_size);
+    offset += AlignMapped(name_size);
+    char* tensor_data = data + offset;
+    offset += AlignMapped(tensor_data_size);
+
+    auto it = input_to_feature_index_map_.find(name);
+    if (it == input_to_feature_index_map_.end()) {
+      continue;
+    }
+
+    // Only fixed-size element types can be used in place.
+    const TensorTypeBase* tensor_type = nullptr;
+    if (data_type != ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      try {
+        tensor_type = DataTypeImpl::TensorTypeFromONNXEnum(data_type);
+      } catch (const OnnxRuntimeException&) {
+      }
+    }
+    ORT_RETURN_IF_NOT(tensor_type != nullptr, "Unsupported data type ", data_type, " of feature ", name);
+    const TensorShape shape(dims);
+    const MLDataType element_type = tensor_type->GetElementType();
+    ORT_RETURN_IF_NOT(static_cast<uint64_t>(shape.Size()) * element_type->Size() == tensor_data_size,
+                      "Data size of feature ", name, " does not match its shape");
+
+    OrtMemoryInfo info("Cpu", OrtDeviceAllocator, OrtDevice{}, 0, OrtMemTypeDefault);
+    auto p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, tensor_data, info);
+    sample->at(it->second).Init(p_tensor.release(),
+                                DataTypeImpl::GetType<Tensor>(),
+                                DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    has_feature[it->second] = true;
+  }
+
+  for (const auto& pair : input_to_feature_index_map_) {
+    ORT_RETURN_IF_NOT(has_feature[pair.second], "Missing feature ", pair.first);
+  }
+
+  return data_set->AddData(std::move(sample));
+}
+
 }  // namespace training
 }  // namespace onnxruntime
@@ -42,15 +42,18 @@ class DataSetBuffer {
     cv_.notify_all();
   }
 
-  bool Remove(size_t index) {
+  // Takes the data set out of the buffer without releasing it, so that the
+  // (potentially slow) release can happen on another thread.
+  std::shared_ptr<DataSet> Take(size_t index) {
     std::lock_guard<std::mutex> lk(mutex_);
-    if (data_sets_.count(index) == 0) {
-      return false;
+    auto it = data_sets_.find(index);
+    if (it == data_sets_.end()) {
+      return nullptr;
     }
 
-    data_sets_[index].reset();
-    data_sets_.erase(index);
-    return true;
+    std::shared_ptr<DataSet> data_set = std::move(it->second);
+    data_sets_.erase(it);
+    return data_set;
   }
 
  private:
@@ -79,12 +82,29 @@ class IDataLoader {
 };
 
 /*
-Training file is organized in the following format:
+Training files with the .pb extension are organized in the following format:
 
   [Sample ByteSize] [Feature0 ByteSize] [Feature0 TensorProto] ... [FeatureN ByteSize] [FeatureN TensorProto]
   next sample ...
 
 All the bytesize fields are stored as 4 bytes uint32_t
+
+Training files with the .ortdata extension are memory-mapped and their tensors
+are used in place, without any parsing:
+
+  [Feature Count] [Feature0] ... [FeatureN]
+  next sample ...
+
+  Feature: [Name ByteSize] [Data Type] [Rank] [Reserved] [Dims] [Data ByteSize] [Name] [Data]
+
+Name ByteSize, Data Type (ONNX TensorProto data type), Rank and Reserved (0) are
+stored as 4 bytes, all other integer fields as 8 bytes. Name and Data are padded
+with zeros to a multiple of 8 bytes so every field stays aligned. All values are
+little-endian.
+
+Up to max_num_files_preload files are prefetched, num_loader_threads of them
+concurrently. Data sets are handed out in file order regardless of the order
+their loads complete in.
 */
 class DataLoader : public IDataLoader {
  public:
@@ -92,7 +112,8 @@ class DataLoader : public IDataLoader {
              const PathString& dir_path,
              size_t max_num_files_preload = 2,
              size_t world_rank = 0,
-             size_t world_size = 1);
+             size_t world_size = 1,
+             size_t num_loader_threads = 1);
 
   Status InitializeDataSetIndex(size_t initial_data_set_index) override;
 
@@ -124,7 +145,14 @@ class DataLoader : public IDataLoader {
                                uint32_t sample_size,
                                std::shared_ptr<DataSet>& data_set);
 
-  void LoadAndRemoveInternalAsync(size_t index_to_load, bool need_remove, size_t index_to_remove);
+  common::Status LoadMappedFile(const PathString& file_path, std::shared_ptr<DataSet>& data_set);
+
+  // Reads the sample starting at offset and advances offset past it.
+  common::Status LoadOneMappedSample(char* data, size_t data_size, size_t& offset,
+                                     std::shared_ptr<DataSet>& data_set);
+
+  // Loads a data set in the thread pool and releases the data set to remove (if any) there.
+  void LoadAndRemoveInternalAsync(size_t index_to_load, std::shared_ptr<DataSet> data_set_to_remove);
 
   // TensorName in File -> Input Name for Graph
   MapStringToString input_name_map_;
@@ -145,11 +173,8 @@ class DataLoader : public IDataLoader {
 
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> data_loader_thread_pool_;
 
-  // number of thread pool threads
-  // NOTE: Currently, thread pool requests should be serialized for correctness
-  //     (i.e., this should be 1). Otherwise, race conditions can occur - e.g.,
-  //     a data set gets removed and then waited for indefinitely.
-  const int32_t thread_pool_size_ = 1;
+  // number of thread pool threads, i.e. the number of files loaded concurrently
+  const int32_t thread_pool_size_;
 
   // indicates whether initial preloading has occurred
   bool is_preloaded_ = false;
@@ -3,6 +3,7 @@
 
 #include "orttraining/models/runner/pipeline.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <cstdint>
@@ -11,6 +12,7 @@
 #include <thread>
 
 #include "gsl/gsl"
+#include "core/common/common.h"
 #include "core/framework/ml_value.h"
 #include "orttraining/training_ops/cpu/controlflow/event_pool.h"
 
@@ -201,6 +203,107 @@ void PipelineSchedule::Add(int batch_id_begin, int batch_id_end) {
   }
 }
 
+void PipelineSchedule::AddOneForwardOneBackward(int batch_id_begin, int batch_id_end) {
+  ORT_ENFORCE(num_batches_ == 0, "1F1B batches must be added to an empty schedule.");
+  num_batches_ = batch_id_end - batch_id_begin;
+
+  // Order of computations at each stage.
+  std::vector<std::vector<Slot>> stage_slots(num_stages_);
+  for (int s = 0; s < num_stages_; ++s) {
+    const int num_warmup_batches = std::min(num_stages_ - s - 1, num_batches_);
+    int next_forward = 0;
+    int next_backward = 0;
+    auto add_slot = [&](Slot::Type type, int& next_batch) {
+      Slot slot;
+      slot.type = type;
+      slot.batch_id = batch_id_begin + next_batch++;
+      stage_slots[s].push_back(slot);
+    };
+
+    for (int i = 0; i < num_warmup_batches; ++i) {
+      add_slot(Slot::Type::Forward, next_forward);
+    }
+    while (next_forward < num_batches_) {
+      add_slot(Slot::Type::Forward, next_forward);
+      add_slot(Slot::Type::Backward, next_backward);
+    }
+    while (next_backward < num_batches_) {
+      add_slot(Slot::Type::Backward, next_backward);
+    }
+  }
+
+  // Place each computation in the first time slot after the previous computation of its stage
+  // and after the computation it depends on, i.e. the forward of the previous stage or the
+  // backward of the next stage (the forward of the same batch at the last stage).
+  std::vector<std::vector<int>> forward_time(num_stages_, std::vector<int>(num_batches_, -1));
+  std::vector<std::vector<int>> backward_time(num_stages_, std::vector<int>(num_batches_, -1));
+  std::vector<size_t> next_slot(num_stages_, 0);
+  int num_remaining_slots = 2 * num_stages_ * num_batches_;
+  for (int t = 0; num_remaining_slots > 0; ++t) {
+    ORT_ENFORCE(t < 2 * (num_stages_ + num_batches_) * num_stages_, "1F1B schedule does not make progress.");
+    table_.push_back(std::vector<Slot>(num_stages_));
+    batch_count_.push_back(0);
+
+    for (int s = 0; s < num_stages_; ++s) {
+      if (next_slot[s] == stage_slots[s].size()) {
+        continue;
+      }
+
+      const Slot& slot = stage_slots[s][next_slot[s]];
+      const int b = slot.batch_id - batch_id_begin;
+      if (slot.IsForward() && s > 0) {
+        const int dependency_time = forward_time[s - 1][b];
+        if (dependency_time < 0 || dependency_time >= t) {
+          continue;
+        }
+      } else if (slot.IsBackward()) {
+        const int dependency_time = s < num_stages_ - 1 ? backward_time[s + 1][b] : forward_time[s][b];
+        if (dependency_time < 0 || dependency_time >= t) {
+          continue;
+        }
+      }
+
+      table_[t][s] = slot;
+      (slot.IsForward() ? forward_time : backward_time)[s][b] = t;
+      ++next_slot[s];
+      --num_remaining_slots;
+    }
+  }
+
+  // Each computation waits for the events recorded by the previous computation of its stage.
+  // Event -1 is never waited.
+  std::vector<int> num_stage_slots(num_stages_, 0);
+  for (auto& slots : table_) {
+    for (int s = 0; s < num_stages_; ++s) {
+      if (slots[s].IsEmpty()) {
+        continue;
+      }
+      const int k = num_stage_slots[s]++;
+      slots[s].waited_events = k > 0 ? std::vector<int>{2 * k - 2, 2 * k - 1} : std::vector<int>{-1, -1};
+      slots[s].recorded_events = std::vector<int>{2 * k, 2 * k + 1};
+    }
+  }
+
+  for (int b = 0; b < num_batches_; ++b) {
+    for (int t = forward_time[0][b]; t <= backward_time[0][b]; ++t) {
+      ++batch_count_[t];
+    }
+  }
+}
+
+int PipelineSchedule::GetMaxInFlightBatches(int stage_id) const {
+  int num_in_flight_batches = 0;
+  int max_in_flight_batches = 0;
+  for (const auto& slots : table_) {
+    if (slots[stage_id].IsForward()) {
+      max_in_flight_batches = std::max(max_in_flight_batches, ++num_in_flight_batches);
+    } else if (slots[stage_id].IsBackward()) {
+      --num_in_flight_batches;
+    }
+  }
+  return max_in_flight_batches;
+}
+
 int PipelineSchedule::GetForwardWaitedEventId(int stage_id, int batch_id) const {
   std::vector<int> events = {-1, -1};
   for (size_t t = 0; t < table_.size(); ++t) {
@@ -61,6 +61,13 @@ class PipelineSchedule {
   PipelineSchedule(int num_stages);
   void Add(int batch_id);
   void Add(int batch_id_begin, int batch_id_end);
+  // Schedule batches [batch_id_begin, batch_id_end) with one-forward-one-backward (1F1B).
+  // After a warm-up of (num_stages - stage_id - 1) forwards, each stage alternates between
+  // forward and backward, so at most (num_stages - stage_id) batches hold activations at
+  // a stage regardless of the number of batches. The schedule must be empty.
+  void AddOneForwardOneBackward(int batch_id_begin, int batch_id_end);
+  // Largest number of batches whose forward is done and backward is not at a stage.
+  int GetMaxInFlightBatches(int stage_id) const;
   int GetForwardWaitedEventId(int stage_id, int batch_id) const;
   int GetForwardWaitedEventIdAfterRecv(int stage_id, int batch_id) const;
   int GetForwardRecordedEventIdBeforeSend(int stage_id, int batch_id) const;
@@ -47,6 +47,14 @@ static SessionOptions SESSION_OPTION = {
     true                               //thread_pool_allow_spinning
 };
 
+static SessionOptions WithExecutionOrder(SessionOptions session_options,
+                                         const TrainingRunner::Parameters& params) {
+  if (params.use_memory_aware_execution_order) {
+    session_options.execution_order = ExecutionOrder::MemoryAware;
+  }
+  return session_options;
+}
+
 TrainingRunner::TrainingRunner(Parameters params, const Environment& env)
     : TrainingRunner(params, env, SESSION_OPTION) {
 }
@@ -57,8 +65,8 @@ TrainingRunner::TrainingRunner(Parameters params, const Environment& env, Sessio
       weight_update_step_count_(0),
       training_data_set_index_(0),
       params_(params),
-      session_options_(session_options),
-      session_(session_options, env),
+      session_options_(WithExecutionOrder(session_options, params)),
+      session_(session_options_, env),
       input_allocator_(params.input_allocator ? params.input_allocator : TrainingUtil::GetCpuAllocator()),
       pipeline_schedule_(params_.pipeline_parallel_size),
       pipeline_worker_pool_(params_.pipeline_parallel_size) {
@@ -73,6 +81,12 @@ TrainingRunner::TrainingRunner(Parameters params, const Environment& env, Sessio
               "Number of training steps must be a multiple of number of gradient accumulation step.");
 }
 
+TrainingRunner::~TrainingRunner() {
+  const auto status = WaitForCheckpointWriter();
+  LOGS_DEFAULT_IF(!status.IsOK(), WARNING)
+      << "Failed to save checkpoint. Error: " << status.ErrorMessage();
+}
+
 Status TrainingRunner::Initialize() {
   if (params_.pipeline_parallel_size > 1 && !params_.pipeline_stage_paths.empty()) {
     // Pipeline partition happens outside ORT. We just load the result of partitioning forward graph.
@@ -129,6 +143,8 @@ Status TrainingRunner::Initialize() {
     opt.use_fp16_moments = params_.use_fp16_moments;
     opt.do_all_reduce_in_fp16 = params_.allreduce_in_fp16;
     opt.use_nccl = params_.use_nccl;
+    opt.allreduce_bucket_size_bytes = params_.allreduce_bucket_size_bytes;
+    opt.use_quantized_allreduce = params_.use_quantized_allreduce;
     opt.deepspeed_zero = params_.deepspeed_zero;
     opt.adasum_reduction_type = params_.GetAdasumReductionType();
     opt.enable_grad_norm_clip = params_.enable_grad_norm_clip;
@@ -148,10 +164,22 @@ Status TrainingRunner::Initialize() {
 
   if (params_.use_gist) {
     TrainingSession::TrainingConfiguration::GistConfiguration gist{};
+    gist.pack_type = params_.gist_pack_type;
 
     config.gist_config = gist;
   }
 
+  if (params_.use_recompute) {
+    TrainingSession::TrainingConfiguration::RecomputeConfiguration recompute{};
+    if (!params_.recompute_op_types.empty()) {
+      recompute.op_types = {params_.recompute_op_types.begin(), params_.recompute_op_types.end()};
+    }
+    recompute.activation_names = {params_.recompute_activation_names.begin(),
+                                  params_.recompute_activation_names.end()};
+
+    config.recompute_config = recompute;
+  }
+
   // Prepare pipeline information to do configuration.
   if (params_.pipeline_parallel_size > 1) {
     TrainingSession::TrainingConfiguration::PipelineConfiguration pipe{};
@@ -281,7 +309,11 @@ Status TrainingRunner::Initialize() {
     // Configure dimension of this pipeline.
     pipeline_context_.pipeline_stage_id = config_result.pipeline_config_result.value().pipeline_stage_id;
     pipeline_context_.num_pipeline_batches = params_.gradient_accumulation_steps;
-    pipeline_schedule_.Add(0, pipeline_context_.num_pipeline_batches);
+    if (params_.use_1f1b_pipeline_schedule) {
+      pipeline_schedule_.AddOneForwardOneBackward(0, pipeline_context_.num_pipeline_batches);
+    } else {
+      pipeline_schedule_.Add(0, pipeline_context_.num_pipeline_batches);
+    }
   } else {
     fetch_names = params_.fetch_names;
     pipeline_context_.pipeline_stage_id = 0;
@@ -312,7 +344,7 @@ Status TrainingRunner::Initialize() {
   // session_.Initialize() must be called prior to LoadCheckpoint()
   if (!params_.checkpoints_dir.empty()) {
     checkpoint_registry_ = onnxruntime::make_unique<CheckpointRegistry>(
-        params_.checkpoints_dir, params_.max_num_checkpoints);
+        GetCheckpointsDir(), params_.max_num_checkpoints);
 
     // Load checkpoint, if any
     PathString checkpoint_to_load_path = params_.checkpoint_to_load_path;
@@ -770,7 +802,7 @@ void TrainingRunner::RunWithoutUpdate(VectorString& feed_names,
 Status TrainingRunner::TrainingLoop(IDataLoader& training_data_loader, IDataLoader* test_data_loader,
                                     const MapStringToString& mapped_dimensions) {
   const bool enable_checkpoint_saving =
-      params_.mpi_context.world_rank == 0 &&
+      (params_.mpi_context.world_rank == 0 || params_.use_sharded_async_checkpoints) &&
       checkpoint_registry_ && params_.checkpoint_period > 0;
 
   std::unique_ptr<perftest::utils::ICPUUsage> cpu_usage_calculator;
@@ -903,10 +935,13 @@ Status TrainingRunner::TrainingLoop(IDataLoader& training_data_loader, IDataLoad
               should_remove_old_checkpoint, old_checkpoint_path));
 
           // ensure checkpoint directory exists
-          if (!Env::Default().FolderExists(params_.checkpoints_dir)) {
-            ORT_RETURN_IF_ERROR(Env::Default().CreateFolder(params_.checkpoints_dir));
+          if (!Env::Default().FolderExists(GetCheckpointsDir())) {
+            ORT_RETURN_IF_ERROR(Env::Default().CreateFolder(GetCheckpointsDir()));
           }
 
+          // the old checkpoint may still be being written
+          ORT_RETURN_IF_ERROR(WaitForCheckpointWriter());
+
           if (should_remove_old_checkpoint) {
             const auto status = Env::Default().DeleteFolder(old_checkpoint_path);
             LOGS_DEFAULT_IF(!status.IsOK(), WARNING)
@@ -915,7 +950,11 @@ Status TrainingRunner::TrainingLoop(IDataLoader& training_data_loader, IDataLoad
                 << ", error: " << status.ErrorMessage();
           }
 
-          ORT_RETURN_IF_ERROR(SaveCheckpoint(new_checkpoint_path));
+          if (params_.use_sharded_async_checkpoints) {
+            ORT_RETURN_IF_ERROR(SaveCheckpointAsync(new_checkpoint_path));
+          } else {
+            ORT_RETURN_IF_ERROR(SaveCheckpoint(new_checkpoint_path));
+          }
         }
       }  // end of one file/shard
 
@@ -927,6 +966,7 @@ Status TrainingRunner::TrainingLoop(IDataLoader& training_data_loader, IDataLoad
 
     ++epoch;
   }
+  ORT_RETURN_IF_ERROR(WaitForCheckpointWriter());
   auto all_steps_time_end = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double> all_steps_duration_seconds = all_steps_time_end - all_steps_time_start;
 
@@ -1221,6 +1261,48 @@ Status TrainingRunner::SaveCheckpoint(const PathString& checkpoint_path) {
   return Status::OK();
 }
 
+Status TrainingRunner::SaveCheckpointAsync(const PathString& checkpoint_path) {
+  ORT_RETURN_IF_ERROR(WaitForCheckpointWriter());
+
+  NameMLValMap checkpointed_tensors{};
+  ORT_RETURN_IF_ERROR(session_.GetStateTensors(checkpointed_tensors));
+
+  std::unordered_map<std::string, std::string> checkpointed_properties{};
+  ORT_RETURN_IF_ERROR(SaveCheckpointProperties(checkpointed_properties));
+
+  // input_allocator_ allocates pinned memory when training on GPU
+  ORT_RETURN_IF_ERROR(CreateCheckpointSnapshot(
+      session_.GetDataTransferManager(), checkpointed_tensors, checkpointed_properties,
+      input_allocator_, checkpoint_snapshot_));
+
+  checkpoint_writer_ = std::thread([this, checkpoint_path]() {
+    checkpoint_writer_status_ = SaveModelCheckpoint(checkpoint_path, checkpoint_snapshot_);
+  });
+
+  return Status::OK();
+}
+
+Status TrainingRunner::WaitForCheckpointWriter() {
+  if (!checkpoint_writer_.joinable()) {
+    return Status::OK();
+  }
+
+  checkpoint_writer_.join();
+  const Status status = checkpoint_writer_status_;
+  checkpoint_writer_status_ = Status::OK();
+  return status;
+}
+
+PathString TrainingRunner::GetCheckpointsDir() const {
+  if (!params_.use_sharded_async_checkpoints) {
+    return params_.checkpoints_dir;
+  }
+
+  return ConcatPathComponent<PathChar>(
+      params_.checkpoints_dir,
+      ToPathString("rank_" + std::to_string(params_.mpi_context.world_rank)));
+}
+
 namespace {
 Status WithOrtValuesFromTensorProtos(
     const PathString& model_location,
@@ -1228,32 +1310,52 @@ Status WithOrtValuesFromTensorProtos(
     std::function<Status(const NameMLValMap&)> use_name_to_ort_value_fn) {
   static const OrtMemoryInfo cpu_alloc_info{onnxruntime::CPU, OrtDeviceAllocator};
 
-  NameMLValMap name_to_ort_value{};
-  std::vector<std::vector<char>> tensor_buffers{};
-  std::vector<ScopedOrtCallbackInvoker> tensor_deleters{};
+  const size_t num_tensors = tensor_protos.size();
+  std::vector<std::vector<char>> tensor_buffers(num_tensors);
+  std::vector<OrtValue> ort_values(num_tensors);
+  std::vector<OrtCallback> callbacks(num_tensors, OrtCallback{nullptr, nullptr});
+  std::vector<Status> statuses(num_tensors);
 
-  for (const auto& tensor_proto : tensor_protos) {
-    const auto* tensor_type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type());
-    const size_t element_size = tensor_type->GetElementType()->Size();
-    const TensorShape shape{
-        tensor_proto.dims().data(), static_cast<size_t>(tensor_proto.dims().size())};
+  // the tensors are read and converted in parallel
+  auto load_tensors = [&](size_t begin, size_t stride) {
+    for (size_t i = begin; i < num_tensors; i += stride) {
+      const auto& tensor_proto = tensor_protos[i];
+      const auto* tensor_type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type());
+      const size_t element_size = tensor_type->GetElementType()->Size();
+      const TensorShape shape{
+          tensor_proto.dims().data(), static_cast<size_t>(tensor_proto.dims().size())};
 
-    std::vector<char> tensor_buffer{};
-    tensor_buffer.resize(element_size * shape.Size());
+      tensor_buffers[i].resize(element_size * shape.Size());
 
-    const MemBuffer mem_buffer{tensor_buffer.data(), tensor_buffer.size(), cpu_alloc_info};
+      const MemBuffer mem_buffer{tensor_buffers[i].data(), tensor_buffers[i].size(), cpu_alloc_info};
 
-    OrtValue ort_value;
-    OrtCallback callback;
+      statuses[i] = utils::TensorProtoToMLValue(
+          Env::Default(), model_location.c_str(), tensor_proto, mem_buffer,
+          ort_values[i], callbacks[i]);
+    }
+  };
 
-    ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(
-        Env::Default(), model_location.c_str(), tensor_proto, mem_buffer,
-        ort_value, callback));
-    ScopedOrtCallbackInvoker callback_invoker{callback};
+  const size_t num_threads = std::min<size_t>(
+      num_tensors, std::max<unsigned int>(std::thread::hardware_concurrency(), 1));
+  std::vector<std::thread> loaders{};
+  for (size_t t = 1; t < num_threads; ++t) {
+    loaders.emplace_back(load_tensors, t, num_threads);
+  }
+  load_tensors(0, std::max<size_t>(num_threads, 1));
+  for (auto& loader : loaders) {
+    loader.join();
+  }
 
-    name_to_ort_value.emplace(tensor_proto.name(), ort_value);
-    tensor_buffers.emplace_back(std::move(tensor_buffer));
-    tensor_deleters.emplace_back(std::move(callback_invoker));
+  std::vector<ScopedOrtCallbackInvoker> tensor_deleters{};
+  tensor_deleters.reserve(num_tensors);
+  for (auto& callback : callbacks) {
+    tensor_deleters.emplace_back(callback);
+  }
+
+  NameMLValMap name_to_ort_value{};
+  for (size_t i = 0; i < num_tensors; ++i) {
+    ORT_RETURN_IF_ERROR(statuses[i]);
+    name_to_ort_value.emplace(tensor_protos[i].name(), ort_values[i]);
   }
 
   ORT_RETURN_IF_ERROR(use_name_to_ort_value_fn(name_to_ort_value));
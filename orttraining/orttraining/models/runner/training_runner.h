@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -10,6 +11,7 @@
 #include "core/framework/ml_value.h"
 #include "core/providers/providers.h"
 #include "orttraining/core/framework/checkpoint_registry.h"
+#include "orttraining/core/framework/checkpointing.h"
 #include "orttraining/core/framework/mpi_setup.h"
 #include "orttraining/core/graph/optimizer_config.h"
 #include "orttraining/core/session/training_session.h"
@@ -30,6 +32,8 @@ class TrainingRunner {
 
     PathString train_data_dir;
     PathString test_data_dir;
+    size_t max_num_files_preload = 2;    // Number of data files prefetched by the data loaders.
+    size_t num_data_loader_threads = 1;  // Number of data files loaded concurrently.
     PathString output_dir;       // Output of training, e.g., trained model files.
     PathString perf_output_dir;  // training perf metrics
     std::string model_type;      // bert/gpt2/...
@@ -91,8 +95,10 @@ class TrainingRunner {
     ZeROConfig deepspeed_zero{};
     // Use Adasum for allreduce.
     bool use_adasum = false;
-    // Use Gist on CPU.
+    // Use Gist to compress the activations stashed for the backward pass.
     bool use_gist = false;
+    // The Gist compression of the stashed activations other than the Relu masks: GistPack16, GistPack8 or empty.
+    std::string gist_pack_type;
     // Whether we collect execution profile trace during this run.
     bool use_profiler = false;
     MPIContext mpi_context;
@@ -107,6 +113,12 @@ class TrainingRunner {
     bool use_fp16_moments = false;
     bool use_fp16_initializer = true;
     bool allreduce_in_fp16 = false;
+    // Size in bytes of the buckets of gradients all-reduced with NCCL during the backward pass. 0 disables them.
+    int64_t allreduce_bucket_size_bytes = 0;
+    // Whether to all-reduce the gradients quantized to 8 bits with NCCL, to save bandwidth.
+    bool use_quantized_allreduce = false;
+    // Whether to run the nodes in a memory-aware order that frees large buffers early, to lower the peak memory.
+    bool use_memory_aware_execution_order = false;
 
     // Tensorboard configuration.
     PathString log_dir;  // Path to write Tensorboard events to.
@@ -151,6 +163,10 @@ class TrainingRunner {
     size_t checkpoint_period = 0;
     // upper limit on number of checkpoint files to keep
     size_t max_num_checkpoints = 1;
+    // whether every rank saves its own state under checkpoints_dir/rank_<world_rank>
+    // the state is copied to host memory and written in a background thread
+    // ranks load from their own directory unless checkpoint_to_load_path is set
+    bool use_sharded_async_checkpoints = false;
 
     int data_parallel_size = 1;
     int horizontal_parallel_size = 1;
@@ -164,6 +180,9 @@ class TrainingRunner {
     // The i-th file is run by the i-th MPI rank.
     // If model_paths is not empty, model partition transformation may not be internally invoked.
     VectorString pipeline_stage_paths;
+    // Schedule pipeline batches one-forward-one-backward so that the activations held by
+    // a stage are bounded by the number of stages instead of the number of batches.
+    bool use_1f1b_pipeline_schedule = false;
     // Enable gradient clipping.
     bool enable_grad_norm_clip = true;
 
@@ -172,10 +191,18 @@ class TrainingRunner {
   
     // Use invertible layernorm grad
     bool use_invertible_layernorm_grad = false;
+
+    // Recompute activations in the backward pass instead of keeping them alive.
+    bool use_recompute = false;
+    // Op types whose outputs are recomputed. If empty, the TrainingSession defaults are used.
+    VectorString recompute_op_types;
+    // Names of additional activations to recompute.
+    VectorString recompute_activation_names;
   };
 
   TrainingRunner(Parameters params, const Environment& env);
   TrainingRunner(Parameters params, const Environment& env, SessionOptions session_options);
+  ~TrainingRunner();
 
   common::Status Initialize();
 
@@ -218,6 +245,9 @@ class TrainingRunner {
   Status Evaluate(InferenceSession& session, IDataLoader& data_loader);
 
   Status SaveCheckpoint(const PathString& checkpoint_path);
+  Status SaveCheckpointAsync(const PathString& checkpoint_path);
+  Status WaitForCheckpointWriter();
+  PathString GetCheckpointsDir() const;
   Status LoadCheckpoint(const PathString& checkpoint_path);
   Status SaveCheckpointProperties(std::unordered_map<std::string, std::string>& properties) const;
   Status LoadCheckpointProperties(const std::unordered_map<std::string, std::string>& properties);
@@ -242,6 +272,10 @@ class TrainingRunner {
   AllocatorPtr input_allocator_;
 
   std::unique_ptr<CheckpointRegistry> checkpoint_registry_;
+  // Host copy of the state written by checkpoint_writer_ if params_.use_sharded_async_checkpoints is set.
+  CheckpointSnapshot checkpoint_snapshot_;
+  std::thread checkpoint_writer_;
+  Status checkpoint_writer_status_;
 
   // Pipeline fields are valid only if params_.pipeline_parallel_size > 1.
   // Information for running pipeline.
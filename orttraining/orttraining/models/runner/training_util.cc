@@ -25,6 +25,7 @@ DataSet::~DataSet() {
   }
   ortvalue_buffers_.clear();
   ortvalue_deleters_.clear();
+  mapped_buffers_.clear();
 }
 
 const vector<string> DataSet::TensorNames() const {
@@ -67,6 +68,10 @@ common::Status DataSet::AddData(const vector<ONNX_NAMESPACE::TensorProto>& featu
   return Status::OK();
 }
 
+void DataSet::AddMappedBuffer(Env::MappedMemoryPtr&& mapped_buffer) {
+  mapped_buffers_.emplace_back(std::move(mapped_buffer));
+}
+
 size_t DataSet::TotalBatch(size_t batch_size) const {
   batch_size = min(batch_size, NumSamples());
   return NumSamples() / batch_size + ((NumSamples() % batch_size > 0) ? 1 : 0);
@@ -8,6 +8,7 @@
 #include "core/framework/callback.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/framework_common.h"
+#include "core/platform/env.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 
 #define RETURN_IF_FAIL(expr)                                \
@@ -47,6 +48,9 @@ class DataSet {
 
   common::Status AddData(const std::vector<ONNX_NAMESPACE::TensorProto>& features);
 
+  // Keeps the mapped file alive that the samples added with AddData(SampleType&&) point into.
+  void AddMappedBuffer(Env::MappedMemoryPtr&& mapped_buffer);
+
   virtual size_t NumSamples() const { return data_.size(); }
 
   // Given a batch_size, get the total num of batches.
@@ -87,6 +91,8 @@ class DataSet {
   std::vector<std::unique_ptr<char[]>> ortvalue_buffers_;
 
   std::vector<OrtCallback> ortvalue_deleters_;
+
+  std::vector<Env::MappedMemoryPtr> mapped_buffers_;
 };
 
 class RandomDataSet : public DataSet {
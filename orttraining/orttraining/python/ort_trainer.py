@@ -557,6 +557,7 @@ class ORTTrainer():
             training_optimizer_name: one of
                - 'SGDOptimizer'
                - 'AdamOptimizer'
+               - 'MultiTensorAdamOptimizer' (Adam updating all weights in a single node)
                - 'LambOptimizer'
             map_optimizer_attributes: for optimizers with weight-dependent
                parameters. A callable that maps weight name to a set of optimization
@@ -591,7 +592,7 @@ class ORTTrainer():
             loss_scaler: updates loss scale automatically when 'use_mixed_precision'
                is specified.
                Defaults to None.
-            deepspeed_zero_stage: controls whether to partition state using the DeepSpeed ZeRO technique.  Stages 0 and 1 are supported.
+            deepspeed_zero_stage: controls whether to partition state using the DeepSpeed ZeRO technique.  Stages 0, 1 and 2 are supported.
                Defaults to 0 (disabled).
             enable_grad_norm_clip: enables gradient norm clipping.
                Defaults to True.
@@ -9,6 +9,7 @@
 #include "gtest/gtest.h"
 
 #include "core/common/common.h"
+#include "core/framework/allocator.h"
 #include "core/framework/data_transfer.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/tensor.h"
@@ -141,6 +142,63 @@ TEST(CheckpointingTest, SaveAndLoad) {
       model_path, name_to_ort_value, name_to_loaded_tensor_proto);
 }
 
+TEST(CheckpointingTest, SaveAndLoadFromSnapshot) {
+  std::unordered_map<std::string, OrtValueTensorData> name_to_ort_value_data{
+      {"first", {{3}, {1.0f, 2.0f, 3.0f}}},
+      {"second", {{2, 2}, {1.0f, 2.0f, 3.0f, 4.0f}}},
+  };
+
+  NameMLValMap name_to_ort_value{};
+  for (auto& name_and_ort_value_data : name_to_ort_value_data) {
+    name_to_ort_value.emplace(
+        name_and_ort_value_data.first, name_and_ort_value_data.second.GetOrtValue());
+  }
+
+  std::unordered_map<std::string, std::string> properties{
+      {"one", "1"},
+  };
+
+  TemporaryDirectory tmp_dir{ORT_TSTR("checkpointing_test_dir")};
+
+  PathString checkpoint_path{
+      ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("test_checkpoint"))};
+  // this path doesn't need to exist, we just consider its parent directory
+  PathString model_path{
+      ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("test_model.onnx"))};
+
+  DataTransferManager data_transfer{};
+  data_transfer.RegisterDataTransfer(onnxruntime::make_unique<CPUDataTransfer>());
+
+  CheckpointSnapshot snapshot{};
+  ASSERT_STATUS_OK(CreateCheckpointSnapshot(
+      data_transfer, name_to_ort_value, properties, std::make_shared<CPUAllocator>(), snapshot));
+
+  // updates after the snapshot is taken are not saved
+  name_to_ort_value.at("first").GetMutable<Tensor>()->MutableData<float>()[0] = 42.0f;
+  ASSERT_EQ(snapshot.tensors.at("first").Get<Tensor>().Data<float>()[0], 1.0f);
+
+  ASSERT_STATUS_OK(SaveModelCheckpoint(checkpoint_path, snapshot));
+
+  std::vector<ONNX_NAMESPACE::TensorProto> loaded_tensor_protos{};
+  std::unordered_map<std::string, std::string> loaded_properties{};
+
+  ASSERT_STATUS_OK(LoadModelCheckpoint(
+      checkpoint_path, model_path, loaded_tensor_protos, loaded_properties));
+
+  ASSERT_EQ(loaded_properties, properties);
+
+  std::unordered_map<std::string, ONNX_NAMESPACE::TensorProto> name_to_loaded_tensor_proto{};
+  std::transform(
+      loaded_tensor_protos.begin(), loaded_tensor_protos.end(),
+      std::inserter(name_to_loaded_tensor_proto, name_to_loaded_tensor_proto.end()),
+      [](const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+        return std::make_pair(tensor_proto.name(), tensor_proto);
+      });
+
+  CompareOrtValuesToTensorProtoValues(
+      model_path, snapshot.tensors, name_to_loaded_tensor_proto);
+}
+
 }  // namespace test
 }  // namespace training
 }  // namespace onnxruntime
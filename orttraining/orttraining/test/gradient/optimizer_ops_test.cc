@@ -367,6 +367,52 @@ TEST(OptimizerTest, AdamOptimizerMixPrecisionTest_Gradient) {
 
 // This helper function is a CPU-based LAMB optimizer
 // implementation. It mainly focuses on readability.
+void run_multi_tensor_adam_test(const bool do_update) {
+  OpTester test("MultiTensorAdamOptimizer", 1, onnxruntime::kMSDomain, true);
+  AdamOptimizerInputOutput data;
+
+  test.AddInput<bool>("update_signal", {}, {do_update});
+  test.AddMissingOptionalInput<float>();
+  test.AddMissingOptionalInput<float>();
+  test.AddInput<float>("ETA", {}, data.eta);
+  test.AddInput<int64_t>("Step", {}, {3});
+  test.AddOutput<int64_t>("Step_Out", {}, {do_update ? 4 : 3});
+
+  // The first weight is updated in place while the second one outputs its update as a gradient.
+  for (int i = 0; i < 2; ++i) {
+    const std::string suffix = std::to_string(i);
+    test.AddInput<float>(("W_" + suffix).c_str(), {3}, data.w);
+    test.AddInput<float>(("G_" + suffix).c_str(), {3}, data.g);
+    test.AddInput<float>(("Moment_1_" + suffix).c_str(), {3}, data.m1);
+    test.AddInput<float>(("Moment_2_" + suffix).c_str(), {3}, data.m2);
+    test.AddMissingOptionalInput<MLFloat16>();
+
+    if (i == 0) {
+      test.AddOutput<float>(("W_Out_" + suffix).c_str(), {3}, do_update ? data.w_new : data.w);
+      test.AddMissingOptionalOutput<float>();
+    } else {
+      test.AddMissingOptionalOutput<float>();
+      test.AddOutput<float>(("G_Out_" + suffix).c_str(), {3}, do_update ? data.g_new : data.g);
+    }
+    test.AddOutput<float>(("Moment_1_Out_" + suffix).c_str(), {3}, do_update ? data.m1_new : data.m1);
+    test.AddOutput<float>(("Moment_2_Out_" + suffix).c_str(), {3}, do_update ? data.m2_new : data.m2);
+    test.AddMissingOptionalOutput<MLFloat16>();
+  }
+
+  test.AddAttribute("do_bias_correction", static_cast<int64_t>(0));
+  test.AddAttribute("weight_decay_mode", static_cast<int64_t>(0));
+
+  test.Run();
+}
+
+TEST(OptimizerTest, MultiTensorAdamOptimizerTest) {
+  run_multi_tensor_adam_test(true);
+}
+
+TEST(OptimizerTest, MultiTensorAdamOptimizerSkipUpdateTest) {
+  run_multi_tensor_adam_test(false);
+}
+
 void compute_lamb(
     const std::vector<int64_t> shape,
     /* weights */ const std::vector<float>& w,
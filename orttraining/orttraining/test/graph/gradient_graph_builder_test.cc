@@ -8,6 +8,9 @@
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/environment.h"
 #include "orttraining/models/runner/training_runner.h"
+#include "orttraining/core/graph/recompute_transformer.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
 
 #include "orttraining/training_ops/cpu/controlflow/event_pool.h"  // TODO: move with PipelineBatchPlanner
 
@@ -204,6 +207,27 @@ TEST(GradientGraphBuilderTest, TrainingSession_WithGist) {
   RunTrainingSessionWithChecks(so, backprop_model_file);
 }
 
+TEST(GradientGraphBuilderTest, TrainingSession_WithGistPack16) {
+  auto config = MakeBasicTrainingConfig();
+  TrainingSession::TrainingConfiguration::GistConfiguration gist{};
+  gist.pack_type = GistEncodeDecode::GIST_PACK16;
+  config.gist_config = gist;
+  PathString backprop_model_file;
+  ASSERT_STATUS_OK(BuildBackPropGraph(ORIGINAL_MODEL_PATH, config, backprop_model_file));
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_STATUS_OK(onnxruntime::Model::Load(backprop_model_file, p_model, nullptr, DefaultLoggingManager().DefaultLogger()));
+
+  // The Relu outputs are also consumed by the MatMul gradients, so they are packed instead of binarized.
+  std::map<std::string, int> op_to_count = CountOpsInGraph(p_model->MainGraph());
+  ASSERT_GT(op_to_count["GistPack16Encoder"], 0);
+  ASSERT_GE(op_to_count["GistPack16Decoder"], op_to_count["GistPack16Encoder"]);
+  ASSERT_EQ(op_to_count["GistBinarizeEncoder"], 0);
+
+  SessionOptions so{};
+  RunTrainingSessionWithChecks(so, backprop_model_file);
+}
+
 TEST(GradientGraphBuilderTest, TrainingSession_WithLogging) {
   const auto& log_manager = DefaultLoggingManager();
   const auto& default_logger = log_manager.DefaultLogger();
@@ -496,6 +520,104 @@ TEST(GradientGraphBuilderTest, TrainingSession_BertToy) {
 #endif
 }
 
+// Test that Gelu's output is recomputed from its stashed input in the backward pass:
+// forward: X -> Gelu -> gelu_out -> MatMul(W) -> Y
+// backward: Y_grad -> Identity -> dY -> MatMul(W) -> d_gelu_out -> GeluGrad(X) -> dX
+//                                  dY -> MatMul(gelu_out) -> dW
+TEST(GradientGraphBuilderTest, Recompute_Gelu) {
+  Model model("Recompute_Gelu", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  ONNX_NAMESPACE::TensorProto w_initializer;
+  w_initializer.set_name("W");
+  w_initializer.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  w_initializer.add_dims(2);
+  w_initializer.add_dims(2);
+  for (int i = 0; i < 4; ++i) {
+    w_initializer.add_float_data(0.5f * i);
+  }
+  graph.AddInitializedTensor(w_initializer);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor_type);
+  auto& w = graph.GetOrCreateNodeArg("W", &float_tensor_type);
+  auto& gelu_out = graph.GetOrCreateNodeArg("gelu_out", &float_tensor_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor_type);
+  auto& y_grad = graph.GetOrCreateNodeArg("Y_grad", &float_tensor_type);
+  auto& dy = graph.GetOrCreateNodeArg("dY", &float_tensor_type);
+  auto& d_gelu_out = graph.GetOrCreateNodeArg("d_gelu_out", &float_tensor_type);
+  auto& dx = graph.GetOrCreateNodeArg("dX", &float_tensor_type);
+  auto& dw = graph.GetOrCreateNodeArg("dW", &float_tensor_type);
+  graph.AddNode("gelu", "Gelu", "", {&x}, {&gelu_out}, nullptr, kMSDomain);
+  graph.AddNode("matmul", "MatMul", "", {&gelu_out, &w}, {&y});
+  graph.AddNode("y_grad", "Identity", "Backward pass", {&y_grad}, {&dy});
+  graph.AddNode("matmul_grad_a", "MatMul", "Backward pass", {&dy, &w}, {&d_gelu_out});
+  graph.AddNode("matmul_grad_b", "MatMul", "Backward pass", {&gelu_out, &dy}, {&dw});
+  graph.AddNode("gelu_grad", "GeluGrad", "Backward pass", {&d_gelu_out, &x}, {&dx}, nullptr, kMSDomain);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  RecomputeReport report{};
+  ASSERT_STATUS_OK(TransformGraphForRecompute(graph, {"Gelu"}, {}, report));
+
+  ASSERT_EQ(report.recomputed_activations, std::vector<std::string>{"gelu_out"});
+  EXPECT_EQ(report.bytes_saved, 4 * static_cast<int64_t>(sizeof(float)));
+  EXPECT_EQ(report.extra_flops, 4);
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Gelu"], 2);
+  EXPECT_EQ(op_to_count["WaitEvent"], 1);
+
+  // gelu_out is only consumed by the forward pass now.
+  for (const auto* consumer : graph.GetConsumerNodes("gelu_out")) {
+    EXPECT_NE(consumer->Description(), "Backward pass");
+  }
+
+  // The recomputed Gelu waits for the upstream gradient of its consumer.
+  for (const auto& node : graph.Nodes()) {
+    if (node.Name() == "matmul_grad_b") {
+      const Node* recompute = graph.GetProducerNode(node.InputDefs()[0]->Name());
+      ASSERT_NE(recompute, nullptr);
+      EXPECT_EQ(recompute->OpType(), "Gelu");
+      EXPECT_EQ(recompute->Description(), "Backward pass");
+
+      const Node* wait = graph.GetProducerNode(recompute->InputDefs()[0]->Name());
+      ASSERT_NE(wait, nullptr);
+      EXPECT_EQ(wait->OpType(), "WaitEvent");
+      EXPECT_EQ(wait->InputDefs()[1]->Name(), "X");
+      EXPECT_EQ(wait->InputDefs().back()->Name(), "dY");
+    }
+  }
+}
+
+// Dropout is never recomputed as it would draw a different mask.
+TEST(GradientGraphBuilderTest, Recompute_SkipsRandomOps) {
+  Model model("Recompute_SkipsRandomOps", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor_type);
+  auto& dropout_out = graph.GetOrCreateNodeArg("dropout_out", &float_tensor_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor_type);
+  auto& dy = graph.GetOrCreateNodeArg("dY", &float_tensor_type);
+  graph.AddNode("dropout", "Dropout", "", {&x}, {&dropout_out});
+  graph.AddNode("relu", "Relu", "", {&dropout_out}, {&y});
+  graph.AddNode("relu_grad", "Mul", "Backward pass", {&dropout_out, &x}, {&dy});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  RecomputeReport report{};
+  ASSERT_STATUS_OK(TransformGraphForRecompute(graph, {"Dropout"}, {"dropout_out"}, report));
+
+  EXPECT_TRUE(report.recomputed_activations.empty());
+  EXPECT_EQ(CountOpsInGraph(graph)["Dropout"], 1);
+}
+
 class PipelineSplitter {
  public:
   struct UnidirectionCutInfo {
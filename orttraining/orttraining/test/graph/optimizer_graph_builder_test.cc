@@ -35,6 +35,8 @@ constexpr const char* const k_loss_scaling_factor_name = "loss_scaling_factor";
 constexpr const char* const k_optimizer_op_name = "AdamOptimizer";
 constexpr const char* const k_horovod_all_reduce_op_name = "HorovodAllReduce";
 constexpr const char* const k_all_reduce_op_name = "NcclAllReduce";
+constexpr const char* const k_quantized_all_reduce_op_name = "NcclQuantizedAllReduce";
+constexpr const char* const k_nccl_wait_op_name = "NcclWait";
 constexpr const char* const k_all_gather_op_name = "NcclAllGather";
 constexpr const char* const k_reduce_scatter_op_name = "NcclReduceScatter";
 constexpr const char* const k_is_all_finite_op_name = "IsAllFinite";
@@ -182,6 +184,32 @@ TEST_F(OptimizerGraphBuilderTest, Default_WithGradientAccumulation_WithMixedPrec
   TestDefaultOptimizerGraphBuilder(config, graph_);
 }
 
+TEST_F(OptimizerGraphBuilderTest, Default_MultiTensorAdam) {
+  OptimizerGraphConfig config;
+  config.gradient_accumulation_steps = 1;
+  config.use_mixed_precision = false;
+
+  auto opt_info = GetOptInfoMap();
+  for (auto& weight_and_config : opt_info) {
+    weight_and_config.second.name = "MultiTensorAdamOptimizer";
+  }
+  OptimizerGraphBuilder optimizer_graph_builder(GetOptimizerBuilderRegistry(), config, opt_info);
+
+  OptimizerOutputKeyMap<std::string> opt_graph_outputs;
+  std::unordered_set<std::string> opt_initializer_names;
+  ASSERT_STATUS_OK(optimizer_graph_builder.Build(graph_, opt_initializer_names, opt_graph_outputs));
+
+  // all weights are updated by a single node sharing one step count
+  auto op_counts = CountOpsInGraph(graph_, false);
+  ASSERT_EQ(GetOpCount(op_counts, "MultiTensorAdamOptimizer"), 1);
+  ASSERT_EQ(GetOpCount(op_counts, k_optimizer_op_name), 0);
+  ASSERT_EQ(opt_initializer_names.count("Step"), 1);
+  for (const auto& weight_name : k_weight_names) {
+    ASSERT_EQ(opt_initializer_names.count(std::string{"Moment_1_"} + weight_name), 1);
+    ASSERT_EQ(opt_initializer_names.count(std::string{"Moment_2_"} + weight_name), 1);
+  }
+}
+
 #if defined(USE_NCCL) || defined(USE_HOROVOD)
 static void TestAllreduceOptimizerGraphBuilder(OptimizerGraphConfig config, Graph& graph) {
   AllreduceOptimizerGraphBuilder optimizer_graph_builder(
@@ -375,6 +403,75 @@ TEST_F(OptimizerGraphBuilderTest, Allreduce_WithGradientAccumulation_WithMixedPr
   TestAllreduceOptimizerGraphBuilder(config, graph_);
 }
 
+static void TestAllreduceBuckets(int64_t bucket_size_bytes, int expected_num_buckets, Graph& graph) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 4;
+  config.use_nccl = true;
+  config.use_mixed_precision = true;
+  config.loss_scale_input_name = k_loss_scaling_factor_name;
+  config.allreduce_bucket_size_bytes = bucket_size_bytes;
+  AllreduceOptimizerGraphBuilder optimizer_graph_builder(
+      GetOptimizerBuilderRegistry(), config, GetOptInfoMap());
+
+  OptimizerOutputKeyMap<std::string> opt_graph_outputs;
+  std::unordered_set<std::string> opt_initializer_names;
+  ASSERT_STATUS_OK(optimizer_graph_builder.Build(graph, opt_initializer_names, opt_graph_outputs));
+
+  auto op_counts = CountOpsInGraph(graph, false);
+
+  // verify each bucket is scaled and reduced on its own, then waited for once
+  ASSERT_EQ(GetOpCount(op_counts, k_unscale_op_name), expected_num_buckets);
+  ASSERT_EQ(GetOpCount(op_counts, k_all_reduce_op_name), expected_num_buckets);
+  ASSERT_EQ(GetOpCount(op_counts, k_nccl_wait_op_name), 1);
+  ASSERT_GT(GetOpCount(op_counts, k_gradient_norm_op_name), 0);
+  ASSERT_EQ(GetOpCount(op_counts, k_optimizer_op_name), k_weight_names.size());
+}
+
+TEST_F(OptimizerGraphBuilderTest, Allreduce_OneGradientPerBucket) {
+  // the gradients are float tensors of shape [1]
+  TestAllreduceBuckets(4, static_cast<int>(k_weight_names.size()), graph_);
+}
+
+TEST_F(OptimizerGraphBuilderTest, Allreduce_AllGradientsInOneBucket) {
+  TestAllreduceBuckets(1024, 1, graph_);
+}
+
+TEST_F(OptimizerGraphBuilderTest, Allreduce_Quantized) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 4;
+  config.use_nccl = true;
+  config.use_mixed_precision = true;
+  config.loss_scale_input_name = k_loss_scaling_factor_name;
+  config.use_quantized_allreduce = true;
+  AllreduceOptimizerGraphBuilder optimizer_graph_builder(
+      GetOptimizerBuilderRegistry(), config, GetOptInfoMap());
+
+  OptimizerOutputKeyMap<std::string> opt_graph_outputs;
+  std::unordered_set<std::string> opt_initializer_names;
+  ASSERT_STATUS_OK(optimizer_graph_builder.Build(graph_, opt_initializer_names, opt_graph_outputs));
+
+  auto op_counts = CountOpsInGraph(graph_, false);
+
+  // verify the fused gradients are quantized instead of all-reduced directly
+  ASSERT_EQ(GetOpCount(op_counts, k_quantized_all_reduce_op_name), 1);
+  ASSERT_EQ(GetOpCount(op_counts, k_all_reduce_op_name), 0);
+  ASSERT_EQ(GetOpCount(op_counts, k_optimizer_op_name), k_weight_names.size());
+
+  // verify the quantization error is kept as optimizer state
+  const Node* allreduce_node = nullptr;
+  for (const auto& node : graph_.Nodes()) {
+    if (node.OpType() == k_quantized_all_reduce_op_name) {
+      allreduce_node = &node;
+    }
+  }
+  ASSERT_NE(allreduce_node, nullptr);
+  const auto& error_name = allreduce_node->InputDefs()[1]->Name();
+  ASSERT_EQ(opt_initializer_names.count(error_name), 1);
+  const auto* error_shape = allreduce_node->InputDefs()[1]->Shape();
+  ASSERT_NE(error_shape, nullptr);
+  ASSERT_EQ(error_shape->dim(0).dim_value(), static_cast<int64_t>(k_weight_names.size()));
+}
+
 static void TestZeROOptimizerGraphBuilder(OptimizerGraphConfig config, Graph& graph) {
   ZeROOptimizerGraphBuilder optimizer_graph_builder(
       GetOptimizerBuilderRegistry(), config, GetOptInfoMap());
@@ -450,6 +547,60 @@ TEST_F(OptimizerGraphBuilderTest, ZeRO_WithGradientAccumulation_WithMixedPrecisi
   TestZeROOptimizerGraphBuilder(config, graph_);
 }
 
+TEST_F(OptimizerGraphBuilderTest, ZeRO_PartitionedGradients_NoMixedPrecision) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 4;
+  config.use_nccl = true;
+  config.deepspeed_zero = ZeROConfig{2};
+  config.gradient_accumulation_steps = 10;
+  config.use_mixed_precision = false;
+  TestZeROOptimizerGraphBuilder(config, graph_);
+}
+
+TEST_F(OptimizerGraphBuilderTest, ZeRO_PartitionedGradients_WithMixedPrecision) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 4;
+  config.use_nccl = true;
+  config.deepspeed_zero = ZeROConfig{2};
+  config.gradient_accumulation_steps = 10;
+  config.use_mixed_precision = true;
+  config.loss_scale_input_name = k_loss_scaling_factor_name;
+  TestZeROOptimizerGraphBuilder(config, graph_);
+}
+
+TEST_F(OptimizerGraphBuilderTest, ZeRO_PartitionedGradients_RankWithoutGradients) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 4;
+  // the gradients are all handled by rank 0
+  config.data_parallel_group_rank = 3;
+  config.use_nccl = true;
+  config.deepspeed_zero = ZeROConfig{2};
+  config.gradient_accumulation_steps = 10;
+  ZeROOptimizerGraphBuilder optimizer_graph_builder(
+      GetOptimizerBuilderRegistry(), config, GetOptInfoMap());
+
+  OptimizerOutputKeyMap<std::string> opt_graph_outputs;
+  std::unordered_set<std::string> opt_initializer_names;
+  ASSERT_STATUS_OK(optimizer_graph_builder.Build(graph_, opt_initializer_names, opt_graph_outputs));
+
+  auto op_counts = CountOpsInGraph(graph_, false);
+
+  // verify the gradients are reduced at each step, but not accumulated
+  ASSERT_GT(opt_graph_outputs.count(OptimizerOutputKey::GradientAccumulation), 0);
+  ASSERT_EQ(GetOpCount(op_counts, k_reduce_scatter_op_name), 1);
+  ASSERT_EQ(GetOpCount(op_counts, k_inplace_accumulator_op_name), 0);
+  ASSERT_EQ(GetOpCount(op_counts, k_zero_gradient_op_name), 0);
+}
+
+TEST_F(OptimizerGraphBuilderTest, ZeRO_PartitionedParametersNotSupported) {
+  OptimizerGraphConfig config;
+  config.data_parallel_group_size = 4;
+  config.use_nccl = true;
+  config.deepspeed_zero = ZeROConfig{3};
+  ASSERT_THROW(ZeROOptimizerGraphBuilder(GetOptimizerBuilderRegistry(), config, GetOptInfoMap()),
+               OnnxRuntimeException);
+}
+
 #endif  // USE_NCCL
 
 }  // namespace test
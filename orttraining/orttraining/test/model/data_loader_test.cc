@@ -1,6 +1,8 @@
 ﻿// Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <fstream>
+
 #include "gtest/gtest.h"
 
 #include "core/framework/callback.h"
@@ -62,16 +64,60 @@ Status WriteInputDataFile(
   return Status::OK();
 }
 
+// writes the same samples as WriteInputDataFile() in the memory-mapped .ortdata format
+Status WriteMappedInputDataFile(
+    const PathString& path,
+    const uint32_t num_samples,
+    const std::vector<std::string>& sample_tensor_names,
+    const uint32_t tensor_data_value) {
+  ORT_RETURN_IF_NOT(num_samples > 0 && !sample_tensor_names.empty());
+
+  std::ofstream file{path, std::ios::binary};
+  const auto write = [&file](const void* data, size_t size) {
+    file.write(static_cast<const char*>(data), size);
+  };
+  const auto write_padding = [&file](size_t size) {
+    const char zeros[8]{};
+    file.write(zeros, (8 - size % 8) % 8);
+  };
+
+  for (uint32_t i = 0; i < num_samples; ++i) {
+    const uint64_t num_features = sample_tensor_names.size();
+    write(&num_features, sizeof(num_features));
+    for (const auto& name : sample_tensor_names) {
+      const uint32_t header[] = {static_cast<uint32_t>(name.size()), ONNX_NAMESPACE::TensorProto_DataType_UINT32, 1, 0};
+      const int64_t dim = 1;
+      const uint64_t data_size = sizeof(tensor_data_value);
+      write(header, sizeof(header));
+      write(&dim, sizeof(dim));
+      write(&data_size, sizeof(data_size));
+      write(name.data(), name.size());
+      write_padding(name.size());
+      write(&tensor_data_value, sizeof(tensor_data_value));
+      write_padding(sizeof(tensor_data_value));
+    }
+  }
+
+  ORT_RETURN_IF_NOT(file.good(), "Failed to write ", ToMBString(path));
+  return Status::OK();
+}
+
 Status CreateInputDataFiles(
     const PathString& directory_path,
     const size_t num_input_files,
-    const std::vector<std::string>& sample_tensor_names) {
+    const std::vector<std::string>& sample_tensor_names,
+    const bool use_mapped_format = false) {
   ORT_RETURN_IF_ERROR(Env::Default().CreateFolder(directory_path));
   for (size_t i = 0; i < num_input_files; ++i) {
     const PathString input_file_path = ConcatPathComponent(
-        directory_path, ToPathString(MakeString("input.", i, ".pb")));
-    ORT_RETURN_IF_ERROR(WriteInputDataFile(
-        input_file_path, 3, sample_tensor_names, static_cast<uint32_t>(i)));
+        directory_path, ToPathString(MakeString("input.", i, use_mapped_format ? ".ortdata" : ".pb")));
+    if (use_mapped_format) {
+      ORT_RETURN_IF_ERROR(WriteMappedInputDataFile(
+          input_file_path, 3, sample_tensor_names, static_cast<uint32_t>(i)));
+    } else {
+      ORT_RETURN_IF_ERROR(WriteInputDataFile(
+          input_file_path, 3, sample_tensor_names, static_cast<uint32_t>(i)));
+    }
   }
   return Status::OK();
 }
@@ -144,17 +190,22 @@ TEST(TrainingDataLoaderTest, DataLoader_OneSingleFileFailParsing) {
 namespace {
 void TestDataLoaderWithMultipleFiles(
     const size_t num_input_files, const size_t max_num_files_preload,
-    const size_t* const start_data_set_index = nullptr) {
+    const size_t* const start_data_set_index = nullptr,
+    const size_t num_loader_threads = 1,
+    const bool use_mapped_format = false) {
   const MapStringToString input_name_map = {{"a", "a"}, {"b", "b"}, {"c", "c"}};
   TemporaryDirectory tmp_dir{ORT_TSTR("training_data_loader_test_dir")};
   const PathString& train_data_dir = ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("multiple_files"));
 
   ASSERT_STATUS_OK(CreateInputDataFiles(
-      train_data_dir, num_input_files, {"a", "b", "c"}));
+      train_data_dir, num_input_files, {"a", "b", "c"}, use_mapped_format));
 
   DataLoader data_loader(input_name_map,
                          train_data_dir,
-                         max_num_files_preload);
+                         max_num_files_preload,
+                         0,
+                         1,
+                         num_loader_threads);
 
   ASSERT_EQ(data_loader.NumShards(), num_input_files);
 
@@ -194,6 +245,28 @@ TEST(TrainingDataLoaderTest, DataLoader_MultipleFiles_PreloadCountExceedsFileCou
   TestDataLoaderWithMultipleFiles(3, 4);
 }
 
+TEST(TrainingDataLoaderTest, DataLoader_MultipleFiles_ConcurrentLoads) {
+  TestDataLoaderWithMultipleFiles(5, 3, nullptr, 3);
+}
+
+TEST(TrainingDataLoaderTest, DataLoader_MultipleFiles_ConcurrentLoadsWrapAround) {
+  const size_t start_index = 1;
+  TestDataLoaderWithMultipleFiles(3, 2, &start_index, 2);
+}
+
+TEST(TrainingDataLoaderTest, DataLoader_MultipleFiles_MappedFormat) {
+  TestDataLoaderWithMultipleFiles(3, 2, nullptr, 2, true);
+}
+
+TEST(TrainingDataLoaderTest, DataLoader_OneSingleFileFailParsing_MappedFormat) {
+  const MapStringToString input_name_map = {{"a_invalid", "a"}, {"b", "b"}, {"c", "c"}};
+  TemporaryDirectory tmp_dir{ORT_TSTR("training_data_loader_test_dir")};
+  const PathString& train_data_dir = ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("single_file"));
+  ASSERT_STATUS_OK(CreateInputDataFiles(train_data_dir, 1, {"a", "b", "c"}, true));
+  DataLoader data_loader(input_name_map, train_data_dir);
+  ASSERT_EQ(nullptr, data_loader.CurrentDataSet());
+}
+
 }  // namespace test
 }  // namespace training
 }  // namespace onnxruntime
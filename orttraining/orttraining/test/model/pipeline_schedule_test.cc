@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "orttraining/models/runner/pipeline.h"
+
+namespace onnxruntime {
+namespace training {
+namespace test {
+
+using pipeline::PipelineSchedule;
+
+TEST(PipelineScheduleTest, OneForwardOneBackwardInFlightBatches) {
+  const int num_stages = 4;
+  for (int num_batches : {1, 3, 4, 16}) {
+    PipelineSchedule schedule(num_stages);
+    schedule.AddOneForwardOneBackward(0, num_batches);
+    for (int s = 0; s < num_stages; ++s) {
+      EXPECT_EQ(schedule.GetMaxInFlightBatches(s), std::min(num_stages - s, num_batches));
+    }
+  }
+}
+
+TEST(PipelineScheduleTest, OneForwardOneBackwardEvents) {
+  const int num_stages = 3;
+  const int num_batches = 5;
+  PipelineSchedule schedule(num_stages);
+  schedule.AddOneForwardOneBackward(0, num_batches);
+
+  // The last stage runs F0 B0 F1 B1 ..., each waiting for the events recorded by the previous one.
+  const int s = num_stages - 1;
+  EXPECT_EQ(schedule.GetForwardWaitedEventId(s, 0), -1);
+  EXPECT_EQ(schedule.GetForwardWaitedEventIdAfterRecv(s, 0), -1);
+  EXPECT_EQ(schedule.GetForwardRecordedEventIdBeforeSend(s, 0), 0);
+  EXPECT_EQ(schedule.GetForwardRecordedEventId(s, 0), 1);
+  EXPECT_EQ(schedule.GetBackwardWaitedEventId(s, 0), 0);
+  EXPECT_EQ(schedule.GetBackwardWaitedEventIdAfterRecv(s, 0), 1);
+  EXPECT_EQ(schedule.GetBackwardRecordedEventIdBeforeSend(s, 0), 2);
+  EXPECT_EQ(schedule.GetBackwardRecordedEventId(s, 0), 3);
+  EXPECT_EQ(schedule.GetForwardWaitedEventId(s, 1), 2);
+  EXPECT_EQ(schedule.GetForwardWaitedEventIdAfterRecv(s, 1), 3);
+
+  // The first stage runs F0 F1 F2 B0 F3 B1 F4 B2 B3 B4.
+  EXPECT_EQ(schedule.GetForwardRecordedEventId(0, 2), 5);
+  EXPECT_EQ(schedule.GetBackwardWaitedEventId(0, 0), 4);
+  EXPECT_EQ(schedule.GetBackwardRecordedEventId(0, 0), 7);
+  EXPECT_EQ(schedule.GetForwardWaitedEventId(0, 3), 6);
+  EXPECT_EQ(schedule.GetBackwardRecordedEventId(0, num_batches - 1), 2 * (2 * num_batches - 1) + 1);
+}
+
+TEST(PipelineScheduleTest, OneForwardOneBackwardRequiresEmptySchedule) {
+  PipelineSchedule schedule(2);
+  schedule.Add(0, 2);
+  EXPECT_THROW(schedule.AddOneForwardOneBackward(2, 4), OnnxRuntimeException);
+}
+
+}  // namespace test
+}  // namespace training
+}  // namespace onnxruntime
@@ -11,6 +11,7 @@
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/utils.h"
 #include "orttraining/core/optimizer/bias_dropout_fusion.h"
+#include "orttraining/core/optimizer/bias_dropout_layer_norm_fusion.h"
 #include "orttraining/core/optimizer/gist_encode_decode.h"
 #include "orttraining/core/optimizer/nonzero_shape_setter.h"
 #include "orttraining/core/optimizer/megatron_transformer.h"
@@ -74,6 +75,89 @@ TEST_F(GraphTransformationTests, BiasDropoutFusionTest) {
   TestBiasDropoutFusion(MODEL_FOLDER "fusion/bias_trainabledropout_residual_fusion.onnx", *logger_);
 }
 
+// BiasDropout -> LayerNormalization, with the dropout output optionally consumed by another node as the
+// LayerNormalizationGrad of a training graph would
+static void TestBiasDropoutLayerNormFusion(bool dropout_output_consumed, const logging::Logger& logger) {
+  Model model("BiasDropoutLayerNormFusion", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}, {kMSDomain, 1}}, {}, logger);
+  auto& graph = model.MainGraph();
+
+  TypeProto data_type;
+  data_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (const int64_t dim : {2, 3, 16}) {
+    data_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  TypeProto vector_type;
+  vector_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  vector_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(16);
+  TypeProto ratio_type;
+  ratio_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  ratio_type.mutable_tensor_type()->mutable_shape();
+  TypeProto training_mode_type;
+  training_mode_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  training_mode_type.mutable_tensor_type()->mutable_shape();
+
+  auto& data = graph.GetOrCreateNodeArg("data", &data_type);
+  auto& bias = graph.GetOrCreateNodeArg("bias", &vector_type);
+  auto& residual = graph.GetOrCreateNodeArg("residual", &data_type);
+  auto& ratio = graph.GetOrCreateNodeArg("ratio", &ratio_type);
+  auto& training_mode = graph.GetOrCreateNodeArg("training_mode", &training_mode_type);
+  auto& scale = graph.GetOrCreateNodeArg("scale", &vector_type);
+  auto& B = graph.GetOrCreateNodeArg("B", &vector_type);
+  auto& dropout_output = graph.GetOrCreateNodeArg("dropout_output", &data_type);
+  auto& mask = graph.GetOrCreateNodeArg("mask", nullptr);
+  auto& output = graph.GetOrCreateNodeArg("output", nullptr);
+  auto& mean = graph.GetOrCreateNodeArg("mean", nullptr);
+  auto& inv_std_var = graph.GetOrCreateNodeArg("inv_std_var", nullptr);
+
+  auto& dropout_node = graph.AddNode("bias_dropout", "BiasDropout", "BiasDropout",
+                                     {&data, &bias, &residual, &ratio, &training_mode}, {&dropout_output, &mask},
+                                     nullptr, kMSDomain);
+  dropout_node.AddAttribute("seed", static_cast<int64_t>(42));
+  auto& layer_norm_node = graph.AddNode("layer_norm", "LayerNormalization", "LayerNormalization",
+                                        {&dropout_output, &scale, &B}, {&output, &mean, &inv_std_var});
+  layer_norm_node.AddAttribute("epsilon", 1e-3f);
+  if (dropout_output_consumed) {
+    auto& dropout_output_copy = graph.GetOrCreateNodeArg("dropout_output_copy", nullptr);
+    graph.AddNode("identity", "Identity", "Stands for LayerNormalizationGrad", {&dropout_output}, {&dropout_output_copy});
+  }
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(
+      onnxruntime::make_unique<BiasDropoutLayerNormFusion>(std::unordered_set<std::string>{kCudaExecutionProvider}),
+      TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, logger));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["BiasDropout"], 0);
+  ASSERT_EQ(op_to_count["LayerNormalization"], 0);
+  ASSERT_EQ(op_to_count["BiasDropoutLayerNormalization"], 1);
+
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() != "BiasDropoutLayerNormalization") {
+      continue;
+    }
+    const auto& inputs = node.InputDefs();
+    ASSERT_EQ(inputs[2]->Name(), "scale");
+    ASSERT_EQ(inputs[3]->Name(), "B");
+    ASSERT_EQ(inputs[4]->Name(), "residual");
+    const auto& outputs = node.OutputDefs();
+    ASSERT_EQ(outputs[0]->Name(), "output");
+    ASSERT_EQ(outputs[3]->Name(), "mask");
+    ASSERT_EQ(outputs[4]->Exists(), dropout_output_consumed);
+    ASSERT_EQ(node.GetAttributes().at("epsilon").f(), 1e-3f);
+  }
+}
+
+TEST_F(GraphTransformationTests, BiasDropoutLayerNormFusionTest) {
+  TestBiasDropoutLayerNormFusion(true, *logger_);
+  TestBiasDropoutLayerNormFusion(false, *logger_);
+}
+
 Node* GetNodeByName(Graph& graph, std::string node_name) {
   GraphViewer graph_viewer(graph);
   const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(GistOpTest, BinarizeEncodeDecode) {
+  std::vector<float> X = {1.5f, -2.f, 0.f, 0.25f};
+
+  OpTester encoder("GistBinarizeEncoder", 1, onnxruntime::kMSDomain);
+  encoder.AddInput<float>("X", {2, 2}, X);
+  encoder.AddOutput<float>("Y", {2, 2}, X);
+  encoder.AddOutput<bool>("Y1", {2, 2}, {true, false, false, true});
+  encoder.Run();
+
+  OpTester decoder("GistBinarizeDecoder", 1, onnxruntime::kMSDomain);
+  decoder.AddMissingOptionalInput<float>();
+  decoder.AddInput<bool>("X", {2, 2}, {true, false, false, true});
+  decoder.AddOutput<float>("Y", {2, 2}, {1.f, 0.f, 0.f, 1.f});
+  decoder.Run();
+}
+
+TEST(GistOpTest, Pack16EncodeDecode) {
+  std::vector<float> X = {1.5f, -2.f, 0.f, 0.1f};
+  std::vector<MLFloat16> X_half(X.size());
+  ConvertFloatToMLFloat16(X.data(), X_half.data(), static_cast<int>(X.size()));
+
+  OpTester encoder("GistPack16Encoder", 1, onnxruntime::kMSDomain);
+  encoder.AddInput<float>("X", {4}, X);
+  encoder.AddOutput<float>("Y", {4}, X);
+  encoder.AddOutput<MLFloat16>("Y1", {4}, X_half);
+  encoder.Run();
+
+  OpTester decoder("GistPack16Decoder", 1, onnxruntime::kMSDomain);
+  decoder.AddInput<float>("X1", {1}, {0.f});
+  decoder.AddInput<MLFloat16>("X", {4}, X_half);
+  decoder.AddOutput<float>("Y", {4}, {1.5f, -2.f, 0.f, 0.099975586f});
+  decoder.Run();
+}
+
+TEST(GistOpTest, Pack8EncodeDecode) {
+  // 1.3 is rounded to 1.25, the nearest value with 2 mantissa bits.
+  std::vector<float> X = {1.5f, -6.f, 0.f, 0.375f, 1.3f};
+  std::vector<uint8_t> packed = {0x3E, 0xC6, 0x00, 0x36, 0x3D};
+
+  OpTester encoder("GistPack8Encoder", 1, onnxruntime::kMSDomain);
+  encoder.AddInput<float>("X", {5}, X);
+  encoder.AddOutput<float>("Y", {5}, X);
+  encoder.AddOutput<uint8_t>("Y1", {5}, packed);
+  encoder.Run();
+
+  OpTester decoder("GistPack8Decoder", 1, onnxruntime::kMSDomain);
+  decoder.AddMissingOptionalInput<float>();
+  decoder.AddInput<uint8_t>("X", {5}, packed);
+  decoder.AddOutput<float>("Y", {5}, {1.5f, -6.f, 0.f, 0.375f, 1.25f});
+  decoder.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
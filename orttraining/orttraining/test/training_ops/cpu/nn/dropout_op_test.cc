@@ -8,6 +8,7 @@
 #include "orttraining/training_ops/cpu/nn/dropout_op.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <numeric>
 #include <random>
@@ -276,6 +277,108 @@ TEST(BiasDropoutTest, RatioLimit) {
 TEST(BiasDropoutTest, EmptyRatio) {
   RunBiasDropoutTest(true, {2, 7, 1024});
 }
+
+namespace {
+void RunBiasDropoutLayerNormTest(const std::vector<int64_t>& input_shape, float ratio, bool training_mode,
+                                 bool has_residual = true) {
+  OpTester t{"BiasDropoutLayerNormalization", 1, kMSDomain};
+  const int64_t seed = 42;
+  const float epsilon = 1e-5f;
+  t.AddAttribute("seed", seed);
+  t.AddAttribute("epsilon", epsilon);
+
+  const auto input_size = std::accumulate(
+      input_shape.begin(), input_shape.end(), static_cast<int64_t>(1), std::multiplies<>{});
+  const auto dim = input_shape.back();
+  std::vector<float> input(input_size), residual(input_size), bias(dim), scale(dim), B(dim);
+  for (int64_t i = 0; i < input_size; ++i) {
+    input[i] = (i % 13) * 0.1f - 0.6f;
+    residual[i] = has_residual ? (i % 7) * 0.3f : 0.0f;
+  }
+  for (int64_t i = 0; i < dim; ++i) {
+    bias[i] = (i % 5) * 0.2f;
+    scale[i] = 1.0f + (i % 3) * 0.5f;
+    B[i] = (i % 4) * 0.1f;
+  }
+
+  t.AddInput("data", input_shape, input);
+  t.AddInput("bias", {dim}, bias);
+  t.AddInput("scale", {dim}, scale);
+  t.AddInput("B", {dim}, B);
+  if (has_residual) {
+    t.AddInput("residual", input_shape, residual);
+  } else {
+    t.AddMissingOptionalInput<float>();
+  }
+  t.AddInput("ratio", {}, {ratio});
+  t.AddInput("training_mode", {}, {training_mode});
+
+  std::vector<int64_t> stats_shape(input_shape);
+  stats_shape.back() = 1;
+  const auto num_rows = input_size / dim;
+  // we'll do our own output verification
+  t.AddOutput<float>("output", input_shape, input);
+  t.AddOutput<float>("mean", stats_shape, std::vector<float>(num_rows));
+  t.AddOutput<float>("inv_std_var", stats_shape, std::vector<float>(num_rows));
+  auto mask_buffer = onnxruntime::make_unique<bool[]>(input_size);
+  t.AddOutput<bool>("mask", input_shape, mask_buffer.get(), input_size);
+  t.AddOutput<float>("dropout_output", input_shape, input);
+
+  auto output_verifier = [&](const std::vector<OrtValue>& fetches, const std::string& provider_type) {
+    ASSERT_EQ(fetches.size(), 5u);
+    auto output_span = FetchTensor(fetches[0]).DataAsSpan<float>();
+    auto mean_span = FetchTensor(fetches[1]).DataAsSpan<float>();
+    auto inv_std_var_span = FetchTensor(fetches[2]).DataAsSpan<float>();
+    auto mask_span = FetchTensor(fetches[3]).DataAsSpan<bool>();
+    auto dropout_output_span = FetchTensor(fetches[4]).DataAsSpan<float>();
+
+    const float effective_ratio = training_mode ? ratio : 0.0f;
+    const auto num_dropped_values = std::count(mask_span.begin(), mask_span.end(), false);
+    ASSERT_NEAR(static_cast<float>(num_dropped_values) / input_size, effective_ratio, 0.1f)
+        << "provider: " << provider_type;
+
+    for (int64_t row = 0; row < num_rows; ++row) {
+      double sum = 0.0;
+      for (int64_t j = 0; j < dim; ++j) {
+        const int64_t i = row * dim + j;
+        const float dropped = mask_span[i] ? (input[i] + bias[j]) / (1.0f - effective_ratio) : 0.0f;
+        ASSERT_NEAR(dropout_output_span[i], dropped + residual[i], 1e-4f)
+            << "unexpected dropout output at index " << i << ", provider: " << provider_type;
+        sum += dropout_output_span[i];
+      }
+      const double mean = sum / dim;
+      double sum_of_squares = 0.0;
+      for (int64_t j = 0; j < dim; ++j) {
+        const double diff = dropout_output_span[row * dim + j] - mean;
+        sum_of_squares += diff * diff;
+      }
+      const double inv_std_var = 1.0 / std::sqrt(sum_of_squares / dim + epsilon);
+      ASSERT_NEAR(mean_span[row], mean, 1e-4) << "provider: " << provider_type;
+      ASSERT_NEAR(inv_std_var_span[row], inv_std_var, 1e-3 * inv_std_var) << "provider: " << provider_type;
+      for (int64_t j = 0; j < dim; ++j) {
+        const int64_t i = row * dim + j;
+        const double expected = scale[j] * (dropout_output_span[i] - mean) * inv_std_var + B[j];
+        ASSERT_NEAR(output_span[i], expected, 1e-3) << "unexpected output at index " << i
+                                                    << ", provider: " << provider_type;
+      }
+    }
+  };
+
+  t.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, nullptr, ExecutionMode::ORT_SEQUENTIAL, output_verifier);
+}
+}  // namespace
+
+TEST(BiasDropoutLayerNormTest, Training) {
+  RunBiasDropoutLayerNormTest({3, 5, 768}, 0.25f, true);
+}
+
+TEST(BiasDropoutLayerNormTest, TrainingWithoutResidual) {
+  RunBiasDropoutLayerNormTest({4, 1000}, 0.5f, true, false);
+}
+
+TEST(BiasDropoutLayerNormTest, Inference) {
+  RunBiasDropoutLayerNormTest({2, 7, 33}, 0.25f, false);
+}
 #endif
 
 namespace {
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gistdecode_op.h"
+#include "core/util/math.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -26,5 +27,49 @@ Status GistBinarizeDecoderOp::Compute(OpKernelContext* context) const {
 
   return Status::OK();
 }
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack16Decoder,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    GistPack16DecoderOp);
+
+Status GistPack16DecoderOp::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(1);
+  ORT_ENFORCE(X != nullptr);
+  const TensorShape& shape = X->Shape();
+  Tensor* Y = context->Output(0, shape);
+  const auto* src = X->template Data<MLFloat16>();
+  auto* dst = Y->template MutableData<float>();
+  for (int64_t i = 0; i < shape.Size(); ++i) {
+    dst[i] = math::halfToFloat(src[i].val);
+  }
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack8Decoder,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    GistPack8DecoderOp);
+
+Status GistPack8DecoderOp::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(1);
+  ORT_ENFORCE(X != nullptr);
+  const TensorShape& shape = X->Shape();
+  Tensor* Y = context->Output(0, shape);
+  const auto* src = X->template Data<uint8_t>();
+  auto* dst = Y->template MutableData<float>();
+  for (int64_t i = 0; i < shape.Size(); ++i) {
+    dst[i] = math::halfToFloat(static_cast<uint16_t>(src[i] << 8));
+  }
+
+  return Status::OK();
+}
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gistencode_op.h"
+#include "core/util/math.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -30,5 +31,62 @@ Status GistBinarizeEncoderOp::Compute(OpKernelContext* context) const {
   ORT_ENFORCE(target != nullptr);
   return Status::OK();
 }
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack16Encoder,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().Alias(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    GistPack16EncoderOp);
+
+Status GistPack16EncoderOp::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  ORT_ENFORCE(X != nullptr);
+  const TensorShape& shape = X->Shape();
+  Tensor* Y = context->Output(0, shape);
+  Tensor* Y1 = context->Output(1, shape);
+  const auto* src = X->template Data<float>();
+  auto* dst = Y1->template MutableData<MLFloat16>();
+  for (int64_t i = 0; i < shape.Size(); ++i) {
+    dst[i] = MLFloat16(math::floatToHalf(src[i]));
+  }
+
+  ORT_ENFORCE(Y->MutableDataRaw(X->DataType()) != nullptr);
+  return Status::OK();
+}
+
+// The high byte of the float16 value, rounded to nearest even. NaN stays NaN.
+static uint8_t FloatToPack8(float value) {
+  const uint16_t h = math::floatToHalf(value);
+  if ((h & 0x7C00) == 0x7C00 && (h & 0x03FF) != 0) {
+    return static_cast<uint8_t>((h >> 8) | 0x02);
+  }
+  return static_cast<uint8_t>((h + 0x7F + ((h >> 8) & 1)) >> 8);
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack8Encoder,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().Alias(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    GistPack8EncoderOp);
+
+Status GistPack8EncoderOp::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  ORT_ENFORCE(X != nullptr);
+  const TensorShape& shape = X->Shape();
+  Tensor* Y = context->Output(0, shape);
+  Tensor* Y1 = context->Output(1, shape);
+  const auto* src = X->template Data<float>();
+  auto* dst = Y1->template MutableData<uint8_t>();
+  for (int64_t i = 0; i < shape.Size(); ++i) {
+    dst[i] = FloatToPack8(src[i]);
+  }
+
+  ORT_ENFORCE(Y->MutableDataRaw(X->DataType()) != nullptr);
+  return Status::OK();
+}
 }
 }
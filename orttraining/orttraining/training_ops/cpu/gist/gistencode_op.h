@@ -14,5 +14,17 @@ class GistBinarizeEncoderOp final : public OpKernel {
   GistBinarizeEncoderOp(const OpKernelInfo& info) : OpKernel(info) {}
   Status Compute(OpKernelContext* context) const override;
 };
+
+class GistPack16EncoderOp final : public OpKernel {
+ public:
+  GistPack16EncoderOp(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class GistPack8EncoderOp final : public OpKernel {
+ public:
+  GistPack8EncoderOp(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
 }  // namespace contrib
 }  //namespace onnxruntime
\ No newline at end of file
@@ -84,6 +84,9 @@ NcclContext::NcclContext() {
   ORT_ENFORCE(ret.IsOK());
 
   MPI_Group_free(&mpi_world_group);
+
+  // Doesn't synchronize with the default stream, for the collectives to overlap with the computations
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&comm_stream_, cudaStreamNonBlocking));
 }
 
 ncclComm_t NcclContext::Comm(training::WorkerGroupType group_type) {
@@ -97,6 +100,8 @@ ncclComm_t NcclContext::Comm(training::WorkerGroupType group_type) {
 }
 
 NcclContext::~NcclContext() {
+  cudaStreamDestroy(comm_stream_);
+
   if (data_group_comm_ != nullptr) {
     ncclCommDestroy(data_group_comm_);
   }
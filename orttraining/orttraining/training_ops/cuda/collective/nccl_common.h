@@ -27,9 +27,15 @@ class NcclContext final {
     return training::DistributedRunContext::GroupSize(group_type);
   }
 
+  // The stream of the collectives overlapped with the computations on the default stream
+  cudaStream_t CommStream() const {
+    return comm_stream_;
+  }
+
  private:
   ncclComm_t data_group_comm_;
   ncclComm_t horizontal_group_comm_;
+  cudaStream_t comm_stream_;
 };
 
 // -----------------------------------------------------------------------
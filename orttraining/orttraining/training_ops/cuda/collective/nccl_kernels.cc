@@ -2,17 +2,38 @@
 // Licensed under the MIT License.
 
 #include "nccl_kernels.h"
+#include "quantized_allreduce_impl.h"
 
 namespace onnxruntime {
 namespace cuda {
 
+// Makes the work queued on stream from now on wait for the work queued on other_stream so far.
+static Status WaitForStream(cudaStream_t stream, cudaStream_t other_stream) {
+  cudaEvent_t event;
+  CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  // The event is released once it completes, even if it is destroyed before.
+  const bool waiting = CUDA_CALL(cudaEventRecord(event, other_stream)) && CUDA_CALL(cudaStreamWaitEvent(stream, event, 0));
+  CUDA_RETURN_IF_ERROR(cudaEventDestroy(event));
+  return waiting ? Status::OK() : Status(common::ONNXRUNTIME, common::FAIL, "Failed to synchronize the CUDA streams.");
+}
+
 NcclAllReduce::NcclAllReduce(const OpKernelInfo& info) : NcclKernel(info) {
+  int64_t use_comm_stream;
+  info.GetAttrOrDefault("use_comm_stream", &use_comm_stream, static_cast<int64_t>(0));
+  use_comm_stream_ = use_comm_stream != 0;
 }
 
 Status NcclAllReduce::ComputeInternal(OpKernelContext* context) const {
   cudaStream_t stream = nullptr;  // Default stream
   ncclComm_t comm = nccl_->Comm(group_type_);
 
+  if (use_comm_stream_) {
+    // Start once the inputs are computed, and leave the default stream to the following kernels.
+    // The outputs are aliases of the inputs, which stay allocated until NcclWait.
+    stream = nccl_->CommStream();
+    ORT_RETURN_IF_ERROR(WaitForStream(stream, nullptr));
+  }
+
   for (int i = 0; i < context->InputCount(); i++) {
     const Tensor* input_tensor = context->Input<Tensor>(i);
     auto onnx_type = input_tensor->DataType();
@@ -29,6 +50,85 @@ Status NcclAllReduce::ComputeInternal(OpKernelContext* context) const {
   return Status::OK();
 }
 
+NcclQuantizedAllReduce::NcclQuantizedAllReduce(const OpKernelInfo& info) : NcclKernel(info) {
+}
+
+template <typename T>
+Status NcclQuantizedAllReduce::ComputeImpl(const Tensor& input, const Tensor& error, Tensor& output, Tensor& error_out) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  cudaStream_t stream = nullptr;  // Default stream
+  ncclComm_t comm = nccl_->Comm(group_type_);
+  const int size = nccl_->Size(group_type_);
+
+  // The sum of the quantized values of all ranks must fit in int8.
+  const int levels = 127 / size;
+  ORT_RETURN_IF_NOT(levels > 0, "Quantized all-reduce supports at most 127 ranks, got ", size);
+
+  const size_t count = input.Shape().Size();
+  const size_t block_count = CeilDiv(count, kQuantizationBlockSize);
+  auto block_max_buffer = GetScratchBuffer<float>(block_count);
+  auto quantized_buffer = GetScratchBuffer<int8_t>(count);
+  float* block_max = block_max_buffer.get();
+  int8_t* quantized = quantized_buffer.get();
+
+  // All the ranks quantize with the same scales, so that the quantized values can be summed.
+  QuantizationBlockMaxImpl(
+      reinterpret_cast<const CudaT*>(input.Data<T>()), error.Data<float>(), block_max, count);
+  NCCL_RETURN_IF_ERROR(ncclAllReduce(block_max, block_max, block_count, ncclFloat, ncclMax, comm, stream));
+
+  QuantizeWithErrorFeedbackImpl(
+      reinterpret_cast<const CudaT*>(input.Data<T>()), error.Data<float>(), block_max, levels,
+      quantized, error_out.MutableData<float>(), count);
+  NCCL_RETURN_IF_ERROR(ncclAllReduce(quantized, quantized, count, ncclInt8, ncclSum, comm, stream));
+
+  DequantizeImpl(
+      quantized, block_max, levels, reinterpret_cast<CudaT*>(output.MutableData<T>()), count);
+
+  return Status::OK();
+}
+
+Status NcclQuantizedAllReduce::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* input_tensor = context->Input<Tensor>(0);
+  const Tensor* error_tensor = context->Input<Tensor>(1);
+  ORT_RETURN_IF_NOT(error_tensor->Shape().Size() == input_tensor->Shape().Size(),
+                    "The quantization error must have as many elements as the input.");
+
+  Tensor* output_tensor = context->Output(0, input_tensor->Shape());
+  Tensor* error_out_tensor = context->Output(1, error_tensor->Shape());
+  if (input_tensor->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  if (input_tensor->IsDataType<float>()) {
+    return ComputeImpl<float>(*input_tensor, *error_tensor, *output_tensor, *error_out_tensor);
+  } else if (input_tensor->IsDataType<MLFloat16>()) {
+    return ComputeImpl<MLFloat16>(*input_tensor, *error_tensor, *output_tensor, *error_out_tensor);
+  }
+
+  return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported input type for NcclQuantizedAllReduce.");
+}
+
+NcclWait::NcclWait(const OpKernelInfo& info) : NcclKernel(info) {
+}
+
+Status NcclWait::ComputeInternal(OpKernelContext* context) const {
+  ORT_RETURN_IF_ERROR(WaitForStream(nullptr, nccl_->CommStream()));
+
+  for (int i = 0; i < context->InputCount(); i++) {
+    const Tensor* input_tensor = context->Input<Tensor>(i);
+    Tensor* output_tensor = context->Output(i, input_tensor->Shape());
+
+    const void* input_data = input_tensor->DataRaw();
+    void* output_data = output_tensor->MutableDataRaw();
+    if (input_data != output_data) {
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_data, input_data, input_tensor->SizeInBytes(), cudaMemcpyDeviceToDevice));
+    }
+  }
+
+  return Status::OK();
+}
+
 NcclAllGather::NcclAllGather(const OpKernelInfo& info) : NcclKernel(info) {
 }
 
@@ -222,6 +322,26 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
     NcclAllReduce);
 
+ONNX_OPERATOR_KERNEL_EX(
+    NcclQuantizedAllReduce,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .Alias({{0, 0}, {1, 1}})
+        .TypeConstraint("T", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<MLFloat16>()}),
+    NcclQuantizedAllReduce);
+
+ONNX_OPERATOR_KERNEL_EX(
+    NcclWait,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .Alias(AliasRange(0, 1024))
+        .TypeConstraint("T", DataTypeImpl::AllIEEEFloatTensorTypes()),
+    NcclWait);
+
 ONNX_OPERATOR_KERNEL_EX(
     NcclAllGather,
     kMSDomain,
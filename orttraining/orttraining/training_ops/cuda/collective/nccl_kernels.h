@@ -12,6 +12,30 @@ class NcclAllReduce final : public NcclKernel {
  public:
   explicit NcclAllReduce(const OpKernelInfo& info);
 
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  bool use_comm_stream_;
+};
+
+// All-reduces a gradient quantized to 8 bits per element, and keeps the quantization error
+// to be added to the gradient of the next step
+class NcclQuantizedAllReduce final : public NcclKernel {
+ public:
+  explicit NcclQuantizedAllReduce(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  template <typename T>
+  Status ComputeImpl(const Tensor& input, const Tensor& error, Tensor& output, Tensor& error_out) const;
+};
+
+// Makes the default stream wait for the NCCL operations launched on the communication stream
+class NcclWait final : public NcclKernel {
+ public:
+  explicit NcclWait(const OpKernelInfo& info);
+
   Status ComputeInternal(OpKernelContext* context) const override;
 };
 
@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/training_ops/cuda/collective/quantized_allreduce_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+__global__ void _QuantizationBlockMax(
+    const T* input,
+    const float* error,
+    float* block_max,
+    CUDA_LONG N) {
+  __shared__ float shared_max[GridDim::maxThreadsPerBlock];
+
+  const CUDA_LONG block_start = static_cast<CUDA_LONG>(blockIdx.x) * kQuantizationBlockSize;
+  float thread_max = 0.f;
+  for (int i = threadIdx.x; i < kQuantizationBlockSize && block_start + i < N; i += blockDim.x) {
+    const float value = fabsf(static_cast<float>(input[block_start + i]) + error[block_start + i]);
+    // NaN is turned into infinity, which is kept by the maximum across the ranks.
+    thread_max = isnan(value) ? INFINITY : fmaxf(thread_max, value);
+  }
+  shared_max[threadIdx.x] = thread_max;
+  __syncthreads();
+
+  for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+    if (threadIdx.x < stride) {
+      shared_max[threadIdx.x] = fmaxf(shared_max[threadIdx.x], shared_max[threadIdx.x + stride]);
+    }
+    __syncthreads();
+  }
+
+  if (threadIdx.x == 0) {
+    block_max[blockIdx.x] = shared_max[0];
+  }
+}
+
+template <typename T>
+void QuantizationBlockMaxImpl(
+    const T* input,
+    const float* error,
+    float* block_max,
+    size_t count) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(count, kQuantizationBlockSize));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _QuantizationBlockMax<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      input,
+      error,
+      block_max,
+      N);
+}
+
+template <typename T>
+__global__ void _QuantizeWithErrorFeedback(
+    const T* input,
+    const float* error,
+    const float* block_max,
+    const float levels,
+    int8_t* quantized,
+    float* error_out,
+    CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  const float max = block_max[id / kQuantizationBlockSize];
+  const float value = static_cast<float>(input[id]) + error[id];
+
+  // Skip the non-finite steps without corrupting the error.
+  if (!isfinite(max) || max == 0.f) {
+    quantized[id] = 0;
+    error_out[id] = isfinite(max) ? value : error[id];
+    return;
+  }
+
+  const float q = fminf(fmaxf(rintf(value / max * levels), -levels), levels);
+  quantized[id] = static_cast<int8_t>(q);
+  error_out[id] = value - q * max / levels;
+}
+
+template <typename T>
+void QuantizeWithErrorFeedbackImpl(
+    const T* input,
+    const float* error,
+    const float* block_max,
+    int levels,
+    int8_t* quantized,
+    float* error_out,
+    size_t count) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _QuantizeWithErrorFeedback<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      input,
+      error,
+      block_max,
+      static_cast<float>(levels),
+      quantized,
+      error_out,
+      N);
+}
+
+template <typename T>
+__global__ void _Dequantize(
+    const int8_t* quantized,
+    const float* block_max,
+    const float levels,
+    T* output,
+    CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  const float max = block_max[id / kQuantizationBlockSize];
+  output[id] = static_cast<T>(isfinite(max) ? static_cast<float>(quantized[id]) * max / levels : max);
+}
+
+template <typename T>
+void DequantizeImpl(
+    const int8_t* quantized,
+    const float* block_max,
+    int levels,
+    T* output,
+    size_t count) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _Dequantize<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      quantized,
+      block_max,
+      static_cast<float>(levels),
+      output,
+      N);
+}
+
+#define SPECIALIZE_QUANTIZED_ALLREDUCE_IMPL(T)                                                                \
+  template void QuantizationBlockMaxImpl<T>(                                                                  \
+      const T* input, const float* error, float* block_max, size_t count);                                    \
+  template void QuantizeWithErrorFeedbackImpl<T>(                                                             \
+      const T* input, const float* error, const float* block_max, int levels, int8_t* quantized,              \
+      float* error_out, size_t count);                                                                        \
+  template void DequantizeImpl<T>(                                                                            \
+      const int8_t* quantized, const float* block_max, int levels, T* output, size_t count);
+
+SPECIALIZE_QUANTIZED_ALLREDUCE_IMPL(float)
+SPECIALIZE_QUANTIZED_ALLREDUCE_IMPL(half)
+
+}  // namespace cuda
+}  // namespace onnxruntime
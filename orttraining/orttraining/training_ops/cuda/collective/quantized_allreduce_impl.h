@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The number of consecutive elements quantized with the same scale.
+constexpr int kQuantizationBlockSize = 1024;
+
+// Computes the maximum absolute value of input + error in each block. Non-finite values yield an infinite maximum.
+template <typename T>
+void QuantizationBlockMaxImpl(
+    const T* input,
+    const float* error,
+    float* block_max,
+    size_t count);
+
+// Rounds input + error to an integer in [-levels, levels] relative to the maximum of its block,
+// and keeps the rounding error to be added to the next input.
+template <typename T>
+void QuantizeWithErrorFeedbackImpl(
+    const T* input,
+    const float* error,
+    const float* block_max,
+    int levels,
+    int8_t* quantized,
+    float* error_out,
+    size_t count);
+
+// Scales the quantized values back. Blocks with a non-finite maximum are set to the maximum.
+template <typename T>
+void DequantizeImpl(
+    const int8_t* quantized,
+    const float* block_max,
+    int levels,
+    T* output,
+    size_t count);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/training_ops/cuda/gist/gist.h"
+#include "orttraining/training_ops/cuda/gist/gist_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+#define REGISTER_GIST_BINARIZE_KERNEL_TYPED(T)                                              \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                            \
+      GistBinarizeEncoder,                                                                  \
+      kMSDomain,                                                                            \
+      1,                                                                                    \
+      T,                                                                                    \
+      kCudaExecutionProvider,                                                               \
+      KernelDefBuilder().Alias(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      GistBinarizeEncoderOp<T>);                                                            \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                            \
+      GistBinarizeDecoder,                                                                  \
+      kMSDomain,                                                                            \
+      1,                                                                                    \
+      T,                                                                                    \
+      kCudaExecutionProvider,                                                               \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),             \
+      GistBinarizeDecoderOp<T>);
+
+REGISTER_GIST_BINARIZE_KERNEL_TYPED(MLFloat16)
+REGISTER_GIST_BINARIZE_KERNEL_TYPED(float)
+REGISTER_GIST_BINARIZE_KERNEL_TYPED(double)
+
+template <typename T>
+Status GistBinarizeEncoderOp<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const Tensor& X = *context->Input<Tensor>(0);
+  ORT_ENFORCE(context->Output(0, X.Shape()) != nullptr);
+  Tensor& Y1 = *context->Output(1, X.Shape());
+  GistBinarizeEncoderImpl(reinterpret_cast<const CudaT*>(X.Data<T>()), Y1.MutableData<bool>(), X.Shape().Size());
+  return Status::OK();
+}
+
+template <typename T>
+Status GistBinarizeDecoderOp<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const Tensor& X = *context->Input<Tensor>(1);
+  Tensor& Y = *context->Output(0, X.Shape());
+  GistBinarizeDecoderImpl(X.Data<bool>(), reinterpret_cast<CudaT*>(Y.MutableData<T>()), X.Shape().Size());
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack16Encoder,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder().Alias(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    GistPack16EncoderOp);
+
+Status GistPack16EncoderOp::ComputeInternal(OpKernelContext* context) const {
+  const Tensor& X = *context->Input<Tensor>(0);
+  ORT_ENFORCE(context->Output(0, X.Shape()) != nullptr);
+  Tensor& Y1 = *context->Output(1, X.Shape());
+  GistPack16EncoderImpl(X.Data<float>(), reinterpret_cast<half*>(Y1.MutableData<MLFloat16>()), X.Shape().Size());
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    GistPack16Decoder,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    GistPack16DecoderOp);
+
+Status GistPack16DecoderOp::ComputeInternal(OpKernelContext* context) const {
+  const Tensor& X = *context->Input<Tensor>(1);
+  Tensor& Y = *context->Output(0, X.Shape());
+  GistPack16DecoderImpl(reinterpret_cast<const half*>(X.Data<MLFloat16>()), Y.MutableData<float>(), X.Shape().Size());
+  return Status::OK();
+}
+
+#define REGISTER_GIST_PACK8_KERNEL_TYPED(T)                                                 \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                            \
+      GistPack8Encoder,                                                                     \
+      kMSDomain,                                                                            \
+      1,                                                                                    \
+      T,                                                                                    \
+      kCudaExecutionProvider,                                                               \
+      KernelDefBuilder().Alias(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      GistPack8EncoderOp<T>);                                                               \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                            \
+      GistPack8Decoder,                                                                     \
+      kMSDomain,                                                                            \
+      1,                                                                                    \
+      T,                                                                                    \
+      kCudaExecutionProvider,                                                               \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),             \
+      GistPack8DecoderOp<T>);
+
+REGISTER_GIST_PACK8_KERNEL_TYPED(MLFloat16)
+REGISTER_GIST_PACK8_KERNEL_TYPED(float)
+
+template <typename T>
+Status GistPack8EncoderOp<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const Tensor& X = *context->Input<Tensor>(0);
+  ORT_ENFORCE(context->Output(0, X.Shape()) != nullptr);
+  Tensor& Y1 = *context->Output(1, X.Shape());
+  GistPack8EncoderImpl(reinterpret_cast<const CudaT*>(X.Data<T>()), Y1.MutableData<uint8_t>(), X.Shape().Size());
+  return Status::OK();
+}
+
+template <typename T>
+Status GistPack8DecoderOp<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const Tensor& X = *context->Input<Tensor>(1);
+  Tensor& Y = *context->Output(0, X.Shape());
+  GistPack8DecoderImpl(X.Data<uint8_t>(), reinterpret_cast<CudaT*>(Y.MutableData<T>()), X.Shape().Size());
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cuda_fp16.h>
+#include "orttraining/training_ops/cuda/gist/gist_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+__device__ __forceinline__ bool _IsPositive(T value) {
+  return value > T(0);
+}
+
+template <>
+__device__ __forceinline__ bool _IsPositive(half value) {
+  return __half2float(value) > 0.f;
+}
+
+template <typename T>
+__global__ void _GistBinarizeEncoder(const T* input, bool* output, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  output[id] = _IsPositive(input[id]);
+}
+
+template <typename T>
+void GistBinarizeEncoderImpl(const T* input, bool* output, size_t count) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _GistBinarizeEncoder<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input, output, N);
+}
+
+template <typename T>
+__global__ void _GistBinarizeDecoder(const bool* input, T* output, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  output[id] = input[id] ? T(1.f) : T(0.f);
+}
+
+template <typename T>
+void GistBinarizeDecoderImpl(const bool* input, T* output, size_t count) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _GistBinarizeDecoder<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input, output, N);
+}
+
+#define SPECIALIZE_GIST_BINARIZE_IMPL(T)                                            \
+  template void GistBinarizeEncoderImpl(const T* input, bool* output, size_t count); \
+  template void GistBinarizeDecoderImpl(const bool* input, T* output, size_t count);
+
+SPECIALIZE_GIST_BINARIZE_IMPL(half)
+SPECIALIZE_GIST_BINARIZE_IMPL(float)
+SPECIALIZE_GIST_BINARIZE_IMPL(double)
+
+__global__ void _GistPack16Encoder(const float* input, half* output, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  output[id] = __float2half_rn(input[id]);
+}
+
+void GistPack16EncoderImpl(const float* input, half* output, size_t count) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _GistPack16Encoder<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input, output, N);
+}
+
+__global__ void _GistPack16Decoder(const half* input, float* output, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  output[id] = __half2float(input[id]);
+}
+
+void GistPack16DecoderImpl(const half* input, float* output, size_t count) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _GistPack16Decoder<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input, output, N);
+}
+
+template <typename T>
+__global__ void _GistPack8Encoder(const T* input, uint8_t* output, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  const unsigned short h = __half_as_ushort(__float2half_rn(static_cast<float>(input[id])));
+  // NaN must not be rounded to infinity.
+  if ((h & 0x7C00) == 0x7C00 && (h & 0x03FF) != 0) {
+    output[id] = static_cast<uint8_t>((h >> 8) | 0x02);
+  } else {
+    output[id] = static_cast<uint8_t>((h + 0x7F + ((h >> 8) & 1)) >> 8);
+  }
+}
+
+template <typename T>
+void GistPack8EncoderImpl(const T* input, uint8_t* output, size_t count) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _GistPack8Encoder<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input, output, N);
+}
+
+template <typename T>
+__global__ void _GistPack8Decoder(const uint8_t* input, T* output, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  output[id] = static_cast<T>(__half2float(__ushort_as_half(static_cast<unsigned short>(input[id] << 8))));
+}
+
+template <typename T>
+void GistPack8DecoderImpl(const uint8_t* input, T* output, size_t count) {
+  int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _GistPack8Decoder<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input, output, N);
+}
+
+#define SPECIALIZE_GIST_PACK8_IMPL(T)                                                 \
+  template void GistPack8EncoderImpl(const T* input, uint8_t* output, size_t count); \
+  template void GistPack8DecoderImpl(const uint8_t* input, T* output, size_t count);
+
+SPECIALIZE_GIST_PACK8_IMPL(half)
+SPECIALIZE_GIST_PACK8_IMPL(float)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Stores whether each element is positive.
+template <typename T>
+void GistBinarizeEncoderImpl(const T* input, bool* output, size_t count);
+
+template <typename T>
+void GistBinarizeDecoderImpl(const bool* input, T* output, size_t count);
+
+void GistPack16EncoderImpl(const float* input, half* output, size_t count);
+
+void GistPack16DecoderImpl(const half* input, float* output, size_t count);
+
+// Stores the high byte of the float16 value of each element, rounded to nearest even.
+template <typename T>
+void GistPack8EncoderImpl(const T* input, uint8_t* output, size_t count);
+
+template <typename T>
+void GistPack8DecoderImpl(const uint8_t* input, T* output, size_t count);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -186,5 +186,116 @@ Status BiasDropout::ComputeInternal(OpKernelContext* context) const {
   return t_disp.Invoke(GetDeviceProp(), N, fdm_dim, ratio_data, generator, *X, *bias, residual, *Y, mask_data);
 }
 
+ONNX_OPERATOR_KERNEL_EX(
+    BiasDropoutLayerNormalization,
+    kMSDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", std::vector<MLDataType>{DataTypeImpl::GetTensorType<float>(),
+                                                     DataTypeImpl::GetTensorType<MLFloat16>()})
+        .TypeConstraint("U", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::AllIEEEFloatTensorTypes())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<bool>())
+        .InputMemoryType<OrtMemTypeCPUInput>(5)
+        .InputMemoryType<OrtMemTypeCPUInput>(6),
+    BiasDropoutLayerNorm);
+
+template <typename T>
+struct BiasDropoutLayerNormComputeImpl {
+  void operator()(const int64_t n1,
+                  const int n2,
+                  const float ratio_data,
+                  PhiloxGenerator& generator,
+                  const Tensor& X,
+                  const Tensor& bias,
+                  const Tensor* residual,
+                  const Tensor& scale,
+                  const Tensor& B,
+                  const float epsilon,
+                  Tensor& Y,
+                  float* mean_data,
+                  float* inv_std_var_data,
+                  bool* mask_data,
+                  Tensor* dropout_output) const {
+    typedef typename ToCudaType<T>::MappedType CudaT;
+
+    BiasDropoutLayerNormKernelImpl<CudaT>(
+        n1, n2, ratio_data, generator,
+        reinterpret_cast<const CudaT*>(X.template Data<T>()),
+        reinterpret_cast<const CudaT*>(bias.template Data<T>()),
+        residual != nullptr ? reinterpret_cast<const CudaT*>(residual->template Data<T>()) : nullptr,
+        reinterpret_cast<const CudaT*>(scale.template Data<T>()),
+        reinterpret_cast<const CudaT*>(B.template Data<T>()),
+        epsilon,
+        reinterpret_cast<CudaT*>(Y.template MutableData<T>()),
+        mean_data, inv_std_var_data, mask_data,
+        dropout_output != nullptr ? reinterpret_cast<CudaT*>(dropout_output->template MutableData<T>()) : nullptr);
+  }
+};
+
+Status BiasDropoutLayerNorm::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  ORT_RETURN_IF_NOT(X, "X Input is not available.");
+  const TensorShape& x_shape = X->Shape();
+  ORT_RETURN_IF_NOT(x_shape.NumDimensions() >= 1, "X Input is expected to have at least 1 dimension.");
+  const int64_t dim = x_shape.GetDims().back();
+
+  // bias, scale and B are all vectors over the normalized last dimension
+  const Tensor* bias = context->Input<Tensor>(1);
+  const Tensor* scale = context->Input<Tensor>(2);
+  const Tensor* B = context->Input<Tensor>(3);
+  for (const Tensor* vector_input : {bias, scale, B}) {
+    ORT_RETURN_IF_NOT(vector_input != nullptr && vector_input->Shape().NumDimensions() == 1 &&
+                          vector_input->Shape()[0] == dim,
+                      "bias, scale and B are expected to be 1D tensors matching the last dimension of the input.");
+  }
+
+  const Tensor* residual = context->Input<Tensor>(4);
+  if (residual != nullptr && residual->Shape() != x_shape) {
+    return Status(common::ONNXRUNTIME, common::FAIL, "Residual input shape does not match X input shape.");
+  }
+
+  //Get the ratio_data
+  float ratio_data = default_ratio_;
+  auto ratio = context->Input<Tensor>(5);
+  if (ratio) {
+    utils::MLTypeCallDispatcher<GetRatioDataImpl, float, MLFloat16, double> t_disp(ratio->GetElementType());
+    t_disp.Invoke(ratio, ratio_data);
+  }
+
+  //Check for inference mode.
+  const Tensor* training_mode = context->Input<Tensor>(6);
+  if (training_mode == nullptr || !*training_mode->Data<bool>()) {
+    ratio_data = 0.0f;
+  }
+
+  std::vector<int64_t> mean_inv_std_var_dims = x_shape.GetDims();
+  mean_inv_std_var_dims.back() = 1;
+  const TensorShape mean_inv_std_var_shape(mean_inv_std_var_dims);
+
+  Tensor* Y = context->Output(0, x_shape);
+  Tensor* mean = context->Output(1, mean_inv_std_var_shape);
+  Tensor* inv_std_var = context->Output(2, mean_inv_std_var_shape);
+  Tensor* mask = context->Output(3, x_shape);
+  Tensor* dropout_output = context->Output(4, x_shape);
+
+  if (x_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  PhiloxGenerator& generator = generator_ ? *generator_ : PhiloxGenerator::Default();
+
+  utils::MLTypeCallDispatcher<BiasDropoutLayerNormComputeImpl, float, MLFloat16> t_disp(X->GetElementType());
+  t_disp.Invoke(x_shape.SizeToDimension(x_shape.NumDimensions() - 1), gsl::narrow<int>(dim), ratio_data, generator,
+                *X, *bias, residual, *scale, *B, epsilon_, *Y,
+                mean != nullptr ? mean->MutableData<float>() : nullptr,
+                inv_std_var != nullptr ? inv_std_var->MutableData<float>() : nullptr,
+                mask != nullptr ? mask->MutableData<bool>() : nullptr,
+                dropout_output);
+
+  return Status::OK();
+}
+
 }  // namespace cuda
 }  // namespace onnxruntime
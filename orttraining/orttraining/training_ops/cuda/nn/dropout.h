@@ -36,5 +36,23 @@ class BiasDropout final : public CudaKernel {
   static constexpr float default_ratio_ = 0.5f;
 };
 
+class BiasDropoutLayerNorm final : public CudaKernel {
+ public:
+  BiasDropoutLayerNorm(const OpKernelInfo& info) : CudaKernel(info) {
+    int64_t seed = 0;
+    if (info.GetAttr<int64_t>("seed", &seed).IsOK()) {
+      generator_ = onnxruntime::make_unique<PhiloxGenerator>(static_cast<uint64_t>(seed));
+    }
+    epsilon_ = info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  mutable std::unique_ptr<PhiloxGenerator> generator_;
+  float epsilon_;
+  static constexpr float default_ratio_ = 0.5f;
+};
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -19,6 +19,7 @@
 #include "core/providers/cuda/cu_inc/common.cuh"
 #include "orttraining/training_ops/cuda/nn/dropout_impl.h"
 #include <curand_kernel.h>
+#include <cub/cub.cuh>
 #include <algorithm>
 
 namespace onnxruntime {
@@ -170,5 +171,160 @@ SPECIALIZED_BIAS_DROPOUT_IMPL(double)
 SPECIALIZED_BIAS_DROPOUT_IMPL(half)
 
 
+constexpr int BIAS_DROPOUT_LAYER_NORM_THREADS = 256;
+
+// One block per row: the dropout output of the row is written once and read back by the same threads for the mean,
+// the variance and the normalization, so the row stays in cache between the passes and no extra kernel is launched.
+template <typename T, bool has_residual>
+__global__ void BiasDropoutLayerNormKernel(
+    const int n2,
+    const float ratio,
+    const std::pair<uint64_t, uint64_t> seeds,
+    const T* X_data,
+    const T* bias_data,
+    const T* residual_data,
+    const T* scale_data,
+    const T* B_data,
+    const float epsilon,
+    T* Y_data,
+    float* mean_data,
+    float* inv_std_var_data,
+    bool* mask_data,
+    T* dropout_output_data) {
+  using BlockReduce = cub::BlockReduce<float, BIAS_DROPOUT_LAYER_NORM_THREADS>;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+  __shared__ float mean;
+  __shared__ float inv_std_var;
+
+  const float p = 1.0f - ratio;
+  const float scale = 1.0f / p;
+  const int64_t offset = static_cast<int64_t>(blockIdx.x) * n2;
+
+  curandStatePhilox4_32_10_t state;
+  if (ratio > 0.0f) {
+    curand_init(seeds.first, static_cast<uint64_t>(blockIdx.x) * blockDim.x + threadIdx.x, seeds.second, &state);
+  }
+
+  float sum = 0.0f;
+  for (int i = threadIdx.x; i < n2; i += BIAS_DROPOUT_LAYER_NORM_THREADS * UNROLL) {
+    // nothing is dropped without a ratio
+    const float4 rand = ratio > 0.0f ? curand_uniform4(&state) : make_float4(0.0f, 0.0f, 0.0f, 0.0f);
+
+#pragma unroll
+    for (int u = 0; u < UNROLL; u++) {
+      const int li = i + u * BIAS_DROPOUT_LAYER_NORM_THREADS;
+      if (li < n2) {
+        const int64_t idx = offset + li;
+        const bool mask = (&rand.x)[u] < p;
+        float value = (float(X_data[idx]) + float(bias_data[li])) * mask * scale;
+        if (has_residual) {
+          value += float(residual_data[idx]);
+        }
+        if (mask_data != nullptr) {
+          mask_data[idx] = mask;
+        }
+
+        // normalize the rounded values, as LayerNormalization would after BiasDropout
+        const T dropout_output = T(value);
+        dropout_output_data[idx] = dropout_output;
+        sum += float(dropout_output);
+      }
+    }
+  }
+
+  const float row_sum = BlockReduce(temp_storage).Sum(sum);
+  if (threadIdx.x == 0) {
+    mean = row_sum / n2;
+  }
+  __syncthreads();
+
+  float sum_of_squares = 0.0f;
+  for (int i = threadIdx.x; i < n2; i += BIAS_DROPOUT_LAYER_NORM_THREADS) {
+    const float diff = float(dropout_output_data[offset + i]) - mean;
+    sum_of_squares += diff * diff;
+  }
+
+  const float row_sum_of_squares = BlockReduce(temp_storage).Sum(sum_of_squares);
+  if (threadIdx.x == 0) {
+    inv_std_var = rsqrtf(row_sum_of_squares / n2 + epsilon);
+    if (mean_data != nullptr) {
+      mean_data[blockIdx.x] = mean;
+    }
+    if (inv_std_var_data != nullptr) {
+      inv_std_var_data[blockIdx.x] = inv_std_var;
+    }
+  }
+  __syncthreads();
+
+  for (int i = threadIdx.x; i < n2; i += BIAS_DROPOUT_LAYER_NORM_THREADS) {
+    const int64_t idx = offset + i;
+    Y_data[idx] = T(float(scale_data[i]) * (float(dropout_output_data[idx]) - mean) * inv_std_var + float(B_data[i]));
+  }
+}
+
+template <typename T>
+void BiasDropoutLayerNormKernelImpl(
+    const int64_t n1,
+    const int n2,
+    const float ratio,
+    PhiloxGenerator& generator,
+    const T* X_data,
+    const T* bias_data,
+    const T* residual_data,
+    const T* scale_data,
+    const T* B_data,
+    const float epsilon,
+    T* Y_data,
+    float* mean_data,
+    float* inv_std_var_data,
+    bool* mask_data,
+    T* dropout_output_data) {
+  // the dropout output is normalized in place when it isn't requested
+  if (dropout_output_data == nullptr) {
+    dropout_output_data = Y_data;
+  }
+
+  std::pair<uint64_t, uint64_t> seeds{};
+  if (ratio > 0.0f) {
+    // Compute the number of random numbers generated by each thread, and increment philox generator offset by that amount.
+    const uint64_t counter_offset = static_cast<uint64_t>(
+        ((n2 - 1) / (BIAS_DROPOUT_LAYER_NORM_THREADS * UNROLL) + 1) * UNROLL);
+    seeds = generator.NextPhiloxSeeds(counter_offset);
+  }
+
+  const int grid_size = static_cast<int>(n1);
+  if (residual_data == nullptr) {
+    BiasDropoutLayerNormKernel<T, false><<<grid_size, BIAS_DROPOUT_LAYER_NORM_THREADS, 0>>>(
+        n2, ratio, seeds, X_data, bias_data, residual_data, scale_data, B_data, epsilon,
+        Y_data, mean_data, inv_std_var_data, mask_data, dropout_output_data);
+  } else {
+    BiasDropoutLayerNormKernel<T, true><<<grid_size, BIAS_DROPOUT_LAYER_NORM_THREADS, 0>>>(
+        n2, ratio, seeds, X_data, bias_data, residual_data, scale_data, B_data, epsilon,
+        Y_data, mean_data, inv_std_var_data, mask_data, dropout_output_data);
+  }
+}
+
+#define SPECIALIZED_BIAS_DROPOUT_LAYER_NORM_IMPL(T) \
+  template void BiasDropoutLayerNormKernelImpl(    \
+      const int64_t n1,                            \
+      const int n2,                                \
+      const float ratio,                           \
+      PhiloxGenerator& generator,                  \
+      const T* X_data,                             \
+      const T* bias_data,                          \
+      const T* residual_data,                      \
+      const T* scale_data,                         \
+      const T* B_data,                             \
+      const float epsilon,                         \
+      T* Y_data,                                   \
+      float* mean_data,                            \
+      float* inv_std_var_data,                     \
+      bool* mask_data,                             \
+      T* dropout_output_data);
+
+SPECIALIZED_BIAS_DROPOUT_LAYER_NORM_IMPL(float)
+SPECIALIZED_BIAS_DROPOUT_LAYER_NORM_IMPL(half)
+
+
 }  // namespace cuda
 }  // namespace onnxruntime
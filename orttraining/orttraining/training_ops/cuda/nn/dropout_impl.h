@@ -29,5 +29,23 @@ void BiasDropoutKernelImpl(
   T* Y_data,
   bool* mask_data);
 
+template <typename T>
+void BiasDropoutLayerNormKernelImpl(
+  const int64_t n1,
+  const int n2,
+  const float ratio,
+  PhiloxGenerator& generator,
+  const T* X_data,
+  const T* bias_data,
+  const T* residual_data,
+  const T* scale_data,
+  const T* B_data,
+  const float epsilon,
+  T* Y_data,
+  float* mean_data,
+  float* inv_std_var_data,
+  bool* mask_data,
+  T* dropout_output_data);
+
 }  // namespace cuda
 }  // namespace onnxruntime
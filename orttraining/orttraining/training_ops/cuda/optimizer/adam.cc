@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <map>
+#include <tuple>
 #include "core/providers/cuda/cuda_allocator.h"
 #include "core/providers/cuda/reduction/reduction_functions.h"
 #include "core/providers/cuda/math/binary_elementwise_ops.h"
@@ -149,5 +151,178 @@ Status AdamOptimizer<T1, T2, T3, T4, T_GRAD, T_GRAD_NORM>::ComputeInternal(OpKer
   return Status::OK();
 }
 
+#define REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(T1, T2, T3, T4, T_GRAD_NORM)           \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                      \
+      MultiTensorAdamOptimizer,                                                       \
+      kMSDomain,                                                                      \
+      1,                                                                              \
+      T1##_##T2##_##T3##_##T4##_##T_GRAD_NORM,                                        \
+      kCudaExecutionProvider,                                                         \
+      KernelDefBuilder()                                                              \
+          .Alias(GenerateMultiTensorOptimizerAliasMapping())                          \
+          .InputMemoryType<OrtMemTypeCPUInput>(0)   /* Keep do_update in CPU */       \
+          .InputMemoryType<OrtMemTypeCPUInput>(4)   /* Keep step count in CPU */      \
+          .OutputMemoryType<OrtMemTypeCPUOutput>(0) /* Keep step count in CPU */      \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<T1>())                    \
+          .TypeConstraint("T2", DataTypeImpl::GetTensorType<T2>())                    \
+          .TypeConstraint("T3", DataTypeImpl::GetTensorType<T3>())                    \
+          .TypeConstraint("T4", DataTypeImpl::GetTensorType<T4>())                    \
+          .TypeConstraint("T_FP16", DataTypeImpl::GetTensorType<MLFloat16>())         \
+          .TypeConstraint("T_GRAD_NORM", DataTypeImpl::GetTensorType<T_GRAD_NORM>()), \
+      MultiTensorAdamOptimizer<T1, T2, T3, T4, T_GRAD_NORM>);
+
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, float, float, float, float)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, float, MLFloat16, float, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, float, MLFloat16, float, float)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, float, MLFloat16, MLFloat16, MLFloat16)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, float, MLFloat16, MLFloat16, float)
+REGISTER_MULTI_TENSOR_ADAM_KERNEL_TYPED(float, float, float, MLFloat16, float)
+
+template <typename T1, typename T2, typename T3, typename T4, typename T_GRAD_NORM>
+Status MultiTensorAdamOptimizer<T1, T2, T3, T4, T_GRAD_NORM>::ComputeInternal(OpKernelContext* ctx) const {
+  typedef typename ToCudaType<T1>::MappedType CudaT1;
+  typedef typename ToCudaType<T2>::MappedType CudaT2;
+  typedef typename ToCudaType<T3>::MappedType CudaT3;
+  typedef typename ToCudaType<T4>::MappedType CudaT4;
+  typedef typename ToCudaType<T_GRAD_NORM>::MappedType CudaT_GRAD_NORM;
+
+  constexpr int non_grouped_input_count = 5;
+  constexpr int input_group_size = 5;
+  constexpr int output_group_size = 5;
+  constexpr int non_grouped_output_count = 1;
+  const int grouped_input_tensor_count = ctx->InputCount() - non_grouped_input_count;
+  const int grouped_output_tensor_count = ctx->OutputCount() - non_grouped_output_count;
+
+  // Inputs after the first non_grouped_input_count ones are repeated sequence of [w, g, m1, m2, w_fp16]
+  // and outputs after the step count are repeated sequence of [w_new, g_new, m1_new, m2_new, w_fp16_new].
+  ORT_ENFORCE(
+      grouped_input_tensor_count > 0 && grouped_input_tensor_count % input_group_size == 0,
+      "Input count must be ", non_grouped_input_count, " + ", input_group_size,
+      " x (number of weights to optimize).");
+  ORT_ENFORCE(
+      grouped_input_tensor_count / input_group_size == (grouped_output_tensor_count + output_group_size - 1) / output_group_size,
+      "Input and output tensor counts are not aligned. Please check MultiTensorAdamOptimizer's input and output lists.");
+
+  const int group_count = grouped_input_tensor_count / input_group_size;
+  ORT_ENFORCE(alpha_.size() >= static_cast<size_t>(group_count));
+  ORT_ENFORCE(beta_.size() >= static_cast<size_t>(group_count));
+  ORT_ENFORCE(lambda_.size() >= static_cast<size_t>(group_count));
+  ORT_ENFORCE(epsilon_.size() >= static_cast<size_t>(group_count));
+
+  // If gradient norm is not finite, we copy inputs to outputs directly.
+  const Tensor* update_signal_tensor = ctx->Input<Tensor>(0);
+  if (update_signal_tensor != nullptr && !*update_signal_tensor->template Data<bool>()) {
+    return copy_inputs_to_outputs<T2, T3, T4>(
+        ctx,
+        non_grouped_input_count,
+        non_grouped_output_count,
+        group_count,
+        input_group_size,
+        output_group_size);
+  }
+
+  const Tensor* loss_scale_tensor = ctx->Input<Tensor>(1);
+  const CudaT2* loss_scale_data = loss_scale_tensor != nullptr
+                                      ? reinterpret_cast<const CudaT2*>(loss_scale_tensor->template Data<T2>())
+                                      : nullptr;
+  const Tensor* g_norm_tensor = ctx->Input<Tensor>(2);
+  const CudaT_GRAD_NORM* g_norm_data = g_norm_tensor != nullptr
+                                           ? reinterpret_cast<const CudaT_GRAD_NORM*>(g_norm_tensor->template Data<T_GRAD_NORM>())
+                                           : nullptr;
+  const CudaT1* eta_data = reinterpret_cast<const CudaT1*>(ctx->Input<Tensor>(3)->template Data<T1>());
+  const Tensor* step_tensor = ctx->Input<Tensor>(4);
+  const int64_t step = step_tensor != nullptr ? *step_tensor->template Data<int64_t>() : 0;
+
+  // Bucketize tensor groups by the associated optimizer configuration.
+  // If two tensor groups use different "alpha", they should be put into two distinct buckets.
+  constexpr int tensor_count_per_group = 7;
+  std::map<std::tuple<float, float, float, float>, std::vector<std::vector<void*>>> buckets;
+  std::map<std::tuple<float, float, float, float>, std::vector<int>> tensor_sizes_in_buckets;
+  for (int group_index = 0; group_index < group_count; ++group_index) {
+    const int input_start_index = non_grouped_input_count + group_index * input_group_size;
+    const Tensor* w = ctx->Input<Tensor>(input_start_index);
+    const Tensor* g = ctx->Input<Tensor>(input_start_index + 1);
+    const Tensor* m1 = ctx->Input<Tensor>(input_start_index + 2);
+    const Tensor* m2 = ctx->Input<Tensor>(input_start_index + 3);
+    const Tensor* w_fp16 = ctx->Input<Tensor>(input_start_index + 4);
+
+    const int output_start_index = non_grouped_output_count + group_index * output_group_size;
+    Tensor* w_new = ctx->Output(output_start_index, w->Shape());
+    Tensor* g_new = ctx->Output(output_start_index + 1, g->Shape());
+    Tensor* m1_new = ctx->Output(output_start_index + 2, m1->Shape());
+    Tensor* m2_new = ctx->Output(output_start_index + 3, m2->Shape());
+    Tensor* w_fp16_new = w_fp16 != nullptr ? ctx->Output(output_start_index + 4, w_fp16->Shape()) : nullptr;
+
+    // TODO: temporary hack until View is improved (it doesn't work with Alias)
+    if (w_new != nullptr)
+      w_new->SetByteOffset(w->ByteOffset());
+    if (g_new != nullptr)
+      g_new->SetByteOffset(g->ByteOffset());
+    if (w_fp16_new != nullptr)
+      w_fp16_new->SetByteOffset(w_fp16->ByteOffset());
+
+    check_inputs_and_outputs(w, g, m1, m2, w_fp16, w_new, g_new, m1_new, m2_new, w_fp16_new);
+
+    // The index in CUDA system is 32-bit integer.
+    ORT_ENFORCE(
+        w->Shape().Size() <
+        static_cast<int64_t>(std::numeric_limits<int>::max()));
+    if (w->Shape().Size() == 0) {
+      continue;
+    }
+
+    // The functor updates the momentums in place, so start from their current values.
+    ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<T4>(*m1, *m1_new));
+    ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<T4>(*m2, *m2_new));
+
+    std::vector<void*> ptrs(tensor_count_per_group);
+    ptrs[0] = const_cast<T2*>(w->template Data<T2>());  // weight tensor
+    ptrs[1] = const_cast<T3*>(g->template Data<T3>());  // gradient
+    ptrs[2] = m1_new->template MutableData<T4>();       // 1st momentum, updated in place
+    ptrs[3] = m2_new->template MutableData<T4>();       // 2nd momentum, updated in place
+    ptrs[4] = w_new != nullptr ? w_new->template MutableData<T2>() : nullptr;            // new weight tensor
+    ptrs[5] = g_new != nullptr ? g_new->template MutableData<T3>() : nullptr;            // new gradient tensor
+    ptrs[6] = w_fp16_new != nullptr ? w_fp16_new->template MutableData<MLFloat16>() : nullptr;  // new half-precision weight tensor
+
+    auto key = std::make_tuple(alpha_[group_index], beta_[group_index], lambda_[group_index], epsilon_[group_index]);
+    buckets[key].push_back(ptrs);
+    tensor_sizes_in_buckets[key].push_back(static_cast<int>(w->Shape().Size()));
+  }
+
+  for (auto& pair : buckets) {
+    const auto key = pair.first;
+    float alpha = 0.f, beta = 0.f, lambda = 0.f, epsilon = 0.f;
+    std::tie(alpha, beta, lambda, epsilon) = key;
+
+    // If bias correction coefficients are set to 1s, it's equivalent to disabling bias correction.
+    const float alpha_correction =
+        do_bias_correction_ ? onnxruntime::contrib::compute_bias_correction_coefficient(alpha, step) : 1.f;
+    const float beta_correction =
+        do_bias_correction_ ? onnxruntime::contrib::compute_bias_correction_coefficient(beta, step) : 1.f;
+
+    typedef AdamMultiTensorFunctor<CudaT1, CudaT2, CudaT3, CudaT4, CudaT_GRAD_NORM> TFunctor;
+    TFunctor functor;
+
+    launch_multi_tensor_functor<tensor_count_per_group, TFunctor, const CudaT1*, const CudaT2*, const CudaT_GRAD_NORM*,
+                                CudaT4, CudaT4, CudaT4, CudaT4, CudaT4, CudaT4, int64_t>(
+        2048 * 32,
+        tensor_sizes_in_buckets[key],
+        pair.second,
+        functor,
+        eta_data, loss_scale_data, g_norm_data,
+        CudaT4(alpha), CudaT4(beta), CudaT4(lambda), CudaT4(epsilon),
+        CudaT4(alpha_correction), CudaT4(beta_correction),
+        weight_decay_mode_);
+  }
+
+  if (step_tensor != nullptr) {
+    Tensor* step_tensor_new = ctx->Output(0, step_tensor->Shape());
+    ORT_ENFORCE(step_tensor_new != nullptr, "Step tensor (input) and updated step tensor (output) must be specified together.");
+    *step_tensor_new->template MutableData<int64_t>() = step + 1;
+  }
+
+  return Status::OK();
+}
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -9,69 +9,88 @@
 
 namespace onnxruntime {
 namespace cuda {
-template <typename T1, typename T3, typename T4, typename T_GRAD, typename T_GRAD_NORM>
-__global__ void _AdamOptimizer_mode0(
-    const T1* eta,
-    const T3* weights,
-    const T_GRAD* grads,
-    const T4* moment_1,
-    const T4* moment_2,
-    const T3* loss_scale,
-    const T_GRAD_NORM* grad_norm,
+// Currently two modes of Adamw are supported:
+// Mode 0: Pytorch https://pytorch.org/docs/stable/_modules/torch/optim/adamw.html#AdamW,
+//         bias correction is applied on m and v individually,
+//         weight decay is applied before weight is updated.
+// Mode 1: Huggingface https://huggingface.co/transformers/_modules/transformers/optimization.html#AdamW.,
+//         bias correction is applied on learning rate,
+//         weight decay is applied after weight is updated.
+template <typename T1, typename T3, typename T4, typename T_GRAD>
+__device__ __forceinline__ void _AdamUpdateRule(
+    const int64_t weight_decay_mode,
+    const T1 eta,
+    const T3 w,
+    const T_GRAD g,
+    const T4 m1,
+    const T4 m2,
+    const T4 actual_scale,
     const T4 alpha,
     const T4 beta,
     const T4 lambda,
     const T4 epsilon,
     const T4 alpha_correction,
     const T4 beta_correction,
-    T4* moment_1_out,
-    T4* moment_2_out,
-    T3* weights_out,
-    T_GRAD* grads_out,
-    half* fp16_weights_out,
-    CUDA_LONG N) {
-  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
-  const T4 actual_scale = _ComputeGradScale<T3, T_GRAD_NORM, T4>(loss_scale, grad_norm);
-
+    T4& m1_new,
+    T4& m2_new,
+    T3* w_new,
+    T_GRAD* g_new,
+    half* w_fp16_new) {
   // Gradient scaling/clipping.
-  const T4 g = T4(grads[id]) / actual_scale;
+  const T4 g_scaled = T4(g) / actual_scale;
   // A shared constant.
   const T4 one = T4(1.0f);
 
   // Compute exponentially-averaged historical gradient.
-  const T4 m1o = alpha * moment_1[id] + (one - alpha) * g;
-  const T4 m1o_corrected = m1o / alpha_correction;
+  const T4 m1o = alpha * m1 + (one - alpha) * g_scaled;
 
   // Compute exponentially-averaged historical squared gradient.
-  const T4 m2o = beta * moment_2[id] + (one - beta) * g * g;
-  const T4 m2o_corrected = m2o / beta_correction;
+  const T4 m2o = beta * m2 + (one - beta) * g_scaled * g_scaled;
+
+  T4 delta;
+  if (weight_decay_mode == 0) {
+    const T4 m1o_corrected = m1o / alpha_correction;
+    const T4 m2o_corrected = m2o / beta_correction;
+
+    // Compute weight update.
+    const T4 denom = _Sqrt(m2o_corrected) + epsilon;
+    const T4 update = (m1o_corrected / denom) + (lambda * T4(w));
 
-  // Compute weight update.
-  const T4 denom = _Sqrt(m2o_corrected) + epsilon;
-  const T4 update = (m1o_corrected / denom) + (lambda * T4(weights[id]));
+    delta = -T4(eta) * update;
+  } else {
+    const T4 denom = _Sqrt(m2o) + epsilon;
 
-  const T4 delta = -T4(*eta) * update;
+    // Apply bias correction terms on learning rate
+    const T4 step_size = T4(eta) * _Sqrt(beta_correction) / alpha_correction;
+
+    // Huggingface updates weights in the following logic:
+    // param' = param - step_size * m1o / denom
+    // param_out = param' - original_lr * lambda * param'
+    // then param_out = param - step_size * m1o / denom - original_lr * lambda * (param - step_size * m1o / denom)
+    // so delta = -step_size * m1o / denom - original_lr * lambda * (param - step_size * m1o / denom)
+    delta = -step_size * m1o / denom - T4(eta) * lambda * (T4(w) - step_size * m1o / denom);
+  }
 
   // Compute the new gradient.
-  if (grads_out) {
-    grads_out[id] = T_GRAD(delta);
+  if (g_new) {
+    *g_new = T_GRAD(delta);
   }
 
   // Compute the new weight.
-  if (weights_out) {
-    weights_out[id] = weights[id] + T3(delta);
+  if (w_new) {
+    *w_new = w + T3(delta);
 
-    if (fp16_weights_out) {
-      fp16_weights_out[id] = static_cast<half>(weights_out[id]);
+    if (w_fp16_new) {
+      *w_fp16_new = static_cast<half>(*w_new);
     }
   }
 
-  moment_1_out[id] = m1o;
-  moment_2_out[id] = m2o;
+  m1_new = m1o;
+  m2_new = m2o;
 }
 
 template <typename T1, typename T3, typename T4, typename T_GRAD, typename T_GRAD_NORM>
-__global__ void _AdamOptimizer_mode1(
+__global__ void _AdamOptimizer(
     const T1* eta,
     const T3* weights,
     const T_GRAD* grads,
@@ -85,6 +104,7 @@ __global__ void _AdamOptimizer_mode1(
     const T4 epsilon,
     const T4 alpha_correction,
     const T4 beta_correction,
+    const int64_t weight_decay_mode,
     T4* moment_1_out,
     T4* moment_2_out,
     T3* weights_out,
@@ -94,45 +114,25 @@ __global__ void _AdamOptimizer_mode1(
   CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
   const T4 actual_scale = _ComputeGradScale<T3, T_GRAD_NORM, T4>(loss_scale, grad_norm);
 
-  // Gradient scaling/clipping.
-  const T4 g = T4(grads[id]) / actual_scale;
-  // A shared constant.
-  const T4 one = T4(1.0f);
-
-  // Compute exponentially-averaged historical gradient.
-  const T4 m1o = alpha * moment_1[id] + (one - alpha) * g;
-
-  // Compute exponentially-averaged historical squared gradient.
-  const T4 m2o = beta * moment_2[id] + (one - beta) * g * g;
-
-  const T4 denom = _Sqrt(m2o) + epsilon;
-
-  // Apply bias correction terms on learning rate
-  const T4 step_size = T4(*eta) * _Sqrt(beta_correction) / alpha_correction;
-
-  // Huggingface updates weights in the following logic:
-  // param' = param - step_size * m1o / denom
-  // param_out = param' - original_lr * lambda * param'
-  // then param_out = param - step_size * m1o / denom - original_lr * lambda * (param - step_size * m1o / denom)
-  // so delta = -step_size * m1o / denom - original_lr * lambda * (param - step_size * m1o / denom)
-  const T4 delta = -step_size * m1o / denom - T4(*eta) * lambda * (T4(weights[id]) - step_size * m1o / denom);
-
-  // Compute the new gradient.
-  if (grads_out) {
-    grads_out[id] = T_GRAD(delta);
-  }
-  
-  // Compute the new weight.
-  if (weights_out) {
-    weights_out[id] = weights[id] + T3(delta);
-
-    if (fp16_weights_out) {
-      fp16_weights_out[id] = static_cast<half>(weights_out[id]);
-    }
-  }
-
-  moment_1_out[id] = m1o;
-  moment_2_out[id] = m2o;
+  _AdamUpdateRule(
+      weight_decay_mode,
+      *eta,
+      weights[id],
+      grads[id],
+      moment_1[id],
+      moment_2[id],
+      actual_scale,
+      alpha,
+      beta,
+      lambda,
+      epsilon,
+      alpha_correction,
+      beta_correction,
+      moment_1_out[id],
+      moment_2_out[id],
+      weights_out != nullptr ? weights_out + id : nullptr,
+      grads_out != nullptr ? grads_out + id : nullptr,
+      fp16_weights_out != nullptr ? fp16_weights_out + id : nullptr);
 }
 
 template <typename T1, typename T2, typename T3, typename T4, typename T_GRAD, typename T_GRAD_NORM>
@@ -165,37 +165,8 @@ void AdamOptimizerImpl(
   const T4 beta_correction = do_bias_correction ?
     onnxruntime::contrib::compute_bias_correction_coefficient(beta, update_count) : T4(1.f);
   
-  // Currently two modes of Adamw are supported:
-  // Mode 0: Pytorch https://pytorch.org/docs/stable/_modules/torch/optim/adamw.html#AdamW,
-  //         bias correction is applied on m and v individually,
-  //         weight decay is applied before weight is updated.
-  // Mode 1: Huggingface https://huggingface.co/transformers/_modules/transformers/optimization.html#AdamW.,
-  //         bias correction is applied on learning rate,
-  //         weight decay is applied after weight is updated.
-  if (weight_decay_mode == 0) {
-    _AdamOptimizer_mode0<T1, T3, T4, T_GRAD, T_GRAD_NORM><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
-      eta,
-      weights,
-      grads,
-      moment_1,
-      moment_2,
-      loss_scale,
-      grad_norm,
-      alpha,
-      beta,
-      lambda,
-      epsilon,
-      alpha_correction,
-      beta_correction,
-      moment_1_out,
-      moment_2_out,
-      weights_out,
-      grads_out,
-      fp16_weights_out,
-      N);
-  }
-  else if (weight_decay_mode == 1) {
-    _AdamOptimizer_mode1<T1, T3, T4, T_GRAD, T_GRAD_NORM><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+  ORT_ENFORCE(weight_decay_mode == 0 || weight_decay_mode == 1, "Unsupported Adamw optimizer mode.");
+  _AdamOptimizer<T1, T3, T4, T_GRAD, T_GRAD_NORM><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
       eta,
       weights,
       grads,
@@ -209,17 +180,13 @@ void AdamOptimizerImpl(
       epsilon,
       alpha_correction,
       beta_correction,
+      weight_decay_mode,
       moment_1_out,
       moment_2_out,
       weights_out,
       grads_out,
       fp16_weights_out,
       N);
-  }
-  else {
-    // Shouldn't reach here
-    ORT_THROW("Unsupported Adamw optimizer mode.");
-  }
 }
 
 #define SPECIALIZED_AdamOptimizerImpl(T1, T2, T3, T4, T_GRAD, T_GRAD_NORM) \
@@ -255,5 +222,107 @@ SPECIALIZED_AdamOptimizerImpl(half, int64_t, float, half, half, float)
 SPECIALIZED_AdamOptimizerImpl(float, int64_t, float, half, half, half)
 SPECIALIZED_AdamOptimizerImpl(float, int64_t, float, half, half, float)
 
+template <typename T1, typename T2, typename T3, typename T4, typename T_GRAD_NORM>
+__global__ void AdamMultiTensorImpl(
+    ChunkGroup<7> chunk_group,
+    const T1* eta,
+    const T2* loss_scale,
+    const T_GRAD_NORM* grad_norm,
+    const T4 alpha,
+    const T4 beta,
+    const T4 lambda,
+    const T4 epsilon,
+    const T4 alpha_correction,
+    const T4 beta_correction,
+    const int64_t weight_decay_mode) {
+  const int group_index = chunk_group.block_index_to_tensor_group_index[blockIdx.x];
+  const int tensor_size = chunk_group.tensor_sizes[group_index];
+  const int chunk_size = chunk_group.chunk_size;
+  const int chunk_start = chunk_group.block_index_to_chunk_start_index[blockIdx.x];
+
+  const T2* w = reinterpret_cast<const T2*>(chunk_group.tensor_ptrs[0][group_index]) + chunk_start;
+  const T3* g = reinterpret_cast<const T3*>(chunk_group.tensor_ptrs[1][group_index]) + chunk_start;
+  T4* m1 = reinterpret_cast<T4*>(chunk_group.tensor_ptrs[2][group_index]) + chunk_start;
+  T4* m2 = reinterpret_cast<T4*>(chunk_group.tensor_ptrs[3][group_index]) + chunk_start;
+  T2* w_new = chunk_group.tensor_ptrs[4][group_index] != nullptr ? reinterpret_cast<T2*>(chunk_group.tensor_ptrs[4][group_index]) + chunk_start : nullptr;
+  T3* g_new = chunk_group.tensor_ptrs[5][group_index] != nullptr ? reinterpret_cast<T3*>(chunk_group.tensor_ptrs[5][group_index]) + chunk_start : nullptr;
+  half* w_fp16_new = chunk_group.tensor_ptrs[6][group_index] != nullptr ? reinterpret_cast<half*>(chunk_group.tensor_ptrs[6][group_index]) + chunk_start : nullptr;
+
+  const T4 actual_scale = _ComputeGradScale<T2, T_GRAD_NORM, T4>(loss_scale, grad_norm);
+
+  for (int i = threadIdx.x; i < chunk_size && i + chunk_start < tensor_size; i += blockDim.x) {
+    _AdamUpdateRule(
+        weight_decay_mode,
+        *eta,
+        w[i],
+        g[i],
+        m1[i],
+        m2[i],
+        actual_scale,
+        alpha,
+        beta,
+        lambda,
+        epsilon,
+        alpha_correction,
+        beta_correction,
+        m1[i],
+        m2[i],
+        w_new != nullptr ? w_new + i : nullptr,
+        g_new != nullptr ? g_new + i : nullptr,
+        w_fp16_new != nullptr ? w_fp16_new + i : nullptr);
+  }
+}
+
+template <typename T1, typename T2, typename T3, typename T4, typename T_GRAD_NORM>
+void AdamMultiTensorFunctor<T1, T2, T3, T4, T_GRAD_NORM>::operator()(
+    ChunkGroup<7> chunk_group,
+    const T1* eta,
+    const T2* loss_scale,
+    const T_GRAD_NORM* grad_norm,
+    const T4 alpha,
+    const T4 beta,
+    const T4 lambda,
+    const T4 epsilon,
+    const T4 alpha_correction,
+    const T4 beta_correction,
+    const int64_t weight_decay_mode) {
+  const int thread_count = ChunkGroup<7>::thread_count_per_block;
+  const int block_count = chunk_group.chunk_count;
+
+  AdamMultiTensorImpl<T1, T2, T3, T4, T_GRAD_NORM><<<block_count, thread_count, 0>>>(
+      chunk_group,
+      eta,
+      loss_scale,
+      grad_norm,
+      alpha,
+      beta,
+      lambda,
+      epsilon,
+      alpha_correction,
+      beta_correction,
+      weight_decay_mode);
+}
+
+#define INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(T1, T2, T3, T4, T_GRAD_NORM)                   \
+  template void AdamMultiTensorFunctor<T1, T2, T3, T4, T_GRAD_NORM>::operator()(             \
+      ChunkGroup<7> chunk_group,                                                            \
+      const T1* eta,                                                                        \
+      const T2* loss_scale,                                                                 \
+      const T_GRAD_NORM* grad_norm,                                                         \
+      const T4 alpha,                                                                       \
+      const T4 beta,                                                                        \
+      const T4 lambda,                                                                      \
+      const T4 epsilon,                                                                     \
+      const T4 alpha_correction,                                                            \
+      const T4 beta_correction,                                                             \
+      const int64_t weight_decay_mode);
+
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, float, float, float)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, half, float, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, half, float, float)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, half, half, half)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, half, half, float)
+INSTANTIATE_ADAM_MULTI_TENSOR_FUNCTOR(float, float, float, half, float)
+
 }  // namespace cuda
 }  // namespace onnxruntime
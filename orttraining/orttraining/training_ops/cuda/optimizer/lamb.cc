@@ -11,40 +11,6 @@
 namespace onnxruntime {
 namespace cuda {
 
-std::vector<std::pair<int, int>> GenerateLambExtraAliasMapping() {
-  // Starting index of extra inputs.
-  constexpr int input_index_bias = 5;
-  // Starting index of extra outputs.
-  constexpr int output_index_bias = 1;
-  // Count of extra I/O groups. One group corresponds to a weight update.
-  constexpr int group_count = 1024;
-  // length of [w, g, m1, m2, w_fp16].
-  constexpr int input_stride = 5;
-  // length of [w_new, g_new, m1_new, m2_new, w_fp16_new].
-  constexpr int output_stride = 5;
-
-  std::vector<std::pair<int, int>> alias_pairs{};
-  for (int i = 0; i < group_count; ++i) {
-    const int input = input_index_bias + i * input_stride;
-    const int output = output_index_bias + i * output_stride;
-    // w --> w_new
-    alias_pairs.emplace_back(std::make_pair(input, output));
-    // g --> g_new
-    alias_pairs.emplace_back(std::make_pair(input + 1, output + 1));
-    // m1 --> m1_new
-    alias_pairs.emplace_back(std::make_pair(input + 2, output + 2));
-    // m2 --> m2_new
-    alias_pairs.emplace_back(std::make_pair(input + 3, output + 3));
-    // w_fp16 --> w_fp16_new
-    alias_pairs.emplace_back(std::make_pair(input + 4, output + 4));
-  }
-
-  // update_count are updated in place.
-  alias_pairs.emplace_back(std::make_pair(4, 0));
-
-  return alias_pairs;
-}
-
 // TODO: Once Schema is checked in to onnx lets fix this to match that
 #define REGISTER_LAMB_KERNEL_TYPED(T1, T2, T3, T4, T_GRAD_NORM)                       \
   ONNX_OPERATOR_TYPED_KERNEL_EX(                                                      \
@@ -54,7 +20,7 @@ std::vector<std::pair<int, int>> GenerateLambExtraAliasMapping() {
       T1##_##T2##_##T3##_##T4##_##T_GRAD_NORM,                                        \
       kCudaExecutionProvider,                                                         \
       KernelDefBuilder()                                                              \
-          .Alias(GenerateLambExtraAliasMapping())                                     \
+          .Alias(GenerateMultiTensorOptimizerAliasMapping())                          \
           .InputMemoryType<OrtMemTypeCPUInput>(0)  /* Keep do_update in CPU */        \
           .InputMemoryType<OrtMemTypeCPUInput>(4)  /* Keep iteration_count in CPU */  \
           .OutputMemoryType<OrtMemTypeCPUOutput>(0)  /* Keep iteration_count in CPU */ \
@@ -75,92 +41,6 @@ REGISTER_LAMB_KERNEL_TYPED(MLFloat16, float, MLFloat16, MLFloat16, float)
 REGISTER_LAMB_KERNEL_TYPED(MLFloat16, float, MLFloat16, float, MLFloat16)
 REGISTER_LAMB_KERNEL_TYPED(MLFloat16, float, MLFloat16, float, float)
 
-void check_inputs_and_outputs(
-    const Tensor* w,
-    const Tensor* g,
-    const Tensor* m1,
-    const Tensor* m2,
-    const Tensor* w_fp16,
-    const Tensor* w_new,
-    const Tensor* g_new,
-    const Tensor* m1_new,
-    const Tensor* m2_new,
-    const Tensor* w_fp16_new) {
-  // Throw if we have incomplete input or output lists.
-  ORT_ENFORCE(w, "Weight tensor should not be null.");
-  ORT_ENFORCE(g, "gradient tensor should not be null.");
-  ORT_ENFORCE(m1, "First-order momentum tensor should not be null.");
-  ORT_ENFORCE(m2, "Second-order momentum tensor should not be null.");
-  ORT_ENFORCE(m1_new, "New first-order momentum tensor should not be null.");
-  ORT_ENFORCE(m2_new, "New second-order momentum tensor should not be null.");
-  // Check if all shapes are good.
-  ORT_ENFORCE(m1->Shape() == m1_new->Shape());
-  ORT_ENFORCE(m2->Shape() == m2_new->Shape());
-  if (w_new)
-    ORT_ENFORCE(w->Shape() == w_new->Shape());
-  if (g_new)
-    ORT_ENFORCE(g->Shape() == g_new->Shape());
-  if (w_fp16 && w_fp16_new)
-    ORT_ENFORCE(w_fp16->Shape() == w_fp16_new->Shape());
-}
-
-template <typename TWeight, typename TGradient, typename TMomentum>
-Status copy_inputs_to_outputs(
-    OpKernelContext* ctx,
-    const int non_grouped_input_count,
-    const int non_grouped_output_count,
-    const int group_count,
-    const int input_group_size,
-    const int output_group_size) {
-
-  const Tensor* step_tensor = ctx->Input<Tensor>(4);
-  if (step_tensor) {
-    const int64_t* step_data = step_tensor->template Data<int64_t>();
-    Tensor* step_tensor_new = ctx->Output(0, step_tensor->Shape());
-    ORT_ENFORCE(step_tensor_new != nullptr, "Step tensor (input) and updated step tensor (output) must be specified together.");
-    int64_t* step_data_new = step_tensor_new->template MutableData<int64_t>();
-    *step_data_new = *step_data;
-  }
-
-  for (int group_index = 0; group_index < group_count; ++group_index) {
-    const int input_start_index = non_grouped_input_count + group_index * input_group_size;
-    const Tensor& w = *ctx->Input<Tensor>(input_start_index);
-    const Tensor& g = *ctx->Input<Tensor>(input_start_index + 1);
-    const Tensor& m1 = *ctx->Input<Tensor>(input_start_index + 2);
-    const Tensor& m2 = *ctx->Input<Tensor>(input_start_index + 3);
-    const Tensor* w_fp16 = ctx->Input<Tensor>(input_start_index + 4);
-    const int output_start_index = non_grouped_output_count + group_index * output_group_size;
-    Tensor* w_new = ctx->Output(output_start_index, w.Shape());
-    Tensor* g_new = ctx->Output(output_start_index + 1, g.Shape());
-    Tensor& m1_new = *ctx->Output(output_start_index + 2, m1.Shape());
-    Tensor& m2_new = *ctx->Output(output_start_index + 3, m2.Shape());
-    Tensor* w_fp16_new = w_fp16 != nullptr ? ctx->Output(output_start_index + 4, w_fp16->Shape()) : nullptr;
-
-    // TODO: temporary hack until View is improved (it doesn't work with Alias)
-    if (w_new != nullptr)
-      w_new->SetByteOffset(w.ByteOffset());
-    if (g_new != nullptr)
-      g_new->SetByteOffset(g.ByteOffset());
-    if (w_fp16_new != nullptr)
-      w_fp16_new->SetByteOffset(w_fp16->ByteOffset());
-
-    if (w_new) {
-      ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<TWeight>(w, *w_new));
-    }
-    if (g_new) {
-      ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<TGradient>(g, *g_new));
-    }
-    ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<TMomentum>(m1, m1_new));
-    ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<TMomentum>(m2, m2_new));
-
-    if (w_fp16_new) {
-      ORT_RETURN_IF_ERROR(CopyIfNotSameBuffer<MLFloat16>(*w_fp16, *w_fp16_new));
-    }
-  }
-
-  return Status::OK();
-}
-
 template <typename CudaT2, typename CudaT3, typename CudaT4, typename CudaT_GRAD_NORM>
 Status launch_lamb_compute_direction(
     const int64_t update_count,
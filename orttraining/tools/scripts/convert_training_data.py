@@ -0,0 +1,60 @@
+import sys
+import os
+import struct
+import onnx
+from onnx import numpy_helper
+
+# Converts training data files from the .pb format read by DataLoader
+# (orttraining/models/runner/data_loader.h) into the memory-mapped .ortdata format.
+
+def pad(size):
+    return b'\0' * ((8 - size % 8) % 8)
+
+def read_samples(pb_path):
+    with open(pb_path, 'rb') as f:
+        data = f.read()
+    offset = 0
+    while offset < len(data):
+        sample_size, = struct.unpack_from('<I', data, offset)
+        offset += 4
+        end = offset + sample_size
+        features = []
+        while offset < end:
+            feature_size, = struct.unpack_from('<I', data, offset)
+            offset += 4
+            tensor = onnx.TensorProto()
+            tensor.ParseFromString(data[offset:offset + feature_size])
+            features.append(tensor)
+            offset += feature_size
+        yield features
+
+def write_feature(f, tensor):
+    name = tensor.name.encode('utf-8')
+    array = numpy_helper.to_array(tensor)
+    raw_data = array.astype(array.dtype.newbyteorder('<')).tobytes()
+    f.write(struct.pack('<IiII', len(name), tensor.data_type, len(tensor.dims), 0))
+    f.write(struct.pack('<%dq' % len(tensor.dims), *tensor.dims))
+    f.write(struct.pack('<Q', len(raw_data)))
+    f.write(name + pad(len(name)))
+    f.write(raw_data + pad(len(raw_data)))
+
+def main():
+    if len(sys.argv) < 3:
+        print("Usage: convert_training_data.py <input dir with .pb files> <output dir>")
+        return
+
+    input_dir, output_dir = sys.argv[1], sys.argv[2]
+    os.makedirs(output_dir, exist_ok=True)
+    for file_name in sorted(os.listdir(input_dir)):
+        if not file_name.endswith('.pb'):
+            continue
+        output_path = os.path.join(output_dir, file_name[:-len('.pb')] + '.ortdata')
+        with open(output_path, 'wb') as f:
+            for features in read_samples(os.path.join(input_dir, file_name)):
+                f.write(struct.pack('<Q', len(features)))
+                for tensor in features:
+                    write_feature(f, tensor)
+        print("Converted", file_name, "to", output_path)
+
+if __name__ == "__main__":
+    main()
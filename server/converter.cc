@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstring>
+
 #include "onnxruntime_cxx_api.h"
 
 #include "onnx-ml.pb.h"
@@ -8,6 +10,7 @@
 
 #include "converter.h"
 #include "serializing/mem_buffer.h"
+#include "serializing/tensorprotoutils.h"
 
 namespace onnxruntime {
 namespace server {
@@ -230,5 +233,35 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
 
   return;
 }
+
+size_t MLValueToExternalData(Ort::Value& ml_value, char* data, size_t length,
+                             /* out */ onnx::TensorProto& tensor_proto) {
+  if (!ml_value.IsTensor()) {
+    throw Ort::Exception("Don't support Non-Tensor values", OrtErrorCode::ORT_NOT_IMPLEMENTED);
+  }
+  const auto& shape = ml_value.GetTensorTypeAndShapeInfo();
+
+  onnx::TensorProto_DataType data_type = MLDataTypeToTensorProtoDataType(shape.GetElementType());
+  auto element_size = GetFixedElementSize(data_type);
+  if (element_size == 0) {
+    throw Ort::Exception("Only the tensors of fixed size types can be written to external data",
+                         OrtErrorCode::ORT_INVALID_ARGUMENT);
+  }
+
+  auto size_in_bytes = element_size * shape.GetElementCount();
+  if (size_in_bytes > length) {
+    throw Ort::Exception("The output of " + std::to_string(size_in_bytes) + " bytes doesn't fit in the " +
+                             std::to_string(length) + " bytes of its external data",
+                         OrtErrorCode::ORT_INVALID_ARGUMENT);
+  }
+
+  for (const auto& dim : shape.GetShape()) {
+    tensor_proto.add_dims(dim);
+  }
+  tensor_proto.set_data_type(data_type);
+  tensor_proto.set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+  memcpy(data, ml_value.GetTensorMutableData<char>(), size_in_bytes);
+  return size_in_bytes;
+}
 }  // namespace server
 }  // namespace onnxruntime
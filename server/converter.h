@@ -22,5 +22,11 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
                           const std::shared_ptr<spdlog::logger>& logger,
                           /* out */ onnx::TensorProto& tensor_proto);
 
+// Copy the data of MLValue to data, a buffer of length bytes outside of the response such as a shared memory
+// region, and describe it in TensorProto with data_location EXTERNAL. The external_data field is left to the caller.
+// Only tensors of fixed size types are supported. Returns the number of bytes written.
+size_t MLValueToExternalData(Ort::Value& ml_value, char* data, size_t length,
+                             /* out */ onnx::TensorProto& tensor_proto);
+
 }  // namespace server
 }  // namespace onnxruntime
@@ -1,10 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include "environment.h"
 #include "onnxruntime_cxx_api.h"
 
+#ifdef USE_CUDA
+
+#include "core/providers/cuda/cuda_provider_factory.h"
+
+#endif
+
 #ifdef USE_DNNL
 
 #include "core/providers/dnnl/dnnl_provider_factory.h"
@@ -66,53 +74,295 @@ ServerEnvironment::ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_ini
   spdlog::initialize_logger(default_logger_);
 }
 
-void ServerEnvironment::RegisterExecutionProviders(){
+void ServerEnvironment::RegisterExecutionProviders(Ort::SessionOptions& options, int cuda_device_id){
+  // CUDA goes first, the other providers taking the nodes it doesn't support
+  #ifdef USE_CUDA
+  if (cuda_device_id >= 0) {
+    Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_CUDA(options, cuda_device_id));
+  }
+  #else
+  (void)cuda_device_id;
+  #endif
+
   #ifdef USE_DNNL
-  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Dnnl(options_, 1));
+  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Dnnl(options, 1));
   #endif
 
   #ifdef USE_NGRAPH
-  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_NGraph(options_, "CPU"));
+  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_NGraph(options, "CPU"));
   #endif
 
   #ifdef USE_NUPHAR
-  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Nuphar(options_, 1, ""));
+  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Nuphar(options, 1, ""));
   #endif
   
   #ifdef USE_OPENVINO
-  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_OpenVINO(options_, ""));
+  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_OpenVINO(options, ""));
   #endif
   
 
 }
 
+void ServerEnvironment::SetModelOptions(const std::string& model_name, const ModelOptions& options) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  model_options_[model_name] = options;
+}
+
 void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version) {
-  RegisterExecutionProviders();
-  auto result = sessions_.emplace(std::piecewise_construct, std::forward_as_tuple(model_name, model_version), std::forward_as_tuple(runtime_environment_, model_path.c_str(), options_));
+  ModelOptions model_options;
+  Ort::SessionOptions session_options{nullptr};
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    if (sessions_.count(std::make_pair(model_name, model_version)) != 0) {
+      throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+    }
+
+    auto it = model_options_.find(model_name);
+    if (it != model_options_.end()) {
+      model_options = it->second;
+    }
+    session_options = options_.Clone();
+  }
 
+  if (model_options.intra_op_num_threads > 0) {
+    session_options.SetIntraOpNumThreads(model_options.intra_op_num_threads);
+  }
+  // The async runs of the session, which the batcher and the limited runs go through, are capped by its threads.
+  if (model_options.max_concurrent_runs > 0) {
+    session_options.SetAsyncRunThreadPoolSize(static_cast<int>(model_options.max_concurrent_runs));
+  }
+
+  auto cuda_device_ids = model_options.cuda_device_ids;
+#ifndef USE_CUDA
+  if (!cuda_device_ids.empty()) {
+    throw Ort::Exception("The server isn't built with CUDA, so the model can't run on CUDA devices.", ORT_INVALID_ARGUMENT);
+  }
+#endif
+  if (cuda_device_ids.empty()) {
+    cuda_device_ids.push_back(-1);
+  }
+
+  ModelReplicas replicas;
+  for (auto cuda_device_id : cuda_device_ids) {
+    auto replica_options = session_options.Clone();
+    RegisterExecutionProviders(replica_options, cuda_device_id);
+
+    auto model = std::make_shared<Model>(runtime_environment_, model_path.c_str(), replica_options);
+    model->name = model_name;
+    model->version = model_version;
+    model->cuda_device_id = cuda_device_id;
+    model->max_concurrent_runs = model_options.max_concurrent_runs;
+    model->max_queued_requests = model_options.max_queued_requests;
+    model->cache_responses = model_options.cache_responses;
+    auto input_count = model->session.GetInputCount();
+    auto output_count = model->session.GetOutputCount();
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    for (size_t i = 0; i < input_count; i++) {
+      auto name = model->session.GetInputName(i, allocator);
+      model->input_names.push_back(name);
+      allocator.Free(name);
+    }
+
+    for (size_t i = 0; i < output_count; i++) {
+      auto name = model->session.GetOutputName(i, allocator);
+      model->output_names.push_back(name);
+      allocator.Free(name);
+    }
+
+    replicas.push_back(std::move(model));
+  }
+
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  auto result = sessions_.emplace(std::make_pair(model_name, model_version), std::move(replicas));
   if (!result.second) {
     throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
   }
 
-  auto iterator = result.first;
-  auto output_count = (iterator->second).session.GetOutputCount();
+  serving_versions_.emplace(model_name, model_version);
+}
 
-  Ort::AllocatorWithDefaultOptions allocator;
-  for (size_t i = 0; i < output_count; i++) {
-    auto name = (iterator->second).session.GetOutputName(i, allocator);
-    (iterator->second).output_names.push_back(name);
-    allocator.Free(name);
+const ServerEnvironment::ModelReplicas& ServerEnvironment::FindReplicas(const std::string& model_name, const std::string& model_version) const {
+  auto version = model_version;
+  if (version.empty()) {
+    auto serving = serving_versions_.find(model_name);
+    if (serving == serving_versions_.end()) {
+      throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+    }
+    version = serving->second;
   }
-}
 
-const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
+  auto it = sessions_.find(std::make_pair(model_name, version));
   if (it == sessions_.end()) {
     throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
   }
 
-  return it->second.output_names;
+  return it->second;
+}
+
+std::shared_ptr<ServerEnvironment::Model> ServerEnvironment::GetModel(const std::string& model_name, const std::string& model_version) const {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  const auto& replicas = FindReplicas(model_name, model_version);
+  if (replicas.size() == 1) {
+    return replicas.front();
+  }
+
+  // The scan starts from a rotating replica, so that the idle replicas take turns.
+  auto start = next_replica_++;
+  const std::shared_ptr<Model>* selected = nullptr;
+  size_t selected_load = 0;
+  for (size_t i = 0; i < replicas.size(); i++) {
+    const auto& replica = replicas[(start + i) % replicas.size()];
+    size_t load = replica->queued_requests;
+    if (selected == nullptr || load < selected_load) {
+      selected = &replica;
+      selected_load = load;
+    }
+  }
+
+  return *selected;
+}
+
+std::vector<std::shared_ptr<ServerEnvironment::Model>> ServerEnvironment::GetModelReplicas(const std::string& model_name, const std::string& model_version) const {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  return FindReplicas(model_name, model_version);
+}
+
+const std::vector<std::string>& ServerEnvironment::GetModelInputNames(const std::string& model_name, const std::string& model_version) const {
+  return GetModel(model_name, model_version)->input_names;
+}
+
+void ServerEnvironment::SetServingVersion(const std::string& model_name, const std::string& model_version) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  if (sessions_.count(std::make_pair(model_name, model_version)) == 0) {
+    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  }
+
+  serving_versions_[model_name] = model_version;
+}
+
+std::string ServerEnvironment::GetServingVersion(const std::string& model_name) const {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  auto it = serving_versions_.find(model_name);
+  return it == serving_versions_.end() ? std::string() : it->second;
+}
+
+static size_t GetElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+static void WarmUp(ServerEnvironment::Model* model) {
+  std::vector<std::vector<uint8_t>> buffers;
+  std::vector<Ort::Value> input_values;
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  for (size_t i = 0; i < model->input_names.size(); i++) {
+    auto type_info = model->session.GetInputTypeInfo(i);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+      return;
+    }
+
+    auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+    auto element_size = GetElementSize(tensor_info.GetElementType());
+    if (element_size == 0) {
+      return;
+    }
+
+    auto shape = tensor_info.GetShape();
+    size_t element_count = 1;
+    for (auto& dim : shape) {
+      if (dim < 0) {
+        dim = 1;
+      }
+      element_count *= static_cast<size_t>(dim);
+    }
+
+    buffers.emplace_back(element_count * element_size);
+    input_values.push_back(Ort::Value::CreateTensor(memory_info, buffers.back().data(), buffers.back().size(),
+                                                    shape.data(), shape.size(), tensor_info.GetElementType()));
+  }
+
+  std::vector<const char*> input_names;
+  for (const auto& name : model->input_names) {
+    input_names.push_back(name.c_str());
+  }
+  std::vector<const char*> output_names;
+  for (const auto& name : model->output_names) {
+    output_names.push_back(name.c_str());
+  }
+
+  model->session.Run(Ort::RunOptions{nullptr}, input_names.data(), input_values.data(), input_values.size(),
+                     output_names.data(), output_names.size());
+}
+
+void ServerEnvironment::WarmUpModel(const std::string& model_name, const std::string& model_version) {
+  for (const auto& model : GetModelReplicas(model_name, model_version)) {
+    WarmUp(model.get());
+  }
+}
+
+void ServerEnvironment::EnableBatching(const std::string& model_name, const std::string& model_version,
+                                       size_t max_batch_size, int64_t max_delay_us) {
+  auto replicas = GetModelReplicas(model_name, model_version);
+
+  // the replicas have the same inputs
+  auto& holder = *replicas.front();
+  for (size_t i = 0; i < holder.input_names.size(); i++) {
+    auto type_info = holder.session.GetInputTypeInfo(i);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+      throw Ort::Exception("Batching requires all the model inputs to be tensors. Input: " + holder.input_names[i],
+                           ORT_INVALID_ARGUMENT);
+    }
+
+    auto shape = type_info.GetTensorTypeAndShapeInfo().GetShape();
+    if (shape.empty() || shape[0] >= 0) {
+      throw Ort::Exception("Batching requires the first dimension of all the model inputs to be symbolic. Input: " +
+                               holder.input_names[i],
+                           ORT_INVALID_ARGUMENT);
+    }
+  }
+
+  std::vector<const char*> input_names;
+  for (const auto& name : holder.input_names) {
+    input_names.push_back(name.c_str());
+  }
+  std::vector<const char*> output_names;
+  for (const auto& name : holder.output_names) {
+    output_names.push_back(name.c_str());
+  }
+
+  for (auto& replica : replicas) {
+    replica->batcher = std::make_unique<Ort::RequestBatcher>(replica->session, input_names.data(), input_names.size(),
+                                                             output_names.data(), output_names.size(),
+                                                             max_batch_size, max_delay_us);
+  }
+}
+
+Ort::RequestBatcher* ServerEnvironment::GetBatcher(const std::string& model_name, const std::string& model_version) const {
+  return GetModel(model_name, model_version)->batcher.get();
+}
+
+const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
+  return GetModel(model_name, model_version)->output_names;
 }
 
 OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
@@ -120,13 +370,42 @@ OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
 }
 
 const Ort::Session& ServerEnvironment::GetSession(const std::string& model_name, const std::string& model_version) const {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  return GetModel(model_name, model_version)->session;
+}
+
+void ServerEnvironment::SetMaxQueuedRequests(size_t max_queued_requests) {
+  max_queued_requests_ = max_queued_requests;
+}
+
+bool ServerEnvironment::TryAcquireRequestSlot(Model& model) {
+  auto max_queued_requests = model.max_queued_requests != 0 ? model.max_queued_requests : max_queued_requests_;
+  auto queued_requests = ++model.queued_requests;
+  if (max_queued_requests != 0 && queued_requests > max_queued_requests) {
+    --model.queued_requests;
+    return false;
   }
 
-  return it->second.session;
+  return true;
+}
+
+void ServerEnvironment::ReleaseRequestSlot(Model& model) {
+  --model.queued_requests;
+}
+
+void ServerEnvironment::EnableResponseCache(size_t max_entries, size_t max_bytes, std::chrono::milliseconds ttl) {
+  response_cache_ = std::make_unique<ResponseCache>(max_entries, max_bytes, ttl);
+}
+
+ResponseCache* ServerEnvironment::GetResponseCache() const {
+  return response_cache_.get();
+}
+
+void ServerEnvironment::EnableSharedMemory() {
+  shared_memory_ = std::make_unique<SharedMemoryManager>();
+}
+
+SharedMemoryManager* ServerEnvironment::GetSharedMemory() const {
+  return shared_memory_.get();
 }
 
 std::shared_ptr<spdlog::logger> ServerEnvironment::GetLogger(const std::string& request_id) const {
@@ -140,13 +419,37 @@ std::shared_ptr<spdlog::logger> ServerEnvironment::GetAppLogger() const {
 }
 
 void ServerEnvironment::UnloadModel(const std::string& model_name, const std::string& model_version) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
   auto identifier = std::make_pair(model_name, model_version);
   auto it = sessions_.find(identifier);
   if (it == sessions_.end()) {
     throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
   }
 
+  // The requests running on the model hold it, and the last of them may complete on a thread of the session, so the
+  // environment keeps it until ReleaseDrainedModels.
+  std::move(it->second.begin(), it->second.end(), std::back_inserter(retired_models_));
   sessions_.erase(it);
+
+  auto serving = serving_versions_.find(model_name);
+  if (serving != serving_versions_.end() && serving->second == model_version) {
+    serving_versions_.erase(serving);
+  }
+}
+
+size_t ServerEnvironment::ReleaseDrainedModels() {
+  // destroyed outside the lock, as destroying a session waits for its threads
+  std::vector<std::shared_ptr<Model>> drained_models;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    // Only the environment can hand out a model, so once unloaded and unused, nothing can take it again.
+    auto drained = std::stable_partition(retired_models_.begin(), retired_models_.end(),
+                                         [](const std::shared_ptr<Model>& model) { return model.use_count() > 1; });
+    std::move(drained, retired_models_.end(), std::back_inserter(drained_models));
+    retired_models_.erase(drained, retired_models_.end());
+  }
+
+  return drained_models.size();
 }
 
 }  // namespace server
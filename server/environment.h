@@ -3,11 +3,16 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "onnxruntime_cxx_api.h"
 #include <spdlog/spdlog.h>
+#include "response_cache.h"
+#include "shared_memory.h"
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
 
@@ -16,21 +21,125 @@ namespace server {
 
 class ServerEnvironment {
  public:
+  // A loaded version of a model, or one of its replicas if it runs on several devices. The requests hold it while
+  // they run, so a version that is unloaded or replaced is only released once its requests are drained.
+  struct Model {
+    std::string name;
+    std::string version;
+    Ort::Session session;
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+    // declared after the session, which must outlive it
+    std::unique_ptr<Ort::RequestBatcher> batcher;
+    std::atomic<size_t> queued_requests{0};
+    // limits of the model, see ModelOptions
+    size_t max_concurrent_runs{0};
+    size_t max_queued_requests{0};
+    bool cache_responses{true};
+    // -1 if the model doesn't run on CUDA
+    int cuda_device_id{-1};
+    explicit Model(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
+      session = Ort::Session(env, path.c_str(), options);
+    };
+    ~Model() = default;
+    Model(const Model&) = delete;
+    Model(const Model&&) = delete;
+    Model& operator=(const Model&) = delete;
+  };
+
+  // Resources of a model, isolating it from the other models of the server.
+  struct ModelOptions {
+    // Maximum number of runs of the model at once. The requests beyond it wait for a run to complete.
+    // 0 is unlimited.
+    size_t max_concurrent_runs{0};
+    // Overrides SetMaxQueuedRequests for the model. 0 keeps the limit of the server.
+    size_t max_queued_requests{0};
+    // Size of the intra-op thread pool of the model. Each session has a thread pool of its own, so the heavy models
+    // can't take the threads of the others. 0 is the default of ONNX Runtime.
+    int intra_op_num_threads{0};
+    // Whether the responses of the model go to the response cache, if enabled. Must be false for the models whose
+    // outputs aren't a function of their inputs alone.
+    bool cache_responses{true};
+    // CUDA devices to run the model on, with a replica of the model on each of them. The requests go to the replica
+    // with the fewest queued requests, and the limits above apply to each replica. Empty runs a single replica with
+    // the providers of the server. Requires a build with CUDA.
+    std::vector<int> cuda_device_ids;
+  };
+
   explicit ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink);
   ~ServerEnvironment() = default;
   ServerEnvironment(const ServerEnvironment&) = delete;
 
   OrtLoggingLevel GetLogSeverity() const;
 
-  const Ort::Session& GetSession(const std::string& model_name, const std::string& model_version) const;
+  // Applies to the versions of the model loaded afterwards.
+  void SetModelOptions(const std::string& model_name, const ModelOptions& options);
+
+  // The model is loaded without holding the lock of the environment, so loading a new version doesn't stall the
+  // requests of the loaded ones. The first version loaded of a model is served to the requests without a version.
   void InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version);
+  // Returns the model, or throws ORT_NO_MODEL. An empty model_version selects the version served for the model.
+  // Of the replicas of a model, returns the least loaded one.
+  std::shared_ptr<Model> GetModel(const std::string& model_name, const std::string& model_version) const;
+  std::vector<std::shared_ptr<Model>> GetModelReplicas(const std::string& model_name, const std::string& model_version) const;
+  const Ort::Session& GetSession(const std::string& model_name, const std::string& model_version) const;
+  const std::vector<std::string>& GetModelInputNames(const std::string& model_name, const std::string& model_version) const;
   const std::vector<std::string>& GetModelOutputNames(const std::string& model_name, const std::string& model_version) const;
+
+  // Serve model_version to the requests without a version. The switch is atomic: each request runs either on the
+  // previous version or on the new one.
+  void SetServingVersion(const std::string& model_name, const std::string& model_version);
+  // Returns an empty string if no version of the model is loaded.
+  std::string GetServingVersion(const std::string& model_name) const;
+  // Run each replica of the model once on zero-filled inputs, so that the first requests don't pay for the lazy
+  // initialization of the sessions. Symbolic dimensions are set to 1. Models with non-tensor or string inputs are skipped.
+  void WarmUpModel(const std::string& model_name, const std::string& model_version);
+
+  // Coalesce the concurrent requests of a model into batched runs of up to max_batch_size rows, waiting at most
+  // max_delay_us for a batch to fill. All the inputs and outputs of the model must be batched along their first
+  // dimension, so the first dimension of every input must be symbolic.
+  void EnableBatching(const std::string& model_name, const std::string& model_version,
+                      size_t max_batch_size, int64_t max_delay_us);
+  // Returns nullptr if batching isn't enabled for the model.
+  Ort::RequestBatcher* GetBatcher(const std::string& model_name, const std::string& model_version) const;
+
+  // Limit the number of requests of each model that are processed or queued at once. The requests beyond the limit
+  // are rejected, which pushes back on the clients under load spikes. 0, the default, is unlimited.
+  // ModelOptions::max_queued_requests overrides it for a model.
+  void SetMaxQueuedRequests(size_t max_queued_requests);
+  // Returns false if the model already has the maximum number of queued requests. Otherwise the request must call
+  // ReleaseRequestSlot once it completes.
+  bool TryAcquireRequestSlot(Model& model);
+  void ReleaseRequestSlot(Model& model);
+
+  // Cache the responses of the models, see ResponseCache. The models must be deterministic, unless
+  // ModelOptions::cache_responses opts them out.
+  void EnableResponseCache(size_t max_entries, size_t max_bytes, std::chrono::milliseconds ttl);
+  // Returns nullptr if the response cache isn't enabled.
+  ResponseCache* GetResponseCache() const;
+
+  // Let the clients register shared memory regions for the tensors of their requests. Only for trusted co-located
+  // clients: the server maps the shared memory they name.
+  void EnableSharedMemory();
+  // Returns nullptr if shared memory isn't enabled.
+  SharedMemoryManager* GetSharedMemory() const;
   std::shared_ptr<spdlog::logger> GetLogger(const std::string& request_id) const;
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
+  // The version stops taking requests right away, and is released by ReleaseDrainedModels once the requests running
+  // on it complete.
   void UnloadModel(const std::string& model_name, const std::string& model_version);
-  void RegisterExecutionProviders();
+  // Release the unloaded models that have no request running anymore. Returns the number of models released.
+  // Must not be called from a callback of a session, which can't be destroyed from one of its own threads.
+  size_t ReleaseDrainedModels();
 
  private:
+  using ModelReplicas = std::vector<std::shared_ptr<Model>>;
+
+  // Appends the providers the server is built with, running on cuda_device_id for CUDA.
+  void RegisterExecutionProviders(Ort::SessionOptions& options, int cuda_device_id);
+  // Must be called with sessions_mutex_ held. Throws ORT_NO_MODEL.
+  const ModelReplicas& FindReplicas(const std::string& model_name, const std::string& model_version) const;
+
   const OrtLoggingLevel severity_;
   const std::string logger_id_;
   const std::vector<spdlog::sink_ptr> sink_;
@@ -39,19 +148,18 @@ class ServerEnvironment {
   Ort::Env runtime_environment_;
   Ort::SessionOptions options_;
 
-  struct SessionHolder {
-    Ort::Session session;
-    std::vector<std::string> output_names;
-    explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
-      session = Ort::Session(env, path.c_str(), options);
-    };
-    ~SessionHolder() = default;
-    SessionHolder(const SessionHolder&) = delete;
-    SessionHolder(const SessionHolder&&) = delete;
-    SessionHolder& operator=(const SessionHolder&) = delete;
-  };
-
-  std::unordered_map<std::pair<std::string, std::string>, ServerEnvironment::SessionHolder, boost::hash<std::pair<std::string, std::string>>> sessions_;
+  // guards sessions_, serving_versions_, retired_models_ and model_options_, not the models themselves
+  mutable std::mutex sessions_mutex_;
+  std::unordered_map<std::pair<std::string, std::string>, ModelReplicas, boost::hash<std::pair<std::string, std::string>>> sessions_;
+  // spreads the requests across the replicas with the same load
+  mutable std::atomic<size_t> next_replica_{0};
+  std::unordered_map<std::string, std::string> serving_versions_;
+  // unloaded models, kept until their requests complete
+  std::vector<std::shared_ptr<Model>> retired_models_;
+  std::unordered_map<std::string, ModelOptions> model_options_;
+  size_t max_queued_requests_{0};
+  std::unique_ptr<ResponseCache> response_cache_;
+  std::unique_ptr<SharedMemoryManager> shared_memory_;
 };
 
 }  // namespace server
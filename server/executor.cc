@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include <stdio.h>
+#include <algorithm>
+#include <future>
 #include "serializing/mem_buffer.h"
 #include "serializing/tensorprotoutils.h"
 
@@ -23,6 +25,21 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
                                           /* out */ Ort::Value& ml_value) {
   auto logger = env_->GetLogger(request_id_);
 
+  if (input_tensor.data_location() == onnx::TensorProto_DataLocation_EXTERNAL) {
+    return SetSharedMemoryMLValue(input_tensor, cpu_memory_info, ml_value);
+  }
+
+  // Use the raw_data of the request in place when possible. The request outlives the run, so the tensor
+  // doesn't need a buffer of its own.
+  try {
+    if (onnxruntime::server::TryWrapTensorProtoRawData(input_tensor, *cpu_memory_info, ml_value)) {
+      return protobufutil::Status::OK;
+    }
+  } catch (const Ort::Exception& e) {
+    logger->error("TryWrapTensorProtoRawData() failed. Error Message: {}", e.what());
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
   size_t cpu_tensor_length = 0;
   try {
     onnxruntime::server::GetSizeInBytesFromTensorProto<0>(input_tensor, &cpu_tensor_length);
@@ -45,6 +62,75 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
   return protobufutil::Status::OK;
 }
 
+protobufutil::Status Executor::GetSharedMemoryRange(const std::string& region, uint64_t offset, uint64_t length,
+                                                    /* out */ char*& data) {
+  auto* shared_memory = env_->GetSharedMemory();
+  if (shared_memory == nullptr) {
+    return protobufutil::Status(protobufutil::error::Code::FAILED_PRECONDITION, "Shared memory isn't enabled on the server");
+  }
+
+  try {
+    auto shared_memory_region = shared_memory->Get(region);
+    data = shared_memory_region->GetRange(static_cast<size_t>(offset), static_cast<size_t>(length));
+    shared_memory_regions_.push_back(std::move(shared_memory_region));
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status Executor::SetSharedMemoryMLValue(const onnx::TensorProto& input_tensor,
+                                                      OrtMemoryInfo* cpu_memory_info,
+                                                      /* out */ Ort::Value& ml_value) {
+  auto logger = env_->GetLogger(request_id_);
+
+  // The keys of external_data follow the ONNX convention, with the region as location. The length defaults to the
+  // size of the tensor.
+  std::string region;
+  uint64_t offset = 0;
+  uint64_t length = 0;
+  bool has_length = false;
+  for (const auto& entry : input_tensor.external_data()) {
+    try {
+      if (entry.key() == "location") {
+        region = entry.value();
+      } else if (entry.key() == "offset") {
+        offset = std::stoull(entry.value());
+      } else if (entry.key() == "length") {
+        length = std::stoull(entry.value());
+        has_length = true;
+      }
+    } catch (const std::exception&) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                  "Invalid " + entry.key() + " in external_data: " + entry.value());
+    }
+  }
+
+  try {
+    if (!has_length) {
+      size_t size_in_bytes = 0;
+      onnxruntime::server::GetSizeInBytesFromTensorProto<0>(input_tensor, &size_in_bytes);
+      length = size_in_bytes;
+    }
+
+    char* data = nullptr;
+    auto status = GetSharedMemoryRange(region, offset, length, data);
+    if (status != protobufutil::Status::OK) {
+      logger->error("GetSharedMemoryRange() failed. Region: {}. Error Message: {}", region, status.error_message());
+      return status;
+    }
+
+    onnxruntime::server::WrapTensorProtoExternalData(input_tensor, data, static_cast<size_t>(length),
+                                                     *cpu_memory_info, ml_value);
+  } catch (const Ort::Exception& e) {
+    logger->error("WrapTensorProtoExternalData() failed. Error Message: {}", e.what());
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  return protobufutil::Status::OK;
+}
+
 protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input_names,
                                                  std::vector<Ort::Value>& input_values,
                                                  const onnxruntime::server::PredictRequest& request,
@@ -61,7 +147,9 @@ protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input
 
   // Prepare the Value object
   for (const auto& input : request.inputs()) {
-    using_raw_data_ = using_raw_data_ && input.second.has_raw_data();
+    using_raw_data_ = using_raw_data_ &&
+                      (input.second.has_raw_data() ||
+                       input.second.data_location() == onnx::TensorProto_DataLocation_EXTERNAL);
 
     Ort::Value ml_value{nullptr};
     auto status = SetMLValue(input.second, buffers, memory_info, ml_value);
@@ -76,6 +164,20 @@ protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input
   }
 
   Ort::GetApi().ReleaseMemoryInfo(memory_info);
+
+  // Resolve the regions of the outputs before the run, so that a bad region fails the request right away.
+  for (const auto& output : request.output_shared_memory()) {
+    const auto& range = output.second;
+    char* data = nullptr;
+    auto status = GetSharedMemoryRange(range.region(), range.offset(), range.length(), data);
+    if (status != protobufutil::Status::OK) {
+      logger->error("GetSharedMemoryRange() failed! Output name: {}", output.first);
+      return status;
+    }
+    shared_memory_outputs_[output.first] = SharedMemoryOutput{range.region(), range.offset(), data,
+                                                              static_cast<size_t>(range.length())};
+  }
+
   return protobufutil::Status::OK;
 }
 
@@ -97,11 +199,233 @@ std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions&
   return const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), output_count);
 }
 
+// Map the requested outputs to their indices among the outputs of the model.
+static std::vector<size_t> GetModelOutputIndices(const std::vector<std::string>& model_output_names,
+                                                 const std::vector<std::string>& output_names) {
+  std::vector<size_t> output_indices;
+  output_indices.reserve(output_names.size());
+  for (const auto& output_name : output_names) {
+    auto it = std::find(model_output_names.begin(), model_output_names.end(), output_name);
+    if (it == model_output_names.end()) {
+      throw Ort::Exception("Invalid Output Name: " + output_name, ORT_INVALID_ARGUMENT);
+    }
+    output_indices.push_back(it - model_output_names.begin());
+  }
+  return output_indices;
+}
+
+// Order the inputs of a request as the inputs of the model, which the batcher takes.
+// Returns false if the request doesn't feed all the inputs of the model, so it has to run on its own.
+static bool GetBatcherInputs(const std::vector<std::string>& model_input_names,
+                             const std::vector<std::string>& input_names,
+                             const std::vector<Ort::Value>& input_values,
+                             /* out */ std::vector<const OrtValue*>& batcher_inputs) {
+  if (input_names.size() != model_input_names.size()) {
+    return false;
+  }
+
+  batcher_inputs.clear();
+  batcher_inputs.reserve(model_input_names.size());
+  for (const auto& model_input_name : model_input_names) {
+    auto it = std::find(input_names.begin(), input_names.end(), model_input_name);
+    if (it == input_names.end()) {
+      return false;
+    }
+    batcher_inputs.push_back(input_values[it - input_names.begin()]);
+  }
+  return true;
+}
+
+struct BlockingRunResult {
+  std::promise<void> done;
+  std::vector<Ort::Value> outputs;
+  OrtErrorCode error_code{ORT_OK};
+  std::string error_message;
+};
+
+static void ORT_API_CALL OnBlockingRunComplete(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status) {
+  auto* result = static_cast<BlockingRunResult*>(user_data);
+  if (status != nullptr) {
+    result->error_code = Ort::GetApi().GetErrorCode(status);
+    result->error_message = Ort::GetApi().GetErrorMessage(status);
+    Ort::GetApi().ReleaseStatus(status);
+  }
+
+  for (size_t i = 0; i < num_outputs; ++i) {
+    result->outputs.emplace_back(outputs[i]);
+  }
+  result->done.set_value();
+}
+
+// Run a request with Session::RunAsync and wait for it, so that it takes one of the async run threads of the session,
+// which cap the concurrent runs of the model.
+static std::vector<Ort::Value> RunQueued(Ort::Session& session, const Ort::RunOptions& options,
+                                         const std::vector<std::string>& input_names,
+                                         const std::vector<Ort::Value>& input_values,
+                                         const std::vector<std::string>& output_names) {
+  std::vector<const char*> input_ptrs{};
+  input_ptrs.reserve(input_names.size());
+  for (const auto& input : input_names) {
+    input_ptrs.push_back(input.data());
+  }
+  std::vector<const char*> output_ptrs{};
+  output_ptrs.reserve(output_names.size());
+  for (const auto& output : output_names) {
+    output_ptrs.push_back(output.data());
+  }
+
+  BlockingRunResult result;
+  auto done = result.done.get_future();
+  session.RunAsync(options, input_ptrs.data(), input_values.data(), input_ptrs.size(),
+                   output_ptrs.data(), output_ptrs.size(), OnBlockingRunComplete, &result);
+  done.wait();
+
+  if (result.error_code != ORT_OK) {
+    throw Ort::Exception(std::move(result.error_message), result.error_code);
+  }
+  return std::move(result.outputs);
+}
+
+// Run a request through the batcher of its model and wait for its batch. The batcher returns all the outputs of
+// the model, from which the requested ones are picked. The run options of the request don't apply to the batched run.
+// Returns false if the request doesn't feed all the inputs of the model, so it has to run on its own.
+static bool RunBatched(Ort::RequestBatcher& batcher,
+                       const std::vector<std::string>& model_input_names,
+                       const std::vector<std::string>& model_output_names,
+                       const std::vector<std::string>& input_names,
+                       const std::vector<Ort::Value>& input_values,
+                       const std::vector<std::string>& output_names,
+                       /* out */ std::vector<Ort::Value>& outputs) {
+  std::vector<const OrtValue*> batcher_inputs;
+  if (!GetBatcherInputs(model_input_names, input_names, input_values, batcher_inputs)) {
+    return false;
+  }
+
+  auto output_indices = GetModelOutputIndices(model_output_names, output_names);
+
+  BlockingRunResult result;
+  auto done = result.done.get_future();
+  Ort::ThrowOnError(Ort::GetApi().RequestBatcherRun(batcher, batcher_inputs.data(), batcher_inputs.size(),
+                                                    OnBlockingRunComplete, &result));
+  done.wait();
+
+  if (result.error_code != ORT_OK) {
+    throw Ort::Exception(std::move(result.error_message), result.error_code);
+  }
+
+  outputs.clear();
+  for (auto index : output_indices) {
+    outputs.push_back(std::move(result.outputs[index]));
+  }
+  return true;
+}
+
+std::vector<std::string> Executor::GetOutputNames(const ServerEnvironment::Model& model,
+                                                  const onnxruntime::server::PredictRequest& request) {
+  std::vector<std::string> output_names;
+
+  if (!request.output_filter().empty()) {
+    output_names.reserve(request.output_filter_size());
+    for (const auto& name : request.output_filter()) {
+      output_names.push_back(name);
+    }
+  } else {
+    output_names = model.output_names;
+  }
+
+  return output_names;
+}
+
+static void AddExternalData(onnx::TensorProto& tensor, const std::string& key, const std::string& value) {
+  auto* entry = tensor.add_external_data();
+  entry->set_key(key);
+  entry->set_value(value);
+}
+
+protobufutil::Status Executor::BuildResponse(std::vector<Ort::Value>& outputs,
+                                             const std::vector<std::string>& output_names,
+                                             /* out */ onnxruntime::server::PredictResponse& response) {
+  auto logger = env_->GetLogger(request_id_);
+
+  // The outputs are serialized straight into the tensors of the response, instead of being copied in afterwards.
+  auto& response_outputs = *response.mutable_outputs();
+  for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
+    if (response_outputs.count(output_names[i]) != 0) {
+      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
+    }
+
+    try {
+      auto shared_memory_output = shared_memory_outputs_.find(output_names[i]);
+      if (shared_memory_output == shared_memory_outputs_.end()) {
+        MLValueToTensorProto(outputs[i], using_raw_data_, logger, response_outputs[output_names[i]]);
+      } else {
+        const auto& range = shared_memory_output->second;
+        auto& tensor = response_outputs[output_names[i]];
+        auto length = MLValueToExternalData(outputs[i], range.data, range.length, tensor);
+        AddExternalData(tensor, "location", range.region);
+        AddExternalData(tensor, "offset", std::to_string(range.offset));
+        AddExternalData(tensor, "length", std::to_string(length));
+      }
+    } catch (const Ort::Exception& e) {
+      logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
+      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    }
+  }
+
+  return protobufutil::Status::OK;
+}
+
+// The responses of the requests in shared memory can't be cached, as the key doesn't cover the tensors.
+static bool UsesSharedMemory(const onnxruntime::server::PredictRequest& request) {
+  if (request.output_shared_memory_size() != 0) {
+    return true;
+  }
+  for (const auto& input : request.inputs()) {
+    if (input.second.data_location() == onnx::TensorProto_DataLocation_EXTERNAL) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Reject the requests beyond the queue limit of the model, so that load spikes fail fast instead of piling up.
+static protobufutil::Status QueueFullStatus() {
+  return protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED,
+                              "The model has too many queued requests. Retry later.");
+}
+
 protobufutil::Status Executor::Predict(const std::string& model_name,
                                        const std::string& model_version,
                                        const onnxruntime::server::PredictRequest& request,
                                        /* out */ onnxruntime::server::PredictResponse& response) {
-  auto logger = env_->GetLogger(request_id_);
+  // Hold the model for the whole request, so that it stays loaded even if a new version replaces it meanwhile.
+  std::shared_ptr<ServerEnvironment::Model> model;
+  try {
+    model = env_->GetModel(model_name, model_version);
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  // The repeated requests are served from the cache, without taking a slot of the model.
+  auto* cache = model->cache_responses && !UsesSharedMemory(request) ? env_->GetResponseCache() : nullptr;
+  std::string cache_key;
+  if (cache != nullptr) {
+    cache_key = ResponseCache::MakeKey(model->name, model->version, request);
+    if (cache->Lookup(cache_key, response)) {
+      return protobufutil::Status::OK;
+    }
+  }
+
+  if (!env_->TryAcquireRequestSlot(*model)) {
+    return QueueFullStatus();
+  }
+
+  struct RequestSlotGuard {
+    ServerEnvironment* env;
+    ServerEnvironment::Model& model;
+    ~RequestSlotGuard() { env->ReleaseRequestSlot(model); }
+  } slot_guard{env_, *model};
 
   // Convert PredictRequest to NameMLValMap
   MemBufferArray buffer_array;
@@ -116,45 +440,174 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
   run_options.SetRunLogVerbosityLevel(static_cast<int>(env_->GetLogSeverity()));
   run_options.SetRunTag(request_id_.c_str());
 
-  // Prepare the output names
+  std::vector<Ort::Value> outputs;
   std::vector<std::string> output_names;
+  try {
+    output_names = GetOutputNames(*model, request);
 
-  if (!request.output_filter().empty()) {
-    output_names.reserve(request.output_filter_size());
-    for (const auto& name : request.output_filter()) {
-      output_names.push_back(name);
+    auto* batcher = model->batcher.get();
+    if (batcher == nullptr ||
+        !RunBatched(*batcher, model->input_names, model->output_names,
+                    input_names, input_values, output_names, outputs)) {
+      outputs = model->max_concurrent_runs > 0
+                    ? RunQueued(model->session, run_options, input_names, input_values, output_names)
+                    : Run(model->session, run_options, input_names, input_values, output_names);
     }
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  auto status = BuildResponse(outputs, output_names, response);
+  if (cache != nullptr && status == protobufutil::Status::OK) {
+    cache->Insert(cache_key, response);
+  }
+  return status;
+}
+
+// State of a prediction between PredictAsync and the completion of its run.
+struct Executor::AsyncPrediction {
+  Executor* executor;
+  std::shared_ptr<ServerEnvironment::Model> model;
+  onnxruntime::server::PredictResponse* response;
+  std::function<void(const protobufutil::Status&)> done;
+
+  // nullptr if the response isn't cached
+  ResponseCache* cache{nullptr};
+  std::string cache_key;
+
+  // the inputs and the run options must stay alive until the run completes
+  MemBufferArray buffers;
+  std::vector<std::string> input_names;
+  std::vector<Ort::Value> input_values;
+  std::vector<std::string> output_names;
+  Ort::RunOptions run_options;
+
+  // indices of the requested outputs among the outputs of the model, for a batched run
+  bool batched{false};
+  std::vector<size_t> output_indices;
+};
+
+void ORT_API_CALL Executor::OnAsyncRunComplete(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                               OrtStatus* status) {
+  std::unique_ptr<AsyncPrediction> prediction{static_cast<AsyncPrediction*>(user_data)};
+
+  std::vector<Ort::Value> output_values;
+  output_values.reserve(num_outputs);
+  for (size_t i = 0; i < num_outputs; ++i) {
+    output_values.emplace_back(outputs[i]);
+  }
+
+  protobufutil::Status result;
+  if (status != nullptr) {
+    result = GenerateProtobufStatus(Ort::GetApi().GetErrorCode(status), Ort::GetApi().GetErrorMessage(status));
+    Ort::GetApi().ReleaseStatus(status);
+  } else if (prediction->batched) {
+    std::vector<Ort::Value> requested_outputs;
+    for (auto index : prediction->output_indices) {
+      requested_outputs.push_back(std::move(output_values[index]));
+    }
+    result = prediction->executor->BuildResponse(requested_outputs, prediction->output_names, *prediction->response);
   } else {
-    output_names = env_->GetModelOutputNames(model_name, model_version);
+    result = prediction->executor->BuildResponse(output_values, prediction->output_names, *prediction->response);
   }
 
-  std::vector<Ort::Value> outputs;
+  if (prediction->cache != nullptr && result == protobufutil::Status::OK) {
+    prediction->cache->Insert(prediction->cache_key, *prediction->response);
+  }
+
+  prediction->executor->env_->ReleaseRequestSlot(*prediction->model);
+
+  // release the inputs before handing the response back, as the request may be freed by done
+  auto done = std::move(prediction->done);
+  prediction.reset();
+  done(result);
+}
+
+void Executor::PredictAsync(const std::string& model_name,
+                            const std::string& model_version,
+                            const onnxruntime::server::PredictRequest& request,
+                            /* out */ onnxruntime::server::PredictResponse& response,
+                            std::function<void(const protobufutil::Status&)> done) {
+  std::shared_ptr<ServerEnvironment::Model> model;
   try {
-    outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
+    model = env_->GetModel(model_name, model_version);
   } catch (const Ort::Exception& e) {
-    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    done(GenerateProtobufStatus(e.GetOrtErrorCode(), e.what()));
+    return;
   }
 
-  // Build the response
-  for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
-    onnx::TensorProto output_tensor{};
-    try {
-      MLValueToTensorProto(outputs[i], using_raw_data_, logger, output_tensor);
-    } catch (const Ort::Exception& e) {
-      logger = env_->GetLogger(request_id_);
-      logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
-      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  auto* cache = model->cache_responses && !UsesSharedMemory(request) ? env_->GetResponseCache() : nullptr;
+  std::string cache_key;
+  if (cache != nullptr) {
+    cache_key = ResponseCache::MakeKey(model->name, model->version, request);
+    if (cache->Lookup(cache_key, response)) {
+      done(protobufutil::Status::OK);
+      return;
     }
+  }
 
-    auto insertion_result = response.mutable_outputs()->insert({output_names[i], output_tensor});
+  if (!env_->TryAcquireRequestSlot(*model)) {
+    done(QueueFullStatus());
+    return;
+  }
 
-    if (!insertion_result.second) {
-      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
-      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
+  auto prediction = std::make_unique<AsyncPrediction>();
+  prediction->executor = this;
+  prediction->model = std::move(model);
+  prediction->response = &response;
+  prediction->done = std::move(done);
+  prediction->cache = cache;
+  prediction->cache_key = std::move(cache_key);
+
+  auto fail = [this, &prediction](const protobufutil::Status& status) {
+    env_->ReleaseRequestSlot(*prediction->model);
+    auto done = std::move(prediction->done);
+    prediction.reset();
+    done(status);
+  };
+
+  auto conversion_status = SetNameMLValueMap(prediction->input_names, prediction->input_values, request,
+                                             prediction->buffers);
+  if (conversion_status != protobufutil::Status::OK) {
+    fail(conversion_status);
+    return;
+  }
+
+  prediction->run_options.SetRunLogVerbosityLevel(static_cast<int>(env_->GetLogSeverity()));
+  prediction->run_options.SetRunTag(request_id_.c_str());
+
+  try {
+    auto& model = *prediction->model;
+    prediction->output_names = GetOutputNames(model, request);
+
+    auto* batcher = model.batcher.get();
+    std::vector<const OrtValue*> batcher_inputs;
+    if (batcher != nullptr &&
+        GetBatcherInputs(model.input_names, prediction->input_names, prediction->input_values, batcher_inputs)) {
+      prediction->batched = true;
+      prediction->output_indices = GetModelOutputIndices(model.output_names, prediction->output_names);
+      Ort::ThrowOnError(Ort::GetApi().RequestBatcherRun(*batcher, batcher_inputs.data(), batcher_inputs.size(),
+                                                        OnAsyncRunComplete, prediction.get()));
+    } else {
+      std::vector<const char*> input_ptrs;
+      for (const auto& input : prediction->input_names) {
+        input_ptrs.push_back(input.data());
+      }
+      std::vector<const char*> output_ptrs;
+      for (const auto& output : prediction->output_names) {
+        output_ptrs.push_back(output.data());
+      }
+
+      model.session.RunAsync(prediction->run_options, input_ptrs.data(), prediction->input_values.data(), input_ptrs.size(),
+                       output_ptrs.data(), output_ptrs.size(), OnAsyncRunComplete, prediction.get());
     }
+  } catch (const Ort::Exception& e) {
+    fail(GenerateProtobufStatus(e.GetOrtErrorCode(), e.what()));
+    return;
   }
 
-  return protobufutil::Status::OK;
+  // the run owns the prediction now, and OnAsyncRunComplete frees it
+  prediction.release();
 }
 
 }  // namespace server
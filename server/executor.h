@@ -3,6 +3,11 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include <google/protobuf/stubs/status.h>
 
 #include "environment.h"
@@ -25,20 +30,62 @@ class Executor {
                                          const onnxruntime::server::PredictRequest& request,
                                          /* out */ onnxruntime::server::PredictResponse& response);
 
+  // Asynchronous prediction method. The run is queued with Session::RunAsync, or with the batcher of the model, and
+  // done is called with the status once the response is built, possibly on a thread of the session. The executor, the
+  // request and the response must stay alive until then.
+  // Requests beyond the queue limit of the model fail right away with RESOURCE_EXHAUSTED, as with Predict.
+  void PredictAsync(const std::string& model_name,
+                    const std::string& model_version,
+                    const onnxruntime::server::PredictRequest& request,
+                    /* out */ onnxruntime::server::PredictResponse& response,
+                    std::function<void(const google::protobuf::util::Status&)> done);
+
  private:
+  struct AsyncPrediction;
+
+  // An output written to a shared memory region
+  struct SharedMemoryOutput {
+    std::string region;
+    uint64_t offset;
+    char* data;
+    size_t length;
+  };
+
   ServerEnvironment* env_;
   const std::string request_id_;
   bool using_raw_data_;
+  // the shared memory regions of the request, kept mapped until its response is built
+  std::vector<std::shared_ptr<SharedMemoryRegion>> shared_memory_regions_;
+  std::unordered_map<std::string, SharedMemoryOutput> shared_memory_outputs_;
 
   google::protobuf::util::Status SetMLValue(const onnx::TensorProto& input_tensor,
                                             MemBufferArray& buffers,
                                             OrtMemoryInfo* cpu_memory_info,
                                             /* out */ Ort::Value& ml_value);
 
+  // Returns the memory of a range of a registered shared memory region, which stays mapped for the request.
+  google::protobuf::util::Status GetSharedMemoryRange(const std::string& region, uint64_t offset, uint64_t length,
+                                                      /* out */ char*& data);
+
+  // Binds an input with data_location EXTERNAL to its range of a shared memory region, without copying it.
+  google::protobuf::util::Status SetSharedMemoryMLValue(const onnx::TensorProto& input_tensor,
+                                                        OrtMemoryInfo* cpu_memory_info,
+                                                        /* out */ Ort::Value& ml_value);
+
   google::protobuf::util::Status SetNameMLValueMap(/* out */ std::vector<std::string>& input_names,
                                                    /* out */ std::vector<Ort::Value>& input_values,
                                                    const onnxruntime::server::PredictRequest& request,
                                                    MemBufferArray& buffers);
+
+  std::vector<std::string> GetOutputNames(const ServerEnvironment::Model& model,
+                                          const onnxruntime::server::PredictRequest& request);
+
+  google::protobuf::util::Status BuildResponse(std::vector<Ort::Value>& outputs,
+                                               const std::vector<std::string>& output_names,
+                                               /* out */ onnxruntime::server::PredictResponse& response);
+
+  static void ORT_API_CALL OnAsyncRunComplete(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                              OrtStatus* status);
 };
 
 }  // namespace server
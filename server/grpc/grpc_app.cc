@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "grpc_app.h"
+#include <algorithm>
 #include <grpcpp/health_check_service_interface.h>
 #include <grpcpp/ext/channelz_service_plugin.h>
 #include <grpcpp/ext/proto_server_reflection_plugin.h>
@@ -9,20 +10,125 @@ namespace onnx_grpc = onnxruntime::server::grpc;
 
 namespace onnxruntime {
 namespace server {
-GRPCApp::GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port) : prediction_service_implementation_(env) {
+
+// State of one Predict call, advanced by the events of the completion queue it was requested on.
+// It deletes itself once the response is sent or the queue shuts down.
+class GRPCApp::CallData {
+ public:
+  CallData(GRPCApp& app, ::grpc::ServerCompletionQueue* completion_queue)
+      : app_(app), completion_queue_(completion_queue), responder_(&context_) {
+    app_.service_.RequestPredict(&context_, &request_, &responder_, completion_queue_, completion_queue_, this);
+  }
+
+  // ok is false if the queue is shutting down or the call was cancelled.
+  void Proceed(bool ok) {
+    if (state_ == State::Finishing || !ok) {
+      delete this;
+      return;
+    }
+
+    // Accept the next call on this queue while this one is processed.
+    new CallData(app_, completion_queue_);
+
+    state_ = State::Processing;
+    app_.BeginPrediction();
+    auto request_id = onnx_grpc::SetRequestContext(&context_, *app_.env_);
+    executor_ = std::make_unique<Executor>(app_.env_.get(), request_id);
+
+    //TODO: (csteegz) Add modelspec for both paths.
+    executor_->PredictAsync("default", "", request_, response_, [this](const google::protobuf::util::Status& status) {
+      // this may be deleted by a queue thread as soon as Finish is called
+      auto& app = app_;
+      state_ = State::Finishing;
+      responder_.Finish(response_, onnx_grpc::ToGrpcStatus(status), this);
+      app.EndPrediction();
+    });
+  }
+
+ private:
+  enum class State {
+    WaitingForRequest,
+    Processing,
+    Finishing
+  };
+
+  GRPCApp& app_;
+  ::grpc::ServerCompletionQueue* completion_queue_;
+  ::grpc::ServerContext context_;
+  PredictRequest request_;
+  PredictResponse response_;
+  ::grpc::ServerAsyncResponseWriter<PredictResponse> responder_;
+  std::unique_ptr<Executor> executor_;
+  State state_{State::WaitingForRequest};
+};
+
+GRPCApp::GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port,
+                 int num_threads) : env_(env) {
   ::grpc::EnableDefaultHealthCheckService(true);
   ::grpc::channelz::experimental::InitChannelzService();
   ::grpc::reflection::InitProtoReflectionServerBuilderPlugin();
   ::grpc::ServerBuilder builder;
-  builder.RegisterService(&prediction_service_implementation_);
+  builder.RegisterService(&service_);
+  if (env_->GetSharedMemory() != nullptr) {
+    shared_memory_service_ = std::make_unique<onnx_grpc::SharedMemoryServiceImpl>(env_);
+    builder.RegisterService(shared_memory_service_.get());
+  }
   builder.AddListeningPort(host + ":" + std::to_string(port), ::grpc::InsecureServerCredentials());
 
+  // One completion queue per thread, so the threads don't contend on a queue.
+  for (int i = 0; i < std::max(num_threads, 1); i++) {
+    completion_queues_.push_back(builder.AddCompletionQueue());
+  }
+
   server_ = builder.BuildAndStart();
   server_->GetHealthCheckService()->SetServingStatus(PredictionService::service_full_name(), true);
+
+  for (auto& completion_queue : completion_queues_) {
+    new CallData(*this, completion_queue.get());
+    threads_.emplace_back(&GRPCApp::HandleRpcs, this, completion_queue.get());
+  }
+}
+
+GRPCApp::~GRPCApp() {
+  server_->Shutdown();
+
+  // The predictions still running send their responses to the queues, so wait for them before shutting the queues down.
+  {
+    std::unique_lock<std::mutex> lock(predictions_mutex_);
+    predictions_cv_.wait(lock, [this] { return active_predictions_ == 0; });
+  }
+
+  for (auto& completion_queue : completion_queues_) {
+    completion_queue->Shutdown();
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
 }
 
 void GRPCApp::Run() {
   server_->Wait();
 }
+
+void GRPCApp::HandleRpcs(::grpc::ServerCompletionQueue* completion_queue) {
+  void* tag;
+  bool ok;
+  while (completion_queue->Next(&tag, &ok)) {
+    static_cast<CallData*>(tag)->Proceed(ok);
+  }
+}
+
+void GRPCApp::BeginPrediction() {
+  std::lock_guard<std::mutex> lock(predictions_mutex_);
+  ++active_predictions_;
+}
+
+void GRPCApp::EndPrediction() {
+  std::lock_guard<std::mutex> lock(predictions_mutex_);
+  if (--active_predictions_ == 0) {
+    predictions_cv_.notify_all();
+  }
+}
+
 }  // namespace server
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -2,16 +2,24 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <grpcpp/grpcpp.h>
 #include "prediction_service_impl.h"
 #include "environment.h"
 
 namespace onnxruntime {
 namespace server {
+// Serves the PredictionService asynchronously: a fixed number of threads poll the completion queues and hand the
+// requests to Executor::PredictAsync, so no thread is blocked while a request runs.
 class GRPCApp {
  public:
-  GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port);
-  ~GRPCApp() = default;
+  GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port,
+          int num_threads = 1);
+  ~GRPCApp();
   GRPCApp(const GRPCApp& other) = delete;
   GRPCApp(GRPCApp&& other) = delete;
 
@@ -21,8 +29,24 @@ class GRPCApp {
   void Run();
 
  private:
-  grpc::PredictionServiceImpl prediction_service_implementation_;
+  class CallData;
+
+  void HandleRpcs(::grpc::ServerCompletionQueue* completion_queue);
+  void BeginPrediction();
+  void EndPrediction();
+
+  std::shared_ptr<onnxruntime::server::ServerEnvironment> env_;
+  PredictionService::AsyncService service_;
+  // nullptr if shared memory isn't enabled
+  std::unique_ptr<onnxruntime::server::grpc::SharedMemoryServiceImpl> shared_memory_service_;
+  std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> completion_queues_;
   std::unique_ptr<::grpc::Server> server_;
+  std::vector<std::thread> threads_;
+
+  // predictions whose response hasn't been sent yet, which must complete before the queues shut down
+  std::mutex predictions_mutex_;
+  std::condition_variable predictions_cv_;
+  size_t active_predictions_{0};
 };
 }  // namespace server
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "prediction_service_impl.h"
 #include "request_id.h"
+#include "shared_memory.h"
 
 namespace onnxruntime {
 namespace server {
@@ -11,21 +12,39 @@ namespace grpc {
 PredictionServiceImpl::PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env) : environment_(env) {}
 
 ::grpc::Status PredictionServiceImpl::Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response) {
-  auto request_id = SetRequestContext(context);
+  auto request_id = SetRequestContext(context, *environment_);
   onnxruntime::server::Executor executor(environment_.get(), request_id);
   //TODO: (csteegz) Add modelspec for both paths.
-  auto status = executor.Predict("default", "1", *request, *response);  // Currently only support one model so hard coded.
+  auto status = executor.Predict("default", "", *request, *response);  // Currently only support one model so hard coded.
+  return ToGrpcStatus(status);
+}
+
+SharedMemoryServiceImpl::SharedMemoryServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env) : environment_(env) {}
+
+::grpc::Status SharedMemoryServiceImpl::RegisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::RegisterSharedMemoryRequest* request, ::onnxruntime::server::RegisterSharedMemoryResponse* /* response */) {
+  auto request_id = SetRequestContext(context, *environment_);
+  environment_->GetLogger(request_id)->info("Register shared memory region: {}", request->name());
+  return ToGrpcStatus(onnxruntime::server::RegisterSharedMemory(environment_->GetSharedMemory(), *request));
+}
+
+::grpc::Status SharedMemoryServiceImpl::UnregisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::UnregisterSharedMemoryRequest* request, ::onnxruntime::server::UnregisterSharedMemoryResponse* /* response */) {
+  auto request_id = SetRequestContext(context, *environment_);
+  environment_->GetLogger(request_id)->info("Unregister shared memory region: {}", request->name());
+  return ToGrpcStatus(onnxruntime::server::UnregisterSharedMemory(environment_->GetSharedMemory(), *request));
+}
+
+::grpc::Status ToGrpcStatus(const google::protobuf::util::Status& status) {
   if (!status.ok()) {
     return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
   }
   return ::grpc::Status::OK;
 }
 
-std::string PredictionServiceImpl::SetRequestContext(::grpc::ServerContext* context) {
+std::string SetRequestContext(::grpc::ServerContext* context, const onnxruntime::server::ServerEnvironment& env) {
   auto metadata = context->client_metadata();
   auto request_id = util::InternalRequestId();
   context->AddInitialMetadata(util::MS_REQUEST_ID_HEADER, request_id);
-  auto logger = environment_->GetLogger(request_id);
+  auto logger = env.GetLogger(request_id);
   auto search = metadata.find(util::MS_CLIENT_REQUEST_ID_HEADER);
   if (search != metadata.end()) {
     std::string id{search->second.data(), search->second.length()};
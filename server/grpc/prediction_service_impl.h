@@ -10,6 +10,13 @@
 namespace onnxruntime {
 namespace server {
 namespace grpc {
+
+//Extract customer request ID and set request ID for response.
+std::string SetRequestContext(::grpc::ServerContext* context, const onnxruntime::server::ServerEnvironment& env);
+
+// Converts the status of a prediction to the status of the RPC.
+::grpc::Status ToGrpcStatus(const google::protobuf::util::Status& status);
+
 class PredictionServiceImpl final : public onnxruntime::server::PredictionService::Service {
  public:
   PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env);
@@ -17,9 +24,17 @@ class PredictionServiceImpl final : public onnxruntime::server::PredictionServic
 
  private:
   std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
+};
 
-  //Extract customer request ID and set request ID for response.
-  std::string SetRequestContext(::grpc::ServerContext* context);
+// Registration of the shared memory regions of the clients. The calls are rare, so the service is synchronous.
+class SharedMemoryServiceImpl final : public onnxruntime::server::SharedMemoryService::Service {
+ public:
+  SharedMemoryServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env);
+  ::grpc::Status RegisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::RegisterSharedMemoryRequest* request, ::onnxruntime::server::RegisterSharedMemoryResponse* response) override;
+  ::grpc::Status UnregisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::UnregisterSharedMemoryRequest* request, ::onnxruntime::server::UnregisterSharedMemoryResponse* response) override;
+
+ private:
+  std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
 };
 }  // namespace grpc
 }  // namespace server
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include <boost/beast/http.hpp>
@@ -33,6 +34,20 @@ class HttpContext {
 
   ~HttpContext() = default;
   HttpContext(const HttpContext&) = delete;
+
+  // Lets the handler respond later, for example once the model run of the request completes: the response isn't sent
+  // when the handler returns, but when the returned function is called, from any thread. The context stays alive
+  // until then. The handler must not throw once it has deferred the response.
+  std::function<void()> Defer() {
+    deferred_ = true;
+    return on_complete_;
+  }
+
+ private:
+  friend class HttpSession;
+
+  bool deferred_{false};
+  std::function<void()> on_complete_;
 };
 
 }  // namespace server
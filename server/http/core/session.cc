@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <boost/asio/post.hpp>
+
 #include "session.h"
 
 namespace onnxruntime {
@@ -93,23 +95,41 @@ void HttpSession::Send(Msg&& msg) {
 
 template <typename Body, typename Allocator>
 void HttpSession::HandleRequest(http::request<Body, http::basic_fields<Allocator> >&& req) {
-  HttpContext context{};
+  context_ = std::make_shared<HttpContext>();
+  auto& context = *context_;
   context.request = std::move(req);
 
   // Special handle the liveness probe endpoint for orchestration systems like Kubernetes.
   if (context.request.method() == http::verb::get && context.request.target().to_string() == "/") {
     context.response.body() = "Healthy";
   } else {
+    // A deferred response is sent on the strand of the session, whichever thread completes it
+    auto self = shared_from_this();
+    context.on_complete_ = [self]() {
+      net::post(self->strand_, [self]() { self->FinishRequest(); });
+    };
+
     auto status = ExecuteUserFunction(context);
+    if (context.deferred_) {
+      return;
+    }
 
     if (status != http::status::ok) {
       routes_.on_error(context);
     }
   }
 
-  context.response.keep_alive(context.request.keep_alive());
-  context.response.prepare_payload();
-  return Send(std::move(context.response));
+  FinishRequest();
+}
+
+void HttpSession::FinishRequest() {
+  // Releasing the context also releases the completion function, which holds the session
+  auto context = std::move(context_);
+  context->on_complete_ = nullptr;
+
+  context->response.keep_alive(context->request.keep_alive());
+  context->response.prepare_payload();
+  return Send(std::move(context->response));
 }
 
 http::status HttpSession::ExecuteUserFunction(HttpContext& context) {
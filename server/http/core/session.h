@@ -41,6 +41,8 @@ class HttpSession : public std::enable_shared_from_this<HttpSession> {
   beast::flat_buffer buffer_;
   boost::optional<http::request_parser<http::string_body>> req_;
   std::shared_ptr<void> res_{nullptr};
+  // the context of the request being handled, kept until its response is sent
+  std::shared_ptr<HttpContext> context_{nullptr};
 
   // Writes the message asynchronously back to the socket
   // Stores the pointer to the message and the class itself so that
@@ -56,6 +58,9 @@ class HttpSession : public std::enable_shared_from_this<HttpSession> {
   template <typename Body, typename Allocator>
   void HandleRequest(http::request<Body, http::basic_fields<Allocator>>&& req);
 
+  // Sends the response of the current request, once its handler is done with it
+  void FinishRequest();
+
   // Handle the request and hand it off to the user's function
   // Execute user function, handle errors
   // HttpContext parameter can be updated here or in HandleRequest
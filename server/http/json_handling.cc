@@ -1,12 +1,20 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
+#include <limits>
+#include <sstream>
+#include <type_traits>
 
 #include <boost/beast/core.hpp>
 #include <google/protobuf/util/json_util.h>
 
+#include "onnx-ml.pb.h"
 #include "predict.pb.h"
 #include "json_handling.h"
 
@@ -15,7 +23,388 @@ namespace protobufutil = google::protobuf::util;
 namespace onnxruntime {
 namespace server {
 
+// Streaming parser of the common shape of the PredictRequest JSON, which writes the numbers of each tensor straight
+// into its data field instead of transcoding the whole document through the protobuf JSON utilities.
+// It gives up on anything unusual (unicode escapes, null values, fields of TensorProto it doesn't handle, invalid
+// input), and the caller then falls back to JsonStringToMessage, which also reports the errors.
+class JsonRequestParser {
+ public:
+  explicit JsonRequestParser(const std::string& json) : p_(json.c_str()), end_(json.c_str() + json.size()) {}
+
+  bool Parse(/* out */ onnxruntime::server::PredictRequest& request) {
+    if (!ParseObject([this, &request](const std::string& key) {
+          if (key == "inputs") {
+            return ParseObject([this, &request](const std::string& name) {
+              auto& tensor = (*request.mutable_inputs())[name];
+              tensor.Clear();
+              return ParseTensor(tensor);
+            });
+          } else if (key == "outputFilter" || key == "output_filter") {
+            request.clear_output_filter();
+            return ParseArray([this, &request]() { return ParseString(*request.add_output_filter()); });
+          } else if (key == "outputSharedMemory" || key == "output_shared_memory") {
+            // left to JsonStringToMessage
+            return false;
+          }
+          // unknown fields are ignored, as by JsonStringToMessage
+          return SkipValue(0);
+        })) {
+      return false;
+    }
+
+    SkipWhitespace();
+    return p_ == end_;
+  }
+
+ private:
+  bool ParseTensor(onnx::TensorProto& tensor) {
+    return ParseObject([this, &tensor](const std::string& key) {
+      if (key == "dims") {
+        return ParseArray([this, &tensor]() {
+          int64_t dim;
+          if (!ParseInteger(dim)) {
+            return false;
+          }
+          tensor.add_dims(dim);
+          return true;
+        });
+      } else if (key == "dataType" || key == "data_type") {
+        return ParseDataType(tensor);
+      } else if (key == "floatData" || key == "float_data") {
+        return ParseArray([this, &tensor]() { return ParseFloat(*AddElement(*tensor.mutable_float_data())); });
+      } else if (key == "doubleData" || key == "double_data") {
+        return ParseArray([this, &tensor]() { return ParseFloat(*AddElement(*tensor.mutable_double_data())); });
+      } else if (key == "int32Data" || key == "int32_data") {
+        return ParseArray([this, &tensor]() { return ParseInteger(*AddElement(*tensor.mutable_int32_data())); });
+      } else if (key == "int64Data" || key == "int64_data") {
+        return ParseArray([this, &tensor]() { return ParseInteger(*AddElement(*tensor.mutable_int64_data())); });
+      } else if (key == "uint64Data" || key == "uint64_data") {
+        return ParseArray([this, &tensor]() { return ParseInteger(*AddElement(*tensor.mutable_uint64_data())); });
+      } else if (key == "rawData" || key == "raw_data") {
+        std::string encoded;
+        return ParseString(encoded) && DecodeBase64(encoded, *tensor.mutable_raw_data());
+      } else if (key == "name") {
+        return ParseString(*tensor.mutable_name());
+      } else if (key == "docString" || key == "doc_string") {
+        return ParseString(*tensor.mutable_doc_string());
+      }
+      return false;
+    });
+  }
+
+  template <typename T>
+  static T* AddElement(google::protobuf::RepeatedField<T>& field) {
+    return field.Add();
+  }
+
+  bool ParseDataType(onnx::TensorProto& tensor) {
+    SkipWhitespace();
+    int64_t value;
+    if (p_ != end_ && *p_ == '"') {
+      std::string name;
+      onnx::TensorProto_DataType data_type;
+      if (!ParseString(name) || !onnx::TensorProto_DataType_Parse(name, &data_type)) {
+        return false;
+      }
+      value = data_type;
+    } else if (!ParseInteger(value)) {
+      return false;
+    }
+
+    if (!onnx::TensorProto_DataType_IsValid(static_cast<int>(value))) {
+      return false;
+    }
+    tensor.set_data_type(static_cast<int32_t>(value));
+    return true;
+  }
+
+  void SkipWhitespace() {
+    while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+      ++p_;
+    }
+  }
+
+  bool Consume(char c) {
+    SkipWhitespace();
+    if (p_ == end_ || *p_ != c) {
+      return false;
+    }
+    ++p_;
+    return true;
+  }
+
+  // Calls parse_member(key) on each member, which must consume the value.
+  template <typename F>
+  bool ParseObject(F&& parse_member) {
+    if (!Consume('{')) {
+      return false;
+    }
+    if (Consume('}')) {
+      return true;
+    }
+
+    do {
+      std::string key;
+      if (!ParseString(key) || !Consume(':') || !parse_member(key)) {
+        return false;
+      }
+    } while (Consume(','));
+
+    return Consume('}');
+  }
+
+  // Calls parse_element() on each element, which must consume it.
+  template <typename F>
+  bool ParseArray(F&& parse_element) {
+    if (!Consume('[')) {
+      return false;
+    }
+    if (Consume(']')) {
+      return true;
+    }
+
+    do {
+      if (!parse_element()) {
+        return false;
+      }
+    } while (Consume(','));
+
+    return Consume(']');
+  }
+
+  bool ParseString(std::string& value) {
+    if (!Consume('"')) {
+      return false;
+    }
+
+    value.clear();
+    while (p_ != end_ && *p_ != '"') {
+      if (*p_ != '\\') {
+        value.push_back(*p_++);
+        continue;
+      }
+
+      if (++p_ == end_) {
+        return false;
+      }
+      switch (*p_++) {
+        case '"':
+          value.push_back('"');
+          break;
+        case '\\':
+          value.push_back('\\');
+          break;
+        case '/':
+          value.push_back('/');
+          break;
+        case 'b':
+          value.push_back('\b');
+          break;
+        case 'f':
+          value.push_back('\f');
+          break;
+        case 'n':
+          value.push_back('\n');
+          break;
+        case 'r':
+          value.push_back('\r');
+          break;
+        case 't':
+          value.push_back('\t');
+          break;
+        default:
+          // \u escapes are left to JsonStringToMessage
+          return false;
+      }
+    }
+
+    if (p_ == end_) {
+      return false;
+    }
+    ++p_;
+    return true;
+  }
+
+  // Returns the characters of a number, quoted or not, as proto3 JSON allows both.
+  bool ParseNumberToken(std::string& quoted, const char*& begin, const char*& end) {
+    SkipWhitespace();
+    if (p_ != end_ && *p_ == '"') {
+      if (!ParseString(quoted)) {
+        return false;
+      }
+      begin = quoted.c_str();
+      end = begin + quoted.size();
+      return !quoted.empty();
+    }
+
+    begin = p_;
+    while (p_ != end_ && (std::isdigit(static_cast<unsigned char>(*p_)) ||
+                          *p_ == '-' || *p_ == '+' || *p_ == '.' || *p_ == 'e' || *p_ == 'E')) {
+      ++p_;
+    }
+    end = p_;
+    return begin != end;
+  }
+
+  static bool IsNumber(const char* begin, const char* end) {
+    if (begin == end || (!std::isdigit(static_cast<unsigned char>(*begin)) && *begin != '-')) {
+      return false;
+    }
+    return std::all_of(begin, end, [](char c) {
+      return std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    });
+  }
+
+  static float StringToFloat(const char* begin, char** end, float) { return std::strtof(begin, end); }
+  static double StringToFloat(const char* begin, char** end, double) { return std::strtod(begin, end); }
+
+  // The token is followed by a character that can't be part of a number, or by the terminating null, so strtof and
+  // strtoll stop at its end.
+  template <typename T>
+  bool ParseFloat(T& value) {
+    std::string quoted;
+    const char* begin;
+    const char* end;
+    if (!ParseNumberToken(quoted, begin, end)) {
+      return false;
+    }
+
+    if (quoted == "NaN") {
+      value = std::numeric_limits<T>::quiet_NaN();
+      return true;
+    } else if (quoted == "Infinity") {
+      value = std::numeric_limits<T>::infinity();
+      return true;
+    } else if (quoted == "-Infinity") {
+      value = -std::numeric_limits<T>::infinity();
+      return true;
+    }
+
+    if (!IsNumber(begin, end)) {
+      return false;
+    }
+    char* parsed_end;
+    value = StringToFloat(begin, &parsed_end, T{});
+    return parsed_end == end;
+  }
+
+  template <typename T>
+  bool ParseInteger(T& value) {
+    std::string quoted;
+    const char* begin;
+    const char* end;
+    if (!ParseNumberToken(quoted, begin, end)) {
+      return false;
+    }
+
+    if (!IsNumber(begin, end)) {
+      return false;
+    }
+
+    char* parsed_end;
+    errno = 0;
+    if (std::is_signed<T>::value) {
+      auto parsed = std::strtoll(begin, &parsed_end, 10);
+      if (parsed < static_cast<long long>(std::numeric_limits<T>::min()) ||
+          parsed > static_cast<long long>(std::numeric_limits<T>::max())) {
+        return false;
+      }
+      value = static_cast<T>(parsed);
+    } else {
+      if (!std::isdigit(static_cast<unsigned char>(*begin))) {
+        return false;
+      }
+      auto parsed = std::strtoull(begin, &parsed_end, 10);
+      if (parsed > static_cast<unsigned long long>(std::numeric_limits<T>::max())) {
+        return false;
+      }
+      value = static_cast<T>(parsed);
+    }
+    return errno == 0 && parsed_end == end;
+  }
+
+  bool SkipValue(int depth) {
+    // deeply nested unknown values are left to JsonStringToMessage
+    if (depth > 32) {
+      return false;
+    }
+
+    SkipWhitespace();
+    if (p_ == end_) {
+      return false;
+    }
+
+    switch (*p_) {
+      case '{':
+        return ParseObject([this, depth](const std::string&) { return SkipValue(depth + 1); });
+      case '[':
+        return ParseArray([this, depth]() { return SkipValue(depth + 1); });
+      case '"': {
+        std::string value;
+        return ParseString(value);
+      }
+      default: {
+        double value;
+        for (const char* literal : {"true", "false"}) {
+          auto length = std::strlen(literal);
+          if (static_cast<size_t>(end_ - p_) >= length && std::strncmp(p_, literal, length) == 0) {
+            p_ += length;
+            return true;
+          }
+        }
+        return ParseFloat(value);
+      }
+    }
+  }
+
+  static bool DecodeBase64(const std::string& encoded, std::string& decoded) {
+    auto decode_char = [](char c) -> int {
+      if (c >= 'A' && c <= 'Z') return c - 'A';
+      if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+      if (c >= '0' && c <= '9') return c - '0' + 52;
+      if (c == '+' || c == '-') return 62;
+      if (c == '/' || c == '_') return 63;
+      return -1;
+    };
+
+    auto length = encoded.size();
+    while (length > 0 && encoded[length - 1] == '=') {
+      --length;
+    }
+    if (encoded.size() - length > 2 || length % 4 == 1) {
+      return false;
+    }
+
+    decoded.clear();
+    decoded.reserve(length * 3 / 4);
+    uint32_t bits = 0;
+    int bit_count = 0;
+    for (size_t i = 0; i < length; ++i) {
+      auto value = decode_char(encoded[i]);
+      if (value < 0) {
+        return false;
+      }
+      bits = (bits << 6) | static_cast<uint32_t>(value);
+      bit_count += 6;
+      if (bit_count >= 8) {
+        bit_count -= 8;
+        decoded.push_back(static_cast<char>((bits >> bit_count) & 0xFF));
+      }
+    }
+    return true;
+  }
+
+  const char* p_;
+  const char* const end_;
+};
+
 protobufutil::Status GetRequestFromJson(const std::string& json_string, /* out */ onnxruntime::server::PredictRequest& request) {
+  JsonRequestParser parser(json_string);
+  if (parser.Parse(request)) {
+    return protobufutil::Status::OK;
+  }
+
+  request.Clear();
   protobufutil::JsonParseOptions options;
   options.ignore_unknown_fields = true;
 
@@ -39,6 +428,22 @@ std::string CreateJsonError(const http::status error_code, const std::string& er
   return R"({"error_code": )" + std::to_string(int(error_code)) + R"(, "error_message": ")" + escaped_message + R"("})" + "\n";
 }
 
+std::string CreateJsonResponseCacheStats(const ResponseCache::Stats& stats) {
+  auto lookups = stats.hits + stats.misses;
+  auto hit_rate = lookups == 0 ? 0.0 : static_cast<double>(stats.hits) / lookups;
+
+  std::ostringstream o;
+  o << R"({"hits": )" << stats.hits
+    << R"(, "misses": )" << stats.misses
+    << R"(, "hit_rate": )" << hit_rate
+    << R"(, "insertions": )" << stats.insertions
+    << R"(, "evictions": )" << stats.evictions
+    << R"(, "expirations": )" << stats.expirations
+    << R"(, "entries": )" << stats.entries
+    << R"(, "bytes": )" << stats.bytes << "}\n";
+  return o.str();
+}
+
 std::string escape_string(const std::string& message) {
   std::ostringstream o;
   for (char c : message) {
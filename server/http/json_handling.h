@@ -7,6 +7,7 @@
 #include <boost/beast/http.hpp>
 
 #include "predict.pb.h"
+#include "response_cache.h"
 
 namespace onnxruntime {
 namespace server {
@@ -25,6 +26,9 @@ google::protobuf::util::Status GenerateResponseInJson(const onnxruntime::server:
 // Constructs JSON error message from error code object and error message
 std::string CreateJsonError(http::status error_code, const std::string& error_message);
 
+// Constructs JSON message from the statistics of the response cache, with the hit rate of the lookups
+std::string CreateJsonResponseCacheStats(const ResponseCache::Stats& stats);
+
 // Escapes a string following the JSON standard
 // Mostly taken from here: https://stackoverflow.com/questions/7724448/simple-json-string-escape-for-c/33799784#33799784
 std::string escape_string(const std::string& message);
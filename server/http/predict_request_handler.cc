@@ -2,17 +2,22 @@
 // Licensed under the MIT License.
 
 #include <google/protobuf/stubs/status.h>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #include "environment.h"
 #include "http_server.h"
 #include "json_handling.h"
+#include "tensor_payload.h"
 #include "executor.h"
+#include "shared_memory.h"
 #include "util.h"
 
 namespace onnxruntime {
 namespace server {
 
 namespace protobufutil = google::protobuf::util;
+namespace net = boost::asio;
 
 #define GenerateErrorResponse(logger, error_code, message, context)                              \
   {                                                                                              \
@@ -30,6 +35,20 @@ namespace protobufutil = google::protobuf::util;
 
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type,
                                 /* out */ PredictRequest& predictRequest, /* out */ http::status& error_code, /* out */ std::string& error_message);
+static void WriteResponse(const std::shared_ptr<spdlog::logger>& logger, SupportedContentType response_type,
+                          const PredictResponse& predict_response, /* in, out */ HttpContext& context);
+
+// The state of a request going through the stages of PredictPipelined
+struct PipelinedPrediction {
+  std::string name;
+  std::string version;
+  SupportedContentType request_type;
+  SupportedContentType response_type;
+  PredictRequest request;
+  PredictResponse response;
+  std::unique_ptr<Executor> executor;
+  std::function<void()> complete;
+};
 
 void Predict(const std::string& name,
              const std::string& version,
@@ -40,7 +59,8 @@ void Predict(const std::string& name,
   logger->info("Model Name: {}, Version: {}, Action: {}", name, version, action);
 
   auto effective_name = name.empty() ? "default" : name;
-  auto effective_version = version.empty() ? "1" : version;
+  // no version selects the version served for the model
+  auto effective_version = version;
 
   if (!context.client_request_id.empty()) {
     logger->info("{}: [{}]", util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
@@ -73,15 +93,129 @@ void Predict(const std::string& name,
     return;
   }
 
+  WriteResponse(logger, response_type, predict_response, context);
+};
+
+void PredictPipelined(const std::string& name,
+                      const std::string& version,
+                      const std::string& action,
+                      /* in, out */ HttpContext& context,
+                      const std::shared_ptr<ServerEnvironment>& env,
+                      net::thread_pool& codec_pool) {
+  auto logger = env->GetLogger(context.request_id);
+  logger->info("Model Name: {}, Version: {}, Action: {}", name, version, action);
+
+  if (!context.client_request_id.empty()) {
+    logger->info("{}: [{}]", util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+
+  auto prediction = std::make_shared<PipelinedPrediction>();
+  prediction->name = name.empty() ? "default" : name;
+  prediction->version = version;
+  prediction->request_type = GetRequestContentType(context);
+  prediction->response_type = GetResponseContentType(context);
+  if (prediction->response_type == SupportedContentType::Unknown) {
+    GenerateErrorResponse(logger, http::status::bad_request, "Unknown 'Accept' header field in the request", context);
+    return;
+  }
+
+  // The context stays alive until the response is completed
+  prediction->complete = context.Defer();
+  net::post(codec_pool, [prediction, logger, env, &context, &codec_pool]() {
+    http::status error_code;
+    std::string error_message;
+    if (!ParseRequestPayload(context, prediction->request_type, prediction->request, error_code, error_message)) {
+      GenerateErrorResponse(logger, error_code, error_message, context);
+      prediction->complete();
+      return;
+    }
+
+    prediction->executor = std::make_unique<Executor>(env.get(), context.request_id);
+    prediction->executor->PredictAsync(
+        prediction->name, prediction->version, prediction->request, prediction->response,
+        [prediction, logger, &context, &codec_pool](const protobufutil::Status& status) {
+          if (!status.ok()) {
+            GenerateErrorResponse(logger, GetHttpStatusCode(status), status.error_message(), context);
+            prediction->complete();
+            return;
+          }
+
+          // Leave the thread of the session to the next run
+          net::post(codec_pool, [prediction, logger, &context]() {
+            WriteResponse(logger, prediction->response_type, prediction->response, context);
+            prediction->complete();
+          });
+        });
+  });
+}
+
+void SharedMemory(const std::string& name,
+                  const std::string& action,
+                  /* in, out */ HttpContext& context,
+                  const std::shared_ptr<ServerEnvironment>& env) {
+  auto logger = env->GetLogger(context.request_id);
+  logger->info("Shared Memory Region: {}, Action: {}", name, action);
+
+  protobufutil::Status status;
+  if (action == "register") {
+    RegisterSharedMemoryRequest request{};
+    auto body = context.request.body();
+    auto request_type = GetRequestContentType(context);
+    if (request_type == SupportedContentType::Json) {
+      protobufutil::JsonParseOptions options;
+      options.ignore_unknown_fields = true;
+      status = protobufutil::JsonStringToMessage(body, &request, options);
+    } else if (request_type == SupportedContentType::PbByteArray) {
+      if (!request.ParseFromArray(body.data(), static_cast<int>(body.size()))) {
+        status = protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Invalid payload.");
+      }
+    } else {
+      status = protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                    "Missing or unknown 'Content-Type' header field in the request");
+    }
+
+    if (status.ok()) {
+      request.set_name(name);
+      status = RegisterSharedMemory(env->GetSharedMemory(), request);
+    }
+  } else {
+    UnregisterSharedMemoryRequest request{};
+    request.set_name(name);
+    status = UnregisterSharedMemory(env->GetSharedMemory(), request);
+  }
+
+  if (!status.ok()) {
+    GenerateErrorResponse(logger, GetHttpStatusCode(status), status.error_message(), context);
+    return;
+  }
+
+  context.response.set(http::field::content_type, "application/json");
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+  context.response.body() = "{}\n";
+  context.response.result(http::status::ok);
+}
+
+static void WriteResponse(const std::shared_ptr<spdlog::logger>& logger, SupportedContentType response_type,
+                          const PredictResponse& predict_response, /* in, out */ HttpContext& context) {
   // Serialize to proper output format
   std::string response_body{};
   if (response_type == SupportedContentType::Json) {
-    status = GenerateResponseInJson(predict_response, response_body);
+    auto status = GenerateResponseInJson(predict_response, response_body);
     if (!status.ok()) {
       GenerateErrorResponse(logger, http::status::internal_server_error, status.error_message(), context);
       return;
     }
     context.response.set(http::field::content_type, "application/json");
+  } else if (response_type == SupportedContentType::TensorPayload) {
+    auto status = GenerateResponseInTensorPayload(predict_response, response_body);
+    if (!status.ok()) {
+      GenerateErrorResponse(logger, GetHttpStatusCode(status), status.error_message(), context);
+      return;
+    }
+    context.response.set(http::field::content_type, kTensorPayloadMimeType);
   } else {
     response_body = predict_response.SerializeAsString();
     if (context.request.find("Accept") != context.request.end() && context.request["Accept"] != "*/*") {
@@ -98,7 +232,7 @@ void Predict(const std::string& name,
   }
   context.response.body() = response_body;
   context.response.result(http::status::ok);
-};
+}
 
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type, PredictRequest& predictRequest, http::status& error_code, std::string& error_message) {
   auto body = context.request.body();
@@ -113,6 +247,15 @@ static bool ParseRequestPayload(const HttpContext& context, SupportedContentType
       }
       break;
     }
+    case SupportedContentType::TensorPayload: {
+      status = GetRequestFromTensorPayload(body, predictRequest);
+      if (!status.ok()) {
+        error_code = GetHttpStatusCode(status);
+        error_message = status.error_message();
+        return false;
+      }
+      break;
+    }
     case SupportedContentType::PbByteArray: {
       bool parse_succeeded = predictRequest.ParseFromArray(body.data(), static_cast<int>(body.size()));
       if (!parse_succeeded) {
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <boost/asio/thread_pool.hpp>
+
 #include "http_server.h"
 #include "json_handling.h"
 
@@ -19,5 +21,22 @@ void Predict(const std::string& name,
              /* in, out */ HttpContext& context,
              const std::shared_ptr<ServerEnvironment>& env);
 
+// Predict as a pipeline of stages: the payload is decoded and the response encoded on codec_pool, and the model runs
+// with Executor::PredictAsync in between, so the HTTP threads only route the requests and the decoding and encoding
+// of requests overlap with the runs of others. The response is deferred until the last stage completes.
+void PredictPipelined(const std::string& name,
+                      const std::string& version,
+                      const std::string& action,
+                      /* in, out */ HttpContext& context,
+                      const std::shared_ptr<ServerEnvironment>& env,
+                      boost::asio::thread_pool& codec_pool);
+
+// Register (action "register") or unregister (action "unregister") the shared memory region name of a client.
+// The body of a registration is a JSON or protobuf RegisterSharedMemoryRequest, whose name is taken from the URL.
+void SharedMemory(const std::string& name,
+                  const std::string& action,
+                  /* in, out */ HttpContext& context,
+                  const std::shared_ptr<ServerEnvironment>& env);
+
 }  // namespace server
 }  // namespace onnxruntime
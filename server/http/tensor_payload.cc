@@ -0,0 +1,163 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <google/protobuf/stubs/status.h>
+
+#include "onnx-ml.pb.h"
+#include "predict.pb.h"
+#include "tensor_payload.h"
+
+namespace protobufutil = google::protobuf::util;
+
+namespace onnxruntime {
+namespace server {
+
+namespace {
+
+// Reads the payload, failing once past its end.
+class PayloadReader {
+ public:
+  explicit PayloadReader(const std::string& payload) : p_(payload.data()), end_(payload.data() + payload.size()) {}
+
+  // Integers are assembled byte by byte, so the reads don't depend on the endianness of the host.
+  template <typename T>
+  bool Read(T& value) {
+    if (static_cast<size_t>(end_ - p_) < sizeof(T)) {
+      return false;
+    }
+
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      bits |= static_cast<uint64_t>(static_cast<uint8_t>(p_[i])) << (8 * i);
+    }
+    p_ += sizeof(T);
+    value = static_cast<T>(bits);
+    return true;
+  }
+
+  bool ReadBytes(uint64_t size, std::string& bytes) {
+    if (static_cast<uint64_t>(end_ - p_) < size) {
+      return false;
+    }
+
+    bytes.assign(p_, static_cast<size_t>(size));
+    p_ += size;
+    return true;
+  }
+
+  bool ReadString(std::string& value) {
+    uint32_t length;
+    return Read(length) && ReadBytes(length, value);
+  }
+
+  bool AtEnd() const { return p_ == end_; }
+
+ private:
+  const char* p_;
+  const char* const end_;
+};
+
+template <typename T>
+void Write(T value, std::string& payload) {
+  auto bits = static_cast<uint64_t>(value);
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    payload.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+  }
+}
+
+void WriteString(const std::string& value, std::string& payload) {
+  Write(static_cast<uint32_t>(value.size()), payload);
+  payload.append(value);
+}
+
+protobufutil::Status InvalidPayload(const std::string& message) {
+  return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Invalid tensor payload: " + message);
+}
+
+}  // namespace
+
+protobufutil::Status GetRequestFromTensorPayload(const std::string& payload, /* out */ onnxruntime::server::PredictRequest& request) {
+  PayloadReader reader(payload);
+
+  uint32_t tensor_count;
+  if (!reader.Read(tensor_count)) {
+    return InvalidPayload("missing tensor count");
+  }
+
+  auto& inputs = *request.mutable_inputs();
+  for (uint32_t i = 0; i < tensor_count; ++i) {
+    std::string name;
+    int32_t data_type;
+    uint32_t rank;
+    if (!reader.ReadString(name) || !reader.Read(data_type) || !reader.Read(rank)) {
+      return InvalidPayload("truncated tensor header");
+    }
+
+    if (!onnx::TensorProto_DataType_IsValid(data_type) || data_type == onnx::TensorProto_DataType_UNDEFINED ||
+        data_type == onnx::TensorProto_DataType_STRING) {
+      return InvalidPayload("unsupported data type " + std::to_string(data_type) + " of tensor " + name);
+    }
+
+    auto& tensor = inputs[name];
+    tensor.Clear();
+    tensor.set_data_type(data_type);
+    for (uint32_t d = 0; d < rank; ++d) {
+      int64_t dim;
+      if (!reader.Read(dim)) {
+        return InvalidPayload("truncated dims of tensor " + name);
+      }
+      tensor.add_dims(dim);
+    }
+
+    uint64_t byte_size;
+    if (!reader.Read(byte_size) || !reader.ReadBytes(byte_size, *tensor.mutable_raw_data())) {
+      return InvalidPayload("truncated data of tensor " + name);
+    }
+  }
+
+  uint32_t output_filter_count;
+  if (!reader.Read(output_filter_count)) {
+    return InvalidPayload("missing output filter count");
+  }
+
+  for (uint32_t i = 0; i < output_filter_count; ++i) {
+    if (!reader.ReadString(*request.add_output_filter())) {
+      return InvalidPayload("truncated output filter");
+    }
+  }
+
+  if (!reader.AtEnd()) {
+    return InvalidPayload("unexpected data after the output filter");
+  }
+
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status GenerateResponseInTensorPayload(const onnxruntime::server::PredictResponse& response, /* out */ std::string& payload) {
+  payload.clear();
+  Write(static_cast<uint32_t>(response.outputs_size()), payload);
+
+  for (const auto& output : response.outputs()) {
+    const auto& tensor = output.second;
+    if (!tensor.has_raw_data()) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                  "Output " + output.first + " can't be returned as " + kTensorPayloadMimeType +
+                                      ", which requires the outputs to be stored as raw data. Send the inputs as raw data too.");
+    }
+
+    WriteString(output.first, payload);
+    Write(static_cast<int32_t>(tensor.data_type()), payload);
+    Write(static_cast<uint32_t>(tensor.dims_size()), payload);
+    for (auto dim : tensor.dims()) {
+      Write(static_cast<int64_t>(dim), payload);
+    }
+    Write(static_cast<uint64_t>(tensor.raw_data().size()), payload);
+    payload.append(tensor.raw_data());
+  }
+
+  Write(static_cast<uint32_t>(0), payload);
+  return protobufutil::Status::OK;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <google/protobuf/stubs/status.h>
+
+#include "predict.pb.h"
+
+namespace onnxruntime {
+namespace server {
+
+// MIME type of the binary tensor payload, a header followed by the raw bytes of each tensor, which skips the
+// encoding of JSON and protobuf. All the integers are little-endian:
+//   payload := uint32 tensor_count, tensor[tensor_count], uint32 output_filter_count, string[output_filter_count]
+//   tensor  := string name, int32 data_type, uint32 rank, int64 dims[rank], uint64 byte_size, uint8 data[byte_size]
+//   string  := uint32 length, char chars[length]
+// data_type is an onnx::TensorProto_DataType and data holds the elements as in TensorProto.raw_data, so string
+// tensors aren't supported. Responses have the same layout, without output filter.
+constexpr const char* kTensorPayloadMimeType = "application/x-onnxruntime-tensors";
+
+// Deserialize a binary tensor payload to PredictRequest. The data of the tensors are stored as raw_data.
+google::protobuf::util::Status GetRequestFromTensorPayload(const std::string& payload, /* out */ onnxruntime::server::PredictRequest& request);
+
+// Serialize PredictResponse to a binary tensor payload. Fails if an output isn't stored as raw_data.
+google::protobuf::util::Status GenerateResponseInTensorPayload(const onnxruntime::server::PredictResponse& response, /* out */ std::string& payload);
+
+}  // namespace server
+}  // namespace onnxruntime
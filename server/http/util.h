@@ -17,18 +17,21 @@ namespace beast = boost::beast;  // from <boost/beast.hpp>
 enum class SupportedContentType : int {
   Unknown,
   Json,
-  PbByteArray
+  PbByteArray,
+  TensorPayload
 };
 
 // Mapping protobuf status to http status
 boost::beast::http::status GetHttpStatusCode(const google::protobuf::util::Status& status);
 
 // "Content-Type" header field in request is MUST-HAVE.
-// Currently we only support two types of input content type: application/json and application/octet-stream
+// Currently we support three types of input content type: application/json, application/octet-stream and
+// application/x-onnxruntime-tensors
 SupportedContentType GetRequestContentType(const HttpContext& context);
 
 // "Accept" header field in request is OPTIONAL.
-// Currently we only support three types of response content type: */*, application/json and application/octet-stream
+// Currently we support four types of response content type: */*, application/json, application/octet-stream and
+// application/x-onnxruntime-tensors
 SupportedContentType GetResponseContentType(const HttpContext& context);
 
 }  // namespace server
@@ -2,10 +2,12 @@
 // Licensed under the MIT License.
 
 #include "environment.h"
+#include "model_repository.h"
 #include "http_server.h"
 #include "predict_request_handler.h"
 #include "server_configuration.h"
 #include "grpc/grpc_app.h"
+#include <boost/asio/thread_pool.hpp>
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/sink.h>
 #include <spdlog/sinks/stdout_sinks.h>
@@ -60,23 +62,76 @@ int main(int argc, char* argv[]) {
 
   const auto env = std::make_shared<server::ServerEnvironment>(config.logging_level, spdlog::sinks_init_list{std::make_shared<spdlog::sinks::stdout_sink_mt>(), std::make_shared<spdlog::sinks::syslog_sink_mt>()});
   auto logger = env->GetAppLogger();
-  logger->info("Model path: {}, ", config.model_path);
-  logger->info("Model name: {}", config.model_name);
-  logger->info("Model version: {}", config.model_version);
-
-  try {
-    env->InitializeModel(config.model_path, config.model_name, config.model_version);
-    logger->debug("Initialize Model Successfully!");
-  } catch (const Ort::Exception& ex) {
-    logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
-    exit(EXIT_FAILURE);
+
+  if (config.max_queued_requests > 0) {
+    env->SetMaxQueuedRequests(config.max_queued_requests);
+    logger->info("Max queued requests: {}", config.max_queued_requests);
+  }
+
+  for (const auto& model_config : config.model_configs) {
+    server::ServerEnvironment::ModelOptions model_options;
+    model_options.max_concurrent_runs = model_config.second.max_concurrent_runs;
+    model_options.max_queued_requests = model_config.second.max_queued_requests;
+    model_options.intra_op_num_threads = model_config.second.intra_op_num_threads;
+    model_options.cache_responses = model_config.second.cache_responses;
+    model_options.cuda_device_ids = model_config.second.cuda_devices;
+    env->SetModelOptions(model_config.first, model_options);
+    logger->info("Model {}: max concurrent runs {}, max queued requests {}, intra-op threads {}, cache responses {}, "
+                 "CUDA device replicas {}",
+                 model_config.first, model_options.max_concurrent_runs, model_options.max_queued_requests,
+                 model_options.intra_op_num_threads, model_options.cache_responses,
+                 model_options.cuda_device_ids.size());
+  }
+
+  if (config.response_cache_entries > 0) {
+    env->EnableResponseCache(config.response_cache_entries, static_cast<size_t>(config.response_cache_mb) << 20,
+                             std::chrono::seconds(config.response_cache_ttl_s));
+    logger->info("Response cache: max entries {}, max size {} MB, ttl {} s", config.response_cache_entries,
+                 config.response_cache_mb, config.response_cache_ttl_s);
+  }
+
+  if (config.enable_shared_memory) {
+    env->EnableSharedMemory();
+    logger->info("Shared memory enabled");
+  }
+
+  std::unique_ptr<server::ModelRepository> repository;
+  if (!config.model_repository.empty()) {
+    logger->info("Model repository: {}", config.model_repository);
+    repository = std::make_unique<server::ModelRepository>(env, config.model_repository,
+                                                           config.max_batch_size, config.max_batch_delay_us);
+    if (!repository->Poll()) {
+      logger->critical("Initialize Model Repository Failed");
+      exit(EXIT_FAILURE);
+    }
+
+    if (config.model_poll_interval_s > 0) {
+      repository->StartPolling(std::chrono::seconds(config.model_poll_interval_s));
+    }
+  } else {
+    logger->info("Model path: {}, ", config.model_path);
+    logger->info("Model name: {}", config.model_name);
+    logger->info("Model version: {}", config.model_version);
+
+    try {
+      env->InitializeModel(config.model_path, config.model_name, config.model_version);
+      logger->debug("Initialize Model Successfully!");
+
+      if (config.max_batch_size > 0) {
+        env->EnableBatching(config.model_name, config.model_version, config.max_batch_size, config.max_batch_delay_us);
+        logger->info("Batching requests: max batch size {}, max delay {} us", config.max_batch_size, config.max_batch_delay_us);
+      }
+    } catch (const Ort::Exception& ex) {
+      logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
+      exit(EXIT_FAILURE);
+    }
   }
 
   //Setup GRPC Server
   auto const grpc_address = config.address;
   auto const grpc_port = config.grpc_port;
 
-  server::GRPCApp grpc_app{env, grpc_address, grpc_port};
+  server::GRPCApp grpc_app{env, grpc_address, grpc_port, config.num_grpc_threads};
 
   logger->info("GRPC Listening at: {}:{}", grpc_address, grpc_port);
 
@@ -84,6 +139,13 @@ int main(int argc, char* argv[]) {
   auto const boost_address = boost::asio::ip::make_address(config.address);
   server::App app{};
 
+  // Decoding and encoding of the predict requests overlap with the runs when they have their own threads
+  std::unique_ptr<boost::asio::thread_pool> codec_pool{};
+  if (config.num_codec_threads > 0) {
+    codec_pool = std::make_unique<boost::asio::thread_pool>(config.num_codec_threads);
+    logger->info("HTTP codec threads: {}", config.num_codec_threads);
+  }
+
   app.RegisterStartup(
       [&env](const auto& details) -> void {
         auto logger = env->GetAppLogger();
@@ -107,17 +169,48 @@ int main(int argc, char* argv[]) {
 
   app.RegisterPost(
       R"(/(?:v1/models/([^/:]+)(?:/versions/(\d+))?:(classify|regress|predict))|(?:score()()()))",
-      [&env](const auto& name, const auto& version, const auto& action, auto& context) -> void {
-        server::Predict(name, version, action, context, env);
+      [&env, &codec_pool](const auto& name, const auto& version, const auto& action, auto& context) -> void {
+        if (codec_pool) {
+          server::PredictPipelined(name, version, action, context, env, *codec_pool);
+        } else {
+          server::Predict(name, version, action, context, env);
+        }
       });
 
   app.RegisterPost(
     R"(/score()()())",
-     [&env](const auto& name, const auto& version, const auto& action, auto& context) -> void {
-        server::Predict(name, version, action, context, env);
+     [&env, &codec_pool](const auto& name, const auto& version, const auto& action, auto& context) -> void {
+        if (codec_pool) {
+          server::PredictPipelined(name, version, action, context, env, *codec_pool);
+        } else {
+          server::Predict(name, version, action, context, env);
+        }
       }
   );
 
+  app.RegisterGet(
+      R"(/v1/cache/stats()()())",
+      [&env](const auto&, const auto&, const auto&, auto& context) -> void {
+        context.response.set(http::field::content_type, "application/json");
+        context.response.insert(server::util::MS_REQUEST_ID_HEADER, context.request_id);
+
+        auto* cache = env->GetResponseCache();
+        if (cache == nullptr) {
+          context.response.result(http::status::not_found);
+          context.response.body() = server::CreateJsonError(http::status::not_found, "The response cache isn't enabled");
+          return;
+        }
+
+        context.response.result(http::status::ok);
+        context.response.body() = server::CreateJsonResponseCacheStats(cache->GetStats());
+      });
+
+  app.RegisterPost(
+      R"(/v1/shared_memory/([^/:]+)():(register|unregister))",
+      [&env](const auto& name, const auto&, const auto& action, auto& context) -> void {
+        server::SharedMemory(name, action, context, env);
+      });
+
   app.Bind(boost_address, config.http_port)
       .NumThreads(config.num_http_threads)
       .Run();
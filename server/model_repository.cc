@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <boost/filesystem.hpp>
+
+#include "model_repository.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace fs = boost::filesystem;
+
+static const char* const kModelFileName = "model.onnx";
+
+// Returns -1 if the name isn't a version number.
+static int64_t ParseVersion(const std::string& name) {
+  if (name.empty() || name.find_first_not_of("0123456789") != std::string::npos) {
+    return -1;
+  }
+
+  try {
+    return std::stoll(name);
+  } catch (const std::out_of_range&) {
+    return -1;
+  }
+}
+
+ModelRepository::ModelRepository(const std::shared_ptr<ServerEnvironment>& env, const std::string& root,
+                                 size_t max_batch_size, int64_t max_batch_delay_us)
+    : env_(env), root_(root), max_batch_size_(max_batch_size), max_batch_delay_us_(max_batch_delay_us) {}
+
+ModelRepository::~ModelRepository() {
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    stop_polling_ = true;
+  }
+  polling_cv_.notify_all();
+
+  if (polling_thread_.joinable()) {
+    polling_thread_.join();
+  }
+}
+
+bool ModelRepository::Poll() {
+  auto logger = env_->GetAppLogger();
+  bool succeeded = true;
+
+  boost::system::error_code error;
+  for (fs::directory_iterator model_it(root_, error), end; !error && model_it != end; model_it.increment(error)) {
+    if (!fs::is_directory(model_it->status())) {
+      continue;
+    }
+
+    // the highest version holding a model
+    auto model_name = model_it->path().filename().string();
+    int64_t latest_version = -1;
+    fs::path latest_path;
+    boost::system::error_code version_error;
+    for (fs::directory_iterator version_it(model_it->path(), version_error);
+         !version_error && version_it != end; version_it.increment(version_error)) {
+      auto version = ParseVersion(version_it->path().filename().string());
+      auto model_path = version_it->path() / kModelFileName;
+      if (version > latest_version && fs::is_regular_file(model_path)) {
+        latest_version = version;
+        latest_path = model_path;
+      }
+    }
+
+    if (latest_version < 0) {
+      continue;
+    }
+
+    auto model_version = std::to_string(latest_version);
+    auto serving_version = env_->GetServingVersion(model_name);
+    if (model_version == serving_version) {
+      continue;
+    }
+
+    if (!LoadVersion(model_name, model_version, latest_path.string())) {
+      succeeded = false;
+      continue;
+    }
+
+    if (!serving_version.empty()) {
+      env_->UnloadModel(model_name, serving_version);
+      logger->info("Unloaded model {} version {}", model_name, serving_version);
+    }
+  }
+
+  if (error) {
+    logger->error("Failed to list the model repository {}: {}", root_, error.message());
+    succeeded = false;
+  }
+
+  env_->ReleaseDrainedModels();
+  return succeeded;
+}
+
+bool ModelRepository::LoadVersion(const std::string& model_name, const std::string& model_version,
+                                  const std::string& model_path) {
+  auto logger = env_->GetAppLogger();
+  logger->info("Loading model {} version {} from {}", model_name, model_version, model_path);
+
+  try {
+    env_->InitializeModel(model_path, model_name, model_version);
+  } catch (const Ort::Exception& ex) {
+    logger->error("Failed to load model {} version {}: {}", model_name, model_version, ex.what());
+    return false;
+  }
+
+  try {
+    if (max_batch_size_ > 0) {
+      env_->EnableBatching(model_name, model_version, max_batch_size_, max_batch_delay_us_);
+    }
+  } catch (const Ort::Exception& ex) {
+    logger->error("Failed to enable batching on model {} version {}: {}", model_name, model_version, ex.what());
+    env_->UnloadModel(model_name, model_version);
+    return false;
+  }
+
+  // A failed warm-up only means the zero-filled inputs don't suit the model, so the version is served anyway.
+  try {
+    env_->WarmUpModel(model_name, model_version);
+  } catch (const Ort::Exception& ex) {
+    logger->warn("Failed to warm up model {} version {}: {}", model_name, model_version, ex.what());
+  }
+
+  env_->SetServingVersion(model_name, model_version);
+  logger->info("Serving model {} version {}", model_name, model_version);
+  return true;
+}
+
+void ModelRepository::StartPolling(std::chrono::seconds interval) {
+  polling_thread_ = std::thread([this, interval]() {
+    std::unique_lock<std::mutex> lock(polling_mutex_);
+    while (!polling_cv_.wait_for(lock, interval, [this]() { return stop_polling_; })) {
+      lock.unlock();
+      Poll();
+      lock.lock();
+    }
+  });
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "environment.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Serves the models of a directory laid out as <root>/<model name>/<version>/model.onnx, where the versions are
+// numbers. The highest version of each model is served to the requests without a version.
+// When a new version shows up, it's loaded and warmed up while the previous one keeps serving, then the requests
+// switch over to it, and the previous version is unloaded and released once its requests are drained.
+class ModelRepository {
+ public:
+  // Batching is enabled on every version loaded if max_batch_size isn't 0.
+  ModelRepository(const std::shared_ptr<ServerEnvironment>& env, const std::string& root,
+                  size_t max_batch_size, int64_t max_batch_delay_us);
+  ~ModelRepository();
+  ModelRepository(const ModelRepository&) = delete;
+  ModelRepository& operator=(const ModelRepository&) = delete;
+
+  // Load the new versions of the repository. Returns false if any of them failed to load, in which case the previous
+  // version of the model, if any, is still served.
+  bool Poll();
+
+  // Poll the repository every interval on a background thread, until the repository is destroyed.
+  void StartPolling(std::chrono::seconds interval);
+
+ private:
+  bool LoadVersion(const std::string& model_name, const std::string& model_version, const std::string& model_path);
+
+  std::shared_ptr<ServerEnvironment> env_;
+  const std::string root_;
+  const size_t max_batch_size_;
+  const int64_t max_batch_delay_us_;
+
+  std::thread polling_thread_;
+  std::mutex polling_mutex_;
+  std::condition_variable polling_cv_;
+  bool stop_polling_{false};
+};
+
+}  // namespace server
+}  // namespace onnxruntime
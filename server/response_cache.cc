@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <functional>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "response_cache.h"
+
+namespace onnxruntime {
+namespace server {
+
+ResponseCache::ResponseCache(size_t max_entries, size_t max_bytes, std::chrono::milliseconds ttl)
+    : max_entries_(max_entries), max_bytes_(max_bytes), ttl_(ttl) {}
+
+std::string ResponseCache::MakeKey(const std::string& model_name, const std::string& model_version,
+                                   const onnxruntime::server::PredictRequest& request) {
+  std::string key;
+  key.reserve(model_name.size() + model_version.size() + 2 + request.ByteSizeLong());
+  key.append(model_name).push_back('\0');
+  key.append(model_version).push_back('\0');
+
+  {
+    google::protobuf::io::StringOutputStream stream(&key);
+    google::protobuf::io::CodedOutputStream coded_stream(&stream);
+    coded_stream.SetSerializationDeterministic(true);
+    request.SerializeToCodedStream(&coded_stream);
+  }
+  return key;
+}
+
+bool ResponseCache::Lookup(const std::string& key, /* out */ onnxruntime::server::PredictResponse& response) {
+  auto hash = std::hash<std::string>{}(key);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(hash);
+  if (it == index_.end() || it->second->key != key) {
+    ++stats_.misses;
+    return false;
+  }
+
+  auto entry = it->second;
+  if (entry->expiry <= std::chrono::steady_clock::now()) {
+    Erase(entry);
+    ++stats_.expirations;
+    ++stats_.misses;
+    return false;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  response.CopyFrom(entry->response);
+  ++stats_.hits;
+  return true;
+}
+
+void ResponseCache::Insert(const std::string& key, const onnxruntime::server::PredictResponse& response) {
+  auto bytes = key.size() + response.ByteSizeLong();
+  if (max_entries_ == 0 || bytes > max_bytes_) {
+    return;
+  }
+
+  auto hash = std::hash<std::string>{}(key);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // a concurrent request may have inserted the key, or another key with the same hash, which is replaced
+  auto it = index_.find(hash);
+  if (it != index_.end()) {
+    Erase(it->second);
+  }
+
+  while (!entries_.empty() && (entries_.size() >= max_entries_ || stats_.bytes + bytes > max_bytes_)) {
+    Erase(std::prev(entries_.end()));
+    ++stats_.evictions;
+  }
+
+  entries_.push_front(Entry{key, response, bytes, std::chrono::steady_clock::now() + ttl_});
+  index_[hash] = entries_.begin();
+  stats_.bytes += bytes;
+  ++stats_.insertions;
+}
+
+ResponseCache::Stats ResponseCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stats = stats_;
+  stats.entries = entries_.size();
+  return stats;
+}
+
+void ResponseCache::Erase(EntryList::iterator entry) {
+  stats_.bytes -= entry->bytes;
+  index_.erase(std::hash<std::string>{}(entry->key));
+  entries_.erase(entry);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
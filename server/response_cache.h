@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "predict.pb.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Bounded LRU cache of the responses of deterministic models, keyed by the model version and the request, so that
+// repeated requests skip the inference. The entries expire after ttl, and the least recently used entries are
+// evicted beyond max_entries or max_bytes. Thread-safe.
+class ResponseCache {
+ public:
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t insertions{0};
+    uint64_t evictions{0};
+    uint64_t expirations{0};
+    size_t entries{0};
+    size_t bytes{0};
+  };
+
+  ResponseCache(size_t max_entries, size_t max_bytes, std::chrono::milliseconds ttl);
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  // The request is serialized deterministically, so the same inputs and output filter give the same key whatever
+  // the order of the inputs in the map.
+  static std::string MakeKey(const std::string& model_name, const std::string& model_version,
+                             const onnxruntime::server::PredictRequest& request);
+
+  // Returns false on a miss, leaving the response untouched.
+  bool Lookup(const std::string& key, /* out */ onnxruntime::server::PredictResponse& response);
+  void Insert(const std::string& key, const onnxruntime::server::PredictResponse& response);
+
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    // full key, to tell apart the keys with the same hash
+    std::string key;
+    onnxruntime::server::PredictResponse response;
+    size_t bytes;
+    std::chrono::steady_clock::time_point expiry;
+  };
+  using EntryList = std::list<Entry>;
+
+  void Erase(EntryList::iterator entry);
+
+  const size_t max_entries_;
+  const size_t max_bytes_;
+  const std::chrono::milliseconds ttl_;
+
+  mutable std::mutex mutex_;
+  // most recently used first
+  EntryList entries_;
+  std::unordered_map<size_t, EntryList::iterator> index_;
+  Stats stats_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -378,6 +378,87 @@ void TensorProtoToMLValue(const onnx::TensorProto& tensor_proto, const MemBuffer
   value = Ort::Value::CreateTensor(&allocator, tensor_data, m.GetLen(), tensor_shape_vec.data(), tensor_shape_vec.size(), (ONNXTensorElementDataType)tensor_proto.data_type());
   return;
 }
+#define CASE_ELEMENT_SIZE(X, Y)                  \
+  case onnx::TensorProto_DataType_##X:           \
+    return sizeof(Y);
+
+size_t GetFixedElementSize(int type) noexcept {
+  switch (type) {
+    CASE_ELEMENT_SIZE(FLOAT, float)
+    CASE_ELEMENT_SIZE(DOUBLE, double)
+    CASE_ELEMENT_SIZE(BOOL, bool)
+    CASE_ELEMENT_SIZE(INT8, int8_t)
+    CASE_ELEMENT_SIZE(INT16, int16_t)
+    CASE_ELEMENT_SIZE(INT32, int32_t)
+    CASE_ELEMENT_SIZE(INT64, int64_t)
+    CASE_ELEMENT_SIZE(UINT8, uint8_t)
+    CASE_ELEMENT_SIZE(UINT16, uint16_t)
+    CASE_ELEMENT_SIZE(UINT32, uint32_t)
+    CASE_ELEMENT_SIZE(UINT64, uint64_t)
+    default:
+      return 0;
+  }
+}
+
+bool TryWrapTensorProtoRawData(const onnx::TensorProto& tensor_proto, const OrtMemoryInfo& memory_info,
+                               Ort::Value& value) {
+  if (!IsLittleEndianOrder() || !tensor_proto.has_raw_data() ||
+      tensor_proto.data_location() == onnx::TensorProto_DataLocation::TensorProto_DataLocation_EXTERNAL) {
+    return false;
+  }
+
+  const size_t element_size = GetFixedElementSize(tensor_proto.data_type());
+  if (element_size == 0) {
+    return false;
+  }
+
+  const std::string& raw_data = tensor_proto.raw_data();
+  if (reinterpret_cast<uintptr_t>(raw_data.data()) % element_size != 0) {
+    return false;
+  }
+
+  size_t expected_size_in_bytes;
+  GetSizeInBytesFromTensorProto<0>(tensor_proto, &expected_size_in_bytes);
+  if (raw_data.size() != expected_size_in_bytes) {
+    throw Ort::Exception(MakeString("the raw data size does not match the tensor shape, expected ",
+                                    expected_size_in_bytes, ", got ", raw_data.size()),
+                         OrtErrorCode::ORT_FAIL);
+  }
+
+  // the kernels don't write to their inputs, so the const data of the request can back the tensor
+  std::vector<int64_t> tensor_shape_vec = GetTensorShapeFromTensorProto(tensor_proto);
+  value = Ort::Value::CreateTensor(&memory_info, const_cast<char*>(raw_data.data()), raw_data.size(),
+                                   tensor_shape_vec.data(), tensor_shape_vec.size(),
+                                   (ONNXTensorElementDataType)tensor_proto.data_type());
+  return true;
+}
+
+void WrapTensorProtoExternalData(const onnx::TensorProto& tensor_proto, char* data, size_t length,
+                                 const OrtMemoryInfo& memory_info, Ort::Value& value) {
+  const size_t element_size = GetFixedElementSize(tensor_proto.data_type());
+  if (element_size == 0) {
+    throw Ort::Exception("External data is only supported for the tensors of fixed size types",
+                         OrtErrorCode::ORT_INVALID_ARGUMENT);
+  }
+
+  if (reinterpret_cast<uintptr_t>(data) % element_size != 0) {
+    throw Ort::Exception(MakeString("the external data isn't aligned on the size of its elements, ", element_size),
+                         OrtErrorCode::ORT_INVALID_ARGUMENT);
+  }
+
+  size_t expected_size_in_bytes;
+  GetSizeInBytesFromTensorProto<0>(tensor_proto, &expected_size_in_bytes);
+  if (length != expected_size_in_bytes) {
+    throw Ort::Exception(MakeString("the external data size does not match the tensor shape, expected ",
+                                    expected_size_in_bytes, ", got ", length),
+                         OrtErrorCode::ORT_INVALID_ARGUMENT);
+  }
+
+  std::vector<int64_t> tensor_shape_vec = GetTensorShapeFromTensorProto(tensor_proto);
+  value = Ort::Value::CreateTensor(&memory_info, data, length, tensor_shape_vec.data(), tensor_shape_vec.size(),
+                                   (ONNXTensorElementDataType)tensor_proto.data_type());
+}
+
 template void GetSizeInBytesFromTensorProto<256>(const onnx::TensorProto& tensor_proto,
                                                  size_t* out);
 template void GetSizeInBytesFromTensorProto<0>(const onnx::TensorProto& tensor_proto, size_t* out);
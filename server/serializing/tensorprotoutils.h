@@ -27,6 +27,26 @@ void GetSizeInBytesFromTensorProto(const onnx::TensorProto& tensor_proto, size_t
  */
 void TensorProtoToMLValue(const onnx::TensorProto& input, const server::MemBuffer& m, /* out */ Ort::Value& value);
 
+/**
+ * wrap the raw_data of a TensorProto as a tensor without copying it. This is only possible when raw_data is set,
+ * holds exactly the elements of a fixed size type in little-endian order, and is aligned for that type.
+ * The value refers to the memory of the TensorProto, which must outlive it.
+ * Returns false, leaving value unchanged, when the data can't be used in place.
+ */
+bool TryWrapTensorProtoRawData(const onnx::TensorProto& input, const OrtMemoryInfo& memory_info,
+                               /* out */ Ort::Value& value);
+
+/**
+ * wrap data, the external data of a TensorProto held by the server such as a shared memory region, as a tensor
+ * without copying it. data must hold exactly the elements of a fixed size type in the native order, aligned for
+ * that type, and must outlive the value. Throws if it doesn't.
+ */
+void WrapTensorProtoExternalData(const onnx::TensorProto& input, char* data, size_t length,
+                                 const OrtMemoryInfo& memory_info, /* out */ Ort::Value& value);
+
+// Size of an element of a tensor of the TensorProto data type, or 0 if the type doesn't have a fixed size.
+size_t GetFixedElementSize(int type) noexcept;
+
 template <typename T>
 void UnpackTensor(const onnx::TensorProto& tensor, const void* raw_data, size_t raw_data_len,
                   /*out*/ T* p_data, int64_t expected_size);
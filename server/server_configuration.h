@@ -3,9 +3,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <thread>
 #include <fstream>
+#include <sstream>
 #include <unordered_map>
+#include <vector>
 
 #include "boost/program_options.hpp"
 #include "onnxruntime_cxx_api.h"
@@ -33,30 +36,63 @@ static std::unordered_map<std::string, OrtLoggingLevel> supported_log_levels{
     {"error", ORT_LOGGING_LEVEL_ERROR},
     {"fatal", ORT_LOGGING_LEVEL_FATAL}};
 
+// Resources of a model set with --model_options, see ServerEnvironment::ModelOptions
+struct ModelConfig {
+  int max_concurrent_runs = 0;
+  int max_queued_requests = 0;
+  int intra_op_num_threads = 0;
+  bool cache_responses = true;
+  std::vector<int> cuda_devices;
+};
+
 // Wrapper around Boost program_options and should provide all the functionality for options parsing
 // Provides sane default values
 class ServerConfiguration {
  public:
   const std::string full_desc = "ONNX Server: host an ONNX model with ONNX Runtime";
   std::string model_path;
+  std::string model_repository;
+  int model_poll_interval_s = 30;
   std::string model_name = "default";
   std::string model_version = "1";
   std::string address = "0.0.0.0";
   unsigned short http_port = 8001;
   unsigned short grpc_port = 50051;
   int num_http_threads = std::thread::hardware_concurrency();
+  int num_codec_threads = 0;
+  int max_batch_size = 0;
+  int max_batch_delay_us = 1000;
+  int num_grpc_threads = 1;
+  int max_queued_requests = 0;
+  int response_cache_entries = 0;
+  int response_cache_mb = 256;
+  int response_cache_ttl_s = 300;
+  bool enable_shared_memory = false;
+  std::unordered_map<std::string, ModelConfig> model_configs;
   OrtLoggingLevel logging_level{};
 
   ServerConfiguration() {
     desc.add_options()("help,h", "Shows a help message and exits");
     desc.add_options()("log_level", po::value(&log_level_str)->default_value(log_level_str), "Logging level. Allowed options (case sensitive): verbose, info, warning, error, fatal");
-    desc.add_options()("model_path", po::value(&model_path)->required(), "Path to ONNX model");
+    desc.add_options()("model_path", po::value(&model_path), "Path to ONNX model");
+    desc.add_options()("model_repository", po::value(&model_repository), "Directory of models laid out as <model name>/<version>/model.onnx, in place of model_path. The highest version of each model is served");
+    desc.add_options()("model_poll_interval_s", po::value(&model_poll_interval_s)->default_value(model_poll_interval_s), "Interval in seconds between the scans of the model repository for new versions. 0 disables the scans");
     desc.add_options()("model_name", po::value(&model_name)->default_value(model_name), "ONNX model name");
     desc.add_options()("model_version", po::value(&model_version)->default_value(model_version), "ONNX model version");
     desc.add_options()("address", po::value(&address)->default_value(address), "The base HTTP address");
     desc.add_options()("http_port", po::value(&http_port)->default_value(http_port), "HTTP port to listen to requests");
     desc.add_options()("num_http_threads", po::value(&num_http_threads)->default_value(num_http_threads), "Number of http threads");
+    desc.add_options()("num_codec_threads", po::value(&num_codec_threads)->default_value(num_codec_threads), "Number of threads decoding the HTTP predict requests and encoding their responses, while the models run other requests. 0 handles the requests on the http threads");
     desc.add_options()("grpc_port", po::value(&grpc_port)->default_value(grpc_port), "GRPC port to listen to requests");
+    desc.add_options()("num_grpc_threads", po::value(&num_grpc_threads)->default_value(num_grpc_threads), "Number of GRPC completion queue threads");
+    desc.add_options()("max_batch_size", po::value(&max_batch_size)->default_value(max_batch_size), "Maximum number of rows (first dimension of the inputs) of a batch of coalesced requests. 0 disables batching");
+    desc.add_options()("max_batch_delay_us", po::value(&max_batch_delay_us)->default_value(max_batch_delay_us), "Maximum time in microseconds a request waits for its batch to fill");
+    desc.add_options()("max_queued_requests", po::value(&max_queued_requests)->default_value(max_queued_requests), "Maximum number of requests of the model processed or queued at once. The requests beyond it are rejected. 0 is unlimited");
+    desc.add_options()("model_options", po::value(&model_options_strs)->composing(), "Resources of a model, as <model name>:<key>=<value>[,<key>=<value>...] with the keys max_concurrent_runs, max_queued_requests (overriding the server limit), intra_op_num_threads, cache_responses (0 opts the model out of the response cache) and cuda_devices (the ';' separated CUDA devices to run a replica of the model on). 0 is unlimited or default. Can be repeated");
+    desc.add_options()("response_cache_entries", po::value(&response_cache_entries)->default_value(response_cache_entries), "Maximum number of responses of deterministic models cached for the repeated requests. 0 disables the response cache");
+    desc.add_options()("response_cache_mb", po::value(&response_cache_mb)->default_value(response_cache_mb), "Maximum size in MB of the cached requests and responses");
+    desc.add_options()("response_cache_ttl_s", po::value(&response_cache_ttl_s)->default_value(response_cache_ttl_s), "Time in seconds a response stays cached");
+    desc.add_options()("enable_shared_memory", po::bool_switch(&enable_shared_memory), "Let the co-located clients register shared memory regions for the tensors of their requests. Only for trusted clients");
   }
 
   // Parses argc and argv and sets the values for the class
@@ -80,7 +116,12 @@ class ServerConfiguration {
       return Result::ExitFailure;
     }
 
-    Result result = ValidateOptions();
+    Result result = ParseModelOptions();
+    if (result != Result::ContinueSuccess) {
+      return result;
+    }
+
+    result = ValidateOptions();
 
     if (result == Result::ContinueSuccess) {
       logging_level = supported_log_levels[log_level_str];
@@ -93,6 +134,75 @@ class ServerConfiguration {
   po::options_description desc{"Allowed options"};
   po::variables_map vm{};
   std::string log_level_str = "info";
+  std::vector<std::string> model_options_strs;
+
+  // Returns -1 if value isn't a non-negative integer
+  static int ParseNonNegativeInt(const std::string& value) {
+    try {
+      size_t parsed = 0;
+      auto result = std::stoi(value, &parsed);
+      return parsed == value.size() && result >= 0 ? result : -1;
+    } catch (const std::exception&) {
+      return -1;
+    }
+  }
+
+  // Fill model_configs from the --model_options values
+  Result ParseModelOptions() {
+    for (const auto& model_options : model_options_strs) {
+      auto separator = model_options.rfind(':');
+      if (separator == std::string::npos || separator == 0) {
+        PrintHelp(std::cerr, "model_options must be <model name>:<key>=<value>[,<key>=<value>...]: " + model_options);
+        return Result::ExitFailure;
+      }
+
+      auto& model_config = model_configs[model_options.substr(0, separator)];
+      std::stringstream settings(model_options.substr(separator + 1));
+      std::string setting;
+      while (std::getline(settings, setting, ',')) {
+        auto equal = setting.find('=');
+        // the values are non-negative integers, or lists of them separated by ';'
+        std::vector<int> values;
+        if (equal != std::string::npos) {
+          std::stringstream value_list(setting.substr(equal + 1));
+          std::string value_str;
+          while (std::getline(value_list, value_str, ';')) {
+            values.push_back(ParseNonNegativeInt(value_str));
+          }
+        }
+
+        if (values.empty() || std::find(values.begin(), values.end(), -1) != values.end()) {
+          PrintHelp(std::cerr, "model_options values must be non-negative integers: " + model_options);
+          return Result::ExitFailure;
+        }
+
+        auto key = setting.substr(0, equal);
+        if (key == "cuda_devices") {
+          model_config.cuda_devices = values;
+          continue;
+        } else if (values.size() != 1) {
+          PrintHelp(std::cerr, "model_options key " + key + " takes a single value: " + model_options);
+          return Result::ExitFailure;
+        }
+
+        auto value = values.front();
+        if (key == "max_concurrent_runs") {
+          model_config.max_concurrent_runs = value;
+        } else if (key == "max_queued_requests") {
+          model_config.max_queued_requests = value;
+        } else if (key == "intra_op_num_threads") {
+          model_config.intra_op_num_threads = value;
+        } else if (key == "cache_responses") {
+          model_config.cache_responses = value != 0;
+        } else {
+          PrintHelp(std::cerr, "Unknown key " + key + " in model_options: " + model_options);
+          return Result::ExitFailure;
+        }
+      }
+    }
+
+    return Result::ContinueSuccess;
+  }
 
   // Print help and return if there is a bad value
   Result ValidateOptions() {
@@ -103,7 +213,37 @@ class ServerConfiguration {
     } else if (num_http_threads <= 0) {
       PrintHelp(std::cerr, "num_http_threads must be greater than 0");
       return Result::ExitFailure;
-    } else if (!file_exists(model_path)) {
+    } else if (num_codec_threads < 0) {
+      PrintHelp(std::cerr, "num_codec_threads must not be negative");
+      return Result::ExitFailure;
+    } else if (num_grpc_threads <= 0) {
+      PrintHelp(std::cerr, "num_grpc_threads must be greater than 0");
+      return Result::ExitFailure;
+    } else if (max_queued_requests < 0) {
+      PrintHelp(std::cerr, "max_queued_requests must not be negative");
+      return Result::ExitFailure;
+    } else if (max_batch_size < 0) {
+      PrintHelp(std::cerr, "max_batch_size must not be negative");
+      return Result::ExitFailure;
+    } else if (max_batch_delay_us < 0) {
+      PrintHelp(std::cerr, "max_batch_delay_us must not be negative");
+      return Result::ExitFailure;
+    } else if (model_path.empty() == model_repository.empty()) {
+      PrintHelp(std::cerr, "Exactly one of model_path and model_repository must be set");
+      return Result::ExitFailure;
+    } else if (response_cache_entries < 0) {
+      PrintHelp(std::cerr, "response_cache_entries must not be negative");
+      return Result::ExitFailure;
+    } else if (response_cache_mb <= 0) {
+      PrintHelp(std::cerr, "response_cache_mb must be greater than 0");
+      return Result::ExitFailure;
+    } else if (response_cache_ttl_s <= 0) {
+      PrintHelp(std::cerr, "response_cache_ttl_s must be greater than 0");
+      return Result::ExitFailure;
+    } else if (model_poll_interval_s < 0) {
+      PrintHelp(std::cerr, "model_poll_interval_s must not be negative");
+      return Result::ExitFailure;
+    } else if (!model_path.empty() && !file_exists(model_path)) {
       PrintHelp(std::cerr, "model_path must be the location of a valid file");
       return Result::ExitFailure;
     } else {
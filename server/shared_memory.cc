@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "onnxruntime_cxx_api.h"
+
+#include "shared_memory.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+#ifdef _WIN32
+
+SharedMemoryRegion::SharedMemoryRegion(const std::string& key, size_t offset, size_t byte_size) : byte_size_(byte_size) {
+  handle_ = OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, key.c_str());
+  if (handle_ == nullptr) {
+    throw Ort::Exception("Can't open the shared memory " + key + ": error " + std::to_string(GetLastError()),
+                         ORT_INVALID_ARGUMENT);
+  }
+
+  // the views start at a multiple of the allocation granularity
+  SYSTEM_INFO system_info;
+  GetSystemInfo(&system_info);
+  size_t aligned_offset = offset - offset % system_info.dwAllocationGranularity;
+  mapping_size_ = byte_size + (offset - aligned_offset);
+  mapping_ = MapViewOfFile(handle_, FILE_MAP_READ | FILE_MAP_WRITE, static_cast<DWORD>(uint64_t(aligned_offset) >> 32),
+                           static_cast<DWORD>(aligned_offset & 0xFFFFFFFF), mapping_size_);
+  if (mapping_ == nullptr) {
+    auto error = GetLastError();
+    CloseHandle(handle_);
+    throw Ort::Exception("Can't map the shared memory " + key + ": error " + std::to_string(error),
+                         ORT_INVALID_ARGUMENT);
+  }
+  data_ = static_cast<char*>(mapping_) + (offset - aligned_offset);
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+  UnmapViewOfFile(mapping_);
+  CloseHandle(handle_);
+}
+
+#else
+
+SharedMemoryRegion::SharedMemoryRegion(const std::string& key, size_t offset, size_t byte_size) : byte_size_(byte_size) {
+  int fd = shm_open(key.c_str(), O_RDWR, 0);
+  if (fd == -1) {
+    throw Ort::Exception("Can't open the shared memory " + key + ": errno " + std::to_string(errno),
+                         ORT_INVALID_ARGUMENT);
+  }
+
+  // mmap rejects the ranges beyond the end of the segment only when they are accessed
+  struct stat segment_stat;
+  if (fstat(fd, &segment_stat) != 0 || segment_stat.st_size < 0 ||
+      static_cast<size_t>(segment_stat.st_size) < offset ||
+      static_cast<size_t>(segment_stat.st_size) - offset < byte_size) {
+    close(fd);
+    throw Ort::Exception("The range is beyond the end of the shared memory " + key, ORT_INVALID_ARGUMENT);
+  }
+
+  // the mappings start at a multiple of the page size
+  size_t page_size = static_cast<size_t>(sysconf(_SC_PAGE_SIZE));
+  size_t aligned_offset = offset - offset % page_size;
+  mapping_size_ = byte_size + (offset - aligned_offset);
+  mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(aligned_offset));
+  auto error = errno;
+  close(fd);
+  if (mapping_ == MAP_FAILED) {
+    throw Ort::Exception("Can't map the shared memory " + key + ": errno " + std::to_string(error),
+                         ORT_INVALID_ARGUMENT);
+  }
+  data_ = static_cast<char*>(mapping_) + (offset - aligned_offset);
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+  munmap(mapping_, mapping_size_);
+}
+
+#endif
+
+char* SharedMemoryRegion::GetRange(size_t offset, size_t length) const {
+  if (offset > byte_size_ || length > byte_size_ - offset) {
+    throw Ort::Exception("The range [" + std::to_string(offset) + ", " + std::to_string(offset + length) +
+                             ") is beyond the end of the shared memory region of " + std::to_string(byte_size_) +
+                             " bytes",
+                         ORT_INVALID_ARGUMENT);
+  }
+  return data_ + offset;
+}
+
+void SharedMemoryManager::Register(const std::string& name, const std::string& key, size_t offset, size_t byte_size) {
+  if (name.empty() || byte_size == 0) {
+    throw Ort::Exception("A shared memory region needs a name and a size", ORT_INVALID_ARGUMENT);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (regions_.count(name) != 0) {
+      throw Ort::Exception("Shared memory region " + name + " already registered", ORT_INVALID_ARGUMENT);
+    }
+  }
+
+  // mapped without holding the lock, as for the models
+  auto region = std::make_shared<SharedMemoryRegion>(key, offset, byte_size);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!regions_.emplace(name, std::move(region)).second) {
+    throw Ort::Exception("Shared memory region " + name + " already registered", ORT_INVALID_ARGUMENT);
+  }
+}
+
+void SharedMemoryManager::Unregister(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (regions_.erase(name) == 0) {
+    throw Ort::Exception("Shared memory region " + name + " not registered", ORT_INVALID_ARGUMENT);
+  }
+}
+
+std::shared_ptr<SharedMemoryRegion> SharedMemoryManager::Get(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = regions_.find(name);
+  if (it == regions_.end()) {
+    throw Ort::Exception("Shared memory region " + name + " not registered", ORT_INVALID_ARGUMENT);
+  }
+  return it->second;
+}
+
+namespace protobufutil = google::protobuf::util;
+
+static protobufutil::Status SharedMemoryDisabledStatus() {
+  return protobufutil::Status(protobufutil::error::Code::FAILED_PRECONDITION,
+                              "Shared memory isn't enabled on the server");
+}
+
+protobufutil::Status RegisterSharedMemory(SharedMemoryManager* shared_memory,
+                                          const onnxruntime::server::RegisterSharedMemoryRequest& request) {
+  if (shared_memory == nullptr) {
+    return SharedMemoryDisabledStatus();
+  }
+
+  try {
+    shared_memory->Register(request.name(), request.key(), static_cast<size_t>(request.offset()),
+                            static_cast<size_t>(request.byte_size()));
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status UnregisterSharedMemory(SharedMemoryManager* shared_memory,
+                                            const onnxruntime::server::UnregisterSharedMemoryRequest& request) {
+  if (shared_memory == nullptr) {
+    return SharedMemoryDisabledStatus();
+  }
+
+  try {
+    shared_memory->Unregister(request.name());
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+  return protobufutil::Status::OK;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <google/protobuf/stubs/status.h>
+
+#include "predict.pb.h"
+
+namespace onnxruntime {
+namespace server {
+
+// A shared memory segment of a co-located client, mapped into the server so that the tensors of its requests are
+// read and written in place instead of going through the sockets. Unmapped once the last request using it completes.
+class SharedMemoryRegion {
+ public:
+  // Maps byte_size bytes at offset of the shared memory object key: a name for shm_open on POSIX, or for
+  // OpenFileMapping on Windows. Throws Ort::Exception if it can't be mapped.
+  SharedMemoryRegion(const std::string& key, size_t offset, size_t byte_size);
+  ~SharedMemoryRegion();
+  SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+  SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+  // Returns the memory of [offset, offset + length) in the region, or throws Ort::Exception if it's out of bounds.
+  char* GetRange(size_t offset, size_t length) const;
+  size_t GetByteSize() const { return byte_size_; }
+
+ private:
+  void* mapping_{nullptr};
+  size_t mapping_size_{0};
+  char* data_{nullptr};
+  size_t byte_size_{0};
+#ifdef _WIN32
+  void* handle_{nullptr};
+#endif
+};
+
+// The shared memory regions registered by the clients, by name. Thread-safe.
+class SharedMemoryManager {
+ public:
+  // Throws Ort::Exception if the name is already registered or the segment can't be mapped.
+  void Register(const std::string& name, const std::string& key, size_t offset, size_t byte_size);
+  // Throws Ort::Exception if the name isn't registered. The requests already holding the region keep it mapped.
+  void Unregister(const std::string& name);
+  // Throws Ort::Exception if the name isn't registered.
+  std::shared_ptr<SharedMemoryRegion> Get(const std::string& name) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<SharedMemoryRegion>> regions_;
+};
+
+// Handle the registration requests of the HTTP and GRPC endpoints. shared_memory is nullptr if shared memory isn't
+// enabled on the server.
+google::protobuf::util::Status RegisterSharedMemory(SharedMemoryManager* shared_memory,
+                                                    const onnxruntime::server::RegisterSharedMemoryRequest& request);
+google::protobuf::util::Status UnregisterSharedMemory(SharedMemoryManager* shared_memory,
+                                                      const onnxruntime::server::UnregisterSharedMemoryRequest& request);
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -52,6 +52,106 @@ TEST_F(ExecutorTest, TestMul_1) {
   EXPECT_EQ(expected, body);
 }
 
+TEST_F(ExecutorTest, TestMul_1_RawData) {
+  const float input_data[] = {1, 2, 3, 4, 5, 6};
+  const float expected_data[] = {1, 4, 9, 16, 25, 36};
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+
+  onnxruntime::server::Executor executor(env, "RequestId");
+  onnxruntime::server::PredictRequest request{};
+  onnxruntime::server::PredictResponse response{};
+
+  onnx::TensorProto input{};
+  input.add_dims(3);
+  input.add_dims(2);
+  input.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  input.set_raw_data(input_data, sizeof(input_data));
+  (*request.mutable_inputs())["X"] = input;
+  request.add_output_filter("Y");
+
+  auto prediction_res = executor.Predict("Name", "version", request, response);
+  EXPECT_TRUE(prediction_res.ok());
+
+  ASSERT_EQ(response.outputs().count("Y"), 1u);
+  const auto& output = response.outputs().at("Y");
+  EXPECT_EQ(output.data_type(), onnx::TensorProto_DataType_FLOAT);
+  EXPECT_EQ(output.raw_data(), std::string(reinterpret_cast<const char*>(expected_data), sizeof(expected_data)));
+}
+
+TEST_F(ExecutorTest, BatchingRequiresSymbolicBatchDimension) {
+  // the input of mul_1 has the fixed shape [3,2]
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  EXPECT_THROW(env->EnableBatching("Name", "version", 8, 1000), Ort::Exception);
+  EXPECT_EQ(env->GetBatcher("Name", "version"), nullptr);
+}
+
+TEST_F(ExecutorTest, SwitchServingVersion) {
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}},"outputFilter":["Y"]})";
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  env->ReleaseDrainedModels();
+
+  env->InitializeModel("testdata/mul_1.onnx", "Name", "version2");
+  EXPECT_EQ(env->GetServingVersion("Name"), "version");
+  env->WarmUpModel("Name", "version2");
+  env->SetServingVersion("Name", "version2");
+  EXPECT_EQ(env->GetServingVersion("Name"), "version2");
+
+  onnxruntime::server::Executor executor(env, "RequestId");
+  onnxruntime::server::PredictRequest request{};
+  onnxruntime::server::PredictResponse response{};
+  EXPECT_TRUE(onnxruntime::server::GetRequestFromJson(input_json, request).ok());
+  EXPECT_TRUE(executor.Predict("Name", "", request, response).ok());
+
+  // an unloaded version stays alive while a request holds it
+  auto model = env->GetModel("Name", "version2");
+  env->UnloadModel("Name", "version2");
+  EXPECT_EQ(env->GetServingVersion("Name"), "");
+  EXPECT_THROW(env->GetModel("Name", ""), Ort::Exception);
+  EXPECT_EQ(env->ReleaseDrainedModels(), 0u);
+
+  model.reset();
+  EXPECT_EQ(env->ReleaseDrainedModels(), 1u);
+}
+
+TEST(ExecutorModelOptionsTest, LimitedConcurrentRuns) {
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}},"outputFilter":["Y"]})";
+  const static auto expected = R"({"outputs":{"Y":{"dims":["3","2"],"dataType":1,"floatData":[1,4,9,16,25,36]}}})";
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  onnxruntime::server::ServerEnvironment::ModelOptions options;
+  options.max_concurrent_runs = 1;
+  options.intra_op_num_threads = 1;
+  env->SetModelOptions("Limited", options);
+  env->InitializeModel("testdata/mul_1.onnx", "Limited", "1");
+  EXPECT_EQ(env->GetModel("Limited", "1")->max_concurrent_runs, 1u);
+
+  // the run goes through the async run threads of the session
+  onnxruntime::server::Executor executor(env, "RequestId");
+  onnxruntime::server::PredictRequest request{};
+  onnxruntime::server::PredictResponse response{};
+  EXPECT_TRUE(onnxruntime::server::GetRequestFromJson(input_json, request).ok());
+  EXPECT_TRUE(executor.Predict("Limited", "1", request, response).ok());
+
+  std::string body;
+  EXPECT_TRUE(GenerateResponseInJson(response, body).ok());
+  EXPECT_EQ(expected, body);
+
+  env->UnloadModel("Limited", "1");
+}
+
+#ifndef USE_CUDA
+TEST(ExecutorModelOptionsTest, CudaDevicesRequireCuda) {
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  onnxruntime::server::ServerEnvironment::ModelOptions options;
+  options.cuda_device_ids = {0, 1};
+  env->SetModelOptions("Replicated", options);
+  EXPECT_THROW(env->InitializeModel("testdata/mul_1.onnx", "Replicated", "1"), Ort::Exception);
+  EXPECT_THROW(env->GetModel("Replicated", "1"), Ort::Exception);
+}
+#endif
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
@@ -49,6 +49,26 @@ TEST(JsonDeserializationTests, InvalidJson) {
   EXPECT_EQ("Expected : between key:value pair.\n{inputs\":{\"Input3\":{\"dims\":\n       ^", status.error_message());
 }
 
+TEST(JsonDeserializationTests, NumbersMatchProtobufParser) {
+  std::string input_json = R"({"inputs":{"X":{"dims":["3",2],"dataType":"FLOAT","floatData":[1,-2.5,3e-3,"NaN","-Infinity",6]},)"
+                           R"("Y":{"dims":[2],"data_type":7,"int64Data":["-9223372036854775808",12]}},)"
+                           R"("foo":{"bar":[true,false,1.5]},"outputFilter":["Z"]})";
+  onnxruntime::server::PredictRequest request;
+  protobufutil::Status status = onnxruntime::server::GetRequestFromJson(input_json, request);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+
+  onnxruntime::server::PredictRequest expected;
+  protobufutil::JsonParseOptions options;
+  options.ignore_unknown_fields = true;
+  ASSERT_TRUE(JsonStringToMessage(input_json, &expected, options).ok());
+  EXPECT_EQ(expected.output_filter_size(), 1);
+  EXPECT_EQ(expected.output_filter(0), request.output_filter(0));
+  for (const auto& input : expected.inputs()) {
+    ASSERT_EQ(request.inputs().count(input.first), 1u);
+    EXPECT_EQ(input.second.DebugString(), request.inputs().at(input.first).DebugString());
+  }
+}
+
 TEST(JsonSerializationTests, HappyPath) {
   std::string test_data = "testdata/server/response_0.pb";
   std::string expected_json_string = R"({"outputs":{"Plus214_Output_0":{"dims":["1","10"],"dataType":1,"rawData":"4+pzRFWuGsSMdM1F2gEnRFdRZcRZ9NDEURj0xBIzdsJOS0LEA/GzxA=="}}})";
@@ -123,6 +143,17 @@ TEST(JsonErrorMessageTests, MessageWithManyCarriageCharacters) {
   EXPECT_EQ(expected, result_t);
 }
 
+TEST(JsonResponseCacheStatsTests, HitRate) {
+  ResponseCache::Stats stats;
+  stats.hits = 3;
+  stats.misses = 1;
+  stats.insertions = 1;
+  stats.entries = 1;
+  stats.bytes = 64;
+  std::string expected = "{\"hits\": 3, \"misses\": 1, \"hit_rate\": 0.75, \"insertions\": 1, \"evictions\": 0, \"expirations\": 0, \"entries\": 1, \"bytes\": 64}\n";
+  EXPECT_EQ(expected, CreateJsonResponseCacheStats(stats));
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "response_cache.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+static onnxruntime::server::PredictRequest CreateRequest(float value) {
+  onnxruntime::server::PredictRequest request{};
+  auto& input = (*request.mutable_inputs())["X"];
+  input.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  input.add_dims(1);
+  input.add_float_data(value);
+  return request;
+}
+
+static onnxruntime::server::PredictResponse CreateResponse(float value) {
+  onnxruntime::server::PredictResponse response{};
+  auto& output = (*response.mutable_outputs())["Y"];
+  output.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  output.add_dims(1);
+  output.add_float_data(value);
+  return response;
+}
+
+TEST(ResponseCacheTests, KeyIgnoresInputOrder) {
+  onnxruntime::server::PredictRequest request1{};
+  (*request1.mutable_inputs())["A"].add_float_data(1);
+  (*request1.mutable_inputs())["B"].add_float_data(2);
+  onnxruntime::server::PredictRequest request2{};
+  (*request2.mutable_inputs())["B"].add_float_data(2);
+  (*request2.mutable_inputs())["A"].add_float_data(1);
+
+  EXPECT_EQ(ResponseCache::MakeKey("model", "1", request1), ResponseCache::MakeKey("model", "1", request2));
+  EXPECT_NE(ResponseCache::MakeKey("model", "1", request1), ResponseCache::MakeKey("model", "2", request1));
+  EXPECT_NE(ResponseCache::MakeKey("model", "1", request1), ResponseCache::MakeKey("model", "1", CreateRequest(1)));
+}
+
+TEST(ResponseCacheTests, HitAndMiss) {
+  ResponseCache cache(8, 1 << 20, std::chrono::seconds(60));
+  auto key = ResponseCache::MakeKey("model", "1", CreateRequest(1));
+
+  onnxruntime::server::PredictResponse response{};
+  EXPECT_FALSE(cache.Lookup(key, response));
+  cache.Insert(key, CreateResponse(2));
+  ASSERT_TRUE(cache.Lookup(key, response));
+  EXPECT_EQ(response.outputs().at("Y").float_data(0), 2);
+  EXPECT_FALSE(cache.Lookup(ResponseCache::MakeKey("model", "1", CreateRequest(2)), response));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 2u);
+  EXPECT_EQ(stats.insertions, 1u);
+  EXPECT_EQ(stats.entries, 1u);
+  EXPECT_GT(stats.bytes, key.size());
+}
+
+TEST(ResponseCacheTests, EvictsLeastRecentlyUsed) {
+  ResponseCache cache(2, 1 << 20, std::chrono::seconds(60));
+  auto key1 = ResponseCache::MakeKey("model", "1", CreateRequest(1));
+  auto key2 = ResponseCache::MakeKey("model", "1", CreateRequest(2));
+  auto key3 = ResponseCache::MakeKey("model", "1", CreateRequest(3));
+
+  onnxruntime::server::PredictResponse response{};
+  cache.Insert(key1, CreateResponse(1));
+  cache.Insert(key2, CreateResponse(2));
+  EXPECT_TRUE(cache.Lookup(key1, response));
+  cache.Insert(key3, CreateResponse(3));
+
+  EXPECT_TRUE(cache.Lookup(key1, response));
+  EXPECT_FALSE(cache.Lookup(key2, response));
+  EXPECT_TRUE(cache.Lookup(key3, response));
+  EXPECT_EQ(cache.GetStats().evictions, 1u);
+  EXPECT_EQ(cache.GetStats().entries, 2u);
+}
+
+TEST(ResponseCacheTests, BoundedBytes) {
+  auto key1 = ResponseCache::MakeKey("model", "1", CreateRequest(1));
+  auto key2 = ResponseCache::MakeKey("model", "1", CreateRequest(2));
+  auto entry_bytes = key1.size() + CreateResponse(1).ByteSizeLong();
+  ResponseCache cache(8, entry_bytes + 1, std::chrono::seconds(60));
+
+  onnxruntime::server::PredictResponse response{};
+  cache.Insert(key1, CreateResponse(1));
+  cache.Insert(key2, CreateResponse(2));
+  EXPECT_FALSE(cache.Lookup(key1, response));
+  EXPECT_TRUE(cache.Lookup(key2, response));
+  EXPECT_EQ(cache.GetStats().bytes, entry_bytes);
+
+  // a response larger than the cache isn't cached
+  ResponseCache small_cache(8, entry_bytes - 1, std::chrono::seconds(60));
+  small_cache.Insert(key1, CreateResponse(1));
+  EXPECT_EQ(small_cache.GetStats().entries, 0u);
+}
+
+TEST(ResponseCacheTests, Expiration) {
+  ResponseCache cache(8, 1 << 20, std::chrono::milliseconds(10));
+  auto key = ResponseCache::MakeKey("model", "1", CreateRequest(1));
+  cache.Insert(key, CreateResponse(1));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  onnxruntime::server::PredictResponse response{};
+  EXPECT_FALSE(cache.Lookup(key, response));
+  EXPECT_EQ(cache.GetStats().expirations, 1u);
+  EXPECT_EQ(cache.GetStats().entries, 0u);
+  EXPECT_EQ(cache.GetStats().bytes, 0u);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
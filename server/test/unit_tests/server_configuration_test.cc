@@ -98,6 +98,183 @@ TEST(ConfigParsingTests, WrongLoggingLevel) {
   EXPECT_EQ(res, Result::ExitFailure);
 }
 
+TEST(ConfigParsingTests, Batching) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("16"),
+      const_cast<char*>("--max_batch_delay_us"), const_cast<char*>("500")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.max_batch_size, 16);
+  EXPECT_EQ(config.max_batch_delay_us, 500);
+}
+
+TEST(ConfigParsingTests, NegativeBatchSize) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("-1")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, GrpcThreadsAndQueueLimit) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--num_grpc_threads"), const_cast<char*>("4"),
+      const_cast<char*>("--max_queued_requests"), const_cast<char*>("64")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.num_grpc_threads, 4);
+  EXPECT_EQ(config.max_queued_requests, 64);
+}
+
+TEST(ConfigParsingTests, ZeroGrpcThreads) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--num_grpc_threads"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, ModelRepository) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_repository"), const_cast<char*>("testdata"),
+      const_cast<char*>("--model_poll_interval_s"), const_cast<char*>("10")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.model_repository, "testdata");
+  EXPECT_EQ(config.model_poll_interval_s, 10);
+}
+
+TEST(ConfigParsingTests, ModelPathAndRepository) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--model_repository"), const_cast<char*>("testdata")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, ModelOptions) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--model_options"), const_cast<char*>("default:max_concurrent_runs=2,intra_op_num_threads=4"),
+      const_cast<char*>("--model_options"), const_cast<char*>("other:max_queued_requests=16")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  ASSERT_EQ(config.model_configs.size(), 2u);
+  EXPECT_EQ(config.model_configs["default"].max_concurrent_runs, 2);
+  EXPECT_EQ(config.model_configs["default"].intra_op_num_threads, 4);
+  EXPECT_EQ(config.model_configs["default"].max_queued_requests, 0);
+  EXPECT_EQ(config.model_configs["other"].max_queued_requests, 16);
+}
+
+TEST(ConfigParsingTests, CudaDevices) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--model_options"), const_cast<char*>("default:cuda_devices=0;1;3,max_concurrent_runs=2")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.model_configs["default"].cuda_devices, std::vector<int>({0, 1, 3}));
+  EXPECT_EQ(config.model_configs["default"].max_concurrent_runs, 2);
+}
+
+TEST(ConfigParsingTests, InvalidModelOptions) {
+  for (auto* model_options : {"default", "default:unknown=1", "default:max_concurrent_runs=-1", "default:intra_op_num_threads=x",
+                              "default:max_queued_requests=1;2", "default:cuda_devices=0;x"}) {
+    char* test_argv[] = {
+        const_cast<char*>("/path/to/binary"),
+        const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+        const_cast<char*>("--model_options"), const_cast<char*>(model_options)};
+
+    onnxruntime::server::ServerConfiguration config{};
+    Result res = config.ParseInput(5, test_argv);
+    EXPECT_EQ(res, Result::ExitFailure) << model_options;
+  }
+}
+
+TEST(ConfigParsingTests, ResponseCache) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--response_cache_entries"), const_cast<char*>("1000"),
+      const_cast<char*>("--response_cache_ttl_s"), const_cast<char*>("60"),
+      const_cast<char*>("--model_options"), const_cast<char*>("random:cache_responses=0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(9, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.response_cache_entries, 1000);
+  EXPECT_EQ(config.response_cache_mb, 256);
+  EXPECT_EQ(config.response_cache_ttl_s, 60);
+  EXPECT_FALSE(config.model_configs["random"].cache_responses);
+}
+
+TEST(ConfigParsingTests, SharedMemory) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--enable_shared_memory")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  EXPECT_FALSE(config.enable_shared_memory);
+  Result res = config.ParseInput(4, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_TRUE(config.enable_shared_memory);
+}
+
+TEST(ConfigParsingTests, ZeroResponseCacheTtl) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--response_cache_ttl_s"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, CodecThreads) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--num_codec_threads"), const_cast<char*>("2")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  EXPECT_EQ(config.num_codec_threads, 0);
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.num_codec_threads, 2);
+
+  test_argv[4] = const_cast<char*>("-1");
+  onnxruntime::server::ServerConfiguration negative_config{};
+  res = negative_config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "executor.h"
+#include "shared_memory.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+// A POSIX shared memory segment of a client
+class SharedMemorySegment {
+ public:
+  SharedMemorySegment(const std::string& key, size_t size) : key_(key), size_(size) {
+    int fd = shm_open(key.c_str(), O_CREAT | O_RDWR, 0600);
+    EXPECT_NE(fd, -1);
+    EXPECT_EQ(ftruncate(fd, size), 0);
+    data_ = static_cast<char*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    close(fd);
+  }
+
+  ~SharedMemorySegment() {
+    munmap(data_, size_);
+    shm_unlink(key_.c_str());
+  }
+
+  char* Data() const { return data_; }
+
+ private:
+  std::string key_;
+  size_t size_;
+  char* data_;
+};
+
+TEST(SharedMemoryTests, RegisterAndUnregister) {
+  SharedMemorySegment segment("/ort_server_test_register", 8192);
+  std::strcpy(segment.Data() + 5000, "tensor");
+
+  SharedMemoryManager manager;
+  manager.Register("region", "/ort_server_test_register", 4096, 4096);
+  EXPECT_THROW(manager.Register("region", "/ort_server_test_register", 0, 16), Ort::Exception);
+
+  auto region = manager.Get("region");
+  EXPECT_EQ(region->GetByteSize(), 4096u);
+  EXPECT_STREQ(region->GetRange(904, 7), "tensor");
+  EXPECT_THROW(region->GetRange(4000, 100), Ort::Exception);
+
+  // the regions in use stay mapped
+  manager.Unregister("region");
+  EXPECT_THROW(manager.Get("region"), Ort::Exception);
+  EXPECT_THROW(manager.Unregister("region"), Ort::Exception);
+  EXPECT_STREQ(region->GetRange(904, 7), "tensor");
+}
+
+TEST(SharedMemoryTests, InvalidSegment) {
+  SharedMemorySegment segment("/ort_server_test_invalid", 4096);
+
+  SharedMemoryManager manager;
+  EXPECT_THROW(manager.Register("region", "/ort_server_test_missing", 0, 16), Ort::Exception);
+  EXPECT_THROW(manager.Register("region", "/ort_server_test_invalid", 4000, 100), Ort::Exception);
+  EXPECT_THROW(manager.Register("region", "/ort_server_test_invalid", 0, 0), Ort::Exception);
+}
+
+TEST(SharedMemoryTests, PredictInSharedMemory) {
+  const float input_data[] = {1, 2, 3, 4, 5, 6};
+  const float expected_data[] = {1, 4, 9, 16, 25, 36};
+
+  SharedMemorySegment segment("/ort_server_test_predict", 4096);
+  std::memcpy(segment.Data(), input_data, sizeof(input_data));
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  env->EnableSharedMemory();
+  env->InitializeModel("testdata/mul_1.onnx", "SharedMemory", "1");
+
+  onnxruntime::server::RegisterSharedMemoryRequest registration{};
+  registration.set_name("tensors");
+  registration.set_key("/ort_server_test_predict");
+  registration.set_byte_size(4096);
+  EXPECT_TRUE(RegisterSharedMemory(env->GetSharedMemory(), registration).ok());
+
+  onnxruntime::server::PredictRequest request{};
+  auto& input = (*request.mutable_inputs())["X"];
+  input.add_dims(3);
+  input.add_dims(2);
+  input.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  input.set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+  auto* location = input.add_external_data();
+  location->set_key("location");
+  location->set_value("tensors");
+  auto& output = (*request.mutable_output_shared_memory())["Y"];
+  output.set_region("tensors");
+  output.set_offset(1024);
+  output.set_length(1024);
+
+  onnxruntime::server::Executor executor(env, "RequestId");
+  onnxruntime::server::PredictResponse response{};
+  auto status = executor.Predict("SharedMemory", "1", request, response);
+  EXPECT_TRUE(status.ok()) << status.error_message();
+
+  ASSERT_EQ(response.outputs().count("Y"), 1u);
+  const auto& result = response.outputs().at("Y");
+  EXPECT_EQ(result.data_location(), onnx::TensorProto_DataLocation_EXTERNAL);
+  EXPECT_FALSE(result.has_raw_data());
+  ASSERT_EQ(result.external_data_size(), 3);
+  EXPECT_EQ(result.external_data(2).key(), "length");
+  EXPECT_EQ(result.external_data(2).value(), std::to_string(sizeof(expected_data)));
+  EXPECT_EQ(std::memcmp(segment.Data() + 1024, expected_data, sizeof(expected_data)), 0);
+
+  // a region out of bounds fails the request
+  output.set_offset(4000);
+  onnxruntime::server::Executor executor2(env, "RequestId");
+  EXPECT_FALSE(executor2.Predict("SharedMemory", "1", request, response).ok());
+
+  onnxruntime::server::UnregisterSharedMemoryRequest unregistration{};
+  unregistration.set_name("tensors");
+  EXPECT_TRUE(UnregisterSharedMemory(env->GetSharedMemory(), unregistration).ok());
+  env->UnloadModel("SharedMemory", "1");
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
+
+#endif
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <google/protobuf/stubs/status.h>
+
+#include "gtest/gtest.h"
+
+#include "onnx-ml.pb.h"
+#include "predict.pb.h"
+#include "http/tensor_payload.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace protobufutil = google::protobuf::util;
+
+TEST(TensorPayloadTests, RoundTrip) {
+  const float data[] = {1.5f, -2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  onnxruntime::server::PredictResponse response;
+  auto& output = (*response.mutable_outputs())["Y"];
+  output.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  output.add_dims(3);
+  output.add_dims(2);
+  output.set_raw_data(data, sizeof(data));
+
+  std::string payload;
+  auto status = GenerateResponseInTensorPayload(response, payload);
+  ASSERT_TRUE(status.ok()) << status.error_message();
+
+  // a response has the layout of a request without output filter
+  onnxruntime::server::PredictRequest request;
+  status = GetRequestFromTensorPayload(payload, request);
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  ASSERT_EQ(request.inputs().count("Y"), 1u);
+  EXPECT_EQ(request.inputs().at("Y").DebugString(), output.DebugString());
+  EXPECT_EQ(request.output_filter_size(), 0);
+}
+
+TEST(TensorPayloadTests, Truncated) {
+  onnxruntime::server::PredictResponse response;
+  auto& output = (*response.mutable_outputs())["Y"];
+  output.set_data_type(onnx::TensorProto_DataType_INT64);
+  output.add_dims(1);
+  int64_t value = 42;
+  output.set_raw_data(&value, sizeof(value));
+
+  std::string payload;
+  ASSERT_TRUE(GenerateResponseInTensorPayload(response, payload).ok());
+
+  for (size_t size = 0; size < payload.size(); ++size) {
+    onnxruntime::server::PredictRequest request;
+    auto status = GetRequestFromTensorPayload(payload.substr(0, size), request);
+    EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, status.error_code()) << size;
+  }
+}
+
+TEST(TensorPayloadTests, OutputWithoutRawData) {
+  onnxruntime::server::PredictResponse response;
+  auto& output = (*response.mutable_outputs())["Y"];
+  output.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  output.add_dims(1);
+  output.add_float_data(1.0f);
+
+  std::string payload;
+  auto status = GenerateResponseInTensorPayload(response, payload);
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, status.error_code());
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,306 @@
+#!/usr/bin/env python3
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+
+"""
+Runs a set of models through onnxruntime on each of the requested execution providers, and compares the latencies
+with those of a baseline run to catch performance regressions between two builds or versions of onnxruntime.
+
+The 'run' action measures the models listed in a JSON config file and saves the results, which can be kept as the
+baseline of later runs. The 'compare' action compares two results files: a model is reported as a regression when
+its median latency is more than --threshold slower than the baseline and a Mann-Whitney U test of the two sets of
+latencies rejects that they come from the same distribution at the --alpha significance level. When the runs were
+profiled, the report also lists the ops whose time changed the most.
+"""
+
+import argparse
+import glob
+import json
+import math
+import os
+import platform
+import sys
+import time
+
+import numpy as np
+import onnx
+from onnx import numpy_helper
+import onnxruntime as ort
+
+numpy_types = {
+    'tensor(float16)': np.float16,
+    'tensor(float)': np.float32,
+    'tensor(double)': np.float64,
+    'tensor(int8)': np.int8,
+    'tensor(uint8)': np.uint8,
+    'tensor(int16)': np.int16,
+    'tensor(uint16)': np.uint16,
+    'tensor(int32)': np.int32,
+    'tensor(int64)': np.int64,
+    'tensor(uint64)': np.uint64,
+    'tensor(bool)': np.bool_,
+}
+
+
+def load_test_data(test_data_dir, session):
+    """Loads the input_*.pb files of a directory in the ONNX test format, in the order of the model inputs."""
+    files = sorted(glob.glob(os.path.join(test_data_dir, 'input_*.pb')))
+    feeds = {}
+    for model_input, filename in zip(session.get_inputs(), files):
+        tensor = onnx.TensorProto()
+        with open(filename, 'rb') as f:
+            tensor.ParseFromString(f.read())
+        feeds[tensor.name or model_input.name] = numpy_helper.to_array(tensor)
+    return feeds
+
+
+def create_random_feeds(session, symbolic_dims, value_range):
+    """Creates random inputs, using the given values of the symbolic dimensions (1 if not given)."""
+    rng = np.random.RandomState(123)
+    low, high = value_range
+    feeds = {}
+    for model_input in session.get_inputs():
+        shape = [dim if isinstance(dim, int) else symbolic_dims.get(dim, 1) for dim in model_input.shape]
+        dtype = numpy_types[model_input.type]
+        if np.issubdtype(dtype, np.floating):
+            feeds[model_input.name] = rng.uniform(low, high, shape).astype(dtype)
+        elif dtype == np.bool_:
+            feeds[model_input.name] = rng.randint(0, 2, shape).astype(dtype)
+        else:
+            feeds[model_input.name] = rng.randint(int(low), int(high), shape).astype(dtype)
+    return feeds
+
+
+def create_session(model_path, provider, profile_prefix=None):
+    options = ort.SessionOptions()
+    if profile_prefix:
+        options.enable_profiling = True
+        options.profile_file_prefix = profile_prefix
+    return ort.InferenceSession(model_path, options, providers=[provider])
+
+
+def aggregate_profile(profile_file, runs):
+    """
+    Returns the average time per run of each op type, in ms, from the node events of a profile.
+    The first run of the profile is left out, like a warmup run.
+    """
+    with open(profile_file) as f:
+        events = json.load(f)
+
+    model_runs = sorted((event for event in events if event['name'] == 'model_run'), key=lambda event: event['ts'])
+    first_run_end = model_runs[0]['ts'] + model_runs[0]['dur'] if model_runs else 0
+
+    op_times = {}
+    for event in events:
+        if event.get('cat') == 'Node' and event['name'].endswith('_kernel_time') and event['ts'] >= first_run_end:
+            op_type = event.get('args', {}).get('op_name', 'unknown')
+            op_times[op_type] = op_times.get(op_type, 0.0) + event['dur'] / 1000.0
+    return {op_type: total / runs for op_type, total in op_times.items()}
+
+
+def measure_model(model, provider, args):
+    session = create_session(model['path'], provider)
+    if 'test_data_dir' in model:
+        feeds = load_test_data(model['test_data_dir'], session)
+    else:
+        feeds = create_random_feeds(session, model.get('symbolic_dims', {}), model.get('input_range', [0, 1]))
+
+    for _ in range(args.warmup):
+        session.run(None, feeds)
+
+    latencies = []
+    for _ in range(args.iterations):
+        start = time.perf_counter()
+        session.run(None, feeds)
+        latencies.append((time.perf_counter() - start) * 1000.0)
+
+    result = {'latencies_ms': latencies}
+
+    # the ops are timed in a separate session, so the overhead of profiling doesn't change the latencies above
+    if args.profile_runs > 0:
+        profiled_session = create_session(model['path'], provider, os.path.join(args.profile_dir, model['name']))
+        for _ in range(args.profile_runs + 1):
+            profiled_session.run(None, feeds)
+        profile_file = profiled_session.end_profiling()
+        result['op_times_ms'] = aggregate_profile(profile_file, args.profile_runs)
+        os.remove(profile_file)
+
+    return result
+
+
+def run(args):
+    with open(args.config) as f:
+        config = json.load(f)
+    config_dir = os.path.dirname(os.path.abspath(args.config))
+    available_providers = ort.get_available_providers()
+    os.makedirs(args.profile_dir, exist_ok=True)
+
+    results = {}
+    for model in config['models']:
+        # paths in the config are relative to the config file
+        model = dict(model)
+        model['path'] = os.path.join(config_dir, model['path'])
+        if 'test_data_dir' in model:
+            model['test_data_dir'] = os.path.join(config_dir, model['test_data_dir'])
+
+        for provider in model.get('providers', config.get('providers', ['CPUExecutionProvider'])):
+            key = '{}|{}'.format(model['name'], provider)
+            if provider not in available_providers:
+                print('Skipping {}: {} is not available in this build'.format(key, provider))
+                continue
+            print('Running {}'.format(key))
+            results[key] = measure_model(model, provider, args)
+
+    output = {
+        'onnxruntime_version': ort.__version__,
+        'machine': platform.platform(),
+        'processor': platform.processor(),
+        'iterations': args.iterations,
+        'results': results,
+    }
+    with open(args.output, 'w') as f:
+        json.dump(output, f, indent=2)
+    print('Saved the results to {}'.format(args.output))
+
+    if args.baseline:
+        args.current = args.output
+        return compare(args)
+    return 0
+
+
+def mann_whitney_u_test(x, y):
+    """
+    Two-sided Mann-Whitney U test with the normal approximation, corrected for ties.
+    Returns the p-value of the hypothesis that x and y come from the same distribution.
+    """
+    n1, n2 = len(x), len(y)
+    values = np.concatenate([x, y])
+    order = np.argsort(values, kind='mergesort')
+    sorted_values = values[order]
+
+    # average ranks, starting at 1, for the tied values
+    ranks = np.empty(len(values))
+    tie_correction = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and sorted_values[j + 1] == sorted_values[i]:
+            j += 1
+        ranks[order[i:j + 1]] = (i + j) / 2.0 + 1
+        ties = j - i + 1
+        tie_correction += ties**3 - ties
+        i = j + 1
+
+    u = ranks[:n1].sum() - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    mean = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_correction / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (u - mean) / math.sqrt(variance)
+    return math.erfc(abs(z) / math.sqrt(2))
+
+
+def compare(args):
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.current) as f:
+        current = json.load(f)
+
+    lines = ['# Performance comparison', '',
+             'Baseline: onnxruntime {} on {}'.format(baseline['onnxruntime_version'], baseline['machine']),
+             'Current: onnxruntime {} on {}'.format(current['onnxruntime_version'], current['machine']), '',
+             '| Model | Baseline median (ms) | Current median (ms) | Change | p-value | Status |',
+             '|---|---|---|---|---|---|']
+    op_lines = []
+    regressions = 0
+
+    for key in sorted(current['results']):
+        if key not in baseline['results']:
+            lines.append('| {} | - | - | - | - | no baseline |'.format(key))
+            continue
+
+        baseline_result = baseline['results'][key]
+        current_result = current['results'][key]
+        baseline_median = float(np.median(baseline_result['latencies_ms']))
+        current_median = float(np.median(current_result['latencies_ms']))
+        change = current_median / baseline_median - 1
+        p_value = mann_whitney_u_test(np.array(current_result['latencies_ms']),
+                                      np.array(baseline_result['latencies_ms']))
+
+        status = 'unchanged'
+        if p_value < args.alpha and abs(change) > args.threshold:
+            status = 'REGRESSION' if change > 0 else 'improvement'
+        if status == 'REGRESSION':
+            regressions += 1
+        lines.append('| {} | {:.3f} | {:.3f} | {:+.1%} | {:.2g} | {} |'.format(key, baseline_median, current_median,
+                                                                             change, p_value, status))
+
+        baseline_ops = baseline_result.get('op_times_ms')
+        current_ops = current_result.get('op_times_ms')
+        if baseline_ops and current_ops:
+            deltas = []
+            for op_type in set(baseline_ops) | set(current_ops):
+                before = baseline_ops.get(op_type, 0.0)
+                after = current_ops.get(op_type, 0.0)
+                deltas.append((after - before, op_type, before, after))
+            deltas.sort(key=lambda delta: -abs(delta[0]))
+            op_lines += ['', '### {}'.format(key), '', '| Op | Baseline (ms) | Current (ms) | Change (ms) |',
+                         '|---|---|---|---|']
+            for delta, op_type, before, after in deltas[:args.top_ops]:
+                op_lines.append('| {} | {:.3f} | {:.3f} | {:+.3f} |'.format(op_type, before, after, delta))
+
+    if op_lines:
+        lines += ['', '## Ops with the largest changes in time per run'] + op_lines
+
+    report = '\n'.join(lines) + '\n'
+    print(report)
+    if args.report:
+        with open(args.report, 'w') as f:
+            f.write(report)
+
+    return 1 if regressions else 0
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    subparsers = parser.add_subparsers(dest='action')
+    subparsers.required = True
+
+    run_parser = subparsers.add_parser('run', help='Measure the models of a config file.')
+    run_parser.add_argument('--config', required=True,
+                            help='JSON file listing the models: {"providers": [...], "models": [{"name": ..., '
+                                 '"path": ..., "providers": [...], "test_data_dir": ..., "symbolic_dims": {...}, '
+                                 '"input_range": [low, high]}]}. Only the name and path of a model are required.')
+    run_parser.add_argument('--output', required=True, help='File to save the results to.')
+    run_parser.add_argument('--warmup', type=int, default=10, help='Runs before the measured ones.')
+    run_parser.add_argument('--iterations', type=int, default=200, help='Measured runs of each model.')
+    run_parser.add_argument('--profile_runs', type=int, default=20,
+                            help='Profiled runs of each model, to measure the time of each op. 0 to disable.')
+    run_parser.add_argument('--profile_dir', default='.', help='Directory for the temporary profile files.')
+    run_parser.add_argument('--baseline', help='Results to compare the new results with.')
+
+    compare_parser = subparsers.add_parser('compare', help='Compare two results files.')
+    compare_parser.add_argument('--baseline', required=True, help='Results of the baseline run.')
+    compare_parser.add_argument('--current', required=True, help='Results of the run to check.')
+
+    for action_parser in [run_parser, compare_parser]:
+        action_parser.add_argument('--alpha', type=float, default=0.01,
+                                   help='Significance level of the test of a latency change.')
+        action_parser.add_argument('--threshold', type=float, default=0.05,
+                                   help='Smallest relative change of the median latency that is reported.')
+        action_parser.add_argument('--top_ops', type=int, default=10, help='Ops to list for each model.')
+        action_parser.add_argument('--report', help='File to write the Markdown report to.')
+
+    return parser.parse_args()
+
+
+def main():
+    args = parse_arguments()
+    if args.action == 'run':
+        return run(args)
+    return compare(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
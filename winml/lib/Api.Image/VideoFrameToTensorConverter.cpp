@@ -137,15 +137,92 @@ void VideoFrameToTensorConverter::VideoFrameToDX12Tensor(
     _In_ const wgi::BitmapBounds& inputBounds,
     _In_ const ImageTensorDescription& tensorDesc,
     _Inout_ ID3D12Resource* pOutputTensor) {
+  CWinMLAutoLock lock(&lock_);
+  auto device = session.Device().as<winmlp::LearningModelDevice>();
+  _winml::D3DDeviceCache* pDeviceCache = device->GetD3DDeviceCache();
+
+  PrepareBatchResources(*pDeviceCache, tensorDesc, batchIdx + 1, inputVideoFrame.SoftwareBitmap() != nullptr);
+  TensorizeVideoFrameToDX12(batchIdx, *pDeviceCache, inputVideoFrame, inputBounds, tensorDesc, pOutputTensor);
+}
+
+void VideoFrameToTensorConverter::VideoFramesToDX12Tensor(
+    _In_ winml::LearningModelSession& session,
+    _In_ const wfc::IVector<wm::VideoFrame>& inputVideoFrames,
+    _In_ const std::vector<wgi::BitmapBounds>& inputBounds,
+    _In_ const ImageTensorDescription& tensorDesc,
+    _Inout_ ID3D12Resource* pOutputTensor) {
+  WINML_THROW_HR_IF_FALSE_MSG(E_INVALIDARG, inputBounds.size() == inputVideoFrames.Size(), "Expected %d bounds, but %d were supplied.", inputVideoFrames.Size(), static_cast<UINT32>(inputBounds.size()));
+
+  CWinMLAutoLock lock(&lock_);
+  auto device = session.Device().as<winmlp::LearningModelDevice>();
+  _winml::D3DDeviceCache* pDeviceCache = device->GetD3DDeviceCache();
+
+  bool needsUploadHeap = false;
+  for (const auto& videoFrame : inputVideoFrames) {
+    needsUploadHeap |= videoFrame.SoftwareBitmap() != nullptr;
+  }
+
+  PrepareBatchResources(*pDeviceCache, tensorDesc, inputVideoFrames.Size(), needsUploadHeap);
+  for (uint32_t batchIdx = 0; batchIdx < inputVideoFrames.Size(); ++batchIdx) {
+    TensorizeVideoFrameToDX12(batchIdx, *pDeviceCache, inputVideoFrames.GetAt(batchIdx), inputBounds[batchIdx], tensorDesc, pOutputTensor);
+  }
+}
+
+void VideoFrameToTensorConverter::PrepareBatchResources(
+    _In_ _winml::D3DDeviceCache& device_cache,
+    _In_ const ImageTensorDescription& tensorDesc,
+    _In_ const UINT32 frameCount,
+    _In_ bool needsUploadHeap) {
+  // The descriptors, the upload heap and the shared input textures are reused by every call,
+  // so the previous tensorization must be done with them. Frames of the same batch don't wait for each other.
+  if (fence_completion_value_ > 0) {
+    device_cache.WaitForFenceValue(fence_completion_value_);
+    fence_completion_value_ = 0;
+  }
+  batch_input_resources_.clear();
+
+  // Each frame of the batch gets its own SRV and UAV.
+  UINT descriptorCount = DescriptorCount * frameCount;
+  if (descriptor_heap_ == nullptr || descriptor_heap_->GetDesc().NumDescriptors < descriptorCount) {
+    // Describe and create a shader resource view (SRV) and unordered access view (UAV) descriptor heap.
+    D3D12_DESCRIPTOR_HEAP_DESC srvUavHeapDesc = {};
+    srvUavHeapDesc.NumDescriptors = descriptorCount;
+    srvUavHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    srvUavHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    WINML_THROW_IF_FAILED(device_cache.GetD3D12Device()->CreateDescriptorHeap(&srvUavHeapDesc, IID_PPV_ARGS(descriptor_heap_.ReleaseAndGetAddressOf())));
+    descriptor_heap_->SetName(L"Tensorize Descriptor Heap");
+  }
+
+  // Each frame backed by a SoftwareBitmap is uploaded through its own region of the upload heap.
+  if (needsUploadHeap) {
+    UINT64 tensorElementSize = tensorDesc.dataType == kImageTensorDataTypeFloat32 ? 4 : 2;
+    UINT64 bufferSize = tensorDesc.sizes[1] * tensorDesc.sizes[2] * tensorDesc.sizes[3] * tensorElementSize * frameCount;
+    if (!upload_heap_ || upload_heap_->GetDesc().Width < bufferSize) {
+      WINML_THROW_IF_FAILED(device_cache.GetD3D12Device()->CreateCommittedResource(
+          &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+          D3D12_HEAP_FLAG_NONE,
+          &CD3DX12_RESOURCE_DESC::Buffer(bufferSize),
+          D3D12_RESOURCE_STATE_GENERIC_READ,
+          nullptr,
+          IID_PPV_ARGS(upload_heap_.ReleaseAndGetAddressOf())));
+    }
+  }
+}
+
+void VideoFrameToTensorConverter::TensorizeVideoFrameToDX12(
+    _In_ const UINT32 batchIdx,
+    _In_ _winml::D3DDeviceCache& device_cache,
+    _In_ const wm::IVideoFrame& inputVideoFrame,
+    _In_ const wgi::BitmapBounds& inputBounds,
+    _In_ const ImageTensorDescription& tensorDesc,
+    _Inout_ ID3D12Resource* pOutputTensor) {
   // Validate Tensor description
   WINML_THROW_HR_IF_FALSE_MSG(E_INVALIDARG, tensorDesc.dataType == kImageTensorDataTypeFloat32 || tensorDesc.dataType == kImageTensorDataTypeFloat16, "Target tensor description must either be kImageTensorDataTypeFloat32, or kImageTensorDataTypeFloat16. %d was supplied.", tensorDesc.dataType);
   WINML_THROW_HR_IF_FALSE_MSG(E_INVALIDARG, tensorDesc.channelType != kImageTensorChannelTypeRGB8 || tensorDesc.sizes[1] == 3, "Target tensor description expects kImageTensorChannelTypeRGB8, but has %lld channels specified instead of 3.", tensorDesc.sizes[1]);
   WINML_THROW_HR_IF_FALSE_MSG(E_INVALIDARG, tensorDesc.channelType != kImageTensorChannelTypeBGR8 || tensorDesc.sizes[1] == 3, "Target tensor description expects kImageTensorChannelTypeBGR8, but has %lld channels specified instead of 3.", tensorDesc.sizes[1]);
   WINML_THROW_HR_IF_FALSE_MSG(E_INVALIDARG, tensorDesc.channelType != kImageTensorChannelTypeGRAY8 || tensorDesc.sizes[1] == 1, "Target tensor description expects kImageTensorChannelTypeGRAY8, but has %lld channels specified instead of 1.", tensorDesc.sizes[1]);
 
-  CWinMLAutoLock lock(&lock_);
-  auto device = session.Device().as<winmlp::LearningModelDevice>();
-  _winml::D3DDeviceCache* pDeviceCache = device->GetD3DDeviceCache();
+  _winml::D3DDeviceCache* pDeviceCache = &device_cache;
   wgdx::Direct3D11::IDirect3DSurface spDirect3DSurface = inputVideoFrame.Direct3DSurface();
 
   if (inputVideoFrame.SoftwareBitmap()) {
@@ -190,6 +267,10 @@ void VideoFrameToTensorConverter::VideoFrameToDX12Tensor(
         }
       }
 
+      // A previous frame of the batch may still be tensorizing from the cached texture
+      if (fence_completion_value_ > 0) {
+        SyncD3D12ToD3D11(*pDeviceCache, D3D11_cached_texture_.Get());
+      }
       CopyTextureIntoTexture(spVideoFrameTexture.Get(), scaledBounds, D3D11_cached_texture_.Get());
     } else {
       // We are not on the same device, so we can't rely on our cached texture
@@ -213,14 +294,19 @@ void VideoFrameToTensorConverter::VideoFrameToDX12Tensor(
       }
 
       // Copy from the video frame texture to the shared texture
+      if (fence_completion_value_ > 0) {
+        SyncD3D12ToD3D11(*pDeviceCache, spSharedD3D11Texture.Get());
+      }
       CopyTextureIntoTexture(spVideoFrameTexture.Get(), scaledBounds, spSharedD3D11Texture.Get());
     }
 
     // Sync to make sure that the D3D11 texture is done copying
     SyncD3D11ToD3D12(*pDeviceCache, spVideoFrameTexture.Get());
 
+    // The input resource may be replaced by the next frame of the batch before this one has been tensorized
+    batch_input_resources_.push_back(input_D3D12_resource_);
+
     // We cropped the texture, shared it and converted it to a known color format, so it's time to tensorize
-    // TODO: merge all videoframes to a single DX12Texture Resource before call ConvertDX12TextureToGPUTensor.
     ConvertDX12TextureToGPUTensor(batchIdx, input_D3D12_resource_.Get(), *pDeviceCache, tensorDesc, pOutputTensor);
   } else {
     // Invalid video frame
@@ -302,18 +388,10 @@ void VideoFrameToTensorConverter::ConvertDX12TextureToGPUTensor(
     }
   }
 
-  // Create descriptor heaps.
+  // The descriptor heap was sized for the batch by PrepareBatchResources.
   UINT srvUavDescriptorSize = spDx12Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-  if (descriptor_heap_ == nullptr) {
-    // Describe and create a shader resource view (SRV) and unordered access view (UAV) descriptor heap.
-    D3D12_DESCRIPTOR_HEAP_DESC srvUavHeapDesc = {};
-    srvUavHeapDesc.NumDescriptors = DescriptorCount;
-    srvUavHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    srvUavHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    WINML_THROW_IF_FAILED(spDx12Device->CreateDescriptorHeap(&srvUavHeapDesc, IID_PPV_ARGS(&descriptor_heap_)));
-    descriptor_heap_->SetName(L"Tensorize Descriptor Heap");
-  }
+  UINT descriptorOffset = batchIdx * DescriptorCount;
+  assert(descriptor_heap_ != nullptr && descriptor_heap_->GetDesc().NumDescriptors >= descriptorOffset + DescriptorCount);
 
   // Create SRV and UAV for input and output respectively
   {
@@ -322,11 +400,11 @@ void VideoFrameToTensorConverter::ConvertDX12TextureToGPUTensor(
     srvDesc.Format = inputDesc.Format;
     srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
     srvDesc.Texture2D.MipLevels = 1;
-    CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(descriptor_heap_->GetCPUDescriptorHandleForHeapStart(), SrvBufferIdx, srvUavDescriptorSize);
+    CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(descriptor_heap_->GetCPUDescriptorHandleForHeapStart(), descriptorOffset + SrvBufferIdx, srvUavDescriptorSize);
     spDx12Device->CreateShaderResourceView(pInputResource, &srvDesc, srvHandle);
 
     D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = CreateUAVDescription(batchIdx, outputDesc, tensorDesc);
-    CD3DX12_CPU_DESCRIPTOR_HANDLE uavHandle(descriptor_heap_->GetCPUDescriptorHandleForHeapStart(), UavBufferIdx, srvUavDescriptorSize);
+    CD3DX12_CPU_DESCRIPTOR_HANDLE uavHandle(descriptor_heap_->GetCPUDescriptorHandleForHeapStart(), descriptorOffset + UavBufferIdx, srvUavDescriptorSize);
     spDx12Device->CreateUnorderedAccessView(pOutputResource, nullptr, &uavDesc, uavHandle);
   }
 
@@ -366,14 +444,8 @@ void VideoFrameToTensorConverter::ConvertDX12TextureToGPUTensor(
     ID3D12DescriptorHeap* ppHeaps[] = {descriptor_heap_.Get()};
     command_list_->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
 
-    // This code currently re-uses the same decriptors each execution, which is unsafe if previous executions are in flight.
-    if (fence_completion_value_ > 0)
-    {
-        device_cache.WaitForFenceValue(fence_completion_value_);
-    }
-
-    CD3DX12_GPU_DESCRIPTOR_HANDLE srvHandle(descriptor_heap_->GetGPUDescriptorHandleForHeapStart(), SrvBufferIdx, srvUavDescriptorSize);
-    CD3DX12_GPU_DESCRIPTOR_HANDLE uavHandle(descriptor_heap_->GetGPUDescriptorHandleForHeapStart(), UavBufferIdx, srvUavDescriptorSize);
+    CD3DX12_GPU_DESCRIPTOR_HANDLE srvHandle(descriptor_heap_->GetGPUDescriptorHandleForHeapStart(), descriptorOffset + SrvBufferIdx, srvUavDescriptorSize);
+    CD3DX12_GPU_DESCRIPTOR_HANDLE uavHandle(descriptor_heap_->GetGPUDescriptorHandleForHeapStart(), descriptorOffset + UavBufferIdx, srvUavDescriptorSize);
     {
       ConstantBufferCS constantBufferCS = {};
       constantBufferCS.height = inputDesc.Height;
@@ -420,11 +492,17 @@ void VideoFrameToTensorConverter::ConvertSoftwareBitmapToGPUTensor(
                                            ? videoFrame.SoftwareBitmap().BitmapPixelFormat()
                                            : _winmli::GetBitmapPixelFormatFromChannelType(tensorDesc.channelType);
 
-    convertedSoftwareBitmap = wgi::SoftwareBitmap(newPixelFormat, static_cast<int32_t>(tensorDesc.sizes[3]), static_cast<int32_t>(tensorDesc.sizes[2]));
-    wm::VideoFrame convertedVideoFrame = wm::VideoFrame::CreateWithSoftwareBitmap(convertedSoftwareBitmap);
-    videoFrame.as<wm::IVideoFrame2>().CopyToAsync(convertedVideoFrame, inputBounds, scaledBounds).get();
+    // The scaled frame is reused by the next frames, since it has been tensorized when this function returns
+    if (converted_video_frame_ == nullptr ||
+        converted_video_frame_.SoftwareBitmap().BitmapPixelFormat() != newPixelFormat ||
+        converted_video_frame_.SoftwareBitmap().PixelWidth() != static_cast<int32_t>(tensorDesc.sizes[3]) ||
+        converted_video_frame_.SoftwareBitmap().PixelHeight() != static_cast<int32_t>(tensorDesc.sizes[2])) {
+      converted_video_frame_ = wm::VideoFrame::CreateWithSoftwareBitmap(
+          wgi::SoftwareBitmap(newPixelFormat, static_cast<int32_t>(tensorDesc.sizes[3]), static_cast<int32_t>(tensorDesc.sizes[2])));
+    }
+    videoFrame.as<wm::IVideoFrame2>().CopyToAsync(converted_video_frame_, inputBounds, scaledBounds).get();
 
-    convertedSoftwareBitmap = convertedVideoFrame.SoftwareBitmap();
+    convertedSoftwareBitmap = converted_video_frame_.SoftwareBitmap();
   } else if (!_winmli::SoftwareBitmapFormatSupported(videoFrame.SoftwareBitmap())) {
     convertedSoftwareBitmap = wgi::SoftwareBitmap::Convert(videoFrame.SoftwareBitmap(), _winmli::GetBitmapPixelFormatFromChannelType(tensorDesc.channelType));
   } else {
@@ -438,17 +516,10 @@ void VideoFrameToTensorConverter::ConvertSoftwareBitmapToGPUTensor(
 
   uint32_t tensorElementSize = tensorDesc.dataType == kImageTensorDataTypeFloat32 ? 4 : 2;
   uint32_t bufferSize = static_cast<uint32_t>(tensorDesc.sizes[1] * tensorDesc.sizes[2] * tensorDesc.sizes[3] * tensorElementSize);
-
-  // TODO: Make an allocator for upload heaps
-  if (!upload_heap_ || upload_heap_->GetDesc().Width < bufferSize) {
-    WINML_THROW_IF_FAILED(device_cache.GetD3D12Device()->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(bufferSize),
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&upload_heap_)));
-  }
+  // The upload heap was sized for the batch by PrepareBatchResources, so that frames don't overwrite each other's data
+  // before it has been copied.
+  UINT64 uploadOffset = static_cast<UINT64>(bufferSize) * batchIdx;
+  assert(upload_heap_ != nullptr && upload_heap_->GetDesc().Width >= uploadOffset + bufferSize);
 
   void* pCPUTensorBuffer = nullptr;
   WINML_THROW_IF_FAILED(upload_heap_->Map(0, &CD3DX12_RANGE(0, 0), &pCPUTensorBuffer));
@@ -456,20 +527,25 @@ void VideoFrameToTensorConverter::ConvertSoftwareBitmapToGPUTensor(
   // We avoid the Video Frame pipeline by manually sending the CPU data to the GPU, and we tensorize while we are filling the
   // upload heap. The image may already have been cropped/scaled by the video frame pipeline, so we send the scaled bounds
   // instead of the initial input bounds
-  ConvertSoftwareBitmapToCPUTensor(convertedSoftwareBitmap, tensorDesc, scaledBounds, pCPUTensorBuffer);
+  ConvertSoftwareBitmapToCPUTensor(convertedSoftwareBitmap, tensorDesc, scaledBounds, static_cast<BYTE*>(pCPUTensorBuffer) + uploadOffset);
 
-  upload_heap_->Unmap(0, &CD3DX12_RANGE(0, bufferSize));
+  upload_heap_->Unmap(0, &CD3DX12_RANGE(static_cast<SIZE_T>(uploadOffset), static_cast<SIZE_T>(uploadOffset + bufferSize)));
 
   ResetCommandList(device_cache);
 
   auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(pOutputResource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_DEST);
   command_list_->ResourceBarrier(1, &barrier);
 
-  command_list_->CopyBufferRegion(pOutputResource, bufferSize * batchIdx, upload_heap_.Get(), 0, bufferSize);
-  
+  command_list_->CopyBufferRegion(pOutputResource, uploadOffset, upload_heap_.Get(), uploadOffset, bufferSize);
+
+  // Leave the tensor in the state the next frame, and the model, expect it in
+  barrier = CD3DX12_RESOURCE_BARRIER::Transition(pOutputResource, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+  command_list_->ResourceBarrier(1, &barrier);
+
   WINML_THROW_IF_FAILED(command_list_->Close());
   ID3D12CommandList* ppCommandLists[] = {command_list_.Get()};
   device_cache.GetCommandQueue()->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+  fence_completion_value_ = device_cache.QueueFenceToD3D12();
 }
 
 D3D12_UNORDERED_ACCESS_VIEW_DESC VideoFrameToTensorConverter::CreateUAVDescription(
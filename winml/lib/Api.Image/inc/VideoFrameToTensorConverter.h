@@ -18,6 +18,13 @@ class IVideoFrameToTensorConverter {
       _In_ const ImageTensorDescription& tensor_description,
       _Inout_ ID3D12Resource* output_tensor) = 0;
 
+  virtual void VideoFramesToDX12Tensor(
+      _In_ winml::LearningModelSession& session,
+      _In_ const wfc::IVector<wm::VideoFrame>& input_video_frames,
+      _In_ const std::vector<wgi::BitmapBounds>& input_bounds,
+      _In_ const ImageTensorDescription& tensor_description,
+      _Inout_ ID3D12Resource* output_tensor) = 0;
+
   virtual void VideoFrameToSoftwareTensor(
       _In_ const wm::IVideoFrame& input_video_frame,
       _In_ const wgi::BitmapBounds& input_bounds,
@@ -44,6 +51,16 @@ class VideoFrameToTensorConverter : IVideoFrameToTensorConverter, public ImageCo
       _In_ const ImageTensorDescription& tensor_description,
       _Inout_ ID3D12Resource* output_tensor);
 
+  // Function takes in a batch of VideoFrames and converts frame i to batch index i of a tensor DX12 Resource.
+  // All frames are tensorized on the GPU with the resources of this converter, without waiting for the
+  // previous frame: each frame uses its own descriptors and its own region of the upload heap.
+  void VideoFramesToDX12Tensor(
+      _In_ winml::LearningModelSession& session,
+      _In_ const wfc::IVector<wm::VideoFrame>& input_video_frames,
+      _In_ const std::vector<wgi::BitmapBounds>& input_bounds,
+      _In_ const ImageTensorDescription& tensor_description,
+      _Inout_ ID3D12Resource* output_tensor);
+
   // Function takes in a VideoFrame backed by either a SoftwareBitmap or D3DSurface,
   // and converts to a tensor returned in a buffer.
   // User should pass in a BitmapBounds describing the region of interest, in the form of
@@ -61,8 +78,26 @@ class VideoFrameToTensorConverter : IVideoFrameToTensorConverter, public ImageCo
   ;  // CE43264E-41F7-4882-9E20-FAA51E3764FC
   Microsoft::WRL::ComPtr<ID3D12Resource> upload_heap_;
   Microsoft::WRL::ComPtr<ID3D12Resource> input_D3D12_resource_;
+  // The input resources of the frames tensorized since the last call to PrepareBatchResources.
+  std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> batch_input_resources_;
   HANDLE shared_handle_;
 
+  // Waits for the previous tensorization to complete, and grows the descriptor heap and the upload heap
+  // so that frame_count frames can be tensorized at once.
+  void PrepareBatchResources(
+      _In_ _winml::D3DDeviceCache& device_cache,
+      _In_ const ImageTensorDescription& tensor_description,
+      _In_ const UINT32 frame_count,
+      _In_ bool needs_upload_heap);
+
+  void TensorizeVideoFrameToDX12(
+      _In_ const UINT32 batch_index,
+      _In_ _winml::D3DDeviceCache& device_cache,
+      _In_ const wm::IVideoFrame& input_video_frame,
+      _In_ const wgi::BitmapBounds& input_bounds,
+      _In_ const ImageTensorDescription& tensor_description,
+      _Inout_ ID3D12Resource* output_tensor);
+
   Microsoft::WRL::ComPtr<ID3D12Resource> ShareD3D11Texture(ID3D11Texture2D* pTexture, ID3D12Device* pDevice);
 
   void ConvertSoftwareBitmapToGPUTensor(
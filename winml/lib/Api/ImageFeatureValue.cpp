@@ -255,30 +255,27 @@ static void GPUTensorize(
   descriptor.height = static_cast<int>(tensorDescriptor.sizes[2]);
   descriptor.luid = spDevice->GetD3DDevice()->GetAdapterLuid();  // Converted image on GPU
 
-  // Tensorize video frames one by one without extra copy.
-  for (uint32_t batchIdx = 0; batchIdx < videoFrames.Size(); ++batchIdx) {
-    auto pooledConverter = _winml::PoolObjectWrapper::Create(spDevice->TensorizerStore()->Fetch(descriptor));
-    {
-      // Apply tensorization
-      auto session = spSession.as<winml::LearningModelSession>();
-      pooledConverter->Get()->Tensorizer->VideoFrameToDX12Tensor(
-          batchIdx,
-          session,
-          videoFrames.GetAt(batchIdx),
-          bounds[batchIdx],
-          tensorDescriptor,
-          d3dResource);
-
-      // Tensorization to a GPU tensor will run asynchronously and associated resources
-      // need to be kept alive until the gpu resources have been used in the queue.
-      //
-      // The PoolObjectWrapper needs to stay alive so that the underlying resources are
-      // not released to the cache.
-      //
-      // This object will be returned to the cache when evaluate has completed. So we cache this
-      // on the binding context.
-      context.converter = pooledConverter;
-    }
+  // Tensorize all video frames with one converter, which queues them on the GPU without waiting for each other.
+  auto pooledConverter = _winml::PoolObjectWrapper::Create(spDevice->TensorizerStore()->Fetch(descriptor));
+  {
+    // Apply tensorization
+    auto session = spSession.as<winml::LearningModelSession>();
+    pooledConverter->Get()->Tensorizer->VideoFramesToDX12Tensor(
+        session,
+        videoFrames,
+        bounds,
+        tensorDescriptor,
+        d3dResource);
+
+    // Tensorization to a GPU tensor will run asynchronously and associated resources
+    // need to be kept alive until the gpu resources have been used in the queue.
+    //
+    // The PoolObjectWrapper needs to stay alive so that the underlying resources are
+    // not released to the cache.
+    //
+    // This object will be returned to the cache when evaluate has completed. So we cache this
+    // on the binding context.
+    context.converter = pooledConverter;
   }
 }
 